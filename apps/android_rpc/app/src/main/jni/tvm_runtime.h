@@ -48,6 +48,7 @@
 #include "../src/runtime/profiling.cc"
 #include "../src/runtime/registry.cc"
 #include "../src/runtime/rpc/rpc_channel.cc"
+#include "../src/runtime/rpc/rpc_compression.cc"
 #include "../src/runtime/rpc/rpc_endpoint.cc"
 #include "../src/runtime/rpc/rpc_event_impl.cc"
 #include "../src/runtime/rpc/rpc_local_session.cc"
@@ -0,0 +1,275 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""End-to-end benchmark of a model zoo on the graph executor, the VM and AOT.
+
+Each model is compiled once per executor and measured in a fresh process, which reports its
+cold start, its first inference, its steady state latency percentiles, its throughput at
+several thread counts and its peak memory. The results are written as JSON, and compared to
+the JSON of a previous run with --baseline.
+see README.md for the usage of this script.
+"""
+import argparse
+import datetime
+import json
+import os
+import platform
+import resource
+import subprocess
+import sys
+import tempfile
+import time
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import aot_executor, graph_executor
+from tvm.relay.backend import Executor
+from tvm.runtime import vm as vm_rt
+
+from util import get_network
+
+MODELS = ["resnet-50", "mobilenet", "bert-base", "ssd-mobilenet"]
+EXECUTORS = ["graph", "vm", "aot"]
+
+
+def _tensor_types(ty):
+    if isinstance(ty, relay.TupleType):
+        return [t for field in ty.fields for t in _tensor_types(field)]
+    return [([int(dim) for dim in ty.shape], ty.dtype)]
+
+
+def build(model, executor, target, batch_size, workdir):
+    """Compile a model for an executor into workdir.
+
+    Returns
+    -------
+    spec : dict
+        The description of the compiled model read by the measuring process.
+    """
+    mod, params, _, _ = get_network(model, batch_size)
+    mod = relay.transform.InferType()(mod)
+    main = mod["main"]
+    inputs = {p.name_hint: _tensor_types(p.checked_type)[0] for p in main.params}
+    inputs = {name: ty for name, ty in inputs.items() if name not in params}
+    lib_path = os.path.join(workdir, "%s-%s.so" % (model, executor))
+    spec = {
+        "executor": executor,
+        "lib": lib_path,
+        "inputs": inputs,
+        "outputs": _tensor_types(main.checked_type.ret_type),
+    }
+    start = time.perf_counter()
+    with tvm.transform.PassContext(opt_level=3):
+        if executor == "graph":
+            relay.build(mod, target=target, params=params).export_library(lib_path)
+        elif executor == "aot":
+            factory = relay.build(mod, target=target, params=params, executor=Executor("aot"))
+            factory.export_library(lib_path)
+        else:
+            code, lib = relay.vm.compile(mod, target=target, params=params).save()
+            lib.export_library(lib_path)
+            spec["code"] = os.path.join(workdir, "%s-vm.ro" % model)
+            with open(spec["code"], "wb") as f:
+                f.write(code)
+    spec["compile_s"] = time.perf_counter() - start
+    return spec
+
+
+class _Runner:
+    """Run a compiled model through one of the executors."""
+
+    def __init__(self, spec, dev):
+        self.dev = dev
+        lib = tvm.runtime.load_module(spec["lib"])
+        inputs = {
+            name: tvm.nd.array(_random_input(shape, dtype), dev)
+            for name, (shape, dtype) in spec["inputs"].items()
+        }
+        executor = spec["executor"]
+        if executor == "graph":
+            gmod = graph_executor.GraphModule(lib["default"](dev))
+            gmod.set_input(**inputs)
+            self.module, self.func, self.args = gmod.module, "run", []
+        elif executor == "vm":
+            with open(spec["code"], "rb") as f:
+                exe = vm_rt.Executable.load_exec(bytearray(f.read()), lib)
+            vm = vm_rt.VirtualMachine(exe, dev)
+            vm.set_input("main", **inputs)
+            self.module, self.func, self.args = vm.module, "invoke", ["main"]
+        else:
+            amod = aot_executor.AotModule(lib["default"](dev))
+            amod.set_input(**inputs)
+            self.module, self.func, self.args = amod.module, "run", []
+        self.run_func = self.module[self.func]
+
+    def run(self):
+        self.run_func(*self.args)
+        self.dev.sync()
+
+    def latencies(self, repeat):
+        timer = self.module.time_evaluator(self.func, self.dev, number=1, repeat=repeat)
+        return timer(*self.args).results
+
+    def mean_latency(self, min_repeat_ms):
+        timer = self.module.time_evaluator(
+            self.func, self.dev, number=1, repeat=3, min_repeat_ms=min_repeat_ms
+        )
+        return timer(*self.args).mean
+
+
+def _random_input(shape, dtype):
+    if dtype.startswith("int"):
+        return np.random.randint(0, 1000, size=shape).astype(dtype)
+    return np.random.uniform(size=shape).astype(dtype)
+
+
+def measure(spec):
+    """Measure a compiled model in this process, which must not have run it before."""
+    dev = tvm.device(spec["target"], 0)
+    rss_before = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    start = time.perf_counter()
+    runner = _Runner(spec, dev)
+    loaded = time.perf_counter()
+    runner.run()
+    first = time.perf_counter()
+    for _ in range(spec["warmup"]):
+        runner.run()
+    latencies = np.array(runner.latencies(spec["repeat"])) * 1e3
+    result = {
+        "cold_start_ms": (loaded - start) * 1e3,
+        "first_inference_ms": (first - loaded) * 1e3,
+        "latency_ms": {
+            "mean": float(np.mean(latencies)),
+            "p50": float(np.percentile(latencies, 50)),
+            "p99": float(np.percentile(latencies, 99)),
+        },
+    }
+    if dev.device_type == tvm.cpu().device_type:
+        config_threadpool = tvm.get_global_func("runtime.config_threadpool")
+        throughput = {}
+        for num_threads in spec["threads"]:
+            config_threadpool(1, num_threads)
+            runner.run()
+            throughput[str(num_threads)] = spec["batch_size"] / runner.mean_latency(200)
+        result["throughput_per_s"] = throughput
+    # ru_maxrss is in kilobytes on Linux
+    result["peak_rss_mb"] = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024
+    result["peak_rss_increase_mb"] = result["peak_rss_mb"] - rss_before / 1024
+    memory_stats = tvm.get_global_func("runtime.GetMemoryStatistics", allow_missing=True)
+    if memory_stats is not None:
+        stats = json.loads(memory_stats())
+        device_stats = stats.get("%s%d" % (dev.MASK2STR[dev.device_type], dev.device_id), {})
+        if "total" in device_stats:
+            result["peak_device_mb"] = device_stats["total"]["peak_bytes"] / (1 << 20)
+    return result
+
+
+def run(args):
+    """Compile and measure every combination of model and executor."""
+    workdir = tempfile.mkdtemp(prefix="model_bench_")
+    results = []
+    for model in args.models.split(","):
+        for executor in args.executors.split(","):
+            print("%s on the %s executor" % (model, executor), file=sys.stderr)
+            entry = {"model": model, "executor": executor, "batch_size": args.batch_size}
+            try:
+                spec = build(model, executor, args.target, args.batch_size, workdir)
+                spec.update(
+                    target=tvm.target.Target(args.target).kind.name,
+                    batch_size=args.batch_size,
+                    warmup=args.warmup,
+                    repeat=args.repeat,
+                    threads=[int(n) for n in args.threads.split(",")],
+                )
+                entry["compile_s"] = spec["compile_s"]
+                worker = subprocess.run(
+                    [sys.executable, __file__, "--measure", json.dumps(spec)],
+                    stdout=subprocess.PIPE,
+                    check=True,
+                )
+                entry.update(json.loads(worker.stdout.decode().splitlines()[-1]))
+            except Exception as err:  # pylint: disable=broad-except
+                # keep going, an executor may not support every model
+                entry["error"] = str(err).splitlines()[-1] if str(err) else type(err).__name__
+            results.append(entry)
+    info = tvm.support.libinfo()
+    return {
+        "environment": {
+            "date": datetime.datetime.now().isoformat(),
+            "host": platform.node(),
+            "processor": platform.processor() or platform.machine(),
+            "target": args.target,
+            "tvm_commit": info.get("GIT_COMMIT_HASH", "unknown"),
+        },
+        "results": results,
+    }
+
+
+def compare(baseline, current):
+    """Print the relative change of the metrics of the current run against a baseline run."""
+    base = {(r["model"], r["executor"]): r for r in baseline["results"]}
+    metrics = [
+        ("cold_start_ms", lambda r: r.get("cold_start_ms")),
+        ("first_inference_ms", lambda r: r.get("first_inference_ms")),
+        ("p50_ms", lambda r: r.get("latency_ms", {}).get("p50")),
+        ("p99_ms", lambda r: r.get("latency_ms", {}).get("p99")),
+        ("peak_rss_mb", lambda r: r.get("peak_rss_mb")),
+    ]
+    print("%-16s %-6s %-20s %12s %12s %8s" % ("Model", "Exec", "Metric", "Base", "Now", "Change"))
+    for result in current["results"]:
+        old = base.get((result["model"], result["executor"]))
+        if old is None:
+            continue
+        for name, get in metrics:
+            before, after = get(old), get(result)
+            if before and after is not None:
+                change = (after / before - 1) * 100
+                row = (result["model"], result["executor"], name, before, after, change)
+                print("%-16s %-6s %-20s %12.2f %12.2f %+7.1f%%" % row)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--models", default=",".join(MODELS), help="comma separated")
+    parser.add_argument("--executors", default=",".join(EXECUTORS), help="comma separated")
+    parser.add_argument("--target", default="llvm", help="the compilation target")
+    parser.add_argument("--batch-size", type=int, default=1)
+    parser.add_argument("--warmup", type=int, default=10, help="runs before the timed runs")
+    parser.add_argument("--repeat", type=int, default=100, help="timed runs of the percentiles")
+    parser.add_argument(
+        "--threads", default="1,%d" % os.cpu_count(), help="thread counts of the throughput"
+    )
+    parser.add_argument("--output", default="model_bench.json", help="the JSON report")
+    parser.add_argument("--baseline", help="the JSON report of a previous run to compare with")
+    parser.add_argument("--measure", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.measure:
+        print(json.dumps(measure(json.loads(args.measure))))
+        return
+    report = run(args)
+    with open(args.output, "w") as f:
+        json.dump(report, f, indent=2)
+    print("Wrote %s" % args.output, file=sys.stderr)
+    if args.baseline:
+        with open(args.baseline) as f:
+            compare(json.load(f), report)
+
+
+if __name__ == "__main__":
+    main()
@@ -27,7 +27,8 @@ def get_network(name, batch_size, dtype="float32"):
     Parameters
     ----------
     name: str
-        The name of the network, can be 'resnet-18', 'resnet-50', 'vgg-16', 'inception_v3', 'mobilenet', ...
+        The name of the network, can be 'resnet-18', 'resnet-50', 'vgg-16', 'inception_v3',
+        'mobilenet', 'bert-base', 'ssd-mobilenet', ...
     batch_size: int
         batch size
     dtype: str
@@ -42,7 +43,7 @@ def get_network(name, batch_size, dtype="float32"):
     input_shape: tuple
         The shape of input tensor
     output_shape: tuple
-        The shape of output tensor
+        The shape of output tensor, None for the networks of several outputs
     """
     input_shape = (batch_size, 3, 224, 224)
     output_shape = (batch_size, 1000)
@@ -72,6 +73,30 @@ def get_network(name, batch_size, dtype="float32"):
         net, params = testing.squeezenet.get_workload(
             batch_size=batch_size, version=version, dtype=dtype
         )
+    elif "bert" in name:
+        # bert-base or bert-large, taking sequences of 128 token ids
+        num_layers, hidden_size, num_heads = (12, 768, 12)
+        if name == "bert-large":
+            num_layers, hidden_size, num_heads = (24, 1024, 16)
+        input_shape = (batch_size, 128)
+        output_shape = (batch_size, hidden_size)
+        net, params = testing.bert.get_workload(
+            batch_size=batch_size,
+            seq_len=128,
+            num_layers=num_layers,
+            hidden_size=hidden_size,
+            num_heads=num_heads,
+            dtype=dtype,
+        )
+    elif name == "ssd-mobilenet":
+        # the architecture of the GluonCV model with random weights, needs mxnet and gluoncv
+        from gluoncv.model_zoo import get_model
+
+        input_shape = (batch_size, 3, 512, 512)
+        block = get_model("ssd_512_mobilenet1.0_voc", pretrained=False, pretrained_base=False)
+        block.initialize()
+        net, params = relay.frontend.from_mxnet(block, shape={"data": input_shape}, dtype=dtype)
+        output_shape = None
     elif name == "mxnet":
         # an example for mxnet model
         from mxnet.gluon.model_zoo.vision import get_model
@@ -65,6 +65,10 @@
 #include "../../src/runtime/graph_executor/graph_executor.cc"
 #include "../../src/runtime/graph_executor/graph_executor_factory.cc"
 
+// AOT executor
+#include "../../src/runtime/aot_executor/aot_executor.cc"
+#include "../../src/runtime/aot_executor/aot_executor_factory.cc"
+
 // Uncomment the following lines to enable RPC
 // #include "../../src/runtime/rpc/rpc_session.cc"
 // #include "../../src/runtime/rpc/rpc_event_impl.cc"
@@ -102,12 +102,22 @@ set(USE_STACKVM_RUNTIME OFF)
 # Whether enable tiny embedded graph executor.
 set(USE_GRAPH_EXECUTOR ON)
 
+# Whether enable the AOT executor of the C++ runtime, which runs the models compiled with
+# the AOT executor without the C runtime
+set(USE_AOT_EXECUTOR ON)
+
 # Whether enable tiny graph executor with CUDA Graph
 set(USE_GRAPH_EXECUTOR_CUDA_GRAPH OFF)
 
+# Whether enable the Relay VM with CUDA Graph replay
+set(USE_VM_CUDA_GRAPH OFF)
+
 # Whether enable pipeline executor.
 set(USE_PIPELINE_EXECUTOR OFF)
 
+# Whether enable the batching executor, which groups requests into dynamic batches.
+set(USE_BATCHING_EXECUTOR OFF)
+
 # Whether to enable the profiler for the graph executor and vm
 set(USE_PROFILER ON)
 
@@ -282,6 +292,10 @@ set(USE_PT_TVMDSOOP OFF)
 # Whether to use STL's std::unordered_map or TVM's POD compatible Map
 set(USE_FALLBACK_STL_MAP OFF)
 
+# Whether make_object allocates the small objects, such as most IR nodes and the
+# NDArray containers, from thread caching pools instead of the global heap
+set(USE_OBJECT_POOL OFF)
+
 # Whether to use hexagon device
 set(USE_HEXAGON_DEVICE OFF)
 set(USE_HEXAGON_SDK /path/to/sdk)
@@ -346,6 +360,14 @@ set(USE_CCACHE AUTO)
 # - /path/to/folder/containing/: Path to folder containing papi.pc.
 set(USE_PAPI OFF)
 
+# Whether to read the performance counters of CUDA kernels with CUPTI while
+# profiling, which needs USE_CUDA.
+set(USE_CUPTI OFF)
+
+# Whether to read the performance counters of ROCm kernels with rocprofiler while
+# profiling, which needs USE_ROCM.
+set(USE_ROCPROFILER OFF)
+
 # Whether to use GoogleTest for C++ unit tests. When enabled, the generated
 # build file (e.g. Makefile) will have a target "cpptest".
 # Possible values:
@@ -358,6 +380,14 @@ set(USE_PAPI OFF)
 # predefined variables to specify the path to the GTest package if needed.
 set(USE_GTEST AUTO)
 
+# Whether to use Google Benchmark for the C++ microbenchmarks of the runtime.
+# When enabled, the generated build file will have a target "cppbench".
+# Possible values:
+# - ON: enable Google Benchmark. The package `benchmark` will be required.
+# - OFF: disable Google Benchmark.
+# - AUTO: enable Google Benchmark if cmake finds the package `benchmark`.
+set(USE_BENCHMARK AUTO)
+
 # Enable using CUTLASS as a BYOC backend
 # Need to have USE_CUDA=ON
 set(USE_CUTLASS OFF)
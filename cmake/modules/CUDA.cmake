@@ -56,6 +56,22 @@ if(USE_CUDA)
     endif()
   endif(USE_CUBLAS)
 
+  if(USE_CUPTI)
+    message(STATUS "Build with CUPTI support")
+    set(CUPTI_DIR ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI)
+    find_library(CUDA_CUPTI_LIBRARY cupti HINTS ${CUPTI_DIR}/lib64 ${CUPTI_DIR}/lib)
+    find_library(CUDA_NVPERF_HOST_LIBRARY nvperf_host HINTS ${CUPTI_DIR}/lib64 ${CUPTI_DIR}/lib)
+    find_library(CUDA_NVPERF_TARGET_LIBRARY nvperf_target
+      HINTS ${CUPTI_DIR}/lib64 ${CUPTI_DIR}/lib)
+    if(NOT CUDA_CUPTI_LIBRARY OR NOT CUDA_NVPERF_HOST_LIBRARY OR NOT CUDA_NVPERF_TARGET_LIBRARY)
+      message(FATAL_ERROR "Cannot find CUPTI in " ${CUPTI_DIR})
+    endif()
+    include_directories(SYSTEM ${CUPTI_DIR}/include)
+    list(APPEND RUNTIME_SRCS src/runtime/contrib/cupti/cupti.cc)
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${CUDA_CUPTI_LIBRARY} ${CUDA_NVPERF_HOST_LIBRARY}
+      ${CUDA_NVPERF_TARGET_LIBRARY})
+  endif(USE_CUPTI)
+
   if(USE_THRUST)
     message(STATUS "Build with Thrust support")
     cmake_minimum_required(VERSION 3.13) # to compile CUDA code
@@ -76,6 +92,15 @@ if(USE_CUDA)
     file(GLOB RUNTIME_CUDA_GRAPH_SRCS src/runtime/graph_executor/cuda_graph/*.cc)
     list(APPEND RUNTIME_SRCS ${RUNTIME_CUDA_GRAPH_SRCS})
   endif()
+
+  if(USE_VM_CUDA_GRAPH)
+    if(CUDAToolkit_VERSION_MAJOR LESS "10")
+      message(FATAL_ERROR "CUDA Graph requires CUDA 10 or above, got=" ${CUDAToolkit_VERSION})
+    endif()
+    message(STATUS "Build with Relay VM with CUDA Graph support...")
+    file(GLOB RUNTIME_VM_CUDA_GRAPH_SRCS src/runtime/vm/cuda_graph/*.cc)
+    list(APPEND RUNTIME_SRCS ${RUNTIME_VM_CUDA_GRAPH_SRCS})
+  endif()
 else(USE_CUDA)
   list(APPEND COMPILER_SRCS src/target/opt/build_cuda_off.cc)
 endif(USE_CUDA)
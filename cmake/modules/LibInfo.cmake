@@ -51,6 +51,7 @@ function(add_lib_info src_file)
     TVM_INFO_CUDA_VERSION="${TVM_INFO_CUDA_VERSION}"
     TVM_INFO_USE_STACKVM_RUNTIME="${USE_STACKVM_RUNTIME}"
     TVM_INFO_USE_GRAPH_EXECUTOR="${USE_GRAPH_EXECUTOR}"
+    TVM_INFO_USE_AOT_EXECUTOR="${USE_AOT_EXECUTOR}"
     TVM_INFO_USE_PROFILER="${USE_PROFILER}"
     TVM_INFO_USE_OPENMP="${USE_OPENMP}"
     TVM_INFO_USE_RELAY_DEBUG="${USE_RELAY_DEBUG}"
@@ -62,6 +63,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_TF_TVMDSOOP="${USE_TF_TVMDSOOP}"
     TVM_INFO_USE_PT_TVMDSOOP="${USE_PT_TVMDSOOP}"
     TVM_INFO_USE_FALLBACK_STL_MAP="${USE_FALLBACK_STL_MAP}"
+    TVM_INFO_USE_OBJECT_POOL="${USE_OBJECT_POOL}"
     TVM_INFO_USE_BYODT_POSIT="${USE_BYODT_POSIT}"
     TVM_INFO_USE_BLAS="${USE_BLAS}"
     TVM_INFO_USE_MKL="${USE_MKL}"
@@ -52,6 +52,17 @@ if(USE_ROCM)
     list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_ROCBLAS_LIBRARY})
   endif(USE_ROCBLAS)
 
+  if(USE_ROCPROFILER)
+    message(STATUS "Build with rocprofiler support")
+    find_library(ROCM_ROCPROFILER_LIBRARY rocprofiler64
+      HINTS ${ROCM_INCLUDE_DIRS}/../lib ${ROCM_INCLUDE_DIRS}/../rocprofiler/lib)
+    if(NOT ROCM_ROCPROFILER_LIBRARY OR NOT ROCM_HSA_LIBRARY)
+      message(FATAL_ERROR "Cannot find rocprofiler and the HSA runtime")
+    endif()
+    list(APPEND RUNTIME_SRCS src/runtime/contrib/rocprofiler/rocprofiler.cc)
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_ROCPROFILER_LIBRARY})
+  endif(USE_ROCPROFILER)
+
   if(USE_THRUST)
     message(STATUS "Build with rocThrust support")
     # We need to override CXX to hipcc. This is required by rocthrust
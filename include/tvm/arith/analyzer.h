@@ -26,10 +26,13 @@
 
 #include <tvm/arith/int_set.h>
 #include <tvm/ir/expr.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/support/with.h>
 
 #include <limits>
 #include <memory>
+#include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -374,6 +377,61 @@ class IntSetAnalyzer {
   Impl* impl_;
 };
 
+/*!
+ * \brief The results of Analyzer::Simplify and Analyzer::CanProve that only depend on the
+ *  expression, shared by the analyzers of several threads.
+ *
+ *  An analyzer with a shared memo stores the results computed outside any constraint
+ *  for the expressions using none of its bound variables, these hold for every analyzer.
+ *  The memo is read-mostly, a lookup only takes a shared lock.
+ *
+ * \sa Analyzer::EnableMemo
+ */
+class TVM_DLL SimplifyMemo {
+ public:
+  /*! \brief The memoized results of one expression. */
+  struct Entry {
+    /*! \brief The simplified expression, undefined when not computed. */
+    PrimExpr simplified;
+    /*! \brief The number of steps simplified was computed with. */
+    int steps{0};
+    /*! \brief The result of CanProve, -1 when not computed. */
+    int proved{-1};
+  };
+  /*! \brief The table of the results, keyed by the structure of the expression. */
+  using Table = std::unordered_map<PrimExpr, Entry, StructuralHash, StructuralEqual>;
+  /*!
+   * \brief Constructor.
+   * \param max_entries The number of entries above which the memo is cleared.
+   */
+  explicit SimplifyMemo(size_t max_entries = 1 << 16) : max_entries_(max_entries) {}
+  /*!
+   * \brief Find the results of an expression.
+   * \param expr The expression.
+   * \param entry The results found.
+   * \return Whether the expression has an entry.
+   */
+  bool Find(const PrimExpr& expr, Entry* entry) const;
+  /*!
+   * \brief Add results to the entry of an expression.
+   * \param expr The expression.
+   * \param entry The results, the fields not computed are left unchanged.
+   */
+  void Insert(const PrimExpr& expr, const Entry& entry);
+  /*! \brief Remove all the entries. */
+  void Clear();
+  /*! \return The number of entries. */
+  size_t size() const;
+
+ private:
+  /*! \brief The number of entries above which the table is cleared. */
+  size_t max_entries_;
+  /*! \brief Protects table_. */
+  mutable std::shared_timed_mutex mutex_;
+  /*! \brief The entries. */
+  Table table_;
+};
+
 /*!
  * \brief Analyzer that contains bunch of sub-analyzers.
  *
@@ -491,6 +549,39 @@ class TVM_DLL Analyzer {
    * \note Analyzer will call into sub-analyzers to get the result.
    */
   PrimExpr Simplify(const PrimExpr& expr, int steps = 2);
+  /*!
+   * \brief Memoize the results of Simplify and CanProve.
+   *
+   *  The results are kept per constraint context: entering a ConstraintContext starts an
+   *  empty table that is dropped on exit, and binding a variable used by a memoized result
+   *  clears all the tables. An analyzer is used by one thread at a time, the analyzers of
+   *  several threads share their results through shared_memo.
+   *
+   * \param shared_memo The memo shared with other analyzers, can be nullptr.
+   *
+   * \note Must be called before any Bind or ConstraintContext. The memo only tracks the
+   *  changes made through Bind and ConstraintContext, ClearMemo must be called after
+   *  updating a sub-analyzer directly.
+   */
+  void EnableMemo(std::shared_ptr<SimplifyMemo> shared_memo = nullptr);
+  /*! \brief Clear the results memoized by this analyzer, the shared memo is kept. */
+  void ClearMemo();
+  /*! \brief destructor */
+  ~Analyzer();
+
+ private:
+  friend class ConstraintContext;
+  class MemoState;
+  /*! \brief CanProve without the memo. */
+  bool CanProveImpl(const PrimExpr& cond);
+  /*! \brief Simplify without the memo. */
+  PrimExpr SimplifyImpl(const PrimExpr& expr, int steps);
+  /*! \brief Update the memo after var was bound to value, undefined for a range. */
+  void MemoBind(const Var& var, const PrimExpr& value);
+  /*! \brief Whether Bind or ConstraintContext were used, i.e. the analyzer is not fresh. */
+  bool modified_{false};
+  /*! \brief The memo, nullptr when not enabled. */
+  std::unique_ptr<MemoState> memo_;
 };
 
 }  // namespace arith
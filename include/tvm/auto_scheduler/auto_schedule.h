@@ -50,6 +50,8 @@ class TuningOptionsNode : public Object {
   ProgramRunner runner;
   /*! \brief MeasureCallback functions to be called after each measure batch */
   Optional<Array<MeasureCallback>> measure_callbacks;
+  /*! \brief The file keeping the costs of the measured programs across the sessions */
+  String measure_cache_file;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("num_measure_trials", &num_measure_trials);
@@ -59,6 +61,7 @@ class TuningOptionsNode : public Object {
     v->Visit("builder", &builder);
     v->Visit("runner", &runner);
     v->Visit("measure_callbacks", &measure_callbacks);
+    v->Visit("measure_cache_file", &measure_cache_file);
   }
 
   static constexpr const char* _type_key = "auto_scheduler.TuningOptions";
@@ -81,10 +84,12 @@ class TuningOptions : public ObjectRef {
    * \param builder ProgramBuilder which builds the program.
    * \param runner ProgramRunner which runs the program and measure time costs.
    * \param measure_callbacks MeasureCallback functions to be called after each measure batch.
+   * \param measure_cache_file The file keeping the costs of the measured programs, empty for
+   * none.
    */
   TuningOptions(int num_measure_trials, int early_stopping, int num_measures_per_round, int verbose,
                 ProgramBuilder builder, ProgramRunner runner,
-                Optional<Array<MeasureCallback>> measure_callbacks);
+                Optional<Array<MeasureCallback>> measure_callbacks, String measure_cache_file = "");
 
   TVM_DEFINE_OBJECT_REF_METHODS(TuningOptions, ObjectRef, TuningOptionsNode);
 };
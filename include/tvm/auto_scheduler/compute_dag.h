@@ -38,6 +38,7 @@
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/te/schedule.h>
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -165,6 +166,8 @@ class AccessAnalyzer : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(AccessAnalyzer, ObjectRef, AccessAnalyzerNode);
 };
 
+class InferBoundCache;
+
 /*! \brief The auto-scheduler's computational graph and related program analyses. */
 class ComputeDAGNode : public Object {
  public:
@@ -181,6 +184,11 @@ class ComputeDAGNode : public Object {
   State init_state;
   /*! \brief The static read-write access analyzer. */
   AccessAnalyzer access_analyzer;
+  /*!
+   * \brief The bounds already inferred for the states of this DAG, by their transform steps.
+   *  Not serialized, and null in a deserialized DAG, which then infers every bound.
+   */
+  std::shared_ptr<InferBoundCache> bound_cache;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("tensors", &tensors);
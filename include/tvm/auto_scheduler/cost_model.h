@@ -30,6 +30,7 @@
 #include <tvm/node/node.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <string>
 #include <vector>
 
 namespace tvm {
@@ -159,6 +160,90 @@ class PythonBasedModel : public CostModel {
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(PythonBasedModel, CostModel, PythonBasedModelNode);
 };
 
+/*!
+ * \brief A gradient boosted tree model scored in C++, loaded from the JSON model format of
+ *  XGBoost.
+ *
+ *  The score of a state is the sum of the predictions of its per store feature rows, as in
+ *  the pack-sum format of XGBModel. The training itself is left to python: Update calls
+ *  `update_func`, which returns the retrained model, so Predict never enters python and
+ *  is not serialized by the GIL during the evolutionary search.
+ */
+class GBTreeModelNode : public CostModelNode {
+ public:
+  /*!
+   * \brief The function training the model in python, returning the new model in the XGBoost
+   *  JSON format, or an empty string while there is no model. Null when not trainable.
+   */
+  PackedFunc update_func;
+  /*! \brief The max number of buffers used in the features. */
+  int max_n_bufs;
+
+  void Update(const Array<MeasureInput>& inputs, const Array<MeasureResult>& results) final;
+
+  void Predict(const SearchTask& task, const Array<State>& states,
+               std::vector<float>* scores) final;
+
+  /*!
+   * \brief Load a model saved by XGBoost in its JSON format, replacing the current one.
+   * \param model_json The model, an empty string to go back to random predictions.
+   */
+  void LoadXGBoostJSON(const std::string& model_json);
+
+  /*!
+   * \brief Predict the raw scores of feature rows.
+   * \param rows The rows, row_len floats each.
+   * \param n_rows The number of rows.
+   * \param row_len The length of a row.
+   * \param preds The predictions of the rows.
+   */
+  void PredictRows(const float* rows, size_t n_rows, size_t row_len, float* preds) const;
+
+  /*! \return The number of trees, 0 until a model is loaded. */
+  size_t NumTrees() const { return tree_roots_.size(); }
+
+  static constexpr const char* _type_key = "auto_scheduler.GBTreeModel";
+  TVM_DECLARE_FINAL_OBJECT_INFO(GBTreeModelNode, CostModelNode);
+
+ private:
+  /*! \brief A tree node, the trees being stored one after the other in `nodes_`. */
+  struct Node {
+    /*! \brief The feature tested by a split node, -1 for a leaf. */
+    int32_t feature;
+    /*! \brief The threshold of a split node, going left when below, or the leaf value. */
+    float value;
+    /*! \brief The children of a split node, in `nodes_`. */
+    int32_t left, right;
+    /*! \brief Whether a missing (NaN) feature goes left. */
+    bool default_left;
+  };
+  /*! \brief The nodes of all the trees. */
+  std::vector<Node> nodes_;
+  /*! \brief The root of each tree in `nodes_`. */
+  std::vector<int32_t> tree_roots_;
+  /*! \brief The largest feature index used by the trees. */
+  int32_t max_feature_{-1};
+  /*! \brief The global bias added to the prediction of each row. */
+  float base_score_{0.0f};
+};
+
+/*!
+ * \brief Managed reference to GBTreeModelNode.
+ * \sa GBTreeModelNode
+ */
+class GBTreeModel : public CostModel {
+ public:
+  /*!
+   * \brief The constructor.
+   * \param model_json The model in the XGBoost JSON format, may be empty.
+   * \param update_func The function training the model in python, may be null.
+   * \param max_n_bufs The max number of buffers used in the features.
+   */
+  GBTreeModel(const std::string& model_json, PackedFunc update_func, int max_n_bufs);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(GBTreeModel, CostModel, GBTreeModelNode);
+};
+
 }  // namespace auto_scheduler
 }  // namespace tvm
 
@@ -116,6 +116,41 @@ void GetPerStoreFeaturesFromMeasurePairs(const Array<MeasureInput>& inputs,
                                          std::vector<float>* normalized_throughputs,
                                          std::vector<int>* task_ids);
 
+/*!
+ * \brief The counters of the feature cache.
+ *
+ *  The features extracted from a state are cached, keyed by its transform steps and the
+ *  parameters of its task, so that the states seen again by the evolutionary search are not
+ *  lowered again. The cache is shared by all the tasks and evicts the least recently used
+ *  states beyond its capacity.
+ */
+struct FeatureCacheStats {
+  /*! \brief The number of states whose features were found in the cache. */
+  int64_t hits = 0;
+  /*! \brief The number of states whose features were extracted. */
+  int64_t misses = 0;
+  /*! \brief The number of states evicted from the cache. */
+  int64_t evictions = 0;
+  /*! \brief The number of states in the cache. */
+  int64_t num_entries = 0;
+  /*! \brief The approximate memory used by the cache, in bytes. */
+  int64_t nbytes = 0;
+  /*! \brief The capacity of the cache in bytes, 0 when disabled. */
+  int64_t capacity_nbytes = 0;
+};
+
+/*!
+ * \brief Set the capacity of the feature cache, evicting states as needed.
+ * \param capacity_nbytes The capacity in bytes, 0 to disable the cache.
+ */
+void SetFeatureCacheCapacity(int64_t capacity_nbytes);
+
+/*! \return The counters of the feature cache. */
+FeatureCacheStats GetFeatureCacheStats();
+
+/*! \brief Remove all the states of the feature cache and reset its counters. */
+void ClearFeatureCache();
+
 }  // namespace auto_scheduler
 }  // namespace tvm
 
@@ -478,6 +478,11 @@ class ProgramMeasurerNode : public Object {
   int verbose;
   /*! \brief The number of allowed maximum continuous error before forcely stopping the tuning */
   int max_continuous_error;
+  /*!
+   * \brief The file keeping the costs of the measured programs across the sessions, empty for
+   * none. The programs found in it are not built and run again.
+   */
+  String cache_file;
 
   /*! \brief Reset book keeping variables */
   void Reset();
@@ -507,6 +512,18 @@ class ProgramMeasurerNode : public Object {
 
   static constexpr const char* _type_key = "auto_scheduler.ProgramMeasurer";
   TVM_DECLARE_FINAL_OBJECT_INFO(ProgramMeasurerNode, Object);
+
+ private:
+  /*! \brief Load the costs in cache_file to program_cache_ once. */
+  void LoadProgramCache();
+
+  /*!
+   * \brief The successful results of the measured programs, keyed by the structural hash of
+   * their lowered TIR and their target. Programs reached through different steps are equal.
+   */
+  std::unordered_map<std::string, MeasureResult> program_cache_;
+  /*! \brief Whether cache_file is loaded. */
+  bool cache_file_loaded_ = false;
 };
 
 /*!
@@ -524,10 +541,11 @@ class ProgramMeasurer : public ObjectRef {
    * measuring.
    * \param max_continuous_error The number of allowed maximum continuous error before
    * forcely stopping the tuning.
+   * \param cache_file The file keeping the costs of the measured programs, empty for none.
    */
   ProgramMeasurer(ProgramBuilder builder, ProgramRunner runner,
                   Optional<Array<MeasureCallback>> callbacks, int verbose,
-                  int max_continuous_error = -1);
+                  int max_continuous_error = -1, String cache_file = "");
 
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(ProgramMeasurer, ObjectRef, ProgramMeasurerNode);
 };
@@ -28,6 +28,7 @@
 #include <tvm/auto_scheduler/measure.h>
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -64,7 +65,14 @@ class RecordToFile : public MeasureCallback {
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(RecordToFile, MeasureCallback, RecordToFileNode);
 };
 
-/*! \brief Log reader to load step logs from a file.*/
+class BinaryRecordFile;
+
+/*!
+ * \brief Log reader to load step logs from a file.
+ *
+ *  The file is either a JSON log, one record per line, or a binary log written by
+ *  ConvertRecordsToBinary, which is detected by its magic number and memory mapped.
+ */
 class RecordReaderNode : public Object {
  public:
   /*! \brief The name of input file. */
@@ -90,12 +98,29 @@ class RecordReaderNode : public Object {
   std::pair<Array<MeasureInput>, Array<MeasureResult>> ReadLines(int max_size = -1,
                                                                  int skip_size = 0);
 
+  /*!
+   * \brief Read all the records of a workload, wherever ReadNext stands.
+   *  A binary log reads them through its workload index, a JSON log is scanned.
+   * \param workload_key The workload key.
+   * \return The MeasureInputs and MeasureResults of the workload, in file order.
+   */
+  std::pair<Array<MeasureInput>, Array<MeasureResult>> ReadWorkload(const String& workload_key);
+
+  /*! \return Whether the file is a binary log. */
+  bool IsBinary() const { return binary_file_ != nullptr; }
+
   static constexpr const char* _type_key = "auto_scheduler.RecordReader";
   TVM_DECLARE_FINAL_OBJECT_INFO(RecordReaderNode, Object);
 
  private:
   /*! \brief A string storing the current line. */
   std::string cur_line_;
+  /*! \brief The mapped file when it is a binary log. */
+  std::shared_ptr<BinaryRecordFile> binary_file_;
+  /*! \brief The index of the next record of the binary log. */
+  size_t next_record_ = 0;
+
+  friend class RecordReader;
 };
 
 /*!
@@ -134,6 +159,28 @@ void WriteMeasureRecords(std::ostream* os, const Array<MeasureInput>& inputs,
 void ReadMeasureRecord(const std::string& str, MeasureInputNode* inp, MeasureResultNode* res,
                        std::string* log_version);
 
+/*!
+ * \brief Convert a JSON log to the binary log format.
+ *
+ *  A binary log stores each distinct search task once, the results as raw numbers, and
+ *  an index of the records of each workload, so that reading it does not parse a task or a
+ *  target per record. It cannot be appended to. Like the JSON log it is converted from, it
+ *  keeps the error_no of the results but not their error_msg, which reads back empty.
+ * \param json_filename The JSON log to read.
+ * \param binary_filename The binary log to write, overwritten.
+ * \return The number of records converted.
+ */
+int64_t ConvertRecordsToBinary(const std::string& json_filename,
+                               const std::string& binary_filename);
+
+/*!
+ * \brief Convert a binary log back to a JSON log.
+ * \param binary_filename The binary log to read.
+ * \param json_filename The JSON log to write, overwritten.
+ * \return The number of records converted.
+ */
+int64_t ConvertRecordsToJSON(const std::string& binary_filename, const std::string& json_filename);
+
 }  // namespace auto_scheduler
 }  // namespace tvm
 
@@ -112,6 +112,43 @@ class PreloadMeasuredStates : public SearchCallback {
                                         PreloadMeasuredStatesNode);
 };
 
+/*!
+ * \brief Warm start the search with the best states of similar workloads in a log file.
+ * The workloads of the same compute function or DAG whose arguments only differ in their
+ * integers (e.g. another batch size or resolution) are ranked by their shape distance, and the
+ * steps of their best records are replayed on the new workload. The states that replay are
+ * measured in the first search round and join the initial population of the evolution.
+ */
+class WarmStartFromSimilarWorkloadsNode : public SearchCallbackNode {
+ public:
+  /*! \brief The name of the record log file. */
+  String filename;
+  /*! \brief The maximum number of states to take from the similar workloads. */
+  int num_states;
+
+  void Callback(SearchPolicyNode* policy) final;
+
+  static constexpr const char* _type_key = "auto_scheduler.WarmStartFromSimilarWorkloads";
+  TVM_DECLARE_FINAL_OBJECT_INFO(WarmStartFromSimilarWorkloadsNode, SearchCallbackNode);
+};
+
+/*!
+ * \brief Managed reference to WarmStartFromSimilarWorkloadsNode.
+ * \sa WarmStartFromSimilarWorkloadsNode
+ */
+class WarmStartFromSimilarWorkloads : public SearchCallback {
+ public:
+  /*!
+   * \brief The constructor.
+   * \param filename The name of the record log file.
+   * \param num_states The maximum number of states to take from the similar workloads.
+   */
+  WarmStartFromSimilarWorkloads(String filename, int num_states);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(WarmStartFromSimilarWorkloads, SearchCallback,
+                                        WarmStartFromSimilarWorkloadsNode);
+};
+
 /*! \brief Attribute keys of ops used for SearchPolicy. */
 struct SearchPolicyKey {
   /*! \brief Always apply unroll to the inner most iterator of the specificed iterators. */
@@ -168,6 +205,13 @@ class SearchPolicyNode : public Object {
    */
   void PreloadMeasuredStates(const String& log_file);
 
+  /*!
+   * \brief Retarget the best states of the similar workloads in a log file to the current task.
+   * \param log_file The name of the record log file.
+   * \param num_states The maximum number of states to retarget.
+   */
+  void WarmStartFromSimilarWorkloads(const String& log_file, int num_states);
+
   /*!
    * \brief Call SearchCallback with the current SearchPolicyNode
    * \param callbacks SearchCallback to be called.
@@ -189,6 +233,8 @@ class SearchPolicyNode : public Object {
   std::vector<State> measured_states_vector_;
   /*! \brief The throughputs of already measured states */
   std::vector<float> measured_states_throughputs_;
+  /*! \brief The states retargeted from similar workloads, to be measured in the next round. */
+  std::vector<State> warm_start_states_;
 };
 
 /*!
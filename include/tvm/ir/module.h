@@ -475,6 +475,21 @@ TVM_DLL String PrettyPrint(const ObjectRef& node);
 TVM_DLL String AsText(const ObjectRef& node, bool show_meta_data = true,
                       runtime::TypedPackedFunc<String(ObjectRef)> annotate = nullptr);
 
+/*!
+ * \brief Write the node to an output stream in the text format, without making a string of
+ *  the whole text.
+ *
+ * \param node The node to be rendered.
+ * \param os The output stream.
+ * \param show_meta_data Whether to print meta data section.
+ * \param annotate An optional callback function for attaching
+ *        additional comment block to an expr.
+ *
+ * \sa AsText.
+ */
+TVM_DLL void AsText(const ObjectRef& node, std::ostream& os, bool show_meta_data = true,
+                    runtime::TypedPackedFunc<String(ObjectRef)> annotate = nullptr);
+
 namespace attr {
 
 /*!
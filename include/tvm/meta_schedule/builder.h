@@ -123,6 +123,17 @@ class Builder : public runtime::ObjectRef {
    * \return The Builder created.
    */
   static Builder PyBuilder(BuilderNode::FBuild f_build);
+  /*!
+   * \brief Create a builder compiling the inputs on a pool of threads.
+   * \param num_threads The number of threads building in parallel.
+   * \param f_build The function building an IRModule for a target, the native lowering and
+   *  code generation if it is null.
+   * \param f_export The function exporting a built module and returning the artifact path,
+   *  `meta_schedule.builder.default_export` if it is null.
+   * \return The Builder created.
+   */
+  TVM_DLL static Builder Threaded(int num_threads, runtime::PackedFunc f_build,
+                                  runtime::PackedFunc f_export);
   TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(Builder, runtime::ObjectRef, BuilderNode);
 };
 
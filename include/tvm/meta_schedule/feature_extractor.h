@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef TVM_META_SCHEDULE_FEATURE_EXTRACTOR_H_
+#define TVM_META_SCHEDULE_FEATURE_EXTRACTOR_H_
+
+#include <tvm/meta_schedule/search_strategy.h>
+#include <tvm/runtime/ndarray.h>
+
+namespace tvm {
+namespace meta_schedule {
+
+class TuneContext;
+
+/*! \brief Extractor of the features of measure candidates, the inputs of the cost models. */
+class FeatureExtractorNode : public runtime::Object {
+ public:
+  /*! \brief Virtual destructor */
+  virtual ~FeatureExtractorNode() = default;
+
+  /*!
+   * \brief Extract the features of measure candidates.
+   * \param tune_context The tuning context.
+   * \param candidates The measure candidates.
+   * \return Two NDArrays on the CPU:
+   *  - the float32 features of all the candidates, of shape (num_rows, num_features), the
+   *    rows of each candidate being contiguous;
+   *  - the int64 row offsets, of shape (num_candidates + 1,), the rows of candidate i
+   *    being [offsets[i], offsets[i + 1]).
+   */
+  virtual Array<runtime::NDArray> ExtractFrom(const TuneContext& tune_context,
+                                              const Array<MeasureCandidate>& candidates) = 0;
+
+  static constexpr const char* _type_key = "meta_schedule.FeatureExtractor";
+  TVM_DECLARE_BASE_OBJECT_INFO(FeatureExtractorNode, Object);
+};
+
+/*! \brief The feature extractor with customized methods on the python-side. */
+class PyFeatureExtractorNode : public FeatureExtractorNode {
+ public:
+  /*!
+   * \brief The function type of `ExtractFrom` method.
+   * \param tune_context The tuning context.
+   * \param candidates The measure candidates.
+   * \return The features and the row offsets.
+   */
+  using FExtractFrom = runtime::TypedPackedFunc<Array<runtime::NDArray>(
+      const TuneContext& tune_context, const Array<MeasureCandidate>& candidates)>;
+
+  /*! \brief The packed function to the `ExtractFrom` function. */
+  FExtractFrom f_extract_from;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    // `f_extract_from` is not visited
+  }
+
+  Array<runtime::NDArray> ExtractFrom(const TuneContext& tune_context,
+                                      const Array<MeasureCandidate>& candidates) final {
+    ICHECK(f_extract_from != nullptr) << "PyFeatureExtractor's ExtractFrom method not implemented!";
+    return f_extract_from(tune_context, candidates);
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.PyFeatureExtractor";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PyFeatureExtractorNode, FeatureExtractorNode);
+};
+
+/*!
+ * \brief Managed reference to FeatureExtractorNode
+ * \sa FeatureExtractorNode
+ */
+class FeatureExtractor : public runtime::ObjectRef {
+ public:
+  /*!
+   * \brief Create a feature extractor with customized methods on the python-side.
+   * \param f_extract_from The packed function of `ExtractFrom`.
+   * \return The feature extractor created.
+   */
+  TVM_DLL static FeatureExtractor PyFeatureExtractor(
+      PyFeatureExtractorNode::FExtractFrom f_extract_from);
+  /*!
+   * \brief Create a feature extractor computing one row of features per buffer store.
+   *
+   *  Each candidate is lowered natively to loops over flattened buffers, and its stores are
+   *  described as the auto-scheduler per-store features: the arithmetic, the loop
+   *  annotations and the thread bindings, the accessed buffers, the arithmetic intensity,
+   *  the allocations and the outer loops. The candidates are processed in parallel, with
+   *  the threads of the tuning context.
+   * \param buffers_per_store The number of buffers described for each store, the most
+   *  accessed first.
+   * \param cache_line_bytes The size of a cache line in bytes.
+   * \return The feature extractor created.
+   */
+  TVM_DLL static FeatureExtractor PerStoreFeature(int buffers_per_store, int cache_line_bytes);
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(FeatureExtractor, ObjectRef,
+                                                    FeatureExtractorNode);
+};
+
+}  // namespace meta_schedule
+}  // namespace tvm
+
+#endif  // TVM_META_SCHEDULE_FEATURE_EXTRACTOR_H_
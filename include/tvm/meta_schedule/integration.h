@@ -22,6 +22,8 @@
 #include <tvm/meta_schedule/database.h>
 #include <tvm/support/with.h>
 
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace tvm {
@@ -40,11 +42,14 @@ class ExtractedTaskNode : public runtime::Object {
   IRModule mod;
   /*! \brief A list of low-level IRs that the high-level IR could potentially dispatch to */
   Array<IRModule> dispatched;
+  /*! \brief The number of times the task appears in the high-level IR */
+  int weight;
 
   void VisitAttrs(AttrVisitor* v) {
     v->Visit("task_name", &task_name);
     v->Visit("mod", &mod);
     v->Visit("dispatched", &dispatched);
+    v->Visit("weight", &weight);
   }
 
   static constexpr const char* _type_key = "meta_schedule.ExtractedTask";
@@ -61,8 +66,10 @@ class ExtractedTask : public runtime::ObjectRef {
    * \brief Constructor. The name of the task extracted
    * \brief The high-level IR
    * \brief A list of low-level IRs that the high-level IR could potentially dispatch to
+   * \brief The number of times the task appears in the high-level IR
    */
-  explicit ExtractedTask(String task_name, IRModule mod, Array<IRModule> dispatched);
+  explicit ExtractedTask(String task_name, IRModule mod, Array<IRModule> dispatched,
+                         int weight = 1);
   TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(ExtractedTask, runtime::ObjectRef, ExtractedTaskNode);
 };
 
@@ -154,6 +161,13 @@ class TaskExtractionNode : public MetaScheduleContextNode {
   Optional<ObjectRef> Query(runtime::String task_name, IRModule mod,
                             Optional<Array<IRModule>> dispatched) final;
 
+  /*!
+   * \brief Set the weights of the extracted tasks, as the high-level IR compiler only queries
+   *  each distinct task once.
+   * \param weights The number of uses of each task, by task name.
+   */
+  void UpdateWeights(const Map<String, Integer>& weights);
+
   static constexpr const char* _type_key = "meta_schedule.TaskExtraction";
   TVM_DECLARE_FINAL_OBJECT_INFO(TaskExtractionNode, MetaScheduleContextNode);
 };
@@ -175,14 +189,30 @@ class TaskExtraction : public MetaScheduleContext {
 /*!
  * \brief An integration context that allows application of historically best records from a
  * database
+ *
+ *  The result of each queried workload is kept in an index by structural hash, so that the
+ *  database is queried and the best trace applied once per workload. The index is shared by
+ *  the threads entering the same context, e.g. the ones of a parallel build.
  */
 class ApplyHistoryBestNode : public MetaScheduleContextNode {
  public:
+  /*! \brief A queried workload and its scheduled PrimFunc, undefined without a record. */
+  struct QueryResult {
+    IRModule mod;
+    Optional<tir::PrimFunc> result;
+  };
+
   /*! \brief The database to be queried from */
   Database database{nullptr};
+  /*! \brief The results of the queried workloads, by their structural hash */
+  std::unordered_multimap<Workload::THashCode, QueryResult> results_;
+  /*! \brief The mutex guarding the index and the database */
+  std::mutex mutex_;
 
   void VisitAttrs(AttrVisitor* v) {
-    v->Visit("database", &database);  //
+    v->Visit("database", &database);
+    // `results_` is not visited
+    // `mutex_` is not visited
   }
 
   // Inherited from base class
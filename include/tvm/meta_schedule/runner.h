@@ -194,6 +194,26 @@ class Runner : public runtime::ObjectRef {
    * \return The runner created.
    */
   TVM_DLL static Runner PyRunner(FRun f_run);
+  /*!
+   * \brief Create a runner measuring the inputs on a pool of RPC devices, each driven by a
+   *  thread keeping its session across the inputs.
+   * \param f_create_session The function requesting a session to a device of the pool, given
+   *  the lifetime of the session in seconds.
+   * \param num_devices The number of devices used in parallel.
+   * \param max_retries The number of times an input is retried after a failed attempt.
+   * \param timeout_sec The time after which a measurement is reported to have timed out.
+   * \param session_lifetime_sec The lifetime requested for a session.
+   * \param number The number of times to run the function in one measurement.
+   * \param repeat The number of measurements.
+   * \param min_repeat_ms The minimum duration of one measurement in milliseconds.
+   * \param enable_cpu_cache_flush Whether to flush the CPU caches before each run.
+   * \param alloc_repeat The number of sets of randomly filled arguments.
+   * \return The runner created.
+   */
+  TVM_DLL static Runner RPCPool(runtime::PackedFunc f_create_session, int num_devices,
+                                int max_retries, double timeout_sec, int session_lifetime_sec,
+                                int number, int repeat, int min_repeat_ms,
+                                bool enable_cpu_cache_flush, int alloc_repeat);
   TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(Runner, runtime::ObjectRef, RunnerNode);
 };
 
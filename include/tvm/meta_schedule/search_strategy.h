@@ -28,6 +28,7 @@ namespace meta_schedule {
 
 // Forward declaration
 class TuneContext;
+class CostModel;
 
 /*! \brief The schedule (with input shapes) to be measured. */
 class MeasureCandidateNode : public runtime::Object {
@@ -247,6 +248,27 @@ class SearchStrategy : public runtime::ObjectRef {
    */
   TVM_DLL static SearchStrategy ReplayTrace(int num_trials_per_iter, int num_trials_total);
 
+  /*!
+   * \brief Constructor of evolutionary search strategy.
+   * \param num_trials_per_iter The number of trials per iteration, i.e., the batch size.
+   * \param num_trials_total The total number of trials.
+   * \param population_size The number of schedules in the population.
+   * \param init_measured_ratio The fraction of the initial population taken from the best
+   *  measured traces.
+   * \param genetic_num_iters The number of generations of the evolution.
+   * \param genetic_mutate_prob The probability for a child to be mutated rather than copied.
+   * \param eps_greedy The fraction of each batch made of random schedules.
+   * \param cost_model The cost model scoring the schedules, random scores if not defined.
+   */
+  TVM_DLL static SearchStrategy EvolutionarySearch(int num_trials_per_iter,     //
+                                                   int num_trials_total,        //
+                                                   int population_size,         //
+                                                   double init_measured_ratio,  //
+                                                   int genetic_num_iters,       //
+                                                   double genetic_mutate_prob,  //
+                                                   double eps_greedy,           //
+                                                   Optional<CostModel> cost_model);
+
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(SearchStrategy, ObjectRef, SearchStrategyNode);
 };
 
@@ -246,6 +246,30 @@ class TaskScheduler : public runtime::ObjectRef {
                                           Builder builder,           //
                                           Runner runner,             //
                                           Database database);        //
+  /*!
+   * \brief Create a task scheduler that gives the next round of trials to the task expected to
+   *  reduce the weighted end-to-end latency the most.
+   * \param tasks The tasks to be tuned.
+   * \param task_weights The weight of each task, i.e. the number of times it appears in the model.
+   * \param builder The builder of the scheduler.
+   * \param runner The runner of the scheduler.
+   * \param database The database of the scheduler.
+   * \param alpha The weight of the backward gradient against the forward one.
+   * \param backward_window_size The number of past rounds the backward gradient is computed over.
+   * \param early_stopping_rounds Stop a task after so many rounds without improvement, -1 to
+   *  disable.
+   * \param seed The random seed breaking the ties, -1 for a random one.
+   */
+  TVM_DLL static TaskScheduler GradientBased(
+      Array<TuneContext> tasks,                                     //
+      Array<FloatImm> task_weights,                                 //
+      Builder builder,                                              //
+      Runner runner,                                                //
+      Database database,                                            //
+      double alpha,                                                 //
+      int backward_window_size,                                     //
+      int early_stopping_rounds,                                    //
+      support::LinearCongruentialEngine::TRandState seed);
   TVM_DLL static TaskScheduler PyTaskScheduler(
       Array<TuneContext> tasks,                                   //
       Builder builder,                                            //
@@ -29,7 +29,14 @@
 
 #include <string>
 
+namespace dmlc {
+class Stream;
+}  // namespace dmlc
+
 namespace tvm {
+
+/*! \brief Magic number at the start of the binary serialization of a node graph. */
+constexpr uint64_t kTVMNodeBinaryMagic = 0xB3E0C5A4F05ECB17;
 /*!
  * \brief save the node as well as all the node it depends on as json.
  *  This can be used to serialize any TVM object
@@ -47,5 +54,31 @@ TVM_DLL std::string SaveJSON(const runtime::ObjectRef& node);
  */
 TVM_DLL runtime::ObjectRef LoadJSON(std::string json_str);
 
+/*!
+ * \brief Save the node as well as all the nodes it depends on in a compact binary format.
+ *
+ *  The graph is the one saved by SaveJSON, with its strings interned in a table, its
+ *  indices written as fixed width integers and its tensors as raw payloads. LoadJSON also
+ *  accepts the result.
+ *
+ * \param strm The output stream.
+ * \param node The node to save.
+ */
+TVM_DLL void SaveBinary(dmlc::Stream* strm, const runtime::ObjectRef& node);
+
+/*!
+ * \brief Save the node in the binary format of SaveBinary to a string.
+ * \param node The node to save.
+ * \return The binary serialization of the node.
+ */
+TVM_DLL std::string SaveBinary(const runtime::ObjectRef& node);
+
+/*!
+ * \brief Load a node saved by SaveBinary, reading the stream sequentially.
+ * \param strm The input stream.
+ * \return The loaded node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinary(dmlc::Stream* strm);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
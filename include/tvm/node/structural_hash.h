@@ -25,8 +25,10 @@
 
 #include <tvm/node/functor.h>
 #include <tvm/runtime/data_type.h>
+#include <tvm/support/with.h>
 
 #include <functional>
+#include <memory>
 #include <string>
 
 namespace tvm {
@@ -83,6 +85,72 @@ class StructuralHash : public BaseValueHash {
   TVM_DLL size_t operator()(const ObjectRef& key) const;
 };
 
+/*!
+ * \brief A cache of subtree hashes, reused by the StructuralHash calls made in its scope.
+ *
+ *  The hash of a subtree that mentions no variable and no graph node is reused anywhere.
+ *  The hash of a subtree that only mentions the variables and graph nodes it contains is
+ *  reused when the subtree starts at the same free variable and graph node counts, so the
+ *  hash values are the same as without the cache, map_free_vars included.
+ *
+ *  The cache holds a reference to the nodes it knows, which makes copy on write copy them
+ *  rather than update them. IRModule, which is updated in place, is never cached, nor is a
+ *  node containing one. The cache is thread safe and may be shared by several threads.
+ *
+ * \code
+ *
+ *  SHashCache cache;
+ *  {
+ *    With<SHashCacheContext> scope(&cache);
+ *    size_t hash = StructuralHash()(func);
+ *  }
+ *
+ * \endcode
+ */
+class SHashCache {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param max_entries The number of cached subtrees above which the cache is cleared.
+   */
+  TVM_DLL explicit SHashCache(size_t max_entries = 1 << 16);
+  TVM_DLL ~SHashCache();
+  /*! \brief Forget all the cached hashes. */
+  TVM_DLL void Clear();
+  /*! \return The number of cached subtrees. */
+  TVM_DLL size_t size() const;
+  /*! \return The cache of the innermost SHashCacheContext of this thread, nullptr if none. */
+  TVM_DLL static SHashCache* Current();
+
+  class Impl;
+
+ private:
+  friend class SHashCacheContext;
+  friend class VarCountingSHashHandler;
+  /*! \brief The cached hashes. */
+  std::unique_ptr<Impl> impl_;
+};
+
+/*!
+ * \brief The scope in which the StructuralHash calls of this thread use a SHashCache.
+ */
+class SHashCacheContext {
+ private:
+  // declare friend to enable with.
+  friend class With<SHashCacheContext>;
+  /*!
+   * \brief Constructor.
+   * \param cache The cache, which must outlive the scope.
+   */
+  explicit SHashCacheContext(SHashCache* cache) : cache_(cache) {}
+  TVM_DLL void EnterWithScope();
+  TVM_DLL void ExitWithScope();
+  /*! \brief The cache. */
+  SHashCache* cache_;
+  /*! \brief The cache of the enclosing scope. */
+  SHashCache* prev_{nullptr};
+};
+
 /*!
  * \brief A Reducer class to reduce the structural hash value.
  *
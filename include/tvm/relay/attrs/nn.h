@@ -1123,6 +1123,32 @@ struct BatchMatmulAttrs : public tvm::AttrsNode<BatchMatmulAttrs> {
   }
 };
 
+/*! \brief Attributes for fused attention operator */
+struct FusedAttentionAttrs : public tvm::AttrsNode<FusedAttentionAttrs> {
+  double scale;
+
+  TVM_DECLARE_ATTRS(FusedAttentionAttrs, "relay.attrs.FusedAttentionAttrs") {
+    TVM_ATTR_FIELD(scale).set_default(1.0).describe(
+        "The factor applied to the query-key products before the softmax.");
+  }
+};
+
+/*! \brief Attributes for weight_only_dense operator */
+struct WeightOnlyDenseAttrs : public tvm::AttrsNode<WeightOnlyDenseAttrs> {
+  int bits;
+  int group_size;
+  DataType out_dtype;
+
+  TVM_DECLARE_ATTRS(WeightOnlyDenseAttrs, "relay.attrs.WeightOnlyDenseAttrs") {
+    TVM_ATTR_FIELD(bits).set_default(4).describe("The number of bits of a weight, 4 or 8.");
+    TVM_ATTR_FIELD(group_size).set_default(128).describe("The number of inputs sharing a scale.");
+    // use 0 bits to indicate none.
+    TVM_ATTR_FIELD(out_dtype)
+        .set_default(NullValue<DataType>())
+        .describe("Output data type, the one of the data when not set.");
+  }
+};
+
 /*! \brief Attributes for sparse_dense operator */
 struct SparseDenseAttrs : public tvm::AttrsNode<SparseDenseAttrs> {
   bool sparse_lhs;
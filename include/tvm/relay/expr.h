@@ -864,6 +864,36 @@ ObjAllocatorBase<SimpleObjAllocator>::make_object<relay::CallNode>() {
   return ObjectPtr<T>(ptr);
 }
 
+template <>
+template <>
+inline ObjectPtr<relay::LetNode>
+ObjAllocatorBase<PooledObjAllocator>::make_object<relay::LetNode>() {
+  using Derived = PooledObjAllocator;
+  using T = relay::LetNode;
+  using Handler = typename Derived::template Handler<T>;
+  static_assert(std::is_base_of<Object, T>::value, "make can only be used to create Object");
+  T* ptr = Handler::New(static_cast<Derived*>(this));
+  ptr->type_index_ = T::RuntimeTypeIndex();
+  ptr->saved_deleter_ = Handler::Deleter();
+  ptr->deleter_ = relay::LetNode::Deleter_;
+  return ObjectPtr<T>(ptr);
+}
+
+template <>
+template <>
+inline ObjectPtr<relay::CallNode>
+ObjAllocatorBase<PooledObjAllocator>::make_object<relay::CallNode>() {
+  using Derived = PooledObjAllocator;
+  using T = relay::CallNode;
+  using Handler = typename Derived::template Handler<T>;
+  static_assert(std::is_base_of<Object, T>::value, "make can only be used to create Object");
+  T* ptr = Handler::New(static_cast<Derived*>(this));
+  ptr->type_index_ = T::RuntimeTypeIndex();
+  ptr->saved_deleter_ = Handler::Deleter();
+  ptr->deleter_ = relay::CallNode::Deleter_;
+  return ObjectPtr<T>(ptr);
+}
+
 }  // namespace runtime
 
 }  // namespace tvm
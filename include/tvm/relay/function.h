@@ -189,6 +189,8 @@ constexpr const char* kInline = "Inline";
 constexpr const char* kPartitionedFromPattern = "PartitionedFromPattern";
 /*! \brief Mark the function as only composed of reshape operations. */
 constexpr const char* kReshapeOnly = "relay.reshape_only";
+/*! \brief The indices of the parameters of a primitive function its result may overwrite. */
+constexpr const char* kInPlaceParams = "relay.in_place_params";
 }  // namespace attr
 
 }  // namespace relay
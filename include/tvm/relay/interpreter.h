@@ -37,6 +37,7 @@
 #include <tvm/ir/module.h>
 #include <tvm/relay/expr.h>
 #include <tvm/runtime/container/closure.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
 #include <tvm/target/target.h>
 
@@ -174,6 +175,19 @@ class ConstructorValue : public ObjectRef {
 TypedPackedFunc<ObjectRef(Array<Expr>)> EvalFunction(IRModule mod, Expr expr, Device device,
                                                      Target target);
 
+/*!
+ * \brief Evaluates \p expr directly when it is an elementwise arithmetic operator on two small
+ * constants, without lowering nor compiling it.
+ *
+ * Only add, subtract, multiply, maximum and minimum on int32, int64, float32 and float64 tensors
+ * of the same shape, or of which one is a scalar, are supported, on the CPU.
+ *
+ * \param expr An expression to evaluate.
+ * \param device The device of the result.
+ * \return The result, or a null NDArray when \p expr is not supported.
+ */
+runtime::NDArray EvalDirect(const Expr& expr, Device device);
+
 /*!
  * \brief Evaluates \p expr and returns its result.
  *
@@ -151,6 +151,19 @@ using FTVMAlterOpLayout =
     runtime::TypedPackedFunc<Expr(const Attrs& attrs, const Array<Expr>& args,
                                   const Array<te::Tensor>& tinfos, const Type& out_type)>;
 
+/*!
+ * \brief The layouts an operator can be altered to, for the global layout planning of the
+ *  AlterOpLayout pass. The planned candidate is then read by FTVMAlterOpLayout.
+ * \param attrs The attribute of the original node.
+ * \param tinfos An array of placeholders, use for getting the inferred shape
+ *               and dtype of the inputs.
+ * \param out_type The output type of the original node.
+ * \return The candidates, each an array of the data layout (String), the output layout
+ *  (String) and the estimated compute cost (FloatImm).
+ */
+using FTVMLayoutCandidates = runtime::TypedPackedFunc<Array<Array<ObjectRef>>(
+    const Attrs& attrs, const Array<te::Tensor>& tinfos, const Type& out_type)>;
+
 /*!
  * \brief Convert the layout of operators or replace the
  *  operator with other expressions. This function will be invoked
@@ -51,6 +51,16 @@ namespace transform {
  */
 TVM_DLL Pass Legalize();
 
+/*!
+ * \brief Merge the chains of requantize, quantize and dequantize ops with constant scalar
+ * quantization parameters into single requantize ops, so that each chain is lowered to one
+ * fixed point multiply. A chain is only merged when it does not change the clipping of its
+ * result.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass FoldRequantize();
+
 }  // namespace transform
 
 }  // namespace qnn
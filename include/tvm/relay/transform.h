@@ -413,6 +413,15 @@ TVM_DLL Pass EtaExpand(bool expand_constructor, bool expand_global_var);
  */
 TVM_DLL Pass PartitionGraph();
 
+/*!
+ * \brief Move the injective ops between the external functions of a partitioned Relay program
+ * into the external function they feed or are fed by, when its codegen supports them through
+ * the "target.<compiler>" op attribute or a composite pattern.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass FuseBoundaryOps();
+
 /*!
  * \brief Inline the global functions marked as `inline` in a given Relay
  * IRModule.
@@ -438,6 +447,16 @@ TVM_DLL Pass RemoveUnusedFunctions(Array<runtime::String> entry_functions);
  */
 TVM_DLL Pass SimplifyExpr();
 
+/*!
+ * \brief Wrap segments of the functions in annotation.checkpoint, so their reverse mode
+ * gradient recomputes the activations of a segment instead of storing them.
+ *
+ * \param budget_bytes The bytes of the activations the gradient may keep alive at once.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass AutoCheckpoint(int64_t budget_bytes);
+
 /*!
  * \brief Run any registered RelayToTIR passes registered on the functions in a module.
  *
@@ -456,6 +475,18 @@ TVM_DLL Pass RelayToTIRTargetHook();
  */
 TVM_DLL Pass ManifestAlloc(SEScope cpu_se_scope);
 
+/*!
+ * \brief A pass sharing the statically sized storages allocated by ManifestAlloc.
+ *
+ * Within each block of let bindings, the storages of a constant size with disjoint lifetimes
+ * are backed by the same storage, allocated once at the start of the block. With the
+ * "relay.vm.plan_static_storage.in_place" option, the result of an elementwise primitive may
+ * also overwrite the storage of an argument not used after the call.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass PlanStaticStorage();
+
 /*!
  * \brief Uses existing "on_device" and "device_copy" CallNodes to infer the \p SEScope on which
  * every Relay sub-expression should run and the result stored. Captures the result of that
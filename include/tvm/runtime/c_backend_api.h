@@ -123,6 +123,11 @@ typedef struct {
   void* sync_handle;
   /*! \brief total amount of task */
   int32_t num_task;
+  /*!
+   * \brief The number of threads, including the calling one, that a parallel
+   *  launch nested in one task of this group may use.
+   */
+  int32_t thread_budget;
 } TVMParallelGroupEnv;
 
 /*!
@@ -139,7 +144,13 @@ typedef int (*FTVMParallelLambda)(int task_id, TVMParallelGroupEnv* penv, void*
  * \param flambda The parallel function to be launched.
  * \param cdata The closure data.
  * \param num_task Number of tasks to launch, can be 0, means launch
- *           with all available threads.
+ *           with all available threads. A negative value also launches
+ *           with all available threads, but always with one task per thread,
+ *           as the lambdas calling TVMBackendParallelBarrier need.
+ *
+ * \note A launch from inside a running parallel task is nested: it runs on the
+ *  idle threads of the same pool, bounded by the thread_budget of the enclosing
+ *  task, and the lambda sees the number of tasks actually launched.
  *
  * \return 0 when no error is thrown, -1 when failure happens
  */
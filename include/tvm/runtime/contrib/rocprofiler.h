@@ -0,0 +1,45 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \brief Performance counters of AMD GPUs for profiling via rocprofiler.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_ROCPROFILER_H_
+#define TVM_RUNTIME_CONTRIB_ROCPROFILER_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/profiling.h>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief Construct a metric collector that reads the hardware performance
+ * counters of the kernels run on ROCm devices through rocprofiler.
+ *
+ * \param metrics The metrics collected on each call, with the names used by
+ * rocprof (see `rocprof --list-derived`). Empty for the device memory traffic,
+ * the L2 hit rate and the memory and vector ALU busy times.
+ */
+TVM_DLL MetricCollector CreateROCProfilerMetricCollector(Array<String> metrics);
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_ROCPROFILER_H_
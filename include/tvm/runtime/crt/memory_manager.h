@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/crt/memory_manager.h
+ * \brief The dynamic memory allocator of the CRT, selected with TVM_CRT_MEMORY_MANAGER.
+ */
+
+#ifndef TVM_RUNTIME_CRT_MEMORY_MANAGER_H_
+#define TVM_RUNTIME_CRT_MEMORY_MANAGER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/page_allocator.h>
+#include <tvm/runtime/crt/tlsf_allocator.h>
+
+/*! \brief The page allocator, see page_allocator.h. */
+#define TVM_CRT_MEMORY_MANAGER_PAGE 0
+/*! \brief The TLSF allocator, see tlsf_allocator.h. */
+#define TVM_CRT_MEMORY_MANAGER_TLSF 1
+
+/*!
+ * \brief Create the memory manager selected by TVM_CRT_MEMORY_MANAGER in crt_config.h, the page
+ * allocator when it is not defined.
+ *
+ * \param manager Pointer, initialized with the new MemoryManager.
+ * \param memory_pool Pointer to the global memory pool used by the CRT.
+ * \param memory_pool_size_bytes Size of `memory_pool`, in bytes.
+ * \param page_size_bytes_log2 log2 of the page size of the page allocator, in bytes.
+ * \return kTvmErrorNoError on success.
+ */
+tvm_crt_error_t CRTMemoryManagerCreate(MemoryManagerInterface** manager, uint8_t* memory_pool,
+                                       size_t memory_pool_size_bytes, size_t page_size_bytes_log2);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_MEMORY_MANAGER_H_
@@ -116,6 +116,17 @@ tvm_crt_error_t TVMPlatformTimerStop(double* elapsed_time_seconds);
  */
 tvm_crt_error_t TVMPlatformGenerateRandom(uint8_t* buffer, size_t num_bytes);
 
+/*! \brief Read a free running cycle counter, such as the DWT CYCCNT register of Cortex-M cores.
+ *
+ * This function is called around each operator run by the graph executor profiler, so it
+ * should be cheap. It does not need to be implemented for inference tasks and an internal
+ * weak-linked stub is provided, in which case the profiler cannot be enabled.
+ *
+ * \param cycles Pointer to write the counter value into.
+ * \return kTvmErrorNoError if successful; a descriptive error code otherwise.
+ */
+tvm_crt_error_t TVMPlatformProfilerCycles(uint64_t* cycles);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/crt/tlsf_allocator.h
+ * \brief A two-level segregated fit (TLSF) memory allocator for microcontrollers.
+ *
+ * Blocks are kept in free lists indexed by a power of two and a linear subdivision of it,
+ * found through two bitmaps, so allocation and free take a bounded time independent of the
+ * number of blocks. Freed blocks are merged with their free neighbours immediately, and the
+ * free blocks are found with a good fit, which bounds the fragmentation.
+ */
+
+#ifndef TVM_RUNTIME_CRT_TLSF_ALLOCATOR_H_
+#define TVM_RUNTIME_CRT_TLSF_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/page_allocator.h>
+
+/*!
+ * \brief Create a TLSF memory manager.
+ *
+ * The manager keeps its state at the start of `memory_pool`, the rest of the pool is allocated.
+ *
+ * \param manager Pointer, initialized with the new MemoryManager.
+ * \param memory_pool Pointer to the global memory pool used by the CRT.
+ * \param memory_pool_size_bytes Size of `memory_pool`, in bytes.
+ * \return kTvmErrorNoError on success.
+ */
+tvm_crt_error_t TLSFMemoryManagerCreate(MemoryManagerInterface** manager, uint8_t* memory_pool,
+                                        size_t memory_pool_size_bytes);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_TLSF_ALLOCATOR_H_
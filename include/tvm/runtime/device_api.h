@@ -28,6 +28,7 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <functional>
 #include <string>
 
 namespace tvm {
@@ -122,6 +123,24 @@ class TVM_DLL DeviceAPI {
    * \param ptr The data space.
    */
   virtual void FreeDataSpace(Device dev, void* ptr) = 0;
+  /*!
+   * \brief Allocate page-locked host memory the device can copy from and to asynchronously.
+   *
+   *  The memory is addressed as a kDLCPU buffer and is reused as the staging area of
+   *  host to device transfers. The default implementation returns nullptr, which means
+   *  the device has no pinned host memory and pageable memory should be used instead.
+   *
+   * \param dev The device the transfers are made with.
+   * \param nbytes The size of the memory in bytes.
+   * \return The allocated host memory, or nullptr when unsupported.
+   */
+  virtual void* AllocPinnedHostSpace(Device dev, size_t nbytes);
+  /*!
+   * \brief Free memory returned by AllocPinnedHostSpace.
+   * \param dev The device passed to AllocPinnedHostSpace.
+   * \param ptr The host memory.
+   */
+  virtual void FreePinnedHostSpace(Device dev, void* ptr);
   /*!
    * \brief copy data from one place to another
    * \note This API is designed to support special memory with shape dependent layout.
@@ -171,6 +190,19 @@ class TVM_DLL DeviceAPI {
    * \param event_dst The destination stream to synchronize.
    */
   virtual void SyncStreamFromTo(Device dev, TVMStreamHandle event_src, TVMStreamHandle event_dst);
+  /*!
+   * \brief Call a host function once the work queued on a stream so far has finished.
+   *
+   *  The default implementation synchronizes the stream and calls the function on the
+   *  calling thread. Devices that can signal completion asynchronously call it from a
+   *  driver thread instead, where it must not call back into the device API.
+   *
+   * \param dev The device of the stream.
+   * \param stream The stream.
+   * \param callback The function to call.
+   */
+  virtual void StreamAddCallback(Device dev, TVMStreamHandle stream,
+                                 std::function<void()> callback);
   /*!
    * \brief Allocate temporal workspace for backend execution.
    *
@@ -25,10 +25,16 @@
 
 #include <tvm/runtime/object.h>
 
+#include <cstdint>
 #include <cstdlib>
+#include <new>
 #include <type_traits>
 #include <utility>
 
+#ifndef TVM_USE_OBJECT_POOL
+#define TVM_USE_OBJECT_POOL 0
+#endif
+
 namespace tvm {
 namespace runtime {
 /*!
@@ -43,11 +49,10 @@ inline ObjectPtr<T> make_object(Args&&... args);
 // Detail implementations after this
 //
 // The current design allows swapping the
-// allocator pattern when necessary.
+// allocator pattern when necessary, see PooledObjAllocator.
 //
 // Possible future allocator optimizations:
 // - Arena allocator that gives ownership of memory to arena (deleter_= nullptr)
-// - Thread-local object pools: one pool per size and alignment requirement.
 // - Can specialize by type of object to give the specific allocator to each object.
 
 /*!
@@ -191,15 +196,143 @@ class SimpleObjAllocator : public ObjAllocatorBase<SimpleObjAllocator> {
   };
 };
 
+/*! \brief The size of the largest blocks of the object pool. */
+constexpr size_t kObjectPoolMaxBytes = 256;
+/*! \brief The granularity and the alignment of the blocks of the object pool. */
+constexpr size_t kObjectPoolAlignment = 16;
+
+/*! \brief The counters of the object pool, summed over the threads. */
+struct ObjectPoolStats {
+  /*! \brief The number of blocks allocated and freed. */
+  uint64_t num_allocs;
+  uint64_t num_frees;
+  /*! \brief The number of times a thread cache was refilled from the shared pool. */
+  uint64_t num_refills;
+  /*! \brief The bytes taken from the heap by the pool, which it never returns. */
+  uint64_t reserved_bytes;
+};
+
+namespace detail {
+/*!
+ * \brief Allocate a block of the object pool.
+ * \param size_class The size of the block in units of kObjectPoolAlignment, minus one.
+ * \return The block, aligned to kObjectPoolAlignment.
+ */
+TVM_DLL void* ObjectPoolAlloc(size_t size_class);
+/*!
+ * \brief Free a block of the object pool, from any thread.
+ * \param ptr The block.
+ * \param size_class The size class it was allocated with.
+ */
+TVM_DLL void ObjectPoolFree(void* ptr, size_t size_class);
+}  // namespace detail
+
+/*! \return The counters of the object pool. */
+TVM_DLL ObjectPoolStats GetObjectPoolStats();
+
+/*!
+ * \brief Allocator taking the small objects from the object pool, the others from the heap.
+ *
+ *  The pool keeps the freed blocks of each size in a cache of the thread that frees them,
+ *  so the objects created and destroyed in bulk by the compiler passes and the executors
+ *  mostly reuse the memory of the same thread without a malloc. The objects keep their
+ *  deleter, so they can be mixed with the objects of SimpleObjAllocator.
+ */
+class PooledObjAllocator : public ObjAllocatorBase<PooledObjAllocator> {
+ public:
+  template <typename T>
+  class Handler {
+   public:
+    using StorageType = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+    static constexpr bool kPooled =
+        sizeof(StorageType) <= kObjectPoolMaxBytes && alignof(T) <= kObjectPoolAlignment;
+    static constexpr size_t kSizeClass = (sizeof(StorageType) - 1) / kObjectPoolAlignment;
+
+    template <typename... Args>
+    static T* New(PooledObjAllocator*, Args&&... args) {
+      if (!kPooled) {
+        return SimpleObjAllocator::Handler<T>::New(nullptr, std::forward<Args>(args)...);
+      }
+      void* data = detail::ObjectPoolAlloc(kSizeClass);
+      new (data) T(std::forward<Args>(args)...);
+      return reinterpret_cast<T*>(data);
+    }
+
+    static Object::FDeleter Deleter() {
+      return kPooled ? Deleter_ : SimpleObjAllocator::Handler<T>::Deleter();
+    }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      detail::ObjectPoolFree(tptr, kSizeClass);
+    }
+  };
+
+  // Array handler keeping in front of each array the size class of its block, or
+  // kHeapBlock when the array is too large for the pool.
+  template <typename ArrayType, typename ElemType>
+  class ArrayHandler {
+   public:
+    static_assert(alignof(ArrayType) <= kObjectPoolAlignment &&
+                      alignof(ElemType) <= kObjectPoolAlignment,
+                  "element alignment constraint");
+
+    template <typename... Args>
+    static ArrayType* New(PooledObjAllocator*, size_t num_elems, Args&&... args) {
+      size_t requested_size =
+          kObjectPoolAlignment + num_elems * sizeof(ElemType) + sizeof(ArrayType);
+      char* block;
+      size_t size_class;
+      if (requested_size <= kObjectPoolMaxBytes) {
+        size_class = (requested_size - 1) / kObjectPoolAlignment;
+        block = static_cast<char*>(detail::ObjectPoolAlloc(size_class));
+      } else {
+        size_class = kHeapBlock;
+        block = static_cast<char*>(::operator new(requested_size));
+      }
+      *reinterpret_cast<size_t*>(block) = size_class;
+      ArrayType* ptr = reinterpret_cast<ArrayType*>(block + kObjectPoolAlignment);
+      new (ptr) ArrayType(std::forward<Args>(args)...);
+      return ptr;
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static constexpr size_t kHeapBlock = ~static_cast<size_t>(0);
+
+    static void Deleter_(Object* objptr) {
+      ArrayType* tptr = static_cast<ArrayType*>(objptr);
+      tptr->ArrayType::~ArrayType();
+      char* block = reinterpret_cast<char*>(tptr) - kObjectPoolAlignment;
+      size_t size_class = *reinterpret_cast<size_t*>(block);
+      if (size_class == kHeapBlock) {
+        ::operator delete(block);
+      } else {
+        detail::ObjectPoolFree(block, size_class);
+      }
+    }
+  };
+};
+
+/*! \brief The allocator of make_object, the pooled one when built with USE_OBJECT_POOL. */
+#if TVM_USE_OBJECT_POOL
+using DefaultObjAllocator = PooledObjAllocator;
+#else
+using DefaultObjAllocator = SimpleObjAllocator;
+#endif
+
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args) {
-  return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
+  return DefaultObjAllocator().make_object<T>(std::forward<Args>(args)...);
 }
 
 template <typename ArrayType, typename ElemType, typename... Args>
 inline ObjectPtr<ArrayType> make_inplace_array_object(size_t num_elems, Args&&... args) {
-  return SimpleObjAllocator().make_inplace_array<ArrayType, ElemType>(num_elems,
-                                                                      std::forward<Args>(args)...);
+  return DefaultObjAllocator().make_inplace_array<ArrayType, ElemType>(
+      num_elems, std::forward<Args>(args)...);
 }
 
 }  // namespace runtime
@@ -139,6 +139,25 @@ class NDArray : public ObjectRef {
    * \note The memory size of new array must be smaller than the current one.
    */
   TVM_DLL NDArray CreateView(ShapeTuple shape, DLDataType dtype);
+  /*!
+   * \brief Create a strided NDArray that shares the data memory with the current one.
+   * \param shape The shape of the new array.
+   * \param strides The strides of the new array, in elements.
+   * \param elem_offset The offset of the first element of the new array, in elements.
+   * \return The created view, compact when the strides match the shape.
+   * \note The current array must be compact, and the view stays in its memory.
+   */
+  TVM_DLL NDArray CreateStridedView(ShapeTuple shape, ShapeTuple strides,
+                                    int64_t elem_offset) const;
+  /*!
+   * \brief Create a view of the range [begin, end) of an axis, without copying.
+   * \param axis The sliced axis.
+   * \param begin The first index of the range.
+   * \param end The end of the range.
+   * \return The created view, which is strided unless the outer axes have one element.
+   * \note The current array must be compact.
+   */
+  TVM_DLL NDArray Slice(int axis, int64_t begin, int64_t end) const;
   /*!
    * \brief Create a reference view of NDArray that
    *  represents as DLManagedTensor.
@@ -302,6 +321,8 @@ class NDArray::Container : public Object, public NDArray::ContainerBase {
   TVM_DECLARE_BASE_OBJECT_INFO(NDArray::Container, Object);
 
  protected:
+  /*! \brief The strides of a strided view, pointed to by dl_tensor.strides. */
+  Optional<ShapeTuple> strides_;
   friend class RPCWrappedFunc;
   friend class NDArray;
 };
@@ -338,6 +359,25 @@ inline bool IsContiguous(const DLTensor& arr) {
   return true;
 }
 
+/*!
+ * \brief Get the address of the first element of a compact DLTensor, which a tensor without
+ *  byte offset can point to.
+ * \param arr The input DLTensor.
+ * \param alignment The alignment the address must have.
+ * \return The address, or nullptr when the tensor is strided or misaligned, or has a byte
+ *  offset on a device whose memory handles are not plain addresses.
+ */
+inline void* GetCompactDataAddress(const DLTensor& arr, size_t alignment) {
+  if (!IsContiguous(arr)) return nullptr;
+  DLDeviceType device_type = arr.device.device_type;
+  if (arr.byte_offset != 0 && device_type != kDLCPU && device_type != kDLCUDA &&
+      device_type != kDLCUDAHost && device_type != kDLROCM) {
+    return nullptr;
+  }
+  void* data = static_cast<char*>(arr.data) + arr.byte_offset;
+  return reinterpret_cast<size_t>(data) % alignment == 0 ? data : nullptr;
+}
+
 inline bool NDArray::IsContiguous() const {
   return ::tvm::runtime::IsContiguous(get_mutable()->dl_tensor);
 }
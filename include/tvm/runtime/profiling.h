@@ -30,6 +30,7 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <chrono>
 #include <stack>
 #include <string>
 #include <unordered_map>
@@ -181,7 +182,7 @@ class ReportNode : public Object {
    * Each element is a mapping from metric name to value. Some metrics that
    * appear in every call are "Name" (the function name), "Argument Shapes",
    * and "Duration (us)". Values are one of `String`, `PercentNode`,
-   * `DurationNode`, or `CountNode`.
+   * `DurationNode`, `CountNode`, or `RatioNode`.
    */
   Array<Map<String, ObjectRef>> calls;
   /*! \brief Metrics collected for the entire run of the model on a per-device basis.
@@ -245,6 +246,15 @@ class ReportNode : public Object {
    * \endcode
    */
   String AsJSON() const;
+  /*! \brief Convert the calls of this report to a timeline in the Chrome trace event format,
+   *  which chrome://tracing and Perfetto display.
+   *
+   * Each device is a process and each host thread making calls a thread of it. A call starts
+   * when the host issued it and lasts its measured duration, so the calls queued on an
+   * asynchronous device are shifted by their launch latency. Calls without a recorded start,
+   * from reports made by other tools, are laid out one after the other.
+   */
+  String AsChromeTrace() const;
 
   static constexpr const char* _type_key = "runtime.profiling.Report";
   TVM_DECLARE_FINAL_OBJECT_INFO(ReportNode, Object);
@@ -332,6 +342,10 @@ struct CallFrame {
    * associated data (returned from MetricCollector.Start).
    */
   std::vector<std::pair<MetricCollector, ObjectRef>> extra_collectors;
+  /*! Host time of the call, in nanoseconds since `Profiler::Start` */
+  int64_t start_ns{0};
+  /*! Index of the host thread making the call */
+  int64_t thread{0};
 };
 
 /*! Runtime profiler for function and/or operator calls. Used in the graph
@@ -412,6 +426,8 @@ class Profiler {
   std::vector<CallFrame> calls_;
   std::stack<CallFrame> in_flight_;
   std::vector<MetricCollector> collectors_;
+  /*! The host time of `Start`, the origin of the call start times */
+  std::chrono::steady_clock::time_point start_time_;
 };
 
 /* \brief A duration in time. */
@@ -459,6 +475,21 @@ class CountNode : public Object {
   TVM_DECLARE_FINAL_OBJECT_INFO(CountNode, Object);
 };
 
+/* A ratio of two things, such as a throughput. Aggregated calls report the mean ratio. */
+class RatioNode : public Object {
+ public:
+  /* The ratio as a floating point value */
+  double ratio;
+
+  /* \brief Construct a new ratio.
+   * \param a The ratio.
+   */
+  explicit RatioNode(double a) : ratio(a) {}
+
+  static constexpr const char* _type_key = "runtime.profiling.Ratio";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RatioNode, Object);
+};
+
 /*! \brief String representation of an array of NDArray shapes
  *  \param shapes Array of NDArrays to get the shapes of.
  *  \return A textual representation of the shapes. For example: `float32[2], int64[1, 2]`.
@@ -476,6 +507,11 @@ String ShapeString(NDArray shape, DLDataType dtype);
  *  \return A textual representation of the shape. For example: `float32[2]`.
  */
 String ShapeString(const std::vector<int64_t>& shape, DLDataType dtype);
+/*! \brief Name of a device as it appears in `Report::device_metrics`.
+ *  \param dev The device.
+ *  \return The device name followed by its id. For example: `cuda0`.
+ */
+std::string DeviceString(Device dev);
 
 }  // namespace profiling
 }  // namespace runtime
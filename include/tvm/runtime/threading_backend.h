@@ -80,6 +80,21 @@ class ThreadGroup {
    */
   int Configure(AffinityMode mode, int nthreads, bool exclude_worker0);
 
+  /*!
+   * \brief configure the workers to run on the CPUs of one NUMA node
+   *
+   *  The main thread is bound to the CPUs of the node as well, so that the memory first
+   *  touched by it or by the workers, such as their workspaces and the tensors of an
+   *  executor created on it, is allocated on the node.
+   *
+   * \param node The NUMA node, see NumNumaNodes.
+   * \param nthreads The number of threads to use (0 = one per physical core of the node).
+   * \param exclude_worker0 Whether to use the main thread as a worker.
+   *
+   * \return The number of workers to use.
+   */
+  int ConfigureNumaNode(int node, int nthreads, bool exclude_worker0);
+
  private:
   Impl* impl_;
 };
@@ -91,9 +106,18 @@ void Yield();
 
 /*!
  * \return the maximum number of effective workers for this system.
+ *
+ *  TVM_NUM_THREADS or OMP_NUM_THREADS when set. Otherwise the number of physical cores the
+ *  process may run on, bounded by the CPU affinity and the cgroup CPU quota on Linux, which
+ *  are queried on the first call only.
  */
 int MaxConcurrency();
 
+/*!
+ * \return The number of NUMA nodes of this system, 1 when it is not known.
+ */
+int NumNumaNodes();
+
 /*!
  * \brief Reset the threads in the pool. All current threads are destroyed and
  * new ones are created.
@@ -102,6 +126,37 @@ int MaxConcurrency();
  */
 void ResetThreadPool();
 
+/*!
+ * \brief Start a parallel region of the thread pool of the calling thread. Until the matching
+ *  EndParallelRegion, the workers keep running between the parallel launches of this thread,
+ *  which then only pay a barrier each.
+ *
+ * Note that this does nothing when openmp is used.
+ */
+void BeginParallelRegion();
+
+/*!
+ * \brief End the parallel region started by the matching BeginParallelRegion.
+ */
+void EndParallelRegion();
+
+/*!
+ * \brief A parallel region lasting until the end of the scope.
+ */
+class ParallelRegionScope {
+ public:
+  /*! \param enable Whether to start a region, no region is started otherwise. */
+  explicit ParallelRegionScope(bool enable = true) : enabled_(enable) {
+    if (enabled_) BeginParallelRegion();
+  }
+  ~ParallelRegionScope() {
+    if (enabled_) EndParallelRegion();
+  }
+
+ private:
+  bool enabled_;
+};
+
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
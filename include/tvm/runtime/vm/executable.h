@@ -42,6 +42,12 @@ namespace vm {
 
 struct VMFunction;
 
+/*!
+ * \brief The key of the operator attributes marking the shape functions, whose outputs the VM
+ * memoizes by their inputs.
+ */
+constexpr const char* kShapeFuncAttr = "shape_func";
+
 /*!
  * \brief The executable emitted by the VM compiler.
  *
@@ -97,6 +103,20 @@ class Executable : public ModuleNode {
    */
   static runtime::Module Load(const std::string& code, const runtime::Module lib);
 
+  /*!
+   * \brief Load a VM executable saved by SaveToFile without copying its constants.
+   *
+   * The file is memory mapped and host constants are exposed as NDArray views into
+   * the mapping; constants placed on other devices are still uploaded by the VM the
+   * first time they are used.
+   *
+   * \param file_name The file holding the serialized bytecode.
+   * \param lib The compiled runtime library.
+   *
+   * \return exe The constructed executable.
+   */
+  static runtime::Module LoadFromFile(const std::string& file_name, const runtime::Module lib);
+
   /*!
    * \brief Get the serialized form of the `functions`. This is
    * essentially bytecode serialization.
@@ -238,9 +258,12 @@ class Executable : public ModuleNode {
   /*!
    * \brief Save the constant pool.
    *
-   * \param strm The output stream.
+   * Constant payloads are aligned relative to the start of the bytecode so that
+   * LoadFromFile can map them in place.
+   *
+   * \param strm The output stream, positioned relative to the start of the bytecode.
    */
-  void SaveConstantSection(dmlc::Stream* strm);
+  void SaveConstantSection(dmlc::SeekStream* strm);
 
   /*!
    * \brief Save primitive op names.
@@ -274,8 +297,10 @@ class Executable : public ModuleNode {
    * \brief Load the constant pool.
    *
    * \param strm The input stream.
+   * \param base When not null, the bytes strm reads from; aligned constants become views.
+   * \param owner The object keeping base alive.
    */
-  void LoadConstantSection(dmlc::Stream* strm);
+  void LoadConstantSection(dmlc::Stream* strm, const char* base, const ObjectRef& owner);
 
   /*!
    * \brief Load primitive op names.
@@ -291,6 +316,17 @@ class Executable : public ModuleNode {
    */
   void LoadCodeSection(dmlc::Stream* strm);
 
+  /*!
+   * \brief Load an executable from a stream over the serialized bytecode.
+   *
+   * \param strm The input stream.
+   * \param lib The compiled runtime library.
+   * \param base See LoadConstantSection.
+   * \param owner See LoadConstantSection.
+   */
+  static runtime::Module LoadFromStream(dmlc::SeekStream* strm, const runtime::Module lib,
+                                        const char* base, const ObjectRef& owner);
+
   /*! \brief The serialized bytecode. */
   std::string code_;
 };
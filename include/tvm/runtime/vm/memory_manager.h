@@ -31,6 +31,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -50,6 +51,7 @@ struct Buffer {
 enum AllocatorType {
   kNaive = 1,
   kPooled,
+  kSlab,
 };
 
 class Allocator {
@@ -80,6 +82,10 @@ class Allocator {
    *  \return The amount of memory currently allocated.
    */
   virtual size_t UsedMemory() const = 0;
+  /*! \brief Counters describing how allocations were served, keyed by counter name.
+   *  \return The counters accumulated since the allocator was created.
+   */
+  virtual std::unordered_map<std::string, int64_t> Stats() const { return {}; }
 
  private:
   AllocatorType type_;
@@ -115,6 +121,11 @@ class StorageObj : public Object {
  public:
   /*! \brief The index into the VM function table. */
   Buffer buffer;
+  /*!
+   * \brief The storage this buffer is a sub-range of, if any. A sub-range is
+   *  released together with its parent rather than through the allocator.
+   */
+  ObjectRef parent;
 
   /*! \brief Allocate an NDArray from a given piece of storage. */
   NDArray AllocNDArray(size_t offset, std::vector<int64_t> shape, DLDataType dtype);
@@ -123,6 +134,7 @@ class StorageObj : public Object {
   static void Deleter(Object* ptr);
 
   ~StorageObj() {
+    if (parent.defined()) return;
     auto alloc = MemoryManager::Global()->GetAllocator(buffer.device);
     alloc->Free(buffer);
   }
@@ -24,6 +24,7 @@
 #ifndef TVM_RUNTIME_VM_VM_H_
 #define TVM_RUNTIME_VM_VM_H_
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/container/closure.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/object.h>
@@ -100,6 +101,24 @@ struct VMFunction {
   friend std::ostream& operator<<(std::ostream& os, const VMFunction&);
 };
 
+/*!
+ * \brief The storage a VM function allocates with sizes known at load time.
+ *
+ * Each such AllocStorage is assigned a fixed offset in one arena per device, so a frame
+ * takes a single buffer from the allocator (or none when the previous arena can be
+ * reused) instead of one per allocation.
+ */
+struct StaticStoragePlan {
+  /*! \brief The (device index, offset) of each instruction, device index is -1 if dynamic. */
+  std::vector<std::pair<Index, size_t>> slots;
+  /*! \brief The arena size per device index, 0 when the device has no static storage. */
+  std::vector<size_t> arena_bytes;
+  /*! \brief The arena alignment per device index. */
+  std::vector<size_t> arena_alignment;
+  /*! \brief The last arena taken for each device index, reused once nothing else holds it. */
+  std::vector<ObjectRef> arena_cache;
+};
+
 /*!
  * \brief A representation of a stack frame.
  *
@@ -123,6 +142,12 @@ struct VMFrame {
   /*! \brief Register in caller's frame to put return value */
   RegName caller_return_register;
 
+  /*! \brief The static storage plan of the function, nullptr if arenas are disabled. */
+  const StaticStoragePlan* storage_plan{nullptr};
+
+  /*! \brief The arena serving the static storage of this frame, one per device index. */
+  std::vector<ObjectRef> storage_arenas;
+
   VMFrame(Index pc, Index func_index, Index args, const Instruction* code, Index register_file_size)
       : pc(pc),
         func_index(func_index),
@@ -192,13 +217,19 @@ class VirtualMachine : public runtime::ModuleNode {
    * \param obj The object to write to.
    */
   inline void WriteRegister(RegName reg, const ObjectRef& obj);
+  /*!
+   * \brief Move an object into a VM register.
+   * \param reg The register to write to.
+   * \param obj The object to write to.
+   */
+  inline void WriteRegister(RegName reg, ObjectRef&& obj);
 
   /*!
    * \brief Read a VM register.
    * \param reg The register to read from.
-   * \return The read object.
+   * \return The read object, only valid until the register or the frame stack changes.
    */
-  ObjectRef ReadRegister(RegName reg) const;
+  const ObjectRef& ReadRegister(RegName reg) const;
 
   /*!
    * \brief Read a VM register and cast it to int32_t
@@ -270,6 +301,21 @@ class VirtualMachine : public runtime::ModuleNode {
    */
   void SetInput(std::string name, TVMArgs args, int offset);
 
+  /*!
+   * \brief Enable or disable serving static storage from per-frame arenas.
+   * \param enable Whether to use arenas.
+   */
+  void SetStorageArena(bool enable);
+
+  /*! \brief Compute the static storage plan of every function, requires devices. */
+  void PlanStaticStorage();
+
+  /*!
+   * \brief Copy the tensor constants to their devices ahead of the first run, with
+   *  overlapping copies. The other constants are still copied when first loaded.
+   */
+  void UploadConstants();
+
   /*!
    * \brief Internal hook for profiling the start of an op.
    *
@@ -289,6 +335,20 @@ class VirtualMachine : public runtime::ModuleNode {
  protected:
   /*! \brief The virtual machine's packed function table. */
   std::vector<PackedFunc> packed_funcs_;
+  /*!
+   * \brief The compiled function called by each packed function of a library module, which
+   *  InvokePacked calls directly, nullptr for the other packed functions.
+   */
+  std::vector<TVMBackendPackedCFunc> packed_cfuncs_;
+  /*! \brief The arguments read by the InvokePacked instructions, kept to reuse their storage. */
+  std::vector<ObjectRef> packed_args_;
+  /*! \brief Whether an InvokePacked instruction is using packed_args_. */
+  bool packed_args_in_use_{false};
+  /*! \brief The arguments packed by InvokePacked, kept to reuse their storage. */
+  std::vector<TVMValue> packed_values_;
+  std::vector<int> packed_codes_;
+  /*! \brief Whether InvokePacked is using packed_values_, packed_codes_ and shape_func_key_. */
+  bool packed_values_in_use_{false};
   /*! \brief The current stack of call frames. */
   std::vector<VMFrame> frames_;
   /*! \brief The fuction table index of the current function. */
@@ -316,6 +376,21 @@ class VirtualMachine : public runtime::ModuleNode {
    * object to avoid rellocation of constants during inference.
    */
   std::vector<ObjectRef> const_pool_;
+  /*! \brief Whether static storage is served from per-frame arenas. */
+  bool use_storage_arena_{false};
+  /*! \brief The static storage plan of each function, empty when arenas are disabled. */
+  std::vector<StaticStoragePlan> storage_plans_;
+  /*! \brief The scalar tensors created by LoadConsti, keyed by value. */
+  std::unordered_map<Index, NDArray> consti_pool_;
+  /*! \brief Whether each packed function is a shape function. */
+  std::vector<bool> is_shape_func_;
+  /*!
+   * \brief The outputs of the shape functions, keyed by packed function index and then by the
+   *  types and values of the inputs.
+   */
+  std::unordered_map<Index, std::unordered_map<std::string, std::string>> shape_func_cache_;
+  /*! \brief The key of the last shape function call, kept to reuse its storage. */
+  std::string shape_func_key_;
 };
 
 }  // namespace vm
@@ -61,8 +61,10 @@ TVM_DLL std::vector<std::vector<int>> rr_partitioner(int begin, int end, int ste
  * \param step The traversal step to the index.
  * \param partitioner A partition function to split tasks to different threads. Use Round-robin
  * partitioner by default.
- * \note 1. Currently do not support nested parallel_for; 2. The order of execution in each thread
- * is not guaranteed, the for loop task should be thread independent and thread safe.
+ * \note 1. The loops run on threads shared by all the parallel loops, the partitions being
+ * started one per thread and the idle threads stealing the indices left in the others. A
+ * parallel loop nested in another runs on the calling thread. 2. The order of execution in
+ * each thread is not guaranteed, the for loop task should be thread independent and thread safe.
  */
 TVM_DLL void parallel_for(int begin, int end, const std::function<void(int)>& f, int step = 1,
                           const PartitionerFuncType partitioner = rr_partitioner);
@@ -83,7 +85,9 @@ TVM_DLL void parallel_for(int begin, int end, const std::function<void(int)>& f,
  * \param num_threads The number of threads to be used.
  * \param f The task function to be executed. Takes the thread index and the task index as
  * input with no output.
- * \note `step` support is left for future work.
+ * \note The threads are shared with `parallel_for` and the calling thread is thread 0. When
+ * nested in another parallel loop, all the tasks run on the calling thread as thread 0.
+ * `step` support is left for future work.
  */
 TVM_DLL void parallel_for_dynamic(int begin, int end, int num_threads,
                                   const std::function<void(int thread_id, int task_id)>& f);
@@ -206,6 +206,24 @@ TVM_DLL size_t CalculateWorkspaceBytes(const PrimFunc& func,
  */
 TVM_DLL Map<Buffer, Optional<Stmt>> DetectBufferAccessLCA(const PrimFunc& func);
 
+/*!
+ * \brief Estimate the floating point operations of a lowered PrimFunc, each operation on a
+ *        vector lane counting as one and a fused multiply add as two.
+ * \param func The PrimFunc to be estimated.
+ * \return The number of floating point operations, counting every branch of a condition.
+ */
+TVM_DLL double EstimateTIRFlops(const PrimFunc& func);
+
+/*!
+ * \brief Estimate the bytes a lowered PrimFunc moves from and to its parameter buffers.
+ *
+ *  The traffic of a buffer is the bytes of its loads and stores, bounded by its size as if
+ *  the caches kept every element once touched, the compulsory traffic of the roofline model.
+ * \param func The PrimFunc to be estimated.
+ * \return The number of bytes moved.
+ */
+TVM_DLL double EstimateTIRBytes(const PrimFunc& func);
+
 // Pass variants of verification analysis
 // directly throws RuntimeError when verification fails.
 namespace transform {
@@ -473,6 +473,10 @@ TVM_DLL const Op& tvm_storage_sync();
  *    return (value passed in by warp indicated by this_warp_id + offset);
  *  }
  *
+ *  Type tvm_warp_shuffle_xor(mask, Type value, lane_mask, width, warp_size) {
+ *    return (value passed in by warp indicated by this_warp_id ^ lane_mask);
+ *  }
+ *
  *  unsigned tvm_warp_activemask() {
  *    return (32-bit mask of currently active threads in the calling warp);
  *  }
@@ -481,6 +485,8 @@ TVM_DLL const Op& tvm_storage_sync();
  *
  *  Parameter offset indicates the relative distance to this_warp_id.
  *
+ *  Parameter lane_mask indicates the bits of this_warp_id flipped to find the source thread.
+ *
  *  Parameter width indicates the number of threads involved in one
  *  shuffle. See CUDA document for __shfl_sync, __shfl_up_sync,
  *  __shfl_down_sync and __activemask.
@@ -492,6 +498,7 @@ TVM_DLL const Op& tvm_storage_sync();
 TVM_DLL const Op& tvm_warp_shuffle();
 TVM_DLL const Op& tvm_warp_shuffle_up();
 TVM_DLL const Op& tvm_warp_shuffle_down();
+TVM_DLL const Op& tvm_warp_shuffle_xor();
 TVM_DLL const Op& tvm_warp_activemask();
 
 /*!
@@ -615,6 +622,92 @@ TVM_DLL const Op& texture2d_store();
  */
 TVM_DLL const Op& texture2d_load();
 
+/*!
+ * \brief tvm intrinsic for the tensor core mma.sync instructions.
+ *
+ *  void ptx_mma(StringImm shape, StringImm A_layout, StringImm B_layout,
+ *               StringImm A_dtype, StringImm B_dtype, StringImm C_dtype,
+ *               Var multiplicand_a, Expr a_index,
+ *               Var multiplicand_b, Expr b_index,
+ *               Var accumulator, Expr c_index, bool saturate) {
+ *    // the fragments are the registers of the calling thread, in the layouts of the
+ *    // PTX ISA, the accumulator is updated in place.
+ *    mma.sync.aligned.shape.A_layout.B_layout.C_dtype.A_dtype.B_dtype.C_dtype
+ *      accumulator[c_index:], multiplicand_a[a_index:], multiplicand_b[b_index:],
+ *      accumulator[c_index:];
+ *  }
+ */
+TVM_DLL const Op& ptx_mma();
+
+/*!
+ * \brief tvm intrinsic for the ldmatrix instruction, loading tensor core fragments from the
+ *  shared memory.
+ *
+ *  void ptx_ldmatrix(bool trans, int num, StringImm type,
+ *                    Var local_ptr, Expr local_index, Expr shared_ptr) {
+ *    // shared_ptr is a tvm_access_ptr of the row the calling thread provides
+ *    ldmatrix.sync.aligned.m8n8.x{num}{.trans}.shared.type local_ptr[local_index:], [shared_ptr];
+ *  }
+ */
+TVM_DLL const Op& ptx_ldmatrix();
+
+/*!
+ * \brief Start an asynchronous copy from the global to the shared memory, cp.async on CUDA.
+ *
+ *  void ptx_cp_async(Expr shared_ptr, Expr global_ptr, int bytes) {
+ *    // the copy is complete once the group it is committed to is waited for
+ *    cp.async.ca.shared.global [shared_ptr], [global_ptr], bytes;
+ *  }
+ *
+ *  The pointers are tvm_access_ptr of the shared and the global buffers, bytes is 4, 8 or 16.
+ */
+TVM_DLL const Op& ptx_cp_async();
+
+/*!
+ * \brief Commit the asynchronous copies started so far to a new group.
+ *
+ *  void ptx_commit_group() {
+ *    cp.async.commit_group;
+ *  }
+ */
+TVM_DLL const Op& ptx_commit_group();
+
+/*!
+ * \brief Wait until at most num_pending of the committed groups are not complete.
+ *
+ *  void ptx_wait_group(int num_pending) {
+ *    cp.async.wait_group num_pending;
+ *  }
+ */
+TVM_DLL const Op& ptx_wait_group();
+
+/*!
+ * \brief Start an asynchronous copy with the DMA engine of a device.
+ *
+ *  void dma_copy(int queue_id, Expr dst_ptr, Expr src_ptr, Expr nbytes) {
+ *    // the copy is complete once the group it is committed to is waited for
+ *    memcpy(dst_ptr, src_ptr, nbytes);
+ *  }
+ *
+ *  LowerTVMBuiltin lowers the DMA builtins to the packed functions device_api.<device>.DMACopy,
+ *  DMACommitGroup and DMAWaitGroup of the device of the function.
+ */
+TVM_DLL const Op& dma_copy();
+
+/*!
+ * \brief Commit the DMA copies of a queue started so far to a new group.
+ *
+ *  void dma_commit_group(int queue_id);
+ */
+TVM_DLL const Op& dma_commit_group();
+
+/*!
+ * \brief Wait until at most num_pending of the committed groups of a queue are not complete.
+ *
+ *  void dma_wait_group(int queue_id, int num_pending);
+ */
+TVM_DLL const Op& dma_wait_group();
+
 /*! \brief The kind of structure field info used in intrinsic */
 enum TVMStructFieldKind : int {
   // array head address
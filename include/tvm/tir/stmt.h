@@ -1357,6 +1357,31 @@ constexpr const char* script_parsing_detect_access = "tir.script_parsing_detect_
  */
 constexpr const char* pragma_loop_partition_hint = "pragma_loop_partition_hint";
 
+/*!
+ * \brief Annotation of a loop giving the pipeline stage of each statement of its body.
+ * \note The value is an array of integers, one per statement.
+ */
+constexpr const char* software_pipeline_stage = "software_pipeline_stage";
+
+/*!
+ * \brief Annotation of a loop giving the order the statements of its body are emitted in
+ *  by the software pipeline.
+ * \note The value is an array of integers, one per statement.
+ */
+constexpr const char* software_pipeline_order = "software_pipeline_order";
+
+/*!
+ * \brief Annotation of a loop listing the pipeline stages whose copies are asynchronous.
+ * \note The value is an array of integers.
+ */
+constexpr const char* software_pipeline_async_stages = "software_pipeline_async_stages";
+
+/*!
+ * \brief Mark the copies that can complete asynchronously, until the next ptx_wait_group for
+ *  the copies to the shared memory, or the next dma_wait_group for the others.
+ */
+constexpr const char* async_scope = "async_scope";
+
 /*!
  * \brief Check if attr_key is a pragma key extension
  * \param attr_key The attr key to be compared
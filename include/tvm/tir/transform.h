@@ -63,6 +63,18 @@ TVM_DLL Pass CreatePrimFuncPass(
  */
 TVM_DLL Pass InjectPrefetch();
 
+/*!
+ * \brief Insert software prefetches for the streaming accesses of the CPU loops.
+ *
+ *  The accesses of a serial loop at a constant stride of at least a cache line, and the
+ *  indirect ones such as the rows of a gather, are prefetched a few iterations ahead. The
+ *  distance is computed from the bytes of the prefetched streams. Configured by the
+ *  "tir.InjectAutoPrefetch" pass config, and disabled by default.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectAutoPrefetch();
+
 // TODO(tvm-team): consolidate configs to the PassContext
 /*!
  * \brief Flatten the multi-dimensional read/write
@@ -135,6 +147,57 @@ TVM_DLL Pass InjectVirtualThread();
  */
 TVM_DLL Pass InjectDoubleBuffer();
 
+/*!
+ * \brief Pipeline the loops annotated with software_pipeline_stage and
+ *  software_pipeline_order.
+ *
+ *  The statements of the loop body run the iterations of the loop shifted by their stage, in
+ *  a prologue, the steady state loop and an epilogue. The buffers allocated in the loop body
+ *  that a later stage reads are given one version per stage in flight.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSoftwarePipeline();
+
+/*!
+ * \brief Pad or permute the shared memory buffers that the threads of a warp access with
+ *  bank conflicts.
+ *
+ *  The conflicts of each access are estimated for the first warp, and the layout with the
+ *  fewest conflicts is kept when it improves on the original one. Must run on the blocks,
+ *  before FlattenBuffer.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass RewriteSharedMemoryLayout();
+
+/*!
+ * \brief Vectorize the innermost loops of the GPU kernels that access consecutive elements
+ *  of the function arguments.
+ *
+ *  A loop is split into vectors of 8 or 16 bytes when the modular set of each access proves
+ *  it aligned. Must run before VectorizeLoop.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass WidenMemoryAccess();
+
+/*!
+ * \brief Rewrite the copies from the global to the shared memory marked by async_scope into
+ *  ptx_cp_async.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectPTXAsyncCopy();
+
+/*!
+ * \brief Rewrite the contiguous copies marked by async_scope that do not go to the shared
+ *  memory into dma_copy. Must run before InjectPTXAsyncCopy, which drops async_scope.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectDMAAsyncCopy();
+
 /*!
  * \brief Rewrite storage allocation pattern.
  *  Moves the allocation to outer most possible scope.
@@ -190,6 +253,9 @@ TVM_DLL Pass InstrumentBoundCheckers();
  *   - Map the values in the api_args to Var that is required by body.
  *   - Insert assertions to check type/value of the passed arguments.
  *
+ *  The assertions are left out under the "tir.skip_arg_checks" option, for the functions
+ *  only called by an executor which validates its inputs once, such as the graph executor.
+ *
  * \param num_unpacked_args Number of arguments that
  *         are processed in plain form instead of packed form.
  *
@@ -435,6 +501,17 @@ TVM_DLL Pass CompactBufferAllocation();
  */
 TVM_DLL Pass LegalizePackedCalls();
 
+/*!
+ * \brief Keep one copy of the PrimFuncs that are structurally equal up to their global
+ *  symbols, redirecting the calls of the others to it.
+ *
+ *  The entry and runner functions and the external ones are kept, the pass being for modules
+ *  whose kernels are only called from the module, as the ones of the AOT executor.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass DeduplicateFunctions();
+
 /*!
  * \brief Remove match buffers inside the block. Also, it will validate the binding.
  * \return The pass.
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/usmp/algorithms.h
+ * \brief The memory planning algorithms of the Unified Static Memory Planner
+ */
+
+#ifndef TVM_TIR_USMP_ALGORITHMS_H_
+#define TVM_TIR_USMP_ALGORITHMS_H_
+
+#include <tvm/tir/usmp/utils.h>
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+namespace algo {
+
+/*!
+ * \brief The greedy by size algorithm to plan memory
+ *
+ * This will try to place the buffers in the order of their size, the largest first.
+ *
+ * \param buffer_info_arr The BufferInfo objects to plan
+ * \param memory_pressure The memory pressure computed by extract_buffer_info
+ */
+Map<BufferInfo, PoolAllocation> GreedyBySize(const Array<BufferInfo>& buffer_info_arr,
+                                             const Integer& memory_pressure);
+
+/*!
+ * \brief The greedy by conflicts algorithm to plan memory
+ *
+ * This will try to place the buffers in the order of their number of liveness conflicts,
+ * the most conflicting first.
+ *
+ * \param buffer_info_arr The BufferInfo objects to plan
+ * \param memory_pressure The memory pressure computed by extract_buffer_info
+ */
+Map<BufferInfo, PoolAllocation> GreedyByConflicts(const Array<BufferInfo>& buffer_info_arr,
+                                                  const Integer& memory_pressure);
+
+/*!
+ * \brief The hill climb algorithm to plan memory
+ *
+ * This will start from the greedy orders and randomly move the buffers ending at the top of a
+ * pool earlier in the placement order, keeping the orders that do not make the pools larger.
+ *
+ * \param buffer_info_arr The BufferInfo objects to plan
+ * \param memory_pressure The memory pressure computed by extract_buffer_info
+ */
+Map<BufferInfo, PoolAllocation> HillClimb(const Array<BufferInfo>& buffer_info_arr,
+                                          const Integer& memory_pressure);
+
+/*!
+ * \brief The branch and bound algorithm to plan memory
+ *
+ * This will search for the smallest total pool size among the placements of the buffers,
+ * starting from the hill climb plan. The search is only run for a small number of buffers
+ * and stops when the time budget is exhausted, returning the best plan found so far.
+ *
+ * \param buffer_info_arr The BufferInfo objects to plan
+ * \param memory_pressure The memory pressure computed by extract_buffer_info
+ * \param time_budget_ms The time the search may take, in milliseconds
+ */
+Map<BufferInfo, PoolAllocation> BranchAndBound(const Array<BufferInfo>& buffer_info_arr,
+                                               const Integer& memory_pressure,
+                                               int64_t time_budget_ms = 1000);
+
+/*!
+ * \brief Plan the memory of several modules sharing the same pools, the modules never running
+ * concurrently.
+ *
+ * The liveness conflicts only exist between the buffers of one module invocation, thus each
+ * module is planned on its own from the start of the pools. A shared pool then only needs the
+ * size of the largest module plan instead of their sum, see CalculateSharedPoolSizes.
+ *
+ * \param module_buffer_info_arrs The BufferInfo objects of each module
+ * \param memory_pressures The memory pressure of each module computed by extract_buffer_info
+ * \param algorithm The name of the algorithm planning each module, e.g. "greedy_by_size"
+ * \return The pool allocations of each module
+ */
+Array<Map<BufferInfo, PoolAllocation>> PlanSharedPools(
+    const Array<Array<BufferInfo>>& module_buffer_info_arrs, const Array<Integer>& memory_pressures,
+    const String& algorithm);
+
+}  // namespace algo
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
+
+#endif  // TVM_TIR_USMP_ALGORITHMS_H_
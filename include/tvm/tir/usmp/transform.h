@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/usmp/transform.h
+ * \brief The transformations of the Unified Static Memory Planner
+ */
+#ifndef TVM_TIR_USMP_TRANSFORM_H_
+#define TVM_TIR_USMP_TRANSFORM_H_
+
+#include <tvm/ir/transform.h>
+#include <tvm/tir/usmp/utils.h>
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+namespace transform {
+
+using Pass = tvm::transform::Pass;
+
+/*!
+ * \brief The PrimFunc attribute listing the pools of the trailing parameters added by
+ * ConvertPoolAllocationsToOffsets, in order.
+ */
+static constexpr const char* kPoolArgsAttr = "tir.usmp.pool_args";
+
+/*!
+ * \brief Replace the planned allocate nodes by offsets in their pools.
+ *
+ * Each pool becomes a trailing uint8 pointer parameter of the PrimFuncs allocating in it or
+ * calling, through call_extern or tvm_call_cpacked, a PrimFunc of the module that takes it. The
+ * call sites pass the pools on, so the pools are provided once by the caller of the entry
+ * function and no planned buffer is allocated at run time.
+ *
+ * \param pool_allocations The pool allocation of each planned allocate node
+ * \return The pass.
+ */
+TVM_DLL Pass ConvertPoolAllocationsToOffsets(const Map<Stmt, PoolAllocation>& pool_allocations);
+
+}  // namespace transform
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
+
+#endif  // TVM_TIR_USMP_TRANSFORM_H_
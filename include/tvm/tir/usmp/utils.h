@@ -26,6 +26,7 @@
 #define TVM_TIR_USMP_UTILS_H_
 
 #include <tvm/ir/expr.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/target/target.h>
 #include <tvm/tir/stmt.h>
 
@@ -46,6 +47,25 @@ static constexpr const char* kTargetPoolReadWriteAccess = "rw";
  */
 static constexpr const char* kTargetPoolReadOnlyAccess = "ro";
 
+/*!
+ * \brief The pool holding the storage of the AOT executor planned by the USMP.
+ */
+static constexpr const char* kDefaultWorkspacePoolName = "workspace";
+
+/*!
+ * \brief The PassContext option enabling the static planning of the AOT executor storage in pools.
+ */
+static constexpr const char* kUSMPEnableOption = "tir.usmp.enable";
+/*!
+ * \brief The PassContext option naming the memory planning algorithm, tir.usmp.algo.<algorithm>.
+ */
+static constexpr const char* kUSMPAlgorithmOption = "tir.usmp.algorithm";
+/*!
+ * \brief The PrimFunc attribute marking an operator whose scratch allocates are planned together
+ * with the storage of the AOT executor, the operator then taking the pools as trailing parameters.
+ */
+static constexpr const char* kUSMPPlanAllocatesAttr = "tir.usmp.plan_allocates";
+
 /*!
  * \brief Describes a pool of memory accessible by one or more targets.
  */
@@ -230,7 +250,7 @@ class PoolAllocation : public ObjectRef {
  *
  * \param buffer_info_map IR-bound BufferInfo map
  */
-Array<BufferInfo> CreateArrayBufferInfo(const Map<Stmt, BufferInfo>& buffer_info_map);
+Array<BufferInfo> CreateArrayBufferInfo(const Map<BufferInfo, Stmt>& buffer_info_map);
 
 /*!
  * \brief The allocate node attribute to indicate candidate memory pools.
@@ -246,6 +266,52 @@ static constexpr const char* kPoolCandidatesAllocateAttr = "candidate_memory_poo
  */
 Integer CalculateExtentsSize(const AllocateNode* op);
 
+/*!
+ * \brief Key the pool allocations of a memory plan by the allocate nodes of the BufferInfo objects.
+ *
+ * \param buffer_info_stmts The allocate node of each BufferInfo object, see extract_buffer_info
+ * \param pool_allocations The pool allocation of each BufferInfo object
+ */
+Map<Stmt, PoolAllocation> AssignStmtPoolAllocations(
+    const Map<BufferInfo, Stmt>& buffer_info_stmts,
+    const Map<BufferInfo, PoolAllocation>& pool_allocations);
+
+/*!
+ * \brief Calculate the size of each pool used by a memory plan, the end of the last buffer
+ * placed in it.
+ *
+ * \param pool_allocations The pool allocation of each BufferInfo object
+ */
+Map<PoolInfo, Integer> CalculatePoolSizes(const Map<BufferInfo, PoolAllocation>& pool_allocations);
+
+/*!
+ * \brief Calculate the size of each pool shared by the memory plans of modules that never run
+ * concurrently, the largest of the sizes of the pool in these plans.
+ *
+ * \param module_pool_allocations The pool allocations of each module
+ */
+Map<PoolInfo, Integer> CalculateSharedPoolSizes(
+    const Array<Map<BufferInfo, PoolAllocation>>& module_pool_allocations);
+
+/*!
+ * \brief Calculate the total size of the pools used by a memory plan, the sum over the pools of
+ * the end of the last buffer placed in each of them.
+ *
+ * \param pool_allocations The pool allocation of each BufferInfo object
+ */
+int64_t CalculateTotalPoolSize(const Map<BufferInfo, PoolAllocation>& pool_allocations);
+
+/*!
+ * \brief Calculate a lower bound of the total size of the pools any memory plan of the
+ * BufferInfo objects needs : the largest of the memory pressure, the largest buffer and the
+ * largest pair of conflicting buffers.
+ *
+ * \param buffer_info_arr The BufferInfo objects
+ * \param memory_pressure The memory pressure computed by extract_buffer_info
+ */
+int64_t CalculatePoolSizeLowerBound(const Array<BufferInfo>& buffer_info_arr,
+                                    const Integer& memory_pressure);
+
 }  // namespace usmp
 }  // namespace tir
 }  // namespace tvm
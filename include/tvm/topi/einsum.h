@@ -33,14 +33,18 @@
 #include <tvm/topi/detail/constant_utils.h>
 #include <tvm/topi/detail/ravel_unravel.h>
 #include <tvm/topi/detail/tensor_utils.h>
+#include <tvm/topi/reduction.h>
 #include <tvm/topi/tags.h>
+#include <tvm/topi/transform.h>
 
 #include <algorithm>
 #include <bitset>
 #include <iterator>
+#include <limits>
 #include <string>
 #include <tuple>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -667,6 +671,343 @@ inline Array<PrimExpr> NumpyEinsumShape(const std::string subscripts,
   return oshape;
 }
 
+/*! \brief The largest number of operands whose contraction order is searched exhaustively. */
+constexpr const size_t kEinsumOptimalPathMaxOperands = 4;
+
+/*!
+ * \brief Parse an einsum into one label string per operand, for the contraction path.
+ *
+ * \param subscripts_str the subscripts of the einsum.
+ * \param inputs the operands.
+ * \param terms the labels of each operand.
+ * \param output the labels of the output.
+ * \param label_sizes the extent of each label, indexed by the label.
+ *
+ * \return whether the einsum can be evaluated by pairwise contractions, which needs constant
+ * shapes, a single dtype, no repeated label in an operand and no broadcast label.
+ */
+inline bool ParseEinsumContraction(const std::string& subscripts_str, const Array<Tensor>& inputs,
+                                   std::vector<std::string>* terms, std::string* output,
+                                   int64_t* label_sizes) {
+  std::vector<Array<PrimExpr>> operands;
+  for (const Tensor& input : inputs) {
+    if (input->dtype != inputs[0]->dtype) {
+      return false;
+    }
+    for (const PrimExpr& dim : input->shape) {
+      if (!dim->IsInstance<IntImmNode>()) {
+        return false;
+      }
+    }
+    operands.push_back(input->shape);
+  }
+  std::tuple<std::string, std::string> parsed = ParseEinsumInput(subscripts_str, operands);
+  *terms = Split(std::get<0>(parsed), ",");
+  *output = std::get<1>(parsed);
+  if (Str2Set(*output).count() != output->length()) {
+    return false;
+  }
+  std::fill(label_sizes, label_sizes + LABELRANGE, -1);
+  for (size_t i = 0; i < terms->size(); ++i) {
+    const std::string& term = (*terms)[i];
+    if (term.length() != operands[i].size() || Str2Set(term).count() != term.length()) {
+      return false;
+    }
+    for (size_t j = 0; j < term.length(); ++j) {
+      int64_t dim = GetConstInt(operands[i][j]);
+      int64_t* size = &label_sizes[static_cast<int>(term[j])];
+      if (*size != -1 && *size != dim) {
+        return false;
+      }
+      *size = dim;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief The number of elements of a tensor with the given labels.
+ *
+ * \param labels the labels of the tensor.
+ * \param label_sizes the extent of each label.
+ *
+ * \return the number of elements, as a double to avoid overflows in the cost model.
+ */
+inline double EinsumLabelsSize(const std::string& labels, const int64_t* label_sizes) {
+  double size = 1;
+  for (const char& c : labels) {
+    size *= label_sizes[static_cast<int>(c)];
+  }
+  return size;
+}
+
+/*!
+ * \brief Compute the labels of the result of contracting two operands of an einsum.
+ *
+ * The labels kept are the ones needed by the output or by another operand, ordered as the
+ * labels shared by both operands, followed by the ones of the first and of the second operand.
+ *
+ * \param terms the labels of the remaining operands.
+ * \param i the index of the first operand.
+ * \param j the index of the second operand.
+ * \param output the labels of the output.
+ *
+ * \return the labels of the result.
+ */
+inline std::string EinsumPairResultLabels(const std::vector<std::string>& terms, size_t i,
+                                          size_t j, const std::string& output) {
+  auto is_kept = [&](char c) {
+    if (output.find(c) != std::string::npos) {
+      return true;
+    }
+    for (size_t t = 0; t < terms.size(); ++t) {
+      if (t != i && t != j && terms[t].find(c) != std::string::npos) {
+        return true;
+      }
+    }
+    return false;
+  };
+  std::string batch, left, right;
+  for (const char& c : terms[i]) {
+    if (is_kept(c)) {
+      (terms[j].find(c) != std::string::npos ? batch : left).append(1, c);
+    }
+  }
+  for (const char& c : terms[j]) {
+    if (is_kept(c) && terms[i].find(c) == std::string::npos) {
+      right.append(1, c);
+    }
+  }
+  return batch + left + right;
+}
+
+/*!
+ * \brief Contract the operands i and j of an einsum, the result replacing them at the end.
+ *
+ * \param terms the labels of the remaining operands, updated in place.
+ * \param i the index of the first operand.
+ * \param j the index of the second operand, greater than i.
+ * \param output the labels of the output.
+ * \param label_sizes the extent of each label.
+ *
+ * \return the number of multiply-adds of the contraction.
+ */
+inline double EinsumContractTerms(std::vector<std::string>* terms, size_t i, size_t j,
+                                  const std::string& output, const int64_t* label_sizes) {
+  std::string result = EinsumPairResultLabels(*terms, i, j, output);
+  std::string all_labels = (*terms)[i];
+  for (const char& c : (*terms)[j]) {
+    if (all_labels.find(c) == std::string::npos) {
+      all_labels.append(1, c);
+    }
+  }
+  terms->erase(terms->begin() + j);
+  terms->erase(terms->begin() + i);
+  terms->push_back(result);
+  return EinsumLabelsSize(all_labels, label_sizes);
+}
+
+/*!
+ * \brief Search the cheapest order of pairwise contractions among all of them.
+ *
+ * \param terms the labels of the remaining operands.
+ * \param output the labels of the output.
+ * \param label_sizes the extent of each label.
+ * \param cost the cost of the contractions done so far.
+ * \param path the contractions done so far.
+ * \param best_cost the cost of the cheapest complete path found.
+ * \param best_path the cheapest complete path found.
+ */
+inline void EinsumOptimalPath(const std::vector<std::string>& terms, const std::string& output,
+                              const int64_t* label_sizes, double cost,
+                              std::vector<std::pair<size_t, size_t>>* path, double* best_cost,
+                              std::vector<std::pair<size_t, size_t>>* best_path) {
+  if (cost >= *best_cost) {
+    return;
+  }
+  if (terms.size() == 1) {
+    *best_cost = cost;
+    *best_path = *path;
+    return;
+  }
+  for (size_t i = 0; i < terms.size(); ++i) {
+    for (size_t j = i + 1; j < terms.size(); ++j) {
+      std::vector<std::string> next = terms;
+      double step = EinsumContractTerms(&next, i, j, output, label_sizes);
+      path->emplace_back(i, j);
+      EinsumOptimalPath(next, output, label_sizes, cost + step, path, best_cost, best_path);
+      path->pop_back();
+    }
+  }
+}
+
+/*!
+ * \brief Compute the order of the pairwise contractions of an einsum.
+ *
+ * As in opt_einsum, the order is searched exhaustively for a few operands, otherwise the
+ * pair whose result is the smallest relative to its operands is greedily contracted first.
+ *
+ * \param terms the labels of each operand.
+ * \param output the labels of the output.
+ * \param label_sizes the extent of each label.
+ *
+ * \return the pairs of operands to contract, each result being appended to the operands.
+ */
+inline std::vector<std::pair<size_t, size_t>> EinsumContractionPath(
+    std::vector<std::string> terms, const std::string& output, const int64_t* label_sizes) {
+  std::vector<std::pair<size_t, size_t>> path;
+  if (terms.size() <= kEinsumOptimalPathMaxOperands) {
+    std::vector<std::pair<size_t, size_t>> current;
+    double best_cost = std::numeric_limits<double>::infinity();
+    EinsumOptimalPath(terms, output, label_sizes, 0, &current, &best_cost, &path);
+    return path;
+  }
+  while (terms.size() > 1) {
+    std::pair<size_t, size_t> best_pair(0, 1);
+    double best_score = std::numeric_limits<double>::infinity();
+    double best_cost = best_score;
+    for (size_t i = 0; i < terms.size(); ++i) {
+      for (size_t j = i + 1; j < terms.size(); ++j) {
+        std::vector<std::string> next = terms;
+        double cost = EinsumContractTerms(&next, i, j, output, label_sizes);
+        double score = EinsumLabelsSize(next.back(), label_sizes) -
+                       EinsumLabelsSize(terms[i], label_sizes) -
+                       EinsumLabelsSize(terms[j], label_sizes);
+        if (score < best_score || (score == best_score && cost < best_cost)) {
+          best_pair = std::make_pair(i, j);
+          best_score = score;
+          best_cost = cost;
+        }
+      }
+    }
+    EinsumContractTerms(&terms, best_pair.first, best_pair.second, output, label_sizes);
+    path.push_back(best_pair);
+  }
+  return path;
+}
+
+/*!
+ * \brief Transpose a tensor to the given labels, skipping the identity permutation.
+ *
+ * \param x the tensor.
+ * \param labels the labels of the tensor.
+ * \param target the labels of the result, a permutation of labels.
+ *
+ * \return the transposed tensor.
+ */
+inline Tensor EinsumTranspose(const Tensor& x, const std::string& labels,
+                              const std::string& target) {
+  if (labels == target) {
+    return x;
+  }
+  Array<Integer> axes;
+  for (const char& c : target) {
+    axes.push_back(static_cast<int>(labels.find(c)));
+  }
+  return transpose(x, axes);
+}
+
+/*!
+ * \brief Contract two operands of an einsum as a batched matrix multiplication.
+ *
+ * The labels only in one operand and not in the result are summed first, then both operands
+ * are transposed and reshaped to [batch, rows, reduction] and [batch, reduction, columns].
+ *
+ * \param a the first operand.
+ * \param a_labels the labels of the first operand.
+ * \param b the second operand.
+ * \param b_labels the labels of the second operand.
+ * \param result_labels the labels of the result, as given by EinsumPairResultLabels.
+ * \param label_sizes the extent of each label.
+ * \param name the name of the operation.
+ * \param tag the tag to mark the operation.
+ *
+ * \return the contracted tensor.
+ */
+inline Tensor EinsumContractPair(Tensor a, std::string a_labels, Tensor b, std::string b_labels,
+                                 const std::string& result_labels, const int64_t* label_sizes,
+                                 std::string name, std::string tag) {
+  auto sum_unused = [&](Tensor* x, std::string* labels, const std::string& other) {
+    Array<Integer> axes;
+    std::string remain;
+    for (size_t i = 0; i < labels->length(); ++i) {
+      char c = (*labels)[i];
+      if (result_labels.find(c) == std::string::npos && other.find(c) == std::string::npos) {
+        axes.push_back(static_cast<int>(i));
+      } else {
+        remain.append(1, c);
+      }
+    }
+    if (axes.size() != 0) {
+      *x = sum(*x, axes);
+      *labels = remain;
+    }
+  };
+  sum_unused(&a, &a_labels, b_labels);
+  sum_unused(&b, &b_labels, a_labels);
+
+  std::string batch, rows, cols, reduction;
+  for (const char& c : result_labels) {
+    bool in_a = a_labels.find(c) != std::string::npos;
+    bool in_b = b_labels.find(c) != std::string::npos;
+    (in_a && in_b ? batch : (in_a ? rows : cols)).append(1, c);
+  }
+  ICHECK_EQ(batch + rows + cols, result_labels);
+  for (const char& c : a_labels) {
+    if (result_labels.find(c) == std::string::npos) {
+      reduction.append(1, c);
+    }
+  }
+  auto extent = [&](const std::string& labels) {
+    int64_t size = static_cast<int64_t>(EinsumLabelsSize(labels, label_sizes));
+    return make_const(DataType::Int(32), size);
+  };
+  PrimExpr batch_extent = extent(batch), rows_extent = extent(rows), cols_extent = extent(cols);
+  Tensor lhs = reshape(EinsumTranspose(a, a_labels, batch + rows + reduction),
+                       {batch_extent, rows_extent, extent(reduction)});
+  Tensor rhs = reshape(EinsumTranspose(b, b_labels, batch + reduction + cols),
+                       {batch_extent, extent(reduction), cols_extent});
+  IterVar k = reduce_axis(Range(0, extent(reduction)), "k");
+  Tensor product = compute(
+      {batch_extent, rows_extent, cols_extent},
+      [&](Var n, Var i, Var j) { return tvm::sum(lhs(n, i, k->var) * rhs(n, k->var, j), {k}); },
+      name, tag);
+  Array<PrimExpr> result_shape;
+  for (const char& c : result_labels) {
+    result_shape.push_back(make_const(DataType::Int(32), label_sizes[static_cast<int>(c)]));
+  }
+  return reshape(product, result_shape);
+}
+
+/*!
+ * \brief Evaluate an einsum as a sequence of pairwise contractions along its contraction path.
+ *
+ * \param inputs the operands.
+ * \param terms the labels of each operand.
+ * \param output the labels of the output.
+ * \param label_sizes the extent of each label.
+ * \param name the name of the operation.
+ * \param tag the tag to mark the operation.
+ *
+ * \return the result of the einsum.
+ */
+inline Tensor EinsumByContractionPath(const Array<Tensor>& inputs, std::vector<std::string> terms,
+                                      const std::string& output, const int64_t* label_sizes,
+                                      std::string name, std::string tag) {
+  std::vector<Tensor> tensors(inputs.begin(), inputs.end());
+  for (const std::pair<size_t, size_t>& pair : EinsumContractionPath(terms, output, label_sizes)) {
+    size_t i = pair.first, j = pair.second;
+    std::string result_labels = EinsumPairResultLabels(terms, i, j, output);
+    Tensor result = EinsumContractPair(tensors[i], terms[i], tensors[j], terms[j], result_labels,
+                                       label_sizes, name, tag);
+    EinsumContractTerms(&terms, i, j, output, label_sizes);
+    tensors.erase(tensors.begin() + j);
+    tensors.erase(tensors.begin() + i);
+    tensors.push_back(result);
+  }
+  return EinsumTranspose(tensors[0], terms[0], output);
+}
+
 /*!
  * \brief Evaluates the Einstein summation convention on the operands.
  *
@@ -680,6 +1021,16 @@ inline Array<PrimExpr> NumpyEinsumShape(const std::string subscripts,
  */
 inline Tensor einsum(const std::string& subscripts_str, const Array<Tensor> inputs,
                      std::string name = "T_einsum", std::string tag = kEinsum) {
+  if (inputs.size() > 2) {
+    // A single loop nest over all the labels grows exponentially with the number of
+    // operands, so contract them pairwise, cheapest order first.
+    std::vector<std::string> terms;
+    std::string output;
+    int64_t label_sizes[LABELRANGE];
+    if (ParseEinsumContraction(subscripts_str, inputs, &terms, &output, label_sizes)) {
+      return EinsumByContractionPath(inputs, terms, output, label_sizes, name, tag);
+    }
+  }
   bool back = false;
   const char* subscripts = subscripts_str.data();
   const char* head = subscripts;
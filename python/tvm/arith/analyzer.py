@@ -90,6 +90,7 @@ class Analyzer:
         self._canonical_simplify = _mod("canonical_simplify")
         self._int_set = _mod("int_set")
         self._enter_constraint_context = _mod("enter_constraint_context")
+        self._enable_memo = _mod("enable_memo")
 
     def const_int_bound(self, expr):
         """Find constant integer bound for expr.
@@ -233,6 +234,13 @@ class Analyzer:
 
         return ConstraintScope(_fenter)
 
+    def enable_memo(self):
+        """Memoize the results of simplify.
+
+        Must be called before any bind or constraint_scope.
+        """
+        self._enable_memo()
+
     def update(self, var, info, override=False):
         """Update infomation about var
 
@@ -20,19 +20,21 @@
 from . import compute_dag
 from . import dispatcher
 from . import feature
+from . import interference
 from . import loop_state
 from . import measure
 from . import measure_record
 from . import relay_integration
 from . import search_policy
 from . import search_task
+from . import symbolic_shape
 from . import task_scheduler
 from . import utils
 from . import workload_registry
 
 # Shortcut
 from .compute_dag import ComputeDAG, LayoutRewriteOption, get_shape_from_rewritten_layout
-from .cost_model import RandomModel, XGBModel
+from .cost_model import RandomModel, GBTreeModel, XGBModel
 from .dispatcher import DispatchContext, ApplyHistoryBest, ApplyHistoryBestOrSample
 from .measure import (
     MeasureInput,
@@ -55,7 +57,10 @@ from .search_policy import (
     EmptyPolicy,
     SketchPolicy,
     PreloadMeasuredStates,
+    WarmStartFromSimilarWorkloads,
     PreloadCustomSketchRule,
 )
+from .symbolic_shape import create_symbolic_tasks, build_symbolic_kernel
+from .interference import measure_in_situ, in_situ_task_weights
 from .task_scheduler import TaskScheduler
 from .workload_registry import register_workload, make_workload_key
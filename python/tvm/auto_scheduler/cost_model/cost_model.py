@@ -22,6 +22,7 @@ import numpy as np
 import tvm._ffi
 from tvm.runtime import Object
 from .. import _ffi_api
+from ..feature import DEFAULT_MAX_N_BUFS
 
 
 @tvm._ffi.register_object("auto_scheduler.CostModel")
@@ -66,6 +67,90 @@ class RandomModel(CostModel):
         return [x.value for x in _ffi_api.CostModelPredict(self, search_task, states)]
 
 
+@tvm._ffi.register_object("auto_scheduler.GBTreeModel")
+class GBTreeModel(CostModel):
+    """A gradient boosted tree model scored in C++, from a model in the JSON format of XGBoost.
+
+    The predictions do not enter python, which keeps the evolutionary search free of the GIL.
+    The training is delegated to a python trainer, such as :code:`XGBModel`.
+
+    Parameters
+    ----------
+    model_json : Optional[Union[str, bytes]]
+        The model saved by XGBoost in its JSON format. The trainer's model when None.
+    trainer : Optional[XGBModel]
+        The model trained on update, whose :code:`export_json` is loaded after each update.
+        None for a model that is never retrained.
+    max_n_bufs : Optional[int]
+        The maximum number of extracted buffers for one statement in the features.
+    """
+
+    def __init__(self, model_json=None, trainer=None, max_n_bufs=None):
+        update_func = None
+        if trainer is not None:
+
+            def update_func(inputs, results):
+                trainer.update(inputs, results)
+                return bytearray(trainer.export_json() or b"")
+
+            if model_json is None:
+                model_json = trainer.export_json()
+        if isinstance(model_json, str):
+            model_json = model_json.encode("utf-8")
+        self.__init_handle_by_constructor__(
+            _ffi_api.GBTreeModel,
+            bytearray(model_json or b""),
+            update_func,
+            max_n_bufs or DEFAULT_MAX_N_BUFS,
+        )
+
+    def load_json(self, model_json):
+        """Replace the model by a model saved by XGBoost in its JSON format.
+
+        Parameters
+        ----------
+        model_json : Union[str, bytes]
+            The model, empty for random predictions.
+        """
+        if isinstance(model_json, str):
+            model_json = model_json.encode("utf-8")
+        _ffi_api.GBTreeModelLoadXGBoostJSON(self, bytearray(model_json))
+
+    @property
+    def num_trees(self):
+        """The number of trees, 0 until a model is loaded."""
+        return _ffi_api.GBTreeModelNumTrees(self)
+
+    def update(self, inputs, results):
+        """Update the cost model according to new measurement results (training data).
+
+        Parameters
+        ----------
+        inputs : List[auto_scheduler.measure.MeasureInput]
+            The measurement inputs
+        results : List[auto_scheduler.measure.MeasureResult]
+            The measurement results
+        """
+        _ffi_api.CostModelUpdate(self, inputs, results)
+
+    def predict(self, search_task, states):
+        """Predict the scores of states
+
+        Parameters
+        ----------
+        search_task : SearchTask
+            The search task of states
+        states : List[State]
+            The input states
+
+        Returns
+        -------
+        scores: List[float]
+            The predicted scores for all states
+        """
+        return [x.value for x in _ffi_api.CostModelPredict(self, search_task, states)]
+
+
 @tvm._ffi.register_func("auto_scheduler.cost_model.random_fill_float")
 def random_fill_float(size, return_ptr):
     """Fills a c++ float array with random numbers in [0, 1]
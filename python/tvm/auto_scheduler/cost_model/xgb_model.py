@@ -19,6 +19,8 @@
 """Cost model based on xgboost"""
 import multiprocessing
 import logging
+import os
+import tempfile
 from collections import defaultdict
 
 import numpy as np
@@ -331,6 +333,26 @@ class XGBModel(PythonBasedModel):
         """
         self.bst.save_model(file_name)
 
+    def export_json(self):
+        """Export the model in the JSON format of XGBoost, as loaded by :code:`GBTreeModel`.
+
+        Returns
+        -------
+        model_json: Optional[bytes]
+            The model, None while it is not trained or still warming up.
+        """
+        if self.bst is None or len(self.inputs) <= self.num_warmup_sample:
+            return None
+        try:
+            return bytes(self.bst.save_raw("json"))
+        except TypeError:
+            # The older versions of xgboost only save JSON to a file
+            with tempfile.TemporaryDirectory() as tmpdir:
+                file_name = os.path.join(tmpdir, "model.json")
+                self.bst.save_model(file_name)
+                with open(file_name, "rb") as f:
+                    return f.read()
+
     def load(self, file_name: str):
         """Load the model from a file
         Parameters
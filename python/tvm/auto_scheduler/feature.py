@@ -26,7 +26,7 @@ the predicted score of each BufferStoreNode as the score of a TIR Stmt.
 The feature specification is defined by `src/auto_scheduler/feature.cc::FeatureSet`
 """
 
-from typing import List, Tuple, Union, Optional
+from typing import Dict, List, Tuple, Union, Optional
 import struct
 
 import numpy as np
@@ -252,3 +252,34 @@ def get_per_store_feature_names(max_n_bufs: Optional[int] = None) -> List[str]:
         The names of elements in the flatten feature vector
     """
     return _ffi_api.GetPerStoreFeatureNames(max_n_bufs or DEFAULT_MAX_N_BUFS)
+
+
+def set_feature_cache_capacity(capacity_nbytes: int):
+    """Set the capacity of the cache of the features extracted from the states.
+
+    The cache is shared by all the tasks, the least recently used states being evicted
+    beyond its capacity.
+
+    Parameters
+    ----------
+    capacity_nbytes: int
+        The capacity in bytes, 0 to disable the cache.
+    """
+    _ffi_api.SetFeatureCacheCapacity(capacity_nbytes)
+
+
+def get_feature_cache_stats() -> Dict[str, int]:
+    """Get the counters of the feature cache.
+
+    Returns
+    -------
+    stats: Dict[str, int]
+        The hits, misses and evictions since the last clear, the number of entries, their
+        approximate size in bytes and the capacity in bytes.
+    """
+    return {k: v.value for k, v in _ffi_api.GetFeatureCacheStats().items()}
+
+
+def clear_feature_cache():
+    """Remove all the states of the feature cache and reset its counters."""
+    _ffi_api.ClearFeatureCache()
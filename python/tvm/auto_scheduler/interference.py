@@ -0,0 +1,162 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Compare the kernel costs measured inside a compiled model with the tuning records.
+
+Tasks are tuned in isolation, but inside a model every kernel runs after its neighbors, which
+pollute the caches, let the clocks ramp and add launch gaps. The kernels whose cost in the model
+is much higher than their tuned cost are sensitive to this interference, and their in-situ
+costs give the task scheduler a better estimate of the end-to-end latency.
+"""
+import json
+import logging
+from collections import namedtuple
+
+from .measure_record import load_best_record
+from .utils import array_mean
+
+logger = logging.getLogger("auto_scheduler")
+
+KernelInterference = namedtuple(
+    "KernelInterference",
+    ["task_idx", "func_names", "in_situ_cost", "isolated_cost", "ratio", "sensitive"],
+)
+KernelInterference.__doc__ = """The costs in seconds of the kernels of a task in a model.
+
+Parameters
+----------
+task_idx : int
+    The index of the task.
+func_names : List[str]
+    The names of the kernels of the task in the model.
+in_situ_cost : float
+    The mean cost of one call of these kernels, measured in the model.
+isolated_cost : Optional[float]
+    The best cost of the task in the tuning records, None when it has no record.
+ratio : Optional[float]
+    in_situ_cost divided by isolated_cost.
+sensitive : bool
+    Whether the ratio is above the threshold.
+"""
+
+
+def measure_in_situ(
+    lib, dev, tasks, log_file, inputs=None, number=10, repeat=3, min_repeat_ms=0, threshold=1.2
+):
+    """Measure the kernels of the tasks inside a compiled model.
+
+    The kernels run in the order of the graph through the debug executor, so each one sees the
+    caches and the device state its neighbors leave. Their costs are compared with the best
+    isolated costs of the tasks in the tuning records.
+
+    Parameters
+    ----------
+    lib : GraphExecutorFactoryModule
+        The model compiled by relay.build, with the records of the tasks applied.
+    dev : Device
+        The device to run the model on.
+    tasks : List[SearchTask]
+        The tasks extracted from the model, e.g. by auto_scheduler.extract_tasks.
+    log_file : str
+        The tuning records of the tasks.
+    inputs : Optional[Dict[str, NDArray]]
+        The inputs of the model, the inputs are left uninitialized when not given.
+    number : int = 10
+        The number of runs of every kernel averaged in one repeat.
+    repeat : int = 3
+        The number of repeats, the costs are averaged over them.
+    min_repeat_ms : int = 0
+        The minimum duration of one repeat in milliseconds.
+    threshold : float = 1.2
+        The ratio of the in-situ cost to the isolated cost above which a kernel is flagged
+        as sensitive to the interference.
+
+    Returns
+    -------
+    interference : List[KernelInterference]
+        The costs of the tasks found in the model, in the order of the tasks.
+    """
+    # pylint: disable=import-outside-toplevel
+    from tvm.contrib.debugger import debug_executor
+
+    graph_json = lib.get_graph_json()
+    module = debug_executor.create(graph_json, lib.get_lib(), dev)
+    try:
+        module.set_input(**lib.get_params())
+        if inputs:
+            module.set_input(**inputs)
+        times = [float(t) for t in module.run_individual(number, repeat, min_repeat_ms)]
+    finally:
+        module.exit()
+
+    # The costs of the calls of every kernel, in the order of the graph
+    func_costs = {}
+    for node, cost in zip(json.loads(graph_json)["nodes"], times):
+        if node["op"] == "tvm_op":
+            func_costs.setdefault(node["attrs"]["func_name"], []).append(cost)
+
+    interference = []
+    for task_idx, task in enumerate(tasks):
+        func_names = [name for name in task.desc.split(",") if name in func_costs]
+        if not func_names:
+            continue
+        costs = [cost for name in func_names for cost in func_costs[name]]
+        in_situ_cost = sum(costs) / len(costs)
+        isolated_cost = ratio = None
+        inp, res = load_best_record(log_file, task.workload_key, task.target)
+        if inp is not None:
+            isolated_cost = array_mean(res.costs)
+            ratio = in_situ_cost / isolated_cost
+        sensitive = ratio is not None and ratio > threshold
+        if sensitive:
+            logger.warning(
+                "Kernels %s take %.2f us in the model, %.2fx their tuned cost",
+                ",".join(func_names),
+                in_situ_cost * 1e6,
+                ratio,
+            )
+        interference.append(
+            KernelInterference(task_idx, func_names, in_situ_cost, isolated_cost, ratio, sensitive)
+        )
+    return interference
+
+
+def in_situ_task_weights(task_weights, interference):
+    """Scale the weights of the tasks by their in-situ ratios for the task scheduler.
+
+    The task scheduler estimates the latency of a model by the sum of the best tuned costs
+    weighted by the task weights. Scaling the weights by the ratios of the in-situ to the
+    isolated costs lets this estimate follow the model, so the scheduler spends more trials on
+    the tasks whose kernels lose the most inside it.
+
+    Parameters
+    ----------
+    task_weights : List[float]
+        The weights of the tasks, e.g. from auto_scheduler.extract_tasks.
+    interference : List[KernelInterference]
+        The result of measure_in_situ.
+
+    Returns
+    -------
+    task_weights : List[float]
+        The scaled weights, a task without a ratio keeps its weight.
+    """
+    weights = [float(w) for w in task_weights]
+    for item in interference:
+        if item.ratio is not None:
+            weights[item.task_idx] *= item.ratio
+    return weights
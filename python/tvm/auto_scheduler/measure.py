@@ -305,14 +305,42 @@ class ProgramMeasurer(Object):
         The Verbosity level: 0 for silent, 1 to output information during program
     max_continuous_error : Optional[int]
         The number of allowed maximum continuous error before stop the tuning
+    cache_file : Optional[str]
+        The file keeping the costs of the measured programs across the tuning sessions.
     """
 
-    def __init__(self, builder, runner, callbacks, verbose, max_continuous_error=None):
+    def __init__(
+        self, builder, runner, callbacks, verbose, max_continuous_error=None, cache_file=None
+    ):
         max_continuous_error = max_continuous_error or -1  # -1 means using the default value
         self.__init_handle_by_constructor__(
-            _ffi_api.ProgramMeasurer, builder, runner, callbacks, verbose, max_continuous_error
+            _ffi_api.ProgramMeasurer,
+            builder,
+            runner,
+            callbacks,
+            verbose,
+            max_continuous_error,
+            cache_file or "",
         )
 
+    def measure(self, task, policy, measure_inputs):
+        """Build and run a list of MeasureInput, reusing the results of the known programs.
+
+        Parameters
+        ----------
+        task : SearchTask
+            The search task of the inputs.
+        policy : SearchPolicy
+            The search policy passed to the callbacks.
+        measure_inputs : List[MeasureInput]
+            The MeasureInputs to be measured.
+
+        Returns
+        -------
+        res : List[MeasureResult]
+        """
+        return _ffi_api.ProgramMeasurerMeasure(self, task, policy, measure_inputs)
+
 
 @tvm._ffi.register_object("auto_scheduler.LocalBuilder")
 class LocalBuilder(ProgramBuilder):
@@ -1075,8 +1103,7 @@ def _rpc_run(
     try:
         # upload built module
         remote = request_remote(key, host, port, priority, timeout)
-        remote.upload(build_res.filename)
-        func = remote.load_module(os.path.split(build_res.filename)[1])
+        func = remote.upload_and_load(build_res.filename)
         dev = remote.device(str(inp.task.target), 0)
         # Limitation:
         # We can not get PackFunction directly in the remote mode as it is wrapped
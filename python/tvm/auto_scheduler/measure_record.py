@@ -54,7 +54,8 @@ class RecordToFile(MeasureCallback):
 @tvm._ffi.register_object("auto_scheduler.RecordReader")
 class RecordReader(Object):
     """
-    Reader of the json log file.
+    Reader of the log file, either a json log or a binary log
+    written by :code:`convert_records_to_binary`.
 
     Parameters
     ----------
@@ -125,6 +126,27 @@ class RecordReader(Object):
         self.check_workload_key(inputs)
         return inputs, results
 
+    def read_workload(self, workload_key):
+        """Read all the records of a workload from the log file.
+
+        A binary log finds them through its workload index, a json log is scanned.
+
+        Parameters
+        ----------
+        workload_key : str
+            The workload key of the records.
+
+        Returns
+        -------
+        inputs : List[auto_scheduler.measure.MeasureInput]
+            The MeasureInputs of the workload, in file order.
+        results : List[auto_scheduler.measure.MeasureResult]
+            The MeasureResults of the workload, in file order.
+        """
+        inputs, results = _ffi_api.RecordReaderReadWorkload(self, workload_key)
+        self.check_workload_key(inputs)
+        return inputs, results
+
     def __iter__(self):
         while True:
             ret = _ffi_api.RecordReaderReadNext(self)
@@ -213,6 +235,49 @@ def save_records(filename, inputs, results):
     _ffi_api.SaveRecords(filename, inputs, results)
 
 
+def convert_records_to_binary(in_file, out_file):
+    """
+    Convert a json log file to the binary log format.
+
+    A binary log stores each distinct search task once and indexes the records by workload,
+    so it loads much faster than the json log. It is memory mapped by :code:`RecordReader`,
+    but cannot be appended to. Like the json log, it keeps the error number of the results
+    but not their error message, which reads back empty.
+
+    Parameters
+    ----------
+    in_file : str
+        The json log to read.
+    out_file : str
+        The binary log to write, overwritten.
+
+    Returns
+    -------
+    num_records : int
+        The number of records converted.
+    """
+    return _ffi_api.ConvertRecordsToBinary(in_file, out_file)
+
+
+def convert_records_to_json(in_file, out_file):
+    """
+    Convert a binary log file back to a json log.
+
+    Parameters
+    ----------
+    in_file : str
+        The binary log to read.
+    out_file : str
+        The json log to write, overwritten.
+
+    Returns
+    -------
+    num_records : int
+        The number of records converted.
+    """
+    return _ffi_api.ConvertRecordsToJSON(in_file, out_file)
+
+
 def load_best_record(filename, workload_key=None, target=None, include_compatible=False):
     """Return the best measurement pair form a log file. This may return none results if
     there is no legal measure pair with the specified workload_key/target found from the log file.
@@ -344,7 +409,7 @@ def distill_record_file(in_file, out_file):
 def main():
     """The main function for CLI."""
     parser = argparse.ArgumentParser()
-    parser.add_argument("--mode", choices=["distill"], default="distill")
+    parser.add_argument("--mode", choices=["distill", "to-binary", "to-json"], default="distill")
     parser.add_argument("-i", "--input", type=str, help="input file")
     parser.add_argument("-o", "--output", type=str, default=None, help="output file")
 
@@ -355,12 +420,23 @@ def main():
     if args.mode == "distill":
         args.output = args.output or args.input + ".best.json"
         distill_record_file(args.input, args.output)
+    elif args.mode == "to-binary":
+        args.output = args.output or args.input + ".bin"
+        num_records = convert_records_to_binary(args.input, args.output)
+        logger.info("Convert %d records from %s to %s", num_records, args.input, args.output)
+    elif args.mode == "to-json":
+        args.output = args.output or args.input + ".json"
+        num_records = convert_records_to_json(args.input, args.output)
+        logger.info("Convert %d records from %s to %s", num_records, args.input, args.output)
 
 
 """
 Usage:
 * Distill the best entries from a large log file
 e.g. python -m tvm.auto_scheduler.measure_record --mode distill -i input.json
+* Convert a log file to the binary log format, and back
+e.g. python -m tvm.auto_scheduler.measure_record --mode to-binary -i input.json -o input.bin
+e.g. python -m tvm.auto_scheduler.measure_record --mode to-json -i input.bin -o input.json
 """
 if __name__ == "__main__":
     main()
@@ -61,6 +61,30 @@ class PreloadMeasuredStates(SearchCallback):
         self.__init_handle_by_constructor__(_ffi_api.PreloadMeasuredStates, filename)
 
 
+@tvm._ffi.register_object("auto_scheduler.WarmStartFromSimilarWorkloads")
+class WarmStartFromSimilarWorkloads(SearchCallback):
+    """A SearchCallback to warm start a search policy with the best states of similar workloads.
+
+    The workloads of the same function or compute DAG whose arguments only differ in their
+    integers, e.g. another batch size or resolution of an already tuned model, are ranked by
+    their shape distance. The transform steps of their best records are replayed on the new
+    workload, and the states that replay are measured in the first search round and join the
+    initial population of the evolutionary search.
+
+    Parameters
+    ----------
+    filename : str
+        The name of the record file.
+    num_states : int = 8
+        The maximum number of states to take from the similar workloads.
+    """
+
+    def __init__(self, filename, num_states=8):
+        self.__init_handle_by_constructor__(
+            _ffi_api.WarmStartFromSimilarWorkloads, filename, num_states
+        )
+
+
 @tvm._ffi.register_object("auto_scheduler.PreloadCustomSketchRule")
 class PreloadCustomSketchRule(SearchCallback):
     """
@@ -173,6 +197,7 @@ class SketchPolicy(SearchPolicy):
         Possible callbacks:
 
           - auto_scheduler.PreloadMeasuredStates
+          - auto_scheduler.WarmStartFromSimilarWorkloads
           - auto_scheduler.PreloadCustomSketchRule
     """
 
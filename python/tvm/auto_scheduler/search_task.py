@@ -167,6 +167,10 @@ class TuningOptions(Object):
         Callback functions called after each measurement.
         Candidates:
         - auto_scheduler.RecordToFile
+    measure_cache_file: Optional[str]
+        The file keeping the costs of the measured programs across the tuning sessions.
+        The programs are identified by their lowered TIR, and those found in this file are not
+        built and run again.
     """
 
     def __init__(
@@ -178,6 +182,7 @@ class TuningOptions(Object):
         builder="local",
         runner="local",
         measure_callbacks=None,
+        measure_cache_file=None,
     ):
         if isinstance(builder, str):
             if builder == "local":
@@ -210,6 +215,7 @@ class TuningOptions(Object):
             builder,
             runner,
             measure_callbacks,
+            measure_cache_file or "",
         )
 
 
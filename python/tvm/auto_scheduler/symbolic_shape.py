@@ -0,0 +1,125 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""
+Tune a computation having a symbolic dimension, e.g. a dynamic batch, once for a set of
+representative sizes, and emit a single kernel for the whole range of the dimension.
+
+The kernel applies the schedules tuned for the representative sizes to the symbolic
+computation, and selects one of them from the runtime size: the schedule of the smallest
+representative size not smaller than it, or of the largest one.
+"""
+
+import tvm
+from tvm import te
+
+from .compute_dag import ComputeDAG, LayoutRewriteOption
+from .measure_record import load_best_record
+from .search_task import SearchTask
+from .workload_registry import WORKLOAD_FUNC_REGISTRY
+
+
+def _replace_arg(args, index, value):
+    args = list(args)
+    args[index] = value
+    return tuple(args)
+
+
+def create_symbolic_tasks(func, args, symbolic_index, sizes, target, **kwargs):
+    """Create the search tasks of the representative sizes of a symbolic dimension.
+
+    Parameters
+    ----------
+    func : Union[Function, str]
+        The registered workload function of the computation.
+    args : Union[Tuple[Any, ...], List[Any]]
+        The arguments of func, the symbolic one being ignored.
+    symbolic_index : int
+        The index of the argument of func giving the symbolic dimension.
+    sizes : List[int]
+        The representative sizes of the dimension to tune for.
+    target : Union[tvm.target.Target, str]
+        The target device of the tasks.
+    kwargs : Dict[str, Any]
+        The other arguments of the SearchTask constructor.
+
+    Returns
+    -------
+    tasks : List[SearchTask]
+        The tasks, sorted by size, to be tuned e.g. with a TaskScheduler.
+    """
+    # The schedules are replayed on the symbolic computation, which needs the original layout.
+    kwargs.setdefault("layout_rewrite_option", LayoutRewriteOption.NO_REWRITE)
+    tasks = []
+    for size in sorted(sizes):
+        task_args = _replace_arg(args, symbolic_index, size)
+        tasks.append(SearchTask(func=func, args=task_args, target=target, **kwargs))
+    return tasks
+
+
+def build_symbolic_kernel(
+    func, args, symbolic_index, sizes, log_file, target, name="default_function", var_name="n"
+):
+    """Build the kernel of a computation for any size of its symbolic dimension, from the
+    schedules tuned for the tasks of create_symbolic_tasks.
+
+    Parameters
+    ----------
+    func : Union[Function, str]
+        The registered workload function of the computation, also called with a te.Var.
+    args : Union[Tuple[Any, ...], List[Any]]
+        The arguments of func, the symbolic one being ignored.
+    symbolic_index : int
+        The index of the argument of func giving the symbolic dimension.
+    sizes : List[int]
+        The representative sizes of the dimension. The ones without a record are skipped.
+    log_file : str
+        The tuning records.
+    target : Union[tvm.target.Target, str]
+        The target device.
+    name : str
+        The name of the kernel.
+    var_name : str
+        The name of the symbolic dimension.
+
+    Returns
+    -------
+    mod : tvm.IRModule
+        The lowered kernel, to be built with tvm.build.
+    """
+    tasks = create_symbolic_tasks(func, args, symbolic_index, sizes, target)
+    symbol = te.var(var_name)
+    if isinstance(func, str):
+        func = WORKLOAD_FUNC_REGISTRY[func]
+    dag = ComputeDAG(func(*_replace_arg(args, symbolic_index, symbol)))
+    binds = None
+    kernels = []
+    for size, task in zip(sorted(sizes), tasks):
+        inp, _ = load_best_record(log_file, task.workload_key, target=task.target)
+        if inp is None:
+            continue
+        sch, kernel_args = dag.apply_steps_from_state(inp.state)
+        if binds is None:
+            # The kernels share their buffers, so their bodies can be chained.
+            binds = {t: tvm.tir.decl_buffer(t.shape, t.dtype, name=t.op.name) for t in kernel_args}
+        kernels.append((size, tvm.lower(sch, kernel_args, name=name, binds=binds)[name]))
+    if not kernels:
+        raise ValueError("No tuning record of %s in %s" % (name, log_file))
+
+    body = kernels[-1][1].body
+    for size, kernel in reversed(kernels[:-1]):
+        body = tvm.tir.IfThenElse(symbol <= size, kernel.body, body)
+    return tvm.IRModule({name: kernels[0][1].with_body(body)})
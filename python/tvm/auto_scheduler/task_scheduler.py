@@ -30,7 +30,7 @@ import logging
 import numpy as np
 
 from .search_policy import SearchPolicy, SketchPolicy, PreloadMeasuredStates
-from .cost_model import RandomModel, XGBModel
+from .cost_model import RandomModel, GBTreeModel, XGBModel
 from .utils import array_mean
 from .measure import ProgramMeasurer
 from .measure_record import RecordReader
@@ -39,6 +39,20 @@ from . import _ffi_api
 logger = logging.getLogger("auto_scheduler")
 
 
+def _custom_sketch_rules(task):
+    """The custom sketch rules of the operators of a task the default rules do not handle
+    well, the sparse operators on CPU."""
+    if task.target.kind.name != "llvm":
+        return []
+    sparse_tags = ("sparse_dense_sp_rhs_bsrmm", "sparse_conv2d_sp_bsrmm")
+    if not any(op.tag.startswith(sparse_tags) for op in task.compute_dag.ops):
+        return []
+    # pylint: disable=import-outside-toplevel
+    from tvm.topi.sparse.utils import sparse_sketch_rules
+
+    return sparse_sketch_rules()
+
+
 def make_search_policies(
     search_policy,
     search_policy_params,
@@ -85,7 +99,7 @@ def make_search_policies(
 
     if isinstance(search_policy, str):
         policy_type, model_type = search_policy.split(".")
-        if model_type == "xgb":
+        if model_type in ("xgb", "xgb-native"):
             cost_model = XGBModel(
                 num_warmup_sample=len(tasks) * num_measures_per_round,
                 model_file=load_model_file,
@@ -97,6 +111,9 @@ def make_search_policies(
             elif load_log_file:
                 logger.info("TaskScheduler: Reload measured states and train the model...")
                 cost_model.update_from_file(load_log_file)
+            if model_type == "xgb-native":
+                # train in python, predict in C++
+                cost_model = GBTreeModel(trainer=cost_model)
         elif model_type == "random":
             cost_model = RandomModel()
         else:
@@ -107,14 +124,14 @@ def make_search_policies(
                 # use the log file to restore the status of search policies.
                 init_search_callbacks = [PreloadMeasuredStates(load_log_file)]
             else:
-                init_search_callbacks = None
+                init_search_callbacks = []
             search_policies = [
                 SketchPolicy(
                     task,
                     cost_model,
                     params=search_policy_params,
                     verbose=verbose,
-                    init_search_callbacks=init_search_callbacks,
+                    init_search_callbacks=init_search_callbacks + _custom_sketch_rules(task),
                 )
                 for task in tasks
             ]
@@ -297,6 +314,7 @@ class TaskScheduler:
             If it is str,
             "default" for the default policy (SketchPolicy + XGBModel),
             "sketch.xgb" for SketchPolicy + XGBModel,
+            "sketch.xgb-native" for SketchPolicy + XGBModel scored by GBTreeModel in C++,
             "sketch.random" for SketchPolicy + RandomModel.
         search_policy_params : Optional[Dict[str, Any]]
             The parameters of the search policy
@@ -320,6 +338,7 @@ class TaskScheduler:
             tune_option.runner,
             tune_option.measure_callbacks,
             tune_option.verbose,
+            cache_file=tune_option.measure_cache_file,
         )
         self.ct = self.best_ct = 0
         self.tic = time.time()
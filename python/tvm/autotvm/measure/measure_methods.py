@@ -679,9 +679,8 @@ class DefaultModuleLoader:
         if self.pre_load_function is not None:
             self.pre_load_function(remote, build_result)
 
-        remote.upload(build_result.filename)
         try:
-            yield remote, remote.load_module(os.path.split(build_result.filename)[1])
+            yield remote, remote.upload_and_load(build_result.filename)
 
         finally:
             # clean up remote files
@@ -30,6 +30,7 @@ of the DispatchContext base class.
 
 from __future__ import absolute_import as _abs
 
+import hashlib
 import logging
 
 import numpy as np
@@ -144,6 +145,38 @@ class DispatchContext(object):
         """
         raise NotImplementedError()
 
+    def digest(self):
+        """
+        Get a digest of the configs picked under this context.
+
+        Returns
+        -------
+        digest : str or None
+            The same digest for the contexts dispatching each workload to the same config,
+            including the contexts they fall back to. None when a context cannot be digested.
+        """
+        parts = []
+        ctx = self
+        while ctx is not None:
+            part = ctx._digest_inside()
+            if part is None:
+                return None
+            parts.append(type(ctx).__name__ + "\n" + part)
+            ctx = ctx._old_ctx
+        return hashlib.sha256("\n".join(parts).encode()).hexdigest()
+
+    def _digest_inside(self):
+        """
+        Describe the configs picked by this context itself, without the ones it falls back to.
+        The contexts that do not implement it cannot be digested.
+
+        Returns
+        -------
+        configs : str or None
+            The configs, None when they cannot be described.
+        """
+        return None
+
     def __enter__(self):
         self._old_ctx = DispatchContext.current
         DispatchContext.current = self
@@ -177,6 +210,9 @@ class ApplyConfig(DispatchContext):
         self.workload = workload
         self._config = cfg
 
+    def _digest_inside(self):
+        return str(self._config)
+
 
 class ApplyHistoryBest(DispatchContext):
     """
@@ -196,6 +232,7 @@ class ApplyHistoryBest(DispatchContext):
         self.best_by_targetkey = {}
         self.best_by_model = {}
         self._best_user_defined = {}
+        self._configs_digest = None
 
         if records:
             self.load(records)
@@ -224,6 +261,7 @@ class ApplyHistoryBest(DispatchContext):
 
         best_by_targetkey = self.best_by_targetkey
         best_by_model = self.best_by_model
+        self._configs_digest = None
 
         counter = 0
         for inp, res in records:
@@ -286,11 +324,24 @@ class ApplyHistoryBest(DispatchContext):
         # assume user provided config is the best
         cfg.cost = 0
         self._best_user_defined[key] = cfg
+        self._configs_digest = None
 
         for k in target.keys:
             key = (k, workload)
             self._best_user_defined[key] = cfg
 
+    def _digest_inside(self):
+        # the records of a log are only sorted once
+        if self._configs_digest is None:
+            configs = []
+            best_maps = [("targetkey", self.best_by_targetkey), ("model", self.best_by_model)]
+            for name, best in best_maps:
+                configs += [(name, k, str(inp.config)) for k, (inp, _) in best.items()]
+            configs += [("user", k, str(cfg)) for k, cfg in self._best_user_defined.items()]
+            configs = "\n".join(sorted(repr(config) for config in configs))
+            self._configs_digest = hashlib.sha256(configs.encode()).hexdigest()
+        return self._configs_digest
+
 
 class FallbackContext(DispatchContext):
     """
@@ -303,6 +354,8 @@ class FallbackContext(DispatchContext):
     def __init__(self):
         super(FallbackContext, self).__init__()
         self.memory = {}
+        # the configs set by update, the other ones are the default fallback configs
+        self._updated = {}
 
     def _query_inside(self, target, workload):
         key = (str(target), workload)
@@ -337,10 +390,15 @@ class FallbackContext(DispatchContext):
         key = (str(target), workload)
         if key in self.memory:
             del self.memory[key]
+        self._updated.pop(key, None)
 
     def update(self, target, workload, cfg):
         key = (str(target), workload)
         self.memory[key] = cfg
+        self._updated[key] = cfg
+
+    def _digest_inside(self):
+        return "\n".join(sorted(repr((k, str(cfg))) for k, cfg in self._updated.items()))
 
 
 DispatchContext.current = FallbackContext()
@@ -0,0 +1,237 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Executor of the models compiled with the AOT executor, from the C++ runtime."""
+import tvm._ffi
+from tvm.runtime import ndarray
+
+
+def create(executor_config, libmod, device):
+    """Create an executor of a model compiled with the AOT executor.
+
+    Parameters
+    ----------
+    executor_config : str
+        The executor config, see AOTExecutorFactoryModule.get_executor_config.
+
+    libmod : tvm.runtime.Module
+        The module of the main function and the operators.
+
+    device : Device or list of Device
+        The devices to run the model on, the first one holding the inputs and the outputs.
+
+    Returns
+    -------
+    aot_module : AotModule
+        The executor.
+    """
+    devices = device if isinstance(device, (list, tuple)) else [device]
+    fcreate = tvm._ffi.get_global_func("tvm.aot_executor.create")
+    return AotModule(fcreate(executor_config, libmod, *devices))
+
+
+class AotModule(object):
+    """Wrapper of the executor of a model compiled with the AOT executor.
+
+    The main function of the model calls the operators directly, without graph JSON and
+    dispatch of each operator, the executor only owning the inputs and the outputs.
+
+    Parameters
+    ----------
+    module : tvm.runtime.Module
+        The executor module.
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        import tvm
+        from tvm import relay
+        from tvm.relay.backend import Executor
+        from tvm.contrib import aot_executor
+
+        lib = relay.build(mod, target="llvm", params=params, executor=Executor("aot"))
+        lib.export_library("compiled_lib.so")
+        lib = tvm.runtime.load_module("compiled_lib.so")
+        amod = aot_executor.AotModule(lib["default"](tvm.cpu()))
+        amod.set_input("x", data)
+        amod.run()
+        out = amod.get_output(0)
+    """
+
+    def __init__(self, module):
+        self.module = module
+        self._set_input = module["set_input"]
+        self._set_input_zero_copy = module["set_input_zero_copy"]
+        self._set_output_zero_copy = module["set_output_zero_copy"]
+        self._run = module["run"]
+        self._get_output = module["get_output"]
+        self._get_input = module["get_input"]
+        self._get_input_index = module["get_input_index"]
+        self._get_num_inputs = module["get_num_inputs"]
+        self._get_num_outputs = module["get_num_outputs"]
+
+    def set_input(self, key=None, value=None, **params):
+        """Copy inputs into the executor.
+
+        Parameters
+        ----------
+        key : int or str
+           The input key
+
+        value : the input value
+
+        params : dict of str to NDArray
+           Additional inputs
+        """
+        if key is not None:
+            params = dict(params)
+            params[key] = value
+        for k, v in params.items():
+            if not isinstance(v, ndarray.NDArray):
+                v = ndarray.array(v)
+            self._set_input(k, v)
+
+    def set_input_zero_copy(self, key, value):
+        """Use an array as an input without copying it, the array must outlive its use.
+
+        Parameters
+        ----------
+        key : int or str
+           The input key
+
+        value : NDArray
+           The input array, of the shape, type and device of the input
+        """
+        self._set_input_zero_copy(key, value)
+
+    def set_output_zero_copy(self, index, value):
+        """Write an output into an array without copying it, the array must outlive its use.
+
+        Parameters
+        ----------
+        index : int
+           The output index
+
+        value : NDArray
+           The output array, of the shape, type and device of the output
+        """
+        self._set_output_zero_copy(index, value)
+
+    def run(self, **input_dict):
+        """Run the model.
+
+        Parameters
+        ----------
+        input_dict : dict of str to NDArray
+            The inputs to set before running
+        """
+        if input_dict:
+            self.set_input(**input_dict)
+        self._run()
+
+    def get_num_inputs(self):
+        """Get the number of inputs."""
+        return self._get_num_inputs()
+
+    def get_num_outputs(self):
+        """Get the number of outputs."""
+        return self._get_num_outputs()
+
+    def get_input_index(self, name):
+        """Get the index of an input, -1 if there is no such input."""
+        return self._get_input_index(name)
+
+    def get_input(self, index, out=None):
+        """Get an input.
+
+        Parameters
+        ----------
+        index : int or str
+            The input index or name
+
+        out : NDArray
+            The array the input is copied to
+        """
+        if out:
+            self._get_input(index).copyto(out)
+            return out
+        return self._get_input(index)
+
+    def get_output(self, index, out=None):
+        """Get an output.
+
+        Parameters
+        ----------
+        index : int
+            The output index
+
+        out : NDArray
+            The array the output is copied to
+        """
+        if out:
+            self._get_output(index, out)
+            return out
+        return self._get_output(index)
+
+    def start_streaming(self, num_buffers, inputs):
+        """Start running the model on a stream of frames, such as camera images.
+
+        A worker thread runs the frames in their order while the next ones are
+        copied in by :py:meth:`push_frame`, each frame taking one of
+        ``num_buffers`` sets of tensors. The other functions of the module must
+        not be called until :py:meth:`stop_streaming`.
+
+        Parameters
+        ----------
+        num_buffers : int
+            The number of frames in flight, at least 2.
+
+        inputs : list of int or str
+            The inputs given by each frame, the others keep their value.
+        """
+        self.module["start_streaming"](num_buffers, *inputs)
+
+    def push_frame(self, *inputs):
+        """Copy the inputs of the next frame, waiting while all the buffers are in use.
+
+        Only :py:meth:`pop_frame` gives a buffer back, so a caller pushing and
+        popping from one thread keeps at most ``num_buffers - 1`` frames pushed
+        and not popped.
+
+        Parameters
+        ----------
+        inputs : list of NDArray or numpy.ndarray
+            One array per input given to :py:meth:`start_streaming`.
+        """
+        self.module["push_frame"](
+            *[x if isinstance(x, ndarray.NDArray) else ndarray.array(x) for x in inputs]
+        )
+
+    def pop_frame(self):
+        """Wait for the outputs of the oldest frame not popped yet.
+
+        Returns
+        -------
+        outputs : list of NDArray
+            The outputs, valid until the next call to pop_frame.
+        """
+        return list(self.module["pop_frame"]())
+
+    def stop_streaming(self):
+        """Wait for the frames pushed and go back to the inputs and outputs of the module."""
+        self.module["stop_streaming"]()
@@ -0,0 +1,105 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Batching executor that groups individual requests into dynamic batches."""
+import tvm._ffi
+from tvm.contrib import graph_executor
+from tvm.runtime import vm as _vm
+
+
+def batching_executor_enabled():
+    """Check if the batching executor is enabled.
+
+    Return
+    -------
+    enable: bool
+        Return whether the batching executor is enabled.
+    """
+    return tvm._ffi.get_global_func("tvm.batching_executor.create", allow_missing=True) is not None
+
+
+def create(variants, max_batch_size=0, max_latency_ms=1.0):
+    """Create a batching executor.
+
+    Parameters
+    ----------
+    variants : list
+        The executors to run batches on. Each item is a
+        :py:class:`~tvm.contrib.graph_executor.GraphModule` compiled for a fixed
+        batch size, which is read from its first input, or a pair of a
+        :py:class:`~tvm.runtime.vm.VirtualMachine` whose "main" accepts any batch
+        size and the batch size it was compiled for (0 for any).
+
+    max_batch_size : int
+        The largest number of rows run together. Defaults to the largest fixed
+        variant.
+
+    max_latency_ms : float
+        The longest a request waits for more requests to join its batch.
+
+    Returns
+    -------
+    executor : BatchingExecutor
+        The batching executor.
+    """
+    args = []
+    for variant in variants:
+        if isinstance(variant, graph_executor.GraphModule):
+            args += [-1, variant.module]
+        else:
+            vm, batch_size = variant
+            assert isinstance(vm, _vm.VirtualMachine)
+            args += [batch_size, vm.module]
+    fcreate = tvm._ffi.get_global_func("tvm.batching_executor.create")
+    return BatchingExecutor(fcreate(max_batch_size, int(max_latency_ms * 1000), *args))
+
+
+class BatchingExecutor(object):
+    """Wrapper of the batching executor module.
+
+    Parameters
+    ----------
+    module : tvm.runtime.Module
+        The module created by ``tvm.batching_executor.create``.
+    """
+
+    def __init__(self, module):
+        self.module = module
+        self._run = module["run"]
+        self._get_num_batches = module["get_num_batches"]
+
+    def run(self, *inputs):
+        """Run one request, blocking until the batch it joined has finished.
+
+        It is safe to call from many threads at once; concurrent calls are the
+        requests that get batched together.
+
+        Parameters
+        ----------
+        inputs : list of NDArray
+            The inputs of the request, all with the same leading batch dimension.
+
+        Returns
+        -------
+        outputs : list of NDArray
+            The outputs restricted to the rows of this request, on the CPU.
+        """
+        return list(self._run(*[tvm.nd.array(x) for x in inputs]))
+
+    @property
+    def num_batches(self):
+        """The number of batches run so far."""
+        return self._get_num_batches()
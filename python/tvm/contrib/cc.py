@@ -18,7 +18,10 @@
 # pylint: disable=invalid-name
 import sys
 import os
+import hashlib
+import shutil
 import subprocess
+from concurrent.futures import ThreadPoolExecutor
 
 from .._ffi.base import py_str
 
@@ -77,6 +80,70 @@ def create_executable(output, objects, options=None, cc="g++"):
         raise ValueError("Unsupported platform")
 
 
+def compile_objects(files, workspace_dir, options=None, cc="g++", num_workers=None, cache_dir=None):
+    """Compile the C and C++ sources of a file list to object files in parallel.
+
+    Parameters
+    ----------
+    files : List[str]
+        The files to link, the sources among them are compiled.
+
+    workspace_dir : str
+        The directory of the object files.
+
+    options : List[str]
+        The list of additional options string, passed to each compilation.
+
+    cc : Optional[str]
+        The compiler command.
+
+    num_workers : Optional[int]
+        The number of concurrent compilations, the number of CPUs by default.
+
+    cache_dir : Optional[str]
+        The directory caching the object files, keyed by the hash of the compiler,
+        the options and the source content. An unchanged source is not compiled again.
+
+    Returns
+    -------
+    files : List[str]
+        The files, with each source replaced by its object file.
+    """
+    options = list(options) if options else []
+
+    def _compile(index, path):
+        with open(path, "rb") as f:
+            code = f.read()
+        key = hashlib.sha256(
+            "\0".join([cc] + options + [os.path.splitext(path)[1]]).encode() + b"\0" + code
+        ).hexdigest()
+        cached = os.path.join(cache_dir, key + ".o") if cache_dir else None
+        if cached and os.path.isfile(cached):
+            return cached
+        obj = os.path.join(workspace_dir, "obj%d_%s.o" % (index, key[:16]))
+        _linux_compile(obj, path, ["-c", "-fPIC"] + options, cc)
+        if cached:
+            # write to a temporary file then rename, so concurrent exports never see a partial one
+            temp = "%s.%d.tmp" % (cached, os.getpid())
+            shutil.copyfile(obj, temp)
+            os.replace(temp, cached)
+        return obj
+
+    if cache_dir:
+        os.makedirs(cache_dir, exist_ok=True)
+    sources = [
+        (index, path)
+        for index, path in enumerate(files)
+        if path.endswith((".c", ".cc", ".cpp"))
+    ]
+    result = list(files)
+    with ThreadPoolExecutor(max_workers=num_workers or os.cpu_count()) as executor:
+        objects = executor.map(lambda item: _compile(*item), sources)
+        for (index, _), obj in zip(sources, objects):
+            result[index] = obj
+    return result
+
+
 def get_target_by_dump_machine(compiler):
     """Functor of get_target_triple that can get the target triple using compiler.
 
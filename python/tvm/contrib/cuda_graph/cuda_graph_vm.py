@@ -0,0 +1,123 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Relay virtual machine with CUDA Graph replay"""
+from tvm.runtime import _ffi_api
+from tvm.runtime import vm
+
+
+def enabled():
+    """Whether the CUDA Graph virtual machine is enabled."""
+    return hasattr(_ffi_api, "_VirtualMachineCudaGraph")
+
+
+class VirtualMachineCudaGraph(vm.VirtualMachine):
+    """Relay VM runtime that captures each invocation into a CUDA Graph.
+
+    A graph is captured the first time a function is invoked with a given set of
+    input shapes and dtypes, and replayed on later invocations with the same
+    signature. Models with dynamic shapes should pad their inputs to a fixed set
+    of shape buckets so that each bucket is captured once.
+
+    The outputs of a replay live in memory owned by the captured graph and are
+    overwritten by the next replay of the same graph.
+
+    Parameters
+    ----------
+    exe : Executable
+        The VM executable.
+
+    device : Device
+        The device to run on, only supports CUDA GPU.
+
+    memory_cfg : str or Dict[tvm.runtime.Device, str], optional
+        Config the type of memory allocator.
+    """
+
+    def __init__(self, exe, device, memory_cfg=None):
+        super(VirtualMachineCudaGraph, self).__init__(exe, device, memory_cfg)
+        self.module = _ffi_api._VirtualMachineCudaGraph(exe.module)
+
+        self._init = self.module["init"]
+        self._invoke = self.module["invoke"]
+        self._set_input = self.module["set_input"]
+        self._invoke_cuda_graph = self.module["invoke_cuda_graph"]
+        self._set_cuda_graph_cache_size = self.module["set_cuda_graph_cache_size"]
+        self._get_cuda_graph_cache_size = self.module["get_cuda_graph_cache_size"]
+        self._setup_device(device, memory_cfg)
+
+    def invoke_cuda_graph(self, func_name, *args, **kwargs):
+        """Invoke a function through its captured CUDA Graph.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : list[tvm.runtime.NDArray] or list[np.ndarray]
+            The arguments to the function.
+
+        kwargs: dict of str to tvm.runtime.NDArray or np.ndarray
+            Named arguments to the function.
+
+        Returns
+        -------
+        result : Object
+            The output.
+        """
+        if args or kwargs:
+            self.set_input(func_name, *args, **kwargs)
+        return self._invoke_cuda_graph(func_name)
+
+    def run(self, *args, **kwargs):
+        """Run the main function through its captured CUDA Graph.
+
+        Parameters
+        ----------
+        args : list[tvm.runtime.NDArray] or list[np.ndarray]
+            The arguments to the function.
+
+        kwargs: dict of str to tvm.runtime.NDArray or np.ndarray
+            Named arguments to the function.
+
+        Returns
+        -------
+        result : Object
+            The output.
+        """
+        return self.invoke_cuda_graph("main", *args, **kwargs)
+
+    def set_cuda_graph_cache_size(self, max_num_graphs):
+        """Set the maximum number of captured graphs kept alive.
+
+        The least recently replayed graphs are evicted first.
+
+        Parameters
+        ----------
+        max_num_graphs : int
+            The maximum number of graphs, must be at least 1.
+        """
+        self._set_cuda_graph_cache_size(max_num_graphs)
+
+    def get_cuda_graph_cache_size(self):
+        """Get the number of captured graphs currently cached.
+
+        Returns
+        -------
+        num_graphs : int
+            The number of cached graphs.
+        """
+        return self._get_cuda_graph_cache_size()
@@ -207,8 +207,12 @@ def handle_conv2d(
         else:
             logger.info("Picked the first kernel found %s", out["name"])
 
-    if op_type == "cutlass.conv2d":
+    if op_type in ["cutlass.conv2d", "cutlass.conv2d_residual_add"]:
         cutlass_op_def = out["opdef"]
+    elif op_type == "cutlass.conv2d_bias":
+        cutlass_op_def = out["opdef_bias"]
+    elif op_type in ["cutlass.conv2d_bias_relu", "cutlass.conv2d_residual_add_relu"]:
+        cutlass_op_def = out["opdef_bias_relu"]
     else:
         raise ValueError("%s pattern is not implemented." % op_type)
 
@@ -17,6 +17,8 @@
 # pylint: disable=invalid-name
 """GEMM kernel generator and profiler for CUTLASS."""
 from functools import partial
+import json
+import os
 import re
 from .gemm_operation import GemmOperation, EmitGemmInstance
 from .gemm_profiler import GemmProfilerEmitter
@@ -159,6 +161,28 @@ class CutlassGemmProfiler:
         self.engine = ProfilerEngine(sm, cutlass_path, binary_path)
         self.sm = sm
         self.cache = {}
+        # The names of the selected kernels are kept on disk, so that a later build with the
+        # same binary_path does not profile the same workloads again.
+        self.cache_path = os.path.join(binary_path, "cutlass_profile_cache.json")
+        self.disk_cache = {}
+        if os.path.exists(self.cache_path):
+            with open(self.cache_path, "r") as f:
+                self.disk_cache = json.load(f)
+
+    def _disk_cache_key(self, M, N, K, out_dtype, batched):
+        kind = "batched" if batched else "gemm"
+        return "sm%d_%s_%s_%dx%dx%d" % (self.sm, out_dtype, kind, M, N, K)
+
+    def _save_disk_cache(self):
+        os.makedirs(os.path.dirname(self.cache_path) or ".", exist_ok=True)
+        # Other profilers may have recorded workloads since this one loaded the file.
+        if os.path.exists(self.cache_path):
+            with open(self.cache_path, "r") as f:
+                self.disk_cache = dict(json.load(f), **self.disk_cache)
+        tmp_path = self.cache_path + ".tmp"
+        with open(tmp_path, "w") as f:
+            json.dump(self.disk_cache, f, indent=2, sort_keys=True)
+        os.replace(tmp_path, self.cache_path)
 
     def check_align(self, op_name, M):
         """Filter out kernels that cannot be supported."""
@@ -188,14 +212,25 @@ class CutlassGemmProfiler:
         If profile_all is False, return immediately after the first applicable kernel is found.
         If use_multiprocessing is True, compile all profiler executables in parallel.
         """
-        if (M, N, K) in self.cache:
-            return self.cache[(M, N, K)]
+        if (M, N, K, out_dtype, batched) in self.cache:
+            return self.cache[(M, N, K, out_dtype, batched)]
 
         ops = GENERATOR_FUNC_TABLE[self.sm](
             out_dtype, op_creator=partial(create_gemm_operator, batched=batched)
         )
         ops = list(filter(lambda op: self.check_align(op["name"], M), ops))
 
+        # A kernel found without profiling all candidates is only reused by a build that
+        # does not ask for the best one either.
+        disk_key = self._disk_cache_key(M, N, K, out_dtype, batched)
+        entry = self.disk_cache.get(disk_key)
+        if entry is not None and (entry["profile_all"] or not profile_all):
+            cached = [op for op in ops if op["name"] == entry["name"]]
+            if cached:
+                cached[0]["runtime"] = entry["runtime"]
+                self.cache[(M, N, K, out_dtype, batched)] = cached[0]
+                return cached[0]
+
         for op in ops:
             op["runtime"] = -1
 
@@ -210,5 +245,11 @@ class CutlassGemmProfiler:
 
         valid_ops = filter(lambda op: op["runtime"] > 0, ops)
         output = sorted(valid_ops, key=lambda i: i["runtime"])
-        self.cache[(M, N, K)] = output[0]
+        self.cache[(M, N, K, out_dtype, batched)] = output[0]
+        self.disk_cache[disk_key] = {
+            "name": output[0]["name"],
+            "runtime": output[0]["runtime"],
+            "profile_all": profile_all,
+        }
+        self._save_disk_cache()
         return output[0]
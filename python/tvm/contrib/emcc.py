@@ -21,7 +21,7 @@ from tvm._ffi.base import py_str
 from tvm._ffi.libinfo import find_lib_path
 
 
-def create_tvmjs_wasm(output, objects, options=None, cc="emcc"):
+def create_tvmjs_wasm(output, objects, options=None, cc="emcc", threaded=False):
     """Create wasm that is supposed to run with the tvmjs.
 
     Parameters
@@ -37,6 +37,12 @@ def create_tvmjs_wasm(output, objects, options=None, cc="emcc"):
 
     cc : str, optional
         The compile string.
+
+    threaded : bool, optional
+        Whether to link the threaded runtime built by ``make threaded``, which runs the
+        parallel loops on Web Workers. The objects must be built for
+        ``tvm.target.wasm(threads=True)``, and the page must be cross origin isolated to
+        use SharedArrayBuffer.
     """
     cmd = [cc]
     cmd += ["-O3"]
@@ -44,21 +50,27 @@ def create_tvmjs_wasm(output, objects, options=None, cc="emcc"):
     cmd += ["-std=c++14"]
     cmd += ["--no-entry"]
     cmd += ["-s", "ERROR_ON_UNDEFINED_SYMBOLS=0"]
-    cmd += ["-s", "STANDALONE_WASM=1"]
+    if threaded:
+        # emscripten starts the threads from its js, a standalone wasm has none
+        cmd += ["-pthread"]
+        cmd += ["-s", "PTHREAD_POOL_SIZE=navigator.hardwareConcurrency"]
+    else:
+        cmd += ["-s", "STANDALONE_WASM=1"]
     cmd += ["-s", "ALLOW_MEMORY_GROWTH=1"]
 
     objects = [objects] if isinstance(objects, str) else objects
+    suffix = "_threaded.bc" if threaded else ".bc"
 
     with_runtime = False
     for obj in objects:
-        if obj.find("wasm_runtime.bc") != -1:
+        if obj.find("wasm_runtime" + suffix) != -1:
             with_runtime = True
 
     if not with_runtime:
-        objects += [find_lib_path("wasm_runtime.bc")[0]]
+        objects += [find_lib_path("wasm_runtime" + suffix)[0]]
 
-    objects += [find_lib_path("tvmjs_support.bc")[0]]
-    objects += [find_lib_path("webgpu_runtime.bc")[0]]
+    objects += [find_lib_path("tvmjs_support" + suffix)[0]]
+    objects += [find_lib_path("webgpu_runtime" + suffix)[0]]
 
     cmd += ["-o", output]
     cmd += objects
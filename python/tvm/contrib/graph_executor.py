@@ -15,6 +15,9 @@
 # specific language governing permissions and limitations
 # under the License.
 """Minimum graph executor that executes graph containing TVM PackedFunc."""
+import ctypes
+import json
+
 import numpy as np
 import tvm._ffi
 
@@ -160,6 +163,7 @@ class GraphModule(object):
         self._get_input_index = module["get_input_index"]
         self._get_num_inputs = module["get_num_inputs"]
         self._load_params = module["load_params"]
+        self._load_params_from_file = module["load_params_from_file"]
         self._share_params = module["share_params"]
 
     def set_input(self, key=None, value=None, **params):
@@ -177,7 +181,7 @@ class GraphModule(object):
            Additional arguments
         """
         if key is not None:
-            v = self._get_input(key)
+            v = self._get_input(key, True)
             if v is None:
                 raise RuntimeError("Could not find '%s' in graph's inputs" % key)
             v.copyfrom(value)
@@ -190,9 +194,9 @@ class GraphModule(object):
                 # TODO(zhiics) Skip the weights for submodule in a better way.
                 # We should use MetadataModule for initialization and remove
                 # params from set_input
-                val = self._get_input(k)
+                val = self._get_input(k, True)
                 if val:
-                    self._get_input(k).copyfrom(params[k])
+                    val.copyfrom(params[k])
 
     def run(self, **input_dict):
         """Run forward execution of the graph
@@ -206,6 +210,272 @@ class GraphModule(object):
             self.set_input(**input_dict)
         self._run()
 
+    def run_async(self, callback, **input_dict):
+        """Enqueue the forward execution of the graph and return immediately.
+
+        The operators are launched on the stream set by :py:meth:`set_stream`
+        and ``callback`` is invoked once they have completed. On a CPU-only
+        graph the execution is synchronous and the callback runs before this
+        function returns.
+
+        Parameters
+        ----------
+        callback : Callable[[], None]
+            The function called on completion. It may run on a driver thread
+            and must not issue device API calls.
+
+        input_dict: dict of str to NDArray
+            List of input values to be feed to
+        """
+        if input_dict:
+            self.set_input(**input_dict)
+        self.module["run_async"](callback)
+
+    def run_in_context(self, device=None, **input_dict):
+        """Run the graph on inputs, safe to call from several threads at once.
+
+        Each call checks out an execution context from a pool of the module, and
+        creates one when all are in use. The contexts share the compiled module and
+        the parameters, and only own their activations, so the concurrent calls do
+        not duplicate the weights. The inputs not given keep the value they have in
+        the context, the parameters must not be loaded again while calls run.
+
+        Parameters
+        ----------
+        device : Device, optional
+            The device the outputs are copied to, the CPU by default.
+
+        input_dict: dict of str to NDArray
+            The inputs of the call.
+
+        Returns
+        -------
+        outputs : list of NDArray
+            The outputs, owned by the caller.
+        """
+        device = device or tvm.cpu(0)
+        args = []
+        for key, value in input_dict.items():
+            if not isinstance(value, tvm.nd.NDArray):
+                value = tvm.nd.array(value)
+            args += [key, value]
+        return list(self.module["run_in_context"](device.device_type, device.device_id, *args))
+
+    def bind_state(self, key, index):
+        """Feed an output back as an input of the next run, without copy.
+
+        The input and the output swap their tensors after each run, which suits the
+        hidden state of recurrent models and the rolling buffers of streaming
+        convolutions. The input keeps its current value as the initial state, and
+        :py:meth:`get_input` gives the state the next run reads, which is also the
+        output of the last run.
+
+        Parameters
+        ----------
+        key : int or str
+            The input index or name reading the state.
+
+        index : int
+            The output index writing the next state.
+        """
+        self.module["bind_state"](key, index)
+
+    def start_streaming(self, num_buffers, inputs):
+        """Start running the model on a stream of frames, such as camera images.
+
+        A worker thread runs the frames in their order while the next ones are
+        copied in by :py:meth:`push_frame`, each frame taking one of
+        ``num_buffers`` sets of tensors. The other functions of the module must
+        not be called until :py:meth:`stop_streaming`.
+
+        Parameters
+        ----------
+        num_buffers : int
+            The number of frames in flight, at least 2.
+
+        inputs : list of int or str
+            The inputs given by each frame, the others keep their value.
+        """
+        self.module["start_streaming"](num_buffers, *inputs)
+
+    def push_frame(self, *inputs):
+        """Copy the inputs of the next frame, waiting while all the buffers are in use.
+
+        Only :py:meth:`pop_frame` gives a buffer back, so a caller pushing and
+        popping from one thread keeps at most ``num_buffers - 1`` frames pushed
+        and not popped.
+
+        Parameters
+        ----------
+        inputs : list of NDArray or numpy.ndarray
+            One array per input given to :py:meth:`start_streaming`.
+        """
+        self.module["push_frame"](
+            *[x if isinstance(x, tvm.nd.NDArray) else tvm.nd.array(x) for x in inputs]
+        )
+
+    def pop_frame(self):
+        """Wait for the outputs of the oldest frame not popped yet.
+
+        Returns
+        -------
+        outputs : list of NDArray
+            The outputs, valid until the next call to pop_frame.
+        """
+        return list(self.module["pop_frame"]())
+
+    def stop_streaming(self):
+        """Wait for the frames pushed and go back to the inputs and outputs of the module."""
+        self.module["stop_streaming"]()
+
+    def set_stream(self, stream):
+        """Set the stream the inputs, operators and outputs are enqueued on.
+
+        Use one executor per in-flight request, each with its own stream, to
+        overlap the copies of a request with the compute of another one.
+
+        Parameters
+        ----------
+        stream : int, ctypes.c_void_p or None
+            The stream handle of the first non-CPU device, None for the default stream.
+        """
+        if not isinstance(stream, ctypes.c_void_p):
+            stream = ctypes.c_void_p(stream)
+        self.module["set_stream"](stream)
+
+    def get_stream(self):
+        """Get the stream set by :py:meth:`set_stream`.
+
+        Returns
+        -------
+        stream : ctypes.c_void_p or None
+            The stream handle, None for the default stream.
+        """
+        return self.module["get_stream"]()
+
+    def set_pinned_staging(self, enable=True):
+        """Stage the host side of the input and output copies in pinned memory.
+
+        A page-locked buffer is allocated per input or output on an accelerator
+        the first time it is copied and reused by the following runs, so the
+        copies run at full bus bandwidth and asynchronously on the stream set
+        by :py:meth:`set_stream`. It applies to the ``set_input`` function of
+        the module and to :py:meth:`get_output` with an ``out`` array.
+
+        Parameters
+        ----------
+        enable : bool
+            Whether to stage the copies, False releases the buffers.
+        """
+        self.module["set_pinned_staging"](enable)
+
+    def get_input_staging(self, key):
+        """Get the pinned staging buffer of an input.
+
+        Filling it in place and passing it to the ``set_input`` function of the
+        module saves the host copy into it.
+
+        Parameters
+        ----------
+        key : int or str
+            The input index or name.
+
+        Returns
+        -------
+        stage : NDArray or None
+            The buffer, None when the input is not staged.
+        """
+        return self.module["get_input_staging"](key)
+
+    def get_output_staging(self, index):
+        """Get the pinned staging buffer of an output.
+
+        :py:meth:`get_output` into this buffer only enqueues the copy on the
+        executor stream, the stream must be synchronized before reading it.
+
+        Parameters
+        ----------
+        index : int
+            The output index.
+
+        Returns
+        -------
+        stage : NDArray or None
+            The buffer, None when the output is not staged.
+        """
+        return self.module["get_output_staging"](index)
+
+    def set_max_concurrent_ops(self, max_concurrent_ops):
+        """Set the maximum number of operators that run concurrently.
+
+        When larger than 1, independent operators of the graph are dispatched
+        onto the thread pool at the same time and each of them gets a share of
+        the workers, which helps graphs with parallel branches. In a heterogeneous
+        graph this also overlaps the operators of the devices with those of the
+        CPU fallbacks, the ready device operators being dispatched first.
+
+        Parameters
+        ----------
+        max_concurrent_ops : int
+            The maximum number of concurrent operators, 1 runs them one by one.
+            It is clamped to the number of threads of the thread pool.
+        """
+        self.module["set_max_concurrent_ops"](max_concurrent_ops)
+
+    def set_persistent_parallel_region(self, enable):
+        """Run the operators in one parallel region of the thread pool.
+
+        The workers stay awake for the whole run and go from the parallel loops
+        of one operator to the next with a barrier, which saves the wake up of
+        the workers on each operator of models made of many short operators.
+
+        Parameters
+        ----------
+        enable : bool
+            Whether to run the operators in a parallel region.
+        """
+        self.module["set_persistent_parallel_region"](enable)
+
+    def set_num_streams(self, num_streams):
+        """Set the number of streams the accelerator operators are spread over.
+
+        Independent branches of the graph are launched on different streams of
+        the first non-CPU device, with events ordering the cross-stream edges.
+
+        Parameters
+        ----------
+        num_streams : int
+            The number of streams, 1 launches every operator on the default stream.
+        """
+        self.module["set_num_streams"](num_streams)
+
+    def set_sampling_profiler(self, sample_period):
+        """Time the operators of one in every sample_period runs.
+
+        Unlike the debug executor, the sampled runs are not synchronized between
+        the operators, so it can stay enabled on deployed models to watch the
+        latency of each operator. The previous samples are dropped.
+
+        Parameters
+        ----------
+        sample_period : int
+            The sampling period, 0 stops sampling.
+        """
+        self.module["set_sampling_profiler"](sample_period)
+
+    def get_sampling_profile(self):
+        """Get the latency histograms gathered by the sampling profiler.
+
+        Returns
+        -------
+        profile : dict
+            The number of sampled runs and, for each operator, the number of
+            samples, the mean, min, max, median and 99th percentile latencies in
+            microseconds, and ``histogram``, whose bucket i counts the samples
+            between 2^i and 2^(i+1) nanoseconds.
+        """
+        return json.loads(self.module["get_sampling_profile"]())
+
     def get_num_outputs(self):
         """Get the number of outputs from the graph
 
@@ -298,6 +568,19 @@ class GraphModule(object):
         """
         self._load_params(bytearray(params_bytes))
 
+    def load_params_from_file(self, path):
+        """Load parameters from a file written from :py:func:`tvm.runtime.save_param_dict`.
+
+        Host parameters saved with ``aligned=True`` are used directly from the
+        memory mapped file rather than copied into the executor.
+
+        Parameters
+        ----------
+        path : str
+            The path to the serialized parameter dict.
+        """
+        self._load_params_from_file(path)
+
     def share_params(self, other, params_bytes):
         """Share parameters from pre-existing GraphExecutor instance.
 
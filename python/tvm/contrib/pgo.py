@@ -0,0 +1,135 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Profile guided optimization of the modules built for the LLVM CPU targets.
+
+The loop has three steps:
+
+1. Build the module with the "tir.llvm.instrument_branches" option, which counts the targets
+   taken by each conditional branch of the generated code.
+2. Run the instrumented module on representative inputs, then read the counts with
+   :py:func:`collect_branch_profile`.
+3. Build the module again with the counts in the "tir.llvm.branch_profile" option, which
+   gives them to LLVM as the weights of the branches, for the block placement, the
+   unrolling and the if conversion to follow the paths actually taken.
+
+The branches are named after their function and their order in it, so the profile only
+applies to a module lowered the same way, i.e. built with the same schedule and options.
+
+.. code-block:: python
+
+    module = pgo.profile_guided_build(mod, "llvm", lambda m: m["main"](*args))
+"""
+from typing import Callable, Dict, Tuple
+
+import tvm
+
+
+def _parse(profile: str) -> Dict[str, Tuple[int, int]]:
+    counts = {}
+    for line in profile.splitlines():
+        fields = line.split()
+        if fields:
+            name, taken, not_taken = fields
+            counts[name] = (int(taken), int(not_taken))
+    return counts
+
+
+def merge_branch_profiles(*profiles: str) -> str:
+    """Add up the counts of several branch profiles, e.g. of several runs.
+
+    Parameters
+    ----------
+    profiles : str
+        The profiles, in the format of the "tir.llvm.branch_profile" option.
+
+    Returns
+    -------
+    profile : str
+        The merged profile.
+    """
+    merged = {}
+    for profile in profiles:
+        for name, (taken, not_taken) in _parse(profile).items():
+            old_taken, old_not_taken = merged.get(name, (0, 0))
+            merged[name] = (old_taken + taken, old_not_taken + not_taken)
+    return "".join("%s %d %d\n" % (name, *merged[name]) for name in sorted(merged))
+
+
+def collect_branch_profile(mod: tvm.runtime.Module) -> str:
+    """Read the counts of the branches of an instrumented module and of its imported modules.
+
+    Parameters
+    ----------
+    mod : tvm.runtime.Module
+        The module built with the "tir.llvm.instrument_branches" option.
+
+    Returns
+    -------
+    profile : str
+        The counts since the module was loaded, one "name taken not_taken" line per branch.
+    """
+    profiles = []
+    stack = [mod]
+    while stack:
+        module = stack.pop()
+        if module.type_key == "llvm":
+            profiles.append(module.get_function("get_branch_profile")())
+        stack.extend(module.imported_modules)
+    return merge_branch_profiles(*profiles)
+
+
+def profile_guided_build(
+    mod, target, run: Callable[[tvm.runtime.Module], None], build=tvm.build, **kwargs
+):
+    """Build a module, profiling its branches on some inputs first.
+
+    Parameters
+    ----------
+    mod : Union[tvm.IRModule, tvm.te.Schedule]
+        The module to build.
+
+    target : Union[str, tvm.target.Target]
+        The LLVM CPU target.
+
+    run : Callable[[tvm.runtime.Module], None]
+        The function running the instrumented module on representative inputs.
+
+    build : Callable
+        The build function, tvm.build by default, called with mod, target and the other
+        keyword arguments.
+
+    Returns
+    -------
+    module : tvm.runtime.Module
+        The module built with the profile.
+    """
+    current = tvm.transform.PassContext.current()
+
+    def _context(option, value):
+        return tvm.transform.PassContext(
+            opt_level=current.opt_level,
+            required_pass=current.required_pass,
+            disabled_pass=current.disabled_pass,
+            config={**dict(current.config), option: value},
+        )
+
+    with _context("tir.llvm.instrument_branches", True):
+        instrumented = build(mod, target=target, **kwargs)
+    run(instrumented)
+    profile = collect_branch_profile(instrumented)
+    with _context("tir.llvm.branch_profile", profile):
+        return build(mod, target=target, **kwargs)
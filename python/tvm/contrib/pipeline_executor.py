@@ -51,7 +51,7 @@ def build(pipe_configs):
     libs = {}
     mod_n_configs = pipe_configs.get_config()
     config_len = len(mod_n_configs)
-    string_config = [{} for _ in range(config_len)]
+    module_connection = [{} for _ in range(config_len)]
     for ir_mod, mod_config in mod_n_configs.items():
         mconf = mod_config["pipeline"].copy()
         mod_idx = mconf["mod_idx"]
@@ -72,9 +72,13 @@ def build(pipe_configs):
 
         mconf["dev"] = "{},{}".format(dev.device_type, dev.device_id)
         # Create a pipeline configuration.
-        string_config[mod_idx] = mconf
+        module_connection[mod_idx] = mconf
         libs[mod_idx] = {"lib": lib, "dev": dev}
 
+    string_config = {
+        "module_connection": module_connection,
+        "input_connection": pipe_configs.get_input_connection_config(),
+    }
     return PipelineExecutorFactoryModule(libs, string_config)
 
 
@@ -94,6 +98,67 @@ class PipelineModule(object):
             self.module = module
         # Get the packed functions from the pipeline executor.
         self._get_num_outputs = self.module["get_num_outputs"]
+        self._set_input = self.module["set_input"]
+        self._run = self.module["run"]
+        self._get_output = self.module["get_output"]
+
+    def set_input(self, key, value):
+        """Set a global input of the next request, the data is copied.
+
+        Parameters
+        ----------
+        key : str
+            The global input name.
+
+        value : numpy.ndarray or NDArray
+            The input data.
+        """
+        if not isinstance(value, tvm.nd.NDArray):
+            value = tvm.nd.array(value)
+        self._set_input(key, value)
+
+    def run(self):
+        """Submit the inputs set so far as one request.
+
+        Each module runs on its own thread and consecutive requests go through the modules
+        concurrently. The queues between the modules are bounded: this call blocks while
+        the pipeline is full, so the outputs must be fetched with :py:meth:`get_output` to
+        make room for new requests.
+        """
+        self._run()
+
+    def get_output(self):
+        """Wait for the outputs of the oldest request whose outputs were not fetched.
+
+        Returns
+        -------
+        outputs : List[NDArray]
+            The global outputs, ordered by their index.
+        """
+        return list(self._get_output())
+
+    def set_queue_capacity(self, capacity):
+        """Set how many requests may wait in front of each module, before the first run.
+
+        Parameters
+        ----------
+        capacity : int
+            The capacity of the queues between the modules.
+        """
+        self.module["set_queue_capacity"](capacity)
+
+    def get_statistics(self):
+        """Get the occupancy and latency counters of the modules.
+
+        Returns
+        -------
+        statistics : Dict[str, Any]
+            The time run blocked on a full pipeline under "run_wait_us", and a list under
+            "stages" with the runs, the mean and maximum run latency, the time spent waiting
+            for inputs and on full output queues, the mean number of queued requests and the
+            number of inputs bound without a copy of each module.
+        """
+        return json.loads(self.module["get_statistics"]())
 
     @property
     def num_outputs(self):
@@ -507,6 +572,23 @@ class PipelineConfig(object):
 
         return mconfig
 
+    def get_input_connection_config(self):
+        """Get the module inputs each global input is bound to, this configuration is used
+        with the one of :py:meth:`get_config`, which assigns the module indices, to create
+        the pipeline executor.
+        """
+        input_conf = []
+        for input_name, binding in self.input_bindings.bindings.items():
+            for dep in binding.bindings:
+                input_conf.append(
+                    {
+                        "global_interface_name": input_name,
+                        "mod_idx": dep.get_owner_idx(),
+                        "module_interface_name": dep.name,
+                    }
+                )
+        return input_conf
+
     def dag_topology_sort(self):
         """Use topological sort to get order of pipeline modules."""
         mlist = []
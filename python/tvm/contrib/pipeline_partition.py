@@ -0,0 +1,425 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Split a Relay module into cost balanced stages of the pipeline executor."""
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+from tvm.contrib.pipeline_executor import PipelineConfig
+
+# The throughput assumed by estimate_op_cost, in multiply-accumulates per second.
+DEFAULT_THROUGHPUT = 1e11
+# The bandwidth assumed between two stages, in bytes per second.
+DEFAULT_BANDWIDTH = 1e10
+
+
+def _tensor_bytes(checked_type):
+    """The size in bytes of a tensor type, None for other types."""
+    if not isinstance(checked_type, relay.TensorType):
+        return None
+    shape = [int(dim) if isinstance(dim, tvm.tir.IntImm) else None for dim in checked_type.shape]
+    if None in shape:
+        raise ValueError("Dynamic shapes are not supported by the pipeline partitioner")
+    return int(np.prod(shape)) * tvm.DataType(checked_type.dtype).bits // 8
+
+
+def _num_elements(checked_type):
+    if isinstance(checked_type, relay.TupleType):
+        return sum(_num_elements(field) for field in checked_type.fields)
+    return int(np.prod([int(dim) for dim in checked_type.shape]))
+
+
+def estimate_op_cost(call, throughput=DEFAULT_THROUGHPUT):
+    """Estimate the latency of an operator from the work it does.
+
+    Convolutions and matrix products are counted in multiply-accumulates, the other
+    operators in output elements.
+
+    Parameters
+    ----------
+    call : relay.Call
+        The type checked operator call.
+
+    throughput : float
+        The multiply-accumulates, or elements, processed per second.
+
+    Returns
+    -------
+    cost : float
+        The estimated latency in seconds.
+    """
+    work = _num_elements(call.checked_type)
+    name = call.op.name if isinstance(call.op, tvm.ir.Op) else ""
+    try:
+        if name in ["nn.conv1d", "nn.conv2d", "nn.conv3d", "nn.conv2d_transpose"]:
+            weight = [int(dim) for dim in call.args[1].checked_type.shape]
+            out_channels = weight[call.attrs.kernel_layout.index("O")]
+            work *= int(np.prod(weight)) // out_channels
+        elif name in ["nn.dense", "nn.matmul", "nn.batch_matmul"]:
+            work *= int(call.args[0].checked_type.shape[-1])
+    except (AttributeError, ValueError, TypeError):
+        pass
+    return work / throughput
+
+
+class ProfiledOpCost(object):
+    """Operator latency measured on the target of each stage.
+
+    Each distinct operator call is compiled on its own and timed with the graph executor,
+    the measurements are cached so that repeated layers are only timed once.
+
+    Parameters
+    ----------
+    stages : List[Tuple[Target, Device]]
+        The target and the device of each stage.
+
+    number : int
+        The number of runs averaged in one measurement.
+
+    repeat : int
+        The number of measurements.
+    """
+
+    def __init__(self, stages, number=10, repeat=3):
+        self.stages = stages
+        self.number = number
+        self.repeat = repeat
+        self.cache = {}
+
+    def _single_op_mod(self, call):
+        params = []
+        args = []
+        # Constants become inputs too, so that layers differing by their weights share a key.
+        for arg in call.args:
+            if isinstance(arg.checked_type, relay.TupleType):
+                fields = []
+                for field_type in arg.checked_type.fields:
+                    params.append(relay.var("p%d" % len(params), field_type))
+                    fields.append(params[-1])
+                args.append(relay.Tuple(fields))
+            else:
+                params.append(relay.var("p%d" % len(params), arg.checked_type))
+                args.append(params[-1])
+        body = relay.Call(call.op, args, call.attrs, call.type_args)
+        return tvm.IRModule.from_expr(relay.Function(params, body))
+
+    def __call__(self, call, stage_index):
+        if not isinstance(call.op, tvm.ir.Op):
+            return estimate_op_cost(call)
+        mod = self._single_op_mod(call)
+        key = (stage_index, tvm.ir.structural_hash(mod))
+        if key not in self.cache:
+            target, dev = self.stages[stage_index]
+            with tvm.transform.PassContext(opt_level=3):
+                lib = relay.build(mod, target=target)
+            module = graph_executor.GraphModule(lib["default"](dev))
+            result = module.benchmark(dev, number=self.number, repeat=self.repeat)
+            self.cache[key] = result.mean
+        return self.cache[key]
+
+
+class _Graph(object):
+    """The dataflow nodes of a function in topological order."""
+
+    def __init__(self, func):
+        self.func = func
+        outputs = func.body.fields if isinstance(func.body, relay.Tuple) else [func.body]
+        self.nodes = []
+        self.index = {}
+        skip = func.body if isinstance(func.body, relay.Tuple) else None
+
+        def visit(expr):
+            if isinstance(expr, (relay.Let, relay.If, relay.Function)):
+                raise ValueError("The pipeline partitioner only supports dataflow graphs")
+            if isinstance(expr, (relay.Call, relay.Tuple, relay.TupleGetItem)) and not (
+                skip is not None and expr.same_as(skip)
+            ):
+                self.index[expr] = len(self.nodes)
+                self.nodes.append(expr)
+
+        relay.analysis.post_order_visit(func.body, visit)
+        self.outputs = []
+        for output in outputs:
+            if output not in self.index:
+                raise ValueError("The outputs of the function must be computed by operators")
+            if _tensor_bytes(output.checked_type) is None:
+                raise ValueError("The outputs of the function must be tensors")
+            self.outputs.append(output)
+        # The last node consuming each node, -1 for the nodes only used as outputs.
+        self.last_use = [-1] * len(self.nodes)
+        for i, node in enumerate(self.nodes):
+            for arg in self.args(node):
+                if arg in self.index:
+                    self.last_use[self.index[arg]] = i
+
+    @staticmethod
+    def args(node):
+        if isinstance(node, relay.Call):
+            return list(node.args)
+        if isinstance(node, relay.Tuple):
+            return list(node.fields)
+        return [node.tuple_value]
+
+
+def _boundary_bytes(graph):
+    """The bytes crossing the cut after each node, inf where a tuple would cross it."""
+    num_nodes = len(graph.nodes)
+    crossing = np.zeros(num_nodes + 1)
+    invalid = np.zeros(num_nodes + 1)
+    for i, node in enumerate(graph.nodes):
+        last_use = graph.last_use[i]
+        if last_use <= i:
+            continue
+        nbytes = _tensor_bytes(node.checked_type)
+        if nbytes is None:
+            invalid[i] += 1
+            invalid[last_use] -= 1
+        else:
+            crossing[i] += nbytes
+            crossing[last_use] -= nbytes
+    crossing = np.cumsum(crossing)[:num_nodes]
+    crossing[np.cumsum(invalid)[:num_nodes] > 0] = np.inf
+    return crossing
+
+
+def _balance(costs, transfer, max_stage_time=None):
+    """Split the nodes into len(costs) contiguous stages.
+
+    Without max_stage_time, minimize the time of the slowest stage, which includes the
+    transfer of the tensors live across the cut in front of it. Otherwise, minimize the
+    total transfer time among the splits whose stages all take at most max_stage_time.
+
+    Returns the objective and the index of the first node of each stage.
+    """
+    num_stages, num_nodes = costs.shape
+    prefix = np.concatenate([np.zeros((num_stages, 1)), np.cumsum(costs, axis=1)], axis=1)
+    # The inbound transfer of a stage starting at node s.
+    inbound = np.concatenate([[0.0], transfer])
+    best = np.full((num_stages, num_nodes + 1), np.inf)
+    choice = np.zeros((num_stages, num_nodes + 1), dtype="int64")
+    for end in range(1, num_nodes + 1):
+        stage_time = prefix[0, end]
+        if max_stage_time is None:
+            best[0, end] = stage_time
+        elif stage_time <= max_stage_time:
+            best[0, end] = 0.0
+    for k in range(1, num_stages):
+        for end in range(k + 1, num_nodes + 1):
+            starts = np.arange(k, end)
+            stage_time = prefix[k, end] - prefix[k, starts] + inbound[starts]
+            if max_stage_time is None:
+                value = np.maximum(best[k - 1, starts], stage_time)
+            else:
+                value = best[k - 1, starts] + inbound[starts]
+                value[stage_time > max_stage_time] = np.inf
+            pick = int(np.argmin(value))
+            best[k, end] = value[pick]
+            choice[k, end] = starts[pick]
+    if not np.isfinite(best[-1, -1]):
+        raise ValueError("Cannot split the graph into %d stages" % num_stages)
+    starts = [0] * num_stages
+    end = num_nodes
+    for k in range(num_stages - 1, 0, -1):
+        starts[k] = int(choice[k, end])
+        end = starts[k]
+    return best[-1, -1], starts
+
+
+def _stage_stats(costs, transfer, starts):
+    inbound = np.concatenate([[0.0], transfer])
+    ends = starts[1:] + [costs.shape[1]]
+    return [
+        float(np.sum(costs[k, start:end]) + inbound[start])
+        for k, (start, end) in enumerate(zip(starts, ends))
+    ]
+
+
+class PipelinePartition(object):
+    """The result of partition.
+
+    Attributes
+    ----------
+    config : PipelineConfig
+        The pipeline configuration, ready for pipeline_executor.build.
+
+    mods : List[IRModule]
+        The module of each stage.
+
+    stage_times : List[float]
+        The estimated time of each stage, including the transfer of its inputs.
+
+    transfer_bytes : List[int]
+        The bytes received by each stage from the other stages.
+    """
+
+    def __init__(self, config, mods, stage_times, transfer_bytes):
+        self.config = config
+        self.mods = mods
+        self.stage_times = stage_times
+        self.transfer_bytes = transfer_bytes
+
+
+def partition(
+    mod,
+    stages,
+    params=None,
+    op_cost=None,
+    bandwidth=DEFAULT_BANDWIDTH,
+    balance_tolerance=0.05,
+):
+    """Cut the main function of a module into balanced stages for the pipeline executor.
+
+    The operators are placed in topological order and cut into one contiguous range per
+    stage. The split first minimizes the time of the slowest stage, counting the transfer of
+    the tensors live across the cut in front of it. Among the splits whose slowest stage is
+    within balance_tolerance of that optimum, it then picks the one transferring the fewest
+    bytes between the stages.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The module, its main function must be a dataflow graph.
+
+    stages : List[Tuple[Target, Device]]
+        The target and the device of each stage, in pipeline order.
+
+    params : Optional[Dict[str, NDArray]]
+        The parameters bound into the stages as constants.
+
+    op_cost : Optional[Callable[[relay.Call, int], float]]
+        The latency in seconds of an operator call on a stage, such as a ProfiledOpCost.
+        Defaults to estimate_op_cost.
+
+    bandwidth : float
+        The bytes per second transferred between two stages.
+
+    balance_tolerance : float
+        The slowdown of the slowest stage accepted to reduce the transfers.
+
+    Returns
+    -------
+    result : PipelinePartition
+        The pipeline configuration and the stage modules.
+    """
+    if op_cost is None:
+        op_cost = lambda call, stage_index: estimate_op_cost(call)
+    func = mod["main"]
+    if params:
+        func = relay.build_module.bind_params_by_name(func, params)
+    mod = tvm.IRModule.from_expr(
+        func, functions={gv: f for gv, f in mod.functions.items() if gv.name_hint != "main"}
+    )
+    mod = relay.transform.InferType()(mod)
+    graph = _Graph(mod["main"])
+    num_stages = len(stages)
+    if len(graph.nodes) < num_stages:
+        raise ValueError("The graph has fewer operators than stages")
+
+    costs = np.zeros((num_stages, len(graph.nodes)))
+    for i, node in enumerate(graph.nodes):
+        if isinstance(node, relay.Call):
+            costs[:, i] = [op_cost(node, k) for k in range(num_stages)]
+    crossing = _boundary_bytes(graph)
+    # The boundary before the first node of a stage, the last node never starts a cut.
+    transfer = crossing[:-1] / bandwidth
+    bottleneck, _ = _balance(costs, transfer)
+    _, starts = _balance(costs, transfer, bottleneck * (1 + balance_tolerance) + 1e-12)
+
+    stage_of = np.zeros(len(graph.nodes), dtype="int64")
+    for k, start in enumerate(starts):
+        stage_of[start:] = k
+    return _emit(mod, graph, stages, stage_of, _stage_stats(costs, transfer, starts))
+
+
+def _emit(mod, graph, stages, stage_of, stage_times):
+    """Build the stage modules and the pipeline configuration of a split."""
+    num_stages = len(stages)
+    other_functions = {gv: f for gv, f in mod.functions.items() if gv.name_hint != "main"}
+    # The outputs of each stage: the values used by later stages, then the global outputs.
+    stage_outputs = [[] for _ in range(num_stages)]
+    for i, node in enumerate(graph.nodes):
+        if graph.last_use[i] >= 0 and stage_of[graph.last_use[i]] > stage_of[i]:
+            stage_outputs[stage_of[i]].append(node)
+    for output in graph.outputs:
+        if output not in stage_outputs[stage_of[graph.index[output]]]:
+            stage_outputs[stage_of[graph.index[output]]].append(output)
+
+    stage_mods = []
+    # The stage input vars and the values they receive.
+    stage_inputs = []
+    for k in range(num_stages):
+        memo = {}
+        inputs = []
+
+        def lookup(expr, k=k, memo=memo, inputs=inputs):
+            if expr in memo:
+                return memo[expr]
+            if isinstance(expr, relay.Var) or (
+                expr in graph.index and stage_of[graph.index[expr]] != k
+            ):
+                if isinstance(expr, relay.Var):
+                    name = expr.name_hint
+                else:
+                    name = "stage%d_output%d" % (
+                        stage_of[graph.index[expr]],
+                        stage_outputs[stage_of[graph.index[expr]]].index(expr),
+                    )
+                memo[expr] = relay.var(name, expr.checked_type)
+                inputs.append((memo[expr], expr))
+                return memo[expr]
+            return expr
+
+        for i in np.nonzero(stage_of == k)[0]:
+            node = graph.nodes[i]
+            if isinstance(node, relay.Call):
+                new_node = relay.Call(
+                    node.op, [lookup(arg) for arg in node.args], node.attrs, node.type_args
+                )
+            elif isinstance(node, relay.Tuple):
+                new_node = relay.Tuple([lookup(field) for field in node.fields])
+            else:
+                new_node = relay.TupleGetItem(lookup(node.tuple_value), node.index)
+            memo[node] = new_node
+        outputs = [memo[node] for node in stage_outputs[k]]
+        body = outputs[0] if len(outputs) == 1 else relay.Tuple(outputs)
+        func = relay.Function([var for var, _ in inputs], body)
+        stage_mods.append(tvm.IRModule.from_expr(func, functions=other_functions))
+        stage_inputs.append(inputs)
+
+    config = PipelineConfig()
+    transfer_bytes = []
+    for k, (target, dev) in enumerate(stages):
+        config[stage_mods[k]].target = target
+        config[stage_mods[k]].dev = dev
+        nbytes = 0
+        for var, value in stage_inputs[k]:
+            dst = config[stage_mods[k]]["input"][var.name_hint]
+            if isinstance(value, relay.Var):
+                config["input"][value.name_hint].connect(dst)
+                continue
+            src = stage_of[graph.index[value]]
+            src_output = stage_outputs[src].index(value)
+            config[stage_mods[src]]["output"][src_output].connect(dst)
+            nbytes += _tensor_bytes(value.checked_type)
+        transfer_bytes.append(nbytes)
+    for global_index, output in enumerate(graph.outputs):
+        src = stage_of[graph.index[output]]
+        config[stage_mods[src]]["output"][stage_outputs[src].index(output)].connect(
+            config["output"][str(global_index)]
+        )
+    return PipelinePartition(config, stage_mods, stage_times, transfer_bytes)
@@ -0,0 +1,342 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Roofline analysis of the operators of a Relay model.
+
+The profiled calls of each operator are annotated with the floating point operations and the
+bytes estimated from its lowered PrimFunc, the throughputs they achieved, and how far they are
+from the roofline of the device, so that the operators worth tuning stand out.
+"""
+import json
+import os
+from typing import Dict, List, Optional
+
+import numpy as np
+
+import tvm
+from tvm import te, tir
+from tvm.runtime import profiling
+from tvm.target import Target
+from .debugger import debug_executor
+
+# The CPUs of the x86 families with 512 and 256 bit vector units.
+_AVX512_CPUS = (
+    "skylake-avx512",
+    "cascadelake",
+    "cooperlake",
+    "icelake-client",
+    "icelake-server",
+    "tigerlake",
+    "sapphirerapids",
+    "knl",
+    "knm",
+)
+_AVX2_CPUS = ("haswell", "broadwell", "skylake", "core-avx2", "znver1", "znver2", "znver3")
+
+# The FP32 lanes of a CUDA streaming multiprocessor, by compute version.
+_CUDA_LANES_PER_SM = {"6.1": 128, "6.2": 128, "8.6": 128, "8.7": 128, "8.9": 128, "9.0": 128}
+
+
+def _cpu_vector_lanes(target: Target) -> int:
+    mcpu = str(target.attrs.get("mcpu", ""))
+    mattr = [str(attr) for attr in target.attrs.get("mattr", [])]
+    if mcpu in _AVX512_CPUS or any("avx512" in attr for attr in mattr):
+        return 16
+    if mcpu in _AVX2_CPUS or any("avx" in attr for attr in mattr):
+        return 8
+    return 4
+
+
+def _cpu_clock_hz() -> Optional[float]:
+    try:
+        with open("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq") as f:
+            return float(f.read()) * 1e3
+    except (OSError, ValueError):
+        pass
+    try:
+        with open("/proc/cpuinfo") as f:
+            mhz = [float(line.split(":")[1]) for line in f if line.startswith("cpu MHz")]
+        return max(mhz) * 1e6 if mhz else None
+    except (OSError, ValueError):
+        return None
+
+
+def estimate_peak_flops(target, dev: tvm.runtime.Device) -> float:
+    """Estimate the peak FP32 throughput of a device from its target and its attributes.
+
+    GPUs count a fused multiply add per lane and cycle. CPUs count two of them per vector lane
+    and cycle with AVX, one otherwise, on every core of the local host at its maximum clock.
+
+    Parameters
+    ----------
+    target : str or Target
+        The target of the device.
+
+    dev : Device
+        The device.
+
+    Returns
+    -------
+    peak_flops : float
+        The floating point operations per second.
+    """
+    target = Target(target)
+    kind = target.kind.name
+    if kind in ("cuda", "rocm") and dev.exist:
+        if kind == "cuda":
+            lanes = _CUDA_LANES_PER_SM.get(dev.compute_version, 64)
+        else:
+            lanes = 64
+        return 2.0 * lanes * dev.multi_processor_count * dev.max_clock_rate * 1e3
+    if kind == "llvm":
+        clock = _cpu_clock_hz()
+        if clock is not None:
+            lanes = _cpu_vector_lanes(target)
+            fma_units = 2 if lanes >= 8 else 1
+            cores = int(os.environ.get("TVM_NUM_THREADS", os.cpu_count() or 1))
+            return 2.0 * fma_units * lanes * cores * clock
+    raise ValueError(
+        "Cannot estimate the peak flops of target %s, pass peak_flops explicitly" % target
+    )
+
+
+def estimate_peak_bandwidth(target, dev: tvm.runtime.Device, nbytes: int = 1 << 27) -> float:
+    """Measure the memory bandwidth of a device with a copy of a buffer larger than its caches.
+
+    Parameters
+    ----------
+    target : str or Target
+        The target of the device.
+
+    dev : Device
+        The device.
+
+    nbytes : int
+        The size of the copied buffer.
+
+    Returns
+    -------
+    peak_bandwidth : float
+        The bytes read and written per second.
+    """
+    target = Target(target)
+    n = nbytes // 4
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i], name="B")
+    s = te.create_schedule(B.op)
+    outer, inner = s[B].split(B.op.axis[0], factor=256)
+    if "gpu" in target.keys:
+        s[B].bind(outer, te.thread_axis("blockIdx.x"))
+        s[B].bind(inner, te.thread_axis("threadIdx.x"))
+    else:
+        s[B].parallel(outer)
+        s[B].vectorize(inner)
+    func = tvm.build(s, [A, B], target)
+    a = tvm.nd.empty((n,), "float32", dev)
+    b = tvm.nd.empty((n,), "float32", dev)
+    cost = func.time_evaluator(func.entry_name, dev, number=10, repeat=3)(a, b).min
+    return 2.0 * n * 4 / cost
+
+
+def _estimate_primfuncs(lowered_mods) -> Dict[str, tuple]:
+    estimates = {}
+    for ir_mod in lowered_mods.values():
+        for gv, func in ir_mod.functions.items():
+            if isinstance(func, tir.PrimFunc):
+                estimates[gv.name_hint] = (
+                    tir.analysis.estimate_tir_flops(func),
+                    tir.analysis.estimate_tir_bytes(func),
+                )
+    return estimates
+
+
+def _from_json_metric(value):
+    kind, val = next(iter(value.items()))
+    if kind == "string":
+        return val
+    if kind == "count":
+        return profiling.Count(val)
+    if kind == "microseconds":
+        return profiling.Duration(val)
+    if kind == "percent":
+        return profiling.Percent(val)
+    return profiling.Ratio(val)
+
+
+def roofline_metrics(
+    flops: float, nbytes: float, duration_us: float, peak_flops: float, peak_bandwidth: float
+) -> Dict[str, object]:
+    """Compute the roofline metrics of a call.
+
+    Parameters
+    ----------
+    flops : float
+        The floating point operations of the call.
+
+    nbytes : float
+        The bytes moved by the call.
+
+    duration_us : float
+        The duration of the call in microseconds.
+
+    peak_flops : float
+        The peak floating point operations per second of the device.
+
+    peak_bandwidth : float
+        The peak bytes per second of the device.
+
+    Returns
+    -------
+    metrics : Dict[str, object]
+        The metrics to add to the profiled call.
+    """
+    seconds = max(duration_us, 1e-3) * 1e-6
+    intensity = flops / nbytes if nbytes > 0 else float("inf")
+    attainable = min(peak_flops, intensity * peak_bandwidth)
+    if flops > 0:
+        efficiency = min(flops / seconds / attainable, 1.0)
+    else:
+        # the operators doing no arithmetic are bounded by their memory traffic only
+        efficiency = min(nbytes / seconds / peak_bandwidth, 1.0)
+    return {
+        "Estimated FLOPs": profiling.Count(int(flops)),
+        "Estimated Bytes": profiling.Count(int(nbytes)),
+        "GFLOP/s": profiling.Ratio(flops / seconds / 1e9),
+        "GB/s": profiling.Ratio(nbytes / seconds / 1e9),
+        "Arithmetic Intensity": profiling.Ratio(min(intensity, 1e9)),
+        "Bound": "compute" if intensity * peak_bandwidth >= peak_flops else "memory",
+        "Roofline Efficiency (%)": profiling.Ratio(efficiency * 100),
+        "Roofline Headroom (us)": profiling.Duration(duration_us * (1 - efficiency)),
+    }
+
+
+def roofline_analysis(
+    mod: tvm.IRModule,
+    params: Dict[str, tvm.nd.NDArray],
+    target,
+    dev: tvm.runtime.Device,
+    inputs: Optional[Dict[str, np.ndarray]] = None,
+    peak_flops: Optional[float] = None,
+    peak_bandwidth: Optional[float] = None,
+) -> profiling.Report:
+    """Profile a Relay model and place each of its operators against the roofline of the
+    device.
+
+    Every call of the report gets the floating point operations and the bytes of its
+    PrimFunc, estimated by :py:func:`tvm.tir.analysis.estimate_tir_flops` and
+    :py:func:`tvm.tir.analysis.estimate_tir_bytes`, the achieved throughputs, whether the
+    roofline bounds it by compute or memory, its efficiency against the roofline, and the time
+    it would save at the roofline as "Roofline Headroom (us)".
+
+    Parameters
+    ----------
+    mod : IRModule
+        The Relay model.
+
+    params : Dict[str, NDArray]
+        The parameters of the model.
+
+    target : str or Target
+        The target of the device.
+
+    dev : Device
+        The device to profile on.
+
+    inputs : Optional[Dict[str, np.ndarray]]
+        The inputs of the model, zeros when not given.
+
+    peak_flops : Optional[float]
+        The peak floating point operations per second, see :py:func:`estimate_peak_flops`.
+
+    peak_bandwidth : Optional[float]
+        The peak bytes per second, see :py:func:`estimate_peak_bandwidth`.
+
+    Returns
+    -------
+    report : Report
+        The profiling report with the roofline metrics.
+    """
+    target = Target(target)
+    if peak_flops is None:
+        peak_flops = estimate_peak_flops(target, dev)
+    if peak_bandwidth is None:
+        peak_bandwidth = estimate_peak_bandwidth(target, dev)
+
+    with tvm.transform.PassContext(opt_level=3):
+        builder = tvm.relay.build_module.BuildModule()
+        graph_json, lib, built_params = builder.build(mod, target=target, params=params)
+        estimates = _estimate_primfuncs(builder.get_irmodule())
+
+    gmod = debug_executor.create(graph_json, lib, dev)
+    gmod.set_input(**built_params)
+    if inputs:
+        gmod.set_input(**inputs)
+    report = json.loads(gmod.profile().json())
+
+    calls = []
+    for call in report["calls"]:
+        metrics = {key: _from_json_metric(value) for key, value in call.items()}
+        estimate = estimates.get(metrics["Name"])
+        if estimate is not None and (estimate[0] > 0 or estimate[1] > 0):
+            duration = call["Duration (us)"]["microseconds"]
+            metrics.update(roofline_metrics(*estimate, duration, peak_flops, peak_bandwidth))
+        calls.append(metrics)
+    device_metrics = {}
+    for device, device_call in report["device_metrics"].items():
+        metrics = {key: _from_json_metric(value) for key, value in device_call.items()}
+        metrics["Peak GFLOP/s"] = profiling.Ratio(peak_flops / 1e9)
+        metrics["Peak GB/s"] = profiling.Ratio(peak_bandwidth / 1e9)
+        device_metrics[device] = metrics
+    return profiling.Report(calls, device_metrics)
+
+
+def roofline_ranking(report: profiling.Report) -> List[Dict[str, object]]:
+    """Rank the operators of a roofline report by the time they would save at the roofline.
+
+    Parameters
+    ----------
+    report : Report
+        The report returned by :py:func:`roofline_analysis`.
+
+    Returns
+    -------
+    ranking : List[Dict[str, object]]
+        For each operator, its "Name", total "Duration (us)", total "Roofline Headroom (us)",
+        mean "Roofline Efficiency (%)" and "Bound", the largest headroom first.
+    """
+    ops = {}
+    for call in json.loads(report.json())["calls"]:
+        if "Roofline Headroom (us)" not in call:
+            continue
+        name = call["Name"]["string"]
+        op = ops.setdefault(
+            name,
+            {
+                "Name": name,
+                "Duration (us)": 0.0,
+                "Roofline Headroom (us)": 0.0,
+                "Roofline Efficiency (%)": 0.0,
+                "Bound": call["Bound"]["string"],
+                "Count": 0,
+            },
+        )
+        op["Duration (us)"] += call["Duration (us)"]["microseconds"]
+        op["Roofline Headroom (us)"] += call["Roofline Headroom (us)"]["microseconds"]
+        op["Roofline Efficiency (%)"] += call["Roofline Efficiency (%)"]["ratio"]
+        op["Count"] += 1
+    for op in ops.values():
+        op["Roofline Efficiency (%)"] /= op.pop("Count")
+    return sorted(ops.values(), key=lambda op: op["Roofline Headroom (us)"], reverse=True)
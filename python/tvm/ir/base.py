@@ -125,15 +125,16 @@ def load_json(json_str):
 
     Parameters
     ----------
-    json_str : str
-        The json string
+    json_str : str or bytes
+        The json string, or the bytes returned by :py:func:`save_binary`.
 
     Returns
     -------
     node : Object
         The loaded tvm node.
     """
-
+    if isinstance(json_str, (bytes, bytearray)):
+        return tvm.runtime._ffi_node_api.LoadJSON(bytearray(json_str))
     try:
         return tvm.runtime._ffi_node_api.LoadJSON(json_str)
     except tvm.error.TVMError:
@@ -157,6 +158,47 @@ def save_json(node):
     return tvm.runtime._ffi_node_api.SaveJSON(node)
 
 
+def save_binary(node):
+    """Save tvm object in a compact binary format.
+
+    The strings are interned and the tensors saved as raw bytes, which makes
+    the result smaller and faster to load than :py:func:`save_json`. It is
+    loaded by :py:func:`load_json`.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    Returns
+    -------
+    data : bytearray
+        Saved bytes.
+    """
+    return tvm.runtime._ffi_node_api.SaveBinary(node)
+
+
+def save_text(node, path, show_meta_data=True):
+    """Write the text format of the node to a file.
+
+    The text is written as it is rendered, without making a string of it, which
+    makes it practical to dump a large module.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    path : str
+        The path of the file.
+
+    show_meta_data : bool
+        Whether to include meta data section in the text
+        if there is meta data.
+    """
+    _ffi_api.SaveText(node, path, show_meta_data)
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
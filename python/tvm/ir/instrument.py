@@ -18,6 +18,7 @@
 """Common pass instrumentation across IR variants."""
 import inspect
 import functools
+import json
 
 import tvm._ffi
 import tvm.runtime
@@ -255,3 +256,48 @@ class PassTimingInstrument(tvm.runtime.Object):
                 profiles = timing_inst.render()
         """
         return _ffi_instrument_api.RenderTimePassProfiles()
+
+
+@tvm._ffi.register_object("instrument.PassInstrument")
+class PassStatsInstrument(tvm.runtime.Object):
+    """A pass instrument implemented in C++, recording the wall time, the growth of the peak
+    resident memory, the object allocations and the IR size of each pass.
+
+    The object allocations are counted when TVM is built with USE_OBJECT_POOL. The stats
+    are reset when entering a PassContext using the instrument, and can be exported after
+    exiting it.
+
+    Parameters
+    ----------
+    count_nodes : bool
+        Whether to count the expression and statement nodes of the module before and
+        after each pass, which takes a traversal of the module each time.
+    """
+
+    def __init__(self, count_nodes=True):
+        self.__init_handle_by_constructor__(
+            _ffi_instrument_api.MakePassStatsInstrument, count_nodes
+        )
+
+    @staticmethod
+    def as_json():
+        """Export the stats of the passes of the current thread.
+
+        Returns
+        -------
+        stats : dict
+            The tree of the measures of the passes under "passes", and under "summary"
+            the measures summed for each pass name, over all the places the pass ran in.
+        """
+        return json.loads(_ffi_instrument_api.PassStatsAsJSON())
+
+    @staticmethod
+    def as_chrome_trace():
+        """Export the stats of the passes of the current thread as a Chrome trace.
+
+        Returns
+        -------
+        trace : str
+            The trace in the Trace Event Format, which chrome://tracing and Perfetto load.
+        """
+        return _ffi_instrument_api.PassStatsAsChromeTrace()
@@ -21,5 +21,7 @@ from . import builder
 from . import runner
 from . import space_generator
 from . import search_strategy
+from . import cost_model
+from . import feature_extractor
 from . import integration
 from .tune_context import TuneContext
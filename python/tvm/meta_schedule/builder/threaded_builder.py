@@ -0,0 +1,73 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Builder compiling on a pool of threads of the current process"""
+from typing import Callable, Optional
+
+from tvm._ffi import register_object
+from tvm.ir import IRModule
+from tvm.runtime import Module
+from tvm.target import Target
+
+from .. import _ffi_api
+from ..utils import cpu_count
+from .builder import Builder
+
+
+@register_object("meta_schedule.ThreadedBuilder")
+class ThreadedBuilder(Builder):
+    """A builder compiling the inputs on a pool of threads of the current process.
+
+    Lowering and code generation run natively in parallel, without the cost of shipping
+    the IRModules to worker processes. Unlike LocalBuilder, a build cannot be killed, so
+    there is no timeout.
+
+    Parameters
+    ----------
+    num_threads : int
+        The number of threads building in parallel.
+    """
+
+    num_threads: int
+
+    def __init__(
+        self,
+        *,
+        num_threads: Optional[int] = None,
+        f_build: Optional[Callable[[IRModule, Target], Module]] = None,
+        f_export: Optional[Callable[[Module], str]] = None,
+    ) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        num_threads : Optional[int]
+            The number of threads building in parallel. Defaults to number of CPUs.
+        f_build : Optional[Callable[[IRModule, Target], Module]]
+            The build function, called from the building threads.
+            Defaults to the native lowering and code generation.
+        f_export : Optional[Callable[[Module], str]]
+            The export function, called from the building threads.
+            Defaults to `meta_schedule.builder.default_export`.
+        """
+        if num_threads is None:
+            num_threads = cpu_count()
+        self.__init_handle_by_constructor__(
+            _ffi_api.BuilderThreaded,  # type: ignore # pylint: disable=no-member
+            num_threads,
+            f_build,
+            f_export,
+        )
@@ -0,0 +1,117 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Meta Schedule CostModel."""
+import ctypes
+from typing import List, TYPE_CHECKING
+
+import numpy as np  # type: ignore
+
+from tvm._ffi import register_object
+from tvm.runtime import Object
+
+from .. import _ffi_api
+from ..runner import RunnerResult
+from ..search_strategy import MeasureCandidate
+from ..utils import check_override
+
+if TYPE_CHECKING:
+    from ..tune_context import TuneContext
+
+
+@register_object("meta_schedule.CostModel")
+class CostModel(Object):
+    """Cost model predicting the performance of measure candidates, the higher the faster."""
+
+    def update(
+        self,
+        tune_context: "TuneContext",
+        candidates: List[MeasureCandidate],
+        results: List[RunnerResult],
+    ) -> None:
+        """Update the cost model given measurement results.
+
+        Parameters
+        ----------
+        tune_context : TuneContext
+            The tuning context.
+        candidates : List[MeasureCandidate]
+            The measure candidates.
+        results : List[RunnerResult]
+            The runner results of the candidates.
+        """
+        _ffi_api.CostModelUpdate(self, tune_context, candidates, results)  # type: ignore # pylint: disable=no-member
+
+    def predict(
+        self,
+        tune_context: "TuneContext",
+        candidates: List[MeasureCandidate],
+    ) -> np.ndarray:
+        """Predict the scores of the measure candidates.
+
+        Parameters
+        ----------
+        tune_context : TuneContext
+            The tuning context.
+        candidates : List[MeasureCandidate]
+            The measure candidates.
+
+        Returns
+        -------
+        scores : np.ndarray
+            The predicted scores, the higher the faster.
+        """
+        scores = np.zeros(len(candidates), dtype="float64")
+        _ffi_api.CostModelPredict(  # type: ignore # pylint: disable=no-member
+            self,
+            tune_context,
+            candidates,
+            scores.ctypes.data_as(ctypes.c_void_p),
+        )
+        return scores
+
+
+@register_object("meta_schedule.PyCostModel")
+class PyCostModel(CostModel):
+    """An abstract cost model with customized methods on the python-side."""
+
+    def __init__(self):
+        """Constructor."""
+
+        @check_override(self.__class__, CostModel)
+        def f_update(
+            tune_context: "TuneContext",
+            candidates: List[MeasureCandidate],
+            results: List[RunnerResult],
+        ) -> None:
+            self.update(tune_context, candidates, results)
+
+        @check_override(self.__class__, CostModel)
+        def f_predict(
+            tune_context: "TuneContext",
+            candidates: List[MeasureCandidate],
+            return_ptr,
+        ) -> None:
+            n = len(candidates)
+            return_ptr = ctypes.cast(return_ptr, ctypes.POINTER(ctypes.c_double))
+            array_wrapper = np.ctypeslib.as_array(return_ptr, shape=(n,))
+            array_wrapper[:] = self.predict(tune_context, candidates)
+
+        self.__init_handle_by_constructor__(
+            _ffi_api.CostModelPyCostModel,  # type: ignore # pylint: disable=no-member
+            f_update,
+            f_predict,
+        )
@@ -0,0 +1,88 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Meta Schedule FeatureExtractor."""
+from typing import List, Tuple, TYPE_CHECKING
+
+import numpy as np  # type: ignore
+
+from tvm import nd
+from tvm._ffi import register_object
+from tvm.runtime import Object
+
+from .. import _ffi_api
+from ..search_strategy import MeasureCandidate
+from ..utils import check_override
+
+if TYPE_CHECKING:
+    from ..tune_context import TuneContext
+
+
+@register_object("meta_schedule.FeatureExtractor")
+class FeatureExtractor(Object):
+    """Extractor of the features of measure candidates."""
+
+    def extract_from(
+        self,
+        tune_context: "TuneContext",
+        candidates: List[MeasureCandidate],
+    ) -> Tuple[np.ndarray, np.ndarray]:
+        """Extract the features of the measure candidates.
+
+        Parameters
+        ----------
+        tune_context : TuneContext
+            The tuning context.
+        candidates : List[MeasureCandidate]
+            The measure candidates.
+
+        Returns
+        -------
+        features : np.ndarray
+            The float32 features of all the candidates, of shape (num_rows, num_features),
+            the rows of each candidate being contiguous.
+        row_offsets : np.ndarray
+            The int64 row offsets, of shape (num_candidates + 1,), the rows of candidate i
+            being features[row_offsets[i]:row_offsets[i + 1]].
+        """
+        features, row_offsets = _ffi_api.FeatureExtractorExtractFrom(  # type: ignore # pylint: disable=no-member
+            self, tune_context, candidates
+        )
+        return features.numpy(), row_offsets.numpy()
+
+
+@register_object("meta_schedule.PyFeatureExtractor")
+class PyFeatureExtractor(FeatureExtractor):
+    """An abstract feature extractor with customized methods on the python-side."""
+
+    def __init__(self):
+        """Constructor."""
+
+        @check_override(self.__class__, FeatureExtractor)
+        def f_extract_from(
+            tune_context: "TuneContext",
+            candidates: List[MeasureCandidate],
+        ) -> List[nd.NDArray]:
+            features, row_offsets = self.extract_from(tune_context, candidates)
+            return [
+                nd.array(np.asarray(features, dtype="float32")),
+                nd.array(np.asarray(row_offsets, dtype="int64")),
+            ]
+
+        self.__init_handle_by_constructor__(
+            _ffi_api.FeatureExtractorPyFeatureExtractor,  # type: ignore # pylint: disable=no-member
+            f_extract_from,
+        )
@@ -0,0 +1,59 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Feature extractor computing one row of features per buffer store"""
+from tvm._ffi import register_object
+
+from .. import _ffi_api
+from .feature_extractor import FeatureExtractor
+
+
+@register_object("meta_schedule.PerStoreFeature")
+class PerStoreFeature(FeatureExtractor):
+    """A feature extractor computing one row of features per buffer store.
+
+    The candidates are lowered natively and described by the auto-scheduler per-store
+    features, in parallel with the threads of the tuning context.
+
+    Parameters
+    ----------
+    buffers_per_store : int
+        The number of buffers described for each store, the most accessed first.
+    cache_line_bytes : int
+        The size of a cache line in bytes.
+    feature_vector_length : int
+        The number of features of a row.
+    """
+
+    buffers_per_store: int
+    cache_line_bytes: int
+    feature_vector_length: int
+
+    def __init__(self, buffers_per_store: int = 5, cache_line_bytes: int = 64) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        buffers_per_store : int
+            The number of buffers described for each store, the most accessed first.
+        cache_line_bytes : int
+            The size of a cache line in bytes.
+        """
+        self.__init_handle_by_constructor__(
+            _ffi_api.FeatureExtractorPerStoreFeature,  # type: ignore # pylint: disable=no-member
+            buffers_per_store,
+            cache_line_bytes,
+        )
@@ -26,6 +26,7 @@ from tvm.target import Target
 from tvm.tir import PrimFunc
 
 from . import _ffi_api
+from .database import Database
 
 
 @register_object("meta_schedule.ExtractedTask")
@@ -40,23 +41,28 @@ class ExtractedTask(Object):
         The high-level IR
     dispatched : List[IRModule]
         A list of low-level IRs that the high-level IR could potentially dispatch to
+    weight : int
+        The number of times the task appears in the high-level IR
     """
 
     task_name: str
     mod: IRModule
     dispatched: List[IRModule]
+    weight: int
 
     def __init__(
         self,
         task_name: str,
         mod: IRModule,
         dispatched: List[IRModule],
+        weight: int = 1,
     ) -> None:
         self.__init_handle_by_constructor__(
             _ffi_api.ExtractedTask,  # type: ignore # pylint: disable=no-member
             task_name,
             mod,
             dispatched,
+            weight,
         )
 
 
@@ -174,7 +180,22 @@ class TaskExtraction(MetaScheduleContext):
 
 @register_object("meta_schedule.ApplyHistoryBest")
 class ApplyHistoryBest(MetaScheduleContext):
-    pass
+    """An integration context that allows application of historically best records from a
+    database.
+
+    The result of each queried workload is kept in an index by structural hash, so the
+    database is queried and the best trace applied once per workload.
+
+    Parameters
+    ----------
+    database : Database
+        The database to be queried from
+    """
+
+    database: Database
+
+    def __init__(self, database: Database) -> None:
+        self.__init_handle_by_constructor__(_ffi_api.ApplyHistoryBest, database)  # type: ignore # pylint: disable=no-member
 
 
 def extract_task(
@@ -22,6 +22,14 @@ from typing import NamedTuple, Optional, Union
 from tvm import rpc
 
 
+# The function preparing the cache before each repeat, for each cpu_cache_mode
+CPU_CACHE_PREPROC = {
+    "non_first_arg": "cache_flush_cpu_non_first_arg",
+    "args": "cache_flush_cpu_args",
+    "graph_context": "cache_warm_cpu_graph_context",
+}
+
+
 class EvaluatorConfig(NamedTuple):
     """Config Details of Evaluator
 
@@ -36,6 +44,15 @@ class EvaluatorConfig(NamedTuple):
         increase the number of runs to the given time (in ms) to reduce the measurement error.
     enable_cpu_cache_flush: bool
         Whether to flush the cache on CPU.
+    cpu_cache_mode: str
+        The cache state prepared before each repeat when flushing the cache on CPU:
+        "non_first_arg" flushes all the arguments but the first one, "args" flushes all the
+        arguments, and "graph_context" also reads the first argument back to the cache, like
+        the activation the previous operator of a model just wrote.
+    target_rel_ci: float
+        When positive, repeat is the maximum number of repeats, and the measurement stops once
+        the half width of the 95% confidence interval of the mean falls below this fraction of
+        the mean.
 
     Note
     ----
@@ -47,6 +64,8 @@ class EvaluatorConfig(NamedTuple):
     repeat: int = 1
     min_repeat_ms: int = 40
     enable_cpu_cache_flush: bool = False
+    target_rel_ci: float = 0.0
+    cpu_cache_mode: str = "non_first_arg"
 
     @staticmethod
     def _normalized(config: Optional["EvaluatorConfig"]) -> "EvaluatorConfig":
@@ -57,7 +76,11 @@ class EvaluatorConfig(NamedTuple):
             repeat=config.repeat,
             min_repeat_ms=config.min_repeat_ms,
             enable_cpu_cache_flush=config.enable_cpu_cache_flush,
+            target_rel_ci=config.target_rel_ci,
+            cpu_cache_mode=config.cpu_cache_mode,
         )
+        if config.cpu_cache_mode not in CPU_CACHE_PREPROC:
+            raise ValueError(f"Unknown cpu_cache_mode: {config.cpu_cache_mode}")
         return config
 
 
@@ -0,0 +1,111 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Runner measuring on a pool of RPC devices"""
+from typing import Callable, Optional
+
+from tvm._ffi import register_object
+from tvm.runtime import Module
+
+from .. import _ffi_api
+from .config import EvaluatorConfig, RPCConfig
+from .runner import Runner
+
+
+@register_object("meta_schedule.RPCPoolRunner")
+class RPCPoolRunner(Runner):
+    """A runner measuring the inputs on a pool of RPC devices.
+
+    Each device is driven by a native worker thread, which keeps its session across the
+    inputs. The inputs are dispatched from a shared queue, their futures are done as soon as
+    they are measured, and a failed attempt is retried on a new session.
+
+    Parameters
+    ----------
+    num_devices : int
+        The number of devices used in parallel.
+    max_retries : int
+        The number of times an input is retried after a failed attempt.
+    timeout_sec : float
+        The time after which a measurement is reported to have timed out.
+    session_lifetime_sec : int
+        The lifetime requested for a session, which is renewed before it expires.
+    """
+
+    num_devices: int
+    max_retries: int
+    timeout_sec: float
+    session_lifetime_sec: int
+
+    def __init__(
+        self,
+        rpc_config: Optional[RPCConfig] = None,
+        evaluator_config: Optional[EvaluatorConfig] = None,
+        alloc_repeat: int = 1,
+        num_devices: Optional[int] = None,
+        max_retries: int = 1,
+        session_lifetime_sec: int = 600,
+        f_create_session: Optional[Callable[[int], Module]] = None,
+    ) -> None:
+        """Constructor
+
+        Parameters
+        ----------
+        rpc_config: Optional[RPCConfig]
+            The rpc configuration, its session timeout bounds each measurement.
+        evaluator_config: Optional[EvaluatorConfig]
+            The evaluator configuration.
+        alloc_repeat: int
+            The number of times to random fill the allocation.
+        num_devices: Optional[int]
+            The number of devices used in parallel.
+            Defaults to the number of servers of the key in the tracker.
+        max_retries: int
+            The number of times an input is retried after a failed attempt.
+        session_lifetime_sec: int
+            The lifetime requested for a session.
+        f_create_session: Optional[Callable[[int], Module]]
+            The function requesting the session module to a device given its lifetime,
+            called from the worker threads. Defaults to a request to the tracker.
+        """
+        rpc_config = RPCConfig._normalized(rpc_config)
+        evaluator_config = EvaluatorConfig._normalized(evaluator_config)
+        if num_devices is None:
+            num_devices = rpc_config.count_num_servers(allow_missing=False)
+        if f_create_session is None:
+
+            def f_create_session(session_timeout_sec: int) -> Module:
+                tracker = rpc_config.connect_tracker()
+                session = tracker.request(
+                    key=rpc_config.tracker_key,
+                    priority=rpc_config.session_priority,
+                    session_timeout=session_timeout_sec,
+                )
+                return session._sess  # pylint: disable=protected-access
+
+        self.__init_handle_by_constructor__(
+            _ffi_api.RunnerRPCPool,  # type: ignore # pylint: disable=no-member
+            f_create_session,
+            num_devices,
+            max_retries,
+            float(rpc_config.session_timeout_sec),
+            session_lifetime_sec,
+            evaluator_config.number,
+            evaluator_config.repeat,
+            evaluator_config.min_repeat_ms,
+            evaluator_config.enable_cpu_cache_flush,
+            alloc_repeat,
+        )
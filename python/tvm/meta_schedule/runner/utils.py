@@ -19,7 +19,7 @@ import itertools
 from typing import Any, Callable, Dict, List
 
 from ...runtime import Device, Module, ndarray
-from .config import EvaluatorConfig
+from .config import CPU_CACHE_PREPROC, EvaluatorConfig
 
 T_ARG_INFO_JSON_OBJ = List[Any]  # pylint: disable=invalid-name
 T_ARG_INFO_JSON_OBJ_LIST = List[T_ARG_INFO_JSON_OBJ]  # pylint: disable=invalid-name
@@ -107,9 +107,10 @@ def run_evaluator_common(
         number=evaluator_config.number,
         repeat=evaluator_config.repeat,
         min_repeat_ms=evaluator_config.min_repeat_ms,
-        f_preproc="cache_flush_cpu_non_first_arg"
+        f_preproc=CPU_CACHE_PREPROC[evaluator_config.cpu_cache_mode]
         if evaluator_config.enable_cpu_cache_flush
         else "",
+        target_rel_ci=evaluator_config.target_rel_ci,
     )
     repeated_costs: List[List[float]] = []
     for args in repeated_args:
@@ -0,0 +1,88 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Evolutionary Search Strategy"""
+from typing import TYPE_CHECKING, Optional
+
+from tvm._ffi import register_object
+
+from .. import _ffi_api
+from .search_strategy import SearchStrategy
+
+if TYPE_CHECKING:
+    from ..cost_model import CostModel
+
+
+@register_object("meta_schedule.EvolutionarySearch")
+class EvolutionarySearch(SearchStrategy):
+    """
+    Evolutionary Search Strategy evolves the sampling decisions of the design spaces, the
+    population being scored by a cost model, and measures the best predicted candidates
+    with an epsilon-greedy share of random ones.
+
+    Parameters
+    ----------
+    num_trials_per_iter : int
+        Number of trials per iteration.
+    num_trials_total : int
+        Total number of trials.
+    population_size : int
+        The number of schedules in the population.
+    init_measured_ratio : float
+        The fraction of the initial population taken from the best measured traces.
+    genetic_num_iters : int
+        The number of generations of the evolution.
+    genetic_mutate_prob : float
+        The probability for a child to be mutated rather than copied.
+    eps_greedy : float
+        The fraction of each batch made of random schedules.
+    cost_model : Optional[CostModel]
+        The cost model scoring the schedules, random scores if it is None.
+    """
+
+    num_trials_per_iter: int
+    num_trials_total: int
+    population_size: int
+    init_measured_ratio: float
+    genetic_num_iters: int
+    genetic_mutate_prob: float
+    eps_greedy: float
+    cost_model: Optional["CostModel"]
+
+    def __init__(
+        self,
+        *,
+        num_trials_per_iter: int,
+        num_trials_total: int,
+        population_size: int = 512,
+        init_measured_ratio: float = 0.2,
+        genetic_num_iters: int = 4,
+        genetic_mutate_prob: float = 0.85,
+        eps_greedy: float = 0.05,
+        cost_model: Optional["CostModel"] = None,
+    ):
+        """Constructor"""
+        self.__init_handle_by_constructor__(
+            _ffi_api.EvolutionarySearch,  # type: ignore # pylint: disable=no-member
+            num_trials_per_iter,
+            num_trials_total,
+            population_size,
+            init_measured_ratio,
+            genetic_num_iters,
+            genetic_mutate_prob,
+            eps_greedy,
+            cost_model,
+        )
@@ -0,0 +1,89 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Gradient Based Task Scheduler"""
+
+from typing import List, Optional, TYPE_CHECKING
+
+from tvm._ffi import register_object
+
+from ..builder import Builder
+from ..runner import Runner
+from ..database import Database
+from .task_scheduler import TaskScheduler
+
+from .. import _ffi_api
+
+if TYPE_CHECKING:
+    from ..tune_context import TuneContext
+
+
+@register_object("meta_schedule.GradientBased")
+class GradientBased(TaskScheduler):
+    """Gradient Based Task Scheduler, allocating the trials to the tasks by the expected
+    reduction of the weighted end-to-end latency"""
+
+    def __init__(
+        self,
+        tasks: List["TuneContext"],
+        builder: Builder,
+        runner: Runner,
+        database: Database,
+        *,
+        task_weights: Optional[List[float]] = None,
+        alpha: float = 0.2,
+        backward_window_size: int = 3,
+        early_stopping_rounds: int = -1,
+        seed: int = -1,
+    ) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        tasks : List[TuneContext]
+            List of tasks to schedule.
+        builder : Builder
+            The builder.
+        runner : Runner
+            The runner.
+        database : Database
+            The database.
+        task_weights : Optional[List[float]]
+            The weight of each task, i.e. the number of times it appears in the model.
+            All the tasks weigh 1 if not given.
+        alpha : float
+            The weight of the backward gradient against the forward one.
+        backward_window_size : int
+            The number of past rounds the backward gradient is computed over.
+        early_stopping_rounds : int
+            Stop a task after so many rounds without improvement, -1 to disable.
+        seed : int
+            The random seed breaking the ties, -1 for a random one.
+        """
+        if task_weights is None:
+            task_weights = [1.0 for _ in tasks]
+        self.__init_handle_by_constructor__(
+            _ffi_api.TaskSchedulerGradientBased,  # type: ignore # pylint: disable=no-member
+            tasks,
+            [float(weight) for weight in task_weights],
+            builder,
+            runner,
+            database,
+            alpha,
+            backward_window_size,
+            early_stopping_rounds,
+            seed,
+        )
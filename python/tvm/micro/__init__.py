@@ -24,6 +24,7 @@ from .model_library_format import (
     export_model_library_format,
     UnsupportedInModelLibraryFormatError,
 )
+from .profiler import profile_graph_executor, profile_report
 from .project import generate_project, GeneratedProject, TemplateProject
 from .session import (
     create_local_graph_executor,
@@ -45,14 +45,21 @@ class UnsupportedInModelLibraryFormatError(Exception):
 
 
 def generate_c_interface_header(
-    module_name, inputs, outputs, devices, workspace_size, include_path
+    module_name, inputs, outputs, devices, workspace_size, include_path, workspace_pool_sizes=None
 ):
-    """Generate C Interface header to be included in MLF"""
+    """Generate C Interface header to be included in MLF
+
+    workspace_pool_sizes optionally maps the name of each workspace pool shared by modules that
+    never run concurrently to the size this module needs, see tvm.tir.usmp.PlanSharedPools. The
+    header then declares the pools, so that all the modules alias the same memory.
+    """
     mangled_name = to_c_variable_style(prefix_generated_name(module_name))
     metadata_header = os.path.join(include_path, f"{mangled_name}.h")
 
     interface_c_create = tvm._ffi.get_global_func("runtime.InterfaceCCreate")
-    interface_c_module = interface_c_create(module_name, inputs, outputs, devices, workspace_size)
+    interface_c_module = interface_c_create(
+        module_name, inputs, outputs, devices, workspace_size, workspace_pool_sizes
+    )
 
     with open(metadata_header, "w") as header_file:
         header_file.write(interface_c_module.get_source())
@@ -328,8 +335,16 @@ def _export_graph_model_library_format(
         inputs, outputs = _get_inputs_and_outputs_from_module(mod)
         devices = mod.get_devices()
         workspace_size = int(metadata["memory"]["functions"]["main"][0]["workspace_size_bytes"])
+        # The pools planned by the USMP with tir.usmp.enable, given by the application
+        workspace_pool_sizes = mod.function_metadata[MAIN_FUNC_NAME_STR].workspace_pool_sizes
         generate_c_interface_header(
-            mod.libmod_name, inputs, outputs, devices, workspace_size, include_path
+            mod.libmod_name,
+            inputs,
+            outputs,
+            devices,
+            workspace_size,
+            include_path,
+            dict(workspace_pool_sizes) if workspace_pool_sizes else None,
         )
 
     parameters_dir = tempdir / "parameters"
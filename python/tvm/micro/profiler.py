@@ -0,0 +1,121 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Per-operator profiling of the graph executor running on a microTVM device."""
+
+import json
+
+import numpy as np
+
+from ..runtime import ndarray
+from ..runtime.profiling import Report
+
+
+def profile_report(records, graph_json_str, cycles_per_second, device_name="cpu0"):
+    """Build a profiling report from the records of the on-device profiler.
+
+    Parameters
+    ----------
+    records : numpy.ndarray
+        The (n, 2) int64 records returned by the graph executor ``get_profile`` function, the
+        node id and the cycles of each operator run.
+
+    graph_json_str : str
+        The graph the records were collected on.
+
+    cycles_per_second : float
+        The frequency of the counter read by ``TVMPlatformProfilerCycles``.
+
+    device_name : str
+        The device name shown in the report.
+
+    Returns
+    -------
+    report : tvm.runtime.profiling.Report
+        One call per operator run, with its duration, cycles and share of the total.
+    """
+    nodes = json.loads(graph_json_str)["nodes"]
+    total_cycles = int(np.sum(records[:, 1])) if len(records) else 0
+    calls = []
+    for node_id, cycles in records:
+        cycles = int(cycles)
+        calls.append(
+            {
+                "Name": {"string": nodes[int(node_id)]["name"]},
+                "Device": {"string": device_name},
+                "Duration (us)": {"microseconds": cycles / cycles_per_second * 1e6},
+                "Cycles": {"count": cycles},
+                "Percent": {"percent": cycles / max(total_cycles, 1) * 100},
+                "Count": {"count": 1},
+            }
+        )
+    device_metrics = {
+        device_name: {
+            "Name": {"string": "Total"},
+            "Duration (us)": {"microseconds": total_cycles / cycles_per_second * 1e6},
+            "Cycles": {"count": total_cycles},
+            "Percent": {"percent": 100.0},
+            "Count": {"count": len(records)},
+        }
+    }
+    return Report.from_json(json.dumps({"calls": calls, "device_metrics": device_metrics}))
+
+
+def profile_graph_executor(
+    graph_mod, graph_json_str, device, cycles_per_second, number=1, max_records=128
+):
+    """Run a graph executor created by ``create_local_graph_executor`` with the on-device
+    profiler enabled.
+
+    The profiler needs a CRT configured with ``TVM_CRT_PROFILER_RING_SIZE`` and a platform
+    implementing ``TVMPlatformProfilerCycles``. The device only keeps the last operator runs,
+    at most ``TVM_CRT_PROFILER_RING_SIZE`` of them.
+
+    Parameters
+    ----------
+    graph_mod : tvm.contrib.graph_executor.GraphModule
+        The graph executor, with its inputs set.
+
+    graph_json_str : str
+        The graph the executor was created from.
+
+    device : tvm.runtime.Device
+        The remote CPU device.
+
+    cycles_per_second : float
+        The frequency of the counter read by ``TVMPlatformProfilerCycles``.
+
+    number : int
+        The number of runs of the graph.
+
+    max_records : int
+        The maximum number of operator runs read back from the device.
+
+    Returns
+    -------
+    report : tvm.runtime.profiling.Report
+        The profiling report.
+    """
+    graph_mod.module["set_profiling"](1)
+    try:
+        for _ in range(number):
+            graph_mod.run()
+    finally:
+        graph_mod.module["set_profiling"](0)
+    out = ndarray.empty((max_records, 2), "int64", device=device)
+    num_records = graph_mod.module["get_profile"](out)
+    records = out.numpy()[:num_records]
+    return profile_report(records, graph_json_str, cycles_per_second, device_name=str(device))
@@ -26,6 +26,9 @@ from .annotated_regions import AnnotatedRegionSet
 from . import call_graph
 from .call_graph import CallGraph
 
+# Cost estimator
+from .cost_estimator import CostEstimator
+
 # Feature
 from . import feature
 from . import sparse_dense
@@ -0,0 +1,108 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The latency estimates of the kernels, for the performance driven compiler decisions."""
+import tvm._ffi
+from tvm.runtime import Object
+from . import _ffi_api
+
+
+@tvm._ffi.register_object("relay.CostEstimator")
+class CostEstimator(Object):
+    """Estimate the latency of the Relay calls and of the PrimFuncs on a target.
+
+    A kernel is estimated by the mean run time of its best record in the tuning database, else
+    by the learned model, else by the roofline of the target, i.e. the maximum of the time its
+    floating point operations take at the peak throughput and of the time its bytes take at
+    the peak bandwidth. The estimates are cached.
+
+    The passes use the estimator of the innermost ``with`` scope, or a default one.
+
+    Parameters
+    ----------
+    peak_flops : float
+        The floating point operations per second of the target, 0 for a default of its kind,
+        e.g. measured by :py:func:`tvm.contrib.roofline.estimate_peak_flops`.
+
+    peak_bandwidth : float
+        The bytes per second of the memory of the target, 0 for a default of its kind, e.g.
+        measured by :py:func:`tvm.contrib.roofline.estimate_peak_bandwidth`.
+
+    database : Optional[tvm.meta_schedule.database.Database]
+        The tuning records.
+
+    learned_model : Optional[Callable[[tvm.tir.PrimFunc, tvm.target.Target], float]]
+        The function estimating the latency in seconds of a lowered PrimFunc, returning a
+        negative value when it cannot.
+    """
+
+    def __init__(self, peak_flops=0.0, peak_bandwidth=0.0, database=None, learned_model=None):
+        self.__init_handle_by_constructor__(
+            _ffi_api.CostEstimator,
+            float(peak_flops),
+            float(peak_bandwidth),
+            database,
+            learned_model,
+        )
+
+    def estimate(self, expr, target):
+        """Estimate the latency of a kernel.
+
+        Parameters
+        ----------
+        expr : Union[tvm.relay.Call, tvm.tir.PrimFunc]
+            The type checked call of an op or of a primitive function, lowered with the
+            strategy of the op, or the PrimFunc.
+
+        target : Union[str, tvm.target.Target]
+            The target.
+
+        Returns
+        -------
+        latency : float
+            The latency in seconds.
+        """
+        return _ffi_api.CostEstimatorEstimate(self, expr, tvm.target.Target(target))
+
+    def roofline(self, func, target):
+        """The roofline estimate of a lowered PrimFunc, ignoring the other sources.
+
+        Parameters
+        ----------
+        func : tvm.tir.PrimFunc
+            The PrimFunc.
+
+        target : Union[str, tvm.target.Target]
+            The target.
+
+        Returns
+        -------
+        latency : float
+            The latency in seconds.
+        """
+        return _ffi_api.CostEstimatorRoofline(self, func, tvm.target.Target(target))
+
+    @staticmethod
+    def current():
+        """The estimator of the innermost scope, or the default one."""
+        return _ffi_api.CostEstimatorCurrent()
+
+    def __enter__(self):
+        _ffi_api.CostEstimatorEnterScope(self)
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        _ffi_api.CostEstimatorExitScope(self)
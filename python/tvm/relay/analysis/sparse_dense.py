@@ -54,6 +54,36 @@ def _search_dense_op_weight(expr):
     return _ffi_api.search_dense_op_weight(expr)
 
 
+def _select_block_size(w_np, block_sizes, sparsity_threshold):
+    """Select the block size of the BSR matrix a dense weight is converted to
+
+    Parameters
+    ----------
+    w_np : numpy.ndarray
+        The 2D dense weight
+    block_sizes : List[Tuple(int, int)]
+        Candidate block sizes
+    sparsity_threshold : float
+        Minimal ratio of the zero blocks for a block size to qualify
+
+    Returns
+    -------
+    ret : Optional[Tuple(int, int)]
+        The qualified block size holding the most elements, None when no one qualifies
+    """
+    best = None
+    for bs_r, bs_c in block_sizes:
+        if w_np.shape[0] % bs_r != 0 or w_np.shape[1] % bs_c != 0:
+            continue
+        if best is not None and bs_r * bs_c <= best[0] * best[1]:
+            continue
+        blocks = w_np.reshape(w_np.shape[0] // bs_r, bs_r, w_np.shape[1] // bs_c, bs_c)
+        nonzero_blocks = np.count_nonzero(np.any(blocks != 0, axis=(1, 3)))
+        if 1.0 - nonzero_blocks / (blocks.shape[0] * blocks.shape[2]) >= sparsity_threshold:
+            best = (bs_r, bs_c)
+    return best
+
+
 def process_params(expr, params, block_size, sparsity_threshold):
     """[summary]
 
@@ -63,8 +93,9 @@ def process_params(expr, params, block_size, sparsity_threshold):
         Expr of the network
     params : Dict[String, tvm.nd.array]
         parameters of the network
-    block_size : Tuple(int, int)
-        Blocksize in BSR matrix
+    block_size : Union[Tuple(int, int), List[Tuple(int, int)]]
+        Blocksize in BSR matrix. When a list of candidates is given, each weight is converted
+        with the largest one whose ratio of zero blocks reaches sparsity_threshold
     sparsity_threshold : float
         Minimal sparsity requirement for converting to sparse operation
 
@@ -81,11 +112,16 @@ def process_params(expr, params, block_size, sparsity_threshold):
 
     memo = SparseAnalysisResult(weight_name=[], weight_shape=[])
     weight_names = _search_dense_op_weight(expr)
+    candidates = None if isinstance(block_size[0], int) else block_size
     for name in weight_names:
         name = str(name)
+        if name not in params:
+            continue
         w_np = params[name].numpy()
         sparsity = 1.0 - (np.count_nonzero(w_np) / w_np.size)
-        if sparsity >= sparsity_threshold:
+        if candidates is not None:
+            block_size = _select_block_size(w_np, candidates, sparsity_threshold)
+        if block_size is not None and sparsity >= sparsity_threshold:
             sparse_weight = sp.bsr_matrix(w_np, blocksize=block_size)
             # remove dense weight
             del params[name]
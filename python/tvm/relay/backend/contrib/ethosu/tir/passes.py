@@ -17,6 +17,7 @@
 # pylint: disable=invalid-name, unused-argument, no-else-return, inconsistent-return-statements
 """The TIR passes to be run on Arm(R) Ethos(TM)-U NPU TIR Compiler."""
 from collections import namedtuple
+import logging
 import numpy as np  # type: ignore
 
 import tvm
@@ -30,6 +31,8 @@ from .unary_elementwise import get_unary_elementwise_params
 from .transform import get_copy_params
 from .utils import get_weights_pointer, get_scale_bias_pointer
 
+logger = logging.getLogger("Ethos-U")
+
 
 def RemoveZeroStores():
     """This pass removes stores which just store zero to initialise buffers.
@@ -307,6 +310,8 @@ def EncodeConstants(const_dict):
     rewrite_buffer = {}
     rewrite_pointer = {}
     accel_config = vela_api.get_accelerator_config()
+    # The sizes in bytes of the weights before and after their compression
+    weight_sizes = [0, 0]
 
     def _align_scale_bias(tir_extern_call, bias):
         """Align the scale_bias to 16 bytes."""
@@ -323,6 +328,8 @@ def EncodeConstants(const_dict):
         """Encode the weights for a TIR extern call."""
         value_bytes = vela_api.encode_weights(tir_extern_call, weights, accel_config)
         value = np.frombuffer(value_bytes, dtype="uint8")
+        weight_sizes[0] += weights.nbytes
+        weight_sizes[1] += value.nbytes
         return value
 
     def _new_buffer(old_buffer, new_value):
@@ -486,6 +493,13 @@ def EncodeConstants(const_dict):
             _ftransform, opt_level=0, name="tir.ethosu.encode_constants"
         )
         new_func = transform_func(mod)
+        if weight_sizes[1] > 0:
+            logger.info(
+                "Compressed the weights from %d to %d bytes, a ratio of %.2f",
+                weight_sizes[0],
+                weight_sizes[1],
+                weight_sizes[0] / weight_sizes[1],
+            )
         return new_func, new_const_dict
 
     return _encode_constants
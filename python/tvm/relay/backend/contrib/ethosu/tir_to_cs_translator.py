@@ -110,7 +110,12 @@ def translate(tir_module, params):
     _npu_ops = list()
     for call_extern in call_extern_list:
         _npu_ops.append(translate_ethosu_tir_call_extern(call_extern))
-    _npu_ops, constant_data, scratch_size = assign_addresses(buffer_info, _npu_ops)
+    weight_streaming = util.is_weight_streaming_enabled()
+    _npu_ops, constant_data, scratch_size = assign_addresses(
+        buffer_info, _npu_ops, weight_streaming
+    )
+    if weight_streaming:
+        _npu_ops = prefetch_constants(_npu_ops)
     target_accel_config = vela_api.get_accelerator_config()
     cmds = vapi.npu_generate_register_command_stream(_npu_ops, target_accel_config)
     payload = vapi.npu_create_driver_payload(cmds, target_accel_config)
@@ -209,7 +214,7 @@ def extract_buffer_info(
     return buffer_info
 
 
-def assign_addresses(buffer_info, npu_ops):
+def assign_addresses(buffer_info, npu_ops, double_buffer_constants=False):
     """This function will assign addresses to tensors
     within two buffers : scratch and constants.
     The scratch is the buffer created to hold all intermediary data
@@ -222,6 +227,9 @@ def assign_addresses(buffer_info, npu_ops):
         The key is the buffer name to BufferInfo
     npu_ops : list
         A list of Vela NpuOps with tir.Loads for addresses
+    double_buffer_constants : bool
+        Whether the scratch buffers the constants are copied to get two slots,
+        used in turn by the successive copies.
     Returns
     -------
     npu_ops : list
@@ -242,6 +250,7 @@ def assign_addresses(buffer_info, npu_ops):
         buffer = npu_fm.tiles.addresses[0].buffer_var
         assert buffer in buffer_addresses.keys()
         address, buffer_type = buffer_addresses[buffer]
+        address += slot_offset(buffer)
         index = npu_fm.tiles.addresses[0].index * (
             np.iinfo(np.dtype(npu_fm.tiles.addresses[0])).bits // 8
         )
@@ -254,6 +263,7 @@ def assign_addresses(buffer_info, npu_ops):
         buffer = npu_addr_range.address.buffer_var
         assert buffer in buffer_addresses.keys(), f"searching for buffer : {buffer}, but not found"
         address, buffer_type = buffer_addresses[buffer]
+        address += slot_offset(buffer)
         return vapi.NpuAddressRange(_REGION_MAP[buffer_type], address, npu_addr_range.length)
 
     def replace_tir_loads(npu_object):
@@ -275,6 +285,26 @@ def assign_addresses(buffer_info, npu_ops):
 
         raise ValueError(f"Unused IO : {buffer} in tir module.")
 
+    def slot_offset(buffer):
+        if buffer not in slot_sizes:
+            return 0
+        return slot_sizes[buffer] * (copy_counts[buffer] % 2)
+
+    # The scratch buffers receiving copies of constants, double buffered when requested
+    slot_sizes = dict()
+    copy_counts = dict()
+    if double_buffer_constants:
+        for npu_op in npu_ops:
+            if isinstance(npu_op, vapi.NpuDmaOperation):
+                src_info = buffer_info[npu_op.src.address.buffer_var]
+                dest_buffer = npu_op.dest.address.buffer_var
+                if (
+                    src_info.btype == BufferType.constant
+                    and buffer_info[dest_buffer].btype == BufferType.scratch
+                ):
+                    slot_sizes[dest_buffer] = 0
+                    copy_counts[dest_buffer] = -1
+
     scratch_size = 0
     constant_hex_data = []
     total_constant_len = 0
@@ -313,9 +343,16 @@ def assign_addresses(buffer_info, npu_ops):
                 assert info.btype == BufferType.scratch
                 address = scratch_size
                 scratch_size += size_in_bytes
+                if _buffer in slot_sizes:
+                    slot_sizes[_buffer] = size_in_bytes
+                    scratch_size += size_in_bytes
                 buffer_addresses[_buffer] = (address, info.btype)
 
     for npu_op in npu_ops:
+        if isinstance(npu_op, vapi.NpuDmaOperation):
+            dest_buffer = npu_op.dest.address.buffer_var
+            if dest_buffer in copy_counts:
+                copy_counts[dest_buffer] += 1
         for attr_name, attr in npu_op.__dict__.items():
             if isinstance(attr, list):
                 new_attr = list()
@@ -333,6 +370,63 @@ def assign_addresses(buffer_info, npu_ops):
     )
 
 
+def prefetch_constants(npu_ops):
+    """This function will move the copies of constants to the scratch
+    ahead of the NPU operation preceding the one that reads them, so that
+    the DMA of the next weights overlaps the current operation. The operations
+    are not otherwise reordered, and a copy writing to a range that the
+    preceding operation reads stays where it is. The hazards between the
+    remaining overlapping accesses are resolved by the waits Vela inserts
+    in the command stream.
+
+    Parameters
+    ----------
+    npu_ops : list
+        A list of Vela NpuOps with addresses assigned by assign_addresses
+
+    Returns
+    -------
+    npu_ops : list
+        The reordered list of Vela NpuOps
+    """
+
+    def overlaps(range_a, range_b):
+        return (
+            range_a.region == range_b.region
+            and range_a.address < range_b.address + range_b.length
+            and range_b.address < range_a.address + range_a.length
+        )
+
+    def is_prefetchable(npu_op, block_op):
+        if not isinstance(npu_op, vapi.NpuDmaOperation):
+            return False
+        if npu_op.src.region != _REGION_MAP[BufferType.constant]:
+            return False
+        if npu_op.dest.region != _REGION_MAP[BufferType.scratch]:
+            return False
+        if block_op is None:
+            return True
+        reads = list(block_op.weights or []) + list(block_op.biases or [])
+        return not any(overlaps(npu_op.dest, read) for read in reads)
+
+    prefetched_ops = list()
+    pending_block_op = None
+    for npu_op in npu_ops:
+        if is_prefetchable(npu_op, pending_block_op):
+            prefetched_ops.append(npu_op)
+            continue
+        if pending_block_op is not None:
+            prefetched_ops.append(pending_block_op)
+            pending_block_op = None
+        if issubclass(type(npu_op), vapi.NpuBlockOperation):
+            pending_block_op = npu_op
+        else:
+            prefetched_ops.append(npu_op)
+    if pending_block_op is not None:
+        prefetched_ops.append(pending_block_op)
+    return prefetched_ops
+
+
 def translate_ethosu_tir_call_extern(tir_call_extern):
     """This is a dispatcher function to dispatch
     correct translation call depending on the extern call's
@@ -208,6 +208,12 @@ def get_accelerator_config():
     return compiler_attrs.accelerator_config
 
 
+def is_weight_streaming_enabled():
+    """Determine whether the weights copied to the scratch are double buffered"""
+    compiler_attrs = tvm.get_global_func("relay.ext.ethos-u.get_compiler_attrs")()
+    return bool(compiler_attrs.enable_weight_streaming)
+
+
 def get_arg_count(func):
     """Helper function to get the number of
     arguments in a python function"""
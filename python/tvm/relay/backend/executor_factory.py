@@ -91,6 +91,9 @@ class AOTExecutorFactoryModule(ExecutorFactoryModule):
         This holds a map function names to their information
     devices : List[str]
         List of devices used in the module
+    executor_config : str
+        The config of the AOT executor of the C++ runtime, see tvm.contrib.aot_executor, empty
+        when the model cannot run on it.
     """
 
     def __init__(
@@ -104,6 +107,7 @@ class AOTExecutorFactoryModule(ExecutorFactoryModule):
         params,
         function_metadata,
         devices,
+        executor_config="",
     ):
         self.ir_mod = ir_mod
         self.lowered_ir_mods = lowered_ir_mods
@@ -115,6 +119,16 @@ class AOTExecutorFactoryModule(ExecutorFactoryModule):
         self.iter_cnt = 0
         self.function_metadata = function_metadata
         self.devices = devices
+        self.executor_config = executor_config or None
+        # The factory creating the executors of the C++ runtime, lib["default"](dev)
+        fcreate = get_global_func("tvm.aot_executor_factory.create", allow_missing=True)
+        if self.executor_config and fcreate:
+            self.module = fcreate(self.executor_config, libmod, libmod_name)
+        else:
+            self.module = libmod
+
+    def export_library(self, file_name, fcompile=None, addons=None, **kwargs):
+        return self.module.export_library(file_name, fcompile, addons, **kwargs)
 
     def get_devices(self):
         return self.devices
@@ -123,7 +137,7 @@ class AOTExecutorFactoryModule(ExecutorFactoryModule):
         return self.params
 
     def get_executor_config(self):
-        return None
+        return self.executor_config
 
     def get_lib(self):
         return self.lib
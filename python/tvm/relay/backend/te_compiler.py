@@ -18,7 +18,12 @@
 """TE compiler engine (replacing legacy compile_engine)."""
 from __future__ import absolute_import
 
+import json
 import logging
+import os
+
+import numpy as np
+
 import tvm
 from tvm import te, autotvm
 from tvm.ir.transform import PassContext
@@ -35,6 +40,11 @@ autotvm_logger = logging.getLogger("autotvm")
 
 _first_warning = True
 
+# The latencies of the implementations measured by select_implementation, by workload, and
+# the logs already loaded in it.
+_measured_latencies = {}
+_loaded_latency_logs = set()
+
 
 @tvm._ffi.register_object("relay.LoweredOutput")
 class LoweredOutput(Object):
@@ -133,12 +143,99 @@ def get_valid_implementations(op, attrs, inputs, out_type, target):
     return ret
 
 
+def _latency_key(op, attrs, inputs, out_type, target):
+    shapes = [[[int(dim) for dim in tensor.shape], tensor.dtype] for tensor in inputs]
+    attrs_json = tvm.ir.save_json(attrs) if attrs is not None else ""
+    return json.dumps([op.name, str(target), shapes, str(out_type), attrs_json])
+
+
+def _load_latency_log(path):
+    if path in _loaded_latency_logs:
+        return
+    _loaded_latency_logs.add(path)
+    if not os.path.exists(path):
+        return
+    with open(path) as log:
+        for line in log:
+            if line.strip():
+                record = json.loads(line)
+                _measured_latencies.setdefault(record["key"], {}).update(record["latencies"])
+
+
+def _measure_latency(impl, attrs, inputs, out_type, target, dev):
+    """Build an implementation of the op alone and measure its latency on random inputs."""
+    # the inputs may be computed by the fused ops, a placeholder stands for each of them
+    placeholders = [te.placeholder(tensor.shape, tensor.dtype) for tensor in inputs]
+    with target:
+        outs = impl.compute(attrs, placeholders, out_type)
+        sch = impl.schedule(attrs, outs, target)
+        func = tvm.build(sch, placeholders + list(outs), target)
+    args = []
+    for tensor in placeholders + list(outs):
+        shape = [int(dim) for dim in tensor.shape]
+        # integer inputs are often indices, which zeros keep in bounds
+        if "float" in tensor.dtype:
+            data = np.random.uniform(-1, 1, size=shape).astype(tensor.dtype)
+        else:
+            data = np.zeros(shape, dtype=tensor.dtype)
+        args.append(tvm.nd.array(data, dev))
+    evaluator = func.time_evaluator(func.entry_name, dev, number=5, repeat=3, min_repeat_ms=10)
+    return evaluator(*args).min
+
+
+def _select_by_latency(op, attrs, inputs, out_type, target, impls):
+    """Pick the fastest implementation on the device of the target, None when not measurable.
+
+    The latencies are cached by workload, and kept in the log of the
+    "relay.backend.implementation_latency_log" option when it is set, so that the later
+    builds reuse them.
+    """
+    if len(impls) < 2:
+        return None
+    if any(not isinstance(dim, tvm.tir.IntImm) for tensor in inputs for dim in tensor.shape):
+        return None
+    dev = tvm.device(target.kind.name, 0)
+    if not dev.exist:
+        return None
+    log_path = PassContext.current().config.get("relay.backend.implementation_latency_log", "")
+    if log_path:
+        _load_latency_log(log_path)
+    key = _latency_key(op, attrs, inputs, out_type, target)
+    latencies = _measured_latencies.setdefault(key, {})
+    measured = {}
+    for impl in impls:
+        if impl.name in latencies:
+            continue
+        old_silent = autotvm.GLOBAL_SCOPE.silent
+        autotvm.GLOBAL_SCOPE.silent = True
+        try:
+            measured[impl.name] = _measure_latency(impl, attrs, inputs, out_type, target, dev)
+        except Exception as err:  # pylint: disable=broad-except
+            logger.info("Cannot measure %s for %s: %s", impl.name, op.name, err)
+            measured[impl.name] = float("inf")
+        finally:
+            autotvm.GLOBAL_SCOPE.silent = old_silent
+        logger.info(
+            "Implementation %s for %s has latency %.2e", impl.name, op.name, measured[impl.name]
+        )
+    latencies.update(measured)
+    if measured and log_path:
+        with open(log_path, "a") as log:
+            log.write(json.dumps({"key": key, "latencies": measured}) + "\n")
+    best_impl = min(impls, key=lambda impl: latencies[impl.name])
+    if latencies[best_impl.name] == float("inf"):
+        return None
+    return best_impl
+
+
 def select_implementation(op, attrs, inputs, out_type, target, use_autotvm=True):
     """Select the best implementation from the op strategy.
 
     If use_autotvm is True, it'll first try to find the best implementation
     based on AutoTVM profile results. If no AutoTVM profile result is found,
-    it'll choose the implementation with highest plevel.
+    it'll choose the implementation with highest plevel, or the fastest one
+    measured on the device when the "relay.backend.measure_implementations"
+    option is set.
 
     If use_autotvm is False, it'll directly choose the implementation with
     highest plevel.
@@ -225,6 +322,15 @@ def select_implementation(op, attrs, inputs, out_type, target, use_autotvm=True)
         )
         return best_autotvm_impl, outputs[best_autotvm_impl]
 
+    # Otherwise, measure the implementations when asked to, unless extracting the tasks
+    env = autotvm.task.TaskExtractEnv.current
+    measure = PassContext.current().config.get("relay.backend.measure_implementations", False)
+    if measure and not (env is not None and env.tracing):
+        best_measured_impl = _select_by_latency(op, attrs, inputs, out_type, target, all_impls)
+        if best_measured_impl:
+            logger.info("Using %s for %s based on lowest latency", best_measured_impl.name, op.name)
+            return best_measured_impl, outputs[best_measured_impl]
+
     # Use the implementation with highest plevel
     if workloads[best_plevel_impl] is not None:
         msg = (
@@ -274,6 +380,13 @@ def get_shape(shape):
     return ret
 
 
+@tvm._ffi.register_func("relay.backend.dispatch_context_digest")
+def dispatch_context_digest():
+    """Get the digest of the configs picked by the current AutoTVM dispatch context, None
+    when it cannot be digested and the lowered functions must not be cached on disk."""
+    return autotvm.task.DispatchContext.current.digest()
+
+
 @tvm._ffi.register_func("relay.backend.lower_call")
 def lower_call(call, inputs, target):
     """Lower the call expression to op implementation and tensor outputs."""
@@ -271,6 +271,20 @@ def _module_export(module, file_name):  # fcompile, addons, kwargs?
 
 
 @register_func("tvm.relay.build")
+def _convert_sparse_weights(mod, params):
+    """Convert the dense operators with block sparse weights to sparse_dense, when
+    relay.DenseToSparse.sparsity_threshold is set."""
+    config = PassContext.current().config
+    threshold = config.get("relay.DenseToSparse.sparsity_threshold", None)
+    if threshold is None or not params:
+        return mod, params
+    # pylint: disable=import-outside-toplevel
+    from .data_dep_optimization import bsr_dense
+
+    block_sizes = config.get("relay.DenseToSparse.block_sizes", [(16, 1), (8, 1), (4, 1), (1, 1)])
+    return bsr_dense.auto_convert(mod, params, block_sizes, float(threshold.value))
+
+
 def _build_module_no_factory(mod, target=None, target_host=None, params=None, mod_name="default"):
     """A wrapper around build which discards the Python GraphFactoryRuntime.
     This wrapper is suitable to be used from other programming languages as
@@ -444,6 +458,8 @@ def build(
     else:
         tophub_context = autotvm.utils.EmptyContext()
 
+    ir_mod, params = _convert_sparse_weights(ir_mod, params)
+
     with tophub_context:
         bld_mod = BuildModule()
         graph_json, runtime_mod, params = bld_mod.build(
@@ -469,6 +485,7 @@ def build(
                 params,
                 func_metadata,
                 devices,
+                executor_config=graph_json,
             )
         elif str(executor) == "graph":
             executor_factory = _executor_factory.GraphExecutorFactoryModule(
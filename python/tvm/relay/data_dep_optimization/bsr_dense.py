@@ -17,6 +17,7 @@
 # pylint: disable=unused-argument, not-context-manager
 """Automatic convert model from dense to block sparse"""
 
+import tvm
 from tvm import relay
 from tvm.relay.analysis.sparse_dense import process_params
 
@@ -32,8 +33,9 @@ def convert(func, params, blocksize, sparsity_threshold):
         Expr will be optimized to sparse operation
     params : Dict[Srting, tvm.nd.array]
         Parameters of the Expr
-    blocksize : Tuple(int, int)
-        Blocksize for BSR matrix
+    blocksize : Union[Tuple(int, int), List[Tuple(int, int)]]
+        Blocksize for BSR matrix, or the candidate blocksizes each weight picks the largest
+        qualified one from
     sparsity_threshold : float
         Minimal sparsity requirement for converting.
         If weight sparsity is lower than this threshold,
@@ -52,3 +54,37 @@ def convert(func, params, blocksize, sparsity_threshold):
         func, relay.transform.DenseToSparse(weight_info.weight_name, weight_info.weight_shape)
     )
     return new_func, params
+
+
+def auto_convert(mod, params, block_sizes, sparsity_threshold):
+    """Convert the dense operators of the main function of a module whose weights are
+    block sparse, picking the blocksize of each weight
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The module, the weights being free parameters of its main function
+    params : Dict[Srting, tvm.nd.array]
+        Parameters of the module
+    block_sizes : List[Tuple(int, int)]
+        Candidate blocksizes for BSR matrix
+    sparsity_threshold : float
+        Minimal ratio of the zero blocks for a weight to be converted
+
+    Returns
+    -------
+    new_mod: tvm.IRModule
+        Mutated module with sparse operations
+
+    params: Dict[Srting, tvm.nd.array]
+        New params with BSR matrix for mutated module
+    """
+    params = {
+        name: value if isinstance(value, tvm.nd.NDArray) else tvm.nd.array(value)
+        for name, value in params.items()
+    }
+    block_sizes = [tuple(int(x) for x in block) for block in block_sizes]
+    main = mod["main"]
+    new_main, params = convert(main, params, block_sizes, sparsity_threshold)
+    functions = {gv: func for gv, func in mod.functions.items() if gv.name_hint != "main"}
+    return tvm.IRModule.from_expr(new_main, functions, mod.type_definitions), params
@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """Patterns supported CUTLASS."""
+from tvm.ir import structural_equal
 from tvm.relay import transform
 from ...dataflow_pattern import wildcard, is_op, is_constant
 
@@ -55,9 +56,46 @@ def make_batch_matmul_pattern():
     return is_op("nn.batch_matmul")(wildcard(), wildcard())
 
 
-def make_conv2d_pattern():
+def make_conv2d_pattern(with_bias=False, with_act=None, with_residual=False):
+    """Create a pattern for conv2d op followed by a bias or a residual add and activations."""
     # TODO(masahi): Check layout and alignment
-    return is_op("nn.conv2d")(wildcard(), wildcard())
+    conv2d = is_op("nn.conv2d")(wildcard(), wildcard())
+    if with_bias:
+        add_or_bias_add = is_op("add") | is_op("nn.bias_add")
+        conv2d_out = add_or_bias_add(conv2d, wildcard())
+    elif with_residual:
+        conv2d_out = is_op("add")(conv2d, wildcard())
+    else:
+        conv2d_out = conv2d
+
+    if with_act is None:
+        return conv2d_out
+    assert isinstance(with_act, str) and with_act == "relu"
+    return is_op("nn.relu")(conv2d_out)
+
+
+def _get_conv2d_add(call):
+    if call.op.name == "nn.relu":
+        call = call.args[0]
+    return call
+
+
+def check_conv2d_bias(call):
+    """Check that the added tensor is a bias broadcast along the output channels."""
+    add = _get_conv2d_add(call)
+    if add.op.name == "nn.bias_add":
+        return add.attrs.axis in (-1, len(add.args[0].checked_type.shape) - 1)
+    bias_shape = add.args[1].checked_type.shape
+    out_channel = add.args[0].checked_type.shape[-1]
+    return all(int(s) == 1 for s in bias_shape[:-1]) and bias_shape[-1] == out_channel
+
+
+def check_conv2d_residual(call):
+    """Check that the added tensor has the shape of the conv2d output."""
+    add = _get_conv2d_add(call)
+    conv2d_shape = add.args[0].checked_type.shape
+    residual_shape = add.args[1].checked_type.shape
+    return structural_equal(conv2d_shape, residual_shape)
 
 
 def partition_for_cutlass(mod):
@@ -77,9 +115,25 @@ def partition_for_cutlass(mod):
         dense_bias_pat,
         dense_pat,
         ("cutlass.batch_matmul", make_batch_matmul_pattern()),
-        # TODO(masahi): Add more conv2d patterns
+        (
+            "cutlass.conv2d_bias_relu",
+            make_conv2d_pattern(with_bias=True, with_act="relu"),
+            check_conv2d_bias,
+        ),
+        ("cutlass.conv2d_bias", make_conv2d_pattern(with_bias=True), check_conv2d_bias),
+        (
+            "cutlass.conv2d_residual_add_relu",
+            make_conv2d_pattern(with_residual=True, with_act="relu"),
+            check_conv2d_residual,
+        ),
+        (
+            "cutlass.conv2d_residual_add",
+            make_conv2d_pattern(with_residual=True),
+            check_conv2d_residual,
+        ),
         ("cutlass.conv2d", make_conv2d_pattern()),
     ]
+    mod = transform.InferType()(mod)
     mod = transform.MergeComposite(cutlass_patterns)(mod)
     mod = transform.AnnotateTarget(["cutlass"])(mod)
     mod = transform.PartitionGraph()(mod)
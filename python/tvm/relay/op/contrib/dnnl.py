@@ -33,6 +33,9 @@ it is supported. For example:
 check the attributes of the op and decide if it should be offloaded to DNNL.
 """
 import tvm.ir
+from tvm.relay import transform
+from tvm.relay.build_module import bind_params_by_name
+
 from ...dataflow_pattern import wildcard, is_op
 from .register import register_pattern_table
 
@@ -79,9 +82,137 @@ def make_pattern(with_bias=True):
     return is_op("nn.relu")(conv_out)
 
 
+def make_fused_pattern(anchor_name, with_bias=True, with_sum=False, with_relu=True):
+    """Create a pattern of a convolution or a dense with its fused post-ops.
+
+    Parameters
+    ----------
+    anchor_name : str
+        The op name of the convolution or the dense.
+    with_bias : bool
+        Whether the pattern adds a bias of the output channels.
+    with_sum : bool
+        Whether the pattern adds a residual of the output shape, fused as a DNNL sum post-op.
+    with_relu : bool
+        Whether the pattern ends with a relu, fused as a DNNL eltwise post-op.
+
+    Returns
+    -------
+    pattern : DFPattern
+        The pattern.
+    """
+    out = is_op(anchor_name)(wildcard(), wildcard())
+    if with_bias:
+        out = is_op("add")(out, wildcard())
+    if with_sum:
+        out = is_op("add")(out, wildcard())
+    if with_relu:
+        out = is_op("nn.relu")(out)
+    return out
+
+
+def _shape_of(expr):
+    return [int(dim) for dim in expr.checked_type.shape]
+
+
+def _is_channel_bias(bias_shape, out_shape):
+    """Whether a bias broadcasts along the channels of an NCHW or NC output."""
+    if len(bias_shape) not in [len(out_shape) - 1, len(out_shape)]:
+        return False
+    bias_shape = [1] * (len(out_shape) - len(bias_shape)) + bias_shape
+    return bias_shape == [1, out_shape[1]] + [1] * (len(out_shape) - 2)
+
+
+def make_fused_check(anchor_name, with_bias=True, with_sum=False):
+    """Create the check of a fused pattern. The DNNL JSON runtime binds float32 tensors only,
+    the bias by the output channels and the residual by the output shape."""
+
+    def _check(extract):
+        # The calls of the pattern from the anchor: the bias add, the residual add, the relu.
+        calls = [extract]
+        while calls[-1].op.name != anchor_name:
+            calls.append(calls[-1].args[0])
+        calls.reverse()
+        anchor = calls[0]
+        if anchor_name == "nn.conv2d":
+            if anchor.attrs.data_layout != "NCHW" or anchor.attrs.kernel_layout != "OIHW":
+                return False
+        out_shape = _shape_of(anchor)
+        inputs = list(anchor.args)
+        if with_bias:
+            bias = calls[1].args[1]
+            if not _is_channel_bias(_shape_of(bias), out_shape):
+                return False
+            inputs.append(bias)
+        if with_sum:
+            residual = calls[2 if with_bias else 1].args[1]
+            if _shape_of(residual) != out_shape:
+                return False
+            inputs.append(residual)
+        return all(arg.checked_type.dtype == "float32" for arg in inputs)
+
+    return _check
+
+
 @register_pattern_table("dnnl")
 def pattern_table():
     conv2d_bias_relu_pat = ("dnnl.conv2d_bias_relu", make_pattern(with_bias=True))
     conv2d_relu_pat = ("dnnl.conv2d_relu", make_pattern(with_bias=False))
     dnnl_patterns = [conv2d_bias_relu_pat, conv2d_relu_pat]
     return dnnl_patterns
+
+
+def fused_pattern_table():
+    """The patterns of the convolutions and the denses with their post-ops fused, supported by
+    the DNNL JSON runtime only. The composite names list the post-ops the runtime fuses, e.g.
+    dnnl.conv2d_bias_sum_relu adds a bias, then a residual, then applies a relu."""
+    patterns = []
+    for with_sum in [True, False]:
+        for with_relu in [True, False]:
+            name = "dnnl.conv2d_bias" + ("_sum" if with_sum else "")
+            name += "_relu" if with_relu else ""
+            pattern = make_fused_pattern("nn.conv2d", True, with_sum, with_relu)
+            patterns.append((name, pattern, make_fused_check("nn.conv2d", True, with_sum)))
+    patterns.append(
+        (
+            "dnnl.conv2d_relu",
+            make_fused_pattern("nn.conv2d", with_bias=False),
+            make_fused_check("nn.conv2d", with_bias=False),
+        )
+    )
+    for with_relu in [True, False]:
+        name = "dnnl.dense_bias" + ("_relu" if with_relu else "")
+        pattern = make_fused_pattern("nn.dense", True, False, with_relu)
+        patterns.append((name, pattern, make_fused_check("nn.dense", True, False)))
+    return patterns
+
+
+def partition_for_dnnl(mod, params=None):
+    """Partition the graph greedily offloading supported operators to DNNL, fusing the
+    post-ops of the convolutions and the denses for the DNNL JSON runtime.
+
+    Parameters
+    ----------
+    mod : Module
+        The module to run passes on.
+    params : Optional[Dict[str, NDArray]]
+        Constant input parameters.
+
+    Returns
+    -------
+    mod : Module
+        Annotated and partitioned module.
+    """
+    if params:
+        mod["main"] = bind_params_by_name(mod["main"], params)
+
+    seq = tvm.transform.Sequential(
+        [
+            transform.InferType(),
+            transform.MergeComposite(fused_pattern_table()),
+            transform.AnnotateTarget("dnnl"),
+            transform.MergeCompilerRegions(),
+            transform.PartitionGraph(),
+        ]
+    )
+    return seq(mod)
@@ -86,6 +86,7 @@ def partition_for_tensorrt(
     use_implicit_batch=True,
     remove_no_mac_subgraphs=False,
     max_workspace_size=1 << 30,
+    max_batch_size=-1,
 ):
     """Partition the graph greedily offloading supported operators to TensorRT.
 
@@ -109,6 +110,11 @@ def partition_for_tensorrt(
     max_workspace_size : Optional[int]
         How many bytes of workspace size to allow each subgraph to use for TensorRT engine creation.
         See TensorRT documentation for more info.
+    max_batch_size : Optional[int]
+        The smallest batch size to build each TensorRT engine for. An engine built for a batch
+        size serves all the smaller batches, so with a dynamic batch dimension a single engine
+        covers the batch sizes up to max_batch_size. By default, engines are built for the batch
+        size of the first run and rebuilt when a larger batch comes.
     Returns
     -------
     mod_and_config : Tuple[Module, Dict[str, Any]]
@@ -119,6 +125,7 @@ def partition_for_tensorrt(
         "use_implicit_batch": use_implicit_batch,
         "max_workspace_size": max_workspace_size,
         "remove_no_mac_subgraphs": remove_no_mac_subgraphs,
+        "max_batch_size": max_batch_size,
     }
     if version:
         assert isinstance(version, tuple) and len(version) == 3
@@ -161,6 +168,40 @@ def partition_for_tensorrt(
     return mod, config
 
 
+def build_tensorrt_engines(module, batch_size):
+    """Build the TensorRT engines of a module ahead of the first run.
+
+    The engines are kept in memory, and written to the TVM_TENSORRT_CACHE_DIR directory when it
+    is set, so that the processes later loading the module do not build them again.
+
+    Parameters
+    ----------
+    module : tvm.runtime.Module
+        The module containing the TensorRT subgraphs. They must have been initialized, for
+        example by creating the graph executor or the virtual machine running the module.
+    batch_size : int
+        The batch size to build the engines for.
+
+    Returns
+    -------
+    num_engines : int
+        The number of engines built.
+    """
+    num_engines = 0
+    visited = set()
+    stack = [module]
+    while stack:
+        mod = stack.pop()
+        if mod.handle.value in visited:
+            continue
+        visited.add(mod.handle.value)
+        if mod.type_key == "tensorrt":
+            mod.get_function("build_engine")(batch_size)
+            num_engines += 1
+        stack.extend(mod.imported_modules)
+    return num_engines
+
+
 def check_dynamism(args, op_name):
     """
     Check for dynamism inside any of the args in the op.
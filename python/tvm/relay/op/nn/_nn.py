@@ -151,6 +151,16 @@ reg.register_strategy("nn.batch_matmul", strategy.batch_matmul_strategy)
 reg.register_pattern("nn.batch_matmul", reg.OpPattern.OUT_ELEMWISE_FUSABLE)
 
 
+# fused_attention
+reg.register_strategy("nn.fused_attention", strategy.fused_attention_strategy)
+reg.register_pattern("nn.fused_attention", reg.OpPattern.OPAQUE)
+
+
+# weight_only_dense
+reg.register_strategy("nn.weight_only_dense", strategy.weight_only_dense_strategy)
+reg.register_pattern("nn.weight_only_dense", reg.OpPattern.OUT_ELEMWISE_FUSABLE)
+
+
 # sparse_dense
 @reg.register_compute("nn.sparse_dense")
 def compute_sparse_dense(attrs, inputs, out_type):
@@ -225,6 +235,12 @@ def alter_op_layout_conv2d(attrs, inputs, tinfos, out_type):
     return topi.nn.conv2d_alter_layout(attrs, inputs, tinfos, out_type)
 
 
+@reg.register_layout_candidates("nn.conv2d")
+def layout_candidates_conv2d(attrs, tinfos, out_type):
+    """The layouts conv2d can be altered to"""
+    return topi.nn.conv2d_layout_candidates(attrs, tinfos, out_type)
+
+
 @reg.register_legalize("nn.conv2d")
 def legalize_conv2d(attrs, inputs, types):
     """Legalize conv2d op.
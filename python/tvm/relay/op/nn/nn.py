@@ -1648,10 +1648,12 @@ def contrib_dense_pack(data, weight, weight_layout="NC", units=None, out_dtype="
 
     weight : tvm.relay.Expr
         The transformed weight expressions, 3-D matrix,
-        of shape `(units // pack_weight_tile, units_in, pack_weight_tile)`.
+        of shape `(units // pack_weight_tile, units_in, pack_weight_tile)`,
+        or 4-D for the int8 dot product instructions,
+        of shape `(units // pack_weight_tile, units_in // pack_k, pack_weight_tile, pack_k)`.
 
     weight_layout: str
-        The layout of weight, such as "NC" or "NC8n".
+        The layout of weight, such as "NC", "NC8n" or "NC16n4c".
 
     units : int, optional
         Number of hidden units of the dense transformation.
@@ -2259,6 +2261,85 @@ def batch_matmul(tensor_a, tensor_b, out_dtype="", transpose_a=False, transpose_
     return _make.batch_matmul(tensor_a, tensor_b, out_dtype, transpose_a, transpose_b)
 
 
+def fused_attention(query, key, value, scale=1.0):
+    r"""
+    Compute scaled dot product attention in one operator.
+
+    .. math::
+
+        \mbox{fused_attention}(Q, K, V)[i, :, :] = \mbox{softmax}(scale * Q[i, :, :]
+        K[i, :, :]^T) V[i, :, :]
+
+    The heads of a multi-head attention are folded into the batch dimension. The
+    implementations go through the keys by blocks with an online softmax, so the attention
+    matrix is never materialized. SimplifyExpr creates this op from batch_matmul, softmax
+    and batch_matmul when the `relay.SimplifyExpr.fuse_attention` option is set.
+
+    Parameters
+    ----------
+    query : tvm.relay.Expr
+        The queries, of shape `(b, m, d)`.
+
+    key : tvm.relay.Expr
+        The keys, of shape `(b, n, d)`.
+
+    value : tvm.relay.Expr
+        The values, of shape `(b, n, dv)`.
+
+    scale : Optional[float] = 1.0
+        The factor applied to the query-key products before the softmax.
+
+    Returns
+    -------
+    result: tvm.relay.Expr
+        The computed result, of shape `(b, m, dv)`.
+    """
+    return _make.fused_attention(query, key, value, scale)
+
+
+def weight_only_dense(data, weight, scales, bits=4, group_size=128, out_dtype=""):
+    r"""
+    Dense operator with float data and weights quantized to 4 or 8 bit integers.
+
+    .. math::
+
+        \mbox{weight_only_dense}(X, W)[i, j] = \sum_k X[i, k] W[j, k]
+        scales[j, k / group\_size]
+
+    Each group of `group_size` inputs of an output shares a scale. The weights are
+    dequantized inside the reduction, so only the packed weights are read from memory.
+    The `WeightOnlyQuantize` pass creates this op from dense with constant weights.
+
+    Parameters
+    ----------
+    data : tvm.relay.Expr
+        The input data, of shape `(d1, k)`.
+
+    weight : tvm.relay.Expr
+        The quantized weights. With 8 bits, int8 of shape `(units, k)`. With 4 bits, uint8
+        of shape `(units, k / 2)`, the weight of the input `i` being biased by 8 in the low
+        half of the byte `i / 2` when `i` is even, in the high half when `i` is odd.
+
+    scales : tvm.relay.Expr
+        The scales, of shape `(units, k / group_size)`.
+
+    bits : int
+        The number of bits of a weight, 4 or 8.
+
+    group_size : int
+        The number of inputs sharing a scale.
+
+    out_dtype : str, optional
+        Specifies the output data type, the one of the data by default.
+
+    Returns
+    -------
+    result : tvm.relay.Expr
+        The computed result, of shape `(d1, units)`.
+    """
+    return _make.weight_only_dense(data, weight, scales, bits, group_size, out_dtype)
+
+
 # pylint: disable=no-else-return,inconsistent-return-statements
 def sparse_dense(dense_mat, sparse_mat, sparse_lhs=False):
     r"""
@@ -324,6 +324,26 @@ def register_alter_op_layout(op_name, alter_layout=None, level=10):
     return tvm.ir.register_op_attr(op_name, "FTVMAlterOpLayout", alter_layout, level)
 
 
+def register_layout_candidates(op_name, layout_candidates=None, level=10):
+    """Register the function giving the layouts an op can be altered to, for the global
+    layout planning of the AlterOpLayout pass.
+
+    Parameters
+    ----------
+    op_name : str
+        The name of the operator
+
+    layout_candidates: function (attrs: Attrs, tinfos: List[Tensor], out_type: Type)
+                       -> candidates: List[Tuple[str, str, float]]
+        The function giving the data layout, the output layout and the estimated compute
+        cost of each candidate
+
+    level : int
+        The priority level
+    """
+    return tvm.ir.register_op_attr(op_name, "FTVMLayoutCandidates", layout_candidates, level)
+
+
 def register_convert_op_layout(op_name, convert_layout=None, level=10):
     """Register convert op layout function for an op
 
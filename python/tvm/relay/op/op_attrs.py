@@ -84,6 +84,16 @@ class BatchMatmulAttrs(Attrs):
     """Attributes for nn.batch_matmul"""
 
 
+@tvm._ffi.register_object("relay.attrs.FusedAttentionAttrs")
+class FusedAttentionAttrs(Attrs):
+    """Attributes for nn.fused_attention"""
+
+
+@tvm._ffi.register_object("relay.attrs.WeightOnlyDenseAttrs")
+class WeightOnlyDenseAttrs(Attrs):
+    """Attributes for nn.weight_only_dense"""
+
+
 @tvm._ffi.register_object("relay.attrs.SoftmaxAttrs")
 class SoftmaxAttrs(Attrs):
     """Attributes for nn.softmax"""
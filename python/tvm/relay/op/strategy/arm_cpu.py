@@ -22,6 +22,7 @@ import logging
 from tvm import relay, topi
 from ....target import arm_isa
 from ....topi.generic import conv2d as conv2d_generic
+from ....topi.generic import dense as dense_generic
 from .generic import *
 from .. import op as _op
 
@@ -453,6 +454,59 @@ def schedule_dense_arm_cpu(attrs, inputs, out_type, target):
             wrap_topi_schedule(topi.generic.schedule_dense),
             name="dense.generic",
         )
+    if (
+        inputs[0].dtype == inputs[1].dtype == out_type.dtype == "float32"
+        and topi.arm_cpu.arm_utils.is_aarch64_arm()
+        and topi.x86.is_dense_micro_kernel_applicable(out_type)
+    ):
+        strategy.add_implementation(
+            wrap_compute_dense(topi.x86.dense_pack_micro_kernel),
+            wrap_topi_schedule(topi.x86.schedule_dense_pack_micro_kernel),
+            name="dense_pack_micro_kernel.x86",
+            plevel=5,
+        )
+    if (
+        inputs[0].dtype == inputs[1].dtype == "int8"
+        and out_type.dtype == "int32"
+        and topi.arm_cpu.arm_utils.is_aarch64_arm()
+        and topi.arm_cpu.arm_utils.is_dotprod_available()
+        and dense_generic.is_dense_int8_packable(inputs[0].shape, inputs[1].shape, 4)
+    ):
+        strategy.add_implementation(
+            wrap_compute_dense(topi.arm_cpu.dense_int8),
+            wrap_topi_schedule(topi.arm_cpu.schedule_dense_int8),
+            name="dense_int8.arm_cpu",
+            plevel=15,
+        )
+    return strategy
+
+
+@dense_pack_strategy.register("arm_cpu")
+def dense_pack_strategy_arm_cpu(attrs, inputs, out_type, target):
+    """dense_pack arm cpu strategy"""
+    strategy = _op.OpStrategy()
+    if len(inputs[1].shape) == 4:
+        strategy.add_implementation(
+            wrap_compute_dense(topi.arm_cpu.dense_int8),
+            wrap_topi_schedule(topi.arm_cpu.schedule_dense_int8),
+            name="dense_int8.arm_cpu",
+        )
+    else:
+        strategy.add_implementation(
+            wrap_compute_dense(topi.x86.dense_pack),
+            wrap_topi_schedule(topi.x86.schedule_dense_pack),
+            name="dense_pack.x86",
+        )
+        if (
+            inputs[0].dtype == inputs[1].dtype == out_type.dtype == "float32"
+            and topi.x86.is_dense_micro_kernel_applicable(out_type, inputs[1].shape[-1])
+        ):
+            strategy.add_implementation(
+                wrap_compute_dense(topi.x86.dense_pack_micro_kernel),
+                wrap_topi_schedule(topi.x86.schedule_dense_pack_micro_kernel),
+                name="dense_pack_micro_kernel.x86",
+                plevel=8,
+            )
     return strategy
 
 
@@ -972,6 +972,30 @@ def scatter_nd_cuda(attrs, inputs, out_type, target):
     return strategy
 
 
+@fused_attention_strategy.register(["cuda", "gpu"])
+def fused_attention_strategy_cuda(attrs, inputs, out_type, target):
+    """fused_attention cuda strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_fused_attention(topi.cuda.fused_attention),
+        wrap_topi_schedule(topi.generic.schedule_extern),
+        name="fused_attention.cuda",
+    )
+    return strategy
+
+
+@weight_only_dense_strategy.register(["cuda", "gpu"])
+def weight_only_dense_strategy_cuda(attrs, inputs, out_type, target):
+    """weight_only_dense cuda strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_weight_only_dense(topi.nn.weight_only_dense),
+        wrap_topi_schedule(topi.cuda.schedule_weight_only_dense),
+        name="weight_only_dense.cuda",
+    )
+    return strategy
+
+
 @sort_strategy.register(["cuda", "gpu"])
 def sort_strategy_cuda(attrs, inputs, out_type, target):
     """sort cuda strategy"""
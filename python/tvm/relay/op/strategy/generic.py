@@ -848,6 +848,54 @@ def batch_matmul_strategy(attrs, inputs, out_type, target):
     return strategy
 
 
+# fused_attention
+def wrap_compute_fused_attention(topi_compute):
+    """wrap fused_attention topi compute"""
+
+    def _compute_fused_attention(attrs, inputs, out_type):
+        return [topi_compute(inputs[0], inputs[1], inputs[2], attrs.scale)]
+
+    return _compute_fused_attention
+
+
+@override_native_generic_func("fused_attention_strategy")
+def fused_attention_strategy(attrs, inputs, out_type, target):
+    """fused_attention generic strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_fused_attention(topi.nn.fused_attention),
+        wrap_topi_schedule(topi.generic.schedule_extern),
+        name="fused_attention.generic",
+    )
+    return strategy
+
+
+# weight_only_dense
+def wrap_compute_weight_only_dense(topi_compute):
+    """wrap weight_only_dense topi compute"""
+
+    def _compute_weight_only_dense(attrs, inputs, out_type):
+        return [
+            topi_compute(
+                inputs[0], inputs[1], inputs[2], attrs.bits, attrs.group_size, out_type.dtype
+            )
+        ]
+
+    return _compute_weight_only_dense
+
+
+@override_native_generic_func("weight_only_dense_strategy")
+def weight_only_dense_strategy(attrs, inputs, out_type, target):
+    """weight_only_dense generic strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_weight_only_dense(topi.nn.weight_only_dense),
+        wrap_topi_schedule(topi.generic.schedule_weight_only_dense),
+        name="weight_only_dense.generic",
+    )
+    return strategy
+
+
 # sparse dense
 def wrap_compute_sparse_dense(topi_compute):
     """wrap sparse dense topi compute"""
@@ -20,6 +20,7 @@ import logging
 
 import re
 from tvm import topi
+from tvm.topi.generic import dense as dense_generic
 from tvm.auto_scheduler import is_auto_scheduler_enabled
 from tvm.te import SpecializedCondition
 from tvm.relay.ty import is_dynamic
@@ -474,6 +475,27 @@ def dense_strategy_cpu(attrs, inputs, out_type, target):
         plevel=10,
     )
 
+    if same_type and dtype == "float32" and topi.x86.is_dense_micro_kernel_applicable(out_type):
+        strategy.add_implementation(
+            wrap_compute_dense(topi.x86.dense_pack_micro_kernel),
+            wrap_topi_schedule(topi.x86.schedule_dense_pack_micro_kernel),
+            name="dense_pack_micro_kernel.x86",
+            plevel=8,
+        )
+
+    if (
+        u8s8s32
+        and not is_auto_scheduler_enabled()
+        and topi.x86.is_int8_hw_support(inputs[0].dtype, inputs[1].dtype)
+        and dense_generic.is_dense_int8_packable(inputs[0].shape, inputs[1].shape, 16)
+    ):
+        strategy.add_implementation(
+            wrap_compute_dense(topi.x86.dense_vnni),
+            wrap_topi_schedule(topi.x86.schedule_dense_vnni),
+            name="dense_vnni.x86",
+            plevel=12,
+        )
+
     if is_auto_scheduler_enabled():
         strategy.add_implementation(
             wrap_compute_dense(topi.nn.dense, need_auto_scheduler_layout=True),
@@ -513,11 +535,28 @@ def dense_strategy_cpu(attrs, inputs, out_type, target):
 def dense_pack_strategy_cpu(attrs, inputs, out_type, target):
     """dense_pack x86 strategy"""
     strategy = _op.OpStrategy()
+    if len(inputs[1].shape) == 4:
+        strategy.add_implementation(
+            wrap_compute_dense(topi.x86.dense_vnni),
+            wrap_topi_schedule(topi.x86.schedule_dense_vnni),
+            name="dense_vnni.x86",
+        )
+        return strategy
     strategy.add_implementation(
         wrap_compute_dense(topi.x86.dense_pack),
         wrap_topi_schedule(topi.x86.schedule_dense_pack),
         name="dense_pack.x86",
     )
+    if (
+        inputs[0].dtype == inputs[1].dtype == out_type.dtype == "float32"
+        and topi.x86.is_dense_micro_kernel_applicable(out_type, inputs[1].shape[-1])
+    ):
+        strategy.add_implementation(
+            wrap_compute_dense(topi.x86.dense_pack_micro_kernel),
+            wrap_topi_schedule(topi.x86.schedule_dense_pack_micro_kernel),
+            name="dense_pack_micro_kernel.x86",
+            plevel=8,
+        )
     return strategy
 
 
@@ -558,6 +597,19 @@ def batch_matmul_strategy_cpu(attrs, inputs, out_type, target):
     return strategy
 
 
+@weight_only_dense_strategy.register("cpu")
+def weight_only_dense_strategy_cpu(attrs, inputs, out_type, target):
+    """weight_only_dense x86 strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_weight_only_dense(topi.nn.weight_only_dense),
+        wrap_topi_schedule(topi.x86.schedule_weight_only_dense),
+        name="weight_only_dense.x86",
+        plevel=10,
+    )
+    return strategy
+
+
 @sparse_dense_strategy.register("cpu")
 def sparse_dense_strategy_cpu(attrs, inputs, out_type, target):
     """sparse dense x86 strategy"""
@@ -19,6 +19,7 @@
 QNN pass transformation infrastructure.
 """
 from tvm import relay
+from . import _transform
 
 
 def CanonicalizeOps():
@@ -68,6 +69,31 @@ def CanonicalizeOps():
     return relay.transform.Legalize("FTVMQnnCanonicalize")
 
 
+def FoldRequantize():
+    """Merges the chains of QNN requantization ops with constant scalar quantization parameters,
+    so that each chain is lowered to a single fixed point multiply.
+
+    The rewrites are
+
+    .. code-block:: text
+
+        requantize(requantize(x, s1, z1, s2, z2), s2, z2, s3, z3) -> requantize(x, s1, z1, s3, z3)
+        quantize(dequantize(x, s1, z1), s2, z2) -> requantize(x, s1, z1, s2, z2)
+        dequantize(requantize(x, s1, z1, s2, z2, "int32"), s2, z2) -> dequantize(x, s1, z1)
+        requantize(x, s, z, s, z) -> x
+
+    A requantize to a narrow dtype is only merged when the clipping of the outer op implies its
+    own, so the chain only loses its intermediate rounding. The pass is meant to run after
+    FakeQuantizationToInteger, which leaves such chains between the rewritten regions.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass that folds the requantization chains.
+    """
+    return _transform.FoldRequantize()
+
+
 def Legalize():
     """Legalizes QNN ops. As opposed to Relay Legalize, this one legalizes only QNN ops. One can
     register a transformation/legalization function for an op by using the FTVMQnnLegalize attr_name
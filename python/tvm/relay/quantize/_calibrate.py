@@ -30,10 +30,9 @@ from .. import expr as _expr
 from .. import analysis as _analysis
 from .. import build_module as _build_module
 from ...contrib import graph_executor
-from .kl_divergence import _find_scale_by_kl
 
 
-def _get_profile_runtime(mod):
+def _get_profile_runtime(mod, num_runtimes=None):
     func = mod["main"]
     func = _quantize.CreateStatsCollector(func)
 
@@ -46,9 +45,9 @@ def _get_profile_runtime(mod):
 
     with tvm.transform.PassContext(opt_level=3):
         lib = _build_module.build(func, target=target)
-    runtime = graph_executor.GraphModule(lib["default"](dev))
-
-    return runtime
+    if num_runtimes is None:
+        return graph_executor.GraphModule(lib["default"](dev))
+    return [graph_executor.GraphModule(lib["default"](dev)) for _ in range(num_runtimes)]
 
 
 def collect_stats(mod, dataset, chunk_by=-1):
@@ -90,14 +89,70 @@ def collect_stats(mod, dataset, chunk_by=-1):
         yield [np.concatenate(output).reshape(-1) for output in outputs]
 
 
+def _get_batch_inputs(runtime, batch):
+    inputs = {}
+    for name, value in batch.items():
+        dtype = runtime.get_input(name).dtype
+        if isinstance(value, tvm.nd.NDArray) and value.dtype == dtype:
+            inputs[name] = value.copyto(tvm.cpu(0))
+        else:
+            value = value.numpy() if isinstance(value, tvm.nd.NDArray) else value
+            inputs[name] = tvm.nd.array(np.asarray(value).astype(dtype))
+    return inputs
+
+
+def stream_stats(mod, dataset, num_workers=1, num_bins=8001):
+    """Run the profile graph of an annotated graph on the calibration dataset and accumulate
+    the histogram of every profiled layer, without holding the outputs of the layers.
+
+    The dataset is run twice: once for the range of every layer, once to fill its
+    histogram. The histograms equal the ones np.histogram computes on the outputs
+    concatenated by collect_stats.
+
+    Parameters
+    ----------
+    mod: Module
+        The simulation graph after annotation.
+
+    dataset: Iterable[NDArray]
+        The calibration dataset. An iterator is read once and its batches kept.
+
+    num_workers: optional, int
+        The number of graph executors running the batches concurrently, -1 for one per core.
+
+    num_bins: optional, int
+        The number of bins of the histograms.
+
+    Returns
+    -------
+    ret: CalibrationStats
+        The statistics of the profiled layers.
+    """
+    logging.info("streaming statistics for calibration...")
+    if num_workers == -1:
+        num_workers = mp.cpu_count()
+    runtimes = _get_profile_runtime(mod, max(num_workers, 1))
+    if iter(dataset) is dataset:
+        dataset = list(dataset)
+    stats = _quantize.CalibrationStats(runtimes[0].get_num_outputs(), num_bins)
+    modules = [runtime.module for runtime in runtimes]
+    for histogram in [False, True]:
+        batches = []
+        for batch in dataset:
+            batches.append(_get_batch_inputs(runtimes[0], batch))
+            if len(batches) == len(runtimes):
+                _quantize.RunCalibrationBatches(modules, batches, stats, histogram)
+                batches = []
+        if batches:
+            _quantize.RunCalibrationBatches(modules, batches, stats, histogram)
+    return stats
+
+
 def _kl_scale(mod, dataset):
     cfg = quantize.current_qconfig()
-    chunk_by = cfg.calibrate_chunk_by
-    scales = []
-    for samples in collect_stats(mod, dataset, chunk_by):
-        logging.info("finding threshold with kl for calibration...")
-        with mp.Pool() as pool:
-            scales += list(pool.map(_find_scale_by_kl, samples))
+    stats = stream_stats(mod, dataset, cfg.calibrate_num_workers)
+    logging.info("finding threshold with kl for calibration...")
+    scales = [scale.value for scale in _quantize.CalibrationStatsFindScales(stats, 255)]
 
     def func(_):
         scale = scales[func.scale_idx]
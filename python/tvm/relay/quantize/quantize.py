@@ -86,6 +86,7 @@ class QConfig(Object):
         "debug_enabled_ops": None,
         "rounding": "UPWARD",
         "calibrate_chunk_by": -1,
+        "calibrate_num_workers": 1,
         "partition_conversions": "disabled",
     }
 
@@ -180,6 +181,15 @@ def qconfig(**kwargs):
     rounding: "UPWARD" or "TONEAREST"
         Rounding direction for fixed point multiplications.
 
+    calibrate_chunk_by: int
+        The number of layers whose outputs are collected at a time by the percentile
+        calibration, -1 for all of them. The kl_divergence calibration streams the outputs
+        into histograms and does not need it.
+
+    calibrate_num_workers: int
+        The number of graph executors running the calibration batches concurrently. The
+        cores of the thread pool are shared among them, -1 uses one executor per core.
+
     partition_conversions: 'disabled', 'enabled', or 'fully_integral'
         If set to 'enabled' or 'fully_integral', partitions a quantized
         result into a module containing
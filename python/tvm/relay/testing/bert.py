@@ -0,0 +1,194 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""
+A BERT encoder with random weights.
+
+Reference:
+Devlin, Jacob, et al. "BERT: Pre-training of Deep Bidirectional Transformers for Language
+Understanding." arXiv preprint arXiv:1810.04805 (2018).
+"""
+import math
+
+from tvm import relay
+from .init import create_workload
+
+
+def _dense(data, units, name):
+    out = relay.nn.dense(data, relay.var(name + "_weight"), units=units)
+    return relay.nn.bias_add(out, relay.var(name + "_bias"), axis=-1)
+
+
+def _layer_norm(data, name):
+    return relay.nn.layer_norm(
+        data, relay.var(name + "_gamma"), relay.var(name + "_beta"), axis=-1, epsilon=1e-12
+    )
+
+
+def _gelu(data, dtype):
+    half = relay.const(0.5, dtype)
+    return data * (half + half * relay.erf(data / relay.const(math.sqrt(2), dtype)))
+
+
+def _split_heads(data, batch_size, seq_len, num_heads, head_size):
+    data = relay.reshape(data, (batch_size, seq_len, num_heads, head_size))
+    data = relay.transpose(data, (0, 2, 1, 3))
+    return relay.reshape(data, (batch_size * num_heads, seq_len, head_size))
+
+
+def encoder_layer(data, batch_size, seq_len, hidden_size, num_heads, name, dtype="float32"):
+    """A transformer encoder layer, the self attention followed by the feed forward network.
+
+    Parameters
+    ----------
+    data : relay.Expr
+        The input of shape (batch_size * seq_len, hidden_size).
+
+    batch_size : int
+        The batch size.
+
+    seq_len : int
+        The sequence length.
+
+    hidden_size : int
+        The hidden size.
+
+    num_heads : int
+        The number of attention heads.
+
+    name : str
+        The prefix of the weights.
+
+    dtype : str, optional
+        The data type
+
+    Returns
+    -------
+    out : relay.Expr
+        The output of shape (batch_size * seq_len, hidden_size).
+    """
+    head_size = hidden_size // num_heads
+    shape = (batch_size, seq_len, num_heads, head_size)
+    query = _split_heads(_dense(data, hidden_size, name + "_query"), *shape)
+    key = _split_heads(_dense(data, hidden_size, name + "_key"), *shape)
+    value = _split_heads(_dense(data, hidden_size, name + "_value"), *shape)
+    scores = relay.nn.batch_matmul(query, key) / relay.const(math.sqrt(head_size), dtype)
+    probs = relay.nn.softmax(scores, axis=-1)
+    context = relay.nn.batch_matmul(probs, value, transpose_b=False)
+    context = relay.reshape(context, (batch_size, num_heads, seq_len, head_size))
+    context = relay.transpose(context, (0, 2, 1, 3))
+    context = relay.reshape(context, (batch_size * seq_len, hidden_size))
+    attention = _layer_norm(_dense(context, hidden_size, name + "_output") + data, name + "_ln1")
+    ffn = _gelu(_dense(attention, 4 * hidden_size, name + "_ffn1"), dtype)
+    ffn = _dense(ffn, hidden_size, name + "_ffn2")
+    return _layer_norm(ffn + attention, name + "_ln2")
+
+
+def get_net(
+    batch_size,
+    seq_len=128,
+    num_layers=12,
+    hidden_size=768,
+    num_heads=12,
+    vocab_size=30522,
+    dtype="float32",
+):
+    """Get a BERT encoder, returning the pooled output of its first token.
+
+    Parameters
+    ----------
+    batch_size : int
+        The batch size used in the model
+
+    seq_len : int, optional
+        The sequence length
+
+    num_layers : int, optional
+        The number of encoder layers, 12 in BERT base and 24 in BERT large
+
+    hidden_size : int, optional
+        The hidden size, 768 in BERT base and 1024 in BERT large
+
+    num_heads : int, optional
+        The number of attention heads, 12 in BERT base and 16 in BERT large
+
+    vocab_size : int, optional
+        The vocabulary size
+
+    dtype : str, optional
+        The data type
+
+    Returns
+    -------
+    net : relay.Function
+        The dataflow.
+    """
+    data = relay.var("data", shape=(batch_size, seq_len), dtype="int32")
+    word_embed = relay.var("word_embed_weight", shape=(vocab_size, hidden_size), dtype=dtype)
+    position_embed = relay.var("position_embed_weight", shape=(seq_len, hidden_size), dtype=dtype)
+    embed = relay.take(word_embed, data, axis=0) + position_embed
+    out = _layer_norm(relay.reshape(embed, (batch_size * seq_len, hidden_size)), "embed_ln")
+    for i in range(num_layers):
+        out = encoder_layer(out, batch_size, seq_len, hidden_size, num_heads, "layer%d" % i, dtype)
+    first_token = relay.take(relay.reshape(out, (batch_size, seq_len, hidden_size)), 0, axis=1)
+    pooled = relay.tanh(_dense(first_token, hidden_size, "pooler"))
+    return relay.Function(relay.analysis.free_vars(pooled), pooled)
+
+
+def get_workload(
+    batch_size=1,
+    seq_len=128,
+    num_layers=12,
+    hidden_size=768,
+    num_heads=12,
+    vocab_size=30522,
+    dtype="float32",
+):
+    """Get benchmark workload for a BERT encoder.
+
+    Parameters
+    ----------
+    batch_size : int, optional
+        The batch size used in the model
+
+    seq_len : int, optional
+        The sequence length
+
+    num_layers : int, optional
+        The number of encoder layers
+
+    hidden_size : int, optional
+        The hidden size
+
+    num_heads : int, optional
+        The number of attention heads
+
+    vocab_size : int, optional
+        The vocabulary size
+
+    dtype : str, optional
+        The data type
+
+    Returns
+    -------
+    mod : tvm.IRModule
+        The relay module that contains a BERT encoder.
+
+    params : dict of str to NDArray
+        The parameters.
+    """
+    net = get_net(batch_size, seq_len, num_layers, hidden_size, num_heads, vocab_size, dtype)
+    return create_workload(net)
@@ -19,4 +19,6 @@
 # transformation passes
 from .transform import *
 from .recast import recast
+from .flexible_shape import FlexibleShapeDispatch
+from .weight_only_quantize import WeightOnlyQuantize
 from . import fake_quantization_to_integer, mixed_precision
@@ -197,6 +197,11 @@ def concat(expr, type_map):
 
     out_type = type_map[expr]
 
+    # Inputs sharing their quantization are concatenated as is, leaving a single requantize, if
+    # any, to the quantize of the region.
+    if all(tvm.ir.structural_equal(t, tuple_type.types[0]) for t in tuple_type.types):
+        return [relay.op.concatenate(expr.args[0], **expr.attrs), tuple_type.types[0]]
+
     out = relay.qnn.op.concatenate(
         expr.args[0],
         relay.Tuple(scales),
@@ -208,6 +213,44 @@ def concat(expr, type_map):
     return [out, out_type]
 
 
+def float_fallback(expr, type_map, out_t):
+    """Run an op without an integer lowering in float, between a dequantize of its first
+    argument and a quantize of its result, so that the rest of the region still gets rewritten
+    to integer ops. The other arguments are kept as they are."""
+    arg = expr.args[0]
+    t = type_map[arg]
+    arg = relay.qnn.op.dequantize(arg, t.scale, t.zero_point, axis=t.axis)
+    out = relay.Call(expr.op, [arg] + list(expr.args[1:]), expr.attrs)
+    out = relay.qnn.op.quantize(out, out_t.scale, out_t.zero_point, out_t.axis, out_t.dtype)
+    return [out, out_t]
+
+
+@register_fake_quantization_to_integer("nn.softmax")
+def softmax(expr, type_map):
+    """Rewrite a softmax op, quantizing its [0, 1] result with a 1 / 256 scale"""
+    t = type_map[expr.args[0]]
+    zero_point = -128 if t.dtype == "int8" else 0
+    out_t = TensorAffineType(
+        relay.const(1.0 / 256, "float32"), relay.const(zero_point, "int32"), t.dtype, -1
+    )
+    return float_fallback(expr, type_map, out_t)
+
+
+@register_fake_quantization_to_integer("nn.layer_norm")
+def layer_norm(expr, type_map):
+    """Rewrite a layer_norm op, quantizing its result like the output of the region"""
+    return float_fallback(expr, type_map, type_map[expr])
+
+
+@register_fake_quantization_to_integer("image.resize2d")
+def resize2d(expr, type_map):
+    """Rewrite a resize2d op, which keeps the quantization of its input"""
+    t = type_map[expr.args[0]]
+    if expr.attrs.method == "nearest_neighbor":
+        return [expr, t]
+    return float_fallback(expr, type_map, t)
+
+
 @register_fake_quantization_to_integer("split")
 def split(expr, type_map):
     """Rewrite a split op"""
@@ -0,0 +1,167 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Compile specialized versions of a function for a set of shape buckets of a dynamic axis,
+and dispatch to them at runtime from the shape of the inputs."""
+import numpy as np
+
+import tvm
+from tvm import relay
+from . import transform as _transform
+
+
+def _specialize(mod, func, axis, bucket, input_indices):
+    """Copy a function with the dynamic axis of some inputs set to a bucket, and propagate
+    the static shapes so the kernels are compiled for them."""
+    new_params = []
+    for i, param in enumerate(func.params):
+        if i in input_indices:
+            ttype = param.checked_type
+            shape = list(ttype.shape)
+            shape[axis] = bucket
+            new_params.append(relay.var(param.name_hint, shape=shape, dtype=ttype.dtype))
+        else:
+            new_params.append(relay.var(param.name_hint, param.checked_type))
+    body = relay.bind(func.body, dict(zip(func.params, new_params)))
+    functions = {gv: f for gv, f in mod.functions.items() if gv.name_hint != "main"}
+    bucket_mod = tvm.IRModule.from_expr(
+        relay.Function(new_params, body), functions=functions, type_defs=mod.type_definitions
+    )
+    bucket_mod = _transform.InferType()(bucket_mod)
+    bucket_mod = _transform.DynamicToStatic()(bucket_mod)
+    return bucket_mod["main"]
+
+
+def _concat_dims(before, dim, after):
+    """Concatenate the static dims before and after a dynamic one into a shape tensor."""
+    parts = [relay.const(np.array(before, "int64"))] if before else []
+    parts.append(relay.reshape(dim, [1]))
+    if after:
+        parts.append(relay.const(np.array(after, "int64")))
+    return relay.concatenate(parts, axis=0)
+
+
+def _pad_to(data, dim, axis, bucket, pad_value):
+    """Pad a tensor along an axis from its dynamic length dim to the bucket length."""
+    rank = len(data.type_annotation.shape)
+    pad_width = _concat_dims(
+        [0] * (2 * axis + 1), relay.const(bucket, "int64") - dim, [0] * (2 * (rank - axis - 1))
+    )
+    pad_width = relay.reshape(pad_width, [rank, 2])
+    return relay.nn.pad(data, pad_width, pad_value)
+
+
+def _slice_to(data, ttype, dim, axis):
+    """Slice the outputs of a bucket back to the dynamic length dim along an axis."""
+    if isinstance(ttype, relay.TupleType):
+        return relay.Tuple(
+            [
+                _slice_to(relay.TupleGetItem(data, i), field, dim, axis)
+                for i, field in enumerate(ttype.fields)
+            ]
+        )
+    if not isinstance(ttype, relay.TensorType) or len(ttype.shape) <= axis:
+        return data
+    shape = [int(s) for s in ttype.shape]
+    begin = relay.const(np.zeros(len(shape), "int64"))
+    return relay.strided_slice(data, begin, _concat_dims(shape[:axis], dim, shape[axis + 1 :]))
+
+
+@tvm.transform.module_pass(opt_level=0, name="FlexibleShapeDispatch")
+class FlexibleShapeDispatch:
+    """Specialize the main function for a set of shape buckets of a dynamic axis.
+
+    Each bucket gets a copy of main with static input shapes, so its kernels are vectorized
+    and tiled like in a static build, and the original main is kept as the generic fallback.
+    The new main looks up the length of the axis in the first dispatched input and calls the
+    matching version, which the VM does at runtime.
+
+    Parameters
+    ----------
+    buckets: List[int]
+        The lengths of the axis to specialize for.
+
+    axis: int
+        The dynamic axis of the dispatched inputs.
+
+    auto_pad: bool
+        Pad the inputs to the smallest bucket holding them instead of only dispatching the
+        exact lengths. The padded data must not change the result of the other positions,
+        e.g. padded tokens masked out by an attention mask.
+
+    pad_value: float
+        The value the inputs are padded with.
+
+    input_indices: Optional[List[int]]
+        The indices of the inputs having the dynamic axis, the first one by default.
+
+    affects_output: bool
+        Whether the outputs have the dynamic axis too, then sliced back to the input length
+        when padding.
+    """
+
+    def __init__(
+        self,
+        buckets,
+        axis=0,
+        auto_pad=False,
+        pad_value=0,
+        input_indices=None,
+        affects_output=True,
+    ):
+        self.buckets = sorted(buckets)
+        self.axis = axis
+        self.auto_pad = auto_pad
+        self.pad_value = pad_value
+        self.input_indices = input_indices if input_indices is not None else [0]
+        self.affects_output = affects_output
+
+    def transform_module(self, mod, ctx):
+        """Add the versions of main and the dispatching main to the module."""
+        mod = _transform.InferType()(mod)
+        main = mod["main"]
+        generic = relay.GlobalVar("main_generic")
+        mod[generic] = main
+        mod = _transform.InferType()(mod)
+        bucket_vars = []
+        for bucket in self.buckets:
+            bucket_var = relay.GlobalVar("main_bucket_%d" % bucket)
+            mod[bucket_var] = _specialize(mod, main, self.axis, bucket, self.input_indices)
+            bucket_vars.append(bucket_var)
+        mod = _transform.InferType()(mod)
+
+        params = [relay.var(p.name_hint, p.checked_type) for p in main.params]
+        shape = relay.shape_of(params[self.input_indices[0]], dtype="int64")
+        dim = relay.take(shape, relay.const(self.axis, "int64"))
+        body = relay.Call(generic, params)
+        for bucket, bucket_var in reversed(list(zip(self.buckets, bucket_vars))):
+            if self.auto_pad:
+                cond = relay.less_equal(dim, relay.const(bucket, "int64"))
+                args = [
+                    _pad_to(p, dim, self.axis, bucket, self.pad_value)
+                    if i in self.input_indices
+                    else p
+                    for i, p in enumerate(params)
+                ]
+                call = relay.Call(bucket_var, args)
+                if self.affects_output:
+                    call = _slice_to(call, mod[bucket_var].checked_type.ret_type, dim, self.axis)
+            else:
+                cond = relay.equal(dim, relay.const(bucket, "int64"))
+                call = relay.Call(bucket_var, params)
+            body = relay.If(cond, call, body)
+        mod["main"] = relay.Function(params, body)
+        return _transform.InferType()(mod)
@@ -152,6 +152,23 @@ def RemoveUnusedFunctions(entry_functions=None):
     return _ffi_api.RemoveUnusedFunctions(entry_functions)
 
 
+def PlanStaticStorage():
+    """Share the statically sized storages allocated by the memory manifestation of the VM.
+
+    Within each block of let bindings, the storages of a constant size with disjoint lifetimes
+    are backed by the same storage, allocated once at the start of the block. The VM compiler
+    runs this pass when the "relay.vm.plan_static_storage" option is set. With the
+    "relay.vm.plan_static_storage.in_place" option, the result of an elementwise primitive may
+    also overwrite the storage of an argument which is not used after the call.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass sharing the static storages.
+    """
+    return _ffi_api.PlanStaticStorage()
+
+
 def ForwardFoldScaleAxis():
     """Fold the scaling of axis into weights of conv2d/dense.
 
@@ -413,6 +430,12 @@ def AlterOpLayout():
     This pass can be used for computing convolution in custom layouts or
     other general weight pre-transformation.
 
+    With the PassContext config relay.AlterOpLayout.plan_layouts, the layouts of the ops
+    registering layout candidates are planned over the whole graph first, minimizing their
+    estimated compute cost plus the cost of the layout transforms between them. Each layout
+    transform costs relay.AlterOpLayout.layout_transform_cost (8 by default) per element.
+    The alter layout functions read the planned candidate with planned_layout_candidate.
+
     Returns
     -------
     ret : tvm.transform.Pass
@@ -421,6 +444,18 @@ def AlterOpLayout():
     return _ffi_api.AlterOpLayout()
 
 
+def planned_layout_candidate():
+    """Get the layout candidate planned for the op being altered by AlterOpLayout.
+
+    Returns
+    -------
+    candidate : Optional[Array]
+        The (data layout, output layout, cost) candidate, None when the layouts are not
+        planned or the op has no candidates.
+    """
+    return _ffi_api.AlterOpLayoutPlannedCandidate()
+
+
 class LayoutConfig(object):
     """A structure for customizing the ConvertLayout pass."""
 
@@ -639,10 +674,14 @@ def ToGraphNormalForm():
 def EliminateCommonSubexpr(fskip=None):
     """Eliminate common subexpressions.
 
+    The constants holding the same data and the identical primitive functions are shared across
+    the functions of the module, a let binding of a value already bound in scope is dropped, and
+    the calls of a global function identical to another one go to that one.
+
     Parameters
     ----------
     fskip: Callable
-        The callback function that decides whether an expression should be
+        The callback function that decides whether an operator call should be
         skipped.
 
     Returns
@@ -708,6 +747,22 @@ def PartitionGraph(mod_name="default"):
     return _ffi_api.PartitionGraph(mod_name)
 
 
+def FuseBoundaryOps():
+    """Move the injective ops left between the external functions of a partitioned Relay program
+    into the external function they feed or are fed by, saving their TVM kernels and the memory
+    round trips of their tensors. An op is moved when the codegen of the function supports it,
+    through the "target.<compiler>" op attribute or a composite function of its patterns named
+    "<compiler>.*". The function must be called once, and the op must be the only user of the
+    tensors passed between them.
+
+    Returns
+    -------
+    ret: tvm.transform.Pass
+        The registered pass that fuses the ops at the boundaries of the external functions.
+    """
+    return _ffi_api.FuseBoundaryOps()
+
+
 def AnnotateTarget(targets, include_non_call_ops=True):
     """Annotate ops in an experession with a provied compiler/target and then
     use it for codegen.
@@ -1149,6 +1204,26 @@ def SimplifyExpr():
     return _ffi_api.SimplifyExpr()
 
 
+def AutoCheckpoint(budget_bytes):
+    """
+    Wrap segments of the functions in annotation.checkpoint for a memory budget, so their
+    reverse mode gradient recomputes the activations of a segment instead of storing them.
+    The functions are converted to A-normal form.
+
+    Parameters
+    ----------
+    budget_bytes : int
+        The bytes of the activations the gradient may keep alive at once. The functions whose
+        activations fit are left unchanged.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered AutoCheckpoint pass.
+    """
+    return _ffi_api.AutoCheckpoint(budget_bytes)
+
+
 def PlanDevices(config):
     """
     Uses existing "on_device" and "device_copy" CallNodes to infer the SEScope on which
@@ -1244,6 +1319,20 @@ def ToMixedPrecision(mixed_precision_type="float16", missing_op_mode=1):
         1: Allow missing ops but emit warnings.
         2: Allow missing ops and silently ignore them.
 
+    The pass reads the following PassContext configs:
+
+    relay.ToMixedPrecision.minimize_casts: bool
+      Place the ops following the precision of their inputs so that the graph casts the
+      fewest elements, rather than from their inputs alone.
+
+    relay.ToMixedPrecision.sensitivity: Dict[str, float]
+      The sensitivity scores of the layers, found e.g. by profiling the accuracy loss of
+      running each one in mixed_precision_type. The keys are op names, covering every call
+      of the op, or "<op name>:<index>", the index-th call of the op in post-order.
+
+    relay.ToMixedPrecision.max_sensitivity: float
+      The layers whose sensitivity score exceeds it stay in float32, 0 by default.
+
     Returns
     -------
     ret : tvm.transform.Pass
@@ -27,5 +27,6 @@ upload and run remote RPC server, get the result back to verify correctness.
 
 from .server import Server
 from .client import connect, connect_tracker
-from .client import RPCSession, LocalSession, PopenSession, TrackerSession
+from .client import RPCSession, LocalSession, PopenSession, ShmSession, TrackerSession
+from .client import SessionPool
 from .minrpc import with_minrpc
@@ -15,10 +15,13 @@
 # specific language governing permissions and limitations
 # under the License.
 """RPC client tools"""
+import contextlib
+import hashlib
 import os
 import stat
 import socket
 import struct
+import sys
 import time
 
 import tvm._ffi
@@ -72,6 +75,44 @@ class RPCSession(object):
         """
         return self._sess.get_function(name)
 
+    def get_async_function(self, name, mod=None):
+        """Get a function whose calls do not wait for the remote.
+
+        Calling the function sends the call and returns right away, so that several calls
+        and copies are in flight when the server queues requests. The calls complete in order.
+
+        Parameters
+        ----------
+        name : str
+            The name of the function
+
+        mod : runtime.Module, optional
+            The remote module to get the function from, the global functions by default.
+
+        Returns
+        -------
+        f : Function
+            The result function, each call returns a function that waits for the call
+            and returns its return value.
+        """
+        return _ffi_api.GetAsyncFunction(self._sess if mod is None else mod, name)
+
+    def set_transfer_options(self, chunk_size=0, compression=None):
+        """Set how the tensor copies of the session are sent.
+
+        Parameters
+        ----------
+        chunk_size : int, optional
+            The maximum number of bytes sent in one request, the largest size the server
+            accepts by default. Smaller chunks let the other requests through during large
+            copies, and overlap the compression of a chunk with the transfer of the previous one.
+
+        compression : str, optional
+            The codec compressing the copies, "zero_rle" replaces the runs of zero bytes by
+            their length. No compression by default, or when the server does not support it.
+        """
+        _ffi_api.SessSetTransferOptions(self._sess, chunk_size, compression or "")
+
     def device(self, dev_type, dev_id=0):
         """Construct a remote device.
 
@@ -92,7 +133,7 @@ class RPCSession(object):
         dev._rpc_sess = self
         return dev
 
-    def upload(self, data, target=None):
+    def upload(self, data, target=None, use_cache=True):
         """Upload file to remote runtime temp folder
 
         Parameters
@@ -102,6 +143,11 @@ class RPCSession(object):
 
         target : str, optional
             The path in remote
+
+        use_cache : bool, optional
+            Whether to reuse the file when the server got the same content in a previous
+            session, in which case only its digest is sent. Ignored by the servers not
+            caching the uploads.
         """
         if isinstance(data, bytearray):
             if not target:
@@ -112,9 +158,64 @@ class RPCSession(object):
             if not target:
                 target = os.path.basename(data)
 
+        digest = hashlib.sha256(blob).hexdigest() if use_cache else None
+        if digest and self._get_optional_function("tvm.rpc.server.load_cached_upload"):
+            if self._remote_funcs["tvm.rpc.server.load_cached_upload"](target, digest):
+                return
+
         if "upload" not in self._remote_funcs:
             self._remote_funcs["upload"] = self.get_function("tvm.rpc.server.upload")
         self._remote_funcs["upload"](target, blob)
+        if digest and self._get_optional_function("tvm.rpc.server.cache_upload"):
+            self._remote_funcs["tvm.rpc.server.cache_upload"](target, digest)
+
+    def upload_and_load(self, data, target=None):
+        """Upload a module and load it, writing it to the remote storage only when needed.
+
+        A module the server cached in a previous session is not sent again. Otherwise a
+        shared library is loaded from memory when the server supports it, and the other
+        modules are uploaded to the remote temp folder.
+
+        Parameters
+        ----------
+        data : str or bytearray
+            The file name or binary of the module.
+
+        target : str, optional
+            The path in remote
+
+        Returns
+        -------
+        m : Module
+            The remote module containing remote function.
+        """
+        if isinstance(data, bytearray):
+            if not target:
+                raise ValueError("target must present when file is a bytearray")
+            blob = data
+        else:
+            blob = bytearray(open(data, "rb").read())
+            if not target:
+                target = os.path.basename(data)
+
+        if self._get_optional_function("tvm.rpc.server.load_cached_upload"):
+            digest = hashlib.sha256(blob).hexdigest()
+            if self._remote_funcs["tvm.rpc.server.load_cached_upload"](target, digest):
+                return self.load_module(target)
+        load_from_memory = self._get_optional_function("tvm.rpc.server.load_module_from_memory")
+        if target.endswith(".so") and load_from_memory:
+            return load_from_memory(target, blob)
+        self.upload(blob, target)
+        return self.load_module(target)
+
+    def _get_optional_function(self, name):
+        """Get a remote function, None when the server does not have it."""
+        if name not in self._remote_funcs:
+            try:
+                self._remote_funcs[name] = self.get_function(name)
+            except (AttributeError, TVMError):
+                self._remote_funcs[name] = None
+        return self._remote_funcs[name]
 
     def download(self, path):
         """Download file from remote temp folder.
@@ -280,6 +381,21 @@ class PopenSession(RPCSession):
         RPCSession.__init__(self, _popen_session(binary))
 
 
+class ShmSession(RPCSession):
+    """RPCSession to a server process started on this host, connected by shared memory.
+
+    The requests and the tensors go through rings in shared memory instead of a socket,
+    which saves the system calls and the kernel copies of local measurements.
+    Only available on Linux.
+    """
+
+    def __init__(self):
+        create_client = tvm._ffi.get_global_func("rpc.CreateShmClient", allow_missing=True)
+        if create_client is None:
+            raise RuntimeError("Shared memory sessions are only supported on Linux")
+        RPCSession.__init__(self, create_client(sys.executable, "-m", "tvm.exec.rpc_shm_server"))
+
+
 class TrackerSession(object):
     """Tracker client session.
 
@@ -418,6 +534,31 @@ class TrackerSession(object):
             "Cannot request %s after %d retry, last_error:%s" % (key, max_retry, str(last_err))
         )
 
+    def session_pool(self, key, priority=1, idle_timeout=60, session_constructor_args=None):
+        """Create a pool keeping the sessions of a device key alive between the uses.
+
+        Parameters
+        ----------
+        key : str
+            The type key of the device.
+
+        priority : int, optional
+            The priority of the requests.
+
+        idle_timeout : float, optional
+            The number of seconds after which an unused session is closed, so that the
+            device goes back to the tracker.
+
+        session_constructor_args : list, optional
+            List of additional arguments to passed as the remote session constructor.
+
+        Returns
+        -------
+        pool : SessionPool
+            The session pool.
+        """
+        return SessionPool(self, key, priority, idle_timeout, session_constructor_args)
+
     def request_and_run(self, key, func, priority=1, session_timeout=0, max_retry=2):
         """Request a resource from tracker and run the func.
 
@@ -460,6 +601,81 @@ class TrackerSession(object):
         )
 
 
+class SessionPool(object):
+    """Sessions of one device key, reused instead of requesting a device for each use.
+
+    Reusing a session saves the connection to the tracker and the server, and the upload of
+    the files already in the remote temp folder. Do not directly create the object, call
+    TrackerSession.session_pool.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        pool = tracker.session_pool("rasp4b")
+        for batch in batches:
+            with pool.session() as remote:
+                measure(remote, batch)
+    """
+
+    def __init__(self, tracker, key, priority, idle_timeout, session_constructor_args):
+        self._tracker = tracker
+        self._key = key
+        self._priority = priority
+        self._idle_timeout = idle_timeout
+        self._session_constructor_args = session_constructor_args
+        # the idle sessions and the time they were released
+        self._idle = []
+
+    def acquire(self):
+        """Get an idle session, or request a new one from the tracker.
+
+        Returns
+        -------
+        sess : RPCSession
+            The session, to be given back with release.
+        """
+        now = time.time()
+        while self._idle:
+            sess, released = self._idle.pop()
+            if now - released > self._idle_timeout:
+                continue
+            try:
+                # a round trip, failing when the server went away
+                sess.get_function("tvm.rpc.server.upload")
+                return sess
+            except TVMError:
+                continue
+        return self._tracker.request(
+            self._key,
+            priority=self._priority,
+            session_constructor_args=self._session_constructor_args,
+        )
+
+    def release(self, sess):
+        """Give back a session for the next uses.
+
+        Parameters
+        ----------
+        sess : RPCSession
+            The session returned by acquire.
+        """
+        now = time.time()
+        self._idle = [item for item in self._idle if now - item[1] <= self._idle_timeout]
+        self._idle.append((sess, now))
+
+    @contextlib.contextmanager
+    def session(self):
+        """Use a session of the pool, dropped instead of reused when the use fails."""
+        sess = self.acquire()
+        yield sess
+        self.release(sess)
+
+    def close(self):
+        """Close the idle sessions."""
+        self._idle = []
+
+
 def connect(url, port, key="", session_timeout=0, session_constructor_args=None):
     """Connect to RPC Server
 
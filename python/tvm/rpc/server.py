@@ -27,6 +27,7 @@ Server is TCP based with the following protocol:
 # pylint: disable=invalid-name
 import os
 import ctypes
+import shutil
 import socket
 import select
 import struct
@@ -51,14 +52,60 @@ from .base import TrackerCode
 
 logger = logging.getLogger("RPCServer")
 
+# The number of uploaded files kept by a server across its sessions
+_MAX_CACHED_UPLOADS = 32
 
-def _server_env(load_library, work_path=None):
+
+def _is_upload_digest(digest):
+    return len(digest) == 64 and all(c in "0123456789abcdef" for c in digest)
+
+
+def _register_upload_cache(temp, cache_path):
+    """Register the functions reusing the files uploaded in the previous sessions.
+
+    The files are stored in cache_path by the sha256 of their content, so a client uploading
+    the same module or data again only sends its digest.
+    """
+
+    # pylint: disable=unused-variable
+    @tvm._ffi.register_func("tvm.rpc.server.load_cached_upload", override=True)
+    def load_cached_upload(file_name, digest):
+        """Copy a cached file to file_name, returns whether it was in the cache."""
+        cached = os.path.join(cache_path, digest)
+        if not _is_upload_digest(digest) or not os.path.exists(cached):
+            return False
+        shutil.copyfile(cached, temp.relpath(file_name))
+        # the most recently used files are kept
+        os.utime(cached)
+        logger.info("upload %s from the cache", file_name)
+        return True
+
+    @tvm._ffi.register_func("tvm.rpc.server.cache_upload", override=True)
+    def cache_upload(file_name, digest):
+        """Add an uploaded file to the cache."""
+        if not _is_upload_digest(digest):
+            return
+        staged = os.path.join(cache_path, digest + ".tmp")
+        shutil.copyfile(temp.relpath(file_name), staged)
+        os.replace(staged, os.path.join(cache_path, digest))
+        cached = sorted(
+            (os.path.join(cache_path, name) for name in os.listdir(cache_path)),
+            key=os.path.getmtime,
+        )
+        for path in cached[: max(0, len(cached) - _MAX_CACHED_UPLOADS)]:
+            os.remove(path)
+
+
+def _server_env(load_library, work_path=None, cache_path=None):
     """Server environment function return temp dir"""
     if work_path:
         temp = work_path
     else:
         temp = utils.tempdir()
 
+    if cache_path:
+        _register_upload_cache(temp, cache_path)
+
     # pylint: disable=unused-variable
     @tvm._ffi.register_func("tvm.rpc.server.workpath", override=True)
     def get_workpath(path):
@@ -113,10 +160,10 @@ def _server_env(load_library, work_path=None):
     return temp
 
 
-def _serve_loop(sock, addr, load_library, work_path=None):
+def _serve_loop(sock, addr, load_library, work_path=None, cache_path=None):
     """Server loop"""
     sockfd = sock.fileno()
-    temp = _server_env(load_library, work_path)
+    temp = _server_env(load_library, work_path, cache_path)
     _ffi_api.ServerLoop(sockfd)
     if not work_path:
         temp.remove()
@@ -206,6 +253,8 @@ def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr):
 
     # Server logic
     tracker_conn = None
+    # the uploads are cached across the sessions, which run in their own work path
+    upload_cache = utils.tempdir()
     while True:
         try:
             # step 1: setup tracker and report to tracker
@@ -235,7 +284,8 @@ def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr):
         work_path = utils.tempdir()
         logger.info("connection from %s", addr)
         server_proc = multiprocessing.Process(
-            target=_serve_loop, args=(conn, addr, load_library, work_path)
+            target=_serve_loop,
+            args=(conn, addr, load_library, work_path, upload_cache.temp_dir),
         )
 
         server_proc.start()
@@ -38,6 +38,7 @@ List of available APIs:
 - REQUEST: request a new resource from tracker
   - input: [TrackerCode.REQUEST, [key, user, priority]]
   - return: [TrackerCode.SUCCESS, [url, port, match-key]]
+  - note: the free resource with the shortest sessions is given first, see PriorityScheduler.
 """
 # pylint: disable=invalid-name
 
@@ -46,6 +47,7 @@ import heapq
 import logging
 import socket
 import threading
+import time
 import errno
 import struct
 import json
@@ -113,7 +115,13 @@ class Scheduler(object):
 
 
 class PriorityScheduler(Scheduler):
-    """Priority based scheduler, FIFO based on request order"""
+    """Priority based scheduler, FIFO based on request order.
+
+    A request gets the free resource whose server had the shortest sessions, which are
+    measured from the time a resource is given to the time its server reports it again.
+    The faster or less loaded devices thus take more of the requests, and the devices
+    not measured yet are tried first.
+    """
 
     def __init__(self, key):
         self._key = key
@@ -124,11 +132,14 @@ class PriorityScheduler(Scheduler):
 
     def _schedule(self):
         while self._requests and self._values:
-            value = self._values.pop(0)
+            # min keeps the first of the equal costs, so the order of put breaks the ties
+            value = min(self._values, key=lambda value: value[0].session_cost or 0.0)
+            self._values.remove(value)
             item = heapq.heappop(self._requests)
             callback = item[-1]
             if callback(value[1:]):
                 value[0].pending_matchkeys.remove(value[-1])
+                value[0].start_session()
             else:
                 self._values.append(value)
 
@@ -172,6 +183,10 @@ class TCPEventHandler(tornado_util.TCPHandler):
         self.pending_matchkeys = set()
         self._tracker._connections.add(self)
         self.put_values = []
+        # the average duration of the sessions of the resources of this connection, and the
+        # start times of the sessions not reported back yet
+        self.session_cost = None
+        self._session_starts = []
 
     def name(self):
         """name of connection"""
@@ -181,6 +196,20 @@ class TCPEventHandler(tornado_util.TCPHandler):
         """Summary of this connection"""
         return self._info
 
+    def start_session(self):
+        """Record that a resource of this connection was given to a request."""
+        self._session_starts.append(time.time())
+
+    def _end_session(self):
+        """Update the session cost when a resource is reported again after a session."""
+        if not self._session_starts:
+            return
+        duration = time.time() - self._session_starts.pop(0)
+        if self.session_cost is None:
+            self.session_cost = duration
+        else:
+            self.session_cost = 0.75 * self.session_cost + 0.25 * duration
+
     def _init_conn(self, message):
         """Initialize the connection"""
         if len(message) != 4:
@@ -235,6 +264,7 @@ class TCPEventHandler(tornado_util.TCPHandler):
         if code == TrackerCode.PUT:
             key = args[1]
             port, matchkey = args[2]
+            self._end_session()
             self.pending_matchkeys.add(matchkey)
             # got custom address (from rpc server)
             if len(args) >= 4 and args[3] is not None:
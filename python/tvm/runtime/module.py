@@ -18,6 +18,7 @@
 # pylint: disable=invalid-name, unused-import, import-outside-toplevel, inconsistent-return-statements
 """Runtime Module namespace."""
 import os
+import sys
 import ctypes
 import struct
 from typing import Sequence
@@ -31,6 +32,15 @@ from .packed_func import PackedFunc, PackedFuncHandle, _set_class_module
 from . import _ffi_api
 
 
+def _student_t975(dof):
+    """The 0.975 quantile of the Student's t distribution, as computed by the time evaluator."""
+    quantiles = [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228]
+    if dof <= len(quantiles):
+        return quantiles[dof - 1]
+    z = 1.96
+    return z + (z ** 3 + z) / (4 * dof)
+
+
 class BenchmarkResult:
     """Runtimes from benchmarking"""
 
@@ -65,6 +75,9 @@ class BenchmarkResult:
         results : Sequence[float]
             The collected runtimes (in seconds). This may be a series of mean runtimes if
             py:meth:`Module.time_evaluator` or `benchmark` was run with `number` > 1.
+        ci : float
+            Half width in seconds of the 95% confidence interval of the mean, by the Student's
+            t distribution. It is infinite with less than two results.
         """
         self.results = results
         self.mean = np.mean(self.results)
@@ -72,6 +85,10 @@ class BenchmarkResult:
         self.median = np.median(self.results)
         self.min = np.min(self.results)
         self.max = np.max(self.results)
+        self.ci = float("inf")
+        if len(results) > 1:
+            self.ci = _student_t975(len(results) - 1) * np.std(results, ddof=1)
+            self.ci /= np.sqrt(len(results))
 
     def __repr__(self):
         return "BenchmarkResult(min={}, mean={}, median={}, max={}, std={}, results={})".format(
@@ -231,7 +248,17 @@ class Module(object):
         """
         _ffi_api.ModuleSaveToFile(self, file_name, fmt)
 
-    def time_evaluator(self, func_name, dev, number=10, repeat=1, min_repeat_ms=0, f_preproc=""):
+    def time_evaluator(
+        self,
+        func_name,
+        dev,
+        number=10,
+        repeat=1,
+        min_repeat_ms=0,
+        f_preproc="",
+        target_rel_ci=0.0,
+        cutoff=0.0,
+    ):
         """Get an evaluator that measures time cost of running function.
 
         Parameters
@@ -262,6 +289,21 @@ class Module(object):
             will be automatically increased.
         f_preproc: str, optional
             The preprocess function name we want to execute before executing the time evaluator.
+            It runs before each repeat, so with `number` = 1 every run sees the prepared cache.
+            The CPU cache can be prepared by "cache_flush_cpu_args", which flushes all the
+            arguments, "cache_flush_cpu_non_first_arg", which keeps the first argument, or
+            "cache_warm_cpu_graph_context", which flushes the other arguments and reads the
+            first one back to the cache like the activation written by a previous operator.
+
+        target_rel_ci: float, optional
+            When positive, `repeat` becomes the maximum number of repeats, and the measurement
+            stops once the half width of the 95% confidence interval of the mean falls below
+            this fraction of the mean.
+
+        cutoff: float, optional
+            When positive, the time cost in seconds of the best known candidate. The measurement
+            stops once the confidence interval of the mean lies above it, so the candidates
+            clearly slower than the best one only take a couple of repeats.
 
         Note
         ----
@@ -272,7 +314,8 @@ class Module(object):
         -------
         ftimer : function
             The function that takes same argument as func and returns a BenchmarkResult.
-            The ProfileResult reports `repeat` time costs in seconds.
+            The ProfileResult reports `repeat` time costs in seconds, or fewer when the
+            adaptive options stop the measurement early.
         """
         try:
             feval = _ffi_api.RPCTimeEvaluator(
@@ -284,13 +327,14 @@ class Module(object):
                 repeat,
                 min_repeat_ms,
                 f_preproc,
+                *((target_rel_ci, cutoff) if target_rel_ci > 0 or cutoff > 0 else ()),
             )
 
             def evaluator(*args):
                 """Internal wrapped evaluator."""
                 # Wrap feval so we can add more stats in future.
                 blob = feval(*args)
-                fmt = "@" + ("d" * repeat)
+                fmt = "@" + ("d" * (len(blob) // 8))
                 results = struct.unpack(fmt, blob)
                 return BenchmarkResult(results)
 
@@ -330,7 +374,16 @@ class Module(object):
         is_dso_exportable = lambda m: (m.type_key == "llvm" or m.type_key == "c")
         return self._collect_from_import_tree(is_dso_exportable)
 
-    def export_library(self, file_name, fcompile=None, addons=None, workspace_dir=None, **kwargs):
+    def export_library(
+        self,
+        file_name,
+        fcompile=None,
+        addons=None,
+        workspace_dir=None,
+        num_workers=None,
+        object_cache_dir=None,
+        **kwargs,
+    ):
         """
         Export the module and all imported modules into a single device library.
 
@@ -362,6 +415,15 @@ class Module(object):
             artifacts when exporting the module.
             If this is not provided a temporary dir will be created.
 
+        num_workers : int, optional
+            The number of C and C++ sources compiled concurrently, when they are linked
+            with the default compiler. Defaults to the number of CPUs.
+
+        object_cache_dir : str, optional
+            The directory caching the object files of the C and C++ sources, keyed by the
+            hash of their content and compile options, so the sources unchanged since a
+            previous export are not compiled again.
+
         kwargs : dict, optional
             Additional arguments passed to fcompile
 
@@ -460,6 +522,23 @@ class Module(object):
             opts = options + ["-I" + path for path in find_include_path()]
             kwargs.update({"options": opts})
 
+        # Compile the sources one by one in parallel, the link then only takes objects.
+        num_sources = len([path for path in files if path.endswith((".c", ".cc", ".cpp"))])
+        if (
+            fcompile is _cc.create_shared
+            and sys.platform != "win32"
+            and kwargs.get("cc", "g++") != "nvcc"
+            and (num_sources > 1 or (num_sources and object_cache_dir))
+        ):
+            files = _cc.compile_objects(
+                files,
+                workspace_dir,
+                options=kwargs.get("options"),
+                cc=kwargs.get("cc", "g++"),
+                num_workers=num_workers,
+                cache_dir=object_cache_dir,
+            )
+
         return fcompile(file_name, files, **kwargs)
 
 
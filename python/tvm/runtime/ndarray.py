@@ -249,6 +249,27 @@ class NDArray(NDArrayBase):
             return self._copyto(res)
         raise ValueError("Unsupported target type %s" % str(type(target)))
 
+    def slice(self, axis, begin, end):
+        """Create a view of a range of an axis, without copying the data
+
+        Parameters
+        ----------
+        axis : int
+            The sliced axis.
+
+        begin : int
+            The first index of the range.
+
+        end : int
+            The end of the range.
+
+        Returns
+        -------
+        view : NDArray
+            The view, strided unless the outer axes have one element.
+        """
+        return _ffi_api.TVMArraySlice(self, axis, begin, end)
+
 
 def device(dev_type, dev_id=0):
     """Construct a TVM device with given device type and id.
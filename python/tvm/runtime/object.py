@@ -82,7 +82,7 @@ class Object(ObjectBase):
     def __getstate__(self):
         handle = self.handle
         if handle is not None:
-            return {"handle": _ffi_node_api.SaveJSON(self)}
+            return {"handle": _ffi_node_api.SaveBinary(self)}
         return {"handle": None}
 
     def __setstate__(self, state):
@@ -90,6 +90,9 @@ class Object(ObjectBase):
         handle = state["handle"]
         self.handle = None
         if handle is not None:
+            # the json of older pickles is still accepted
+            if isinstance(handle, bytes):
+                handle = bytearray(handle)
             self.__init_handle_by_constructor__(_ffi_node_api.LoadJSON, handle)
 
     def _move(self):
@@ -16,10 +16,13 @@
 # under the License.
 # pylint: disable=invalid-name
 """Helper utility to save and load parameter dicts."""
+import tvm._ffi
+
 from . import _ffi_api, ndarray
+from .object import Object
 
 
-def save_param_dict(params):
+def save_param_dict(params, aligned=False, indexed=False):
     """Save parameter dictionary to binary bytes.
 
     The result binary bytes can be loaded by the
@@ -30,6 +33,17 @@ def save_param_dict(params):
     params : dict of str to NDArray
         The parameter dictionary.
 
+    aligned : bool
+        Pad each tensor so that, once written to a file, it can be memory
+        mapped in place by :py:func:`load_param_dict_from_file`. The aligned
+        layout is not understood by older releases.
+
+    indexed : bool
+        Write a table of the names, types, shapes and offsets of the tensors
+        before their aligned payloads, so that :py:class:`ParamsFile` can get
+        one of them without reading the others. The indexed layout is not
+        understood by older releases.
+
     Returns
     -------
     param_bytes: bytearray
@@ -48,7 +62,7 @@ def save_param_dict(params):
        tvm.runtime.load_param_dict(param_bytes)
     """
     transformed = {k: ndarray.array(v) for (k, v) in params.items()}
-    return _ffi_api.SaveParams(transformed)
+    return _ffi_api.SaveParams(transformed, aligned, indexed)
 
 
 def load_param_dict(param_bytes):
@@ -67,3 +81,73 @@ def load_param_dict(param_bytes):
     if isinstance(param_bytes, (bytes, str)):
         param_bytes = bytearray(param_bytes)
     return _ffi_api.LoadParams(param_bytes)
+
+
+def load_param_dict_from_file(path):
+    """Load parameter dictionary from a file.
+
+    The file is memory mapped, and parameters saved with ``aligned=True`` are
+    returned as views into the mapping instead of being copied.
+
+    Parameters
+    ----------
+    path: str
+        The path to the serialized parameters.
+
+    Returns
+    -------
+    params : dict of str to NDArray
+        The parameter dictionary.
+    """
+    return _ffi_api.LoadParamsFromFile(path)
+
+
+@tvm._ffi.register_object("runtime.ParamsFile")
+class ParamsFile(Object):
+    """A memory mapped parameters file.
+
+    Only the table of a file saved with ``indexed=True`` is read when it is
+    opened, each tensor is paged in when it is used. Files in the other
+    layouts are loaded as a whole.
+
+    Parameters
+    ----------
+    path: str
+        The path to the serialized parameters.
+    """
+
+    def __init__(self, path):
+        self.__init_handle_by_constructor__(_ffi_api.ParamsFileOpen, path)
+
+    def names(self):
+        """The names of the parameters, in the order they were saved.
+
+        Returns
+        -------
+        names : list of str
+            The parameter names.
+        """
+        return [str(name) for name in _ffi_api.ParamsFileGetNames(self)]
+
+    def __getitem__(self, name):
+        return _ffi_api.ParamsFileGet(self, name)
+
+    def load(self, names=None, device=None):
+        """Load some parameters, uploading them to a device with the threads of the runtime.
+
+        Parameters
+        ----------
+        names : list of str, optional
+            The parameters to load, all of them by default.
+
+        device : Device, optional
+            The device of the returned tensors, the CPU by default. The CPU
+            tensors are views into the mapping when possible.
+
+        Returns
+        -------
+        params : dict of str to NDArray
+            The parameter dictionary.
+        """
+        device = device if device is not None else tvm.runtime.cpu(0)
+        return _ffi_api.ParamsFileLoad(self, names or [], device)
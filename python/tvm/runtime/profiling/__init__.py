@@ -35,6 +35,23 @@ class Report(Object):
         Per-device metrics collected over the entire run.
     """
 
+    def __init__(
+        self,
+        calls: Sequence[Dict[str, Object]],
+        device_metrics: Dict[str, Dict[str, Object]],
+    ):
+        """Construct a profiling report from a list of metrics and per-device metrics.
+
+        Parameters
+        ----------
+        calls : Sequence[Dict[str, Object]]
+            Per function call metrics.
+
+        device_metrics : Dict[str, Dict[str, Object]]
+            Per device metrics.
+        """
+        self.__init_handle_by_constructor__(_ffi_api.Report, calls, device_metrics)
+
     def csv(self):
         """Convert this profiling report into CSV format.
 
@@ -133,6 +150,19 @@ class Report(Object):
         """
         return _ffi_api.AsJSON(self)
 
+    def chrome_trace(self):
+        """Convert the calls of this report to a timeline in the Chrome trace event format.
+
+        The output can be opened in chrome://tracing or https://ui.perfetto.dev. Each
+        device is a process and each host thread making calls is a thread of it.
+
+        Returns
+        -------
+        trace : str
+            The trace events in JSON.
+        """
+        return _ffi_api.AsChromeTrace(self)
+
     @classmethod
     def from_json(cls, s):
         """Deserialize a report from JSON.
@@ -150,6 +180,38 @@ class Report(Object):
         return _ffi_api.FromJSON(s)
 
 
+@_ffi.register_object("runtime.profiling.Count")
+class Count(Object):
+    """A integer count of something"""
+
+    def __init__(self, count: int):
+        self.__init_handle_by_constructor__(_ffi_api.Count, count)
+
+
+@_ffi.register_object("runtime.profiling.Duration")
+class Duration(Object):
+    """A duration of something, in microseconds"""
+
+    def __init__(self, duration: float):
+        self.__init_handle_by_constructor__(_ffi_api.Duration, duration)
+
+
+@_ffi.register_object("runtime.profiling.Percent")
+class Percent(Object):
+    """A percent of something"""
+
+    def __init__(self, percent: float):
+        self.__init_handle_by_constructor__(_ffi_api.Percent, percent)
+
+
+@_ffi.register_object("runtime.profiling.Ratio")
+class Ratio(Object):
+    """A ratio of two things, such as a throughput"""
+
+    def __init__(self, ratio: float):
+        self.__init_handle_by_constructor__(_ffi_api.Ratio, ratio)
+
+
 @_ffi.register_object("runtime.profiling.MetricCollector")
 class MetricCollector(Object):
     """Interface for user defined profiling metric collection."""
@@ -185,3 +247,54 @@ if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=T
             for dev, names in metric_names.items():
                 wrapped[DeviceWrapper(dev)] = names
             self.__init_handle_by_constructor__(_ffi_api.PAPIMetricCollector, wrapped)
+
+
+# We only enable this class when TVM is built with CUPTI support
+if _ffi.get_global_func("runtime.profiling.CUPTIMetricCollector", allow_missing=True) is not None:
+
+    @_ffi.register_object("runtime.profiling.CUPTIMetricCollector")
+    class CUPTIMetricCollector(MetricCollector):
+        """Collects the hardware performance counters of the kernels run on CUDA
+        devices through the CUDA Profiling Tools Interface (CUPTI).
+
+        Each profiled call replays its kernels until all the counters are read, so
+        the durations of the report include the replays.
+        """
+
+        def __init__(self, metric_names: Optional[Sequence[str]] = None):
+            """
+            Parameters
+            ----------
+            metric_names : Optional[Sequence[str]]
+                The metrics to collect, with the names listed by
+                `ncu --query-metrics`. By default the achieved occupancy, the DRAM
+                bytes, the L2 hit rate and the tensor pipe utilization.
+            """
+            metric_names = [] if metric_names is None else list(metric_names)
+            self.__init_handle_by_constructor__(_ffi_api.CUPTIMetricCollector, metric_names)
+
+
+# We only enable this class when TVM is built with rocprofiler support
+if (
+    _ffi.get_global_func("runtime.profiling.ROCProfilerMetricCollector", allow_missing=True)
+    is not None
+):
+
+    @_ffi.register_object("runtime.profiling.ROCProfilerMetricCollector")
+    class ROCProfilerMetricCollector(MetricCollector):
+        """Collects the hardware performance counters of the kernels run on ROCm
+        devices through rocprofiler.
+        """
+
+        def __init__(self, metric_names: Optional[Sequence[str]] = None):
+            """
+            Parameters
+            ----------
+            metric_names : Optional[Sequence[str]]
+                The metrics to collect, with the names listed by
+                `rocprof --list-derived`. By default the bytes read from and written
+                to the device memory, the L2 hit rate and the memory and vector ALU
+                busy times.
+            """
+            metric_names = [] if metric_names is None else list(metric_names)
+            self.__init_handle_by_constructor__(_ffi_api.ROCProfilerMetricCollector, metric_names)
@@ -177,6 +177,34 @@ class Executable(object):
 
         return Executable(_ffi_api.Load_Executable(bytecode, lib))
 
+    @staticmethod
+    def load_exec_from_file(path, lib):
+        """Construct an executable from a file written by ``Executable.mod.save``.
+
+        The file is memory mapped and host constants are used in place, which
+        avoids holding a second copy of the weights while loading.
+
+        Parameters
+        ----------
+        path : str
+            The path to the saved bytecode.
+
+        lib : :py:class:`~tvm.runtime.Module`
+            The runtime module that contains the generated code.
+
+        Returns
+        -------
+        exec: Executable
+            An executable constructed using the provided artifacts.
+        """
+        if lib is not None and not isinstance(lib, tvm.runtime.Module):
+            raise TypeError(
+                "lib is expected to be the type of tvm.runtime.Module"
+                + ", but received {}".format(type(lib))
+            )
+
+        return Executable(_ffi_api.Load_ExecutableFromFile(path, lib))
+
     @property
     def lib(self):
         """Get the library that contains hardware dependent code.
@@ -313,7 +341,9 @@ class VirtualMachine(object):
 
     memory_cfg : str or Dict[tvm.runtime.Device, str], optional
         Config the type of memory allocator. The allocator type can be ["naive",
-        "pooled"]. If memory_cfg is None, all devices will use pooled allocator
+        "pooled", "slab"]. The slab allocator rounds requests to geometric size
+        classes and splits and coalesces cached blocks, which bounds the cache
+        growth of dynamic shape workloads. If memory_cfg is None, all devices will use pooled allocator
         by default. If memory_cfg is string, all devices will use the specified
         allocator type. If memory_cfg is a dict, each device uses the allocator
         type specified in the dict, or pooled allocator if not specified in the
@@ -322,6 +352,7 @@ class VirtualMachine(object):
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    SLAB_ALLOCATOR = 3
 
     def __init__(self, exe, device, memory_cfg=None):
         """
@@ -388,9 +419,11 @@ class VirtualMachine(object):
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
+            assert memory_cfg in ["naive", "pooled", "slab"]
             if memory_cfg == "naive":
                 default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            elif memory_cfg == "slab":
+                default_alloc_type = VirtualMachine.SLAB_ALLOCATOR
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
@@ -481,6 +514,21 @@ class VirtualMachine(object):
         """
         return self.invoke("main", *args, **kwargs)
 
+    def set_storage_arena(self, enable=True):
+        """Serve statically sized storage from one arena per call frame.
+
+        Storage whose size is known when the executable is loaded is carved out of a
+        single arena per device, which is reused by the next invocation once no
+        tensor of the previous one is alive. Dynamically sized storage still goes
+        through the allocator.
+
+        Parameters
+        ----------
+        enable : bool
+            Whether to use storage arenas.
+        """
+        self.module["set_storage_arena"](enable)
+
     def invoke_stateful(self, func_name, *args, **kwargs):
         """Invoke a function and ignore the returned result.
 
@@ -622,3 +670,262 @@ class VirtualMachine(object):
         return self.module.time_evaluator(
             "invoke", device, repeat=repeat, number=number, min_repeat_ms=min_repeat_ms
         )(func_name)
+
+
+class PagedKVCache(object):
+    """The key value cache of an autoregressive decoder, split in blocks of positions.
+
+    The cache is one tensor of shape ``[num_blocks, block_size] + entry_shape``, allocated
+    by the pooled allocator of the device. Each sequence owns a list of blocks, and the
+    entry of its position ``p`` is the row ``p % block_size`` of its block
+    ``p // block_size``, so sequences of different lengths share the cache without padding.
+    A forked sequence shares the blocks of its parent until it writes past their common
+    prefix, the shared block being copied then.
+
+    Parameters
+    ----------
+    num_blocks : int
+        The number of blocks of the cache.
+
+    block_size : int
+        The number of positions in a block.
+
+    entry_shape : List[int]
+        The shape of the entry of a position, e.g. ``[num_layers, 2, num_heads, head_dim]``.
+
+    dtype : str
+        The data type of the cache.
+
+    device : tvm.runtime.Device
+        The device of the cache.
+    """
+
+    def __init__(self, num_blocks, block_size, entry_shape, dtype="float32", device=None):
+        device = tvm.cpu() if device is None else device
+        self.module = _ffi_api._PagedKVCache(
+            num_blocks,
+            block_size,
+            tvm.runtime.ShapeTuple(entry_shape),
+            dtype,
+            device.device_type,
+            device.device_id,
+        )
+        self.block_size = block_size
+        self._reserve = self.module["reserve"]
+        self._free = self.module["free"]
+        self._fork = self.module["fork"]
+        self._block_table = self.module["block_table"]
+        self._get_pool = self.module["get_pool"]
+        self._set_pool = self.module["set_pool"]
+        self._get_num_free_blocks = self.module["get_num_free_blocks"]
+
+    def reserve(self, seq_id, length):
+        """Make sure a sequence has the blocks of its first ``length`` positions.
+
+        The positions past the previous length are the ones written next, the shared
+        blocks holding some of them are replaced by private copies.
+
+        Returns
+        -------
+        reserved : bool
+            Whether the blocks are reserved. Nothing is reserved when the cache is too short.
+        """
+        return bool(self._reserve(seq_id, length))
+
+    def free(self, seq_id):
+        """Return the blocks of a sequence to the cache, as far as no other one shares them."""
+        self._free(seq_id)
+
+    def fork(self, parent_id, child_id):
+        """Start a sequence whose prefix is the reserved positions of another one."""
+        self._fork(parent_id, child_id)
+
+    def block_table(self, seq_ids):
+        """The int32 block tables of a batch, of shape [batch, max_blocks], padded with -1."""
+        return self._block_table(tvm.runtime.ShapeTuple(seq_ids))
+
+    @property
+    def pool(self):
+        """The tensor holding the blocks."""
+        return self._get_pool()
+
+    @pool.setter
+    def pool(self, value):
+        self._set_pool(value)
+
+    @property
+    def num_free_blocks(self):
+        """The number of blocks not owned by any sequence."""
+        return self._get_num_free_blocks()
+
+
+class ContinuousBatcher(object):
+    """Run the decoding steps of many sequences through a VM function as one batch.
+
+    The batch is rebuilt at every step: finished sequences leave it and waiting ones join
+    it, so a sequence never waits for the longest one of its batch and nothing is padded.
+    Each step feeds one token of each running sequence, the next prompt token or the last
+    generated one, and the prompts are therefore consumed through the same function.
+
+    The function is called as ``func(tokens, positions, block_table, pool)`` with
+
+    - tokens, the int32 tokens of shape [batch],
+    - positions, the int32 positions of these tokens in their sequences,
+    - block_table, the int32 block tables of shape [batch, max_blocks],
+    - pool, the tensor of the cache,
+
+    and returns the int32 next tokens of shape [batch], or a tuple of them and of the
+    updated pool. The function writes the cache entry of each token and reads the entries
+    of the previous positions through the block table.
+
+    When a running sequence needs a block and the cache is full, the last admitted sequence
+    is preempted: its blocks are freed and it is fed again from its first token when it
+    joins the batch back.
+
+    Parameters
+    ----------
+    vm : VirtualMachine
+        The VM running the step function.
+
+    kv_cache : PagedKVCache
+        The cache of the sequences.
+
+    func_name : str
+        The name of the step function.
+
+    max_batch_size : int
+        The maximal number of sequences of a step.
+    """
+
+    class _Sequence(object):
+        def __init__(self, seq_id, prompt, max_new_tokens, stop_token):
+            self.seq_id = seq_id
+            self.tokens = list(prompt)
+            self.num_prompt_tokens = len(self.tokens)
+            self.max_new_tokens = max_new_tokens
+            self.stop_token = stop_token
+            # the number of tokens already fed, whose cache entries are written
+            self.num_fed = 0
+
+    def __init__(self, vm, kv_cache, func_name="decode", max_batch_size=8):
+        self.vm = vm
+        self.kv_cache = kv_cache
+        self.func_name = func_name
+        self.max_batch_size = max_batch_size
+        self._next_id = 0
+        self._waiting = []
+        self._running = []
+        self._finished = {}
+
+    def add_request(self, prompt, max_new_tokens, stop_token=None):
+        """Queue a sequence, which joins the batch at a next step.
+
+        Parameters
+        ----------
+        prompt : List[int]
+            The tokens of the prompt, not empty.
+
+        max_new_tokens : int
+            The maximal number of generated tokens.
+
+        stop_token : Optional[int]
+            The token ending the sequence, kept in its output.
+
+        Returns
+        -------
+        seq_id : int
+            The identifier of the sequence.
+        """
+        if not prompt:
+            raise ValueError("The prompt must not be empty")
+        seq_id = self._next_id
+        self._next_id += 1
+        self._waiting.append(self._Sequence(seq_id, prompt, max_new_tokens, stop_token))
+        return seq_id
+
+    @property
+    def num_pending(self):
+        """The number of sequences running or waiting."""
+        return len(self._running) + len(self._waiting)
+
+    def _preempt(self):
+        seq = self._running.pop()
+        self.kv_cache.free(seq.seq_id)
+        seq.num_fed = 0
+        self._waiting.insert(0, seq)
+
+    def _schedule(self):
+        # the running sequences keep their place before any waiting one joins
+        i = 0
+        while i < len(self._running):
+            seq = self._running[i]
+            if self.kv_cache.reserve(seq.seq_id, seq.num_fed + 1):
+                i += 1
+            elif len(self._running) > 1:
+                self._preempt()
+            else:
+                raise RuntimeError("The cache is too short for sequence %d" % seq.seq_id)
+        while self._waiting and len(self._running) < self.max_batch_size:
+            seq = self._waiting[0]
+            if not self.kv_cache.reserve(seq.seq_id, 1):
+                if not self._running:
+                    raise RuntimeError("The cache is too short for sequence %d" % seq.seq_id)
+                break
+            self._running.append(self._waiting.pop(0))
+
+    def step(self):
+        """Run one decoding step of the batch.
+
+        Returns
+        -------
+        finished : List[int]
+            The sequences finished by this step.
+        """
+        self._schedule()
+        if not self._running:
+            return []
+        seq_ids = [seq.seq_id for seq in self._running]
+        tokens = np.array([seq.tokens[seq.num_fed] for seq in self._running], dtype="int32")
+        positions = np.array([seq.num_fed for seq in self._running], dtype="int32")
+        block_table = self.kv_cache.block_table(seq_ids)
+        out = self.vm.invoke(
+            self.func_name,
+            tvm.nd.array(tokens),
+            tvm.nd.array(positions),
+            block_table,
+            self.kv_cache.pool,
+        )
+        if isinstance(out, container.ADT):
+            out, self.kv_cache.pool = out[0], out[1]
+        next_tokens = out.numpy()
+        finished = []
+        running = []
+        for seq, token in zip(self._running, next_tokens):
+            seq.num_fed += 1
+            if seq.num_fed == len(seq.tokens):
+                seq.tokens.append(int(token))
+                num_new = len(seq.tokens) - seq.num_prompt_tokens
+                if num_new >= seq.max_new_tokens or token == seq.stop_token:
+                    self.kv_cache.free(seq.seq_id)
+                    self._finished[seq.seq_id] = seq.tokens[seq.num_prompt_tokens :]
+                    finished.append(seq.seq_id)
+                    continue
+            running.append(seq)
+        self._running = running
+        return finished
+
+    def get_output(self, seq_id):
+        """The generated tokens of a finished sequence, None while it runs."""
+        return self._finished.get(seq_id)
+
+    def run(self):
+        """Run steps until every queued sequence is finished.
+
+        Returns
+        -------
+        outputs : Dict[int, List[int]]
+            The generated tokens of each finished sequence.
+        """
+        while self.num_pending:
+            self.step()
+        return dict(self._finished)
@@ -483,6 +483,32 @@ def riscv_cpu(model="sifive-u54", options=None):
     return Target(" ".join(["llvm"] + opts))
 
 
+def wasm(simd=True, threads=False, options=None):
+    """Returns a WebAssembly target for the web runtime.
+
+    Parameters
+    ----------
+    simd : bool
+        Whether to emit the SIMD128 vector instructions.
+    threads : bool
+        Whether the code runs with the threaded runtime of the web, whose memory is shared
+        with its Web Workers, see ``tvm.contrib.emcc.create_tvmjs_wasm``.
+    options : str or list of str
+        Additional options
+    """
+    mattr = []
+    if simd:
+        mattr += ["+simd128"]
+    if threads:
+        # the objects linked into a shared memory must use its atomics
+        mattr += ["+atomics", "+bulk-memory"]
+    opts = ["-mtriple=wasm32-unknown-unknown-wasm"]
+    if mattr:
+        opts += ["-mattr=" + ",".join(mattr)]
+    opts = _merge_opts(opts, options)
+    return Target(" ".join(["llvm"] + opts))
+
+
 def hexagon(cpu_ver="v66", **kwargs):
     """Returns a Hexagon target.
 
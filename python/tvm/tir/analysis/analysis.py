@@ -180,6 +180,40 @@ def calculate_workspace_bytes(func: PrimFunc, workspace_byte_alignment: int) ->
     return _ffi_api.calculate_workspace_bytes(func, workspace_byte_alignment)  # type: ignore
 
 
+def estimate_tir_flops(func: PrimFunc) -> float:
+    """Estimate the floating point operations of a lowered PrimFunc, each operation on a
+    vector lane counting as one and a fused multiply add as two.
+
+    Parameters
+    ----------
+    func: tvm.tir.PrimFunc
+        The function to be estimated.
+
+    Returns
+    -------
+    result : float
+        The number of floating point operations.
+    """
+    return _ffi_api.estimate_tir_flops(func)  # type: ignore
+
+
+def estimate_tir_bytes(func: PrimFunc) -> float:
+    """Estimate the bytes a lowered PrimFunc moves from and to its parameter buffers, each
+    buffer counting the bytes of its loads and stores up to its size.
+
+    Parameters
+    ----------
+    func: tvm.tir.PrimFunc
+        The function to be estimated.
+
+    Returns
+    -------
+    result : float
+        The number of bytes moved.
+    """
+    return _ffi_api.estimate_tir_bytes(func)  # type: ignore
+
+
 def detect_buffer_access_lca(func: PrimFunc) -> Dict[Buffer, Stmt]:
     """Detect the lowest common ancestor(LCA) of buffer access, including both high-level
     access(BufferLoad, BufferStore) and low-level access(Load, Store and opaque access).
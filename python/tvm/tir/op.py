@@ -223,6 +223,123 @@ def call_llvm_pure_intrin(dtype, name, *args, span=None):
     )
 
 
+def ptx_mma(
+    shape,
+    A_layout,
+    B_layout,
+    A_dtype,
+    B_dtype,
+    C_dtype,
+    multiplicand_a,
+    a_index,
+    multiplicand_b,
+    b_index,
+    accumulator,
+    c_index,
+    saturate=False,
+):
+    """Build a tensor core mma.sync, accumulating in place.
+
+    The fragments are the registers of the calling thread, in the layouts of the PTX ISA.
+
+    Parameters
+    ----------
+    shape : str
+        The shape of the instruction, for example "m16n8k16".
+
+    A_layout : str
+        The layout of the multiplicand A, "row".
+
+    B_layout : str
+        The layout of the multiplicand B, "col".
+
+    A_dtype : str
+        The PTX type of A, one of "f16", "bf16", "tf32", "s8" and "u8".
+
+    B_dtype : str
+        The PTX type of B, the type of A.
+
+    C_dtype : str
+        The PTX type of the accumulator, one of "f16", "f32" and "s32".
+
+    multiplicand_a : Var
+        The local buffer holding the fragment of A.
+
+    a_index : PrimExpr
+        The first element of the fragment of A.
+
+    multiplicand_b : Var
+        The local buffer holding the fragment of B.
+
+    b_index : PrimExpr
+        The first element of the fragment of B.
+
+    accumulator : Var
+        The local buffer holding the fragment of the accumulator.
+
+    c_index : PrimExpr
+        The first element of the fragment of the accumulator.
+
+    saturate : bool
+        Whether to saturate the integer results.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        "handle",
+        "tir.ptx_mma",
+        shape,
+        A_layout,
+        B_layout,
+        A_dtype,
+        B_dtype,
+        C_dtype,
+        multiplicand_a,
+        a_index,
+        multiplicand_b,
+        b_index,
+        accumulator,
+        c_index,
+        saturate,
+    )
+
+
+def ptx_ldmatrix(trans, num, dtype, local_ptr, local_index, shared_ptr):
+    """Build an ldmatrix, loading 8x8 tensor core fragments from the shared memory.
+
+    Parameters
+    ----------
+    trans : bool
+        Whether to transpose the matrices.
+
+    num : int
+        The number of matrices, 1, 2 or 4.
+
+    dtype : str
+        The PTX type of the elements, ".b16".
+
+    local_ptr : Var
+        The local buffer the fragments are loaded to.
+
+    local_index : PrimExpr
+        The first element loaded to.
+
+    shared_ptr : PrimExpr
+        The access_ptr of the row of the shared buffer the calling thread provides.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        "handle", "tir.ptx_ldmatrix", trans, num, dtype, local_ptr, local_index, shared_ptr
+    )
+
+
 def ret(val):
     """Create a tir return expression
 
@@ -74,6 +74,24 @@ def InjectPrefetch():
     return _ffi_api.InjectPrefetch()  # type: ignore
 
 
+def InjectAutoPrefetch():
+    """Insert software prefetches for the streaming accesses of the CPU loops.
+
+    The accesses of a serial loop at a constant stride of at least
+    ``min_stride_bytes``, and the indirect ones such as the rows of a gather,
+    are prefetched a few iterations ahead. The distance is ``distance_bytes``
+    divided by the bytes the prefetched streams move per iteration, at most
+    ``max_distance``. The options are set by the ``tir.InjectAutoPrefetch``
+    pass config, and the pass does nothing while ``distance_bytes`` is 0.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectAutoPrefetch()  # type: ignore
+
+
 def StorageFlatten(cache_line_size, create_bound_attribute: bool = False):
     """Flatten the multi-dimensional read/write to 1D.
 
@@ -206,6 +224,75 @@ def InjectDoubleBuffer():
     return _ffi_api.InjectDoubleBuffer()  # type: ignore
 
 
+def InjectSoftwarePipeline():
+    """Pipeline the loops annotated with software_pipeline_stage and software_pipeline_order.
+
+    Each statement of the loop body runs the iterations of the loop shifted by its stage, and
+    the statements are emitted in the given order. The stages listed in the optional
+    software_pipeline_async_stages annotation copy to the shared memory asynchronously.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSoftwarePipeline()  # type: ignore
+
+
+def RewriteSharedMemoryLayout():
+    """Pad or permute the shared memory buffers that the threads of a warp access with bank
+    conflicts.
+
+    The conflicts are estimated for the first warp, and the new layout is only kept when it
+    has fewer conflicts. The pass runs on the blocks, before FlattenBuffer.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.RewriteSharedMemoryLayout()  # type: ignore
+
+
+def WidenMemoryAccess():
+    """Vectorize the innermost loops of the GPU kernels that access consecutive elements of
+    the function arguments, so that each thread loads and stores 8 or 16 bytes at once.
+
+    A loop is only split when every access is proven aligned. The pass runs before
+    VectorizeLoop.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.WidenMemoryAccess()  # type: ignore
+
+
+def InjectPTXAsyncCopy():
+    """Rewrite the copies from the global to the shared memory in an async_scope into
+    ptx_cp_async.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectPTXAsyncCopy()  # type: ignore
+
+
+def InjectDMAAsyncCopy():
+    """Rewrite the contiguous copies in an async_scope that do not go to the shared memory
+    into dma_copy. Must run before InjectPTXAsyncCopy.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectDMAAsyncCopy()  # type: ignore
+
+
 def InjectRollingBuffer():
     """Inject rolling buffer statements.
 
@@ -490,6 +577,21 @@ def LegalizePackedCalls():
     return _ffi_api.LegalizePackedCalls()  # type: ignore
 
 
+def DeduplicateFunctions():
+    """Keep one copy of the PrimFuncs that are structurally equal up to their global symbols,
+    redirecting the calls of the others to it.
+
+    The entry and runner functions and the external ones are kept, the pass being for modules
+    whose kernels are only called from the module, as the ones of the AOT executor.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.DeduplicateFunctions()  # type: ignore
+
+
 def LowerIntrin():
     """Lower target specific intrinsic calls.
 
@@ -0,0 +1,44 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""USMP Transform Python API for passes"""
+# pylint: disable=invalid-name
+
+from typing import Dict
+
+from . import _ffi_api
+from ...stmt import Stmt
+from ..utils import PoolAllocation
+
+
+def convert_pool_allocations_to_offsets(pool_allocations: Dict[Stmt, PoolAllocation]):
+    """Replace the planned allocate nodes by offsets in their pools.
+
+    Each pool becomes a trailing uint8 pointer parameter of the PrimFuncs allocating in it
+    or calling a PrimFunc that takes it, so the pools are provided once by the caller of
+    the entry function.
+
+    Parameters
+    ----------
+    pool_allocations : Dict[tvm.tir.Stmt, PoolAllocation]
+        The pool allocation of each planned allocate node
+
+    Returns
+    -------
+    ret: tvm.transform.Pass
+        The registered pass.
+    """
+    return _ffi_api.ConvertPoolAllocationsToOffsets(pool_allocations)
@@ -17,9 +17,42 @@
 # pylint: disable=invalid-name, unused-variable, no-else-return, unused-argument, import-outside-toplevel
 """Dense schedule for ARM CPU"""
 
+from tvm import te
+from tvm import autotvm
+from .. import tag
+from ..utils import traverse_inline, get_const_tuple
+from ..generic import dense as dense_generic
 from .mprofile.dsp.dense import dense_dsp_schedule
+from .tensor_intrin import dot_int8_int8_int32
 
 
 def schedule_dense_dsp(outs):
     """Create schedule for dense_dsp"""
     return dense_dsp_schedule(outs)
+
+
+@autotvm.register_topi_compute("dense_int8.arm_cpu")
+def dense_int8(cfg, data, weight, bias=None, out_dtype=None):
+    """Compute int8 x int8 dense on a weight packed in the NC4n4c layout, for sdot."""
+    if out_dtype is None:
+        out_dtype = "int32"
+    C = dense_generic.dense_int8_packed(cfg, data, weight, out_dtype, int32_lanes=4)
+    if bias is not None:
+        M, N = get_const_tuple(C.shape)
+        C = te.compute((M, N), lambda i, j: C[i, j] + bias[j].astype(out_dtype), tag=tag.BROADCAST)
+    return C
+
+
+@autotvm.register_topi_schedule("dense_int8.arm_cpu")
+def schedule_dense_int8(cfg, outs):
+    """Create the schedule for dense_int8"""
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if "dense_int8_packed" in op.tag:
+            dense_generic.schedule_dense_int8_packed(
+                cfg, s, op.output(0), outs[0], 4, dot_int8_int8_int32(int32_lanes=4, dtype="int")
+            )
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
@@ -60,3 +60,4 @@ from .sparse_reshape import *
 from .transform import *
 from .unique import *
 from .searchsorted import *
+from .attention import *
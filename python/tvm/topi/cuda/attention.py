@@ -0,0 +1,159 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-locals
+"""Fused scaled dot product attention on CUDA"""
+import tvm
+from tvm import te
+from ..utils import get_const_int, ceil_div
+
+
+def _fused_attention_ir(query, key, value, out, scale, block_size, nthread):
+    """Online softmax attention. Each thread owns one query row, and the threads of a CUDA
+    block load the blocks of keys and values they all visit into the shared memory together.
+    Only the scores of the current key block are kept, in the registers of each thread."""
+    ib = tvm.tir.ir_builder.create()
+    batch, q_len, _ = query.shape
+    kv_len = key.shape[1]
+    dim = get_const_int(query.shape[2])
+    v_dim = get_const_int(value.shape[2])
+    acc_dtype = "float32" if query.dtype == "float16" else query.dtype
+
+    q = ib.buffer_ptr(query)
+    k = ib.buffer_ptr(key)
+    v = ib.buffer_ptr(value)
+    o = ib.buffer_ptr(out)
+
+    tx = te.thread_axis("threadIdx.x")
+    bx = te.thread_axis("blockIdx.x")
+    by = te.thread_axis("blockIdx.y")
+    ib.scope_attr(tx, "thread_extent", nthread)
+    ib.scope_attr(bx, "thread_extent", ceil_div(q_len, nthread))
+    ib.scope_attr(by, "thread_extent", batch)
+    b = by
+    i = bx * nthread + tx
+
+    key_tile = ib.allocate(key.dtype, (block_size, dim), name="key_tile", scope="shared")
+    value_tile = ib.allocate(value.dtype, (block_size, v_dim), name="value_tile", scope="shared")
+    q_row = ib.allocate(acc_dtype, (dim,), name="q_row", scope="local")
+    acc = ib.allocate(acc_dtype, (v_dim,), name="acc", scope="local")
+    scores = ib.allocate(acc_dtype, (block_size,), name="scores", scope="local")
+    row_max = ib.allocate(acc_dtype, (1,), name="row_max", scope="local")
+    row_sum = ib.allocate(acc_dtype, (1,), name="row_sum", scope="local")
+    dot = ib.allocate(acc_dtype, (1,), name="dot", scope="local")
+    block_max = ib.allocate(acc_dtype, (1,), name="block_max", scope="local")
+
+    row_max[0] = tvm.tir.min_value(acc_dtype)
+    row_sum[0] = tvm.tir.const(0, acc_dtype)
+    with ib.for_range(0, v_dim, name="d") as d:
+        acc[d] = tvm.tir.const(0, acc_dtype)
+    with ib.if_scope(i < q_len):
+        with ib.for_range(0, dim, name="d") as d:
+            q_row[d] = q[b, i, d].astype(acc_dtype) * tvm.tir.const(scale, acc_dtype)
+
+    with ib.for_range(0, ceil_div(kv_len, block_size), name="kb") as kb:
+        # every thread of the block takes part in the loads and the barriers, even past q_len
+        with ib.for_range(0, ceil_div(block_size * dim, nthread), name="t") as t:
+            idx = t * nthread + tx
+            jj = kb * block_size + idx // dim
+            with ib.if_scope(tvm.tir.all(idx < block_size * dim, jj < kv_len)):
+                key_tile[idx // dim, idx % dim] = k[b, jj, idx % dim]
+        with ib.for_range(0, ceil_div(block_size * v_dim, nthread), name="t") as t:
+            idx = t * nthread + tx
+            jj = kb * block_size + idx // v_dim
+            with ib.if_scope(tvm.tir.all(idx < block_size * v_dim, jj < kv_len)):
+                value_tile[idx // v_dim, idx % v_dim] = v[b, jj, idx % v_dim]
+        ib.emit(tvm.tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"])))
+
+        with ib.if_scope(i < q_len):
+            block_max[0] = row_max[0]
+            with ib.for_range(0, block_size, name="j") as j:
+                with ib.if_scope(kb * block_size + j < kv_len):
+                    dot[0] = tvm.tir.const(0, acc_dtype)
+                    with ib.for_range(0, dim, name="d") as d:
+                        dot[0] += q_row[d] * key_tile[j, d].astype(acc_dtype)
+                    scores[j] = dot[0]
+                    block_max[0] = tvm.te.max(block_max[0], scores[j])
+
+            correction = ib.let("correction", tvm.te.exp(row_max[0] - block_max[0]))
+            row_sum[0] *= correction
+            with ib.for_range(0, v_dim, name="d") as d:
+                acc[d] *= correction
+            row_max[0] = block_max[0]
+
+            with ib.for_range(0, block_size, name="j") as j:
+                with ib.if_scope(kb * block_size + j < kv_len):
+                    p = ib.let("p", tvm.te.exp(scores[j] - row_max[0]))
+                    row_sum[0] += p
+                    with ib.for_range(0, v_dim, name="d") as d:
+                        acc[d] += p * value_tile[j, d].astype(acc_dtype)
+        ib.emit(tvm.tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"])))
+
+    with ib.if_scope(i < q_len):
+        with ib.for_range(0, v_dim, name="d") as d:
+            o[b, i, d] = (acc[d] / row_sum[0]).astype(out.dtype)
+
+    return ib.get()
+
+
+def fused_attention(query, key, value, scale=1.0):
+    """Scaled dot product attention computed without storing the attention matrix.
+
+    .. math::
+
+        out[b, :, :] = softmax(scale * query[b, :, :] key[b, :, :]^T) value[b, :, :]
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        3-D with shape [batch, q_len, dim], the heads of a multi-head attention being
+        folded into the batch, dim being static
+
+    key : tvm.te.Tensor
+        3-D with shape [batch, kv_len, dim]
+
+    value : tvm.te.Tensor
+        3-D with shape [batch, kv_len, v_dim], v_dim being static
+
+    scale : float, optional
+        The factor of the query-key products
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        3-D with shape [batch, q_len, v_dim]
+    """
+    assert len(query.shape) == 3 and len(key.shape) == 3 and len(value.shape) == 3
+    dim = get_const_int(query.shape[2])
+    v_dim = get_const_int(value.shape[2])
+    # the blocks of keys and values fit in the 48KB of shared memory of a CUDA block
+    dtype_bytes = tvm.runtime.DataType(query.dtype).bits // 8
+    block_size = max(1, min(32, (48 * 1024) // (dtype_bytes * (dim + v_dim))))
+    nthread = 64
+
+    out_shape = (query.shape[0], query.shape[1], value.shape[2])
+    out_buf = tvm.tir.decl_buffer(out_shape, query.dtype, "out_buf")
+    return te.extern(
+        [out_shape],
+        [query, key, value],
+        lambda ins, outs: _fused_attention_ir(
+            ins[0], ins[1], ins[2], outs[0], scale, block_size, nthread
+        ),
+        out_buffers=[out_buf],
+        dtype=query.dtype,
+        name="fused_attention_gpu",
+        tag="fused_attention_gpu",
+    )
@@ -135,6 +135,34 @@ def schedule_dense_int8(cfg, outs):
 _dp4a = dp4a("shared", "shared", "local")
 
 
+def schedule_weight_only_dense(outs):
+    """Create schedule for weight_only_dense, the threads of a CUDA block reducing one output
+    element together, which suits the small batches of decoding steps."""
+    outs = [outs] if isinstance(outs, te.tensor.Tensor) else outs
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if op.tag == "weight_only_dense":
+            C = op.output(0)
+            out = s.outputs[0].output(0)
+            if op not in s.outputs:
+                s[C].compute_at(s[out], s[out].op.axis[1])
+            s[out].bind(s[out].op.axis[0], te.thread_axis("blockIdx.y"))
+            s[out].bind(s[out].op.axis[1], te.thread_axis("blockIdx.x"))
+
+            thread_x = te.thread_axis("threadIdx.x")
+            _, ki = s[C].split(s[C].op.reduce_axis[0], factor=64)
+            CF = s.rfactor(C, ki)
+            tx = s[C].op.reduce_axis[0]
+            s[C].bind(tx, thread_x)
+            s[CF].compute_at(s[C], tx)
+            s[C].set_store_predicate(thread_x.var.equal(0))
+            s[out].set_store_predicate(thread_x.var.equal(0))
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
+
+
 def _schedule_dense_int8(cfg, s, output):
     data, weight = s[output].op.input_tensors
     if len(weight.op.input_tensors) == 1 and weight.op.input_tensors[0] == data:
@@ -17,6 +17,8 @@
 # pylint: disable=invalid-name, no-member, too-many-locals, too-many-arguments, too-many-statements, singleton-comparison
 # pylint: disable=bad-continuation, unused-argument
 """Non-maximum suppression operator"""
+import functools
+
 import tvm
 from tvm import te
 from tvm.contrib import nvcc
@@ -364,6 +366,148 @@ def _nms_loop(
     return ib.get()
 
 
+# The bitmask of the suppressed box pairs is only used when it takes at most this many bytes.
+_NMS_BITMASK_MAX_BYTES = 64 * 1024 * 1024
+
+
+def _use_bitmask_nms(batch_size, num_anchors):
+    """Whether the bitmask of a NMS with static shapes is small enough to be allocated."""
+    if not isinstance(batch_size, (int, tvm.tir.IntImm)):
+        return False
+    if not isinstance(num_anchors, (int, tvm.tir.IntImm)):
+        return False
+    batch_size = int(batch_size)
+    num_anchors = int(num_anchors)
+    return batch_size * num_anchors * ceil_div(num_anchors, 32) * 4 <= _NMS_BITMASK_MAX_BYTES
+
+
+def _nms_bitmask_loop(
+    ib,
+    batch_size,
+    top_k,
+    iou_threshold,
+    max_output_size,
+    valid_count,
+    on_new_valid_box_func,
+    on_new_invalidated_box_func,
+    needs_bbox_check_func,
+    calc_overlap_func,
+    out_scores,
+    num_valid_boxes,
+    num_anchors,
+):
+    """The same NMS as _nms_loop, with the IoU tests of every box pair done upfront by a
+    kernel over the whole device. Bit k of word w of row j of the bitmask tells whether the
+    box j suppresses the box w * 32 + k. A CUDA block per batch then walks the boxes in score
+    order, merging the rows of the boxes it keeps into the shared bitmask of the suppressed
+    boxes, which makes each step a few word ORs instead of a pass of IoU tests."""
+    max_threads = int(tvm.target.Target.current(allow_none=False).max_num_threads)
+    num_words = ceil_div(num_anchors, 32)
+    mask = ib.allocate(
+        "uint32", (batch_size, num_anchors, num_words), name="nms_mask", scope="global"
+    )
+
+    def get_nkeep(i):
+        return if_then_else(tvm.tir.all(top_k > 0, top_k < valid_count[i]), top_k, valid_count[i])
+
+    with ib.new_scope():
+        nthread_tx = max_threads
+        nthread_bx = ceil_div(num_anchors * num_words, max_threads)
+        tx = te.thread_axis("threadIdx.x")
+        bx = te.thread_axis("blockIdx.x")
+        by = te.thread_axis("blockIdx.y")
+        ib.scope_attr(by, "thread_extent", batch_size)
+        ib.scope_attr(tx, "thread_extent", nthread_tx)
+        ib.scope_attr(bx, "thread_extent", nthread_bx)
+        i = by
+        tid = bx * nthread_tx + tx
+        j = tid // num_words
+        w = tid % num_words
+        nkeep = get_nkeep(i)
+
+        with ib.if_scope(tvm.tir.all(iou_threshold > 0, j < nkeep)):
+            bits = ib.allocate("uint32", (1,), name="bits", scope="local")
+            bits[0] = tvm.tir.const(0, "uint32")
+            with ib.for_range(0, 32, kind="unroll", name="b") as b:
+                k = w * 32 + b
+                with ib.if_scope(
+                    tvm.tir.all(
+                        k > j, k < nkeep, out_scores[i, k] > 0, needs_bbox_check_func(i, j, k)
+                    )
+                ):
+                    with ib.if_scope(calc_overlap_func(i, j, k) >= iou_threshold):
+                        bits[0] = bits[0] | (tvm.tir.const(1, "uint32") << b.astype("uint32"))
+            mask[i, j, w] = bits[0]
+
+    with ib.new_scope():
+        nthread_tx = max_threads
+        # See _nms_loop for the register limit of these architectures.
+        target = tvm.target.Target.current(allow_none=False)
+        if target.kind.name == "cuda":
+            if nvcc.get_target_compute_version(target) in ["3.2", "5.3", "6.2"]:
+                nthread_tx = 512
+
+        by = te.thread_axis("blockIdx.y")
+        tx = te.thread_axis("threadIdx.x")
+        ib.scope_attr(by, "thread_extent", batch_size)
+        ib.scope_attr(tx, "thread_extent", nthread_tx)
+        i = by
+        nkeep = get_nkeep(i)
+        max_output_size = if_then_else(max_output_size > 0, max_output_size, nkeep)
+
+        removed = ib.allocate("uint32", (num_words,), name="removed", scope="shared")
+        num_valid_boxes_local = ib.allocate(
+            "int32", (1,), name="num_valid_boxes_local", scope="local"
+        )
+        num_valid_boxes_local[0] = 0
+
+        with ib.for_range(0, ceil_div(num_words, nthread_tx), name="t") as t:
+            with ib.if_scope(t * nthread_tx + tx < num_words):
+                removed[t * nthread_tx + tx] = tvm.tir.const(0, "uint32")
+        ib.emit(tvm.tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"])))
+
+        with ib.if_scope(tvm.tir.all(iou_threshold > 0, valid_count[i] > 0)):
+            box_idx = ib.allocate("int32", (1,), name="box_idx", scope="local")
+            box_idx[0] = 0
+            with ib.while_loop(
+                tvm.tir.all(box_idx[0] < nkeep, num_valid_boxes_local[0] < max_output_size)
+            ):
+                j = box_idx[0]
+                is_removed = (removed[j // 32] >> (j % 32).astype("uint32")) & tvm.tir.const(
+                    1, "uint32"
+                )
+                # Every thread sees the same removed words here, so they all take the branch.
+                with ib.if_scope(tvm.tir.all(is_removed == 0, out_scores[i, j] > -1.0)):
+                    on_new_valid_box_func(ib, tx, num_valid_boxes_local[0], i, j)
+                    num_valid_boxes_local[0] += 1
+                    with ib.for_range(0, ceil_div(num_words, nthread_tx), name="t") as t:
+                        w = t * nthread_tx + tx
+                        with ib.if_scope(w < num_words):
+                            removed[w] = removed[w] | mask[i, j, w]
+                    ib.emit(
+                        tvm.tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"]))
+                    )
+                box_idx[0] += 1
+
+            with ib.for_range(0, ceil_div(nkeep, nthread_tx), name="t") as t:
+                k = t * nthread_tx + tx
+                with ib.if_scope(k < nkeep):
+                    is_removed = (removed[k // 32] >> (k % 32).astype("uint32")) & tvm.tir.const(
+                        1, "uint32"
+                    )
+                    with ib.if_scope(is_removed != 0):
+                        out_scores[i, k] = -1.0
+                        on_new_invalidated_box_func(i, k)
+
+            with ib.if_scope(tx + 0 == 0):
+                num_valid_boxes[i] = num_valid_boxes_local[0]
+
+        with ib.else_scope():
+            num_valid_boxes[i] = 0
+
+    return ib.get()
+
+
 def nms_ir(
     data,
     sorted_index,
@@ -585,7 +729,11 @@ def nms_ir(
             out_class_ids[i, k] == out_class_ids[i, j],
         )
 
-    return _nms_loop(
+    nms_loop = _nms_loop
+    if _use_bitmask_nms(batch_size, num_anchors):
+        nms_loop = functools.partial(_nms_bitmask_loop, num_anchors=num_anchors)
+
+    return nms_loop(
         ib,
         batch_size,
         top_k,
@@ -1110,6 +1258,10 @@ def all_class_non_max_suppression(
     sorted_scores, sorted_indices = _dispatch_sort(scores, ret_type="both")
     valid_count = _get_valid_box_count(sorted_scores, score_threshold)
 
+    nms_loop = _nms_loop
+    if _use_bitmask_nms(batch * num_class, num_boxes):
+        nms_loop = functools.partial(_nms_bitmask_loop, num_anchors=num_boxes)
+
     selected_indices, selected_scores, num_detections = run_all_class_nms(
         boxes,
         sorted_scores,
@@ -1117,7 +1269,7 @@ def all_class_non_max_suppression(
         valid_count,
         max_output_boxes_per_class,
         iou_threshold,
-        _nms_loop,
+        nms_loop,
         return_scores=(output_format == "tensorflow"),
     )
 
@@ -0,0 +1,188 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, unused-variable, too-many-locals
+"""Generic int8 dense declaration and schedules for the CPUs with dot product instructions"""
+import tvm
+from tvm import te
+from tvm import autotvm
+from tvm.autotvm.task.space import SplitEntity
+from ..utils import get_const_tuple
+
+
+def dense_int8_weight_layout(int32_lanes, num_int8_elements=4):
+    """The layout of the weight packed for the dot product instructions.
+
+    The weight of shape (N, K) is packed into (N // int32_lanes, K // num_int8_elements,
+    int32_lanes, num_int8_elements), so that the inner most block is the kernel[int32_lanes,
+    num_int8_elements] operand of one instruction.
+    """
+    return "NC%dn%dc" % (int32_lanes, num_int8_elements)
+
+
+def is_dense_int8_packable(data_shape, weight_shape, int32_lanes, num_int8_elements=4):
+    """Check whether the weight of a static dense can be packed for the dot product
+    instructions."""
+    shapes = [get_const_tuple(data_shape), get_const_tuple(weight_shape)]
+    if not all(isinstance(dim, int) for shape in shapes for dim in shape):
+        return False
+    (_, K), weight_shape = shapes
+    if len(weight_shape) == 4:
+        return weight_shape[2:] == (int32_lanes, num_int8_elements)
+    N = weight_shape[0]
+    return len(weight_shape) == 2 and N % int32_lanes == 0 and K % num_int8_elements == 0
+
+
+def _default_dense_int8_config(cfg, M, NO, KO):
+    tiley_i = 1
+    for bm in range(8, 0, -1):
+        if M % bm == 0:
+            tiley_i = bm
+            break
+    tilex_i = 1
+    for bn in range(4, 0, -1):
+        if NO % bn == 0:
+            tilex_i = bn
+            break
+    tilek_i = 1
+    for bk in range(64, 0, -1):
+        if KO % bk == 0:
+            tilek_i = bk
+            break
+    cfg["tile_y"] = SplitEntity([M // tiley_i, tiley_i])
+    cfg["tile_x"] = SplitEntity([NO // tilex_i, tilex_i])
+    cfg["tile_k"] = SplitEntity([KO // tilek_i, tilek_i])
+
+
+def dense_int8_packed(cfg, data, weight, out_dtype, int32_lanes, num_int8_elements=4):
+    """Compute an int8 dense on a weight packed for the dot product instructions.
+
+    Parameters
+    ----------
+    cfg : ConfigEntity
+        The config of the tuning space.
+    data : tvm.te.Tensor
+        2-D with shape [M, K].
+    weight : tvm.te.Tensor
+        2-D with shape [N, K], or already packed, see dense_int8_weight_layout.
+    out_dtype : str
+        The accumulation dtype.
+    int32_lanes : int
+        How many numbers of int32/uint32 are produced by one instruction.
+    num_int8_elements : int
+        How many numbers of int8/uint8 are reduced into each of them.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        2-D with shape [M, N].
+    """
+    M, K = get_const_tuple(data.shape)
+    if len(weight.shape) == 4:
+        NO, KO, _, _ = get_const_tuple(weight.shape)
+        packw = weight
+    else:
+        N, _ = get_const_tuple(weight.shape)
+        NO, KO = N // int32_lanes, K // num_int8_elements
+        packw_shape = (NO, KO, int32_lanes, num_int8_elements)
+        if autotvm.GLOBAL_SCOPE.in_tuning:
+            # Directly use modified data layout placeholder.
+            packw = te.placeholder(packw_shape, weight.dtype, name="packed_weight")
+        else:
+            packw = te.compute(
+                packw_shape,
+                lambda xo, ko, xi, ki: weight[
+                    xo * int32_lanes + xi, ko * num_int8_elements + ki
+                ],
+                name="packed_weight",
+            )
+    N = NO * int32_lanes
+
+    cfg.define_split("tile_y", M, num_outputs=2)
+    cfg.define_split("tile_x", NO, num_outputs=2)
+    cfg.define_split("tile_k", KO, num_outputs=2)
+    cfg.add_flop(2 * M * N * K)
+    if cfg.is_fallback:
+        _default_dense_int8_config(cfg, M, NO, KO)
+
+    idxdiv = tvm.tir.indexdiv
+    idxmod = tvm.tir.indexmod
+    ko = te.reduce_axis((0, KO), name="ko")
+    ki = te.reduce_axis((0, num_int8_elements), name="ki")
+    return te.compute(
+        (M, N),
+        lambda y, x: te.sum(
+            data[y, ko * num_int8_elements + ki].astype(out_dtype)
+            * packw[idxdiv(x, int32_lanes), ko, idxmod(x, int32_lanes), ki].astype(out_dtype),
+            axis=[ko, ki],
+        ),
+        tag="dense_int8_packed",
+    )
+
+
+def schedule_dense_int8_packed(cfg, s, C, O, int32_lanes, intrin):
+    """Schedule an int8 dense on a packed weight, tensorizing the inner most block with a dot
+    product instruction.
+
+    Parameters
+    ----------
+    cfg : ConfigEntity
+        The config of the tuning space.
+    s : tvm.te.Schedule
+        The schedule.
+    C : tvm.te.Tensor
+        The output of dense_int8_packed.
+    O : tvm.te.Tensor
+        The output of the fused operator, C or an elementwise stage on top of it.
+    int32_lanes : int
+        How many numbers of int32/uint32 are produced by the instruction.
+    intrin : TensorIntrin
+        The intrinsic computing output[int32_lanes] from data[num_int8_elements] and
+        kernel[int32_lanes, num_int8_elements].
+    """
+    _, packw = s[C].op.input_tensors
+    if isinstance(packw.op, te.tensor.ComputeOp) and packw.name == "packed_weight":
+        xo, ko, xi, ki = s[packw].op.axis
+        s[packw].parallel(xo)
+        s[packw].vectorize(ki)
+
+    def _split_output(stage):
+        y, x = stage.op.axis
+        xo, xi = stage.split(x, factor=int32_lanes)
+        yo, yi = cfg["tile_y"].apply(s, stage, y)
+        xoo, xoi = cfg["tile_x"].apply(s, stage, xo)
+        return yo, xoo, yi, xoi, xi
+
+    (ko, ki) = s[C].op.reduce_axis
+    if C == O:
+        yo, xoo, yi, xoi, xi = _split_output(s[C])
+        koo, koi = cfg["tile_k"].apply(s, C, ko)
+        s[C].reorder(yo, xoo, koo, yi, xoi, koi, xi, ki)
+        fused = s[C].fuse(yo, xoo)
+        s[C].parallel(fused)
+    else:
+        yo, xoo, yi, xoi, xi = _split_output(s[O])
+        s[O].reorder(yo, xoo, yi, xoi, xi)
+        fused = s[O].fuse(yo, xoo)
+        s[O].parallel(fused)
+        s[O].vectorize(xi)
+        s[C].compute_at(s[O], fused)
+        y, x = s[C].op.axis
+        xo, xi = s[C].split(x, factor=int32_lanes)
+        koo, koi = cfg["tile_k"].apply(s, C, ko)
+        s[C].reorder(koo, y, xo, koi, xi, ki)
+    s[C].tensorize(xi, intrin)
+    return s
@@ -631,6 +631,23 @@ def schedule_dense(outs):
     return _default_schedule(outs, False)
 
 
+def schedule_weight_only_dense(outs):
+    """Schedule for weight_only_dense
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+          The computation graph description of weight_only_dense
+          in the format of an array of tensors.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
+    return _default_schedule(outs, False)
+
+
 def schedule_pool(outs, layout):
     """Schedule for pool
 
@@ -20,3 +20,4 @@
 # pylint: disable=wildcard-import
 
 from .conv2d import *
+from .tensor_intrin import *
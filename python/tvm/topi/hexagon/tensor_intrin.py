@@ -0,0 +1,122 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""HVX tensor intrinsics for Hexagon."""
+import tvm
+from tvm import te
+
+
+def dot_vrmpy(x_ty="uint8", y_ty="int8"):
+    """
+    Int8 dot product by every 4 elements using the HVX vrmpy instructions.
+    This function takes two arrays of 8 bit integers -- data[4] and
+    kernel[32][4] -- and computes a dot product of data[4] with every
+    4 elements of kernels, resulting in output[32] of int32 datatype.
+    The pseudo code is as follows.
+    .. code-block:: c
+        void dot_vrmpy(uint8 data[4], int8 kernel[32][4], int32 output[32]){
+            for (int i = 0; i < 32; i++){
+                output[i] = 0;
+                for (int k = 0; k < 4; k++){
+                    output[i] += data[k] * kernel[i][k]
+                }
+            }
+        }
+
+    Physically, the kernel array fills a 128 byte HVX vector register and
+    the data[4] is broadcasted to another one. This function returns a
+    TensorIntrin that can be used to tensorize a schedule.
+
+    Parameters
+    ----------
+    x_ty : str
+        The data type of data, "uint8".
+
+    y_ty : str
+        The data type of kernel, "int8" or "uint8".
+
+    Returns
+    -------
+    intrin : TensorIntrin
+        The HVX int8 TensorIntrin that can be used in tensorizing schedule
+    """
+    assert x_ty == "uint8" and y_ty in ("int8", "uint8"), "unsupported types %s, %s" % (x_ty, y_ty)
+    int32_lanes = 32  # 32 int32 lanes in a 128 byte HVX vector
+    num_int8_elements = 4  # 4 int8 elements in int32
+    data = te.placeholder((num_int8_elements,), dtype=x_ty, name="data")
+    kernel = te.placeholder((int32_lanes, num_int8_elements), dtype=y_ty, name="kernel")
+    k = te.reduce_axis((0, num_int8_elements), name="k")
+    C = te.compute(
+        (int32_lanes,),
+        lambda i: te.sum(data[k].astype("int32") * kernel[i, k].astype("int32"), axis=k),
+        name="C",
+    )
+
+    a_buffer = tvm.tir.decl_buffer(
+        data.shape, dtype=x_ty, name="a_buffer", offset_factor=1, strides=[1]
+    )
+    b_buffer = tvm.tir.decl_buffer(
+        kernel.shape, dtype=y_ty, name="b_buffer", offset_factor=1, strides=[te.var("ldw"), 1]
+    )
+
+    # Vu.ub times Vv.b for a signed kernel, Vu.ub times Vv.ub for an unsigned one.
+    inst_name = "vrmpybusv" if y_ty == "int8" else "vrmpyubv"
+
+    def _intrin_func(ins, outs):
+        def _instr(index):
+            ib = tvm.tir.ir_builder.create()
+            if index == 1:
+                ib.emit(outs[0].vstore(0, tvm.tir.const(0, "int32x32")))
+                return ib.get()
+
+            a_int8 = ins[0].vload([0], x_ty + "x4")
+            re_int32 = tvm.tir.call_intrin("int32", "tir.reinterpret", a_int8)
+            vec_ai32 = tvm.tir.call_llvm_pure_intrin(
+                "int32x32", "llvm.hexagon.V6.lvsplatw.128B", tvm.tir.const(0, "uint32"), re_int32
+            )
+            vec_b = ins[1].vload([0, 0], y_ty + "x128")
+            vec_bi32 = tvm.tir.call_intrin("int32x32", "tir.reinterpret", vec_b)
+
+            if index == 0:
+                quad_reduction = tvm.tir.call_llvm_pure_intrin(
+                    "int32x32",
+                    "llvm.hexagon.V6.%s.128B" % inst_name,
+                    tvm.tir.const(0, "uint32"),
+                    vec_ai32,
+                    vec_bi32,
+                )
+            else:
+                quad_reduction = tvm.tir.call_llvm_pure_intrin(
+                    "int32x32",
+                    "llvm.hexagon.V6.%s.acc.128B" % inst_name,
+                    tvm.tir.const(0, "uint32"),
+                    outs[0].vload([0], "int32x32"),
+                    vec_ai32,
+                    vec_bi32,
+                )
+            ib.emit(outs[0].vstore(0, quad_reduction))
+            return ib.get()
+
+        # body, reset, update
+        return _instr(0), _instr(1), _instr(2)
+
+    buffer_params = {"offset_factor": 1}
+    return te.decl_tensor_intrin(
+        C.op,
+        _intrin_func,
+        binds={data: a_buffer, kernel: b_buffer},
+        default_buffer_params=buffer_params,
+    )
@@ -42,6 +42,7 @@ from .local_response_norm import *
 from .bitserial_conv2d import *
 from .bitserial_dense import *
 from .batch_matmul import *
+from .attention import *
 from .sparse import *
 from .pad import *
 from .fifo_buffer import *
@@ -0,0 +1,243 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Fused scaled dot product attention"""
+import tvm
+from tvm import te
+from ..utils import get_const_int, ceil_div
+
+
+def _fused_attention_ir(query, key, value, out, scale, block_size):
+    """Online softmax attention, one query row at a time. The keys are visited by
+    blocks, whose scores are the only ones kept, and the running maximum rescales the
+    partial sums whenever a block raises it."""
+    ib = tvm.tir.ir_builder.create()
+    batch, q_len, dim = query.shape
+    kv_len = key.shape[1]
+    v_dim = get_const_int(value.shape[2])
+    acc_dtype = "float32" if query.dtype == "float16" else query.dtype
+
+    q = ib.buffer_ptr(query)
+    k = ib.buffer_ptr(key)
+    v = ib.buffer_ptr(value)
+    o = ib.buffer_ptr(out)
+
+    with ib.for_range(0, batch * q_len, kind="parallel", name="row") as row:
+        b = row // q_len
+        i = row % q_len
+        acc = ib.allocate(acc_dtype, (v_dim,), name="acc", scope="local")
+        scores = ib.allocate(acc_dtype, (block_size,), name="scores", scope="local")
+        row_max = ib.allocate(acc_dtype, (1,), name="row_max", scope="local")
+        row_sum = ib.allocate(acc_dtype, (1,), name="row_sum", scope="local")
+        dot = ib.allocate(acc_dtype, (1,), name="dot", scope="local")
+        block_max = ib.allocate(acc_dtype, (1,), name="block_max", scope="local")
+        row_max[0] = tvm.tir.min_value(acc_dtype)
+        row_sum[0] = tvm.tir.const(0, acc_dtype)
+        with ib.for_range(0, v_dim, name="d") as d:
+            acc[d] = tvm.tir.const(0, acc_dtype)
+
+        with ib.for_range(0, ceil_div(kv_len, block_size), name="kb") as kb:
+            block_max[0] = row_max[0]
+            with ib.for_range(0, block_size, name="j") as j:
+                jj = kb * block_size + j
+                with ib.if_scope(jj < kv_len):
+                    dot[0] = tvm.tir.const(0, acc_dtype)
+                    with ib.for_range(0, dim, name="d") as d:
+                        dot[0] += q[b, i, d].astype(acc_dtype) * k[b, jj, d].astype(acc_dtype)
+                    scores[j] = dot[0] * tvm.tir.const(scale, acc_dtype)
+                    block_max[0] = tvm.te.max(block_max[0], scores[j])
+
+            correction = ib.let("correction", tvm.te.exp(row_max[0] - block_max[0]))
+            row_sum[0] *= correction
+            with ib.for_range(0, v_dim, name="d") as d:
+                acc[d] *= correction
+            row_max[0] = block_max[0]
+
+            with ib.for_range(0, block_size, name="j") as j:
+                jj = kb * block_size + j
+                with ib.if_scope(jj < kv_len):
+                    p = ib.let("p", tvm.te.exp(scores[j] - row_max[0]))
+                    row_sum[0] += p
+                    with ib.for_range(0, v_dim, name="d") as d:
+                        acc[d] += p * v[b, jj, d].astype(acc_dtype)
+
+        with ib.for_range(0, v_dim, name="d") as d:
+            o[b, i, d] = (acc[d] / row_sum[0]).astype(out.dtype)
+
+    return ib.get()
+
+
+def fused_attention(query, key, value, scale=1.0, block_size=64):
+    """Scaled dot product attention computed without storing the attention matrix.
+
+    .. math::
+
+        out[b, :, :] = softmax(scale * query[b, :, :] key[b, :, :]^T) value[b, :, :]
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        3-D with shape [batch, q_len, dim], the heads of a multi-head attention being
+        folded into the batch
+
+    key : tvm.te.Tensor
+        3-D with shape [batch, kv_len, dim]
+
+    value : tvm.te.Tensor
+        3-D with shape [batch, kv_len, v_dim], v_dim being static
+
+    scale : float, optional
+        The factor of the query-key products
+
+    block_size : int, optional
+        The number of keys whose scores are kept at once
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        3-D with shape [batch, q_len, v_dim]
+    """
+    assert len(query.shape) == 3 and len(key.shape) == 3 and len(value.shape) == 3
+    out_shape = (query.shape[0], query.shape[1], value.shape[2])
+    out_buf = tvm.tir.decl_buffer(out_shape, query.dtype, "out_buf")
+    return te.extern(
+        [out_shape],
+        [query, key, value],
+        lambda ins, outs: _fused_attention_ir(ins[0], ins[1], ins[2], outs[0], scale, block_size),
+        out_buffers=[out_buf],
+        dtype=query.dtype,
+        name="fused_attention",
+        tag="fused_attention",
+    )
+
+
+def _paged_attention_ir(query, key_cache, value_cache, block_table, seq_lens, out, scale):
+    """Online softmax attention of one query per head, the keys and the values of each
+    sequence being read from the cache blocks listed by its block table. A cache block is
+    the unit of the running maximum, as the key blocks of the fused attention."""
+    ib = tvm.tir.ir_builder.create()
+    batch, num_heads, dim = query.shape
+    block_size = get_const_int(key_cache.shape[1])
+    max_blocks = block_table.shape[1]
+    v_dim = get_const_int(value_cache.shape[3])
+    acc_dtype = "float32" if query.dtype == "float16" else query.dtype
+
+    q = ib.buffer_ptr(query)
+    k = ib.buffer_ptr(key_cache)
+    v = ib.buffer_ptr(value_cache)
+    table = ib.buffer_ptr(block_table)
+    lens = ib.buffer_ptr(seq_lens)
+    o = ib.buffer_ptr(out)
+
+    with ib.for_range(0, batch * num_heads, kind="parallel", name="row") as row:
+        b = row // num_heads
+        h = row % num_heads
+        seq_len = ib.let("seq_len", lens[b])
+        acc = ib.allocate(acc_dtype, (v_dim,), name="acc", scope="local")
+        scores = ib.allocate(acc_dtype, (block_size,), name="scores", scope="local")
+        row_max = ib.allocate(acc_dtype, (1,), name="row_max", scope="local")
+        row_sum = ib.allocate(acc_dtype, (1,), name="row_sum", scope="local")
+        dot = ib.allocate(acc_dtype, (1,), name="dot", scope="local")
+        block_max = ib.allocate(acc_dtype, (1,), name="block_max", scope="local")
+        row_max[0] = tvm.tir.min_value(acc_dtype)
+        row_sum[0] = tvm.tir.const(0, acc_dtype)
+        with ib.for_range(0, v_dim, name="d") as d:
+            acc[d] = tvm.tir.const(0, acc_dtype)
+
+        with ib.for_range(0, max_blocks, name="kb") as kb:
+            with ib.if_scope(kb * block_size < seq_len):
+                block = ib.let("block", table[b, kb])
+                block_max[0] = row_max[0]
+                with ib.for_range(0, block_size, name="j") as j:
+                    with ib.if_scope(kb * block_size + j < seq_len):
+                        dot[0] = tvm.tir.const(0, acc_dtype)
+                        with ib.for_range(0, dim, name="d") as d:
+                            dot[0] += q[b, h, d].astype(acc_dtype) * k[block, j, h, d].astype(
+                                acc_dtype
+                            )
+                        scores[j] = dot[0] * tvm.tir.const(scale, acc_dtype)
+                        block_max[0] = tvm.te.max(block_max[0], scores[j])
+
+                correction = ib.let("correction", tvm.te.exp(row_max[0] - block_max[0]))
+                row_sum[0] *= correction
+                with ib.for_range(0, v_dim, name="d") as d:
+                    acc[d] *= correction
+                row_max[0] = block_max[0]
+
+                with ib.for_range(0, block_size, name="j") as j:
+                    with ib.if_scope(kb * block_size + j < seq_len):
+                        p = ib.let("p", tvm.te.exp(scores[j] - row_max[0]))
+                        row_sum[0] += p
+                        with ib.for_range(0, v_dim, name="d") as d:
+                            acc[d] += p * v[block, j, h, d].astype(acc_dtype)
+
+        with ib.for_range(0, v_dim, name="d") as d:
+            o[b, h, d] = (acc[d] / row_sum[0]).astype(out.dtype)
+
+    return ib.get()
+
+
+def paged_attention(query, key_cache, value_cache, block_table, seq_lens, scale=1.0):
+    """Attention of one decoding step, the keys and the values being in a paged cache.
+
+    The position p of the sequence b is the row p % block_size of the cache block
+    block_table[b, p // block_size], as laid out by tvm.runtime.vm.PagedKVCache.
+
+    .. math::
+
+        out[b, h, :] = softmax(scale * query[b, h, :] K_{b,h}^T) V_{b,h}
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        3-D with shape [batch, num_heads, dim]
+
+    key_cache : tvm.te.Tensor
+        4-D with shape [num_blocks, block_size, num_heads, dim], block_size being static
+
+    value_cache : tvm.te.Tensor
+        4-D with shape [num_blocks, block_size, num_heads, v_dim], v_dim being static
+
+    block_table : tvm.te.Tensor
+        2-D int32 with shape [batch, max_blocks], the cache blocks of each sequence
+
+    seq_lens : tvm.te.Tensor
+        1-D int32 with shape [batch], the positive number of positions of each sequence
+
+    scale : float, optional
+        The factor of the query-key products
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        3-D with shape [batch, num_heads, v_dim]
+    """
+    assert len(query.shape) == 3 and len(key_cache.shape) == 4 and len(value_cache.shape) == 4
+    assert len(block_table.shape) == 2 and len(seq_lens.shape) == 1
+    out_shape = (query.shape[0], query.shape[1], value_cache.shape[3])
+    out_buf = tvm.tir.decl_buffer(out_shape, query.dtype, "out_buf")
+    return te.extern(
+        [out_shape],
+        [query, key_cache, value_cache, block_table, seq_lens],
+        lambda ins, outs: _paged_attention_ir(
+            ins[0], ins[1], ins[2], ins[3], ins[4], outs[0], scale
+        ),
+        out_buffers=[out_buf],
+        dtype=query.dtype,
+        name="paged_attention",
+        tag="paged_attention",
+    )
@@ -140,6 +140,28 @@ def conv2d_alter_layout(attrs, inputs, tinfos, out_type):
     return None
 
 
+@tvm.target.generic_func
+def conv2d_layout_candidates(attrs, tinfos, out_type):
+    """Get the layouts Conv2D can be altered to, for the global layout planning.
+
+    Parameters
+    ----------
+    attrs : tvm.ir.Attrs
+        Attributes of current convolution
+    tinfos : list
+        Input shape and dtype
+    out_type: type
+        The output type
+
+    Returns
+    -------
+    candidates : list of (str, str, float)
+        The data layout, the output layout and the estimated compute cost of each candidate.
+    """
+    # no candidate by default
+    return []
+
+
 @tvm.target.generic_func
 def conv2d_infer_layout(workload, cfg):
     """Infer input/output shapes and layouts from a workload and cfg.
@@ -253,6 +253,64 @@ def dense_pack(data, weight, bias=None, out_dtype=None):
     return C
 
 
+def weight_only_dense(data, weight, scales, bits=4, group_size=128, out_dtype=None):
+    """Dense of float data and weights quantized by groups of the input dimension.
+
+    The weights are dequantized inside the reduction, never in memory, so only the packed
+    weights and the scales are read.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        2-D with shape [batch, in_dim]
+
+    weight : tvm.te.Tensor
+        With bits = 8, int8 with shape [out_dim, in_dim]. With bits = 4, uint8 with shape
+        [out_dim, in_dim / 2], the weight of the input k being biased by 8 in the low half
+        of the byte k / 2 when k is even, in the high half when k is odd.
+
+    scales : tvm.te.Tensor
+        2-D with shape [out_dim, in_dim / group_size]
+
+    bits : int
+        The number of bits of a weight, 4 or 8
+
+    group_size : int
+        The number of inputs sharing a scale
+
+    out_dtype : Optional[str]
+        The output type, the one of data by default
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        2-D with shape [batch, out_dim]
+    """
+    assert bits in (4, 8), "weight_only_dense supports 4 and 8 bit weights, not %d" % bits
+    if out_dtype is None:
+        out_dtype = data.dtype
+    M, K = data.shape
+    N = weight.shape[0]
+    idxdiv = tvm.tir.indexdiv
+    idxmod = tvm.tir.indexmod
+
+    def dequantize(j, k):
+        if bits == 8:
+            value = weight[j, k].astype("int32")
+        else:
+            byte = weight[j, idxdiv(k, 2)].astype("int32")
+            value = ((byte >> (idxmod(k, 2) * 4)) & 15) - 8
+        return value.astype(out_dtype) * scales[j, idxdiv(k, group_size)].astype(out_dtype)
+
+    k = te.reduce_axis((0, K), name="k")
+    return te.compute(
+        (M, N),
+        lambda i, j: te.sum(data[i, k].astype(out_dtype) * dequantize(j, k), axis=k),
+        name="T_weight_only_dense",
+        tag="weight_only_dense",
+    )
+
+
 @tvm.target.generic_func
 def dense_alter_layout(attrs, inputs, tinfos, out_type):
     """Change dense layout.
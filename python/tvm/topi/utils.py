@@ -80,6 +80,27 @@ def traverse_inline(s, final_op, callback):
     _traverse(final_op)
 
 
+def inline_injective_inputs(s, tensor):
+    """Inline the injective stages computing an input of an anchor op, such as a layout
+    transform fused before it, so that the anchor reads the input through their index mapping.
+    The padding stages are kept, they are scheduled by the anchor.
+
+    Parameters
+    ----------
+    s: schedule
+        The schedule
+    tensor: Tensor
+        The input of the anchor op
+    """
+    op = tensor.op
+    if not isinstance(op, tvm.te.ComputeOp) or not tag.is_injective(op.tag):
+        return
+    if "pad" not in op.tag and op not in s.outputs:
+        s[op].compute_inline()
+    for input_tensor in op.input_tensors:
+        inline_injective_inputs(s, input_tensor)
+
+
 def prod(x):
     """Get the product of every items in the tuple.
 
@@ -28,7 +28,7 @@ from ..nn.conv2d import conv2d_infer_layout, _get_workload as _get_conv2d_worklo
 from ..nn.conv2d import unpack_NCHWc_to_nchw
 from ..nn.depthwise_conv2d import _get_workload as _get_depthwise_conv2d_workload
 from ..nn.utils import get_pad_tuple
-from ..utils import get_const_tuple, traverse_inline
+from ..utils import get_const_tuple, inline_injective_inputs, traverse_inline
 from . import conv2d_avx_1x1, conv2d_avx_common
 
 logger = logging.getLogger("topi")
@@ -248,6 +248,7 @@ def schedule_conv2d_NCHWc(cfg, outs):
             conv_out = op.output(0)
             kernel_vec = conv_out.op.input_tensors[1]
             data_vec = conv_out.op.input_tensors[0]
+            inline_injective_inputs(s, data_vec)
 
             args = [s, cfg, data_vec, kernel_vec, conv_out, outs[0]]
             (
@@ -17,6 +17,7 @@
 # pylint: disable=invalid-name,unused-variable,unused-argument,no-member
 """Conv2D alter op and legalize functions for x86"""
 
+import copy
 import logging
 
 import re
@@ -24,10 +25,12 @@ import tvm
 from tvm import te
 from tvm import relay
 from tvm import autotvm
+from tvm.autotvm.task.space import SplitEntity
 from .conv2d import _get_default_config
 from .conv2d_int8 import is_int8_hw_support, _get_default_config_int8
+from .utils import get_simd_32bit_lanes
 from ..utils import get_const_tuple
-from ..nn import conv2d_legalize, conv2d_alter_layout
+from ..nn import conv2d_legalize, conv2d_alter_layout, conv2d_layout_candidates
 from ..nn.utils import get_pad_tuple
 
 logger = logging.getLogger("topi")
@@ -36,6 +39,47 @@ _NCHWc_matcher = re.compile("^NCHW[0-9]+c$")
 _OIHWio_matcher = re.compile("^OIHW[0-9]+i[0-9]+o$")
 
 
+@conv2d_layout_candidates.register("cpu")
+def _conv2d_layout_candidates(attrs, tinfos, out_type):
+    target = tvm.target.Target.current(allow_none=False)
+    dispatch_ctx = autotvm.task.DispatchContext.current
+    if isinstance(dispatch_ctx, autotvm.task.ApplyGraphBest):
+        # The graph tuner already chose the layouts of the whole graph.
+        return []
+    if attrs["data_layout"] != "NCHW" or attrs["kernel_layout"] != "OIHW":
+        return []
+    _, outs = relay.backend.te_compiler.select_implementation(
+        relay.op.get("nn.conv2d"), attrs, tinfos, out_type, target
+    )
+    workload = autotvm.task.get_workload(outs)
+    if workload is None or workload[0] != "conv2d_NCHWc.x86":
+        return []
+
+    cfg = dispatch_ctx.query(target, workload)
+    if not cfg.is_fallback:
+        # A tuned config keeps its blocking, its neighbors adapt to it.
+        ic_bn, oc_bn = cfg["tile_ic"].size[-1], cfg["tile_oc"].size[-1]
+        return [("NCHW%dc" % ic_bn, "NCHW%dc" % oc_bn, tvm.tir.const(0, "float64"))]
+
+    data_tensor, kernel_tensor = tinfos
+    in_channel = get_const_tuple(data_tensor.shape)[1]
+    out_channel, _, kh, kw = get_const_tuple(kernel_tensor.shape)
+    flops = 2.0 * in_channel * kh * kw
+    for dim in get_const_tuple(out_type.shape):
+        flops *= dim
+    simd_width = get_simd_32bit_lanes()
+    candidates = []
+    for oc_bn in [bn for bn in range(1, simd_width + 1) if out_channel % bn == 0]:
+        for ic_bn in [bn for bn in range(1, simd_width + 1) if in_channel % bn == 0]:
+            # The output channel block fills the vector lanes, while the input channel block
+            # only unrolls the reduction.
+            cost = flops * simd_width / oc_bn * (1 + 1.0 / (8 * ic_bn))
+            candidates.append(
+                ("NCHW%dc" % ic_bn, "NCHW%dc" % oc_bn, tvm.tir.const(cost, "float64"))
+            )
+    return candidates
+
+
 @conv2d_alter_layout.register("cpu")
 def _alter_conv2d_layout(attrs, inputs, tinfos, out_type):
     target = tvm.target.Target.current(allow_none=False)
@@ -110,6 +154,14 @@ def _alter_conv2d_layout(attrs, inputs, tinfos, out_type):
             batch_size, in_channel, height, width = get_const_tuple(data_tensor.shape)
             out_channel, _, kh, kw = get_const_tuple(kernel_tensor.shape)
             ic_bn, oc_bn = cfg["tile_ic"].size[-1], cfg["tile_oc"].size[-1]
+            planned = relay.transform.planned_layout_candidate()
+            if cfg.is_fallback and planned is not None:
+                # Use the channel blocking of the global layout plan. The fallback config is
+                # shared by the convolutions of the same workload, so it is copied.
+                ic_bn, oc_bn = int(str(planned[0])[4:-1]), int(str(planned[1])[4:-1])
+                cfg = copy.deepcopy(cfg)
+                cfg["tile_ic"] = SplitEntity([in_channel // ic_bn, ic_bn])
+                cfg["tile_oc"] = SplitEntity([out_channel // oc_bn, oc_bn])
 
             # update new attrs
             new_attrs["channels"] = out_channel
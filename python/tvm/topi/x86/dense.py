@@ -27,11 +27,29 @@ from tvm.contrib import mkl
 from tvm.contrib import mkldnn
 
 from .utils import get_simd_32bit_lanes
+from .tensor_intrin import dot_16x1x16_uint8_int8_int32
+from .tensor_intrin import gemm_fp32_micro_kernel, gemm_fp32_micro_kernel_rows
 from .. import generic, tag
+from ..generic import dense as dense_generic
 from ..utils import traverse_inline, get_const_tuple
 
 
-def _schedule_dense_pack_template(cfg, s, C, O):
+def is_dense_micro_kernel_applicable(out_type, packw_bn=None):
+    """
+    Checks whether a dense can use the fp32 micro-kernel schedule
+    1) The shapes are static.
+    2) The output features, and the block of the packed weight when given, are whole
+       vectors of float32.
+    """
+    vec_width = get_simd_32bit_lanes()
+    if not all(isinstance(dim, tvm.tir.IntImm) for dim in out_type.shape):
+        return False
+    if packw_bn is not None:
+        return isinstance(packw_bn, tvm.tir.IntImm) and packw_bn.value % vec_width == 0
+    return out_type.shape[-1].value % vec_width == 0
+
+
+def _schedule_dense_pack_template(cfg, s, C, O, micro_kernel=False):
     A, packedB = s[C].op.input_tensors
 
     CC = s.cache_write(C, "global")
@@ -51,19 +69,28 @@ def _schedule_dense_pack_template(cfg, s, C, O):
     s[CC].compute_at(s[C], xyo)
     y, x = s[CC].op.axis
     ko, ki = cfg["tile_k"].apply(s, CC, k)
-    s[CC].reorder(ko, ki, y, x)
-    s[CC].vectorize(x)
-
-    tile_inner = cfg["tile_inner"].size[-1]
-    if tile_inner > 1:
-        yo, yi = s[CC].split(y, tile_inner)
-        s[CC].reorder(ko, yo, ki, yi, x)
+    if micro_kernel:
+        # the block of C of each call stays in registers
+        cols = cfg["tile_x"].size[-1]
+        rows = gemm_fp32_micro_kernel_rows(cfg["tile_y"].size[-1], cols // get_simd_32bit_lanes())
+        yo, yi = s[CC].split(y, rows)
+        s[CC].reorder(ko, yo, yi, x, ki)
         s[CC].unroll(yo)
-        s[CC].unroll(ki)
-        s[CC].unroll(yi)
+        s[CC].tensorize(yi, gemm_fp32_micro_kernel(rows, cols, cfg["tile_k"].size[-1]))
     else:
-        s[CC].unroll(ki)
-        s[CC].unroll(y)
+        s[CC].reorder(ko, ki, y, x)
+        s[CC].vectorize(x)
+
+        tile_inner = cfg["tile_inner"].size[-1]
+        if tile_inner > 1:
+            yo, yi = s[CC].split(y, tile_inner)
+            s[CC].reorder(ko, yo, ki, yi, x)
+            s[CC].unroll(yo)
+            s[CC].unroll(ki)
+            s[CC].unroll(yi)
+        else:
+            s[CC].unroll(ki)
+            s[CC].unroll(y)
 
     if C != O:
         y, x = s[O].op.axis
@@ -98,7 +125,7 @@ def _schedule_dense_nopack_template(cfg, s, C):
     return s
 
 
-def _default_dense_pack_config(cfg, M, N, K):
+def _default_dense_pack_config(cfg, M, N, K, micro_kernel=False):
     # Generate default schedule for dynamic shape.
     if isinstance(M, (tvm.tir.Var, tvm.tir.Any)):
         M = 16
@@ -109,7 +136,8 @@ def _default_dense_pack_config(cfg, M, N, K):
 
     vec_width = get_simd_32bit_lanes()
     tilex_ii = 1
-    for bn in range(vec_width * 2, 0, -1):
+    # the micro-kernel only takes whole vectors of columns
+    for bn in range(vec_width * 2, 0, -vec_width if micro_kernel else -1):
         if N % bn == 0:
             tilex_ii = bn
             break
@@ -132,7 +160,8 @@ def _default_dense_pack_config(cfg, M, N, K):
 
     cfg["tile_y"] = SplitEntity([MM // tiley_oi, tiley_oi, tiley_ii])
     cfg["tile_x"] = SplitEntity([NN // tilex_oi, tilex_oi, tilex_ii])
-    cfg["tile_k"] = SplitEntity([K, 1])
+    # the micro-kernel keeps its accumulators in registers during the whole reduction
+    cfg["tile_k"] = SplitEntity([1, K] if micro_kernel else [K, 1])
     cfg["tile_inner"] = SplitEntity([M // tiley_ii, tiley_ii])
 
 
@@ -206,9 +235,7 @@ def schedule_dense_nopack(cfg, outs):
     return s
 
 
-@autotvm.register_topi_compute("dense_pack.x86")
-def dense_pack(cfg, data, weight, bias=None, out_dtype=None):
-    """Compute dense with transformed weight."""
+def _dense_pack_compute(cfg, data, weight, bias, out_dtype, micro_kernel=False):
     if out_dtype is None:
         out_dtype = data.dtype
     M, K = get_const_tuple(data.shape)  # batch, in_dim
@@ -221,9 +248,13 @@ def dense_pack(cfg, data, weight, bias=None, out_dtype=None):
     cfg.define_split(
         "tile_y", 32 if isinstance(M, (tvm.tir.Var, tvm.tir.Any)) else M, num_outputs=3
     )
-    cfg.define_split(
-        "tile_x", 32 if isinstance(N, (tvm.tir.Var, tvm.tir.Any)) else N, num_outputs=3
-    )
+    if micro_kernel:
+        vec_width = get_simd_32bit_lanes()
+        cfg.define_split("tile_x", N, num_outputs=3, filter=lambda x: x.size[-1] % vec_width == 0)
+    else:
+        cfg.define_split(
+            "tile_x", 32 if isinstance(N, (tvm.tir.Var, tvm.tir.Any)) else N, num_outputs=3
+        )
     cfg.define_split(
         "tile_k", 32 if isinstance(K, (tvm.tir.Var, tvm.tir.Any)) else K, num_outputs=2
     )
@@ -234,7 +265,7 @@ def dense_pack(cfg, data, weight, bias=None, out_dtype=None):
         filter=lambda y: y.size[-1] <= 16,
     )
     if cfg.is_fallback:
-        _default_dense_pack_config(cfg, M, N, K)
+        _default_dense_pack_config(cfg, M, N, K, micro_kernel)
 
     if len(weight.shape) == 2:
         packw_bn = cfg["tile_x"].size[-1]
@@ -266,6 +297,12 @@ def dense_pack(cfg, data, weight, bias=None, out_dtype=None):
     return C
 
 
+@autotvm.register_topi_compute("dense_pack.x86")
+def dense_pack(cfg, data, weight, bias=None, out_dtype=None):
+    """Compute dense with transformed weight."""
+    return _dense_pack_compute(cfg, data, weight, bias, out_dtype)
+
+
 @autotvm.register_topi_schedule("dense_pack.x86")
 def schedule_dense_pack(cfg, outs):
     """Create the schedule for dense_pack"""
@@ -279,6 +316,54 @@ def schedule_dense_pack(cfg, outs):
     return s
 
 
+@autotvm.register_topi_compute("dense_pack_micro_kernel.x86")
+def dense_pack_micro_kernel(cfg, data, weight, bias=None, out_dtype=None):
+    """Compute fp32 dense with transformed weight, for the register-blocked micro-kernel.
+    The shapes must be static and the output features a multiple of the float32 lanes."""
+    return _dense_pack_compute(cfg, data, weight, bias, out_dtype, micro_kernel=True)
+
+
+@autotvm.register_topi_schedule("dense_pack_micro_kernel.x86")
+def schedule_dense_pack_micro_kernel(cfg, outs):
+    """Create the schedule for dense_pack_micro_kernel, tensorizing the blocks of the output
+    onto gemm_fp32_micro_kernel"""
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if "dense_pack" in op.tag:
+            _schedule_dense_pack_template(cfg, s, op.output(0), outs[0], micro_kernel=True)
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
+
+
+@autotvm.register_topi_compute("dense_vnni.x86")
+def dense_vnni(cfg, data, weight, bias=None, out_dtype=None):
+    """Compute uint8 x int8 dense on a weight packed in the NC16n4c layout, for VNNI."""
+    if out_dtype is None:
+        out_dtype = "int32"
+    C = dense_generic.dense_int8_packed(cfg, data, weight, out_dtype, int32_lanes=16)
+    if bias is not None:
+        M, N = get_const_tuple(C.shape)
+        C = te.compute((M, N), lambda i, j: C[i, j] + bias[j].astype(out_dtype), tag=tag.BROADCAST)
+    return C
+
+
+@autotvm.register_topi_schedule("dense_vnni.x86")
+def schedule_dense_vnni(cfg, outs):
+    """Create the schedule for dense_vnni"""
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if "dense_int8_packed" in op.tag:
+            dense_generic.schedule_dense_int8_packed(
+                cfg, s, op.output(0), outs[0], 16, dot_16x1x16_uint8_int8_int32()
+            )
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
+
+
 def matmul_blas_common(cfg, tensor_a, tensor_b, bias, out_dtype, transpose_a, transpose_b, lib):
     """Compute matmul/dense using a BLAS library"""
     M, K = get_const_tuple(tensor_a.shape)
@@ -386,3 +471,24 @@ def matmul_mkldnn(
 def schedule_matmul_mkldnn(_, outs):
     """Create schedule for matmul_mkldnn."""
     return generic.schedule_extern(outs)
+
+
+def schedule_weight_only_dense(outs):
+    """Create schedule for weight_only_dense, one output element per parallel iteration, the
+    reduction being unrolled by weight bytes."""
+    outs = [outs] if isinstance(outs, te.tensor.Tensor) else outs
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if op.tag == "weight_only_dense":
+            C = op.output(0)
+            out = outs[0]
+            fused = s[out].fuse(*s[out].op.axis)
+            s[out].parallel(fused)
+            if C.op != out.op:
+                s[C].compute_at(s[out], fused)
+            _, ki = s[C].split(s[C].op.reduce_axis[0], factor=8)
+            s[C].unroll(ki)
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
@@ -24,6 +24,7 @@ from tvm import autotvm
 from .dense import _default_dense_pack_config
 from ..utils import get_const_tuple
 from ..nn import dense_alter_layout
+from ..generic.dense import dense_int8_weight_layout
 
 
 @dense_alter_layout.register(["cpu", "arm_cpu"])
@@ -43,9 +44,11 @@ def _alter_dense_layout(attrs, inputs, tinfos, out_type):
     if workload:
         cfg = dispatch_ctx.query(target, workload)
         topi_impl = workload[0]
-        if topi_impl == "dense_pack.x86":
+        if topi_impl in ["dense_pack.x86", "dense_pack_micro_kernel.x86"]:
             if cfg.is_fallback:
-                _default_dense_pack_config(cfg, M, N, K)
+                _default_dense_pack_config(
+                    cfg, M, N, K, micro_kernel=topi_impl == "dense_pack_micro_kernel.x86"
+                )
             packw_bn = cfg["tile_x"].size[-1]
             weight_layout = "NC%dn" % packw_bn
             new_weight = te.placeholder(
@@ -64,5 +67,18 @@ def _alter_dense_layout(attrs, inputs, tinfos, out_type):
             )
             dispatch_ctx.update(target, new_workload, cfg)
             return relay.nn.contrib_dense_pack(inputs[0], inputs[1], weight_layout, None, out_dtype)
+        if topi_impl in ["dense_vnni.x86", "dense_int8.arm_cpu"]:
+            # Pack the weight once at compile time into the blocks the dot product
+            # instructions read.
+            int32_lanes = 16 if topi_impl == "dense_vnni.x86" else 4
+            new_weight = te.placeholder(
+                (N // int32_lanes, K // 4, int32_lanes, 4), dtype=weight_tensor.dtype
+            )
+            new_workload = autotvm.task.args_to_workload(
+                [data_tensor, new_weight, None, out_dtype], topi_impl
+            )
+            dispatch_ctx.update(target, new_workload, cfg)
+            weight_layout = dense_int8_weight_layout(int32_lanes)
+            return relay.nn.contrib_dense_pack(inputs[0], inputs[1], weight_layout, None, out_dtype)
 
     return None
@@ -20,6 +20,7 @@ import tvm
 from tvm import te
 import tvm.target.codegen
 from .utils import target_has_sse42, target_has_vnni, get_simd_32bit_lanes
+from .utils import get_simd_num_registers
 
 
 def dot_16x1x16_uint8_int8_int32():
@@ -348,3 +349,121 @@ def dot_16x1x16_uint8_int8_int32_cascadelake():
         binds={data: a_buffer, kernel: b_buffer},
         default_buffer_params=buffer_params,
     )
+
+
+def gemm_fp32_micro_kernel_rows(tile_rows, num_vecs):
+    """The largest divisor of tile_rows for which the accumulators of a micro-kernel
+    with num_vecs vectors per row, the vectors of B and the broadcast of A fit in the
+    SIMD registers of the current target."""
+    num_regs = get_simd_num_registers()
+    rows = 1
+    for r in range(1, tile_rows + 1):
+        if tile_rows % r == 0 and (r + 1) * num_vecs + 1 <= num_regs:
+            rows = r
+    return rows
+
+
+def gemm_fp32_micro_kernel(rows, cols, reduce_len, lanes=None):
+    """
+    Register-blocked fp32 GEMM micro-kernel, for the FMA, AVX-512 and NEON targets.
+    This function takes two arrays of float32 -- A[rows][reduce_len] and
+    B[reduce_len][cols] -- and accumulates their product into C[rows][cols].
+    The pseudo code is as follows.
+    .. code-block:: c
+        void gemm_fp32_micro_kernel(float A[rows][reduce_len], float B[reduce_len][cols],
+                float C[rows][cols]){
+            for (int k = 0; k < reduce_len; k++){
+                for (int i = 0; i < rows; i++){
+                    for (int j = 0; j < cols; j++){
+                        C[i][j] += A[i][k] * B[k][j];
+                    }
+                }
+            }
+        }
+
+    The block of C stays in rows * cols / lanes vector registers during the whole
+    reduction. Each step loads cols / lanes vectors of B and broadcasts one element of A
+    per row, and LLVM contracts the multiply-adds into FMA instructions. The block
+    should be sized with gemm_fp32_micro_kernel_rows so that nothing spills.
+
+    Parameters
+    ----------
+    rows : int
+        The number of rows of the block of C.
+
+    cols : int
+        The number of columns of the block of C, a multiple of lanes.
+
+    reduce_len : int
+        The length of the reduction done by one call.
+
+    lanes : int, optional
+        The number of float32 lanes of a vector register, defaults to the one of the
+        current target.
+
+    Returns
+    -------
+    intrin : TensorIntrin
+        The fp32 TensorIntrin that can be used in tensorizing schedule
+    """
+    if lanes is None:
+        lanes = get_simd_32bit_lanes()
+    assert cols % lanes == 0, "The columns of the micro-kernel must fill whole vectors."
+    num_vecs = cols // lanes
+    vec_type = "float32x%d" % lanes
+
+    A = te.placeholder((rows, reduce_len), dtype="float32", name="A")
+    B = te.placeholder((reduce_len, cols), dtype="float32", name="B")
+    k = te.reduce_axis((0, reduce_len), name="k")
+    C = te.compute((rows, cols), lambda i, j: te.sum(A[i, k] * B[k, j], axis=k), name="C")
+
+    a_buffer = tvm.tir.decl_buffer(
+        A.shape, dtype="float32", name="a_buffer", offset_factor=1, strides=[te.var("lda"), 1]
+    )
+    b_buffer = tvm.tir.decl_buffer(
+        B.shape, dtype="float32", name="b_buffer", offset_factor=1, strides=[te.var("ldb"), 1]
+    )
+    c_buffer = tvm.tir.decl_buffer(
+        C.shape, dtype="float32", name="c_buffer", offset_factor=1, strides=[te.var("ldc"), 1]
+    )
+
+    def _intrin_func(ins, outs):
+        a, b = ins
+        c = outs[0]
+
+        def _instr(index):
+            ib = tvm.tir.ir_builder.create()
+            if index == 1:
+                for i in range(rows):
+                    for v in range(num_vecs):
+                        ib.emit(c.vstore([i, v * lanes], tvm.tir.const(0, vec_type)))
+                return ib.get()
+
+            acc = ib.allocate(vec_type, (rows * num_vecs,), name="acc", scope="local")
+            for i in range(rows):
+                for v in range(num_vecs):
+                    if index == 0:
+                        acc[i * num_vecs + v] = tvm.tir.const(0, vec_type)
+                    else:
+                        acc[i * num_vecs + v] = c.vload([i, v * lanes], vec_type)
+            with ib.for_range(0, reduce_len, name="k") as kk:
+                vec_b = [b.vload([kk, v * lanes], vec_type) for v in range(num_vecs)]
+                for i in range(rows):
+                    vec_a = tvm.tir.Broadcast(a.vload([i, kk], "float32"), lanes)
+                    for v in range(num_vecs):
+                        acc[i * num_vecs + v] = acc[i * num_vecs + v] + vec_a * vec_b[v]
+            for i in range(rows):
+                for v in range(num_vecs):
+                    ib.emit(c.vstore([i, v * lanes], acc[i * num_vecs + v]))
+            return ib.get()
+
+        # body, reset, update
+        return _instr(0), _instr(1), _instr(2)
+
+    buffer_params = {"offset_factor": 1}
+    return te.decl_tensor_intrin(
+        C.op,
+        _intrin_func,
+        binds={A: a_buffer, B: b_buffer, C: c_buffer},
+        default_buffer_params=buffer_params,
+    )
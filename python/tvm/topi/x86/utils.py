@@ -110,3 +110,11 @@ def get_simd_32bit_lanes():
     elif target_has_avx2(mcpu):
         fp32_vec_len = 8
     return fp32_vec_len
+
+
+def get_simd_num_registers():
+    """The number of SIMD registers a register-blocked kernel can use on the current target."""
+    target = tvm.target.Target.current()
+    if "arm_cpu" in target.keys or target_has_avx512(target.mcpu):
+        return 32
+    return 16
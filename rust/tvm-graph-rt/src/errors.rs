@@ -38,6 +38,16 @@ pub enum GraphFormatError {
     UnsupportedOp(String),
 }
 
+#[derive(Debug, Error)]
+pub enum InputError {
+    #[error("Unknown input: {0}")]
+    UnknownInput(String),
+    #[error("Input {0} needs {1} bytes but the buffer has {2}")]
+    SizeMismatch(String, usize, usize),
+    #[error("The buffer of input {0} is not aligned to {1} bytes")]
+    Misaligned(String, usize),
+}
+
 #[derive(Debug, Error)]
 #[error("Function {0} not found")]
 pub struct FunctionNotFound(pub String);
@@ -33,7 +33,7 @@ use serde_json;
 
 use tvm_sys::ffi::{DLDataTypeCode_kDLFloat, DLDataTypeCode_kDLInt, DLDataTypeCode_kDLUInt};
 
-use tvm_sys::{ffi::DLTensor, ArgValue, DataType, Device, DeviceType};
+use tvm_sys::{ffi::DLTensor, packed_func::PackedFunc, ArgValue, DataType, Device, DeviceType};
 
 use crate::{errors::*, Module, Storage, Tensor};
 
@@ -41,6 +41,8 @@ use crate::{errors::*, Module, Storage, Tensor};
 const _NDARRAY_MAGIC: u64 = 0xDD5E_40F0_96B4_A13F;
 // @see `kTVMNDArrayListMagic` in `graph_executor.h`
 const _NDARRAY_LIST_MAGIC: u64 = 0xF7E5_8D4F_0504_9CB7;
+// @see `kAllocAlignment` in `device_api.h`
+const ALLOC_ALIGNMENT: usize = 64;
 
 /// A TVM computation graph.
 ///
@@ -180,33 +182,54 @@ impl<'a> TryFrom<&'a str> for Graph {
 ///
 /// println!("{:#?}", Array::try_from(output).unwrap());
 /// ```
+///
+/// The storages of the graph are slices of one arena, laid out from the storage plan of the
+/// graph. An input can borrow the buffer of the caller instead of being copied into the arena,
+/// see `set_input_zero_copy`.
 pub struct GraphExecutor<'m, 't> {
     graph: Graph,
-    op_execs: Vec<Box<dyn Fn() + 'm>>,
+    op_execs: Vec<OpExec<'m>>,
     tensors: Vec<Tensor<'t>>,
+    // the storage of the tensors, which are views of it
+    _arena: Storage<'static>,
+}
+
+/// A call of a library function, with the arguments of the node.
+struct OpExec<'m> {
+    func: &'m dyn PackedFunc,
+    func_name: String,
+    args: Vec<DLTensor>,
+    // the index in `tensors` of each argument
+    arg_indices: Vec<usize>,
 }
 
 unsafe impl<'m, 't> Send for GraphExecutor<'m, 't> {}
 
 impl<'m, 't> GraphExecutor<'m, 't> {
     pub fn new<M: 'm + Module>(graph: Graph, lib: &'m M) -> Result<Self, Box<dyn Error>> {
-        let tensors = Self::setup_storages(&graph)?;
+        let (arena, tensors) = Self::setup_storages(&graph)?;
         Ok(GraphExecutor {
             op_execs: Self::setup_op_execs(&graph, lib, &tensors)?,
             tensors,
             graph,
+            _arena: arena,
         })
     }
 
     /// Runs the computation graph.
     pub fn run(&mut self) {
-        self.op_execs.iter().for_each(|op_exec| {
-            op_exec();
-        });
+        for op_exec in self.op_execs.iter() {
+            let args: Vec<ArgValue> = op_exec.args.iter().map(|t| t.into()).collect();
+            if (op_exec.func)(&args).is_err() {
+                panic!("Function {} failed to execute", op_exec.func_name);
+            }
+        }
     }
 
-    /// Allocates `Storages` for each `storage_id` and returns `Tensor`s to hold each output.
-    fn setup_storages<'a>(graph: &'a Graph) -> Result<Vec<Tensor<'t>>, Box<dyn Error>> {
+    /// Allocates the arena of the storages and returns `Tensor`s to hold each output.
+    fn setup_storages<'a>(
+        graph: &'a Graph,
+    ) -> Result<(Storage<'static>, Vec<Tensor<'t>>), Box<dyn Error>> {
         let storage_ids = graph.get_attr::<(String, Vec<usize>)>("storage_id")?.1;
         let shapes = graph.get_attr::<(String, Vec<Vec<i64>>)>("shape")?.1;
         let dtypes = graph
@@ -222,7 +245,6 @@ impl<'m, 't> GraphExecutor<'m, 't> {
             })
             .collect::<Result<Vec<DataType>, GraphFormatError>>()?;
 
-        let align = dtypes.iter().map(|dtype| dtype.bits() as usize).max();
         let mut storage_num_bytes = vec![0usize; *storage_ids.iter().max().unwrap_or(&1) + 1];
         for (i, &storage_id) in storage_ids.iter().enumerate() {
             let dtype_size = (dtypes[i].bits() * dtypes[i].lanes()) >> 3;
@@ -230,16 +252,25 @@ impl<'m, 't> GraphExecutor<'m, 't> {
             storage_num_bytes[storage_id] = cmp::max(nbytes, storage_num_bytes[storage_id]);
         }
 
-        let mut storages: Vec<Storage> = storage_num_bytes
-            .into_iter()
-            .map(|nbytes| Storage::new(nbytes, align))
-            .collect::<Result<Vec<Storage>, std::alloc::LayoutError>>()?;
+        // each storage starts at a multiple of the alignment of the allocations of TVM
+        let mut storage_offsets = Vec::with_capacity(storage_num_bytes.len());
+        let mut arena_num_bytes = 0;
+        for &nbytes in storage_num_bytes.iter() {
+            storage_offsets.push(arena_num_bytes);
+            arena_num_bytes += (nbytes + ALLOC_ALIGNMENT - 1) / ALLOC_ALIGNMENT * ALLOC_ALIGNMENT;
+        }
+        let arena = Storage::new(cmp::max(arena_num_bytes, 1), Some(ALLOC_ALIGNMENT))?;
 
         let tensors = izip!(storage_ids, shapes, dtypes)
             .map(|(storage_id, shape, dtype)| {
-                let storage = storages[storage_id].view();
+                let data = unsafe {
+                    std::slice::from_raw_parts_mut(
+                        arena.as_mut_ptr().add(storage_offsets[storage_id]),
+                        storage_num_bytes[storage_id],
+                    )
+                };
                 Tensor {
-                    data: mem::replace(&mut storages[storage_id], storage),
+                    data: Storage::View(data, ALLOC_ALIGNMENT),
                     device: Device::default(),
                     dtype,
                     size: shape.iter().product::<i64>() as usize,
@@ -250,7 +281,7 @@ impl<'m, 't> GraphExecutor<'m, 't> {
             })
             .collect();
 
-        Ok(tensors)
+        Ok((arena, tensors))
     }
 
     /// Creates closures which represent the computation performed by this graph.
@@ -258,7 +289,7 @@ impl<'m, 't> GraphExecutor<'m, 't> {
         graph: &Graph,
         lib: &'m M,
         tensors: &[Tensor<'t>],
-    ) -> Result<Vec<Box<dyn Fn() + 'm>>, Box<dyn Error + 'static>> {
+    ) -> Result<Vec<OpExec<'m>>, Box<dyn Error + 'static>> {
         if !graph.node_row_ptr.is_some() {
             return Err(GraphFormatError::MissingField("node_row_ptr").into());
         }
@@ -289,28 +320,26 @@ impl<'m, 't> GraphExecutor<'m, 't> {
                 .inputs
                 .iter()
                 .map(|entry| graph.entry_index(entry))
-                .chain((0..attrs.num_outputs).map(|oi| Ok(node_row_ptr[i] + oi)));
+                .chain((0..attrs.num_outputs).map(|oi| Ok(node_row_ptr[i] + oi)))
+                .collect::<Result<Vec<usize>, GraphFormatError>>()?;
 
-            let dl_tensors: Vec<DLTensor> = arg_indices
-                .map(|idx| {
-                    let tensor = &tensors[idx?];
-                    Ok(if attrs.flatten_data {
+            let args: Vec<DLTensor> = arg_indices
+                .iter()
+                .map(|&idx| {
+                    let tensor = &tensors[idx];
+                    if attrs.flatten_data {
                         Tensor::as_dltensor(tensor, true /* flatten */)
                     } else {
                         DLTensor::from(tensor)
-                    })
+                    }
                 })
-                .collect::<Result<Vec<DLTensor>, GraphFormatError>>()?
-                .into();
-            let op: Box<dyn Fn()> = Box::new(move || {
-                let args: Vec<ArgValue> = dl_tensors
-                    .iter()
-                    .map(|t| t.into())
-                    .collect::<Vec<ArgValue>>();
-                let err_str = format!("Function {} failed to execute", attrs.func_name);
-                func(&args).expect(&err_str);
+                .collect();
+            op_execs.push(OpExec {
+                func,
+                func_name: attrs.func_name,
+                args,
+                arg_indices,
             });
-            op_execs.push(op);
         }
         Ok(op_execs)
     }
@@ -344,6 +373,42 @@ impl<'m, 't> GraphExecutor<'m, 't> {
         }
     }
 
+    /// Binds the graph input `name` to the buffer `data` of the caller, without a copy.
+    ///
+    /// The operators then read the input from `data`, which `set_input` copies into. The
+    /// buffer must have the size of the input and be aligned to 64 bytes, like the allocations
+    /// of TVM, since the compiled operators may assume it.
+    pub fn set_input_zero_copy<S: AsRef<str>, T>(
+        &mut self,
+        name: S,
+        data: &'t mut [T],
+    ) -> Result<(), InputError> {
+        let name = name.as_ref();
+        let idx = self
+            .get_input_index(name)
+            .ok_or_else(|| InputError::UnknownInput(name.to_owned()))?;
+        let expected = self.tensors[idx].size * self.tensors[idx].dtype.itemsize();
+        let nbytes = data.len() * mem::size_of::<T>();
+        if nbytes != expected {
+            return Err(InputError::SizeMismatch(name.to_owned(), expected, nbytes));
+        }
+        let ptr = data.as_mut_ptr() as *mut u8;
+        if ptr as usize % ALLOC_ALIGNMENT != 0 {
+            return Err(InputError::Misaligned(name.to_owned(), ALLOC_ALIGNMENT));
+        }
+        let bytes = unsafe { std::slice::from_raw_parts_mut(ptr, nbytes) };
+        self.tensors[idx].data = Storage::View(bytes, ALLOC_ALIGNMENT);
+        // the arguments referring to the entry of the input read the new buffer
+        for op_exec in self.op_execs.iter_mut() {
+            for (arg, &arg_idx) in op_exec.args.iter_mut().zip(op_exec.arg_indices.iter()) {
+                if arg_idx == idx {
+                    arg.data = ptr as *mut std::os::raw::c_void;
+                }
+            }
+        }
+        Ok(())
+    }
+
     /// Returns the graph input with name `name`, if it exists.
     pub fn get_input<S: AsRef<str>>(&mut self, name: S) -> Option<&Tensor> {
         self.get_input_index(name.as_ref())
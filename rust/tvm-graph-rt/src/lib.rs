@@ -45,6 +45,7 @@ mod array;
 pub mod errors;
 mod graph;
 mod module;
+#[cfg(not(feature = "cpp-thread-pool"))]
 mod threading;
 mod workspace;
 
@@ -55,7 +56,9 @@ pub use tvm_sys::{
     ArgValue, RetValue,
 };
 
-pub use self::{array::*, errors::*, graph::*, module::*, threading::*, workspace::*};
+pub use self::{array::*, errors::*, graph::*, module::*, workspace::*};
+#[cfg(not(feature = "cpp-thread-pool"))]
+pub use self::threading::*;
 
 lazy_static! {
     static ref LAST_ERROR: std::sync::RwLock<Option<&'static std::ffi::CStr>> =
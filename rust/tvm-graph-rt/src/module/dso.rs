@@ -27,8 +27,14 @@ use std::{
 
 use tvm_sys::{ffi::BackendPackedCFunc, packed_func::PackedFunc};
 
+#[cfg(feature = "cpp-thread-pool")]
+use tvm_sys::ffi::{
+    FTVMParallelLambda, TVMBackendParallelBarrier, TVMBackendParallelLaunch, TVMParallelGroupEnv,
+};
+
+#[cfg(not(feature = "cpp-thread-pool"))]
+use crate::threading::{TVMBackendParallelBarrier, TVMBackendParallelLaunch};
 use crate::{
-    threading::{TVMBackendParallelBarrier, TVMBackendParallelLaunch},
     workspace::{TVMBackendAllocWorkspace, TVMBackendFreeWorkspace},
     TVMAPISetLastError,
 };
@@ -73,6 +79,11 @@ impl<'a> DsoModule<'a> {
                 TVMBackendFreeWorkspace,
                 unsafe extern "C" fn(c_int, c_int, *mut c_void) -> c_int
             ),
+        );
+
+        #[cfg(not(feature = "cpp-thread-pool"))]
+        init_context_func!(
+            lib,
             (
                 TVMBackendParallelLaunch,
                 unsafe extern "C" fn(
@@ -87,6 +98,20 @@ impl<'a> DsoModule<'a> {
             ),
         );
 
+        // the parallel loops run on the thread pool of the C++ runtime
+        #[cfg(feature = "cpp-thread-pool")]
+        init_context_func!(
+            lib,
+            (
+                TVMBackendParallelLaunch,
+                unsafe extern "C" fn(FTVMParallelLambda, *mut c_void, c_int) -> c_int
+            ),
+            (
+                TVMBackendParallelBarrier,
+                unsafe extern "C" fn(c_int, *mut TVMParallelGroupEnv) -> c_int
+            ),
+        );
+
         // Pin the module in memory so that `ctx` pointer (below) is stable.
         let dso_mod = Box::pin(Self {
             lib,
@@ -62,6 +62,7 @@ impl Job {
                 penv: TVMParallelGroupEnv {
                     sync_handle: &Arc::clone(&barrier) as *const _ as *mut c_void,
                     num_task: num_tasks as i32,
+                    thread_budget: 1,
                 },
                 cdata: self.cdata,
                 pending: Arc::clone(&self.pending),
@@ -188,6 +189,7 @@ pub extern "C" fn TVMBackendParallelLaunch(
         let penv = TVMParallelGroupEnv {
             sync_handle: std::ptr::null_mut(),
             num_task: 1,
+            thread_budget: 1,
         };
         cb(0, &penv as *const _, cdata);
     } else {
@@ -25,6 +25,9 @@ use tvm_graph_rt::{Graph, GraphExecutor, SystemLibModule, Tensor};
 const BATCH_SIZE: usize = 4;
 const IN_DIM: usize = 8;
 
+#[repr(align(64))]
+struct AlignedInput([f32; BATCH_SIZE * IN_DIM]);
+
 macro_rules! check_sum {
     ($e:expr, $a:ident, $b:ident) => {
         let a = Array::try_from($e.get_input(stringify!($a)).unwrap().to_owned()).unwrap();
@@ -59,6 +62,8 @@ fn main() {
         &fs::read_to_string(concat!(env!("OUT_DIR"), "/test_nn/graph.json")).unwrap(),
     )
     .unwrap();
+    // bound to the input without a copy, so it outlives the executor
+    let mut x_buf = AlignedInput([0f32; BATCH_SIZE * IN_DIM]);
     let mut exec = GraphExecutor::new(graph, &syslib).unwrap();
 
     let x = Array::from_shape_vec(
@@ -96,4 +101,13 @@ fn main() {
     check_sum!(exec, 0, expected_o0);
     check_sum!(exec, 1, expected_o1);
     check_sum!(exec, 2, dense);
+
+    x_buf.0.copy_from_slice(x.as_slice().unwrap());
+    exec.set_input_zero_copy("data", &mut x_buf.0).unwrap();
+    exec.run();
+
+    check_sum!(exec, data, x);
+    check_sum!(exec, 0, expected_o0);
+    check_sum!(exec, 1, expected_o1);
+    check_sum!(exec, 2, dense);
 }
@@ -24,10 +24,176 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <mutex>
+#include <unordered_set>
 
 namespace tvm {
 namespace arith {
 
+/*! \brief Merge the results computed in src into dst. */
+static void MergeMemoEntry(SimplifyMemo::Entry* dst, const SimplifyMemo::Entry& src) {
+  if (src.simplified.defined()) {
+    dst->simplified = src.simplified;
+    dst->steps = src.steps;
+  }
+  if (src.proved != -1) {
+    dst->proved = src.proved;
+  }
+}
+
+bool SimplifyMemo::Find(const PrimExpr& expr, Entry* entry) const {
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+  auto it = table_.find(expr);
+  if (it == table_.end()) return false;
+  *entry = it->second;
+  return true;
+}
+
+void SimplifyMemo::Insert(const PrimExpr& expr, const Entry& entry) {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+  if (table_.size() >= max_entries_ && !table_.count(expr)) {
+    table_.clear();
+  }
+  MergeMemoEntry(&table_[expr], entry);
+}
+
+void SimplifyMemo::Clear() {
+  std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+  table_.clear();
+}
+
+size_t SimplifyMemo::size() const {
+  std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+  return table_.size();
+}
+
+/*!
+ * \brief The memoized results of an analyzer.
+ *
+ *  A result only depends on the bindings of the variables of its expression, and of the
+ *  variables their values use, and on the constraints in effect. So binding a variable that
+ *  no memoized expression depends on keeps the results, and a result stored outside any
+ *  constraint for an expression depending on no bound variable holds for any analyzer.
+ */
+class Analyzer::MemoState {
+ public:
+  explicit MemoState(std::shared_ptr<SimplifyMemo> shared) : shared_(std::move(shared)) {
+    scopes_.emplace_back();
+  }
+
+  /*!
+   * \brief Find the results of an expression in the current constraint context.
+   * \param expr The expression.
+   * \param entry The entry found, or the entry to fill.
+   * \return Whether the entry was found.
+   */
+  bool Find(const PrimExpr& expr, SimplifyMemo::Entry* entry) {
+    const SimplifyMemo::Table& table = scopes_.back();
+    auto it = table.find(expr);
+    if (it != table.end()) {
+      *entry = it->second;
+      return true;
+    }
+    return shared_ != nullptr && IsShareable(expr) && shared_->Find(expr, entry);
+  }
+
+  /*! \brief Store the results of an expression computed in the current constraint context. */
+  void Insert(const PrimExpr& expr, const SimplifyMemo::Entry& entry) {
+    SimplifyMemo::Table& table = scopes_.back();
+    if (table.size() >= kMaxEntries && !table.count(expr)) {
+      table.clear();
+    }
+    MergeMemoEntry(&table[expr], entry);
+    std::vector<const VarNode*> deps = CollectDeps(expr);
+    used_vars_.insert(deps.begin(), deps.end());
+    if (shared_ != nullptr && IsShareable(deps)) {
+      shared_->Insert(expr, entry);
+    }
+  }
+
+  /*! \brief Update the memo after var was bound to value, undefined for a range. */
+  void Bind(const Var& var, const PrimExpr& value) {
+    bound_vars_.insert(var.get());
+    if (value.defined()) {
+      deps_[var.get()] = CollectDeps(value);
+    }
+    if (used_vars_.count(var.get())) {
+      Clear();
+    }
+  }
+
+  /*!
+   * \brief Start an empty table for a new constraint context.
+   * \return The function restoring the table of the enclosing context.
+   */
+  std::function<void()> EnterScope() {
+    scopes_.emplace_back();
+    size_t depth = scopes_.size();
+    return [this, depth]() {
+      ICHECK_EQ(scopes_.size(), depth) << "ConstraintContext exited out of order";
+      scopes_.pop_back();
+    };
+  }
+
+  /*! \brief Drop the results of all the constraint contexts. */
+  void Clear() {
+    for (SimplifyMemo::Table& table : scopes_) {
+      table.clear();
+    }
+    used_vars_.clear();
+  }
+
+ private:
+  /*! \brief The number of entries above which the table of a context is cleared. */
+  static constexpr size_t kMaxEntries = 1 << 16;
+
+  /*! \return The variables of expr, followed by the variables their values use. */
+  std::vector<const VarNode*> CollectDeps(const PrimExpr& expr) const {
+    std::vector<const VarNode*> vars;
+    std::unordered_set<const VarNode*> visited;
+    tir::PostOrderVisit(expr, [&](const ObjectRef& node) {
+      if (const auto* var = node.as<VarNode>()) {
+        if (visited.insert(var).second) vars.push_back(var);
+      }
+    });
+    // the values of the bound variables already hold their own dependencies
+    for (size_t i = 0, n = vars.size(); i < n; ++i) {
+      auto it = deps_.find(vars[i]);
+      if (it == deps_.end()) continue;
+      for (const VarNode* var : it->second) {
+        if (visited.insert(var).second) vars.push_back(var);
+      }
+    }
+    return vars;
+  }
+
+  bool IsShareable(const std::vector<const VarNode*>& deps) const {
+    if (scopes_.size() != 1) return false;
+    for (const VarNode* var : deps) {
+      if (bound_vars_.count(var)) return false;
+    }
+    return true;
+  }
+
+  bool IsShareable(const PrimExpr& expr) const {
+    if (scopes_.size() != 1) return false;
+    return bound_vars_.empty() || IsShareable(CollectDeps(expr));
+  }
+
+  /*! \brief The results of each constraint context, the innermost last. */
+  std::vector<SimplifyMemo::Table> scopes_;
+  /*! \brief The variables the memoized results may depend on. */
+  std::unordered_set<const VarNode*> used_vars_;
+  /*! \brief The variables bound so far. */
+  std::unordered_set<const VarNode*> bound_vars_;
+  /*! \brief The variables used by the value of each variable bound to an expression. */
+  std::unordered_map<const VarNode*, std::vector<const VarNode*>> deps_;
+  /*! \brief The memo shared with other analyzers, can be nullptr. */
+  std::shared_ptr<SimplifyMemo> shared_;
+};
+
 Analyzer::Analyzer()
     : const_int_bound(this),
       modular_set(this),
@@ -35,6 +201,8 @@ Analyzer::Analyzer()
       canonical_simplify(this),
       int_set(this) {}
 
+Analyzer::~Analyzer() = default;
+
 void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
   PrimExpr new_expr = expr;
   new_expr = this->canonical_simplify(new_expr);
@@ -44,6 +212,7 @@ void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
   this->modular_set.Update(var, this->modular_set(new_expr), allow_override);
   this->rewrite_simplify.Update(var, new_expr, allow_override);
   this->canonical_simplify.Update(var, new_expr, allow_override);
+  this->MemoBind(var, new_expr);
 }
 
 void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
@@ -52,6 +221,7 @@ void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
     this->Bind(var, range->min, allow_override);
   } else {
     this->const_int_bound.Bind(var, range, allow_override);
+    this->MemoBind(var, PrimExpr());
   }
   // skip modular_set
   // skip rewrite simplify
@@ -63,14 +233,34 @@ void Analyzer::Bind(const Map<Var, Range>& variables, bool allow_override) {
   }
 }
 
+void Analyzer::EnableMemo(std::shared_ptr<SimplifyMemo> shared_memo) {
+  ICHECK(!modified_) << "EnableMemo must be called before any Bind or ConstraintContext";
+  memo_ = std::make_unique<MemoState>(std::move(shared_memo));
+}
+
+void Analyzer::ClearMemo() {
+  if (memo_ != nullptr) memo_->Clear();
+}
+
+void Analyzer::MemoBind(const Var& var, const PrimExpr& value) {
+  modified_ = true;
+  if (memo_ != nullptr) memo_->Bind(var, value);
+}
+
 void ConstraintContext::EnterWithScope() {
   ICHECK(exit_ == nullptr);
   // entering the scope.
   auto f0 = analyzer_->const_int_bound.EnterConstraint(constraint_);
   auto f1 = analyzer_->modular_set.EnterConstraint(constraint_);
   auto f2 = analyzer_->rewrite_simplify.EnterConstraint(constraint_);
+  analyzer_->modified_ = true;
+  std::function<void()> f3 = nullptr;
+  if (analyzer_->memo_ != nullptr) {
+    f3 = analyzer_->memo_->EnterScope();
+  }
   // recovery function.
-  exit_ = [f0, f1, f2]() {
+  exit_ = [f0, f1, f2, f3]() {
+    if (f3 != nullptr) f3();
     if (f2 != nullptr) f2();
     if (f1 != nullptr) f1();
     if (f0 != nullptr) f0();
@@ -111,6 +301,20 @@ bool Analyzer::CanProve(const PrimExpr& expr) {
   if (const auto* ptr = expr.as<IntImmNode>()) {
     return ptr->value != 0;
   }
+  if (memo_ != nullptr) {
+    SimplifyMemo::Entry entry;
+    if (memo_->Find(expr, &entry) && entry.proved != -1) {
+      return entry.proved != 0;
+    }
+    entry = SimplifyMemo::Entry();
+    entry.proved = CanProveImpl(expr);
+    memo_->Insert(expr, entry);
+    return entry.proved != 0;
+  }
+  return CanProveImpl(expr);
+}
+
+bool Analyzer::CanProveImpl(const PrimExpr& expr) {
   auto res = this->rewrite_simplify(expr);
   if (const auto* ptr = res.as<IntImmNode>()) {
     return ptr->value != 0;
@@ -124,6 +328,21 @@ bool Analyzer::CanProve(const PrimExpr& expr) {
 
 PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
   if (tir::is_const_int(expr)) return expr;
+  if (memo_ != nullptr) {
+    SimplifyMemo::Entry entry;
+    if (memo_->Find(expr, &entry) && entry.simplified.defined() && entry.steps == steps) {
+      return entry.simplified;
+    }
+    entry = SimplifyMemo::Entry();
+    entry.simplified = SimplifyImpl(expr, steps);
+    entry.steps = steps;
+    memo_->Insert(expr, entry);
+    return entry.simplified;
+  }
+  return SimplifyImpl(expr, steps);
+}
+
+PrimExpr Analyzer::SimplifyImpl(const PrimExpr& expr, int steps) {
   PrimExpr res = expr;
   for (int i = 0; i < steps; ++i) {
     res = this->rewrite_simplify(res);
@@ -176,6 +395,8 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
           self->Bind(args[0], args[1].operator PrimExpr());
         }
       });
+    } else if (name == "enable_memo") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) { self->EnableMemo(); });
     } else if (name == "enter_constraint_context") {
       return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
         // can't use make_shared due to noexcept(false) decl in destructor,
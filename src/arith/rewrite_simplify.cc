@@ -1554,6 +1554,15 @@ PrimExpr RewriteSimplifier::Impl::VisitExpr_(const CallNode* op) {
       // the operator overload will eagerly constant fold.
       return op->args[0] << op->args[1];
     }
+  } else if (op->op.same_as(tir::builtin::bitwise_and()) ||
+             op->op.same_as(tir::builtin::bitwise_or()) ||
+             op->op.same_as(tir::builtin::bitwise_xor())) {
+    if (op->args[0].as<IntImmNode>() && op->args[1].as<IntImmNode>()) {
+      // the operator overload will eagerly constant fold.
+      if (op->op.same_as(tir::builtin::bitwise_and())) return op->args[0] & op->args[1];
+      if (op->op.same_as(tir::builtin::bitwise_or())) return op->args[0] | op->args[1];
+      return op->args[0] ^ op->args[1];
+    }
   }
   ExprDeepEqual expr_equal;
   if (op->op.same_as(tir::builtin::likely())) {
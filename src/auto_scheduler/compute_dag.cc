@@ -37,7 +37,9 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <mutex>
 #include <queue>
+#include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -58,6 +60,51 @@ using OperationSet = std::unordered_set<te::Operation, ObjectHash, ObjectEqual>;
 
 TVM_REGISTER_NODE_TYPE(ComputeDAGNode);
 
+/*!
+ * \brief The ranges of the iterators of the stages inferred for the states of a ComputeDAG.
+ *
+ *  The bounds of a state only depend on its transform steps, and the search infers them for
+ *  many states built by the same steps: the states inferred again before the redundancy
+ *  check, the mutations producing a known state and the measured states.
+ */
+class InferBoundCache {
+ public:
+  /*! \brief The ranges of the iterators of each stage, empty for the inlined stages. */
+  using StageRanges = std::vector<std::vector<Range>>;
+
+  /*! \return The key identifying the transform steps, their record. */
+  static std::string Key(const Array<Step>& transform_steps) {
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    for (const auto& step : transform_steps) {
+      writer.BeginArray(false);
+      step->WriteToRecord(&writer);
+      writer.EndArray();
+    }
+    return os.str();
+  }
+
+  bool Get(const std::string& key, StageRanges* ranges) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    *ranges = it->second;
+    return true;
+  }
+
+  void Set(const std::string& key, StageRanges ranges) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The search keeps exploring new states, forget the old ones rather than tracking uses
+    if (entries_.size() >= kMaxEntries) entries_.clear();
+    entries_[key] = std::move(ranges);
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 4096;
+  std::mutex mutex_;
+  std::unordered_map<std::string, StageRanges> entries_;
+};
+
 // Topo-sort ops from tensors according to their read-write relations.
 Array<te::Operation> TopoSortOps(const Array<te::Tensor>& tensors) {
   std::unordered_map<const te::OperationNode*, int> degree;
@@ -373,7 +420,9 @@ AccessAnalyzer::AccessAnalyzer(const Array<te::Tensor>& tensors) {
         }
 
         for (const auto& axis : cop->axis) {
-          if (GetIntImm(axis->dom->extent) > 1 && vars.count(axis->var.get()) == 0) {
+          // A symbolic extent, e.g. of a dynamic batch, may be larger than 1.
+          const auto* extent = axis->dom->extent.as<IntImmNode>();
+          if ((extent == nullptr || extent->value > 1) && vars.count(axis->var.get()) == 0) {
             n_missing++;
             break;
           }
@@ -701,6 +750,7 @@ ComputeDAG::ComputeDAG(Array<te::Tensor> tensors) {
 
   node->flop_ct = FlopEstimator().EstimateFlop(node->ops);
   node->init_state = State(node->ops);
+  node->bound_cache = std::make_shared<InferBoundCache>();
   data_ = std::move(node);
 }
 
@@ -728,6 +778,7 @@ ComputeDAG::ComputeDAG(const te::Schedule& sch) {
   node->access_analyzer = AccessAnalyzer(node->tensors);
   node->flop_ct = FlopEstimator().EstimateFlop(node->ops);
   node->init_state = State(node->ops);
+  node->bound_cache = std::make_shared<InferBoundCache>();
   data_ = std::move(node);
 }
 
@@ -900,6 +951,8 @@ ComputeDAG ComputeDAG::RewriteLayout(Array<Step>* transform_steps,
       << "Call ComputeDAG::RewriteLayout with NoRewrite.";
   ComputeDAG new_dag = *this;
   ComputeDAGNode* p_dag = new_dag.CopyOnWrite();
+  // The rewritten DAG has other ops, it must not share the bounds of this one
+  p_dag->bound_cache = std::make_shared<InferBoundCache>();
 
   auto node = make_object<StateNode>();
   node->transform_steps = *transform_steps;
@@ -1323,15 +1376,43 @@ State ComputeDAG::InferBound(const State& state) const {
     pstate = ret_state.CopyOnWrite();
   }
 
-  Array<te::Stage> stages;
-  StageToAxesMap stage_to_axes;
-  te::Schedule sch;
-  Array<te::Tensor> tensors;
-  // Replay steps to tvm::Schedule
-  std::tie(sch, tensors) = ApplySteps(pstate->transform_steps, &stages, &stage_to_axes);
-  sch = sch.normalize_for_feature_extraction();
-  // Get bound information from TVM schedule
-  Map<IterVar, Range> bounds = te::InferBound(sch);
+  InferBoundCache* cache = operator->()->bound_cache.get();
+  std::string key;
+  InferBoundCache::StageRanges ranges;
+  if (cache != nullptr) {
+    key = InferBoundCache::Key(pstate->transform_steps);
+  }
+  if (cache == nullptr || !cache->Get(key, &ranges)) {
+    Array<te::Stage> stages;
+    StageToAxesMap stage_to_axes;
+    te::Schedule sch;
+    Array<te::Tensor> tensors;
+    // Replay steps to tvm::Schedule
+    std::tie(sch, tensors) = ApplySteps(pstate->transform_steps, &stages, &stage_to_axes);
+    sch = sch.normalize_for_feature_extraction();
+    // Get bound information from TVM schedule
+    Map<IterVar, Range> bounds = te::InferBound(sch);
+
+    ranges.resize(pstate->stages.size());
+    for (size_t i = 0; i < pstate->stages.size(); ++i) {
+      const Stage& stage = pstate->stages[i];
+      if (stage->compute_at == ComputeAtKind::kInlined) {
+        continue;
+      }
+      // the StageToAxesMap is used to find the corresponding IterVar in TVM schedule result
+      for (const IterVar& axis : stage_to_axes.at(stages[i])) {
+        auto find_res = bounds.find(axis);
+        if (find_res == bounds.end()) {
+          LOG(FATAL) << "Infer bound fails";
+        }
+        ranges[i].push_back((*find_res).second);
+      }
+    }
+    if (cache != nullptr) {
+      cache->Set(key, ranges);
+    }
+  }
+  ICHECK_EQ(ranges.size(), pstate->stages.size());
 
   // Update the state bound information
   for (size_t i = 0; i < pstate->stages.size(); ++i) {
@@ -1343,19 +1424,11 @@ State ComputeDAG::InferBound(const State& state) const {
 
     Array<Iterator> new_iters;
     new_iters.reserve(stage->iters.size());
-    // Get bound information from schedule
-    // the StageToAxesMap is used to find the corresponding IterVar in TVM schedule result
+    ICHECK_EQ(ranges[i].size(), stage->iters.size());
     for (size_t j = 0; j < stage->iters.size(); ++j) {
       const Iterator& iter = stage->iters[j];
-      const IterVar& axis = stage_to_axes.at(stages[i])[j];
-
-      auto find_res = bounds.find(axis);
-      if (find_res != bounds.end()) {
-        new_iters.push_back(Iterator(iter->name, (*find_res).second, iter->iter_kind,
-                                     iter->annotation, &iter->orig_iters));
-      } else {
-        LOG(FATAL) << "Infer bound fails";
-      }
+      new_iters.push_back(Iterator(iter->name, ranges[i][j], iter->iter_kind, iter->annotation,
+                                   &iter->orig_iters));
     }
 
     pstate->stages.Set(
@@ -23,6 +23,17 @@
  */
 
 #include <tvm/auto_scheduler/cost_model.h>
+#include <tvm/auto_scheduler/feature.h>
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "picojson.h"
 
 namespace tvm {
 namespace auto_scheduler {
@@ -30,6 +41,7 @@ namespace auto_scheduler {
 TVM_REGISTER_OBJECT_TYPE(CostModelNode);
 TVM_REGISTER_OBJECT_TYPE(RandomModelNode);
 TVM_REGISTER_OBJECT_TYPE(PythonBasedModelNode);
+TVM_REGISTER_OBJECT_TYPE(GBTreeModelNode);
 
 RandomModel::RandomModel() {
   ObjectPtr<RandomModelNode> node = make_object<RandomModelNode>();
@@ -145,6 +157,194 @@ void PythonBasedModelNode::PredictStages(const SearchTask& task, const Array<Sta
   }
 }
 
+GBTreeModel::GBTreeModel(const std::string& model_json, PackedFunc update_func, int max_n_bufs) {
+  auto node = make_object<GBTreeModelNode>();
+  node->update_func = std::move(update_func);
+  node->max_n_bufs = max_n_bufs;
+  node->LoadXGBoostJSON(model_json);
+  data_ = std::move(node);
+}
+
+void GBTreeModelNode::Update(const Array<MeasureInput>& inputs,
+                             const Array<MeasureResult>& results) {
+  if (update_func != nullptr) {
+    std::string model_json = update_func(inputs, results);
+    LoadXGBoostJSON(model_json);
+  }
+}
+
+namespace {
+
+const picojson::value& GetJSONField(const picojson::value& json, const std::string& key) {
+  CHECK(json.is<picojson::object>() && json.contains(key))
+      << "ValueError: Invalid XGBoost JSON model, missing the field \"" << key << "\"";
+  return json.get(key);
+}
+
+const picojson::array& GetJSONArray(const picojson::value& json, const std::string& key) {
+  const picojson::value& field = GetJSONField(json, key);
+  CHECK(field.is<picojson::array>())
+      << "ValueError: Invalid XGBoost JSON model, \"" << key << "\" is not an array";
+  return field.get<picojson::array>();
+}
+
+// The booleans were saved as numbers by the older versions of XGBoost.
+double GetJSONNumber(const picojson::value& json) {
+  if (json.is<bool>()) {
+    return json.get<bool>() ? 1.0 : 0.0;
+  }
+  CHECK(json.is<double>()) << "ValueError: Invalid XGBoost JSON model, expect a number but get "
+                           << json.serialize();
+  return json.get<double>();
+}
+
+}  // namespace
+
+void GBTreeModelNode::LoadXGBoostJSON(const std::string& model_json) {
+  nodes_.clear();
+  tree_roots_.clear();
+  max_feature_ = -1;
+  base_score_ = 0.0f;
+  if (model_json.empty()) {
+    return;
+  }
+  picojson::value root;
+  std::string error = picojson::parse(root, model_json);
+  CHECK(error.empty()) << "ValueError: Invalid XGBoost JSON model: " << error;
+  const picojson::value& learner = GetJSONField(root, "learner");
+  // The base score is a string, also wrapped in brackets by the recent versions of XGBoost
+  {
+    const picojson::value& param = GetJSONField(learner, "learner_model_param");
+    std::string base_score = GetJSONField(param, "base_score").to_str();
+    base_score.erase(std::remove(base_score.begin(), base_score.end(), '['), base_score.end());
+    base_score.erase(std::remove(base_score.begin(), base_score.end(), ']'), base_score.end());
+    base_score_ = std::stof(base_score);
+  }
+  const picojson::value& booster = GetJSONField(learner, "gradient_booster");
+  CHECK_EQ(GetJSONField(booster, "name").to_str(), "gbtree")
+      << "ValueError: Only the gbtree booster of XGBoost is supported";
+  for (const picojson::value& tree : GetJSONArray(GetJSONField(booster, "model"), "trees")) {
+    const picojson::array& left = GetJSONArray(tree, "left_children");
+    const picojson::array& right = GetJSONArray(tree, "right_children");
+    const picojson::array& split_index = GetJSONArray(tree, "split_indices");
+    const picojson::array& split_value = GetJSONArray(tree, "split_conditions");
+    const picojson::array& default_left = GetJSONArray(tree, "default_left");
+    int32_t num_nodes = left.size();
+    CHECK(num_nodes > 0 && right.size() == left.size() && split_index.size() == left.size() &&
+          split_value.size() == left.size() && default_left.size() == left.size())
+        << "ValueError: Invalid XGBoost JSON model, the node arrays of a tree mismatch";
+    if (tree.contains("split_type")) {
+      for (const picojson::value& split_type : GetJSONArray(tree, "split_type")) {
+        CHECK_EQ(GetJSONNumber(split_type), 0)
+            << "ValueError: The categorical splits of XGBoost are not supported";
+      }
+    }
+    int32_t base = nodes_.size();
+    tree_roots_.push_back(base);
+    for (int32_t i = 0; i < num_nodes; ++i) {
+      Node node;
+      int32_t left_child = GetJSONNumber(left[i]);
+      int32_t right_child = GetJSONNumber(right[i]);
+      // For a leaf, XGBoost stores the leaf value in place of the threshold
+      node.value = GetJSONNumber(split_value[i]);
+      node.default_left = GetJSONNumber(default_left[i]) != 0;
+      if (left_child == -1) {
+        node.feature = -1;
+        node.left = node.right = -1;
+      } else {
+        CHECK(left_child >= 0 && left_child < num_nodes && left_child != i && right_child >= 0 &&
+              right_child < num_nodes && right_child != i)
+            << "ValueError: Invalid XGBoost JSON model, bad children of node " << i;
+        node.feature = GetJSONNumber(split_index[i]);
+        CHECK_GE(node.feature, 0);
+        node.left = base + left_child;
+        node.right = base + right_child;
+        max_feature_ = std::max(max_feature_, node.feature);
+      }
+      nodes_.push_back(node);
+    }
+  }
+}
+
+void GBTreeModelNode::PredictRows(const float* rows, size_t n_rows, size_t row_len,
+                                  float* preds) const {
+  CHECK_LT(max_feature_, static_cast<int64_t>(row_len))
+      << "ValueError: The model uses feature " << max_feature_ << " but the rows only have "
+      << row_len;
+  // The rows are scored by blocks, tree by tree, so a tree stays in cache for a whole block
+  constexpr size_t kBlockRows = 64;
+  size_t n_blocks = (n_rows + kBlockRows - 1) / kBlockRows;
+  auto predict_block = [&](int block) {
+    size_t begin = block * kBlockRows;
+    size_t end = std::min(n_rows, begin + kBlockRows);
+    std::fill(preds + begin, preds + end, base_score_);
+    for (int32_t root : tree_roots_) {
+      for (size_t i = begin; i < end; ++i) {
+        const float* row = rows + i * row_len;
+        const Node* node = &nodes_[root];
+        while (node->feature >= 0) {
+          float x = row[node->feature];
+          bool go_left = std::isnan(x) ? node->default_left : x < node->value;
+          node = &nodes_[go_left ? node->left : node->right];
+        }
+        preds[i] += node->value;
+      }
+    }
+  };
+  if (n_blocks > 1) {
+    support::parallel_for(0, n_blocks, predict_block);
+  } else if (n_blocks == 1) {
+    predict_block(0);
+  }
+}
+
+void GBTreeModelNode::Predict(const SearchTask& task, const Array<State>& states,
+                              std::vector<float>* scores) {
+  std::vector<std::vector<float>> features;
+  GetPerStoreFeaturesFromStates(states, task, 0, max_n_bufs, &features);
+  scores->assign(states.size(), 0.0f);
+
+  // The per store rows of all the states, each feature vector being made of the number of
+  // rows followed by the rows.
+  std::vector<float> rows;
+  std::vector<int> row_states;
+  std::vector<bool> valid(states.size(), false);
+  size_t row_len = 0;
+  for (size_t i = 0; i < features.size(); ++i) {
+    const std::vector<float>& feature = features[i];
+    int n_rows = feature.empty() ? 0 : static_cast<int>(feature[0] + 0.5);
+    if (n_rows == 0) {
+      continue;
+    }
+    size_t len = (feature.size() - 1) / n_rows;
+    ICHECK(row_len == 0 || row_len == len) << "The length of the feature vectors differ";
+    row_len = len;
+    valid[i] = std::any_of(feature.begin() + 1, feature.end(), [](float x) { return x != 0; });
+    rows.insert(rows.end(), feature.begin() + 1, feature.end());
+    row_states.insert(row_states.end(), n_rows, i);
+  }
+
+  if (tree_roots_.empty()) {
+    // There is no model yet, explore at random as XGBModel does
+    const auto* f = runtime::Registry::Get("auto_scheduler.cost_model.random_fill_float");
+    ICHECK(f != nullptr);
+    (*f)(states.size(), static_cast<void*>(scores->data()));
+  } else if (!row_states.empty()) {
+    std::vector<float> preds(row_states.size());
+    PredictRows(rows.data(), row_states.size(), row_len, preds.data());
+    for (size_t i = 0; i < preds.size(); ++i) {
+      (*scores)[row_states[i]] += preds[i];
+    }
+  }
+
+  // Predict -inf for invalid states that failed to be lowered.
+  for (size_t i = 0; i < states.size(); ++i) {
+    if (!valid[i]) {
+      (*scores)[i] = -std::numeric_limits<float>::infinity();
+    }
+  }
+}
+
 TVM_REGISTER_GLOBAL("auto_scheduler.RandomModel").set_body_typed([]() { return RandomModel(); });
 
 TVM_REGISTER_GLOBAL("auto_scheduler.PythonBasedModel")
@@ -153,6 +353,20 @@ TVM_REGISTER_GLOBAL("auto_scheduler.PythonBasedModel")
       return PythonBasedModel(update_func, predict_func, predict_stage_func);
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.GBTreeModel")
+    .set_body_typed([](std::string model_json, PackedFunc update_func, int max_n_bufs) {
+      return GBTreeModel(model_json, update_func, max_n_bufs);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.GBTreeModelLoadXGBoostJSON")
+    .set_body_typed([](GBTreeModel model, std::string model_json) {
+      model->LoadXGBoostJSON(model_json);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.GBTreeModelNumTrees").set_body_typed([](GBTreeModel model) {
+  return static_cast<int64_t>(model->NumTrees());
+});
+
 TVM_REGISTER_GLOBAL("auto_scheduler.CostModelUpdate")
     .set_body_typed([](CostModel model, Array<MeasureInput> inputs, Array<MeasureResult> results) {
       model->Update(inputs, results);
@@ -36,10 +36,17 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <dmlc/json.h>
+
 #include <algorithm>
 #include <cmath>
+#include <list>
+#include <mutex>
 #include <numeric>
+#include <sstream>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "search_policy/utils.h"
@@ -1256,8 +1263,136 @@ void GetPerStoreFeatureName(int max_n_bufs, std::vector<std::string>* ret) {
   // section total : 3
 }
 
-void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, int max_n_bufs,
-                                   std::vector<float>* feature, std::atomic<int>* error_ct) {
+/*! \brief The LRU cache of the features of the states, shared by all tasks. */
+class FeatureCache {
+ public:
+  static FeatureCache* Global() {
+    static FeatureCache* inst = new FeatureCache();
+    return inst;
+  }
+
+  /*!
+   * \brief Find the features of a state.
+   * \param key The key of the state.
+   * \param feature The features, set when found.
+   * \return Whether the state is in the cache.
+   */
+  bool Lookup(const std::string& key, std::vector<float>* feature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.capacity_nbytes == 0) {
+      return false;
+    }
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++stats_.misses;
+      return false;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    *feature = it->second->second;
+    return true;
+  }
+
+  /*! \brief Add the features of a state. */
+  void Insert(const std::string& key, const std::vector<float>& feature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.capacity_nbytes == 0 || index_.count(key)) {
+      return;
+    }
+    entries_.emplace_front(key, feature);
+    index_.emplace(key, entries_.begin());
+    stats_.nbytes += EntryBytes(entries_.front());
+    ++stats_.num_entries;
+    Evict();
+  }
+
+  void SetCapacity(int64_t capacity_nbytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ICHECK_GE(capacity_nbytes, 0);
+    stats_.capacity_nbytes = capacity_nbytes;
+    Evict();
+  }
+
+  FeatureCacheStats Stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    int64_t capacity_nbytes = stats_.capacity_nbytes;
+    stats_ = FeatureCacheStats();
+    stats_.capacity_nbytes = capacity_nbytes;
+  }
+
+ private:
+  using Entry = std::pair<std::string, std::vector<float>>;
+
+  // The default capacity holds the features of tens of thousands of states
+  FeatureCache() { stats_.capacity_nbytes = 256 << 20; }
+
+  static int64_t EntryBytes(const Entry& entry) {
+    // the key is stored twice, in the list and in the index
+    return 2 * entry.first.size() + entry.second.size() * sizeof(float) + 128;
+  }
+
+  void Evict() {
+    while (stats_.nbytes > stats_.capacity_nbytes && !entries_.empty()) {
+      stats_.nbytes -= EntryBytes(entries_.back());
+      --stats_.num_entries;
+      ++stats_.evictions;
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+  std::mutex mutex_;
+  /*! \brief The states, the most recently used first. */
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  FeatureCacheStats stats_;
+};
+
+/*!
+ * \brief The key of a state in the feature cache: everything the features depend on, i.e. the
+ *  transform steps and the task parameters used by the lowering and the extraction.
+ */
+std::string FeatureCacheKey(const SearchTask& task, const State& state, int max_n_bufs,
+                            bool disable_vectorize, bool instrument_bound_checkers) {
+  std::ostringstream os;
+  const HardwareParams& hw = task->hardware_params;
+  os << task->workload_key << '\n'
+     << task->target->str() << '\n'
+     << hw->cache_line_bytes << ' ' << hw->max_shared_memory_per_block << ' '
+     << hw->max_local_memory_per_block << ' ' << hw->max_threads_per_block << ' '
+     << hw->vector_unit_bytes << ' ' << hw->max_vthread_extent << ' '
+     << static_cast<int>(task->layout_rewrite_option) << ' ' << max_n_bufs << ' '
+     << disable_vectorize << instrument_bound_checkers << '\n';
+  dmlc::JSONWriter writer(&os);
+  writer.BeginArray(false);
+  for (const auto& step : state->transform_steps) {
+    writer.WriteArraySeperator();
+    writer.BeginArray(false);
+    step->WriteToRecord(&writer);
+    writer.EndArray();
+  }
+  writer.EndArray();
+  return os.str();
+}
+
+void SetFeatureCacheCapacity(int64_t capacity_nbytes) {
+  FeatureCache::Global()->SetCapacity(capacity_nbytes);
+}
+
+FeatureCacheStats GetFeatureCacheStats() { return FeatureCache::Global()->Stats(); }
+
+void ClearFeatureCache() { FeatureCache::Global()->Clear(); }
+
+void ExtractPerStoreFeatures(const SearchTask& task, const State& state, int max_n_bufs,
+                             bool disable_vectorize, bool instrument_bound_checkers,
+                             std::vector<float>* feature, std::atomic<int>* error_ct) {
   te::Schedule sch;
   Array<te::Tensor> tensors;
 
@@ -1271,16 +1406,10 @@ void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, i
 
   try {
     const std::string& name = "main";
-    auto pass_ctx = tvm::transform::PassContext::Current();
 
     auto mod = ScheduleToModule(sch, Array<ObjectRef>{tensors.begin(), tensors.end()}, name,
                                 std::unordered_map<te::Tensor, te::Buffer>());
 
-    bool disable_vectorize =
-        pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value();
-    bool instrument_bound_checkers =
-        pass_ctx->GetConfig<Bool>("tir.instrument_bound_checkers", Bool(false)).value();
-
     if (IsGPUTask(task)) {
       auto pass_list = Array<tvm::transform::Pass>();
       // Phase 0
@@ -1315,6 +1444,24 @@ void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, i
   }
 }
 
+void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, int max_n_bufs,
+                                   std::vector<float>* feature, std::atomic<int>* error_ct) {
+  auto pass_ctx = tvm::transform::PassContext::Current();
+  bool disable_vectorize =
+      pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value();
+  bool instrument_bound_checkers =
+      pass_ctx->GetConfig<Bool>("tir.instrument_bound_checkers", Bool(false)).value();
+  std::string key =
+      FeatureCacheKey(task, state, max_n_bufs, disable_vectorize, instrument_bound_checkers);
+  if (FeatureCache::Global()->Lookup(key, feature)) {
+    return;
+  }
+  ExtractPerStoreFeatures(task, state, max_n_bufs, disable_vectorize, instrument_bound_checkers,
+                          feature, error_ct);
+  // the states failing to lower are cached too, with empty features
+  FeatureCache::Global()->Insert(key, *feature);
+}
+
 void GetPerStoreFeaturesFromStates(const Array<State>& states, const SearchTask& task,
                                    int skip_first_n_feature_extraction, int max_n_bufs,
                                    std::vector<std::vector<float>>* features) {
@@ -1622,6 +1769,24 @@ TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeaturesFromStates")
                                std::move(task_ids), &byte_data);
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.SetFeatureCacheCapacity")
+    .set_body_typed(SetFeatureCacheCapacity);
+
+TVM_REGISTER_GLOBAL("auto_scheduler.GetFeatureCacheStats").set_body_typed([]() {
+  FeatureCacheStats stats = GetFeatureCacheStats();
+  auto to_int = [](int64_t value) { return Integer(IntImm(DataType::Int(64), value)); };
+  return Map<String, Integer>{
+      {"hits", to_int(stats.hits)},
+      {"misses", to_int(stats.misses)},
+      {"evictions", to_int(stats.evictions)},
+      {"num_entries", to_int(stats.num_entries)},
+      {"nbytes", to_int(stats.nbytes)},
+      {"capacity_nbytes", to_int(stats.capacity_nbytes)},
+  };
+});
+
+TVM_REGISTER_GLOBAL("auto_scheduler.ClearFeatureCache").set_body_typed(ClearFeatureCache);
+
 TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeatureNames")
     .set_body([](TVMArgs args, TVMRetValue* ret) {
       int max_n_bufs = args[0];
@@ -23,9 +23,13 @@
  */
 
 #include <tvm/auto_scheduler/measure.h>
+#include <tvm/driver/driver_api.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 
 #include "search_policy/empty_policy.h"
 #include "search_policy/sketch_policy.h"
@@ -208,7 +212,7 @@ void PythonBasedMeasureCallbackNode::Callback(const SearchPolicy& policy,
 /********** ProgramMeasurer **********/
 ProgramMeasurer::ProgramMeasurer(ProgramBuilder builder, ProgramRunner runner,
                                  Optional<Array<MeasureCallback>> callbacks, int verbose,
-                                 int max_continuous_error) {
+                                 int max_continuous_error, String cache_file) {
   auto node = make_object<ProgramMeasurerNode>();
   node->builder = std::move(builder);
   node->runner = std::move(runner);
@@ -217,9 +221,57 @@ ProgramMeasurer::ProgramMeasurer(ProgramBuilder builder, ProgramRunner runner,
   node->max_continuous_error = max_continuous_error < 0
                                    ? ProgramMeasurerNode::DEFAULT_MAX_CONTINUOUS_ERROR
                                    : max_continuous_error;
+  node->cache_file = std::move(cache_file);
   data_ = std::move(node);
 }
 
+/*!
+ * \brief Get the key of the program of a measure input, the structural hash of its lowered TIR
+ * and its target, or an empty string when it does not lower.
+ */
+static std::string GetProgramKey(const MeasureInput& input) {
+  std::ostringstream os;
+  try {
+    te::Schedule sch;
+    Array<te::Tensor> args;
+    std::tie(sch, args) = input->task->compute_dag.ApplySteps(input->state->transform_steps);
+    IRModule mod = LowerSchedule(sch, args, "main", {});
+    os << std::hex << StructuralHash()(mod) << " " << input->task->target->str();
+    if (input->task->target_host.defined()) {
+      os << " " << input->task->target_host->str();
+    }
+  } catch (Error& e) {
+    return "";
+  }
+  return os.str();
+}
+
+void ProgramMeasurerNode::LoadProgramCache() {
+  cache_file_loaded_ = true;
+  std::ifstream ifs(cache_file);
+  std::string line;
+  // Every line holds the costs of a program and its key
+  while (std::getline(ifs, line)) {
+    std::istringstream is(line);
+    int num_costs = 0;
+    is >> num_costs;
+    Array<PrimExpr> costs;
+    double cost;
+    for (int i = 0; i < num_costs && is >> cost; ++i) {
+      costs.push_back(FloatImm(DataType::Float(64), cost));
+    }
+    std::string key;
+    if (num_costs <= 0 || static_cast<int>(costs.size()) != num_costs ||
+        !std::getline(is >> std::ws, key)) {
+      continue;
+    }
+    program_cache_[key] = MeasureResult(costs, static_cast<int>(MeasureErrorNO::kNoError), "",
+                                        0.0, 0.0);
+  }
+  StdCout(verbose) << "ProgramMeasurer: Loaded the costs of " << program_cache_.size()
+                   << " programs from " << cache_file << std::endl;
+}
+
 void ProgramMeasurerNode::Reset() {
   ct = error_ct = 0;
   best_flops.clear();
@@ -313,14 +365,69 @@ void ProgramMeasurerNode::SilentMeasure(const SearchTask& task, const Array<Meas
                                         Array<MeasureResult>* results) {
   results->clear();
   results->reserve(inputs.size());
+  if (!cache_file.empty() && !cache_file_loaded_) {
+    LoadProgramCache();
+  }
+
+  // Only build and run the programs neither measured before nor repeated in this batch
+  std::vector<std::string> keys;
+  std::vector<int> measure_index;
+  std::unordered_map<std::string, int> batch_index;
+  Array<MeasureInput> measure_inputs;
+  for (const auto& input : inputs) {
+    std::string key = GetProgramKey(input);
+    int index = -1;
+    if (key.empty() || !program_cache_.count(key)) {
+      auto it = key.empty() ? batch_index.end() : batch_index.find(key);
+      if (it != batch_index.end()) {
+        index = it->second;
+      } else {
+        index = static_cast<int>(measure_inputs.size());
+        measure_inputs.push_back(input);
+        if (!key.empty()) batch_index[key] = index;
+      }
+    }
+    keys.push_back(std::move(key));
+    measure_index.push_back(index);
+  }
 
   // Call builder and runner
-  Array<BuildResult> build_res_batch = builder->Build(inputs, verbose);
-  Array<MeasureResult> result_batch = runner->Run(inputs, build_res_batch, verbose);
+  Array<MeasureResult> result_batch;
+  if (!measure_inputs.empty()) {
+    Array<BuildResult> build_res_batch = builder->Build(measure_inputs, verbose);
+    result_batch = runner->Run(measure_inputs, build_res_batch, verbose);
+  }
 
-  // Store result batch
-  for (auto& res : result_batch) {
+  // Store result batch, and remember the new successful results
+  std::ofstream ofs;
+  double timestamp = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::seconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (measure_index[i] < 0) {
+      const MeasureResult& cached = program_cache_.at(keys[i]);
+      results->push_back(MeasureResult(cached->costs, cached->error_no, "", 0.0, timestamp));
+      continue;
+    }
+    const MeasureResult& res = result_batch[measure_index[i]];
     results->push_back(res);
+    if (keys[i].empty() || res->error_no != static_cast<int>(MeasureErrorNO::kNoError) ||
+        !program_cache_.emplace(keys[i], res).second || cache_file.empty()) {
+      continue;
+    }
+    if (!ofs.is_open()) {
+      ofs.open(cache_file, std::ofstream::app);
+    }
+    ofs << res->costs.size();
+    for (const auto& cost : res->costs) {
+      ofs << " " << std::setprecision(17) << Downcast<FloatImm>(cost)->value;
+    }
+    ofs << " " << keys[i] << "\n";
+  }
+  if (inputs.size() != measure_inputs.size()) {
+    StdCout(verbose) << "ProgramMeasurer: Reused the results of "
+                     << inputs.size() - measure_inputs.size() << " programs" << std::endl;
   }
 }
 
@@ -389,8 +496,16 @@ TVM_REGISTER_GLOBAL("auto_scheduler.PythonBasedMeasureCallback")
 
 TVM_REGISTER_GLOBAL("auto_scheduler.ProgramMeasurer")
     .set_body_typed([](ProgramBuilder builder, ProgramRunner runner,
-                       Array<MeasureCallback> callbacks, int verbose, int max_continuous_error) {
-      return ProgramMeasurer(builder, runner, callbacks, verbose, max_continuous_error);
+                       Array<MeasureCallback> callbacks, int verbose, int max_continuous_error,
+                       String cache_file) {
+      return ProgramMeasurer(builder, runner, callbacks, verbose, max_continuous_error,
+                             cache_file);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.ProgramMeasurerMeasure")
+    .set_body_typed([](ProgramMeasurer measurer, SearchTask task, SearchPolicy policy,
+                       Array<MeasureInput> inputs) {
+      return measurer->Measure(task, policy, inputs);
     });
 
 TVM_REGISTER_GLOBAL("auto_scheduler.ProgramBuilderBuild")
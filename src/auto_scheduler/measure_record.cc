@@ -27,10 +27,23 @@
 #include <tvm/auto_scheduler/measure_record.h>
 #include <tvm/auto_scheduler/transform_step.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <sstream>
+#include <streambuf>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -355,10 +368,220 @@ void RecordToFileNode::Callback(const SearchPolicy& policy, const Array<MeasureI
   WriteMeasureRecords(&ofs, inputs, results);
 }
 
+/*
+ * The binary log, all the integers being little endian:
+ *   BinaryRecordHeader
+ *   the JSON of the tasks and of the states, the costs and the workload index
+ *   num_tasks x BinaryTaskEntry
+ *   num_records x BinaryRecordEntry
+ * The records keep the order of the JSON log they were converted from.
+ */
+constexpr const char kBinaryRecordMagic[8] = {'T', 'V', 'M', 'A', 'S', 'R', 'E', 'C'};
+constexpr uint32_t kBinaryRecordFormatVersion = 1;
+
+struct BinaryRecordHeader {
+  char magic[8];
+  uint32_t format_version;
+  uint32_t reserved;
+  uint64_t num_tasks;
+  uint64_t num_records;
+  uint64_t task_table_offset;
+  uint64_t record_table_offset;
+};
+
+struct BinaryTaskEntry {
+  /*! \brief The JSON of the SearchTask. */
+  uint64_t json_offset, json_size;
+  /*! \brief The workload key. */
+  uint64_t key_offset, key_size;
+  /*! \brief The indices of the records of the task, an array of uint64_t. */
+  uint64_t index_offset, num_records;
+};
+
+struct BinaryRecordEntry {
+  uint32_t task_index;
+  int32_t error_no;
+  double all_cost;
+  double timestamp;
+  /*! \brief The JSON of the State. */
+  uint64_t state_offset;
+  uint32_t state_size;
+  /*! \brief The costs, an array of double. */
+  uint32_t num_costs;
+  uint64_t costs_offset;
+};
+
+/*! \brief A read only stream buffer over bytes it does not own. */
+class ConstMemoryStreamBuf : public std::streambuf {
+ public:
+  ConstMemoryStreamBuf(const char* data, size_t size) {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+/*! \brief A binary log, memory mapped. */
+class BinaryRecordFile {
+ public:
+  /*!
+   * \brief Map a binary log and decode its tasks.
+   * \param filename The file, starting with kBinaryRecordMagic.
+   */
+  explicit BinaryRecordFile(const std::string& filename) {
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    ICHECK_GE(fd, 0) << "Cannot open " << filename;
+    struct stat st;
+    ICHECK_EQ(fstat(fd, &st), 0) << "Cannot stat " << filename;
+    size_ = st.st_size;
+    void* base = size_ == 0 ? nullptr : mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    ICHECK(base != MAP_FAILED) << "Cannot mmap " << filename;
+    data_ = static_cast<const char*>(base);
+#else
+    std::ifstream is(filename, std::ios::binary);
+    buffer_.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+    ICHECK_GE(size_, sizeof(BinaryRecordHeader)) << "Truncated binary log " << filename;
+    const auto* header = reinterpret_cast<const BinaryRecordHeader*>(data_);
+    ICHECK_EQ(header->format_version, kBinaryRecordFormatVersion)
+        << "Unsupported binary log version " << header->format_version << " in " << filename;
+    num_records_ = header->num_records;
+    ICHECK(header->task_table_offset + header->num_tasks * sizeof(BinaryTaskEntry) <= size_ &&
+           header->record_table_offset + num_records_ * sizeof(BinaryRecordEntry) <= size_)
+        << "Truncated binary log " << filename;
+    task_table_ = reinterpret_cast<const BinaryTaskEntry*>(data_ + header->task_table_offset);
+    record_table_ = reinterpret_cast<const BinaryRecordEntry*>(data_ + header->record_table_offset);
+    // The tasks are few, parse them once so that the records share them
+    tasks_.reserve(header->num_tasks);
+    for (uint64_t i = 0; i < header->num_tasks; ++i) {
+      ConstMemoryStreamBuf buf(Bytes(task_table_[i].json_offset, task_table_[i].json_size),
+                               task_table_[i].json_size);
+      std::istream is(&buf);
+      dmlc::JSONReader reader(&is);
+      auto task_node = make_object<SearchTaskNode>();
+      reader.Read(task_node.get());
+      tasks_.push_back(SearchTask(task_node));
+    }
+  }
+
+  ~BinaryRecordFile() {
+#ifndef _WIN32
+    if (data_ != nullptr) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+  }
+
+  size_t NumRecords() const { return num_records_; }
+
+  /*! \brief Decode a record. */
+  void Read(size_t index, MeasureInputNode* inp, MeasureResultNode* res) const {
+    const BinaryRecordEntry& entry = record_table_[index];
+    ICHECK_LT(entry.task_index, tasks_.size()) << "Corrupted binary log";
+    inp->task = tasks_[entry.task_index];
+    {
+      ConstMemoryStreamBuf buf(Bytes(entry.state_offset, entry.state_size), entry.state_size);
+      std::istream is(&buf);
+      dmlc::JSONReader reader(&is);
+      auto state_node = make_object<StateNode>();
+      state_node->concrete = true;
+      reader.Read(state_node.get());
+      inp->state = State(state_node);
+    }
+    const char* costs = Bytes(entry.costs_offset, entry.num_costs * sizeof(double));
+    res->costs.clear();
+    for (uint32_t i = 0; i < entry.num_costs; ++i) {
+      double cost;
+      std::memcpy(&cost, costs + i * sizeof(double), sizeof(double));
+      res->costs.push_back(FloatImm(DataType::Float(64), cost));
+    }
+    res->error_no = entry.error_no;
+    // the JSON logs do not keep the error messages either
+    res->error_msg = "";
+    res->all_cost = entry.all_cost;
+    res->timestamp = entry.timestamp;
+  }
+
+  /*! \brief The indices of the records of a workload, in file order. */
+  std::vector<uint64_t> WorkloadRecords(const std::string& workload_key) const {
+    std::vector<uint64_t> indices;
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+      const BinaryTaskEntry& task = task_table_[i];
+      if (task.key_size != workload_key.size() ||
+          std::memcmp(Bytes(task.key_offset, task.key_size), workload_key.data(),
+                      task.key_size) != 0) {
+        continue;
+      }
+      const char* index = Bytes(task.index_offset, task.num_records * sizeof(uint64_t));
+      size_t begin = indices.size();
+      indices.resize(begin + task.num_records);
+      std::memcpy(indices.data() + begin, index, task.num_records * sizeof(uint64_t));
+    }
+    // the tasks sharing a workload key differ by target, merge their records back in order
+    std::sort(indices.begin(), indices.end());
+    return indices;
+  }
+
+ private:
+  const char* Bytes(uint64_t offset, uint64_t size) const {
+    ICHECK(offset <= size_ && size <= size_ - offset) << "Corrupted binary log";
+    return data_ + offset;
+  }
+
+  const char* data_{nullptr};
+  size_t size_{0};
+#ifdef _WIN32
+  std::vector<char> buffer_;
+#endif
+  size_t num_records_{0};
+  const BinaryTaskEntry* task_table_{nullptr};
+  const BinaryRecordEntry* record_table_{nullptr};
+  std::vector<SearchTask> tasks_;
+};
+
+/*! \brief Whether a file starts with the magic number of the binary logs. */
+bool IsBinaryRecordFile(const std::string& filename) {
+  std::ifstream is(filename, std::ios::binary);
+  char magic[sizeof(kBinaryRecordMagic)];
+  return is.read(magic, sizeof(magic)) &&
+         std::memcmp(magic, kBinaryRecordMagic, sizeof(magic)) == 0;
+}
+
+/*! \brief Decode some records of a binary log, in parallel when there are many. */
+std::pair<Array<MeasureInput>, Array<MeasureResult>> ReadBinaryRecords(
+    const BinaryRecordFile& file, const std::vector<uint64_t>& indices) {
+  constexpr size_t kMinParallelRecords = 1024;
+  std::vector<MeasureInput> inputs(indices.size());
+  std::vector<MeasureResult> results(indices.size());
+  auto read = [&](int thread_id, int i) {
+    auto inp = make_object<MeasureInputNode>();
+    auto res = make_object<MeasureResultNode>();
+    file.Read(indices[i], inp.get(), res.get());
+    inputs[i] = MeasureInput(inp);
+    results[i] = MeasureResult(res);
+  };
+  if (indices.size() < kMinParallelRecords) {
+    for (size_t i = 0; i < indices.size(); ++i) {
+      read(0, i);
+    }
+  } else {
+    int num_threads = std::max<int>(1, std::thread::hardware_concurrency());
+    support::parallel_for_dynamic(0, indices.size(), num_threads, read);
+  }
+  return std::make_pair(Array<MeasureInput>(inputs), Array<MeasureResult>(results));
+}
+
 RecordReader::RecordReader(String filename) {
   auto node = make_object<RecordReaderNode>();
   node->filename = filename;
-  node->infile.open(filename, std::ifstream::in);
+  if (IsBinaryRecordFile(filename)) {
+    node->binary_file_ = std::make_shared<BinaryRecordFile>(filename);
+  } else {
+    node->infile.open(filename, std::ifstream::in);
+  }
   data_ = std::move(node);
 }
 
@@ -367,6 +590,14 @@ RecordReaderNode::~RecordReaderNode() { infile.close(); }
 bool RecordReaderNode::ReadNext(MeasureInputNode* inp, MeasureResultNode* res) {
   std::string log_version;
 
+  if (binary_file_ != nullptr) {
+    if (next_record_ >= binary_file_->NumRecords()) {
+      return false;
+    }
+    binary_file_->Read(next_record_++, inp, res);
+    return true;
+  }
+
   while (std::getline(infile, cur_line_)) {
     if (cur_line_[0] == '#' || cur_line_[0] == ' ') {
       // skip comment lines begin with '#' or ' '
@@ -381,6 +612,20 @@ bool RecordReaderNode::ReadNext(MeasureInputNode* inp, MeasureResultNode* res) {
 
 std::pair<Array<MeasureInput>, Array<MeasureResult>> RecordReaderNode::ReadLines(int max_size,
                                                                                  int skip_size) {
+  if (binary_file_ != nullptr) {
+    // no need to decode the skipped records
+    size_t num_records = binary_file_->NumRecords();
+    size_t begin = std::min(num_records, next_record_ + std::max(skip_size, 0));
+    size_t end = max_size > 0 ? std::min(num_records, begin + max_size) : num_records;
+    std::vector<uint64_t> indices;
+    indices.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+      indices.push_back(i);
+    }
+    next_record_ = end;
+    return ReadBinaryRecords(*binary_file_, indices);
+  }
+
   auto inp = make_object<MeasureInputNode>();
   auto res = make_object<MeasureResultNode>();
   Array<MeasureInput> inputs;
@@ -403,6 +648,133 @@ std::pair<Array<MeasureInput>, Array<MeasureResult>> RecordReaderNode::ReadLines
   return std::make_pair(inputs, results);
 }
 
+std::pair<Array<MeasureInput>, Array<MeasureResult>> RecordReaderNode::ReadWorkload(
+    const String& workload_key) {
+  if (binary_file_ != nullptr) {
+    return ReadBinaryRecords(*binary_file_, binary_file_->WorkloadRecords(workload_key));
+  }
+  // scan the whole file with a reader of its own, leaving the position of this one alone
+  RecordReader reader(filename);
+  auto inp = make_object<MeasureInputNode>();
+  auto res = make_object<MeasureResultNode>();
+  Array<MeasureInput> inputs;
+  Array<MeasureResult> results;
+  while (reader->ReadNext(inp.get(), res.get())) {
+    if (inp->task->workload_key == workload_key) {
+      inputs.push_back(inp->copy());
+      results.push_back(res->copy());
+    }
+  }
+  return std::make_pair(inputs, results);
+}
+
+int64_t ConvertRecordsToBinary(const std::string& json_filename,
+                               const std::string& binary_filename) {
+  std::ofstream os(binary_filename, std::ios::binary | std::ios::trunc);
+  ICHECK(os.is_open()) << "Cannot open " << binary_filename;
+  BinaryRecordHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kBinaryRecordMagic, sizeof(header.magic));
+  header.format_version = kBinaryRecordFormatVersion;
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  uint64_t offset = sizeof(header);
+  auto append = [&os, &offset](const void* data, size_t size) {
+    uint64_t begin = offset;
+    os.write(static_cast<const char*>(data), size);
+    offset += size;
+    return begin;
+  };
+  // The states and costs are streamed out, only the fixed size entries are kept in memory
+  std::unordered_map<std::string, uint32_t> task_index;
+  std::vector<std::string> task_json;
+  std::vector<std::string> task_keys;
+  std::vector<std::vector<uint64_t>> task_records;
+  std::vector<BinaryRecordEntry> records;
+  RecordReader reader(json_filename);
+  ICHECK(!reader->IsBinary()) << json_filename << " is already a binary log";
+  auto inp = make_object<MeasureInputNode>();
+  auto res = make_object<MeasureResultNode>();
+  while (reader->ReadNext(inp.get(), res.get())) {
+    std::ostringstream task_os;
+    {
+      dmlc::JSONWriter writer(&task_os);
+      writer.Write(*inp->task.get());
+    }
+    auto it = task_index.emplace(task_os.str(), task_json.size()).first;
+    if (it->second == task_json.size()) {
+      task_json.push_back(it->first);
+      task_keys.push_back(inp->task->workload_key);
+      task_records.emplace_back();
+    }
+    std::ostringstream state_os;
+    {
+      dmlc::JSONWriter writer(&state_os);
+      writer.Write(*inp->state.get());
+    }
+    std::string state_json = state_os.str();
+    std::vector<double> costs;
+    for (const auto& x : res->costs) {
+      auto pf = x.as<tir::FloatImmNode>();
+      ICHECK(pf != nullptr) << "Cost can only contain float values";
+      costs.push_back(pf->value);
+    }
+    BinaryRecordEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.task_index = it->second;
+    entry.error_no = res->error_no;
+    entry.all_cost = res->all_cost;
+    entry.timestamp = res->timestamp;
+    entry.state_size = state_json.size();
+    entry.state_offset = append(state_json.data(), state_json.size());
+    entry.num_costs = costs.size();
+    entry.costs_offset = append(costs.data(), costs.size() * sizeof(double));
+    task_records[it->second].push_back(records.size());
+    records.push_back(entry);
+  }
+  std::vector<BinaryTaskEntry> tasks(task_json.size());
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    tasks[i].json_size = task_json[i].size();
+    tasks[i].json_offset = append(task_json[i].data(), task_json[i].size());
+    tasks[i].key_size = task_keys[i].size();
+    tasks[i].key_offset = append(task_keys[i].data(), task_keys[i].size());
+    tasks[i].num_records = task_records[i].size();
+    tasks[i].index_offset =
+        append(task_records[i].data(), task_records[i].size() * sizeof(uint64_t));
+  }
+  // keep the tables aligned, they are read in place
+  static const char padding[8] = {0};
+  append(padding, (8 - offset % 8) % 8);
+  header.num_tasks = tasks.size();
+  header.num_records = records.size();
+  header.task_table_offset = append(tasks.data(), tasks.size() * sizeof(BinaryTaskEntry));
+  header.record_table_offset =
+      append(records.data(), records.size() * sizeof(BinaryRecordEntry));
+  os.seekp(0);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  ICHECK(os.good()) << "Failed to write " << binary_filename;
+  return records.size();
+}
+
+int64_t ConvertRecordsToJSON(const std::string& binary_filename, const std::string& json_filename) {
+  RecordReader reader(binary_filename);
+  ICHECK(reader->IsBinary()) << binary_filename << " is not a binary log";
+  std::ofstream os(json_filename, std::ofstream::trunc);
+  ICHECK(os.is_open()) << "Cannot open " << json_filename;
+  // convert in batches to bound the memory used for large logs
+  constexpr int kBatchSize = 4096;
+  int64_t num_records = 0;
+  while (true) {
+    auto batch = reader->ReadLines(kBatchSize);
+    if (batch.first.empty()) {
+      break;
+    }
+    WriteMeasureRecords(&os, batch.first, batch.second);
+    num_records += batch.first.size();
+  }
+  ICHECK(os.good()) << "Failed to write " << json_filename;
+  return num_records;
+}
+
 TVM_REGISTER_GLOBAL("auto_scheduler.RecordToFile").set_body_typed([](const String& filename) {
   return RecordToFile(filename);
 });
@@ -417,6 +789,17 @@ TVM_REGISTER_GLOBAL("auto_scheduler.RecordReaderReadLines")
       return Array<ObjectRef>{res.first, res.second};
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.RecordReaderReadWorkload")
+    .set_body_typed([](RecordReader reader, String workload_key) {
+      const auto& res = reader->ReadWorkload(workload_key);
+      return Array<ObjectRef>{res.first, res.second};
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.ConvertRecordsToBinary")
+    .set_body_typed(ConvertRecordsToBinary);
+
+TVM_REGISTER_GLOBAL("auto_scheduler.ConvertRecordsToJSON").set_body_typed(ConvertRecordsToJSON);
+
 TVM_REGISTER_GLOBAL("auto_scheduler.RecordReaderReadNext").set_body_typed([](RecordReader reader) {
   auto inp = make_object<MeasureInputNode>();
   auto res = make_object<MeasureResultNode>();
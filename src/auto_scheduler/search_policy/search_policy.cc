@@ -26,6 +26,14 @@
 #include <tvm/auto_scheduler/search_policy.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "utils.h"
 
 namespace tvm {
@@ -34,6 +42,38 @@ namespace auto_scheduler {
 TVM_REGISTER_OBJECT_TYPE(SearchCallbackNode);
 TVM_REGISTER_OBJECT_TYPE(SearchPolicyNode);
 TVM_REGISTER_OBJECT_TYPE(PreloadMeasuredStatesNode);
+TVM_REGISTER_OBJECT_TYPE(WarmStartFromSimilarWorkloadsNode);
+
+/*!
+ * \brief Split a workload key into its template, the key with every integer replaced by '#',
+ * and the integers. Two workloads of the same function or compute DAG only differing in their
+ * shapes have the same template.
+ */
+static std::string SplitWorkloadKey(const std::string& workload_key, std::vector<double>* ints) {
+  std::string pattern;
+  size_t i = 0;
+  bool in_string = false;
+  while (i < workload_key.size()) {
+    char ch = workload_key[i];
+    if (ch == '"' && (i == 0 || workload_key[i - 1] != '\\')) {
+      in_string = !in_string;
+    }
+    bool starts_number =
+        !in_string && (std::isdigit(ch) || (ch == '-' && i + 1 < workload_key.size() &&
+                                            std::isdigit(workload_key[i + 1])));
+    if (starts_number) {
+      size_t end = i + 1;
+      while (end < workload_key.size() && std::isdigit(workload_key[end])) end++;
+      ints->push_back(std::stod(workload_key.substr(i, end - i)));
+      pattern.push_back('#');
+      i = end;
+    } else {
+      pattern.push_back(ch);
+      i++;
+    }
+  }
+  return pattern;
+}
 
 void SearchPolicyNode::PreloadMeasuredStates(const String& log_file) {
   RecordReader reader = RecordReader(log_file);
@@ -81,6 +121,71 @@ void SearchPolicyNode::PreloadMeasuredStates(const String& log_file) {
   }
 }
 
+void SearchPolicyNode::WarmStartFromSimilarWorkloads(const String& log_file, int num_states) {
+  std::vector<double> target_ints;
+  const std::string target_pattern = SplitWorkloadKey(search_task->workload_key, &target_ints);
+
+  // Keep the best record of every similar workload
+  RecordReader reader = RecordReader(log_file);
+  const auto& res = reader->ReadLines(-1);
+  std::unordered_map<std::string, std::pair<double, int>> best_records;
+  for (size_t i = 0; i < res.first.size(); i++) {
+    const auto& inp = res.first[i];
+    const auto& workload_key = inp->task->workload_key;
+    if (res.second[i]->error_no != 0 || workload_key == search_task->workload_key ||
+        inp->task->target->kind->name != search_task->target->kind->name) {
+      continue;
+    }
+    double cost = FloatArrayMean(res.second[i]->costs);
+    auto it = best_records.find(workload_key);
+    if (it == best_records.end() || cost < it->second.first) {
+      best_records[workload_key] = {cost, static_cast<int>(i)};
+    }
+  }
+
+  // Rank the workloads by the distance of their shapes in log scale
+  std::vector<std::pair<double, int>> candidates;
+  for (const auto& kv : best_records) {
+    std::vector<double> ints;
+    if (SplitWorkloadKey(kv.first, &ints) != target_pattern) continue;
+    double dis = 0;
+    for (size_t i = 0; i < ints.size(); i++) {
+      if ((ints[i] <= 0 || target_ints[i] <= 0) && ints[i] != target_ints[i]) {
+        dis = std::numeric_limits<double>::infinity();
+        break;
+      }
+      dis += ints[i] > 0 ? std::fabs(std::log(target_ints[i] / ints[i])) : 0;
+    }
+    if (std::isfinite(dis)) candidates.emplace_back(dis, kv.second.second);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  // Replay the steps of the nearest workloads, skipping those the new shapes do not accept
+  Array<State> states;
+  for (const auto& cand : candidates) {
+    if (static_cast<int>(states.size()) >= num_states) break;
+    State state = search_task->compute_dag->init_state;
+    try {
+      for (const auto& step : res.first[cand.second]->state->transform_steps) {
+        StepApplyToState(step, &state, search_task->compute_dag);
+      }
+      state = search_task->compute_dag.InferBound(state);
+    } catch (Error& e) {
+      continue;
+    }
+    if (state.defined() && !measured_states_set_.count(state.ToStr())) {
+      states.push_back(std::move(state));
+    }
+  }
+  for (const auto& state : states) {
+    warm_start_states_.push_back(state);
+  }
+
+  StdCout(verbose) << "SearchPolicy: Retargeted " << states.size() << " states of "
+                   << candidates.size() << " similar workloads from " << log_file << " for "
+                   << search_task->workload_key << std::endl;
+}
+
 void SearchPolicyNode::RunCallbacks(const Array<SearchCallback>& callbacks) {
   for (const auto& callback : callbacks) {
     callback->Callback(this);
@@ -97,6 +202,17 @@ void PreloadMeasuredStatesNode::Callback(SearchPolicyNode* policy) {
   policy->PreloadMeasuredStates(filename);
 }
 
+WarmStartFromSimilarWorkloads::WarmStartFromSimilarWorkloads(String filename, int num_states) {
+  auto node = make_object<WarmStartFromSimilarWorkloadsNode>();
+  node->filename = std::move(filename);
+  node->num_states = num_states;
+  data_ = std::move(node);
+}
+
+void WarmStartFromSimilarWorkloadsNode::Callback(SearchPolicyNode* policy) {
+  policy->WarmStartFromSimilarWorkloads(filename, num_states);
+}
+
 TVM_REGISTER_GLOBAL("auto_scheduler.SearchPolicyRunCallbacks")
     .set_body_typed([](SearchPolicy policy, Optional<Array<SearchCallback>> callbacks) {
       if (callbacks) {
@@ -119,5 +235,10 @@ TVM_REGISTER_GLOBAL("auto_scheduler.PreloadMeasuredStates").set_body_typed([](St
   return PreloadMeasuredStates(filename);
 });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.WarmStartFromSimilarWorkloads")
+    .set_body_typed([](String filename, int num_states) {
+      return WarmStartFromSimilarWorkloads(filename, num_states);
+    });
+
 }  // namespace auto_scheduler
 }  // namespace tvm
@@ -86,6 +86,8 @@ SketchPolicy::SketchPolicy(SearchTask task, CostModel program_cost_model,
     // Candidates:
     // - auto_scheduler.PreloadMeasuredStates: Load already measured states to
     //   `measured_states_set_`, `measured_states_vector_` and `measured_states_throughputs_`.
+    // - auto_scheduler.WarmStartFromSimilarWorkloads: Retarget the best states of similar
+    //   workloads to `warm_start_states_`.
     // - auto_scheduler.PreloadCustomSketchRule: Add user custom sketch rules to `sketch_rules`,
     //   these rules will be processed prior to the default rules.
     node->RunCallbacks(init_search_callbacks.value());
@@ -304,11 +306,24 @@ Array<State> SketchPolicyNode::SearchOneRound(int num_random_states, Array<State
   for (int i = 0; i < num_use_measured; i++) {
     init_population.push_back(measured_states_vector_[indices[i]]);
   }
+  // And the states retargeted from similar workloads, which are also measured first
+  for (const auto& state : warm_start_states_) {
+    init_population.push_back(state);
+  }
   // Sample some random states for eps-greedy
   if (num_random_states > 0 && random_states != nullptr) {
     *random_states = RandomSampleStates(init_population, &rand_gen, num_random_states);
   }
-  return EvolutionarySearch(init_population, num_measure_per_iter_ * 2);
+  Array<State> best_states = EvolutionarySearch(init_population, num_measure_per_iter_ * 2);
+  if (!warm_start_states_.empty()) {
+    Array<State> warm_states(warm_start_states_.begin(), warm_start_states_.end());
+    for (const auto& state : best_states) {
+      warm_states.push_back(state);
+    }
+    warm_start_states_.clear();
+    return warm_states;
+  }
+  return best_states;
 }
 
 Array<State> SketchPolicyNode::GenerateSketches() {
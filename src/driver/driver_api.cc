@@ -43,10 +43,13 @@ TVM_REGISTER_PASS_CONFIG_OPTION("tir.noalias", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.detect_global_barrier", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.instrument_bound_checkers", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.disable_assert", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.skip_arg_checks", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.disable_vectorize", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.is_entry_func", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.add_lower_pass", Array<Array<ObjectRef>>);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.debug_keep_trivial_loop", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.rewrite_shared_memory_layout", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.widen_memory_access", Bool);
 
 using runtime::PackedFunc;
 using runtime::TVMArgs;
@@ -193,6 +196,10 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
   bool disable_vectorize = pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value();
   bool instrument_bound_checkers =
       pass_ctx->GetConfig<Bool>("tir.instrument_bound_checkers", Bool(false)).value();
+  bool rewrite_shared_memory_layout =
+      pass_ctx->GetConfig<Bool>("tir.rewrite_shared_memory_layout", Bool(false)).value();
+  bool widen_memory_access =
+      pass_ctx->GetConfig<Bool>("tir.widen_memory_access", Bool(false)).value();
 
   // Get any user-added passes
   Array<Array<ObjectRef>> add_lower_pass =
@@ -244,6 +251,10 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
   pass_list.push_back(tir::transform::UnifyThreadBinding());
   pass_list.push_back(tir::transform::CompactBufferAllocation());
   pass_list.push_back(tir::transform::LowerMatchBuffer());
+  pass_list.push_back(tir::transform::InjectSoftwarePipeline());
+  if (rewrite_shared_memory_layout) {
+    pass_list.push_back(tir::transform::RewriteSharedMemoryLayout());
+  }
   pass_list.push_back(tir::transform::FlattenBuffer());
   pass_list.push_back(tir::transform::BF16Legalize());
   pass_list.push_back(tir::transform::NarrowDataType(32));
@@ -257,7 +268,12 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition) {
     pass_list.push_back(tir::transform::LoopPartition());
   }
 
+  if (widen_memory_access && !disable_vectorize) {
+    pass_list.push_back(tir::transform::WidenMemoryAccess());
+  }
   pass_list.push_back(tir::transform::VectorizeLoop(!disable_vectorize));
+  pass_list.push_back(tir::transform::InjectDMAAsyncCopy());
+  pass_list.push_back(tir::transform::InjectPTXAsyncCopy());
   pass_list.push_back(tir::transform::InjectVirtualThread());
   pass_list.push_back(tir::transform::InjectDoubleBuffer());
   pass_list.push_back(tir::transform::StorageRewrite());
@@ -647,6 +663,7 @@ transform::Sequential HostModulePassManager(IRModule mixed_mod, Target target_ho
 
   host_pass_list.push_back(BindTarget(target_host));
 
+  host_pass_list.push_back(tir::transform::InjectAutoPrefetch());
   host_pass_list.push_back(tir::transform::LowerTVMBuiltin());
   host_pass_list.push_back(tir::transform::LowerCustomDatatypes());
   host_pass_list.push_back(tir::transform::LowerIntrin());
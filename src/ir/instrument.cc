@@ -25,8 +25,20 @@
 #include <tvm/ir/instrument.h>
 #include <tvm/ir/transform.h>
 #include <tvm/node/repr_printer.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/function.h>
+#include <tvm/runtime/memory.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/stmt_functor.h>
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
 #include <stack>
 
 namespace tvm {
@@ -337,5 +349,255 @@ TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([]() {
                             run_before_pass, run_after_pass);
 });
 
+/*!
+ * \brief PassStats stores the time, the memory and the IR size measured around a pass and its
+ *  sub-passes.
+ */
+struct PassStats {
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::duration<double, std::micro>;
+
+  /*! \brief The name of the pass. */
+  String name;
+  /*! \brief The time when the pass was entered, and the duration of the pass. */
+  Clock::time_point start;
+  Duration duration{0};
+  /*! \brief The time the instrument spent measuring the sub-passes, excluded from duration. */
+  Duration overhead{0};
+  /*! \brief The peak resident set size of the process before the pass, and its growth. */
+  int64_t peak_rss_kb{0};
+  int64_t peak_rss_delta_kb{0};
+  /*! \brief The object allocations before the pass, and the allocations during the pass. */
+  uint64_t allocs{0};
+  int64_t num_allocs{-1};
+  /*! \brief The IR nodes of the module before and after the pass, -1 when not counted. */
+  int64_t nodes_before{-1};
+  int64_t nodes_after{-1};
+  /*! \brief The stats of the sub-passes. */
+  std::vector<PassStats> children;
+
+  explicit PassStats(String name) : name(name), start(Clock::now()) {}
+};
+
+struct PassStatsThreadLocalEntry {
+  /*! \brief The placeholder top-level PassStats. */
+  PassStats root{"root"};
+  /*! \brief The stack of PassStats for nested passes currently running. */
+  std::stack<PassStats*> stats_stack;
+  /*! \brief The time the stats were reset, the origin of the trace. */
+  PassStats::Clock::time_point origin{PassStats::Clock::now()};
+
+  PassStats* Current() { return stats_stack.empty() ? &root : stats_stack.top(); }
+
+  void Reset() {
+    root.children.clear();
+    stats_stack = std::stack<PassStats*>();
+    origin = PassStats::Clock::now();
+  }
+};
+
+/*! \brief Thread local store to hold the pass stats. */
+typedef dmlc::ThreadLocalStore<PassStatsThreadLocalEntry> PassStatsThreadLocalStore;
+
+namespace {
+/*! \return The peak resident set size of the process in KB, 0 when it is unknown. */
+int64_t PeakRSSKB() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+  return static_cast<int64_t>(usage.ru_maxrss) / 1024;
+#else
+  return static_cast<int64_t>(usage.ru_maxrss);
+#endif
+#else
+  return 0;
+#endif
+}
+
+/*! \return The objects allocated so far, counted by the object pool when it is built in. */
+uint64_t ObjectAllocs() { return runtime::GetObjectPoolStats().num_allocs; }
+
+/*! \return The number of expression and statement nodes of the functions of a module. */
+int64_t CountIRNodes(const IRModule& mod) {
+  int64_t count = 0;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<relay::FunctionNode>()) {
+      relay::PostOrderVisit(GetRef<relay::Function>(func), [&count](const RelayExpr&) { ++count; });
+    } else if (const auto* func = kv.second.as<tir::PrimFuncNode>()) {
+      tir::PostOrderVisit(func->body, [&count](const ObjectRef&) { ++count; });
+    }
+  }
+  return count;
+}
+
+std::string JSONString(const std::string& str) {
+  std::ostringstream os;
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+         << std::dec << std::setfill(' ');
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+  return os.str();
+}
+
+// The measures of a pass, as the members of a JSON object.
+void WritePassMeasures(std::ostream& os, const PassStats& stats) {
+  os << "\"duration_us\":" << stats.duration.count()
+     << ",\"peak_rss_delta_kb\":" << stats.peak_rss_delta_kb;
+  if (stats.num_allocs >= 0) os << ",\"num_allocs\":" << stats.num_allocs;
+  if (stats.nodes_before >= 0) {
+    os << ",\"nodes_before\":" << stats.nodes_before << ",\"nodes_after\":" << stats.nodes_after;
+  }
+}
+
+void WritePassStatsJSON(std::ostream& os, const PassStats& stats) {
+  os << "{\"name\":" << JSONString(stats.name) << ",";
+  WritePassMeasures(os, stats);
+  os << ",\"children\":[";
+  for (size_t i = 0; i < stats.children.size(); ++i) {
+    if (i != 0) os << ",";
+    WritePassStatsJSON(os, stats.children[i]);
+  }
+  os << "]}";
+}
+
+/*! \brief The stats of the runs of a pass, summed over the places it runs in. */
+struct PassSummary {
+  int64_t count{0};
+  double duration_us{0};
+  double self_duration_us{0};
+  int64_t peak_rss_delta_kb{0};
+  int64_t num_allocs{0};
+  int64_t nodes_delta{0};
+};
+
+void SummarizePassStats(const PassStats& stats, std::map<std::string, PassSummary>* summary) {
+  PassSummary& entry = (*summary)[stats.name];
+  entry.count += 1;
+  entry.duration_us += stats.duration.count();
+  entry.self_duration_us += stats.duration.count();
+  entry.peak_rss_delta_kb += stats.peak_rss_delta_kb;
+  entry.num_allocs += std::max<int64_t>(stats.num_allocs, 0);
+  if (stats.nodes_before >= 0) entry.nodes_delta += stats.nodes_after - stats.nodes_before;
+  for (const PassStats& child : stats.children) {
+    (*summary)[stats.name].self_duration_us -= child.duration.count();
+    SummarizePassStats(child, summary);
+  }
+}
+
+void WriteTraceEvents(std::ostream& os, const PassStats& stats,
+                      PassStats::Clock::time_point origin, bool* first) {
+  if (!*first) os << ",";
+  *first = false;
+  // the events span the measures of the sub-passes too, so that they nest in the trace
+  PassStats::Duration ts = stats.start - origin;
+  PassStats::Duration dur = stats.duration + stats.overhead;
+  os << "{\"name\":" << JSONString(stats.name) << ",\"cat\":\"pass\",\"ph\":\"X\",\"pid\":0,"
+     << "\"tid\":0,\"ts\":" << ts.count() << ",\"dur\":" << dur.count()
+     << ",\"args\":{";
+  WritePassMeasures(os, stats);
+  os << "}}";
+  for (const PassStats& child : stats.children) {
+    WriteTraceEvents(os, child, origin, first);
+  }
+}
+
+PassStatsThreadLocalEntry* CompletedPassStats() {
+  PassStatsThreadLocalEntry* entry = PassStatsThreadLocalStore::Get();
+  CHECK(entry->stats_stack.empty()) << "cannot export the pass stats while still in a pass!";
+  return entry;
+}
+}  // namespace
+
+String PassStatsAsJSON() {
+  PassStatsThreadLocalEntry* entry = CompletedPassStats();
+  std::map<std::string, PassSummary> summary;
+  for (const PassStats& stats : entry->root.children) {
+    SummarizePassStats(stats, &summary);
+  }
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(1);
+  os << "{\"passes\":[";
+  for (size_t i = 0; i < entry->root.children.size(); ++i) {
+    if (i != 0) os << ",";
+    WritePassStatsJSON(os, entry->root.children[i]);
+  }
+  os << "],\"summary\":{";
+  bool first = true;
+  for (const auto& kv : summary) {
+    if (!first) os << ",";
+    first = false;
+    const PassSummary& s = kv.second;
+    os << JSONString(kv.first) << ":{\"count\":" << s.count << ",\"duration_us\":" << s.duration_us
+       << ",\"self_duration_us\":" << s.self_duration_us
+       << ",\"peak_rss_delta_kb\":" << s.peak_rss_delta_kb << ",\"num_allocs\":" << s.num_allocs
+       << ",\"nodes_delta\":" << s.nodes_delta << "}";
+  }
+  os << "}}";
+  return os.str();
+}
+
+String PassStatsAsChromeTrace() {
+  PassStatsThreadLocalEntry* entry = CompletedPassStats();
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(1);
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (const PassStats& stats : entry->root.children) {
+    WriteTraceEvents(os, stats, entry->origin, &first);
+  }
+  os << "]}";
+  return os.str();
+}
+
+TVM_REGISTER_GLOBAL("instrument.PassStatsAsJSON").set_body_typed(PassStatsAsJSON);
+
+TVM_REGISTER_GLOBAL("instrument.PassStatsAsChromeTrace").set_body_typed(PassStatsAsChromeTrace);
+
+TVM_REGISTER_GLOBAL("instrument.MakePassStatsInstrument").set_body_typed([](bool count_nodes) {
+  // the time spent counting the nodes is not part of the passes
+  auto run_before_pass = [count_nodes](const IRModule& mod, const transform::PassInfo& pass_info) {
+    PassStats::Clock::time_point begin = PassStats::Clock::now();
+    PassStatsThreadLocalEntry* entry = PassStatsThreadLocalStore::Get();
+    PassStats* parent = entry->Current();
+    parent->children.emplace_back(pass_info->name);
+    PassStats* stats = &parent->children.back();
+    entry->stats_stack.push(stats);
+    if (count_nodes) stats->nodes_before = CountIRNodes(mod);
+    stats->peak_rss_kb = PeakRSSKB();
+    stats->allocs = ObjectAllocs();
+    stats->start = PassStats::Clock::now();
+    parent->overhead += stats->start - begin;
+  };
+
+  auto run_after_pass = [count_nodes](const IRModule& mod, const transform::PassInfo& pass_info) {
+    PassStats::Clock::time_point end = PassStats::Clock::now();
+    PassStatsThreadLocalEntry* entry = PassStatsThreadLocalStore::Get();
+    ICHECK(!entry->stats_stack.empty()) << "mismatched enter/exit for pass stats";
+    PassStats* stats = entry->stats_stack.top();
+    stats->duration = end - stats->start - stats->overhead;
+    stats->peak_rss_delta_kb = PeakRSSKB() - stats->peak_rss_kb;
+#if TVM_USE_OBJECT_POOL
+    stats->num_allocs = static_cast<int64_t>(ObjectAllocs() - stats->allocs);
+#endif
+    if (count_nodes) stats->nodes_after = CountIRNodes(mod);
+    entry->stats_stack.pop();
+    entry->Current()->overhead += stats->overhead + (PassStats::Clock::now() - end);
+  };
+
+  auto enter_pass_ctx = []() { PassStatsThreadLocalStore::Get()->Reset(); };
+
+  return BasePassInstrument("PassStatsInstrument", enter_pass_ctx, /* exit_pass_ctx */ nullptr,
+                            /* should_run */ nullptr, run_before_pass, run_after_pass);
+});
+
 }  // namespace instrument
 }  // namespace tvm
@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/driver/driver_api.h>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief A builder compiling the inputs on a pool of threads of the current process.
+ *
+ *  Lowering and code generation run natively, and the caller's PassContext is entered on
+ *  each thread. Unlike the LocalBuilder, a build cannot be killed, so there is no timeout.
+ */
+class ThreadedBuilderNode : public BuilderNode {
+ public:
+  /*! \brief The function type building one IRModule. */
+  using FBuildOne = runtime::TypedPackedFunc<runtime::Module(IRModule, Target)>;
+  /*! \brief The function type exporting a built module, returning the artifact path. */
+  using FExport = runtime::TypedPackedFunc<String(runtime::Module)>;
+
+  /*! \brief The number of threads building in parallel. */
+  int num_threads;
+  /*! \brief The build function, the native lowering and code generation if it is null. */
+  FBuildOne f_build;
+  /*! \brief The export function, `meta_schedule.builder.default_export` if it is null. */
+  FExport f_export;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("num_threads", &num_threads);
+    // `f_build` is not visited
+    // `f_export` is not visited
+  }
+
+  Array<BuilderResult> Build(const Array<BuilderInput>& build_inputs) final {
+    FExport f_export = this->f_export;
+    if (f_export == nullptr) {
+      const runtime::PackedFunc* f = runtime::Registry::Get("meta_schedule.builder.default_export");
+      CHECK(f) << "ValueError: Cannot find the export function "
+                  "`meta_schedule.builder.default_export`, please import tvm.meta_schedule";
+      f_export = *f;
+    }
+    int n = build_inputs.size();
+    std::vector<Optional<String>> artifact_paths(n);
+    std::vector<Optional<String>> error_msgs(n);
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    support::parallel_for_dynamic(0, n, std::min(num_threads, std::max(n, 1)),
+                                  [&](int thread_id, int i) {
+                                    With<transform::PassContext> ctx(pass_ctx);
+                                    try {
+                                      runtime::Module rt_mod = BuildOne(build_inputs[i]);
+                                      artifact_paths[i] = f_export(rt_mod);
+                                    } catch (const std::exception& e) {
+                                      error_msgs[i] = String(
+                                          std::string("ThreadedBuilder: An exception occurred\n") +
+                                          e.what());
+                                    }
+                                  });
+    Array<BuilderResult> results;
+    results.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      results.push_back(BuilderResult(artifact_paths[i], error_msgs[i]));
+    }
+    return results;
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.ThreadedBuilder";
+  TVM_DECLARE_FINAL_OBJECT_INFO(ThreadedBuilderNode, BuilderNode);
+
+ private:
+  runtime::Module BuildOne(const BuilderInput& input) const {
+    if (f_build != nullptr) {
+      return f_build(input->mod, input->target);
+    }
+    const Target& target = input->target;
+    return tvm::build(LowerModule(input->mod, /*simple_mode=*/false), target,
+                      target->GetHost().value_or(Target()));
+  }
+};
+
+Builder Builder::Threaded(int num_threads, PackedFunc f_build, PackedFunc f_export) {
+  CHECK_GT(num_threads, 0) << "ValueError: `num_threads` should be positive";
+  ObjectPtr<ThreadedBuilderNode> n = make_object<ThreadedBuilderNode>();
+  n->num_threads = num_threads;
+  n->f_build = f_build;
+  n->f_export = f_export;
+  return Builder(std::move(n));
+}
+
+TVM_REGISTER_NODE_TYPE(ThreadedBuilderNode);
+TVM_REGISTER_GLOBAL("meta_schedule.BuilderThreaded").set_body_typed(Builder::Threaded);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -0,0 +1,48 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+CostModel CostModel::PyCostModel(PyCostModelNode::FUpdate f_update,
+                                 PyCostModelNode::FPredict f_predict) {
+  ObjectPtr<PyCostModelNode> n = make_object<PyCostModelNode>();
+  n->f_update = std::move(f_update);
+  n->f_predict = std::move(f_predict);
+  return CostModel(n);
+}
+
+/******** FFI ********/
+
+TVM_REGISTER_OBJECT_TYPE(CostModelNode);
+TVM_REGISTER_NODE_TYPE(PyCostModelNode);
+
+TVM_REGISTER_GLOBAL("meta_schedule.CostModelUpdate")
+    .set_body_method<CostModel>(&CostModelNode::Update);
+TVM_REGISTER_GLOBAL("meta_schedule.CostModelPredict")
+    .set_body_typed([](CostModel model, const TuneContext& tune_context,
+                       Array<MeasureCandidate> candidates, void* p_addr) -> void {
+      std::vector<double> scores = model->Predict(tune_context, candidates);
+      std::copy(scores.begin(), scores.end(), static_cast<double*>(p_addr));
+    });
+TVM_REGISTER_GLOBAL("meta_schedule.CostModelPyCostModel").set_body_typed(CostModel::PyCostModel);
+
+}  // namespace meta_schedule
+}  // namespace tvm
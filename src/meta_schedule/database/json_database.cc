@@ -16,8 +16,13 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <set>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "../utils.h"
 
@@ -46,23 +51,71 @@ struct SortTuningRecordByMeanRunSecs {
   }
 };
 
+/*!
+ * \brief Read the leading integer of a JSON array line, e.g. the workload index of a tuning
+ *  record or the structural hash of a workload, without parsing the rest of the line.
+ * \param line The line.
+ * \param quoted Whether the integer is a JSON string.
+ * \param result The integer.
+ * \return Whether the line starts as expected.
+ */
+bool ParseLeadingInteger(const std::string& line, bool quoted, uint64_t* result) {
+  size_t i = line.find_first_not_of(" \t");
+  if (i == std::string::npos || line[i] != '[') return false;
+  i = line.find_first_not_of(" \t", i + 1);
+  if (i == std::string::npos) return false;
+  if (quoted && line[i++] != '"') return false;
+  size_t end = i;
+  while (end < line.size() && line[end] >= '0' && line[end] <= '9') ++end;
+  if (end == i || end - i > 20 || (quoted && (end == line.size() || line[end] != '"'))) {
+    return false;
+  }
+  errno = 0;
+  *result = std::strtoull(line.c_str() + i, nullptr, 10);
+  return errno == 0;
+}
+
 /*! \brief The default database implementation, which mimics two database tables with two files. */
 class JSONDatabaseNode : public DatabaseNode {
  public:
+  /*!
+   * \brief A workload and its tuning records.
+   *
+   *  The entries read from the files are decoded on first use, so that a large database
+   *  only pays for the workloads it is queried for.
+   */
+  struct Entry {
+    /*! \brief The workload, undefined until its line is decoded. */
+    Workload workload{nullptr};
+    /*! \brief The JSON line of the workload, cleared once decoded. */
+    String workload_json;
+    /*! \brief The JSON lines of the records not decoded yet. */
+    Array<String> pending_records;
+    /*! \brief The decoded records, sorted by mean run seconds. */
+    std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs> records;
+  };
   /*! \brief The path to the workload table */
   String path_workload;
   /*! \brief The path to the tuning record table */
   String path_tuning_record;
-  /*! \brief All the workloads in the database */
+  /*! \brief The decoded workloads in the database */
   std::unordered_map<Workload, int, WorkloadHash, WorkloadEqual> workloads2idx_;
-  /*! \brief All the tuning records in the database */
-  std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs> tuning_records_;
+  /*! \brief The workloads and their records, indexed by workload index */
+  std::vector<Entry> entries_;
+  /*! \brief The workloads not decoded yet, indexed by structural hash */
+  std::unordered_multimap<Workload::THashCode, int> undecoded_workloads_;
+  /*! \brief The number of tuning records in the database */
+  int64_t num_records_ = 0;
+  /*! \brief The subtree hashes of the committed modules */
+  SHashCache shash_cache_;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("path_workload", &path_workload);
     v->Visit("path_tuning_record", &path_tuning_record);
     // `workloads2idx_` is not visited
-    // `tuning_records_` is not visited
+    // `entries_` is not visited
+    // `undecoded_workloads_` is not visited
+    // `num_records_` is not visited
   }
 
   static constexpr const char* _type_key = "meta_schedule.JSONDatabase";
@@ -70,25 +123,36 @@ class JSONDatabaseNode : public DatabaseNode {
 
  public:
   Workload CommitWorkload(const IRModule& mod) {
-    // Try to insert `mod` into `workloads_`
-    decltype(this->workloads2idx_)::iterator it;
-    bool inserted = false;
-    std::tie(it, inserted) =
-        this->workloads2idx_.emplace(Workload(mod, tvm::StructuralHash()(mod)), -1);
-    Workload workload = it->first;
-    // If `mod` is new in `workloads2idx_`, append it to the workload file
-    if (inserted) {
-      it->second = static_cast<int>(this->workloads2idx_.size()) - 1;
-      JSONFileAppendLine(this->path_workload, JSONObj2Str(workload->AsJSON()));
+    Workload::THashCode shash;
+    {
+      // the tasks commit modules sharing most of their functions
+      With<SHashCacheContext> shash_scope(&shash_cache_);
+      shash = tvm::StructuralHash()(mod);
+    }
+    Workload workload(mod, shash);
+    int index = this->FindWorkload(workload);
+    if (index != -1) {
+      return this->entries_[index].workload;
     }
-    return it->first;
+    // `mod` is new, append it to the workload file
+    index = static_cast<int>(this->entries_.size());
+    this->entries_.emplace_back();
+    this->entries_.back().workload = workload;
+    this->workloads2idx_.emplace(workload, index);
+    JSONFileAppendLine(this->path_workload, JSONObj2Str(workload->AsJSON()));
+    return workload;
   }
 
   void CommitTuningRecord(const TuningRecord& record) {
-    this->tuning_records_.insert(record);
+    int index = this->FindWorkload(record->workload);
+    CHECK_NE(index, -1) << "ValueError: The workload of the tuning record is not committed";
+    // decode the records read from the file first, to keep the order of the ties
+    this->DecodeRecords(index);
+    this->entries_[index].records.insert(record);
+    ++this->num_records_;
     JSONFileAppendLine(this->path_tuning_record,
                        JSONObj2Str(Array<ObjectRef>{
-                           /*workload_index=*/Integer(this->workloads2idx_.at(record->workload)),
+                           /*workload_index=*/Integer(index),
                            /*tuning_record=*/record->AsJSON()  //
                        }));
   }
@@ -98,56 +162,123 @@ class JSONDatabaseNode : public DatabaseNode {
     if (top_k == 0) {
       return {};
     }
+    int index = this->FindWorkload(workload);
+    if (index == -1) {
+      return {};
+    }
+    this->DecodeRecords(index);
+    const auto& records = this->entries_[index].records;
     Array<TuningRecord> results;
-    results.reserve(top_k);
-    int counter = 0;
-    for (const TuningRecord& record : this->tuning_records_) {
-      if (WorkloadEqual()(record->workload, workload)) {
-        results.push_back(record);
-        if (++counter == top_k) {
-          break;
-        }
+    results.reserve(std::min<size_t>(top_k, records.size()));
+    for (const TuningRecord& record : records) {
+      results.push_back(record);
+      if (static_cast<int>(results.size()) == top_k) {
+        break;
       }
     }
     return results;
   }
 
-  int64_t Size() { return tuning_records_.size(); }
-};
+  int64_t Size() { return num_records_; }
 
-Database Database::JSONDatabase(String path_workload, String path_tuning_record,
-                                bool allow_missing) {
-  ObjectPtr<JSONDatabaseNode> n = make_object<JSONDatabaseNode>();
-  // Load `n->workloads2idx_` from `path_workload`
-  std::vector<Workload> workloads;
-  {
-    Array<ObjectRef> json_objs = JSONStr2Obj(JSONFileReadLines(path_workload, allow_missing));
-    int n_objs = json_objs.size();
-    n->workloads2idx_.reserve(n_objs);
-    workloads.reserve(n_objs);
-    for (int i = 0; i < n_objs; ++i) {
-      Workload workload = Workload::FromJSON(json_objs[i]);
-      n->workloads2idx_.emplace(workload, i);
-      workloads.push_back(workload);
+  /*!
+   * \brief Find a workload, decoding the workloads of the file with the same structural hash.
+   * \param workload The workload.
+   * \return Its index, -1 when it is not in the database.
+   */
+  int FindWorkload(const Workload& workload) {
+    auto it = this->workloads2idx_.find(workload);
+    if (it != this->workloads2idx_.end()) {
+      return it->second;
+    }
+    auto range = this->undecoded_workloads_.equal_range(workload->shash);
+    if (range.first == range.second) {
+      return -1;
     }
+    std::vector<int> indices;
+    for (auto jt = range.first; jt != range.second; ++jt) {
+      indices.push_back(jt->second);
+    }
+    this->undecoded_workloads_.erase(workload->shash);
+    for (int index : indices) {
+      this->DecodeWorkload(index);
+    }
+    it = this->workloads2idx_.find(workload);
+    return it == this->workloads2idx_.end() ? -1 : it->second;
   }
-  // Load `n->tuning_records_` from `path_tuning_record`
-  {
-    Array<ObjectRef> json_objs = JSONStr2Obj(JSONFileReadLines(path_tuning_record, allow_missing));
+
+  /*! \brief Decode a workload read from the file. */
+  void DecodeWorkload(int index) {
+    Entry& entry = this->entries_[index];
+    Array<ObjectRef> json_objs = JSONStr2Obj({entry.workload_json});
+    entry.workload = Workload::FromJSON(json_objs[0]);
+    entry.workload_json = String();
+    this->workloads2idx_.emplace(entry.workload, index);
+  }
+
+  /*! \brief Decode the records of a workload read from the file. */
+  void DecodeRecords(int index) {
+    Entry& entry = this->entries_[index];
+    if (entry.pending_records.empty()) {
+      return;
+    }
+    Array<ObjectRef> json_objs = JSONStr2Obj(entry.pending_records);
+    entry.pending_records = {};
     for (const ObjectRef& json_obj : json_objs) {
-      int workload_index = -1;
       ObjectRef tuning_record{nullptr};
       try {
         const ArrayNode* arr = json_obj.as<ArrayNode>();
         ICHECK_EQ(arr->size(), 2);
-        workload_index = Downcast<Integer>(arr->at(0));
         tuning_record = arr->at(1);
       } catch (std::runtime_error& e) {
         LOG(FATAL) << "ValueError: Unable to parse the JSON object: " << json_obj
                    << "\nThe error is: " << e.what();
       }
-      n->tuning_records_.insert(TuningRecord::FromJSON(tuning_record, workloads[workload_index]));
+      entry.records.insert(TuningRecord::FromJSON(tuning_record, entry.workload));
+    }
+  }
+};
+
+Database Database::JSONDatabase(String path_workload, String path_tuning_record,
+                                bool allow_missing) {
+  ObjectPtr<JSONDatabaseNode> n = make_object<JSONDatabaseNode>();
+  // Index the workloads of `path_workload` by structural hash, they are decoded on first use
+  {
+    Array<String> lines = JSONFileReadLines(path_workload, allow_missing);
+    n->entries_.resize(lines.size());
+    for (int i = 0, n_lines = lines.size(); i < n_lines; ++i) {
+      JSONDatabaseNode::Entry& entry = n->entries_[i];
+      uint64_t shash = 0;
+      if (ParseLeadingInteger(lines[i], /*quoted=*/true, &shash)) {
+        entry.workload_json = lines[i];
+        n->undecoded_workloads_.emplace(shash, i);
+      } else {
+        entry.workload = Workload::FromJSON(JSONStr2Obj({lines[i]})[0]);
+        n->workloads2idx_.emplace(entry.workload, i);
+      }
+    }
+  }
+  // Group the lines of `path_tuning_record` by workload, they are decoded on first use
+  {
+    Array<String> lines = JSONFileReadLines(path_tuning_record, allow_missing);
+    uint64_t n_workloads = n->entries_.size();
+    for (const String& line : lines) {
+      uint64_t workload_index = 0;
+      if (!ParseLeadingInteger(line, /*quoted=*/false, &workload_index)) {
+        try {
+          const ArrayNode* arr = JSONStr2Obj({line})[0].as<ArrayNode>();
+          ICHECK(arr != nullptr && arr->size() == 2);
+          workload_index = Downcast<Integer>(arr->at(0))->value;
+        } catch (std::runtime_error& e) {
+          LOG(FATAL) << "ValueError: Unable to parse the JSON object: " << line
+                     << "\nThe error is: " << e.what();
+        }
+      }
+      CHECK_LT(workload_index, n_workloads)
+          << "ValueError: Unknown workload index " << workload_index << " in: " << line;
+      n->entries_[workload_index].pending_records.push_back(line);
     }
+    n->num_records_ = lines.size();
   }
   n->path_workload = path_workload;
   n->path_tuning_record = path_tuning_record;
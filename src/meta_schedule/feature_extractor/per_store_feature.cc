@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/auto_scheduler/feature.h>
+#include <tvm/tir/transform.h>
+
+#include <atomic>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief The per-store features of the TensorIR candidates.
+ *
+ *  The scheduled PrimFuncs are lowered to loops over flattened buffers, with the thread
+ *  bindings as thread extent attributes, the form the auto-scheduler extracts its per-store
+ *  features from. The loops are not vectorized, their annotations being features.
+ */
+class PerStoreFeatureNode : public FeatureExtractorNode {
+ public:
+  /*! \brief The number of buffers described for each store. */
+  int buffers_per_store;
+  /*! \brief The size of a cache line in bytes. */
+  int cache_line_bytes;
+  /*! \brief The number of features of a row. */
+  int feature_vector_length;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("buffers_per_store", &buffers_per_store);
+    v->Visit("cache_line_bytes", &cache_line_bytes);
+    v->Visit("feature_vector_length", &feature_vector_length);
+  }
+
+  Array<runtime::NDArray> ExtractFrom(const TuneContext& tune_context,
+                                      const Array<MeasureCandidate>& candidates) final {
+    int n = candidates.size();
+    std::vector<std::vector<float>> features(n);
+    std::atomic<int> num_errors(0);
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    int num_threads = std::min(std::max(tune_context->num_threads, 1), std::max(n, 1));
+    support::parallel_for_dynamic(0, n, num_threads, [&](int thread_id, int i) {
+      With<transform::PassContext> ctx(pass_ctx);
+      try {
+        ExtractOne(candidates[i]->sch->mod(), &features[i]);
+      } catch (const std::exception& e) {
+        // the candidates failing to lower get no row
+        features[i].clear();
+        ++num_errors;
+      }
+    });
+    if (num_errors > 0) {
+      LOG(WARNING) << "PerStoreFeature: " << num_errors.load()
+                   << " candidates failed to lower, they have no feature";
+    }
+    // Copy the rows of all candidates to one array
+    DLDevice cpu{kDLCPU, 0};
+    runtime::NDArray row_offsets = runtime::NDArray::Empty({n + 1}, DataType::Int(64), cpu);
+    int64_t* offsets = static_cast<int64_t*>(row_offsets->data);
+    offsets[0] = 0;
+    for (int i = 0; i < n; ++i) {
+      offsets[i + 1] = offsets[i] + features[i].size() / feature_vector_length;
+    }
+    runtime::NDArray feature_array = runtime::NDArray::Empty(
+        {offsets[n], feature_vector_length}, DataType::Float(32), cpu);
+    float* data = static_cast<float*>(feature_array->data);
+    for (int i = 0; i < n; ++i) {
+      std::copy(features[i].begin(), features[i].end(),
+                data + offsets[i] * feature_vector_length);
+    }
+    return {feature_array, row_offsets};
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.PerStoreFeature";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PerStoreFeatureNode, FeatureExtractorNode);
+
+ private:
+  void ExtractOne(IRModule mod, std::vector<float>* rows) const {
+    mod = transform::Sequential({
+        tir::transform::LowerCrossThreadReduction(),
+        tir::transform::LowerInitBlock(),
+        tir::transform::PlanAndUpdateBufferAllocationLocation(),
+        tir::transform::ConvertBlocksToOpaque(),
+        tir::transform::UnifyThreadBinding(),
+        tir::transform::CompactBufferAllocation(),
+        tir::transform::LowerMatchBuffer(),
+        tir::transform::FlattenBuffer(),
+        tir::transform::Simplify(),
+    })(std::move(mod));
+    for (const auto& kv : mod->functions) {
+      const auto* func = kv.second.as<tir::PrimFuncNode>();
+      if (func == nullptr) continue;
+      // The number of stores, followed by their rows
+      std::vector<float> func_rows;
+      auto_scheduler::GetPerStoreFeature(func->body, cache_line_bytes, buffers_per_store,
+                                         &func_rows);
+      ICHECK(!func_rows.empty());
+      ICHECK_EQ(func_rows.size() - 1, static_cast<size_t>(func_rows[0]) * feature_vector_length);
+      rows->insert(rows->end(), func_rows.begin() + 1, func_rows.end());
+    }
+  }
+};
+
+FeatureExtractor FeatureExtractor::PerStoreFeature(int buffers_per_store, int cache_line_bytes) {
+  CHECK_GT(buffers_per_store, 0) << "ValueError: `buffers_per_store` should be positive";
+  CHECK_GT(cache_line_bytes, 0) << "ValueError: `cache_line_bytes` should be positive";
+  ObjectPtr<PerStoreFeatureNode> n = make_object<PerStoreFeatureNode>();
+  n->buffers_per_store = buffers_per_store;
+  n->cache_line_bytes = cache_line_bytes;
+  std::vector<std::string> names;
+  auto_scheduler::GetPerStoreFeatureName(buffers_per_store, &names);
+  n->feature_vector_length = names.size();
+  return FeatureExtractor(n);
+}
+
+TVM_REGISTER_NODE_TYPE(PerStoreFeatureNode);
+TVM_REGISTER_GLOBAL("meta_schedule.FeatureExtractorPerStoreFeature")
+    .set_body_typed(FeatureExtractor::PerStoreFeature);
+
+}  // namespace meta_schedule
+}  // namespace tvm
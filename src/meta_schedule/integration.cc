@@ -19,6 +19,7 @@
 #include <tvm/meta_schedule/integration.h>
 #include <tvm/relay/function.h>
 #include <tvm/tir/function.h>
+#include <tvm/tir/schedule/schedule.h>
 
 namespace tvm {
 namespace meta_schedule {
@@ -41,11 +42,13 @@ bool HasOnlyOneFunction(const IRModule& mod) {
 
 /**************** ExtractedTask ****************/
 
-ExtractedTask::ExtractedTask(String task_name, IRModule mod, Array<IRModule> dispatched) {
+ExtractedTask::ExtractedTask(String task_name, IRModule mod, Array<IRModule> dispatched,
+                             int weight) {
   ObjectPtr<ExtractedTaskNode> n = make_object<ExtractedTaskNode>();
   n->task_name = task_name;
   n->mod = mod;
   n->dispatched = dispatched;
+  n->weight = weight;
   data_ = n;
 }
 
@@ -102,6 +105,16 @@ Optional<ObjectRef> TaskExtractionNode::Query(runtime::String task_name, IRModul
   return NullOpt;
 }
 
+void TaskExtractionNode::UpdateWeights(const Map<String, Integer>& weights) {
+  for (int i = 0, n = tasks.size(); i < n; ++i) {
+    const ExtractedTask& task = tasks[i];
+    if (Optional<Integer> weight = weights.Get(task->task_name)) {
+      tasks.Set(i, ExtractedTask(task->task_name, task->mod, task->dispatched,
+                                 std::max<int>(weight.value()->value, 1)));
+    }
+  }
+}
+
 /**************** ApplyHistoryBest ****************/
 
 ApplyHistoryBest::ApplyHistoryBest(Database database) {
@@ -112,7 +125,36 @@ ApplyHistoryBest::ApplyHistoryBest(Database database) {
 
 Optional<ObjectRef> ApplyHistoryBestNode::Query(runtime::String task_name, IRModule mod,
                                                 Optional<Array<IRModule>> dispatched) {
-  throw;
+  ICHECK(dispatched.defined());
+  ICHECK_EQ(dispatched.value().size(), 1);
+  IRModule prim_mod = dispatched.value()[0];
+  ICHECK(HasOnlyOneFunction<tir::PrimFunc>(prim_mod)) << prim_mod;
+  Workload::THashCode shash = tvm::StructuralHash()(prim_mod);
+  Array<TuningRecord> records;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = results_.equal_range(shash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (tvm::StructuralEqual()(it->second.mod, prim_mod)) {
+        return it->second.result;
+      }
+    }
+    records = database->GetTopK(Workload(prim_mod, shash), 1);
+  }
+  // Apply the best trace outside of the lock, the other workloads being queried meanwhile
+  Optional<tir::PrimFunc> result;
+  if (!records.empty()) {
+    tir::Schedule sch =
+        tir::Schedule::Traced(prim_mod, /*seed=*/-1, /*debug_mask=*/0,
+                              /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+    records[0]->trace->ApplyToSchedule(sch, /*remove_postproc=*/false);
+    for (const auto& kv : sch->mod()->functions) {
+      result = Downcast<tir::PrimFunc>(kv.second);
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  results_.emplace(shash, QueryResult{prim_mod, result});
+  return result;
 }
 
 /**************** FFI ****************/
@@ -129,9 +171,17 @@ TVM_REGISTER_NODE_TYPE(TaskExtractionNode);
 TVM_REGISTER_NODE_TYPE(ApplyHistoryBestNode);
 
 TVM_REGISTER_GLOBAL("meta_schedule.ExtractedTask")
-    .set_body_typed([](String task_name, IRModule mod,
-                       Array<IRModule> dispatched) -> ExtractedTask {
-      return ExtractedTask(task_name, mod, dispatched);
+    .set_body_typed([](String task_name, IRModule mod, Array<IRModule> dispatched,
+                       int weight) -> ExtractedTask {
+      return ExtractedTask(task_name, mod, dispatched, weight);
+    });
+TVM_REGISTER_GLOBAL("meta_schedule.TaskExtractionUpdateWeightsInsideWithScope")
+    .set_body_typed([](Map<String, Integer> weights) -> void {
+      if (Optional<MetaScheduleContext> ctx = MetaScheduleContext::Current()) {
+        if (const auto* extraction = ctx.value().as<TaskExtractionNode>()) {
+          GetRef<TaskExtraction>(extraction)->UpdateWeights(weights);
+        }
+      }
     });
 TVM_REGISTER_GLOBAL("meta_schedule.MetaScheduleContextEnterScope")
     .set_body_typed(MetaScheduleContextInternal::EnterScope);
@@ -146,6 +196,10 @@ TVM_REGISTER_GLOBAL("meta_schedule.MetaScheduleContextQuery")
 TVM_REGISTER_GLOBAL("meta_schedule.TaskExtraction").set_body_typed([]() -> TaskExtraction {
   return TaskExtraction();
 });
+TVM_REGISTER_GLOBAL("meta_schedule.ApplyHistoryBest")
+    .set_body_typed([](Database database) -> ApplyHistoryBest {
+      return ApplyHistoryBest(database);
+    });
 
 }  // namespace meta_schedule
 }  // namespace tvm
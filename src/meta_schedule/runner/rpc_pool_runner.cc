@@ -0,0 +1,362 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/runtime/device_api.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief The state of one input shared by the runner and its future. */
+struct RPCPoolTask {
+  /*! \brief The input to run. */
+  RunnerInput input;
+  /*! \brief The number of attempts made so far. */
+  int num_attempts = 0;
+  /*! \brief Protects the fields below. */
+  std::mutex mutex;
+  /*! \brief Signaled when the result is set. */
+  std::condition_variable cv;
+  /*! \brief The result, defined once the input has been run. */
+  Optional<RunnerResult> result = NullOpt;
+
+  explicit RPCPoolTask(RunnerInput input) : input(std::move(input)) {}
+
+  void SetResult(RunnerResult result) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      this->result = std::move(result);
+    }
+    cv.notify_all();
+  }
+};
+
+/*!
+ * \brief A runner measuring the inputs on a pool of RPC devices.
+ *
+ *  Each device is driven by a worker thread holding its own session, which is kept across
+ *  the inputs, so the cost of a tracker request is only paid once per device. The workers
+ *  take the inputs from a shared queue, and the future of an input is done as soon as it is
+ *  measured, so the results stream back in completion order. A failed attempt drops the
+ *  session and puts the input back in the queue, to be retried by any device.
+ */
+class RPCPoolRunnerNode : public RunnerNode {
+ public:
+  /*!
+   * \brief The function type creating a session to a device of the pool.
+   * \param session_timeout_sec The lifetime of the session granted by the tracker.
+   * \return The RPC session module.
+   */
+  using FCreateSession = runtime::TypedPackedFunc<runtime::Module(int session_timeout_sec)>;
+
+  /*! \brief The function creating a session to a device of the pool. */
+  FCreateSession f_create_session;
+  /*! \brief The number of devices, i.e. of worker threads. */
+  int num_devices;
+  /*! \brief The number of times an input is retried after a failed attempt. */
+  int max_retries;
+  /*! \brief The time after which a measurement is reported to have timed out, in seconds. */
+  double timeout_sec;
+  /*! \brief The lifetime requested for a session, which is renewed before it expires. */
+  int session_lifetime_sec;
+  /*! \brief The number of times to run the function in one measurement. */
+  int number;
+  /*! \brief The number of measurements. */
+  int repeat;
+  /*! \brief The minimum duration of one measurement in milliseconds. */
+  int min_repeat_ms;
+  /*! \brief Whether to flush the CPU caches before each run. */
+  bool enable_cpu_cache_flush;
+  /*! \brief The number of sets of randomly filled arguments, each being measured. */
+  int alloc_repeat;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    // `f_create_session` is not visited
+    v->Visit("num_devices", &num_devices);
+    v->Visit("max_retries", &max_retries);
+    v->Visit("timeout_sec", &timeout_sec);
+    v->Visit("session_lifetime_sec", &session_lifetime_sec);
+    v->Visit("number", &number);
+    v->Visit("repeat", &repeat);
+    v->Visit("min_repeat_ms", &min_repeat_ms);
+    v->Visit("enable_cpu_cache_flush", &enable_cpu_cache_flush);
+    v->Visit("alloc_repeat", &alloc_repeat);
+  }
+
+  ~RPCPoolRunnerNode() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+    // The queue is drained once the workers are gone, as they may requeue a failed input while
+    // stopping, so that no future waits forever.
+    for (const std::shared_ptr<RPCPoolTask>& task : queue_) {
+      task->SetResult(RunnerResult(NullOpt, String("RPCPoolRunner: The runner was destroyed")));
+    }
+    queue_.clear();
+  }
+
+  Array<RunnerFuture> Run(Array<RunnerInput> runner_inputs) final {
+    Array<RunnerFuture> futures;
+    futures.reserve(runner_inputs.size());
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // The workers are started on the first run, the sessions on their first input.
+      while (static_cast<int>(workers_.size()) < num_devices) {
+        workers_.emplace_back([this]() { WorkerLoop(); });
+      }
+      for (const RunnerInput& input : runner_inputs) {
+        auto task = std::make_shared<RPCPoolTask>(input);
+        queue_.push_back(task);
+        futures.push_back(RunnerFuture(
+            [task]() -> bool {
+              std::lock_guard<std::mutex> lock(task->mutex);
+              return task->result.defined();
+            },
+            [task]() -> RunnerResult {
+              std::unique_lock<std::mutex> lock(task->mutex);
+              task->cv.wait(lock, [&task]() { return task->result.defined(); });
+              return task->result.value();
+            }));
+      }
+    }
+    cv_.notify_all();
+    return futures;
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.RPCPoolRunner";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RPCPoolRunnerNode, RunnerNode);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /*! \brief A session to one device of the pool. */
+  struct Session {
+    runtime::Module sess;
+    int table_index;
+    Clock::time_point expiry;
+  };
+
+  /*! \brief The loop of a worker thread, measuring inputs until the runner is destroyed. */
+  void WorkerLoop() {
+    std::unique_ptr<Session> session;
+    while (true) {
+      std::shared_ptr<RPCPoolTask> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (stop_) return;
+        task = queue_.front();
+        queue_.pop_front();
+      }
+      ++task->num_attempts;
+      auto start = Clock::now();
+      try {
+        // Renew the session when it may expire before the measurement is over.
+        if (session != nullptr &&
+            session->expiry < start + std::chrono::duration<double>(timeout_sec)) {
+          session.reset();
+        }
+        if (session == nullptr) {
+          session = CreateSession();
+        }
+        task->SetResult(RunnerResult(Measure(*session, task->input), NullOpt));
+        continue;
+      } catch (const std::exception& e) {
+        // The device may be broken or the session expired, never reuse it.
+        session.reset();
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (elapsed >= timeout_sec) {
+          std::ostringstream os;
+          os << "RPCPoolRunner: Timeout, killed after " << timeout_sec << " seconds";
+          task->SetResult(RunnerResult(NullOpt, String(os.str())));
+        } else if (task->num_attempts <= max_retries) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          queue_.push_back(task);
+          cv_.notify_one();
+        } else {
+          task->SetResult(RunnerResult(
+              NullOpt, String(std::string("RPCPoolRunner: An exception occurred\n") + e.what())));
+        }
+      }
+    }
+  }
+
+  /*! \brief Request a session to a device of the pool. */
+  std::unique_ptr<Session> CreateSession() const {
+    auto start = Clock::now();
+    std::unique_ptr<Session> session(new Session());
+    session->sess = f_create_session(session_lifetime_sec);
+    const runtime::PackedFunc* f_table_index = runtime::Registry::Get("rpc.SessTableIndex");
+    ICHECK(f_table_index != nullptr);
+    session->table_index = (*f_table_index)(session->sess);
+    session->expiry = start + std::chrono::seconds(session_lifetime_sec);
+    return session;
+  }
+
+  /*! \brief Get a function of the remote, failing with a hint when it is missing. */
+  static runtime::PackedFunc GetRemoteFunc(const Session& session, const std::string& name,
+                                           const std::string& hint) {
+    runtime::Module sess = session.sess;
+    runtime::PackedFunc f = sess.GetFunction(name);
+    CHECK(f != nullptr) << "ValueError: Cannot find the function " << name
+                        << " on the RPC server. " << hint;
+    return f;
+  }
+
+  /*! \brief Upload, load and measure an artifact on a device, then remove it. */
+  Array<FloatImm> Measure(const Session& session, const RunnerInput& input) const {
+    // Step 1. Upload the artifact.
+    std::string local_path = input->artifact_path;
+    std::string remote_path = local_path.substr(local_path.find_last_of("/\\") + 1);
+    std::string blob;
+    {
+      std::ifstream is(local_path, std::ios::binary);
+      CHECK(is.good()) << "ValueError: Cannot open the artifact: " << local_path;
+      blob.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    }
+    TVMByteArray arr{blob.data(), blob.size()};
+    GetRemoteFunc(session, "tvm.rpc.server.upload", "")(remote_path, arr);
+    runtime::PackedFunc f_remove = GetRemoteFunc(session, "tvm.rpc.server.remove", "");
+    struct RemoveGuard {
+      runtime::PackedFunc f_remove;
+      std::string remote_path;
+      ~RemoveGuard() {
+        try {
+          f_remove(remote_path);
+        } catch (const std::exception&) {
+          // The session is broken, and the artifact is gone with it.
+        }
+      }
+    } remove_guard{f_remove, remote_path};
+    const runtime::PackedFunc* f_load = runtime::Registry::Get("rpc.LoadRemoteModule");
+    ICHECK(f_load != nullptr);
+    runtime::Module rt_mod = (*f_load)(session.sess, remote_path);
+    // Step 2. Allocate and randomly fill the arguments.
+    Device dev = runtime::AddRPCSessionMask(ParseDevice(input->device_type), session.table_index);
+    runtime::PackedFunc f_random_fill = GetRemoteFunc(
+        session, "tvm.contrib.random.random_fill",
+        "Please make sure 'USE_RANDOM' is turned ON in the config.cmake on the RPC server.");
+    std::vector<std::vector<runtime::NDArray>> repeated_args(alloc_repeat);
+    for (std::vector<runtime::NDArray>& args : repeated_args) {
+      for (const ArgInfo& arg_info : input->args_info) {
+        const auto* tensor_info = arg_info.as<TensorInfoNode>();
+        CHECK(tensor_info != nullptr) << "NotImplementedError: " << arg_info;
+        runtime::NDArray arg = runtime::NDArray::Empty(tensor_info->shape, tensor_info->dtype, dev);
+        f_random_fill(arg);
+        args.push_back(arg);
+      }
+    }
+    // Step 3. Measure with the time evaluator.
+    const runtime::PackedFunc* f_time_evaluator =
+        runtime::Registry::Get("runtime.RPCTimeEvaluator");
+    ICHECK(f_time_evaluator != nullptr);
+    runtime::PackedFunc evaluator = (*f_time_evaluator)(
+        rt_mod, std::string(runtime::symbol::tvm_module_main), static_cast<int>(dev.device_type),
+        dev.device_id, number, repeat, min_repeat_ms,
+        std::string(enable_cpu_cache_flush ? "cache_flush_cpu_non_first_arg" : ""));
+    Array<FloatImm> run_secs;
+    for (const std::vector<runtime::NDArray>& args : repeated_args) {
+      std::vector<TVMValue> values(args.size());
+      std::vector<int> type_codes(args.size());
+      runtime::TVMArgsSetter setter(values.data(), type_codes.data());
+      for (size_t i = 0; i < args.size(); ++i) {
+        setter(i, args[i]);
+      }
+      runtime::TVMRetValue rv;
+      evaluator.CallPacked(runtime::TVMArgs(values.data(), type_codes.data(), args.size()), &rv);
+      std::string costs = rv;
+      ICHECK_EQ(costs.size() % sizeof(double), 0);
+      for (size_t i = 0; i < costs.size(); i += sizeof(double)) {
+        double cost;
+        std::memcpy(&cost, costs.data() + i, sizeof(double));
+        run_secs.push_back(FloatImm(DataType::Float(64), cost));
+      }
+    }
+    return run_secs;
+  }
+
+  /*! \brief Parse the device type of a RunnerInput, a target kind or a device name. */
+  static Device ParseDevice(const String& device_type) {
+    Device dev{kDLCPU, 0};
+    if (device_type == "cpu") {
+      return dev;
+    }
+    if (device_type == "gpu") {
+      dev.device_type = kDLCUDA;
+      return dev;
+    }
+    Optional<TargetKind> kind = TargetKind::Get(device_type);
+    CHECK(kind.defined()) << "ValueError: Unknown device type: " << device_type;
+    dev.device_type = static_cast<DLDeviceType>(kind.value().as<TargetKindNode>()->device_type);
+    return dev;
+  }
+
+  /*! \brief Protects the fields below. */
+  std::mutex mutex_;
+  /*! \brief Signaled when an input is queued or the runner is destroyed. */
+  std::condition_variable cv_;
+  /*! \brief The inputs waiting for a device. */
+  std::deque<std::shared_ptr<RPCPoolTask>> queue_;
+  /*! \brief The worker threads, one per device. */
+  std::vector<std::thread> workers_;
+  /*! \brief Set to stop the workers. */
+  bool stop_ = false;
+};
+
+Runner Runner::RPCPool(PackedFunc f_create_session, int num_devices, int max_retries,
+                       double timeout_sec, int session_lifetime_sec, int number, int repeat,
+                       int min_repeat_ms, bool enable_cpu_cache_flush, int alloc_repeat) {
+  CHECK(f_create_session != nullptr) << "ValueError: `f_create_session` is not provided";
+  CHECK_GT(num_devices, 0) << "ValueError: `num_devices` should be positive";
+  CHECK_GE(max_retries, 0) << "ValueError: `max_retries` should be non-negative";
+  CHECK_GT(session_lifetime_sec, timeout_sec)
+      << "ValueError: `session_lifetime_sec` should be longer than `timeout_sec`";
+  ObjectPtr<RPCPoolRunnerNode> n = make_object<RPCPoolRunnerNode>();
+  n->f_create_session = f_create_session;
+  n->num_devices = num_devices;
+  n->max_retries = max_retries;
+  n->timeout_sec = timeout_sec;
+  n->session_lifetime_sec = session_lifetime_sec;
+  n->number = number;
+  n->repeat = repeat;
+  n->min_repeat_ms = min_repeat_ms;
+  n->enable_cpu_cache_flush = enable_cpu_cache_flush;
+  n->alloc_repeat = alloc_repeat;
+  return Runner(n);
+}
+
+TVM_REGISTER_NODE_TYPE(RPCPoolRunnerNode);
+TVM_REGISTER_GLOBAL("meta_schedule.RunnerRPCPool").set_body_typed(Runner::RPCPool);
+
+}  // namespace meta_schedule
+}  // namespace tvm
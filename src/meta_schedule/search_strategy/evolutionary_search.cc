@@ -0,0 +1,484 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <random>
+#include <unordered_set>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*! \brief A schedule scored by the cost model, with the structural hash of its module. */
+struct ScoredSchedule {
+  tir::Schedule sch;
+  size_t hash;
+  double score;
+};
+
+/*!
+ * \brief A search strategy evolving the decisions of the design spaces, guided by a cost model.
+ *
+ *  Each iteration starts from a population made of the best measured traces and of random
+ *  samples of the design spaces. The population then evolves for a few generations, the
+ *  parents being drawn in proportion to their predicted scores and mutated by changing one
+ *  sampling decision. The candidates measured are the best predicted ones not measured yet,
+ *  a fraction `eps_greedy` of them being random samples to keep exploring.
+ */
+class EvolutionarySearchNode : public SearchStrategyNode {
+ public:
+  using TRandState = support::LinearCongruentialEngine::TRandState;
+
+  /*! \brief The state of the search strategy. */
+  struct State {
+    /*! \brief The search strategy itself */
+    EvolutionarySearchNode* self;
+    /*! \brief The traces of the design spaces. */
+    Array<tir::Trace> design_spaces;
+    /*! \brief The number of candidates generated so far. */
+    int num_trials_generated = 0;
+    /*! \brief The measured traces with their mean running time, sorted by the time. */
+    std::vector<std::pair<double, tir::Trace>> measured_traces;
+    /*! \brief The structural hash of the modules measured or being measured. */
+    std::unordered_set<size_t> measured_hashes;
+    /*! \brief The candidates of the last batch, whose results are to be notified. */
+    Array<MeasureCandidate> pending_candidates;
+
+    explicit State(EvolutionarySearchNode* self, Array<tir::Trace> design_spaces)
+        : self(self), design_spaces(design_spaces) {}
+
+    inline Optional<Array<MeasureCandidate>> GenerateMeasureCandidates();
+    inline void NotifyRunnerResults(const Array<RunnerResult>& results);
+
+   private:
+    /*! \brief Sample the initial population, from the measured traces and the design spaces. */
+    inline std::vector<tir::Schedule> SampleInitPopulation(int num_measured, int num_random);
+    /*! \brief Evolve the population, returning the best unmeasured schedules seen. */
+    inline std::vector<tir::Schedule> EvolveWithCostModel(std::vector<tir::Schedule> population,
+                                                          int num);
+    /*! \brief Pick a batch from the best and the random schedules, epsilon-greedily. */
+    inline std::vector<tir::Schedule> PickWithEpsGreedy(const std::vector<tir::Schedule>& best,
+                                                        const std::vector<tir::Schedule>& random,
+                                                        int num);
+    /*! \brief Predict the scores of schedules, random ones without a cost model. */
+    inline std::vector<double> Predict(const std::vector<tir::Schedule>& population);
+  };
+
+  /*! \brief The number of trials per iteration. */
+  int num_trials_per_iter;
+  /*! \brief The number of total trials. */
+  int num_trials_total;
+  /*! \brief The number of schedules in the population. */
+  int population_size;
+  /*! \brief The fraction of the initial population taken from the measured traces. */
+  double init_measured_ratio;
+  /*! \brief The number of generations of the evolution. */
+  int genetic_num_iters;
+  /*! \brief The probability for a child to be mutated rather than copied. */
+  double genetic_mutate_prob;
+  /*! \brief The fraction of each batch made of random schedules. */
+  double eps_greedy;
+  /*! \brief The cost model, the scores are random if it is not defined. */
+  Optional<CostModel> cost_model;
+
+  /*! \brief The tuning context, which owns the search strategy. */
+  const TuneContextNode* context_ = nullptr;
+  /*! \brief The module to be tuned. */
+  IRModule mod_{nullptr};
+  /*! \brief The metadata of the function arguments. */
+  Array<ArgInfo> args_info_{nullptr};
+  /*! \brief The number of threads to use. -1 means using logical cpu number. */
+  int num_threads_ = -1;
+  /*! \brief The random state. -1 means using random number. */
+  TRandState rand_state_ = -1;
+  /*! \brief The cache of the trace prefixes, shared by the traces differing by a few decisions. */
+  std::unique_ptr<tir::TraceReplayCache> replay_cache_ = nullptr;
+  /*! \brief The state of the search strategy. */
+  std::unique_ptr<State> state_ = nullptr;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("num_trials_per_iter", &num_trials_per_iter);
+    v->Visit("num_trials_total", &num_trials_total);
+    v->Visit("population_size", &population_size);
+    v->Visit("init_measured_ratio", &init_measured_ratio);
+    v->Visit("genetic_num_iters", &genetic_num_iters);
+    v->Visit("genetic_mutate_prob", &genetic_mutate_prob);
+    v->Visit("eps_greedy", &eps_greedy);
+    v->Visit("cost_model", &cost_model);
+    // `context_` is not visited
+    // `mod_` is not visited
+    // `args_info_` is not visited
+    // `num_threads_` is not visited
+    // `rand_state_` is not visited
+    // `replay_cache_` is not visited
+    // `state_` is not visited
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.EvolutionarySearch";
+  TVM_DECLARE_FINAL_OBJECT_INFO(EvolutionarySearchNode, SearchStrategyNode);
+
+  void InitializeWithTuneContext(const TuneContext& tune_context) final {
+    this->context_ = tune_context.get();
+    this->mod_ = tune_context->mod.value();
+    this->args_info_ = ArgInfo::FromPrimFunc(FindEntryFunc(this->mod_));
+    this->num_threads_ = tune_context->num_threads;
+    this->rand_state_ = ForkSeed(&tune_context->rand_state);
+    this->replay_cache_ = std::make_unique<tir::TraceReplayCache>(this->mod_);
+    this->state_.reset();
+  }
+
+  void PreTuning(const Array<tir::Schedule>& design_spaces) final {
+    ICHECK(!design_spaces.empty());
+    ICHECK(this->state_ == nullptr);
+    Array<tir::Trace> traces;
+    for (const tir::Schedule& sch : design_spaces) {
+      traces.push_back(sch->trace().value());
+    }
+    this->state_ = std::make_unique<State>(this, traces);
+  }
+
+  void PostTuning() final {
+    ICHECK(this->state_ != nullptr);
+    this->state_.reset();
+  }
+
+  Optional<Array<MeasureCandidate>> GenerateMeasureCandidates() final {
+    ICHECK(this->state_ != nullptr);
+    return this->state_->GenerateMeasureCandidates();
+  }
+
+  void NotifyRunnerResults(const Array<RunnerResult>& results) final {
+    ICHECK(this->state_ != nullptr);
+    this->state_->NotifyRunnerResults(results);
+  }
+
+  /*!
+   * \brief Replay a trace on a schedule of the module, resuming from the longest prefix cached.
+   * \return The schedule, NullOpt if the trace fails to apply.
+   */
+  Optional<tir::Schedule> Replay(const tir::Trace& trace, TRandState* rand_state) const {
+    try {
+      return replay_cache_->Replay(trace, /*seed=*/ForkSeed(rand_state),
+                                   /*remove_postproc=*/true);
+    } catch (const std::exception& e) {
+      return NullOpt;
+    }
+  }
+
+  /*!
+   * \brief Change one sampling decision of a trace.
+   * \return The mutated trace, NullOpt if the trace has no decision that can be changed.
+   */
+  static Optional<tir::Trace> Mutate(const tir::Trace& trace, TRandState* rand_state) {
+    static const tir::InstructionKind& inst_sample_categorical =
+        tir::InstructionKind::Get("SampleCategorical");
+    static const tir::InstructionKind& inst_sample_perfect_tile =
+        tir::InstructionKind::Get("SamplePerfectTile");
+    std::vector<tir::Instruction> candidates;
+    for (const tir::Instruction& inst : trace->insts) {
+      if ((inst->kind.same_as(inst_sample_categorical) ||
+           inst->kind.same_as(inst_sample_perfect_tile)) &&
+          trace->decisions.count(inst)) {
+        candidates.push_back(inst);
+      }
+    }
+    // A few attempts, as the decision drawn may have no valid alternative.
+    for (int attempt = 0; attempt < 8 && !candidates.empty(); ++attempt) {
+      const tir::Instruction& inst = candidates[tir::SampleInt(rand_state, 0, candidates.size())];
+      ObjectRef decision = trace->decisions.at(inst);
+      Optional<ObjectRef> new_decision = NullOpt;
+      if (inst->kind.same_as(inst_sample_categorical)) {
+        new_decision = MutateCategorical(inst, Downcast<Integer>(decision), rand_state);
+      } else {
+        new_decision = MutateTile(inst, Downcast<Array<Integer>>(decision), rand_state);
+      }
+      if (new_decision.defined()) {
+        return trace->WithDecision(inst, new_decision.value(), /*remove_postproc=*/true);
+      }
+    }
+    return NullOpt;
+  }
+
+ private:
+  /*! \brief Draw another candidate of a SampleCategorical. */
+  static Optional<ObjectRef> MutateCategorical(const tir::Instruction& inst, const Integer& decision,
+                                               TRandState* rand_state) {
+    int num_candidates = Downcast<Array<Integer>>(inst->attrs[0]).size();
+    if (num_candidates < 2) {
+      return NullOpt;
+    }
+    int new_decision = tir::SampleInt(rand_state, 0, num_candidates - 1);
+    if (new_decision >= decision->value) {
+      ++new_decision;
+    }
+    return Integer(new_decision);
+  }
+
+  /*! \brief Move a factor between two tiles of a SamplePerfectTile, keeping their product. */
+  static Optional<ObjectRef> MutateTile(const tir::Instruction& inst,
+                                        const Array<Integer>& decision, TRandState* rand_state) {
+    std::vector<int64_t> tiles = support::AsVector<Integer, int64_t>(decision);
+    int n = tiles.size();
+    int64_t max_innermost_factor = Downcast<Integer>(inst->attrs[1])->value;
+    std::vector<int> sources;
+    for (int i = 0; i < n; ++i) {
+      if (tiles[i] > 1) {
+        sources.push_back(i);
+      }
+    }
+    if (sources.empty() || n < 2) {
+      return NullOpt;
+    }
+    int src = sources[tir::SampleInt(rand_state, 0, sources.size())];
+    int dst = tir::SampleInt(rand_state, 0, n - 1);
+    if (dst >= src) {
+      ++dst;
+    }
+    std::vector<int64_t> divisors;
+    for (int64_t d = 2; d <= tiles[src]; ++d) {
+      if (tiles[src] % d == 0) {
+        divisors.push_back(d);
+      }
+    }
+    int64_t d = divisors[tir::SampleInt(rand_state, 0, divisors.size())];
+    tiles[src] /= d;
+    tiles[dst] *= d;
+    if (max_innermost_factor != -1 && tiles[n - 1] > max_innermost_factor) {
+      return NullOpt;
+    }
+    return support::AsArray<int64_t, Integer>(tiles);
+  }
+};
+
+inline std::vector<double> EvolutionarySearchNode::State::Predict(
+    const std::vector<tir::Schedule>& population) {
+  if (self->cost_model.defined()) {
+    Array<MeasureCandidate> candidates;
+    candidates.reserve(population.size());
+    for (const tir::Schedule& sch : population) {
+      candidates.push_back(MeasureCandidate(sch, self->args_info_));
+    }
+    return self->cost_model.value()->Predict(GetRef<TuneContext>(self->context_), candidates);
+  }
+  support::LinearCongruentialEngine rand_engine(&self->rand_state_);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::vector<double> scores;
+  scores.reserve(population.size());
+  for (size_t i = 0; i < population.size(); ++i) {
+    scores.push_back(dist(rand_engine));
+  }
+  return scores;
+}
+
+inline std::vector<tir::Schedule> EvolutionarySearchNode::State::SampleInitPopulation(
+    int num_measured, int num_random) {
+  num_measured = std::min<int>(num_measured, measured_traces.size());
+  int num = num_measured + num_random;
+  std::vector<TRandState> per_thread_rand_state = ForkSeed(&self->rand_state_, self->num_threads_);
+  std::vector<Optional<tir::Schedule>> results(num, NullOpt);
+  auto f_worker = [this, num_measured, &per_thread_rand_state, &results](int thread_id,
+                                                                         int task_id) -> void {
+    TRandState& rand_state = per_thread_rand_state[thread_id];
+    if (task_id < num_measured) {
+      results[task_id] = self->Replay(measured_traces[task_id].second, &rand_state);
+    } else {
+      // Drop the decisions so that they are sampled again.
+      const tir::Trace& trace =
+          design_spaces[tir::SampleInt(&rand_state, 0, design_spaces.size())];
+      results[task_id] = self->Replay(tir::Trace(trace->insts, {}), &rand_state);
+    }
+  };
+  support::parallel_for_dynamic(0, num, self->num_threads_, f_worker);
+  std::vector<tir::Schedule> population;
+  population.reserve(num);
+  for (const Optional<tir::Schedule>& sch : results) {
+    if (sch.defined()) {
+      population.push_back(sch.value());
+    }
+  }
+  return population;
+}
+
+inline std::vector<tir::Schedule> EvolutionarySearchNode::State::EvolveWithCostModel(
+    std::vector<tir::Schedule> population, int num) {
+  // The best unmeasured schedules seen over the generations.
+  std::vector<ScoredSchedule> heap;
+  std::unordered_set<size_t> seen;
+  auto f_cmp = [](const ScoredSchedule& a, const ScoredSchedule& b) { return a.score > b.score; };
+  for (int iter = 0;; ++iter) {
+    std::vector<double> scores = Predict(population);
+    for (size_t i = 0; i < population.size(); ++i) {
+      size_t hash = StructuralHash()(population[i]->mod());
+      if (!measured_hashes.count(hash) && seen.insert(hash).second) {
+        heap.push_back(ScoredSchedule{population[i], hash, scores[i]});
+        std::push_heap(heap.begin(), heap.end(), f_cmp);
+        if (static_cast<int>(heap.size()) > num) {
+          std::pop_heap(heap.begin(), heap.end(), f_cmp);
+          heap.pop_back();
+        }
+      }
+    }
+    if (iter == self->genetic_num_iters || population.empty()) {
+      break;
+    }
+    // Draw the parents in proportion to their scores, shifted to be positive.
+    double min_score = *std::min_element(scores.begin(), scores.end());
+    std::vector<double> prefix_sums;
+    prefix_sums.reserve(scores.size());
+    double sum = 0.0;
+    for (double score : scores) {
+      sum += score - min_score + 1e-6;
+      prefix_sums.push_back(sum);
+    }
+    std::vector<TRandState> per_thread_rand_state =
+        ForkSeed(&self->rand_state_, self->num_threads_);
+    std::vector<tir::Schedule> next_population = population;
+    auto f_worker = [this, &population, &prefix_sums, &per_thread_rand_state, &next_population](
+                        int thread_id, int task_id) -> void {
+      TRandState& rand_state = per_thread_rand_state[thread_id];
+      support::LinearCongruentialEngine rand_engine(&rand_state);
+      std::uniform_real_distribution<double> dist(0.0, 1.0);
+      int parent = std::upper_bound(prefix_sums.begin(), prefix_sums.end(),
+                                    dist(rand_engine) * prefix_sums.back()) -
+                   prefix_sums.begin();
+      parent = std::min<int>(parent, population.size() - 1);
+      const tir::Schedule& sch = population[parent];
+      next_population[task_id] = sch;
+      if (dist(rand_engine) >= self->genetic_mutate_prob) {
+        return;
+      }
+      if (Optional<tir::Trace> trace = Mutate(sch->trace().value(), &rand_state)) {
+        if (Optional<tir::Schedule> child = self->Replay(trace.value(), &rand_state)) {
+          next_population[task_id] = child.value();
+        }
+      }
+    };
+    support::parallel_for_dynamic(0, population.size(), self->num_threads_, f_worker);
+    population = std::move(next_population);
+  }
+  std::sort_heap(heap.begin(), heap.end(), f_cmp);
+  std::vector<tir::Schedule> results;
+  results.reserve(heap.size());
+  for (const ScoredSchedule& item : heap) {
+    results.push_back(item.sch);
+  }
+  return results;
+}
+
+inline std::vector<tir::Schedule> EvolutionarySearchNode::State::PickWithEpsGreedy(
+    const std::vector<tir::Schedule>& best, const std::vector<tir::Schedule>& random, int num) {
+  int num_random = static_cast<int>(std::round(num * self->eps_greedy));
+  std::vector<tir::Schedule> results;
+  results.reserve(num);
+  size_t i_best = 0, i_random = 0;
+  auto f_add = [this, &results](const tir::Schedule& sch) -> void {
+    if (measured_hashes.insert(StructuralHash()(sch->mod())).second) {
+      results.push_back(sch);
+    }
+  };
+  while (static_cast<int>(results.size()) < num_random && i_random < random.size()) {
+    f_add(random[i_random++]);
+  }
+  while (static_cast<int>(results.size()) < num && i_best < best.size()) {
+    f_add(best[i_best++]);
+  }
+  // Too few new schedules were found by the evolution.
+  while (static_cast<int>(results.size()) < num && i_random < random.size()) {
+    f_add(random[i_random++]);
+  }
+  return results;
+}
+
+inline Optional<Array<MeasureCandidate>> EvolutionarySearchNode::State::GenerateMeasureCandidates() {
+  if (num_trials_generated >= self->num_trials_total) {
+    return NullOpt;
+  }
+  int num = std::min(self->num_trials_per_iter, self->num_trials_total - num_trials_generated);
+  int num_measured = static_cast<int>(self->population_size * self->init_measured_ratio);
+  num_measured = std::min<int>(num_measured, measured_traces.size());
+  std::vector<tir::Schedule> population =
+      SampleInitPopulation(num_measured, self->population_size - num_measured);
+  std::vector<tir::Schedule> best = EvolveWithCostModel(population, num);
+  std::vector<tir::Schedule> random = SampleInitPopulation(0, num);
+  std::vector<tir::Schedule> picked = PickWithEpsGreedy(best, random, num);
+  if (picked.empty()) {
+    // The search space is exhausted.
+    return NullOpt;
+  }
+  num_trials_generated += picked.size();
+  Array<MeasureCandidate> candidates;
+  candidates.reserve(picked.size());
+  for (const tir::Schedule& sch : picked) {
+    candidates.push_back(MeasureCandidate(sch, self->args_info_));
+  }
+  pending_candidates = candidates;
+  return candidates;
+}
+
+inline void EvolutionarySearchNode::State::NotifyRunnerResults(const Array<RunnerResult>& results) {
+  ICHECK_EQ(results.size(), pending_candidates.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    const RunnerResult& result = results[i];
+    if (result->error_msg.defined() || !result->run_secs.defined() ||
+        result->run_secs.value().empty()) {
+      continue;
+    }
+    double sum = 0.0;
+    for (const FloatImm& run_sec : result->run_secs.value()) {
+      sum += run_sec->value;
+    }
+    double mean = sum / result->run_secs.value().size();
+    measured_traces.emplace_back(mean, pending_candidates[i]->sch->trace().value());
+  }
+  std::stable_sort(measured_traces.begin(), measured_traces.end(),
+                   [](const std::pair<double, tir::Trace>& a,
+                      const std::pair<double, tir::Trace>& b) { return a.first < b.first; });
+  if (self->cost_model.defined()) {
+    self->cost_model.value()->Update(GetRef<TuneContext>(self->context_), pending_candidates,
+                                     results);
+  }
+  pending_candidates = {};
+}
+
+SearchStrategy SearchStrategy::EvolutionarySearch(int num_trials_per_iter, int num_trials_total,
+                                                  int population_size, double init_measured_ratio,
+                                                  int genetic_num_iters,
+                                                  double genetic_mutate_prob, double eps_greedy,
+                                                  Optional<CostModel> cost_model) {
+  CHECK_GT(population_size, 0) << "ValueError: `population_size` should be positive";
+  CHECK(0.0 <= init_measured_ratio && init_measured_ratio <= 1.0)
+      << "ValueError: `init_measured_ratio` should be in [0, 1]";
+  CHECK(0.0 <= eps_greedy && eps_greedy <= 1.0) << "ValueError: `eps_greedy` should be in [0, 1]";
+  ObjectPtr<EvolutionarySearchNode> n = make_object<EvolutionarySearchNode>();
+  n->num_trials_per_iter = num_trials_per_iter;
+  n->num_trials_total = num_trials_total;
+  n->population_size = population_size;
+  n->init_measured_ratio = init_measured_ratio;
+  n->genetic_num_iters = genetic_num_iters;
+  n->genetic_mutate_prob = genetic_mutate_prob;
+  n->eps_greedy = eps_greedy;
+  n->cost_model = cost_model;
+  return SearchStrategy(n);
+}
+
+TVM_REGISTER_NODE_TYPE(EvolutionarySearchNode);
+TVM_REGISTER_GLOBAL("meta_schedule.EvolutionarySearch")
+    .set_body_typed(SearchStrategy::EvolutionarySearch);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -57,6 +57,8 @@ class ReplayTraceNode : public SearchStrategyNode {
   int num_threads_ = -1;
   /*! \brief The random state. -1 means using random number. */
   TRandState rand_state_ = -1;
+  /*! \brief The cache of the deterministic prefixes of the design spaces. */
+  std::unique_ptr<tir::TraceReplayCache> replay_cache_ = nullptr;
   /*! \brief The state of the search strategy. */
   std::unique_ptr<State> state_ = nullptr;
 
@@ -67,6 +69,7 @@ class ReplayTraceNode : public SearchStrategyNode {
     // `args_info_` is not visited
     // `num_threads_` is not visited
     // `rand_state_` is not visited
+    // `replay_cache_` is not visited
     // `state_` is not visited
   }
 
@@ -78,6 +81,7 @@ class ReplayTraceNode : public SearchStrategyNode {
     this->args_info_ = ArgInfo::FromPrimFunc(FindEntryFunc(this->mod_));
     this->num_threads_ = tune_context->num_threads;
     this->rand_state_ = ForkSeed(&tune_context->rand_state);
+    this->replay_cache_ = std::make_unique<tir::TraceReplayCache>(this->mod_);
     this->state_.reset();
   }
 
@@ -117,12 +121,8 @@ inline Optional<Array<MeasureCandidate>> ReplayTraceNode::State::GenerateMeasure
     int design_space_index = tir::SampleInt(&rand_state, 0, design_spaces.size());
     tir::Trace trace = design_spaces[design_space_index]->trace().value();
     tir::Trace new_trace = tir::Trace(trace->insts, {});
-    tir::Schedule sch = tir::Schedule::Traced(  //
-        self->mod_,                             //
-        /*rand_state=*/ForkSeed(&rand_state),   //
-        /*debug_mode=*/0,                       //
-        /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
-    new_trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
+    tir::Schedule sch = self->replay_cache_->Replay(new_trace, /*seed=*/ForkSeed(&rand_state),
+                                                    /*remove_postproc=*/true);
     per_task_result.Set(task_id, MeasureCandidate(sch, self->args_info_));
   };
   support::parallel_for_dynamic(0, ed - st, self->num_threads_, f_worker);
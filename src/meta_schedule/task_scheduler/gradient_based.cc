@@ -0,0 +1,192 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <random>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+/*!
+ * \brief The task scheduler that gives the next round of trials to the task expected to reduce
+ *  the weighted sum of the task latencies the most, as the task scheduler of auto_scheduler.
+ */
+class GradientBasedNode final : public TaskSchedulerNode {
+ public:
+  /*! \brief The weight of each task, i.e. the number of times it appears in the model. */
+  Array<FloatImm> task_weights;
+  /*! \brief The weight of the backward gradient against the forward one. */
+  double alpha;
+  /*! \brief The number of past rounds the backward gradient is computed over. */
+  int backward_window_size;
+  /*! \brief Stop a task after so many rounds without improvement, disabled when -1. */
+  int early_stopping_rounds;
+  /*! \brief The random state, used to break the ties. */
+  support::LinearCongruentialEngine::TRandState rand_state;
+
+  /*! \brief The best latency of each task after each of its rounds. */
+  std::vector<std::vector<double>> best_latency_history;
+  /*! \brief The round of each task its best latency was last improved in. */
+  std::vector<int> best_round;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    TaskSchedulerNode::VisitAttrs(v);
+    v->Visit("task_weights", &task_weights);
+    v->Visit("alpha", &alpha);
+    v->Visit("backward_window_size", &backward_window_size);
+    v->Visit("early_stopping_rounds", &early_stopping_rounds);
+    // `rand_state` is not visited
+    // `best_latency_history` is not visited
+    // `best_round` is not visited
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.GradientBased";
+  TVM_DECLARE_FINAL_OBJECT_INFO(GradientBasedNode, TaskSchedulerNode);
+
+ protected:
+  /*! \brief The latency of a task with no successful measurement yet. */
+  static constexpr double kMaxLatency = 1e10;
+
+  void JoinRunningTask(int task_id) final {
+    TuneContext task = tasks[task_id];
+    ICHECK(task->runner_futures.defined());
+    // Fetch the results once, and hand them over to the base class as done futures.
+    Array<RunnerResult> results;
+    Array<RunnerFuture> done_futures;
+    for (const RunnerFuture& future : task->runner_futures.value()) {
+      RunnerResult result = future->Result();
+      results.push_back(result);
+      done_futures.push_back(RunnerFuture(
+          /*f_done=*/[]() -> bool { return true; },
+          /*f_result=*/[result]() -> RunnerResult { return result; }));
+    }
+    task->runner_futures = done_futures;
+    TaskSchedulerNode::JoinRunningTask(task_id);
+    std::vector<double>& history = best_latency_history[task_id];
+    double best = history.empty() ? kMaxLatency : history.back();
+    for (const RunnerResult& result : results) {
+      if (result->error_msg.defined() || !result->run_secs.defined()) {
+        continue;
+      }
+      Array<FloatImm> run_secs = result->run_secs.value();
+      if (run_secs.empty()) {
+        continue;
+      }
+      double sum = 0.0;
+      for (const FloatImm& secs : run_secs) {
+        sum += secs->value;
+      }
+      best = std::min(best, sum / run_secs.size());
+    }
+    if (history.empty() || best < history.back()) {
+      best_round[task_id] = history.size();
+    }
+    history.push_back(best);
+  }
+
+  int NextTaskId() final {
+    int n_tasks = this->tasks.size();
+    // The gradients need the latencies of all the rounds issued so far.
+    for (int task_id = 0; task_id < n_tasks; ++task_id) {
+      if (IsTaskRunning(task_id)) {
+        JoinRunningTask(task_id);
+      }
+    }
+    // Stop the tasks which converged.
+    for (int task_id = 0; task_id < n_tasks; ++task_id) {
+      int n_rounds = best_latency_history[task_id].size();
+      if (!tasks[task_id]->is_stopped && early_stopping_rounds >= 0 &&
+          n_rounds - 1 - best_round[task_id] >= early_stopping_rounds && n_rounds > 0) {
+        SetTaskStopped(task_id);
+      }
+    }
+    // Warm up: every task runs one round first.
+    for (int task_id = 0; task_id < n_tasks; ++task_id) {
+      if (!tasks[task_id]->is_stopped && best_latency_history[task_id].empty()) {
+        return task_id;
+      }
+    }
+    std::vector<int> task_ids;
+    std::vector<double> grads;
+    for (int task_id = 0; task_id < n_tasks; ++task_id) {
+      if (tasks[task_id]->is_stopped) {
+        continue;
+      }
+      const std::vector<double>& history = best_latency_history[task_id];
+      int n_rounds = history.size();
+      double best = history.back();
+      // The end-to-end latency is the weighted sum of the task latencies.
+      double chain_grad = task_weights[task_id]->value;
+      double backward_grad = 0.0;
+      if (n_rounds > backward_window_size) {
+        backward_grad =
+            (history.back() - history[n_rounds - 1 - backward_window_size]) / backward_window_size;
+      }
+      // Optimistically, the next round improves the latency as much as an average round did.
+      double forward_grad = -best / n_rounds;
+      task_ids.push_back(task_id);
+      grads.push_back(chain_grad * (alpha * backward_grad + (1 - alpha) * forward_grad));
+    }
+    if (task_ids.empty()) {
+      return -1;
+    }
+    auto [min_grad, max_grad] = std::minmax_element(grads.begin(), grads.end());
+    if (*min_grad == *max_grad) {
+      return task_ids[tir::SampleInt(&rand_state, 0, task_ids.size())];
+    }
+    return task_ids[min_grad - grads.begin()];
+  }
+};
+
+TaskScheduler TaskScheduler::GradientBased(Array<TuneContext> tasks,             //
+                                           Array<FloatImm> task_weights,         //
+                                           Builder builder,                      //
+                                           Runner runner,                        //
+                                           Database database,                    //
+                                           double alpha,                         //
+                                           int backward_window_size,             //
+                                           int early_stopping_rounds,            //
+                                           support::LinearCongruentialEngine::TRandState seed) {
+  CHECK_EQ(tasks.size(), task_weights.size())
+      << "ValueError: The number of tasks and task weights differ";
+  CHECK_GT(backward_window_size, 0) << "ValueError: The backward window must not be empty";
+  ObjectPtr<GradientBasedNode> n = make_object<GradientBasedNode>();
+  n->tasks = tasks;
+  n->task_weights = task_weights;
+  n->builder = builder;
+  n->runner = runner;
+  n->database = database;
+  n->alpha = alpha;
+  n->backward_window_size = backward_window_size;
+  n->early_stopping_rounds = early_stopping_rounds;
+  n->best_latency_history.resize(tasks.size());
+  n->best_round.resize(tasks.size(), 0);
+  if (seed == -1) {
+    seed = std::random_device()();
+  }
+  support::LinearCongruentialEngine(&n->rand_state).Seed(seed);
+  return TaskScheduler(n);
+}
+
+TVM_REGISTER_NODE_TYPE(GradientBasedNode);
+TVM_REGISTER_GLOBAL("meta_schedule.TaskSchedulerGradientBased")
+    .set_body_typed(TaskScheduler::GradientBased);
+
+}  // namespace meta_schedule
+}  // namespace tvm
@@ -118,8 +118,16 @@ void TaskSchedulerNode::Tune() {
         tasks[i]->space_generator.value()->GenerateDesignSpace(tasks[i]->mod.value()));
   }
 
-  int running_tasks = tasks.size();
-  while (running_tasks > 0) {
+  // A scheduler may also stop a task on its own, e.g. when its tuning converged.
+  auto has_running_tasks = [this]() -> bool {
+    for (const TuneContext& task : this->tasks) {
+      if (!task->is_stopped) {
+        return true;
+      }
+    }
+    return false;
+  };
+  while (has_running_tasks()) {
     for (int task_id; (task_id = NextTaskId()) != -1;) {
       TuneContext task = tasks[task_id];
       ICHECK(!task->is_stopped);
@@ -132,7 +140,6 @@ void TaskSchedulerNode::Tune() {
             SendToRunner(this->runner, task, task->measure_candidates.value(), builder_results);
       } else {
         SetTaskStopped(task_id);
-        --running_tasks;
       }
     }
     int n_tasks = this->tasks.size();
@@ -22,7 +22,9 @@
 #include <dmlc/memory_io.h>
 #include <tvm/meta_schedule/arg_info.h>
 #include <tvm/meta_schedule/builder.h>
+#include <tvm/meta_schedule/cost_model.h>
 #include <tvm/meta_schedule/database.h>
+#include <tvm/meta_schedule/feature_extractor.h>
 #include <tvm/meta_schedule/runner.h>
 #include <tvm/meta_schedule/search_strategy.h>
 #include <tvm/meta_schedule/space_generator.h>
@@ -40,6 +42,7 @@
 #include "../support/array.h"
 #include "../support/base64.h"
 #include "../tir/schedule/primitive.h"
+#include "../tir/schedule/trace_replay_cache.h"
 
 namespace tvm {
 namespace meta_schedule {
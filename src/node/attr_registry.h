@@ -52,6 +52,7 @@ class AttrRegistry {
    * \return The corresponding entry.
    */
   const EntryType* Get(const String& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = entry_map_.find(name);
     if (it != entry_map_.end()) return it->second;
     return nullptr;
@@ -63,6 +64,7 @@ class AttrRegistry {
    * \return The corresponding entry.
    */
   EntryType& RegisterOrGet(const String& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = entry_map_.find(name);
     if (it != entry_map_.end()) return *it->second;
     uint32_t registry_index = static_cast<uint32_t>(entries_.size());
@@ -79,6 +81,7 @@ class AttrRegistry {
    * \return The entry names.
    */
   Array<String> ListAllNames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     Array<String> names;
     for (const auto& kv : entry_map_) {
       names.push_back(kv.first);
@@ -167,8 +170,8 @@ class AttrRegistry {
   }
 
  private:
-  // mutex to avoid registration from multiple threads.
-  std::mutex mutex_;
+  // mutex to avoid registration from multiple threads, and lookups racing with it.
+  mutable std::mutex mutex_;
   // entries in the registry
   std::vector<std::unique_ptr<EntryType>> entries_;
   // map from name to entries.
@@ -33,8 +33,11 @@
 #include <tvm/runtime/registry.h>
 
 #include <cctype>
+#include <limits>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "../runtime/object_internal.h"
 #include "../support/base64.h"
@@ -500,7 +503,12 @@ struct JSONGraph {
     helper.ReadAllFields(reader);
   }
 
-  static JSONGraph Create(const ObjectRef& root) {
+  /*!
+   * \brief Create the graph of a node.
+   * \param root The root node.
+   * \param tensors When given, receives the tensors instead of b64ndarrays.
+   */
+  static JSONGraph Create(const ObjectRef& root, std::vector<DLTensor*>* tensors = nullptr) {
     JSONGraph g;
     NodeIndexer indexer;
     indexer.MakeIndex(const_cast<Object*>(root.get()));
@@ -515,6 +523,10 @@ struct JSONGraph {
     }
     g.attrs["tvm_version"] = TVM_VERSION;
     g.root = indexer.node_index_.at(const_cast<Object*>(root.get()));
+    if (tensors != nullptr) {
+      *tensors = indexer.tensor_list_;
+      return g;
+    }
     // serialize tensor
     for (DLTensor* tensor : indexer.tensor_list_) {
       std::string blob;
@@ -563,36 +575,140 @@ struct JSONGraph {
   }
 };
 
-std::string SaveJSON(const ObjectRef& n) {
-  auto jgraph = JSONGraph::Create(n);
-  std::ostringstream os;
-  dmlc::JSONWriter writer(&os);
-  jgraph.Save(&writer);
-  return os.str();
-}
+// The binary format of a graph is made of
+//   the magic number and a reserved word,
+//   the table of the interned strings,
+//   the root, the global attributes and the nodes, referring to the strings by index,
+//   the tensors, saved by SaveDLTensor.
+// Each node is written as its type key, its number of attributes, keys and data, its repr
+// bytes, then one array of the attribute key and value pairs, the keys and the data.
+class BinaryGraphWriter {
+ public:
+  explicit BinaryGraphWriter(dmlc::Stream* strm) : strm_(strm) {}
+
+  void Write(const JSONGraph& g, const std::vector<DLTensor*>& tensors) {
+    // intern all the strings first, the table is written ahead of its users
+    for (const auto& kv : g.attrs) {
+      Intern(kv.first);
+      Intern(kv.second);
+    }
+    for (const JSONNode& node : g.nodes) {
+      Intern(node.type_key);
+      for (const auto& kv : node.attrs) {
+        Intern(kv.first);
+        Intern(kv.second);
+      }
+      for (const std::string& key : node.keys) Intern(key);
+    }
+    uint64_t header = kTVMNodeBinaryMagic, reserved = 0;
+    strm_->Write(header);
+    strm_->Write(reserved);
+    strm_->Write(strings_);
+    strm_->Write(static_cast<uint64_t>(g.root));
+    WriteAttrs(g.attrs);
+    ICHECK_LE(g.nodes.size(), std::numeric_limits<uint32_t>::max()) << "Too many nodes";
+    strm_->Write(static_cast<uint64_t>(g.nodes.size()));
+    std::vector<uint32_t> words;
+    for (const JSONNode& node : g.nodes) {
+      uint32_t counts[] = {index_.at(node.type_key), static_cast<uint32_t>(node.attrs.size()),
+                           static_cast<uint32_t>(node.keys.size()),
+                           static_cast<uint32_t>(node.data.size())};
+      strm_->WriteArray(counts, 4);
+      strm_->Write(node.repr_bytes);
+      words.clear();
+      for (const auto& kv : node.attrs) {
+        words.push_back(index_.at(kv.first));
+        words.push_back(index_.at(kv.second));
+      }
+      for (const std::string& key : node.keys) words.push_back(index_.at(key));
+      for (size_t index : node.data) words.push_back(static_cast<uint32_t>(index));
+      strm_->WriteArray(words.data(), words.size());
+    }
+    strm_->Write(static_cast<uint64_t>(tensors.size()));
+    for (DLTensor* tensor : tensors) {
+      runtime::SaveDLTensor(strm_, tensor);
+    }
+  }
 
-ObjectRef LoadJSON(std::string json_str) {
-  ReflectionVTable* reflection = ReflectionVTable::Global();
-  JSONGraph jgraph;
-  {
-    // load in json graph.
-    std::istringstream is(json_str);
-    dmlc::JSONReader reader(&is);
-    jgraph.Load(&reader);
+ private:
+  void Intern(const std::string& str) {
+    if (index_.emplace(str, strings_.size()).second) strings_.push_back(str);
   }
-  size_t n_nodes = jgraph.nodes.size();
-  std::vector<runtime::NDArray> tensors;
-  {
-    // load in tensors
-    for (const std::string& blob : jgraph.b64ndarrays) {
-      dmlc::MemoryStringStream mstrm(const_cast<std::string*>(&blob));
-      support::Base64InStream b64strm(&mstrm);
-      b64strm.InitPosition();
-      runtime::NDArray temp;
-      ICHECK(temp.Load(&b64strm));
-      tensors.emplace_back(std::move(temp));
+
+  void WriteAttrs(const AttrMap& attrs) {
+    std::vector<uint32_t> words;
+    for (const auto& kv : attrs) {
+      words.push_back(index_.at(kv.first));
+      words.push_back(index_.at(kv.second));
     }
+    strm_->Write(words);
+  }
+
+  dmlc::Stream* strm_;
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, uint32_t> index_;
+};
+
+class BinaryGraphReader {
+ public:
+  explicit BinaryGraphReader(dmlc::Stream* strm) : strm_(strm) {}
+
+  // Read a graph, whose magic number was already read.
+  void Read(JSONGraph* g, std::vector<runtime::NDArray>* tensors) {
+    uint64_t reserved, root, num_nodes, num_tensors;
+    ICHECK(strm_->Read(&reserved)) << "Invalid binary node format";
+    ICHECK(strm_->Read(&strings_)) << "Invalid binary node format";
+    ICHECK(strm_->Read(&root)) << "Invalid binary node format";
+    g->root = root;
+    std::vector<uint32_t> words;
+    ICHECK(strm_->Read(&words) && words.size() % 2 == 0) << "Invalid binary node format";
+    for (size_t i = 0; i < words.size(); i += 2) {
+      g->attrs[GetString(words[i])] = GetString(words[i + 1]);
+    }
+    ICHECK(strm_->Read(&num_nodes)) << "Invalid binary node format";
+    g->nodes.resize(num_nodes);
+    for (JSONNode& node : g->nodes) {
+      uint32_t counts[4];
+      ICHECK(strm_->ReadArray(counts, 4)) << "Invalid binary node format";
+      node.type_key = GetString(counts[0]);
+      ICHECK(strm_->Read(&node.repr_bytes)) << "Invalid binary node format";
+      words.resize(2 * static_cast<size_t>(counts[1]) + counts[2] + counts[3]);
+      if (!words.empty()) {
+        ICHECK(strm_->ReadArray(words.data(), words.size())) << "Invalid binary node format";
+      }
+      const uint32_t* word = words.data();
+      for (uint32_t i = 0; i < counts[1]; ++i, word += 2) {
+        node.attrs[GetString(word[0])] = GetString(word[1]);
+      }
+      for (uint32_t i = 0; i < counts[2]; ++i) node.keys.push_back(GetString(*word++));
+      for (uint32_t i = 0; i < counts[3]; ++i) {
+        ICHECK_LT(*word, num_nodes) << "Invalid binary node format";
+        node.data.push_back(*word++);
+      }
+    }
+    ICHECK_LT(g->root, num_nodes) << "Invalid binary node format";
+    ICHECK(strm_->Read(&num_tensors)) << "Invalid binary node format";
+    tensors->resize(num_tensors);
+    for (runtime::NDArray& tensor : *tensors) {
+      ICHECK(tensor.Load(strm_)) << "Invalid binary node format";
+    }
+  }
+
+ private:
+  const std::string& GetString(uint32_t index) const {
+    ICHECK_LT(index, strings_.size()) << "Invalid binary node format";
+    return strings_[index];
   }
+
+  dmlc::Stream* strm_;
+  std::vector<std::string> strings_;
+};
+
+// Create the objects of a graph, given its tensors.
+ObjectRef LoadGraph(JSONGraph* graph, const std::vector<runtime::NDArray>& tensors) {
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  JSONGraph& jgraph = *graph;
+  size_t n_nodes = jgraph.nodes.size();
   // Pass 1: create all non-container objects
   std::vector<ObjectPtr<Object>> nodes(n_nodes, nullptr);
   for (size_t i = 0; i < n_nodes; ++i) {
@@ -622,7 +738,74 @@ ObjectRef LoadJSON(std::string json_str) {
   return ObjectRef(nodes.at(jgraph.root));
 }
 
+std::string SaveJSON(const ObjectRef& n) {
+  auto jgraph = JSONGraph::Create(n);
+  std::ostringstream os;
+  dmlc::JSONWriter writer(&os);
+  jgraph.Save(&writer);
+  return os.str();
+}
+
+ObjectRef LoadJSON(std::string json_str) {
+  {
+    // the binary format is accepted as well
+    dmlc::MemoryFixedSizeStream strm(const_cast<char*>(json_str.data()), json_str.size());
+    uint64_t header = 0;
+    if (strm.Read(&header) && header == kTVMNodeBinaryMagic) {
+      strm.Seek(0);
+      return LoadBinary(&strm);
+    }
+  }
+  JSONGraph jgraph;
+  {
+    // load in json graph.
+    std::istringstream is(json_str);
+    dmlc::JSONReader reader(&is);
+    jgraph.Load(&reader);
+  }
+  std::vector<runtime::NDArray> tensors;
+  {
+    // load in tensors
+    for (const std::string& blob : jgraph.b64ndarrays) {
+      dmlc::MemoryStringStream mstrm(const_cast<std::string*>(&blob));
+      support::Base64InStream b64strm(&mstrm);
+      b64strm.InitPosition();
+      runtime::NDArray temp;
+      ICHECK(temp.Load(&b64strm));
+      tensors.emplace_back(std::move(temp));
+    }
+  }
+  return LoadGraph(&jgraph, tensors);
+}
+
+void SaveBinary(dmlc::Stream* strm, const ObjectRef& n) {
+  std::vector<DLTensor*> tensors;
+  JSONGraph jgraph = JSONGraph::Create(n, &tensors);
+  BinaryGraphWriter(strm).Write(jgraph, tensors);
+}
+
+std::string SaveBinary(const ObjectRef& n) {
+  std::string bytes;
+  dmlc::MemoryStringStream strm(&bytes);
+  SaveBinary(&strm, n);
+  return bytes;
+}
+
+ObjectRef LoadBinary(dmlc::Stream* strm) {
+  uint64_t header;
+  ICHECK(strm->Read(&header) && header == kTVMNodeBinaryMagic) << "Invalid binary node format";
+  JSONGraph jgraph;
+  std::vector<runtime::NDArray> tensors;
+  BinaryGraphReader(strm).Read(&jgraph, &tensors);
+  return LoadGraph(&jgraph, tensors);
+}
+
 TVM_REGISTER_GLOBAL("node.SaveJSON").set_body_typed(SaveJSON);
 
 TVM_REGISTER_GLOBAL("node.LoadJSON").set_body_typed(LoadJSON);
+
+TVM_REGISTER_GLOBAL("node.SaveBinary").set_body([](TVMArgs args, TVMRetValue* rv) {
+  std::string bytes = SaveBinary(args[0].operator ObjectRef());
+  *rv = TVMByteArray{bytes.data(), bytes.size()};
+});
 }  // namespace tvm
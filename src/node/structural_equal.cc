@@ -24,9 +24,12 @@
 #include <tvm/node/node.h>
 #include <tvm/node/reflection.h>
 #include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/runtime/registry.h>
 
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace tvm {
 
@@ -50,10 +53,17 @@ bool ReflectionVTable::SEqualReduce(const Object* self, const Object* other,
  *
  *  The order of SEqual being called is the same as the order as if we
  *  eagerly do recursive calls in SEqualReduce.
+ *
+ *  While all the vars and graph nodes mapped so far are mapped to themselves, a subtree
+ *  shared by both sides is equal to itself and is skipped. Skipping it leaves out the
+ *  identity mappings of its vars and graph nodes, which are only added back, by comparing
+ *  the skipped subtrees, the first time they could change the result: when a var or a
+ *  graph node is mapped to another one, or when a Map looks up a mapping.
  */
 class RemapVarSEqualHandler : public SEqualReducer::Handler {
  public:
-  explicit RemapVarSEqualHandler(bool assert_mode) : assert_mode_(assert_mode) {}
+  explicit RemapVarSEqualHandler(bool assert_mode, bool skip_shared = true)
+      : assert_mode_(assert_mode), skip_shared_(skip_shared) {}
 
   bool SEqualReduce(const ObjectRef& lhs, const ObjectRef& rhs, bool map_free_vars) final {
     // We cannot use check lhs.same_as(rhs) to check equality.
@@ -82,6 +92,11 @@ class RemapVarSEqualHandler : public SEqualReducer::Handler {
         return it->second.same_as(rhs);
       }
       if (equal_map_rhs_.count(rhs)) return false;
+      // a shared subtree is equal to itself while the mapping is the identity
+      if (skip_shared_ && identity_map_ && lhs.same_as(rhs)) {
+        skipped_.emplace_back(lhs, map_free_vars);
+        return true;
+      }
       // need to push to pending tasks in this case
       pending_tasks_.emplace_back(Task(lhs, rhs, map_free_vars));
       return true;
@@ -98,6 +113,12 @@ class RemapVarSEqualHandler : public SEqualReducer::Handler {
   ObjectRef MapLhsToRhs(const ObjectRef& lhs) final {
     auto it = equal_map_lhs_.find(lhs);
     if (it != equal_map_lhs_.end()) return it->second;
+    if (!skipped_.empty()) {
+      // the mapping may be in a skipped subtree
+      this->MapSkipped();
+      it = equal_map_lhs_.find(lhs);
+      if (it != equal_map_lhs_.end()) return it->second;
+    }
     return ObjectRef(nullptr);
   }
 
@@ -108,7 +129,15 @@ class RemapVarSEqualHandler : public SEqualReducer::Handler {
     pending_tasks_.clear();
     equal_map_lhs_.clear();
     equal_map_rhs_.clear();
+    skipped_.clear();
+    identity_map_ = true;
+    // equal objects hash the same, which is cheap to rule out with cached subtree hashes.
+    if (!assert_mode_ && !map_free_vars && SHashCache::Current() != nullptr &&
+        !lhs.same_as(rhs) && StructuralHash()(lhs) != StructuralHash()(rhs)) {
+      return false;
+    }
     if (!SEqualReduce(lhs, rhs, map_free_vars)) return false;
+    if (pending_tasks_.empty()) return true;
     ICHECK_EQ(pending_tasks_.size(), 1U);
     ICHECK(allow_push_to_stack_);
     task_stack_.emplace_back(std::move(pending_tasks_.back()));
@@ -142,6 +171,16 @@ class RemapVarSEqualHandler : public SEqualReducer::Handler {
         // This means all the condition checks for
         // the current entry has been passed
         // We can safely mark lhs and rhs as equal to each other.
+        if (entry.graph_equal && !entry.lhs.same_as(entry.rhs) && identity_map_) {
+          // the first mapping to another node, the skipped subtrees may map either side.
+          identity_map_ = false;
+          if (!skipped_.empty()) {
+            this->MapSkipped();
+            if (equal_map_lhs_.count(entry.lhs) || equal_map_rhs_.count(entry.rhs)) {
+              return CheckResult(false, entry.lhs, entry.rhs);
+            }
+          }
+        }
         auto it = equal_map_lhs_.find(entry.lhs);
         if (it != equal_map_lhs_.end()) {
           ICHECK(it->second.same_as(entry.rhs));
@@ -189,6 +228,18 @@ class RemapVarSEqualHandler : public SEqualReducer::Handler {
     };
     return CheckResult(compute(), lhs, rhs);
   }
+  // Add the identity mappings of the vars and graph nodes of the skipped subtrees.
+  void MapSkipped() {
+    for (const auto& kv : skipped_) {
+      RemapVarSEqualHandler handler(false, false);
+      handler.Equal(kv.first, kv.first, kv.second);
+      for (const auto& mapped : handler.equal_map_lhs_) {
+        equal_map_lhs_.emplace(mapped.first, mapped.second);
+        equal_map_rhs_.emplace(mapped.second, mapped.first);
+      }
+    }
+    skipped_.clear();
+  }
 
  private:
   /*! \brief Pending reduce tasks. */
@@ -216,6 +267,12 @@ class RemapVarSEqualHandler : public SEqualReducer::Handler {
   bool allow_push_to_stack_{true};
   //  If in assert mode, must return true, and will throw error otherwise.
   bool assert_mode_{false};
+  // Whether to skip the subtrees shared by both sides.
+  bool skip_shared_{true};
+  // Whether every var and graph node mapped so far is mapped to itself.
+  bool identity_map_{true};
+  // The skipped subtrees whose mappings were not added yet, with their map_free_vars.
+  std::vector<std::pair<ObjectRef, bool>> skipped_;
   // reflection vtable
   ReflectionVTable* vtable_ = ReflectionVTable::Global();
   // map from lhs to rhs
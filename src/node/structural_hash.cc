@@ -28,7 +28,10 @@
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <memory>
+#include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "../support/str_escape.h"
 #include "../support/utils.h"
@@ -45,15 +48,153 @@ void ReflectionVTable::SHashReduce(const Object* self, SHashReducer reducer) con
   fshash_reduce_[tindex](self, reducer);
 }
 
+/*! \brief A cached subtree hash, with what is needed to reuse it. */
+struct SHashCacheEntry {
+  /*! \brief The hash of the subtree. */
+  size_t hash;
+  /*! \brief The number of nodes hashed to compute it. */
+  size_t num_nodes;
+  /*! \brief Whether the subtree mentions no variable and no graph node. */
+  bool independent;
+  /*! \brief Whether the hash looked up the hashes of other nodes, see LookupHashedValue. */
+  bool lookup_dep;
+  /*! \brief The mapping of the free variables, and the counters at the start of the subtree. */
+  bool map_free_vars;
+  size_t free_var_start;
+  size_t graph_node_start;
+  /*! \brief How much the subtree advances the counters. */
+  size_t free_var_delta;
+  size_t graph_node_delta;
+  /*! \brief The variables and the graph nodes of the subtree, and their hashes, in order. */
+  std::vector<ObjectRef> roots;
+  std::vector<size_t> root_hashes;
+};
+
+class SHashCache::Impl {
+ public:
+  explicit Impl(size_t max_entries) : max_entries_(max_entries) {}
+
+  std::shared_ptr<const SHashCacheEntry> Find(const ObjectRef& object, size_t free_var,
+                                              size_t graph_node, bool map_free_vars,
+                                              bool fresh) const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    auto it = table_.find(object);
+    if (it == table_.end()) return nullptr;
+    for (const auto& entry : it->second) {
+      if (entry->lookup_dep && !fresh) continue;
+      if (entry->independent ||
+          (entry->map_free_vars == map_free_vars && entry->free_var_start == free_var &&
+           entry->graph_node_start == graph_node)) {
+        return entry;
+      }
+    }
+    return nullptr;
+  }
+
+  void Insert(const ObjectRef& object, std::shared_ptr<const SHashCacheEntry> entry) {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+    if (num_entries_ >= max_entries_) {
+      table_.clear();
+      num_entries_ = 0;
+    }
+    auto& entries = table_[object];
+    // a node hashed at many positions only keeps its latest ones
+    if (entries.size() >= kMaxVariants) {
+      entries.erase(entries.begin());
+      --num_entries_;
+    }
+    entries.push_back(std::move(entry));
+    ++num_entries_;
+  }
+
+  void Clear() {
+    std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+    table_.clear();
+    num_entries_ = 0;
+  }
+
+  size_t size() const {
+    std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+    return num_entries_;
+  }
+
+ private:
+  static constexpr size_t kMaxVariants = 4;
+  size_t max_entries_;
+  size_t num_entries_{0};
+  mutable std::shared_timed_mutex mutex_;
+  std::unordered_map<ObjectRef, std::vector<std::shared_ptr<const SHashCacheEntry>>,
+                     ObjectPtrHash, ObjectPtrEqual>
+      table_;
+};
+
+SHashCache::SHashCache(size_t max_entries) : impl_(new Impl(max_entries)) {}
+
+SHashCache::~SHashCache() = default;
+
+void SHashCache::Clear() { impl_->Clear(); }
+
+size_t SHashCache::size() const { return impl_->size(); }
+
+namespace {
+thread_local SHashCache* current_shash_cache = nullptr;
+}  // namespace
+
+SHashCache* SHashCache::Current() { return current_shash_cache; }
+
+void SHashCacheContext::EnterWithScope() {
+  prev_ = current_shash_cache;
+  current_shash_cache = cache_;
+}
+
+void SHashCacheContext::ExitWithScope() {
+  ICHECK_EQ(current_shash_cache, cache_);
+  current_shash_cache = prev_;
+}
+
 // Hash handler that handles free vars
 // by assigning an unique counter in the order of their ocurrence.
 //
 // This algorithm depends on the determinism of the traversal of SHash function.
 // In particular, when we traverse unordered_map, we should first sort
 // the entries by keys(or hash of keys) before traversing.
-
+//
+// With a SHashCache, the handler also tracks what each hash depends on. The variables and
+// the graph nodes, whose hashes depend on the traversal order, are numbered as they are met,
+// and a hash records the smallest number it depends on. A subtree that only depends on the
+// numbers met inside it hashes the same whenever it starts at the same counters, and reusing
+// it replays the hashes of its variables and graph nodes.
 class VarCountingSHashHandler : public SHashReducer::Handler {
  public:
+  /*! \brief The dependency of a hash that depends on no variable and no graph node. */
+  static constexpr size_t kNoDep = std::numeric_limits<size_t>::max();
+  /*! \brief The smallest subtree worth caching, in number of nodes. */
+  static constexpr size_t kMinCachedNodes = 8;
+
+  /*! \brief A hash value, with what it depends on. */
+  struct Result {
+    /*! \brief The hash value. */
+    size_t hash{0};
+    /*! \brief The smallest variable or graph node number the value depends on. */
+    size_t dep{kNoDep};
+    /*! \brief The number of nodes hashed to compute it. */
+    size_t num_nodes{0};
+    /*! \brief Whether the value depends on the hashes looked up. */
+    bool lookup_dep{false};
+    /*! \brief Whether the value covers a node updated in place. */
+    bool uncacheable{false};
+
+    Result() = default;
+    explicit Result(size_t hash, size_t dep = kNoDep) : hash(hash), dep(dep) {}
+
+    void Merge(const Result& other) {
+      dep = std::min(dep, other.dep);
+      num_nodes += other.num_nodes;
+      lookup_dep |= other.lookup_dep;
+      uncacheable |= other.uncacheable;
+    }
+  };
+
   /*! \brief Pending reduce tasks. */
   struct Task {
     /*!
@@ -62,8 +203,8 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
      *  the correct value.
      */
     ObjectRef object;
-    /*! \brief The partially reduce hash value.*/
-    size_t reduced_hash;
+    /*! \brief The partially reduce hash value, and what it depends on.*/
+    Result result;
     /*! \brief The expected location in the result stack. */
     size_t result_stack_index = std::numeric_limits<size_t>::max();
     /*! \brief Whether the children has been expanded via SEqualReduce */
@@ -72,13 +213,20 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
     bool graph_node_hash{false};
     /*! \brief whether to map the free variables. */
     bool map_free_vars;
+    /*! \brief The number of roots and the counters when the children were expanded. */
+    size_t roots_start{0};
+    size_t free_var_start{0};
+    size_t graph_node_start{0};
+    /*! \brief Whether nothing was hashed yet when the children were expanded. */
+    bool fresh{false};
 
     Task() = default;
-    explicit Task(ObjectRef object, size_t reduced_hash, bool map_free_vars)
-        : object(object), reduced_hash(reduced_hash), map_free_vars(map_free_vars) {}
+    explicit Task(ObjectRef object, Result result, bool map_free_vars)
+        : object(object), result(result), map_free_vars(map_free_vars) {}
   };
 
-  VarCountingSHashHandler() {}
+  explicit VarCountingSHashHandler(SHashCache* cache = SHashCache::Current())
+      : cache_(cache != nullptr ? cache->impl_.get() : nullptr) {}
 
   void MarkGraphNode() final {
     // need to push to pending tasks in this case
@@ -87,28 +235,36 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
   }
 
   bool LookupHashedValue(const ObjectRef& key, size_t* hash_value) final {
+    // the hash of the node being expanded depends on what is found
+    Result* result = task_stack_.empty() ? nullptr : &task_stack_.back().result;
+    if (result != nullptr) result->lookup_dep = true;
     auto it = hash_memo_.find(key);
     if (it != hash_memo_.end()) {
-      hash_value[0] = it->second;
+      hash_value[0] = it->second.hash;
+      if (result != nullptr) result->Merge(it->second);
       return true;
     }
+    // the key may be in a reused subtree, whose nodes are not memoized
+    if (reused_subtree_) restart_ = true;
     return false;
   }
 
   void SHashReduceHashedValue(size_t hashed_value) final {
-    pending_tasks_.emplace_back(Task(ObjectRef(nullptr), hashed_value, false));
+    pending_tasks_.emplace_back(Task(ObjectRef(nullptr), Result(hashed_value), false));
   }
 
   void SHashReduceFreeVar(const runtime::Object* var, bool map_free_vars) final {
     ICHECK(!hash_memo_.count(GetRef<ObjectRef>(var)));
+    size_t dep = roots_.size();
+    roots_.push_back(GetRef<ObjectRef>(var));
     if (map_free_vars) {
       // use counter value.
       size_t value = std::hash<size_t>()(free_var_counter_++);
-      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), value, false));
+      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), Result(value, dep), false));
     } else {
       // use pointer hash
       size_t value = std::hash<const runtime::Object*>()(var);
-      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), value, false));
+      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), Result(value, dep), false));
     }
   }
 
@@ -117,7 +273,7 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
     // Note: it is still important to push the result to pendng tasks
     // so that the reduction order of hash values stays the same.
     if (!object.defined()) {
-      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), 0, false));
+      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), Result(0), false));
       return;
     }
     auto it = hash_memo_.find(object);
@@ -125,11 +281,28 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
       pending_tasks_.emplace_back(Task(ObjectRef(nullptr), it->second, false));
     } else {
       // Push a pending task with initial value.
-      pending_tasks_.emplace_back(Task(object, object->GetTypeKeyHash(), map_free_vars));
+      pending_tasks_.emplace_back(Task(object, Result(object->GetTypeKeyHash()), map_free_vars));
     }
   }
 
   size_t Hash(const ObjectRef& object, bool map_free_vars) {
+    size_t ret = HashOnce(object, map_free_vars);
+    if (restart_) {
+      // a lookup missed a node of a reused subtree, hash again without the cache.
+      cache_ = nullptr;
+      restart_ = false;
+      reused_subtree_ = false;
+      free_var_counter_ = 0;
+      graph_node_counter_ = 0;
+      hash_memo_.clear();
+      roots_.clear();
+      ret = HashOnce(object, map_free_vars);
+    }
+    return ret;
+  }
+
+ protected:
+  size_t HashOnce(const ObjectRef& object, bool map_free_vars) {
     ICHECK_EQ(task_stack_.size(), 0U);
     ICHECK_EQ(pending_tasks_.size(), 0U);
     ICHECK_EQ(result_stack_.size(), 0U);
@@ -143,35 +316,35 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
     this->RunTasks();
 
     ICHECK_EQ(result_stack_.size(), 1U);
-    size_t ret = result_stack_.back();
+    size_t ret = result_stack_.back().hash;
     result_stack_.pop_back();
     return ret;
   }
-
- protected:
   /*!
    * \brief Pop the top entry of the task stack and push the hash into the result stack.
    */
   void PopTaskStack() {
     const auto& entry = task_stack_.back();
-    result_stack_.push_back(entry.reduced_hash);
+    result_stack_.push_back(entry.result);
     task_stack_.pop_back();
   }
   /*!
    * \brief Compute the reduced hash value for the task.
    * \param task The indicated task.
    */
-  size_t ReduceHash(const Task& task) {
+  Result ReduceHash(const Task& task) {
     size_t stack_begin = task.result_stack_index;
     ICHECK_LE(stack_begin, result_stack_.size());
 
     // combine in the reverse order of the stack.
-    size_t reduced_hash = task.reduced_hash;
+    Result reduced = task.result;
     for (size_t i = result_stack_.size(); i != stack_begin; --i) {
-      reduced_hash = support::HashCombine(reduced_hash, result_stack_[i - 1]);
+      reduced.hash = support::HashCombine(reduced.hash, result_stack_[i - 1].hash);
+      reduced.Merge(result_stack_[i - 1]);
     }
+    reduced.num_nodes += 1;
     result_stack_.resize(stack_begin);
-    return reduced_hash;
+    return reduced;
   }
   // run the tasks.
   void RunTasks() {
@@ -180,21 +353,24 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
       auto& entry = task_stack_.back();
       if (entry.children_expanded) {
         // reduce hash
-        entry.reduced_hash = ReduceHash(entry);
+        entry.result = ReduceHash(entry);
         // When all the children has expanded and visited.
-        // entry.reduced_hash contains the reduced hash result.
+        // entry.result contains the reduced hash result.
         auto it = hash_memo_.find(entry.object);
         if (it != hash_memo_.end()) {
           // use the pre-computed hash for the object.
-          entry.reduced_hash = it->second;
+          entry.result = it->second;
         } else {
           // Append the graph node counter to the hash
           // so that we can distinguish DAG from trees.
           if (entry.graph_node_hash) {
-            entry.reduced_hash = support::HashCombine(entry.reduced_hash,
-                                                      std::hash<size_t>()(graph_node_counter_++));
+            entry.result.hash = support::HashCombine(entry.result.hash,
+                                                     std::hash<size_t>()(graph_node_counter_++));
+            entry.result.dep = std::min(entry.result.dep, roots_.size());
+            roots_.push_back(entry.object);
           }
-          hash_memo_[entry.object] = entry.reduced_hash;
+          hash_memo_[entry.object] = entry.result;
+          if (cache_ != nullptr) this->CacheSubtree(entry);
         }
         // send value to parent.
         this->PopTaskStack();
@@ -205,13 +381,22 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
         // check if there are already hash for object.
         auto it = hash_memo_.find(entry.object);
         if (it != hash_memo_.end()) {
-          entry.reduced_hash = it->second;
+          entry.result = it->second;
+          this->PopTaskStack();
+        } else if (cache_ != nullptr && this->ReuseSubtree(&entry)) {
           this->PopTaskStack();
         } else {
           // NOTE: important to modify entry before visit.
           // as entry becomes invalid after we change the stack.
           entry.children_expanded = true;
           entry.result_stack_index = result_stack_.size();
+          entry.roots_start = roots_.size();
+          entry.free_var_start = free_var_counter_;
+          entry.graph_node_start = graph_node_counter_;
+          entry.fresh = hash_memo_.empty();
+          if (cache_ != nullptr) {
+            entry.result.uncacheable = entry.object->type_index() == ModuleTypeIndex();
+          }
 
           ICHECK_EQ(pending_tasks_.size(), 0U);
           allow_push_to_stack_ = false;
@@ -235,6 +420,61 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
   }
 
  private:
+  // The type index of IRModule, which is updated in place.
+  static uint32_t ModuleTypeIndex() {
+    static uint32_t tindex = Object::TypeKey2Index("IRModule");
+    return tindex;
+  }
+  // Look up the hash of the task object in the cache, and replay its roots.
+  bool ReuseSubtree(Task* task) {
+    std::shared_ptr<const SHashCacheEntry> cached = cache_->Find(
+        task->object, free_var_counter_, graph_node_counter_, task->map_free_vars,
+        hash_memo_.empty());
+    if (cached == nullptr) return false;
+    // a root met before changes the hashes of the subtree
+    for (const ObjectRef& root : cached->roots) {
+      if (hash_memo_.count(root)) return false;
+    }
+    Result result(cached->hash, cached->roots.empty() ? kNoDep : roots_.size());
+    result.num_nodes = cached->num_nodes;
+    result.lookup_dep = cached->lookup_dep;
+    for (size_t i = 0; i < cached->roots.size(); ++i) {
+      hash_memo_[cached->roots[i]] = Result(cached->root_hashes[i], roots_.size());
+      roots_.push_back(cached->roots[i]);
+    }
+    free_var_counter_ += cached->free_var_delta;
+    graph_node_counter_ += cached->graph_node_delta;
+    hash_memo_[task->object] = result;
+    task->result = result;
+    reused_subtree_ = true;
+    return true;
+  }
+  // Cache the hash of a subtree that only depends on what it contains.
+  void CacheSubtree(const Task& task) {
+    const Result& result = task.result;
+    if (restart_ || result.uncacheable || result.num_nodes < kMinCachedNodes) return;
+    bool independent = result.dep == kNoDep;
+    if (!independent && result.dep < task.roots_start) return;
+    if (result.lookup_dep && !task.fresh) return;
+    auto cached = std::make_shared<SHashCacheEntry>();
+    cached->hash = result.hash;
+    cached->num_nodes = result.num_nodes;
+    cached->independent = independent;
+    cached->lookup_dep = result.lookup_dep;
+    cached->map_free_vars = task.map_free_vars;
+    cached->free_var_start = task.free_var_start;
+    cached->graph_node_start = task.graph_node_start;
+    cached->free_var_delta = free_var_counter_ - task.free_var_start;
+    cached->graph_node_delta = graph_node_counter_ - task.graph_node_start;
+    for (size_t i = task.roots_start; i < roots_.size(); ++i) {
+      auto it = hash_memo_.find(roots_[i]);
+      if (it == hash_memo_.end()) return;
+      cached->roots.push_back(roots_[i]);
+      cached->root_hashes.push_back(it->second.hash);
+    }
+    cache_->Insert(task.object, std::move(cached));
+  }
+
   // free var counter.
   size_t free_var_counter_{0};
   // graph node counter.
@@ -246,11 +486,19 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
   // Internal task stack to executed the task
   std::vector<Task> task_stack_;
   // Internal stack to store the result poped from the task stack.
-  std::vector<size_t> result_stack_;
+  std::vector<Result> result_stack_;
   // reflection vtable
   ReflectionVTable* vtable_ = ReflectionVTable::Global();
   // map from lhs to rhs
-  std::unordered_map<ObjectRef, size_t, ObjectPtrHash, ObjectPtrEqual> hash_memo_;
+  std::unordered_map<ObjectRef, Result, ObjectPtrHash, ObjectPtrEqual> hash_memo_;
+  // The variables and the graph nodes met so far, numbered in order.
+  std::vector<ObjectRef> roots_;
+  // The subtree cache, nullptr when not used.
+  SHashCache::Impl* cache_;
+  // Whether a subtree was reused, leaving its inner nodes out of hash_memo_.
+  bool reused_subtree_{false};
+  // Whether the hash must be computed again without the cache.
+  bool restart_{false};
 };
 
 TVM_REGISTER_GLOBAL("node.StructuralHash")
@@ -392,7 +392,7 @@ class Parser {
    */
   void Consume(const TokenType& token_type) {
     if (tokens[pos]->token_type != token_type) {
-      this->diag_ctx.EmitFatal(Diagnostic::Error(tokens[pos]->span)
+      this->diag_ctx.EmitFatal(Diagnostic::Error(tokens[pos]->span())
                                << "expected a " << Pretty(token_type) << " found "
                                << Pretty(Peek()->token_type));
     }
@@ -485,7 +485,7 @@ class Parser {
   Var LookupLocal(const Token& local) {
     auto var = this->expr_scopes.Lookup(local.ToString());
     if (!var.defined()) {
-      diag_ctx.Emit(Diagnostic::Error(local->span)
+      diag_ctx.Emit(Diagnostic::Error(local->span())
                     << "this local variable has not been previously declared");
     }
     return var;
@@ -593,7 +593,7 @@ class Parser {
 
   template <typename R>
   R WithSpan(std::function<R()> parser) {
-    auto start_span = Peek()->span;
+    auto start_span = Peek()->span();
     VLOG(9) << "WithSpan: start_span = " << start_span;
     R ast = parser();
     if (ast.defined()) {
@@ -608,8 +608,8 @@ class Parser {
         span_pos--;
       }
       auto end_token = tokens.at(span_pos);
-      VLOG(9) << "WithSpan: end_span = " << end_token->span;
-      ast->span = start_span.Merge(end_token->span);
+      VLOG(9) << "WithSpan: end_span = " << end_token->span();
+      ast->span = start_span.Merge(end_token->span());
     }
     return ast;
   }
@@ -715,7 +715,7 @@ class Parser {
         return elements;
       } else {
         auto next = Peek();
-        this->diag_ctx.EmitFatal(Diagnostic::Error(next->span)
+        this->diag_ctx.EmitFatal(Diagnostic::Error(next->span())
                                  << "expected a " << Pretty(stop) << " found  "
                                  << Pretty(next->token_type));
         return Array<T>(nullptr);
@@ -751,15 +751,15 @@ class Parser {
       auto version = Match(TokenType::kVersion);
       // TODO(@jroesch): we currently only support 0.0.5.
       if (version.ToString() != "\"0.0.5\"") {
-        this->diag_ctx.Emit(Diagnostic::Error(version->span)
+        this->diag_ctx.Emit(Diagnostic::Error(version->span())
                             << "invalid semantic version `" << version.ToString() << "`");
       }
     } else if (required) {
-      this->diag_ctx.Emit(Diagnostic::Error(Peek()->span)
+      this->diag_ctx.Emit(Diagnostic::Error(Peek()->span())
                           << "expected text format semantic version, found a  "
                           << PrettyPrint(Peek()));
 
-      this->diag_ctx.Emit(Diagnostic::Help(Peek()->span)
+      this->diag_ctx.Emit(Diagnostic::Help(Peek()->span())
                           << "you can annotate it as #[version = \"0.0.5\"]");
     }
     return SemVer(0, 0, 5);
@@ -790,7 +790,7 @@ class Parser {
           Consume(TokenType::kExtern);
           auto type_def = ParseTypeDef();
           if (type_def->constructors.size()) {
-            diag_ctx.Emit(Diagnostic::Error(next->span)
+            diag_ctx.Emit(Diagnostic::Error(next->span())
                           << "an external type may not have any constructors");
           }
           defs.types.push_back(type_def);
@@ -849,7 +849,7 @@ class Parser {
             try {
               this->ctors.Add(ctor_name, ctor);
             } catch (const DuplicateKeyError& e) {
-              this->diag_ctx.EmitFatal(Diagnostic::Error(ctor_tok->span)
+              this->diag_ctx.EmitFatal(Diagnostic::Error(ctor_tok->span())
                                        << "a constructor with the name "
                                        << "`" << ctor_name << "` "
                                        << "was previously defined");
@@ -1024,7 +1024,7 @@ class Parser {
         Match(TokenType::kSemicolon);
         AddGraphBinding(next, val);
       } else if (next->token_type == TokenType::kLet) {
-        auto span = next->span;
+        auto span = next->span();
         // Parse the 'let'.
         Consume(TokenType::kLet);
 
@@ -1209,7 +1209,7 @@ class Parser {
           diag_ctx.EmitFatal(
               // TODO(@jroesch): split into error and help
               // deal with multiple rendering
-              Diagnostic::Error(id->span)
+              Diagnostic::Error(id->span())
               << "undefined constructor name `" << id.ToString()
               << "`, perhaps you intended to write a"
               << "pattern variable, considering changing this to `%" << id.ToString() << "`");
@@ -1521,7 +1521,7 @@ class Parser {
         case TokenType::kFloat: {
           Consume(next->token_type);
           auto number = NumberToNDArray(next);
-          Expr e = Constant(number, next->span);
+          Expr e = Constant(number, next->span());
           ICHECK(e->span.defined()) << "constant spans must be defined";
           return e;
         }
@@ -1529,7 +1529,7 @@ class Parser {
           Consume(TokenType::kBoolean);
           int64_t value = Downcast<tvm::Integer>(next->data);
           auto boolean = BooleanToNDarray(value);
-          Expr e = Constant(boolean, next->span);
+          Expr e = Constant(boolean, next->span());
           ICHECK(e->span.defined()) << "constant spans must be defined";
           return e;
         }
@@ -1604,7 +1604,7 @@ class Parser {
           });
         }
         case TokenType::kOpenParen: {
-          Span sp = next->span;
+          Span sp = next->span();
           Consume(TokenType::kOpenParen);
           // parse '(' ')'
           if (WhenMatch(TokenType::kCloseParen)) {
@@ -1624,7 +1624,7 @@ class Parser {
                   auto element = ParseExpr();
                   auto comma = Peek();
                   if (WhenMatch(TokenType::kComma)) {
-                    sp = sp.Merge(element->span.Merge(comma->span));
+                    sp = sp.Merge(element->span.Merge(comma->span()));
                   } else {
                     sp = sp.Merge(element->span);
                   }
@@ -1638,7 +1638,7 @@ class Parser {
           }
         }
         default: {
-          this->diag_ctx.EmitFatal(Diagnostic::Error(next->span)
+          this->diag_ctx.EmitFatal(Diagnostic::Error(next->span())
                                    << "expected an expression found  " << Pretty(next->token_type));
           return Expr();
         }
@@ -1648,7 +1648,7 @@ class Parser {
     if (WhenMatch(TokenType::kPeriod)) {
       auto token = Match(TokenType::kInteger);
       auto index = token.ToNumber();
-      auto span = token->span.Merge(expr->span);
+      auto span = token->span().Merge(expr->span);
       VLOG(9) << "Parser::ParseAtomicExpr: tuple get item";
       return relay::TupleGetItem(expr, index, span);
     } else {
@@ -1674,9 +1674,9 @@ class Parser {
       auto token = Peek();
 
       if (span.defined()) {
-        span = span.Merge(token->span);
+        span = span.Merge(token->span());
       } else {
-        span = token->span;
+        span = token->span();
       }
 
       auto name = token.ToString();
@@ -1753,7 +1753,7 @@ class Parser {
       }
 
       if (!head_type.defined()) {
-        diag_ctx.EmitFatal(Diagnostic::Error(tok->span)
+        diag_ctx.EmitFatal(Diagnostic::Error(tok->span())
                            << "the type constructor `" << name << "` is undefined");
       }
 
@@ -1815,7 +1815,7 @@ class Parser {
       } else if (WhenMatch(TokenType::kUnderscore)) {
         return IncompleteType();
       } else {
-        this->diag_ctx.EmitFatal(Diagnostic::Error(tok->span)
+        this->diag_ctx.EmitFatal(Diagnostic::Error(tok->span())
                                  << "failed to parse type found " << tok);
         return Type();
       }
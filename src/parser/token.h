@@ -347,10 +347,25 @@ class Token;
 
 class TokenNode : public Object {
  public:
-  Span span;
+  /*!
+   * \brief The position of the token, from which its span is built on demand, as most tokens
+   *  never need one.
+   */
+  SourceName source_name;
+  int line;
+  int column;
+  int end_line;
+  int end_column;
+  /*! \brief Whether the token has a span, Token::Null and the metadata table may not. */
+  bool has_span;
   TokenType token_type;
   mutable runtime::ObjectRef data;
 
+  /*! \return The span of the token. */
+  Span span() const {
+    return has_span ? Span(source_name, line, end_line, column, end_column) : Span();
+  }
+
   void VisitAttrs(AttrVisitor* v) {}
 
   static constexpr const char* _type_key = "parser.Token";
@@ -360,7 +375,7 @@ class TokenNode : public Object {
 TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
     .set_dispatch<TokenNode>([](const ObjectRef& ref, ReprPrinter* p) {
       auto* node = static_cast<const TokenNode*>(ref.get());
-      p->stream << "Token(span=" << node->span << ", token_type=" << ToString(node->token_type)
+      p->stream << "Token(span=" << node->span() << ", token_type=" << ToString(node->token_type)
                 << ", data=" << node->data << ")";
     });
 
@@ -369,6 +384,25 @@ TVM_REGISTER_NODE_TYPE(TokenNode);
 class Token : public ObjectRef {
  public:
   TVM_DLL explicit Token(Span span, TokenType token_type, ObjectRef data = ObjectRef());
+  /*!
+   * \brief Create a token from its position, without building its span.
+   * \param source_name The source of the token.
+   * \param line The line of the start of the token.
+   * \param column The column of the start of the token.
+   * \param end_line The line of the end of the token.
+   * \param end_column The column of the end of the token.
+   * \param token_type The type of the token.
+   * \param data The data of the token.
+   */
+  TVM_DLL Token(SourceName source_name, int line, int column, int end_line, int end_column,
+                TokenType token_type, ObjectRef data = ObjectRef());
+  /*!
+   * \brief Create a token at the position of this one.
+   * \param token_type The type of the new token.
+   * \param data The data of the new token.
+   * \return The new token.
+   */
+  Token WithType(TokenType token_type, ObjectRef data = ObjectRef()) const;
 
   static Token Null();
   int64_t ToNumber() const;
@@ -379,13 +413,44 @@ class Token : public ObjectRef {
 
 Token::Token(Span span, TokenType token_type, ObjectRef data) {
   ObjectPtr<TokenNode> n = make_object<TokenNode>();
-  n->span = span;
+  n->has_span = span.defined();
+  if (n->has_span) {
+    n->source_name = span->source_name;
+    n->line = span->line;
+    n->column = span->column;
+    n->end_line = span->end_line;
+    n->end_column = span->end_column;
+  } else {
+    n->line = n->column = n->end_line = n->end_column = 0;
+  }
   n->token_type = token_type;
   n->data = data;
   data_ = std::move(n);
 }
 
-Token Token::Null() { return Token(Span(SourceName(), 0, 0, 0, 0), TokenType::kNull); }
+Token::Token(SourceName source_name, int line, int column, int end_line, int end_column,
+             TokenType token_type, ObjectRef data) {
+  ObjectPtr<TokenNode> n = make_object<TokenNode>();
+  n->source_name = std::move(source_name);
+  n->line = line;
+  n->column = column;
+  n->end_line = end_line;
+  n->end_column = end_column;
+  n->has_span = true;
+  n->token_type = token_type;
+  n->data = std::move(data);
+  data_ = std::move(n);
+}
+
+Token Token::WithType(TokenType token_type, ObjectRef data) const {
+  const TokenNode* self = this->operator->();
+  ObjectPtr<TokenNode> n = make_object<TokenNode>(*self);
+  n->token_type = token_type;
+  n->data = std::move(data);
+  return Token(n);
+}
+
+Token Token::Null() { return Token(SourceName(), 0, 0, 0, 0, TokenType::kNull); }
 
 int64_t Token::ToNumber() const { return Downcast<tvm::Integer>(this->operator->()->data); }
 
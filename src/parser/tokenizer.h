@@ -107,9 +107,8 @@ struct Tokenizer {
   }
 
   Token NewToken(TokenType token_type, ObjectRef data = ObjectRef(), int lines = 0, int cols = 1) {
-    auto span =
-        Span(this->source_name, this->line, this->line + lines, this->col, this->col + cols);
-    return Token(span, token_type, data);
+    return Token(this->source_name, this->line, this->col, this->line + lines, this->col + cols,
+                 token_type, data);
   }
 
   Span SpanFrom(int line, int column) {
@@ -118,6 +117,16 @@ struct Tokenizer {
     return Span(this->source_name, line, end_line, column, end_column);
   }
 
+  /*! \brief Create a token from a position to the current one. */
+  Token TokenFrom(int line, int column, TokenType token_type, ObjectRef data = ObjectRef()) {
+    return Token(this->source_name, line, column, this->line, this->col, token_type, data);
+  }
+
+  /*! \brief The source text from a position to the current one. */
+  std::string TextFrom(size_t start) const {
+    return std::string(this->source.data() + start, this->pos - start);
+  }
+
   enum CommentParserState {
     Proceed,
     Forward,
@@ -181,9 +190,11 @@ struct Tokenizer {
       try {
         value = std::stoll(number, &index);
       } catch (const std::invalid_argument& err) {
-        this->diag_ctx.Emit(Diagnostic::Error(token->span) << "invalid number `" << number << "`");
+        this->diag_ctx.Emit(Diagnostic::Error(token->span())
+                            << "invalid number `" << number << "`");
       } catch (const std::out_of_range& err) {
-        this->diag_ctx.Emit(Diagnostic::Error(token->span) << "invalid number `" << number << "`");
+        this->diag_ctx.Emit(Diagnostic::Error(token->span())
+                            << "invalid number `" << number << "`");
       }
       if (number.size() <= index) {
         value = is_pos ? value : -value;
@@ -209,10 +220,10 @@ struct Tokenizer {
       try {
         width = std::stoi(suffix);
       } catch (const std::invalid_argument& err) {
-        this->diag_ctx.Emit(Diagnostic::Error(token->span)
+        this->diag_ctx.Emit(Diagnostic::Error(token->span())
                             << "invalid numeric suffix `" << suffix << "`");
       } catch (const std::out_of_range& err) {
-        this->diag_ctx.Emit(Diagnostic::Error(token->span)
+        this->diag_ctx.Emit(Diagnostic::Error(token->span())
                             << "invalid numeric suffix `" << suffix << "`");
       }
     }
@@ -224,30 +235,34 @@ struct Tokenizer {
   }
 
   Token ParseNumber(bool is_pos) {
-    std::stringstream ss;
+    size_t start = this->pos;
     while (More() && IsNumeric(Peek())) {
-      ss << Next();
+      Next();
     }
 
     bool is_float = false;
 
     // Remove trailing floating point prefix.
     if (More() && Peek() == 'f') {
-      ss << Next();
+      Next();
       while (More() && IsNumeric(Peek())) {
-        ss << Next();
+        Next();
       }
       is_float = true;
     }
-    return ParseNumber(is_pos, is_float, ss.str());
+    return ParseNumber(is_pos, is_float, TextFrom(start));
   }
 
   bool MatchString(const std::string& string) {
-    int start = this->pos;
+    size_t start = this->pos;
+    int line = this->line;
+    int col = this->col;
 
     for (auto c : string) {
-      if (Peek() != c) {
+      if (!More() || Peek() != c) {
         this->pos = start;
+        this->line = line;
+        this->col = col;
         return false;
       } else {
         Next();
@@ -263,25 +278,26 @@ struct Tokenizer {
 
     ICHECK_EQ(Peek(), '[');
     Next();
-    std::stringstream type_key;
+    size_t type_key = this->pos;
     while (More() && Peek() != ']') {
-      type_key << Next();
+      Next();
     }
+    std::string type_key_str = TextFrom(type_key);
     ICHECK_EQ(Peek(), ']');
     Next();
 
     ICHECK_EQ(Peek(), '[');
     Next();
-    std::stringstream str_index;
+    size_t str_index = this->pos;
     while (More() && Peek() != ']') {
-      str_index << Next();
+      Next();
     }
+    std::string str_index_str = TextFrom(str_index);
     ICHECK_EQ(Peek(), ']');
     Next();
     // todo: add error handling around bad indices
-    auto index = ParseNumber(true, false, str_index.str()).ToNumber();
-    auto span = SpanFrom(line, column);
-    return Token(span, TokenType::kMetaReference, MetaRef(type_key.str(), index));
+    auto index = ParseNumber(true, false, str_index_str).ToNumber();
+    return TokenFrom(line, column, TokenType::kMetaReference, MetaRef(type_key_str, index));
   }
 
   Token TokenizeAttr() {
@@ -305,20 +321,27 @@ struct Tokenizer {
 
       // Metadata can only appear at the bottom of a file and goes to EOF.
       if (attribute == "metadata") {
-        std::stringstream metadata;
-        while (More()) {
-          metadata << Next();
+        // the metadata holds the constants and can be most of the text, so it is skipped at once
+        const char* begin = this->source.data() + this->pos;
+        const char* end = this->source.data() + this->source.size();
+        const char* last_newline = begin;
+        for (const char* it = begin; it != end; ++it) {
+          if (*it == '\n') {
+            this->line += 1;
+            last_newline = it + 1;
+          }
         }
-        ObjectRef metadata_map = tvm::LoadJSON(metadata.str());
-        auto span = SpanFrom(line, column);
-        return Token(span, TokenType::kMetadata, metadata_map);
+        this->col = last_newline == begin ? this->col + static_cast<int>(end - begin)
+                                          : static_cast<int>(end - last_newline) + 1;
+        this->pos = this->source.size();
+        ObjectRef metadata_map = tvm::LoadJSON(std::string(begin, end));
+        return TokenFrom(line, column, TokenType::kMetadata, metadata_map);
       }
       if (attribute.rfind("version", 0) == 0) {
         std::string version = attribute.substr(attribute.find("=") + 1);
         ltrim(version);
         rtrim(version);
-        auto span = SpanFrom(line, column);
-        return Token(span, TokenType::kVersion, tvm::String(version));
+        return TokenFrom(line, column, TokenType::kVersion, tvm::String(version));
       } else {
         // TOOD(@jroesch): maybe make this a warning an continue parsing?
         auto span = SpanFrom(line, column);
@@ -340,10 +363,12 @@ struct Tokenizer {
     int col = this->col;
     auto next = Peek();
     VLOG(9) << "tvm::parser::TokenizeOnce: next=" << next;
-    if (next == '\n') {
-      auto token = NewToken(TokenType::kNewline);
-      Next();
-      return token;
+    if (IsWhitespace(next)) {
+      // the parser skips whitespace, so a whole run of it makes a single token
+      while (More() && IsWhitespace(Peek())) {
+        Next();
+      }
+      return TokenFrom(line, col, TokenType::kWhitespace);
     } else if (next == '\r') {
       Next();
       if (More() && Peek() == '\n') {
@@ -360,16 +385,13 @@ struct Tokenizer {
       // TODO(@jroesch): Properly tokenize escape sequences in strings.
       // see https://github.com/apache/tvm/issues/6153.
       Next();
-      std::stringstream string_content;
+      size_t start = this->pos;
       while (More() && Peek() != '"') {
-        string_content << Next();
+        Next();
       }
+      std::string string_content = TextFrom(start);
       Next();
-      return NewToken(TokenType::kStringLiteral, tvm::String(string_content.str()));
-    } else if (IsWhitespace(next)) {
-      auto token = NewToken(TokenType::kWhitespace);
-      Next();
-      return token;
+      return NewToken(TokenType::kStringLiteral, tvm::String(string_content));
     } else if (next == '-') {
       int negs = 0;
       while (More() && Peek() == '-') {
@@ -386,6 +408,7 @@ struct Tokenizer {
         // this is really slow for lexing, should replace
         // with multi-token return or something.
         pos = pos - (negs - 1);
+        col = col - (negs - 1);
         return NewToken(TokenType::kMinus);
       }
     } else if (IsDigit(next)) {
@@ -472,16 +495,15 @@ struct Tokenizer {
       auto token = NewToken(TokenType::kPercent);
       Next();
 
-      std::stringstream number;
+      size_t start = this->pos;
       while (More() && IsDigit(Peek())) {
-        number << Next();
+        Next();
       }
 
-      auto number_str = number.str();
+      auto number_str = TextFrom(start);
       if (number_str.size()) {
         auto num_tok = ParseNumber(true, false, number_str);
-        auto span = SpanFrom(token->span->line, token->span->column);
-        token = Token(span, TokenType::kGraph, num_tok->data);
+        token = TokenFrom(token->line, token->column, TokenType::kGraph, num_tok->data);
       }
 
       return token;
@@ -491,11 +513,11 @@ struct Tokenizer {
         auto token = NewToken(TokenType::kLineComment);
         // Consume the /
         Next();
-        std::stringstream comment;
+        size_t start = this->pos;
         while (More() && Peek() != '\n') {
-          comment << Next();
+          Next();
         }
-        token->data = tvm::String(comment.str());
+        token->data = tvm::String(TextFrom(start));
         return token;
       } else if (Peek() == '*') {
         // Eat the first /* pair before entering the state machine.
@@ -508,18 +530,18 @@ struct Tokenizer {
         return NewToken(TokenType::kDivision);
       }
     } else if (IsIdentLetter(next)) {
-      std::stringstream ss;
       // Due the below code we need to patch
       // the line/col info to the start of
       // token.
       int line = this->line;
       int col = this->col;
+      size_t start = this->pos;
 
       while (More() && IsIdent(Peek())) {
-        ss << Next();
+        Next();
       }
 
-      std::string keyword = ss.str();
+      std::string keyword = TextFrom(start);
       auto it = KEYWORD_TABLE.find(keyword);
 
       TokenType token_type;
@@ -536,15 +558,14 @@ struct Tokenizer {
         token_type = TokenType::kIdentifier;
       }
 
-      auto span = SpanFrom(line, col);
-      return Token(span, token_type, tvm::String(ss.str()));
+      return TokenFrom(line, col, token_type, tvm::String(keyword));
     } else {
-      std::stringstream ss;
+      auto token = NewToken(TokenType::kUnknown);
+      size_t start = this->pos;
       while (More() && !IsWhitespace(Peek())) {
-        ss << Next();
+        Next();
       }
-      auto token = NewToken(TokenType::kUnknown);
-      token->data = tvm::String(ss.str());
+      token->data = tvm::String(TextFrom(start));
       return token;
     }
   }
@@ -591,12 +612,12 @@ std::vector<Token> Condense(const std::vector<Token>& tokens, Token* table) {
           // Match this token.
           i += 1;
           // TODO(@jroesch): merge spans
-          auto tok = Token(current->span, TokenType::kLocal, next->data);
+          auto tok = current.WithType(TokenType::kLocal, next->data);
           ICHECK(tok.defined());
           out.push_back(tok);
         } else if (next->token_type == TokenType::kInteger) {
           i += 1;
-          auto tok = Token(current->span, TokenType::kGraph, next->data);
+          auto tok = current.WithType(TokenType::kGraph, next->data);
           ICHECK(tok.defined());
           out.push_back(tok);
         } else {
@@ -611,7 +632,7 @@ std::vector<Token> Condense(const std::vector<Token>& tokens, Token* table) {
           // Match this token.
           i += 1;
           // TODO(@jroesch): merge spans
-          auto tok = Token(current->span, TokenType::kGlobal, next->data);
+          auto tok = current.WithType(TokenType::kGlobal, next->data);
           ICHECK(tok.defined());
           out.push_back(tok);
         } else {
@@ -626,12 +647,12 @@ std::vector<Token> Condense(const std::vector<Token>& tokens, Token* table) {
         // TODO(@jroesch): merge spans
         if (str == "True") {
           auto data = tvm::Integer(1);
-          tok = Token(current->span, TokenType::kBoolean, data);
+          tok = current.WithType(TokenType::kBoolean, data);
         } else if (str == "False") {
           auto data = tvm::Integer(0);
-          tok = Token(current->span, TokenType::kBoolean, data);
+          tok = current.WithType(TokenType::kBoolean, data);
         } else if (str == "_") {
-          tok = Token(current->span, TokenType::kUnderscore);
+          tok = current.WithType(TokenType::kUnderscore);
         } else {
           tok = current;
         }
@@ -28,6 +28,7 @@
 #include <tvm/runtime/packed_func.h>
 
 #include <sstream>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -83,10 +84,45 @@ class DocLine : public DocAtom {
   TVM_DEFINE_OBJECT_REF_METHODS(DocLine, DocAtom, DocLineNode);
 };
 
+/*!
+ * \brief Represent a doc stream shared by the docs it is part of.
+ */
+class DocFragmentNode : public DocAtomNode {
+ public:
+  /*! \brief The atoms of the fragment. */
+  std::vector<DocAtom> stream;
+  /*! \brief The indent added to the new lines of the fragment. */
+  int indent;
+
+  DocFragmentNode(std::vector<DocAtom> stream, int indent)
+      : stream(std::move(stream)), indent(indent) {}
+
+  static constexpr const char* _type_key = "printer.DocFragment";
+  TVM_DECLARE_FINAL_OBJECT_INFO(DocFragmentNode, DocAtomNode);
+};
+
+TVM_REGISTER_OBJECT_TYPE(DocFragmentNode);
+
+// Docs of at most this number of atoms are copied rather than shared when appended.
+constexpr size_t kMaxCopiedAtoms = 4;
+
+DocAtom Doc::AsFragment() const {
+  // the stream only grows, so the fragment is current while it holds as many atoms
+  auto* fragment = fragment_.as<DocFragmentNode>();
+  if (fragment == nullptr || fragment->stream.size() != stream_.size()) {
+    fragment_ = DocAtom(runtime::make_object<DocFragmentNode>(stream_, 0));
+  }
+  return fragment_;
+}
+
 // DSL function implementations
 Doc& Doc::operator<<(const Doc& right) {
   ICHECK(this != &right);
-  this->stream_.insert(this->stream_.end(), right.stream_.begin(), right.stream_.end());
+  if (right.stream_.size() <= kMaxCopiedAtoms) {
+    this->stream_.insert(this->stream_.end(), right.stream_.begin(), right.stream_.end());
+  } else {
+    this->stream_.push_back(right.AsFragment());
+  }
   return *this;
 }
 
@@ -99,16 +135,37 @@ Doc& Doc::operator<<(const DocAtom& right) {
 
 std::string Doc::str() {
   std::ostringstream os;
-  for (auto atom : this->stream_) {
+  Write(os);
+  return os.str();
+}
+
+void Doc::Write(std::ostream& os) const {
+  // walk the fragments with an explicit stack, as docs can nest as deep as the IR
+  struct Frame {
+    const std::vector<DocAtom>* stream;
+    size_t index;
+    int indent;
+  };
+  std::vector<Frame> stack{{&stream_, 0, 0}};
+  while (!stack.empty()) {
+    Frame& frame = stack.back();
+    if (frame.index == frame.stream->size()) {
+      stack.pop_back();
+      continue;
+    }
+    const DocAtom& atom = (*frame.stream)[frame.index++];
     if (auto* text = atom.as<DocTextNode>()) {
       os << text->str;
     } else if (auto* line = atom.as<DocLineNode>()) {
-      os << "\n" << std::string(line->indent, ' ');
+      os << '\n';
+      for (int i = line->indent + frame.indent; i > 0; --i) os << ' ';
+    } else if (auto* fragment = atom.as<DocFragmentNode>()) {
+      int indent = frame.indent + fragment->indent;
+      stack.push_back({&fragment->stream, 0, indent});
     } else {
       LOG(FATAL) << "do not expect type " << atom->GetTypeKey();
     }
   }
-  return os.str();
 }
 
 Doc Doc::NewLine(int indent) { return Doc() << DocLine(indent); }
@@ -120,12 +177,7 @@ Doc Doc::RawText(std::string text) {
 }
 
 Doc Doc::Indent(int indent, Doc doc) {
-  for (size_t i = 0; i < doc.stream_.size(); ++i) {
-    if (auto* line = doc.stream_[i].as<DocLineNode>()) {
-      doc.stream_[i] = DocLine(indent + line->indent);
-    }
-  }
-  return doc;
+  return Doc() << DocAtom(runtime::make_object<DocFragmentNode>(std::move(doc.stream_), indent));
 }
 
 Doc Doc::StrLiteral(const std::string& value, std::string quote) {
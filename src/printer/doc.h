@@ -30,6 +30,7 @@
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/object.h>
 
+#include <ostream>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -63,6 +64,9 @@ class DocAtom : public ObjectRef {
  * The layout(code formating) decisions include:
  * - Change indentation.
  * - Break single line into multiple ones(subjected to future improvements).
+ *
+ * A doc appended to another one, or indented, is shared as an immutable fragment rather
+ * than copied, so building the doc of an IR is linear in the size of its text.
  */
 class Doc {
  public:
@@ -105,6 +109,11 @@ class Doc {
    * \return The string representation.
    */
   std::string str();
+  /*!
+   * \brief Write the doc stream to an output stream.
+   * \param os The output stream.
+   */
+  void Write(std::ostream& os) const;
   /*!
    * \brief Create a doc that represents text content.
    * \return The created doc.
@@ -159,8 +168,12 @@ class Doc {
   static Doc Concat(const std::vector<Doc>& vec, const Doc& sep = Text(", "));
 
  private:
+  /*! \return The doc as a single atom, sharing the stream with the docs it is appended to. */
+  DocAtom AsFragment() const;
   /*! \brief Internal doc stream. */
   std::vector<DocAtom> stream_;
+  /*! \brief The fragment holding a copy of the stream, made the first time it is needed. */
+  mutable DocAtom fragment_;
 };
 
 }  // namespace tvm
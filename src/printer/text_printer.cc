@@ -27,6 +27,7 @@
 
 #include <tvm/tir/function.h>
 
+#include <fstream>
 #include <string>
 
 namespace tvm {
@@ -88,8 +89,8 @@ String PrettyPrint(const ObjectRef& node) {
   return doc.str();
 }
 
-String AsText(const ObjectRef& node, bool show_meta_data,
-              runtime::TypedPackedFunc<String(ObjectRef)> annotate) {
+void AsText(const ObjectRef& node, std::ostream& os, bool show_meta_data,
+            runtime::TypedPackedFunc<String(ObjectRef)> annotate) {
   Doc doc;
   doc << "#[version = \"" << kSemVer << "\"]" << Doc::NewLine();
   runtime::TypedPackedFunc<std::string(ObjectRef)> ftyped = nullptr;
@@ -98,11 +99,30 @@ String AsText(const ObjectRef& node, bool show_meta_data,
         [&annotate](const ObjectRef& expr) -> std::string { return annotate(expr); });
   }
   doc << TextPrinter(show_meta_data, ftyped).PrintFinal(node);
-  return doc.str();
+  doc.Write(os);
+}
+
+String AsText(const ObjectRef& node, bool show_meta_data,
+              runtime::TypedPackedFunc<String(ObjectRef)> annotate) {
+  std::ostringstream os;
+  AsText(node, os, show_meta_data, annotate);
+  return os.str();
 }
 
 TVM_REGISTER_GLOBAL("ir.PrettyPrint").set_body_typed(PrettyPrint);
 
-TVM_REGISTER_GLOBAL("ir.AsText").set_body_typed(AsText);
+TVM_REGISTER_GLOBAL("ir.AsText")
+    .set_body_typed([](ObjectRef node, bool show_meta_data,
+                       runtime::TypedPackedFunc<String(ObjectRef)> annotate) {
+      return AsText(node, show_meta_data, annotate);
+    });
+
+TVM_REGISTER_GLOBAL("ir.SaveText")
+    .set_body_typed([](ObjectRef node, String path, bool show_meta_data) {
+      std::ofstream os(path.operator std::string());
+      ICHECK(os) << "SaveText: cannot open " << path;
+      AsText(node, os, show_meta_data);
+      ICHECK(os) << "SaveText: failed to write " << path;
+    });
 
 }  // namespace tvm
@@ -0,0 +1,292 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/analysis/cost_estimator.cc
+ * \brief Estimate the latency of the Relay calls and of the PrimFuncs on a target.
+ */
+#include "cost_estimator.h"
+
+#include <dmlc/thread_local.h>
+#include <tvm/driver/driver_api.h>
+#include <tvm/relay/attrs/annotation.h>
+#include <tvm/relay/function.h>
+#include <tvm/relay/transform.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "../../runtime/meta_data.h"
+#include "../backend/te_compiler_cache.h"
+
+namespace tvm {
+namespace relay {
+
+namespace {
+// The peaks assumed when none is given, of a mid range device of each kind.
+constexpr double kDefaultCPUClockHz = 2.5e9;
+constexpr double kDefaultCPUBandwidth = 20e9;
+constexpr double kDefaultGPUFlops = 10e12;
+constexpr double kDefaultGPUBandwidth = 500e9;
+
+// The float32 lanes of the vector unit of a CPU target.
+int CPUVectorLanes(const Target& target) {
+  std::string mcpu = target->GetAttr<String>("mcpu").value_or("");
+  Array<String> mattr = target->GetAttr<Array<String>>("mattr").value_or({});
+  auto has_attr = [&](const std::string& name) {
+    return std::any_of(mattr.begin(), mattr.end(), [&](const String& attr) {
+      return std::string(attr).find(name) != std::string::npos;
+    });
+  };
+  if (has_attr("avx512") || mcpu == "skylake-avx512" || mcpu == "cascadelake" ||
+      mcpu == "icelake-server") {
+    return 16;
+  }
+  if (has_attr("avx") || mcpu == "haswell" || mcpu == "skylake" || mcpu == "znver2" ||
+      mcpu == "znver3" || mcpu == "core-avx2") {
+    return 8;
+  }
+  return 4;
+}
+
+double DefaultPeakFlops(const Target& target) {
+  if (target->kind->device_type == kDLCPU) {
+    double num_cores = std::max(1U, std::thread::hardware_concurrency());
+    // one fused multiply add by vector lane and cycle
+    return 2.0 * CPUVectorLanes(target) * num_cores * kDefaultCPUClockHz;
+  }
+  return kDefaultGPUFlops;
+}
+
+double DefaultPeakBandwidth(const Target& target) {
+  return target->kind->device_type == kDLCPU ? kDefaultCPUBandwidth : kDefaultGPUBandwidth;
+}
+
+// The tuning workload of a PrimFunc given as is, named like the tuned functions.
+IRModule WorkloadOf(const tir::PrimFunc& func) {
+  String name = func->GetAttr<String>(tvm::attr::kGlobalSymbol).value_or("main");
+  return IRModule({{GlobalVar(name), func}});
+}
+
+// The primitive function of a call, made of the op alone for a call of an op.
+Function KernelOf(const Call& call) {
+  if (const auto* func = call->op.as<FunctionNode>()) {
+    return GetRef<Function>(func);
+  }
+  ICHECK(call->op.as<OpNode>())
+      << "CostEstimator: expect a call of an op or of a primitive function, but got "
+      << PrettyPrint(call->op);
+  Array<Var> params;
+  Array<Expr> args;
+  for (const Expr& arg : call->args) {
+    Var param("p" + std::to_string(params.size()), arg->checked_type());
+    params.push_back(param);
+    args.push_back(param);
+  }
+  Function func(params, Call(call->op, args, call->attrs, call->type_args),
+                call->checked_type(), {});
+  func = WithAttr(std::move(func), attr::kPrimitive, Integer(1));
+  IRModule mod = transform::InferType()(IRModule::FromExpr(func));
+  return Downcast<Function>(mod->Lookup("main"));
+}
+}  // namespace
+
+double CostEstimatorNode::Estimate(const tir::PrimFunc& func, const Target& target) {
+  std::string target_key = target->str();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EstimateCache& cache = cache_[target_key];
+    auto it = cache.find(func);
+    if (it != cache.end()) return it->second;
+  }
+  double latency = EstimateLowered(func, WorkloadOf(func), target);
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_[target_key][func] = latency;
+  return latency;
+}
+
+double CostEstimatorNode::Estimate(const Call& call, const Target& target) {
+  Function func = KernelOf(call);
+  std::string target_key = target->str();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EstimateCache& cache = cache_[target_key];
+    auto it = cache.find(func);
+    if (it != cache.end()) return it->second;
+  }
+  // lowered like the TE compiler does, for the kernel to match the tuned one
+  With<Target> target_scope(target);
+  tec::CachedFunc cfunc = tec::PrimFuncFor(func, target, [](std::string name) {
+    return runtime::get_name_mangled("default", name);
+  });
+  tir::PrimFunc lowered;
+  if (cfunc->prim_func.defined()) {
+    lowered = cfunc->prim_func.value();
+  } else {
+    ICHECK(cfunc->schedule.defined()) << "CostEstimator: no schedule for " << PrettyPrint(call);
+    Array<te::Tensor> all_args = cfunc->inputs;
+    for (const te::Tensor& arg : cfunc->outputs) {
+      all_args.push_back(arg);
+    }
+    std::unordered_map<te::Tensor, tir::Buffer> binds;
+    std::string name = cfunc->prim_fn_var->name_hint;
+    IRModule lowered_mod = LowerSchedule(cfunc->schedule, all_args, name, binds);
+    lowered = Downcast<tir::PrimFunc>(lowered_mod->Lookup(name));
+  }
+  Optional<IRModule> workload;
+  if (database.defined()) {
+    static const auto* f_create_func = runtime::Registry::Get("te.CreatePrimFuncFromOutputs");
+    ICHECK(f_create_func) << "te.CreatePrimFuncFromOutputs is not registered";
+    try {
+      tir::PrimFunc workload_func = (*f_create_func)(cfunc->outputs);
+      workload = IRModule({{cfunc->prim_fn_var, workload_func}});
+    } catch (const Error& e) {
+      // the extern ops have no tuning workload
+      VLOG(1) << "CostEstimator: no tuning workload for " << PrettyPrint(call) << ": "
+              << e.what();
+    }
+  }
+  double latency = EstimateLowered(lowered, workload, target);
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_[target_key][func] = latency;
+  return latency;
+}
+
+double CostEstimatorNode::EstimateRoofline(const tir::PrimFunc& func,
+                                           const Target& target) const {
+  double flops = peak_flops > 0 ? peak_flops : DefaultPeakFlops(target);
+  double bandwidth = peak_bandwidth > 0 ? peak_bandwidth : DefaultPeakBandwidth(target);
+  return std::max(tir::EstimateTIRFlops(func) / flops, tir::EstimateTIRBytes(func) / bandwidth);
+}
+
+double CostEstimatorNode::EstimateLowered(const tir::PrimFunc& func,
+                                          const Optional<IRModule>& workload,
+                                          const Target& target) {
+  if (database.defined() && workload.defined()) {
+    double latency = QueryDatabase(workload.value(), target);
+    if (latency >= 0) return latency;
+  }
+  if (learned_model != nullptr) {
+    double latency = learned_model(func, target);
+    if (latency >= 0) return latency;
+  }
+  return EstimateRoofline(func, target);
+}
+
+double CostEstimatorNode::QueryDatabase(const IRModule& workload, const Target& target) {
+  // the records of the other targets sharing the workload are skipped
+  constexpr int kTopK = 16;
+  Array<meta_schedule::TuningRecord> records;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records = database.value()->GetTopK(
+        meta_schedule::Workload(workload, StructuralHash()(workload)), kTopK);
+  }
+  for (const meta_schedule::TuningRecord& record : records) {
+    if (record->target->kind->name != target->kind->name || record->run_secs.empty()) {
+      continue;
+    }
+    double total = 0;
+    for (const FloatImm& secs : record->run_secs) {
+      total += secs->value;
+    }
+    return total / record->run_secs.size();
+  }
+  return -1;
+}
+
+CostEstimator::CostEstimator(double peak_flops, double peak_bandwidth,
+                             Optional<meta_schedule::Database> database,
+                             runtime::PackedFunc learned_model) {
+  ObjectPtr<CostEstimatorNode> n = make_object<CostEstimatorNode>();
+  n->peak_flops = peak_flops;
+  n->peak_bandwidth = peak_bandwidth;
+  n->database = std::move(database);
+  n->learned_model = std::move(learned_model);
+  data_ = std::move(n);
+}
+
+struct CostEstimatorThreadLocalEntry {
+  /*! \brief The estimators of the entered scopes, the innermost last. */
+  std::vector<CostEstimator> scopes;
+};
+
+using CostEstimatorThreadLocalStore = dmlc::ThreadLocalStore<CostEstimatorThreadLocalEntry>;
+
+CostEstimator CostEstimator::Current() {
+  const std::vector<CostEstimator>& scopes = CostEstimatorThreadLocalStore::Get()->scopes;
+  if (!scopes.empty()) return scopes.back();
+  // shared by the threads, for the estimates of a default estimator to be cached once
+  static CostEstimator* global = new CostEstimator();
+  return *global;
+}
+
+void CostEstimator::EnterWithScope() {
+  CostEstimatorThreadLocalStore::Get()->scopes.push_back(*this);
+}
+
+void CostEstimator::ExitWithScope() {
+  std::vector<CostEstimator>& scopes = CostEstimatorThreadLocalStore::Get()->scopes;
+  ICHECK(!scopes.empty() && scopes.back().same_as(*this));
+  scopes.pop_back();
+}
+
+class CostEstimatorInternal {
+ public:
+  static void EnterScope(CostEstimator estimator) { estimator.EnterWithScope(); }
+  static void ExitScope(CostEstimator estimator) { estimator.ExitWithScope(); }
+};
+
+TVM_REGISTER_NODE_TYPE(CostEstimatorNode);
+
+TVM_REGISTER_GLOBAL("relay.analysis.CostEstimator")
+    .set_body_typed([](double peak_flops, double peak_bandwidth,
+                       Optional<meta_schedule::Database> database,
+                       runtime::PackedFunc learned_model) {
+      return CostEstimator(peak_flops, peak_bandwidth, database, learned_model);
+    });
+
+TVM_REGISTER_GLOBAL("relay.analysis.CostEstimatorEstimate")
+    .set_body_typed([](CostEstimator estimator, ObjectRef expr, Target target) {
+      if (const auto* func = expr.as<tir::PrimFuncNode>()) {
+        return estimator->Estimate(GetRef<tir::PrimFunc>(func), target);
+      }
+      const auto* call = expr.as<CallNode>();
+      ICHECK(call) << "CostEstimator: expect a Relay call or a PrimFunc, but got "
+                   << expr->GetTypeKey();
+      return estimator->Estimate(GetRef<Call>(call), target);
+    });
+
+TVM_REGISTER_GLOBAL("relay.analysis.CostEstimatorRoofline")
+    .set_body_typed([](CostEstimator estimator, tir::PrimFunc func, Target target) {
+      return estimator->EstimateRoofline(func, target);
+    });
+
+TVM_REGISTER_GLOBAL("relay.analysis.CostEstimatorCurrent").set_body_typed(CostEstimator::Current);
+TVM_REGISTER_GLOBAL("relay.analysis.CostEstimatorEnterScope")
+    .set_body_typed(CostEstimatorInternal::EnterScope);
+TVM_REGISTER_GLOBAL("relay.analysis.CostEstimatorExitScope")
+    .set_body_typed(CostEstimatorInternal::ExitScope);
+
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,156 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/analysis/cost_estimator.h
+ * \brief Estimate the latency of the Relay calls and of the PrimFuncs on a target, for the
+ *  passes making performance driven decisions without tuning the model first.
+ */
+#ifndef TVM_RELAY_ANALYSIS_COST_ESTIMATOR_H_
+#define TVM_RELAY_ANALYSIS_COST_ESTIMATOR_H_
+
+#include <tvm/ir/attrs.h>
+#include <tvm/meta_schedule/database.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
+#include <tvm/relay/expr.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/support/with.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/function.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tvm {
+namespace relay {
+
+/*!
+ * \brief Estimate the latency of the kernels, each estimate being cached.
+ *
+ *  A kernel is estimated, from the most to the least trusted source, by
+ *  - the mean run time of its best record in the tuning database, when there is one,
+ *  - the learned model, when it returns a non negative latency,
+ *  - the roofline of the target, i.e. the maximum of the time its floating point operations
+ *    take at the peak throughput and of the time its bytes take at the peak bandwidth.
+ */
+class CostEstimatorNode : public Object {
+ public:
+  /*! \brief The floating point operations per second of the target, 0 for a default. */
+  double peak_flops{0};
+  /*! \brief The bytes per second of the memory of the target, 0 for a default. */
+  double peak_bandwidth{0};
+  /*! \brief The tuning records, may be undefined. */
+  Optional<meta_schedule::Database> database;
+  /*!
+   * \brief The function estimating the latency in seconds of a lowered PrimFunc on a target,
+   *  returning a negative value when it cannot, may be null.
+   */
+  runtime::PackedFunc learned_model;
+
+  void VisitAttrs(AttrVisitor* v) {
+    v->Visit("peak_flops", &peak_flops);
+    v->Visit("peak_bandwidth", &peak_bandwidth);
+    v->Visit("database", &database);
+    // `learned_model` is not visited
+  }
+
+  /*!
+   * \brief Estimate the latency of a PrimFunc.
+   * \param func The PrimFunc, a tuning workload when it is not lowered yet.
+   * \param target The target.
+   * \return The latency in seconds.
+   */
+  double Estimate(const tir::PrimFunc& func, const Target& target);
+
+  /*!
+   * \brief Estimate the latency of the kernel of a Relay call, lowered with the strategy of
+   *  its op on the target.
+   * \param call The type checked call of an op or of a primitive function.
+   * \param target The target.
+   * \return The latency in seconds.
+   */
+  double Estimate(const Call& call, const Target& target);
+
+  /*!
+   * \brief The roofline estimate of a lowered PrimFunc.
+   * \param func The PrimFunc.
+   * \param target The target.
+   * \return The latency in seconds.
+   */
+  double EstimateRoofline(const tir::PrimFunc& func, const Target& target) const;
+
+  static constexpr const char* _type_key = "relay.CostEstimator";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CostEstimatorNode, Object);
+
+ private:
+  using EstimateCache = std::unordered_map<ObjectRef, double, StructuralHash, StructuralEqual>;
+
+  /*! \brief Estimate a lowered PrimFunc, given the tuning workload it was lowered from. */
+  double EstimateLowered(const tir::PrimFunc& func, const Optional<IRModule>& workload,
+                         const Target& target);
+  /*! \brief The mean run time of the best tuning record of a workload, negative without one. */
+  double QueryDatabase(const IRModule& workload, const Target& target);
+
+  /*! \brief The estimates of the PrimFuncs and of the Relay functions, by target. */
+  std::unordered_map<std::string, EstimateCache> cache_;
+  /*! \brief The mutex guarding the cache and the database. */
+  std::mutex mutex_;
+};
+
+/*!
+ * \brief Managed reference to CostEstimatorNode.
+ * \sa CostEstimatorNode
+ */
+class CostEstimator : public ObjectRef {
+ public:
+  /*!
+   * \brief Create a cost estimator.
+   * \param peak_flops The floating point operations per second, 0 for a default of the target.
+   * \param peak_bandwidth The memory bytes per second, 0 for a default of the target.
+   * \param database The tuning records, may be undefined.
+   * \param learned_model The function estimating a lowered PrimFunc, may be null.
+   */
+  TVM_DLL CostEstimator(double peak_flops = 0, double peak_bandwidth = 0,
+                        Optional<meta_schedule::Database> database = NullOpt,
+                        runtime::PackedFunc learned_model = nullptr);
+
+  /*!
+   * \brief The estimator of the passes, the one of the innermost scope or a process wide one
+   *  with the default settings.
+   * \return The current cost estimator.
+   */
+  TVM_DLL static CostEstimator Current();
+
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(CostEstimator, ObjectRef, CostEstimatorNode);
+
+ private:
+  friend class With<CostEstimator>;
+  friend class CostEstimatorInternal;
+  /*! \brief Make the estimator current. */
+  TVM_DLL void EnterWithScope();
+  /*! \brief Restore the previous estimator. */
+  TVM_DLL void ExitWithScope();
+};
+
+}  // namespace relay
+}  // namespace tvm
+#endif  // TVM_RELAY_ANALYSIS_COST_ESTIMATOR_H_
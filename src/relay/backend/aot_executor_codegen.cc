@@ -22,6 +22,7 @@
  * \brief AOT executor codegen
  */
 
+#include <dmlc/json.h>
 #include <tvm/ir/module.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/call.h>
@@ -29,12 +30,17 @@
 #include <tvm/relay/expr_functor.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/object.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/stmt.h>
+#include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
+#include <tvm/tir/usmp/analysis.h>
+#include <tvm/tir/usmp/transform.h>
+#include <tvm/tir/usmp/utils.h>
 
 #include <algorithm>
 #include <list>
@@ -44,6 +50,7 @@
 #include "../op/annotation/annotation.h"
 #include "../op/call/call.h"
 #include "../op/memory/device_copy.h"
+#include "../op/memory/memory.h"
 #include "../transforms/device_aware_visitors.h"
 #include "./name_transforms.h"
 #include "./te_compiler.h"
@@ -56,6 +63,43 @@ namespace backend {
 using StorageMap =
     std::unordered_map<Expr, StorageInfo, runtime::ObjectPtrHash, runtime::ObjectPtrEqual>;
 
+/*! \brief A tensor argument of the main function, in the config of the C++ AOT executor. */
+struct AOTTensorConfig {
+  std::string name;
+  std::string dtype;
+  std::vector<int64_t> shape;
+
+  void Save(dmlc::JSONWriter* writer) const {
+    writer->BeginObject();
+    if (!name.empty()) {
+      writer->WriteObjectKeyValue("name", name);
+    }
+    writer->WriteObjectKeyValue("dtype", dtype);
+    writer->WriteObjectKeyValue("shape", shape);
+    writer->EndObject();
+  }
+};
+
+/*!
+ * \brief Describe the tensors of a type.
+ * \return false when a shape is not static.
+ */
+bool MakeTensorConfigs(const Type& type, const std::string& name,
+                       std::vector<AOTTensorConfig>* configs) {
+  for (const TensorType& tensor_type : FlattenTupleType(type)) {
+    AOTTensorConfig config;
+    config.name = name;
+    config.dtype = runtime::DLDataType2String(tensor_type->dtype);
+    for (const PrimExpr& dim : tensor_type->shape) {
+      const IntImmNode* value = dim.as<IntImmNode>();
+      if (value == nullptr) return false;
+      config.shape.push_back(value->value);
+    }
+    configs->push_back(config);
+  }
+  return true;
+}
+
 /**
  * This is an on demand allocator for AOT. A new temporary
  * (storage allocator identifier) is allocated for each operation.
@@ -251,6 +295,24 @@ class AOTOnDemandAllocator : public transform::DeviceAwareExprVisitor {
 };
 
 /*! \brief Code generator for AOT executor */
+/*! \brief Annotate the allocate nodes with the candidate pools of the USMP. */
+class PoolCandidatesAnnotator : public tir::StmtMutator {
+ public:
+  explicit PoolCandidatesAnnotator(Array<tir::usmp::PoolInfo> candidates)
+      : candidates_(candidates) {}
+
+  tir::Stmt VisitStmt_(const tir::AllocateNode* op) final {
+    auto allocate = Downcast<tir::Allocate>(tir::StmtMutator::VisitStmt_(op));
+    Map<String, ObjectRef> annotations = allocate->annotations;
+    annotations.Set(tir::usmp::kPoolCandidatesAllocateAttr, candidates_);
+    return tir::Allocate(allocate->buffer_var, allocate->dtype, allocate->extents,
+                         allocate->condition, allocate->body, annotations, allocate->span);
+  }
+
+ private:
+  Array<tir::usmp::PoolInfo> candidates_;
+};
+
 class AOTExecutorCodegen : public MixedModeVisitor {
  protected:
   /*!
@@ -617,6 +679,70 @@ class AOTExecutorCodegen : public MixedModeVisitor {
   // Create the main PrimFunc to execute the graph. Please note that
   // the packed function calls don't pack their arguments. The AOT
   // runner function needs to be legalized by the LegalizePackedCalls pass.
+  /*!
+   * \brief Plan the storage of the main function in a workspace pool, replacing its allocate
+   * nodes by offsets in the pool, which becomes a trailing parameter of the main function.
+   *
+   * The pool is declared by the generated C interface and given by the entrypoint, so running
+   * the main function allocates no memory. The scratch of the operators marked with
+   * tir.usmp.plan_allocates is planned in the same pool, which they take as a parameter.
+   *
+   * \param mod_run The module of the main function, after StorageRewrite
+   * \param lowered_mod The lowered module holding the operators, updated in place
+   * \return The planned module
+   */
+  IRModule PlanWorkspacePools(IRModule mod_run, IRModule* lowered_mod) {
+    auto main_gv = mod_run->GetGlobalVar(::tvm::runtime::symbol::tvm_run_func_suffix);
+    auto main_func = Downcast<tir::PrimFunc>(mod_run->Lookup(main_gv));
+    tir::usmp::PoolInfo pool(tir::usmp::kDefaultWorkspacePoolName,
+                             {{target_host_, tir::usmp::kTargetPoolReadWriteAccess}});
+    Array<tir::usmp::PoolInfo> candidates = {pool};
+    main_func.CopyOnWrite()->body = PoolCandidatesAnnotator(candidates)(main_func->body);
+    mod_run->Update(main_gv, main_func);
+    std::vector<GlobalVar> planned_operators;
+    for (const auto& kv : (*lowered_mod)->functions) {
+      const auto* op_func = kv.second.as<tir::PrimFuncNode>();
+      if (op_func == nullptr ||
+          !op_func->GetAttr<Bool>(tir::usmp::kUSMPPlanAllocatesAttr, Bool(false)).value()) {
+        continue;
+      }
+      tir::PrimFunc annotated = GetRef<tir::PrimFunc>(op_func);
+      annotated.CopyOnWrite()->body = PoolCandidatesAnnotator(candidates)(annotated->body);
+      mod_run->Add(kv.first, annotated);
+      planned_operators.push_back(kv.first);
+    }
+
+    tvm::transform::PassContext pass_ctx = tvm::transform::PassContext::Current();
+    String algorithm = pass_ctx->GetConfig<String>(tir::usmp::kUSMPAlgorithmOption,
+                                                   String("greedy_by_size"))
+                           .value();
+    const runtime::PackedFunc* falgo =
+        runtime::Registry::Get("tir.usmp.algo." + std::string(algorithm));
+    CHECK(falgo != nullptr) << "TVM USMP Error: unknown memory planning algorithm " << algorithm;
+
+    tir::usmp::BufferInfoAnalysis buffer_info_analysis =
+        tir::usmp::ExtractBufferInfo(main_func, mod_run);
+    Array<tir::usmp::BufferInfo> buffer_info_arr =
+        tir::usmp::CreateArrayBufferInfo(buffer_info_analysis->buffer_info_stmts);
+    Map<tir::usmp::BufferInfo, tir::usmp::PoolAllocation> buffer_info_pool_allocations =
+        (*falgo)(buffer_info_arr, buffer_info_analysis->memory_pressure);
+    for (const auto& kv : tir::usmp::CalculatePoolSizes(buffer_info_pool_allocations)) {
+      VLOG(1) << "USMP pool " << kv.first->pool_name << ": " << kv.second << " bytes";
+      workspace_pool_sizes_.Set(kv.first->pool_name, kv.second);
+    }
+    Map<tir::Stmt, tir::usmp::PoolAllocation> stmt_pool_allocations =
+        tir::usmp::AssignStmtPoolAllocations(buffer_info_analysis->buffer_info_stmts,
+                                             buffer_info_pool_allocations);
+    mod_run =
+        tir::usmp::transform::ConvertPoolAllocationsToOffsets(stmt_pool_allocations)(mod_run);
+    // Move the planned operators back to the module of their target
+    for (const GlobalVar& gv : planned_operators) {
+      lowered_mod->CopyOnWrite()->Update(gv, mod_run->Lookup(gv));
+      mod_run->Remove(gv);
+    }
+    return mod_run;
+  }
+
   tir::PrimFunc CreateMainFunc(String mod_name, unsigned int relay_params) {
     tir::Stmt body = tir::SeqStmt(stmts_);
 
@@ -680,6 +806,8 @@ class AOTExecutorCodegen : public MixedModeVisitor {
   Map<GlobalVar, tir::Var> device_contexts_;
   /*! \brief input and output variables belonging to the main function signature */
   Array<tir::Var> main_signature_;
+  /*! \brief The config of the C++ AOT executor, see GetExecutorConfig. */
+  std::string executor_config_;
   /*! \brief target device */
   tec::TargetMap targets_;
   /*! \brief target host */
@@ -716,6 +844,8 @@ class AOTExecutorCodegen : public MixedModeVisitor {
   std::vector<tir::Stmt> stmts_;
   /*! \brief the list of return sids (note that the function might return more then one output */
   std::vector<int> return_sid_;
+  /*! \brief the size of each workspace pool planned by the USMP, empty when it is disabled */
+  Map<String, Integer> workspace_pool_sizes_;
 
  public:
   AOTExecutorCodegen(runtime::Module* mod, const tec::TargetMap& targets, Target target_host)
@@ -819,6 +949,15 @@ class AOTExecutorCodegen : public MixedModeVisitor {
     // Apply storage rewrite pass to the runner function to do memory planning
     auto storage_rewrite = tir::transform::StorageRewrite();
     mod_run = storage_rewrite(mod_run);
+    // Place the storage of the main function in pools given by the caller, see tir.usmp.enable
+    bool enable_usmp = tvm::transform::PassContext::Current()
+                           ->GetConfig<Bool>(tir::usmp::kUSMPEnableOption, Bool(false))
+                           .value();
+    if (enable_usmp) {
+      CHECK(use_unpacked_api_ && interface_api == "c")
+          << "The USMP needs the AOT executor with the unpacked API and the C interface";
+      mod_run = PlanWorkspacePools(mod_run, &lowered_mod);
+    }
     // The workspace for main function should be calculated after performing storage_rewrite for
     // the top level TIR function.
     Integer main_workspace_size = CalculateWorkspaceBytes(
@@ -829,6 +968,7 @@ class AOTExecutorCodegen : public MixedModeVisitor {
         lowered_mod->GetAttr<backend::FunctionInfo>("main_func_info");
 
     main_func_info.value()->workspace_sizes.Set(target_host_, main_workspace_size);
+    main_func_info.value()->workspace_pool_sizes = workspace_pool_sizes_;
     function_metadata_.Set(runtime::symbol::tvm_module_main, main_func_info.value());
 
     // Legalize AOT if needed. This means that all the packed calls
@@ -864,16 +1004,64 @@ class AOTExecutorCodegen : public MixedModeVisitor {
       VLOG(1) << "adding main into new module for host target";
       ret.lowered_funcs.Set(target_host_, mod_run);
     }
+    // The kernels only differing by their names, such as the copies lowered from reshape and
+    // squeeze, are emitted once.
+    IRModule host_mod = ret.lowered_funcs[target_host_];
+    IRModule dedup_mod = tir::transform::DeduplicateFunctions()(host_mod);
+    for (const auto& kv : host_mod->functions) {
+      if (!dedup_mod->ContainGlobalVar(kv.first->name_hint)) {
+        ret.function_metadata.erase(kv.first->name_hint);
+      }
+    }
+    ret.lowered_funcs.Set(target_host_, dedup_mod);
 
     std::vector<String> input_var_names(input_vars_.size());
     std::transform(input_vars_.begin(), input_vars_.end(), input_var_names.begin(),
                    [](Var input_var) -> String { return input_var->name_hint(); });
-    ret.metadata =
-        runtime::Metadata(input_var_names, ListDevices(), return_sid_.size(),
-                          runtime::kTvmExecutorAot, mod_name, interface_api, use_unpacked_api_);
+    std::vector<String> pool_names;
+    for (const auto& kv : workspace_pool_sizes_) {
+      pool_names.push_back(kv.first);
+    }
+    // The pools are the trailing parameters of the main function, in the order of their names
+    std::sort(pool_names.begin(), pool_names.end(),
+              [](const String& a, const String& b) { return a.compare(b) < 0; });
+    ret.metadata = runtime::Metadata(input_var_names, ListDevices(), return_sid_.size(),
+                                     runtime::kTvmExecutorAot, mod_name, interface_api,
+                                     use_unpacked_api_, pool_names);
+    executor_config_ = CreateExecutorConfig(func, mod_name);
     return ret;
   }
 
+  /*!
+   * \brief Get the config of the C++ AOT executor, see src/runtime/aot_executor.
+   * \return The JSON description of the main function and its arguments, empty when the main
+   *  function cannot be called from the C++ runtime.
+   */
+  const std::string& GetExecutorConfig() const { return executor_config_; }
+
+  std::string CreateExecutorConfig(const Function& func, const String& mod_name) const {
+    // the C++ runtime calls the main function through the packed calling convention
+    if (use_unpacked_api_ || !workspace_pool_sizes_.empty() || !devices_.empty()) return "";
+    std::vector<AOTTensorConfig> inputs;
+    std::vector<AOTTensorConfig> outputs;
+    ICHECK_EQ(func->params.size(), input_vars_.size());
+    for (const Var& param : func->params) {
+      if (!MakeTensorConfigs(param->checked_type(), param->name_hint(), &inputs)) return "";
+    }
+    if (!MakeTensorConfigs(func->body->checked_type(), "", &outputs)) return "";
+    if (inputs.size() != input_vars_.size() || outputs.size() != return_sid_.size()) return "";
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    writer.BeginObject();
+    writer.WriteObjectKeyValue(
+        "main",
+        std::string(runtime::get_name_mangled(mod_name, runtime::symbol::tvm_run_func_suffix)));
+    writer.WriteObjectKeyValue("inputs", inputs);
+    writer.WriteObjectKeyValue("outputs", outputs);
+    writer.EndObject();
+    return os.str();
+  }
+
   /*!
    * \brief Get list of devices found
    * \return List of devices
@@ -935,6 +1123,10 @@ class AOTExecutorCodegenModule : public runtime::ModuleNode {
     } else if (name == "get_metadata") {
       return PackedFunc(
           [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = output_.metadata; });
+    } else if (name == "get_executor_config") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = this->codegen_->GetExecutorConfig();
+      });
     } else {
       return PackedFunc([](TVMArgs args, TVMRetValue* rv) {});
     }
@@ -127,7 +127,10 @@ struct AOTCodegen : ExecutorCodegen {
     mod = (*pf)();
   }
 
-  void UpdateOutput(BuildOutput* ret) override { ret->graph_json = ""; }
+  // The graph JSON holds the config of the C++ AOT executor, see src/runtime/aot_executor.
+  void UpdateOutput(BuildOutput* ret) override {
+    ret->graph_json = CallFunc<std::string>("get_executor_config", nullptr);
+  }
 
   ~AOTCodegen() {}
 };
@@ -0,0 +1,128 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "buffer_size.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace tvm {
+namespace relay {
+namespace contrib {
+namespace cmsisnn {
+
+namespace {
+// The number of channels the MVE depthwise kernel processes at once, CH_IN_BLOCK_MVE.
+constexpr int32_t kChannelBlockMVE = 124;
+
+// The variants an unknown CPU may need, the size is the largest of theirs.
+const CMSISNNFlags kVariants[] = {
+    {false, false, true},
+    {true, false, true},
+    {true, true, true},
+};
+}  // namespace
+
+CMSISNNFlags GetCMSISNNFlags(const String& mcpu) {
+  std::string cpu = mcpu;
+  if (cpu == "cortex-m55") {
+    return {true, true, true};
+  }
+  if (cpu == "cortex-m4" || cpu == "cortex-m7" || cpu == "cortex-m33" || cpu == "cortex-m35p") {
+    return {true, false, true};
+  }
+  if (cpu == "cortex-m0" || cpu == "cortex-m0plus" || cpu == "cortex-m3") {
+    return {false, false, true};
+  }
+  return {false, false, false};
+}
+
+int Conv2dBufferSize(CMSISNNFlags flags, int32_t input_c, int32_t filter_h, int32_t filter_w,
+                     int32_t stride_h, int32_t stride_w, int32_t padding_h, int32_t padding_w,
+                     int32_t dilation_h, int32_t dilation_w) {
+  if (!flags.known) {
+    int size = 0;
+    for (const CMSISNNFlags& variant : kVariants) {
+      size = std::max(size, Conv2dBufferSize(variant, input_c, filter_h, filter_w, stride_h,
+                                             stride_w, padding_h, padding_w, dilation_h,
+                                             dilation_w));
+    }
+    return size;
+  }
+  // arm_convolve_1x1_s8_fast needs no scratch
+  if (padding_w == 0 && padding_h == 0 && input_c % 4 == 0 && stride_w == 1 && stride_h == 1 &&
+      filter_w == 1 && filter_h == 1 && dilation_w == 1 && dilation_h == 1) {
+    return 0;
+  }
+  int32_t col_length = input_c * filter_w * filter_h;
+  if (flags.mve) {
+    // four im2col buffers of int16 lanes, padded to whole Q registers of 8 elements
+    return 4 * ((col_length + 7) / 8) * 8 * static_cast<int32_t>(sizeof(int8_t));
+  }
+  if (flags.dsp) {
+    return 2 * col_length * static_cast<int32_t>(sizeof(int16_t));
+  }
+  return 0;
+}
+
+int DepthwiseConv2dBufferSize(CMSISNNFlags flags, int32_t input_n, int32_t input_c,
+                              int32_t output_c, int32_t filter_h, int32_t filter_w,
+                              int32_t padding_h, int32_t padding_w, int32_t dilation_h,
+                              int32_t dilation_w) {
+  if (!flags.known) {
+    int size = 0;
+    for (const CMSISNNFlags& variant : kVariants) {
+      size = std::max(size, DepthwiseConv2dBufferSize(variant, input_n, input_c, output_c,
+                                                      filter_h, filter_w, padding_h, padding_w,
+                                                      dilation_h, dilation_w));
+    }
+    return size;
+  }
+  // Only arm_depthwise_conv_s8_opt, used without channel multiplier, needs a scratch
+  if (input_c != output_c || input_n != 1 || dilation_w != 1 || dilation_h != 1) {
+    return 0;
+  }
+  if (flags.mve) {
+    return 4 * kChannelBlockMVE * filter_w * filter_h * static_cast<int32_t>(sizeof(int8_t));
+  }
+  // arm_depthwise_conv_3x3_s8 needs no scratch
+  if (filter_w == 3 && filter_h == 3 && padding_h <= 1 && padding_w <= 1) {
+    return 0;
+  }
+  if (flags.dsp) {
+    return input_c * filter_w * filter_h * static_cast<int32_t>(sizeof(int16_t));
+  }
+  return 0;
+}
+
+int AvgPoolBufferSize(CMSISNNFlags flags, int32_t input_c) {
+  if (!flags.known) {
+    return AvgPoolBufferSize({true, false, true}, input_c);
+  }
+  if (flags.dsp && !flags.mve) {
+    return input_c * static_cast<int32_t>(sizeof(int32_t));
+  }
+  return 0;
+}
+
+}  // namespace cmsisnn
+}  // namespace contrib
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,103 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/backend/contrib/cmsisnn/buffer_size.h
+ * \brief The sizes of the scratch buffers of the CMSIS-NN kernels, computed at compile time as
+ *  the *_get_buffer_size functions of CMSIS-NN do on the device.
+ */
+#ifndef TVM_RELAY_BACKEND_CONTRIB_CMSISNN_BUFFER_SIZE_H_
+#define TVM_RELAY_BACKEND_CONTRIB_CMSISNN_BUFFER_SIZE_H_
+
+#include <tvm/runtime/container/string.h>
+
+namespace tvm {
+namespace relay {
+namespace contrib {
+namespace cmsisnn {
+
+/*! \brief The extensions of the Cortex-M selecting the variant of the CMSIS-NN kernels. */
+struct CMSISNNFlags {
+  /*! \brief Whether the CPU has the DSP extension, ARM_MATH_DSP. */
+  bool dsp;
+  /*! \brief Whether the CPU has the M-Profile Vector Extension, ARM_MATH_MVEI. */
+  bool mve;
+  /*! \brief Whether the CPU is known, the sizes fitting every variant otherwise. */
+  bool known;
+};
+
+/*!
+ * \brief Get the extensions of a Cortex-M.
+ * \param mcpu The name of the CPU, e.g. cortex-m55, empty when unknown.
+ * \return The extensions.
+ */
+CMSISNNFlags GetCMSISNNFlags(const String& mcpu);
+
+/*!
+ * \brief Compute the scratch size of arm_convolve_wrapper_s8.
+ * \param flags The extensions of the CPU.
+ * \param input_c The number of input channels.
+ * \param filter_h The height of the filter.
+ * \param filter_w The width of the filter.
+ * \param stride_h The vertical stride.
+ * \param stride_w The horizontal stride.
+ * \param padding_h The vertical padding.
+ * \param padding_w The horizontal padding.
+ * \param dilation_h The vertical dilation.
+ * \param dilation_w The horizontal dilation.
+ * \return The size in bytes.
+ */
+int Conv2dBufferSize(CMSISNNFlags flags, int32_t input_c, int32_t filter_h, int32_t filter_w,
+                     int32_t stride_h, int32_t stride_w, int32_t padding_h, int32_t padding_w,
+                     int32_t dilation_h, int32_t dilation_w);
+
+/*!
+ * \brief Compute the scratch size of arm_depthwise_conv_wrapper_s8.
+ * \param flags The extensions of the CPU.
+ * \param input_n The batch size.
+ * \param input_c The number of input channels.
+ * \param output_c The number of output channels.
+ * \param filter_h The height of the filter.
+ * \param filter_w The width of the filter.
+ * \param padding_h The vertical padding.
+ * \param padding_w The horizontal padding.
+ * \param dilation_h The vertical dilation.
+ * \param dilation_w The horizontal dilation.
+ * \return The size in bytes.
+ */
+int DepthwiseConv2dBufferSize(CMSISNNFlags flags, int32_t input_n, int32_t input_c,
+                              int32_t output_c, int32_t filter_h, int32_t filter_w,
+                              int32_t padding_h, int32_t padding_w, int32_t dilation_h,
+                              int32_t dilation_w);
+
+/*!
+ * \brief Compute the scratch size of arm_avgpool_s8.
+ * \param flags The extensions of the CPU.
+ * \param input_c The number of channels.
+ * \return The size in bytes.
+ */
+int AvgPoolBufferSize(CMSISNNFlags flags, int32_t input_c);
+
+}  // namespace cmsisnn
+}  // namespace contrib
+}  // namespace relay
+}  // namespace tvm
+
+#endif  // TVM_RELAY_BACKEND_CONTRIB_CMSISNN_BUFFER_SIZE_H_
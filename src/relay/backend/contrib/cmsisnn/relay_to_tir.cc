@@ -26,9 +26,12 @@
 #include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/usmp/utils.h>
 
 #include "../../../qnn/utils.h"
 #include "../../../transforms/pattern_utils.h"
+#include "buffer_size.h"
+#include "compiler_attrs.h"
 
 namespace tvm {
 namespace relay {
@@ -37,8 +40,8 @@ namespace cmsisnn {
 
 class RelayToTIRVisitor : public MixedModeMutator {
  public:
-  explicit RelayToTIRVisitor(IRModule ir_module, Target target)
-      : ir_module_(ir_module), target_(target) {
+  explicit RelayToTIRVisitor(IRModule ir_module, Target target, CMSISNNFlags flags)
+      : ir_module_(ir_module), target_(target), flags_(flags) {
     context_buffer_id_ = 0;
   }
 
@@ -80,6 +83,8 @@ class RelayToTIRVisitor : public MixedModeMutator {
       body =
           tir::AttrStmt(PrimExpr(), tvm::tir::attr::device_type, target_->kind->device_type, body);
       body = tir::AttrStmt(PrimExpr(), tvm::tir::attr::device_id, 0, body);
+      // with the USMP, the context buffer is placed in the pools of the executor storage
+      dict_attrs.Set(tir::usmp::kUSMPPlanAllocatesAttr, Bool(true));
     }
 
     tir::PrimFunc replacement_func(func_signature, body, VoidType(), Map<tir::Var, tir::Buffer>(),
@@ -192,9 +197,20 @@ class RelayToTIRVisitor : public MixedModeMutator {
 
     // https://github.com/ARM-software/CMSIS_5/blob/d788fd583984388553391de18afd8b4d2a146868/CMSIS/NN/Source/ConvolutionFunctions/arm_convolve_s8.c#L367
     std::string context_buffer_name = "NULL";
-    size_t context_buffer_size =
-        (2 * qnn::get_const_int(input_shape[3]) * qnn::get_const_int(filter_shape[2]) *
-         qnn::get_const_int(filter_shape[1]) * (int32_t)sizeof(int16_t));
+    int32_t input_n = qnn::get_const_int(input_shape[0]);
+    int32_t input_c = qnn::get_const_int(input_shape[3]);
+    int32_t filter_h = qnn::get_const_int(filter_shape[1]);
+    int32_t filter_w = qnn::get_const_int(filter_shape[2]);
+    int context_buffer_size;
+    if (depth_multiplier != -1) {
+      context_buffer_size =
+          DepthwiseConv2dBufferSize(flags_, input_n, input_c, out_channels, filter_h, filter_w,
+                                    padding_h, padding_w, dilation_h, dilation_w);
+    } else {
+      context_buffer_size =
+          Conv2dBufferSize(flags_, input_c, filter_h, filter_w, stride_h, stride_w, padding_h,
+                           padding_w, dilation_h, dilation_w);
+    }
     if (context_buffer_size) {
       context_buffer_name = "context_buffer_" + std::to_string(context_buffer_id_++);
     }
@@ -302,6 +318,7 @@ class RelayToTIRVisitor : public MixedModeMutator {
     }
     call_ext_args.push_back(output);
 
+    // arm_fully_connected_s8 needs no scratch in any variant
     int context_buffer_size = 0;
     std::string context_buffer_name = "NULL";
     tvm::Array<PrimExpr> context_buffer_args = {tir::StringImm(context_buffer_name),
@@ -391,9 +408,10 @@ class RelayToTIRVisitor : public MixedModeMutator {
 
     int context_buffer_size = 0;
     std::string context_buffer_name = "NULL";
-    if (pool_name == "cmsisnn.qnn_avg_pool2d") {
-      // TODO(@Mousius): Need to move this into buffer_size calculations
-      context_buffer_size = qnn::get_const_int(input_shape[3]) * sizeof(int32_t);
+    if (pool_name == "cmsis-nn.qnn_avg_pool2d") {
+      context_buffer_size = AvgPoolBufferSize(flags_, qnn::get_const_int(input_shape[3]));
+    }
+    if (context_buffer_size) {
       context_buffer_name = "context_buffer_" + std::to_string(context_buffer_id_++);
     }
     tvm::Array<PrimExpr> context_buffer_args = {tir::StringImm(context_buffer_name),
@@ -625,12 +643,14 @@ class RelayToTIRVisitor : public MixedModeMutator {
   int32_t context_buffer_id_;
   IRModule ir_module_;
   Target target_;
+  CMSISNNFlags flags_;
 };
 
 tvm::transform::Pass RelayToTIR() {
   runtime::TypedPackedFunc<IRModule(IRModule, transform::PassContext)> pass_func =
       [=](IRModule ir_module, transform::PassContext pass_context) {
-        auto relay_to_tir = RelayToTIRVisitor(ir_module, Target("cmsis-nn"));
+        CMSISNNFlags flags = GetCMSISNNFlags(GetCompilerAttrs()->mcpu);
+        auto relay_to_tir = RelayToTIRVisitor(ir_module, Target("cmsis-nn"), flags);
         return relay_to_tir.Mutate();
       };
   return tvm::transform::CreateModulePass(pass_func, 0, "RelayToTIR", {});
@@ -453,11 +453,10 @@ class DNNLJSONSerializer : public backend::contrib::JSONSerializer {
       ICHECK(comp.defined()) << "DNNL JSON runtime only supports composite functions.";
       name = comp.value();
 
-      if (name == "dnnl.conv2d_bias_relu") {
-        call = GetRootCall(fn->body.as<CallNode>(), 2, {"nn.conv2d", "add", "nn.relu"});
-      } else if (name == "dnnl.conv2d_relu") {
-        call = GetRootCall(fn->body.as<CallNode>(), 1, {"nn.conv2d", "nn.relu"});
-        ICHECK(call->op.as<OpNode>()) << "Not op node";
+      if (name.compare(0, 12, "dnnl.conv2d_") == 0) {
+        call = GetAnchorCall(fn->body.as<CallNode>(), "nn.conv2d");
+      } else if (name.compare(0, 11, "dnnl.dense_") == 0) {
+        call = GetAnchorCall(fn->body.as<CallNode>(), "nn.dense");
       } else {
         LOG(FATAL) << "Unrecognized DNNL pattern: " << name;
       }
@@ -476,6 +475,26 @@ class DNNLJSONSerializer : public backend::contrib::JSONSerializer {
     SetCallNodeAttribute(node, call);
     return AddNode(node, GetRef<Expr>(cn));
   }
+
+ private:
+  /*!
+   * \brief Get the convolution or dense call of a composite function. The fused ops, the bias
+   * and residual adds and the activations, take the anchor call as their first argument.
+   * \param call The body of the composite function.
+   * \param anchor_name The op name of the anchor call.
+   * \return The anchor call.
+   */
+  static const CallNode* GetAnchorCall(const CallNode* call, const std::string& anchor_name) {
+    while (call != nullptr) {
+      const auto* op_node = call->op.as<OpNode>();
+      ICHECK(op_node) << "Not op node";
+      if (op_node->name == anchor_name) return call;
+      ICHECK(!call->args.empty());
+      call = call->args[0].as<CallNode>();
+    }
+    LOG(FATAL) << "Cannot find " << anchor_name << " in the composite function";
+    return nullptr;
+  }
 };
 #endif
 
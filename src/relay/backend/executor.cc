@@ -90,7 +90,8 @@ ExecutorRegEntry& ExecutorRegEntry::RegisterOrGet(const String& name) {
 TVM_REGISTER_EXECUTOR("aot")
     .add_attr_option<Bool>("unpacked-api")
     .add_attr_option<String>("interface-api")
-    .add_attr_option<Integer>("workspace-byte-alignment");
+    .add_attr_option<Integer>("workspace-byte-alignment")
+    .add_attr_option<Bool>("inline-operators");
 
 TVM_REGISTER_EXECUTOR("graph").add_attr_option<Bool>("link-params", Bool(false));
 
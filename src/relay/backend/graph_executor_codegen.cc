@@ -33,10 +33,12 @@
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/function.h>
 
+#include <algorithm>
 #include <list>
 #include <string>
 #include <vector>
 
+#include "../../runtime/texture.h"
 #include "../op/annotation/annotation.h"
 #include "../op/call/call.h"
 #include "../op/memory/device_copy.h"
@@ -326,6 +328,9 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
       storage_ids.push_back(v);
     }
     node->attrs_["storage_id"] = std::move(storage_ids);
+    if (!storage_info->storage_offsets_in_bytes.empty()) {
+      node->attrs_["storage_offset"] = storage_info->storage_offsets_in_bytes;
+    }
     // type
     std::vector<int64_t> device_types;
     for (const auto& se_scope : storage_info->se_scopes) {
@@ -342,6 +347,15 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     if (num_unknown_devices == 0) {
       node->attrs_["device_index"] = device_types;
     }
+    // The memory scopes are only kept when the executor must allocate textures.
+    std::vector<std::string> storage_scopes;
+    for (const auto& se_scope : storage_info->se_scopes) {
+      storage_scopes.push_back(se_scope->memory_scope);
+    }
+    if (std::any_of(storage_scopes.begin(), storage_scopes.end(),
+                    [](const std::string& scope) { return runtime::IsTextureStorage(scope); })) {
+      node->attrs_["storage_scope"] = std::move(storage_scopes);
+    }
     auto node_id = nodes_.size();
     nodes_.push_back(node);
     // Tuple return value, flatten as tuple
@@ -412,7 +426,12 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     StorageInfo rit = GetStorageInfo(rhs);
     int64_t lhs_storage_id = lit->storage_ids[0];
     int64_t rhs_storage_id = rit->storage_ids[0];
-    return lhs_storage_id == rhs_storage_id;
+    // Entries of one storage only share memory at the same offset.
+    int64_t lhs_offset =
+        lit->storage_offsets_in_bytes.empty() ? 0 : lit->storage_offsets_in_bytes[0];
+    int64_t rhs_offset =
+        rit->storage_offsets_in_bytes.empty() ? 0 : rit->storage_offsets_in_bytes[0];
+    return lhs_storage_id == rhs_storage_id && lhs_offset == rhs_offset;
   }
 
   std::vector<GraphNodeRef> GraphAddCallNode(const CallNode* call_node, GraphAttrs attrs) {
@@ -555,7 +574,9 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     size_t num_entry = 0;
     ShapeVector shapes;
     std::vector<size_t> storage_ids;
+    std::vector<size_t> storage_offsets;
     std::vector<size_t> device_types;
+    std::vector<std::string> storage_scopes;
     std::vector<std::string> dltypes;
     std::vector<size_t> node_row_ptr{0};
     for (auto node : nodes_) {
@@ -569,6 +590,16 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
       shapes.insert(shapes.end(), shape_vec.begin(), shape_vec.end());
       dltypes.insert(dltypes.end(), dtype_vec.begin(), dtype_vec.end());
       storage_ids.insert(storage_ids.end(), storage_id.begin(), storage_id.end());
+      if (node->attrs_.count("storage_offset")) {
+        const auto& offsets = dmlc::get<std::vector<int64_t>>(node->attrs_["storage_offset"]);
+        storage_offsets.resize(num_entry - node->num_outputs_, 0);
+        storage_offsets.insert(storage_offsets.end(), offsets.begin(), offsets.end());
+      }
+      if (node->attrs_.count("storage_scope")) {
+        const auto& scopes = dmlc::get<std::vector<std::string>>(node->attrs_["storage_scope"]);
+        storage_scopes.resize(num_entry - node->num_outputs_);
+        storage_scopes.insert(storage_scopes.end(), scopes.begin(), scopes.end());
+      }
       if (node->attrs_.count("device_index")) {
         const auto& dev_types = dmlc::get<std::vector<int64_t>>(node->attrs_["device_index"]);
         device_types.insert(device_types.end(), dev_types.begin(), dev_types.end());
@@ -584,6 +615,20 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     attrs["shape"].emplace_back(shapes);
     attrs["storage_id"].emplace_back(std::string("list_int"));
     attrs["storage_id"].emplace_back(storage_ids);
+    // Only written when some entries share a storage at different offsets, as older runtimes
+    // would ignore it.
+    if (std::any_of(storage_offsets.begin(), storage_offsets.end(),
+                    [](size_t offset) { return offset != 0; })) {
+      storage_offsets.resize(num_entry, 0);
+      attrs["storage_offset"].emplace_back(std::string("list_int"));
+      attrs["storage_offset"].emplace_back(storage_offsets);
+    }
+    // Only written when some entries are textures, which older runtimes cannot allocate.
+    if (!storage_scopes.empty()) {
+      storage_scopes.resize(num_entry);
+      attrs["storage_scope"].emplace_back(std::string("list_str"));
+      attrs["storage_scope"].emplace_back(storage_scopes);
+    }
     if (device_types.size()) {
       attrs["device_index"].emplace_back(std::string("list_int"));
       attrs["device_index"].emplace_back(device_types);
@@ -29,8 +29,16 @@
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/tir/op.h>
 
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../../runtime/texture.h"
 #include "../../support/arena.h"
 #include "../op/annotation/annotation.h"
 #include "../op/call/call.h"
@@ -45,6 +53,9 @@ using backend::StaticMemoryPlan;
 using backend::StorageInfo;
 using IntegerArray = Array<Integer>;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.GraphPlanMemory.use_offsets", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.GraphPlanMemory.in_place", Bool);
+
 /*! A representation of a block of memory required at runtime on some device. */
 struct StorageToken {
   /*! \brief Reference counter */
@@ -57,6 +68,14 @@ struct StorageToken {
   SEScope se_scope = SEScope::FullyUnconstrained();
   /*! \brief The storage id */
   int64_t storage_id{-1};
+  /*! \brief The byte offset within the storage, when placed in an arena. */
+  int64_t offset{0};
+  /*! \brief The first and the last step the token is live at, -1 until it is released. */
+  int first_use{0};
+  int last_use{-1};
+  /*! \brief The extent in texels of the image, when the memory is a texture. */
+  int64_t texture_width{0};
+  int64_t texture_height{0};
 
   bool is_valid() const { return !se_scope->IsFullyUnconstrained(); }
 
@@ -244,8 +263,17 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   StaticMemoryPlan Plan(const Function& func) {
     VLOG_CONTEXT << "StorageAllocator";
     VLOG(1) << "planning:" << std::endl << PrettyPrint(func);
+    use_offsets_ = transform::PassContext::Current()
+                       ->GetConfig<Bool>("relay.GraphPlanMemory.use_offsets", Bool(false))
+                       .value();
+    in_place_ = transform::PassContext::Current()
+                    ->GetConfig<Bool>("relay.GraphPlanMemory.in_place", Bool(false))
+                    .value();
     prototype_ = StorageAllocaInit(&arena_).GetInitTokenMap(func);
     this->Run(func);
+    if (use_offsets_) {
+      PlanOffsets();
+    }
 
     // The value of smap contains two integer arrays where the first array
     // contains the planned storage ids and the second holds the device types.
@@ -260,6 +288,7 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
       se_scopes.reserve(kv.second.size());
       std::vector<int64_t> sid_sizes_byte;
       sid_sizes_byte.reserve(kv.second.size());
+      std::vector<int64_t> sid_offsets_byte;
 
       for (StorageToken* tok : kv.second) {
         VLOG(1) << "token: " << tok->ToString();
@@ -270,9 +299,13 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
         storage_ids.push_back(tok->storage_id);
         se_scopes.push_back(tok->se_scope);
         sid_sizes_byte.push_back(GetMemorySize(tok));
+        if (use_offsets_) {
+          sid_offsets_byte.push_back(tok->offset);
+        }
       }
-      auto storage_info = backend::StorageInfo(std::move(storage_ids), std::move(se_scopes),
-                                               std::move(sid_sizes_byte));
+      auto storage_info =
+          backend::StorageInfo(std::move(storage_ids), std::move(se_scopes),
+                               std::move(sid_sizes_byte), std::move(sid_offsets_byte));
       smap.Set(GetRef<Expr>(kv.first), storage_info);
     }
     // Either all or none of the nodes should be annotated.
@@ -338,6 +371,8 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
         args.push_back(tok);
       }
     }
+    // The arguments are read and the results written at the same step.
+    ++step_;
 
     // Under the flat-memory setting.
     // we can force aliasing the input and output of reshape
@@ -352,6 +387,9 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     if (call_lowered_props.lowered_func.defined() && IsReshapeOnly(call_lowered_props)) {
       ICHECK_EQ(call_lowered_props.arguments.size(), 1U);
       ReuseInputToken(call_node, args[0]);
+    } else if (StorageToken* input_token = FindInPlaceToken(call_node, call_lowered_props, args)) {
+      // The result overwrites an argument which dies at the call.
+      ReuseInputToken(call_node, input_token);
     } else {
       // create token for the call node.
       CreateToken(call_node, true);
@@ -366,6 +404,37 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
       CheckForRelease(tok);
     }
   }
+  /*!
+   * \brief Find the token of an argument of a lowered call its result may overwrite, that is
+   * an argument the result may alias whose memory is not used after the call.
+   * \param call_node The call.
+   * \param props The lowered call.
+   * \param args The tokens of all the arguments of the call.
+   * \return The token, nullptr when there is none.
+   */
+  StorageToken* FindInPlaceToken(const CallNode* call_node, const CallLoweredProps& props,
+                                 const std::vector<StorageToken*>& args) {
+    if (!in_place_ || !props.lowered_func.defined()) return nullptr;
+    const std::vector<StorageToken*>& prototypes = prototype_.at(call_node);
+    if (prototypes.size() != 1) return nullptr;
+    StorageToken* prototype = prototypes[0];
+    for (const Integer& index : InPlaceArguments(props)) {
+      if (index->value < 0 || static_cast<size_t>(index->value) >= props.arguments.size()) {
+        continue;
+      }
+      const std::vector<StorageToken*>& tokens = GetToken(props.arguments[index->value]);
+      if (tokens.size() != 1) continue;
+      StorageToken* tok = tokens[0];
+      // The parameters and the constants hold an extra reference, they are never overwritten.
+      int num_uses = static_cast<int>(std::count(args.begin(), args.end(), tok));
+      if (tok->ref_counter == num_uses && tok->is_compatible(*prototype) && !IsTexture(*tok) &&
+          tok->max_bytes >= static_cast<size_t>(GetMemorySize(prototype))) {
+        return tok;
+      }
+    }
+    return nullptr;
+  }
+
   /*!
    * \brief ceil(size/word_size) to get number of words.
    * \param size The original size.
@@ -402,8 +471,17 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
    * \return The result token.
    */
   StorageToken* Request(StorageToken* prototype) {
+    if (IsTexture(*prototype)) {
+      return RequestTexture(prototype);
+    }
     // calculate the size;
     size_t size = GetMemorySize(prototype);
+    if (use_offsets_ && CanPlaceInArena(*prototype)) {
+      // The token is given a place in an arena once all the liveness intervals are known.
+      prototype->first_use = step_;
+      placed_.push_back(prototype);
+      return this->Alloc(prototype, size);
+    }
     // search memory block in [size / match_range_, size * match_range_)
     if (match_range_ == 0) {
       return this->Alloc(prototype, size);
@@ -439,6 +517,85 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     // cannot find anything return a new one.
     return this->Alloc(prototype, size);
   }
+
+  /*! \brief Check if the token is held in a texture rather than in a buffer. */
+  static bool IsTexture(const StorageToken& tok) {
+    return runtime::IsTextureStorage(tok.se_scope->memory_scope);
+  }
+
+  /*!
+   * \brief Get the 2d extent of the texture holding a token, following the layout of its
+   * memory scope.
+   */
+  static runtime::Texture2DShape<int64_t> GetTextureShape(const StorageToken& tok) {
+    std::vector<int64_t> shape;
+    for (IndexExpr dim : tok.ttype->shape) {
+      const int64_t* pval = tir::as_const_int(dim);
+      ICHECK(pval != nullptr) << "Cannot allocate a texture for symbolic tensor shape "
+                              << tok.ttype->shape;
+      shape.push_back(*pval);
+    }
+    ICHECK_GE(shape.size(), 3U) << "A texture holds tensors of rank 3 at least, not "
+                                << tok.ttype->shape;
+    size_t axis = runtime::DefaultTextureLayoutSeparator(shape.size(), tok.se_scope->memory_scope);
+    return runtime::ApplyTexture2DFlattening<int64_t>(shape, shape.size(), axis);
+  }
+
+  /*!
+   * \brief Check if a released texture may hold a request. The texels of all the texture
+   * scopes are read in the same way whatever the layout of the tensor, so the activations
+   * and the weights of the same channel packing share their textures.
+   */
+  static bool CanShareTexture(const StorageToken& tok, const StorageToken& prototype) {
+    const SEScope& a = tok.se_scope;
+    const SEScope& b = prototype.se_scope;
+    return a->device_type() == b->device_type() && a->virtual_device_id == b->virtual_device_id &&
+           a->target == b->target && tok.ttype->dtype == prototype.ttype->dtype &&
+           GetTextureShape(tok).channel == GetTextureShape(prototype).channel;
+  }
+
+  /*!
+   * \brief Request a texture for a given prototype, growing a released texture to the 2d
+   * extent covering both when that is cheaper than a new one.
+   *
+   * As the TexturePool of the runtime does, the texture which grows the least is chosen, then
+   * among them the one wasting the least texels.
+   */
+  StorageToken* RequestTexture(StorageToken* prototype) {
+    runtime::Texture2DShape<int64_t> shape = GetTextureShape(*prototype);
+    int64_t area = shape.width * shape.height;
+    auto best = free_textures_.end();
+    int64_t best_added = std::numeric_limits<int64_t>::max();
+    int64_t best_wasted = std::numeric_limits<int64_t>::max();
+    for (auto it = free_textures_.begin(); it != free_textures_.end(); ++it) {
+      StorageToken* tok = *it;
+      if (!CanShareTexture(*tok, *prototype)) continue;
+      ICHECK_EQ(tok->ref_counter, 0);
+      int64_t grown = std::max(tok->texture_width, shape.width) *
+                      std::max(tok->texture_height, shape.height);
+      int64_t added = grown - tok->texture_width * tok->texture_height;
+      int64_t wasted = grown - area;
+      // growing more than the request costs more than allocating it
+      if (added > area) continue;
+      if (added < best_added || (added == best_added && wasted < best_wasted)) {
+        best = it;
+        best_added = added;
+        best_wasted = wasted;
+      }
+    }
+    if (best == free_textures_.end()) {
+      return this->Alloc(prototype, GetMemorySize(prototype));
+    }
+    StorageToken* tok = *best;
+    free_textures_.erase(best);
+    tok->texture_width = std::max(tok->texture_width, shape.width);
+    tok->texture_height = std::max(tok->texture_height, shape.height);
+    tok->max_bytes = tok->texture_width * tok->texture_height * shape.channel *
+                     DivRoundUp(tok->ttype->dtype.bits() * tok->ttype->dtype.lanes(), 8);
+    tok->ref_counter = prototype->ref_counter;
+    return tok;
+  }
+
   /*!
    * \brief Allocate a storage token by consuming prototype
    * \param prototype The prototype token.
@@ -447,6 +604,11 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   StorageToken* Alloc(StorageToken* prototype, size_t size) {
     prototype->max_bytes = size;
     prototype->storage_id = static_cast<int64_t>(data_.size());
+    if (IsTexture(*prototype)) {
+      runtime::Texture2DShape<int64_t> shape = GetTextureShape(*prototype);
+      prototype->texture_width = shape.width;
+      prototype->texture_height = shape.height;
+    }
     data_.push_back(prototype);
     return prototype;
   }
@@ -458,7 +620,159 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     ICHECK_GE(tok->storage_id, 0);
     ICHECK_GE(tok->ref_counter, 0);
     if (tok->ref_counter == 0) {
-      free_.insert({tok->max_bytes, tok});
+      if (use_offsets_ && tok->last_use < 0 && CanPlaceInArena(*tok)) {
+        tok->last_use = step_;
+      } else if (IsTexture(*tok)) {
+        free_textures_.push_back(tok);
+      } else {
+        free_.insert({tok->max_bytes, tok});
+      }
+    }
+  }
+
+  /*!
+   * \brief Check if a token may be placed at an offset of an arena shared with other tokens,
+   * that is if its device buffers are plain addresses.
+   */
+  static bool CanPlaceInArena(const StorageToken& tok) {
+    switch (tok.se_scope->device_type()) {
+      case kDLCPU:
+      case kDLCUDA:
+      case kDLCUDAHost:
+      case kDLCUDAManaged:
+      case kDLROCM:
+        return tok.se_scope->memory_scope.empty() || tok.se_scope->memory_scope == "global";
+      default:
+        return false;
+    }
+  }
+
+  /*! \brief Check if the liveness intervals of two tokens overlap. */
+  static bool LiveTogether(const StorageToken* a, const StorageToken* b) {
+    int a_last = a->last_use < 0 ? std::numeric_limits<int>::max() : a->last_use;
+    int b_last = b->last_use < 0 ? std::numeric_limits<int>::max() : b->last_use;
+    return a->first_use <= b_last && b->first_use <= a_last;
+  }
+
+  static int64_t AlignedSize(const StorageToken* tok) {
+    return DivRoundUp(tok->max_bytes, runtime::kAllocAlignment) * runtime::kAllocAlignment;
+  }
+
+  /*!
+   * \brief Place the tokens one after the other in \p order, each at the lowest offset where
+   * it does not overlap a token placed before it and live at the same time.
+   * \return The size of the arena.
+   */
+  static int64_t PlaceInOrder(const std::vector<StorageToken*>& tokens,
+                              const std::vector<std::vector<size_t>>& conflicts,
+                              const std::vector<size_t>& order, std::vector<int64_t>* offsets) {
+    std::vector<std::pair<int64_t, int64_t>> used;
+    int64_t arena_size = 0;
+    for (size_t index : order) {
+      used.clear();
+      for (size_t other : conflicts[index]) {
+        if ((*offsets)[other] >= 0) {
+          used.emplace_back((*offsets)[other], (*offsets)[other] + AlignedSize(tokens[other]));
+        }
+      }
+      std::sort(used.begin(), used.end());
+      int64_t size = AlignedSize(tokens[index]);
+      int64_t offset = 0;
+      for (const auto& range : used) {
+        if (offset + size <= range.first) break;
+        offset = std::max(offset, range.second);
+      }
+      (*offsets)[index] = offset;
+      arena_size = std::max(arena_size, offset + size);
+    }
+    return arena_size;
+  }
+
+  /*!
+   * \brief Place the tokens of one scope in a single arena.
+   *
+   * The tokens are first placed by decreasing size, then the order is refined by moving the
+   * token ending at the top of the arena before a random earlier token, keeping the moves
+   * that shrink the arena, as the hill climb of the USMP algorithms does.
+   * \return The size of the arena.
+   */
+  static int64_t PlaceArena(const std::vector<StorageToken*>& tokens) {
+    size_t num_tokens = tokens.size();
+    std::vector<std::vector<size_t>> conflicts(num_tokens);
+    for (size_t i = 0; i < num_tokens; ++i) {
+      for (size_t j = i + 1; j < num_tokens; ++j) {
+        if (LiveTogether(tokens[i], tokens[j])) {
+          conflicts[i].push_back(j);
+          conflicts[j].push_back(i);
+        }
+      }
+    }
+    std::vector<size_t> rank(num_tokens);
+    for (size_t i = 0; i < num_tokens; ++i) rank[i] = i;
+    std::stable_sort(rank.begin(), rank.end(), [&](size_t a, size_t b) {
+      return tokens[a]->max_bytes > tokens[b]->max_bytes;
+    });
+    std::vector<int64_t> offsets(num_tokens, -1);
+    int64_t best_size = PlaceInOrder(tokens, conflicts, rank, &offsets);
+    std::vector<int64_t> best_offsets = offsets;
+    // Each placement costs about num_tokens^2, the refinement is bounded accordingly.
+    int64_t num_steps = std::min<int64_t>(
+        kMaxRefineSteps, kRefineBudget / std::max<int64_t>(1, num_tokens * num_tokens));
+    std::mt19937 rng(static_cast<uint32_t>(num_tokens));
+    for (int64_t step = 0; step < num_steps; ++step) {
+      size_t top = 0;
+      for (size_t i = 0; i < num_tokens; ++i) {
+        if (best_offsets[rank[i]] + AlignedSize(tokens[rank[i]]) == best_size) top = i;
+      }
+      if (top == 0) break;
+      std::vector<size_t> new_rank = rank;
+      size_t target = std::uniform_int_distribution<size_t>(0, top - 1)(rng);
+      size_t moved = new_rank[top];
+      new_rank.erase(new_rank.begin() + top);
+      new_rank.insert(new_rank.begin() + target, moved);
+      std::fill(offsets.begin(), offsets.end(), -1);
+      int64_t size = PlaceInOrder(tokens, conflicts, new_rank, &offsets);
+      if (size < best_size) {
+        best_size = size;
+        best_offsets = offsets;
+        rank = std::move(new_rank);
+      }
+    }
+    for (size_t i = 0; i < num_tokens; ++i) {
+      tokens[i]->offset = best_offsets[i];
+    }
+    return best_size;
+  }
+
+  /*!
+   * \brief Place the tokens requested while planning with offsets in one arena per scope, and
+   * renumber the storage ids so that each arena is a single storage.
+   */
+  void PlanOffsets() {
+    std::vector<std::vector<StorageToken*>> arenas;
+    std::unordered_map<const StorageToken*, size_t> arena_index;
+    for (StorageToken* tok : placed_) {
+      size_t index = 0;
+      while (index < arenas.size() && !arenas[index][0]->is_compatible(*tok)) ++index;
+      if (index == arenas.size()) arenas.emplace_back();
+      arenas[index].push_back(tok);
+      arena_index[tok] = index;
+    }
+    for (const auto& tokens : arenas) {
+      int64_t arena_size = PlaceArena(tokens);
+      VLOG(1) << "placed " << tokens.size() << " tokens in an arena of " << arena_size
+              << " bytes on " << tokens[0]->se_scope;
+    }
+    std::vector<int64_t> arena_ids(arenas.size(), -1);
+    int64_t next_id = 0;
+    for (StorageToken* tok : data_) {
+      auto it = arena_index.find(tok);
+      if (it == arena_index.end()) {
+        tok->storage_id = next_id++;
+      } else {
+        if (arena_ids[it->second] < 0) arena_ids[it->second] = next_id++;
+        tok->storage_id = arena_ids[it->second];
+      }
     }
   }
 
@@ -467,8 +781,21 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   support::Arena arena_;
   // scale used for rough match
   size_t match_range_{16};
+  // whether the tokens are placed at offsets of per scope arenas rather than pooled
+  bool use_offsets_{false};
+  // whether the results of the elementwise calls may overwrite their dying arguments
+  bool in_place_{false};
+  // the number of calls visited so far, the liveness intervals are counted in calls
+  int step_{0};
+  // the tokens to place in the arenas
+  std::vector<StorageToken*> placed_;
+  /*! \brief The bound of the refinement steps of an arena placement and of their total cost. */
+  static constexpr int64_t kMaxRefineSteps = 256;
+  static constexpr int64_t kRefineBudget = int64_t(1) << 26;
   // free list of storage entry
   std::multimap<size_t, StorageToken*> free_;
+  // free list of the textures, searched for the best 2d fit
+  std::vector<StorageToken*> free_textures_;
   // all the storage resources available
   std::vector<StorageToken*> data_;
   /*! \brief internal prototype token map */
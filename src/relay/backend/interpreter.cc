@@ -23,6 +23,8 @@
  */
 
 #include <tvm/driver/driver_api.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/call.h>
@@ -37,6 +39,12 @@
 #include <tvm/runtime/object.h>
 #include <tvm/target/compilation_config.h>
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "../op/annotation/annotation.h"
 #include "../op/call/call.h"
 #include "../op/memory/device_copy.h"
@@ -122,6 +130,106 @@ ObjectRef ToADTOrNDArray(const Type& type, const std::vector<NDArray>& nd_arrays
   }
 }
 
+/*!
+ * \brief The runtime modules built for the primitives projected out of the lowered modules,
+ * shared by all the interpreters of the process.
+ *
+ * Each constant evaluation and each debug executor creates a fresh interpreter, which would
+ * otherwise build again the primitives an earlier interpreter already built. A built module only
+ * depends on the projected module, the target and the build configuration of the pass context.
+ */
+class CompiledModuleCache {
+ public:
+  static CompiledModuleCache* Global() {
+    static CompiledModuleCache* inst = new CompiledModuleCache();
+    return inst;
+  }
+
+  /*!
+   * \brief Returns the module built for \p mod and \p target, calling \p fbuild on first use.
+   */
+  runtime::Module Get(const IRModule& mod, const Target& target,
+                      const std::function<runtime::Module()>& fbuild) {
+    Key key{mod, target->str(), transform::PassContext::Current()->config};
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = table_.find(key);
+      if (it != table_.end()) {
+        return it->second;
+      }
+    }
+    // Build outside of the lock, two interpreters racing on the same module both build it.
+    runtime::Module built = fbuild();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (table_.size() >= kMaxEntries) {
+      table_.clear();
+    }
+    return table_.emplace(std::move(key), built).first->second;
+  }
+
+ private:
+  struct Key {
+    IRModule mod;
+    std::string target;
+    Map<String, ObjectRef> config;
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      size_t hash = StructuralHash()(key.mod);
+      hash = dmlc::HashCombine(hash, std::hash<std::string>()(key.target));
+      return dmlc::HashCombine(hash, StructuralHash()(key.config));
+    }
+  };
+  struct KeyEqual {
+    bool operator()(const Key& lhs, const Key& rhs) const {
+      return lhs.target == rhs.target && StructuralEqual()(lhs.mod, rhs.mod) &&
+             StructuralEqual()(lhs.config, rhs.config);
+    }
+  };
+  /*! \brief The table is dropped when it reaches this size. */
+  static constexpr size_t kMaxEntries = 512;
+  std::mutex mutex_;
+  std::unordered_map<Key, runtime::Module, KeyHash, KeyEqual> table_;
+};
+
+/*! \brief The elementwise operators evaluated directly on small constants. */
+enum class DirectOp { kAdd, kSubtract, kMultiply, kMaximum, kMinimum };
+
+/*! \brief Constants above this number of elements are left to the compiled kernels. */
+constexpr int64_t kMaxDirectElements = 4096;
+
+// W is the type the values are computed in, unsigned for the integers so that an overflow wraps
+// around as in the compiled kernels.
+template <typename T, typename W>
+void DirectBinary(DirectOp op, const void* lhs, bool lhs_scalar, const void* rhs, bool rhs_scalar,
+                  void* out, int64_t num_elements) {
+  const T* a = static_cast<const T*>(lhs);
+  const T* b = static_cast<const T*>(rhs);
+  T* c = static_cast<T*>(out);
+  for (int64_t i = 0; i < num_elements; ++i) {
+    T x = a[lhs_scalar ? 0 : i];
+    T y = b[rhs_scalar ? 0 : i];
+    switch (op) {
+      case DirectOp::kAdd:
+        c[i] = static_cast<T>(static_cast<W>(x) + static_cast<W>(y));
+        break;
+      case DirectOp::kSubtract:
+        c[i] = static_cast<T>(static_cast<W>(x) - static_cast<W>(y));
+        break;
+      case DirectOp::kMultiply:
+        c[i] = static_cast<T>(static_cast<W>(x) * static_cast<W>(y));
+        break;
+      // Same selects as the code generators, so that a NaN operand gives the same result.
+      case DirectOp::kMaximum:
+        c[i] = x > y ? x : y;
+        break;
+      case DirectOp::kMinimum:
+        c[i] = x < y ? x : y;
+        break;
+    }
+  }
+}
+
 }  // namespace
 
 InterpreterClosure::InterpreterClosure(Map<Var, ObjectRef> env, Function func) {
@@ -402,14 +510,16 @@ class Interpreter : public ExprFunctor<ObjectRef(const Expr& n)>,
       lowered_projected_mod->Add(var, target_module->Lookup(var->name_hint));
     }
 
-    // Compile (aka 'build') the projected module into a runtime module of packed functions.
-    runtime::Module runtime_module;
-    if (const auto* f = runtime::Registry::Get("relay.backend.build")) {
-      // TODO(mbs): Cleanup hooks.
-      runtime_module = (*f)(lowered_projected_mod, target);
-    } else {
-      runtime_module = build(lowered_projected_mod, target, /*target_host=*/Target(nullptr));
-    }
+    // Compile (aka 'build') the projected module into a runtime module of packed functions,
+    // unless another interpreter already built the same one.
+    runtime::Module runtime_module =
+        CompiledModuleCache::Global()->Get(lowered_projected_mod, target, [&]() {
+          if (const auto* f = runtime::Registry::Get("relay.backend.build")) {
+            // TODO(mbs): Cleanup hooks.
+            return (*f)(lowered_projected_mod, target).operator runtime::Module();
+          }
+          return build(lowered_projected_mod, target, /*target_host=*/Target(nullptr));
+        });
 
     // Extract all the packed functions.
     for (const auto& var : all_tir_fn_vars) {
@@ -1107,8 +1217,76 @@ TypedPackedFunc<ObjectRef(Array<Expr>)> EvalFunction(IRModule mod, Expr expr, De
   }
 }
 
+NDArray EvalDirect(const Expr& expr, Device device) {
+  static const std::unordered_map<std::string, DirectOp> direct_ops = {
+      {"add", DirectOp::kAdd},
+      {"subtract", DirectOp::kSubtract},
+      {"multiply", DirectOp::kMultiply},
+      {"maximum", DirectOp::kMaximum},
+      {"minimum", DirectOp::kMinimum}};
+  const auto* call_node = expr.as<CallNode>();
+  if (call_node == nullptr || call_node->args.size() != 2 || device.device_type != kDLCPU) {
+    return NDArray();
+  }
+  const auto* op_node = call_node->op.as<OpNode>();
+  auto op_it = op_node == nullptr ? direct_ops.end() : direct_ops.find(op_node->name);
+  if (op_it == direct_ops.end()) {
+    return NDArray();
+  }
+  std::vector<NDArray> args;
+  for (const Expr& arg : call_node->args) {
+    const auto* const_node = AsIgnoringOnDevice<ConstantNode>(arg);
+    if (const_node == nullptr || const_node->data->device.device_type != kDLCPU ||
+        !const_node->data.IsContiguous()) {
+      return NDArray();
+    }
+    args.push_back(const_node->data);
+  }
+  // Only the same shapes and the broadcasts of a scalar, which keep the shape of the other side.
+  const DLTensor* lhs = args[0].operator->();
+  const DLTensor* rhs = args[1].operator->();
+  bool lhs_scalar = lhs->ndim == 0;
+  bool rhs_scalar = rhs->ndim == 0;
+  std::vector<int64_t> lhs_shape(lhs->shape, lhs->shape + lhs->ndim);
+  std::vector<int64_t> rhs_shape(rhs->shape, rhs->shape + rhs->ndim);
+  DataType dtype(lhs->dtype);
+  if (dtype != DataType(rhs->dtype) || dtype.lanes() != 1 ||
+      (!lhs_scalar && !rhs_scalar && lhs_shape != rhs_shape)) {
+    return NDArray();
+  }
+  const std::vector<int64_t>& shape = lhs_scalar ? rhs_shape : lhs_shape;
+  int64_t num_elements = 1;
+  for (int64_t dim : shape) {
+    num_elements *= dim;
+  }
+  if (num_elements > kMaxDirectElements) {
+    return NDArray();
+  }
+  NDArray result = NDArray::Empty(shape, dtype, device);
+  if (dtype == DataType::Float(32)) {
+    DirectBinary<float, float>(op_it->second, lhs->data, lhs_scalar, rhs->data, rhs_scalar,
+                               result->data, num_elements);
+  } else if (dtype == DataType::Float(64)) {
+    DirectBinary<double, double>(op_it->second, lhs->data, lhs_scalar, rhs->data, rhs_scalar,
+                                 result->data, num_elements);
+  } else if (dtype == DataType::Int(32)) {
+    DirectBinary<int32_t, uint32_t>(op_it->second, lhs->data, lhs_scalar, rhs->data, rhs_scalar,
+                                    result->data, num_elements);
+  } else if (dtype == DataType::Int(64)) {
+    DirectBinary<int64_t, uint64_t>(op_it->second, lhs->data, lhs_scalar, rhs->data, rhs_scalar,
+                                    result->data, num_elements);
+  } else {
+    return NDArray();
+  }
+  return result;
+}
+
 ObjectRef Eval(Expr expr, Map<GlobalTypeVar, TypeData> type_definitions,
                std::unordered_set<String> import_set, Device device, Target target) {
+  NDArray direct_result = EvalDirect(expr, device);
+  if (direct_result.defined()) {
+    return std::move(direct_result);
+  }
   ICHECK_EQ(device.device_type, target->kind->device_type);
   TargetMap targets;
   targets.Set(device.device_type, target);
@@ -1133,5 +1311,9 @@ ObjectRef Eval(Expr expr, Map<GlobalTypeVar, TypeData> type_definitions,
 
 TVM_REGISTER_GLOBAL("relay.backend.EvalFunction").set_body_typed(EvalFunction);
 
+TVM_REGISTER_GLOBAL("relay.backend.EvalDirect").set_body_typed([](Expr expr, Device device) {
+  return EvalDirect(expr, device);
+});
+
 }  // namespace relay
 }  // namespace tvm
@@ -22,6 +22,7 @@
 #include <tvm/driver/driver_api.h>
 #include <tvm/ir/attrs.h>
 #include <tvm/ir/function.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/call.h>
@@ -48,6 +49,7 @@
 #include "../op/memory/device_copy.h"
 #include "../transforms/device_aware_visitors.h"
 #include "./te_compiler_cache.h"
+#include "./te_compiler_disk_cache.h"
 #include "./utils.h"
 
 namespace tvm {
@@ -259,6 +261,11 @@ class TECompilerImpl : public TECompilerNode {
             << "for target:" << std::endl
             << key->target->ToDebugString();
     std::lock_guard<std::mutex> lock(mutex_);
+    {
+      // the same primitive functions are looked up again and again
+      With<SHashCacheContext> shash_scope(&shash_cache_);
+      key->Hash();
+    }
     CCacheValue value;
     auto it = cache_.find(key);
     if (it != cache_.end()) {
@@ -303,11 +310,26 @@ class TECompilerImpl : public TECompilerNode {
       return value;
     }
 
+    // The AutoTVM records are digested into the disk cache entries, the auto-scheduler and
+    // meta-schedule ones are not, so it is skipped when they may pick the schedules.
+    std::string cache_dir = TECompilerDiskCache::CurrentDir();
+    bool use_disk_cache = !cache_dir.empty() && !backend::IsAutoSchedulerEnabled() &&
+                          !backend::IsMetaScheduleEnabled() &&
+                          TECompilerDiskCache::DispatchContextDigest().defined();
+    TECompilerDiskCache disk_cache(cache_dir);
+    if (use_disk_cache) {
+      value->cached_func = disk_cache.Load(
+          key, [&](String name) { return String(GetUniqueName(mangle_fn(name), &name_map_)); });
+      if (value->cached_func.defined()) return value;
+    }
+
     // Enforce use the target.
     With<Target> target_scope(key->target);
 
     ICHECK(!value->cached_func.defined());
+    String candidate_name;
     value->cached_func = PrimFuncFor(key->source_func, key->target, [&](std::string name) {
+      candidate_name = name;
       auto mangled = mangle_fn(name);
       return GetUniqueName(mangled, &name_map_);
     });
@@ -340,6 +362,9 @@ class TECompilerImpl : public TECompilerNode {
       ICHECK(value->cached_func->funcs->Lookup(value->cached_func->prim_fn_var)
                  .as<tir::PrimFuncNode>());
     }
+    if (use_disk_cache) {
+      disk_cache.Store(key, candidate_name, value->cached_func);
+    }
     VLOG(1) << "lowered to name:" << std::endl
             << PrettyPrint(value->cached_func->prim_fn_var) << std::endl
             << "with definitions:" << std::endl
@@ -355,6 +380,10 @@ class TECompilerImpl : public TECompilerNode {
             << "for target:" << std::endl
             << key->target->ToDebugString();
     std::lock_guard<std::mutex> lock(mutex_);
+    {
+      With<SHashCacheContext> shash_scope(&shash_cache_);
+      key->Hash();
+    }
     CCacheValue value;
     auto it = shape_func_cache_.find(key);
     if (it != shape_func_cache_.end()) {
@@ -408,6 +437,8 @@ class TECompilerImpl : public TECompilerNode {
   std::unordered_map<CCacheKey, CCacheValue> cache_;
   /*! \brief internal compiler cache for shape funcs */
   std::unordered_map<CCacheKey, CCacheValue> shape_func_cache_;
+  /*! \brief the subtree hashes of the functions, reused by the cache key hashes */
+  SHashCache shash_cache_;
   /*! \brief the cache key of the function that is being lowered currently*/
   CCacheKey cur_ccache_key_;
   /*! \brief Map of GlobalVar to C Device API context names */
@@ -427,6 +458,8 @@ TECompiler& TECompiler::Global() {
 }
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_auto_scheduler", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.measure_implementations", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.implementation_latency_log", String);
 
 TVM_REGISTER_GLOBAL("relay.backend._TECompilerGlobal").set_body_typed([]() {
   return TECompiler::Global();
@@ -602,7 +635,14 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
       call_lowered_attrs->metadata.Set(attr::kReshapeOnly, tvm::Integer(1));
     }
 
-    call_lowered_attrs->metadata.Set("relay_attrs", func->attrs);
+    Array<Integer> in_place_params = opt_compiler ? Array<Integer>() : backend::InPlaceParams(func);
+    if (!in_place_params.empty()) {
+      // The memory planners may then let the result overwrite a parameter dying at the call.
+      call_lowered_attrs->metadata.Set(
+          "relay_attrs", WithAttr(func, attr::kInPlaceParams, in_place_params)->attrs);
+    } else {
+      call_lowered_attrs->metadata.Set("relay_attrs", func->attrs);
+    }
     call_lowered_attrs->metadata.Set("all_prim_fn_vars", all_prim_fn_vars);
 
     if (IsDynamic(func->ret_type)) {
@@ -1112,7 +1152,7 @@ IRModule LowerTE(const IRModule& module, const String& module_name, ProcessFn pr
   updated_module = WithAttrs(updated_module, {{"external_mods", std::move(external_mods)},
                                               {"device_contexts", std::move(device_contexts)}});
 
-  if (backend::IsAutoSchedulerEnabled()) {
+  if (backend::IsAutoSchedulerEnabled() || backend::IsMetaScheduleEnabled()) {
     // Capture all the 'operator weights', ie usage counts for each PrimFunc.
     Map<String, Integer> op_weights =
         module->GetAttr<Map<String, Integer>>("op_weights", Map<String, Integer>()).value();
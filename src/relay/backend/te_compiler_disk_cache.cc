@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relay/backend/te_compiler_disk_cache.cc
+ * \brief A persistent cache of the functions lowered by the TECompiler.
+ */
+#include "./te_compiler_disk_cache.h"
+
+#include <tvm/ir/transform.h>
+#include <tvm/node/serialization.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/registry.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include "../../support/utils.h"
+
+namespace tvm {
+namespace relay {
+namespace tec {
+
+/*! \brief The pass context option naming the directory of the cache. */
+constexpr const char* kCacheDirConfig = "relay.backend.te_compiler_cache_dir";
+
+TVM_REGISTER_PASS_CONFIG_OPTION(kCacheDirConfig, String);
+
+std::string TECompilerDiskCache::CurrentDir() {
+  return transform::PassContext::Current()->GetConfig<String>(kCacheDirConfig, String("")).value();
+}
+
+Optional<String> TECompilerDiskCache::DispatchContextDigest() {
+  const auto* fdigest = runtime::Registry::Get("relay.backend.dispatch_context_digest");
+  if (fdigest == nullptr) return String("");
+  TVMRetValue digest = (*fdigest)();
+  if (digest.type_code() == kTVMNullptr) return NullOpt;
+  return String(digest.operator std::string());
+}
+
+std::string TECompilerDiskCache::Context(const CCacheKey& key) {
+  Optional<String> digest = DispatchContextDigest();
+  ICHECK(digest.defined()) << "The TECompiler cache cannot be used in this dispatch context";
+  transform::PassContext pass_ctx = transform::PassContext::Current();
+  // the location of the cache does not change what is lowered
+  Map<String, ObjectRef> config = pass_ctx->config;
+  config.erase(kCacheDirConfig);
+  std::ostringstream os;
+  os << TVM_VERSION << '\n'
+     << digest.value() << '\n'
+     << SaveJSON(Array<ObjectRef>{key->target, config, Integer(pass_ctx->opt_level),
+                                  pass_ctx->required_pass, pass_ctx->disabled_pass});
+  return os.str();
+}
+
+std::string TECompilerDiskCache::EntryPath(const CCacheKey& key,
+                                           const std::string& context) const {
+  uint64_t hash = StructuralHash()(key->source_func);
+  hash = support::HashCombine(hash, StructuralHash()(String(context)));
+  std::ostringstream os;
+  os << dir_ << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".json";
+  return os.str();
+}
+
+CachedFunc TECompilerDiskCache::Load(const CCacheKey& key,
+                                     const std::function<String(String)>& fname) const {
+  std::string context = Context(key);
+  std::ifstream fs(EntryPath(key, context), std::ios::in | std::ios::binary);
+  if (!fs) return CachedFunc(nullptr);
+  std::string json((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  Map<String, ObjectRef> entry;
+  try {
+    entry = Downcast<Map<String, ObjectRef>>(LoadJSON(json));
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Ignoring the corrupted TECompiler cache entry " << EntryPath(key, context);
+    return CachedFunc(nullptr);
+  }
+  // a different key with the same hash
+  if (Downcast<String>(entry["context"]) != context ||
+      !StructuralEqual()(entry["source_func"], key->source_func)) {
+    return CachedFunc(nullptr);
+  }
+  IRModule funcs = Downcast<IRModule>(entry["funcs"]);
+  ICHECK_EQ(funcs->functions.size(), 1U);
+  tir::PrimFunc prim_func = Downcast<tir::PrimFunc>((*funcs->functions.begin()).second);
+  // the stored name may be taken in this build
+  GlobalVar prim_fn_var(fname(Downcast<String>(entry["name"])));
+  prim_fn_var->checked_type_ = key->source_func->checked_type();
+  prim_func = WithAttr(std::move(prim_func), tvm::attr::kGlobalSymbol, prim_fn_var->name_hint);
+  VLOG(1) << "loaded " << prim_fn_var->name_hint << " from the TECompiler cache";
+  IRModule lowered(Map<GlobalVar, BaseFunc>({{prim_fn_var, prim_func}}));
+  return CachedFunc(key->target, prim_fn_var, {}, {}, te::Schedule{nullptr},
+                    tir::PrimFunc{nullptr}, {}, lowered);
+}
+
+void TECompilerDiskCache::Store(const CCacheKey& key, const String& name,
+                                const CachedFunc& cfunc) const {
+  if (cfunc->funcs->functions.size() != 1 ||
+      !cfunc->funcs->Lookup(cfunc->prim_fn_var).as<tir::PrimFuncNode>()) {
+    return;
+  }
+  std::string context = Context(key);
+  Map<String, ObjectRef> entry{{"context", String(context)},
+                               {"source_func", key->source_func},
+                               {"name", name},
+                               {"funcs", cfunc->funcs}};
+  std::string path = EntryPath(key, context);
+  // write a file of our own then rename it, so that concurrent builds never read a partial entry
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id())
+           << std::chrono::steady_clock::now().time_since_epoch().count();
+  {
+    std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+    if (!fs) {
+      LOG(WARNING) << "Cannot write the TECompiler cache entry " << tmp_path.str();
+      return;
+    }
+    fs << SaveJSON(entry);
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
+}  // namespace tec
+}  // namespace relay
+}  // namespace tvm
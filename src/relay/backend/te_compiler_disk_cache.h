@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relay/backend/te_compiler_disk_cache.h
+ * \brief A persistent cache of the functions lowered by the TECompiler.
+ */
+#ifndef TVM_RELAY_BACKEND_TE_COMPILER_DISK_CACHE_H_
+#define TVM_RELAY_BACKEND_TE_COMPILER_DISK_CACHE_H_
+
+#include <functional>
+#include <string>
+
+#include "./te_compiler_cache.h"
+
+namespace tvm {
+namespace relay {
+namespace tec {
+
+/*!
+ * \brief A persistent cache of the functions lowered by the TECompiler, one file per function
+ *  in a directory shared by the builds.
+ *
+ *  An entry is found by the structural hash of the source function and of the lowering context:
+ *  the target, the pass context configuration, the digest of the AutoTVM dispatch context and
+ *  the TVM version. It is only used when they are all equal to the ones it was stored with.
+ */
+class TECompilerDiskCache {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param dir The existing directory holding the entries.
+   */
+  explicit TECompilerDiskCache(std::string dir) : dir_(std::move(dir)) {}
+  /*!
+   * \brief Load the lowered functions of a key.
+   * \param key The key.
+   * \param fname The function making the name the function was first lowered with unique in
+   *  the current build.
+   * \return The lowered functions, renamed by fname, or nullptr when the key has no entry.
+   */
+  CachedFunc Load(const CCacheKey& key, const std::function<String(String)>& fname) const;
+  /*!
+   * \brief Store the lowered functions of a key, only when they are a single PrimFunc.
+   * \param key The key.
+   * \param name The name the function was lowered with, before it was made unique.
+   * \param cfunc The lowered functions.
+   */
+  void Store(const CCacheKey& key, const String& name, const CachedFunc& cfunc) const;
+  /*! \return The cache directory of the current pass context, empty when it has none. */
+  static std::string CurrentDir();
+  /*!
+   * \return The digest of the configs picked by the AutoTVM dispatch context of the Python
+   *  frontend, empty without it, and nullopt when the context cannot be digested and the cache
+   *  must not be used.
+   */
+  static Optional<String> DispatchContextDigest();
+
+ private:
+  /*! \return The lowering context of key, that an entry must match. */
+  static std::string Context(const CCacheKey& key);
+  /*! \return The path of the entry of a key with the given context. */
+  std::string EntryPath(const CCacheKey& key, const std::string& context) const;
+
+  /*! \brief The directory holding the entries. */
+  std::string dir_;
+};
+
+}  // namespace tec
+}  // namespace relay
+}  // namespace tvm
+
+#endif  // TVM_RELAY_BACKEND_TE_COMPILER_DISK_CACHE_H_
@@ -25,6 +25,7 @@
 #include "utils.h"
 
 #include <tvm/parser/parser.h>
+#include <tvm/relay/op_attr_types.h>
 #include <tvm/relay/qnn/transform.h>
 
 #include "te_compiler.h"
@@ -51,17 +52,27 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
       for (auto bytes : node->storage_sizes_in_bytes) {
         p->stream << bytes << ",";
       }
+      if (!node->storage_offsets_in_bytes.empty()) {
+        p->stream << "], storage_offsets_in_bytes=[";
+        for (auto offset : node->storage_offsets_in_bytes) {
+          p->stream << offset << ",";
+        }
+      }
       p->stream << "])";
     });
 
 StorageInfo::StorageInfo(std::vector<int64_t> storage_ids, std::vector<SEScope> se_scopes,
-                         std::vector<int64_t> storage_sizes_in_bytes) {
+                         std::vector<int64_t> storage_sizes_in_bytes,
+                         std::vector<int64_t> storage_offsets_in_bytes) {
   ICHECK_EQ(storage_ids.size(), se_scopes.size());
   ICHECK_EQ(storage_ids.size(), storage_sizes_in_bytes.size());
+  ICHECK(storage_offsets_in_bytes.empty() ||
+         storage_offsets_in_bytes.size() == storage_ids.size());
   auto node = make_object<StorageInfoNode>();
   node->storage_ids = std::move(storage_ids);
   node->se_scopes = std::move(se_scopes);
   node->storage_sizes_in_bytes = std::move(storage_sizes_in_bytes);
+  node->storage_offsets_in_bytes = std::move(storage_offsets_in_bytes);
   data_ = std::move(node);
 }
 
@@ -112,6 +123,15 @@ TVM_REGISTER_GLOBAL("relay.ir.StorageInfoStorageSizes").set_body_typed([](Storag
   return storage_sizes_in_bytes;
 });
 
+TVM_REGISTER_GLOBAL("relay.ir.StorageInfoStorageOffsets").set_body_typed([](StorageInfo si) {
+  Array<tvm::Integer> storage_offsets_in_bytes;
+  for (size_t i = 0; i < si->storage_ids.size(); ++i) {
+    storage_offsets_in_bytes.push_back(
+        si->storage_offsets_in_bytes.empty() ? 0 : si->storage_offsets_in_bytes[i]);
+  }
+  return storage_offsets_in_bytes;
+});
+
 TVM_REGISTER_NODE_TYPE(StaticMemoryPlanNode);
 
 StaticMemoryPlan::StaticMemoryPlan(Map<Expr, StorageInfo> expr_to_storage_info) {
@@ -151,6 +171,56 @@ int64_t CalculateRelayExprSizeBytes(const Type& expr_type) {
   return element_size * num_of_elements;
 }
 
+Array<Integer> InPlaceParams(const Function& func) {
+  const auto* ret_type = func->body->checked_type_.as<TensorTypeNode>();
+  if (ret_type == nullptr || func->GetAttr<String>(attr::kCompiler)) return {};
+  for (const PrimExpr& dim : ret_type->shape) {
+    if (!dim->IsInstance<IntImmNode>()) return {};
+  }
+  // Check the calls of the body all compute the elements of the result independently.
+  class ElementwiseChecker : public ExprVisitor {
+   public:
+    explicit ElementwiseChecker(const Array<PrimExpr>& shape) : shape_(shape) {}
+    bool elementwise = true;
+
+    void VisitExpr(const Expr& expr) final {
+      if (elementwise) ExprVisitor::VisitExpr(expr);
+    }
+    void VisitExpr_(const CallNode* call) final {
+      static const auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+      const auto* type = call->checked_type_.as<TensorTypeNode>();
+      if (!call->op->IsInstance<OpNode>() ||
+          fpattern.get(Downcast<Op>(call->op), kOpaque) > kBroadcast || type == nullptr ||
+          !StructuralEqual()(type->shape, shape_)) {
+        elementwise = false;
+        return;
+      }
+      for (const Expr& arg : call->args) VisitExpr(arg);
+    }
+    void VisitExpr_(const LetNode* op) final { elementwise = false; }
+    void VisitExpr_(const IfNode* op) final { elementwise = false; }
+    void VisitExpr_(const FunctionNode* op) final { elementwise = false; }
+    void VisitExpr_(const TupleNode* op) final { elementwise = false; }
+    void VisitExpr_(const TupleGetItemNode* op) final { elementwise = false; }
+
+   private:
+    const Array<PrimExpr>& shape_;
+  } checker(ret_type->shape);
+  checker.VisitExpr(func->body);
+  if (!checker.elementwise) return {};
+  Array<Integer> params;
+  for (size_t i = 0; i < func->params.size(); ++i) {
+    const auto* type = func->params[i]->checked_type_.as<TensorTypeNode>();
+    if (type != nullptr && type->dtype == ret_type->dtype &&
+        StructuralEqual()(type->shape, ret_type->shape)) {
+      params.push_back(static_cast<int>(i));
+    }
+  }
+  return params;
+}
+
+TVM_REGISTER_GLOBAL("relay.backend.InPlaceParams").set_body_typed(InPlaceParams);
+
 TVM_REGISTER_NODE_TYPE(FunctionInfoNode);
 
 FunctionInfo::FunctionInfo(Map<Target, Integer> workspace_sizes, Map<Target, Integer> io_sizes,
@@ -273,6 +343,18 @@ void UpdateAutoSchedulerOpWeights(const IRModule& module) {
   (*te_compiler_update_weights)(weight_map);
 }
 
+void UpdateMetaScheduleTaskWeights(const IRModule& module) {
+  const auto* f_update_weights =
+      runtime::Registry::Get("meta_schedule.TaskExtractionUpdateWeightsInsideWithScope");
+  ICHECK(f_update_weights != nullptr)
+      << "meta_schedule.TaskExtractionUpdateWeightsInsideWithScope is not registered";
+
+  Map<String, Integer> weight_map =
+      module->GetAttr<Map<String, Integer>>("op_weights", Map<String, Integer>()).value();
+
+  (*f_update_weights)(weight_map);
+}
+
 }  // namespace backend
 }  // namespace relay
 }  // namespace tvm
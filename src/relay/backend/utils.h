@@ -66,6 +66,11 @@ class StorageInfoNode : public Object {
   std::vector<SEScope> se_scopes;
   /* \brief The sizes of each storage element, in bytes. */
   std::vector<int64_t> storage_sizes_in_bytes;
+  /*!
+   * \brief The byte offset of each storage element within its storage, when several elements
+   * are placed in one storage. Empty if all the offsets are zero.
+   */
+  std::vector<int64_t> storage_offsets_in_bytes;
 
   // TODO(@jroesch): expose the fields
   void VisitAttrs(AttrVisitor* v) {}
@@ -78,7 +83,8 @@ class StorageInfoNode : public Object {
 class StorageInfo : public ObjectRef {
  public:
   StorageInfo(std::vector<int64_t> storage_ids, std::vector<SEScope> se_scopes,
-              std::vector<int64_t> storage_sizes_in_bytes);
+              std::vector<int64_t> storage_sizes_in_bytes,
+              std::vector<int64_t> storage_offsets_in_bytes = {});
   TVM_DEFINE_OBJECT_REF_METHODS(StorageInfo, ObjectRef, StorageInfoNode);
 };
 
@@ -108,6 +114,8 @@ struct FunctionInfoNode : public Object {
   Map<Target, Integer> constant_sizes;
   Map<Target, tir::PrimFunc> tir_primfuncs;
   Map<Target, Function> relay_primfuncs;
+  /*! \brief The size of each workspace pool given by the caller, see tir.usmp.enable. */
+  Map<String, Integer> workspace_pool_sizes;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("workspace_sizes", &workspace_sizes);
@@ -115,6 +123,7 @@ struct FunctionInfoNode : public Object {
     v->Visit("constant_sizes", &constant_sizes);
     v->Visit("tir_primfuncs", &tir_primfuncs);
     v->Visit("relay_primfuncs", &relay_primfuncs);
+    v->Visit("workspace_pool_sizes", &workspace_pool_sizes);
   }
 
   static constexpr const char* _type_key = "relay.backend.FunctionInfo";
@@ -137,6 +146,20 @@ class FunctionInfo : public ObjectRef {
  */
 int64_t CalculateRelayExprSizeBytes(const Type& expr_type);
 
+/*!
+ * \brief Find the parameters of a primitive function its result may be written over.
+ *
+ * The result may share its memory with a parameter when every call of the function body is
+ * an elementwise or a broadcast operator computing a tensor of the static shape of the result,
+ * so that each element of the result only reads the elements of the same index of the
+ * parameters of that shape, before it is written. The parameter must also have the dtype of
+ * the result.
+ *
+ * \param func The primitive function, whose body is type checked.
+ * \return The indices of the parameters, empty when there is none.
+ */
+Array<Integer> InPlaceParams(const Function& func);
+
 /*!
  *  \brief Executor generator artifacts. Those artifacts  are subsequently
  *  used by the relay build process.
@@ -510,6 +533,13 @@ Map<Target, IRModule> TargetStrModuleMapToTargetModuleMap(
  */
 void UpdateAutoSchedulerOpWeights(const IRModule& module);
 
+/*!
+ * \brief Communicate the op weights seen during Relay module lowering back to the meta schedule
+ * task extraction, if it is the current meta schedule context.
+ * \param IRModule after lowering by LowerTEPass.
+ */
+void UpdateMetaScheduleTaskWeights(const IRModule& module);
+
 }  // namespace backend
 }  // namespace relay
 }  // namespace tvm
@@ -59,6 +59,14 @@
 namespace tvm {
 namespace relay {
 
+/*!
+ * \brief Whether the VM compiler shares the statically sized storages of the functions, see
+ * transform::PlanStaticStorage.
+ */
+constexpr const char* kPlanStaticStorageConfig = "relay.vm.plan_static_storage";
+
+TVM_REGISTER_PASS_CONFIG_OPTION(kPlanStaticStorageConfig, Bool);
+
 namespace transform {
 
 Pass LambdaLift();
@@ -947,6 +955,9 @@ void VMCompiler::Lower(IRModule mod, TargetMap targets, tvm::Target target_host)
   if (backend::IsAutoSchedulerEnabled()) {
     backend::UpdateAutoSchedulerOpWeights(context_.module);
   }
+  if (backend::IsMetaScheduleEnabled()) {
+    backend::UpdateMetaScheduleTaskWeights(context_.module);
+  }
 }
 
 transform::Sequential VMCompiler::MemoryOpt(const SEScope& host_se_scope) {
@@ -975,6 +986,11 @@ transform::Sequential VMCompiler::MemoryOpt(const SEScope& host_se_scope) {
   // // Perform memory planning in order to coalesce/reduce allocations.
   // pass_seqs.push_back(transform::MemoryPlan());
 
+  // Share the storages of a static size with disjoint lifetimes.
+  if (PassContext::Current()->GetConfig<Bool>(kPlanStaticStorageConfig, Bool(false)).value()) {
+    pass_seqs.push_back(transform::PlanStaticStorage());
+  }
+
   // Compute away constant computation introduced by coalescing allocations.
   pass_seqs.push_back(transform::FoldConstant());
 
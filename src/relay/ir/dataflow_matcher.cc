@@ -38,9 +38,29 @@ namespace relay {
 bool DFPatternMatcher::Match(const DFPattern& pattern, const Expr& expr) {
   memo_.clear();
   matched_nodes_.clear();
+  if (!pattern.same_as(indexed_pattern_)) {
+    IndexPattern(pattern);
+  }
   return VisitDFPattern(pattern, expr);
 }
 
+void DFPatternMatcher::IndexPattern(const DFPattern& pattern) {
+  indexed_pattern_ = pattern;
+  context_free_.clear();
+  auto pattern_graph = CreateIndexedGraph(pattern);
+  // The inputs come first in the topological order.
+  for (const auto& node : pattern_graph.topological_order_) {
+    if (node->ref_.as<DominatorPatternNode>()) continue;
+    bool context_free = true;
+    for (const auto* input : node->inputs_) {
+      context_free &= input->outputs_.size() <= 1 && context_free_.count(input->ref_.get()) != 0;
+    }
+    if (context_free) {
+      context_free_.insert(node->ref_.get());
+    }
+  }
+}
+
 void DFPatternMatcher::ClearMap(size_t watermark) {
   for (size_t i = watermark; i < matched_nodes_.size(); ++i) {
     memo_.erase(matched_nodes_[i]);
@@ -53,6 +73,15 @@ bool DFPatternMatcher::VisitDFPattern(const DFPattern& pattern, const Expr& expr
     ICHECK_EQ(memo_[pattern].size(), 1);
     return expr.same_as(memo_[pattern][0]);
   } else {
+    // The result of a pattern whose sub-patterns have no other user does not depend on what
+    // the rest of the pattern matched, so its mismatches are kept across the matches.
+    bool context_free = memoize_ && context_free_.count(pattern.get()) != 0;
+    if (context_free) {
+      auto it = mismatches_.find(pattern.get());
+      if (it != mismatches_.end() && it->second.count(expr.get()) != 0) {
+        return false;
+      }
+    }
     auto watermark = matched_nodes_.size();
     auto out = DFPatternFunctor::VisitDFPattern(pattern, expr);
     if (out) {
@@ -60,6 +89,9 @@ bool DFPatternMatcher::VisitDFPattern(const DFPattern& pattern, const Expr& expr
       matched_nodes_.push_back(pattern);
     } else {
       ClearMap(watermark);
+      if (context_free) {
+        mismatches_[pattern.get()].insert(expr.get());
+      }
     }
     return out;
   }
@@ -580,8 +612,57 @@ const std::unordered_map<int, PatternGrouper::Group>& PatternGrouper::GroupMatch
   return this->groups_;
 }
 
+/*!
+ * \brief Collect the operators the calls the pattern can match start with.
+ * \return False when the pattern can match other expressions than the calls of operators.
+ */
+bool CollectRootOps(const DFPattern& pattern, std::unordered_set<const Object*>* ops) {
+  if (const auto* alt = pattern.as<AltPatternNode>()) {
+    return CollectRootOps(alt->left, ops) && CollectRootOps(alt->right, ops);
+  } else if (const auto* attr = pattern.as<AttrPatternNode>()) {
+    return CollectRootOps(attr->pattern, ops);
+  } else if (const auto* type = pattern.as<TypePatternNode>()) {
+    return CollectRootOps(type->pattern, ops);
+  } else if (const auto* shape = pattern.as<ShapePatternNode>()) {
+    return CollectRootOps(shape->pattern, ops);
+  } else if (const auto* dtype = pattern.as<DataTypePatternNode>()) {
+    return CollectRootOps(dtype->pattern, ops);
+  } else if (const auto* dominator = pattern.as<DominatorPatternNode>()) {
+    return CollectRootOps(dominator->child, ops);
+  } else if (const auto* call = pattern.as<CallPatternNode>()) {
+    std::vector<DFPattern> op_patterns = {call->op};
+    while (!op_patterns.empty()) {
+      DFPattern op_pattern = op_patterns.back();
+      op_patterns.pop_back();
+      if (const auto* alt = op_pattern.as<AltPatternNode>()) {
+        op_patterns.push_back(alt->left);
+        op_patterns.push_back(alt->right);
+        continue;
+      }
+      const auto* expr_pattern = op_pattern.as<ExprPatternNode>();
+      const auto* op = expr_pattern ? expr_pattern->expr.as<OpNode>() : nullptr;
+      if (op == nullptr) return false;
+      ops->insert(op);
+      // the matcher associates multiply and divide
+      if (op->name == "multiply" || op->name == "divide") {
+        ops->insert(Op::Get(op->name == "multiply" ? "divide" : "multiply").get());
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
 void PatternGrouper::VisitExprs() {
   std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> pre_partitioned;
+  // Only the calls of the root operators of the pattern are tried, when it has some.
+  std::unordered_set<const Object*> root_ops;
+  bool has_root_ops = CollectRootOps(pattern_, &root_ops);
+  auto is_candidate = [&](const Expr& expr) {
+    if (!has_root_ops) return true;
+    const auto* call = expr.as<CallNode>();
+    return call != nullptr && root_ops.count(call->op.get()) != 0;
+  };
   for (size_t i = matcher_->expr_graph_.topological_order_.size(); i != 0; --i) {
     size_t index = i - 1;
     Expr current = matcher_->expr_graph_.topological_order_.at(index)->ref_;
@@ -593,7 +674,8 @@ void PatternGrouper::VisitExprs() {
                          [&pre_partitioned](const Expr& expr) { pre_partitioned.insert(expr); });
         }
       }
-      if (pre_partitioned.count(current) == 0 && matcher_->Match(pattern_, current)) {
+      if (pre_partitioned.count(current) == 0 && is_candidate(current) &&
+          matcher_->Match(pattern_, current)) {
         CreateGroup(current);
       }
     }
@@ -30,6 +30,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "indexed_graph.h"
@@ -66,10 +67,17 @@ class DFPatternMatcher : public DFPatternFunctor<bool(const DFPattern&, const Ex
   void ClearMap(size_t watermark);
   bool MatchesPath(const DominatorPatternNode* op, const Expr& expr);
   bool DominatesParent(const DominatorPatternNode* op, const Expr& expr);
+  /*! \brief Find the sub-patterns of the matched pattern whose results can be memoized. */
+  void IndexPattern(const DFPattern& pattern);
 
   std::unordered_map<DFPattern, Array<Expr>, ObjectPtrHash, ObjectPtrEqual> memo_;
   std::vector<DFPattern> matched_nodes_;
   bool memoize_ = true;
+  /*! \brief The pattern last matched, and its sub-patterns no other sub-pattern shares. */
+  DFPattern indexed_pattern_;
+  std::unordered_set<const Object*> context_free_;
+  /*! \brief The expressions each context free pattern failed to match. */
+  std::unordered_map<const Object*, std::unordered_set<const Object*>> mismatches_;
 };
 
 /*!
@@ -44,6 +44,7 @@ MixedModeVisitor::MixedModeVisitor(int visit_limit) {
 }
 
 void MixedModeVisitor::VisitLeaf(const Expr& expr) {
+  // the visit may insert into visit_counter_, which invalidates the iterators.
   if (visit_counter_[expr.get()] < visit_limit_) {
     ExprFunctor::VisitExpr(expr);
   }
@@ -51,10 +52,11 @@ void MixedModeVisitor::VisitLeaf(const Expr& expr) {
 }
 
 bool MixedModeVisitor::CheckVisited(const Expr& expr) {
-  if (visit_counter_[expr.get()] < visit_limit_) {
+  size_t& count = visit_counter_[expr.get()];
+  if (count < visit_limit_) {
     return false;
   } else {
-    visit_counter_[expr.get()]++;
+    count++;
     return true;
   }
 }
@@ -83,24 +85,19 @@ void MixedModeMutator::VisitLeaf(const Expr& expr) {
   }
 }
 
-bool MixedModeMutator::CheckVisited(const Expr& expr) {
-  if (memo_.count(expr)) {
-    return true;
-  } else {
-    return false;
-  }
-}
+bool MixedModeMutator::CheckVisited(const Expr& expr) { return memo_.count(expr) != 0; }
 
 Expr MixedModeMutator::DispatchVisitExpr(const Expr& expr) { return ExprMutator::VisitExpr(expr); }
 
 Expr MixedModeMutator::VisitExpr(const Expr& expr) {
   auto fcheck_visited = [this](const Expr& expr) { return this->CheckVisited(expr); };
   auto fvisit_leaf = [this](const Expr& expr) { return this->VisitLeaf(expr); };
-  if (memo_.count(expr)) {
-    return memo_[expr];
+  auto it = memo_.find(expr);
+  if (it != memo_.end()) {
+    return it->second;
   } else {
     ExpandDataflow(expr, fcheck_visited, fvisit_leaf);
-    return memo_[expr];
+    return memo_.at(expr);
   }
 }
 
@@ -26,12 +26,79 @@
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/registry.h>
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 namespace tvm {
 namespace relay {
 namespace transform {
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.fallback_device_type", IntImm);
 
+/*!
+ * \brief The names of the idempotent function passes that skip the functions they already
+ *  processed.
+ *
+ *  Such a pass must give the same result when run on its own output, and must not depend on
+ *  the other functions of the module nor on the configs changed in between.
+ */
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FunctionPass.skip_unchanged", Array<String>);
+
+/*!
+ * \brief The functions produced by each idempotent function pass, after the InferType which
+ *  follows it.
+ *
+ *  The IR is immutable, so a function which is still the same object has not changed since
+ *  the pass produced it, and running the pass on it again would give it back. The table holds
+ *  the functions alive, so it drops the ones nothing else refers to.
+ */
+class ProcessedFunctionTable {
+ public:
+  static ProcessedFunctionTable* Global() {
+    static ProcessedFunctionTable* inst = new ProcessedFunctionTable();
+    return inst;
+  }
+
+  /*! \brief Check whether a function was produced by a pass. */
+  bool IsProcessed(const std::string& pass_name, const FunctionNode* func) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = table_.find(pass_name);
+    return it != table_.end() && it->second.count(func) != 0;
+  }
+
+  /*! \brief Record the functions of a module produced by a pass. */
+  void Add(const std::string& pass_name, const IRModule& mod) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& funcs = table_[pass_name];
+    Sweep(&funcs);
+    for (const auto& kv : mod->functions) {
+      if (const auto* func = kv.second.as<FunctionNode>()) {
+        if (funcs.size() >= kMaxEntries) funcs.clear();
+        funcs.emplace(func, GetRef<Function>(func));
+      }
+    }
+  }
+
+ private:
+  using FunctionSet = std::unordered_map<const FunctionNode*, Function>;
+
+  // Forget the functions only the table refers to.
+  static void Sweep(FunctionSet* funcs) {
+    for (auto it = funcs->begin(); it != funcs->end();) {
+      if (it->second.use_count() == 1) {
+        it = funcs->erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  static constexpr size_t kMaxEntries = 4096;
+  std::mutex mutex_;
+  std::unordered_map<std::string, FunctionSet> table_;
+};
+
 class FunctionPass;
 
 /*!
@@ -126,10 +193,22 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
 
   IRModule updated_mod = mod->ShallowCopy();
 
+  bool skip_unchanged = false;
+  for (const String& name : pass_ctx->GetConfig<Array<String>>("relay.FunctionPass.skip_unchanged",
+                                                               Array<String>())
+                                .value()) {
+    skip_unchanged |= name == pass_info->name;
+  }
+  ProcessedFunctionTable* processed = ProcessedFunctionTable::Global();
+
   std::vector<std::pair<GlobalVar, Function> > updates;
   for (const auto& kv : updated_mod->functions) {
     // only process optimizable Relay Functions
     if (const auto* function_node = AsOptimizableFunctionNode(kv.second)) {
+      if (skip_unchanged && processed->IsProcessed(pass_info->name, function_node)) {
+        VLOG(1) << "Skipping the unchanged function " << kv.first->name_hint;
+        continue;
+      }
       Function updated_func = pass_func(GetRef<Function>(function_node), updated_mod, pass_ctx);
       updates.push_back({kv.first, std::move(updated_func)});
     }
@@ -149,7 +228,9 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
 
   // TODO(@jroesch): move away from eager type checking for performance reasons
   // make issue.
-  return transform::InferType()(updated_mod);
+  IRModule typed_mod = transform::InferType()(updated_mod);
+  if (skip_unchanged) processed->Add(pass_info->name, typed_mod);
+  return typed_mod;
 }
 
 Pass CreateFunctionPass(
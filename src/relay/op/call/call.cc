@@ -132,5 +132,13 @@ bool IsReshapeOnly(const CallLoweredProps& props) {
   return false;
 }
 
+Array<Integer> InPlaceArguments(const CallLoweredProps& props) {
+  if (props.attrs.metadata.count("relay_attrs")) {
+    auto dict_attrs = Downcast<DictAttrs>(props.attrs.metadata["relay_attrs"]);
+    return dict_attrs.GetAttr<Array<Integer>>(attr::kInPlaceParams).value_or(Array<Integer>());
+  }
+  return {};
+}
+
 }  // namespace relay
 }  // namespace tvm
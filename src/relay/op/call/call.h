@@ -80,6 +80,12 @@ Call GetAnyCall(const CallNode* call_node);
  */
 bool IsReshapeOnly(const CallLoweredProps& props);
 
+/*!
+ * \brief Returns the indices of the arguments of the lowered call described by \p props its
+ * result may overwrite, see backend::InPlaceParams.
+ */
+Array<Integer> InPlaceArguments(const CallLoweredProps& props);
+
 }  // namespace relay
 }  // namespace tvm
 
@@ -263,7 +263,8 @@ bool DensePackRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
   ICHECK(param != nullptr);
 
   ICHECK_EQ(data->shape.size(), 2) << "Only 2D data is supported";
-  ICHECK_EQ(weight->shape.size(), 3) << "Weight is not packed";
+  // The weight packed for the int8 dot product instructions also blocks the reduction axis.
+  ICHECK(weight->shape.size() == 3 || weight->shape.size() == 4) << "Weight is not packed";
 
   Array<tvm::PrimExpr> oshape = data->shape;
   oshape.Set(1, weight->shape[0] * weight->shape[2]);
@@ -298,14 +299,15 @@ RELAY_REGISTER_OP("nn.contrib_dense_pack")
     .describe(R"code(Applies a linear transformation: :math:`Y = XW^T`.
 
 - **data**: `(batch, input_dim)`
-- **weight**: `(units // pack_weight_tile, input_dim, pack_weight_tile)`
+- **weight**: `(units // pack_weight_tile, input_dim, pack_weight_tile)`, or
+  `(units // pack_weight_tile, input_dim // pack_k, pack_weight_tile, pack_k)`
 - **out**: `(batch, units)`.
 
 )code" TVM_ADD_FILELINE)
     .set_attrs_type<DenseAttrs>()
     .set_num_inputs(2)
     .add_argument("data", "2D Tensor", "Input data.")
-    .add_argument("weight", "3D Tensor", "Packed weight matrix.")
+    .add_argument("weight", "3D or 4D Tensor", "Packed weight matrix.")
     .set_support_level(10)
     .set_attr<FInferCorrectLayout>("FInferCorrectLayout", DensePackInferCorrectLayout)
     .add_type_rel("DensePack", DensePackRel);
@@ -1028,6 +1030,143 @@ Both `tensor_a` and `tensor_b` can be transposed. For legacy reason, we use NT f
     .add_type_rel("BatchMatmul", BatchMatmulRel<BatchMatmulAttrs>);
 // ------------------- relay.nn.batch_matmul
 
+// ------------------- relay.nn.fused_attention
+TVM_REGISTER_NODE_TYPE(FusedAttentionAttrs);
+
+bool FusedAttentionRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
+                       const TypeReporter& reporter) {
+  ICHECK_EQ(types.size(), 4);
+  const auto* query = types[0].as<TensorTypeNode>();
+  const auto* key = types[1].as<TensorTypeNode>();
+  const auto* value = types[2].as<TensorTypeNode>();
+  if (query == nullptr || key == nullptr || value == nullptr) return false;
+  ICHECK(query->shape.size() == 3 && key->shape.size() == 3 && value->shape.size() == 3)
+      << "FusedAttention: expects 3D query, key and value, but got query shape="
+      << query->shape << ", key shape=" << key->shape << ", value shape=" << value->shape;
+  ICHECK(reporter->AssertEQ(query->shape[0], key->shape[0]) &&
+         reporter->AssertEQ(query->shape[0], value->shape[0]))
+      << "FusedAttention: batch dimensions don't match, query shape=" << query->shape
+      << ", key shape=" << key->shape << ", value shape=" << value->shape;
+  ICHECK(reporter->AssertEQ(query->shape[2], key->shape[2]))
+      << "FusedAttention: query and key dimensions don't match, query shape=" << query->shape
+      << ", key shape=" << key->shape;
+  ICHECK(reporter->AssertEQ(key->shape[1], value->shape[1]))
+      << "FusedAttention: key and value lengths don't match, key shape=" << key->shape
+      << ", value shape=" << value->shape;
+  reporter->Assign(types[3], TensorType({query->shape[0], query->shape[1], value->shape[2]},
+                                        query->dtype));
+  return true;
+}
+
+// Positional relay function to create fused_attention operator used by frontend FFI.
+Expr MakeFusedAttention(Expr query, Expr key, Expr value, double scale) {
+  auto attrs = make_object<FusedAttentionAttrs>();
+  attrs->scale = scale;
+  static const Op& op = Op::Get("nn.fused_attention");
+  return Call(op, {query, key, value}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relay.op.nn._make.fused_attention").set_body_typed(MakeFusedAttention);
+
+RELAY_REGISTER_OP("nn.fused_attention")
+    .describe(R"code(Compute scaled dot product attention in one operator.
+
+.. math::
+
+  fused\_attention(Q, K, V)[i, :, :] = softmax(scale * Q[i, :, :] K[i, :, :]^T) V[i, :, :]
+
+The heads of a multi-head attention are folded into the batch dimension. The
+implementations go through the keys by blocks with an online softmax, so the
+`(b, m, n)` attention matrix is never materialized.
+
+- **query**: `(b, m, d)`
+- **key**: `(b, n, d)`
+- **value**: `(b, n, dv)`
+- **out**: `(b, m, dv)`.
+
+)code" TVM_ADD_FILELINE)
+    .set_num_inputs(3)
+    .set_attrs_type<FusedAttentionAttrs>()
+    .add_argument("query", "3D Tensor", "The queries.")
+    .add_argument("key", "3D Tensor", "The keys.")
+    .add_argument("value", "3D Tensor", "The values.")
+    .set_support_level(10)
+    .add_type_rel("FusedAttention", FusedAttentionRel);
+// ------------------- relay.nn.fused_attention
+
+// ------------------- relay.nn.weight_only_dense
+TVM_REGISTER_NODE_TYPE(WeightOnlyDenseAttrs);
+
+bool WeightOnlyDenseRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
+                        const TypeReporter& reporter) {
+  ICHECK_EQ(types.size(), 4);
+  const auto* data = types[0].as<TensorTypeNode>();
+  const auto* weight = types[1].as<TensorTypeNode>();
+  const auto* scales = types[2].as<TensorTypeNode>();
+  if (data == nullptr || weight == nullptr || scales == nullptr) return false;
+  const auto* param = attrs.as<WeightOnlyDenseAttrs>();
+  ICHECK(param != nullptr);
+  ICHECK(param->bits == 4 || param->bits == 8)
+      << "WeightOnlyDense: expects 4 or 8 bit weights, but got " << param->bits;
+  ICHECK_GT(param->group_size, 0) << "WeightOnlyDense: the group size must be positive";
+  ICHECK(data->shape.size() == 2 && weight->shape.size() == 2 && scales->shape.size() == 2)
+      << "WeightOnlyDense: expects 2D data, weight and scales, but got data shape="
+      << data->shape << ", weight shape=" << weight->shape << ", scales shape=" << scales->shape;
+  DataType weight_dtype = param->bits == 8 ? DataType::Int(8) : DataType::UInt(8);
+  ICHECK(weight->dtype == weight_dtype)
+      << "WeightOnlyDense: expects " << weight_dtype << " weights with " << param->bits
+      << " bits, but got " << weight->dtype;
+  PrimExpr in_dim = data->shape[1];
+  ICHECK(reporter->AssertEQ(weight->shape[1] * (8 / param->bits), in_dim))
+      << "WeightOnlyDense: the packed weight shape=" << weight->shape
+      << " doesn't match the data shape=" << data->shape;
+  ICHECK(reporter->AssertEQ(scales->shape[0], weight->shape[0]) &&
+         reporter->AssertEQ(scales->shape[1] * param->group_size, in_dim))
+      << "WeightOnlyDense: the scales shape=" << scales->shape << " doesn't match "
+      << param->group_size << " inputs per group of the data shape=" << data->shape;
+  DataType out_dtype = param->out_dtype;
+  if (out_dtype.bits() == 0) {
+    out_dtype = data->dtype;
+  }
+  reporter->Assign(types[3], TensorType({data->shape[0], weight->shape[0]}, out_dtype));
+  return true;
+}
+
+// Positional relay function to create weight_only_dense operator used by frontend FFI.
+Expr MakeWeightOnlyDense(Expr data, Expr weight, Expr scales, int bits, int group_size,
+                         DataType out_dtype) {
+  auto attrs = make_object<WeightOnlyDenseAttrs>();
+  attrs->bits = bits;
+  attrs->group_size = group_size;
+  attrs->out_dtype = out_dtype;
+  static const Op& op = Op::Get("nn.weight_only_dense");
+  return Call(op, {data, weight, scales}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relay.op.nn._make.weight_only_dense").set_body_typed(MakeWeightOnlyDense);
+
+RELAY_REGISTER_OP("nn.weight_only_dense")
+    .describe(R"code(Applies a linear transformation with quantized weights: :math:`Y = XW^T`.
+
+The weights are quantized to 4 or 8 bit integers, each group of `group_size` inputs
+of an output sharing a scale, and are dequantized inside the reduction.
+
+- **data**: `(batch, input_dim)`
+- **weight**: `(units, input_dim)` int8 for 8 bits, `(units, input_dim / 2)` uint8 for
+  4 bits, the even inputs in the low halves of the bytes, biased by 8
+- **scales**: `(units, input_dim / group_size)`
+- **out**: `(batch, units)`.
+
+)code" TVM_ADD_FILELINE)
+    .set_num_inputs(3)
+    .set_attrs_type<WeightOnlyDenseAttrs>()
+    .add_argument("data", "2D Tensor", "Input data.")
+    .add_argument("weight", "2D Tensor", "Packed quantized weights.")
+    .add_argument("scales", "2D Tensor", "The scales of the weight groups.")
+    .set_support_level(10)
+    .add_type_rel("WeightOnlyDense", WeightOnlyDenseRel);
+// ------------------- relay.nn.weight_only_dense
+
 // relay.nn.cross_entropy
 bool CrossEntropyRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
                      const TypeReporter& reporter) {
@@ -119,6 +119,44 @@ Expr DenseFourthTerm(const Expr& input_zero_point, const Expr& kernel_zero_point
   return Multiply(Multiply(input_zero_point, kernel_zero_point), reduction_dim);
 }
 
+/*
+ * \brief Compute Term4 - Term3 of a constant weight at compile time.
+ * \param kernel The constant weight, of shape (units, input_dim).
+ * \param input_zero_point_int The input zero point.
+ * \param kernel_zero_point The constant weight zero point, a scalar or one per unit.
+ * \return The constant term, one int32 per unit.
+ */
+Expr DenseConstantTerm(const ConstantNode* kernel, int input_zero_point_int,
+                       const ConstantNode* kernel_zero_point) {
+  runtime::NDArray weight = kernel->data;
+  ICHECK_EQ(weight->ndim, 2);
+  ICHECK(weight->device.device_type == kDLCPU);
+  DataType dtype = weight.DataType();
+  ICHECK(dtype == DataType::Int(8) || dtype == DataType::UInt(8))
+      << "qnn.dense: the weight should be int8 or uint8, got " << dtype;
+  int64_t units = weight->shape[0], input_dim = weight->shape[1];
+  runtime::NDArray zero_point = kernel_zero_point->data;
+  ICHECK(zero_point.DataType() == DataType::Int(32));
+  int64_t num_zero_points = runtime::GetDataSize(*zero_point.operator->()) / sizeof(int32_t);
+  ICHECK(num_zero_points == 1 || num_zero_points == units)
+      << "qnn.dense: expect 1 or " << units << " weight zero points, got " << num_zero_points;
+  const int32_t* zero_point_data = static_cast<const int32_t*>(zero_point->data);
+
+  runtime::NDArray term = runtime::NDArray::Empty({units}, DataType::Int(32), {kDLCPU, 0});
+  int32_t* term_data = static_cast<int32_t*>(term->data);
+  for (int64_t n = 0; n < units; ++n) {
+    int32_t sum = 0;
+    for (int64_t k = 0; k < input_dim; ++k) {
+      int64_t index = n * input_dim + k;
+      sum += dtype.is_int() ? static_cast<const int8_t*>(weight->data)[index]
+                            : static_cast<const uint8_t*>(weight->data)[index];
+    }
+    int32_t zp = zero_point_data[num_zero_points == 1 ? 0 : n];
+    term_data[n] = input_zero_point_int * (zp * static_cast<int32_t>(input_dim) - sum);
+  }
+  return Constant(term);
+}
+
 Expr DenseCombineTerms(const Expr& term1, const Expr& term2, const Expr& term3, const Expr& term4) {
   auto data_term = Subtract(term1, term2);
   // Putting constant terms together, so that constant folding can fold it.
@@ -176,6 +214,21 @@ Expr QnnDenseCanonicalize(const Attrs& attrs, const Array<Expr>& new_args,
   auto term2 = DenseSecondTerm(quantized_data, kernel_zero_point, out_dim_size);
   auto term3 = DenseThirdTerm(quantized_kernel, input_zero_point);
 
+  // With a constant weight, Term3 and Term4 are computed here rather than left to constant
+  // folding, which would compile and run the reduction over the whole weight.
+  const auto* kernel = quantized_kernel.as<ConstantNode>();
+  const auto* kernel_zero_point_const = kernel_zero_point.as<ConstantNode>();
+  if (kernel && kernel_zero_point_const && IsConstScalar(input_zero_point)) {
+    auto input_zero_point_int = GetScalarFromConstant<int>(input_zero_point);
+    if (input_zero_point_int != 0) {
+      bool kernel_zero_point_is_zero = IsConstScalar(kernel_zero_point) &&
+                                       GetScalarFromConstant<int>(kernel_zero_point) == 0;
+      auto data_term = kernel_zero_point_is_zero ? term1 : Subtract(term1, term2);
+      return Add(data_term,
+                 DenseConstantTerm(kernel, input_zero_point_int, kernel_zero_point_const));
+    }
+  }
+
   // Extract the integer zero points.
 
   if (!IsConstScalar(input_zero_point) || !IsConstScalar(kernel_zero_point)) {
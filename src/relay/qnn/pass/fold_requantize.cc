@@ -0,0 +1,211 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relay/qnn/pass/fold_requantize.cc
+ * \brief Merge the chains of QNN requantization ops.
+ */
+
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/qnn/attrs.h>
+#include <tvm/relay/qnn/transform.h>
+
+#include <cmath>
+
+#include "../../transforms/pattern_utils.h"
+
+namespace tvm {
+namespace relay {
+namespace qnn {
+
+/*! \brief The scalar quantization parameters of a tensor. */
+struct QParams {
+  float scale;
+  int zero_point;
+  DataType dtype;
+
+  /*! \brief The range of real values representable with these parameters. */
+  std::pair<double, double> RealRange() const {
+    double qmin = dtype.is_uint() ? 0 : -std::ldexp(1.0, dtype.bits() - 1);
+    double qmax = dtype.is_uint() ? std::ldexp(1.0, dtype.bits()) - 1
+                                  : std::ldexp(1.0, dtype.bits() - 1) - 1;
+    return {(qmin - zero_point) * scale, (qmax - zero_point) * scale};
+  }
+};
+
+bool GetQParams(const Expr& scale, const Expr& zero_point, DataType dtype, QParams* params) {
+  if (!IsConstScalar(scale) || !IsConstScalar(zero_point)) return false;
+  if (scale->checked_type_.defined() &&
+      !(Downcast<TensorType>(scale->checked_type())->dtype == DataType::Float(32))) {
+    return false;
+  }
+  params->scale = GetScalarFromConstant<float>(scale);
+  params->zero_point = GetScalarFromConstant<int>(zero_point);
+  params->dtype = dtype;
+  return true;
+}
+
+/*!
+ * \brief Merge requantize and quantize ops into the requantize ops producing their input.
+ *
+ *  The chains handled, with scalar constant quantization parameters, are
+ *
+ *    requantize(requantize(x, s1, z1, s2, z2), s2, z2, s3, z3) -> requantize(x, s1, z1, s3, z3)
+ *    quantize(dequantize(x, s1, z1), s2, z2) -> requantize(x, s1, z1, s2, z2)
+ *    dequantize(requantize(x, s1, z1, s2, z2, int32), s2, z2) -> dequantize(x, s1, z1)
+ *    requantize(x, s, z, s, z) of the dtype of x -> x
+ *
+ *  so that each chain is lowered to a single fixed point multiply. A requantize to a narrow
+ *  dtype is only merged when its clipping is implied by the clipping of the outer one, the
+ *  result only differs from the chain by the intermediate rounding it no longer does.
+ */
+class RequantizeFolder : public MixedModeMutator {
+ protected:
+  using MixedModeMutator::VisitExpr_;
+
+  Expr Rewrite_(const CallNode* pre, const Expr& post) final {
+    const auto* call = post.as<CallNode>();
+    if (call == nullptr) return post;
+    if (call->op == requantize_op_) {
+      return RewriteRequantize(call, post);
+    } else if (call->op == quantize_op_) {
+      return RewriteQuantize(call, post);
+    } else if (call->op == dequantize_op_) {
+      return RewriteDequantize(call, post);
+    }
+    return post;
+  }
+
+ private:
+  // The dtype of an expression, which may be a requantization op created by this pass and not
+  // typed yet.
+  static DataType DTypeOf(const Expr& expr) {
+    if (expr->checked_type_.defined()) {
+      return Downcast<TensorType>(expr->checked_type())->dtype;
+    }
+    const auto* call = expr.as<CallNode>();
+    ICHECK(call) << "FoldRequantize: expect the new expressions to be calls";
+    if (const auto* attrs = call->attrs.as<RequantizeAttrs>()) {
+      return attrs->out_dtype;
+    }
+    ICHECK(call->attrs.as<DequantizeAttrs>()) << "FoldRequantize: unexpected new expression";
+    return DataType::Float(32);
+  }
+
+  static Expr MakeRequantize(const Expr& data, const Expr& input_scale,
+                             const Expr& input_zero_point, const Expr& output_scale,
+                             const Expr& output_zero_point, const RequantizeAttrs* like) {
+    auto attrs = make_object<RequantizeAttrs>();
+    attrs->axis = like->axis;
+    attrs->rounding = like->rounding;
+    attrs->out_dtype = like->out_dtype;
+    static const Op& op = Op::Get("qnn.requantize");
+    return Call(op, {data, input_scale, input_zero_point, output_scale, output_zero_point},
+                Attrs(attrs), {});
+  }
+
+  Expr RewriteRequantize(const CallNode* call, const Expr& post) {
+    const auto* attrs = call->attrs.as<RequantizeAttrs>();
+    QParams in, out;
+    if (!GetQParams(call->args[1], call->args[2], DTypeOf(call->args[0]), &in) ||
+        !GetQParams(call->args[3], call->args[4], attrs->out_dtype, &out)) {
+      return post;
+    }
+    if (in.scale == out.scale && in.zero_point == out.zero_point && in.dtype == out.dtype) {
+      return call->args[0];
+    }
+    const auto* inner = call->args[0].as<CallNode>();
+    if (inner == nullptr || inner->op != requantize_op_) return post;
+    const auto* inner_attrs = inner->attrs.as<RequantizeAttrs>();
+    QParams inner_in, inner_out;
+    if (!GetQParams(inner->args[1], inner->args[2], DTypeOf(inner->args[0]), &inner_in) ||
+        !GetQParams(inner->args[3], inner->args[4], inner_attrs->out_dtype, &inner_out) ||
+        inner_out.scale != in.scale || inner_out.zero_point != in.zero_point) {
+      return post;
+    }
+    // The range of the outer result has to fit in the inner one for its clipping to be implied.
+    auto inner_range = inner_out.RealRange();
+    auto out_range = out.RealRange();
+    if (inner_range.first > out_range.first || inner_range.second < out_range.second) {
+      return post;
+    }
+    return MakeRequantize(inner->args[0], inner->args[1], inner->args[2], call->args[3],
+                          call->args[4], attrs);
+  }
+
+  Expr RewriteQuantize(const CallNode* call, const Expr& post) {
+    const auto* attrs = call->attrs.as<QuantizeAttrs>();
+    const auto* inner = call->args[0].as<CallNode>();
+    if (inner == nullptr || inner->op != dequantize_op_) return post;
+    QParams in, out;
+    if (!GetQParams(inner->args[1], inner->args[2], DTypeOf(inner->args[0]), &in) ||
+        !GetQParams(call->args[1], call->args[2], attrs->out_dtype, &out)) {
+      return post;
+    }
+    auto requantize_attrs = make_object<RequantizeAttrs>();
+    requantize_attrs->axis = attrs->axis;
+    requantize_attrs->rounding = "UPWARD";
+    requantize_attrs->out_dtype = attrs->out_dtype;
+    Expr out_expr = MakeRequantize(inner->args[0], inner->args[1], inner->args[2], call->args[1],
+                                   call->args[2], requantize_attrs.get());
+    // the requantize may itself merge into the one producing the dequantized tensor
+    return RewriteRequantize(out_expr.as<CallNode>(), out_expr);
+  }
+
+  Expr RewriteDequantize(const CallNode* call, const Expr& post) {
+    const auto* inner = call->args[0].as<CallNode>();
+    if (inner == nullptr || inner->op != requantize_op_) return post;
+    const auto* inner_attrs = inner->attrs.as<RequantizeAttrs>();
+    QParams in, inner_out;
+    if (inner_attrs->out_dtype != DataType::Int(32) ||
+        !GetQParams(call->args[1], call->args[2], DataType::Int(32), &in) ||
+        !GetQParams(inner->args[3], inner->args[4], inner_attrs->out_dtype, &inner_out) ||
+        inner_out.scale != in.scale || inner_out.zero_point != in.zero_point ||
+        !IsConstScalar(inner->args[1]) || !IsConstScalar(inner->args[2])) {
+      return post;
+    }
+    DataType dtype = DTypeOf(inner->args[0]);
+    if (dtype != DataType::Int(8) && dtype != DataType::UInt(8) && dtype != DataType::Int(32)) {
+      return post;
+    }
+    return Call(call->op, {inner->args[0], inner->args[1], inner->args[2]}, call->attrs, {});
+  }
+
+  const Op requantize_op_ = Op::Get("qnn.requantize");
+  const Op quantize_op_ = Op::Get("qnn.quantize");
+  const Op dequantize_op_ = Op::Get("qnn.dequantize");
+};
+
+namespace transform {
+
+Pass FoldRequantize() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, relay::transform::PassContext)> pass_func =
+      [=](Function f, IRModule m, relay::transform::PassContext pc) {
+        return Downcast<Function>(RequantizeFolder().Mutate(f));
+      };
+  return relay::transform::CreateFunctionPass(pass_func, 1, "QnnFoldRequantize", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay.qnn._transform.FoldRequantize").set_body_typed(FoldRequantize);
+
+}  // namespace transform
+
+}  // namespace qnn
+}  // namespace relay
+}  // namespace tvm
@@ -26,8 +26,20 @@
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <thread>
 
 #include "./quantize.h"
 
@@ -143,6 +155,229 @@ float MinimizeKL(const std::vector<int>& hist, const std::vector<float>& hist_ed
   return thresholds[min_divergence_idx];
 }
 
+/*!
+ * \brief The statistics of the profiled layers, accumulated a batch at a time so that the
+ *  activations of the whole calibration dataset never have to be held.
+ *
+ *  The statistics are collected in two passes over the dataset. The first one finds the
+ *  maximum absolute value of every layer, which fixes the range of its histogram, the second
+ *  one fills the histograms. The result is the histogram np.histogram would compute on the
+ *  concatenated activations, which the KL divergence minimization then reads.
+ */
+class CalibrationStatsNode : public Object {
+ public:
+  /*! \brief The number of bins of the histograms. */
+  int num_bins;
+  /*! \brief The maximum absolute value of every layer. */
+  std::vector<float> max_abs;
+  /*! \brief The histogram of every layer, over [-max_abs, max_abs]. */
+  std::vector<std::vector<int64_t>> hists;
+
+  void VisitAttrs(AttrVisitor* v) { v->Visit("num_bins", &num_bins); }
+
+  /*!
+   * \brief Merge the outputs of the profile graph on one batch into the statistics.
+   * \param outputs The outputs, one float32 tensor on the CPU per profiled layer.
+   * \param histogram Whether to fill the histograms rather than the ranges.
+   * \param parallel Whether to process the layers in parallel.
+   */
+  void Update(const std::vector<runtime::NDArray>& outputs, bool histogram, bool parallel) {
+    ICHECK_EQ(outputs.size(), max_abs.size())
+        << "CalibrationStats: expect " << max_abs.size() << " outputs, got " << outputs.size();
+    auto fupdate = [&](int i) {
+      const runtime::NDArray& arr = outputs[i];
+      ICHECK(arr.DataType() == DataType::Float(32))
+          << "CalibrationStats: the profiled layers should be float32, got " << arr.DataType();
+      const float* data = static_cast<const float*>(arr->data);
+      size_t size = runtime::GetDataSize(*arr.operator->()) / sizeof(float);
+      if (histogram) {
+        std::vector<int64_t> hist = Histogram(i, data, size);
+        std::lock_guard<std::mutex> lock(mutexes_[i]);
+        for (int j = 0; j < num_bins; ++j) hists[i][j] += hist[j];
+      } else {
+        float value = 0.f;
+        for (size_t j = 0; j < size; ++j) value = std::max(value, std::fabs(data[j]));
+        std::lock_guard<std::mutex> lock(mutexes_[i]);
+        max_abs[i] = std::max(max_abs[i], value);
+      }
+    };
+    if (parallel && outputs.size() > 1) {
+      support::parallel_for(0, static_cast<int>(outputs.size()), fupdate);
+    } else {
+      for (size_t i = 0; i < outputs.size(); ++i) fupdate(i);
+    }
+  }
+
+  /*!
+   * \brief The edges of the histogram of a layer, as computed by np.histogram.
+   * \param layer The index of the layer.
+   * \return The num_bins + 1 edges.
+   */
+  std::vector<float> HistogramEdges(int layer) const {
+    float lo = -max_abs[layer], hi = max_abs[layer];
+    if (lo == hi) {
+      lo -= 0.5f;
+      hi += 0.5f;
+    }
+    std::vector<float> edges(num_bins + 1);
+    double step = (static_cast<double>(hi) - lo) / num_bins;
+    for (int i = 0; i < num_bins; ++i) edges[i] = static_cast<float>(lo + i * step);
+    edges[num_bins] = hi;
+    return edges;
+  }
+
+  /*!
+   * \brief Find the threshold of every layer minimizing the KL divergence, in parallel.
+   * \param num_quantized_bins The number of quantized bins.
+   * \return The thresholds.
+   */
+  std::vector<float> FindScales(int num_quantized_bins) const {
+    std::vector<float> scales(max_abs.size());
+    support::parallel_for(0, static_cast<int>(max_abs.size()), [&](int i) {
+      std::vector<int> hist(num_bins);
+      for (int j = 0; j < num_bins; ++j) {
+        ICHECK_LE(hists[i][j], std::numeric_limits<int>::max())
+            << "CalibrationStats: too many values in a histogram bin";
+        hist[j] = static_cast<int>(hists[i][j]);
+      }
+      scales[i] = MinimizeKL(hist, HistogramEdges(i), num_bins, num_quantized_bins);
+    });
+    return scales;
+  }
+
+  static constexpr const char* _type_key = "relay.quantize.CalibrationStats";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CalibrationStatsNode, Object);
+
+ private:
+  friend class CalibrationStats;
+
+  // Bin the values the way np.histogram does for uniform bins, the values out of the range
+  // being dropped.
+  std::vector<int64_t> Histogram(int layer, const float* data, size_t size) const {
+    std::vector<float> edges = HistogramEdges(layer);
+    float lo = edges.front(), hi = edges.back();
+    double norm = num_bins / (static_cast<double>(hi) - lo);
+    std::vector<int64_t> hist(num_bins, 0);
+    for (size_t j = 0; j < size; ++j) {
+      float x = data[j];
+      if (!(x >= lo && x <= hi)) continue;
+      int64_t index = static_cast<int64_t>((static_cast<double>(x) - lo) * norm);
+      if (index >= num_bins) index = num_bins - 1;
+      if (x < edges[index]) {
+        --index;
+      } else if (index != num_bins - 1 && x >= edges[index + 1]) {
+        ++index;
+      }
+      ++hist[index];
+    }
+    return hist;
+  }
+
+  /*! \brief The lock of every layer. */
+  std::unique_ptr<std::mutex[]> mutexes_;
+};
+
+class CalibrationStats : public ObjectRef {
+ public:
+  CalibrationStats(int num_layers, int num_bins) {
+    auto n = make_object<CalibrationStatsNode>();
+    n->num_bins = num_bins;
+    n->max_abs.assign(num_layers, 0.f);
+    n->hists.assign(num_layers, std::vector<int64_t>(num_bins, 0));
+    n->mutexes_.reset(new std::mutex[num_layers]);
+    data_ = std::move(n);
+  }
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CalibrationStats, ObjectRef, CalibrationStatsNode);
+};
+
+TVM_REGISTER_NODE_TYPE(CalibrationStatsNode);
+
+/*!
+ * \brief Run the profile graph on calibration batches and merge its outputs into the statistics.
+ *
+ *  Every executor is driven by its own thread, which takes the next batch not run yet, so the
+ *  batches run concurrently on the executors. The thread pool of each driving thread is given
+ *  an equal share of the cores, and a single executor merges the layers in parallel instead.
+ *
+ * \param executors The graph executor modules of the profile graph, on any device.
+ * \param batches The calibration batches, each mapping the input names to CPU tensors.
+ * \param stats The statistics to update.
+ * \param histogram Whether to fill the histograms rather than the ranges.
+ */
+void RunCalibrationBatches(const Array<runtime::Module>& executors,
+                           const Array<Map<String, runtime::NDArray>>& batches,
+                           CalibrationStats stats, bool histogram) {
+  ICHECK(!executors.empty()) << "RunCalibrationBatches: no executor is given";
+  int num_workers = std::min<int>(executors.size(), batches.size());
+  if (num_workers == 0) return;
+  std::atomic<int> next_batch{0};
+  std::vector<std::exception_ptr> errors(num_workers);
+  auto fworker = [&](int worker) {
+    try {
+      if (num_workers > 1) {
+        int nthreads = std::max(1, runtime::threading::MaxConcurrency() / num_workers);
+        const runtime::PackedFunc* fconfig = runtime::Registry::Get("runtime.config_threadpool");
+        if (fconfig != nullptr) {
+          (*fconfig)(static_cast<int>(runtime::threading::ThreadGroup::kBig), nthreads);
+        }
+      }
+      runtime::Module mod = executors[worker];
+      runtime::PackedFunc fset_input = mod.GetFunction("set_input");
+      runtime::PackedFunc frun = mod.GetFunction("run");
+      runtime::PackedFunc fget_output = mod.GetFunction("get_output");
+      int num_outputs = mod.GetFunction("get_num_outputs")();
+      for (int i = next_batch++; i < static_cast<int>(batches.size()); i = next_batch++) {
+        for (const auto& kv : batches[i]) {
+          fset_input(kv.first, kv.second);
+        }
+        frun();
+        std::vector<runtime::NDArray> outputs;
+        for (int j = 0; j < num_outputs; ++j) {
+          runtime::NDArray out = fget_output(j);
+          Device dev = out->device;
+          if (dev.device_type != kDLCPU) {
+            out = out.CopyTo(Device{kDLCPU, 0});
+            runtime::DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+          }
+          outputs.push_back(out);
+        }
+        stats->Update(outputs, histogram, num_workers == 1);
+      }
+    } catch (...) {
+      errors[worker] = std::current_exception();
+    }
+  };
+  if (num_workers == 1) {
+    fworker(0);
+  } else {
+    std::vector<std::thread> threads;
+    for (int worker = 0; worker < num_workers; ++worker) {
+      threads.emplace_back(fworker, worker);
+    }
+    for (auto& thread : threads) thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStats").set_body_typed([](int num_layers,
+                                                                         int num_bins) {
+  return CalibrationStats(num_layers, num_bins);
+});
+
+TVM_REGISTER_GLOBAL("relay._quantize.RunCalibrationBatches").set_body_typed(RunCalibrationBatches);
+
+TVM_REGISTER_GLOBAL("relay._quantize.CalibrationStatsFindScales")
+    .set_body_typed([](CalibrationStats stats, int num_quantized_bins) {
+      Array<FloatImm> scales;
+      for (float scale : stats->FindScales(num_quantized_bins)) {
+        scales.push_back(FloatImm(DataType::Float(32), scale));
+      }
+      return scales;
+    });
+
 class StatsCollector : private ExprMutator {
  public:
   StatsCollector() : simulated_quantize_op_(Op::Get("relay.op.annotation.simulated_quantize")) {}
@@ -25,14 +25,18 @@
  */
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op_attr_types.h>
 #include <tvm/relay/transform.h>
 #include <tvm/te/operation.h>
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -44,6 +48,227 @@ namespace relay {
 
 namespace alter_op_layout {
 
+/*! \brief The planned candidate of the call being altered, read by FTVMAlterOpLayout. */
+thread_local ObjectRef current_planned_candidate;
+
+/*!
+ * \brief Get the placeholders of the arguments of a call.
+ * \param call The call.
+ * \param tinfos The placeholders.
+ * \return Whether all the arguments are tensors of static shape.
+ */
+bool GetStaticTensorInfos(const CallNode* call, Array<te::Tensor>* tinfos) {
+  for (const auto& arg : call->args) {
+    const auto* ttype = arg->checked_type_.as<TensorTypeNode>();
+    if (ttype == nullptr) return false;
+    for (const auto& dim : ttype->shape) {
+      if (!dim.as<IntImmNode>()) return false;
+    }
+    tinfos->push_back(te::placeholder(ttype->shape, ttype->dtype));
+  }
+  return true;
+}
+
+/*!
+ * \brief Plan the layouts of the ops registering FTVMLayoutCandidates over the whole graph.
+ *
+ * The plan minimizes the estimated compute cost of the ops plus the cost of the layout
+ * transforms between them, paying the size of the tensor times transform_cost when a
+ * producer outputs a layout other than the data layout of its consumer. The producers are
+ * found looking through the element-wise, broadcast and pooling-like ops, whose layout follows
+ * their input. An exact dynamic programming over the tree linking each op to its first consumer
+ * gives the initial plan, refined by local search for the remaining edges.
+ */
+class LayoutPlanner {
+ public:
+  explicit LayoutPlanner(double transform_cost) : transform_cost_(transform_cost) {}
+
+  /*!
+   * \brief Plan the layouts of an expression.
+   * \param expr The expression.
+   * \return The planned candidate of the calls.
+   */
+  std::unordered_map<const CallNode*, Array<ObjectRef>> Plan(const Expr& expr) {
+    static auto fcandidates = Op::GetAttrMap<FTVMLayoutCandidates>("FTVMLayoutCandidates");
+    PostOrderVisit(expr, [&](const Expr& e) {
+      const auto* call = e.as<CallNode>();
+      if (call == nullptr || !call->op.as<OpNode>()) return;
+      Op op = Downcast<Op>(call->op);
+      Array<te::Tensor> tinfos;
+      if (!fcandidates.count(op) || !GetStaticTensorInfos(call, &tinfos)) return;
+      Array<Array<ObjectRef>> candidates =
+          fcandidates[op](call->attrs, tinfos, call->checked_type());
+      if (candidates.empty()) return;
+      PlannedOp planned{call, candidates, {}, {}, {}};
+      for (const auto& candidate : candidates) {
+        ICHECK_EQ(candidate.size(), 3U)
+            << "FTVMLayoutCandidates of " << op->name
+            << " must return (data layout, output layout, cost) candidates";
+        planned.in_layouts.push_back(Downcast<String>(candidate[0]));
+        planned.out_layouts.push_back(Downcast<String>(candidate[1]));
+        planned.costs.push_back(Downcast<FloatImm>(candidate[2])->value);
+      }
+      int id = static_cast<int>(ops_.size());
+      op_ids_[call] = id;
+      ops_.push_back(std::move(planned));
+      std::unordered_set<const Object*> visited;
+      CollectProducers(call->args[0], id, TensorSize(call->args[0]), &visited);
+    });
+    if (ops_.empty()) return {};
+
+    std::vector<int> choice = SolveTree();
+    RefineLocally(&choice);
+    std::unordered_map<const CallNode*, Array<ObjectRef>> plan;
+    for (size_t i = 0; i < ops_.size(); ++i) {
+      plan[ops_[i].call] = ops_[i].candidates[choice[i]];
+    }
+    return plan;
+  }
+
+ private:
+  /*! \brief An op to plan and its candidates. */
+  struct PlannedOp {
+    const CallNode* call;
+    Array<Array<ObjectRef>> candidates;
+    std::vector<std::string> in_layouts;
+    std::vector<std::string> out_layouts;
+    std::vector<double> costs;
+  };
+
+  /*! \brief A producer feeding the data of a consumer, and the elements of the tensor. */
+  struct PlanEdge {
+    int producer;
+    int consumer;
+    double elements;
+  };
+
+  static double TensorSize(const Expr& expr) {
+    const auto* ttype = expr->checked_type_.as<TensorTypeNode>();
+    if (ttype == nullptr) return 0;
+    double size = 1;
+    for (const auto& dim : ttype->shape) {
+      if (const auto* imm = dim.as<IntImmNode>()) size *= imm->value;
+    }
+    return size;
+  }
+
+  // Whether the layout of the output of a call follows its inputs.
+  static bool IsTransparent(const CallNode* call) {
+    static auto falter_layout = Op::GetAttrMap<FTVMAlterOpLayout>("FTVMAlterOpLayout");
+    static auto finfer_layout = Op::GetAttrMap<FInferCorrectLayout>("FInferCorrectLayout");
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    if (!call->op.as<OpNode>()) return false;
+    Op op = Downcast<Op>(call->op);
+    if (falter_layout.count(op) || !finfer_layout.count(op) || !fpattern.count(op)) return false;
+    int pattern = fpattern[op];
+    return pattern == kElemWise || pattern == kBroadcast || pattern == kOutEWiseFusable;
+  }
+
+  void CollectProducers(const Expr& expr, int consumer, double elements,
+                        std::unordered_set<const Object*>* visited) {
+    if (!visited->insert(expr.get()).second) return;
+    const auto* call = expr.as<CallNode>();
+    if (call == nullptr) return;
+    auto it = op_ids_.find(call);
+    if (it != op_ids_.end()) {
+      edges_.push_back({it->second, consumer, elements});
+    } else if (IsTransparent(call)) {
+      for (const auto& arg : call->args) CollectProducers(arg, consumer, elements, visited);
+    }
+  }
+
+  double EdgeCost(const PlanEdge& edge, int producer_choice, int consumer_choice) const {
+    const std::string& out_layout = ops_[edge.producer].out_layouts[producer_choice];
+    const std::string& in_layout = ops_[edge.consumer].in_layouts[consumer_choice];
+    return out_layout == in_layout ? 0 : edge.elements * transform_cost_;
+  }
+
+  // The best choice of a producer given the choice of its consumer, and its total cost.
+  std::pair<int, double> BestProducerChoice(const PlanEdge& edge, int consumer_choice,
+                                            const std::vector<std::vector<double>>& subtree) {
+    std::pair<int, double> best = {0, std::numeric_limits<double>::infinity()};
+    for (size_t j = 0; j < ops_[edge.producer].costs.size(); ++j) {
+      double cost = subtree[edge.producer][j] + EdgeCost(edge, j, consumer_choice);
+      if (cost < best.second) best = {static_cast<int>(j), cost};
+    }
+    return best;
+  }
+
+  // Solve the tree linking each op to its first consumer, the ops being in topological order.
+  std::vector<int> SolveTree() {
+    std::vector<int> parent_edge(ops_.size(), -1);
+    std::vector<std::vector<int>> child_edges(ops_.size());
+    for (size_t e = 0; e < edges_.size(); ++e) {
+      if (parent_edge[edges_[e].producer] < 0) {
+        parent_edge[edges_[e].producer] = static_cast<int>(e);
+        child_edges[edges_[e].consumer].push_back(static_cast<int>(e));
+      }
+    }
+    std::vector<std::vector<double>> subtree(ops_.size());
+    for (size_t u = 0; u < ops_.size(); ++u) {
+      subtree[u] = ops_[u].costs;
+      for (size_t k = 0; k < subtree[u].size(); ++k) {
+        for (int e : child_edges[u]) {
+          subtree[u][k] += BestProducerChoice(edges_[e], k, subtree).second;
+        }
+      }
+    }
+    std::vector<int> choice(ops_.size(), 0);
+    for (int u = static_cast<int>(ops_.size()) - 1; u >= 0; --u) {
+      if (parent_edge[u] < 0) {
+        choice[u] = static_cast<int>(std::min_element(subtree[u].begin(), subtree[u].end()) -
+                                     subtree[u].begin());
+      }
+      for (int e : child_edges[u]) {
+        choice[edges_[e].producer] = BestProducerChoice(edges_[e], choice[u], subtree).first;
+      }
+    }
+    return choice;
+  }
+
+  // Change the choice of one op at a time while it lowers the total cost.
+  void RefineLocally(std::vector<int>* choice) {
+    std::vector<std::vector<int>> incident(ops_.size());
+    for (size_t e = 0; e < edges_.size(); ++e) {
+      incident[edges_[e].producer].push_back(static_cast<int>(e));
+      incident[edges_[e].consumer].push_back(static_cast<int>(e));
+    }
+    auto local_cost = [&](int u, int k) {
+      double cost = ops_[u].costs[k];
+      for (int e : incident[u]) {
+        const PlanEdge& edge = edges_[e];
+        if (edge.producer == u) {
+          cost += EdgeCost(edge, k, (*choice)[edge.consumer]);
+        } else {
+          cost += EdgeCost(edge, (*choice)[edge.producer], k);
+        }
+      }
+      return cost;
+    };
+    for (int iter = 0; iter < kMaxRefineIterations; ++iter) {
+      bool changed = false;
+      for (size_t u = 0; u < ops_.size(); ++u) {
+        double best = local_cost(u, (*choice)[u]);
+        for (size_t k = 0; k < ops_[u].costs.size(); ++k) {
+          double cost = local_cost(u, k);
+          if (cost < best) {
+            best = cost;
+            (*choice)[u] = static_cast<int>(k);
+            changed = true;
+          }
+        }
+      }
+      if (!changed) break;
+    }
+  }
+
+  static constexpr int kMaxRefineIterations = 16;
+  double transform_cost_;
+  std::vector<PlannedOp> ops_;
+  std::unordered_map<const CallNode*, int> op_ids_;
+  std::vector<PlanEdge> edges_;
+};
+
 /*!
  * \brief Container to instantiate a Node for alter op layouts.
  */
@@ -74,7 +299,10 @@ class AlterTransformMemorizerNode : public TransformMemorizerNode {
       }
       // TODO(@kevinthesun, @icemelon9): This won't work if inputs/outputs are dynamic shapes.
       //   Probably we need to disable the AlterOpLayout when compiling dynamic models.
+      auto it = plan.find(ref_call.get());
+      current_planned_candidate = it != plan.end() ? it->second : ObjectRef();
       Expr altered_value = falter_layout[op](new_attrs, new_args, tinfos, ref_call->checked_type());
+      current_planned_candidate = ObjectRef();
       if (altered_value.defined()) {
         new_e = altered_value;
         modified = true;
@@ -92,6 +320,9 @@ class AlterTransformMemorizerNode : public TransformMemorizerNode {
   Call CallWithNewLayouts(const Call& ref_call, const std::vector<Expr>& new_args) override {
     return CallWithNewLayouts(ref_call, ref_call->attrs, new_args);
   }
+
+  /*! \brief The planned candidate of the calls, when planning the layouts globally. */
+  std::unordered_map<const CallNode*, Array<ObjectRef>> plan;
 };
 
 /*!
@@ -114,9 +345,12 @@ class AlterTransformMemorizer : public TransformMemorizer {
  * 1. The altered op should have the same number of arguments as the previous one.
  * 2. Do not support nested tuple arguments.
  */
-Expr AlterOpLayout(const Expr& expr) {
+Expr AlterOpLayout(const Expr& expr, bool plan_layouts, double transform_cost) {
   // TODO(@icemelon9): need to rerun type inference after applying an alter op.
   AlterTransformMemorizer alter_memorizer(make_object<AlterTransformMemorizerNode>());
+  if (plan_layouts) {
+    alter_memorizer->plan = LayoutPlanner(transform_cost).Plan(expr);
+  }
   std::function<ObjectRef(const Call&)> fcontext = [=](const Call& call) -> ObjectRef {
     return alter_memorizer;
   };
@@ -124,14 +358,30 @@ Expr AlterOpLayout(const Expr& expr) {
   return ForwardRewrite(expr, rewrite_func, fcontext);
 }
 
+TVM_REGISTER_GLOBAL("relay._transform.AlterOpLayoutPlannedCandidate").set_body_typed([]() {
+  return current_planned_candidate;
+});
+
 }  // namespace alter_op_layout
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.AlterOpLayout.plan_layouts", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.AlterOpLayout.layout_transform_cost", FloatImm);
+
 Pass AlterOpLayout() {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(relay::alter_op_layout::AlterOpLayout(f));
+        bool plan_layouts =
+            pc->GetConfig<Bool>("relay.AlterOpLayout.plan_layouts", Bool(false)).value();
+        // A layout transform moves each element with strided accesses, costing about as much
+        // as a few vectorized multiply-adds.
+        double transform_cost = pc->GetConfig<FloatImm>("relay.AlterOpLayout.layout_transform_cost",
+                                                        FloatImm(DataType::Float(64), 8.0))
+                                    .value()
+                                    ->value;
+        return Downcast<Function>(
+            relay::alter_op_layout::AlterOpLayout(f, plan_layouts, transform_cost));
       };
   return CreateFunctionPass(pass_func, 3, "AlterOpLayout", {"InferType"});
 }
@@ -0,0 +1,247 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/transforms/auto_checkpoint.cc
+ *
+ * \brief The reverse mode gradient keeps every forward activation alive until the backward
+ * pass uses it. This pass wraps segments of the let chain of a function in
+ * annotation.checkpoint, whose gradient recomputes the segment in the backward pass, so only
+ * the outputs of the segments are stored.
+ *
+ * The segments are chosen for a memory budget of the activations alive at once: the stored
+ * activations plus those of the largest segment, live while it is recomputed. When every
+ * activation fits, the function is left unchanged. Otherwise, among the segmentations bounding
+ * the segment sizes by a geometric series of limits, the one recomputing the fewest bytes within
+ * the budget is kept, or the one of the smallest peak when none fits.
+ */
+
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relay {
+namespace auto_checkpoint {
+
+// The bytes of a type made of tensors of static shapes, -1 otherwise.
+int64_t TypeBytes(const Type& type) {
+  if (const auto* tt = type.as<TensorTypeNode>()) {
+    int64_t bytes = (tt->dtype.bits() * tt->dtype.lanes() + 7) / 8;
+    for (const auto& dim : tt->shape) {
+      const auto* imm = dim.as<IntImmNode>();
+      if (imm == nullptr) return -1;
+      bytes *= imm->value;
+    }
+    return bytes;
+  }
+  if (const auto* tuple = type.as<TupleTypeNode>()) {
+    int64_t bytes = 0;
+    for (const auto& field : tuple->fields) {
+      int64_t field_bytes = TypeBytes(field);
+      if (field_bytes < 0) return -1;
+      bytes += field_bytes;
+    }
+    return bytes;
+  }
+  return -1;
+}
+
+// Whether a let bound value can be recomputed in the backward pass.
+bool IsRecomputable(const Expr& value) {
+  static const Op& checkpoint_op = Op::Get("annotation.checkpoint");
+  static auto fstateful = Op::GetAttrMap<TOpIsStateful>("TOpIsStateful");
+  if (const auto* call = value.as<CallNode>()) {
+    const auto* op = call->op.as<OpNode>();
+    return op != nullptr && call->op != checkpoint_op && !fstateful.get(GetRef<Op>(op), false);
+  }
+  return value.as<TupleGetItemNode>() || value.as<TupleNode>() || value.as<ConstantNode>();
+}
+
+/*! \brief A segmentation of a let chain, the segments being ranges [begin, end] of bindings. */
+struct Segmentation {
+  std::vector<std::pair<size_t, size_t>> segments;
+  /*! \brief The bytes of the activations alive at once in the backward pass. */
+  int64_t peak_bytes = 0;
+  /*! \brief The bytes of the activations recomputed in the backward pass. */
+  int64_t recompute_bytes = 0;
+};
+
+class CheckpointPlanner {
+ public:
+  CheckpointPlanner(std::vector<std::pair<Var, Expr>> bindings, const Expr& result)
+      : bindings_(std::move(bindings)) {
+    size_t n = bindings_.size();
+    std::unordered_map<const VarNode*, size_t> index;
+    for (size_t i = 0; i < n; ++i) {
+      index[bindings_[i].first.get()] = i;
+      bytes_.push_back(TypeBytes(bindings_[i].first->checked_type()));
+    }
+    last_use_.assign(n, 0);
+    auto note_uses = [&](const Expr& expr, size_t user) {
+      for (const Var& var : FreeVars(expr)) {
+        auto it = index.find(var.get());
+        if (it != index.end()) {
+          last_use_[it->second] = std::max(last_use_[it->second], user);
+        }
+      }
+    };
+    for (size_t i = 0; i < n; ++i) {
+      note_uses(bindings_[i].second, i);
+    }
+    // the result uses its values after all the bindings
+    note_uses(result, n);
+  }
+
+  /*! \return The bytes of all the activations, -1 when some are not static. */
+  int64_t TotalBytes() const {
+    int64_t total = 0;
+    for (int64_t bytes : bytes_) {
+      if (bytes < 0) return -1;
+      total += bytes;
+    }
+    return total;
+  }
+
+  /*!
+   * \brief Greedily segment the chain, the stored activations inside a segment recomputing at
+   * most limit bytes.
+   */
+  Segmentation Segment(int64_t limit) const {
+    Segmentation seg;
+    int64_t stored = 0, largest_segment = 0;
+    size_t n = bindings_.size();
+    size_t i = 0;
+    while (i < n) {
+      size_t end = i;
+      int64_t inner = 0, end_inner = 0;
+      size_t inner_last_use = 0;
+      for (size_t j = i; j < n && IsRecomputable(bindings_[j].second) && bytes_[j] >= 0; ++j) {
+        // j can end the segment when the values before it are only used inside the segment
+        if (j > i && inner_last_use <= j &&
+            bindings_[j].first->checked_type().as<TensorTypeNode>()) {
+          end = j;
+          end_inner = inner;
+        }
+        inner += bytes_[j];
+        inner_last_use = std::max(inner_last_use, last_use_[j]);
+        if (inner > limit) break;
+      }
+      if (end > i) {
+        seg.segments.emplace_back(i, end);
+        seg.recompute_bytes += end_inner;
+        largest_segment = std::max(largest_segment, end_inner);
+      }
+      stored += std::max<int64_t>(bytes_[end], 0);
+      i = end + 1;
+    }
+    seg.peak_bytes = stored + largest_segment;
+    return seg;
+  }
+
+  /*! \brief Rebuild the let chain with the segments wrapped in checkpoints. */
+  Expr Rewrite(const Segmentation& seg, Expr result) const {
+    static const Op& checkpoint_op = Op::Get("annotation.checkpoint");
+    std::vector<std::pair<Var, Expr>> bindings;
+    size_t next = 0;
+    for (size_t i = 0; i < bindings_.size(); ++i) {
+      if (next < seg.segments.size() && seg.segments[next].first == i) {
+        size_t end = seg.segments[next++].second;
+        Expr inner = bindings_[end].second;
+        for (size_t j = end; j-- > i;) {
+          inner = Let(bindings_[j].first, bindings_[j].second, inner);
+        }
+        bindings.emplace_back(bindings_[end].first, Call(checkpoint_op, {inner}, Attrs(), {}));
+        i = end;
+      } else {
+        bindings.push_back(bindings_[i]);
+      }
+    }
+    for (size_t i = bindings.size(); i-- > 0;) {
+      result = Let(bindings[i].first, bindings[i].second, result);
+    }
+    return result;
+  }
+
+ private:
+  std::vector<std::pair<Var, Expr>> bindings_;
+  // The bytes of the value of every binding, -1 when not static.
+  std::vector<int64_t> bytes_;
+  // The index of the last binding using every binding, the number of bindings for the result.
+  std::vector<size_t> last_use_;
+};
+
+Function AutoCheckpoint(const Function& func, int64_t budget_bytes) {
+  std::vector<std::pair<Var, Expr>> bindings;
+  Expr result = func->body;
+  while (const auto* let = result.as<LetNode>()) {
+    bindings.emplace_back(let->var, let->value);
+    result = let->body;
+  }
+  CheckpointPlanner planner(std::move(bindings), result);
+  int64_t total = planner.TotalBytes();
+  if (total >= 0 && total <= budget_bytes) {
+    return func;
+  }
+
+  Segmentation best;
+  bool found = false;
+  for (int64_t limit = total > 0 ? total : std::numeric_limits<int32_t>::max(); limit > 0;
+       limit /= 2) {
+    Segmentation seg = planner.Segment(limit);
+    bool fits = seg.peak_bytes <= budget_bytes;
+    bool best_fits = found && best.peak_bytes <= budget_bytes;
+    if (!found || (fits && (!best_fits || seg.recompute_bytes < best.recompute_bytes)) ||
+        (!fits && !best_fits && seg.peak_bytes < best.peak_bytes)) {
+      best = std::move(seg);
+      found = true;
+    }
+  }
+  if (!found || best.segments.empty()) {
+    return func;
+  }
+  return WithFields(func, func->params, planner.Rewrite(best, result));
+}
+
+}  // namespace auto_checkpoint
+
+namespace transform {
+
+Pass AutoCheckpoint(int64_t budget_bytes) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return auto_checkpoint::AutoCheckpoint(f, budget_bytes);
+      };
+  auto checkpoint_pass = CreateFunctionPass(pass_func, 0, "AutoCheckpointFunc", {"InferType"});
+  return Sequential({ToANormalForm(), InferType(), checkpoint_pass, InferType()},
+                    "AutoCheckpoint");
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.AutoCheckpoint").set_body_typed(AutoCheckpoint);
+
+}  // namespace transform
+}  // namespace relay
+}  // namespace tvm
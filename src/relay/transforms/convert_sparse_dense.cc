@@ -128,6 +128,11 @@ Expr DenseToSparse(const Expr& e, const Array<ObjectRef>& weight_name,
 
 namespace transform {
 
+// When set, relay.build converts the dense operators whose weights reach the ratio of zero
+// blocks to sparse_dense, with the largest qualified block size among block_sizes.
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.DenseToSparse.sparsity_threshold", FloatImm);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.DenseToSparse.block_sizes", Array<Array<Integer>>);
+
 Pass DenseToSparse(const Array<ObjectRef>& weight_name,
                    const Array<Array<PrimExpr> >& weight_shape) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
@@ -25,21 +25,94 @@
  * This is an optimization pass that eliminates common subexpressions. During the pass, it tries
  * to replace an expression with a previously appeared expression with the same input and
  * attributes. The fskip callback argument allows us to skip specific expressions.
+ *
+ * The constants holding the same data and the structurally equal primitive functions are shared
+ * across the functions of the module first, so the calls taking them are combined too, and a
+ * let binding of a value already bound in scope is replaced by the earlier variable. The global
+ * functions structurally equal to another one are then called through that one.
  */
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
 
+#include <algorithm>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "pattern_utils.h"
 
 namespace tvm {
 namespace relay {
 
+/*!
+ * \brief The canonical constants and primitive functions, shared by the functions of a module.
+ *
+ *  The constants are keyed by their data, only the ones on the host being compared.
+ */
+struct SharedExprTable {
+  std::unordered_map<ObjectRef, Constant, StructuralHash, StructuralEqual> constants;
+  std::unordered_map<Function, Function, StructuralHash, StructuralEqual> primitive_funcs;
+};
+
 class CommonSubexprEliminator : public MixedModeMutator {
  public:
-  explicit CommonSubexprEliminator(runtime::TypedPackedFunc<bool(Expr)> fskip) : fskip_(fskip) {}
+  CommonSubexprEliminator(runtime::TypedPackedFunc<bool(Expr)> fskip, SharedExprTable* table)
+      : fskip_(fskip), table_(table) {}
+
+  using MixedModeMutator::VisitExpr_;
+
+  Expr VisitExpr_(const ConstantNode* op) final {
+    Constant constant = GetRef<Constant>(op);
+    if (table_ == nullptr || op->data->device.device_type != kDLCPU ||
+        !runtime::IsContiguous(*op->data.operator->())) {
+      return std::move(constant);
+    }
+    return table_->constants.emplace(op->data, constant).first->second;
+  }
+
+  Expr VisitExpr_(const FunctionNode* op) final {
+    Expr new_expr = ExprMutator::VisitExpr_(op);
+    if (table_ == nullptr || !op->HasNonzeroAttr(attr::kPrimitive)) {
+      return new_expr;
+    }
+    Function func = Downcast<Function>(new_expr);
+    return table_->primitive_funcs.emplace(func, func).first->second;
+  }
+
+  Expr VisitExpr_(const LetNode* op) final {
+    auto pre_visit = [this](const LetNode* op) {
+      Expr value = this->VisitExpr(op->value);
+      if (!value->IsInstance<CallNode>() && !value->IsInstance<TupleGetItemNode>()) return;
+      auto it = let_values_.find(value);
+      if (it != let_values_.end()) {
+        // the value is bound in scope already, the variable is replaced and the binding dropped
+        this->memo_[op->var] = it->second;
+      } else {
+        let_values_.emplace(value, op->var);
+      }
+    };
+    auto post_visit = [this](const LetNode* op) {
+      Expr expr = GetRef<Expr>(op);
+      Expr value = this->VisitExpr(op->value);
+      Expr body = this->VisitExpr(op->body);
+      auto it = let_values_.find(value);
+      if (it != let_values_.end() && it->second.same_as(op->var)) {
+        // the binding goes out of scope
+        let_values_.erase(it);
+      }
+      auto var_it = this->memo_.find(op->var);
+      if (var_it != this->memo_.end() && !var_it->second.same_as(op->var)) {
+        this->memo_[expr] = body;
+      } else if (value.same_as(op->value) && body.same_as(op->body)) {
+        this->memo_[expr] = expr;
+      } else {
+        this->memo_[expr] = Let(op->var, value, body, op->span);
+      }
+    };
+    ExpandANormalForm(op, pre_visit, post_visit);
+    return memo_[GetRef<Expr>(op)];
+  }
 
   Expr Rewrite_(const CallNode* call, const Expr& post) final {
     static auto op_stateful = Op::GetAttrMap<TOpIsStateful>("TOpIsStateful");
@@ -47,12 +120,17 @@ class CommonSubexprEliminator : public MixedModeMutator {
     const CallNode* new_call = new_expr.as<CallNode>();
     ICHECK(new_call);
     const OpNode* op = new_call->op.as<OpNode>();
+    const FunctionNode* func = new_call->op.as<FunctionNode>();
+    // the calls of the primitive functions are pure, as the ones of the stateless operators
+    bool is_primitive = func != nullptr && func->HasNonzeroAttr(attr::kPrimitive);
     StructuralEqual attrs_equal;
 
-    if (new_call->args.size() == 0 || op == nullptr || op_stateful.get(GetRef<Op>(op), false)) {
+    if (new_call->args.size() == 0 || (op == nullptr && !is_primitive) ||
+        (op != nullptr && op_stateful.get(GetRef<Op>(op), false))) {
       return new_expr;
     }
-    if (fskip_ != nullptr && fskip_(new_expr)) {
+    // the callbacks are written for the calls of operators
+    if (op != nullptr && fskip_ != nullptr && fskip_(new_expr)) {
       return new_expr;
     }
 
@@ -104,21 +182,76 @@ class CommonSubexprEliminator : public MixedModeMutator {
   }
 
   std::unordered_map<Expr, std::vector<Expr>, ObjectPtrHash, ObjectPtrEqual> expr_map_;
+  /*! \brief The let bound values in scope, with their variables. */
+  std::unordered_map<Expr, Var, ObjectPtrHash, ObjectPtrEqual> let_values_;
   runtime::TypedPackedFunc<bool(Expr)> fskip_;
+  SharedExprTable* table_;
+};
+
+/*! \brief Replace the references to global functions by the ones to their canonical copies. */
+class GlobalVarReplacer : public ExprMutator {
+ public:
+  explicit GlobalVarReplacer(
+      const std::unordered_map<GlobalVar, GlobalVar, ObjectPtrHash, ObjectPtrEqual>& replacements)
+      : replacements_(replacements) {}
+
+  Expr VisitExpr_(const GlobalVarNode* op) final {
+    auto it = replacements_.find(GetRef<GlobalVar>(op));
+    return it == replacements_.end() ? GetRef<Expr>(op) : Expr(it->second);
+  }
+
+ private:
+  const std::unordered_map<GlobalVar, GlobalVar, ObjectPtrHash, ObjectPtrEqual>& replacements_;
 };
 
 Expr EliminateCommonSubexpr(const Expr& expr, PackedFunc callback) {
-  return CommonSubexprEliminator(callback)(expr);
+  SharedExprTable table;
+  return CommonSubexprEliminator(callback, &table)(expr);
+}
+
+IRModule EliminateCommonSubexprInModule(const IRModule& mod, PackedFunc callback) {
+  IRModule updated_mod = mod->ShallowCopy();
+  SharedExprTable table;
+  std::vector<std::pair<GlobalVar, Function>> updates;
+  for (const auto& kv : updated_mod->functions) {
+    if (const auto* function_node = AsOptimizableFunctionNode(kv.second)) {
+      Expr updated = CommonSubexprEliminator(callback, &table)(GetRef<Function>(function_node));
+      updates.emplace_back(kv.first, Downcast<Function>(updated));
+    }
+  }
+  // main is kept, duplicates of other functions are called through the first of them
+  std::sort(updates.begin(), updates.end(), [](const auto& lhs, const auto& rhs) {
+    if ((lhs.first->name_hint == "main") != (rhs.first->name_hint == "main")) {
+      return lhs.first->name_hint == "main";
+    }
+    return lhs.first->name_hint < rhs.first->name_hint;
+  });
+  std::unordered_map<Function, GlobalVar, StructuralHash, StructuralEqual> canonical_funcs;
+  std::unordered_map<GlobalVar, GlobalVar, ObjectPtrHash, ObjectPtrEqual> replacements;
+  for (const auto& pair : updates) {
+    auto it = canonical_funcs.emplace(pair.second, pair.first).first;
+    if (!it->second.same_as(pair.first) && pair.first->name_hint != "main") {
+      replacements.emplace(pair.first, it->second);
+    }
+  }
+  for (const auto& pair : updates) {
+    Function func = pair.second;
+    if (!replacements.empty()) {
+      func = Downcast<Function>(GlobalVarReplacer(replacements)(func));
+    }
+    updated_mod->Add(pair.first, func, true);
+  }
+  return updated_mod;
 }
 
 namespace transform {
 
 Pass EliminateCommonSubexpr(PackedFunc fskip) {
-  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
-      [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(EliminateCommonSubexpr(f, fskip));
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) {
+        return InferType()(EliminateCommonSubexprInModule(m, fskip));
       };
-  return CreateFunctionPass(pass_func, 3, "EliminateCommonSubexpr", {"InferType"});
+  return CreateModulePass(pass_func, 3, "EliminateCommonSubexpr", {"InferType"});
 }
 
 TVM_REGISTER_GLOBAL("relay._transform.EliminateCommonSubexpr")
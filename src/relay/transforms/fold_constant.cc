@@ -20,6 +20,8 @@
 /*!
  * \file constant_folding.cc
  */
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/transform.h>
@@ -30,6 +32,15 @@
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../op/memory/on_device.h"
 #include "./pattern_utils.h"
@@ -38,6 +49,9 @@ namespace tvm {
 namespace relay {
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FoldConstant.num_threads", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FoldConstant.max_constant_bytes", Integer);
+
 namespace {
 /*!
  * \brief Returns whether \p expr is a literal \p Constant, optionally wrapped by an "on_device"
@@ -62,18 +76,290 @@ bool IsComplexConstant(const Expr& expr) {
   }
 }
 
+/*!
+ * \brief Returns the number of bytes of a value of type \p type, or -1 if its shape is not
+ * static.
+ */
+int64_t StaticTypeBytes(const Type& type) {
+  if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+    int64_t num_elements = 1;
+    for (const PrimExpr& dim : tensor_type->shape) {
+      const auto* int_dim = dim.as<IntImmNode>();
+      if (int_dim == nullptr) {
+        return -1;
+      }
+      num_elements *= int_dim->value;
+    }
+    return num_elements * ((tensor_type->dtype.bits() * tensor_type->dtype.lanes() + 7) / 8);
+  } else if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+    int64_t num_bytes = 0;
+    for (const Type& field : tuple_type->fields) {
+      int64_t field_bytes = StaticTypeBytes(field);
+      if (field_bytes < 0) {
+        return -1;
+      }
+      num_bytes += field_bytes;
+    }
+    return num_bytes;
+  } else {
+    return -1;
+  }
+}
+
+/*! \brief Returns the number of bytes of the \p IsComplexConstant expression \p expr. */
+int64_t ConstantBytes(const Expr& expr) {
+  if (const auto* const_node = AsIgnoringOnDevice<ConstantNode>(expr)) {
+    return static_cast<int64_t>(runtime::GetDataSize(*const_node->data.operator->()));
+  }
+  int64_t num_bytes = 0;
+  for (const Expr& field : AsIgnoringOnDevice<TupleNode>(expr)->fields) {
+    num_bytes += ConstantBytes(field);
+  }
+  return num_bytes;
+}
+
+/*!
+ * \brief Returns whether calls to \p op with constant arguments can be replaced by their value.
+ */
+bool IsEvaluableOp(const Op& op) {
+  static auto fnoncomputational = Op::GetAttrMap<TNonComputational>("TNonComputational");
+  static auto op_stateful = Op::GetAttrMap<TOpIsStateful>("TOpIsStateful");
+  static const Op& device_copy_op = Op::Get("device_copy");
+  static const Op& shape_of_op = Op::Get("shape_of");
+  static const Op& vm_shape_of_op = Op::Get("vm.shape_of");
+  static const Op& ndarray_size_op = Op::Get("ndarray_size");
+  if (op_stateful.get(op, false)) {
+    // skip stateful ops.
+    return false;
+  }
+  // We should think about potentially constant evaluation over these ops too.
+  return !fnoncomputational.get(op, false) && op != device_copy_op && op != shape_of_op &&
+         op != vm_shape_of_op && op != ndarray_size_op;
+}
+
+/*!
+ * \brief The kernels compiled to fold the calls to primitive operators, shared by all the
+ * folds of the process.
+ *
+ * The value of such a call only depends on its operator, its attributes and the types and values
+ * of its arguments. So the function compiled for the first call of a signature is applied to the
+ * constants of all the later ones, instead of preparing, lowering and building a fresh module for
+ * each call. The folder always evaluates on the same CPU target, which is not part of the key.
+ */
+class FoldKernelCache {
+ public:
+  static FoldKernelCache* Global() {
+    static FoldKernelCache* inst = new FoldKernelCache();
+    return inst;
+  }
+
+  /*!
+   * \brief Applies the kernel of \p signature to \p args, compiling it on first use.
+   * \param signature A function of the argument types calling the operator on its parameters.
+   * \param args The constant arguments.
+   * \param device The device the kernel runs on.
+   * \param target The target the kernel is compiled for.
+   */
+  ObjectRef Run(const Function& signature, const Array<Expr>& args, Device device,
+                Target target) {
+    std::shared_ptr<Kernel> kernel;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = table_.find(signature);
+      if (it == table_.end()) {
+        if (table_.size() >= kMaxEntries) {
+          table_.clear();
+        }
+        it = table_.emplace(signature, std::make_shared<Kernel>()).first;
+      }
+      kernel = it->second;
+    }
+    // The interpreter behind a kernel is not thread safe, and the callers of a kernel being
+    // compiled wait for it rather than compile it again.
+    std::lock_guard<std::mutex> lock(kernel->mutex);
+    if (kernel->func == nullptr) {
+      kernel->func = EvalFunction(IRModule(), signature, device, target);
+    }
+    return kernel->func(args);
+  }
+
+ private:
+  struct Kernel {
+    std::mutex mutex;
+    TypedPackedFunc<ObjectRef(Array<Expr>)> func;
+  };
+  /*! \brief The table is dropped when it reaches this size. */
+  static constexpr size_t kMaxEntries = 1024;
+  std::mutex mutex_;
+  std::unordered_map<Function, std::shared_ptr<Kernel>, StructuralHash, StructuralEqual> table_;
+};
+
+/*!
+ * \brief Predicts the calls the folder will evaluate from the checked types of the expression,
+ * grouped by depth so that the calls of a group only depend on the calls of the previous ones.
+ */
+class FoldableCallCollector : public MixedModeVisitor {
+ public:
+  std::vector<std::vector<Call>> Collect(const Expr& expr) {
+    VisitExpr(expr);
+    return std::move(calls_);
+  }
+
+ private:
+  using MixedModeVisitor::VisitExpr_;
+
+  void VisitExpr_(const ConstantNode* constant_node) final { depth_[constant_node] = 0; }
+
+  void VisitExpr_(const TupleNode* tuple_node) final {
+    MixedModeVisitor::VisitExpr_(tuple_node);
+    int depth = MaxDepth(tuple_node->fields);
+    if (depth >= 0) {
+      depth_[tuple_node] = depth;
+    }
+  }
+
+  void VisitExpr_(const TupleGetItemNode* tuple_get_item_node) final {
+    MixedModeVisitor::VisitExpr_(tuple_get_item_node);
+    int depth = MaxDepth({tuple_get_item_node->tuple});
+    if (depth >= 0) {
+      depth_[tuple_get_item_node] = depth;
+    }
+  }
+
+  void VisitExpr_(const CallNode* call_node) final {
+    MixedModeVisitor::VisitExpr_(call_node);
+    OnDeviceProps props = GetOnDeviceProps(call_node);
+    if (props.body.defined()) {
+      int depth = MaxDepth({props.body});
+      if (depth >= 0) {
+        depth_[call_node] = depth;
+      }
+      return;
+    }
+    const auto* op_node = call_node->op.as<OpNode>();
+    if (op_node == nullptr || call_node->args.empty()) {
+      return;
+    }
+    Op op = GetRef<Op>(op_node);
+    if (op == shape_of_op_ || op == vm_shape_of_op_ || op == ndarray_size_op_) {
+      // Folded from the argument type alone, and without compiling anything costly.
+      if (call_node->args[0]->checked_type_.defined() &&
+          StaticTypeBytes(call_node->args[0]->checked_type()) >= 0) {
+        depth_[call_node] = 0;
+      }
+      return;
+    }
+    int depth = MaxDepth(call_node->args);
+    if (depth < 0 || !IsEvaluableOp(op)) {
+      return;
+    }
+    depth_[call_node] = depth + 1;
+    if (calls_.size() <= static_cast<size_t>(depth)) {
+      calls_.resize(depth + 1);
+    }
+    calls_[depth].push_back(GetRef<Call>(call_node));
+  }
+
+  void VisitExpr_(const FunctionNode* function_node) final {
+    // The folder leaves the primitive functions alone.
+    if (!function_node->HasNonzeroAttr(attr::kPrimitive)) {
+      ExprVisitor::VisitExpr_(function_node);
+    }
+  }
+
+  void VisitExpr_(const LetNode* let_node) final {
+    auto pre_visit = [this](const LetNode* op) {
+      this->VisitExpr(op->var);
+      this->VisitExpr(op->value);
+    };
+    auto post_visit = [this](const LetNode* op) {
+      this->VisitExpr(op->body);
+      this->visit_counter_[op] += 1;
+    };
+    ExpandANormalForm(let_node, pre_visit, post_visit);
+  }
+
+  /*! \brief Returns the maximum depth of \p exprs, or -1 if one of them will not be constant. */
+  int MaxDepth(const Array<Expr>& exprs) const {
+    int max_depth = 0;
+    for (const Expr& expr : exprs) {
+      auto it = depth_.find(expr.get());
+      if (it == depth_.end()) {
+        return -1;
+      }
+      max_depth = std::max(max_depth, it->second);
+    }
+    return max_depth;
+  }
+
+  const Op& shape_of_op_ = Op::Get("shape_of");
+  const Op& vm_shape_of_op_ = Op::Get("vm.shape_of");
+  const Op& ndarray_size_op_ = Op::Get("ndarray_size");
+  /*! \brief The depth of the expressions predicted to be constant, 0 for the leaves. */
+  std::unordered_map<const Object*, int> depth_;
+  /*! \brief The calls predicted to be evaluated, indexed by depth minus one. */
+  std::vector<std::vector<Call>> calls_;
+};
+
 // TODO(tvm-team) consider combine dead-code with constant folder.
 // or make a more powerful partial evaluator.
 class ConstantFolder : public MixedModeMutator {
  public:
-  explicit ConstantFolder(IRModule module)
+  /*!
+   * \brief Creates a folder.
+   * \param module The module of the folded expressions.
+   * \param max_constant_bytes A call is left alone if its value would be above this many bytes
+   * and larger than its arguments, or 0 for no limit.
+   */
+  explicit ConstantFolder(IRModule module, int64_t max_constant_bytes = 0)
       : module_(std::move(module)),
-        device_copy_op_(Op::Get("device_copy")),
+        max_constant_bytes_(max_constant_bytes),
         shape_of_op_(Op::Get("shape_of")),
         vm_shape_of_op_(Op::Get("vm.shape_of")),
         cast_op_(Op::Get("cast")),
         ndarray_size_op_(Op::Get("ndarray_size")) {}
 
+  /*!
+   * \brief Evaluates the calls of \p expr the folder will fold on \p num_threads threads, so
+   * that folding \p expr afterwards only looks up their values.
+   *
+   * The calls are evaluated by waves, each wave holding the calls whose arguments are all folded
+   * by the previous ones. The arguments are folded on the calling thread, so the memo is never
+   * shared. A call failing to evaluate is left for the folding itself, which reports the error.
+   */
+  void Prefold(const Expr& expr, int num_threads) {
+    for (const std::vector<Call>& wave : FoldableCallCollector().Collect(expr)) {
+      std::vector<std::pair<Call, Call>> todo;
+      for (const Call& pre_call : wave) {
+        Array<Expr> args;
+        for (const Expr& arg : pre_call->args) {
+          args.push_back(Mutate(arg));
+        }
+        if (!std::all_of(args.begin(), args.end(), IsComplexConstant)) {
+          continue;
+        }
+        Call post_call(pre_call->op, args, pre_call->attrs, pre_call->type_args, pre_call->span);
+        if (!ExceedsMaxConstantBytes(pre_call, post_call)) {
+          todo.emplace_back(pre_call, post_call);
+        }
+      }
+      std::vector<Expr> values(todo.size());
+      support::parallel_for_dynamic(0, todo.size(), std::min<int>(num_threads, todo.size()),
+                                    [&](int, int i) {
+                                      try {
+                                        values[i] = ConstEvaluate(todo[i].second);
+                                      } catch (const std::exception& e) {
+                                        VLOG(1) << "Prefolding failed: " << e.what();
+                                      }
+                                    });
+      for (size_t i = 0; i < todo.size(); ++i) {
+        if (values[i].defined()) {
+          prefolded_.emplace(todo[i].first, values[i]);
+        }
+      }
+    }
+  }
+
  private:
   using ExprMutator::VisitExpr_;
 
@@ -157,19 +443,12 @@ class ConstantFolder : public MixedModeMutator {
       return std::move(pre_call);
     }
 
-    static auto fnoncomputational = Op::GetAttrMap<TNonComputational>("TNonComputational");
-
     const auto* op_node = post_call->op.as<OpNode>();
     if (op_node == nullptr) {
       // Only evaluate primitives.
       return std::move(post_call);
     }
     Op op = GetRef<Op>(op_node);
-    static auto op_stateful = Op::GetAttrMap<TOpIsStateful>("TOpIsStateful");
-    if (op_stateful.get(op, false)) {
-      // skip stateful ops.
-      return std::move(post_call);
-    }
     // Try to evaluate shape_of and ndarray_size ops
     // Use the original call rather than new_call here since it still has valid checked_type
     // fields. These operators don't care about the value of their argument anyway.
@@ -181,15 +460,21 @@ class ConstantFolder : public MixedModeMutator {
     if (Optional<Expr> opt_result = EvaluateNdarraySize(pre_call)) {
       return opt_result.value();
     }
-    if ((fnoncomputational.count(op) && fnoncomputational[op]) || op == device_copy_op_ ||
-        op == shape_of_op_ || op == vm_shape_of_op_ || op == ndarray_size_op_) {
-      // We should think about potentially constant evaluation over these ops too.
+    if (!IsEvaluableOp(op)) {
       return std::move(post_call);
     }
     if (!std::all_of(post_call->args.begin(), post_call->args.end(), IsComplexConstant)) {
       // At least one non-constant argument.
       return std::move(post_call);
     }
+    if (ExceedsMaxConstantBytes(pre_call, post_call)) {
+      VLOG(1) << "Not folding " << op->name << " above the constant size limit";
+      return std::move(post_call);
+    }
+    auto it = prefolded_.find(pre_call);
+    if (it != prefolded_.end()) {
+      return it->second;
+    }
     // During evaluation we have obviously lost all on_device annotations. However any
     // on_device wrapping this call will be left in place.
     return ConstEvaluate(post_call);
@@ -254,12 +539,63 @@ class ConstantFolder : public MixedModeMutator {
     // needed for both execution and creation(due to JIT)
     With<transform::PassContext> fresh_build_ctx(transform::PassContext::Create());
 
-    Expr result = ObjectToExpr(
-        Eval(expr, module_->type_definitions, module_->Imports(), eval_cpu_dev_, eval_cpu_target_));
+    ObjectRef value = EvalDirect(expr, eval_cpu_dev_);
+    if (!value.defined()) {
+      value = EvaluateWithKernel(expr);
+    }
+    if (!value.defined()) {
+      value =
+          Eval(expr, module_->type_definitions, module_->Imports(), eval_cpu_dev_, eval_cpu_target_);
+    }
+    Expr result = ObjectToExpr(value);
     VLOG(1) << "Evaluated to constant:" << std::endl << PrettyPrint(result);
     return result;
   }
 
+  /*!
+   * \brief Returns the value of \p expr if it is a call to a primitive operator on tensor
+   * constants, applying the kernel cached for its signature. Returns null otherwise.
+   */
+  ObjectRef EvaluateWithKernel(const Expr& expr) {
+    const auto* call_node = expr.as<CallNode>();
+    if (call_node == nullptr || !call_node->op->IsInstance<OpNode>()) {
+      return {};
+    }
+    Array<Var> params;
+    Array<Expr> args;
+    for (const Expr& arg : call_node->args) {
+      const auto* const_node = AsIgnoringOnDevice<ConstantNode>(arg);
+      if (const_node == nullptr) {
+        return {};
+      }
+      params.push_back(Var("p" + std::to_string(params.size()), const_node->tensor_type()));
+      args.push_back(GetRef<Constant>(const_node));
+    }
+    Function signature(params, Call(call_node->op, {params.begin(), params.end()}, call_node->attrs,
+                                    call_node->type_args),
+                       Type(), {});
+    return FoldKernelCache::Global()->Run(signature, args, eval_cpu_dev_, eval_cpu_target_);
+  }
+
+  /*!
+   * \brief Returns whether the value of \p post_call is above the size limit and larger than its
+   * arguments, using the type of \p pre_call.
+   */
+  bool ExceedsMaxConstantBytes(const Call& pre_call, const Call& post_call) const {
+    if (max_constant_bytes_ <= 0 || !pre_call->checked_type_.defined()) {
+      return false;
+    }
+    int64_t num_bytes = StaticTypeBytes(pre_call->checked_type());
+    if (num_bytes <= max_constant_bytes_) {
+      return false;
+    }
+    int64_t arg_bytes = 0;
+    for (const Expr& arg : post_call->args) {
+      arg_bytes += ConstantBytes(arg);
+    }
+    return num_bytes > arg_bytes;
+  }
+
   /*!
    * \brief Returns constant shape result of \p call if it of form \p shape_of(e) and \p e has
    * a non-dynamic tensor shape. Returns null otherwise.
@@ -378,6 +714,11 @@ class ConstantFolder : public MixedModeMutator {
 
   // Module
   IRModule module_;
+  // The size in bytes above which the values larger than their arguments are not folded, 0 for no
+  // limit.
+  int64_t max_constant_bytes_;
+  // The values of the calls evaluated by Prefold.
+  std::unordered_map<Call, Expr, ObjectPtrHash, ObjectPtrEqual> prefolded_;
 
   // The kDLCPU device assumed to be available to the compiler. Used only when evaluating
   // sub-expressions.
@@ -387,7 +728,6 @@ class ConstantFolder : public MixedModeMutator {
   Target eval_cpu_target_{"llvm"};
 
   // Cache the following ops for equivalence checking in this pass.
-  const Op& device_copy_op_;
   const Op& shape_of_op_;
   const Op& vm_shape_of_op_;
   const Op& cast_op_;
@@ -412,7 +752,21 @@ TVM_REGISTER_GLOBAL("relay.analysis.check_constant").set_body_typed(IsComplexCon
 Expr FoldConstantExpr(const Expr& expr, const IRModule& mod) {
   VLOG_CONTEXT << "FoldConstantExpr";
   VLOG(1) << "folding:" << std::endl << PrettyPrint(expr);
-  Expr result = ConstantFolder(mod).VisitExpr(expr);
+  PassContext pass_ctx = PassContext::Current();
+  int num_threads =
+      pass_ctx->GetConfig<Integer>("relay.FoldConstant.num_threads", Integer(1)).value();
+  if (num_threads == 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  int64_t max_constant_bytes =
+      pass_ctx->GetConfig<Integer>("relay.FoldConstant.max_constant_bytes", Integer(0))
+          .value()
+          ->value;
+  ConstantFolder folder(mod, max_constant_bytes);
+  if (num_threads > 1) {
+    folder.Prefold(expr, num_threads);
+  }
+  Expr result = folder.VisitExpr(expr);
   VLOG(1) << "folded to:" << std::endl << PrettyPrint(result);
   return result;
 }
@@ -0,0 +1,262 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/transforms/fuse_boundary_ops.cc
+ *
+ * \brief After the graph is partitioned, the injective ops left between the external functions
+ * run as separate TVM kernels, each reading and writing its tensors in memory. This pass moves
+ * such an op into the external function it feeds or is fed by, when the codegen of the function
+ * supports it, so that the codegen fuses it with its neighbours.
+ *
+ * An op is supported when the "target.<compiler>" attribute of the op accepts the call, or when
+ * it is a composite function of the patterns of the codegen, named "<compiler>.*", made of
+ * injective ops. The injective ops that remain between two external functions are fused into
+ * TVM kernels by FuseOps as usual.
+ */
+
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/annotation.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace relay {
+namespace fuse_boundary_ops {
+
+// Whether an expression is a call of an op no more complex than injective.
+bool IsInjectiveOp(const Expr& op) {
+  static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+  const auto* op_node = op.as<OpNode>();
+  return op_node != nullptr && fpattern.count(GetRef<Op>(op_node)) &&
+         fpattern[GetRef<Op>(op_node)] <= kInjective;
+}
+
+// Whether the codegen of a compiler supports a call of the graph, keeping a tensor result.
+bool IsSupported(const CallNode* call, const std::string& compiler) {
+  if (!call->checked_type_.defined() || !call->checked_type().as<TensorTypeNode>()) return false;
+  if (IsInjectiveOp(call->op)) {
+    if (!Op::HasAttrMap("target." + compiler)) return false;
+    auto fannotate = Op::GetAttrMap<FTVMAnnotateTarget>("target." + compiler);
+    Op op = Downcast<Op>(call->op);
+    return fannotate.count(op) && fannotate[op](GetRef<Call>(call));
+  }
+  const auto* fn = call->op.as<FunctionNode>();
+  if (fn == nullptr) return false;
+  Optional<String> composite = fn->GetAttr<String>(attr::kComposite);
+  if (!composite || composite.value().operator std::string().rfind(compiler + ".", 0) != 0) {
+    return false;
+  }
+  bool injective = true;
+  PostOrderVisit(fn->body, [&injective](const Expr& expr) {
+    if (const auto* inner = expr.as<CallNode>()) injective &= IsInjectiveOp(inner->op);
+  });
+  return injective;
+}
+
+// Count the uses of the expressions of a function.
+class UseCounter : public ExprVisitor {
+ public:
+  std::unordered_map<const Object*, size_t> Count(const Expr& expr) {
+    VisitExpr(expr);
+    std::unordered_map<const Object*, size_t> counts;
+    for (const auto& it : visit_counter_) {
+      counts[it.first] = it.second;
+    }
+    return counts;
+  }
+};
+
+class BoundaryOpFuser : public ExprMutator {
+ public:
+  BoundaryOpFuser(const IRModule& mod, const std::unordered_map<const Object*, size_t>& use_counts,
+                  const std::unordered_map<const Object*, size_t>& call_counts,
+                  std::unordered_map<GlobalVar, Function, ObjectPtrHash, ObjectPtrEqual>* updates)
+      : mod_(mod), use_counts_(use_counts), call_counts_(call_counts), updates_(updates) {}
+
+  Expr VisitExpr_(const CallNode* pre) final {
+    Expr post = ExprMutator::VisitExpr_(pre);
+    const auto* call = post.as<CallNode>();
+    if (call == nullptr) return post;
+    std::string compiler;
+    if (GetExternal(call->op, &compiler)) {
+      return FuseProducers(pre, call, compiler);
+    }
+    return FuseConsumer(pre, call);
+  }
+
+ private:
+  // Whether an expression is an external function called once, and its compiler.
+  bool GetExternal(const Expr& op, std::string* compiler) {
+    const auto* gv = op.as<GlobalVarNode>();
+    if (gv == nullptr || call_counts_.count(gv) == 0 || call_counts_.at(gv) != 1) return false;
+    const auto* fn = mod_->Lookup(GetRef<GlobalVar>(gv)).as<FunctionNode>();
+    if (fn == nullptr) return false;
+    Optional<String> name = fn->GetAttr<String>(attr::kCompiler);
+    if (!name) return false;
+    *compiler = name.value();
+    return true;
+  }
+
+  Function GetFunction(const GlobalVar& gv) {
+    auto it = updates_->find(gv);
+    return it != updates_->end() ? it->second : Downcast<Function>(mod_->Lookup(gv));
+  }
+
+  size_t UseCount(const Expr& expr) const {
+    auto it = use_counts_.find(expr.get());
+    return it == use_counts_.end() ? 0 : it->second;
+  }
+
+  // Move the supported calls only feeding an external function into it. Their arguments become
+  // the arguments of the external function, except the constants that the function binds.
+  Expr FuseProducers(const CallNode* pre, const CallNode* call, const std::string& compiler) {
+    GlobalVar gv = Downcast<GlobalVar>(call->op);
+    Function func = GetFunction(gv);
+    Array<Var> params;
+    Array<Expr> args;
+    Map<Var, Expr> binds;
+    for (size_t i = 0; i < call->args.size(); ++i) {
+      const auto* pre_arg = pre->args[i].as<CallNode>();
+      const auto* arg = call->args[i].as<CallNode>();
+      if (pre_arg == nullptr || arg == nullptr || UseCount(pre->args[i]) != 1 ||
+          !IsSupported(pre_arg, compiler)) {
+        params.push_back(func->params[i]);
+        args.push_back(call->args[i]);
+        continue;
+      }
+      Array<Expr> inner_args;
+      for (size_t j = 0; j < arg->args.size(); ++j) {
+        if (arg->args[j].as<ConstantNode>()) {
+          inner_args.push_back(arg->args[j]);
+          continue;
+        }
+        Var param(func->params[i]->name_hint() + "_in" + std::to_string(j),
+                  pre_arg->args[j]->checked_type());
+        params.push_back(param);
+        args.push_back(arg->args[j]);
+        inner_args.push_back(param);
+      }
+      binds.Set(func->params[i], Call(arg->op, inner_args, arg->attrs, arg->type_args));
+    }
+    if (binds.empty()) return GetRef<Call>(call);
+    (*updates_)[gv] = Function(params, Bind(func->body, binds), func->ret_type,
+                               func->type_params, func->attrs);
+    return Call(gv, args, call->attrs, call->type_args);
+  }
+
+  // Move a supported call into the external function feeding it, when its other arguments are
+  // constants and it is the only user of the external function.
+  Expr FuseConsumer(const CallNode* pre, const CallNode* call) {
+    int ext_index = -1;
+    std::string compiler;
+    for (size_t i = 0; i < call->args.size(); ++i) {
+      if (call->args[i].as<ConstantNode>()) continue;
+      const auto* arg = call->args[i].as<CallNode>();
+      if (ext_index >= 0 || arg == nullptr || !GetExternal(arg->op, &compiler) ||
+          UseCount(pre->args[i]) != 1 || !pre->args[i]->checked_type().as<TensorTypeNode>()) {
+        return GetRef<Call>(call);
+      }
+      ext_index = static_cast<int>(i);
+    }
+    if (ext_index < 0 || !IsSupported(pre, compiler)) return GetRef<Call>(call);
+
+    const auto* ext_call = call->args[ext_index].as<CallNode>();
+    GlobalVar gv = Downcast<GlobalVar>(ext_call->op);
+    Function func = GetFunction(gv);
+    Array<Expr> inner_args = call->args;
+    inner_args.Set(ext_index, func->body);
+    Call body(call->op, inner_args, call->attrs, call->type_args);
+    (*updates_)[gv] = Function(func->params, body, Type(), func->type_params, func->attrs);
+    return Call(gv, ext_call->args, ext_call->attrs, ext_call->type_args);
+  }
+
+  const IRModule& mod_;
+  const std::unordered_map<const Object*, size_t>& use_counts_;
+  const std::unordered_map<const Object*, size_t>& call_counts_;
+  std::unordered_map<GlobalVar, Function, ObjectPtrHash, ObjectPtrEqual>* updates_;
+};
+
+IRModule FuseBoundaryOps(IRModule mod) {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    // The external functions are only moved ops into when a single call site uses them.
+    std::unordered_map<const Object*, size_t> call_counts;
+    for (const auto& it : mod->functions) {
+      if (const auto* fn = it.second.as<FunctionNode>()) {
+        PostOrderVisit(fn->body, [&call_counts](const Expr& expr) {
+          if (const auto* call = expr.as<CallNode>()) {
+            if (call->op.as<GlobalVarNode>()) ++call_counts[call->op.get()];
+          }
+        });
+      }
+    }
+
+    std::unordered_map<GlobalVar, Function, ObjectPtrHash, ObjectPtrEqual> updates;
+    std::vector<std::pair<GlobalVar, Function>> callers;
+    for (const auto& it : mod->functions) {
+      const auto* fn = it.second.as<FunctionNode>();
+      if (fn == nullptr || fn->GetAttr<String>(attr::kCompiler).defined()) continue;
+      auto use_counts = UseCounter().Count(fn->body);
+      BoundaryOpFuser fuser(mod, use_counts, call_counts, &updates);
+      Expr body = fuser.Mutate(fn->body);
+      if (!body.same_as(fn->body)) {
+        callers.emplace_back(it.first, WithFields(GetRef<Function>(fn), fn->params, body));
+      }
+    }
+    for (const auto& it : callers) {
+      mod->Update(it.first, it.second);
+    }
+    for (const auto& it : updates) {
+      mod->Update(it.first, it.second);
+    }
+    if (!updates.empty()) {
+      mod = transform::InferType()(mod);
+      changed = true;
+    }
+  }
+  return mod;
+}
+
+}  // namespace fuse_boundary_ops
+
+namespace transform {
+
+Pass FuseBoundaryOps() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule m,
+                                                                            PassContext pc) {
+    return fuse_boundary_ops::FuseBoundaryOps(m);
+  };
+  auto fuse_pass = CreateModulePass(pass_func, 0, "FuseBoundaryOps", {"InferType"});
+  return Sequential({InferType(), fuse_pass, InferType()}, "FuseBoundaryOps");
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.FuseBoundaryOps").set_body_typed(transform::FuseBoundaryOps);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
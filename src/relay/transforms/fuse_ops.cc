@@ -85,6 +85,8 @@ constexpr uint32_t kMaxFusedOps = 256;
 static const Op& stop_fusion_op = Op::Get("annotation.stop_fusion");
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.FuseOps.max_depth", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FuseOps.horizontal", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FuseOps.fuse_layout_transform", Bool);
 
 /*!
  * \brief Indexed data flow graph in forward direction.
@@ -226,7 +228,45 @@ class IndexedForwardGraph::Creator : private ExprVisitor {
     }
   }
 
-  void VisitExpr_(const CallNode* call) final {
+  // Visit the dataflow nodes without recursion, so deep graphs do not overflow the stack.
+  // As in a recursive visit, a dataflow node adds its edges when it is expanded, before its
+  // inputs are visited, and it is added to the graph after them.
+  void VisitExpr(const Expr& expr) final {
+    if (visit_counter_.count(expr.get())) return;
+    auto fcheck_visited = [this](const Expr& expr) {
+      return visit_counter_.count(expr.get()) != 0;
+    };
+    auto fvisit_leaf = [this](const Expr& expr) {
+      if (expr.as<CallNode>() || expr.as<TupleNode>() || expr.as<TupleGetItemNode>()) {
+        this->AddNode(expr.get());
+        visit_counter_.emplace(expr.get(), 1);
+      } else {
+        ExprVisitor::VisitExpr(expr);
+      }
+    };
+    auto fexpand_expr = [this](const Expr& expr) {
+      std::vector<Expr> inputs;
+      if (const CallNode* call = expr.as<CallNode>()) {
+        this->ExpandCall(call);
+        for (auto it = call->args.rbegin(); it != call->args.rend(); ++it) {
+          inputs.push_back(*it);
+        }
+        inputs.push_back(call->op);
+      } else if (const TupleNode* tuple = expr.as<TupleNode>()) {
+        this->ExpandTuple(tuple);
+        for (auto it = tuple->fields.rbegin(); it != tuple->fields.rend(); ++it) {
+          inputs.push_back(*it);
+        }
+      } else if (const TupleGetItemNode* get_item = expr.as<TupleGetItemNode>()) {
+        this->ExpandTupleGetItem(get_item);
+        inputs.push_back(get_item->tuple);
+      }
+      return inputs;
+    };
+    ExpandDataflow(expr, fcheck_visited, fvisit_leaf, fexpand_expr);
+  }
+
+  void ExpandCall(const CallNode* call) {
     ICHECK(graph_.node_map.count(call));
     Node* node = graph_.node_map.at(call);
     static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
@@ -266,11 +306,9 @@ class IndexedForwardGraph::Creator : private ExprVisitor {
       }
       this->Update(call->args[i], node, edge_pattern);
     }
-    ExprVisitor::VisitExpr_(call);
-    this->AddNode(call);
   }
 
-  void VisitExpr_(const TupleNode* op) final {
+  void ExpandTuple(const TupleNode* op) {
     ICHECK(graph_.node_map.count(op));
     Node* tuple_node = graph_.node_map.at(op);
     tuple_node->pattern = kTuple;
@@ -281,18 +319,16 @@ class IndexedForwardGraph::Creator : private ExprVisitor {
         this->Update(field, nullptr, kOpaque);
       }
     }
-    ExprVisitor::VisitExpr_(op);
-    this->AddNode(op);
   }
 
-  void VisitExpr_(const TupleGetItemNode* op) final {
+  void ExpandTupleGetItem(const TupleGetItemNode* op) {
     auto tuple_type = op->tuple->checked_type().as<TupleTypeNode>();
     ICHECK(tuple_type);
     // When TVM lowers a fused function, it expects all arguments to be a Tensor or
     // a tuple containing only Tensors. But this tuple may contain a reference or
     // another tuple. To avoid modifying codegen logic, we do not allow fusing through this node
-    // if the tuple contains such non Tensor fields. However, all fields will be recursively
-    // visited via call to ExprVisitor::VisitExpr_(op) below and corresponding visitor methods.
+    // if the tuple contains such non Tensor fields. However, all fields will still be
+    // visited as the inputs of the node, by the corresponding visitor methods.
     bool has_non_tensor = false;
     for (auto ty : tuple_type->fields) {
       if (!ty.as<TensorTypeNode>()) {
@@ -308,8 +344,6 @@ class IndexedForwardGraph::Creator : private ExprVisitor {
       node->pattern = kInjective;
       this->Update(op->tuple, node, kInjective);
     }
-    ExprVisitor::VisitExpr_(op);
-    this->AddNode(op);
   }
 
   void VisitExpr_(const VarNode* op) final { this->AddNode(op); }
@@ -508,8 +542,12 @@ DominatorTree DominatorTree::PostDom(support::Arena* arena, const IndexedForward
  */
 class GraphPartitioner {
  public:
-  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth)
-      : arena_(arena), opt_level_(opt_level), max_fuse_depth_(max_fuse_depth) {}
+  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth,
+                            bool fuse_layout_transform = false)
+      : arena_(arena),
+        opt_level_(opt_level),
+        max_fuse_depth_(max_fuse_depth),
+        fuse_layout_transform_(fuse_layout_transform) {}
   /*!
    * \brief Group as a union find data structure.
    */
@@ -563,6 +601,8 @@ class GraphPartitioner {
   int opt_level_;
   /*! \brief The maximum number of operations in one fused function */
   size_t max_fuse_depth_;
+  /*! \brief Whether to fuse the layout transforms into the anchor ops reading them. */
+  bool fuse_layout_transform_;
   /*! \brief The internal groups. */
   std::vector<Group*> groups_;
   /*! \brief internal field used for deduplication */
@@ -683,6 +723,28 @@ class GraphPartitioner {
     return target->FindRoot()->num_nodes + CountNodesUptoSink_(child, dom_parent);
   }
 
+  // Fuse a layout transform into the anchor op reading it as its data input, so that the anchor
+  // reads the input through the index mapping of the transform rather than a transformed copy.
+  bool FuseLayoutTransformIntoAnchor(IndexedForwardGraph::Node* graph_node,
+                                     IndexedForwardGraph::Node* consumer) {
+    static const Op& layout_transform_op = Op::Get("layout_transform");
+    const auto* call = static_cast<const CallNode*>(graph_node->ref);
+    if (!graph_node->ref->IsInstance<CallNode>() || !call->op.same_as(layout_transform_op)) {
+      return false;
+    }
+    // The transform group has no anchor of its own, and only feeds the consumer.
+    if (groups_[graph_node->index]->FindRoot()->pattern > kInjective) return false;
+    auto* link = graph_node->outputs.head;
+    if (link == nullptr || link->next != nullptr || link->value.node != consumer) return false;
+    if (consumer->pattern != kOutEWiseFusable || !consumer->ref->IsInstance<CallNode>()) {
+      return false;
+    }
+    const auto* consumer_call = static_cast<const CallNode*>(consumer->ref);
+    if (consumer_call->args.empty() || consumer_call->args[0].get() != call) return false;
+    CommitFuse(graph_node, consumer);
+    return true;
+  }
+
   // Initialize the groups.
   void InitGroups(const IndexedForwardGraph& graph) {
     groups_.resize(graph.post_dfs_order.size());
@@ -781,6 +843,10 @@ class GraphPartitioner {
         // defer injective fusion to second phase.
         // so conv2d always finishes fusing.
         if (phase != 1) continue;
+        if (fuse_layout_transform_ &&
+            FuseLayoutTransformIntoAnchor(graph_node, dom_node->parent->gnode)) {
+          continue;
+        }
         // Check if all path are injective.
         auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
         if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
@@ -810,10 +876,13 @@ std::vector<GraphPartitioner::Group*> GraphPartitioner::Partition(
 class FuseMutator : private MixedModeMutator {
  public:
   // Run the transform
-  Expr Transform(const Expr& body, int fuse_opt_level, size_t max_fuse_depth) {
+  Expr Transform(const Expr& body, int fuse_opt_level, size_t max_fuse_depth,
+                 bool fuse_layout_transform = false) {
     // setup the group map.
     auto graph = IndexedForwardGraph::Create(&arena_, body);
-    auto groups = GraphPartitioner(&arena_, fuse_opt_level, max_fuse_depth).Partition(graph);
+    auto groups =
+        GraphPartitioner(&arena_, fuse_opt_level, max_fuse_depth, fuse_layout_transform)
+            .Partition(graph);
     for (size_t nid = 0; nid < graph.post_dfs_order.size(); ++nid) {
       ICHECK(graph.post_dfs_order[nid]->ref != nullptr);
       gmap_[graph.post_dfs_order[nid]->ref] = groups[nid];
@@ -1017,8 +1086,144 @@ class FuseMutator : private MixedModeMutator {
   }
 };
 
-Expr FuseOps(const Expr& expr, int fuse_opt_level, size_t max_fuse_depth, const IRModule& module) {
-  return FuseMutator().Transform(expr, fuse_opt_level, max_fuse_depth);
+/*!
+ * \brief Pack the independent injective kernels of a fused function into multi-output kernels,
+ * so that a group of small kernels running side by side, e.g. the per-head ops after a split,
+ * is launched by one call.
+ *
+ * Two kernels are packed when they read the same producer, return the same tensor type and
+ * have the same depth, the longest chain of kernels from the inputs. A kernel only depends on
+ * kernels of smaller depths, so kernels of the same depth are independent.
+ */
+class HorizontalFuser : private MixedModeMutator {
+ public:
+  Expr Transform(const Expr& body) {
+    bool has_let = false;
+    PostOrderVisit(body, [&has_let](const Expr& expr) { has_let |= expr->IsInstance<LetNode>(); });
+    // The depth of the kernels is only known in the dataflow form.
+    if (has_let) return body;
+
+    std::unordered_map<std::string, std::vector<const CallNode*>> candidates;
+    std::vector<std::string> keys;
+    PostOrderVisit(body, [&](const Expr& expr) {
+      size_t depth = 0;
+      if (const auto* call = expr.as<CallNode>()) {
+        for (const auto& arg : call->args) depth = std::max(depth, depth_[arg.get()]);
+        depth_[call] = depth + (call->op.as<OpNode>() ? 0 : 1);
+        std::string key = CandidateKey(call, depth_[call]);
+        if (key.empty()) return;
+        if (candidates.count(key) == 0) keys.push_back(key);
+        candidates[key].push_back(call);
+      } else if (const auto* tuple = expr.as<TupleNode>()) {
+        for (const auto& field : tuple->fields) depth = std::max(depth, depth_[field.get()]);
+        depth_[tuple] = depth;
+      } else if (const auto* get = expr.as<TupleGetItemNode>()) {
+        depth_[get] = depth_[get->tuple.get()];
+      }
+    });
+
+    for (const auto& key : keys) {
+      const auto& calls = candidates[key];
+      for (size_t begin = 0; begin + 1 < calls.size(); begin += kMaxHorizontalKernels) {
+        size_t end = std::min(calls.size(), begin + kMaxHorizontalKernels);
+        auto pack = std::make_shared<Pack>();
+        for (size_t i = begin; i < end; ++i) {
+          pack->calls.push_back(calls[i]);
+          packs_[calls[i]] = {pack, i - begin};
+        }
+      }
+    }
+    if (packs_.empty()) return body;
+    return this->Mutate(body);
+  }
+
+ private:
+  using MixedModeMutator::VisitExpr_;
+
+  /*! \brief The kernels packed together and the call of their multi-output kernel. */
+  struct Pack {
+    std::vector<const CallNode*> calls;
+    Expr packed_call;
+  };
+
+  // The key of the kernels a kernel can be packed with, empty when it cannot be packed.
+  std::string CandidateKey(const CallNode* call, size_t depth) {
+    const auto* fn = call->op.as<FunctionNode>();
+    if (fn == nullptr || !fn->HasNonzeroAttr(attr::kPrimitive) ||
+        fn->HasNonzeroAttr(attr::kReshapeOnly) || fn->GetAttr<String>(attr::kCompiler) ||
+        call->args.empty() || !fn->ret_type.defined() || !fn->ret_type.as<TensorTypeNode>()) {
+      return "";
+    }
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    bool injective = true;
+    PostOrderVisit(fn->body, [&injective](const Expr& expr) {
+      if (const auto* inner = expr.as<CallNode>()) {
+        const auto* op = inner->op.as<OpNode>();
+        injective &= op != nullptr && fpattern.get(GetRef<Op>(op), kOpaque) <= kInjective;
+      }
+    });
+    if (!injective) return "";
+    // The producer of the first argument, through the tuple accesses of a split.
+    Expr source = call->args[0];
+    while (const auto* get = source.as<TupleGetItemNode>()) source = get->tuple;
+    std::ostringstream os;
+    os << depth << "|" << source.get() << "|" << PrettyPrint(fn->ret_type);
+    return os.str();
+  }
+
+  Expr Rewrite_(const CallNode* call, const Expr& post) final {
+    auto it = packs_.find(call);
+    if (it == packs_.end()) return post;
+    Pack* pack = it->second.first.get();
+    if (!pack->packed_call.defined()) pack->packed_call = MakePackedCall(pack);
+    return TupleGetItem(pack->packed_call, it->second.second);
+  }
+
+  // Create the multi-output kernel of a pack, sharing the parameters of the same arguments.
+  Expr MakePackedCall(Pack* pack) {
+    Array<Var> params;
+    Array<Expr> args;
+    Array<Expr> fields;
+    Array<Type> field_types;
+    for (const CallNode* call : pack->calls) {
+      Function fn = Downcast<Function>(call->op);
+      Map<Var, Expr> binds;
+      for (size_t i = 0; i < call->args.size(); ++i) {
+        Expr arg = this->Mutate(call->args[i]);
+        size_t index = 0;
+        while (index < args.size() && !args[index].same_as(arg)) ++index;
+        if (index == args.size()) {
+          std::ostringstream os;
+          os << "p" << params.size();
+          params.push_back(Var(os.str(), fn->params[i]->type_annotation));
+          args.push_back(arg);
+        }
+        binds.Set(fn->params[i], params[index]);
+      }
+      fields.push_back(Bind(fn->body, binds));
+      field_types.push_back(fn->ret_type);
+    }
+    auto func = Function(params, Tuple(fields), TupleType(field_types), {});
+    func = WithAttr(std::move(func), attr::kPrimitive, tvm::Integer(1));
+    return Call(func, args, Attrs());
+  }
+
+  /*! \brief The maximum number of kernels packed together. */
+  static constexpr size_t kMaxHorizontalKernels = 16;
+  /*! \brief The longest chain of kernels from the inputs to each expression. */
+  std::unordered_map<const Object*, size_t> depth_;
+  /*! \brief The pack of each packed kernel, and the index of its output. */
+  std::unordered_map<const Object*, std::pair<std::shared_ptr<Pack>, size_t>> packs_;
+};
+
+Expr FuseOps(const Expr& expr, int fuse_opt_level, size_t max_fuse_depth, bool fuse_horizontal,
+             bool fuse_layout_transform, const IRModule& module) {
+  Expr fused =
+      FuseMutator().Transform(expr, fuse_opt_level, max_fuse_depth, fuse_layout_transform);
+  if (fuse_horizontal && fuse_opt_level >= 1) {
+    fused = HorizontalFuser().Transform(fused);
+  }
+  return fused;
 }
 
 namespace transform {
@@ -1028,7 +1233,12 @@ Pass FuseOps(int fuse_opt_level) {
       [=](Function f, IRModule m, PassContext pc) {
         int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
         auto max_fuse_depth = pc->GetConfig("relay.FuseOps.max_depth", Integer(kMaxFusedOps));
-        return Downcast<Function>(FuseOps(f, opt_level, max_fuse_depth.value(), m));
+        auto fuse_horizontal = pc->GetConfig("relay.FuseOps.horizontal", Bool(false));
+        auto fuse_layout_transform =
+            pc->GetConfig("relay.FuseOps.fuse_layout_transform", Bool(false));
+        return Downcast<Function>(FuseOps(f, opt_level, max_fuse_depth.value(),
+                                          fuse_horizontal.value(), fuse_layout_transform.value(),
+                                          m));
       };
   return CreateFunctionPass(pass_func, 0, "FuseOps", {"InferType"});
 }
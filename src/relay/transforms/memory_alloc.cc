@@ -34,6 +34,7 @@
 #include <tvm/relay/op.h>
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/vm/vm.h>
 #include <tvm/target/target.h>
 
 #include <cstdint>
@@ -330,9 +331,12 @@ class DialectRewriter : public transform::DeviceAwareExprMutator {
       out_shapes.push_back(alloc);
     }
 
-    // Represent the call in DPS form.
+    // Represent the call in DPS form. The call is marked so that the VM may memoize its outputs.
+    Map<String, ObjectRef> shape_func_attrs =
+        Downcast<DictAttrs>(attrs.metadata.at("relay_attrs"))->dict;
+    shape_func_attrs.Set(runtime::vm::kShapeFuncAttr, String("1"));
     auto shape_call = OnDevice(InvokeTVMOp(prim_fn_var, Tuple(shape_func_ins), Tuple(out_shapes),
-                                           Downcast<DictAttrs>(attrs.metadata.at("relay_attrs"))),
+                                           DictAttrs(shape_func_attrs)),
                                host_se_scope_, /*is_fixed=*/true);
     Var shape_func_var("shape_func", Type(nullptr));
     scope->Push(shape_func_var, shape_call);
@@ -0,0 +1,414 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/transforms/plan_static_storage.cc
+ * \brief A pass coalescing the statically sized storages allocated by ManifestAlloc.
+ *
+ * ManifestAlloc allocates a fresh storage for the result of every primitive call. Within a
+ * block of let bindings, the storages of a constant size whose tensors are no longer used
+ * can back the storages allocated after them. This pass assigns the storages of each block
+ * to shared storages, in the way GraphPlanMemory does for the graph executor, and allocates
+ * each shared storage once at the start of the block.
+ *
+ * The lifetime of a storage ends at the last binding referring to it or to a variable derived
+ * from it. A storage whose tensors may outlive the block, because they are part of its result,
+ * are captured by a closure, stored in a reference or passed to a Relay function, is never
+ * reused by a later storage.
+ *
+ * The result of a primitive call may also overwrite an argument it is allowed to alias, see
+ * backend::InPlaceParams, when the storage of that argument is not used after the call. This
+ * is enabled by the "relay.vm.plan_static_storage.in_place" option.
+ */
+
+#include <tvm/relay/attrs/memory.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../op/memory/memory.h"
+#include "../op/memory/on_device.h"
+#include "./pattern_utils.h"
+
+namespace tvm {
+namespace relay {
+namespace transform {
+
+namespace {
+
+/*! \brief The index of the bindings using the storages that may outlive their block. */
+constexpr size_t kOutlivesBlock = std::numeric_limits<size_t>::max();
+
+/*!
+ * \brief A storage is only shared with the storages of a size in [size / kMatchRange,
+ * size * kMatchRange], to bound the memory wasted by a large storage backing small ones.
+ */
+constexpr int64_t kMatchRange = 16;
+
+/*! \brief The index of no storage. */
+constexpr size_t kNoStorage = std::numeric_limits<size_t>::max();
+
+/*! \brief An "alloc_storage" binding of a constant size. */
+struct StaticStorage {
+  /*! \brief The index of the binding in its block. */
+  size_t binding;
+  /*! \brief The "alloc_storage" call, without its "on_device" annotation. */
+  Call call;
+  /*! \brief The size and the alignment in bytes. */
+  int64_t size;
+  int64_t alignment;
+  /*! \brief The index of the last binding using the storage. */
+  size_t last_use;
+  /*! \brief The shared storage backing this storage. */
+  size_t shared;
+  /*!
+   * \brief The storage of an argument of the call writing this storage which this storage may
+   * overwrite, and the index of that call, kNoStorage when there is none.
+   */
+  size_t overwrites = kNoStorage;
+  size_t overwriting_call = 0;
+};
+
+/*! \brief A storage backing several static storages with disjoint lifetimes. */
+struct SharedStorage {
+  /*! \brief The storage with the largest size, whose call is reused to allocate this one. */
+  size_t largest;
+  /*! \brief The size and the alignment in bytes, the largest of the backed storages. */
+  int64_t size;
+  int64_t alignment;
+  /*! \brief The index of the last binding using the current storage. */
+  size_t last_use;
+};
+
+/*! \return The value of a scalar int64 constant, or -1 if \p expr is not one. */
+int64_t GetConstantInt64(const Expr& expr) {
+  const auto* constant = IgnoreOnDevice(expr).as<ConstantNode>();
+  if (constant == nullptr || !constant->is_scalar() ||
+      constant->data->dtype.code != kDLInt || constant->data->dtype.bits != 64) {
+    return -1;
+  }
+  return reinterpret_cast<const int64_t*>(constant->data->data)[0];
+}
+
+/*!
+ * \brief Collects the variables a binding refers to, and whether it may let the tensors of
+ * these variables outlive the block.
+ */
+class VarUseCollector : public ExprVisitor {
+ public:
+  std::vector<const VarNode*> vars;
+  bool may_escape = false;
+
+  void VisitExpr_(const VarNode* op) final { vars.push_back(op); }
+
+  void VisitExpr_(const FunctionNode* op) final {
+    // Primitive functions do not capture anything, closures may be called after the block.
+    if (!op->HasNonzeroAttr(attr::kPrimitive)) {
+      may_escape = true;
+      ExprVisitor::VisitExpr_(op);
+    }
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (!op->op->IsInstance<OpNode>() && !op->op->IsInstance<ConstructorNode>()) {
+      may_escape = true;
+    }
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const RefCreateNode* op) final {
+    may_escape = true;
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const RefWriteNode* op) final {
+    may_escape = true;
+    ExprVisitor::VisitExpr_(op);
+  }
+};
+
+class StaticStoragePlanner : public ExprMutator {
+ public:
+  explicit StaticStoragePlanner(bool in_place) : in_place_(in_place) {}
+
+  Expr VisitExpr_(const FunctionNode* op) final {
+    if (op->HasNonzeroAttr(attr::kPrimitive)) {
+      return GetRef<Expr>(op);
+    }
+    return ExprMutator::VisitExpr_(op);
+  }
+
+  Expr VisitExpr_(const LetNode* op) final {
+    // Visit the blocks iteratively, they are long after ManifestAlloc.
+    std::vector<std::pair<Var, Expr>> bindings;
+    Expr expr = GetRef<Expr>(op);
+    while (const auto* let = expr.as<LetNode>()) {
+      bindings.emplace_back(let->var, VisitExpr(let->value));
+      expr = let->body;
+    }
+    return PlanBlock(std::move(bindings), VisitExpr(expr));
+  }
+
+ private:
+  Expr PlanBlock(std::vector<std::pair<Var, Expr>> bindings, Expr body) {
+    static const Op& alloc_storage_op = Op::Get("memory.alloc_storage");
+    static const Op& invoke_tvm_op = Op::Get("vm.invoke_tvm_op");
+    std::vector<StaticStorage> storages;
+    // The storages each variable may refer to the tensors of.
+    std::unordered_map<const VarNode*, std::vector<size_t>> var_storages;
+    auto use = [&](const std::vector<const VarNode*>& vars, size_t binding,
+                   std::vector<size_t>* derived) {
+      for (const VarNode* var : vars) {
+        auto it = var_storages.find(var);
+        if (it == var_storages.end()) continue;
+        for (size_t storage : it->second) {
+          size_t& last_use = storages[storage].last_use;
+          last_use = last_use == kOutlivesBlock ? last_use : std::max(last_use, binding);
+          if (derived != nullptr) derived->push_back(storage);
+        }
+      }
+    };
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      const Expr& value = bindings[i].second;
+      const auto* call = IgnoreOnDevice(value).as<CallNode>();
+      if (call != nullptr && call->op == alloc_storage_op) {
+        int64_t size = GetConstantInt64(call->args[0]);
+        int64_t alignment = GetConstantInt64(call->args[1]);
+        if (size >= 0 && alignment > 0) {
+          var_storages[bindings[i].first.get()] = {storages.size()};
+          storages.push_back({i, GetRef<Call>(call), size, alignment, i, 0});
+          continue;
+        }
+      }
+      if (in_place_ && call != nullptr && call->op == invoke_tvm_op) {
+        FindInPlaceStorage(call, i, var_storages, &storages);
+      }
+      VarUseCollector collector;
+      collector.VisitExpr(value);
+      std::vector<size_t> derived;
+      use(collector.vars, i, &derived);
+      if (collector.may_escape) {
+        for (size_t storage : derived) storages[storage].last_use = kOutlivesBlock;
+      }
+      if (!derived.empty()) {
+        std::sort(derived.begin(), derived.end());
+        derived.erase(std::unique(derived.begin(), derived.end()), derived.end());
+        var_storages[bindings[i].first.get()] = std::move(derived);
+      }
+    }
+    VarUseCollector collector;
+    collector.VisitExpr(body);
+    std::vector<size_t> derived;
+    use(collector.vars, bindings.size(), &derived);
+    for (size_t storage : derived) storages[storage].last_use = kOutlivesBlock;
+
+    std::vector<SharedStorage> shared = Share(&storages);
+    if (shared.size() == storages.size()) {
+      return Rebuild(bindings, body);
+    }
+
+    // Allocate the shared storages at the start of the block, in place of the storages.
+    std::vector<std::pair<Var, Expr>> new_bindings;
+    std::vector<Var> shared_vars;
+    for (size_t i = 0; i < shared.size(); ++i) {
+      const StaticStorage& largest = storages[shared[i].largest];
+      const Expr& value = bindings[largest.binding].second;
+      const Call& call = largest.call;
+      Expr size = MakeConstantScalar(DataType::Int(64), shared[i].size);
+      OnDeviceProps size_props = GetOnDeviceProps(call->args[0]);
+      if (size_props.body.defined()) {
+        size = OnDevice(size, size_props.se_scope, size_props.is_fixed);
+      }
+      Expr alignment = MakeConstantScalar(DataType::Int(64), shared[i].alignment);
+      Expr alloc = Call(call->op, {size, alignment}, call->attrs, call->type_args, call->span);
+      OnDeviceProps props = GetOnDeviceProps(value);
+      if (props.body.defined()) {
+        alloc = OnDevice(alloc, props.se_scope, props.is_fixed);
+      }
+      Var var("storage_shared_" + std::to_string(i), Type(nullptr));
+      new_bindings.emplace_back(var, alloc);
+      shared_vars.push_back(var);
+    }
+    Map<Var, Expr> binds;
+    std::vector<bool> removed(bindings.size(), false);
+    for (const StaticStorage& storage : storages) {
+      binds.Set(bindings[storage.binding].first, shared_vars[storage.shared]);
+      removed[storage.binding] = true;
+    }
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      if (!removed[i]) {
+        new_bindings.emplace_back(bindings[i].first, Bind(bindings[i].second, binds));
+      }
+    }
+    VLOG(1) << "PlanStaticStorage: " << storages.size() << " static storages backed by "
+            << shared.size() << " shared storages";
+    return Rebuild(new_bindings, Bind(body, binds));
+  }
+
+  /*!
+   * \brief Record the storage of the result of an "invoke_tvm_op" call may overwrite the storage
+   * of an argument, when the primitive allows it and both storages hold a single tensor of the
+   * same size.
+   */
+  static void FindInPlaceStorage(
+      const CallNode* call, size_t binding,
+      const std::unordered_map<const VarNode*, std::vector<size_t>>& var_storages,
+      std::vector<StaticStorage>* storages) {
+    const auto* attrs = call->attrs.as<DictAttrsNode>();
+    const auto* ins = call->args[1].as<TupleNode>();
+    const auto* outs = call->args[2].as<TupleNode>();
+    if (attrs == nullptr || ins == nullptr || outs == nullptr || outs->fields.size() != 1) return;
+    auto single_storage = [&](const Expr& expr) {
+      const auto* var = expr.as<VarNode>();
+      auto it = var == nullptr ? var_storages.end() : var_storages.find(var);
+      return it == var_storages.end() || it->second.size() != 1 ? kNoStorage : it->second[0];
+    };
+    size_t out = single_storage(outs->fields[0]);
+    if (out == kNoStorage) return;
+    Array<Integer> in_place_params = GetRef<DictAttrs>(attrs)
+                                         .GetAttr<Array<Integer>>(attr::kInPlaceParams)
+                                         .value_or(Array<Integer>());
+    for (const Integer& index : in_place_params) {
+      if (index->value < 0 || static_cast<size_t>(index->value) >= ins->fields.size()) continue;
+      size_t in = single_storage(ins->fields[index->value]);
+      if (in != kNoStorage && in != out && (*storages)[in].size == (*storages)[out].size) {
+        (*storages)[out].overwrites = in;
+        (*storages)[out].overwriting_call = binding;
+        return;
+      }
+    }
+  }
+
+  /*!
+   * \brief Assign the storages to shared storages, in the order of their bindings, each
+   * to the best fitting shared storage whose storages are no longer used.
+   *
+   * A storage which may overwrite the storage of an argument of the call writing it is
+   * assigned to the shared storage of that argument, when the call is its last use.
+   */
+  std::vector<SharedStorage> Share(std::vector<StaticStorage>* storages) {
+    std::vector<SharedStorage> shared;
+    for (size_t i = 0; i < storages->size(); ++i) {
+      StaticStorage& storage = (*storages)[i];
+      if (storage.overwrites < i) {
+        const StaticStorage& input = (*storages)[storage.overwrites];
+        SharedStorage& target = shared[input.shared];
+        if (input.last_use == storage.overwriting_call &&
+            target.last_use == storage.overwriting_call &&
+            Compatible((*storages)[target.largest], storage)) {
+          storage.shared = input.shared;
+          target.alignment = std::max(target.alignment, storage.alignment);
+          target.last_use = storage.last_use;
+          continue;
+        }
+      }
+      int best = -1;
+      for (size_t j = 0; j < shared.size(); ++j) {
+        const SharedStorage& candidate = shared[j];
+        if (candidate.last_use >= storage.binding ||
+            candidate.size > storage.size * kMatchRange ||
+            candidate.size * kMatchRange < storage.size ||
+            !Compatible((*storages)[candidate.largest], storage)) {
+          continue;
+        }
+        // The smallest storage large enough, otherwise the largest one.
+        if (best < 0) {
+          best = static_cast<int>(j);
+          continue;
+        }
+        int64_t best_size = shared[best].size;
+        bool fits = candidate.size >= storage.size;
+        bool best_fits = best_size >= storage.size;
+        if (fits ? (!best_fits || candidate.size < best_size)
+                 : (!best_fits && candidate.size > best_size)) {
+          best = static_cast<int>(j);
+        }
+      }
+      if (best < 0) {
+        storage.shared = shared.size();
+        shared.push_back({i, storage.size, storage.alignment, storage.last_use});
+        continue;
+      }
+      SharedStorage& target = shared[best];
+      storage.shared = best;
+      if (storage.size > target.size) {
+        target.size = storage.size;
+        target.largest = i;
+      }
+      target.alignment = std::max(target.alignment, storage.alignment);
+      target.last_use = storage.last_use;
+    }
+    return shared;
+  }
+
+  /*! \return Whether two storages have the same dtype and scope, and sizes annotated alike. */
+  static bool Compatible(const StaticStorage& a, const StaticStorage& b) {
+    const auto* a_attrs = a.call->attrs.as<AllocStorageAttrs>();
+    const auto* b_attrs = b.call->attrs.as<AllocStorageAttrs>();
+    return a_attrs->dtype == b_attrs->dtype &&
+           StructuralEqual()(a_attrs->se_scope, b_attrs->se_scope) &&
+           SameSizeAnnotation(a.call->args[0], b.call->args[0]);
+  }
+
+  /*! \return Whether the sizes of two storages are annotated alike. */
+  static bool SameSizeAnnotation(const Expr& a, const Expr& b) {
+    OnDeviceProps a_props = GetOnDeviceProps(a);
+    OnDeviceProps b_props = GetOnDeviceProps(b);
+    return a_props.body.defined() == b_props.body.defined() &&
+           a_props.is_fixed == b_props.is_fixed &&
+           StructuralEqual()(a_props.se_scope, b_props.se_scope);
+  }
+
+  static Expr Rebuild(const std::vector<std::pair<Var, Expr>>& bindings, Expr body) {
+    for (auto it = bindings.rbegin(); it != bindings.rend(); ++it) {
+      body = Let(it->first, it->second, body);
+    }
+    return body;
+  }
+
+  /*! \brief Whether the result of a call may overwrite the storage of an argument. */
+  bool in_place_;
+};
+
+}  // namespace
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.vm.plan_static_storage.in_place", Bool);
+
+Pass PlanStaticStorage() {
+  auto pass_func = [](Function func, IRModule mod, PassContext ctxt) {
+    bool in_place =
+        ctxt->GetConfig<Bool>("relay.vm.plan_static_storage.in_place", Bool(false)).value();
+    return Downcast<Function>(StaticStoragePlanner(in_place).Mutate(func));
+  };
+  return Sequential({CreateFunctionPass(pass_func, 0, "PlanStaticStorageImpl", {}), InferType()},
+                    "PlanStaticStorage");
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.PlanStaticStorage").set_body_typed(PlanStaticStorage);
+
+}  // namespace transform
+}  // namespace relay
+}  // namespace tvm
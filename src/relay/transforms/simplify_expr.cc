@@ -585,6 +585,89 @@ class EliminateIdentityRewrite : public DFPatternRewrite {
   DFPattern const_;
 };
 
+/*!
+ * \brief SimplifyAttention matches scaled dot product attention written as batch_matmul,
+ *   softmax and batch_matmul, and replaces it by one fused_attention op, whose implementations
+ *   never store the attention matrix.
+ */
+class SimplifyAttention : public DFPatternRewrite {
+ public:
+  SimplifyAttention() {
+    query_ = IsWildcard();
+    key_ = IsWildcard();
+    value_ = IsWildcard();
+    scale_ = IsConstant();
+    scores_ = IsOp("nn.batch_matmul")({query_, key_});
+    DFPattern scaled = scores_ || IsOp("multiply")({scores_, scale_}) ||
+                       IsOp("multiply")({scale_, scores_}) || IsOp("divide")({scores_, scale_});
+    softmax_ = IsOp("nn.softmax")({scaled}) || IsOp("nn.fast_softmax")({scaled});
+    pattern_ = IsOp("nn.batch_matmul")({softmax_, value_});
+  }
+
+  Expr Callback(const Expr& pre, const Expr& post,
+                const Map<DFPattern, Array<Expr>>& node_map) const override {
+    Expr query = node_map[query_][0];
+    Expr key = node_map[key_][0];
+    Expr value = node_map[value_][0];
+    const auto* scores = node_map[scores_][0].as<CallNode>();
+    const auto* softmax = node_map[softmax_][0].as<CallNode>();
+    const auto* output = post.as<CallNode>();
+    const auto* scores_attrs = scores->attrs.as<BatchMatmulAttrs>();
+    const auto* output_attrs = output->attrs.as<BatchMatmulAttrs>();
+    const auto* softmax_attrs = softmax->attrs.as<SoftmaxAttrs>();
+    const auto* query_type = query->checked_type().as<TensorTypeNode>();
+    const auto* key_type = key->checked_type().as<TensorTypeNode>();
+    const auto* value_type = value->checked_type().as<TensorTypeNode>();
+    const auto* scores_type = scores->checked_type().as<TensorTypeNode>();
+    const auto* out_type = pre->checked_type().as<TensorTypeNode>();
+    if (scores_attrs->transpose_a || output_attrs->transpose_a ||
+        (softmax_attrs->axis != -1 && softmax_attrs->axis != 2)) {
+      return post;
+    }
+    // the products are accumulated in the input type, and the batch broadcasting of
+    // batch_matmul is not supported
+    DataType dtype = query_type->dtype;
+    if (!dtype.is_float() || key_type->dtype != dtype || value_type->dtype != dtype ||
+        scores_type->dtype != dtype || out_type->dtype != dtype ||
+        !StructuralEqual()(query_type->shape[0], key_type->shape[0]) ||
+        !StructuralEqual()(query_type->shape[0], value_type->shape[0])) {
+      return post;
+    }
+
+    double scale = 1.0;
+    if (node_map.count(scale_)) {
+      Expr scale_expr = node_map[scale_][0];
+      if (!IsConstScalar(scale_expr)) return post;
+      scale = static_cast<double>(ToScalar(scale_expr.as<ConstantNode>()->data));
+      const auto* scaled = softmax->args[0].as<CallNode>();
+      if (scaled->op == Op::Get("divide")) {
+        if (scale == 0) return post;
+        scale = 1.0 / scale;
+      }
+    }
+    if (!scores_attrs->transpose_b) {
+      key = MakeTranspose(key, {0, 2, 1});
+    }
+    if (output_attrs->transpose_b) {
+      value = MakeTranspose(value, {0, 2, 1});
+    }
+    return MakeFusedAttention(query, key, value, scale);
+  }
+
+ private:
+  /*! \brief Pattern inputs */
+  DFPattern query_;
+  DFPattern key_;
+  DFPattern value_;
+  /*! \brief The constant factor of the scores */
+  DFPattern scale_;
+  /*! \brief The query-key batch_matmul and the softmax */
+  DFPattern scores_;
+  DFPattern softmax_;
+};
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.SimplifyExpr.fuse_attention", Bool);
+
 Expr SimplifyExpr(const Expr& expr, const IRModule& mod) {
   // the rewrites will be applied in the given order, and repeated until fixed point
   DFPatternRewriteComposer composer;
@@ -599,6 +682,12 @@ Expr SimplifyExpr(const Expr& expr, const IRModule& mod) {
   composer.AddRewrite<SimplifyTranspose>();
   composer.AddRewrite<SimplifyCast>();
   composer.AddRewrite<FullElementwise>();
+  // off by default, as it hides the batch_matmul ops from the external codegens
+  if (transform::PassContext::Current()
+          ->GetConfig<Bool>("relay.SimplifyExpr.fuse_attention", Bool(false))
+          .value()) {
+    composer.AddRewrite<SimplifyAttention>();
+  }
   return RewritePatterns(composer.MakeCallbacks(), expr, mod);
 }
 
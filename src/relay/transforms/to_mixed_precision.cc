@@ -25,11 +25,18 @@
  */
 
 #include <tvm/ir/attrs.h>
+#include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/object.h>
 
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "pattern_utils.h"
 
@@ -67,6 +74,296 @@ using CachedCastNodes = std::unordered_map<std::pair<const ExprNode*, DataType>,
 using FTVMMixedPrecisionConversionType = runtime::TypedPackedFunc<Array<ObjectRef>(
     const Call& call_node, const std::string& target_dtype_str)>;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.ToMixedPrecision.minimize_casts", Bool);
+/*! \brief The sensitivity scores of the layers, keyed by op name or "<op name>:<index>". */
+using SensitivityProfile = Map<String, PrimExpr>;
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.ToMixedPrecision.sensitivity", SensitivityProfile);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.ToMixedPrecision.max_sensitivity", FloatImm);
+
+/*!
+ * \brief Get the conversion category of a call and its dtypes.
+ * \param call The call node.
+ * \param mixed_precision_type The target mixed precision dtype.
+ * \param accumulation_dtype The accumulation dtype of the call.
+ * \param output_dtype The output dtype of the call.
+ * \return The category, and whether the op registered FTVMMixedPrecisionConversionType.
+ */
+std::pair<MixedTypeConversionCategory, bool> GetConversionCategory(
+    const CallNode* call, const DataType& mixed_precision_type, DataType* accumulation_dtype,
+    DataType* output_dtype) {
+  if (call->op.as<FunctionNode>()) {
+    // Avoid messing with functions to avoid changing signature
+    *accumulation_dtype = DataType::Float(32);
+    *output_dtype = DataType::Float(32);
+    return {MIXED_PRECISION_NEVER, true};
+  }
+  ICHECK(call->op.as<OpNode>()) << "Unsupported op type in CallNode: " << call->op;
+  static auto attr_map =
+      Op::GetAttrMap<FTVMMixedPrecisionConversionType>("FTVMMixedPrecisionConversionType");
+  Op op = Downcast<Op>(call->op);
+  if (!attr_map.count(op)) {
+    // If not registered, by default assume is a generic FOLLOW operation.
+    *accumulation_dtype = mixed_precision_type;
+    *output_dtype = mixed_precision_type;
+    return {MIXED_PRECISION_FOLLOW, false};
+  }
+  // Calculate the conversion category and dtypes from registered attribute.
+  FTVMMixedPrecisionConversionType func = attr_map[op];
+  Array<ObjectRef> op_descriptor =
+      func(GetRef<Call>(call), DLDataType2String(mixed_precision_type));
+  ICHECK(op_descriptor.size() == 3)
+      << "got the wrong number of returned arguments (expected 3 got " << op_descriptor.size()
+      << ") from FTVMMixedPrecisionConversionType for " << AsText(op, false);
+
+  int64_t op_conversion_type = Downcast<Integer>(op_descriptor[0])->value;
+  *accumulation_dtype = DataType(String2DLDataType(Downcast<String>(op_descriptor[1])));
+  *output_dtype = DataType(String2DLDataType(Downcast<String>(op_descriptor[2])));
+  return {static_cast<MixedTypeConversionCategory>(op_conversion_type), true};
+}
+
+/*!
+ * \brief Decide the precision of the calls of a graph before the rewrite.
+ *
+ * The layers of a sensitivity profile scoring above a threshold stay in FP32. The profile keys
+ * are either op names, covering every call of the op, or "<op name>:<index>", the index-th call
+ * of the op in post-order.
+ *
+ * When minimizing casts, the precision of the FOLLOW ops is chosen for the fewest cast elements
+ * over the graph rather than from their arguments alone, as a minimum s-t cut: the source side
+ * runs in the mixed precision type, the sink side in FP32, the ALWAYS ops are tied to the source
+ * and the NEVER ops and the inputs to the sink. A tensor read in both precisions is cast once,
+ * which two auxiliary nodes per producer model: cutting the edge between the producer and one
+ * of them costs the size of the tensor, and the consumers are tied to it. Among the minimum
+ * cuts the one with the most ops in the mixed precision type is used.
+ */
+class PrecisionPlanner {
+ public:
+  PrecisionPlanner(DataType mixed_precision_type, SensitivityProfile sensitivity,
+                   double max_sensitivity)
+      : mixed_precision_type_(mixed_precision_type),
+        sensitivity_(sensitivity),
+        max_sensitivity_(max_sensitivity) {}
+
+  /*!
+   * \brief Plan the precision of the calls of an expression.
+   * \param expr The expression.
+   * \param minimize_casts Whether to place the FOLLOW ops for the fewest casts.
+   * \return The category of the calls whose category is decided.
+   */
+  std::unordered_map<const CallNode*, MixedTypeConversionCategory> Plan(const Expr& expr,
+                                                                      bool minimize_casts) {
+    std::vector<const CallNode*> calls;
+    std::unordered_map<std::string, int> op_counts;
+    PostOrderVisit(expr, [&](const Expr& e) {
+      const auto* call = e.as<CallNode>();
+      if (call == nullptr || call->op.as<ConstructorNode>() || call->op.as<GlobalVarNode>() ||
+          call->op.as<VarNode>()) {
+        return;
+      }
+      DataType accumulation_dtype, output_dtype;
+      categories_[call] =
+          GetConversionCategory(call, mixed_precision_type_, &accumulation_dtype, &output_dtype)
+              .first;
+      calls.push_back(call);
+      if (const auto* op = call->op.as<OpNode>()) {
+        int index = op_counts[op->name]++;
+        if (IsSensitive(op->name) || IsSensitive(op->name + ":" + std::to_string(index))) {
+          categories_[call] = MIXED_PRECISION_NEVER;
+          decisions_[call] = MIXED_PRECISION_NEVER;
+        }
+      }
+    });
+    if (minimize_casts) PlaceFollowOps(calls);
+    return decisions_;
+  }
+
+ private:
+  bool IsSensitive(const std::string& key) const {
+    auto it = sensitivity_.find(key);
+    if (it == sensitivity_.end()) return false;
+    double score = 0;
+    if (const auto* imm = (*it).second.as<FloatImmNode>()) {
+      score = imm->value;
+    } else if (const auto* imm = (*it).second.as<IntImmNode>()) {
+      score = static_cast<double>(imm->value);
+    } else {
+      LOG(FATAL) << "The sensitivity of " << key << " must be a number";
+    }
+    return score > max_sensitivity_;
+  }
+
+  // The number of floating point elements of a type, the dynamic dimensions counting as 1.
+  static int64_t FloatElements(const Type& type) {
+    if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+      if (!tensor_type->dtype.is_float() && !tensor_type->dtype.is_bfloat16()) return 0;
+      int64_t size = 1;
+      for (const auto& dim : tensor_type->shape) {
+        if (const auto* imm = dim.as<IntImmNode>()) size *= std::max<int64_t>(imm->value, 1);
+      }
+      return size;
+    } else if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+      int64_t size = 0;
+      for (const auto& field : tuple_type->fields) size += FloatElements(field);
+      return size;
+    }
+    return 0;
+  }
+
+  static Type TypeOf(const ExprNode* expr) {
+    return expr->checked_type_.defined() ? expr->checked_type_ : Type();
+  }
+
+  // The producers of an argument, looking through tuples. The constants are cast for free.
+  void CollectProducers(const Expr& arg, std::vector<const Object*>* producers) {
+    if (const auto* tuple = arg.as<TupleNode>()) {
+      for (const auto& field : tuple->fields) CollectProducers(field, producers);
+    } else if (const auto* get = arg.as<TupleGetItemNode>()) {
+      CollectProducers(get->tuple, producers);
+    } else if (arg.as<CallNode>() || arg.as<VarNode>()) {
+      producers->push_back(arg.get());
+    }
+  }
+
+  void PlaceFollowOps(const std::vector<const CallNode*>& calls) {
+    const int64_t kInf = std::numeric_limits<int64_t>::max() / 4;
+    const int source = 0, sink = 1;
+    std::unordered_map<const Object*, int> node_ids;
+    graph_.assign(2, {});
+    auto node_id = [&](const Object* node) {
+      auto it = node_ids.find(node);
+      if (it != node_ids.end()) return it->second;
+      int id = static_cast<int>(graph_.size());
+      graph_.emplace_back();
+      node_ids[node] = id;
+      return id;
+    };
+    std::unordered_map<const Object*, std::vector<int>> consumers;
+    std::vector<const Object*> producers_order;
+    for (const CallNode* call : calls) {
+      int id = node_id(call);
+      MixedTypeConversionCategory category = categories_[call];
+      if (category == MIXED_PRECISION_ALWAYS) AddEdge(source, id, kInf);
+      if (category == MIXED_PRECISION_NEVER) AddEdge(id, sink, kInf);
+      std::vector<const Object*> producers;
+      for (const auto& arg : call->args) CollectProducers(arg, &producers);
+      for (const Object* producer : producers) {
+        if (producer->IsInstance<VarNode>()) {
+          // The inputs keep their FP32 dtype.
+          AddEdge(node_id(producer), sink, kInf);
+        }
+        if (consumers.count(producer) == 0) producers_order.push_back(producer);
+        consumers[producer].push_back(id);
+      }
+    }
+    for (const Object* producer : producers_order) {
+      int64_t size = FloatElements(TypeOf(static_cast<const ExprNode*>(producer)));
+      if (size == 0) continue;
+      int id = node_id(producer);
+      int to_fp32 = static_cast<int>(graph_.size());
+      int to_mixed = to_fp32 + 1;
+      graph_.resize(graph_.size() + 2);
+      // Cast once when the producer runs in the mixed precision type and a consumer in FP32.
+      AddEdge(id, to_fp32, size);
+      // Cast once when the producer runs in FP32 and a consumer in the mixed precision type.
+      AddEdge(to_mixed, id, size);
+      for (int consumer : consumers[producer]) {
+        AddEdge(to_fp32, consumer, kInf);
+        AddEdge(consumer, to_mixed, kInf);
+      }
+    }
+    MaxFlow(source, sink);
+
+    // The nodes that can still push flow to the sink form the smallest sink side.
+    std::vector<bool> reaches_sink(graph_.size(), false);
+    std::vector<std::vector<int>> reverse(graph_.size());
+    for (size_t u = 0; u < graph_.size(); ++u) {
+      for (const Edge& edge : graph_[u]) {
+        if (edge.capacity > 0) reverse[edge.to].push_back(static_cast<int>(u));
+      }
+    }
+    std::vector<int> stack = {sink};
+    reaches_sink[sink] = true;
+    while (!stack.empty()) {
+      int v = stack.back();
+      stack.pop_back();
+      for (int u : reverse[v]) {
+        if (!reaches_sink[u]) {
+          reaches_sink[u] = true;
+          stack.push_back(u);
+        }
+      }
+    }
+    for (const CallNode* call : calls) {
+      // The ops not producing floats keep deciding from their arguments.
+      if (categories_[call] != MIXED_PRECISION_FOLLOW || FloatElements(TypeOf(call)) == 0) continue;
+      decisions_[call] =
+          reaches_sink[node_ids[call]] ? MIXED_PRECISION_NEVER : MIXED_PRECISION_ALWAYS;
+    }
+  }
+
+  /*! \brief An edge of the flow graph and its residual capacity. */
+  struct Edge {
+    int to;
+    int64_t capacity;
+    size_t reverse;
+  };
+
+  void AddEdge(int from, int to, int64_t capacity) {
+    graph_[from].push_back({to, capacity, graph_[to].size()});
+    graph_[to].push_back({from, 0, graph_[from].size() - 1});
+  }
+
+  // Dinic's maximum flow, leaving the residual capacities in the graph.
+  void MaxFlow(int source, int sink) {
+    std::vector<int> level(graph_.size());
+    std::vector<size_t> next(graph_.size());
+    while (true) {
+      std::fill(level.begin(), level.end(), -1);
+      std::queue<int> queue;
+      level[source] = 0;
+      queue.push(source);
+      while (!queue.empty()) {
+        int u = queue.front();
+        queue.pop();
+        for (const Edge& edge : graph_[u]) {
+          if (edge.capacity > 0 && level[edge.to] < 0) {
+            level[edge.to] = level[u] + 1;
+            queue.push(edge.to);
+          }
+        }
+      }
+      if (level[sink] < 0) return;
+      std::fill(next.begin(), next.end(), 0);
+      while (Augment(source, sink, std::numeric_limits<int64_t>::max(), &level, &next) > 0) {
+      }
+    }
+  }
+
+  int64_t Augment(int u, int sink, int64_t flow, std::vector<int>* level,
+                  std::vector<size_t>* next) {
+    if (u == sink) return flow;
+    for (size_t& i = (*next)[u]; i < graph_[u].size(); ++i) {
+      Edge& edge = graph_[u][i];
+      if (edge.capacity <= 0 || (*level)[edge.to] != (*level)[u] + 1) continue;
+      int64_t pushed = Augment(edge.to, sink, std::min(flow, edge.capacity), level, next);
+      if (pushed > 0) {
+        edge.capacity -= pushed;
+        graph_[edge.to][edge.reverse].capacity += pushed;
+        return pushed;
+      }
+    }
+    return 0;
+  }
+
+  DataType mixed_precision_type_;
+  SensitivityProfile sensitivity_;
+  double max_sensitivity_;
+  std::unordered_map<const CallNode*, MixedTypeConversionCategory> categories_;
+  std::unordered_map<const CallNode*, MixedTypeConversionCategory> decisions_;
+  std::vector<std::vector<Edge>> graph_;
+};
+
 /*! \brief This class transforms the given relay module into a version where
  * as many operations as possible operate in the target mixed precision dtype.
  *
@@ -106,6 +403,9 @@ class MixedPrecisionPass : public MixedModeMutator {
    */
   std::unordered_map<std::string, int> missing_ops_;
 
+  /*! \brief The categories decided ahead by a PrecisionPlanner, overriding the others. */
+  std::unordered_map<const CallNode*, MixedTypeConversionCategory> planned_categories_;
+
   Attrs GetNewAttrs(const CallNode* call, const DataType& accumulation_dtype) const {
     /* If the accumulation dtype is in the attributes make a copy and mutate the field. */
     Attrs cur_attrs = call->attrs;
@@ -272,8 +572,12 @@ class MixedPrecisionPass : public MixedModeMutator {
  public:
   using MixedModeMutator::VisitExpr_;
 
-  explicit MixedPrecisionPass(DataType mixed_precision_type = DataType::Float(16))
-      : MixedModeMutator(), mixed_precision_type_(mixed_precision_type) {
+  explicit MixedPrecisionPass(
+      DataType mixed_precision_type = DataType::Float(16),
+      std::unordered_map<const CallNode*, MixedTypeConversionCategory> planned_categories = {})
+      : MixedModeMutator(),
+        mixed_precision_type_(mixed_precision_type),
+        planned_categories_(std::move(planned_categories)) {
     if (!mixed_precision_type_.is_float() && !mixed_precision_type_.is_bfloat16()) {
       LOG(FATAL) << "Only support IEEE floating point mixed precision types and bfloat16, but got "
                  << mixed_precision_type_;
@@ -295,42 +599,13 @@ class MixedPrecisionPass : public MixedModeMutator {
 
     // Get info on the operation being called:
     // conversion category (int), accumulation dtype (str), output dtype (str)
-    MixedTypeConversionCategory initial_category;
     DataType accumulation_dtype, output_dtype;
-    if (cur_op.as<FunctionNode>()) {
-      // Avoid messing with functions to avoid changing signature
-      initial_category = MIXED_PRECISION_NEVER;
-      accumulation_dtype = DataType::Float(32);
-      output_dtype = DataType::Float(32);
-    } else if (cur_op.as<OpNode>()) {
-      static auto attr_map =
-          Op::GetAttrMap<FTVMMixedPrecisionConversionType>("FTVMMixedPrecisionConversionType");
-      Op op = Downcast<Op>(cur_op);
-      if (attr_map.count(op)) {
-        // Calculate the conversion category and dtypes from registered attribute.
-        FTVMMixedPrecisionConversionType func = attr_map[op];
-        Array<ObjectRef> op_descriptor =
-            func(GetRef<Call>(pre_call_node), DLDataType2String(mixed_precision_type_));
-        ICHECK(op_descriptor.size() == 3)
-            << "got the wrong number of returned arguments (expected 3 got " << op_descriptor.size()
-            << ") from FTVMMixedPrecisionConversionType for " << AsText(op, false);
-
-        int64_t op_conversion_type = Downcast<Integer>(op_descriptor[0])->value;
-        initial_category = static_cast<MixedTypeConversionCategory>(op_conversion_type);
-        accumulation_dtype = DataType(String2DLDataType(Downcast<String>(op_descriptor[1])));
-        output_dtype = DataType(String2DLDataType(Downcast<String>(op_descriptor[2])));
-      } else {
-        missing_ops_[op->name] += 1;
-
-        // If not registered, by default assume is a generic FOLLOW operation.
-        initial_category = MIXED_PRECISION_FOLLOW;
-        accumulation_dtype = mixed_precision_type_;
-        output_dtype = mixed_precision_type_;
-      }
-    } else {
-      LOG(FATAL) << "Unsupported op type in CallNode: " << pre_call_node->op;
+    auto category = GetConversionCategory(pre_call_node, mixed_precision_type_,
+                                          &accumulation_dtype, &output_dtype);
+    MixedTypeConversionCategory initial_category = category.first;
+    if (!category.second) {
+      missing_ops_[Downcast<Op>(cur_op)->name] += 1;
     }
-
     // First check if all the new mutated args are in lower precision form
     Array<Type> cur_arg_types;
     bool all_args_mixed_type_compatible = true;
@@ -349,7 +624,10 @@ class MixedPrecisionPass : public MixedModeMutator {
 
     // Determine the final category we want for conversion
     MixedTypeConversionCategory final_category = initial_category;
-    if (initial_category == MIXED_PRECISION_FOLLOW) {
+    auto it = planned_categories_.find(pre_call_node);
+    if (it != planned_categories_.end()) {
+      final_category = it->second;
+    } else if (initial_category == MIXED_PRECISION_FOLLOW) {
       final_category =
           all_args_mixed_type_compatible ? MIXED_PRECISION_ALWAYS : MIXED_PRECISION_NEVER;
     }
@@ -404,10 +682,13 @@ class MixedPrecisionPass : public MixedModeMutator {
 
   // To access map of ops not registered for error reporting
   friend Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type,
-                               int missing_op_mode);
+                               int missing_op_mode, bool minimize_casts,
+                               SensitivityProfile sensitivity, double max_sensitivity);
 };
 
-Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, int missing_op_mode) {
+Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, int missing_op_mode,
+                      bool minimize_casts, SensitivityProfile sensitivity,
+                      double max_sensitivity) {
   /*
   missing_op_mode:
 
@@ -418,7 +699,12 @@ Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, in
   ICHECK(missing_op_mode >= 0 && missing_op_mode <= 2)
       << " missing_op_mode must be either 0, 1, or 2 got " << missing_op_mode;
 
-  MixedPrecisionPass converter = MixedPrecisionPass(mixed_precision_type);
+  std::unordered_map<const CallNode*, MixedTypeConversionCategory> planned_categories;
+  if (minimize_casts || !sensitivity.empty()) {
+    planned_categories = PrecisionPlanner(mixed_precision_type, sensitivity, max_sensitivity)
+                             .Plan(expr, minimize_casts);
+  }
+  MixedPrecisionPass converter = MixedPrecisionPass(mixed_precision_type, planned_categories);
   auto result = converter.Mutate(expr);
 
   for (auto it = converter.missing_ops_.begin();
@@ -442,9 +728,20 @@ namespace transform {
 Pass ToMixedPrecision(DataType mixed_precision_type, int missing_op_mode) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(ToMixedPrecision(f, mixed_precision_type, missing_op_mode));
+        bool minimize_casts =
+            pc->GetConfig<Bool>("relay.ToMixedPrecision.minimize_casts", Bool(false)).value();
+        SensitivityProfile sensitivity =
+            pc->GetConfig<SensitivityProfile>("relay.ToMixedPrecision.sensitivity",
+                                              SensitivityProfile())
+                .value();
+        double max_sensitivity =
+            pc->GetConfig<FloatImm>("relay.ToMixedPrecision.max_sensitivity", FloatImm(nullptr))
+                .value_or(FloatImm(DataType::Float(64), 0))
+                ->value;
+        return Downcast<Function>(ToMixedPrecision(f, mixed_precision_type, missing_op_mode,
+                                                   minimize_casts, sensitivity, max_sensitivity));
       };
-  return CreateFunctionPass(pass_func, 0, "ToMixedPrecision", {});
+  return CreateFunctionPass(pass_func, 0, "ToMixedPrecision", {"InferType"});
 }
 
 TVM_REGISTER_GLOBAL("relay._transform.ToMixedPrecision").set_body_typed(ToMixedPrecision);
@@ -44,6 +44,13 @@
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/pattern_functor.h>
 #include <tvm/relay/transform.h>
+#include <tvm/runtime/registry.h>
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "../analysis/type_solver.h"
 #include "pass_utils.h"
@@ -180,6 +187,38 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
     if (it != type_map_.end() && it->second.checked_type.defined()) {
       return it->second.checked_type;
     }
+    if (expr.as<CallNode>() || expr.as<TupleNode>() || expr.as<TupleGetItemNode>()) {
+      // Infer the dataflow inputs first without recursion, in the order the recursive visit
+      // would, so that deep chains of calls do not overflow the stack.
+      auto fcheck_visited = [this](const Expr& expr) {
+        auto it = type_map_.find(expr);
+        return it != type_map_.end() && it->second.checked_type.defined();
+      };
+      auto fvisit_leaf = [this](const Expr& expr) { this->InferExprType(expr); };
+      auto fexpand_expr = [](const Expr& expr) {
+        std::vector<Expr> inputs;
+        // the callee is typed after the arguments, when the call is visited.
+        if (const CallNode* op = expr.as<CallNode>()) {
+          for (auto it = op->args.rbegin(); it != op->args.rend(); ++it) {
+            inputs.push_back(*it);
+          }
+        } else if (const TupleNode* op = expr.as<TupleNode>()) {
+          for (auto it = op->fields.rbegin(); it != op->fields.rend(); ++it) {
+            inputs.push_back(*it);
+          }
+        } else if (const TupleGetItemNode* op = expr.as<TupleGetItemNode>()) {
+          inputs.push_back(op->tuple);
+        }
+        return inputs;
+      };
+      ExpandDataflow(expr, fcheck_visited, fvisit_leaf, fexpand_expr);
+      return type_map_.at(expr).checked_type;
+    }
+    return InferExprType(expr);
+  }
+
+  // Infer the type of an expression, whose dataflow inputs may already be typed.
+  Type InferExprType(const Expr& expr) {
     Type ret = this->VisitExpr(expr);
     ICHECK(ret.defined()) << "expression:" << std::endl << PrettyPrint(expr);
     KindCheck(ret, mod_, this->diag_ctx);
@@ -824,6 +863,116 @@ void AddGlobalTypes(IRModule mod) {
   }
 }
 
+/*!
+ * \brief The functions produced by InferType, which stay well typed while the types of the
+ *  globals they use do not change.
+ *
+ *  A pass that leaves a function untouched hands the same object back, so the next InferType
+ *  skips it instead of solving its constraints again. A function is re-inferred as soon as
+ *  it is rewritten, or the signature of a global it uses is. The table holds the functions
+ *  alive, so it drops the ones nothing else refers to.
+ */
+class InferredFunctionTable {
+ public:
+  static InferredFunctionTable* Global() {
+    static InferredFunctionTable* inst = new InferredFunctionTable();
+    return inst;
+  }
+
+  /*!
+   * \brief Check whether a function is still well typed in a module.
+   * \param func The function.
+   * \param mod The module, with the global types added by AddGlobalTypes.
+   */
+  bool IsInferred(const Function& func, const IRModule& mod) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = table_.find(func.get());
+    if (it == table_.end()) return false;
+    // the unknown parts of the signatures are fresh incomplete types at each InferType.
+    static const runtime::PackedFunc* fequal = runtime::Registry::Get("node.StructuralEqual");
+    for (const auto& kv : it->second.globals) {
+      Type type = GlobalType(kv.first, mod);
+      if (!type.defined()) return false;
+      bool equal = (*fequal)(type, kv.second, /*assert_mode=*/false, /*map_free_vars=*/true);
+      if (!equal) return false;
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Record a function produced by InferType.
+   * \param func The function.
+   * \param mod The module, with the global types added by AddGlobalTypes.
+   */
+  void Add(const Function& func, const IRModule& mod) {
+    Entry entry;
+    entry.func = func;
+    bool cacheable = true;
+    std::unordered_set<const Object*> visited;
+    PostOrderVisit(func, [&](const Expr& expr) {
+      if (const auto* gvar = expr.as<GlobalVarNode>()) {
+        if (!visited.insert(gvar).second) return;
+        Type type = GlobalType(GetRef<GlobalVar>(gvar), mod);
+        cacheable &= type.defined();
+        entry.globals.emplace_back(GetRef<GlobalVar>(gvar), type);
+      } else if (expr.as<ConstructorNode>() || expr.as<MatchNode>()) {
+        // the algebraic data types may be redefined.
+        cacheable = false;
+      } else if (const auto* var = expr.as<VarNode>()) {
+        cacheable &= !UsesTypeDefinition(var->type_annotation);
+      }
+    });
+    cacheable &= !UsesTypeDefinition(func->checked_type_);
+    if (!cacheable) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (table_.size() >= kMaxEntries) table_.clear();
+    table_[func.get()] = std::move(entry);
+  }
+
+  /*! \brief Forget the functions only the table refers to. */
+  void Sweep() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = table_.begin(); it != table_.end();) {
+      if (it->second.func.use_count() == 1) {
+        it = table_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+ private:
+  struct Entry {
+    /*! \brief The function, held so its address is not reused. */
+    Function func;
+    /*! \brief The globals used by the function and the types it was inferred with. */
+    std::vector<std::pair<GlobalVar, Type>> globals;
+  };
+
+  // Whether a type refers to an algebraic data type.
+  static bool UsesTypeDefinition(const Type& type) {
+    struct Visitor : public TypeVisitor {
+      void VisitType_(const GlobalTypeVarNode* op) final { found = true; }
+      void VisitType_(const TypeCallNode* op) final { found = true; }
+      bool found{false};
+    } visitor;
+    if (type.defined()) visitor.VisitType(type);
+    return visitor.found;
+  }
+
+  // The type TypeInferencer gives to a global, undefined when it is not in the module.
+  static Type GlobalType(const GlobalVar& gvar, const IRModule& mod) {
+    if (!mod->ContainGlobalVar(gvar->name_hint)) return Type();
+    BaseFunc func = mod->Lookup(gvar->name_hint);
+    if (func.as<FunctionNode>()) return func->checked_type_;
+    return gvar->checked_type_;
+  }
+
+  static constexpr size_t kMaxEntries = 4096;
+  std::mutex mutex_;
+  std::unordered_map<const FunctionNode*, Entry> table_;
+};
+
 namespace transform {
 
 Pass InferType() {
@@ -837,6 +986,8 @@ Pass InferType() {
 
         // Add all the type annotations to the functions in the model.
         AddGlobalTypes(mod);
+        InferredFunctionTable* inferred = InferredFunctionTable::Global();
+        inferred->Sweep();
 
         std::vector<std::pair<GlobalVar, Function> > updates;
         for (const auto& it : updated_mod->functions) {
@@ -849,10 +1000,11 @@ Pass InferType() {
           if (auto* func_node = it.second.as<FunctionNode>()) {
             auto func = GetRef<Function>(func_node);
 
-            // // If a function already has type information we can skip checking it.
-            // if (func->checked_type_.defined()) {
-            //   continue;
-            // }
+            // A function typed by a previous InferType and left untouched since is skipped.
+            if (inferred->IsInferred(func, mod)) {
+              it.first->checked_type_ = func->checked_type();
+              continue;
+            }
 
             // TODO(@jroesch): we should be able to move the type inferencer outside
             // of this function but it seems to be more stateful then I expect.
@@ -873,6 +1025,7 @@ Pass InferType() {
             ICHECK(free_tvars.size() == 0)
                 << "Found unbound type variables in " << updated_func << ": " << free_tvars;
             EnsureCheckedType(updated_func);
+            inferred->Add(Downcast<Function>(updated_func), mod);
             updates.push_back({it.first, Downcast<Function>(updated_func)});
           }
         }
@@ -0,0 +1,278 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/aot_executor/aot_executor.cc
+ * \brief Executor of the models compiled by the AOT executor codegen for the C++ runtime.
+ */
+#include "aot_executor.h"
+
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+
+#include <sstream>
+
+#include "../library_module.h"
+
+namespace tvm {
+namespace runtime {
+
+AotExecutor::AotExecutor(Module module, const std::string& config_json,
+                         const std::vector<Device>& devs)
+    : module_(module), devices_(devs) {
+  CHECK(!config_json.empty()) << "The AOT executor needs a model compiled with the packed API, "
+                              << "without the C device API, workspace pools and dynamic shapes";
+  ICHECK(!devs.empty()) << "AotExecutor: no device given";
+  std::string main_name;
+  std::vector<AotTensorInfo> inputs, outputs;
+  std::istringstream is(config_json);
+  dmlc::JSONReader reader(&is);
+  dmlc::JSONObjectReadHelper helper;
+  helper.DeclareField("main", &main_name);
+  helper.DeclareField("inputs", &inputs);
+  helper.DeclareField("outputs", &outputs);
+  helper.ReadAllFields(&reader);
+
+  main_ = module_.GetFunction(main_name, true);
+  CHECK(main_ != nullptr) << "AotExecutor: no main function " << main_name << " in the module";
+  main_faddr_ = GetBackendPackedCFunc(main_);
+  for (const AotTensorInfo& info : inputs) {
+    input_names_.push_back(info.name);
+    inputs_.push_back(NDArray::Empty(info.shape, String2DLDataType(info.dtype), devices_[0]));
+  }
+  for (const AotTensorInfo& info : outputs) {
+    outputs_.push_back(NDArray::Empty(info.shape, String2DLDataType(info.dtype), devices_[0]));
+  }
+  for (const NDArray& array : inputs_) {
+    arg_tensors_.push_back(*array.operator->());
+  }
+  for (const NDArray& array : outputs_) {
+    arg_tensors_.push_back(*array.operator->());
+  }
+  for (DLTensor& tensor : arg_tensors_) {
+    TVMValue value;
+    value.v_handle = &tensor;
+    arg_values_.push_back(value);
+    arg_tcodes_.push_back(kTVMDLTensorHandle);
+  }
+}
+
+void AotExecutor::Run() {
+  int num_args = static_cast<int>(arg_values_.size());
+  if (main_faddr_ != nullptr) {
+    TVMValue ret_value;
+    int ret_type_code = kTVMNullptr;
+    int ret = (*main_faddr_)(arg_values_.data(), arg_tcodes_.data(), num_args, &ret_value,
+                             &ret_type_code, nullptr);
+    ICHECK_EQ(ret, 0) << TVMGetLastError();
+  } else {
+    TVMRetValue rv;
+    main_.CallPacked(TVMArgs(arg_values_.data(), arg_tcodes_.data(), num_args), &rv);
+  }
+  for (size_t i = 0; i < output_copies_.size(); ++i) {
+    if (output_copies_[i] != nullptr) outputs_[i].CopyTo(output_copies_[i]);
+  }
+}
+
+int AotExecutor::GetInputIndex(const std::string& name) const {
+  for (size_t i = 0; i < input_names_.size(); ++i) {
+    if (input_names_[i] == name) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+void AotExecutor::SetInput(int index, DLTensor* data_in) {
+  ICHECK_LT(static_cast<size_t>(index), inputs_.size());
+  // a previous zero copy input is replaced by the tensor owned by the executor
+  arg_tensors_[index].data = inputs_[index]->data;
+  inputs_[index].CopyFrom(data_in);
+}
+
+void AotExecutor::CheckExternalDLTensor(const DLTensor* external, const NDArray& internal) const {
+  ICHECK_EQ(internal->ndim, external->ndim);
+  ICHECK(DataType(internal->dtype) == DataType(external->dtype));
+  ICHECK_EQ(internal->device.device_type, external->device.device_type);
+  ICHECK_EQ(internal->device.device_id, external->device.device_id);
+  for (int i = 0; i < external->ndim; ++i) {
+    ICHECK_EQ(internal->shape[i], external->shape[i]);
+  }
+}
+
+void AotExecutor::SetInputZeroCopy(int index, DLTensor* data_ref) {
+  ICHECK_LT(static_cast<size_t>(index), inputs_.size());
+  CheckExternalDLTensor(data_ref, inputs_[index]);
+  // the main function takes compact tensors, a strided or misaligned input is copied instead
+  void* data = GetCompactDataAddress(*data_ref, kAllocAlignment);
+  if (data == nullptr) {
+    SetInput(index, data_ref);
+    return;
+  }
+  arg_tensors_[index].data = data;
+}
+
+void AotExecutor::SetOutputZeroCopy(int index, DLTensor* data_ref) {
+  ICHECK_LT(static_cast<size_t>(index), outputs_.size());
+  CheckExternalDLTensor(data_ref, outputs_[index]);
+  // a strided or misaligned output is written to the executor's tensor and copied out
+  void* data = GetCompactDataAddress(*data_ref, kAllocAlignment);
+  output_copies_.resize(outputs_.size());
+  output_copies_[index] = data == nullptr ? data_ref : nullptr;
+  arg_tensors_[inputs_.size() + index].data = data != nullptr ? data : outputs_[index]->data;
+}
+
+NDArray AotExecutor::GetInput(int index) const {
+  ICHECK_LT(static_cast<size_t>(index), inputs_.size());
+  return inputs_[index];
+}
+
+NDArray AotExecutor::GetOutput(int index) const {
+  ICHECK_LT(static_cast<size_t>(index), outputs_.size());
+  return outputs_[index];
+}
+
+void AotExecutor::StartStreaming(int num_buffers, const std::vector<int>& input_indices) {
+  ICHECK(streamer_ == nullptr) << "AotExecutor: the executor is already streaming";
+  std::vector<NDArray> inputs;
+  for (int index : input_indices) {
+    ICHECK_LT(static_cast<size_t>(index), inputs_.size());
+    inputs.push_back(inputs_[index]);
+  }
+  streamed_inputs_ = input_indices;
+  streamer_ = std::make_unique<FrameStreamer>(
+      num_buffers, inputs, outputs_,
+      [this](const std::vector<NDArray>& frame_inputs, const std::vector<NDArray>& frame_outputs) {
+        for (size_t i = 0; i < frame_inputs.size(); ++i) {
+          DLTensor* input = const_cast<DLTensor*>(frame_inputs[i].operator->());
+          SetInputZeroCopy(streamed_inputs_[i], input);
+        }
+        for (size_t i = 0; i < frame_outputs.size(); ++i) {
+          SetOutputZeroCopy(i, const_cast<DLTensor*>(frame_outputs[i].operator->()));
+        }
+        Run();
+      });
+}
+
+void AotExecutor::PushFrame(const std::vector<const DLTensor*>& inputs) {
+  ICHECK(streamer_ != nullptr) << "AotExecutor: PushFrame needs StartStreaming";
+  streamer_->Push(inputs);
+}
+
+Array<NDArray> AotExecutor::PopFrame() {
+  ICHECK(streamer_ != nullptr) << "AotExecutor: PopFrame needs StartStreaming";
+  return streamer_->Pop();
+}
+
+void AotExecutor::StopStreaming() {
+  if (streamer_ == nullptr) return;
+  streamer_.reset();
+  for (int index : streamed_inputs_) {
+    SetInputZeroCopy(index, const_cast<DLTensor*>(inputs_[index].operator->()));
+  }
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    SetOutputZeroCopy(i, const_cast<DLTensor*>(outputs_[i].operator->()));
+  }
+  streamed_inputs_.clear();
+}
+
+PackedFunc AotExecutor::GetFunction(const std::string& name,
+                                    const ObjectPtr<Object>& sptr_to_self) {
+  auto input_index = [this](const TVMArgValue& arg) {
+    if (String::CanConvertFrom(arg)) {
+      int index = this->GetInputIndex(arg.operator String());
+      CHECK_GE(index, 0) << "AotExecutor: no input named " << arg.operator String();
+      return index;
+    }
+    return arg.operator int();
+  };
+  if (name == "set_input") {
+    return PackedFunc([sptr_to_self, this, input_index](TVMArgs args, TVMRetValue* rv) {
+      this->SetInput(input_index(args[0]), args[1]);
+    });
+  } else if (name == "set_input_zero_copy") {
+    return PackedFunc([sptr_to_self, this, input_index](TVMArgs args, TVMRetValue* rv) {
+      this->SetInputZeroCopy(input_index(args[0]), args[1]);
+    });
+  } else if (name == "set_output_zero_copy") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetOutputZeroCopy(args[0], args[1]);
+    });
+  } else if (name == "get_input") {
+    return PackedFunc([sptr_to_self, this, input_index](TVMArgs args, TVMRetValue* rv) {
+      *rv = this->GetInput(input_index(args[0]));
+    });
+  } else if (name == "get_output") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      if (args.num_args == 2) {
+        this->GetOutput(args[0]).CopyTo(args[1].operator DLTensor*());
+      } else {
+        *rv = this->GetOutput(args[0]);
+      }
+    });
+  } else if (name == "get_input_index") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = this->GetInputIndex(args[0].operator String());
+    });
+  } else if (name == "get_num_inputs") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
+  } else if (name == "get_num_outputs") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumOutputs(); });
+  } else if (name == "run") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "start_streaming") {
+    return PackedFunc([sptr_to_self, this, input_index](TVMArgs args, TVMRetValue* rv) {
+      std::vector<int> input_indices;
+      for (int i = 1; i < args.size(); ++i) {
+        input_indices.push_back(input_index(args[i]));
+      }
+      this->StartStreaming(args[0], input_indices);
+    });
+  } else if (name == "push_frame") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<const DLTensor*> inputs;
+      for (int i = 0; i < args.size(); ++i) {
+        inputs.push_back(args[i].operator DLTensor*());
+      }
+      this->PushFrame(inputs);
+    });
+  } else if (name == "pop_frame") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->PopFrame(); });
+  } else if (name == "stop_streaming") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->StopStreaming(); });
+  } else {
+    return PackedFunc();
+  }
+}
+
+TVM_REGISTER_GLOBAL("tvm.aot_executor.create").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ICHECK_GE(args.num_args, 3) << "The expected arguments are the executor config, the module "
+                              << "and the devices";
+  std::vector<Device> devices;
+  for (int i = 2; i < args.num_args; ++i) {
+    devices.push_back(args[i].operator Device());
+  }
+  *rv = Module(make_object<AotExecutor>(args[1], args[0], devices));
+});
+
+}  // namespace runtime
+}  // namespace tvm
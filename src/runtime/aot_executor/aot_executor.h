@@ -0,0 +1,193 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/aot_executor/aot_executor.h
+ * \brief Executor of the models compiled by the AOT executor codegen for the C++ runtime.
+ */
+#ifndef TVM_RUNTIME_AOT_EXECUTOR_AOT_EXECUTOR_H_
+#define TVM_RUNTIME_AOT_EXECUTOR_AOT_EXECUTOR_H_
+
+#include <dlpack/dlpack.h>
+#include <dmlc/json.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../frame_streamer.h"
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief A tensor argument of the main function, as described by the executor config. */
+struct AotTensorInfo {
+  std::string name;
+  std::string dtype;
+  std::vector<int64_t> shape;
+
+  void Load(dmlc::JSONReader* reader) {
+    dmlc::JSONObjectReadHelper helper;
+    helper.DeclareOptionalField("name", &name);
+    helper.DeclareField("dtype", &dtype);
+    helper.DeclareField("shape", &shape);
+    helper.ReadAllFields(reader);
+  }
+};
+
+/*!
+ * \brief Run a model compiled by the AOT executor codegen.
+ *
+ *  The main function generated for the model calls the operators directly and places the
+ *  intermediate tensors itself, from the static memory plan of the codegen. The executor
+ *  owns the input and output tensors and packs the arguments of the main function once, so
+ *  a run is a single call of compiled code. The executor config, written by the codegen,
+ *  names the main function and describes its arguments.
+ */
+class TVM_DLL AotExecutor : public ModuleNode {
+ public:
+  /*!
+   * \brief Create an executor.
+   * \param module The module holding the main function and the operators.
+   * \param config_json The executor config.
+   * \param devs The devices, the first one holding the inputs and the outputs.
+   */
+  AotExecutor(Module module, const std::string& config_json, const std::vector<Device>& devs);
+
+  /*!
+   * \brief Get member function to front-end.
+   * \param name The name of the function.
+   * \param sptr_to_self The pointer to the module node.
+   * \return The corresponding member function.
+   */
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final;
+
+  const char* type_key() const final { return "AotExecutor"; }
+
+  /*! \brief Run the model once. */
+  void Run();
+
+  /*!
+   * \brief Get the index of an input.
+   * \param name The input name.
+   * \return The input index, -1 if there is no such input.
+   */
+  int GetInputIndex(const std::string& name) const;
+
+  /*!
+   * \brief Copy the data of an input.
+   * \param index The input index.
+   * \param data_in The input data.
+   */
+  void SetInput(int index, DLTensor* data_in);
+
+  /*!
+   * \brief Use external data as an input, without copying it unless it is strided or
+   *  misaligned.
+   * \param index The input index.
+   * \param data_ref The input data, which must stay alive while the executor uses it.
+   */
+  void SetInputZeroCopy(int index, DLTensor* data_ref);
+
+  /*!
+   * \brief Write an output into external data, without copying it unless it is strided or
+   *  misaligned, in which case it is copied at the end of each run.
+   * \param index The output index.
+   * \param data_ref The output data, which must stay alive while the executor uses it.
+   */
+  void SetOutputZeroCopy(int index, DLTensor* data_ref);
+
+  /*! \return The number of inputs. */
+  int NumInputs() const { return static_cast<int>(inputs_.size()); }
+
+  /*! \return The number of outputs. */
+  int NumOutputs() const { return static_cast<int>(outputs_.size()); }
+
+  /*!
+   * \param index The input index.
+   * \return The tensor of the input owned by the executor.
+   */
+  NDArray GetInput(int index) const;
+
+  /*!
+   * \param index The output index.
+   * \return The tensor of the output owned by the executor.
+   */
+  NDArray GetOutput(int index) const;
+
+  /*!
+   * \brief Start running the model on a stream of frames, see GraphExecutor::StartStreaming.
+   * \param num_buffers The number of tensor sets, at least 2.
+   * \param input_indices The inputs given by each frame, the others keep their value.
+   */
+  void StartStreaming(int num_buffers, const std::vector<int>& input_indices);
+
+  /*!
+   * \brief Copy the inputs of the next frame, waiting while all the tensor sets are in use.
+   * \param inputs One tensor per input given to StartStreaming.
+   */
+  void PushFrame(const std::vector<const DLTensor*>& inputs);
+
+  /*!
+   * \brief Wait for the outputs of the oldest frame not popped yet.
+   * \return The outputs, valid until the next PopFrame.
+   */
+  Array<NDArray> PopFrame();
+
+  /*! \brief Wait for the frames pushed and go back to the tensors of the executor. */
+  void StopStreaming();
+
+ private:
+  /*! \brief Check that external data can be used for an argument. */
+  void CheckExternalDLTensor(const DLTensor* external, const NDArray& internal) const;
+
+  /*! \brief The module holding the main function. */
+  Module module_;
+  /*! \brief The devices of the model. */
+  std::vector<Device> devices_;
+  /*! \brief The input names. */
+  std::vector<std::string> input_names_;
+  /*! \brief The tensors of the inputs and the outputs. */
+  std::vector<NDArray> inputs_;
+  std::vector<NDArray> outputs_;
+  /*! \brief The main function, and the compiled function it calls if it is in a library. */
+  PackedFunc main_;
+  TVMBackendPackedCFunc main_faddr_{nullptr};
+  /*!
+   * \brief The arguments of the main function, the inputs then the outputs. The zero copy
+   *  setters patch the data pointers of the tensors.
+   */
+  std::vector<DLTensor> arg_tensors_;
+  /*! \brief The external tensors the outputs are copied to after a run, nullptr for none. */
+  std::vector<DLTensor*> output_copies_;
+  std::vector<TVMValue> arg_values_;
+  std::vector<int> arg_tcodes_;
+  std::vector<int> streamed_inputs_;
+  // declared last so that its worker thread stops before the other members go away
+  std::unique_ptr<FrameStreamer> streamer_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_AOT_EXECUTOR_AOT_EXECUTOR_H_
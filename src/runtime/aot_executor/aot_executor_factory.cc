@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/aot_executor/aot_executor_factory.cc
+ * \brief Factory module of the AOT executor, saved with the compiled model.
+ */
+#include "aot_executor_factory.h"
+
+#include <dmlc/io.h>
+#include <tvm/runtime/registry.h>
+
+#include "aot_executor.h"
+
+namespace tvm {
+namespace runtime {
+
+PackedFunc AotExecutorFactory::GetFunction(const std::string& name,
+                                           const ObjectPtr<Object>& sptr_to_self) {
+  if (name == module_name_) {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<Device> devices;
+      for (int i = 0; i < args.num_args; ++i) {
+        devices.emplace_back(args[i].operator Device());
+      }
+      *rv = this->ExecutorCreate(devices);
+    });
+  } else if (name == "get_executor_config") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->config_json_; });
+  } else {
+    return PackedFunc();
+  }
+}
+
+void AotExecutorFactory::SaveToBinary(dmlc::Stream* stream) {
+  stream->Write(config_json_);
+  stream->Write(module_name_);
+}
+
+Module AotExecutorFactory::ExecutorCreate(const std::vector<Device>& devs) {
+  ICHECK_EQ(imports_.size(), 1U) << "The AOT executor factory must import the model library";
+  return Module(make_object<AotExecutor>(imports_[0], config_json_, devs));
+}
+
+Module AotExecutorFactoryModuleLoadBinary(void* strm) {
+  dmlc::Stream* stream = static_cast<dmlc::Stream*>(strm);
+  std::string config_json;
+  std::string module_name;
+  ICHECK(stream->Read(&config_json));
+  ICHECK(stream->Read(&module_name));
+  return Module(make_object<AotExecutorFactory>(config_json, module_name));
+}
+
+TVM_REGISTER_GLOBAL("tvm.aot_executor_factory.create")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.num_args, 3) << "The expected arguments are the executor config, the "
+                                  << "module and the module name";
+      auto exec = make_object<AotExecutorFactory>(args[0], args[2]);
+      exec->Import(args[1]);
+      *rv = Module(exec);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.module.loadbinary_AotExecutorFactory")
+    .set_body_typed(AotExecutorFactoryModuleLoadBinary);
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,303 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file batching_executor.cc
+ */
+#include "batching_executor.h"
+
+#include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace tvm {
+namespace runtime {
+
+namespace {
+/*! \brief Copy rows [from_row, from_row + rows) of from to rows starting at to_row of to. */
+void CopyRows(const DLTensor* from, int64_t from_row, DLTensor* to, int64_t to_row,
+              int64_t rows) {
+  std::vector<int64_t> from_shape(from->shape, from->shape + from->ndim);
+  std::vector<int64_t> to_shape(to->shape, to->shape + to->ndim);
+  size_t from_row_bytes = GetDataSize(*from) / from_shape[0];
+  size_t to_row_bytes = GetDataSize(*to) / to_shape[0];
+  DLTensor src = *from;
+  DLTensor dst = *to;
+  from_shape[0] = to_shape[0] = rows;
+  src.shape = from_shape.data();
+  dst.shape = to_shape.data();
+  src.byte_offset += from_row * from_row_bytes;
+  dst.byte_offset += to_row * to_row_bytes;
+  NDArray::CopyFromTo(&src, &dst);
+}
+
+/*! \brief Whether mod is a VirtualMachine, including its profiling subclass. */
+bool IsVirtualMachine(Module mod) { return mod.GetFunction("invoke") != nullptr; }
+
+/*! \brief Call the VM's set_input for func_name with the arrays. */
+void SetVMInputs(const PackedFunc& set_input, const std::string& func_name,
+                 const std::vector<NDArray>& arrays) {
+  size_t num_args = arrays.size() + 1;
+  std::vector<TVMValue> values(num_args);
+  std::vector<int> codes(num_args);
+  TVMArgsSetter setter(values.data(), codes.data());
+  setter(0, func_name);
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    setter(i + 1, arrays[i]);
+  }
+  TVMRetValue rv;
+  set_input.CallPacked(TVMArgs(values.data(), codes.data(), num_args), &rv);
+}
+}  // namespace
+
+BatchingExecutor::BatchingExecutor(std::vector<Variant> variants, int64_t max_batch_size,
+                                   int64_t max_latency_us)
+    : variants_(std::move(variants)), max_latency_(max_latency_us) {
+  ICHECK(!variants_.empty()) << "The batching executor needs at least one variant";
+  std::sort(variants_.begin(), variants_.end(), [](const Variant& lhs, const Variant& rhs) {
+    // Dynamic variants (batch size 0) go last so that fixed sizes are preferred.
+    if (lhs.batch_size == 0 || rhs.batch_size == 0) return rhs.batch_size == 0 && lhs.batch_size != 0;
+    return lhs.batch_size < rhs.batch_size;
+  });
+  bool dynamic = variants_.back().batch_size == 0;
+  int64_t largest = 0;
+  for (const Variant& variant : variants_) {
+    largest = std::max(largest, variant.batch_size);
+  }
+  if (max_batch_size <= 0) {
+    max_batch_size = largest;
+  }
+  ICHECK_GT(max_batch_size, 0) << "max_batch_size must be given when the only variant is dynamic";
+  ICHECK(dynamic || max_batch_size <= largest)
+      << "max_batch_size " << max_batch_size << " exceeds the largest variant " << largest;
+  max_batch_size_ = max_batch_size;
+  ICHECK_GE(max_latency_us, 0);
+  worker_ = std::thread([this]() { this->WorkerLoop(); });
+}
+
+BatchingExecutor::~BatchingExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+std::future<Array<NDArray>> BatchingExecutor::Submit(std::vector<NDArray> inputs) {
+  ICHECK(!inputs.empty()) << "A request needs at least one input";
+  auto request = std::make_unique<Request>();
+  request->rows = -1;
+  std::vector<std::pair<std::vector<int64_t>, DLDataType>> signature;
+  for (const NDArray& input : inputs) {
+    ICHECK_GE(input->ndim, 1) << "Batched inputs need a leading batch dimension";
+    ICHECK(request->rows == -1 || request->rows == input->shape[0])
+        << "All inputs of a request must have the same batch dimension";
+    request->rows = input->shape[0];
+    signature.emplace_back(std::vector<int64_t>(input->shape + 1, input->shape + input->ndim),
+                           input->dtype);
+  }
+  ICHECK_GT(request->rows, 0) << "A request needs at least one row";
+  ICHECK_LE(request->rows, max_batch_size_)
+      << "The request has " << request->rows << " rows but max_batch_size is " << max_batch_size_;
+  request->inputs = std::move(inputs);
+  std::future<Array<NDArray>> future = request->result.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (signature_.empty()) {
+      signature_ = signature;
+    }
+    ICHECK_EQ(signature.size(), signature_.size()) << "All requests must have the same inputs";
+    for (size_t i = 0; i < signature.size(); ++i) {
+      ICHECK(signature[i].first == signature_[i].first &&
+             DataType(signature[i].second) == DataType(signature_[i].second))
+          << "Input " << i << " does not match the shape and type of earlier requests";
+    }
+    request->arrival = std::chrono::steady_clock::now();
+    pending_rows_ += request->rows;
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_all();
+  return future;
+}
+
+void BatchingExecutor::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (stop_) break;
+    auto deadline = queue_.front()->arrival + max_latency_;
+    cv_.wait_until(lock, deadline, [this]() { return stop_ || pending_rows_ >= max_batch_size_; });
+    if (stop_) break;
+    // Take requests in arrival order for as long as they fit.
+    std::vector<std::unique_ptr<Request>> batch;
+    int64_t rows = 0;
+    while (!queue_.empty() && rows + queue_.front()->rows <= max_batch_size_) {
+      rows += queue_.front()->rows;
+      pending_rows_ -= queue_.front()->rows;
+      batch.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    lock.unlock();
+    RunBatch(batch, rows);
+    lock.lock();
+  }
+  for (auto& request : queue_) {
+    request->result.set_exception(
+        std::make_exception_ptr(Error("The batching executor was destroyed")));
+  }
+  queue_.clear();
+}
+
+void BatchingExecutor::RunBatch(const std::vector<std::unique_ptr<Request>>& batch,
+                                int64_t rows) {
+  try {
+    const Variant* variant = nullptr;
+    for (const Variant& v : variants_) {
+      if (v.batch_size == 0 || v.batch_size >= rows) {
+        variant = &v;
+        break;
+      }
+    }
+    ICHECK(variant != nullptr) << "No variant accepts a batch of " << rows;
+    int64_t batch_size = variant->batch_size == 0 ? rows : variant->batch_size;
+
+    Device cpu{kDLCPU, 0};
+    std::vector<NDArray> inputs;
+    for (size_t i = 0; i < signature_.size(); ++i) {
+      std::vector<int64_t> shape = {batch_size};
+      shape.insert(shape.end(), signature_[i].first.begin(), signature_[i].first.end());
+      NDArray input = NDArray::Empty(shape, signature_[i].second, cpu);
+      int64_t row = 0;
+      for (const auto& request : batch) {
+        CopyRows(request->inputs[i].operator->(), 0, const_cast<DLTensor*>(input.operator->()),
+                 row, request->rows);
+        row += request->rows;
+      }
+      if (row < batch_size) {
+        // Pad the batch up to the variant's size.
+        size_t row_bytes = GetDataSize(*input.operator->()) / batch_size;
+        std::memset(static_cast<char*>(input->data) + row * row_bytes, 0,
+                    (batch_size - row) * row_bytes);
+      }
+      inputs.push_back(input);
+    }
+
+    Array<NDArray> outputs = RunVariant(*variant, inputs);
+    std::vector<std::vector<NDArray>> results(batch.size());
+    for (const NDArray& output : outputs) {
+      ICHECK(output->ndim >= 1 && output->shape[0] == batch_size)
+          << "Every output must keep the batch dimension of the inputs";
+      int64_t row = 0;
+      for (size_t r = 0; r < batch.size(); ++r) {
+        std::vector<int64_t> shape(output->shape, output->shape + output->ndim);
+        shape[0] = batch[r]->rows;
+        NDArray result = NDArray::Empty(shape, output->dtype, cpu);
+        CopyRows(output.operator->(), row, const_cast<DLTensor*>(result.operator->()), 0,
+                 batch[r]->rows);
+        row += batch[r]->rows;
+        results[r].push_back(result);
+      }
+    }
+    num_batches_++;
+    for (size_t r = 0; r < batch.size(); ++r) {
+      batch[r]->result.set_value(Array<NDArray>(results[r]));
+    }
+  } catch (...) {
+    for (const auto& request : batch) {
+      request->result.set_exception(std::current_exception());
+    }
+  }
+}
+
+Array<NDArray> BatchingExecutor::RunVariant(const Variant& variant,
+                                            const std::vector<NDArray>& inputs) {
+  Module mod = variant.module;
+  Array<NDArray> outputs;
+  if (IsVirtualMachine(mod)) {
+    SetVMInputs(mod.GetFunction("set_input"), "main", inputs);
+    ObjectRef ret = mod.GetFunction("invoke")(std::string("main"));
+    if (const auto* adt = ret.as<ADTObj>()) {
+      for (size_t i = 0; i < adt->size; ++i) {
+        outputs.push_back(Downcast<NDArray>((*adt)[i]));
+      }
+    } else {
+      outputs.push_back(Downcast<NDArray>(ret));
+    }
+  } else {
+    PackedFunc set_input = mod.GetFunction("set_input");
+    ICHECK(set_input != nullptr) << "Variants must be GraphExecutor or VirtualMachine modules, "
+                                 << "but got " << mod->type_key();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      set_input(static_cast<int>(i), inputs[i]);
+    }
+    mod.GetFunction("run")();
+    int num_outputs = mod.GetFunction("get_num_outputs")();
+    PackedFunc get_output = mod.GetFunction("get_output");
+    for (int i = 0; i < num_outputs; ++i) {
+      outputs.push_back(get_output(i));
+    }
+  }
+  return outputs;
+}
+
+PackedFunc BatchingExecutor::GetFunction(const std::string& name,
+                                         const ObjectPtr<Object>& sptr_to_self) {
+  if (name == "run") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<NDArray> inputs;
+      for (int i = 0; i < args.num_args; ++i) {
+        inputs.push_back(args[i]);
+      }
+      *rv = this->Submit(std::move(inputs)).get();
+    });
+  } else if (name == "get_num_batches") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumBatches(); });
+  } else {
+    return PackedFunc();
+  }
+}
+
+TVM_REGISTER_GLOBAL("tvm.batching_executor.create").set_body([](TVMArgs args, TVMRetValue* rv) {
+  // The argument order is max_batch_size, max_latency_us, then pairs of batch_size and
+  // module. A negative batch size is read from the first input of a GraphExecutor.
+  ICHECK_GE(args.num_args, 4);
+  ICHECK_EQ(args.num_args % 2, 0);
+  std::vector<BatchingExecutor::Variant> variants;
+  for (int i = 2; i < args.num_args; i += 2) {
+    int64_t batch_size = args[i];
+    Module mod = args[i + 1];
+    if (batch_size < 0) {
+      ICHECK(!IsVirtualMachine(mod)) << "The batch size of a VirtualMachine variant must be given";
+      NDArray input = mod.GetFunction("get_input")(0);
+      batch_size = input->shape[0];
+    }
+    variants.push_back({batch_size, mod});
+  }
+  int64_t max_batch_size = args[0];
+  int64_t max_latency_us = args[1];
+  auto exec = make_object<BatchingExecutor>(std::move(variants), max_batch_size, max_latency_us);
+  *rv = Module(exec);
+});
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file batching_executor.h
+ * \brief Executor that groups individual requests into dynamic batches.
+ */
+#ifndef TVM_RUNTIME_BATCHING_BATCHING_EXECUTOR_H_
+#define TVM_RUNTIME_BATCHING_BATCHING_EXECUTOR_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Batching executor.
+ *
+ *  Requests are submitted one at a time, each with its own leading batch dimension, and
+ *  are collected by a worker thread until either max_batch_size rows are pending or the
+ *  oldest request has waited max_latency. The batch then runs on the smallest compiled
+ *  variant that fits it, padded with zeros up to the variant's batch size, and the rows
+ *  of every output are copied back to the request that produced them.
+ *
+ *  Variants are GraphExecutor modules compiled for a fixed batch size, or VirtualMachine
+ *  modules whose "main" accepts any batch size.
+ */
+class TVM_DLL BatchingExecutor : public ModuleNode {
+ public:
+  /*! \brief A compiled executor and the batch size it accepts. */
+  struct Variant {
+    /*! \brief The batch size of the inputs, 0 when any batch size is accepted. */
+    int64_t batch_size;
+    /*! \brief The GraphExecutor or VirtualMachine module. */
+    Module module;
+  };
+
+  /*!
+   * \brief Create the executor and start its worker thread.
+   * \param variants The compiled variants, in any order.
+   * \param max_batch_size The largest number of rows run together, 0 to use the largest
+   *  fixed variant.
+   * \param max_latency_us The longest a request waits for more requests to join its batch.
+   */
+  BatchingExecutor(std::vector<Variant> variants, int64_t max_batch_size, int64_t max_latency_us);
+  ~BatchingExecutor();
+
+  const char* type_key() const final { return "BatchingExecutor"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final;
+
+  /*!
+   * \brief Queue one request.
+   * \param inputs The inputs of the request, all with the same leading batch dimension.
+   * \return The outputs of the request, restricted to its rows and placed on the CPU.
+   */
+  std::future<Array<NDArray>> Submit(std::vector<NDArray> inputs);
+
+  /*! \return The number of batches run so far. */
+  int64_t NumBatches() const { return num_batches_; }
+
+ private:
+  /*! \brief A queued request. */
+  struct Request {
+    std::vector<NDArray> inputs;
+    int64_t rows;
+    std::chrono::steady_clock::time_point arrival;
+    std::promise<Array<NDArray>> result;
+  };
+  /*! \brief The worker thread: forms batches and runs them. */
+  void WorkerLoop();
+  /*! \brief Run one batch and fulfil its requests. */
+  void RunBatch(const std::vector<std::unique_ptr<Request>>& batch, int64_t rows);
+  /*! \brief Run the inputs on a variant and return its outputs. */
+  Array<NDArray> RunVariant(const Variant& variant, const std::vector<NDArray>& inputs);
+
+  /*! \brief The variants sorted by batch size, with any dynamic variant last. */
+  std::vector<Variant> variants_;
+  int64_t max_batch_size_;
+  std::chrono::microseconds max_latency_;
+  /*! \brief The trailing shape and dtype every request must match, set by the first one. */
+  std::vector<std::pair<std::vector<int64_t>, DLDataType>> signature_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  /*! \brief The number of rows in queue_. */
+  int64_t pending_rows_{0};
+  bool stop_{false};
+  std::atomic<int64_t> num_batches_{0};
+  std::thread worker_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_BATCHING_BATCHING_EXECUTOR_H_
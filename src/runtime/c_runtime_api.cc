@@ -190,6 +190,12 @@ void DeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void* to, s
 
 void DeviceAPI::FreeWorkspace(Device dev, void* ptr) { FreeDataSpace(dev, ptr); }
 
+void* DeviceAPI::AllocPinnedHostSpace(Device dev, size_t nbytes) { return nullptr; }
+
+void DeviceAPI::FreePinnedHostSpace(Device dev, void* ptr) {
+  LOG(FATAL) << "Device does not support pinned host memory.";
+}
+
 TVMStreamHandle DeviceAPI::CreateStream(Device dev) { return nullptr; }
 
 void DeviceAPI::FreeStream(Device dev, TVMStreamHandle stream) {}
@@ -197,6 +203,12 @@ void DeviceAPI::FreeStream(Device dev, TVMStreamHandle stream) {}
 void DeviceAPI::SyncStreamFromTo(Device dev, TVMStreamHandle event_src, TVMStreamHandle event_dst) {
 }
 
+void DeviceAPI::StreamAddCallback(Device dev, TVMStreamHandle stream,
+                                  std::function<void()> callback) {
+  StreamSync(dev, stream);
+  callback();
+}
+
 //--------------------------------------------------------
 // Error handling mechanism
 // -------------------------------------------------------
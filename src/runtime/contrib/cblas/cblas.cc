@@ -65,12 +65,10 @@ struct CblasSgemmBatchOp {
                   int c_stride, int ldc) {
     CBLAS_TRANSPOSE trans_a = CBLASBooleanToTranspose(ta);
     CBLAS_TRANSPOSE trans_b = CBLASBooleanToTranspose(tb);
-    for (int i = 0; i < batch_size; ++i) {
-      cblas_sgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
-      A += a_stride;
-      B += b_stride;
-      C += c_stride;
-    }
+    RunGemmBatch(batch_size, static_cast<int64_t>(M) * N * K, [&](int i) {
+      cblas_sgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A + i * a_stride, lda,
+                  B + i * b_stride, ldb, beta, C + i * c_stride, ldc);
+    });
   }
 };
 
@@ -97,12 +95,10 @@ struct CblasDgemmBatchOp {
                   int c_stride, int ldc) {
     CBLAS_TRANSPOSE trans_a = CBLASBooleanToTranspose(ta);
     CBLAS_TRANSPOSE trans_b = CBLASBooleanToTranspose(tb);
-    for (int i = 0; i < batch_size; ++i) {
-      cblas_dgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
-      A += a_stride;
-      B += b_stride;
-      C += c_stride;
-    }
+    RunGemmBatch(batch_size, static_cast<int64_t>(M) * N * K, [&](int i) {
+      cblas_dgemm(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A + i * a_stride, lda,
+                  B + i * b_stride, ldb, beta, C + i * c_stride, ldc);
+    });
   }
 };
 
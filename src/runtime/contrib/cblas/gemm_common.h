@@ -25,6 +25,7 @@
 #ifndef TVM_RUNTIME_CONTRIB_CBLAS_GEMM_COMMON_H_
 #define TVM_RUNTIME_CONTRIB_CBLAS_GEMM_COMMON_H_
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/registry.h>
 
@@ -173,6 +174,39 @@ inline bool IsInPlaceTransposed3D(DLTensor* tensor) {
 inline int BatchCount3D(DLTensor* tensor) { return tensor->shape[0]; }
 inline int RowCount3D(DLTensor* tensor, bool trans) { return tensor->shape[trans ? 2 : 1]; }
 inline int ColumnCount3D(DLTensor* tensor, bool trans) { return tensor->shape[trans ? 1 : 2]; }
+
+/*!
+ * \brief The gemms of a batch with fewer multiply-adds than this run on the threads of the
+ *  runtime pool, as the BLAS libraries run them on a single thread with a high overhead per call.
+ */
+constexpr int64_t kMaxParallelBatchGemmSize = 128 * 128 * 128;
+
+/*!
+ * \brief Run the gemms of a batch, the small ones in parallel.
+ * \param batch_size The number of gemms.
+ * \param gemm_size The number of multiply-adds of one gemm.
+ * \param fgemm Called as fgemm(i) to run the i-th gemm.
+ */
+template <typename FGemm>
+inline void RunGemmBatch(int batch_size, int64_t gemm_size, const FGemm& fgemm) {
+  if (batch_size < 2 || gemm_size > kMaxParallelBatchGemmSize) {
+    for (int i = 0; i < batch_size; ++i) fgemm(i);
+    return;
+  }
+  struct Closure {
+    const FGemm* fgemm;
+    int batch_size;
+  } closure{&fgemm, batch_size};
+  auto task = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    const Closure* closure = static_cast<const Closure*>(cdata);
+    for (int i = task_id; i < closure->batch_size; i += penv->num_task) {
+      (*closure->fgemm)(i);
+    }
+    return 0;
+  };
+  ICHECK_EQ(TVMBackendParallelLaunch(task, &closure, std::min(batch_size, 0x7fff)), 0)
+      << "RunGemmBatch: " << TVMGetLastError();
+}
 template <typename TBatchGemmOp>
 inline void CallBatchGemm(TVMArgs args, TVMRetValue* ret, TBatchGemmOp op) {
   using DType = typename TBatchGemmOp::TDatatype;
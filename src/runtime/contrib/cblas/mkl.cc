@@ -26,6 +26,7 @@
 
 extern "C" {
 #include <mkl_cblas.h>
+#include <mkl_version.h>
 }
 
 #include "gemm_common.h"
@@ -88,6 +89,11 @@ struct MKLSgemmBatchOp {
                   int c_stride, int ldc) {
     CBLAS_TRANSPOSE trans_a = MKLBooleanToTranspose(ta);
     CBLAS_TRANSPOSE trans_b = MKLBooleanToTranspose(tb);
+#if INTEL_MKL_VERSION >= 20200002
+    // the strided variant saves building the arrays of matrix addresses
+    cblas_sgemm_batch_strided(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A, lda, a_stride, B,
+                              ldb, b_stride, beta, C, ldc, c_stride, batch_size);
+#else
     std::vector<const float*> A_array(batch_size);
     std::vector<const float*> B_array(batch_size);
     std::vector<float*> C_array(batch_size);
@@ -98,6 +104,7 @@ struct MKLSgemmBatchOp {
     }
     cblas_sgemm_batch(CblasColMajor, &trans_a, &trans_b, &M, &N, &K, &alpha, A_array.data(), &lda,
                       B_array.data(), &ldb, &beta, C_array.data(), &ldc, 1, &batch_size);
+#endif
   }
 };
 
@@ -124,6 +131,11 @@ struct MKLDgemmBatchOp {
                   int c_stride, int ldc) {
     CBLAS_TRANSPOSE trans_a = MKLBooleanToTranspose(ta);
     CBLAS_TRANSPOSE trans_b = MKLBooleanToTranspose(tb);
+#if INTEL_MKL_VERSION >= 20200002
+    // the strided variant saves building the arrays of matrix addresses
+    cblas_dgemm_batch_strided(CblasColMajor, trans_a, trans_b, M, N, K, alpha, A, lda, a_stride, B,
+                              ldb, b_stride, beta, C, ldc, c_stride, batch_size);
+#else
     std::vector<const double*> A_array(batch_size);
     std::vector<const double*> B_array(batch_size);
     std::vector<double*> C_array(batch_size);
@@ -134,6 +146,7 @@ struct MKLDgemmBatchOp {
     }
     cblas_dgemm_batch(CblasColMajor, &trans_a, &trans_b, &M, &N, &K, &alpha, A_array.data(), &lda,
                       B_array.data(), &ldb, &beta, C_array.data(), &ldc, 1, &batch_size);
+#endif
   }
 };
 
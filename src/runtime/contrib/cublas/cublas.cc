@@ -35,13 +35,6 @@ inline cublasOperation_t CUBLASBooleanToTranspose(bool item) {
   return item ? CUBLAS_OP_T : CUBLAS_OP_N;
 }
 
-inline void CUBLASTryEnableTensorCore(cublasHandle_t hdl) {
-  // TensorCores are only supported in cublas 9.0 or higher
-  int version;
-  CHECK_CUBLAS_ERROR(cublasGetVersion(hdl, &version));
-  if (version >= 9000) CHECK_CUBLAS_ERROR(cublasSetMathMode(hdl, CUBLAS_DEFAULT_MATH));
-}
-
 struct CublasHgemmOp {
   typedef half TDatatype;
   cublasHandle_t handle;
@@ -124,12 +117,31 @@ bool CheckMixPrecisionType(DLDataType in_dtype, DLDataType out_dtype, bool int_s
   if (int_support && TypeMatch(out_dtype, kDLInt, 32)) {
     return TypeMatch(in_dtype, kDLInt, 8);
   } else if (TypeMatch(out_dtype, kDLFloat, 32)) {
-    return TypeMatch(in_dtype, kDLInt, 8) || TypeMatch(in_dtype, kDLFloat, 16);
+    return TypeMatch(in_dtype, kDLInt, 8) || TypeMatch(in_dtype, kDLFloat, 16) ||
+           TypeMatch(in_dtype, kDLBfloat, 16);
+  } else if (TypeMatch(out_dtype, kDLBfloat, 16)) {
+    return TypeMatch(in_dtype, kDLBfloat, 16);
   } else {
     return false;
   }
 }
 
+/*! \brief Check if the gemm of two types goes through the Ex functions of cuBLAS. */
+inline bool UseGemmEx(DLDataType in_dtype, DLDataType out_dtype) {
+  return !TypeEqual(in_dtype, out_dtype) || TypeMatch(in_dtype, kDLBfloat, 16);
+}
+
+/*! \brief The accumulation type of the Ex functions, int32 or float32. */
+inline cudaDataType_t GetCudaComputeType(DLDataType out_dtype) {
+  return out_dtype.code == kDLInt ? CUDA_R_32I : CUDA_R_32F;
+}
+
+/*! \brief The algorithm of the Ex functions, on the tensor cores for the narrow inputs. */
+inline cublasGemmAlgo_t GetGemmAlgo(DLDataType in_dtype) {
+  if (in_dtype.bits <= 16) return CUBLAS_GEMM_DEFAULT_TENSOR_OP;
+  return CUBLAS_GEMM_DEFAULT;
+}
+
 int roundoff(int v, int d) { return (v + d - 1) / d * d; }
 
 #if CUDART_VERSION >= 10010
@@ -241,7 +253,8 @@ inline void CallGemmEx(TVMArgs args, TVMRetValue* ret, cublasHandle_t hdl) {
 
   cudaDataType_t cuda_in_type = GetCudaDataType(A->dtype);
   cudaDataType_t cuda_out_type = GetCudaDataType(C->dtype);
-  cublasGemmAlgo_t algo = CUBLAS_GEMM_DEFAULT;
+  cudaDataType_t cuda_compute_type = GetCudaComputeType(C->dtype);
+  cublasGemmAlgo_t algo = GetGemmAlgo(A->dtype);
   void *alpha_ptr = nullptr, *beta_ptr = nullptr;
   auto alpha_int = static_cast<int32_t>(alpha);
   auto beta_int = static_cast<int32_t>(beta);
@@ -250,7 +263,7 @@ inline void CallGemmEx(TVMArgs args, TVMRetValue* ret, cublasHandle_t hdl) {
   if (C->dtype.code == kDLInt) {
     alpha_ptr = &alpha_int;
     beta_ptr = &beta_int;
-  } else if (C->dtype.code == kDLFloat) {
+  } else if (C->dtype.code == kDLFloat || C->dtype.code == kDLBfloat) {
     alpha_ptr = &alpha_float;
     beta_ptr = &beta_float;
   }
@@ -263,7 +276,7 @@ inline void CallGemmEx(TVMArgs args, TVMRetValue* ret, cublasHandle_t hdl) {
       cublasGemmEx(hdl, CUBLASBooleanToTranspose(transb), CUBLASBooleanToTranspose(transa),
                    ColumnCount(B, transb), RowCount(A, transa), ColumnCount(A, transa), alpha_ptr,
                    B_data, cuda_in_type, ColumnStride(B), A_data, cuda_in_type, ColumnStride(A),
-                   beta_ptr, C_data, cuda_out_type, ColumnStride(C), cuda_out_type, algo));
+                   beta_ptr, C_data, cuda_out_type, ColumnStride(C), cuda_compute_type, algo));
 }
 
 inline void CallBatchGemmEx(TVMArgs args, TVMRetValue* ret, cublasHandle_t hdl) {
@@ -318,7 +331,8 @@ inline void CallBatchGemmEx(TVMArgs args, TVMRetValue* ret, cublasHandle_t hdl)
 
   cudaDataType_t cuda_in_type = GetCudaDataType(A->dtype);
   cudaDataType_t cuda_out_type = GetCudaDataType(C->dtype);
-  cublasGemmAlgo_t algo = CUBLAS_GEMM_DEFAULT;
+  cudaDataType_t cuda_compute_type = GetCudaComputeType(C->dtype);
+  cublasGemmAlgo_t algo = GetGemmAlgo(A->dtype);
   void *alpha_ptr = nullptr, *beta_ptr = nullptr;
   auto alpha_int = static_cast<int32_t>(alpha);
   auto beta_int = static_cast<int32_t>(beta);
@@ -327,7 +341,7 @@ inline void CallBatchGemmEx(TVMArgs args, TVMRetValue* ret, cublasHandle_t hdl)
   if (C->dtype.code == kDLInt) {
     alpha_ptr = &alpha_int;
     beta_ptr = &beta_int;
-  } else if (C->dtype.code == kDLFloat) {
+  } else if (C->dtype.code == kDLFloat || C->dtype.code == kDLBfloat) {
     alpha_ptr = &alpha_float;
     beta_ptr = &beta_float;
   }
@@ -339,8 +353,8 @@ inline void CallBatchGemmEx(TVMArgs args, TVMRetValue* ret, cublasHandle_t hdl)
       hdl, CUBLASBooleanToTranspose(transb), CUBLASBooleanToTranspose(transa),
       ColumnCount3D(B, transb), RowCount3D(A, transa), ColumnCount3D(A, transa), alpha_ptr, B_data,
       cuda_in_type, ColumnStride3D(B), B_stride, A_data, cuda_in_type, ColumnStride3D(A), A_stride,
-      beta_ptr, C_data, cuda_out_type, ColumnStride3D(C), C_stride, batch_size, cuda_out_type,
-      algo));
+      beta_ptr, C_data, cuda_out_type, ColumnStride3D(C), C_stride, batch_size,
+      cuda_compute_type, algo));
 }
 
 // matrix multiplication for row major
@@ -350,9 +364,7 @@ TVM_REGISTER_GLOBAL("tvm.contrib.cublas.matmul").set_body([](TVMArgs args, TVMRe
 
   CuBlasThreadEntry* entry_ptr = CuBlasThreadEntry::ThreadLocal();
 
-  CUBLASTryEnableTensorCore(entry_ptr->handle);
-
-  if (TypeEqual(A->dtype, C->dtype)) {
+  if (!UseGemmEx(A->dtype, C->dtype)) {
     ICHECK(TypeMatch(A->dtype, kDLFloat, 16) || TypeMatch(A->dtype, kDLFloat, 32) ||
            TypeMatch(A->dtype, kDLFloat, 64));
 
@@ -373,13 +385,8 @@ TVM_REGISTER_GLOBAL("tvm.contrib.cublaslt.matmul").set_body([](TVMArgs args, TVM
 
   CuBlasThreadEntry* entry_ptr = CuBlasThreadEntry::ThreadLocal();
 
-  CUBLASTryEnableTensorCore(entry_ptr->handle);
-
   ICHECK(TypeMatch(A->dtype, kDLInt, 8)) << "Expects dtype to be int8\n";
-  cublasLtHandle_t ltHandle;
-  CHECK_CUBLAS_ERROR(cublasLtCreate(&ltHandle));
-  CallLtIgemm(args, ret, ltHandle);
-  CHECK_CUBLAS_ERROR(cublasLtDestroy(ltHandle));
+  CallLtIgemm(args, ret, entry_ptr->GetLtHandle());
 });
 #endif  // CUDART_VERSION >= 10010
 
@@ -389,8 +396,7 @@ TVM_REGISTER_GLOBAL("tvm.contrib.cublas.batch_matmul").set_body([](TVMArgs args,
 
   CuBlasThreadEntry* entry_ptr = CuBlasThreadEntry::ThreadLocal();
 
-  CUBLASTryEnableTensorCore(entry_ptr->handle);
-  if (TypeEqual(A->dtype, C->dtype)) {
+  if (!UseGemmEx(A->dtype, C->dtype)) {
     ICHECK(TypeMatch(A->dtype, kDLFloat, 16) || TypeMatch(A->dtype, kDLFloat, 32) ||
            TypeMatch(A->dtype, kDLFloat, 64));
 
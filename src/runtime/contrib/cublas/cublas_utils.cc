@@ -30,14 +30,38 @@
 namespace tvm {
 namespace contrib {
 
-CuBlasThreadEntry::CuBlasThreadEntry() { CHECK_CUBLAS_ERROR(cublasCreate(&handle)); }
+CuBlasThreadEntry::CuBlasThreadEntry() {
+  CHECK_CUBLAS_ERROR(cublasCreate(&handle));
+  // From cuBLAS 11 the default math mode uses the tensor cores for the half, bfloat16 and int8
+  // inputs, the older versions must be asked to.
+#if CUDART_VERSION >= 11000
+  CHECK_CUBLAS_ERROR(cublasSetMathMode(handle, CUBLAS_DEFAULT_MATH));
+#else
+  CHECK_CUBLAS_ERROR(cublasSetMathMode(handle, CUBLAS_TENSOR_OP_MATH));
+#endif
+}
 
 CuBlasThreadEntry::~CuBlasThreadEntry() {
   if (handle) {
     cublasDestroy(handle);
     handle = nullptr;
   }
+#if CUDART_VERSION >= 10010
+  if (lt_handle) {
+    cublasLtDestroy(lt_handle);
+    lt_handle = nullptr;
+  }
+#endif  // CUDART_VERSION >= 10010
+}
+
+#if CUDART_VERSION >= 10010
+cublasLtHandle_t CuBlasThreadEntry::GetLtHandle() {
+  if (lt_handle == nullptr) {
+    CHECK_CUBLAS_ERROR(cublasLtCreate(&lt_handle));
+  }
+  return lt_handle;
 }
+#endif  // CUDART_VERSION >= 10010
 
 typedef dmlc::ThreadLocalStore<CuBlasThreadEntry> CuBlasThreadStore;
 
@@ -73,7 +73,13 @@ inline const char* GetCublasErrorString(int error) {
 struct CuBlasThreadEntry {
   CuBlasThreadEntry();
   ~CuBlasThreadEntry();
+  /*! \brief The handle, set to use the tensor cores once when it is created. */
   cublasHandle_t handle{nullptr};
+#if CUDART_VERSION >= 10010
+  /*! \brief The cublasLt handle, created on the first use. */
+  cublasLtHandle_t lt_handle{nullptr};
+  cublasLtHandle_t GetLtHandle();
+#endif  // CUDART_VERSION >= 10010
   static CuBlasThreadEntry* ThreadLocal();
 };  // CuBlasThreadEntry
 
@@ -101,6 +107,10 @@ inline cudaDataType_t GetCudaDataType(DLDataType type) {
       case 64:
         return CUDA_R_64F;
     }
+#if CUDART_VERSION >= 11000
+  } else if (type.code == kDLBfloat && type.bits == 16) {
+    return CUDA_R_16BF;
+#endif  // CUDART_VERSION >= 11000
   }
   LOG(FATAL) << "Unsupported cuda type";
   return CUDA_R_16F;
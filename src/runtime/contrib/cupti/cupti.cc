@@ -0,0 +1,423 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file cupti.cc
+ * \brief Performance counters of the CUDA kernels read through the CUPTI profiling API.
+ */
+#include <cupti_profiler_target.h>
+#include <cupti_target.h>
+#include <nvperf_cuda_host.h>
+#include <nvperf_host.h>
+#include <nvperf_target.h>
+#include <tvm/runtime/contrib/cupti.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+#define CUPTI_CALL(func)                                                     \
+  {                                                                          \
+    CUptiResult e = (func);                                                  \
+    if (e != CUPTI_SUCCESS) {                                                \
+      const char* msg;                                                       \
+      cuptiGetResultString(e, &msg);                                         \
+      LOG(FATAL) << "CUPTIError: in function " #func " " << e << " " << msg; \
+    }                                                                        \
+  }
+
+#define NVPW_CALL(func)                                                         \
+  {                                                                             \
+    NVPA_Status e = (func);                                                     \
+    if (e != NVPA_STATUS_SUCCESS) {                                             \
+      LOG(FATAL) << "NVPWError: in function " #func " " << static_cast<int>(e); \
+    }                                                                           \
+  }
+
+/*!
+ * \brief The metrics collected by default: achieved occupancy, DRAM bytes, L2 hit rate and
+ * tensor pipe utilization.
+ */
+static const std::vector<std::string> default_cupti_metric_names = {
+    "sm__warps_active.avg.pct_of_peak_sustained_active", "dram__bytes.sum",
+    "lts__t_sector_hit_rate.pct", "sm__pipe_tensor_cycles_active.avg.pct_of_peak_sustained_active"};
+
+/*! \brief The maximum number of kernels launched by one profiled call. */
+static constexpr int kMaxKernelsPerCall = 64;
+
+/*! \brief The images CUPTI needs to collect a set of metrics on one device. */
+struct CUPTIDeviceConfig {
+  /*! \brief The chip name, owned by CUPTI. */
+  std::string chip_name;
+  /*! \brief The metrics context evaluating the counters. */
+  NVPA_MetricsContext* metrics_context{nullptr};
+  /*! \brief The counters to collect, built from the metric names. */
+  std::vector<uint8_t> config_image;
+  /*! \brief The layout of the counter data. */
+  std::vector<uint8_t> counter_data_prefix;
+};
+
+/*! \brief Object holding the counter data of a profiled function call. */
+struct CUPTISessionNode : public Object {
+  /*! \brief The device of the call. */
+  Device dev;
+  /*! \brief The counter data filled by the kernels of the call. */
+  std::vector<uint8_t> counter_data;
+  std::vector<uint8_t> scratch_buffer;
+  /*! \brief Whether the session was ended early by a nested call, which has the metrics. */
+  bool discarded{false};
+
+  explicit CUPTISessionNode(Device dev) : dev(dev) {}
+
+  static constexpr const char* _type_key = "CUPTISessionNode";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CUPTISessionNode, Object);
+};
+
+/*! \brief MetricCollectorNode for the hardware counters of NVIDIA GPUs.
+ *
+ * Each call is profiled in its own CUPTI session, in which every kernel launched by the call is
+ * replayed until all the counters are read. Only one session can run at a time, so a call, such
+ * as the total of a device, that is interrupted by a nested call gets no metrics and the nested
+ * call gets them.
+ *
+ * The metric names are the ones of Nsight Compute, listed by `ncu --query-metrics`.
+ */
+struct CUPTIMetricCollectorNode final : public MetricCollectorNode {
+  explicit CUPTIMetricCollectorNode(Array<String> metrics) {
+    for (const String& metric : metrics) {
+      metric_names.push_back(metric);
+    }
+    if (metric_names.empty()) {
+      metric_names = default_cupti_metric_names;
+    }
+  }
+
+  void Init(Array<DeviceWrapper> devices) final {
+    CUpti_Profiler_Initialize_Params init_params = {CUpti_Profiler_Initialize_Params_STRUCT_SIZE};
+    CUPTI_CALL(cuptiProfilerInitialize(&init_params));
+    NVPW_InitializeHost_Params host_params = {NVPW_InitializeHost_Params_STRUCT_SIZE};
+    NVPW_CALL(NVPW_InitializeHost(&host_params));
+    for (auto wrapped_device : devices) {
+      Device dev = wrapped_device->device;
+      if (dev.device_type != kDLCUDA || configs.count(dev.device_id)) continue;
+      configs[dev.device_id] = CreateConfig(dev.device_id);
+    }
+  }
+
+  ObjectRef Start(Device dev) final {
+    auto it = configs.find(dev.device_id);
+    if (dev.device_type != kDLCUDA || it == configs.end()) {
+      return ObjectRef(nullptr);
+    }
+    if (active_ != nullptr) {
+      // only one session can be profiled, the outer call gives it up
+      EndSession(active_);
+      active_->discarded = true;
+    }
+    const CUPTIDeviceConfig& config = it->second;
+    auto session = make_object<CUPTISessionNode>(dev);
+    InitCounterData(config, session.get());
+
+    CUpti_Profiler_BeginSession_Params begin_params = {
+        CUpti_Profiler_BeginSession_Params_STRUCT_SIZE};
+    begin_params.ctx = nullptr;
+    begin_params.counterDataImageSize = session->counter_data.size();
+    begin_params.pCounterDataImage = session->counter_data.data();
+    begin_params.counterDataScratchBufferSize = session->scratch_buffer.size();
+    begin_params.pCounterDataScratchBuffer = session->scratch_buffer.data();
+    begin_params.range = CUPTI_AutoRange;
+    begin_params.replayMode = CUPTI_KernelReplay;
+    begin_params.maxRangesPerPass = kMaxKernelsPerCall;
+    begin_params.maxLaunchesPerPass = kMaxKernelsPerCall;
+    CUPTI_CALL(cuptiProfilerBeginSession(&begin_params));
+
+    CUpti_Profiler_SetConfig_Params config_params = {CUpti_Profiler_SetConfig_Params_STRUCT_SIZE};
+    config_params.pConfig = config.config_image.data();
+    config_params.configSize = config.config_image.size();
+    config_params.passIndex = 0;
+    config_params.minNestingLevel = 1;
+    config_params.numNestingLevels = 1;
+    CUPTI_CALL(cuptiProfilerSetConfig(&config_params));
+
+    CUpti_Profiler_EnableProfiling_Params enable_params = {
+        CUpti_Profiler_EnableProfiling_Params_STRUCT_SIZE};
+    CUPTI_CALL(cuptiProfilerEnableProfiling(&enable_params));
+    active_ = session.get();
+    return ObjectRef(session);
+  }
+
+  Map<String, ObjectRef> Stop(ObjectRef obj) final {
+    CUPTISessionNode* session = const_cast<CUPTISessionNode*>(obj.as<CUPTISessionNode>());
+    if (session->discarded) return {};
+    EndSession(session);
+    const CUPTIDeviceConfig& config = configs.at(session->dev.device_id);
+
+    NVPW_CounterData_GetNumRanges_Params ranges_params = {
+        NVPW_CounterData_GetNumRanges_Params_STRUCT_SIZE};
+    ranges_params.pCounterDataImage = session->counter_data.data();
+    NVPW_CALL(NVPW_CounterData_GetNumRanges(&ranges_params));
+
+    std::vector<const char*> names;
+    for (const std::string& name : metric_names) {
+      names.push_back(name.c_str());
+    }
+    // each kernel is a range, the metrics of a call add up the counts and average the ratios
+    std::vector<double> totals(names.size(), 0);
+    std::vector<double> values(names.size());
+    for (size_t range = 0; range < ranges_params.numRanges; ++range) {
+      NVPW_MetricsContext_SetCounterData_Params data_params = {
+          NVPW_MetricsContext_SetCounterData_Params_STRUCT_SIZE};
+      data_params.pMetricsContext = config.metrics_context;
+      data_params.pCounterDataImage = session->counter_data.data();
+      data_params.rangeIndex = range;
+      data_params.isolated = true;
+      NVPW_CALL(NVPW_MetricsContext_SetCounterData(&data_params));
+      NVPW_MetricsContext_EvaluateToGpuValues_Params eval_params = {
+          NVPW_MetricsContext_EvaluateToGpuValues_Params_STRUCT_SIZE};
+      eval_params.pMetricsContext = config.metrics_context;
+      eval_params.numMetrics = names.size();
+      eval_params.ppMetricNames = names.data();
+      eval_params.pMetricValues = values.data();
+      NVPW_CALL(NVPW_MetricsContext_EvaluateToGpuValues(&eval_params));
+      for (size_t i = 0; i < names.size(); ++i) {
+        totals[i] += values[i];
+      }
+    }
+    Map<String, ObjectRef> metrics;
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (IsRatio(metric_names[i])) {
+        double mean = ranges_params.numRanges ? totals[i] / ranges_params.numRanges : 0;
+        metrics.Set(metric_names[i], ObjectRef(make_object<PercentNode>(mean)));
+      } else {
+        metrics.Set(metric_names[i],
+                    ObjectRef(make_object<CountNode>(static_cast<int64_t>(totals[i]))));
+      }
+    }
+    return metrics;
+  }
+
+  ~CUPTIMetricCollectorNode() final {
+    for (auto& p : configs) {
+      NVPW_MetricsContext_Destroy_Params destroy_params = {
+          NVPW_MetricsContext_Destroy_Params_STRUCT_SIZE};
+      destroy_params.pMetricsContext = p.second.metrics_context;
+      NVPW_MetricsContext_Destroy(&destroy_params);
+    }
+  }
+
+  /*! \brief The metrics collected, in the order of the evaluated values. */
+  std::vector<std::string> metric_names;
+  /*! \brief The images of each CUDA device id. */
+  std::unordered_map<int, CUPTIDeviceConfig> configs;
+
+  static constexpr const char* _type_key = "runtime.profiling.CUPTIMetricCollector";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CUPTIMetricCollectorNode, MetricCollectorNode);
+
+ private:
+  /*! \return Whether a metric is a percentage, like the `.pct` and `.pct_of_peak_*` ones. */
+  static bool IsRatio(const std::string& name) { return name.find(".pct") != std::string::npos; }
+
+  CUPTIDeviceConfig CreateConfig(int device_id) {
+    CUPTIDeviceConfig config;
+    CUpti_Device_GetChipName_Params chip_params = {CUpti_Device_GetChipName_Params_STRUCT_SIZE};
+    chip_params.deviceIndex = device_id;
+    CUPTI_CALL(cuptiDeviceGetChipName(&chip_params));
+    config.chip_name = chip_params.pChipName;
+
+    NVPW_CUDA_MetricsContext_Create_Params context_params = {
+        NVPW_CUDA_MetricsContext_Create_Params_STRUCT_SIZE};
+    context_params.pChipName = config.chip_name.c_str();
+    NVPW_CALL(NVPW_CUDA_MetricsContext_Create(&context_params));
+    config.metrics_context = context_params.pMetricsContext;
+
+    // the raw counters the metrics are computed from
+    std::vector<std::string> raw_names;
+    for (const std::string& name : metric_names) {
+      NVPW_MetricsContext_GetMetricProperties_Begin_Params begin_params = {
+          NVPW_MetricsContext_GetMetricProperties_Begin_Params_STRUCT_SIZE};
+      begin_params.pMetricsContext = config.metrics_context;
+      begin_params.pMetricName = name.c_str();
+      if (NVPW_MetricsContext_GetMetricProperties_Begin(&begin_params) != NVPA_STATUS_SUCCESS) {
+        LOG(FATAL) << "CUPTIMetricCollector: unknown metric " << name << " on "
+                   << config.chip_name;
+      }
+      for (const char** dep = begin_params.ppRawMetricDependencies; *dep != nullptr; ++dep) {
+        raw_names.push_back(*dep);
+      }
+      NVPW_MetricsContext_GetMetricProperties_End_Params end_params = {
+          NVPW_MetricsContext_GetMetricProperties_End_Params_STRUCT_SIZE};
+      end_params.pMetricsContext = config.metrics_context;
+      NVPW_CALL(NVPW_MetricsContext_GetMetricProperties_End(&end_params));
+    }
+    std::vector<NVPA_RawMetricRequest> requests;
+    for (const std::string& raw_name : raw_names) {
+      NVPA_RawMetricRequest request = {NVPA_RAW_METRIC_REQUEST_STRUCT_SIZE};
+      request.pMetricName = raw_name.c_str();
+      request.isolated = true;
+      request.keepInstances = true;
+      requests.push_back(request);
+    }
+
+    NVPW_CUDA_RawMetricsConfig_Create_Params raw_params = {
+        NVPW_CUDA_RawMetricsConfig_Create_Params_STRUCT_SIZE};
+    raw_params.activityKind = NVPA_ACTIVITY_KIND_PROFILER;
+    raw_params.pChipName = config.chip_name.c_str();
+    NVPW_CALL(NVPW_CUDA_RawMetricsConfig_Create(&raw_params));
+    NVPA_RawMetricsConfig* raw_config = raw_params.pRawMetricsConfig;
+    NVPW_RawMetricsConfig_BeginPassGroup_Params begin_pass_params = {
+        NVPW_RawMetricsConfig_BeginPassGroup_Params_STRUCT_SIZE};
+    begin_pass_params.pRawMetricsConfig = raw_config;
+    NVPW_CALL(NVPW_RawMetricsConfig_BeginPassGroup(&begin_pass_params));
+    NVPW_RawMetricsConfig_AddMetrics_Params add_params = {
+        NVPW_RawMetricsConfig_AddMetrics_Params_STRUCT_SIZE};
+    add_params.pRawMetricsConfig = raw_config;
+    add_params.pRawMetricRequests = requests.data();
+    add_params.numMetricRequests = requests.size();
+    NVPW_CALL(NVPW_RawMetricsConfig_AddMetrics(&add_params));
+    NVPW_RawMetricsConfig_EndPassGroup_Params end_pass_params = {
+        NVPW_RawMetricsConfig_EndPassGroup_Params_STRUCT_SIZE};
+    end_pass_params.pRawMetricsConfig = raw_config;
+    NVPW_CALL(NVPW_RawMetricsConfig_EndPassGroup(&end_pass_params));
+    NVPW_RawMetricsConfig_GenerateConfigImage_Params generate_params = {
+        NVPW_RawMetricsConfig_GenerateConfigImage_Params_STRUCT_SIZE};
+    generate_params.pRawMetricsConfig = raw_config;
+    NVPW_CALL(NVPW_RawMetricsConfig_GenerateConfigImage(&generate_params));
+    NVPW_RawMetricsConfig_GetConfigImage_Params image_params = {
+        NVPW_RawMetricsConfig_GetConfigImage_Params_STRUCT_SIZE};
+    image_params.pRawMetricsConfig = raw_config;
+    NVPW_CALL(NVPW_RawMetricsConfig_GetConfigImage(&image_params));
+    config.config_image.resize(image_params.bytesCopied);
+    image_params.bytesAllocated = config.config_image.size();
+    image_params.pBuffer = config.config_image.data();
+    NVPW_CALL(NVPW_RawMetricsConfig_GetConfigImage(&image_params));
+    NVPW_RawMetricsConfig_Destroy_Params raw_destroy_params = {
+        NVPW_RawMetricsConfig_Destroy_Params_STRUCT_SIZE};
+    raw_destroy_params.pRawMetricsConfig = raw_config;
+    NVPW_CALL(NVPW_RawMetricsConfig_Destroy(&raw_destroy_params));
+
+    NVPW_CounterDataBuilder_Create_Params builder_params = {
+        NVPW_CounterDataBuilder_Create_Params_STRUCT_SIZE};
+    builder_params.pChipName = config.chip_name.c_str();
+    NVPW_CALL(NVPW_CounterDataBuilder_Create(&builder_params));
+    NVPW_CounterDataBuilder_AddMetrics_Params builder_add_params = {
+        NVPW_CounterDataBuilder_AddMetrics_Params_STRUCT_SIZE};
+    builder_add_params.pCounterDataBuilder = builder_params.pCounterDataBuilder;
+    builder_add_params.pRawMetricRequests = requests.data();
+    builder_add_params.numMetricRequests = requests.size();
+    NVPW_CALL(NVPW_CounterDataBuilder_AddMetrics(&builder_add_params));
+    NVPW_CounterDataBuilder_GetCounterDataPrefix_Params prefix_params = {
+        NVPW_CounterDataBuilder_GetCounterDataPrefix_Params_STRUCT_SIZE};
+    prefix_params.pCounterDataBuilder = builder_params.pCounterDataBuilder;
+    NVPW_CALL(NVPW_CounterDataBuilder_GetCounterDataPrefix(&prefix_params));
+    config.counter_data_prefix.resize(prefix_params.bytesCopied);
+    prefix_params.bytesAllocated = config.counter_data_prefix.size();
+    prefix_params.pBuffer = config.counter_data_prefix.data();
+    NVPW_CALL(NVPW_CounterDataBuilder_GetCounterDataPrefix(&prefix_params));
+    NVPW_CounterDataBuilder_Destroy_Params builder_destroy_params = {
+        NVPW_CounterDataBuilder_Destroy_Params_STRUCT_SIZE};
+    builder_destroy_params.pCounterDataBuilder = builder_params.pCounterDataBuilder;
+    NVPW_CALL(NVPW_CounterDataBuilder_Destroy(&builder_destroy_params));
+    return config;
+  }
+
+  static void InitCounterData(const CUPTIDeviceConfig& config, CUPTISessionNode* session) {
+    CUpti_Profiler_CounterDataImageOptions options;
+    options.pCounterDataPrefix = config.counter_data_prefix.data();
+    options.counterDataPrefixSize = config.counter_data_prefix.size();
+    options.maxNumRanges = kMaxKernelsPerCall;
+    options.maxNumRangeTreeNodes = kMaxKernelsPerCall;
+    options.maxRangeNameLength = 64;
+
+    CUpti_Profiler_CounterDataImage_CalculateSize_Params size_params = {
+        CUpti_Profiler_CounterDataImage_CalculateSize_Params_STRUCT_SIZE};
+    size_params.pOptions = &options;
+    size_params.sizeofCounterDataImageOptions = CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE;
+    CUPTI_CALL(cuptiProfilerCounterDataImageCalculateSize(&size_params));
+    session->counter_data.resize(size_params.counterDataImageSize);
+
+    CUpti_Profiler_CounterDataImage_Initialize_Params init_params = {
+        CUpti_Profiler_CounterDataImage_Initialize_Params_STRUCT_SIZE};
+    init_params.sizeofCounterDataImageOptions = CUpti_Profiler_CounterDataImageOptions_STRUCT_SIZE;
+    init_params.pOptions = &options;
+    init_params.counterDataImageSize = session->counter_data.size();
+    init_params.pCounterDataImage = session->counter_data.data();
+    CUPTI_CALL(cuptiProfilerCounterDataImageInitialize(&init_params));
+
+    CUpti_Profiler_CounterDataImage_CalculateScratchBufferSize_Params scratch_size_params = {
+        CUpti_Profiler_CounterDataImage_CalculateScratchBufferSize_Params_STRUCT_SIZE};
+    scratch_size_params.counterDataImageSize = session->counter_data.size();
+    scratch_size_params.pCounterDataImage = session->counter_data.data();
+    CUPTI_CALL(cuptiProfilerCounterDataImageCalculateScratchBufferSize(&scratch_size_params));
+    session->scratch_buffer.resize(scratch_size_params.counterDataScratchBufferSize);
+
+    CUpti_Profiler_CounterDataImage_InitializeScratchBuffer_Params scratch_params = {
+        CUpti_Profiler_CounterDataImage_InitializeScratchBuffer_Params_STRUCT_SIZE};
+    scratch_params.counterDataImageSize = session->counter_data.size();
+    scratch_params.pCounterDataImage = session->counter_data.data();
+    scratch_params.counterDataScratchBufferSize = session->scratch_buffer.size();
+    scratch_params.pCounterDataScratchBuffer = session->scratch_buffer.data();
+    CUPTI_CALL(cuptiProfilerCounterDataImageInitializeScratchBuffer(&scratch_params));
+  }
+
+  void EndSession(CUPTISessionNode* session) {
+    // the kernels of the call must be done before the counters are read
+    DeviceAPI::Get(session->dev)->StreamSync(session->dev, nullptr);
+    CUpti_Profiler_DisableProfiling_Params disable_params = {
+        CUpti_Profiler_DisableProfiling_Params_STRUCT_SIZE};
+    CUPTI_CALL(cuptiProfilerDisableProfiling(&disable_params));
+    CUpti_Profiler_UnsetConfig_Params unset_params = {
+        CUpti_Profiler_UnsetConfig_Params_STRUCT_SIZE};
+    CUPTI_CALL(cuptiProfilerUnsetConfig(&unset_params));
+    CUpti_Profiler_EndSession_Params end_params = {CUpti_Profiler_EndSession_Params_STRUCT_SIZE};
+    CUPTI_CALL(cuptiProfilerEndSession(&end_params));
+    active_ = nullptr;
+  }
+
+  /*! \brief The call whose session is running, nullptr when there is none. */
+  CUPTISessionNode* active_{nullptr};
+};
+
+/*! \brief Wrapper for `CUPTIMetricCollectorNode`. */
+class CUPTIMetricCollector : public MetricCollector {
+ public:
+  explicit CUPTIMetricCollector(Array<String> metrics) {
+    data_ = make_object<CUPTIMetricCollectorNode>(metrics);
+  }
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CUPTIMetricCollector, MetricCollector,
+                                        CUPTIMetricCollectorNode);
+};
+
+MetricCollector CreateCUPTIMetricCollector(Array<String> metrics) {
+  return CUPTIMetricCollector(metrics);
+}
+
+TVM_REGISTER_OBJECT_TYPE(CUPTISessionNode);
+TVM_REGISTER_OBJECT_TYPE(CUPTIMetricCollectorNode);
+
+TVM_REGISTER_GLOBAL("runtime.profiling.CUPTIMetricCollector")
+    .set_body_typed([](Array<String> metrics) { return CUPTIMetricCollector(metrics); });
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
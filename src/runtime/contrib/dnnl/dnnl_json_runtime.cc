@@ -25,8 +25,14 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../json/json_node.h"
@@ -40,6 +46,55 @@ namespace contrib {
 using namespace tvm::runtime;
 using namespace tvm::runtime::json;
 
+/*! \brief The CPU engine shared by all the DNNL JSON runtime modules. */
+static dnnl::engine& GetDNNLEngine() {
+  static dnnl::engine engine(dnnl::engine::kind::cpu, 0);
+  return engine;
+}
+
+/*! \brief A primitive and the size of the scratchpad its execution needs. */
+struct DNNLPrimitive {
+  dnnl::primitive prim;
+  size_t scratchpad_size;
+};
+
+/*!
+ * \brief The primitives of all the DNNL JSON runtime modules, keyed by their kind, shapes and
+ * attributes. Creating a primitive generates its kernel, so the layers of the same configuration,
+ * in one subgraph or across modules, share it. Primitives hold no data and are executed
+ * concurrently.
+ */
+class DNNLPrimitiveCache {
+ public:
+  static DNNLPrimitiveCache* Global() {
+    static DNNLPrimitiveCache* inst = new DNNLPrimitiveCache();
+    return inst;
+  }
+
+  /*!
+   * \brief Get the primitive of a key, creating it on the first use.
+   * \tparam PrimitiveT The type of the primitive.
+   * \param key The kind, shapes and attributes of the primitive.
+   * \param fcreate The function creating the primitive descriptor.
+   * \return The primitive.
+   */
+  template <typename PrimitiveT, typename FCreate>
+  DNNLPrimitive GetOrCreate(const std::string& key, FCreate fcreate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+      auto prim_desc = fcreate();
+      DNNLPrimitive prim{PrimitiveT(prim_desc), prim_desc.scratchpad_desc().get_size()};
+      it = cache_.emplace(key, prim).first;
+    }
+    return it->second;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, DNNLPrimitive> cache_;
+};
+
 class DNNLJSONRuntime : public JSONRuntimeBase {
   using tag = dnnl::memory::format_tag;
   using dt = dnnl::memory::data_type;
@@ -51,6 +106,38 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
   const char* type_key() const { return "dnnl_json"; }
 
+  /*!
+   * \brief Get a packed function. The subgraph function binds its arguments locally instead of
+   * through the shared data entries, so the request threads can run it concurrently.
+   *
+   * \param name The name/symbol of the function.
+   * \param sptr_to_self The pointer to the module node.
+   * \return The packed function.
+   */
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) override {
+    if (this->symbol_name_ == name) {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ICHECK(this->initialized_) << "The module has not been initialized";
+        ICHECK_EQ(args.size(), input_var_eid_.size() + outputs_.size())
+            << "Found mismatch in the number of provided data entryies and required.";
+        std::vector<const DLTensor*> io(args.size());
+        for (int i = 0; i < args.size(); ++i) {
+          ICHECK(args[i].type_code() == kTVMNDArrayHandle ||
+                 args[i].type_code() == kTVMDLTensorHandle)
+              << "Expect NDArray or DLTensor as inputs";
+          if (args[i].IsObjectRef<NDArray>()) {
+            NDArray arr = args[i];
+            io[i] = arr.operator->();
+          } else {
+            io[i] = args[i].operator DLTensor*();
+          }
+        }
+        this->Run(io);
+      });
+    }
+    return JSONRuntimeBase::GetFunction(name, sptr_to_self);
+  }
+
   void Init(const Array<NDArray>& consts) override {
     BuildEngine();
 
@@ -59,41 +146,159 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
     // Setup constants entries for weights.
     SetupConstants(consts);
+
+    // The buffers holding constants only are filled once and shared by the threads.
+    const_buffers_.resize(buffers_.size());
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+      if (buffers_[i].is_const) {
+        const_buffers_[i] = dnnl::memory(buffers_[i].desc, GetDNNLEngine());
+        WriteEntries(const_buffers_[i], buffers_[i].entries);
+      }
+    }
   }
 
   void Run() override {
+    std::vector<const DLTensor*> io;
+    for (uint32_t eid : input_var_eid_) {
+      io.push_back(data_entry_[eid]);
+    }
+    for (const auto& output : outputs_) {
+      io.push_back(data_entry_[EntryID(output)]);
+    }
+    Run(io);
+  }
+
+ private:
+  /*! \brief A buffer of the network, holding the data of one or more entries. */
+  struct BufferInfo {
+    /*! \brief The memory description of the buffer. */
+    dnnl::memory::desc desc;
+    /*! \brief The entries in the buffer, with their offsets in elements. */
+    std::vector<std::pair<uint32_t, size_t>> entries;
+    /*! \brief Whether all the entries are constants. */
+    bool is_const;
+  };
+
+  /*! \brief A primitive of the network and the buffers of its arguments. */
+  struct Layer {
+    DNNLPrimitive prim;
+    std::vector<std::pair<int, size_t>> args;
+    /*! \brief The buffers copied into the destination before execution, for a sum post-op. */
+    int sum_src{-1};
+    int sum_dst{-1};
+  };
+
+  /*! \brief The memories and the stream of one run of the network in flight. */
+  struct RunState {
+    dnnl::stream stream;
+    std::vector<dnnl::memory> buffers;
+    std::vector<std::unordered_map<int, dnnl::memory>> net_args;
+  };
+
+  /*! \brief The post-ops fused into a convolution or a dense, parsed from the composite name. */
+  struct FusedOps {
+    bool has_bias{false};
+    bool has_sum{false};
+    std::vector<dnnl::algorithm> eltwise;
+  };
+
+  void Run(const std::vector<const DLTensor*>& io) {
+    std::unique_ptr<RunState> state = AcquireRunState();
+
     // Fill in the input buffers.
-    for (size_t i = 0; i < input_nodes_.size(); ++i) {
-      auto eid = EntryID(input_nodes_[i], 0);
-      // TODO(@comaniac): Support other data lengths.
-      size_t offset_in_bytes = entry_out_mem_[eid].second * 4;
-      size_t buffer_size = GetDataSize(*data_entry_[eid]);
-      write_to_dnnl_memory(data_entry_[eid]->data, entry_out_mem_[eid].first, buffer_size,
-                           offset_in_bytes);
+    for (size_t i = 0; i < input_var_eid_.size(); ++i) {
+      const auto& buffer = entry_buffer_.at(input_var_eid_[i]);
+      write_to_dnnl_memory(io[i]->data, state->buffers[buffer.first], GetDataSize(*io[i]),
+                           buffer.second * 4);
     }
 
     // Invoke the engine through intepreting the stream.
     for (size_t i = 0; i < net_.size(); ++i) {
-      net_.at(i).execute(stream_, net_args_.at(i));
+      const Layer& layer = net_[i];
+      if (layer.sum_src >= 0) {
+        const dnnl::memory& src = state->buffers[layer.sum_src];
+        write_to_dnnl_memory(src.get_data_handle(), state->buffers[layer.sum_dst],
+                             src.get_desc().get_size());
+      }
+      layer.prim.prim.execute(state->stream, state->net_args[i]);
     }
-    stream_.wait();
+    state->stream.wait();
 
     // Read output buffers.
     for (size_t i = 0; i < outputs_.size(); ++i) {
-      auto eid = EntryID(outputs_[i]);
-      size_t offset_in_bytes = entry_out_mem_[eid].second * 4;
-      size_t buffer_size = GetDataSize(*data_entry_[eid]);
-      read_from_dnnl_memory(data_entry_[eid]->data, entry_out_mem_[eid].first, buffer_size,
-                            offset_in_bytes);
+      const DLTensor* out = io[input_var_eid_.size() + i];
+      const auto& buffer = entry_buffer_.at(EntryID(outputs_[i]));
+      read_from_dnnl_memory(out->data, state->buffers[buffer.first], GetDataSize(*out),
+                            buffer.second * 4);
     }
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_run_states_.push_back(std::move(state));
+  }
+
+  // Take memories no other run is using, allocating them when all are busy. They are kept for
+  // the next runs, so there are only as many as the runs that were in flight at once.
+  std::unique_ptr<RunState> AcquireRunState() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!free_run_states_.empty()) {
+        std::unique_ptr<RunState> state = std::move(free_run_states_.back());
+        free_run_states_.pop_back();
+        return state;
+      }
+    }
+    std::unique_ptr<RunState> state(new RunState());
+    dnnl::engine& engine = GetDNNLEngine();
+    state->stream = dnnl::stream(engine);
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+      if (buffers_[i].is_const) {
+        state->buffers.push_back(const_buffers_[i]);
+      } else {
+        state->buffers.emplace_back(buffers_[i].desc, engine);
+        WriteEntries(state->buffers.back(), buffers_[i].entries);
+      }
+    }
+    // The layers run one after another, so they share one scratchpad.
+    size_t scratchpad_size = 0;
+    for (const auto& layer : net_) {
+      scratchpad_size = std::max(scratchpad_size, layer.prim.scratchpad_size);
+    }
+    dnnl::memory scratchpad;
+    if (scratchpad_size > 0) {
+      dnnl::memory::dims scratchpad_dims = {static_cast<dnnl::memory::dim>(scratchpad_size)};
+      scratchpad = dnnl::memory({scratchpad_dims, dt::u8, tag::x}, engine);
+    }
+    for (const auto& layer : net_) {
+      std::unordered_map<int, dnnl::memory> args;
+      for (const auto& arg : layer.args) {
+        args[arg.first] = state->buffers[arg.second];
+      }
+      if (layer.prim.scratchpad_size > 0) {
+        args[DNNL_ARG_SCRATCHPAD] = scratchpad;
+      }
+      state->net_args.push_back(args);
+    }
+    return state;
+  }
+
+  // Write the constant entries of a buffer.
+  void WriteEntries(const dnnl::memory& mem,
+                    const std::vector<std::pair<uint32_t, size_t>>& entries) {
+    for (const auto& entry : entries) {
+      const DLTensor* tensor = data_entry_[entry.first];
+      if (tensor == nullptr || !IsConstEntry(entry.first)) continue;
+      write_to_dnnl_memory(tensor->data, mem, GetDataSize(*tensor), entry.second * 4);
+    }
+  }
+
+  bool IsConstEntry(uint32_t eid) const {
+    for (uint32_t nid : const_idx_) {
+      if (EntryID(nid, 0) == eid) return true;
+    }
+    return false;
   }
 
- private:
   // Build up the engine based on the input graph.
   void BuildEngine() {
-    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
-    stream_ = dnnl::stream(engine_);
-
     // Build subgraph engine.
     for (size_t nid = 0; nid < nodes_.size(); ++nid) {
       const auto& node = nodes_[nid];
@@ -101,13 +306,13 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
         ICHECK_EQ(node.GetOpType(), "kernel");
         auto op_name = node.GetOpName();
         if ("nn.conv2d" == op_name) {
-          Conv2d(nid);
-        } else if ("dnnl.conv2d_relu" == op_name) {
-          Conv2d(nid, true, false);
-        } else if ("dnnl.conv2d_bias_relu" == op_name) {
-          Conv2d(nid, true, true);
+          Conv2d(nid, FusedOps());
+        } else if (op_name.compare(0, 12, "dnnl.conv2d_") == 0) {
+          Conv2d(nid, ParseFusedOps(op_name.substr(12)));
         } else if ("nn.dense" == op_name) {
-          Dense(nid);
+          Dense(nid, FusedOps());
+        } else if (op_name.compare(0, 11, "dnnl.dense_") == 0) {
+          Dense(nid, ParseFusedOps(op_name.substr(11)));
         } else if ("nn.batch_norm" == op_name) {
           BatchNorm(nid);
         } else if ("nn.relu" == op_name) {
@@ -121,36 +326,96 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
         }
       }
     }
+    // Mark the buffers the threads can share.
+    for (auto& buffer : buffers_) {
+      buffer.is_const = std::all_of(buffer.entries.begin(), buffer.entries.end(),
+                                    [this](const std::pair<uint32_t, size_t>& entry) {
+                                      return IsConstEntry(entry.first);
+                                    });
+    }
+  }
+
+  // Parse the fused ops of a composite name, e.g. "bias_sum_relu" of "dnnl.conv2d_bias_sum_relu".
+  static FusedOps ParseFusedOps(const std::string& names) {
+    FusedOps fused;
+    std::istringstream is(names);
+    std::string name;
+    while (std::getline(is, name, '_')) {
+      if (name == "bias") {
+        fused.has_bias = true;
+      } else if (name == "sum") {
+        fused.has_sum = true;
+      } else if (name == "relu") {
+        fused.eltwise.push_back(dnnl::algorithm::eltwise_relu);
+      } else if (name == "tanh") {
+        fused.eltwise.push_back(dnnl::algorithm::eltwise_tanh);
+      } else if (name == "sigmoid") {
+        fused.eltwise.push_back(dnnl::algorithm::eltwise_logistic);
+      } else {
+        LOG(FATAL) << "Unsupported fused op: " << name;
+      }
+    }
+    return fused;
+  }
+
+  // Create the attributes of a primitive with the fused post-ops, and append them to its key.
+  static dnnl::primitive_attr MakeAttr(const FusedOps& fused, std::ostringstream* key) {
+    dnnl::primitive_attr attr;
+    attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+    dnnl::post_ops ops;
+    if (fused.has_sum) {
+      ops.append_sum(1.f);
+      *key << "|sum";
+    }
+    for (auto algo : fused.eltwise) {
+      ops.append_eltwise(1.f, algo, 0.f, 0.f);
+      *key << "|eltwise" << static_cast<int>(algo);
+    }
+    attr.set_post_ops(ops);
+    return attr;
+  }
+
+  // Get the primitive of a key from the global cache.
+  template <typename PrimitiveT, typename FCreate>
+  static DNNLPrimitive GetPrimitive(const std::ostringstream& key, FCreate fcreate) {
+    return DNNLPrimitiveCache::Global()->GetOrCreate<PrimitiveT>(key.str(), fcreate);
+  }
+
+  static std::string DimsToString(const dnnl::memory::dims& dims) {
+    std::ostringstream os;
+    for (size_t i = 0; i < dims.size(); ++i) {
+      os << (i == 0 ? "" : "x") << dims[i];
+    }
+    return os.str();
   }
 
-  // Bind a JSON graph node entry to a DNNL memory.
-  dnnl::memory BindDNNLMemory(const JSONGraphNodeEntry& entry, dnnl::memory::desc mem_desc,
-                              size_t offset = 0) {
+  // Bind a JSON graph node entry to a new buffer, unless it is already bound.
+  size_t BindBuffer(const JSONGraphNodeEntry& entry, const dnnl::memory::desc& mem_desc) {
     auto eid = EntryID(entry);
-    if (entry_out_mem_.count(eid) == 0) {
-      return BindDNNLMemory(entry, dnnl::memory(mem_desc, engine_), offset);
+    if (entry_buffer_.count(eid) == 0) {
+      buffers_.push_back({mem_desc, {}, false});
+      BindBuffer(entry, buffers_.size() - 1);
     }
-    return entry_out_mem_[eid].first;
+    return entry_buffer_[eid].first;
   }
 
-  // Bind a JSON graph node entry to a given DNNL memory.
-  dnnl::memory BindDNNLMemory(const JSONGraphNodeEntry& entry, dnnl::memory mem,
-                              size_t offset = 0) {
+  // Bind a JSON graph node entry to a given buffer at an offset in elements.
+  size_t BindBuffer(const JSONGraphNodeEntry& entry, size_t buffer_id, size_t offset = 0) {
     auto eid = EntryID(entry);
-    // Since the DNNL memory has been created before calling this function, we assume the entry
-    // has not yet been bound to the other DNNL memory; otherwise it may have memory leak.
-    ICHECK_EQ(entry_out_mem_.count(eid), 0);
+    // The entry has not yet been bound to the other buffer; otherwise its data would be lost.
+    ICHECK_EQ(entry_buffer_.count(eid), 0);
 
     // TODO(@comanic): Support other data types (i.e., int8).
     auto data_node = nodes_[entry.id_];
     auto dltype = data_node.GetOpDataType()[entry.index_];
     ICHECK_EQ(dltype.bits, 32);
 
-    entry_out_mem_[eid] = {mem, offset};
-    return entry_out_mem_[eid].first;
+    entry_buffer_[eid] = {buffer_id, offset};
+    buffers_[buffer_id].entries.emplace_back(eid, offset);
+    return buffer_id;
   }
 
-  void Conv2d(const size_t& nid, const bool has_relu = false, const bool has_bias = false) {
+  void Conv2d(const size_t& nid, const FusedOps& fused) {
     auto node = nodes_[nid];
 
     // Setup attributes.
@@ -196,57 +461,62 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     auto conv_bias_md = dnnl::memory::desc(bias_dims, dt::f32, tag::any);
     auto conv_dst_md = dnnl::memory::desc(dst_dims, dt::f32, tag::nchw);
 
-    // Covn2d description.
-    auto conv_desc = dnnl::convolution_forward::desc(
-        dnnl::prop_kind::forward_inference, dnnl::algorithm::convolution_direct, conv_src_md,
-        conv_weights_md, conv_bias_md, conv_dst_md, strides_dims, padding_dims_l, padding_dims_r);
-
-    // Enable ReLU
-    dnnl::primitive_attr attr;
-    if (has_relu) {
-      dnnl::post_ops ops;
-      ops.append_eltwise(1.f, dnnl::algorithm::eltwise_relu, 0.f, 0.f);
-      attr.set_post_ops(ops);
-    }
-
-    auto conv2d_prim_desc = dnnl::convolution_forward::primitive_desc(conv_desc, attr, engine_);
-
-    // Push to the network.
-    auto conv = dnnl::convolution_forward(conv2d_prim_desc);
-    net_.push_back(conv);
+    // Fused bias and post-ops.
+    std::ostringstream key;
+    key << "conv2d|" << DimsToString(src_dims) << "|" << DimsToString(weights_dims) << "|"
+        << DimsToString(dst_dims) << "|" << DimsToString(strides_dims) << "|"
+        << DimsToString(padding_dims_l) << "|" << DimsToString(padding_dims_r)
+        << (fused.has_bias ? "|bias" : "");
+    dnnl::primitive_attr attr = MakeAttr(fused, &key);
+
+    Layer layer;
+    layer.prim = GetPrimitive<dnnl::convolution_forward>(key, [&]() {
+      // Covn2d description.
+      auto conv_desc =
+          fused.has_bias
+              ? dnnl::convolution_forward::desc(
+                    dnnl::prop_kind::forward_inference, dnnl::algorithm::convolution_direct,
+                    conv_src_md, conv_weights_md, conv_bias_md, conv_dst_md, strides_dims,
+                    padding_dims_l, padding_dims_r)
+              : dnnl::convolution_forward::desc(
+                    dnnl::prop_kind::forward_inference, dnnl::algorithm::convolution_direct,
+                    conv_src_md, conv_weights_md, conv_dst_md, strides_dims, padding_dims_l,
+                    padding_dims_r);
+      return dnnl::convolution_forward::primitive_desc(conv_desc, attr, GetDNNLEngine());
+    });
 
     // Data memory.
     ICHECK_EQ(node.GetAttr<std::vector<std::string>>("data_layout")[0], "NCHW");
-    auto conv2d_src_memory = BindDNNLMemory(data_entry, {src_dims, dt::f32, tag::nchw});
+    layer.args.emplace_back(DNNL_ARG_SRC, BindBuffer(data_entry, {src_dims, dt::f32, tag::nchw}));
 
     // Weight memory.
     ICHECK_EQ(node.GetAttr<std::vector<std::string>>("kernel_layout")[0], "OIHW");
-    auto conv2d_weights_memory = BindDNNLMemory(
-        weight_entry, {weights_dims, dt::f32, (groups > 1) ? tag::goihw : tag::oihw});
+    layer.args.emplace_back(
+        DNNL_ARG_WEIGHTS,
+        BindBuffer(weight_entry, {weights_dims, dt::f32, (groups > 1) ? tag::goihw : tag::oihw}));
 
     // Bias memory.
-    auto conv2d_bias_memory = dnnl::memory({bias_dims, dt::f32, tag::x}, engine_);
-    if (has_bias) {
-      auto bias_entry = node.GetInputs()[2];
-      BindDNNLMemory(bias_entry, conv2d_bias_memory);
-    } else {
-      float bias[OC] = {0};
-      write_to_dnnl_memory(bias, conv2d_bias_memory, OC * sizeof(float));
+    size_t next_input = 2;
+    if (fused.has_bias) {
+      auto bias_entry = node.GetInputs()[next_input++];
+      layer.args.emplace_back(DNNL_ARG_BIAS, BindBuffer(bias_entry, {bias_dims, dt::f32, tag::x}));
     }
 
-    // Output memory.
+    // Output memory, which holds the residual added by the sum post-op before execution.
     JSONGraphNodeEntry out_entry(nid, 0);
-    auto conv2d_dst_memory = BindDNNLMemory(out_entry, conv2d_prim_desc.dst_desc());
-
-    // Bind memory buffers.
-    net_args_.push_back({{DNNL_ARG_SRC, conv2d_src_memory},
-                         {DNNL_ARG_WEIGHTS, conv2d_weights_memory},
-                         {DNNL_ARG_BIAS, conv2d_bias_memory},
-                         {DNNL_ARG_DST, conv2d_dst_memory}});
+    size_t dst_buffer = BindBuffer(out_entry, conv_dst_md);
+    if (fused.has_sum) {
+      auto residual_entry = node.GetInputs()[next_input++];
+      layer.sum_src = static_cast<int>(BindBuffer(residual_entry, conv_dst_md));
+      layer.sum_dst = static_cast<int>(dst_buffer);
+    }
+    layer.args.emplace_back(DNNL_ARG_DST, dst_buffer);
+    net_.push_back(layer);
   }
 
-  void Dense(const size_t& nid) {
+  void Dense(const size_t& nid, const FusedOps& fused) {
     auto node = nodes_[nid];
+    ICHECK(!fused.has_sum) << "The sum post-op is not supported for dense";
 
     // Setup attributes.
     auto data_entry = node.GetInputs()[0];
@@ -270,27 +540,31 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     auto bias_md = dnnl::memory::desc({bias_dims, dt::f32, tag::x});
     auto dst_md = dnnl::memory::desc({out_dims, dt::f32, tag::nc});
 
-    // Dense description.
-    auto dense_desc = dnnl::inner_product_forward::desc(dnnl::prop_kind::forward_inference, data_md,
-                                                        weight_md, bias_md, dst_md);
-    auto dense_prim_desc = dnnl::inner_product_forward::primitive_desc(dense_desc, engine_);
-
-    auto dense = dnnl::inner_product_forward(dense_prim_desc);
-    net_.push_back(dense);
+    std::ostringstream key;
+    key << "dense|" << DimsToString(data_dims) << "|" << DimsToString(weight_dims)
+        << (fused.has_bias ? "|bias" : "");
+    dnnl::primitive_attr attr = MakeAttr(fused, &key);
+
+    Layer layer;
+    layer.prim = GetPrimitive<dnnl::inner_product_forward>(key, [&]() {
+      // Dense description.
+      auto dense_desc = fused.has_bias
+                            ? dnnl::inner_product_forward::desc(dnnl::prop_kind::forward_inference,
+                                                                data_md, weight_md, bias_md, dst_md)
+                            : dnnl::inner_product_forward::desc(dnnl::prop_kind::forward_inference,
+                                                                data_md, weight_md, dst_md);
+      return dnnl::inner_product_forward::primitive_desc(dense_desc, attr, GetDNNLEngine());
+    });
 
     // Memories.
-    auto data_memory = BindDNNLMemory(data_entry, data_md);
-    auto weight_memory = BindDNNLMemory(weight_entry, weight_md);
-    auto bias_memory = dnnl::memory(bias_md, engine_);
-    float bias[OC] = {0};
-    write_to_dnnl_memory(bias, bias_memory, OC * sizeof(float));
+    layer.args.emplace_back(DNNL_ARG_SRC, BindBuffer(data_entry, data_md));
+    layer.args.emplace_back(DNNL_ARG_WEIGHTS, BindBuffer(weight_entry, weight_md));
+    if (fused.has_bias) {
+      layer.args.emplace_back(DNNL_ARG_BIAS, BindBuffer(node.GetInputs()[2], bias_md));
+    }
     JSONGraphNodeEntry out_entry(nid, 0);
-    auto dst_memory = BindDNNLMemory(out_entry, dense_prim_desc.dst_desc());
-
-    net_args_.push_back({{DNNL_ARG_SRC, data_memory},
-                         {DNNL_ARG_WEIGHTS, weight_memory},
-                         {DNNL_ARG_BIAS, bias_memory},
-                         {DNNL_ARG_DST, dst_memory}});
+    layer.args.emplace_back(DNNL_ARG_DST, BindBuffer(out_entry, dst_md));
+    net_.push_back(layer);
   }
 
   void BatchNorm(const size_t& nid) {
@@ -308,31 +582,34 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     // Memory description.
     dnnl::memory::desc data_md = GenDNNLMemDescByShape(data_shape, dt::f32);
 
+    std::ostringstream key;
+    key << "batch_norm|" << DimsToString(data_shape) << "|" << epsilon;
+    dnnl::primitive_attr attr = MakeAttr(FusedOps(), &key);
+
     // BN description.
     auto bn_desc = dnnl::batch_normalization_forward::desc(
         dnnl::prop_kind::forward_inference, data_md, epsilon,
         dnnl::normalization_flags::use_global_stats | dnnl::normalization_flags::use_scale_shift);
-    auto bn_prim_desc = dnnl::batch_normalization_forward::primitive_desc(bn_desc, engine_);
-    auto bn = dnnl::batch_normalization_forward(bn_prim_desc);
-    net_.push_back(bn);
+    auto bn_prim_desc =
+        dnnl::batch_normalization_forward::primitive_desc(bn_desc, attr, GetDNNLEngine());
+    Layer layer;
+    using BatchNormT = dnnl::batch_normalization_forward;
+    layer.prim = GetPrimitive<BatchNormT>(key, [&]() { return bn_prim_desc; });
 
     // Memories.
-    auto data_memory = BindDNNLMemory(data_entry, data_md);
+    layer.args.emplace_back(DNNL_ARG_SRC, BindBuffer(data_entry, data_md));
     JSONGraphNodeEntry out_entry(nid, 0);
-    auto out_memory = BindDNNLMemory(out_entry, data_md);
-    auto mean_memory = BindDNNLMemory(mean_entry, bn_prim_desc.mean_desc());
-    auto variance_memory = BindDNNLMemory(variance_entry, bn_prim_desc.variance_desc());
+    layer.args.emplace_back(DNNL_ARG_DST, BindBuffer(out_entry, data_md));
+    layer.args.emplace_back(DNNL_ARG_MEAN, BindBuffer(mean_entry, bn_prim_desc.mean_desc()));
+    layer.args.emplace_back(DNNL_ARG_VARIANCE,
+                            BindBuffer(variance_entry, bn_prim_desc.variance_desc()));
 
-    // In DNNL, weight is composed of gamma+beta, so we point them to the same DNNL memory but
+    // In DNNL, weight is composed of gamma+beta, so we point them to the same buffer but
     // assign an offset to beta data for runtime serialization.
-    auto weight_memory = BindDNNLMemory(gamma_entry, bn_prim_desc.weights_desc(), 0);
-    BindDNNLMemory(beta_entry, weight_memory, IC);
-
-    net_args_.push_back({{DNNL_ARG_SRC, data_memory},
-                         {DNNL_ARG_DST, out_memory},
-                         {DNNL_ARG_SCALE_SHIFT, weight_memory},
-                         {DNNL_ARG_MEAN, mean_memory},
-                         {DNNL_ARG_VARIANCE, variance_memory}});
+    size_t weight_buffer = BindBuffer(gamma_entry, bn_prim_desc.weights_desc());
+    BindBuffer(beta_entry, weight_buffer, IC);
+    layer.args.emplace_back(DNNL_ARG_SCALE_SHIFT, weight_buffer);
+    net_.push_back(layer);
   }
 
   void Relu(const size_t& nid) {
@@ -342,19 +619,23 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     dnnl::memory::dims shape = nodes_[data_entry.id_].GetOpShape()[data_entry.index_];
     dnnl::memory::desc data_md = GenDNNLMemDescByShape(shape, dt::f32);
 
-    auto relu_desc = dnnl::eltwise_forward::desc(dnnl::prop_kind::forward_inference,
-                                                 dnnl::algorithm::eltwise_relu, data_md, 0);
-    auto relu_prim_desc = dnnl::eltwise_forward::primitive_desc(relu_desc, engine_);
-    ICHECK(data_md == relu_prim_desc.dst_desc());
+    std::ostringstream key;
+    key << "relu|" << DimsToString(shape);
+    dnnl::primitive_attr attr = MakeAttr(FusedOps(), &key);
 
-    auto relu = dnnl::eltwise_forward(relu_prim_desc);
-    net_.push_back(relu);
+    Layer layer;
+    layer.prim = GetPrimitive<dnnl::eltwise_forward>(key, [&]() {
+      auto relu_desc = dnnl::eltwise_forward::desc(dnnl::prop_kind::forward_inference,
+                                                   dnnl::algorithm::eltwise_relu, data_md, 0);
+      auto relu_prim_desc = dnnl::eltwise_forward::primitive_desc(relu_desc, attr, GetDNNLEngine());
+      ICHECK(data_md == relu_prim_desc.dst_desc());
+      return relu_prim_desc;
+    });
 
-    auto data_memory = BindDNNLMemory(data_entry, data_md);
+    layer.args.emplace_back(DNNL_ARG_SRC, BindBuffer(data_entry, data_md));
     JSONGraphNodeEntry out_entry(nid, 0);
-    auto out_memory = BindDNNLMemory(out_entry, data_md);
-
-    net_args_.push_back({{DNNL_ARG_SRC, data_memory}, {DNNL_ARG_DST, out_memory}});
+    layer.args.emplace_back(DNNL_ARG_DST, BindBuffer(out_entry, data_md));
+    net_.push_back(layer);
   }
 
   void Binary(const size_t& nid, dnnl::algorithm algo) {
@@ -363,7 +644,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     // Memory and compute description.
     std::vector<dnnl::memory::dims> data_dims;
     std::vector<dnnl::memory::desc> data_mds;
-    std::vector<dnnl::memory> data_memories;
+    std::vector<size_t> data_buffers;
 
     ICHECK_EQ(node.GetInputs().size(), 2U);
     for (auto entry : node.GetInputs()) {
@@ -372,21 +653,25 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
       data_dims.push_back(data_shape);
       data_mds.push_back(data_md);
-      data_memories.push_back(BindDNNLMemory(entry, data_md));
+      data_buffers.push_back(BindBuffer(entry, data_md));
     }
     ICHECK(data_dims[0] == data_dims[1]);
     auto out_md = data_mds[0];
     JSONGraphNodeEntry out_entry(nid, 0);
-    auto out_memory = BindDNNLMemory(out_entry, out_md);
-
-    auto binary_desc = dnnl::binary::desc(algo, data_mds[0], data_mds[1], out_md);
-    auto binary_prim_desc = dnnl::binary::primitive_desc(binary_desc, engine_);
-    auto binary = dnnl::binary(binary_prim_desc);
-    net_.push_back(binary);
 
-    net_args_.push_back({{DNNL_ARG_SRC_0, data_memories[0]},
-                         {DNNL_ARG_SRC_1, data_memories[1]},
-                         {DNNL_ARG_DST, out_memory}});
+    std::ostringstream key;
+    key << "binary" << static_cast<int>(algo) << "|" << DimsToString(data_dims[0]);
+    dnnl::primitive_attr attr = MakeAttr(FusedOps(), &key);
+
+    Layer layer;
+    layer.prim = GetPrimitive<dnnl::binary>(key, [&]() {
+      auto binary_desc = dnnl::binary::desc(algo, data_mds[0], data_mds[1], out_md);
+      return dnnl::binary::primitive_desc(binary_desc, attr, GetDNNLEngine());
+    });
+    layer.args = {{DNNL_ARG_SRC_0, data_buffers[0]},
+                  {DNNL_ARG_SRC_1, data_buffers[1]},
+                  {DNNL_ARG_DST, BindBuffer(out_entry, out_md)}};
+    net_.push_back(layer);
   }
 
   // Read from DNNL memory (+offset) and write to the handle.
@@ -427,16 +712,18 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     return data_md;
   }
 
-  /* The dnnl engine. */
-  dnnl::engine engine_;
-  /* The dnnl stream. */
-  dnnl::stream stream_;
   /* The network layers that are represented in dnnl primitives. */
-  std::vector<dnnl::primitive> net_;
-  /* The memory that is consumed by arguments. */
-  std::vector<std::unordered_map<int, dnnl::memory>> net_args_;
-  /* The entry ID to its corresponding output memory. */
-  std::unordered_map<uint32_t, std::pair<dnnl::memory, size_t>> entry_out_mem_;
+  std::vector<Layer> net_;
+  /* The buffers of the network. */
+  std::vector<BufferInfo> buffers_;
+  /* The entry ID to its buffer and its offset in elements. */
+  std::unordered_map<uint32_t, std::pair<size_t, size_t>> entry_buffer_;
+  /* The memories of the constant buffers, shared by the threads. */
+  std::vector<dnnl::memory> const_buffers_;
+  /* The memories of the runs that are over, reused by the next runs. */
+  std::vector<std::unique_ptr<RunState>> free_run_states_;
+  /* Protects free_run_states_. */
+  std::mutex mutex_;
 };
 
 runtime::Module DNNLJSONRuntimeCreate(String symbol_name, String graph_json,
@@ -25,10 +25,16 @@
 #ifndef TVM_RUNTIME_CONTRIB_JSON_JSON_RUNTIME_H_
 #define TVM_RUNTIME_CONTRIB_JSON_JSON_RUNTIME_H_
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/ndarray.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -204,6 +210,133 @@ class JSONRuntimeBase : public ModuleNode {
 
     // Reserve data entries.
     data_entry_.resize(NumEntries());
+    ComputeNodeLevels();
+  }
+
+  /*!
+   * \brief Group the kernel nodes by levels: the inputs of a node are produced by the nodes of
+   * the previous levels, so the nodes of one level are independent.
+   */
+  void ComputeNodeLevels() {
+    std::vector<size_t> node_level(nodes_.size(), 0);
+    node_levels_.clear();
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      if (nodes_[nid].GetOpType() != "kernel") continue;
+      size_t level = 1;
+      for (const auto& entry : nodes_[nid].GetInputs()) {
+        ICHECK_LT(entry.id_, nid) << "The json graph nodes must be in topological order";
+        level = std::max(level, node_level[entry.id_] + 1);
+      }
+      node_level[nid] = level;
+      if (node_levels_.size() < level) node_levels_.resize(level);
+      node_levels_[level - 1].push_back(nid);
+    }
+  }
+
+  /*!
+   * \brief Allocate the entries produced and consumed inside the subgraph, the outputs of the
+   * kernel nodes that are not outputs of the graph, and bind them to the data entries. An
+   * entry reuses the storage of the entries whose last consumer ran in a previous level, so
+   * the storage is also safe for RunKernelNodes running the nodes of a level concurrently.
+   *
+   * The runtimes whose kernels read and write the data entries call it in Init. Like the data
+   * entries, the intermediates belong to the module, so its runs must not overlap.
+   *
+   * \param dev The device of the intermediates.
+   */
+  void AllocateIntermediates(Device dev) {
+    std::vector<bool> is_output(NumEntries(), false);
+    for (const auto& output : outputs_) {
+      is_output[EntryID(output)] = true;
+    }
+    // The last level reading each entry. An entry is free from the next level on.
+    std::vector<size_t> last_level(NumEntries(), 0);
+    for (size_t level = 0; level < node_levels_.size(); ++level) {
+      for (uint32_t nid : node_levels_[level]) {
+        for (const auto& entry : nodes_[nid].GetInputs()) {
+          last_level[EntryID(entry)] = level;
+        }
+        for (uint32_t i = 0; i < nodes_[nid].GetNumOutput(); ++i) {
+          last_level[EntryID(nid, i)] = std::max(last_level[EntryID(nid, i)], level);
+        }
+      }
+    }
+
+    std::vector<size_t> storage_bytes;
+    std::vector<size_t> free_storage;
+    std::vector<std::pair<uint32_t, size_t>> entry_storage;
+    for (size_t level = 0; level < node_levels_.size(); ++level) {
+      for (uint32_t nid : node_levels_[level]) {
+        for (uint32_t i = 0; i < nodes_[nid].GetNumOutput(); ++i) {
+          uint32_t eid = EntryID(nid, i);
+          if (is_output[eid]) continue;
+          size_t nbytes = EntryBytes(nid, i);
+          // Take the smallest free storage large enough, or grow the largest one.
+          auto fit = free_storage.end();
+          auto largest = free_storage.end();
+          for (auto it = free_storage.begin(); it != free_storage.end(); ++it) {
+            size_t bytes = storage_bytes[*it];
+            if (bytes >= nbytes && (fit == free_storage.end() || bytes < storage_bytes[*fit])) {
+              fit = it;
+            }
+            if (largest == free_storage.end() || bytes > storage_bytes[*largest]) largest = it;
+          }
+          auto best = fit != free_storage.end() ? fit : largest;
+          size_t sid;
+          if (best != free_storage.end()) {
+            sid = *best;
+            free_storage.erase(best);
+            storage_bytes[sid] = std::max(storage_bytes[sid], nbytes);
+          } else {
+            sid = storage_bytes.size();
+            storage_bytes.push_back(nbytes);
+          }
+          entry_storage.emplace_back(eid, sid);
+        }
+      }
+      for (const auto& it : entry_storage) {
+        if (last_level[it.first] == level) free_storage.push_back(it.second);
+      }
+    }
+
+    intermediate_storage_.clear();
+    for (size_t nbytes : storage_bytes) {
+      intermediate_storage_.push_back(NDArray::Empty({static_cast<int64_t>(nbytes)},
+                                                     DLDataType{kDLUInt, 8, 1}, dev));
+    }
+    intermediates_.clear();
+    for (const auto& it : entry_storage) {
+      uint32_t nid = std::upper_bound(node_row_ptr_.begin(), node_row_ptr_.end(), it.first) -
+                     node_row_ptr_.begin() - 1;
+      uint32_t index = it.first - node_row_ptr_[nid];
+      NDArray view = intermediate_storage_[it.second].CreateView(
+          nodes_[nid].GetOpShape()[index], nodes_[nid].GetOpDataType()[index]);
+      intermediates_.push_back(view);
+      data_entry_[it.first] = view.operator->();
+    }
+  }
+
+  /*!
+   * \brief Execute the kernel nodes in their dependency order, the nodes of a level running
+   * concurrently on the runtime thread pool when parallel is set. An error of a node is
+   * raised once its level finished.
+   *
+   * \param fexec The function executing a kernel node, given its node index.
+   * \param parallel Whether to run the independent nodes concurrently.
+   */
+  void RunKernelNodes(const std::function<void(uint32_t)>& fexec, bool parallel = true) {
+    for (const auto& level : node_levels_) {
+      if (!parallel || level.size() == 1) {
+        for (uint32_t nid : level) {
+          fexec(nid);
+        }
+        continue;
+      }
+      LevelTask task{&level, &fexec};
+      int ret = TVMBackendParallelLaunch(RunLevelTask, &task, 0);
+      ICHECK_EQ(ret, 0) << "Failed to launch the json graph nodes";
+      if (task.error != nullptr) std::rethrow_exception(task.error);
+    }
   }
 
   /*!
@@ -246,6 +379,43 @@ class JSONRuntimeBase : public ModuleNode {
   // Number of node entries.
   uint32_t NumEntries() const { return node_row_ptr_.back(); }
 
+  // The size in bytes of an output of a node.
+  size_t EntryBytes(uint32_t nid, uint32_t index) const {
+    const DLDataType& dtype = nodes_[nid].GetOpDataType()[index];
+    size_t nbytes = (dtype.bits * dtype.lanes + 7) / 8;
+    for (int64_t dim : nodes_[nid].GetOpShape()[index]) {
+      nbytes *= static_cast<size_t>(dim);
+    }
+    return nbytes;
+  }
+
+ private:
+  /*! \brief The nodes of a level executed by the workers of the thread pool. */
+  struct LevelTask {
+    const std::vector<uint32_t>* nids;
+    const std::function<void(uint32_t)>* fexec;
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    LevelTask(const std::vector<uint32_t>* nids, const std::function<void(uint32_t)>* fexec)
+        : nids(nids), fexec(fexec) {}
+  };
+
+  // The workers take the next node of the level until all are done.
+  static int RunLevelTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+    LevelTask* task = static_cast<LevelTask*>(cdata);
+    for (size_t i = task->next++; i < task->nids->size(); i = task->next++) {
+      try {
+        (*task->fexec)((*task->nids)[i]);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        if (task->error == nullptr) task->error = std::current_exception();
+      }
+    }
+    return 0;
+  }
+
  protected:
   /*! \brief The only subgraph name for this module. */
   std::string symbol_name_;
@@ -269,6 +439,12 @@ class JSONRuntimeBase : public ModuleNode {
   std::vector<uint32_t> const_idx_;
   /*! \brief Indicate if the engine has been initialized. */
   bool initialized_{false};
+  /*! \brief The kernel nodes by levels, each level only depending on the previous ones. */
+  std::vector<std::vector<uint32_t>> node_levels_;
+  /*! \brief The storage shared by the intermediate entries. */
+  std::vector<NDArray> intermediate_storage_;
+  /*! \brief The intermediate entries, views of the storage. */
+  std::vector<NDArray> intermediates_;
 };
 
 }  // namespace json
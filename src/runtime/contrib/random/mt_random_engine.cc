@@ -21,15 +21,18 @@
  * \file random/mt_random_engine.cc
  * \brief mt19937 random engine
  */
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/ndarray.h>
 
 #include <algorithm>
+#include <cmath>
 #include <ctime>
 #include <random>
 
 #include "../3rdparty/compiler-rt/builtin_fp16.h"
+#include "philox.h"
 
 namespace tvm {
 namespace contrib {
@@ -55,6 +58,7 @@ class RandomEngine {
   inline void Seed(unsigned seed) {
     rnd_engine_.seed(seed);
     this->rseed_ = static_cast<unsigned>(seed);
+    this->philox_offset_ = 0;
   }
 
   /*!
@@ -83,9 +87,12 @@ class RandomEngine {
     ICHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
 
     if (data->device.device_type == kDLCPU) {
-      std::uniform_real_distribution<float> uniform_dist(low, high);
-      std::generate_n(static_cast<float*>(data->data), size,
-                      [&]() { return uniform_dist(rnd_engine_); });
+      FillByBlocks(static_cast<float*>(data->data), size,
+                   [low, high](const Philox4x32::Block& block, float* values) {
+                     for (int i = 0; i < 4; ++i) {
+                       values[i] = low + ToUnitFloat(block[i]) * (high - low);
+                     }
+                   });
     } else {
       LOG(FATAL) << "Do not support random.uniform on this device yet";
     }
@@ -107,9 +114,18 @@ class RandomEngine {
     ICHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
 
     if (data->device.device_type == kDLCPU) {
-      std::normal_distribution<float> normal_dist(loc, scale);
-      std::generate_n(static_cast<float*>(data->data), size,
-                      [&]() { return normal_dist(rnd_engine_); });
+      // Box-Muller transform, each pair of integers gives a pair of samples
+      FillByBlocks(static_cast<float*>(data->data), size,
+                   [loc, scale](const Philox4x32::Block& block, float* values) {
+                     for (int i = 0; i < 4; i += 2) {
+                       // in (0, 1], the logarithm stays finite
+                       float u = 1.0f - ToUnitFloat(block[i]);
+                       float radius = std::sqrt(-2.0f * std::log(u));
+                       float theta = 6.28318530717958647692f * ToUnitFloat(block[i + 1]);
+                       values[i] = loc + scale * radius * std::cos(theta);
+                       values[i + 1] = loc + scale * radius * std::sin(theta);
+                     }
+                   });
     } else {
       LOG(FATAL) << "Do not support random.normal on this device yet";
     }
@@ -133,6 +149,60 @@ class RandomEngine {
   }
 
  private:
+  /*! \brief The tensors with fewer blocks of four elements are filled by the calling thread. */
+  static constexpr int64_t kMinParallelBlocks = 1 << 14;
+
+  /*! \return The 24 high bits of a random integer as a float in [0, 1). */
+  static float ToUnitFloat(uint32_t value) {
+    return static_cast<float>(value >> 8) * (1.0f / (1 << 24));
+  }
+
+  /*!
+   * \brief Fill a tensor by blocks of four elements, each sampled from the Philox block of the
+   *  same index, on the threads of the runtime pool for the large tensors.
+   *
+   *  The tensor only depends on the seed and on the number of blocks drawn since the engine was
+   *  seeded, not on the number of threads.
+   * \param out The elements of the tensor.
+   * \param size The number of elements.
+   * \param fsample Called as fsample(block, values) to sample four values from a block.
+   */
+  template <typename FSample>
+  void FillByBlocks(float* out, int64_t size, const FSample& fsample) {
+    struct Closure {
+      const FSample* fsample;
+      Philox4x32 philox;
+      uint64_t offset;
+      float* out;
+      int64_t size;
+      int64_t num_blocks;
+
+      void Fill(int64_t begin, int64_t end) const {
+        float values[4];
+        for (int64_t b = begin; b < end; ++b) {
+          (*fsample)(philox(offset + b), values);
+          int64_t count = std::min<int64_t>(4, size - b * 4);
+          std::copy(values, values + count, out + b * 4);
+        }
+      }
+    };
+    int64_t num_blocks = (size + 3) / 4;
+    Closure closure{&fsample, Philox4x32(rseed_), philox_offset_, out, size, num_blocks};
+    philox_offset_ += num_blocks;
+    if (num_blocks < kMinParallelBlocks) {
+      closure.Fill(0, num_blocks);
+      return;
+    }
+    auto task = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+      const Closure* closure = static_cast<const Closure*>(cdata);
+      closure->Fill(closure->num_blocks * task_id / penv->num_task,
+                    closure->num_blocks * (task_id + 1) / penv->num_task);
+      return 0;
+    };
+    ICHECK_EQ(TVMBackendParallelLaunch(task, &closure, 0), 0)
+        << "FillByBlocks: " << TVMGetLastError();
+  }
+
   void FillData(DLTensor* tensor, int64_t size) {
     // Make the value be 1.0 - 10.0, not (0.0 - 1.0) so that we could satisfy
     // quantized dtype (uint8 / int8) data non-empty requirement
@@ -168,6 +238,8 @@ class RandomEngine {
  private:
   std::mt19937 rnd_engine_;
   unsigned rseed_;
+  /*! \brief The number of Philox blocks drawn since the engine was seeded. */
+  uint64_t philox_offset_{0};
 };
 
 }  // namespace contrib
@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file random/philox.h
+ * \brief Philox4x32-10 counter based random number generator.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+#define TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+
+#include <array>
+#include <cstdint>
+
+namespace tvm {
+namespace contrib {
+
+/*!
+ * \brief The Philox4x32-10 generator of Salmon et al., "Parallel random numbers: as easy as
+ *  1, 2, 3".
+ *
+ *  Each block of four random integers is a function of the key and of the counter of the
+ *  block only, so the blocks of a tensor may be generated in any order by any thread and
+ *  still give the same tensor for a given key.
+ */
+class Philox4x32 {
+ public:
+  using Block = std::array<uint32_t, 4>;
+
+  explicit Philox4x32(uint64_t key)
+      : key_{static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)} {}
+
+  /*!
+   * \brief Generate the block of a counter.
+   * \param counter The counter of the block.
+   * \param stream Distinguishes the sequences generated with the same key.
+   */
+  Block operator()(uint64_t counter, uint64_t stream = 0) const {
+    Block ctr = {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+                 static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)};
+    uint32_t k0 = key_[0];
+    uint32_t k1 = key_[1];
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        k0 += kWeyl0;
+        k1 += kWeyl1;
+      }
+      uint64_t prod0 = static_cast<uint64_t>(kMul0) * ctr[0];
+      uint64_t prod1 = static_cast<uint64_t>(kMul1) * ctr[2];
+      ctr = {static_cast<uint32_t>(prod1 >> 32) ^ ctr[1] ^ k0, static_cast<uint32_t>(prod1),
+             static_cast<uint32_t>(prod0 >> 32) ^ ctr[3] ^ k1, static_cast<uint32_t>(prod0)};
+    }
+    return ctr;
+  }
+
+ private:
+  static constexpr uint32_t kMul0 = 0xD2511F53;
+  static constexpr uint32_t kMul1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+  uint32_t key_[2];
+};
+
+}  // namespace contrib
+}  // namespace tvm
+#endif  // TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
@@ -0,0 +1,241 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file rocprofiler.cc
+ * \brief Performance counters of the ROCm kernels read through rocprofiler.
+ */
+#include <hsa/hsa.h>
+#include <rocprofiler/rocprofiler.h>
+#include <tvm/runtime/contrib/rocprofiler.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+#define ROCPROFILER_CALL(func)                                                     \
+  {                                                                                \
+    hsa_status_t e = (func);                                                       \
+    if (e != HSA_STATUS_SUCCESS) {                                                 \
+      const char* msg = "";                                                        \
+      rocprofiler_error_string(&msg);                                              \
+      LOG(FATAL) << "ROCProfilerError: in function " #func " " << e << " " << msg; \
+    }                                                                              \
+  }
+
+/*!
+ * \brief The metrics collected by default: the bytes read from and written to the device memory
+ * (in KB), the L2 hit rate and the share of the time the memory and vector ALU units are busy.
+ */
+static const std::vector<std::string> default_rocprofiler_metric_names = {
+    "FETCH_SIZE", "WRITE_SIZE", "L2CacheHit", "MemUnitBusy", "VALUBusy"};
+
+/*! \brief Object marking a profiled function call. */
+struct ROCProfilerCallNode : public Object {
+  /*! \brief The device of the call. */
+  Device dev;
+  /*! \brief Whether the counters were stopped early by a nested call, which has the metrics. */
+  bool discarded{false};
+
+  explicit ROCProfilerCallNode(Device dev) : dev(dev) {}
+
+  static constexpr const char* _type_key = "ROCProfilerCallNode";
+  TVM_DECLARE_FINAL_OBJECT_INFO(ROCProfilerCallNode, Object);
+};
+
+/*! \brief MetricCollectorNode for the hardware counters of AMD GPUs.
+ *
+ * The counters of a device are started before a call and read after it, in the standalone mode
+ * of rocprofiler which counts all the kernels of the device. A call, such as the total of a
+ * device, that is interrupted by a nested call gets no metrics and the nested call gets them.
+ *
+ * The metric names are the ones of rocprof, listed by `rocprof --list-derived`.
+ */
+struct ROCProfilerMetricCollectorNode final : public MetricCollectorNode {
+  explicit ROCProfilerMetricCollectorNode(Array<String> metrics) {
+    for (const String& metric : metrics) {
+      metric_names.push_back(metric);
+    }
+    if (metric_names.empty()) {
+      metric_names = default_rocprofiler_metric_names;
+    }
+  }
+
+  void Init(Array<DeviceWrapper> devices) final {
+    ROCPROFILER_CALL(hsa_init());
+    std::vector<hsa_agent_t> agents;
+    ROCPROFILER_CALL(hsa_iterate_agents(
+        [](hsa_agent_t agent, void* data) {
+          hsa_device_type_t type;
+          hsa_status_t status = hsa_agent_get_info(agent, HSA_AGENT_INFO_DEVICE, &type);
+          if (status == HSA_STATUS_SUCCESS && type == HSA_DEVICE_TYPE_GPU) {
+            static_cast<std::vector<hsa_agent_t>*>(data)->push_back(agent);
+          }
+          return status;
+        },
+        &agents));
+    for (auto wrapped_device : devices) {
+      Device dev = wrapped_device->device;
+      if (dev.device_type != kDLROCM || contexts.count(dev.device_id)) continue;
+      ICHECK_LT(dev.device_id, static_cast<int>(agents.size()))
+          << "ROCProfilerMetricCollector: no HSA agent for " << dev;
+      std::vector<rocprofiler_feature_t>& features = features_[dev.device_id];
+      features.resize(metric_names.size());
+      for (size_t i = 0; i < metric_names.size(); ++i) {
+        features[i] = rocprofiler_feature_t();
+        features[i].kind = ROCPROFILER_FEATURE_KIND_METRIC;
+        features[i].name = metric_names[i].c_str();
+      }
+      rocprofiler_properties_t properties = {};
+      properties.queue_depth = 128;
+      // the standalone mode counts the kernels of all the queues of the device
+      uint32_t mode =
+          ROCPROFILER_MODE_STANDALONE | ROCPROFILER_MODE_CREATEQUEUE | ROCPROFILER_MODE_SINGLEGROUP;
+      rocprofiler_t* context = nullptr;
+      ROCPROFILER_CALL(rocprofiler_open(agents[dev.device_id], features.data(), features.size(),
+                                        &context, mode, &properties));
+      contexts[dev.device_id] = context;
+    }
+  }
+
+  ObjectRef Start(Device dev) final {
+    auto it = contexts.find(dev.device_id);
+    if (dev.device_type != kDLROCM || it == contexts.end()) {
+      return ObjectRef(nullptr);
+    }
+    if (active_ != nullptr) {
+      // the counters of a device can only be started once, the outer call gives them up
+      StopCounters(active_);
+      active_->discarded = true;
+    }
+    // the counters only cover the kernels of the call
+    DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+    ROCPROFILER_CALL(rocprofiler_start(it->second, 0));
+    auto call = make_object<ROCProfilerCallNode>(dev);
+    active_ = call.get();
+    return ObjectRef(call);
+  }
+
+  Map<String, ObjectRef> Stop(ObjectRef obj) final {
+    ROCProfilerCallNode* call = const_cast<ROCProfilerCallNode*>(obj.as<ROCProfilerCallNode>());
+    if (call->discarded) return {};
+    StopCounters(call);
+    rocprofiler_t* context = contexts.at(call->dev.device_id);
+    ROCPROFILER_CALL(rocprofiler_read(context, 0));
+    ROCPROFILER_CALL(rocprofiler_get_data(context, 0));
+    ROCPROFILER_CALL(rocprofiler_get_metrics(context));
+    Map<String, ObjectRef> metrics;
+    const std::vector<rocprofiler_feature_t>& features = features_.at(call->dev.device_id);
+    for (size_t i = 0; i < features.size(); ++i) {
+      const rocprofiler_data_t& data = features[i].data;
+      double value = 0;
+      switch (data.kind) {
+        case ROCPROFILER_DATA_KIND_INT32:
+          value = data.result_int32;
+          break;
+        case ROCPROFILER_DATA_KIND_INT64:
+          value = data.result_int64;
+          break;
+        case ROCPROFILER_DATA_KIND_FLOAT:
+          value = data.result_float;
+          break;
+        case ROCPROFILER_DATA_KIND_DOUBLE:
+          value = data.result_double;
+          break;
+        default:
+          LOG(WARNING) << "ROCProfilerMetricCollector: metric " << metric_names[i]
+                       << " has no value, setting it to -1.";
+          value = -1;
+      }
+      if (IsRatio(metric_names[i])) {
+        metrics.Set(metric_names[i], ObjectRef(make_object<PercentNode>(value)));
+      } else {
+        metrics.Set(metric_names[i],
+                    ObjectRef(make_object<CountNode>(static_cast<int64_t>(value))));
+      }
+    }
+    return metrics;
+  }
+
+  ~ROCProfilerMetricCollectorNode() final {
+    for (auto& p : contexts) {
+      rocprofiler_close(p.second);
+    }
+  }
+
+  /*! \brief The metrics collected, in the order of the features. */
+  std::vector<std::string> metric_names;
+  /*! \brief The profiling context of each ROCm device id. */
+  std::unordered_map<int, rocprofiler_t*> contexts;
+
+  static constexpr const char* _type_key = "runtime.profiling.ROCProfilerMetricCollector";
+  TVM_DECLARE_FINAL_OBJECT_INFO(ROCProfilerMetricCollectorNode, MetricCollectorNode);
+
+ private:
+  /*! \return Whether a metric is a percentage, like the hit rates and the busy times. */
+  static bool IsRatio(const std::string& name) {
+    for (const char* suffix : {"Hit", "Busy", "Utilization", "Occupancy"}) {
+      std::string s(suffix);
+      if (name.size() >= s.size() && name.compare(name.size() - s.size(), s.size(), s) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void StopCounters(ROCProfilerCallNode* call) {
+    DeviceAPI::Get(call->dev)->StreamSync(call->dev, nullptr);
+    ROCPROFILER_CALL(rocprofiler_stop(contexts.at(call->dev.device_id), 0));
+    active_ = nullptr;
+  }
+
+  /*! \brief The features of each context, which receive the metric values. */
+  std::unordered_map<int, std::vector<rocprofiler_feature_t>> features_;
+  /*! \brief The call whose counters are running, nullptr when there is none. */
+  ROCProfilerCallNode* active_{nullptr};
+};
+
+/*! \brief Wrapper for `ROCProfilerMetricCollectorNode`. */
+class ROCProfilerMetricCollector : public MetricCollector {
+ public:
+  explicit ROCProfilerMetricCollector(Array<String> metrics) {
+    data_ = make_object<ROCProfilerMetricCollectorNode>(metrics);
+  }
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(ROCProfilerMetricCollector, MetricCollector,
+                                        ROCProfilerMetricCollectorNode);
+};
+
+MetricCollector CreateROCProfilerMetricCollector(Array<String> metrics) {
+  return ROCProfilerMetricCollector(metrics);
+}
+
+TVM_REGISTER_OBJECT_TYPE(ROCProfilerCallNode);
+TVM_REGISTER_OBJECT_TYPE(ROCProfilerMetricCollectorNode);
+
+TVM_REGISTER_GLOBAL("runtime.profiling.ROCProfilerMetricCollector")
+    .set_body_typed([](Array<String> metrics) { return ROCProfilerMetricCollector(metrics); });
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
@@ -22,7 +22,9 @@
  */
 
 #include <dlpack/dlpack.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
 #include <vector>
@@ -34,16 +36,6 @@ namespace contrib {
 
 using namespace runtime;
 
-template <typename DType>
-bool CompareAscend(const std::pair<int64_t, DType>& lhs, const std::pair<int64_t, DType>& rhs) {
-  return lhs.second < rhs.second;
-}
-
-template <typename DType>
-bool CompareDescend(const std::pair<int64_t, DType>& lhs, const std::pair<int64_t, DType>& rhs) {
-  return lhs.second > rhs.second;
-}
-
 struct float16 {
   uint16_t bits;
   float to_float() const {
@@ -51,15 +43,219 @@ struct float16 {
   }
 };
 
+/*!
+ * \brief The key an element is sorted by. The float16 elements are converted to float once
+ *  when a row is gathered, instead of at each comparison.
+ */
+template <typename DataType>
+struct SortKey {
+  using Type = DataType;
+  static Type Get(const DataType& value) { return value; }
+};
+
 template <>
-bool CompareAscend(const std::pair<int64_t, float16>& lhs, const std::pair<int64_t, float16>& rhs) {
-  return lhs.second.to_float() < rhs.second.to_float();
+struct SortKey<float16> {
+  using Type = float;
+  static Type Get(const float16& value) { return value.to_float(); }
+};
+
+/*! \brief The key of an element of a row and its position in the row. */
+template <typename KeyType>
+struct SortEntry {
+  KeyType key;
+  int64_t index;
+};
+
+template <typename KeyType, bool kAscend>
+struct CompareEntry {
+  bool operator()(const SortEntry<KeyType>& lhs, const SortEntry<KeyType>& rhs) const {
+    return kAscend ? lhs.key < rhs.key : lhs.key > rhs.key;
+  }
+};
+
+// Also orders the equal keys by position, so that the selection algorithms, which are not
+// stable, pick the same entries as a stable sort.
+template <typename KeyType, bool kAscend>
+struct CompareEntryByPosition {
+  bool operator()(const SortEntry<KeyType>& lhs, const SortEntry<KeyType>& rhs) const {
+    CompareEntry<KeyType, kAscend> compare;
+    if (compare(lhs, rhs)) return true;
+    if (compare(rhs, lhs)) return false;
+    return lhs.index < rhs.index;
+  }
+};
+
+/*! \brief The rows with fewer elements in total are sorted by the calling thread. */
+constexpr int64_t kMinParallelElements = 1 << 15;
+/*! \brief The rows with fewer elements are sorted by one thread each. */
+constexpr int64_t kMinParallelRowSize = 1 << 16;
+/*! \brief Only the first k entries are selected, rather than sorted, when k * ratio < size. */
+constexpr int64_t kPartialSortRatio = 8;
+
+/*!
+ * \brief Run f(begin, end) on the runtime thread pool, over chunks splitting [0, num_items).
+ * \param num_items The number of items.
+ * \param num_chunks The maximum number of chunks, the number of threads when 0.
+ * \param f The function run on each chunk.
+ */
+template <typename F>
+void ParallelFor(int64_t num_items, int num_chunks, const F& f) {
+  struct Closure {
+    const F* f;
+    int64_t num_items;
+  } closure{&f, num_items};
+  auto task = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    const Closure* closure = static_cast<const Closure*>(cdata);
+    int64_t begin = closure->num_items * task_id / penv->num_task;
+    int64_t end = closure->num_items * (task_id + 1) / penv->num_task;
+    if (begin < end) (*closure->f)(begin, end);
+    return 0;
+  };
+  ICHECK_EQ(TVMBackendParallelLaunch(task, &closure, num_chunks), 0)
+      << "ParallelFor: " << TVMGetLastError();
 }
 
-template <>
-bool CompareDescend(const std::pair<int64_t, float16>& lhs,
-                    const std::pair<int64_t, float16>& rhs) {
-  return lhs.second.to_float() > rhs.second.to_float();
+/*!
+ * \brief Stable sort a large row with several threads: the chunks of the row are sorted in
+ *  parallel, then merged pairwise, the merges of each level also in parallel.
+ */
+template <typename Compare, typename Iter>
+void ParallelStableSort(Iter begin, Iter end, Compare compare) {
+  int64_t size = end - begin;
+  int num_chunks = static_cast<int>(std::min<int64_t>(threading::MaxConcurrency(),
+                                                      size / (kMinParallelRowSize / 2)));
+  if (num_chunks <= 1) {
+    std::stable_sort(begin, end, compare);
+    return;
+  }
+  std::vector<int64_t> bounds(num_chunks + 1);
+  for (int c = 0; c <= num_chunks; ++c) {
+    bounds[c] = size * c / num_chunks;
+  }
+  ParallelFor(num_chunks, num_chunks, [&](int64_t first, int64_t last) {
+    for (int64_t c = first; c < last; ++c) {
+      std::stable_sort(begin + bounds[c], begin + bounds[c + 1], compare);
+    }
+  });
+  for (int64_t width = 1; width < num_chunks; width *= 2) {
+    int64_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+    ParallelFor(num_merges, static_cast<int>(num_merges), [&](int64_t first, int64_t last) {
+      for (int64_t m = first; m < last; ++m) {
+        int64_t lo = m * 2 * width;
+        int64_t mid = std::min<int64_t>(lo + width, num_chunks);
+        int64_t hi = std::min<int64_t>(lo + 2 * width, num_chunks);
+        if (mid < hi) {
+          // the merge is stable, the entries of the left chunk come first on equal keys
+          std::inplace_merge(begin + bounds[lo], begin + bounds[mid], begin + bounds[hi],
+                             compare);
+        }
+      }
+    });
+  }
+}
+
+/*!
+ * \brief Order the entries of a row by key, equal keys keeping their order.
+ * \param entries The entries of the row.
+ * \param count Only the first count entries are needed in order.
+ * \param parallel Whether the row may be sorted by several threads.
+ */
+template <typename KeyType, bool kAscend>
+void OrderEntries(std::vector<SortEntry<KeyType>>* entries, int64_t count, bool parallel) {
+  int64_t size = static_cast<int64_t>(entries->size());
+  if (count * kPartialSortRatio < size) {
+    // the top-k of a long row: O(size + count * log(count)) rather than a full sort
+    CompareEntryByPosition<KeyType, kAscend> compare;
+    std::nth_element(entries->begin(), entries->begin() + count, entries->end(), compare);
+    std::sort(entries->begin(), entries->begin() + count, compare);
+  } else if (parallel && size >= kMinParallelRowSize) {
+    ParallelStableSort(entries->begin(), entries->end(), CompareEntry<KeyType, kAscend>());
+  } else {
+    std::stable_sort(entries->begin(), entries->end(), CompareEntry<KeyType, kAscend>());
+  }
+}
+
+/*!
+ * \brief Sort each row of a tensor along an axis.
+ *
+ *  The rows are processed in parallel when there are enough of them, else one after the other
+ *  with the large rows sorted by several threads. The keys of a strided row are first gathered
+ *  with their positions in a contiguous buffer, which the sort then works on.
+ *
+ * \param input The tensor.
+ * \param axis The axis to sort along.
+ * \param k Only the first k elements of each row are needed in order.
+ * \param sort_num When not null, the number of elements of each row to sort, indexed by
+ *  i * axis_mul_after + j.
+ * \param is_ascend Whether to sort in ascending order.
+ * \param epilogue Called as epilogue(base_idx, i, j, entries, count) for each row, with the
+ *  first count entries sorted.
+ */
+template <typename DataType, typename Epilogue>
+void SortRows(DLTensor* input, int32_t axis, int64_t k, const int32_t* sort_num, bool is_ascend,
+              const Epilogue& epilogue) {
+  using KeyType = typename SortKey<DataType>::Type;
+  const DataType* data_ptr = static_cast<const DataType*>(input->data);
+  int64_t axis_mul_before = 1;
+  int64_t axis_mul_after = 1;
+  for (int i = 0; i < input->ndim; ++i) {
+    if (i < axis) {
+      axis_mul_before *= input->shape[i];
+    } else if (i > axis) {
+      axis_mul_after *= input->shape[i];
+    }
+  }
+  int64_t axis_size = input->shape[axis];
+  int64_t num_rows = axis_mul_before * axis_mul_after;
+  bool parallel_rows = num_rows * axis_size >= kMinParallelElements &&
+                       num_rows >= static_cast<int64_t>(threading::MaxConcurrency());
+
+  auto sort_rows = [&](int64_t first, int64_t last) {
+    std::vector<SortEntry<KeyType>> entries;
+    for (int64_t row = first; row < last; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
+      int64_t size = sort_num == nullptr ? axis_size : sort_num[row];
+      int64_t base_idx = i * axis_size * axis_mul_after + j;
+      entries.resize(size);
+      for (int64_t kk = 0; kk < size; ++kk) {
+        entries[kk] = {SortKey<DataType>::Get(data_ptr[base_idx + kk * axis_mul_after]), kk};
+      }
+      int64_t count = std::min(k, size);
+      if (is_ascend) {
+        OrderEntries<KeyType, true>(&entries, count, !parallel_rows);
+      } else {
+        OrderEntries<KeyType, false>(&entries, count, !parallel_rows);
+      }
+      epilogue(base_idx, i, j, entries, count);
+    }
+  };
+  if (parallel_rows) {
+    ParallelFor(num_rows, 0, sort_rows);
+  } else {
+    sort_rows(0, num_rows);
+  }
+}
+
+template <typename DataType>
+void argsort_nms(DLTensor* input, DLTensor* sort_num, DLTensor* output, int32_t axis,
+                 bool is_ascend) {
+  int32_t* out_ptr = static_cast<int32_t*>(output->data);
+  int64_t axis_size = input->shape[axis];
+  int64_t axis_stride = 1;
+  for (int i = axis + 1; i < input->ndim; ++i) {
+    axis_stride *= input->shape[i];
+  }
+  SortRows<DataType>(
+      input, axis, axis_size, static_cast<const int32_t*>(sort_num->data), is_ascend,
+      [&](int64_t base_idx, int64_t, int64_t,
+          const std::vector<SortEntry<typename SortKey<DataType>::Type>>& entries,
+          int64_t count) {
+        for (int64_t kk = 0; kk < axis_size; ++kk) {
+          out_ptr[base_idx + kk * axis_stride] =
+              static_cast<int32_t>(kk < count ? entries[kk].index : kk);
+        }
+      });
 }
 
 // Argsort implemented C library sort for nms.
@@ -77,12 +273,6 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
   bool is_ascend = args[4];
 
   auto dtype = input->dtype;
-  auto data_ptr = static_cast<float*>(input->data);
-  auto sort_num_ptr = static_cast<int32_t*>(sort_num->data);
-  std::vector<std::pair<int32_t, float>> sorter;
-  int64_t axis_mul_before = 1;
-  int64_t axis_mul_after = 1;
-
   if (axis < 0) {
     axis = input->ndim + axis;
   }
@@ -98,105 +288,50 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
                                   "input ndim "
                                << input->ndim;
 
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
-    }
-  }
-
-  for (int64_t i = 0; i < axis_mul_before; ++i) {
-    for (int64_t j = 0; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int32_t current_sort_num = *(sort_num_ptr + i * axis_mul_after + j);
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < current_sort_num; ++k) {
-        int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, *(data_ptr + full_idx)));
-      }
-      if (is_ascend) {
 #if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
-          std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<__fp16>);
-        } else {
-#endif
-          std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<float>);
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        }
-#endif
-      } else {
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
-          std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<__fp16>);
-        } else {
-#endif
-          std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<float>);
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        }
-#endif
-      }
-      for (int32_t k = 0; k < input->shape[axis]; ++k) {
-        *(static_cast<int32_t*>(output->data) + base_idx + k * axis_mul_after) =
-            k < static_cast<int32_t>(sorter.size()) ? sorter[k].first : k;
-      }
-    }
+  if (dtype.bits == 16) {
+    argsort_nms<__fp16>(input, sort_num, output, axis, is_ascend);
+    return;
   }
+#endif
+  argsort_nms<float>(input, sort_num, output, axis, is_ascend);
 });
 
-template <typename DataType, typename OutType>
-void sort_impl(
-    DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend,
-    std::function<void(OutType*, size_t, const std::pair<int64_t, DataType>&)> epilogue) {
-  auto data_ptr = static_cast<DataType*>(input->data);
-  auto out_ptr = static_cast<OutType*>(output->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
-
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
-    }
-  }
-
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
-      }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        epilogue(out_ptr, base_idx + k * axis_mul_after, sorter[k]);
-      }
-    }
-  }
-}
-
 template <typename DataType, typename OutType>
 void argsort(DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend) {
-  return sort_impl<DataType, OutType>(
-      input, output, axis, is_ascend,
-      [](OutType* out_ptr, size_t index, const std::pair<int64_t, DataType>& sort_pair) {
-        out_ptr[index] = static_cast<OutType>(sort_pair.first);
+  OutType* out_ptr = static_cast<OutType*>(output->data);
+  int64_t axis_stride = 1;
+  for (int i = axis + 1; i < input->ndim; ++i) {
+    axis_stride *= input->shape[i];
+  }
+  SortRows<DataType>(
+      input, axis, input->shape[axis], nullptr, is_ascend,
+      [&](int64_t base_idx, int64_t, int64_t,
+          const std::vector<SortEntry<typename SortKey<DataType>::Type>>& entries,
+          int64_t count) {
+        for (int64_t kk = 0; kk < count; ++kk) {
+          out_ptr[base_idx + kk * axis_stride] = static_cast<OutType>(entries[kk].index);
+        }
       });
 }
 
 template <typename DataType>
 void sort(DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend) {
-  return sort_impl<DataType, DataType>(
-      input, output, axis, is_ascend,
-      [](DataType* out_ptr, size_t index, const std::pair<int64_t, DataType>& sort_pair) {
-        out_ptr[index] = sort_pair.second;
+  const DataType* data_ptr = static_cast<const DataType*>(input->data);
+  DataType* out_ptr = static_cast<DataType*>(output->data);
+  int64_t axis_stride = 1;
+  for (int i = axis + 1; i < input->ndim; ++i) {
+    axis_stride *= input->shape[i];
+  }
+  SortRows<DataType>(
+      input, axis, input->shape[axis], nullptr, is_ascend,
+      [&](int64_t base_idx, int64_t, int64_t,
+          const std::vector<SortEntry<typename SortKey<DataType>::Type>>& entries,
+          int64_t count) {
+        for (int64_t kk = 0; kk < count; ++kk) {
+          out_ptr[base_idx + kk * axis_stride] =
+              data_ptr[base_idx + entries[kk].index * axis_stride];
+        }
       });
 }
 
@@ -341,52 +476,36 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.sort").set_body([](TVMArgs args, TVMRetVal
 template <typename DataType, typename IndicesType>
 void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, int axis,
           bool is_ascend) {
-  DataType* data_ptr = static_cast<DataType*>(input->data);
+  const DataType* data_ptr = static_cast<const DataType*>(input->data);
   DataType* values_ptr =
       (out_values == nullptr) ? nullptr : static_cast<DataType*>(out_values->data);
   IndicesType* indices_ptr =
       (out_indices == nullptr) ? nullptr : static_cast<IndicesType*>(out_indices->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
-
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
-    }
+  int64_t axis_stride = 1;
+  for (int i = axis + 1; i < input->ndim; ++i) {
+    axis_stride *= input->shape[i];
   }
   if (k < 1) {
     k = input->shape[axis];
   }
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
-      int64_t dst_base_idx = i * k * axis_mul_after + j;
-      for (int64_t kk = 0; kk < input->shape[axis]; ++kk) {
-        int64_t full_idx = src_base_idx + kk * axis_mul_after;
-        sorter.emplace_back(std::make_pair(kk, data_ptr[full_idx]));
-      }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
-      int64_t cnt = k > 0 ? k : input->shape[axis];
-      for (int64_t kk = 0; kk < cnt; ++kk) {
-        if (indices_ptr != nullptr) {
-          indices_ptr[dst_base_idx + kk * axis_mul_after] =
-              static_cast<IndicesType>(sorter[kk].first);
-        }
-        if (values_ptr != nullptr) {
-          values_ptr[dst_base_idx + kk * axis_mul_after] = static_cast<DataType>(sorter[kk].second);
+  SortRows<DataType>(
+      input, axis, k, nullptr, is_ascend,
+      [&](int64_t src_base_idx, int64_t i, int64_t j,
+          const std::vector<SortEntry<typename SortKey<DataType>::Type>>& entries,
+          int64_t count) {
+        int64_t dst_base_idx = i * k * axis_stride + j;
+        for (int64_t kk = 0; kk < count; ++kk) {
+          int64_t index = entries[kk].index;
+          if (indices_ptr != nullptr) {
+            indices_ptr[dst_base_idx + kk * axis_stride] = static_cast<IndicesType>(index);
+          }
+          if (values_ptr != nullptr) {
+            values_ptr[dst_base_idx + kk * axis_stride] =
+                data_ptr[src_base_idx + index * axis_stride];
+          }
         }
-      }
-    }
-  }
+      });
 }
 
 // Argsort implemented C library sort.
@@ -26,6 +26,7 @@
 
 #include <tvm/runtime/ndarray.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -170,21 +171,36 @@ TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
     LOG(INFO) << "config finishes setting up calibrator as INT8 mode ... ";
   }
 
-  // Add profiles.
+  // Add profiles. A dynamic batch dimension ranges from 1 to batch_size, so that the engine
+  // serves all the smaller batches. The profile is optimized for the shape of the current
+  // inputs, or for batch_size when the engine is built before any input is known.
   if (!use_implicit_batch_) {
     auto profile = builder_->createOptimizationProfile();
     for (int i = 0; i < network_->getNbInputs(); ++i) {
       auto name = network_->getInput(i)->getName();
       const uint32_t entry_id = entry_id_map_[name];
-      std::vector<int64_t> shape(data_entry_[entry_id]->shape,
-                                 data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
-      auto dims = VectorToTrtDims(shape);
+      const nvinfer1::Dims network_dims = network_->getInput(i)->getDimensions();
+      const bool dynamic_batch = network_dims.nbDims >= 1 && network_dims.d[0] == -1;
+      nvinfer1::Dims dims = network_dims;
+      if (data_entry_[entry_id] != nullptr) {
+        std::vector<int64_t> shape(data_entry_[entry_id]->shape,
+                                   data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
+        dims = VectorToTrtDims(shape);
+      } else if (dynamic_batch) {
+        dims.d[0] = batch_size_;
+      }
+      for (int j = 0; j < dims.nbDims; ++j) {
+        ICHECK_GE(dims.d[j], 0) << "The shape of input " << name
+                                << " must be known to build the TensorRT engine.";
+      }
 
       profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT, dims);
+      if (dynamic_batch) {
+        dims.d[0] = std::max(dims.d[0], batch_size_);
+      }
       profile->setDimensions(name, nvinfer1::OptProfileSelector::kMAX, dims);
       // Set minimum batch size to 1 when dynamic batching is used.
-      if (network_->getInput(i)->getDimensions().nbDims >= 1 &&
-          network_->getInput(i)->getDimensions().d[0] == -1) {
+      if (dynamic_batch) {
         dims.d[0] = 1;
       }
       profile->setDimensions(name, nvinfer1::OptProfileSelector::kMIN, dims);
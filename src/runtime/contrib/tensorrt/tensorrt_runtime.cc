@@ -26,8 +26,11 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -37,6 +40,8 @@
 #include "../json/json_runtime.h"
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+#include <cuda_runtime_api.h>
+
 #include "NvInfer.h"
 #include "tensorrt_builder.h"
 #include "tensorrt_calibrator.h"
@@ -72,6 +77,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
         use_implicit_batch_(true),
         max_workspace_size_(size_t(1) << 30),
         max_batch_size_(-1),
+        min_engine_batch_size_(-1),
         multi_engine_mode_(false) {
     const bool use_int8 = dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false);
     multi_engine_mode_ = dmlc::GetEnv("TVM_TENSORRT_MULTI_ENGINE", false);
@@ -96,6 +102,26 @@ class TensorRTRuntime : public JSONRuntimeBase {
    */
   const char* type_key() const override { return "tensorrt"; }
 
+  /*!
+   * \brief Get a packed function. Besides the functions of the JSON runtime, "build_engine"
+   * builds the engine for a batch size ahead of the first run, and caches it to disk when
+   * TVM_TENSORRT_CACHE_DIR is set.
+   *
+   * \param name The name/symbol of the function.
+   * \param sptr_to_self The pointer to the module node.
+   * \return The packed function.
+   */
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) override {
+    if (name == "build_engine") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ICHECK(this->initialized_) << "The module has not been initialized";
+        ICHECK_EQ(args.size(), 1U);
+        this->BuildEngineAheadOfTime(args[0]);
+      });
+    }
+    return JSONRuntimeBase::GetFunction(name, sptr_to_self);
+  }
+
   /*!
    * \brief Initialize runtime. Create TensorRT layer from JSON
    * representation.
@@ -106,7 +132,8 @@ class TensorRTRuntime : public JSONRuntimeBase {
     ICHECK_EQ(consts.size(), const_idx_.size())
         << "The number of input constants must match the number of required.";
     LoadGlobalAttributes();
-    if (GetCachedEnginesFromDisk()) return;
+    // The constants are still needed when an engine loaded from disk is later rebuilt for a
+    // larger batch size.
     SetupConstants(consts);
   }
 
@@ -126,6 +153,13 @@ class TensorRTRuntime : public JSONRuntimeBase {
           max_workspace_size_ =
               std::stoul(nodes_[i].GetAttr<std::vector<std::string>>("max_workspace_size")[0]);
         }
+        // Modules compiled before the option existed do not have the attribute.
+        if (nodes_[i].HasAttr("max_batch_size")) {
+          min_engine_batch_size_ =
+              std::stoi(nodes_[i].GetAttr<std::vector<std::string>>("max_batch_size")[0]);
+        }
+        min_engine_batch_size_ =
+            dmlc::GetEnv("TVM_TENSORRT_MAX_BATCH_SIZE", min_engine_batch_size_);
         return;
       }
     }
@@ -145,8 +179,8 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   /*! \brief Run inference using built engine. */
   void Run() override {
-    auto& engine_and_context = GetOrBuildEngine();
     int batch_size = GetBatchSize();
+    auto& engine_and_context = GetOrBuildEngine(batch_size);
     if (batch_size == 0) return;
     auto engine = engine_and_context.engine;
     auto context = engine_and_context.context;
@@ -261,8 +295,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
    * \brief Build TensorRT engine from JSON representation and cache it. If compatible engine is
    * already built, do nothing.
    */
-  TensorRTEngineAndContext& GetOrBuildEngine() {
-    int batch_size = GetBatchSize();
+  TensorRTEngineAndContext& GetOrBuildEngine(int batch_size) {
     int compatible_engine_batch_size = -1;
     bool find_engine_flag = FindCompatibleEngine(batch_size, &compatible_engine_batch_size);
     const bool use_int8 = (dmlc::GetEnv("TVM_TENSORRT_USE_INT8", 0) != 0);
@@ -274,9 +307,18 @@ class TensorRTRuntime : public JSONRuntimeBase {
       return trt_engine_cache_.at(std::make_pair(symbol_name_, compatible_engine_batch_size));
     }
 
-    // For single engine mode, remove previous engine and update max_batch_size.
+    // Reuse an engine built by another process or ahead of time, unless calibrating.
+    if (calibrator_ == nullptr &&
+        LoadEngineFromDisk(batch_size, &compatible_engine_batch_size)) {
+      num_calibration_batches_remaining_ = 0;
+      return trt_engine_cache_.at(std::make_pair(symbol_name_, compatible_engine_batch_size));
+    }
+
+    // In single engine mode, the engine is built for at least the max_batch_size option, so
+    // that it serves the smaller batches without rebuilding.
     if (!multi_engine_mode_) {
       DestroyEngines();
+      if (!use_int8) batch_size = std::max(batch_size, min_engine_batch_size_);
       max_batch_size_ = batch_size;
     }
     DLOG(INFO) << "Building new TensorRT engine for subgraph " << symbol_name_
@@ -293,16 +335,27 @@ class TensorRTRuntime : public JSONRuntimeBase {
       TensorRTEngineAndContext& engine_and_context =
           trt_engine_cache_[std::make_pair(symbol_name_, batch_size)];
       if (use_int8) {
-        this->CreateInt8Calibrator(engine_and_context);
+        this->CreateInt8Calibrator(engine_and_context, batch_size);
       }
     }
 
     LOG(INFO) << "Finished building TensorRT engine for subgraph " << symbol_name_
               << " with batch size " << batch_size;
-    CacheEngineToDisk();
+    // The engine used to collect the calibration data is not worth keeping.
+    if (calibrator_ == nullptr) {
+      CacheEngineToDisk(batch_size);
+    }
     return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
   }
 
+  /*! \brief Build the engine for a batch size before the inputs are known. */
+  void BuildEngineAheadOfTime(int batch_size) {
+    ICHECK(dmlc::GetEnv("TVM_TENSORRT_USE_INT8", 0) == 0)
+        << "INT8 engines need calibration data and cannot be built ahead of time.";
+    ICHECK_GT(batch_size, 0) << "The batch size to build the TensorRT engine for must be positive.";
+    GetOrBuildEngine(batch_size);
+  }
+
   void BuildEngineFromJson(int batch_size) {
     const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false);
     TensorRTBuilder builder(&logger_, data_entry_, max_workspace_size_, use_implicit_batch_,
@@ -336,78 +389,144 @@ class TensorRTRuntime : public JSONRuntimeBase {
     trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
   }
 
-  /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will check that directory for
-   * already built TRT engines and load into trt_engine_cache_ so they don't
-   * have to be built at first inference.
+  /*!
+   * \brief If TVM_TENSORRT_CACHE_DIR is set, look into that directory for an engine built for
+   * this subgraph which serves batch_size, and load it into trt_engine_cache_.
+   * \param batch_size The batch size to run.
+   * \param engine_batch_size The batch size the loaded engine was built for.
+   * \return Whether an engine was loaded.
    */
-  bool GetCachedEnginesFromDisk() {
+  bool LoadEngineFromDisk(int batch_size, int* engine_batch_size) {
     std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
     if (cache_dir.empty()) return false;
-    std::string key = GetSubgraphKey();
-    std::string path = cache_dir + "/" + key + ".plan";
-    // Check if engine is in the cache.
-    std::ifstream infile(path, std::ios::binary);
-    if (!infile.good()) return false;
-    LOG(INFO) << "Loading cached TensorRT engine from " << path;
-    infile.close();
-    std::string serialized_engine;
-    LoadBinaryFromFile(path, &serialized_engine);
-    // Deserialize engine
-    nvinfer1::IRuntime* runtime = nvinfer1::createInferRuntime(logger_);
-    TensorRTEngineAndContext engine_and_context;
-    engine_and_context.engine =
-        runtime->deserializeCudaEngine(&serialized_engine[0], serialized_engine.size(), nullptr);
-    engine_and_context.context = engine_and_context.engine->createExecutionContext();
+    std::string path = cache_dir + "/" + GetEnginePathStem(batch_size);
+    std::ifstream meta_file(path + ".meta", std::ios::binary);
+    std::ifstream plan_file(path + ".plan", std::ios::binary);
+    if (!meta_file.good() || !plan_file.good()) return false;
+    meta_file.close();
+    plan_file.close();
     // Load metadata
-    std::string meta_path = cache_dir + "/" + key + ".meta";
     std::string serialized_meta;
-    LoadBinaryFromFile(meta_path, &serialized_meta);
+    LoadBinaryFromFile(path + ".meta", &serialized_meta);
     std::istringstream is(serialized_meta);
     dmlc::JSONReader reader(&is);
     dmlc::JSONObjectReadHelper helper;
+    TensorRTEngineAndContext engine_and_context;
+    int max_batch_size = -1;
     helper.DeclareField("inputs", &engine_and_context.inputs);
     helper.DeclareField("outputs", &engine_and_context.outputs);
+    helper.DeclareField("max_batch_size", &max_batch_size);
     helper.ReadAllFields(&reader);
-    const int batch_size = GetBatchSize();
-    trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
-    LOG(INFO) << "finished saving engine and context ... ";
+    if (batch_size > max_batch_size) return false;
+    LOG(INFO) << "Loading cached TensorRT engine from " << path << ".plan";
+    std::string serialized_engine;
+    LoadBinaryFromFile(path + ".plan", &serialized_engine);
+    // Deserialize engine
+    nvinfer1::IRuntime* runtime = nvinfer1::createInferRuntime(logger_);
+    engine_and_context.engine =
+        runtime->deserializeCudaEngine(&serialized_engine[0], serialized_engine.size(), nullptr);
+    if (engine_and_context.engine == nullptr) {
+      LOG(WARNING) << "Failed to deserialize the TensorRT engine " << path << ".plan";
+      return false;
+    }
+    engine_and_context.context = engine_and_context.engine->createExecutionContext();
+    if (!multi_engine_mode_) {
+      DestroyEngines();
+      max_batch_size_ = max_batch_size;
+    }
+    trt_engine_cache_[std::make_pair(symbol_name_, max_batch_size)] = engine_and_context;
+    *engine_batch_size = max_batch_size;
     return true;
   }
 
   /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will save the engine to that
    * directory so it can be loaded later.
    */
-  void CacheEngineToDisk() {
-    int batch_size = GetBatchSize();
+  void CacheEngineToDisk(int batch_size) {
     std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
     if (cache_dir.empty()) return;
-    std::string key = GetSubgraphKey();
-    std::string path = cache_dir + "/" + key + ".plan";
-    DLOG(INFO) << "Caching TensorRT engine to " << path;
+    std::string path = cache_dir + "/" + GetEnginePathStem(batch_size);
+    const TensorRTEngineAndContext& engine_and_context =
+        trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
+    DLOG(INFO) << "Caching TensorRT engine to " << path << ".plan";
     // Serialize engine to disk
-    nvinfer1::IHostMemory* serialized_engine =
-        trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].engine->serialize();
-    SaveBinaryToFile(path, std::string(static_cast<const char*>(serialized_engine->data()),
-                                       serialized_engine->size()));
+    nvinfer1::IHostMemory* serialized_engine = engine_and_context.engine->serialize();
+    SaveBinaryToFile(path + ".plan",
+                     std::string(static_cast<const char*>(serialized_engine->data()),
+                                 serialized_engine->size()));
     serialized_engine->destroy();
-    // Serialize metadata
+    // Serialize metadata, written last so that a partially written engine is never loaded.
     std::ostringstream os;
     dmlc::JSONWriter writer(&os);
     writer.BeginObject();
-    writer.WriteObjectKeyValue("inputs",
-                               trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].inputs);
-    writer.WriteObjectKeyValue("outputs",
-                               trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].outputs);
+    writer.WriteObjectKeyValue("inputs", engine_and_context.inputs);
+    writer.WriteObjectKeyValue("outputs", engine_and_context.outputs);
+    writer.WriteObjectKeyValue("max_batch_size", batch_size);
     writer.EndObject();
-    std::string meta_path = cache_dir + "/" + key + ".meta";
-    SaveBinaryToFile(meta_path, os.str());
+    SaveBinaryToFile(path + ".meta", os.str());
   }
 
+  /*!
+   * \brief The file name of a cached engine, without extension. In single engine mode one engine
+   * is kept per subgraph, in multi engine mode one per batch size.
+   */
+  std::string GetEnginePathStem(int batch_size) {
+    std::string key = GetSubgraphKey();
+    return multi_engine_mode_ ? key + "_b" + std::to_string(batch_size) : key;
+  }
+
+  /*!
+   * \brief The key of the cached engines of this subgraph. An engine is only valid for the same
+   * graph and weights, TensorRT version, GPU model and build options.
+   */
   std::string GetSubgraphKey() {
-    // Using this key will only allow a single model per TVM_TENSORRT_CACHE_DIR directory. We could
-    // instead use a hash of graph_json and all weights to allow many models in the same directory,
-    // but the cost of computing the hash is high.
-    return symbol_name_ + (dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) ? "_fp16" : "_fp32");
+    if (subgraph_key_.empty()) {
+      std::ostringstream os;
+      os << symbol_name_ << "_" << std::hex << HashSubgraph() << std::dec << "_trt"
+         << NV_TENSORRT_MAJOR << "." << NV_TENSORRT_MINOR << "." << NV_TENSORRT_PATCH << "_"
+         << GetDeviceModel();
+      if (dmlc::GetEnv("TVM_TENSORRT_USE_INT8", 0) != 0) {
+        os << "_int8";
+      } else {
+        os << (dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) ? "_fp16" : "_fp32");
+      }
+      os << (use_implicit_batch_ ? "" : "_explicit") << "_ws" << max_workspace_size_;
+      subgraph_key_ = os.str();
+    }
+    return subgraph_key_;
+  }
+
+  /*! \brief Hash the graph JSON and the constants of the subgraph with FNV-1a. */
+  uint64_t HashSubgraph() {
+    uint64_t hash = 14695981039346656037ULL;
+    auto update = [&hash](const void* data, size_t size) {
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+      }
+    };
+    update(graph_json_.data(), graph_json_.size());
+    for (size_t i = 0; i < const_idx_.size(); ++i) {
+      const DLTensor* tensor = data_entry_[EntryID(const_idx_[i], 0)];
+      ICHECK(tensor != nullptr && tensor->device.device_type == kDLCPU);
+      update(static_cast<const char*>(tensor->data) + tensor->byte_offset, GetDataSize(*tensor));
+    }
+    return hash;
+  }
+
+  /*! \brief The name and the compute capability of the current GPU, usable in a file name. */
+  static std::string GetDeviceModel() {
+    int device_id = 0;
+    cudaDeviceProp prop;
+    if (cudaGetDevice(&device_id) != cudaSuccess ||
+        cudaGetDeviceProperties(&prop, device_id) != cudaSuccess) {
+      return "unknown_gpu";
+    }
+    std::string name = prop.name;
+    for (char& c : name) {
+      if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+    return name + "_sm" + std::to_string(prop.major) + std::to_string(prop.minor);
   }
 
   /*! \brief Retreive a GPU buffer for input or output or allocate if needed. */
@@ -432,14 +551,13 @@ class TensorRTRuntime : public JSONRuntimeBase {
     return device_buffers_.at(binding_index);
   }
 
-  void CreateInt8Calibrator(const TensorRTEngineAndContext& engine_and_context) {
+  void CreateInt8Calibrator(const TensorRTEngineAndContext& engine_and_context, int batch_size) {
     // Get input names in binding order.
     std::vector<std::string> input_names;
     for (size_t i = 0; i < engine_and_context.inputs.size(); i++) {
       std::string ele = engine_and_context.inputs[i];
       input_names.push_back(ele);
     }
-    const int batch_size = GetBatchSize();
     calibrator_.reset(new TensorRTCalibrator(batch_size, input_names));
   }
 
@@ -459,20 +577,19 @@ class TensorRTRuntime : public JSONRuntimeBase {
   /*! \brief TensorRT logger. */
   TensorRTLogger logger_;
 
+  /*! \brief The key of the cached engines on disk, computed on first use. */
+  std::string subgraph_key_;
+
 #else
   void Run() override {
     LOG(FATAL) << "TensorRT runtime is not enabled. "
                << "Please build with USE_TENSORRT_RUNTIME.";
   }
 
-  void BuildEngine() {
+  void BuildEngineAheadOfTime(int batch_size) {
     LOG(WARNING) << "TensorRT runtime is not enabled. "
                  << "Please build with USE_TENSORRT_RUNTIME.";
   }
-
-  bool GetCachedEnginesFromDisk() { return false; }
-
-  void CacheEngineToDisk() {}
 #endif
 
   bool use_implicit_batch_;
@@ -486,6 +603,11 @@ class TensorRTRuntime : public JSONRuntimeBase {
    * (multi_engine_mode=false). */
   int max_batch_size_;
 
+  /*! \brief The smallest batch size to build an engine for in single engine mode, from the
+   * max_batch_size option. With a dynamic batch dimension, one engine then serves all the batch
+   * sizes up to it. */
+  int min_engine_batch_size_;
+
   /*! \brief The strategy to use for dynamic batching. With multi_engine_mode=true, a new TensorRT
    * engine is created for each unique batch size encountered. With multi_engine_mode=false, only
    * one TensorRT engine is alive at any given time. It is replaced if a higher batch size is
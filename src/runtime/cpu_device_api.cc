@@ -104,5 +104,20 @@ TVM_REGISTER_GLOBAL("device_api.cpu").set_body([](TVMArgs args, TVMRetValue* rv)
   DeviceAPI* ptr = CPUDeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
 });
+
+// The DMA builtins of TIR on a CPU, with copies that are complete when they start.
+TVM_REGISTER_GLOBAL("device_api.cpu.DMACopy").set_body([](TVMArgs args, TVMRetValue* rv) {
+  int64_t nbytes = args[3];
+  std::memcpy(args[1].operator void*(), args[2].operator void*(), nbytes);
+  *rv = static_cast<int32_t>(0);
+});
+
+TVM_REGISTER_GLOBAL("device_api.cpu.DMACommitGroup").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = static_cast<int32_t>(0);
+});
+
+TVM_REGISTER_GLOBAL("device_api.cpu.DMAWaitGroup").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = static_cast<int32_t>(0);
+});
 }  // namespace runtime
 }  // namespace tvm
@@ -55,6 +55,7 @@ int TVMBackendFreeWorkspace(int device_type, int device_id, void* ptr) {
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
   TVMParallelGroupEnv env;
   env.num_task = 1;
+  env.thread_budget = 1;
   flambda(0, &env, cdata);
   return 0;
 }
@@ -575,6 +575,10 @@ __attribute__((weak)) tvm_crt_error_t TVMPlatformGenerateRandom(uint8_t* buffer,
   return kTvmErrorFunctionCallNotImplemented;
 }
 
+__attribute__((weak)) tvm_crt_error_t TVMPlatformProfilerCycles(uint64_t* cycles) {
+  return kTvmErrorFunctionCallNotImplemented;
+}
+
 // Fill the tensor in args[0] with random data using TVMPlatformGenerateRandom.
 // Named to correspond with the analogous function in the C++ runtime.
 int TVMContribRandomFill(TVMValue* args, int* type_codes, int num_args, TVMValue* ret_val,
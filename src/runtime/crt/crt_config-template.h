@@ -57,6 +57,19 @@
 /*! \brief Maximum length of a PackedFunc function name. */
 #define TVM_CRT_MAX_FUNCTION_NAME_LENGTH_BYTES 30
 
+/*!
+ * \brief The dynamic memory allocator created by CRTMemoryManagerCreate, the page allocator
+ * (TVM_CRT_MEMORY_MANAGER_PAGE) by default or the TLSF allocator (TVM_CRT_MEMORY_MANAGER_TLSF),
+ * see tvm/runtime/crt/memory_manager.h.
+ */
+// #define TVM_CRT_MEMORY_MANAGER TVM_CRT_MEMORY_MANAGER_TLSF
+
+/*!
+ * \brief Number of operator runs kept by the graph executor profiler, which needs
+ * TVMPlatformProfilerCycles. 0 by default, which compiles the profiler out.
+ */
+// #define TVM_CRT_PROFILER_RING_SIZE 128
+
 /*! \brief Enable checks to enforce the stack allocator with a FIFO ordering. Off by default */
 // #define TVM_CRT_STACK_ALLOCATOR_ENABLE_FIFO_CHECK
 
@@ -886,11 +886,87 @@ void TVMGraphExecutor_Run(TVMGraphExecutor* executor) {
 #if TVM_CRT_DEBUG
       printf("calling: %s (%d)\n", executor->op_execs[idx].name, idx);
 #endif  // TVM_CRT_DEBUG
+#if TVM_CRT_PROFILER_RING_SIZE > 0
+      uint64_t start_cycles = 0;
+      if (executor->profiling) {
+        TVMPlatformProfilerCycles(&start_cycles);
+      }
+#endif
       executor->op_execs[idx].Call(&(executor->op_execs[idx]));
+#if TVM_CRT_PROFILER_RING_SIZE > 0
+      if (executor->profiling) {
+        uint64_t end_cycles = 0;
+        TVMPlatformProfilerCycles(&end_cycles);
+        TVMGraphExecutorProfileRecord* record =
+            executor->profile_ring + (executor->profile_count % TVM_CRT_PROFILER_RING_SIZE);
+        record->node_id = idx;
+        record->cycles = end_cycles - start_cycles;
+        executor->profile_count++;
+      }
+#endif
     }
   }
 }
 
+/*!
+ * \brief Start or stop recording the cycles taken by each operator run.
+ * \param executor The graph executor.
+ * \param enable Whether to record, enabling clears the previous records.
+ * \return 0 on success, an error when the profiler is compiled out or the platform has no
+ *  cycle counter.
+ */
+int TVMGraphExecutor_SetProfiling(TVMGraphExecutor* executor, int enable) {
+#if TVM_CRT_PROFILER_RING_SIZE > 0
+  uint64_t cycles;
+  if (enable) {
+    tvm_crt_error_t err = TVMPlatformProfilerCycles(&cycles);
+    if (err != kTvmErrorNoError) {
+      return err;
+    }
+  }
+  executor->profiling = enable != 0;
+  if (enable) {
+    executor->profile_count = 0;
+  }
+  return 0;
+#else
+  return kTvmErrorFunctionCallNotImplemented;
+#endif
+}
+
+/*!
+ * \brief Copy the profiler records, oldest first.
+ * \param executor The graph executor.
+ * \param out An int64 tensor of shape (n, 2), filled with the node id and the cycles of up to n
+ *  records.
+ * \return The number of records copied, negative on error.
+ */
+int64_t TVMGraphExecutor_GetProfile(TVMGraphExecutor* executor, DLTensor* out) {
+#if TVM_CRT_PROFILER_RING_SIZE > 0
+  if (out->ndim != 2 || out->shape[1] != 2 || out->dtype.code != kDLInt ||
+      out->dtype.bits != 64) {
+    return -1;
+  }
+  uint64_t count = executor->profile_count;
+  uint64_t begin =
+      count > TVM_CRT_PROFILER_RING_SIZE ? count - TVM_CRT_PROFILER_RING_SIZE : 0;
+  if (count - begin > (uint64_t)out->shape[0]) {
+    begin = count - out->shape[0];
+  }
+  int64_t* data = (int64_t*)((uint8_t*)out->data + out->byte_offset);
+  uint64_t idx;
+  for (idx = begin; idx < count; ++idx) {
+    const TVMGraphExecutorProfileRecord* record =
+        executor->profile_ring + (idx % TVM_CRT_PROFILER_RING_SIZE);
+    data[2 * (idx - begin)] = record->node_id;
+    data[2 * (idx - begin) + 1] = (int64_t)record->cycles;
+  }
+  return (int64_t)(count - begin);
+#else
+  return -1;
+#endif
+}
+
 /*!
  * \brief Get the number of output tensors allocated.
  * \param executor The graph executor.
@@ -149,6 +149,28 @@ int32_t TVMGraphExecutorModule_GetOutput(TVMValue* args, int* tcodes, int nargs,
   return 0;
 }
 
+int32_t TVMGraphExecutorModule_GetProfile(TVMValue* args, int* tcodes, int nargs,
+                                          TVMValue* ret_values, int* ret_tcodes,
+                                          void* resource_handle) {
+  if (nargs != 1) {
+    return kTvmErrorFunctionCallNumArguments;
+  }
+
+  if (tcodes[0] != kTVMDLTensorHandle && tcodes[0] != kTVMNDArrayHandle) {
+    return kTvmErrorFunctionCallWrongArgType;
+  }
+
+  int64_t num_records =
+      TVMGraphExecutor_GetProfile(graph_executor.executor, (DLTensor*)args[0].v_handle);
+  if (num_records < 0) {
+    return kTvmErrorFunctionCallInvalidArg;
+  }
+
+  ret_values[0].v_int64 = num_records;
+  ret_tcodes[0] = kTVMArgInt;
+  return 0;
+}
+
 int32_t TVMGraphExecutorModule_LoadParams(TVMValue* args, int* tcodes, int nargs,
                                           TVMValue* ret_values, int* ret_tcodes,
                                           void* resource_handle) {
@@ -195,6 +217,21 @@ int32_t TVMGraphExecutorModule_SetInput(TVMValue* args, int* tcodes, int nargs,
   return 0;
 }
 
+int32_t TVMGraphExecutorModule_SetProfiling(TVMValue* args, int* tcodes, int nargs,
+                                            TVMValue* ret_values, int* ret_tcodes,
+                                            void* resource_handle) {
+  if (nargs != 1) {
+    return kTvmErrorFunctionCallNumArguments;
+  }
+
+  if (tcodes[0] != kTVMArgInt) {
+    return kTvmErrorFunctionCallWrongArgType;
+  }
+
+  ret_tcodes[0] = kTVMNullptr;
+  return TVMGraphExecutor_SetProfiling(graph_executor.executor, (int)args[0].v_int64);
+}
+
 int32_t TVMGraphExecutorModule_NotImplemented(TVMValue* args, int* tcodes, int nargs,
                                               TVMValue* ret_values, int* ret_tcodes,
                                               void* resource_handle) {
@@ -204,18 +241,21 @@ int32_t TVMGraphExecutorModule_NotImplemented(TVMValue* args, int* tcodes, int n
 static const TVMBackendPackedCFunc graph_executor_registry_funcs[] = {
     &TVMGraphExecutorModule_GetInput,      &TVMGraphExecutorModule_GetNumInputs,
     &TVMGraphExecutorModule_GetNumOutputs, &TVMGraphExecutorModule_GetOutput,
-    &TVMGraphExecutorModule_LoadParams,    &TVMGraphExecutorModule_Run,
-    &TVMGraphExecutorModule_SetInput,      &TVMGraphExecutorModule_NotImplemented,
+    &TVMGraphExecutorModule_GetProfile,    &TVMGraphExecutorModule_LoadParams,
+    &TVMGraphExecutorModule_Run,           &TVMGraphExecutorModule_SetInput,
+    &TVMGraphExecutorModule_SetProfiling,  &TVMGraphExecutorModule_NotImplemented,
 };
 
 static const TVMFuncRegistry graph_executor_registry = {
-    "\x08get_input\0"
+    "\x0aget_input\0"
     "get_num_inputs\0"
     "get_num_outputs\0"
     "get_output\0"
+    "get_profile\0"
     "load_params\0"
     "run\0"
     "set_input\0"
+    "set_profiling\0"
     "share_params\0",
     graph_executor_registry_funcs};
 
@@ -26,7 +26,7 @@
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/crt/logging.h>
 #include <tvm/runtime/crt/microtvm_rpc_server.h>
-#include <tvm/runtime/crt/page_allocator.h>
+#include <tvm/runtime/crt/memory_manager.h>
 #include <unistd.h>
 
 #include <chrono>
@@ -95,6 +95,13 @@ tvm_crt_error_t TVMPlatformTimerStop(double* elapsed_time_seconds) {
   return kTvmErrorNoError;
 }
 
+// The host has no cycle counter, the profiler counts the nanoseconds instead.
+tvm_crt_error_t TVMPlatformProfilerCycles(uint64_t* cycles) {
+  *cycles = static_cast<uint64_t>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+  return kTvmErrorNoError;
+}
+
 static_assert(RAND_MAX >= (1 << 8), "RAND_MAX is smaller than acceptable");
 unsigned int random_seed = 0;
 tvm_crt_error_t TVMPlatformGenerateRandom(uint8_t* buffer, size_t num_bytes) {
@@ -124,7 +131,7 @@ int testonly_reset_server(TVMValue* args, int* type_codes, int num_args, TVMValu
 int main(int argc, char** argv) {
   g_argv = argv;
   int status =
-      PageMemoryManagerCreate(&memory_manager, memory, sizeof(memory), 8 /* page_size_log2 */);
+      CRTMemoryManagerCreate(&memory_manager, memory, sizeof(memory), 8 /* page_size_log2 */);
   if (status != 0) {
     fprintf(stderr, "error initiailizing memory manager\n");
     return 2;
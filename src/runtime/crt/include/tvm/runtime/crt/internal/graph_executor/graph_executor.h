@@ -33,6 +33,13 @@ extern "C" {
 #include <tvm/runtime/crt/internal/graph_executor/load_json.h>
 #include <tvm/runtime/crt/module.h>
 
+#include "crt_config.h"
+
+/*! \brief Number of operator runs recorded by the profiler, 0 compiles the profiler out. */
+#ifndef TVM_CRT_PROFILER_RING_SIZE
+#define TVM_CRT_PROFILER_RING_SIZE 0
+#endif
+
 // Memory pool entry.
 typedef struct TVMGraphExecutorPoolEntry {
   size_t size;
@@ -75,6 +82,12 @@ typedef struct TVMGraphExecutorNode {
   int (*Load)(struct TVMGraphExecutorNode* node, JSONReader* reader);
 } TVMGraphExecutorNode;
 
+// Profiler record, the cycles taken by one run of an operator.
+typedef struct TVMGraphExecutorProfileRecord {
+  uint32_t node_id;
+  uint64_t cycles;
+} TVMGraphExecutorProfileRecord;
+
 typedef struct TVMGraphExecutor {
   /*! \brief The graph nodes. */
   TVMGraphExecutorNode* nodes;
@@ -106,6 +119,13 @@ typedef struct TVMGraphExecutor {
   /*! \brief Operator on each node. */
   TVMPackedFunc* op_execs;
   uint32_t op_execs_count;
+#if TVM_CRT_PROFILER_RING_SIZE > 0
+  /*! \brief Whether the operator runs are recorded. */
+  uint8_t profiling;
+  /*! \brief The number of operator runs recorded, the last ones are kept in profile_ring. */
+  uint64_t profile_count;
+  TVMGraphExecutorProfileRecord profile_ring[TVM_CRT_PROFILER_RING_SIZE];
+#endif
 } TVMGraphExecutor;
 
 typedef DLTensor* DLTensorPtr;
@@ -116,6 +136,8 @@ void TVMGraphExecutor_SetInput(TVMGraphExecutor* executor, const char* name, DLT
 int TVMGraphExecutor_LoadParams(TVMGraphExecutor* executor, const char* param_blob,
                                 const uint32_t param_size);
 void TVMGraphExecutor_Run(TVMGraphExecutor* executor);
+int TVMGraphExecutor_SetProfiling(TVMGraphExecutor* executor, int enable);
+int64_t TVMGraphExecutor_GetProfile(TVMGraphExecutor* executor, DLTensor* out);
 int TVMGraphExecutor_GetOutput(TVMGraphExecutor* executor, const int32_t idx, DLTensor* out);
 
 int32_t TVMGraphExecutor_CreateTVMOp(TVMGraphExecutor* executor, const TVMOpParam* param,
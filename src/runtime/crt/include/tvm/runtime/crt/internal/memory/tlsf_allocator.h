@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime/crt/include/tvm/runtime/crt/internal/memory/tlsf_allocator.h
+ * \brief Defines data types and functions used in the TLSF memory manager.
+ *     Exposed for testing.
+ */
+
+#ifndef TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
+#define TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
+
+#include <stdint.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/tlsf_allocator.h>
+
+#include "crt_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief log2 of the largest block plus one, the pools are only used up to this size. */
+#ifndef TVM_CRT_TLSF_MAX_BLOCK_SIZE_LOG2
+#define TVM_CRT_TLSF_MAX_BLOCK_SIZE_LOG2 26
+#endif
+
+/*! \brief log2 of the alignment of the allocated memory, and granularity of the block sizes. */
+#define TLSF_ALIGNMENT_LOG2 4
+#define TLSF_ALIGNMENT_BYTES (1 << TLSF_ALIGNMENT_LOG2)
+/*! \brief log2 of the number of second level lists per power of two. */
+#define TLSF_SL_LOG2 4
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+/*! \brief The blocks smaller than this size are all in the first level list 0, linearly. */
+#define TLSF_FL_SHIFT (TLSF_SL_LOG2 + TLSF_ALIGNMENT_LOG2)
+#define TLSF_SMALL_BLOCK_SIZE (1 << TLSF_FL_SHIFT)
+#define TLSF_FL_COUNT (TVM_CRT_TLSF_MAX_BLOCK_SIZE_LOG2 - TLSF_FL_SHIFT + 1)
+#define TLSF_MAX_BLOCK_SIZE ((size_t)1 << TVM_CRT_TLSF_MAX_BLOCK_SIZE_LOG2)
+/*! \brief The bytes between a block and its data, the header rounded up to the alignment. */
+#define TLSF_BLOCK_OVERHEAD TLSF_ALIGNMENT_BYTES
+/*! \brief The smallest block, large enough for the free list links. */
+#define TLSF_MIN_BLOCK_SIZE TLSF_ALIGNMENT_BYTES
+
+/*! \brief The flags kept in the low bits of TLSFBlock::size. */
+#define TLSF_BLOCK_FREE_BIT ((size_t)1)
+#define TLSF_BLOCK_PREV_FREE_BIT ((size_t)2)
+
+/*!
+ * \brief A block of memory, followed by its data.
+ *
+ * Only prev_phys and size are kept for the allocated blocks, the free list links are stored at
+ * the start of the data of the free blocks.
+ */
+typedef struct TLSFBlock {
+  /*! \brief The previous block in memory, only valid when it is free. */
+  struct TLSFBlock* prev_phys;
+  /*! \brief The size of the data in bytes, or-ed with the TLSF_BLOCK_*_BIT flags. */
+  size_t size;
+  /*! \brief The next and previous blocks of the free list of the block, when it is free. */
+  struct TLSFBlock* next_free;
+  struct TLSFBlock* prev_free;
+} TLSFBlock;
+
+/*!
+ * \brief TLSF memory manager, kept at the start of the memory pool.
+ */
+typedef struct TLSFMemoryManager {
+  /*! \brief Public interface for this object. */
+  MemoryManagerInterface interface;
+  /*! \brief Bit i set when a second level list of the first level list i is not empty. */
+  uint32_t fl_bitmap;
+  /*! \brief Bit j of sl_bitmap[i] set when blocks[i][j] is not empty. */
+  uint32_t sl_bitmap[TLSF_FL_COUNT];
+  /*! \brief The heads of the free lists. */
+  TLSFBlock* blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+  /*! \brief The first block, and the empty block ending the pool. */
+  TLSFBlock* first_block;
+  TLSFBlock* last_block;
+} TLSFMemoryManager;
+
+/*!
+ * \brief The free list of the blocks of a size.
+ * \param size The size of the block data, a multiple of TLSF_ALIGNMENT_BYTES.
+ * \param fl The first level index.
+ * \param sl The second level index.
+ */
+void TLSFMappingInsert(size_t size, int* fl, int* sl);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
@@ -0,0 +1,45 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+// LINT_C_FILE
+
+/*!
+ * \file memory_manager.c
+ * \brief Creates the memory manager selected by TVM_CRT_MEMORY_MANAGER.
+ */
+
+#include <tvm/runtime/crt/memory_manager.h>
+
+#include "crt_config.h"
+
+#ifndef TVM_CRT_MEMORY_MANAGER
+#define TVM_CRT_MEMORY_MANAGER TVM_CRT_MEMORY_MANAGER_PAGE
+#endif
+
+tvm_crt_error_t CRTMemoryManagerCreate(MemoryManagerInterface** manager, uint8_t* memory_pool,
+                                       size_t memory_pool_size_bytes, size_t page_size_bytes_log2) {
+#if TVM_CRT_MEMORY_MANAGER == TVM_CRT_MEMORY_MANAGER_TLSF
+  return TLSFMemoryManagerCreate(manager, memory_pool, memory_pool_size_bytes);
+#elif TVM_CRT_MEMORY_MANAGER == TVM_CRT_MEMORY_MANAGER_PAGE
+  return PageMemoryManagerCreate(manager, memory_pool, memory_pool_size_bytes,
+                                 page_size_bytes_log2);
+#else
+#error "TVM_CRT_MEMORY_MANAGER must be TVM_CRT_MEMORY_MANAGER_PAGE or TVM_CRT_MEMORY_MANAGER_TLSF"
+#endif
+}
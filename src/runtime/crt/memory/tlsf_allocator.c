@@ -0,0 +1,270 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+// LINT_C_FILE
+
+/*!
+ * \file tlsf_allocator.c
+ * \brief Two-level segregated fit memory manager, with a bounded allocation and free time.
+ *
+ * To maximize portability, thread-safe feature has been dropped for now.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/internal/memory/tlsf_allocator.h>
+#include <tvm/runtime/crt/logging.h>
+#include <tvm/runtime/crt/platform.h>
+
+#define TLSF_ROUND_UP(qty, modulo) (((qty) + ((modulo)-1)) & ~((modulo)-1))
+
+// The index of the highest and of the lowest set bit, x must not be 0.
+static int TLSFHighestBit(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 31 - __builtin_clz(x);
+#else
+  int bit = 0;
+  while (x >>= 1) bit++;
+  return bit;
+#endif
+}
+
+static int TLSFLowestBit(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(x);
+#else
+  int bit = 0;
+  while ((x & 1) == 0) {
+    x >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+static size_t TLSFBlockSize(const TLSFBlock* block) {
+  return block->size & ~(TLSF_BLOCK_FREE_BIT | TLSF_BLOCK_PREV_FREE_BIT);
+}
+
+static uint8_t* TLSFBlockData(TLSFBlock* block) { return (uint8_t*)block + TLSF_BLOCK_OVERHEAD; }
+
+static TLSFBlock* TLSFBlockNext(TLSFBlock* block) {
+  return (TLSFBlock*)(TLSFBlockData(block) + TLSFBlockSize(block));
+}
+
+void TLSFMappingInsert(size_t size, int* fl, int* sl) {
+  if (size < TLSF_SMALL_BLOCK_SIZE) {
+    *fl = 0;
+    *sl = (int)(size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_COUNT));
+  } else {
+    int bit = TLSFHighestBit((uint32_t)size);
+    *sl = (int)((size >> (bit - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT);
+    *fl = bit - TLSF_FL_SHIFT + 1;
+  }
+}
+
+// The first free list whose blocks are all at least size bytes, so the search is a good fit.
+static void TLSFMappingSearch(size_t size, int* fl, int* sl) {
+  if (size >= TLSF_SMALL_BLOCK_SIZE) {
+    size += ((size_t)1 << (TLSFHighestBit((uint32_t)size) - TLSF_SL_LOG2)) - 1;
+  }
+  TLSFMappingInsert(size, fl, sl);
+}
+
+static void TLSFInsertFreeBlock(TLSFMemoryManager* mgr, TLSFBlock* block) {
+  int fl, sl;
+  TLSFMappingInsert(TLSFBlockSize(block), &fl, &sl);
+  TLSFBlock* head = mgr->blocks[fl][sl];
+  block->next_free = head;
+  block->prev_free = NULL;
+  if (head != NULL) {
+    head->prev_free = block;
+  }
+  mgr->blocks[fl][sl] = block;
+  mgr->fl_bitmap |= 1U << fl;
+  mgr->sl_bitmap[fl] |= 1U << sl;
+}
+
+static void TLSFRemoveFreeBlock(TLSFMemoryManager* mgr, TLSFBlock* block) {
+  int fl, sl;
+  TLSFMappingInsert(TLSFBlockSize(block), &fl, &sl);
+  if (block->next_free != NULL) {
+    block->next_free->prev_free = block->prev_free;
+  }
+  if (block->prev_free != NULL) {
+    block->prev_free->next_free = block->next_free;
+  } else {
+    mgr->blocks[fl][sl] = block->next_free;
+    if (block->next_free == NULL) {
+      mgr->sl_bitmap[fl] &= ~(1U << sl);
+      if (mgr->sl_bitmap[fl] == 0) {
+        mgr->fl_bitmap &= ~(1U << fl);
+      }
+    }
+  }
+}
+
+static void TLSFMarkFree(TLSFBlock* block) {
+  block->size |= TLSF_BLOCK_FREE_BIT;
+  TLSFBlock* next = TLSFBlockNext(block);
+  next->prev_phys = block;
+  next->size |= TLSF_BLOCK_PREV_FREE_BIT;
+}
+
+static void TLSFMarkUsed(TLSFBlock* block) {
+  block->size &= ~TLSF_BLOCK_FREE_BIT;
+  TLSFBlockNext(block)->size &= ~TLSF_BLOCK_PREV_FREE_BIT;
+}
+
+/*!
+ * \brief Allocate memory from manager
+ * \param size The size of memory
+ * \return The virtual address
+ */
+tvm_crt_error_t TLSFMemoryManager_Allocate(MemoryManagerInterface* interface, size_t num_bytes,
+                                           DLDevice dev, void** out_ptr) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+
+  *out_ptr = 0;
+  if (num_bytes >= TLSF_MAX_BLOCK_SIZE) {
+    return kTvmErrorPlatformNoMemory;
+  }
+  size_t size = TLSF_ROUND_UP(num_bytes, (size_t)TLSF_ALIGNMENT_BYTES);
+  if (size < TLSF_MIN_BLOCK_SIZE) {
+    size = TLSF_MIN_BLOCK_SIZE;
+  }
+
+  int fl, sl;
+  TLSFMappingSearch(size, &fl, &sl);
+  if (fl >= TLSF_FL_COUNT) {
+    return kTvmErrorPlatformNoMemory;
+  }
+  uint32_t sl_map = mgr->sl_bitmap[fl] & (~0U << sl);
+  if (sl_map == 0) {
+    uint32_t fl_map = mgr->fl_bitmap & (~0U << (fl + 1));
+    if (fl_map == 0) {
+#if TVM_CRT_DEBUG > 1
+      TVMLogf("insufficient memory, num_bytes=%zu\n", num_bytes);
+#endif
+      return kTvmErrorPlatformNoMemory;
+    }
+    fl = TLSFLowestBit(fl_map);
+    sl_map = mgr->sl_bitmap[fl];
+  }
+  sl = TLSFLowestBit(sl_map);
+  TLSFBlock* block = mgr->blocks[fl][sl];
+  TLSFRemoveFreeBlock(mgr, block);
+
+  // Give the end of the block back when it can hold another block.
+  size_t block_size = TLSFBlockSize(block);
+  if (block_size >= size + TLSF_BLOCK_OVERHEAD + TLSF_MIN_BLOCK_SIZE) {
+    TLSFBlock* rest = (TLSFBlock*)(TLSFBlockData(block) + size);
+    rest->size = block_size - size - TLSF_BLOCK_OVERHEAD;
+    block->size = size | (block->size & (TLSF_BLOCK_FREE_BIT | TLSF_BLOCK_PREV_FREE_BIT));
+    TLSFMarkFree(rest);
+    TLSFInsertFreeBlock(mgr, rest);
+  }
+  TLSFMarkUsed(block);
+
+  *out_ptr = TLSFBlockData(block);
+  mgr->interface.vleak_size++;
+#if TVM_CRT_DEBUG > 1
+  TVMLogf("allocate: addr=%p, size=%zu, vleak=%d\n", *out_ptr, TLSFBlockSize(block),
+          mgr->interface.vleak_size);
+#endif  // TVM_CRT_DEBUG
+  return kTvmErrorNoError;
+}
+
+/*!
+ * \brief Free the memory.
+ * \param interface Pointer to this structure.
+ * \param ptr A pointer returned from TVMPlatformMemoryAllocate which should be free'd.
+ * \param dev Execution device passed to TVMPlatformMemoryAllocate. Fixed to {kDLCPU, 0}.
+ * \return kTvmErrorNoError if successful; a descriptive error code otherwise.
+ */
+tvm_crt_error_t TLSFMemoryManager_Free(MemoryManagerInterface* interface, void* ptr, DLDevice dev) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+
+  uint8_t* data = (uint8_t*)ptr;
+  if (data < TLSFBlockData(mgr->first_block) || data >= (uint8_t*)mgr->last_block ||
+      ((uintptr_t)data & (TLSF_ALIGNMENT_BYTES - 1)) != 0) {
+    return kTvmErrorPlatformMemoryManagerBadFree;
+  }
+  TLSFBlock* block = (TLSFBlock*)(data - TLSF_BLOCK_OVERHEAD);
+  if ((block->size & TLSF_BLOCK_FREE_BIT) != 0) {
+    return kTvmErrorPlatformMemoryManagerBadFree;
+  }
+#if TVM_CRT_DEBUG > 1
+  TVMLogf("release: addr=%p, size=%zu, vleak=%d\n", ptr, TLSFBlockSize(block),
+          mgr->interface.vleak_size - 1);
+#endif  // TVM_CRT_DEBUG
+
+  // Merge the block with its free neighbours.
+  if ((block->size & TLSF_BLOCK_PREV_FREE_BIT) != 0) {
+    TLSFBlock* prev = block->prev_phys;
+    TLSFRemoveFreeBlock(mgr, prev);
+    prev->size += TLSF_BLOCK_OVERHEAD + TLSFBlockSize(block);
+    block = prev;
+  }
+  TLSFBlock* next = TLSFBlockNext(block);
+  if ((next->size & TLSF_BLOCK_FREE_BIT) != 0) {
+    TLSFRemoveFreeBlock(mgr, next);
+    block->size += TLSF_BLOCK_OVERHEAD + TLSFBlockSize(next);
+  }
+  TLSFMarkFree(block);
+  TLSFInsertFreeBlock(mgr, block);
+  mgr->interface.vleak_size--;
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t TLSFMemoryManagerCreate(MemoryManagerInterface** interface, uint8_t* memory_pool,
+                                        size_t memory_pool_size_bytes) {
+  uintptr_t begin = TLSF_ROUND_UP((uintptr_t)memory_pool, (uintptr_t)TLSF_ALIGNMENT_BYTES);
+  uintptr_t end = ((uintptr_t)memory_pool + memory_pool_size_bytes) &
+                  ~((uintptr_t)TLSF_ALIGNMENT_BYTES - 1);
+  uintptr_t first_block =
+      begin + TLSF_ROUND_UP(sizeof(TLSFMemoryManager), (size_t)TLSF_ALIGNMENT_BYTES);
+  // The first block and the empty block ending the pool.
+  if (end < first_block + 2 * TLSF_BLOCK_OVERHEAD + TLSF_MIN_BLOCK_SIZE) {
+    return kTvmErrorPlatformNoMemory;
+  }
+  size_t size = end - first_block - 2 * TLSF_BLOCK_OVERHEAD;
+  if (size >= TLSF_MAX_BLOCK_SIZE) {
+    size = TLSF_MAX_BLOCK_SIZE - TLSF_ALIGNMENT_BYTES;
+  }
+
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)begin;
+  memset(mgr, 0, sizeof(TLSFMemoryManager));
+  mgr->interface.Allocate = TLSFMemoryManager_Allocate;
+  mgr->interface.Free = TLSFMemoryManager_Free;
+
+  TLSFBlock* block = (TLSFBlock*)first_block;
+  block->prev_phys = NULL;
+  block->size = size;
+  mgr->first_block = block;
+  mgr->last_block = TLSFBlockNext(block);
+  mgr->last_block->size = 0;
+  TLSFMarkFree(block);
+  TLSFInsertFreeBlock(mgr, block);
+
+  *interface = &mgr->interface;
+  return kTvmErrorNoError;
+}
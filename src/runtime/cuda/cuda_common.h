@@ -27,7 +27,9 @@
 #include <cuda_runtime.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "../workspace_pool.h"
 
@@ -58,8 +60,15 @@ class CUDAThreadEntry {
   cudaStream_t stream{nullptr};
   /*! \brief thread local pool*/
   WorkspacePool pool;
+  /*!
+   * \brief workspace pools of the non-default streams, the workspace freed by a kernel
+   *  can only be reused by the kernels ordered after it on the same stream.
+   */
+  std::unordered_map<cudaStream_t, std::unique_ptr<WorkspacePool>> stream_pools;
   /*! \brief constructor */
   CUDAThreadEntry();
+  /*! \return the workspace pool of the current stream */
+  WorkspacePool* CurrentPool();
   // get the threadlocal workspace
   static CUDAThreadEntry* ThreadLocal();
 };
@@ -28,7 +28,16 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <atomic>
+#include <cstdlib>
 #include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include "cuda_common.h"
 
@@ -116,6 +125,16 @@ class CUDADeviceAPI final : public DeviceAPI {
       CUDA_CALL(cudaMallocHost(&ret, nbytes));
     } else {
       CUDA_CALL(cudaSetDevice(dev.device_id));
+#if CUDART_VERSION >= 11020
+      if (UseStreamOrderedAllocator(dev)) {
+        VLOG(1) << "allocating " << nbytes << " bytes from the memory pool of the device";
+        CUDA_CALL(cudaMallocAsync(&ret, nbytes, CUDAThreadEntry::ThreadLocal()->stream));
+        std::lock_guard<std::mutex> lock(mutex_);
+        stream_ordered_allocations_.insert(ret);
+        stream_ordered_used_.store(true);
+        return ret;
+      }
+#endif
       size_t free_mem, total_mem;
       CUDA_CALL(cudaMemGetInfo(&free_mem, &total_mem));
       VLOG(1) << "allocating " << nbytes << " bytes on device, with " << free_mem
@@ -131,11 +150,28 @@ class CUDADeviceAPI final : public DeviceAPI {
       CUDA_CALL(cudaFreeHost(ptr));
     } else {
       CUDA_CALL(cudaSetDevice(dev.device_id));
+#if CUDART_VERSION >= 11020
+      if (EraseStreamOrderedAllocation(ptr)) {
+        // ordered after the kernels launched so far on the stream, without a device sync
+        VLOG(1) << "freeing device memory to the memory pool of the device";
+        CUDA_CALL(cudaFreeAsync(ptr, CUDAThreadEntry::ThreadLocal()->stream));
+        return;
+      }
+#endif
       VLOG(1) << "freeing device memory";
       CUDA_CALL(cudaFree(ptr));
     }
   }
 
+  void* AllocPinnedHostSpace(Device dev, size_t nbytes) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    void* ret;
+    CUDA_CALL(cudaMallocHost(&ret, nbytes));
+    return ret;
+  }
+
+  void FreePinnedHostSpace(Device dev, void* ptr) final { CUDA_CALL(cudaFreeHost(ptr)); }
+
  protected:
   void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
                       Device dev_from, Device dev_to, DLDataType type_hint,
@@ -187,6 +223,7 @@ class CUDADeviceAPI final : public DeviceAPI {
   void FreeStream(Device dev, TVMStreamHandle stream) {
     CUDA_CALL(cudaSetDevice(dev.device_id));
     cudaStream_t cu_stream = static_cast<cudaStream_t>(stream);
+    CUDAThreadEntry::ThreadLocal()->stream_pools.erase(cu_stream);
     CUDA_CALL(cudaStreamDestroy(cu_stream));
   }
 
@@ -210,14 +247,65 @@ class CUDADeviceAPI final : public DeviceAPI {
     CUDAThreadEntry::ThreadLocal()->stream = static_cast<cudaStream_t>(stream);
   }
 
+  void StreamAddCallback(Device dev, TVMStreamHandle stream,
+                         std::function<void()> callback) final {
+#if CUDART_VERSION >= 10000
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    auto* fn = new std::function<void()>(std::move(callback));
+    CUDA_CALL(cudaLaunchHostFunc(
+        static_cast<cudaStream_t>(stream),
+        [](void* data) {
+          std::unique_ptr<std::function<void()>> fn(static_cast<std::function<void()>*>(data));
+          try {
+            (*fn)();
+          } catch (const std::exception& e) {
+            LOG(ERROR) << "Stream callback failed: " << e.what();
+          }
+        },
+        fn));
+#else
+    DeviceAPI::StreamAddCallback(dev, stream, std::move(callback));
+#endif
+  }
+
   void* AllocWorkspace(Device dev, size_t size, DLDataType type_hint) final {
-    return CUDAThreadEntry::ThreadLocal()->pool.AllocWorkspace(dev, size);
+    // the memory pool of the device already caches the stream ordered allocations
+    if (UseStreamOrderedAllocator(dev)) {
+      return AllocDataSpace(dev, size, kTempAllocaAlignment, type_hint);
+    }
+    return CUDAThreadEntry::ThreadLocal()->CurrentPool()->AllocWorkspace(dev, size);
   }
 
   void FreeWorkspace(Device dev, void* data) final {
-    CUDAThreadEntry::ThreadLocal()->pool.FreeWorkspace(dev, data);
+    if (IsStreamOrderedAllocation(data)) {
+      FreeDataSpace(dev, data);
+      return;
+    }
+    CUDAThreadEntry::ThreadLocal()->CurrentPool()->FreeWorkspace(dev, data);
   }
 
+  /*!
+   * \brief Select the allocator of the device memory.
+   * \param name "default" for cudaMalloc and cudaFree, "async" for cudaMallocAsync and
+   *  cudaFreeAsync on the stream of the calling thread, in the default memory pool of the
+   *  device shared with the other libraries using it.
+   *
+   *  The memory allocated before the switch is freed by the allocator it came from. The
+   *  stream ordered memory must only be used by the stream it was allocated on, or after
+   *  that stream was synchronized with.
+   */
+  void SetAllocator(const std::string& name) {
+    ICHECK(name == "default" || name == "async")
+        << "unknown CUDA allocator " << name << ", expected default or async";
+#if CUDART_VERSION < 11020
+    ICHECK(name == "default") << "the async CUDA allocator needs CUDA 11.2 or later";
+#endif
+    stream_ordered_.store(name == "async");
+  }
+
+  /*! \return The name of the allocator of the device memory. */
+  std::string GetAllocator() const { return stream_ordered_.load() ? "async" : "default"; }
+
   static CUDADeviceAPI* Global() {
     // NOTE: explicitly use new to avoid exit-time destruction of global state
     // Global state will be recycled by OS as the process exits.
@@ -226,8 +314,78 @@ class CUDADeviceAPI final : public DeviceAPI {
   }
 
  private:
+  CUDADeviceAPI() {
+    const char* allocator = std::getenv("TVM_CUDA_ALLOCATOR");
+    if (allocator != nullptr && allocator[0] != '\0') {
+      SetAllocator(allocator);
+    }
+  }
+
+  // Whether the allocations on a device are stream ordered, false when the device has no
+  // memory pool support.
+  bool UseStreamOrderedAllocator(Device dev) {
+#if CUDART_VERSION >= 11020
+    if (!stream_ordered_.load() || dev.device_type != kDLCUDA) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = memory_pools_supported_.find(dev.device_id);
+    if (it != memory_pools_supported_.end()) return it->second;
+    int supported = 0;
+    CUDA_CALL(cudaDeviceGetAttribute(&supported, cudaDevAttrMemoryPoolsSupported, dev.device_id));
+    if (supported) {
+      // keep the freed memory in the pool instead of returning it at each synchronization
+      cudaMemPool_t pool;
+      uint64_t threshold = std::numeric_limits<uint64_t>::max();
+      CUDA_CALL(cudaDeviceGetDefaultMemPool(&pool, dev.device_id));
+      CUDA_CALL(cudaMemPoolSetAttribute(pool, cudaMemPoolAttrReleaseThreshold, &threshold));
+    } else {
+      LOG(WARNING) << "CUDA device " << dev.device_id
+                   << " has no memory pool support, using cudaMalloc";
+    }
+    memory_pools_supported_[dev.device_id] = supported != 0;
+    return supported != 0;
+#else
+    return false;
+#endif
+  }
+
+  bool IsStreamOrderedAllocation(void* ptr) {
+    if (!stream_ordered_used_.load()) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stream_ordered_allocations_.count(ptr) != 0;
+  }
+
+  bool EraseStreamOrderedAllocation(void* ptr) {
+    if (!stream_ordered_used_.load()) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stream_ordered_allocations_.erase(ptr) != 0;
+  }
+
+  /*! \brief Whether the device memory is allocated by cudaMallocAsync. */
+  std::atomic<bool> stream_ordered_{false};
+  /*! \brief Whether any stream ordered allocation was made. */
+  std::atomic<bool> stream_ordered_used_{false};
+  /*! \brief Protects the fields below. */
+  std::mutex mutex_;
+  /*! \brief The live allocations made by cudaMallocAsync. */
+  std::unordered_set<void*> stream_ordered_allocations_;
+  /*! \brief Whether each device supports memory pools. */
+  std::unordered_map<int, bool> memory_pools_supported_;
   static void GPUCopy(const void* from, void* to, size_t size, cudaMemcpyKind kind,
                       cudaStream_t stream) {
+#if CUDART_VERSION >= 10000
+    if (stream == nullptr) {
+      // Synchronous copies are illegal while the thread local stream is captured into
+      // a CUDA graph, so capture the copy on that stream instead.
+      cudaStream_t thread_stream = CUDAThreadEntry::ThreadLocal()->stream;
+      cudaStreamCaptureStatus status = cudaStreamCaptureStatusNone;
+      if (thread_stream != nullptr) {
+        CUDA_CALL(cudaStreamIsCapturing(thread_stream, &status));
+      }
+      if (status == cudaStreamCaptureStatusActive) {
+        stream = thread_stream;
+      }
+    }
+#endif
     if (stream != nullptr) {
       CUDA_CALL(cudaMemcpyAsync(to, from, size, kind, stream));
     } else {
@@ -242,6 +400,15 @@ CUDAThreadEntry::CUDAThreadEntry() : pool(kDLCUDA, CUDADeviceAPI::Global()) {}
 
 CUDAThreadEntry* CUDAThreadEntry::ThreadLocal() { return CUDAThreadStore::Get(); }
 
+WorkspacePool* CUDAThreadEntry::CurrentPool() {
+  if (stream == nullptr) return &pool;
+  std::unique_ptr<WorkspacePool>& stream_pool = stream_pools[stream];
+  if (stream_pool == nullptr) {
+    stream_pool.reset(new WorkspacePool(kDLCUDA, CUDADeviceAPI::Global()));
+  }
+  return stream_pool.get();
+}
+
 TVM_REGISTER_GLOBAL("device_api.cuda").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = CUDADeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
@@ -252,6 +419,14 @@ TVM_REGISTER_GLOBAL("device_api.cuda_host").set_body([](TVMArgs args, TVMRetValu
   *rv = static_cast<void*>(ptr);
 });
 
+TVM_REGISTER_GLOBAL("runtime.cuda.SetAllocator").set_body_typed([](String name) {
+  CUDADeviceAPI::Global()->SetAllocator(name);
+});
+
+TVM_REGISTER_GLOBAL("runtime.cuda.GetAllocator").set_body_typed([]() -> String {
+  return CUDADeviceAPI::Global()->GetAllocator();
+});
+
 class GPUTimerNode : public TimerNode {
  public:
   virtual void Start() {
@@ -24,11 +24,27 @@
 
 #include <dmlc/json.h>
 #include <dmlc/memory_io.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <numeric>
+#include <sstream>
 #include <unordered_map>
 #include <vector>
 
@@ -161,16 +177,325 @@ void LoadMetaDataFromFile(const std::string& file_name,
 
 void RemoveFile(const std::string& file_name) { std::remove(file_name.c_str()); }
 
+namespace {
+struct KernelCacheConfig {
+  std::mutex mutex;
+  std::string dir;
+
+  KernelCacheConfig() {
+    if (const char* env_dir = getenv("TVM_KERNEL_CACHE_DIR")) {
+      dir = env_dir;
+    }
+  }
+
+  static KernelCacheConfig* Global() {
+    static KernelCacheConfig* inst = new KernelCacheConfig();
+    return inst;
+  }
+};
+}  // namespace
+
+std::string GetKernelCacheDir() {
+  KernelCacheConfig* config = KernelCacheConfig::Global();
+  std::lock_guard<std::mutex> lock(config->mutex);
+  return config->dir;
+}
+
+void SetKernelCacheDir(const std::string& dir) {
+  KernelCacheConfig* config = KernelCacheConfig::Global();
+  std::lock_guard<std::mutex> lock(config->mutex);
+  config->dir = dir;
+}
+
+std::string KernelCacheKey(const std::vector<std::string>& parts) {
+  // 64 bit FNV-1a, the sizes separating the parts.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto update = [&hash](const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ULL;
+    }
+  };
+  for (const std::string& part : parts) {
+    std::string size = std::to_string(part.size()) + ":";
+    update(size.data(), size.size());
+    update(part.data(), part.size());
+  }
+  std::ostringstream os;
+  os << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return os.str();
+}
+
+bool LoadKernelCache(const std::string& key, std::string* data) {
+  std::string dir = GetKernelCacheDir();
+  if (dir.empty()) return false;
+  std::ifstream fs(dir + "/" + key + ".bin", std::ios::in | std::ios::binary);
+  if (fs.fail()) return false;
+  std::ostringstream os;
+  os << fs.rdbuf();
+  *data = os.str();
+  return !fs.bad();
+}
+
+void SaveKernelCache(const std::string& key, const std::string& data) {
+  std::string dir = GetKernelCacheDir();
+  if (dir.empty()) return;
+#ifndef _WIN32
+  mkdir(dir.c_str(), 0755);
+  std::string temp_file = dir + "/" + key + ".tmp." + std::to_string(getpid());
+#else
+  std::string temp_file = dir + "/" + key + ".tmp";
+#endif
+  std::string file_name = dir + "/" + key + ".bin";
+  {
+    std::ofstream fs(temp_file, std::ios::out | std::ios::binary);
+    fs.write(data.data(), data.size());
+    if (fs.fail()) {
+      LOG(WARNING) << "Cannot write the kernel cache entry " << temp_file;
+      fs.close();
+      std::remove(temp_file.c_str());
+      return;
+    }
+  }
+#ifdef _WIN32
+  std::remove(file_name.c_str());
+#endif
+  if (std::rename(temp_file.c_str(), file_name.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write the kernel cache entry " << file_name << ": "
+                 << strerror(errno);
+    std::remove(temp_file.c_str());
+  }
+}
+
+TVM_REGISTER_GLOBAL("runtime.SetKernelCacheDir").set_body_typed([](const String& dir) {
+  SetKernelCacheDir(dir);
+});
+TVM_REGISTER_GLOBAL("runtime.GetKernelCacheDir").set_body_typed([]() {
+  return String(GetKernelCacheDir());
+});
+
+MappedFileObj::~MappedFileObj() {
+#ifndef _WIN32
+  if (mapped_) {
+    munmap(data_, size_);
+  }
+#endif
+}
+
+MappedFile MappedFile::Open(const std::string& file_name) {
+  auto n = make_object<MappedFileObj>();
+#ifndef _WIN32
+  int fd = open(file_name.c_str(), O_RDONLY);
+  ICHECK_GE(fd, 0) << "Failed to open " << file_name << ": " << strerror(errno);
+  struct stat st;
+  ICHECK_EQ(fstat(fd, &st), 0) << "Failed to stat " << file_name << ": " << strerror(errno);
+  n->size_ = static_cast<size_t>(st.st_size);
+  if (n->size_ != 0) {
+    void* ptr = mmap(nullptr, n->size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (ptr != MAP_FAILED) {
+      n->data_ = static_cast<char*>(ptr);
+      n->mapped_ = true;
+    }
+  }
+  close(fd);
+#endif
+  if (!n->mapped_) {
+    LoadBinaryFromFile(file_name, &n->buffer_);
+    n->data_ = &n->buffer_[0];
+    n->size_ = n->buffer_.size();
+  }
+  return MappedFile(std::move(n));
+}
+
+TVM_REGISTER_OBJECT_TYPE(MappedFileObj);
+
+namespace {
+/*! \brief Alignment of a payload of nbytes in the aligned layout. */
+size_t AlignedPayloadAlignment(int64_t nbytes) {
+  constexpr int64_t kPageSize = 4096;
+  return nbytes >= kPageSize ? kPageSize : kAllocAlignment;
+}
+
+/*! \brief Keeps the mapping alive for as long as a view into it exists. */
+struct MappedTensorContext {
+  DLManagedTensor tensor;
+  ObjectRef owner;
+
+  static void Deleter(DLManagedTensor* self) {
+    delete static_cast<MappedTensorContext*>(self->manager_ctx);
+  }
+};
+
+/*! \brief Create a CPU array on top of a payload of a mapped file, which owner keeps alive. */
+NDArray MakeMappedView(const char* payload, DLDataType dtype, const std::vector<int64_t>& shape,
+                       const ObjectRef& owner) {
+  auto* ctx = new MappedTensorContext();
+  ctx->owner = owner;
+  ctx->tensor.manager_ctx = ctx;
+  ctx->tensor.deleter = MappedTensorContext::Deleter;
+  DLTensor& view = ctx->tensor.dl_tensor;
+  view.data = const_cast<char*>(payload);
+  view.device = {kDLCPU, 0};
+  view.ndim = static_cast<int>(shape.size());
+  view.dtype = dtype;
+  view.shape = const_cast<int64_t*>(shape.data());
+  view.strides = nullptr;
+  view.byte_offset = 0;
+  // FromDLPack copies the shape, so the vector may go away afterwards.
+  return NDArray::FromDLPack(&ctx->tensor);
+}
+}  // namespace
+
+size_t SaveAlignedDLTensor(dmlc::Stream* strm, size_t offset, const DLTensor* tensor) {
+  int64_t data_byte_size = GetDataSize(*tensor);
+  // Padding count, then the SaveDLTensor header: magic, reserved, device, ndim, dtype,
+  // shape and data_byte_size.
+  size_t header_bytes = sizeof(uint64_t) * 3 + sizeof(DLDevice) + sizeof(int) +
+                        sizeof(DLDataType) + sizeof(int64_t) * (tensor->ndim + 1);
+  size_t alignment = AlignedPayloadAlignment(data_byte_size);
+  size_t payload = offset + header_bytes;
+  uint64_t padding = (alignment - payload % alignment) % alignment;
+  strm->Write(padding);
+  if (padding != 0) {
+    std::vector<char> zeros(padding, 0);
+    strm->Write(zeros.data(), padding);
+  }
+  SaveDLTensor(strm, tensor);
+  return header_bytes + padding + data_byte_size;
+}
+
+NDArray LoadAlignedDLTensor(dmlc::Stream* strm, const char* base, const ObjectRef& owner) {
+  uint64_t padding;
+  ICHECK(strm->Read(&padding)) << "Invalid DLTensor file format";
+  if (padding != 0) {
+    std::vector<char> skip(padding);
+    ICHECK_EQ(strm->Read(skip.data(), padding), padding) << "Invalid DLTensor file format";
+  }
+  if (base == nullptr || !DMLC_IO_NO_ENDIAN_SWAP) {
+    NDArray ret;
+    ret.Load(strm);
+    return ret;
+  }
+  auto* seek_strm = dynamic_cast<dmlc::SeekStream*>(strm);
+  ICHECK(seek_strm != nullptr) << "Mapped tensors must be loaded from a seekable stream";
+
+  uint64_t header, reserved;
+  ICHECK(strm->Read(&header)) << "Invalid DLTensor file format";
+  ICHECK(strm->Read(&reserved)) << "Invalid DLTensor file format";
+  ICHECK(header == kTVMNDArrayMagic) << "Invalid DLTensor file format";
+  Device dev;
+  int ndim;
+  DLDataType dtype;
+  ICHECK(strm->Read(&dev)) << "Invalid DLTensor file format";
+  ICHECK(strm->Read(&ndim)) << "Invalid DLTensor file format";
+  ICHECK(strm->Read(&dtype)) << "Invalid DLTensor file format";
+  ICHECK_EQ(dev.device_type, kDLCPU) << "Invalid DLTensor device: can only save as CPU tensor";
+  std::vector<int64_t> shape(ndim);
+  if (ndim != 0) {
+    ICHECK(strm->ReadArray(&shape[0], ndim)) << "Invalid DLTensor file format";
+  }
+  int64_t data_byte_size;
+  ICHECK(strm->Read(&data_byte_size)) << "Invalid DLTensor file format";
+  const char* payload = base + seek_strm->Tell();
+  if (reinterpret_cast<uintptr_t>(payload) % kAllocAlignment != 0) {
+    // The file was written with a different base; fall back to a copy.
+    NDArray ret = NDArray::Empty(ShapeTuple(shape), dtype, dev);
+    ICHECK_EQ(data_byte_size, GetDataSize(*ret.operator->())) << "Invalid DLTensor file format";
+    ICHECK(strm->Read(ret->data, data_byte_size)) << "Invalid DLTensor file format";
+    return ret;
+  }
+  NDArray ret = MakeMappedView(payload, dtype, shape, owner);
+  ICHECK_EQ(data_byte_size, GetDataSize(*ret.operator->())) << "Invalid DLTensor file format";
+  seek_strm->Seek(seek_strm->Tell() + data_byte_size);
+  return ret;
+}
+
 Map<String, NDArray> LoadParams(const std::string& param_blob) {
   dmlc::MemoryStringStream strm(const_cast<std::string*>(&param_blob));
   return LoadParams(&strm);
 }
-Map<String, NDArray> LoadParams(dmlc::Stream* strm) {
+
+namespace {
+// The bytes taken by the magic, the reserved word, the count and the table of an indexed list.
+size_t IndexedHeaderBytes(const std::vector<ParamsIndexEntry>& entries) {
+  size_t nbytes = sizeof(uint64_t) * 3;
+  for (const ParamsIndexEntry& entry : entries) {
+    nbytes += sizeof(uint64_t) + entry.name.size() + sizeof(DLDataType) + sizeof(int32_t) +
+              sizeof(int64_t) * entry.shape.size() + sizeof(uint64_t) * 2;
+  }
+  return nbytes;
+}
+
+// Read the table of an indexed list, which follows its magic and reserved word.
+std::vector<ParamsIndexEntry> LoadParamsIndex(dmlc::Stream* strm) {
+  uint64_t count;
+  ICHECK(strm->Read(&count)) << "Invalid parameters file format";
+  std::vector<ParamsIndexEntry> entries(count);
+  for (ParamsIndexEntry& entry : entries) {
+    int32_t ndim;
+    ICHECK(strm->Read(&entry.name)) << "Invalid parameters file format";
+    ICHECK(strm->Read(&entry.dtype)) << "Invalid parameters file format";
+    ICHECK(strm->Read(&ndim) && ndim >= 0) << "Invalid parameters file format";
+    entry.shape.resize(ndim);
+    if (ndim != 0) {
+      ICHECK(strm->ReadArray(&entry.shape[0], ndim)) << "Invalid parameters file format";
+    }
+    ICHECK(strm->Read(&entry.offset)) << "Invalid parameters file format";
+    ICHECK(strm->Read(&entry.nbytes)) << "Invalid parameters file format";
+  }
+  // the payloads follow the table, in order and without overlap
+  uint64_t end = IndexedHeaderBytes(entries);
+  for (const ParamsIndexEntry& entry : entries) {
+    int64_t num_elems = 1;
+    for (int64_t dim : entry.shape) num_elems *= dim;
+    ICHECK_EQ(entry.nbytes, num_elems * ((entry.dtype.bits * entry.dtype.lanes + 7) / 8))
+        << "Invalid parameters file format";
+    ICHECK_GE(entry.offset, end) << "Invalid parameters file format";
+    end = entry.offset + entry.nbytes;
+  }
+  return entries;
+}
+
+// Copy the payload of an indexed entry into a new CPU array.
+NDArray CopyIndexedPayload(const ParamsIndexEntry& entry, const char* payload) {
+  NDArray ret = NDArray::Empty(ShapeTuple(entry.shape), entry.dtype, {kDLCPU, 0});
+  std::memcpy(ret->data, payload, entry.nbytes);
+  if (!DMLC_IO_NO_ENDIAN_SWAP) {
+    int elem_bytes = (entry.dtype.bits + 7) / 8;
+    dmlc::ByteSwap(ret->data, elem_bytes, entry.nbytes / elem_bytes);
+  }
+  return ret;
+}
+
+// Load the tensors of an indexed list from a stream, positioned after the table.
+Map<String, NDArray> LoadIndexedParams(dmlc::Stream* strm,
+                                       const std::vector<ParamsIndexEntry>& entries) {
+  Map<String, NDArray> params;
+  uint64_t pos = IndexedHeaderBytes(entries);
+  std::vector<char> buffer;
+  for (const ParamsIndexEntry& entry : entries) {
+    buffer.resize(std::max<uint64_t>(entry.offset - pos, entry.nbytes));
+    // skip the padding, the stream may not be seekable
+    ICHECK_EQ(strm->Read(buffer.data(), entry.offset - pos), entry.offset - pos)
+        << "Invalid parameters file format";
+    ICHECK_EQ(strm->Read(buffer.data(), entry.nbytes), entry.nbytes)
+        << "Invalid parameters file format";
+    params.Set(entry.name, CopyIndexedPayload(entry, buffer.data()));
+    pos = entry.offset + entry.nbytes;
+  }
+  return params;
+}
+
+Map<String, NDArray> LoadParams(dmlc::Stream* strm, const char* base, const ObjectRef& owner) {
   Map<String, NDArray> params;
   uint64_t header, reserved;
   ICHECK(strm->Read(&header)) << "Invalid parameters file format";
-  ICHECK(header == kTVMNDArrayListMagic) << "Invalid parameters file format";
+  ICHECK(header == kTVMNDArrayListMagic || header == kTVMNDArrayListAlignedMagic ||
+         header == kTVMNDArrayListIndexedMagic)
+      << "Invalid parameters file format";
   ICHECK(strm->Read(&reserved)) << "Invalid parameters file format";
+  if (header == kTVMNDArrayListIndexedMagic) {
+    return LoadIndexedParams(strm, LoadParamsIndex(strm));
+  }
 
   std::vector<std::string> names;
   ICHECK(strm->Read(&names)) << "Invalid parameters file format";
@@ -181,13 +506,44 @@ Map<String, NDArray> LoadParams(dmlc::Stream* strm) {
   for (size_t i = 0; i < size; ++i) {
     // The data_entry is allocated on device, NDArray.load always load the array into CPU.
     NDArray temp;
-    temp.Load(strm);
+    if (header == kTVMNDArrayListAlignedMagic) {
+      temp = LoadAlignedDLTensor(strm, base, owner);
+    } else {
+      temp.Load(strm);
+    }
     params.Set(names[i], temp);
   }
   return params;
 }
+}  // namespace
 
-void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params) {
+Map<String, NDArray> LoadParams(dmlc::Stream* strm) {
+  return LoadParams(strm, nullptr, ObjectRef());
+}
+
+Map<String, NDArray> LoadParamsFromFile(const std::string& file_name) {
+  return ParamsFile::Open(file_name)->Load({}, {kDLCPU, 0});
+}
+
+std::vector<std::string> LoadParamNames(dmlc::Stream* strm) {
+  uint64_t header, reserved;
+  ICHECK(strm->Read(&header)) << "Invalid parameters file format";
+  ICHECK(header == kTVMNDArrayListMagic || header == kTVMNDArrayListAlignedMagic ||
+         header == kTVMNDArrayListIndexedMagic)
+      << "Invalid parameters file format";
+  ICHECK(strm->Read(&reserved)) << "Invalid parameters file format";
+  std::vector<std::string> names;
+  if (header == kTVMNDArrayListIndexedMagic) {
+    for (const ParamsIndexEntry& entry : LoadParamsIndex(strm)) {
+      names.push_back(entry.name);
+    }
+  } else {
+    ICHECK(strm->Read(&names)) << "Invalid parameters file format";
+  }
+  return names;
+}
+
+void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params, bool aligned) {
   std::vector<std::string> names;
   std::vector<const DLTensor*> arrays;
   for (auto& p : params) {
@@ -195,37 +551,307 @@ void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params) {
     arrays.push_back(p.second.operator->());
   }
 
-  uint64_t header = kTVMNDArrayListMagic, reserved = 0;
+  uint64_t header = aligned ? kTVMNDArrayListAlignedMagic : kTVMNDArrayListMagic, reserved = 0;
   strm->Write(header);
   strm->Write(reserved);
   strm->Write(names);
+  // Track the offset of each record so the aligned layout can pad relative to the file start.
+  size_t offset = sizeof(uint64_t) * 4;
+  for (const auto& name : names) {
+    offset += sizeof(uint64_t) + name.size();
+  }
   {
     uint64_t sz = static_cast<uint64_t>(arrays.size());
     strm->Write(sz);
     for (size_t i = 0; i < sz; ++i) {
-      tvm::runtime::SaveDLTensor(strm, arrays[i]);
+      if (aligned) {
+        offset += SaveAlignedDLTensor(strm, offset, arrays[i]);
+      } else {
+        tvm::runtime::SaveDLTensor(strm, arrays[i]);
+      }
     }
   }
 }
 
-std::string SaveParams(const Map<String, NDArray>& params) {
+std::string SaveParams(const Map<String, NDArray>& params, bool aligned) {
   std::string bytes;
   dmlc::MemoryStringStream strm(&bytes);
   dmlc::Stream* fo = &strm;
-  SaveParams(fo, params);
+  SaveParams(fo, params, aligned);
   return bytes;
 }
 
-TVM_REGISTER_GLOBAL("runtime.SaveParams").set_body_typed([](const Map<String, NDArray>& params) {
-  std::string s = ::tvm::runtime::SaveParams(params);
+void SaveIndexedParams(dmlc::Stream* strm, const Map<String, NDArray>& params) {
+  std::vector<ParamsIndexEntry> entries;
+  std::vector<NDArray> arrays;
+  for (auto& p : params) {
+    NDArray array = p.second;
+    if (array->device.device_type != kDLCPU || !array.IsContiguous()) {
+      array = array.CopyTo({kDLCPU, 0});
+    }
+    ParamsIndexEntry entry;
+    entry.name = p.first;
+    entry.dtype = array->dtype;
+    entry.shape.assign(array->shape, array->shape + array->ndim);
+    entry.nbytes = GetDataSize(*array.operator->());
+    entries.push_back(entry);
+    arrays.push_back(array);
+  }
+  uint64_t offset = IndexedHeaderBytes(entries);
+  for (ParamsIndexEntry& entry : entries) {
+    size_t alignment = AlignedPayloadAlignment(entry.nbytes);
+    entry.offset = (offset + alignment - 1) / alignment * alignment;
+    offset = entry.offset + entry.nbytes;
+  }
+
+  uint64_t header = kTVMNDArrayListIndexedMagic, reserved = 0;
+  strm->Write(header);
+  strm->Write(reserved);
+  strm->Write(static_cast<uint64_t>(entries.size()));
+  for (const ParamsIndexEntry& entry : entries) {
+    strm->Write(entry.name);
+    strm->Write(entry.dtype);
+    strm->Write(static_cast<int32_t>(entry.shape.size()));
+    strm->WriteArray(entry.shape.data(), entry.shape.size());
+    strm->Write(entry.offset);
+    strm->Write(entry.nbytes);
+  }
+  uint64_t pos = IndexedHeaderBytes(entries);
+  std::vector<char> zeros;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    zeros.assign(entries[i].offset - pos, 0);
+    strm->Write(zeros.data(), zeros.size());
+    const char* data = static_cast<const char*>(arrays[i]->data) + arrays[i]->byte_offset;
+    if (DMLC_IO_NO_ENDIAN_SWAP) {
+      strm->Write(data, entries[i].nbytes);
+    } else {
+      std::vector<char> bytes(data, data + entries[i].nbytes);
+      int elem_bytes = (entries[i].dtype.bits + 7) / 8;
+      dmlc::ByteSwap(bytes.data(), elem_bytes, entries[i].nbytes / elem_bytes);
+      strm->Write(bytes.data(), bytes.size());
+    }
+    pos = entries[i].offset + entries[i].nbytes;
+  }
+}
+
+std::string SaveIndexedParams(const Map<String, NDArray>& params) {
+  std::string bytes;
+  dmlc::MemoryStringStream strm(&bytes);
+  SaveIndexedParams(&strm, params);
+  return bytes;
+}
+
+ParamsFile ParamsFile::Open(const std::string& file_name) {
+  MappedFile file = MappedFile::Open(file_name);
+  auto n = make_object<ParamsFileObj>();
+  n->file_ = file;
+  n->data_ = file->data();
+  dmlc::MemoryFixedSizeStream strm(const_cast<char*>(file->data()), file->size());
+  uint64_t header = 0;
+  ICHECK(strm.Read(&header)) << "Invalid parameters file format";
+  strm.Seek(0);
+  if (header == kTVMNDArrayListIndexedMagic) {
+    // only the table is read, the payloads are paged in when they are used
+    strm.Seek(sizeof(uint64_t) * 2);
+    n->indexed_ = true;
+    n->entries_ = LoadParamsIndex(&strm);
+    for (size_t i = 0; i < n->entries_.size(); ++i) {
+      const ParamsIndexEntry& entry = n->entries_[i];
+      ICHECK_LE(entry.offset + entry.nbytes, file->size()) << "Truncated parameters file";
+      ICHECK(n->index_.emplace(entry.name, i).second) << "Duplicated parameter " << entry.name;
+    }
+  } else {
+    n->names_ = LoadParamNames(&strm);
+    strm.Seek(0);
+    n->loaded_ = LoadParams(&strm, file->data(), file);
+  }
+  return ParamsFile(std::move(n));
+}
+
+Array<String> ParamsFileObj::GetNames() const {
+  Array<String> names;
+  if (indexed_) {
+    for (const ParamsIndexEntry& entry : entries_) names.push_back(entry.name);
+  } else {
+    for (const std::string& name : names_) names.push_back(name);
+  }
+  return names;
+}
+
+NDArray ParamsFileObj::Get(const std::string& name) const {
+  if (!indexed_) {
+    auto it = loaded_.find(name);
+    ICHECK(it != loaded_.end()) << "Unknown parameter " << name;
+    return (*it).second;
+  }
+  auto it = index_.find(name);
+  ICHECK(it != index_.end()) << "Unknown parameter " << name;
+  const ParamsIndexEntry& entry = entries_[it->second];
+  const char* payload = data_ + entry.offset;
+  if (DMLC_IO_NO_ENDIAN_SWAP && reinterpret_cast<uintptr_t>(payload) % kAllocAlignment == 0) {
+    return MakeMappedView(payload, entry.dtype, entry.shape, file_);
+  }
+  return CopyIndexedPayload(entry, payload);
+}
+
+namespace {
+/*! \brief The maximum number of streams the copies to one device are spread on. */
+constexpr size_t kMaxUploadStreams = 4;
+/*! \brief The size of the pinned buffers the host tensors are staged in. */
+constexpr size_t kUploadChunkBytes = 4 << 20;
+
+/*! \brief The copies made on one stream of a device, in order. */
+struct UploadQueue {
+  Device dev;
+  std::vector<std::pair<NDArray, NDArray>> copies;
+  size_t nbytes{0};
+
+  void Run() const {
+    DeviceAPI* api = DeviceAPI::Get(dev);
+    TVMStreamHandle stream = api->CreateStream(dev);
+    // two pinned buffers, the next chunk is read in one while the other is transferred
+    void* staging[2] = {nullptr, nullptr};
+    if (dev.device_type != kDLCPU) {
+      staging[0] = api->AllocPinnedHostSpace(dev, kUploadChunkBytes);
+      staging[1] = staging[0] ? api->AllocPinnedHostSpace(dev, kUploadChunkBytes) : nullptr;
+    }
+    int slot = 0;
+    for (const auto& copy : copies) {
+      DLTensor* from = const_cast<DLTensor*>(copy.first.operator->());
+      DLTensor* to = const_cast<DLTensor*>(copy.second.operator->());
+      if (staging[1] == nullptr || from->device.device_type != kDLCPU) {
+        api->CopyDataFromTo(from, to, stream);
+        continue;
+      }
+      ICHECK(IsContiguous(*from) && IsContiguous(*to))
+          << "UploadParams only supports contiguous arrays";
+      size_t nbytes = GetDataSize(*from);
+      ICHECK_EQ(nbytes, GetDataSize(*to));
+      const char* data = static_cast<const char*>(from->data) + from->byte_offset;
+      for (size_t offset = 0; offset < nbytes; offset += kUploadChunkBytes) {
+        int64_t chunk = std::min(kUploadChunkBytes, nbytes - offset);
+        std::memcpy(staging[slot], data + offset, chunk);
+        // the previous chunk must be out of the buffer the next one is read into
+        api->StreamSync(dev, stream);
+        DLTensor chunk_from{staging[slot], {kDLCPU, 0}, 1, {kDLUInt, 8, 1}, &chunk, nullptr, 0};
+        DLTensor chunk_to{to->data, to->device, 1, {kDLUInt, 8, 1}, &chunk, nullptr,
+                          to->byte_offset + offset};
+        api->CopyDataFromTo(&chunk_from, &chunk_to, stream);
+        slot = 1 - slot;
+      }
+    }
+    api->StreamSync(dev, stream);
+    for (void* buffer : staging) {
+      if (buffer != nullptr) api->FreePinnedHostSpace(dev, buffer);
+    }
+    api->FreeStream(dev, stream);
+  }
+};
+
+/*! \brief The queues run by the tasks of a parallel launch. */
+struct ParamsUpload {
+  std::vector<UploadQueue> queues;
+
+  static int Task(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+    auto* upload = static_cast<ParamsUpload*>(cdata);
+    try {
+      for (size_t i = task_id; i < upload->queues.size(); i += penv->num_task) {
+        upload->queues[i].Run();
+      }
+    } catch (const std::exception& e) {
+      TVMAPISetLastError(e.what());
+      return -1;
+    }
+    return 0;
+  }
+};
+}  // namespace
+
+void UploadParams(const std::vector<NDArray>& src, const std::vector<NDArray>& dst) {
+  ICHECK_EQ(src.size(), dst.size());
+  // the largest copies first, each to the least loaded stream of its device
+  std::vector<size_t> order(src.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return GetDataSize(*src[a].operator->()) > GetDataSize(*src[b].operator->());
+  });
+  std::unordered_map<int64_t, std::vector<size_t>> device_queues;
+  ParamsUpload upload;
+  for (size_t i : order) {
+    ICHECK_EQ(GetDataSize(*src[i].operator->()), GetDataSize(*dst[i].operator->()))
+        << "UploadParams: the source and destination sizes differ";
+    Device dev = dst[i]->device;
+    std::vector<size_t>& queues = device_queues[static_cast<int64_t>(dev.device_type) << 32 |
+                                                static_cast<uint32_t>(dev.device_id)];
+    if (queues.size() < std::min(kMaxUploadStreams, src.size())) {
+      queues.push_back(upload.queues.size());
+      upload.queues.push_back(UploadQueue{dev, {}, 0});
+    }
+    UploadQueue* queue = &upload.queues[queues[0]];
+    for (size_t q : queues) {
+      if (upload.queues[q].nbytes < queue->nbytes) queue = &upload.queues[q];
+    }
+    queue->copies.emplace_back(src[i], dst[i]);
+    queue->nbytes += GetDataSize(*src[i].operator->());
+  }
+  if (upload.queues.size() == 1) {
+    upload.queues[0].Run();
+    return;
+  }
+  ICHECK_EQ(TVMBackendParallelLaunch(ParamsUpload::Task, &upload, 0), 0) << TVMGetLastError();
+}
+
+Map<String, NDArray> ParamsFileObj::Load(const Array<String>& names, Device dev) const {
+  Array<String> selected = names.empty() ? GetNames() : names;
+  std::vector<NDArray> values;
+  for (const String& name : selected) {
+    values.push_back(Get(name));
+  }
+  if (dev.device_type != kDLCPU) {
+    // the pages of the mapped file are read by the tasks that copy them
+    std::vector<NDArray> uploaded;
+    for (const NDArray& value : values) {
+      uploaded.push_back(NDArray::Empty(value.Shape(), value.DataType(), dev));
+    }
+    UploadParams(values, uploaded);
+    values = std::move(uploaded);
+  }
+  Map<String, NDArray> params;
+  for (size_t i = 0; i < values.size(); ++i) {
+    params.Set(selected[i], values[i]);
+  }
+  return params;
+}
+
+TVM_REGISTER_OBJECT_TYPE(ParamsFileObj);
+
+TVM_REGISTER_GLOBAL("runtime.SaveParams").set_body([](TVMArgs args, TVMRetValue* rv) {
+  Map<String, NDArray> params = args[0];
+  bool aligned = args.num_args > 1 ? static_cast<bool>(args[1]) : false;
+  bool indexed = args.num_args > 2 ? static_cast<bool>(args[2]) : false;
+  std::string s = indexed ? ::tvm::runtime::SaveIndexedParams(params)
+                          : ::tvm::runtime::SaveParams(params, aligned);
   // copy return array so it is owned by the ret value
-  TVMRetValue rv;
-  rv = TVMByteArray{s.data(), s.size()};
-  return rv;
+  *rv = TVMByteArray{s.data(), s.size()};
 });
 TVM_REGISTER_GLOBAL("runtime.LoadParams").set_body_typed([](const String& s) {
   return ::tvm::runtime::LoadParams(s);
 });
+TVM_REGISTER_GLOBAL("runtime.LoadParamsFromFile").set_body_typed([](const String& file_name) {
+  return ::tvm::runtime::LoadParamsFromFile(file_name);
+});
+TVM_REGISTER_GLOBAL("runtime.ParamsFileOpen").set_body_typed([](const String& file_name) {
+  return ParamsFile::Open(file_name);
+});
+TVM_REGISTER_GLOBAL("runtime.ParamsFileGetNames").set_body_typed([](const ParamsFile& file) {
+  return file->GetNames();
+});
+TVM_REGISTER_GLOBAL("runtime.ParamsFileGet")
+    .set_body_typed([](const ParamsFile& file, const String& name) { return file->Get(name); });
+TVM_REGISTER_GLOBAL("runtime.ParamsFileLoad")
+    .set_body_typed([](const ParamsFile& file, const Array<String>& names, Device dev) {
+      return file->Load(names, dev);
+    });
 
 }  // namespace runtime
 }  // namespace tvm
@@ -24,11 +24,16 @@
 #ifndef TVM_RUNTIME_FILE_UTILS_H_
 #define TVM_RUNTIME_FILE_UTILS_H_
 
+#include <dmlc/io.h>
+#include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/object.h>
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "meta_data.h"
 
@@ -96,7 +101,129 @@ void LoadMetaDataFromFile(const std::string& file_name,
  */
 void RemoveFile(const std::string& file_name);
 
+/*!
+ * \brief Get the directory of the kernel binary cache.
+ *
+ * The device runtimes store the kernels compiled by their drivers there, so that a later
+ * process can load them instead of compiling again.  It is initialized from the
+ * TVM_KERNEL_CACHE_DIR environment variable and may be changed by the application with
+ * the runtime.SetKernelCacheDir global function.
+ * \return The directory, empty when the cache is disabled.
+ */
+std::string GetKernelCacheDir();
+
+/*!
+ * \brief Set the directory of the kernel binary cache.
+ * \param dir The directory, created when missing, or empty to disable the cache.
+ */
+void SetKernelCacheDir(const std::string& dir);
+
+/*!
+ * \brief Compute the key of a kernel cache entry.
+ * \param parts The values the entry depends on, such as the device, the driver version
+ *        and the kernel source.
+ * \return A hash of the parts, stable across processes and platforms.
+ */
+std::string KernelCacheKey(const std::vector<std::string>& parts);
+
+/*!
+ * \brief Load an entry of the kernel binary cache.
+ * \param key The key of the entry, see KernelCacheKey.
+ * \param data The content of the entry.
+ * \return Whether the cache is enabled and has the entry.
+ */
+bool LoadKernelCache(const std::string& key, std::string* data);
+
+/*!
+ * \brief Save an entry of the kernel binary cache, when the cache is enabled.
+ *
+ * The entry is written to a temporary file renamed over the previous one, so concurrent
+ * processes never read a partial entry.  Failures only log a warning, the cache being
+ * an optimization.
+ * \param key The key of the entry, see KernelCacheKey.
+ * \param data The content of the entry.
+ */
+void SaveKernelCache(const std::string& key, const std::string& data);
+
+/*!
+ * \brief A read-only view of a whole file, memory mapped when the platform allows it.
+ *
+ * The mapping is private and copy-on-write, so arrays created on top of it may be
+ * written without touching the file. Platforms without mmap fall back to reading
+ * the file into a heap buffer.
+ */
+class MappedFileObj : public Object {
+ public:
+  ~MappedFileObj();
+  /*! \return The first byte of the file. */
+  const char* data() const { return data_; }
+  /*! \return The size of the file in bytes. */
+  size_t size() const { return size_; }
+  /*! \return Whether the bytes are backed by a memory mapping. */
+  bool is_mapped() const { return mapped_; }
+
+  static constexpr const char* _type_key = "runtime.MappedFile";
+  TVM_DECLARE_FINAL_OBJECT_INFO(MappedFileObj, Object);
+
+ private:
+  char* data_{nullptr};
+  size_t size_{0};
+  bool mapped_{false};
+  /*! \brief Backing storage when the file could not be mapped. */
+  std::string buffer_;
+
+  friend class MappedFile;
+};
+
+/*! \brief Managed reference to MappedFileObj. */
+class MappedFile : public ObjectRef {
+ public:
+  /*!
+   * \brief Map a file into memory.
+   * \param file_name The name of the file.
+   */
+  static MappedFile Open(const std::string& file_name);
+
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(MappedFile, ObjectRef, MappedFileObj);
+};
+
+/*!
+ * \brief Save a tensor so that its payload starts at an aligned offset.
+ *
+ * The record is a uint64 count of padding bytes, the zero padding and a regular
+ * SaveDLTensor record. Payloads of at least a page are page aligned, smaller ones
+ * are aligned to kAllocAlignment, so they can be used in place once mapped.
+ * \param strm The output stream.
+ * \param offset Offset of the record from the start of the file.
+ * \param tensor The tensor to save.
+ * \return The number of bytes written.
+ */
+size_t SaveAlignedDLTensor(dmlc::Stream* strm, size_t offset, const DLTensor* tensor);
+
+/*!
+ * \brief Load a record written by SaveAlignedDLTensor.
+ * \param strm The input stream.
+ * \param base When not null, strm must be a dmlc::SeekStream whose offset zero is base.
+ *        Host payloads that are suitably aligned are then returned as views into it
+ *        instead of being copied.
+ * \param owner The object that keeps base alive; it is retained by every view.
+ * \return The loaded array.
+ */
+NDArray LoadAlignedDLTensor(dmlc::Stream* strm, const char* base = nullptr,
+                            const ObjectRef& owner = ObjectRef());
+
 constexpr uint64_t kTVMNDArrayListMagic = 0xF7E58D4F05049CB7;
+/*! \brief Magic of parameter lists whose tensors are saved with SaveAlignedDLTensor. */
+constexpr uint64_t kTVMNDArrayListAlignedMagic = 0xF7E58D4F05049CB8;
+/*!
+ * \brief Magic of indexed parameter lists, see SaveIndexedParams.
+ *
+ * The magic and a reserved word are followed by the number of tensors and a table with
+ * the name, dtype, ndim, shape, offset from the start of the file and size in bytes of
+ * each tensor. The payloads come after the table in the same order, aligned like the ones
+ * of SaveAlignedDLTensor.
+ */
+constexpr uint64_t kTVMNDArrayListIndexedMagic = 0xF7E58D4F05049CB9;
 /*!
  * \brief Load parameters from a string.
  * \param param_blob Serialized string of parameters.
@@ -109,18 +236,125 @@ Map<String, NDArray> LoadParams(const std::string& param_blob);
  * \return Map of parameter name to parameter value.
  */
 Map<String, NDArray> LoadParams(dmlc::Stream* strm);
+/*!
+ * \brief Load parameters from a file without reading it into memory first.
+ *
+ * Parameters saved with the aligned layout are returned as views into the
+ * memory mapped file; the legacy layout is copied as LoadParams does.
+ * \param file_name The name of the file.
+ * \return Map of parameter name to parameter value.
+ */
+Map<String, NDArray> LoadParamsFromFile(const std::string& file_name);
 /*!
  * \brief Serialize parameters to a byte array.
  * \param params Parameters to save.
+ * \param aligned Whether to use the aligned layout that LoadParamsFromFile can map.
  * \return String containing binary parameter data.
  */
-std::string SaveParams(const Map<String, NDArray>& params);
+std::string SaveParams(const Map<String, NDArray>& params, bool aligned = false);
 /*!
  * \brief Serialize parameters to a stream.
- * \param strm Stream to write to.
+ * \param strm Stream to write to, positioned at the start of the file.
+ * \param params Parameters to save.
+ * \param aligned Whether to use the aligned layout that LoadParamsFromFile can map.
+ */
+void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params, bool aligned = false);
+/*!
+ * \brief Serialize parameters with the indexed layout, whose tensors can be read one by one.
+ * \param strm Stream to write to, positioned at the start of the file.
  * \param params Parameters to save.
  */
-void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params);
+void SaveIndexedParams(dmlc::Stream* strm, const Map<String, NDArray>& params);
+/*!
+ * \brief Serialize parameters with the indexed layout to a byte array.
+ * \param params Parameters to save.
+ * \return String containing binary parameter data.
+ */
+std::string SaveIndexedParams(const Map<String, NDArray>& params);
+/*!
+ * \brief Read the names of a parameter list of any layout, leaving the tensors unread.
+ * \param strm Stream positioned at the start of the parameters.
+ * \return The names, in the order of the tensors.
+ */
+std::vector<std::string> LoadParamNames(dmlc::Stream* strm);
+/*!
+ * \brief Copy parameters into tensors of their devices, overlapping the copies.
+ *
+ *  The copies to a device are spread on a few of its streams, each run by a task of the
+ *  runtime thread pool. When the device has pinned host memory, host tensors are staged
+ *  in chunks through two pinned buffers, so that reading a chunk, possibly from a mapped
+ *  file, overlaps with the transfer of the previous one. Returns once all copies are done.
+ *
+ * \param src The source tensors.
+ * \param dst The destination tensors, of the same sizes as the sources.
+ */
+void UploadParams(const std::vector<NDArray>& src, const std::vector<NDArray>& dst);
+
+/*!
+ * \brief A parameter file opened for random access.
+ *
+ * Only the table of an indexed file is read on open, its tensors are views into the memory
+ * mapped file, whose pages are read on first access. The files of the other layouts are
+ * loaded whole on open.
+ */
+/*! \brief An entry of the table of an indexed parameter list. */
+struct ParamsIndexEntry {
+  std::string name;
+  DLDataType dtype;
+  std::vector<int64_t> shape;
+  /*! \brief The offset of the payload from the start of the parameters, and its size. */
+  uint64_t offset;
+  uint64_t nbytes;
+};
+
+class ParamsFileObj : public Object {
+ public:
+  /*! \return The names of the parameters, in the order of the file. */
+  Array<String> GetNames() const;
+  /*!
+   * \brief Get one parameter, in place in the file when it is mapped and aligned.
+   * \param name The name of the parameter.
+   * \return The parameter, on the CPU.
+   */
+  NDArray Get(const std::string& name) const;
+  /*!
+   * \brief Load some of the parameters onto a device, uploaded in parallel.
+   * \param names The names of the parameters, all of them when empty.
+   * \param dev The device. The CPU parameters are returned in place, as Get does.
+   * \return Map of parameter name to parameter value.
+   */
+  Map<String, NDArray> Load(const Array<String>& names, Device dev) const;
+
+  static constexpr const char* _type_key = "runtime.ParamsFile";
+  TVM_DECLARE_FINAL_OBJECT_INFO(ParamsFileObj, Object);
+
+ private:
+  /*! \brief The mapped file, and its bytes. */
+  ObjectRef file_;
+  const char* data_{nullptr};
+  /*! \brief Whether the file has the indexed layout. */
+  bool indexed_{false};
+  /*! \brief The table of an indexed file, and the index of each name in it. */
+  std::vector<ParamsIndexEntry> entries_;
+  std::unordered_map<std::string, size_t> index_;
+  /*! \brief The names and the parameters of the files of the other layouts. */
+  std::vector<std::string> names_;
+  Map<String, NDArray> loaded_;
+
+  friend class ParamsFile;
+};
+
+/*! \brief Managed reference to ParamsFileObj. */
+class ParamsFile : public ObjectRef {
+ public:
+  /*!
+   * \brief Open a parameter file.
+   * \param file_name The name of the file.
+   */
+  static ParamsFile Open(const std::string& file_name);
+
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(ParamsFile, ObjectRef, ParamsFileObj);
+};
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_FILE_UTILS_H_
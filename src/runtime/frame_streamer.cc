@@ -0,0 +1,120 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file frame_streamer.cc
+ * \brief Runs an executor on a stream of frames, with several frames in flight.
+ */
+#include "frame_streamer.h"
+
+#include <tvm/runtime/logging.h>
+
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+
+FrameStreamer::FrameStreamer(int num_buffers, const std::vector<NDArray>& inputs,
+                             const std::vector<NDArray>& outputs, FRun frun)
+    : frun_(std::move(frun)) {
+  // the outputs popped last keep their slot, so one slot is left for the next frame
+  ICHECK_GE(num_buffers, 2) << "FrameStreamer: streaming needs at least 2 buffers";
+  slots_.resize(num_buffers);
+  for (Slot& slot : slots_) {
+    for (const NDArray& input : inputs) {
+      slot.inputs.push_back(NDArray::Empty(input.Shape(), input.DataType(), input->device));
+    }
+    for (const NDArray& output : outputs) {
+      slot.outputs.push_back(NDArray::Empty(output.Shape(), output.DataType(), output->device));
+    }
+  }
+  worker_ = std::thread([this]() { this->WorkerLoop(); });
+}
+
+FrameStreamer::~FrameStreamer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+void FrameStreamer::Push(const std::vector<const DLTensor*>& inputs) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this]() { return pushed_ - released_ < slots_.size() || !error_.empty(); });
+  if (!error_.empty()) {
+    LOG(FATAL) << "FrameStreamer: a previous frame failed: " << error_;
+  }
+  Slot& slot = slots_[pushed_ % slots_.size()];
+  lock.unlock();
+  // the slot is only used by this thread until the frame is pushed
+  ICHECK_EQ(inputs.size(), slot.inputs.size()) << "FrameStreamer: wrong number of inputs";
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    slot.inputs[i].CopyFrom(inputs[i]);
+  }
+  lock.lock();
+  ++pushed_;
+  lock.unlock();
+  cv_.notify_all();
+}
+
+Array<NDArray> FrameStreamer::Pop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  ICHECK_LT(popped_, pushed_) << "FrameStreamer: no frame pushed to pop";
+  released_ = popped_;
+  cv_.notify_all();
+  cv_.wait(lock, [this]() { return computed_ > popped_ || !error_.empty(); });
+  if (!error_.empty()) {
+    LOG(FATAL) << "FrameStreamer: the frame failed: " << error_;
+  }
+  const Slot& slot = slots_[popped_ % slots_.size()];
+  ++popped_;
+  return Array<NDArray>(slot.outputs.begin(), slot.outputs.end());
+}
+
+void FrameStreamer::WorkerLoop() {
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return computed_ < pushed_ || stop_; });
+    if (computed_ == pushed_) return;
+    const Slot& slot = slots_[computed_ % slots_.size()];
+    lock.unlock();
+    std::string error;
+    try {
+      frun_(slot.inputs, slot.outputs);
+    } catch (const std::exception& err) {
+      error = err.what();
+    }
+    lock.lock();
+    if (!error.empty()) {
+      error_ = error;
+      stop_ = true;
+    } else {
+      ++computed_;
+    }
+    lock.unlock();
+    cv_.notify_all();
+    if (!error.empty()) return;
+  }
+}
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,117 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file frame_streamer.h
+ * \brief Runs an executor on a stream of frames, with several frames in flight.
+ */
+#ifndef TVM_RUNTIME_FRAME_STREAMER_H_
+#define TVM_RUNTIME_FRAME_STREAMER_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Runs an executor on the frames of a stream, such as camera images or audio windows.
+ *
+ *  The frames take in turn one of num_buffers sets of input and output tensors. A worker
+ *  thread runs the executor on the frames in their order while the caller copies the next
+ *  frames in, so the copies overlap the runs. The outputs of a frame are read back in the
+ *  same order, and stay valid until the next Pop, after which their set is reused.
+ */
+class FrameStreamer {
+ public:
+  /*!
+   * \brief Run the executor on the tensors of a frame, binding them without copy.
+   *
+   *  Called on the worker thread, it returns once the outputs are written.
+   */
+  using FRun =
+      std::function<void(const std::vector<NDArray>& inputs, const std::vector<NDArray>& outputs)>;
+
+  /*!
+   * \brief Allocate the tensor sets and start the worker thread.
+   * \param num_buffers The number of tensor sets, at least 2.
+   * \param inputs The tensors giving the shape, type and device of the streamed inputs.
+   * \param outputs The tensors giving the shape, type and device of the outputs.
+   * \param frun The function running the executor.
+   */
+  FrameStreamer(int num_buffers, const std::vector<NDArray>& inputs,
+                const std::vector<NDArray>& outputs, FRun frun);
+
+  /*! \brief Wait for the frames pushed and stop the worker thread. */
+  ~FrameStreamer();
+
+  /*!
+   * \brief Copy the inputs of the next frame, waiting while all the tensor sets are in use.
+   *
+   *  Only Pop gives a set back, so a caller pushing and popping from one thread keeps at
+   *  most num_buffers - 1 frames pushed and not popped.
+   * \param inputs One tensor per streamed input.
+   */
+  void Push(const std::vector<const DLTensor*>& inputs);
+
+  /*!
+   * \brief Wait for the oldest frame not read back yet.
+   * \return Its outputs, valid until the next Pop.
+   */
+  Array<NDArray> Pop();
+
+ private:
+  /*! \brief The tensors of one frame. */
+  struct Slot {
+    std::vector<NDArray> inputs;
+    std::vector<NDArray> outputs;
+  };
+
+  void WorkerLoop();
+
+  FRun frun_;
+  std::vector<Slot> slots_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // The frames are numbered by their push, frame i using slots_[i % slots_.size()].
+  // The frames before released_ gave their slot back, the one before popped_ is read by
+  // the caller, the ones before computed_ are done, and the ones before pushed_ were pushed.
+  uint64_t released_{0};
+  uint64_t popped_{0};
+  uint64_t computed_{0};
+  uint64_t pushed_{0};
+  /*! \brief Whether the worker stops once the frames pushed are done. */
+  bool stop_{false};
+  /*! \brief The error of the worker, which stops running frames. */
+  std::string error_;
+  std::thread worker_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_FRAME_STREAMER_H_
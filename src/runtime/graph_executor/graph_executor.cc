@@ -22,6 +22,7 @@
  */
 #include "graph_executor.h"
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/device_api.h>
@@ -30,10 +31,13 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <unordered_set>
@@ -41,6 +45,8 @@
 #include <vector>
 
 #include "../file_utils.h"
+#include "../library_module.h"
+#include "../texture.h"
 
 namespace tvm {
 namespace runtime {
@@ -50,18 +56,473 @@ inline size_t GetDataAlignment(const DLTensor& arr) {
   if (align < kAllocAlignment) return kAllocAlignment;
   return align;
 }
+
+/*! \brief A host tensor in the pinned memory of a device. */
+struct PinnedTensorContext {
+  DLManagedTensor tensor;
+  std::vector<int64_t> shape;
+  Device dev;
+
+  static void Deleter(DLManagedTensor* self) {
+    auto* ctx = static_cast<PinnedTensorContext*>(self->manager_ctx);
+    DeviceAPI::Get(ctx->dev)->FreePinnedHostSpace(ctx->dev, self->dl_tensor.data);
+    delete ctx;
+  }
+};
+
+/*!
+ * \brief Allocate a kDLCPU tensor shaped like arr in the pinned host memory of its device.
+ * \return The tensor, undefined when the device has no pinned host memory.
+ */
+inline NDArray PinnedEmptyLike(const NDArray& arr) {
+  Device dev = arr->device;
+  void* data = DeviceAPI::Get(dev)->AllocPinnedHostSpace(dev, GetDataSize(*arr.operator->()));
+  if (data == nullptr) return NDArray();
+  auto* ctx = new PinnedTensorContext();
+  ctx->shape.assign(arr->shape, arr->shape + arr->ndim);
+  ctx->dev = dev;
+  ctx->tensor.manager_ctx = ctx;
+  ctx->tensor.deleter = PinnedTensorContext::Deleter;
+  DLTensor& tensor = ctx->tensor.dl_tensor;
+  tensor.data = data;
+  tensor.device = Device{kDLCPU, 0};
+  tensor.ndim = arr->ndim;
+  tensor.dtype = arr->dtype;
+  tensor.shape = ctx->shape.data();
+  tensor.strides = nullptr;
+  tensor.byte_offset = 0;
+  return NDArray::FromDLPack(&ctx->tensor);
+}
+
+/*! \brief The shared state of the tasks of a concurrent run. */
+struct ConcurrentRunState {
+  const std::vector<std::function<void()>>* op_execs;
+  const std::vector<std::vector<uint32_t>>* op_successors;
+  /*! \brief The profiler timing the operators, nullptr when the run is not sampled. */
+  SamplingProfiler* profiler{nullptr};
+  /*! \brief The number of unfinished dependencies of each node. */
+  std::unique_ptr<std::atomic<uint32_t>[]> pending_deps;
+  /*! \brief Whether each node runs on a device other than the CPU, nullptr for none of them. */
+  const std::vector<bool>* op_on_accelerator{nullptr};
+  /*! \brief The operators ready to run on the CPU, and on the other devices. */
+  std::vector<uint32_t> ready;
+  std::vector<uint32_t> ready_accelerator;
+  std::mutex mutex;
+  /*! \brief The number of operators not finished yet. */
+  std::atomic<uint32_t> num_remaining;
+  /*! \brief Set when an operator failed, to stop the other tasks. */
+  std::atomic<bool> failed{false};
+
+  // The operators of the other devices go first: they only launch asynchronous work, which
+  // keeps the device busy while the workers run the CPU operators.
+  bool PopReady(uint32_t* nid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<uint32_t>& queue = ready_accelerator.empty() ? ready : ready_accelerator;
+    if (queue.empty()) return false;
+    *nid = queue.back();
+    queue.pop_back();
+    return true;
+  }
+
+  void PushReady(uint32_t nid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool on_accelerator = op_on_accelerator != nullptr && (*op_on_accelerator)[nid];
+    (on_accelerator ? ready_accelerator : ready).push_back(nid);
+  }
+};
+
+int RunConcurrentTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  ConcurrentRunState* state = static_cast<ConcurrentRunState*>(cdata);
+  while (state->num_remaining.load() != 0 && !state->failed.load()) {
+    uint32_t nid;
+    if (!state->PopReady(&nid)) {
+      threading::Yield();
+      continue;
+    }
+    try {
+      if (state->profiler != nullptr) state->profiler->BeginOp(nid);
+      (*state->op_execs)[nid]();
+      if (state->profiler != nullptr) state->profiler->EndOp(nid);
+    } catch (const std::exception& e) {
+      state->failed.store(true);
+      TVMAPISetLastError(e.what());
+      return -1;
+    }
+    for (uint32_t succ : (*state->op_successors)[nid]) {
+      if (state->pending_deps[succ].fetch_sub(1) == 1) {
+        state->PushReady(succ);
+      }
+    }
+    state->num_remaining.fetch_sub(1);
+  }
+  return 0;
+}
+
 }  // namespace details
 
 /*!
  * \brief Run all the operations one by one.
  */
 void GraphExecutor::Run() {
-  // setup the array and requirements.
-  for (size_t i = 0; i < op_execs_.size(); ++i) {
-    if (op_execs_[i]) op_execs_[i]();
+  bool sampled = sampling_profiler_.BeginRun();
+  if (!streams_.empty()) {
+    RunMultiStream(sampled);
+  } else if (max_concurrent_ops_ > 1) {
+    RunConcurrent(sampled);
+    if (run_stream_ != nullptr) {
+      // the operators were launched on the default streams of the pool threads
+      Device dev = AcceleratorDevice();
+      DeviceAPI::Get(dev)->SyncStreamFromTo(dev, nullptr, run_stream_);
+    }
+  } else {
+    Device dev = AcceleratorDevice();
+    DeviceAPI* api = DeviceAPI::Get(dev);
+    if (run_stream_ != nullptr) api->SetStream(dev, run_stream_);
+    threading::ParallelRegionScope region(persistent_parallel_region_);
+    for (const OpCall& call : op_calls_) {
+      if (sampled) sampling_profiler_.BeginOp(call.nid);
+      if (call.faddr != nullptr) {
+        TVMValue ret_value;
+        int ret_type_code = kTVMNullptr;
+        int ret = (*call.faddr)(call.arg_values, call.arg_tcodes, call.num_args, &ret_value,
+                                &ret_type_code, nullptr);
+        ICHECK_EQ(ret, 0) << TVMGetLastError();
+      } else {
+        op_execs_[call.nid]();
+      }
+      if (sampled) sampling_profiler_.EndOp(call.nid);
+    }
+    if (run_stream_ != nullptr) api->SetStream(dev, nullptr);
+  }
+  for (size_t i = 0; i < output_copies_.size(); ++i) {
+    if (output_copies_[i] != nullptr) {
+      NDArray::CopyFromTo(data_entry_[this->entry_id(outputs_[i])].operator->(),
+                          output_copies_[i], run_stream_);
+    }
+  }
+  SwapStates();
+  if (sampled) sampling_profiler_.EndRun();
+}
+
+void GraphExecutor::BindState(int input_index, int output_index) {
+  ICHECK_LT(static_cast<size_t>(input_index), input_nodes_.size());
+  ICHECK_LT(static_cast<size_t>(output_index), outputs_.size());
+  ICHECK(streamer_ == nullptr) << "BindState: the executor is streaming";
+  uint32_t in_eid = this->entry_id(input_nodes_[input_index], 0);
+  uint32_t out_eid = this->entry_id(outputs_[output_index]);
+  for (const auto& state : states_) {
+    ICHECK(state.first != in_eid && state.second != out_eid)
+        << "BindState: the input or the output is already bound";
+  }
+  const NDArray& input = data_entry_[in_eid];
+  const NDArray& output = data_entry_[out_eid];
+  ICHECK(input.Shape() == output.Shape() && input.DataType() == output.DataType() &&
+         input->device.device_type == output->device.device_type &&
+         input->device.device_id == output->device.device_id)
+      << "BindState: input " << input_index << " and output " << output_index
+      << " differ in shape, dtype or device";
+  // The tensors move from one entry to the other, they get their own storage when the
+  // memory plan shares it with other entries, which would overwrite the state.
+  for (uint32_t eid : {in_eid, out_eid}) {
+    int sid = attrs_.storage_id[eid];
+    int num_users = std::count(attrs_.storage_id.begin(), attrs_.storage_id.end(), sid);
+    if (num_users > 1 || storage_linked_[sid]) {
+      NDArray storage = NDArray::Empty(data_entry_[eid].Shape(), data_entry_[eid].DataType(),
+                                       data_entry_[eid]->device);
+      storage.CopyFrom(data_entry_[eid]);
+      data_entry_[eid] = storage;
+      data_alignment_[eid] = details::GetDataAlignment(*storage.operator->());
+    }
+  }
+  states_.emplace_back(in_eid, out_eid);
+  this->SetupOpExecs();
+}
+
+void GraphExecutor::SwapStates() {
+  for (const auto& state : states_) {
+    uint32_t in_eid = state.first;
+    uint32_t out_eid = state.second;
+    std::swap(data_entry_[in_eid], data_entry_[out_eid]);
+    std::swap(data_alignment_[in_eid], data_alignment_[out_eid]);
+    for (DLTensor* t : input_dltensors_[in_eid]) {
+      t->data = data_entry_[in_eid]->data;
+    }
+    for (DLTensor* t : output_dltensors_[out_eid]) {
+      t->data = data_entry_[out_eid]->data;
+    }
+    for (DLTensor* t : both_output_opinput_dltensors_[out_eid]) {
+      t->data = data_entry_[out_eid]->data;
+    }
+  }
+}
+
+Array<NDArray> GraphExecutor::RunInContext(const std::vector<std::pair<int, DLTensor*>>& inputs,
+                                           Device host) {
+  ObjectPtr<GraphExecutor> context;
+  {
+    std::lock_guard<std::mutex> lock(contexts_mutex_);
+    if (!free_contexts_.empty()) {
+      context = free_contexts_.back();
+      free_contexts_.pop_back();
+    }
+  }
+  if (context == nullptr) {
+    context = make_object<GraphExecutor>();
+    context->Init(graph_json_, module_, devices_, lookup_linked_param_);
+    for (uint32_t eid : param_eids_) {
+      context->data_entry_[eid] = data_entry_[eid];
+      context->data_alignment_[eid] = data_alignment_[eid];
+    }
+    // the storage of the parameters of the context is not used
+    std::vector<bool> used(context->storage_pool_.size(), false);
+    for (uint32_t eid = 0; eid < num_node_entries(); ++eid) {
+      if (!param_eids_.count(eid)) used[attrs_.storage_id[eid]] = true;
+    }
+    for (size_t sid = 0; sid < used.size(); ++sid) {
+      if (!used[sid]) context->storage_pool_[sid] = NDArray();
+    }
+    context->SetupOpExecs();
+  }
+  for (const auto& input : inputs) {
+    context->SetInput(input.first, input.second);
+  }
+  context->Run();
+  Array<NDArray> outputs;
+  for (int i = 0; i < context->NumOutputs(); ++i) {
+    NDArray out = context->GetOutput(i);
+    NDArray copy = NDArray::Empty(out.Shape(), out.DataType(), host);
+    copy.CopyFrom(out);
+    outputs.push_back(copy);
+  }
+  std::lock_guard<std::mutex> lock(contexts_mutex_);
+  free_contexts_.push_back(context);
+  return outputs;
+}
+
+uint32_t GraphExecutor::output_entry_id(int index) const {
+  uint32_t eid = this->entry_id(outputs_[index]);
+  for (const auto& state : states_) {
+    if (state.second == eid) return state.first;
+  }
+  return eid;
+}
+
+void GraphExecutor::SetSamplingProfiler(int sample_period) {
+  std::vector<Device> op_devices(op_execs_.size());
+  for (uint32_t nid = 0; nid < op_execs_.size(); ++nid) {
+    if (!op_execs_[nid]) continue;
+    int device_type = static_cast<int>(devices_[0].device_type);
+    if (!attrs_.device_index.empty()) {
+      device_type = attrs_.device_index[this->entry_id(nid, 0)];
+    }
+    auto it = std::find_if(devices_.begin(), devices_.end(), [device_type](const Device& d) {
+      return static_cast<int>(d.device_type) == device_type;
+    });
+    op_devices[nid] = it == devices_.end() ? devices_[0] : *it;
+  }
+  sampling_profiler_.Configure(sample_period, std::move(op_devices));
+}
+
+std::string GraphExecutor::GetSamplingProfile() const {
+  std::vector<std::string> node_names;
+  for (const auto& node : nodes_) {
+    node_names.push_back(node.name);
+  }
+  return sampling_profiler_.AsJSON(node_names);
+}
+
+void GraphExecutor::RunAsync(std::function<void()> callback) {
+  Run();
+  Device dev = AcceleratorDevice();
+  DeviceAPI::Get(dev)->StreamAddCallback(dev, run_stream_, std::move(callback));
+}
+
+Device GraphExecutor::AcceleratorDevice() const {
+  auto it = std::find_if(devices_.begin(), devices_.end(),
+                         [](const Device& d) { return d.device_type != kDLCPU; });
+  return it == devices_.end() ? devices_[0] : *it;
+}
+
+void GraphExecutor::SetStream(TVMStreamHandle stream) {
+  ICHECK(stream == nullptr || AcceleratorDevice().device_type != kDLCPU)
+      << "A stream requires a non-CPU device";
+  run_stream_ = stream;
+}
+
+void GraphExecutor::SetMaxConcurrentOps(int max_concurrent_ops) {
+  ICHECK_GE(max_concurrent_ops, 1);
+  // the operators are tasks of one parallel launch, which cannot outnumber the workers
+  max_concurrent_ops_ = std::min(max_concurrent_ops, threading::MaxConcurrency());
+}
+
+GraphExecutor::~GraphExecutor() {
+  // the worker thread runs the graph, it is stopped before the graph goes away
+  streamer_.reset();
+  FreeStreams();
+}
+
+void GraphExecutor::StartStreaming(int num_buffers, const std::vector<int>& input_indices) {
+  ICHECK(streamer_ == nullptr) << "The executor is already streaming";
+  ICHECK(states_.empty()) << "A stateful executor runs one frame at a time";
+  std::vector<NDArray> inputs, outputs;
+  for (int index : input_indices) {
+    ICHECK_LT(static_cast<size_t>(index), input_nodes_.size());
+    inputs.push_back(data_entry_[this->entry_id(input_nodes_[index], 0)]);
+  }
+  for (const NodeEntry& output : outputs_) {
+    outputs.push_back(data_entry_[this->entry_id(output)]);
+  }
+  streamed_inputs_ = input_indices;
+  streamer_ = std::make_unique<FrameStreamer>(
+      num_buffers, inputs, outputs,
+      [this](const std::vector<NDArray>& frame_inputs, const std::vector<NDArray>& frame_outputs) {
+        for (size_t i = 0; i < frame_inputs.size(); ++i) {
+          DLTensor* input = const_cast<DLTensor*>(frame_inputs[i].operator->());
+          SetInputZeroCopy(streamed_inputs_[i], input);
+        }
+        for (size_t i = 0; i < frame_outputs.size(); ++i) {
+          SetOutputZeroCopy(i, const_cast<DLTensor*>(frame_outputs[i].operator->()));
+        }
+        Run();
+        Device dev = AcceleratorDevice();
+        if (dev.device_type != kDLCPU) {
+          DeviceAPI::Get(dev)->StreamSync(dev, run_stream_);
+        }
+      });
+}
+
+void GraphExecutor::PushFrame(const std::vector<const DLTensor*>& inputs) {
+  ICHECK(streamer_ != nullptr) << "PushFrame needs StartStreaming";
+  streamer_->Push(inputs);
+}
+
+Array<NDArray> GraphExecutor::PopFrame() {
+  ICHECK(streamer_ != nullptr) << "PopFrame needs StartStreaming";
+  return streamer_->Pop();
+}
+
+void GraphExecutor::StopStreaming() {
+  if (streamer_ == nullptr) return;
+  streamer_.reset();
+  for (int index : streamed_inputs_) {
+    NDArray input = data_entry_[this->entry_id(input_nodes_[index], 0)];
+    SetInputZeroCopy(index, const_cast<DLTensor*>(input.operator->()));
+  }
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    NDArray output = data_entry_[this->entry_id(outputs_[i])];
+    SetOutputZeroCopy(i, const_cast<DLTensor*>(output.operator->()));
+  }
+  streamed_inputs_.clear();
+}
+
+void GraphExecutor::FreeStreams() {
+  for (TVMStreamHandle stream : streams_) {
+    DeviceAPI::Get(stream_device_)->FreeStream(stream_device_, stream);
+  }
+  streams_.clear();
+  op_stream_.clear();
+}
+
+void GraphExecutor::SetNumStreams(int num_streams) {
+  ICHECK_GE(num_streams, 1);
+  FreeStreams();
+  if (num_streams == 1) return;
+  auto it = std::find_if(devices_.begin(), devices_.end(),
+                         [](const Device& d) { return d.device_type != kDLCPU; });
+  ICHECK(it != devices_.end()) << "Multiple streams require a non-CPU device";
+  stream_device_ = *it;
+  DeviceAPI* api = DeviceAPI::Get(stream_device_);
+  for (int i = 0; i < num_streams; ++i) {
+    streams_.push_back(api->CreateStream(stream_device_));
+  }
+  // Assign the streams so that an operator continues the stream of one of its
+  // producers, and every other branch starts on the next stream in turn.
+  uint32_t num_nodes = this->GetNumOfNodes();
+  op_stream_.assign(num_nodes, -1);
+  std::vector<bool> continued(num_nodes, false);
+  int next_stream = 0;
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    const auto& inode = nodes_[nid];
+    if (inode.op_type == "null" || inode.param.func_name == "__copy") continue;
+    int device_type = static_cast<int>(devices_[0].device_type);
+    if (!attrs_.device_index.empty()) {
+      device_type = attrs_.device_index[this->entry_id(nid, 0)];
+    }
+    if (device_type != static_cast<int>(stream_device_.device_type)) continue;
+    for (uint32_t pred : op_predecessors_[nid]) {
+      if (op_stream_[pred] >= 0 && !continued[pred]) {
+        continued[pred] = true;
+        op_stream_[nid] = op_stream_[pred];
+        break;
+      }
+    }
+    if (op_stream_[nid] < 0) {
+      op_stream_[nid] = next_stream;
+      next_stream = (next_stream + 1) % num_streams;
+    }
+  }
+}
+
+void GraphExecutor::RunMultiStream(bool sampled) {
+  DeviceAPI* api = DeviceAPI::Get(stream_device_);
+  // the inputs are set on the stream of the executor
+  for (TVMStreamHandle stream : streams_) {
+    api->SyncStreamFromTo(stream_device_, run_stream_, stream);
+  }
+  std::vector<int> waited;
+  for (size_t nid = 0; nid < op_execs_.size(); ++nid) {
+    if (!op_execs_[nid]) continue;
+    int sid = op_stream_[nid];
+    TVMStreamHandle stream = sid >= 0 ? streams_[sid] : run_stream_;
+    // insert one event per producer stream different from the one of this operator
+    waited.clear();
+    for (uint32_t pred : op_predecessors_[nid]) {
+      int pred_sid = op_stream_[pred];
+      if (pred_sid == sid || std::find(waited.begin(), waited.end(), pred_sid) != waited.end()) {
+        continue;
+      }
+      waited.push_back(pred_sid);
+      api->SyncStreamFromTo(stream_device_, pred_sid >= 0 ? streams_[pred_sid] : run_stream_,
+                            stream);
+    }
+    api->SetStream(stream_device_, stream);
+    if (sampled) sampling_profiler_.BeginOp(nid);
+    op_execs_[nid]();
+    if (sampled) sampling_profiler_.EndOp(nid);
+  }
+  api->SetStream(stream_device_, nullptr);
+  // join back to the stream used by the outputs
+  for (TVMStreamHandle stream : streams_) {
+    api->SyncStreamFromTo(stream_device_, stream, run_stream_);
   }
 }
 
+void GraphExecutor::RunConcurrent(bool sampled) {
+  details::ConcurrentRunState state;
+  state.op_execs = &op_execs_;
+  state.op_successors = &op_successors_;
+  state.profiler = sampled ? &sampling_profiler_ : nullptr;
+  state.pending_deps.reset(new std::atomic<uint32_t>[op_predecessors_.size()]);
+  uint32_t num_ops = 0;
+  for (size_t nid = 0; nid < op_predecessors_.size(); ++nid) {
+    state.pending_deps[nid].store(static_cast<uint32_t>(op_predecessors_[nid].size()),
+                                  std::memory_order_relaxed);
+    if (op_execs_[nid]) ++num_ops;
+  }
+  if (num_ops == 0) return;
+  state.num_remaining.store(num_ops);
+  if (std::find(op_on_accelerator_.begin(), op_on_accelerator_.end(), true) !=
+      op_on_accelerator_.end()) {
+    state.op_on_accelerator = &op_on_accelerator_;
+  }
+  // pushed in reverse so that the stack pops the roots in graph order
+  for (auto it = op_roots_.rbegin(); it != op_roots_.rend(); ++it) {
+    state.PushReady(*it);
+  }
+  // the thread pool gives each task its share of the idle workers for nested launches
+  TVM_CCALL(TVMBackendParallelLaunch(details::RunConcurrentTask, &state, max_concurrent_ops_));
+}
+
 /*!
  * \brief Initialize the graph executor with graph and device.
  * \param graph_json The execution graph.
@@ -77,6 +538,7 @@ void GraphExecutor::Init(const std::string& graph_json, tvm::runtime::Module mod
   std::istringstream is(graph_json);
   dmlc::JSONReader reader(&is);
   this->Load(&reader);
+  graph_json_ = graph_json;
   module_ = module;
   devices_ = devs;
   lookup_linked_param_ = lookup_linked_param_func;
@@ -86,6 +548,7 @@ void GraphExecutor::Init(const std::string& graph_json, tvm::runtime::Module mod
   }
   this->SetupStorage();
   this->SetupOpExecs();
+  this->SetupOpDependencies();
   for (size_t i = 0; i < input_nodes_.size(); i++) {
     const uint32_t nid = input_nodes_[i];
     std::string& name = nodes_[nid].name;
@@ -97,6 +560,20 @@ void GraphExecutor::Init(const std::string& graph_json, tvm::runtime::Module mod
     output_map_[name] = i;
   }
 }
+std::unordered_map<std::string, std::pair<int, int>> GraphExecutor::GetInputStorage(
+    const std::string& graph_json) {
+  auto graph = make_object<GraphExecutor>();
+  std::istringstream is(graph_json);
+  dmlc::JSONReader reader(&is);
+  graph->Load(&reader);
+  std::unordered_map<std::string, std::pair<int, int>> storage;
+  for (uint32_t nid : graph->input_nodes_) {
+    uint32_t eid = graph->entry_id(nid, 0);
+    int device_type = graph->attrs_.device_index.empty() ? -1 : graph->attrs_.device_index[eid];
+    storage[graph->nodes_[nid].name] = {graph->attrs_.storage_id[eid], device_type};
+  }
+  return storage;
+}
 /*!
  * \brief Get the input index given the name of input.
  * \param name The name of the input.
@@ -129,7 +606,25 @@ int GraphExecutor::GetOutputIndex(const std::string& name) {
 void GraphExecutor::SetInput(int index, DLTensor* data_in) {
   ICHECK_LT(static_cast<size_t>(index), input_nodes_.size());
   uint32_t eid = this->entry_id(input_nodes_[index], 0);
-  data_entry_[eid].CopyFrom(data_in);
+  DetachLinkedStorage(eid);
+  DLTensor* entry = const_cast<DLTensor*>(data_entry_[eid].operator->());
+  // the operators may be built without checking their arguments, see tir.skip_arg_checks
+  ICHECK(DataType(data_in->dtype) == DataType(entry->dtype))
+      << "set_input: expect an input " << index << " of dtype "
+      << DLDataType2String(entry->dtype) << ", not " << DLDataType2String(data_in->dtype);
+  NDArray stage = data_in->device.device_type == kDLCPU ? GetStaging(eid) : NDArray();
+  if (stage.defined()) {
+    DLTensor* staged = const_cast<DLTensor*>(stage.operator->());
+    if (staged->data != data_in->data) {
+      // the copy of the previous run may still be reading the buffer
+      if (run_stream_ != nullptr) {
+        DeviceAPI::Get(entry->device)->StreamSync(entry->device, run_stream_);
+      }
+      NDArray::CopyFromTo(data_in, staged);
+    }
+    data_in = staged;
+  }
+  NDArray::CopyFromTo(data_in, entry, run_stream_);
 }
 /*!
  * \brief Check the legality of external DLTensor*.
@@ -140,8 +635,8 @@ void GraphExecutor::CheckExternalDLTensor(const DLTensor* external, uint32_t eid
   const DLTensor* internal = data_entry_[eid].operator->();
 
   ICHECK_EQ(data_alignment_[eid], details::GetDataAlignment(*external));
-  ICHECK_EQ(reinterpret_cast<size_t>(external->data) % kAllocAlignment, 0);
   ICHECK_EQ(internal->ndim, static_cast<size_t>(external->ndim));
+  ICHECK(DataType(internal->dtype) == DataType(external->dtype));
   ICHECK_EQ(internal->device.device_type, external->device.device_type);
   ICHECK_EQ(internal->device.device_id, external->device.device_id);
   for (auto i = 0; i < external->ndim; ++i) {
@@ -158,9 +653,15 @@ void GraphExecutor::SetInputZeroCopy(int index, DLTensor* data_ref) {
   uint32_t eid = this->entry_id(input_nodes_[index], 0);
   // check the consistency of input
   CheckExternalDLTensor(data_ref, eid);
+  // the operators take compact tensors, a strided or misaligned input is copied instead
+  void* data = GetCompactDataAddress(*data_ref, kAllocAlignment);
+  if (data == nullptr) {
+    SetInput(index, data_ref);
+    data = data_entry_[eid]->data;
+  }
   // Update the data pointer for each argument of each op
   for (DLTensor* t : input_dltensors_[eid]) {
-    t->data = data_ref->data;
+    t->data = data;
   }
 }
 /*!
@@ -177,14 +678,23 @@ void GraphExecutor::SetOutputZeroCopy(int index, DLTensor* data_ref) {
   // check the consistency of output
   CheckExternalDLTensor(data_ref, output_node_eid);
 
+  // a strided or misaligned output is written by the operators to the executor's tensor,
+  // and copied out after each run
+  void* data = GetCompactDataAddress(*data_ref, kAllocAlignment);
+  output_copies_.resize(outputs_.size());
+  output_copies_[index] = data == nullptr ? data_ref : nullptr;
+  if (data == nullptr) {
+    data = data_entry_[output_node_eid]->data;
+  }
+
   // Update the data pointer for output op
   for (DLTensor* t : output_dltensors_[output_node_eid]) {
-    t->data = data_ref->data;
+    t->data = data;
   }
 
   // Update the input of the op connected to the output
   for (DLTensor* t : both_output_opinput_dltensors_[output_node_eid]) {
-    t->data = data_ref->data;
+    t->data = data;
   }
 }
 /*!
@@ -218,7 +728,7 @@ NDArray GraphExecutor::GetInput(int index) const {
  */
 NDArray GraphExecutor::GetOutput(int index) const {
   ICHECK_LT(static_cast<size_t>(index), outputs_.size());
-  uint32_t eid = this->entry_id(outputs_[index]);
+  uint32_t eid = this->output_entry_id(index);
   return data_entry_[eid];
 }
 /*!
@@ -228,7 +738,7 @@ NDArray GraphExecutor::GetOutput(int index) const {
  */
 void GraphExecutor::CopyOutputTo(int index, DLTensor* data_out) {
   ICHECK_LT(static_cast<size_t>(index), outputs_.size());
-  uint32_t eid = this->entry_id(outputs_[index]);
+  uint32_t eid = this->output_entry_id(index);
 
   // Check the shapes to avoid receiving in different dimension but same size.
   const NDArray& data = data_entry_[eid];
@@ -237,7 +747,44 @@ void GraphExecutor::CopyOutputTo(int index, DLTensor* data_out) {
     ICHECK_EQ(data->shape[j], data_out->shape[j]);
   }
 
-  data_entry_[eid].CopyTo(data_out);
+  NDArray stage = data_out->device.device_type == kDLCPU ? GetStaging(eid) : NDArray();
+  if (stage.defined()) {
+    DLTensor* staged = const_cast<DLTensor*>(stage.operator->());
+    NDArray::CopyFromTo(data.operator->(), staged, run_stream_);
+    if (staged->data == data_out->data) return;
+    DeviceAPI::Get(data->device)->StreamSync(data->device, run_stream_);
+    NDArray::CopyFromTo(staged, data_out);
+    return;
+  }
+  NDArray::CopyFromTo(data.operator->(), data_out, run_stream_);
+}
+
+void GraphExecutor::SetPinnedStaging(bool enable) {
+  pinned_staging_ = enable;
+  if (!enable) staging_.clear();
+}
+
+NDArray GraphExecutor::GetStaging(uint32_t eid) {
+  if (!pinned_staging_) return NDArray();
+  auto it = staging_.find(eid);
+  if (it != staging_.end()) return it->second;
+  const NDArray& entry = data_entry_[eid];
+  NDArray stage;
+  if (entry->device.device_type != kDLCPU && entry->strides == nullptr) {
+    stage = details::PinnedEmptyLike(entry);
+  }
+  staging_[eid] = stage;
+  return stage;
+}
+
+NDArray GraphExecutor::GetInputStaging(int index) {
+  ICHECK_LT(static_cast<size_t>(index), input_nodes_.size());
+  return GetStaging(this->entry_id(input_nodes_[index], 0));
+}
+
+NDArray GraphExecutor::GetOutputStaging(int index) {
+  ICHECK_LT(static_cast<size_t>(index), outputs_.size());
+  return GetStaging(this->entry_id(outputs_[index]));
 }
 
 /*!
@@ -251,26 +798,52 @@ void GraphExecutor::LoadParams(const std::string& param_blob) {
 
 void GraphExecutor::LoadParams(dmlc::Stream* strm) {
   Map<String, NDArray> params = ::tvm::runtime::LoadParams(strm);
+  std::vector<NDArray> params_src, entries_dst;
+  for (auto& p : params) {
+    int in_idx = GetInputIndex(p.first);
+    if (in_idx < 0) continue;
+    uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
+    DetachLinkedStorage(eid);
+    params_src.push_back(p.second);
+    entries_dst.push_back(data_entry_[eid]);
+    param_eids_.insert(eid);
+  }
+  UploadParams(params_src, entries_dst);
+}
+
+void GraphExecutor::LoadParamsFromFile(const std::string& file_name) {
+  Map<String, NDArray> params = ::tvm::runtime::LoadParamsFromFile(file_name);
+  std::vector<NDArray> params_src, entries_dst;
+  bool rebound = false;
   for (auto& p : params) {
     int in_idx = GetInputIndex(p.first);
     if (in_idx < 0) continue;
     uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
-    data_entry_[eid].CopyFrom(p.second);
+    param_eids_.insert(eid);
+    const DLTensor* dst = data_entry_[eid].operator->();
+    const DLTensor* src = p.second.operator->();
+    bool same_type = dst->device.device_type == kDLCPU && src->device.device_type == kDLCPU &&
+                     p.second.DataType() == data_entry_[eid].DataType() && dst->ndim == src->ndim &&
+                     std::equal(dst->shape, dst->shape + dst->ndim, src->shape);
+    if (same_type) {
+      data_entry_[eid] = p.second;
+      data_alignment_[eid] = details::GetDataAlignment(*src);
+      rebound = true;
+    } else {
+      DetachLinkedStorage(eid);
+      params_src.push_back(p.second);
+      entries_dst.push_back(data_entry_[eid]);
+    }
+  }
+  UploadParams(params_src, entries_dst);
+  if (rebound) {
+    this->SetupOpExecs();
   }
 }
 
 void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm) {
-  uint64_t header, reserved;
-  ICHECK(strm->Read(&header)) << "Invalid parameters file format";
-  ICHECK(header == kTVMNDArrayListMagic) << "Invalid parameters file format";
-  ICHECK(strm->Read(&reserved)) << "Invalid parameters file format";
-  std::vector<std::string> names;
-  ICHECK(strm->Read(&names)) << "Invalid parameters file format";
-  uint64_t sz;
-  strm->Read(&sz);
-  size_t size = static_cast<size_t>(sz);
-  ICHECK(size == names.size()) << "Invalid parameters file format";
-  for (size_t i = 0; i < size; ++i) {
+  std::vector<std::string> names = LoadParamNames(strm);
+  for (size_t i = 0; i < names.size(); ++i) {
     int in_idx = GetInputIndex(names[i]);
     if (in_idx < 0) continue;
     uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
@@ -280,6 +853,7 @@ void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm)
     ICHECK_GT(data_entry_[eid].use_count(), 1);
     const DLTensor* tmp = data_entry_[eid].operator->();
     data_alignment_[eid] = details::GetDataAlignment(*tmp);
+    param_eids_.insert(eid);
   }
   this->SetupOpExecs();
 }
@@ -347,6 +921,9 @@ void GraphExecutor::SetupStorage() {
     size_t bits = t.bits * t.lanes;
     ICHECK(bits % 8U == 0U || bits == 1U || bits == 4U);
     size_t bytes = ((bits + 7U) / 8U) * size;
+    if (!attrs_.storage_offset.empty()) {
+      bytes += static_cast<size_t>(attrs_.storage_offset[i]);
+    }
 
     uint32_t sid = static_cast<uint32_t>(storage_id);
     if (sid >= pool_entry.size()) {
@@ -369,6 +946,22 @@ void GraphExecutor::SetupStorage() {
     pool_entry[sid].param_data_entry = i;
     pool_entry[sid].size = std::max(pool_entry[sid].size, bytes);
     pool_entry[sid].device_type = device_type;
+    if (!attrs_.storage_scope.empty() && IsTextureStorage(attrs_.storage_scope[i])) {
+      // The entries sharing a texture may use different layouts, the texture covers the 2d
+      // extents of all of them.
+      const std::vector<int64_t>& shape = attrs_.shape[i];
+      size_t axis = DefaultTextureLayoutSeparator(shape.size(), attrs_.storage_scope[i]);
+      auto texture = ApplyTexture2DFlattening<int64_t>(shape, shape.size(), axis);
+      PoolEntry& entry = pool_entry[sid];
+      ICHECK(entry.scope.empty() || (entry.texture_channel == texture.channel &&
+                                     DataType(entry.texture_dtype) == DataType(t)))
+          << "The entries sharing a texture must have the same channels and element type";
+      entry.scope = "global.texture";
+      entry.texture_width = std::max(entry.texture_width, texture.width);
+      entry.texture_height = std::max(entry.texture_height, texture.height);
+      entry.texture_channel = texture.channel;
+      entry.texture_dtype = t;
+    }
   }
 
   // Allocate the space.
@@ -379,8 +972,13 @@ void GraphExecutor::SetupStorage() {
       return pit.device_type == static_cast<int>(d.device_type);
     });
     Device dev = cit == devices_.end() ? devices_[0] : *cit;
+    storage_linked_.push_back(pit.linked_param.defined());
     if (pit.linked_param.defined()) {
       storage_pool_.push_back(pit.linked_param);
+    } else if (!pit.scope.empty()) {
+      // [height, width, channel] is flattened back to the same 2d extent by global.texture.
+      std::vector<int64_t> shape{pit.texture_height, pit.texture_width, pit.texture_channel};
+      storage_pool_.push_back(NDArray::Empty(shape, pit.texture_dtype, dev, String(pit.scope)));
     } else {
       std::vector<int64_t> shape;
       shape.push_back(static_cast<int64_t>(pit.size + 3) / 4);
@@ -396,18 +994,49 @@ void GraphExecutor::SetupStorage() {
   for (size_t i = 0; i < data_entry_.size(); ++i) {
     int storage_id = attrs_.storage_id[i];
     ICHECK_LT(static_cast<size_t>(storage_id), storage_pool_.size());
-    data_entry_[i] = storage_pool_[storage_id].CreateView(attrs_.shape[i], vtype[i]);
+    data_entry_[i] = CreateEntryView(i, vtype[i]);
 
     const DLTensor* tmp = data_entry_[i].operator->();
     data_alignment_[i] = details::GetDataAlignment(*tmp);
   }
 }
 
+NDArray GraphExecutor::CreateEntryView(uint32_t eid, DLDataType dtype) {
+  NDArray view = storage_pool_[attrs_.storage_id[eid]].CreateView(attrs_.shape[eid], dtype);
+  int64_t offset = attrs_.storage_offset.empty() ? 0 : attrs_.storage_offset[eid];
+  if (offset != 0) {
+    // The planner only places entries at offsets on devices whose buffers are addresses, and
+    // the view is moved rather than given a byte_offset the kernels may not accept.
+    DLTensor* tensor = const_cast<DLTensor*>(view.operator->());
+    tensor->data = static_cast<char*>(tensor->data) + offset;
+  }
+  return view;
+}
+
+void GraphExecutor::DetachLinkedStorage(uint32_t eid) {
+  uint32_t sid = static_cast<uint32_t>(attrs_.storage_id[eid]);
+  if (!storage_linked_[sid]) return;
+  const NDArray& linked = storage_pool_[sid];
+  NDArray storage = NDArray::Empty(linked.Shape(), linked.DataType(), linked->device);
+  storage.CopyFrom(linked);
+  storage_pool_[sid] = storage;
+  storage_linked_[sid] = false;
+  for (size_t i = 0; i < data_entry_.size(); ++i) {
+    if (static_cast<uint32_t>(attrs_.storage_id[i]) != sid) continue;
+    data_entry_[i] = CreateEntryView(i, data_entry_[i].DataType());
+    data_alignment_[i] = details::GetDataAlignment(*data_entry_[i].operator->());
+  }
+  this->SetupOpExecs();
+}
+
 void GraphExecutor::SetupOpExecs() {
-  op_execs_.resize(this->GetNumOfNodes());
-  input_dltensors_.resize(num_node_entries());
-  output_dltensors_.resize(num_node_entries());
-  both_output_opinput_dltensors_.resize(num_node_entries());
+  // the tables are rebuilt from scratch, the tensors of the previous operators being freed
+  op_execs_.assign(this->GetNumOfNodes(), nullptr);
+  op_args_.assign(this->GetNumOfNodes(), nullptr);
+  op_calls_.clear();
+  input_dltensors_.assign(num_node_entries(), {});
+  output_dltensors_.assign(num_node_entries(), {});
+  both_output_opinput_dltensors_.assign(num_node_entries(), {});
   std::unordered_set<uint32_t> input_node_eids;
   for (size_t i = 0; i < input_nodes_.size(); i++) {
     uint32_t nid = input_nodes_[i];
@@ -435,6 +1064,9 @@ void GraphExecutor::SetupOpExecs() {
 
     std::shared_ptr<OpArgs> op_args = nullptr;
     std::tie(op_execs_[nid], op_args) = CreateTVMOp(inode.param, args);
+    op_args_[nid] = op_args;
+    op_calls_.push_back({nid, op_args->faddr, op_args->arg_values.data(),
+                         op_args->arg_tcodes.data(), static_cast<int>(op_args->arg_values.size())});
 
     for (size_t i = 0; i < inode.inputs.size(); i++) {
       uint32_t input_eid = this->entry_id(inode.inputs[i]);
@@ -461,6 +1093,55 @@ void GraphExecutor::SetupOpExecs() {
   }
 }
 
+void GraphExecutor::SetupOpDependencies() {
+  uint32_t num_nodes = this->GetNumOfNodes();
+  std::vector<std::vector<uint32_t>>& preds = op_predecessors_;
+  preds.assign(num_nodes, {});
+  // the last operator writing each storage and the operators reading it since then
+  std::unordered_map<int, uint32_t> last_writer;
+  std::unordered_map<int, std::vector<uint32_t>> readers;
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    const auto& inode = nodes_[nid];
+    if (inode.op_type == "null") continue;
+    std::vector<uint32_t>& deps = preds[nid];
+    for (const auto& e : inode.inputs) {
+      int sid = attrs_.storage_id[this->entry_id(e)];
+      auto it = last_writer.find(sid);
+      if (it != last_writer.end()) deps.push_back(it->second);
+      readers[sid].push_back(nid);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      int sid = attrs_.storage_id[this->entry_id(nid, index)];
+      auto it = last_writer.find(sid);
+      if (it != last_writer.end()) deps.push_back(it->second);
+      for (uint32_t reader : readers[sid]) {
+        if (reader != nid) deps.push_back(reader);
+      }
+      readers[sid].clear();
+      last_writer[sid] = nid;
+    }
+    for (uint32_t dep : inode.control_deps) {
+      if (nodes_[dep].op_type != "null") deps.push_back(dep);
+    }
+    std::sort(deps.begin(), deps.end());
+    deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+  }
+  op_successors_.assign(num_nodes, {});
+  op_roots_.clear();
+  op_on_accelerator_.assign(num_nodes, false);
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    if (nodes_[nid].op_type == "null") continue;
+    for (uint32_t dep : preds[nid]) {
+      op_successors_[dep].push_back(nid);
+    }
+    if (preds[nid].empty()) op_roots_.push_back(nid);
+    // a copy runs on the device of its output, so the copies back to the host block a worker
+    if (!attrs_.device_index.empty()) {
+      op_on_accelerator_[nid] = attrs_.device_index[this->entry_id(nid, 0)] != kDLCPU;
+    }
+  }
+}
+
 std::pair<std::function<void()>, std::shared_ptr<GraphExecutor::OpArgs> >
 GraphExecutor::CreateTVMOp(const TVMOpParam& param, const std::vector<DLTensor>& args) {
   std::shared_ptr<GraphExecutor::OpArgs> arg_ptr = std::make_shared<GraphExecutor::OpArgs>();
@@ -502,6 +1183,21 @@ GraphExecutor::CreateTVMOp(const TVMOpParam& param, const std::vector<DLTensor>&
   tvm::runtime::PackedFunc pf = module_.GetFunction(param.func_name, true);
   ICHECK(pf != nullptr) << "no such function in module: " << param.func_name;
 
+  // Call the compiled functions of library modules directly with the arguments packed above,
+  // skipping the PackedFunc and TVMArgs wrappers on every run. pf keeps the library loaded.
+  if (TVMBackendPackedCFunc faddr = GetBackendPackedCFunc(pf)) {
+    arg_ptr->faddr = faddr;
+    auto fexec = [arg_ptr, pf, faddr]() {
+      TVMValue ret_value;
+      int ret_type_code = kTVMNullptr;
+      int ret = (*faddr)(arg_ptr->arg_values.data(), arg_ptr->arg_tcodes.data(),
+                         static_cast<int>(arg_ptr->arg_values.size()), &ret_value, &ret_type_code,
+                         nullptr);
+      ICHECK_EQ(ret, 0) << TVMGetLastError();
+    };
+    return {fexec, arg_ptr};
+  }
+
   auto fexec = [arg_ptr, pf]() {
     TVMRetValue rv;
     TVMArgs targs(arg_ptr->arg_values.data(), arg_ptr->arg_tcodes.data(),
@@ -558,6 +1254,10 @@ PackedFunc GraphExecutor::GetFunction(const std::string& name,
         in_idx = args[0];
       }
       if (in_idx >= 0) {
+        // the caller is about to write into the input, give it a private copy
+        if (args.num_args > 1 && args[1].operator bool()) {
+          this->DetachLinkedStorage(this->entry_id(input_nodes_[in_idx], 0));
+        }
         *rv = this->GetInput(in_idx);
       }
     });
@@ -569,6 +1269,97 @@ PackedFunc GraphExecutor::GetFunction(const std::string& name,
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
   } else if (name == "run") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "run_async") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      PackedFunc callback = args[0];
+      this->RunAsync([callback]() { callback(); });
+    });
+  } else if (name == "set_pinned_staging") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetPinnedStaging(args[0]);
+    });
+  } else if (name == "get_input_staging") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int in_idx = 0;
+      if (String::CanConvertFrom(args[0])) {
+        in_idx = this->GetInputIndex(args[0].operator String());
+      } else {
+        in_idx = args[0];
+      }
+      ICHECK_GE(in_idx, 0) << "Cannot find input";
+      NDArray stage = this->GetInputStaging(in_idx);
+      if (stage.defined()) *rv = stage;
+    });
+  } else if (name == "get_output_staging") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      NDArray stage = this->GetOutputStaging(args[0]);
+      if (stage.defined()) *rv = stage;
+    });
+  } else if (name == "bind_state") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int in_idx = 0;
+      if (String::CanConvertFrom(args[0])) {
+        in_idx = this->GetInputIndex(args[0].operator String());
+      } else {
+        in_idx = args[0];
+      }
+      ICHECK_GE(in_idx, 0) << "Cannot find input";
+      this->BindState(in_idx, args[1]);
+    });
+  } else if (name == "start_streaming") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<int> input_indices;
+      for (int i = 1; i < args.size(); ++i) {
+        int in_idx = 0;
+        if (String::CanConvertFrom(args[i])) {
+          in_idx = this->GetInputIndex(args[i].operator String());
+        } else {
+          in_idx = args[i];
+        }
+        ICHECK_GE(in_idx, 0) << "Cannot find input";
+        input_indices.push_back(in_idx);
+      }
+      this->StartStreaming(args[0], input_indices);
+    });
+  } else if (name == "push_frame") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<const DLTensor*> inputs;
+      for (int i = 0; i < args.size(); ++i) {
+        inputs.push_back(args[i].operator DLTensor*());
+      }
+      this->PushFrame(inputs);
+    });
+  } else if (name == "pop_frame") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->PopFrame(); });
+  } else if (name == "stop_streaming") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->StopStreaming(); });
+  } else if (name == "set_stream") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->SetStream(args[0]); });
+  } else if (name == "get_stream") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetStream(); });
+  } else if (name == "set_num_streams") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->SetNumStreams(args[0]); });
+  } else if (name == "set_max_concurrent_ops") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetMaxConcurrentOps(args[0]);
+    });
+  } else if (name == "set_persistent_parallel_region") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetPersistentParallelRegion(args[0]);
+    });
+  } else if (name == "set_sampling_profiler") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetSamplingProfiler(args[0]);
+    });
+  } else if (name == "get_sampling_profile") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = this->GetSamplingProfile();
+    });
   } else if (name == "run_from_inputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
@@ -597,10 +1388,32 @@ PackedFunc GraphExecutor::GetFunction(const std::string& name,
           }
           *rv = outputs;
         });
+  } else if (name == "run_in_context") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      CHECK(args.size() % 2 == 0)
+          << "Number of arguments to run_in_context must be an even number of key-value pairs";
+      Device host{static_cast<DLDeviceType>(args[0].operator int()), args[1].operator int()};
+      std::vector<std::pair<int, DLTensor*>> inputs;
+      for (int i = 2; i < args.size(); i += 2) {
+        int in_idx = 0;
+        if (String::CanConvertFrom(args[i])) {
+          in_idx = this->GetInputIndex(args[i].operator String());
+          CHECK_GE(in_idx, 0) << args[i].operator String() << " is not a valid input name";
+        } else {
+          in_idx = args[i];
+        }
+        inputs.emplace_back(in_idx, args[i + 1].operator DLTensor*());
+      }
+      *rv = this->RunInContext(inputs, host);
+    });
   } else if (name == "load_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       this->LoadParams(args[0].operator std::string());
     });
+  } else if (name == "load_params_from_file") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->LoadParamsFromFile(args[0].operator std::string());
+    });
   } else if (name == "share_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       const auto& module = args[0].operator Module();
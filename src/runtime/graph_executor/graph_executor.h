@@ -28,15 +28,22 @@
 #include <dlpack/dlpack.h>
 #include <dmlc/json.h>
 #include <dmlc/memory_io.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "../frame_streamer.h"
+#include "sampling_profiler.h"
+
 namespace tvm {
 namespace runtime {
 
@@ -68,6 +75,21 @@ class TVM_DLL GraphExecutor : public ModuleNode {
     std::vector<TVMValue> arg_values;
     std::vector<int> arg_tcodes;
     std::vector<int64_t> shape_data;
+    /*! \brief The compiled function called with the arguments, nullptr if there is none. */
+    TVMBackendPackedCFunc faddr{nullptr};
+  };
+  /*!
+   * \brief A call run by Run, the arguments pointing into the OpArgs of the node so that
+   *  the zero copy inputs and outputs are patched in place.
+   */
+  struct OpCall {
+    /*! \brief The node index. */
+    uint32_t nid;
+    /*! \brief The compiled function, nullptr for the nodes run through op_execs_. */
+    TVMBackendPackedCFunc faddr;
+    TVMValue* arg_values;
+    int* arg_tcodes;
+    int num_args;
   };
 
  public:
@@ -85,6 +107,160 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   const char* type_key() const final { return "GraphExecutor"; }
   void Run();
 
+  /*!
+   * \brief Set the maximum number of operators run concurrently by Run.
+   *
+   *  When larger than 1, Run dispatches the operators whose dependencies are met
+   *  onto that many tasks of the thread pool, and each operator gets its share of
+   *  the remaining workers for its own parallel loops. In a heterogeneous graph the ready
+   *  operators of the other devices are dispatched before those of the CPU, so that a long
+   *  CPU operator does not hold back the device.
+   * \param max_concurrent_ops The maximum number of concurrent operators, 1 runs
+   *  the operators one by one in graph order. It is clamped to the number of threads of
+   *  the thread pool.
+   */
+  void SetMaxConcurrentOps(int max_concurrent_ops);
+
+  /*!
+   * \brief Run the operators of Run in one parallel region of the thread pool.
+   *
+   *  The workers then go from the parallel loops of one operator to the next with a barrier
+   *  instead of being woken up by each of them, which pays off for the models made of many
+   *  short operators. They spin for the whole run, even during the serial operators.
+   * \param enable Whether to run the operators in a parallel region.
+   */
+  void SetPersistentParallelRegion(bool enable) { persistent_parallel_region_ = enable; }
+
+  /*!
+   * \brief Time the operators of one in every sample_period runs, for the monitoring of
+   *  deployed models. The histograms of the previous sampling are dropped.
+   * \param sample_period The sampling period, 0 stops sampling.
+   */
+  void SetSamplingProfiler(int sample_period);
+
+  /*!
+   * \brief Get the latency histograms of the operators gathered by the sampling profiler.
+   * \return The histograms in JSON, see SamplingProfiler::AsJSON.
+   */
+  std::string GetSamplingProfile() const;
+
+  /*!
+   * \brief Set the number of streams the operators on the accelerator are spread over.
+   *
+   *  When larger than 1, the branches of the graph are assigned to a pool of streams
+   *  created on the first non-CPU device, and the operators on different streams are
+   *  ordered by events inserted at the cross-stream edges. The default stream is used
+   *  to join the streams at the beginning and the end of Run.
+   * \param num_streams The number of streams, 1 launches every operator on the default stream.
+   */
+  void SetNumStreams(int num_streams);
+
+  /*!
+   * \brief Set the stream that Run, RunAsync and the input and output copies are queued on.
+   *
+   *  The stream belongs to the first non-CPU device. With a stream set, SetInput and
+   *  CopyOutputTo only enqueue their copies, so the host buffers must stay valid until
+   *  the stream has reached them.
+   * \param stream The stream, nullptr for the default stream of the device.
+   */
+  void SetStream(TVMStreamHandle stream);
+
+  /*! \return The stream set by SetStream. */
+  TVMStreamHandle GetStream() const { return run_stream_; }
+
+  /*!
+   * \brief Queue the whole graph on the stream and return without waiting for it.
+   *
+   *  The executor must stay alive, and its inputs and outputs untouched, until the
+   *  callback has been called.
+   * \param callback Called once the graph has finished. On devices that signal completion
+   *  asynchronously it runs on a driver thread, see DeviceAPI::StreamAddCallback.
+   */
+  void RunAsync(std::function<void()> callback);
+
+  /*!
+   * \brief Stage the host side of SetInput and CopyOutputTo in pinned host memory.
+   *
+   *  One page-locked buffer is allocated per input or output on a non-CPU device the
+   *  first time it is copied, and reused by the following runs, which lets the copies
+   *  run at full bus bandwidth and asynchronously on the executor stream. Devices
+   *  without pinned host memory keep copying from pageable memory.
+   * \param enable Whether to stage the copies, disabling it releases the buffers.
+   */
+  void SetPinnedStaging(bool enable);
+
+  /*!
+   * \brief Get the pinned staging buffer of an input.
+   *
+   *  Filling it directly and passing it to SetInput saves the host copy into it.
+   * \param index The input index.
+   * \return The buffer, undefined when the input is not staged.
+   */
+  NDArray GetInputStaging(int index);
+
+  /*!
+   * \brief Get the pinned staging buffer of an output.
+   *
+   *  CopyOutputTo into this buffer only enqueues the device copy on the executor
+   *  stream, the caller synchronizes the stream before reading it.
+   * \param index The output index.
+   * \return The buffer, undefined when the output is not staged.
+   */
+  NDArray GetOutputStaging(int index);
+
+  /*!
+   * \brief Start running the graph on a stream of frames, given by PushFrame.
+   *
+   *  A worker thread runs the frames in their order while the next ones are copied in,
+   *  each frame taking one of num_buffers sets of tensors. The other functions of the
+   *  executor must not be called until StopStreaming.
+   * \param num_buffers The number of tensor sets, at least 2.
+   * \param input_indices The inputs given by each frame, the others keep their value.
+   */
+  void StartStreaming(int num_buffers, const std::vector<int>& input_indices);
+
+  /*!
+   * \brief Copy the inputs of the next frame, waiting while all the tensor sets are in use.
+   * \param inputs One tensor per input given to StartStreaming.
+   */
+  void PushFrame(const std::vector<const DLTensor*>& inputs);
+
+  /*!
+   * \brief Wait for the outputs of the oldest frame not popped yet.
+   * \return The outputs, valid until the next PopFrame.
+   */
+  Array<NDArray> PopFrame();
+
+  /*! \brief Wait for the frames pushed and go back to the tensors of the executor. */
+  void StopStreaming();
+
+  /*!
+   * \brief Feed an output back as an input of the next run, such as the hidden state of a
+   *  recurrent or streaming convolutional model.
+   *
+   *  The input and the output swap their tensors after each run, so the state is not
+   *  copied. The input keeps its current value as the initial state, and get_input gives
+   *  the state the next run reads, which is also the output of the last run.
+   * \param input_index The input reading the state.
+   * \param output_index The output writing the next state.
+   */
+  void BindState(int input_index, int output_index);
+
+  /*!
+   * \brief Run the graph on some inputs, safe to call from several threads at once.
+   *
+   *  Each call checks out an execution context from a pool, and creates one when all are
+   *  in use. A context is an executor sharing the module and the parameters of this one,
+   *  with its own activations, so the calls only duplicate the activations. The parameters
+   *  must not be loaded again while calls are running.
+   * \param inputs The index and the value of the inputs set by the call.
+   * \param host The device the outputs are copied to.
+   * \return The outputs.
+   */
+  Array<NDArray> RunInContext(const std::vector<std::pair<int, DLTensor*>>& inputs, Device host);
+
+  ~GraphExecutor();
+
   /*!
    * \brief Initialize the graph executor with graph and device.
    * \param graph_json The execution graph.
@@ -100,6 +276,15 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   void Init(const std::string& graph_json, tvm::runtime::Module module,
             const std::vector<Device>& devs, const PackedFunc lookup_linked_param_func = nullptr);
 
+  /*!
+   * \brief Get the storage planned for every graph input without creating an executor.
+   * \param graph_json The execution graph.
+   * \return Map from input name to its (storage id, device type). The device type is -1
+   *  when the graph does not annotate devices.
+   */
+  static std::unordered_map<std::string, std::pair<int, int>> GetInputStorage(
+      const std::string& graph_json);
+
   /*!
    * \brief Get the input index given the name of input.
    * \param name The name of the input.
@@ -124,12 +309,14 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \brief set index-th input to the graph without copying the data
    * \param index The input index.
    * \param data_ref The input data that is referred.
+   * \note A strided or misaligned input is copied, as with SetInput.
    */
   void SetInputZeroCopy(int index, DLTensor* data_ref);
   /*!
    * \brief set index-th output to the graph without copying the data.
    * \param index The output index.
    * \param data_ref The output data that is referred.
+   * \note A strided or misaligned output is copied to data_ref at the end of each run.
    */
   void SetOutputZeroCopy(int index, DLTensor* data_ref);
   /*!
@@ -174,6 +361,14 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \param param_blob A binary blob of parameter.
    */
   void LoadParams(const std::string& param_blob);
+  /*!
+   * \brief Load parameters from a parameter file.
+   *
+   * The file is memory mapped; host parameters saved with the aligned layout are
+   * bound to the mapping directly instead of being copied into the executor storage.
+   * \param file_name The name of the parameter file.
+   */
+  void LoadParamsFromFile(const std::string& file_name);
 
   /*!
    * \brief Share parameters from pre-existing GraphExecutor instance.
@@ -198,6 +393,13 @@ class TVM_DLL GraphExecutor : public ModuleNode {
     int device_type;
     int param_data_entry;
     NDArray linked_param;
+    /*! \brief The memory scope, empty unless the storage is a texture. */
+    std::string scope;
+    /*! \brief The 2d extent and the element type of a texture storage. */
+    int64_t texture_width{0};
+    int64_t texture_height{0};
+    int64_t texture_channel{0};
+    DLDataType texture_dtype{kDLFloat, 32, 1};
     //    PoolEntry(int s, int dev_type, void* pre_linked_param) :
     //        size(s), device_type(dev_type), pre_linked_param(std::move(pre_linked_param)) {}
   };
@@ -291,7 +493,11 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   struct GraphAttr {
     size_t storage_num_not_alloctaed{0};
     std::vector<int> storage_id;
+    /*! \brief The byte offset of each entry in its storage, empty if they are all zero. */
+    std::vector<int64_t> storage_offset;
     std::vector<int> device_index;
+    /*! \brief The memory scope of each entry, empty if none is a texture. */
+    std::vector<std::string> storage_scope;
     std::vector<std::string> dltype;
     std::vector<std::vector<int64_t>> shape;
     // The graph attribute fields.
@@ -335,6 +541,22 @@ class TVM_DLL GraphExecutor : public ModuleNode {
           ICHECK(reader->NextArrayItem());
           reader->Read(&device_index);
           ICHECK(!reader->NextArrayItem());
+        } else if (key == "storage_offset") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_int");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&storage_offset);
+          ICHECK(!reader->NextArrayItem());
+        } else if (key == "storage_scope") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_str");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&storage_scope);
+          ICHECK(!reader->NextArrayItem());
         } else {
           reader->BeginArray();
           ICHECK(reader->NextArrayItem());
@@ -387,12 +609,49 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   }
   /*! \brief PackedFunc to lookup a linked paramter from a local Module. */
   void DefaultLookupLinkedParam(TVMArgs args, TVMRetValue* rv);
+  /*!
+   * \brief Give the storage of a data entry a private copy if it is a linked parameter.
+   * \param eid The data entry about to be written.
+   */
+  void DetachLinkedStorage(uint32_t eid);
   /*! \brief Delete NDArray::Container with linked (i.e. static) data. */
   static void LinkedNDArrayDeleter(Object* container);
+  /*!
+   * \brief Create the tensor of a data entry, viewing its storage at its offset.
+   * \param eid The data entry.
+   * \param dtype The data type of the entry.
+   */
+  NDArray CreateEntryView(uint32_t eid, DLDataType dtype);
   /*! \brief Setup the temporal storage */
   void SetupStorage();
   /*! \brief Setup the executors. */
   void SetupOpExecs();
+  /*!
+   * \brief Build the dependencies between operators used by the concurrent Run.
+   *  Besides the dataflow edges, an operator also waits for the earlier readers and
+   *  writers of the storage it writes, since the memory plan reuses storage in graph order.
+   */
+  void SetupOpDependencies();
+  /*!
+   * \brief Run the operators concurrently following the dependencies.
+   * \param sampled Whether the sampling profiler times this run.
+   */
+  void RunConcurrent(bool sampled);
+  /*!
+   * \brief Run the operators in graph order, spread over the streams.
+   * \param sampled Whether the sampling profiler times this run.
+   */
+  void RunMultiStream(bool sampled);
+  /*! \brief Release the streams created by SetNumStreams. */
+  void FreeStreams();
+  /*! \return The first non-CPU device, or the fallback device when there is none. */
+  Device AcceleratorDevice() const;
+  /*!
+   * \brief Get, allocating it on first use, the pinned staging buffer of an entry.
+   * \param eid The data entry index.
+   * \return The buffer, undefined when staging is off or does not apply to the entry.
+   */
+  NDArray GetStaging(uint32_t eid);
   /*!
    * \brief Check the legality of external DLTensor*.
    * \param external The external DLTensor*.
@@ -413,6 +672,10 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   uint32_t entry_id(const NodeEntry& e) const { return entry_id(e.node_id, e.index); }
   // Number of node entries.
   uint32_t num_node_entries() const { return node_row_ptr_.back(); }
+  // Get the entry holding an output after a run, the input entry for a state.
+  uint32_t output_entry_id(int index) const;
+  // Swap the entries of the states after a run.
+  void SwapStates();
   /*! \brief The graph nodes. */
   std::vector<Node> nodes_;
   /*! \brief The argument nodes. */
@@ -431,6 +694,8 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   std::vector<uint32_t> node_row_ptr_;
   /*! \brief Output entries. */
   std::vector<NodeEntry> outputs_;
+  /*! \brief The external tensors the outputs are copied to after a run, nullptr for none. */
+  std::vector<DLTensor*> output_copies_;
   /*! \brief Additional graph attributes. */
   GraphAttr attrs_;
   /*! \brief The code module that contains both host and device code. */
@@ -439,12 +704,60 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   std::vector<Device> devices_;
   /*! \brief Common storage pool for all devices. */
   std::vector<NDArray> storage_pool_;
+  /*!
+   * \brief Whether each storage pool entry is a linked parameter. Linked storage may be
+   *  shared with other executors, so it is copied before it is written.
+   */
+  std::vector<bool> storage_linked_;
   /*! \brief Data entry of each node. */
   std::vector<NDArray> data_entry_;
   /*! \brief Data alignment of each node. */
   std::vector<size_t> data_alignment_;
   /*! \brief Operator on each node. */
   std::vector<std::function<void()>> op_execs_;
+  /*! \brief The arguments of the operator on each node. */
+  std::vector<std::shared_ptr<OpArgs>> op_args_;
+  /*! \brief The operators run in order by Run, one per operator node. */
+  std::vector<OpCall> op_calls_;
+  /*! \brief The operators each node depends on. */
+  std::vector<std::vector<uint32_t>> op_predecessors_;
+  /*! \brief The operators depending on each node. */
+  std::vector<std::vector<uint32_t>> op_successors_;
+  /*! \brief The operators without dependencies. */
+  std::vector<uint32_t> op_roots_;
+  /*! \brief Whether each node runs on a device other than the CPU. */
+  std::vector<bool> op_on_accelerator_;
+  /*! \brief The maximum number of operators run concurrently. */
+  int max_concurrent_ops_{1};
+  /*! \brief Whether the operators run in order are in one parallel region. */
+  bool persistent_parallel_region_{false};
+  /*! \brief The device owning streams_. */
+  Device stream_device_;
+  /*! \brief The streams the accelerator operators are spread over. */
+  std::vector<TVMStreamHandle> streams_;
+  /*! \brief The index in streams_ of each node, -1 when it runs on the default stream. */
+  std::vector<int> op_stream_;
+  /*! \brief The profiler timing one in every few runs. */
+  SamplingProfiler sampling_profiler_;
+  /*! \brief The stream Run is queued on, nullptr for the default stream. */
+  TVMStreamHandle run_stream_{nullptr};
+  /*! \brief Whether the input and output copies are staged in pinned host memory. */
+  bool pinned_staging_{false};
+  /*! \brief The pinned staging buffer of each staged entry, undefined for unstaged ones. */
+  std::unordered_map<uint32_t, NDArray> staging_;
+  /*! \brief The streaming of frames, null when not streaming. */
+  std::unique_ptr<FrameStreamer> streamer_;
+  /*! \brief The inputs given by the streamed frames. */
+  std::vector<int> streamed_inputs_;
+  /*! \brief The graph, kept to create the execution contexts. */
+  std::string graph_json_;
+  /*! \brief The entries holding the parameters, shared by the execution contexts. */
+  std::unordered_set<uint32_t> param_eids_;
+  /*! \brief The execution contexts not in use, see RunInContext. */
+  std::vector<ObjectPtr<GraphExecutor>> free_contexts_;
+  std::mutex contexts_mutex_;
+  /*! \brief The input and output entries of each state bound by BindState. */
+  std::vector<std::pair<uint32_t, uint32_t>> states_;
   /*! \brief Linked parameter lookup function. */
   PackedFunc lookup_linked_param_;
   /*! \brief Module's _lookup_linked_param function, used by DefaultLookupLinkedParam. */
@@ -76,6 +76,9 @@ PackedFunc GraphExecutorFactory::GetFunction(
       exec->Import(this->imports_[0]);
       *rv = Module(exec);
     });
+  } else if (name == "set_share_params") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->SetShareParams(args[0]); });
   } else if (name == "cuda_graph_create") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       std::vector<Device> devices;
@@ -107,11 +110,49 @@ void GraphExecutorFactory::SaveToBinary(dmlc::Stream* stream) {
   stream->Write(module_name_);
 }
 
+PackedFunc GraphExecutorFactory::SharedParamsLookup(const std::vector<Device>& devs) {
+  std::vector<std::pair<int, int>> key;
+  for (const auto& dev : devs) {
+    key.emplace_back(static_cast<int>(dev.device_type), dev.device_id);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = shared_params_.find(key);
+  if (it == shared_params_.end()) {
+    std::unordered_map<int, NDArray> pool;
+    auto storage = GraphExecutor::GetInputStorage(this->graph_json_);
+    for (const auto& p : this->params_) {
+      auto sit = storage.find(p.first);
+      if (sit == storage.end()) continue;
+      // Place the param on the device its storage is planned on, as SetupStorage does.
+      auto dit = std::find_if(devs.begin(), devs.end(), [&sit](const Device& d) {
+        return sit->second.second == static_cast<int>(d.device_type);
+      });
+      Device dev = dit == devs.end() ? devs[0] : *dit;
+      NDArray param = NDArray::Empty(p.second.Shape(), p.second.DataType(), dev);
+      param.CopyFrom(p.second);
+      pool[sit->second.first] = param;
+    }
+    it = shared_params_.emplace(key, std::move(pool)).first;
+  }
+  std::unordered_map<int, NDArray> pool = it->second;
+  return PackedFunc([pool](TVMArgs args, TVMRetValue* rv) {
+    int storage_id = args[1];
+    auto it = pool.find(storage_id);
+    if (it != pool.end()) {
+      *rv = it->second;
+    }
+  });
+}
+
 Module GraphExecutorFactory::ExecutorCreate(const std::vector<Device>& devs) {
   auto exec = make_object<GraphExecutor>();
-  exec->Init(this->graph_json_, this->imports_[0], devs, PackedFunc());
-  // set params
-  SetParams(exec.get(), this->params_);
+  if (share_params_ && !this->params_.empty()) {
+    exec->Init(this->graph_json_, this->imports_[0], devs, SharedParamsLookup(devs));
+  } else {
+    exec->Init(this->graph_json_, this->imports_[0], devs, PackedFunc());
+    // set params
+    SetParams(exec.get(), this->params_);
+  }
   return Module(exec);
 }
 
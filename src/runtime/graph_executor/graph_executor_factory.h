@@ -32,9 +32,12 @@
 
 #include <algorithm>
 #include <functional>
+#include <map>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "./graph_executor.h"
@@ -75,12 +78,23 @@ class TVM_DLL GraphExecutorFactory : public runtime::ModuleNode {
 
   /*!
    * \brief Create a specific executor module
+   *
+   *  Once enabled with SetShareParams, every executor created for the same devices
+   *  links to one copy of the params owned by the factory; an executor only makes a
+   *  private copy of a param when it is overwritten through set_input or load_params,
+   *  writing into the array returned by get_input changes the params of all of them.
    * \param devs The device of the host and devices where graph nodes will be
    *  executed on.
    * \return created executor module
    */
   Module ExecutorCreate(const std::vector<Device>& devs);
 
+  /*!
+   * \brief Set whether ExecutorCreate links executors to shared params.
+   * \param share_params When false, the default, each executor gets its own copy of the params.
+   */
+  void SetShareParams(bool share_params) { share_params_ = share_params; }
+
   /*!
    * \brief Create a specific debug executor module
    * \param devs The device of the host and devices where graph nodes will be
@@ -125,12 +139,26 @@ class TVM_DLL GraphExecutorFactory : public runtime::ModuleNode {
   }
 
  protected:
+  /*!
+   * \brief Get the lookup linking an executor on devs to the shared params, creating the
+   *  shared copies on first use.
+   * \param devs The devices of the executor.
+   * \return The linked parameter lookup function passed to GraphExecutor::Init.
+   */
+  PackedFunc SharedParamsLookup(const std::vector<Device>& devs);
+
   /*! \brief The execution graph. */
   std::string graph_json_;
   /*! \brief The params. */
   std::unordered_map<std::string, tvm::runtime::NDArray> params_;
   /*! \brief module name */
   std::string module_name_;
+  /*! \brief Whether ExecutorCreate links executors to shared params. */
+  bool share_params_{false};
+  /*! \brief The shared params of each device list, by storage id. */
+  std::map<std::vector<std::pair<int, int>>, std::unordered_map<int, NDArray>> shared_params_;
+  /*! \brief Protects shared_params_ when executors are created concurrently. */
+  std::mutex mutex_;
 };
 
 }  // namespace runtime
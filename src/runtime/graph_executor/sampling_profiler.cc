@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file sampling_profiler.cc
+ * \brief Low overhead profiler timing the operators of one in every few graph runs.
+ */
+#include "sampling_profiler.h"
+
+#include <tvm/runtime/logging.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+
+void SamplingProfiler::Configure(int sample_period, std::vector<Device> op_devices) {
+  ICHECK_GE(sample_period, 0) << "SamplingProfiler: the sample period must not be negative";
+  sample_period_ = sample_period;
+  run_count_ = 0;
+  sampled_runs_ = 0;
+  op_devices_ = std::move(op_devices);
+  size_t num_nodes = op_devices_.size();
+  start_.assign(num_nodes, std::chrono::steady_clock::time_point());
+  elapsed_ns_.assign(num_nodes, -1);
+  timers_.assign(num_nodes, Timer());
+  histograms_.assign(num_nodes, Histogram());
+}
+
+void SamplingProfiler::EndRun() {
+  ++sampled_runs_;
+  for (size_t nid = 0; nid < op_devices_.size(); ++nid) {
+    int64_t ns = elapsed_ns_[nid];
+    if (timers_[nid].defined()) {
+      ns = timers_[nid]->SyncAndGetElapsedNanos();
+      timers_[nid] = Timer();
+    }
+    if (ns < 0) continue;
+    elapsed_ns_[nid] = -1;
+    Histogram& hist = histograms_[nid];
+    hist.min_ns = hist.count == 0 ? ns : std::min(hist.min_ns, ns);
+    hist.max_ns = std::max(hist.max_ns, ns);
+    hist.total_ns += ns;
+    ++hist.count;
+    int bucket = 0;
+    while (bucket + 1 < kNumBuckets && (ns >> (bucket + 1)) != 0) ++bucket;
+    ++hist.buckets[bucket];
+  }
+}
+
+double SamplingProfiler::Quantile(const Histogram& hist, double q) {
+  uint64_t rank = static_cast<uint64_t>(q * (hist.count - 1)) + 1;
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += hist.buckets[i];
+    if (seen >= rank) {
+      return std::min<double>(static_cast<double>(int64_t(1) << (i + 1)), hist.max_ns) / 1e3;
+    }
+  }
+  return hist.max_ns / 1e3;
+}
+
+std::string SamplingProfiler::AsJSON(const std::vector<std::string>& node_names) const {
+  std::ostringstream os;
+  os << std::setprecision(6) << std::fixed;
+  os << "{\"sample_period\":" << sample_period_ << ",\"sampled_runs\":" << sampled_runs_
+     << ",\"ops\":[";
+  bool first = true;
+  for (size_t nid = 0; nid < histograms_.size(); ++nid) {
+    const Histogram& hist = histograms_[nid];
+    if (hist.count == 0) continue;
+    if (!first) os << ",";
+    first = false;
+    os << "{\"name\":\"" << node_names[nid] << "\",\"count\":" << hist.count
+       << ",\"mean_us\":" << hist.total_ns / 1e3 / hist.count << ",\"min_us\":" << hist.min_ns / 1e3
+       << ",\"max_us\":" << hist.max_ns / 1e3 << ",\"p50_us\":" << Quantile(hist, 0.5)
+       << ",\"p99_us\":" << Quantile(hist, 0.99) << ",\"histogram\":[";
+    for (int i = 0; i < kNumBuckets; ++i) {
+      os << (i ? "," : "") << hist.buckets[i];
+    }
+    os << "]}";
+  }
+  os << "]}";
+  return os.str();
+}
+
+}  // namespace runtime
+}  // namespace tvm
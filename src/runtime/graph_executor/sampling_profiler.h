@@ -0,0 +1,126 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/graph_executor/sampling_profiler.h
+ * \brief Low overhead profiler timing the operators of one in every few graph runs.
+ */
+#ifndef TVM_RUNTIME_GRAPH_EXECUTOR_SAMPLING_PROFILER_H_
+#define TVM_RUNTIME_GRAPH_EXECUTOR_SAMPLING_PROFILER_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/profiling.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Times the operators of one in every sample_period runs and keeps a latency histogram
+ *  of each operator.
+ *
+ *  Unlike profiling::Profiler, it neither synchronizes the devices between the operators nor
+ *  allocates in the sampled runs: the host operators are timed with the steady clock and the
+ *  device ones with the device timers, read back at the end of the run. Each operator only
+ *  writes its own preallocated slot, so the operators run by the concurrent executor need no
+ *  lock either.
+ */
+class SamplingProfiler {
+ public:
+  /*! \brief The number of log2 latency buckets, the last one holding every longer run. */
+  static constexpr int kNumBuckets = 40;
+
+  /*!
+   * \brief Start sampling, dropping the previous histograms.
+   * \param sample_period Time one in every sample_period runs, 0 stops sampling.
+   * \param op_devices The device of each node, empty for the nodes which are not operators.
+   */
+  void Configure(int sample_period, std::vector<Device> op_devices);
+
+  /*! \return Whether the run starting is timed, BeginOp and EndOp are only called if so. */
+  bool BeginRun() {
+    if (sample_period_ == 0) return false;
+    return run_count_++ % sample_period_ == 0;
+  }
+
+  /*! \brief Called right before the operator of node nid is launched. */
+  void BeginOp(uint32_t nid) {
+    if (op_devices_[nid].device_type == kDLCPU) {
+      start_[nid] = std::chrono::steady_clock::now();
+    } else {
+      timers_[nid] = Timer::Start(op_devices_[nid]);
+    }
+  }
+
+  /*! \brief Called right after the operator of node nid is launched. */
+  void EndOp(uint32_t nid) {
+    if (op_devices_[nid].device_type == kDLCPU) {
+      elapsed_ns_[nid] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start_[nid])
+                             .count();
+    } else {
+      timers_[nid]->Stop();
+    }
+  }
+
+  /*! \brief Add the operator times of a timed run to the histograms. */
+  void EndRun();
+
+  /*!
+   * \brief Serialize the histograms.
+   * \param node_names The name of each node.
+   * \return A JSON object with the number of timed runs and, for each operator which ran,
+   *  its name, the number of samples, the mean, minimum, maximum, median and 99th percentile
+   *  latencies in microseconds and the sample count of each histogram bucket. Bucket i counts
+   *  the samples between 2^i and 2^(i+1) nanoseconds.
+   */
+  std::string AsJSON(const std::vector<std::string>& node_names) const;
+
+ private:
+  /*! \brief The samples of one operator. */
+  struct Histogram {
+    uint64_t count{0};
+    int64_t total_ns{0};
+    int64_t min_ns{0};
+    int64_t max_ns{0};
+    std::array<uint64_t, kNumBuckets> buckets{};
+  };
+
+  /*! \return An upper bound of the latency below which a fraction q of the samples fall. */
+  static double Quantile(const Histogram& hist, double q);
+
+  int sample_period_{0};
+  uint64_t run_count_{0};
+  uint64_t sampled_runs_{0};
+  std::vector<Device> op_devices_;
+  std::vector<std::chrono::steady_clock::time_point> start_;
+  std::vector<int64_t> elapsed_ns_;
+  std::vector<Timer> timers_;
+  std::vector<Histogram> histograms_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_GRAPH_EXECUTOR_SAMPLING_PROFILER_H_
@@ -27,6 +27,7 @@
 #include <utility>
 
 #include "hexagon_common.h"
+#include "hexagon_vtcm_pool.h"
 
 namespace tvm {
 namespace runtime {
@@ -57,13 +58,20 @@ HexagonBuffer::HexagonBuffer(int ndim, const int64_t* shape, DLDataType dtype,
 }
 
 HexagonBuffer::HexagonBuffer(size_t nbytes, size_t alignment, Optional<String> scope) {
+  SetStorageScope(scope);
   void* ptr = nullptr;
-  int ret = posix_memalign(&ptr, alignment, nbytes);
-  if (ret != 0) {
-    throw std::bad_alloc();
+  if (storage_scope_ == StorageScope::kVTCM) {
+    ptr = HexagonVtcmPool::Global()->Allocate(nbytes, alignment);
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+  } else {
+    int ret = posix_memalign(&ptr, alignment, nbytes);
+    if (ret != 0) {
+      throw std::bad_alloc();
+    }
   }
   allocations_.push_back(ptr);
-  SetStorageScope(scope);
 }
 
 HexagonBuffer::HexagonBuffer(void* data, Optional<String> scope) : managed_{false} {
@@ -74,7 +82,11 @@ HexagonBuffer::HexagonBuffer(void* data, Optional<String> scope) : managed_{fals
 HexagonBuffer::~HexagonBuffer() {
   if (managed_) {
     for (auto& ptr : allocations_) {
-      free(ptr);
+      if (storage_scope_ == StorageScope::kVTCM) {
+        HexagonVtcmPool::Global()->Free(ptr);
+      } else {
+        free(ptr);
+      }
     }
   }
 }
@@ -31,10 +31,13 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <string>
 
 #include "../../workspace_pool.h"
 #include "hexagon_buffer.h"
 #include "hexagon_common.h"
+#include "hexagon_user_dma.h"
+#include "hexagon_vtcm_pool.h"
 
 namespace tvm {
 namespace runtime {
@@ -90,15 +93,10 @@ void HexagonDeviceAPIv2::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamH
   if (IsHexagonDevice(from->device) && IsHexagonDevice(to->device)) {
     HexagonBuffer* buffer_src = static_cast<HexagonBuffer*>(from->data);
     HexagonBuffer* buffer_dst = static_cast<HexagonBuffer*>(to->data);
-    // Check storage scopes
-    if (buffer_src->GetStorageScope() == HexagonBuffer::StorageScope::kDDR &&
-        buffer_dst->GetStorageScope() == HexagonBuffer::StorageScope::kDDR) {
-      memcpy(static_cast<char*>(buffer_dst->GetPointer()) + to->byte_offset,
-             static_cast<const char*>(buffer_src->GetPointer()) + from->byte_offset,
-             GetDataSize(*from));
-    } else {
-      ICHECK(false) << "Currently only copying between DDR storage is supported.";
-    }
+    // The VTCM is mapped in the address space, so any storage scopes are copied the same way.
+    memcpy(static_cast<char*>(buffer_dst->GetPointer()) + to->byte_offset,
+           static_cast<const char*>(buffer_src->GetPointer()) + from->byte_offset,
+           GetDataSize(*from));
   } else if (IsHexagonDevice(from->device) && to->device.device_type == kDLCPU) {
     HexagonBuffer* buffer_src = static_cast<HexagonBuffer*>(from->data);
     memcpy(static_cast<char*>(to->data) + to->byte_offset,
@@ -121,6 +119,40 @@ void HexagonDeviceAPIv2::CopyDataFromTo(const void* from, size_t from_offset, vo
   memcpy(static_cast<char*>(to) + to_offset, static_cast<const char*>(from) + from_offset, size);
 }
 
+// The allocation of the buffers of global.vtcm scope, called by the code LowerTVMBuiltin emits.
+TVM_REGISTER_GLOBAL("device_api.hexagon.AllocVtcm").set_body([](TVMArgs args, TVMRetValue* rv) {
+  uint64_t nbytes = args[2];
+  void* ptr = HexagonVtcmPool::Global()->Allocate(nbytes, kHexagonVtcmAlignment);
+  if (ptr == nullptr) {
+    TVMAPISetLastError(("Failed to allocate " + std::to_string(nbytes) + " bytes of VTCM").c_str());
+  }
+  *rv = ptr;
+});
+
+TVM_REGISTER_GLOBAL("device_api.hexagon.FreeVtcm").set_body([](TVMArgs args, TVMRetValue* rv) {
+  HexagonVtcmPool::Global()->Free(args[2].operator void*());
+  *rv = static_cast<int32_t>(0);
+});
+
+// The asynchronous copies, called by the code LowerTVMBuiltin emits for the DMA builtins.
+TVM_REGISTER_GLOBAL("device_api.hexagon.DMACopy").set_body([](TVMArgs args, TVMRetValue* rv) {
+  int64_t nbytes = args[3];
+  HexagonUserDMA::ThreadLocal()->Copy(args[0], args[1].operator void*(), args[2].operator void*(),
+                                      nbytes);
+  *rv = static_cast<int32_t>(0);
+});
+
+TVM_REGISTER_GLOBAL("device_api.hexagon.DMACommitGroup")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      HexagonUserDMA::ThreadLocal()->CommitGroup(args[0]);
+      *rv = static_cast<int32_t>(0);
+    });
+
+TVM_REGISTER_GLOBAL("device_api.hexagon.DMAWaitGroup").set_body([](TVMArgs args, TVMRetValue* rv) {
+  HexagonUserDMA::ThreadLocal()->WaitGroup(args[0], args[1]);
+  *rv = static_cast<int32_t>(0);
+});
+
 TVM_REGISTER_GLOBAL("device_api.hexagon.v2").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = HexagonDeviceAPIv2::Global();
   *rv = static_cast<void*>(ptr);
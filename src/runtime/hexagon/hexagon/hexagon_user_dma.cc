@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file hexagon_user_dma.cc
+ */
+#define TVM_LOG_CUSTOMIZE 1
+
+#include "hexagon_user_dma.h"
+
+#include <dmlc/thread_local.h>
+#include <tvm/runtime/logging.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace tvm {
+namespace runtime {
+namespace hexagon {
+
+#if defined(__hexagon__) && defined(__HEXAGON_ARCH__) && __HEXAGON_ARCH__ >= 68
+#define TVM_HEXAGON_USER_DMA 1
+#endif
+
+//! \brief The number of descriptors of each thread.
+constexpr size_t kNumDMADescriptors = 256;
+//! \brief The longest copy of one descriptor.
+constexpr size_t kMaxDMALength = 0x00FFFFFF;
+
+//! \brief The fields of HexagonDMADescriptor::config.
+constexpr uint32_t kDMADescDone = 0x80000000;
+constexpr uint32_t kDMADescOrdered = 0x40000000;
+constexpr uint32_t kDMADescLengthMask = 0x00FFFFFF;
+
+#if defined(TVM_HEXAGON_USER_DMA)
+inline void DMStart(void* next) {
+  asm volatile(" release(%0):at" : : "r"(next));
+  asm volatile(" dmstart(%0)" : : "r"(next));
+}
+
+inline void DMLink(void* tail, void* next) {
+  asm volatile(" release(%0):at" : : "r"(next));
+  asm volatile(" dmlink(%0, %1)" : : "r"(tail), "r"(next));
+}
+
+inline uint32_t DMPoll() {
+  uint32_t ret = 0;
+  asm volatile(" %0 = dmpoll" : "=r"(ret) : : "memory");
+  return ret;
+}
+#endif
+
+HexagonUserDMA* HexagonUserDMA::ThreadLocal() {
+  return dmlc::ThreadLocalStore<HexagonUserDMA>::Get();
+}
+
+HexagonUserDMA::HexagonUserDMA() {
+  void* ptr = nullptr;
+  CHECK_EQ(posix_memalign(&ptr, 64, kNumDMADescriptors * sizeof(HexagonDMADescriptor)), 0)
+      << "Failed to allocate the DMA descriptors";
+  descriptors_ = static_cast<HexagonDMADescriptor*>(ptr);
+  for (size_t i = 0; i < kNumDMADescriptors; ++i) {
+    descriptors_[i].config = kDMADescDone;
+  }
+}
+
+HexagonUserDMA::~HexagonUserDMA() {
+  for (size_t i = 0; i < kNumDMADescriptors; ++i) {
+    Wait(&descriptors_[i]);
+  }
+  free(descriptors_);
+}
+
+void HexagonUserDMA::Wait(HexagonDMADescriptor* desc) {
+  volatile uint32_t* config = &desc->config;
+  while ((*config & kDMADescDone) == 0) {
+#if defined(TVM_HEXAGON_USER_DMA)
+    DMPoll();
+#endif
+  }
+  if (desc == tail_) tail_ = nullptr;
+}
+
+HexagonDMADescriptor* HexagonUserDMA::NextDescriptor() {
+  HexagonDMADescriptor* desc = &descriptors_[next_index_];
+  next_index_ = (next_index_ + 1) % kNumDMADescriptors;
+  // the ring is in chain order, so the oldest copies are waited for first
+  Wait(desc);
+  return desc;
+}
+
+void HexagonUserDMA::Copy(int queue_id, void* dst, const void* src, size_t nbytes) {
+  Queue& queue = queues_[queue_id];
+  char* dst_bytes = static_cast<char*>(dst);
+  const char* src_bytes = static_cast<const char*>(src);
+  while (nbytes > 0) {
+    size_t length = std::min(nbytes, kMaxDMALength);
+    HexagonDMADescriptor* desc = NextDescriptor();
+#if defined(TVM_HEXAGON_USER_DMA)
+    desc->next = 0;
+    desc->src = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(src_bytes));
+    desc->dst = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(dst_bytes));
+    // a one dimensional descriptor
+    desc->config = kDMADescOrdered | (static_cast<uint32_t>(length) & kDMADescLengthMask);
+    if (tail_ == nullptr) {
+      DMStart(desc);
+    } else {
+      DMLink(tail_, desc);
+    }
+    tail_ = desc;
+#else
+    std::memcpy(dst_bytes, src_bytes, length);
+#endif
+    queue.pending.push_back(desc);
+    dst_bytes += length;
+    src_bytes += length;
+    nbytes -= length;
+  }
+}
+
+void HexagonUserDMA::CommitGroup(int queue_id) {
+  Queue& queue = queues_[queue_id];
+  queue.groups.emplace_back(std::move(queue.pending));
+  queue.pending.clear();
+}
+
+void HexagonUserDMA::WaitGroup(int queue_id, int num_pending) {
+  Queue& queue = queues_[queue_id];
+  while (queue.groups.size() > static_cast<size_t>(std::max(num_pending, 0))) {
+    // a descriptor reused since its group was committed belongs to a later copy, waiting for
+    // it only waits longer, as the copies complete in order
+    for (HexagonDMADescriptor* desc : queue.groups.front()) {
+      Wait(desc);
+    }
+    queue.groups.pop_front();
+  }
+}
+
+}  // namespace hexagon
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file hexagon_user_dma.h
+ * \brief Asynchronous copies with the user DMA engine of Hexagon.
+ */
+#ifndef TVM_RUNTIME_HEXAGON_HEXAGON_HEXAGON_USER_DMA_H_
+#define TVM_RUNTIME_HEXAGON_HEXAGON_HEXAGON_USER_DMA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace hexagon {
+
+/*! \brief A one dimensional descriptor of the user DMA engine. */
+struct alignas(16) HexagonDMADescriptor {
+  //! \brief The next descriptor of the chain, 0 at its end.
+  uint32_t next;
+  //! \brief The state, the ordering, the cache bypasses, the type and the length.
+  uint32_t config;
+  //! \brief The source and destination addresses.
+  uint32_t src;
+  uint32_t dst;
+};
+
+/*!
+ * \brief The DMA copies started by one thread, which owns a DMA engine.
+ *
+ *  The copies are chained in one descriptor list, so they complete in order. Each queue
+ *  commits its copies to groups, and waiting for a queue polls the descriptors of its oldest
+ *  groups. Without a user DMA engine, before v68, the copies are done when they start.
+ */
+class HexagonUserDMA {
+ public:
+  //! \brief Retrieve the instance of the current thread.
+  static HexagonUserDMA* ThreadLocal();
+
+  HexagonUserDMA();
+  ~HexagonUserDMA();
+
+  /*! \brief Start a copy.
+   *  \param queue_id The queue of the copy.
+   *  \param dst The destination.
+   *  \param src The source.
+   *  \param nbytes The number of bytes to copy.
+   */
+  void Copy(int queue_id, void* dst, const void* src, size_t nbytes);
+
+  //! \brief Commit the copies of a queue started since the last commit to a new group.
+  void CommitGroup(int queue_id);
+
+  //! \brief Wait until at most num_pending of the groups of a queue are not complete.
+  void WaitGroup(int queue_id, int num_pending);
+
+ private:
+  //! \brief Take a free descriptor, waiting for the oldest one when all are in flight.
+  HexagonDMADescriptor* NextDescriptor();
+
+  //! \brief Wait for a descriptor to complete.
+  void Wait(HexagonDMADescriptor* desc);
+
+  //! \brief The descriptors, used in a ring.
+  HexagonDMADescriptor* descriptors_{nullptr};
+  size_t next_index_{0};
+  //! \brief The last descriptor of the chain, nullptr when the engine is idle.
+  HexagonDMADescriptor* tail_{nullptr};
+
+  //! \brief The copies started and not committed, and the committed groups, of each queue.
+  struct Queue {
+    std::vector<HexagonDMADescriptor*> pending;
+    std::deque<std::vector<HexagonDMADescriptor*>> groups;
+  };
+  std::unordered_map<int, Queue> queues_;
+};
+
+}  // namespace hexagon
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_HEXAGON_HEXAGON_HEXAGON_USER_DMA_H_
@@ -0,0 +1,126 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file hexagon_vtcm_pool.cc
+ */
+#define TVM_LOG_CUSTOMIZE 1
+
+#include "hexagon_vtcm_pool.h"
+
+#include <tvm/runtime/logging.h>
+
+#include <cstdlib>
+#include <iterator>
+#include <utility>
+
+#include "hexagon_common.h"
+
+#if defined(__hexagon__)
+#include <HAP_vtcm_mgr.h>
+#endif
+
+namespace tvm {
+namespace runtime {
+namespace hexagon {
+
+//! \brief The size of the region emulating the VTCM when not built for Hexagon.
+constexpr size_t kEmulatedVtcmBytes = 4 << 20;
+
+HexagonVtcmPool* HexagonVtcmPool::Global() {
+  static auto* inst = new HexagonVtcmPool();
+  return inst;
+}
+
+HexagonVtcmPool::~HexagonVtcmPool() {
+  if (base_ == nullptr) return;
+#if defined(__hexagon__)
+  HEXAGON_SAFE_CALL(HAP_release_VTCM(base_));
+#else
+  free(base_);
+#endif
+}
+
+void HexagonVtcmPool::Init() {
+#if defined(__hexagon__)
+  unsigned int page_size = 0;
+  unsigned short page_count = 0;  // NOLINT(runtime/int)
+  HEXAGON_SAFE_CALL(HAP_query_total_VTCM(&page_size, &page_count));
+  total_bytes_ = static_cast<size_t>(page_size) * page_count;
+  base_ = static_cast<char*>(HAP_request_VTCM(total_bytes_, /*single_page_flag=*/1));
+#else
+  total_bytes_ = kEmulatedVtcmBytes;
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, kHexagonVtcmAlignment, total_bytes_) == 0) base_ = static_cast<char*>(ptr);
+#endif
+  CHECK(base_ != nullptr) << "Failed to acquire " << total_bytes_ << " bytes of VTCM";
+  free_[0] = total_bytes_;
+}
+
+void* HexagonVtcmPool::Allocate(size_t nbytes, size_t alignment) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (base_ == nullptr) Init();
+  nbytes = nbytes == 0 ? 1 : nbytes;
+  for (auto it = free_.begin(); it != free_.end(); ++it) {
+    size_t begin = it->first;
+    size_t end = begin + it->second;
+    size_t address = reinterpret_cast<size_t>(base_) + begin;
+    size_t start = begin + ((alignment - address % alignment) % alignment);
+    if (start + nbytes > end) continue;
+    size_t alloc_end = start + nbytes;
+    free_.erase(it);
+    if (end > alloc_end) free_[alloc_end] = end - alloc_end;
+    void* ptr = base_ + start;
+    // the alignment padding in front is freed together with the allocation
+    allocated_[ptr] = {begin, alloc_end - begin};
+    return ptr;
+  }
+  return nullptr;
+}
+
+void HexagonVtcmPool::Free(void* ptr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = allocated_.find(ptr);
+  CHECK(it != allocated_.end()) << "Attempt made to free unknown or already freed VTCM";
+  size_t begin = it->second.first;
+  size_t size = it->second.second;
+  allocated_.erase(it);
+  auto next = free_.lower_bound(begin);
+  if (next != free_.end() && next->first == begin + size) {
+    size += next->second;
+    next = free_.erase(next);
+  }
+  if (next != free_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == begin) {
+      prev->second += size;
+      return;
+    }
+  }
+  free_[begin] = size;
+}
+
+bool HexagonVtcmPool::Contains(const void* ptr) const {
+  const char* p = static_cast<const char*>(ptr);
+  return base_ != nullptr && p >= base_ && p < base_ + total_bytes_;
+}
+
+}  // namespace hexagon
+}  // namespace runtime
+}  // namespace tvm
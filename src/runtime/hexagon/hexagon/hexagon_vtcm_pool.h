@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file hexagon_vtcm_pool.h
+ * \brief Allocator of the vector tightly coupled memory (VTCM) of Hexagon.
+ */
+#ifndef TVM_RUNTIME_HEXAGON_HEXAGON_HEXAGON_VTCM_POOL_H_
+#define TVM_RUNTIME_HEXAGON_HEXAGON_HEXAGON_VTCM_POOL_H_
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+namespace tvm {
+namespace runtime {
+namespace hexagon {
+
+//! \brief The alignment of the VTCM allocations of the generated code.
+constexpr size_t kHexagonVtcmAlignment = 2048;
+
+/*!
+ * \brief A pool sub-allocating one VTCM region.
+ *
+ *  Requesting VTCM from the OS is slow and done by whole pages, so the pool requests the
+ *  whole VTCM once, at the first allocation, and then serves the allocations from it with a
+ *  first fit free list. When not built for Hexagon, the region is ordinary memory, so the
+ *  pool can be exercised on the host.
+ */
+class HexagonVtcmPool {
+ public:
+  //! \brief Retrieve the global singleton instance of the pool.
+  static HexagonVtcmPool* Global();
+
+  //! \brief Release the VTCM region.
+  ~HexagonVtcmPool();
+
+  /*! \brief Allocate from the VTCM.
+   *  \param nbytes The number of bytes to allocate.
+   *  \param alignment The byte alignment, a power of two.
+   *  \returns The allocation, or nullptr when the VTCM left is not enough.
+   */
+  void* Allocate(size_t nbytes, size_t alignment);
+
+  //! \brief Free an allocation of the pool.
+  void Free(void* ptr);
+
+  //! \brief Check whether a pointer is in the VTCM region.
+  bool Contains(const void* ptr) const;
+
+  //! \brief The size of the VTCM region in bytes, 0 before the first allocation.
+  size_t TotalBytes() const { return total_bytes_; }
+
+ private:
+  //! \brief Request the VTCM region.
+  void Init();
+
+  //! \brief The start of the VTCM region.
+  char* base_{nullptr};
+  //! \brief The size of the VTCM region in bytes.
+  size_t total_bytes_{0};
+  //! \brief The free ranges of the region, by offset then size, coalesced.
+  std::map<size_t, size_t> free_;
+  //! \brief The allocations, with the range they took from free_.
+  std::map<void*, std::pair<size_t, size_t>> allocated_;
+  std::mutex mutex_;
+};
+
+}  // namespace hexagon
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_HEXAGON_HEXAGON_HEXAGON_VTCM_POOL_H_
@@ -27,6 +27,7 @@
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
 
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -71,8 +72,13 @@ class ModuleInternal {
   static std::vector<Module>* GetImportsAddr(ModuleNode* node) { return &(node->imports_); }
 };
 
-PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
-  return PackedFunc([faddr, sptr_to_self](TVMArgs args, TVMRetValue* rv) {
+// The body of the packed functions created by WrapPackedFunc, a named type so that
+// GetBackendPackedCFunc can find the function address back.
+struct BackendPackedCFuncCaller {
+  TVMBackendPackedCFunc faddr;
+  ObjectPtr<Object> sptr_to_self;
+
+  void operator()(TVMArgs args, TVMRetValue* rv) const {
     TVMValue ret_value;
     int ret_type_code = kTVMNullptr;
     int ret = (*faddr)(const_cast<TVMValue*>(args.values), const_cast<int*>(args.type_codes),
@@ -81,7 +87,17 @@ PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>&
     if (ret_type_code != kTVMNullptr) {
       *rv = TVMRetValue::MoveFromCHost(ret_value, ret_type_code);
     }
-  });
+  }
+};
+
+PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
+  return PackedFunc(BackendPackedCFuncCaller{faddr, sptr_to_self});
+}
+
+TVMBackendPackedCFunc GetBackendPackedCFunc(const PackedFunc& pf) {
+  PackedFunc::FType body = pf.body();
+  const BackendPackedCFuncCaller* caller = body.target<BackendPackedCFuncCaller>();
+  return caller == nullptr ? nullptr : caller->faddr;
 }
 
 void InitContextFunctions(std::function<void*(const char*)> fgetsymbol) {
@@ -123,6 +139,59 @@ Module LoadModuleFromBinary(const std::string& type_key, dmlc::Stream* stream) {
   return (*f)(static_cast<void*>(stream));
 }
 
+/*!
+ * \brief A module of a library blob, deserialized when it is first used.
+ *
+ *  The device modules upload their binaries when their functions are first called, but
+ *  deserializing them copies and parses the binaries of all the kernels. Deferring it makes
+ *  loading a library cheap when only some of its modules are used.
+ */
+class LazyModuleNode final : public ModuleNode {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param type_key The type key of the module.
+   * \param data The output of the module SaveToBinary, in the blob of lib.
+   * \param size The size of data in bytes.
+   * \param lib The library, which holds data alive.
+   */
+  LazyModuleNode(std::string type_key, const char* data, size_t size, ObjectPtr<Library> lib)
+      : type_key_(std::move(type_key)), data_(data), size_(size), lib_(std::move(lib)) {}
+
+  const char* type_key() const final { return type_key_.c_str(); }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    // the imports are shared with the loaded module, querying them here would be redundant.
+    return Load()->GetFunction(name, false);
+  }
+
+  void SaveToFile(const std::string& file_name, const std::string& format) final {
+    Load()->SaveToFile(file_name, format);
+  }
+
+  void SaveToBinary(dmlc::Stream* stream) final { stream->Write(data_, size_); }
+
+  std::string GetSource(const std::string& format) final { return Load()->GetSource(format); }
+
+ private:
+  Module Load() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!module_.defined()) {
+      dmlc::MemoryFixedSizeStream fs(const_cast<char*>(data_), size_);
+      module_ = LoadModuleFromBinary(type_key_, &fs);
+      *ModuleInternal::GetImportsAddr(module_.operator->()) = imports_;
+    }
+    return module_;
+  }
+
+  std::string type_key_;
+  const char* data_;
+  size_t size_;
+  ObjectPtr<Library> lib_;
+  std::mutex mutex_;
+  Module module_;
+};
+
 /*!
  * \brief Load and append module blob to module list
  * \param mblob The module blob.
@@ -161,6 +230,17 @@ void ProcessModuleBlob(const char* mblob, ObjectPtr<Library> lib,
       modules.emplace_back(dso_module);
       ICHECK_EQ(num_dso_module, 1U) << "Multiple dso module detected, please upgrade tvm "
                                     << " to the latest before exporting the module";
+    } else if (tkey == "_lazy") {
+      // a module serialized with its size, so it can be skipped until it is used
+      std::string type_key;
+      uint64_t size;
+      ICHECK(stream->Read(&type_key));
+      ICHECK(stream->Read(&size));
+      size_t offset = fs.Tell();
+      ICHECK_LE(offset + size, nbytes) << "ProcessModuleBlob: truncated module " << type_key;
+      fs.Seek(offset + size);
+      modules.emplace_back(make_object<LazyModuleNode>(type_key, mblob + sizeof(nbytes) + offset,
+                                                       size, lib));
     } else if (tkey == "_import_tree") {
       ICHECK(stream->Read(&import_tree_row_ptr));
       ICHECK(stream->Read(&import_tree_child_indices));
@@ -72,6 +72,15 @@ class Library : public Object {
  */
 PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& mptr);
 
+/*!
+ * \brief Get the function address wrapped by WrapPackedFunc, so that the executors can call
+ *  a compiled function with arguments packed once instead of through TVMArgs on every call.
+ * \param pf The packed function.
+ * \return The function address, nullptr if pf was not created by WrapPackedFunc.
+ * \note The caller must keep pf alive while it uses the address, pf holding its module.
+ */
+TVMBackendPackedCFunc GetBackendPackedCFunc(const PackedFunc& pf);
+
 /*!
  * \brief Utility to initialize conext function symbols during startup
  * \param fgetsymbol A symbol lookup function.
@@ -0,0 +1,143 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file memory_stats.cc
+ * \brief The counters of the memory held by the runtime allocators on each device.
+ */
+#include "memory_stats.h"
+
+#include <tvm/runtime/registry.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+
+void MemoryCounter::Update(int64_t delta) {
+  int64_t current = current_bytes_.fetch_add(delta, std::memory_order_relaxed) + delta;
+  int64_t peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (current > peak &&
+         !peak_bytes_.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+  }
+}
+
+void MemoryCounter::RecordAlloc(size_t nbytes) {
+  int bucket = 0;
+  while (bucket + 1 < kNumBuckets && (nbytes >> (bucket + 1)) != 0) ++bucket;
+  histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+  num_allocs_.fetch_add(1, std::memory_order_relaxed);
+  Update(static_cast<int64_t>(nbytes));
+  if (total_ != nullptr) total_->RecordAlloc(nbytes);
+}
+
+void MemoryCounter::RecordFree(size_t nbytes) {
+  num_frees_.fetch_add(1, std::memory_order_relaxed);
+  Update(-static_cast<int64_t>(nbytes));
+  if (total_ != nullptr) total_->RecordFree(nbytes);
+}
+
+void MemoryCounter::ResetPeak() {
+  peak_bytes_.store(current_bytes_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+namespace {
+struct MemoryStatsRegistry {
+  std::mutex mutex;
+  /*! \brief The counters by device then allocator name. */
+  std::map<std::pair<int, int>, std::map<std::string, std::unique_ptr<MemoryCounter>>> counters;
+
+  static MemoryStatsRegistry* Global() {
+    // never destroyed, the allocators may still free memory at exit
+    static auto* inst = new MemoryStatsRegistry();
+    return inst;
+  }
+};
+}  // namespace
+
+MemoryCounter* MemoryStats::Get(Device dev, const std::string& allocator) {
+  MemoryStatsRegistry* registry = MemoryStatsRegistry::Global();
+  std::lock_guard<std::mutex> lock(registry->mutex);
+  auto& counters = registry->counters[{static_cast<int>(dev.device_type), dev.device_id}];
+  std::unique_ptr<MemoryCounter>& total = counters[kMemoryTotal];
+  if (total == nullptr) total.reset(new MemoryCounter());
+  std::unique_ptr<MemoryCounter>& counter = counters[allocator];
+  if (counter == nullptr) {
+    counter.reset(new MemoryCounter());
+    counter->total_ = total.get();
+  }
+  return counter.get();
+}
+
+void MemoryStats::ResetPeaks() {
+  MemoryStatsRegistry* registry = MemoryStatsRegistry::Global();
+  std::lock_guard<std::mutex> lock(registry->mutex);
+  for (auto& dev_kv : registry->counters) {
+    for (auto& kv : dev_kv.second) {
+      kv.second->ResetPeak();
+    }
+  }
+}
+
+std::string MemoryStats::AsJSON() {
+  MemoryStatsRegistry* registry = MemoryStatsRegistry::Global();
+  std::lock_guard<std::mutex> lock(registry->mutex);
+  std::ostringstream os;
+  os << "{";
+  bool first_dev = true;
+  for (const auto& dev_kv : registry->counters) {
+    os << (first_dev ? "" : ",") << "\"" << DeviceName(dev_kv.first.first)
+       << dev_kv.first.second << "\":{";
+    first_dev = false;
+    bool first_counter = true;
+    for (const auto& kv : dev_kv.second) {
+      const MemoryCounter& counter = *kv.second;
+      os << (first_counter ? "" : ",") << "\"" << kv.first << "\":{"
+         << "\"current_bytes\":" << counter.current_bytes()
+         << ",\"peak_bytes\":" << counter.peak_bytes() << ",\"num_allocs\":" << counter.num_allocs()
+         << ",\"num_frees\":" << counter.num_frees() << ",\"histogram\":{";
+      first_counter = false;
+      bool first_bucket = true;
+      for (int i = 0; i < MemoryCounter::kNumBuckets; ++i) {
+        if (counter.histogram(i) == 0) continue;
+        // keyed by the lower bound of the bucket
+        os << (first_bucket ? "" : ",") << "\"" << (static_cast<uint64_t>(1) << i)
+           << "\":" << counter.histogram(i);
+        first_bucket = false;
+      }
+      os << "}}";
+    }
+    os << "}";
+  }
+  os << "}";
+  return os.str();
+}
+
+TVM_REGISTER_GLOBAL("runtime.GetMemoryStatistics").set_body_typed([]() -> String {
+  return MemoryStats::AsJSON();
+});
+
+TVM_REGISTER_GLOBAL("runtime.ResetMemoryPeaks").set_body_typed(MemoryStats::ResetPeaks);
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file memory_stats.h
+ * \brief The counters of the memory held by the runtime allocators on each device.
+ */
+#ifndef TVM_RUNTIME_MEMORY_STATS_H_
+#define TVM_RUNTIME_MEMORY_STATS_H_
+
+#include <tvm/runtime/device_api.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief The NDArray allocations, made by NDArray::Empty. */
+constexpr const char* kMemoryNDArray = "ndarray";
+/*! \brief The blocks of the workspace pools. */
+constexpr const char* kMemoryWorkspace = "workspace";
+/*! \brief The device allocations of the VM allocators. */
+constexpr const char* kMemoryVMNaive = "vm_naive";
+constexpr const char* kMemoryVMPooled = "vm_pooled";
+constexpr const char* kMemoryVMSlab = "vm_slab";
+/*! \brief The images of the OpenCL texture pools. */
+constexpr const char* kMemoryTexture = "texture";
+/*! \brief The sum of the allocators of a device. */
+constexpr const char* kMemoryTotal = "total";
+
+/*!
+ * \brief The bytes one allocator holds on one device, updated without a lock.
+ *
+ *  Each allocation is also counted by the total counter of the device, so the peak of the
+ *  device is the peak of the sum and not the sum of the peaks.
+ */
+class MemoryCounter {
+ public:
+  /*! \brief The number of histogram buckets, bucket i counts the sizes in [2^i, 2^(i+1)). */
+  static constexpr int kNumBuckets = 48;
+  /*!
+   * \brief Count an allocation.
+   * \param nbytes The size of the allocation.
+   */
+  void RecordAlloc(size_t nbytes);
+  /*!
+   * \brief Count a free.
+   * \param nbytes The size of the freed allocation.
+   */
+  void RecordFree(size_t nbytes);
+  /*! \brief Set the peak to the current bytes. */
+  void ResetPeak();
+  /*! \return The bytes currently allocated. */
+  int64_t current_bytes() const { return current_bytes_.load(std::memory_order_relaxed); }
+  /*! \return The peak of the bytes allocated. */
+  int64_t peak_bytes() const { return peak_bytes_.load(std::memory_order_relaxed); }
+  /*! \return The number of allocations. */
+  int64_t num_allocs() const { return num_allocs_.load(std::memory_order_relaxed); }
+  /*! \return The number of frees. */
+  int64_t num_frees() const { return num_frees_.load(std::memory_order_relaxed); }
+  /*! \return The number of allocations in a histogram bucket. */
+  int64_t histogram(int bucket) const {
+    return histogram_[bucket].load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class MemoryStats;
+  void Update(int64_t delta);
+
+  std::atomic<int64_t> current_bytes_{0};
+  std::atomic<int64_t> peak_bytes_{0};
+  std::atomic<int64_t> num_allocs_{0};
+  std::atomic<int64_t> num_frees_{0};
+  std::atomic<int64_t> histogram_[kNumBuckets] = {};
+  /*! \brief The total counter of the device, nullptr for the total itself. */
+  MemoryCounter* total_{nullptr};
+};
+
+/*! \brief The memory counters of all devices and allocators of the process. */
+class MemoryStats {
+ public:
+  /*!
+   * \brief Get the counter of an allocator on a device, created on first use.
+   * \param dev The device.
+   * \param allocator The allocator, one of the kMemory names.
+   * \return The counter, valid for the lifetime of the process.
+   */
+  static MemoryCounter* Get(Device dev, const std::string& allocator);
+  /*! \brief Set the peak of all counters to their current bytes. */
+  static void ResetPeaks();
+  /*!
+   * \brief Write the counters as JSON, indexed by device name then allocator.
+   * \return The JSON string.
+   */
+  static std::string AsJSON();
+};
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_MEMORY_STATS_H_
@@ -66,6 +66,8 @@ class MetadataNode : public Object {
   String interface_api;
   /*! \brief The internal API (packed or unpacked) in use */
   bool unpacked_api;
+  /*! \brief The workspace pools given to the main function after its arguments, in order */
+  Array<String> pools;
 
   String mod_name = "";
 
@@ -80,7 +82,8 @@ class MetadataNode : public Object {
 class Metadata : public ObjectRef {
  public:
   TVM_DLL Metadata(Array<String> inputs, Array<String> devices, int num_outputs, String executor,
-                   String mod_name, String interface_api = "packed", bool unpacked_api = false) {
+                   String mod_name, String interface_api = "packed", bool unpacked_api = false,
+                   Array<String> pools = {}) {
     auto n = make_object<MetadataNode>();
     n->inputs = inputs;
     n->devices = devices;
@@ -88,6 +91,7 @@ class Metadata : public ObjectRef {
     n->executor = executor;
     n->interface_api = interface_api;
     n->unpacked_api = unpacked_api;
+    n->pools = pools;
     n->mod_name = mod_name;
     data_ = std::move(n);
   }
@@ -53,6 +53,9 @@
 /*! \brief Maximum length of a PackedFunc function name. */
 #define TVM_CRT_MAX_FUNCTION_NAME_LENGTH_BYTES 30
 
+/*! \brief Number of operator runs kept by the graph executor profiler. */
+#define TVM_CRT_PROFILER_RING_SIZE 128
+
 // #define TVM_CRT_FRAMER_ENABLE_LOGS
 
 #endif  // TVM_RUNTIME_MICRO_CRT_CONFIG_H_
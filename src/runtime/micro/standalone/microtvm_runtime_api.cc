@@ -50,6 +50,7 @@ const char* TVMGetLastError(void) { return g_last_error.c_str(); }
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
   TVMParallelGroupEnv env;
   env.num_task = 1;
+  env.thread_budget = 1;
   flambda(0, &env, cdata);
   return 0;
 }
@@ -39,6 +39,7 @@ TVM_MICRO_RUNTIME_API_BACKEND_API void* TVMBackendAllocWorkspace(int device_type
 typedef struct {
   void* sync_handle;
   int32_t num_task;
+  int32_t thread_budget;
 } TVMParallelGroupEnv;
 
 typedef int (*FTVMParallelLambda)(int task_id, TVMParallelGroupEnv* penv, void* cdata);
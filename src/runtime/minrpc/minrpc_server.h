@@ -62,6 +62,11 @@ namespace runtime {
  *         - PosixWrite, PosixRead, Close: posix style, read, write, close API.
  *         - MessageStart(num_bytes), MessageDone(): framing APIs.
  *         - Exit: exit with status code.
+ *
+ *         It can also provide bool ReadToDevice(const DLTensor* tensor, uint64_t num_bytes),
+ *         for channels able to DMA into the memory of a device. It reads num_bytes of the
+ *         payload straight into the tensor data at its byte_offset, or returns false without
+ *         reading anything when it cannot write that device.
  */
 template <typename TIOHandler>
 class MinRPCServer {
@@ -186,7 +191,7 @@ class MinRPCServer {
 
     uint8_t* data_ptr;
     int call_ecode = 0;
-    if (arr->device.device_type == kDLCPU) {
+    if (IsHostAccessible(arr->device)) {
       data_ptr = reinterpret_cast<uint8_t*>(data_handle) + arr->byte_offset;
     } else {
       data_ptr = this->ArenaAlloc<uint8_t>(num_bytes);
@@ -235,10 +240,12 @@ class MinRPCServer {
     this->Read(&num_bytes);
 
     int call_ecode = 0;
-    if (arr->device.device_type == kDLCPU) {
+    // The payload is read straight into the tensor when the channel can reach its memory,
+    // otherwise it goes through a host buffer and a device copy.
+    if (IsHostAccessible(arr->device)) {
       uint8_t* dptr = reinterpret_cast<uint8_t*>(data_handle) + arr->byte_offset;
       this->ReadArray(dptr, num_bytes);
-    } else {
+    } else if (!ReadToDevice(io_, arr, num_bytes, 0)) {
       uint8_t* temp_data = this->ArenaAlloc<uint8_t>(num_bytes);
       this->ReadArray(temp_data, num_bytes);
       DLTensor temp;
@@ -562,6 +569,24 @@ class MinRPCServer {
   void MessageDone() { io_->MessageDone(); }
 
  private:
+  /*! \return Whether the memory of a device is plain host memory. */
+  static bool IsHostAccessible(DLDevice dev) {
+    return dev.device_type == kDLCPU || dev.device_type == kDLCUDAHost ||
+           dev.device_type == kDLROCMHost;
+  }
+
+  // Use the ReadToDevice of the IO handler when it has one.
+  template <typename T>
+  static auto ReadToDevice(T* io, const DLTensor* tensor, uint64_t num_bytes, int)
+      -> decltype(io->ReadToDevice(tensor, num_bytes)) {
+    return io->ReadToDevice(tensor, num_bytes);
+  }
+
+  template <typename T>
+  static bool ReadToDevice(T* io, const DLTensor* tensor, uint64_t num_bytes, long) {  // NOLINT(*)
+    return false;
+  }
+
   // Internal allocator that redirects alloc to TVM's C API.
   class PageAllocator {
    public:
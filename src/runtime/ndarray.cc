@@ -27,6 +27,11 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "memory_stats.h"
 #include "runtime_base.h"
 
 extern "C" {
@@ -59,10 +64,83 @@ inline void VerifyDataType(DLDataType dtype) {
   ICHECK_EQ(dtype.bits & (dtype.bits - 1), 0);
 }
 
+// The NDArray memory counter of a device. Every allocation and free updates it, so the counters
+// of the common devices are kept in a table rather than looked up under the lock of MemoryStats.
+MemoryCounter* NDArrayMemoryCounter(Device dev) {
+  constexpr int kMaxDeviceTypes = 64;
+  constexpr int kMaxDeviceIds = 16;
+  static std::atomic<MemoryCounter*> counters[kMaxDeviceTypes][kMaxDeviceIds];
+  int device_type = static_cast<int>(dev.device_type);
+  if (device_type < 0 || device_type >= kMaxDeviceTypes || dev.device_id < 0 ||
+      dev.device_id >= kMaxDeviceIds) {
+    return MemoryStats::Get(dev, kMemoryNDArray);
+  }
+  std::atomic<MemoryCounter*>& entry = counters[device_type][dev.device_id];
+  MemoryCounter* counter = entry.load(std::memory_order_acquire);
+  if (counter == nullptr) {
+    // MemoryStats gives the same counter to the threads racing here
+    counter = MemoryStats::Get(dev, kMemoryNDArray);
+    entry.store(counter, std::memory_order_release);
+  }
+  return counter;
+}
+
+// The strides of a tensor in elements, computed for a compact tensor.
+std::vector<int64_t> TensorStrides(const DLTensor& arr) {
+  std::vector<int64_t> strides(arr.ndim);
+  int64_t stride = 1;
+  for (int i = arr.ndim - 1; i >= 0; --i) {
+    strides[i] = arr.strides != nullptr ? arr.strides[i] : stride;
+    stride *= arr.shape[i];
+  }
+  return strides;
+}
+
+// Copy a tensor to another of the same shape in the memory of the host, with any strides.
+void CopyStridedOnHost(const DLTensor* from, DLTensor* to) {
+  ICHECK_EQ(from->ndim, to->ndim) << "Strided copy: the shapes must match";
+  for (int i = 0; i < from->ndim; ++i) {
+    ICHECK_EQ(from->shape[i], to->shape[i]) << "Strided copy: the shapes must match";
+  }
+  ICHECK(from->dtype.bits % 8 == 0) << "Strided copy: sub byte types are not supported";
+  size_t elem_bytes = from->dtype.bits / 8 * from->dtype.lanes;
+  if (GetDataSize(*from) == 0) return;
+  std::vector<int64_t> from_strides = TensorStrides(*from);
+  std::vector<int64_t> to_strides = TensorStrides(*to);
+  const char* src = static_cast<const char*>(from->data) + from->byte_offset;
+  char* dst = static_cast<char*>(to->data) + to->byte_offset;
+  // the innermost axis is copied as a row, in one go when both sides are compact along it
+  int inner = from->ndim - 1;
+  int64_t row = inner >= 0 ? from->shape[inner] : 1;
+  int64_t src_step = inner >= 0 ? from_strides[inner] : 1;
+  int64_t dst_step = inner >= 0 ? to_strides[inner] : 1;
+  std::vector<int64_t> index(std::max(inner, 0), 0);
+  int64_t src_offset = 0, dst_offset = 0;
+  while (true) {
+    if (src_step == 1 && dst_step == 1) {
+      std::memcpy(dst + dst_offset * elem_bytes, src + src_offset * elem_bytes, row * elem_bytes);
+    } else {
+      for (int64_t j = 0; j < row; ++j) {
+        std::memcpy(dst + (dst_offset + j * dst_step) * elem_bytes,
+                    src + (src_offset + j * src_step) * elem_bytes, elem_bytes);
+      }
+    }
+    int k = inner - 1;
+    for (; k >= 0; --k) {
+      src_offset += from_strides[k];
+      dst_offset += to_strides[k];
+      if (++index[k] < from->shape[k]) break;
+      src_offset -= from_strides[k] * from->shape[k];
+      dst_offset -= to_strides[k] * from->shape[k];
+      index[k] = 0;
+    }
+    if (k < 0) return;
+  }
+}
+
 void ArrayCopyFromBytes(DLTensor* handle, const void* data, size_t nbytes) {
   size_t arr_size = GetDataSize(*handle);
   ICHECK_EQ(arr_size, nbytes) << "ArrayCopyFromBytes: size mismatch";
-  ICHECK(IsContiguous(*handle)) << "ArrayCopyFromBytes only support contiguous array for now";
 
   DLTensor from;
   from.data = const_cast<void*>(data);
@@ -72,7 +150,7 @@ void ArrayCopyFromBytes(DLTensor* handle, const void* data, size_t nbytes) {
   from.shape = handle->shape;
   from.strides = nullptr;
   from.byte_offset = 0;
-  DeviceAPI::Get(handle->device)->CopyDataFromTo(&from, handle, nullptr);
+  NDArray::CopyFromTo(&from, handle, nullptr);
   // Synchronize in case data become unavailable later.
   DeviceAPI::Get(handle->device)->StreamSync(handle->device, nullptr);
 }
@@ -80,7 +158,6 @@ void ArrayCopyFromBytes(DLTensor* handle, const void* data, size_t nbytes) {
 void ArrayCopyToBytes(const DLTensor* handle, void* data, size_t nbytes) {
   size_t arr_size = GetDataSize(*handle);
   ICHECK_EQ(arr_size, nbytes) << "ArrayCopyToBytes: size mismatch";
-  ICHECK(IsContiguous(*handle)) << "ArrayCopyToBytes only support contiguous array for now";
 
   DLTensor to;
   to.data = const_cast<void*>(data);
@@ -91,7 +168,7 @@ void ArrayCopyToBytes(const DLTensor* handle, void* data, size_t nbytes) {
   to.strides = nullptr;
   to.byte_offset = 0;
 
-  DeviceAPI::Get(handle->device)->CopyDataFromTo(const_cast<DLTensor*>(handle), &to, nullptr);
+  NDArray::CopyFromTo(handle, &to, nullptr);
   // Synchronize in case data become unavailable later.
   DeviceAPI::Get(handle->device)->StreamSync(handle->device, nullptr);
 }
@@ -105,6 +182,7 @@ struct NDArray::Internal {
     } else if (ptr->dl_tensor.data != nullptr) {
       tvm::runtime::DeviceAPI::Get(ptr->dl_tensor.device)
           ->FreeDataSpace(ptr->dl_tensor.device, ptr->dl_tensor.data);
+      NDArrayMemoryCounter(ptr->dl_tensor.device)->RecordFree(GetDataSize(ptr->dl_tensor));
     }
     delete ptr;
   }
@@ -174,7 +252,7 @@ struct NDArray::Internal {
 
 NDArray NDArray::CreateView(ShapeTuple shape, DLDataType dtype) {
   ICHECK(data_ != nullptr);
-  ICHECK(get_mutable()->dl_tensor.strides == nullptr) << "Can only create view for compact tensor";
+  ICHECK(IsContiguous()) << "Can only create view for compact tensor";
   NDArray ret = Internal::Create(shape, dtype, get_mutable()->dl_tensor.device);
   ret.get_mutable()->dl_tensor.byte_offset = this->get_mutable()->dl_tensor.byte_offset;
   size_t curr_size = GetDataSize(this->get_mutable()->dl_tensor);
@@ -188,6 +266,54 @@ NDArray NDArray::CreateView(ShapeTuple shape, DLDataType dtype) {
   return ret;
 }
 
+NDArray NDArray::CreateStridedView(ShapeTuple shape, ShapeTuple strides,
+                                   int64_t elem_offset) const {
+  ICHECK(data_ != nullptr);
+  ICHECK(IsContiguous()) << "Can only create view for compact tensor";
+  ICHECK_EQ(shape.size(), strides.size()) << "The view needs one stride per axis";
+  const DLTensor& curr = get_mutable()->dl_tensor;
+  // the elements of the view must stay in the current array
+  int64_t curr_size = 1;
+  for (int i = 0; i < curr.ndim; ++i) curr_size *= curr.shape[i];
+  int64_t last = elem_offset;
+  bool empty = false;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    ICHECK_GE(shape[i], 0) << "The view has a negative extent";
+    ICHECK_GE(strides[i], 0) << "The view has a negative stride";
+    empty = empty || shape[i] == 0;
+    if (shape[i] > 0) last += (shape[i] - 1) * strides[i];
+  }
+  ICHECK(empty || (elem_offset >= 0 && last < curr_size))
+      << "Tries to create a view out of the memory of the current one";
+  NDArray ret = Internal::Create(shape, curr.dtype, curr.device);
+  Container* view = ret.get_mutable();
+  view->dl_tensor.byte_offset =
+      curr.byte_offset + elem_offset * ((curr.dtype.bits * curr.dtype.lanes + 7) / 8);
+  view->dl_tensor.strides = const_cast<int64_t*>(strides.data());
+  if (ret.IsContiguous()) {
+    view->dl_tensor.strides = nullptr;
+  } else {
+    view->strides_ = std::move(strides);
+  }
+  // increase ref count
+  get_mutable()->IncRef();
+  view->manager_ctx = get_mutable();
+  view->dl_tensor.data = curr.data;
+  return ret;
+}
+
+NDArray NDArray::Slice(int axis, int64_t begin, int64_t end) const {
+  ICHECK(data_ != nullptr);
+  const DLTensor& curr = get_mutable()->dl_tensor;
+  ICHECK(axis >= 0 && axis < curr.ndim) << "Slice: axis " << axis << " out of range";
+  ICHECK(0 <= begin && begin <= end && end <= curr.shape[axis])
+      << "Slice: invalid range [" << begin << ", " << end << ") of an axis of " << curr.shape[axis];
+  std::vector<int64_t> shape(curr.shape, curr.shape + curr.ndim);
+  std::vector<int64_t> strides = TensorStrides(curr);
+  shape[axis] = end - begin;
+  return CreateStridedView(ShapeTuple(shape), ShapeTuple(strides), begin * strides[axis]);
+}
+
 DLManagedTensor* NDArray::ToDLPack() const { return Internal::ToDLPack(get_mutable()); }
 
 NDArray NDArray::Empty(ShapeTuple shape, DLDataType dtype, Device dev, Optional<String> mem_scope) {
@@ -195,6 +321,7 @@ NDArray NDArray::Empty(ShapeTuple shape, DLDataType dtype, Device dev, Optional<
   ret.get_mutable()->dl_tensor.data =
       DeviceAPI::Get(ret->device)
           ->AllocDataSpace(ret->device, shape.size(), shape.data(), ret->dtype, mem_scope);
+  NDArrayMemoryCounter(ret->device)->RecordAlloc(GetDataSize(ret.get_mutable()->dl_tensor));
   return ret;
 }
 
@@ -241,7 +368,35 @@ void NDArray::CopyFromTo(const DLTensor* from, DLTensor* to, TVMStreamHandle str
   // api manager.
   Device dev = from->device.device_type != kDLCPU ? from->device : to->device;
 
-  DeviceAPI::Get(dev)->CopyDataFromTo(const_cast<DLTensor*>(from), to, stream);
+  if (runtime::IsContiguous(*from) && runtime::IsContiguous(*to)) {
+    DeviceAPI::Get(dev)->CopyDataFromTo(const_cast<DLTensor*>(from), to, stream);
+    return;
+  }
+  // a strided tensor is copied element by element on the host, through a compact host
+  // tensor when the other side is on a device
+  auto on_host = [](const DLTensor* arr) {
+    return arr->device.device_type == kDLCPU || arr->device.device_type == kDLCUDAHost;
+  };
+  if (on_host(from) && on_host(to)) {
+    CopyStridedOnHost(from, to);
+    return;
+  }
+  ICHECK(on_host(runtime::IsContiguous(*from) ? to : from))
+      << "TVMArrayCopyFromTo: strided tensors are only supported in the memory of the host";
+  std::vector<int64_t> shape(from->shape, from->shape + from->ndim);
+  NDArray temp = NDArray::Empty(ShapeTuple(shape), from->dtype, {kDLCPU, 0});
+  DLTensor* host = const_cast<DLTensor*>(temp.operator->());
+  if (!runtime::IsContiguous(*from)) {
+    CopyStridedOnHost(from, host);
+    CopyFromTo(host, to, stream);
+  } else {
+    CopyFromTo(from, host, stream);
+  }
+  // the temporary tensor is only valid during the call
+  DeviceAPI::Get(dev)->StreamSync(dev, stream);
+  if (!runtime::IsContiguous(*to)) {
+    CopyStridedOnHost(host, to);
+  }
 }
 
 ShapeTuple NDArray::Shape() const { return get_mutable()->shape_; }
@@ -293,6 +448,11 @@ TVM_REGISTER_GLOBAL("runtime.TVMArrayAllocWithScope").set_body([](TVMArgs args,
   *ret = ndarray;
 });
 
+TVM_REGISTER_GLOBAL("runtime.TVMArraySlice")
+    .set_body_typed([](NDArray arr, int axis, int64_t begin, int64_t end) {
+      return arr.Slice(axis, begin, end);
+    });
+
 int TVMArrayFree(TVMArrayHandle handle) {
   API_BEGIN();
   NDArray::Internal::FFIDecRef(handle);
@@ -0,0 +1,255 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file object_pool.cc
+ * \brief The thread caching pool of the small objects, see PooledObjAllocator.
+ */
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace detail {
+namespace {
+
+constexpr size_t kNumSizeClasses = kObjectPoolMaxBytes / kObjectPoolAlignment;
+/*! \brief The number of blocks moved at once between a thread cache and the shared pool. */
+constexpr size_t kTransferBlocks = 64;
+/*! \brief The number of blocks of one size a thread cache keeps at most. */
+constexpr size_t kMaxCachedBlocks = 4 * kTransferBlocks;
+/*! \brief The size of the chunks of memory the pool takes from the heap. */
+constexpr size_t kChunkBytes = 64 << 10;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+/*! \brief A counter written by one thread and read by any. */
+struct ThreadCounter {
+  std::atomic<uint64_t> value{0};
+  void Add(uint64_t n) {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+  uint64_t Get() const { return value.load(std::memory_order_relaxed); }
+};
+
+class ThreadCache;
+
+/*!
+ * \brief The blocks shared by all the threads.
+ *  It is never destroyed, as some objects outlive the static destructors.
+ */
+class SharedPool {
+ public:
+  static SharedPool* Global() {
+    static SharedPool* inst = new SharedPool();
+    return inst;
+  }
+
+  /*! \brief Take up to n blocks of a size class, as a list, into *head. */
+  size_t Take(size_t size_class, size_t n, FreeBlock** head) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_[size_class] == nullptr) Grow(size_class);
+    size_t taken = 0;
+    FreeBlock* last = nullptr;
+    for (FreeBlock* block = free_[size_class]; block != nullptr && taken < n;
+         block = block->next) {
+      last = block;
+      ++taken;
+    }
+    *head = free_[size_class];
+    free_[size_class] = last->next;
+    last->next = nullptr;
+    return taken;
+  }
+
+  /*! \brief Give back a list of blocks of a size class. */
+  void Give(size_t size_class, FreeBlock* head, FreeBlock* tail) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tail->next = free_[size_class];
+    free_[size_class] = head;
+  }
+
+  void Register(ThreadCache* cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.push_back(cache);
+  }
+
+  void Unregister(ThreadCache* cache, const ObjectPoolStats& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.erase(std::find(caches_.begin(), caches_.end(), cache));
+    exited_.num_allocs += stats.num_allocs;
+    exited_.num_frees += stats.num_frees;
+    exited_.num_refills += stats.num_refills;
+  }
+
+  ObjectPoolStats Stats();
+
+ private:
+  // Carve a new chunk of the heap into blocks of a size class.
+  void Grow(size_t size_class) {
+    size_t block_bytes = (size_class + 1) * kObjectPoolAlignment;
+    char* chunk = static_cast<char*>(::operator new(kChunkBytes));
+    reserved_bytes_ += kChunkBytes;
+    size_t num_blocks = kChunkBytes / block_bytes;
+    for (size_t i = num_blocks; i != 0; --i) {
+      FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * block_bytes);
+      block->next = free_[size_class];
+      free_[size_class] = block;
+    }
+  }
+
+  std::mutex mutex_;
+  FreeBlock* free_[kNumSizeClasses] = {};
+  std::vector<ThreadCache*> caches_;
+  ObjectPoolStats exited_ = {};
+  uint64_t reserved_bytes_{0};
+};
+
+/*! \brief The blocks cached by one thread. */
+class ThreadCache {
+ public:
+  ThreadCache() { SharedPool::Global()->Register(this); }
+
+  ~ThreadCache() {
+    for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+      if (free_[size_class] != nullptr) Release(size_class, num_free_[size_class]);
+    }
+    SharedPool::Global()->Unregister(this, Stats());
+  }
+
+  void* Alloc(size_t size_class) {
+    if (free_[size_class] == nullptr) {
+      num_free_[size_class] =
+          SharedPool::Global()->Take(size_class, kTransferBlocks, &free_[size_class]);
+      num_refills_.Add(1);
+    }
+    FreeBlock* block = free_[size_class];
+    free_[size_class] = block->next;
+    --num_free_[size_class];
+    num_allocs_.Add(1);
+    return block;
+  }
+
+  void Free(void* ptr, size_t size_class) {
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = free_[size_class];
+    free_[size_class] = block;
+    num_frees_.Add(1);
+    if (++num_free_[size_class] > kMaxCachedBlocks) {
+      Release(size_class, kTransferBlocks);
+    }
+  }
+
+  ObjectPoolStats Stats() const {
+    return {num_allocs_.Get(), num_frees_.Get(), num_refills_.Get(), 0};
+  }
+
+ private:
+  // Give the first n cached blocks of a size class back to the shared pool.
+  void Release(size_t size_class, size_t n) {
+    FreeBlock* head = free_[size_class];
+    FreeBlock* tail = head;
+    for (size_t i = 1; i < n; ++i) tail = tail->next;
+    free_[size_class] = tail->next;
+    num_free_[size_class] -= n;
+    SharedPool::Global()->Give(size_class, head, tail);
+  }
+
+  FreeBlock* free_[kNumSizeClasses] = {};
+  size_t num_free_[kNumSizeClasses] = {};
+  ThreadCounter num_allocs_;
+  ThreadCounter num_frees_;
+  ThreadCounter num_refills_;
+};
+
+ObjectPoolStats SharedPool::Stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ObjectPoolStats stats = exited_;
+  for (ThreadCache* cache : caches_) {
+    ObjectPoolStats thread_stats = cache->Stats();
+    stats.num_allocs += thread_stats.num_allocs;
+    stats.num_frees += thread_stats.num_frees;
+    stats.num_refills += thread_stats.num_refills;
+  }
+  stats.reserved_bytes = reserved_bytes_;
+  return stats;
+}
+
+// The cache of the thread, null once the thread has destroyed it. A plain pointer, so that
+// the objects freed by the later destructors are still handled.
+thread_local ThreadCache* thread_cache = nullptr;
+thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCacheOwner {
+  ~ThreadCacheOwner() {
+    delete thread_cache;
+    thread_cache = nullptr;
+    thread_cache_destroyed = true;
+  }
+};
+
+ThreadCache* GetThreadCache() {
+  if (thread_cache == nullptr && !thread_cache_destroyed) {
+    static thread_local ThreadCacheOwner owner;
+    thread_cache = new ThreadCache();
+  }
+  return thread_cache;
+}
+}  // namespace
+
+void* ObjectPoolAlloc(size_t size_class) {
+  if (ThreadCache* cache = GetThreadCache()) {
+    return cache->Alloc(size_class);
+  }
+  FreeBlock* block;
+  SharedPool::Global()->Take(size_class, 1, &block);
+  return block;
+}
+
+void ObjectPoolFree(void* ptr, size_t size_class) {
+  if (ThreadCache* cache = GetThreadCache()) {
+    cache->Free(ptr, size_class);
+    return;
+  }
+  FreeBlock* block = static_cast<FreeBlock*>(ptr);
+  SharedPool::Global()->Give(size_class, block, block);
+}
+}  // namespace detail
+
+ObjectPoolStats GetObjectPoolStats() { return detail::SharedPool::Global()->Stats(); }
+
+TVM_REGISTER_GLOBAL("runtime.ObjectPoolStat").set_body_typed([](const std::string& name) {
+  ObjectPoolStats stats = GetObjectPoolStats();
+  if (name == "num_allocs") return static_cast<int64_t>(stats.num_allocs);
+  if (name == "num_frees") return static_cast<int64_t>(stats.num_frees);
+  if (name == "num_refills") return static_cast<int64_t>(stats.num_refills);
+  ICHECK_EQ(name, "reserved_bytes") << "Unknown object pool counter " << name;
+  return static_cast<int64_t>(stats.reserved_bytes);
+});
+
+}  // namespace runtime
+}  // namespace tvm
@@ -234,6 +234,28 @@ class OpenCLWorkspace : public DeviceAPI {
   std::vector<cl_device_id> devices;
   // the queues
   std::vector<cl_command_queue> queues;
+  /*!
+   * \brief Whether the queues execute out of order.
+   *
+   *  Enabled by the TVM_OPENCL_OUT_OF_ORDER_QUEUE environment variable on devices that
+   *  support it.  Each kernel then waits on the events of the last commands that accessed
+   *  its buffers, so that the independent kernels of a graph may overlap.
+   */
+  bool out_of_order_queue{false};
+  /*! \brief The event state of the queue of a device. */
+  struct QueueEvents {
+    /*! \brief Whether profiling is enabled on the queue. */
+    bool profiling{false};
+    /*! \brief The number of started and not yet stopped timers. */
+    int num_recording_timers{0};
+    /*! \brief The events of the kernels launched while a timer is recording. */
+    std::vector<cl_event> recorded;
+    /*! \brief The event of the last kernel accessing each buffer, in out of order mode. */
+    std::unordered_map<cl_mem, cl_event> last_access;
+  };
+  std::vector<QueueEvents> queue_events;
+  // the mutex of queue_events
+  std::mutex events_mu;
   // Number of registered kernels
   // Used to register kernel into the workspace.
   size_t num_registered_kernels{0};
@@ -263,6 +285,44 @@ class OpenCLWorkspace : public DeviceAPI {
         << "Invalid OpenCL device_id=" << dev.device_id;
     return queues[dev.device_id];
   }
+  /*!
+   * \brief Enqueue a kernel on the queue of a device.
+   * \param dev The device.
+   * \param kernel The kernel, whose arguments are set.
+   * \param work_dim The number of work dimensions.
+   * \param global_work_size The global work size.
+   * \param local_work_size The local work size.
+   * \param buffers The buffers accessed by the kernel, which it depends on in out of
+   *        order mode.
+   */
+  void EnqueueKernel(Device dev, cl_kernel kernel, cl_uint work_dim,
+                     const size_t* global_work_size, const size_t* local_work_size,
+                     const std::vector<cl_mem>& buffers);
+  /*!
+   * \brief Make the commands enqueued later wait for the ones enqueued so far, in out of
+   *  order mode.  Commands not enqueued with EnqueueKernel are surrounded by barriers.
+   * \param dev The device.
+   */
+  void EnqueueBarrier(Device dev);
+  /*!
+   * \brief Recreate the queue of a device with profiling enabled, when it is not.
+   *  Must not be called while other threads enqueue commands on the device.
+   * \param dev The device.
+   */
+  void EnableQueueProfiling(Device dev);
+  /*!
+   * \brief Start recording the events of the kernels launched on a device.
+   * \param dev The device.
+   * \return The position of the first recorded event, to be passed to StopEventRecording.
+   */
+  size_t StartEventRecording(Device dev);
+  /*!
+   * \brief Stop a recording started by StartEventRecording.
+   * \param dev The device.
+   * \param begin The value returned by StartEventRecording.
+   * \return The events recorded since then, retained for the caller.
+   */
+  std::vector<cl_event> StopEventRecording(Device dev, size_t begin);
   // override device API
   void SetDevice(Device dev) final;
   void GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv) final;
@@ -380,6 +440,12 @@ class OpenCLModuleNode : public ModuleNode {
                           const std::string& func_name, const KTRefEntry& e);
 
  private:
+  // Load and build a program binary from the kernel cache, nullptr when missing or invalid.
+  cl_program LoadCachedProgram(cl::OpenCLWorkspace* w, cl_device_id dev,
+                               const std::string& cache_key);
+  // Save the binary of a built program to the kernel cache.
+  void SaveCachedProgram(cl_program program, const std::string& cache_key);
+
   // The workspace, need to keep reference to use it in destructor.
   // In case of static destruction order problem.
   cl::OpenCLWorkspace* workspace_;
@@ -21,8 +21,12 @@
  * \file opencl_device_api.cc
  */
 #include <dmlc/thread_local.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+
+#include "../../support/utils.h"
 #include "opencl_common.h"
 
 namespace tvm {
@@ -231,6 +235,15 @@ void OpenCLWorkspace::FreeDataSpace(Device dev, void* ptr) {
   OPENCL_CALL(clFinish(this->GetQueue(dev)));
 
   cl::BufferDescriptor* desc = static_cast<cl::BufferDescriptor*>(ptr);
+  {
+    std::lock_guard<std::mutex> lock(events_mu);
+    auto& last_access = queue_events[dev.device_id].last_access;
+    auto it = last_access.find(desc->buffer);
+    if (it != last_access.end()) {
+      OPENCL_CALL(clReleaseEvent(it->second));
+      last_access.erase(it);
+    }
+  }
   OPENCL_CALL(clReleaseMemObject(desc->buffer));
   delete desc;
 }
@@ -269,11 +282,14 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
     ICHECK(from_desc->layout == cl::BufferDescriptor::MemoryLayout::kBuffer1D)
         << "Device to device copying is currently only implemented for OpenCL buffer storage";
     auto* to_desc = static_cast<cl::BufferDescriptor*>(to->data);
+    EnqueueBarrier(to->device);
     OPENCL_CALL(clEnqueueCopyBuffer(this->GetQueue(to->device), from_desc->buffer, to_desc->buffer,
                                     from->byte_offset, to->byte_offset, nbytes, 0, nullptr,
                                     nullptr));
+    EnqueueBarrier(to->device);
   } else if (IsOpenCLDevice(from->device) && to->device.device_type == kDLCPU) {
     const auto* from_desc = static_cast<const cl::BufferDescriptor*>(from->data);
+    EnqueueBarrier(from->device);
     switch (from_desc->layout) {
       case cl::BufferDescriptor::MemoryLayout::kBuffer1D:
         OPENCL_CALL(clEnqueueReadBuffer(
@@ -295,6 +311,7 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
     OPENCL_CALL(clFinish(this->GetQueue(from->device)));
   } else if (from->device.device_type == kDLCPU && IsOpenCLDevice(to->device)) {
     auto* to_desc = static_cast<cl::BufferDescriptor*>(to->data);
+    EnqueueBarrier(to->device);
     switch (to_desc->layout) {
       case cl::BufferDescriptor::MemoryLayout::kBuffer1D:
         OPENCL_CALL(clEnqueueWriteBuffer(
@@ -319,6 +336,116 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
 void OpenCLWorkspace::StreamSync(Device dev, TVMStreamHandle stream) {
   ICHECK(stream == nullptr);
   OPENCL_CALL(clFinish(this->GetQueue(dev)));
+  // All the commands are complete, no later command depends on them.
+  std::lock_guard<std::mutex> lock(events_mu);
+  auto& last_access = queue_events[dev.device_id].last_access;
+  for (auto& kv : last_access) {
+    OPENCL_CALL(clReleaseEvent(kv.second));
+  }
+  last_access.clear();
+}
+
+void OpenCLWorkspace::EnqueueKernel(Device dev, cl_kernel kernel, cl_uint work_dim,
+                                    const size_t* global_work_size,
+                                    const size_t* local_work_size,
+                                    const std::vector<cl_mem>& buffers) {
+  cl_command_queue queue = this->GetQueue(dev);
+  std::lock_guard<std::mutex> lock(events_mu);
+  QueueEvents& events = queue_events[dev.device_id];
+  std::vector<cl_event> wait_list;
+  if (out_of_order_queue) {
+    // The kernel does not tell which buffers it writes, so it waits on
+    // the last command accessing any of them, which transitively covers
+    // the earlier ones.
+    for (cl_mem buffer : buffers) {
+      auto it = events.last_access.find(buffer);
+      if (it != events.last_access.end() &&
+          std::find(wait_list.begin(), wait_list.end(), it->second) == wait_list.end()) {
+        wait_list.push_back(it->second);
+      }
+    }
+  }
+  bool record = events.num_recording_timers > 0;
+  cl_event event = nullptr;
+  OPENCL_CALL(clEnqueueNDRangeKernel(queue, kernel, work_dim, nullptr, global_work_size,
+                                     local_work_size, wait_list.size(),
+                                     wait_list.empty() ? nullptr : wait_list.data(),
+                                     out_of_order_queue || record ? &event : nullptr));
+  if (out_of_order_queue) {
+    for (cl_mem buffer : buffers) {
+      cl_event& last = events.last_access[buffer];
+      if (last == event) continue;
+      if (last != nullptr) {
+        OPENCL_CALL(clReleaseEvent(last));
+      }
+      OPENCL_CALL(clRetainEvent(event));
+      last = event;
+    }
+  }
+  if (record) {
+    events.recorded.push_back(event);
+  } else if (event != nullptr) {
+    OPENCL_CALL(clReleaseEvent(event));
+  }
+}
+
+void OpenCLWorkspace::EnqueueBarrier(Device dev) {
+  if (!out_of_order_queue) return;
+  OPENCL_CALL(clEnqueueBarrierWithWaitList(this->GetQueue(dev), 0, nullptr, nullptr));
+}
+
+namespace {
+cl_command_queue CreateQueue(cl_context context, cl_device_id device, bool out_of_order,
+                             bool profiling) {
+  cl_command_queue_properties props = 0;
+  if (out_of_order) props |= CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+  if (profiling) props |= CL_QUEUE_PROFILING_ENABLE;
+  cl_int err_code;
+  cl_command_queue queue = clCreateCommandQueue(context, device, props, &err_code);
+  OPENCL_CHECK_ERROR(err_code);
+  return queue;
+}
+}  // namespace
+
+void OpenCLWorkspace::EnableQueueProfiling(Device dev) {
+  cl_command_queue queue = this->GetQueue(dev);
+  std::lock_guard<std::mutex> lock(events_mu);
+  QueueEvents& events = queue_events[dev.device_id];
+  if (events.profiling) return;
+  OPENCL_CALL(clFinish(queue));
+  for (auto& kv : events.last_access) {
+    OPENCL_CALL(clReleaseEvent(kv.second));
+  }
+  events.last_access.clear();
+  OPENCL_CALL(clReleaseCommandQueue(queue));
+  queues[dev.device_id] =
+      CreateQueue(this->context, this->devices[dev.device_id], out_of_order_queue, true);
+  events.profiling = true;
+}
+
+size_t OpenCLWorkspace::StartEventRecording(Device dev) {
+  std::lock_guard<std::mutex> lock(events_mu);
+  QueueEvents& events = queue_events[dev.device_id];
+  ICHECK(events.profiling) << "OpenCL profiling is not enabled on device " << dev.device_id;
+  ++events.num_recording_timers;
+  return events.recorded.size();
+}
+
+std::vector<cl_event> OpenCLWorkspace::StopEventRecording(Device dev, size_t begin) {
+  std::lock_guard<std::mutex> lock(events_mu);
+  QueueEvents& events = queue_events[dev.device_id];
+  ICHECK_GT(events.num_recording_timers, 0);
+  std::vector<cl_event> result(events.recorded.begin() + begin, events.recorded.end());
+  for (cl_event event : result) {
+    OPENCL_CALL(clRetainEvent(event));
+  }
+  if (--events.num_recording_timers == 0) {
+    for (cl_event event : events.recorded) {
+      OPENCL_CALL(clReleaseEvent(event));
+    }
+    events.recorded.clear();
+  }
+  return result;
 }
 
 void* OpenCLWorkspace::AllocWorkspace(Device dev, size_t size, DLDataType type_hint) {
@@ -421,11 +548,24 @@ void OpenCLWorkspace::Init(const std::string& type_key, const std::string& devic
                                   nullptr, &err_code);
   OPENCL_CHECK_ERROR(err_code);
   ICHECK_EQ(this->queues.size(), 0U);
+  if (support::BoolEnvironmentVar("TVM_OPENCL_OUT_OF_ORDER_QUEUE")) {
+    this->out_of_order_queue = true;
+    for (cl_device_id did : this->devices) {
+      cl_command_queue_properties props = 0;
+      OPENCL_CALL(clGetDeviceInfo(did, CL_DEVICE_QUEUE_PROPERTIES, sizeof(props), &props,
+                                  nullptr));
+      if (!(props & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)) {
+        LOG(WARNING) << "The OpenCL device " << did
+                     << " does not support out of order queues, using in order queues";
+        this->out_of_order_queue = false;
+      }
+    }
+  }
   for (size_t i = 0; i < this->devices.size(); ++i) {
     cl_device_id did = this->devices[i];
-    this->queues.push_back(clCreateCommandQueue(this->context, did, 0, &err_code));
-    OPENCL_CHECK_ERROR(err_code);
+    this->queues.push_back(CreateQueue(this->context, did, this->out_of_order_queue, false));
   }
+  this->queue_events.resize(this->devices.size());
   initialized_ = true;
 }
 
@@ -467,6 +607,60 @@ TVM_REGISTER_GLOBAL("device_api.opencl").set_body([](TVMArgs args, TVMRetValue*
   *rv = static_cast<void*>(ptr);
 });
 
+/*!
+ * \brief Timer measuring the execution of the kernels on the device, from the
+ *  profiling information of their events, so that the time of the host and of the
+ *  synchronizations is not included.
+ */
+class OpenCLTimerNode : public TimerNode {
+ public:
+  explicit OpenCLTimerNode(Device dev) : dev_(dev) {
+    OpenCLWorkspace::Global()->EnableQueueProfiling(dev_);
+  }
+  virtual ~OpenCLTimerNode() { ReleaseEvents(); }
+
+  virtual void Start() {
+    ReleaseEvents();
+    begin_ = OpenCLWorkspace::Global()->StartEventRecording(dev_);
+  }
+  virtual void Stop() { events_ = OpenCLWorkspace::Global()->StopEventRecording(dev_, begin_); }
+  virtual int64_t SyncAndGetElapsedNanos() {
+    if (events_.empty()) return 0;
+    OPENCL_CALL(clWaitForEvents(events_.size(), events_.data()));
+    int64_t elapsed = 0;
+    for (cl_event event : events_) {
+      cl_ulong start = 0, end = 0;
+      OPENCL_CALL(clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(start),
+                                          &start, nullptr));
+      OPENCL_CALL(
+          clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end), &end, nullptr));
+      elapsed += static_cast<int64_t>(end - start);
+    }
+    return elapsed;
+  }
+
+  static constexpr const char* _type_key = "OpenCLTimerNode";
+  TVM_DECLARE_FINAL_OBJECT_INFO(OpenCLTimerNode, TimerNode);
+
+ private:
+  void ReleaseEvents() {
+    for (cl_event event : events_) {
+      OPENCL_CALL(clReleaseEvent(event));
+    }
+    events_.clear();
+  }
+
+  Device dev_;
+  size_t begin_{0};
+  std::vector<cl_event> events_;
+};
+
+TVM_REGISTER_OBJECT_TYPE(OpenCLTimerNode);
+
+TVM_REGISTER_GLOBAL("profiling.timer.opencl").set_body_typed([](Device dev) {
+  return Timer(make_object<OpenCLTimerNode>(dev));
+});
+
 }  // namespace cl
 }  // namespace runtime
 }  // namespace tvm
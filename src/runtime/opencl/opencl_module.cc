@@ -35,6 +35,10 @@
 namespace tvm {
 namespace runtime {
 
+namespace cl {
+std::string GetDeviceInfo(cl_device_id pid, cl_device_info param_name);
+}  // namespace cl
+
 class OpenCLWrappedFunc {
  public:
   // initialize the OpenCL function.
@@ -63,24 +67,26 @@ class OpenCLWrappedFunc {
       kernel = m_->InstallKernel(w_, t, func_name_, entry_);
     }
     // setup arguments.
+    std::vector<cl_mem> buffers;
     for (cl_uint i = 0; i < arg_size_.size(); ++i) {
       void* arg = nullptr;
       if (args.type_codes[i] == DLDataTypeCode::kDLOpaqueHandle) {
-        arg = static_cast<cl::BufferDescriptor*>(void_args[i])->buffer;
+        // void_args[i] points to the handle of the buffer descriptor.
+        cl::BufferDescriptor* desc = *static_cast<cl::BufferDescriptor**>(void_args[i]);
+        arg = &desc->buffer;
+        buffers.push_back(desc->buffer);
       } else {
         arg = void_args[i];
       }
       OPENCL_CALL(clSetKernelArg(kernel, i, arg_size_[i], arg));
     }
-    cl_command_queue queue = w_->GetQueue(t->device);
     ThreadWorkLoad wl = launch_param_config_.Extract(args);
     cl_uint work_dim = static_cast<cl_uint>(launch_param_config_.work_dim());
     for (cl_uint i = 0; i < work_dim; ++i) {
       wl.work_size[i] *= wl.work_size[i + 3];
     }
     // launch kernel
-    OPENCL_CALL(clEnqueueNDRangeKernel(queue, kernel, work_dim, nullptr, wl.work_size,
-                                       wl.work_size + 3, 0, nullptr, nullptr));
+    w_->EnqueueKernel(t->device, kernel, work_dim, wl.work_size, wl.work_size + 3, buffers);
   }
 
  private:
@@ -210,6 +216,19 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
                                           const std::string& func_name, const KTRefEntry& e) {
   std::lock_guard<std::mutex> lock(build_lock_);
   int device_id = t->device.device_id;
+  std::string cache_key;
+  if (programs_[func_name][device_id] == nullptr && fmt_ == "cl" &&
+      !GetKernelCacheDir().empty()) {
+    // The driver version is part of the key, as program binaries are
+    // only loadable by the compiler that produced them.
+    cl_device_id dev = w->devices[device_id];
+    cache_key = KernelCacheKey({"opencl_program", w->platform_name,
+                                cl::GetDeviceInfo(dev, CL_DEVICE_NAME),
+                                cl::GetDeviceInfo(dev, CL_DEVICE_VERSION),
+                                cl::GetDeviceInfo(dev, CL_DRIVER_VERSION),
+                                parsed_kernels_[func_name]});
+    programs_[func_name][device_id] = LoadCachedProgram(w, dev, cache_key);
+  }
   if (programs_[func_name][device_id] == nullptr) {
     // create program
     if (fmt_ == "cl") {
@@ -243,6 +262,9 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
                             &log[0], nullptr);
       LOG(FATAL) << "OpenCL build error for device=" << dev << "\n" << log;
     }
+    if (!cache_key.empty()) {
+      SaveCachedProgram(programs_[func_name][device_id], cache_key);
+    }
   }
   // build kernel
   cl_int err;
@@ -254,6 +276,43 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
   return kernel;
 }
 
+cl_program OpenCLModuleNode::LoadCachedProgram(cl::OpenCLWorkspace* w, cl_device_id dev,
+                                               const std::string& cache_key) {
+  std::string binary;
+  if (!LoadKernelCache(cache_key, &binary) || binary.empty()) {
+    return nullptr;
+  }
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(binary.data());
+  size_t len = binary.length();
+  cl_int status;
+  cl_int err;
+  cl_program program = clCreateProgramWithBinary(w->context, 1, &dev, &len, &s, &status, &err);
+  if (err != CL_SUCCESS || status != CL_SUCCESS) {
+    if (program != nullptr) clReleaseProgram(program);
+    return nullptr;
+  }
+  // Binaries still need a build, which is a cheap load.  A failure
+  // falls back to the source, whose binary replaces the entry.
+  if (clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr) != CL_SUCCESS) {
+    clReleaseProgram(program);
+    return nullptr;
+  }
+  return program;
+}
+
+void OpenCLModuleNode::SaveCachedProgram(cl_program program, const std::string& cache_key) {
+  // The program is built for a single device, so it has one binary.
+  size_t binary_size = 0;
+  OPENCL_CALL(clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &binary_size,
+                               nullptr));
+  if (binary_size == 0) return;
+  std::string binary(binary_size, '\0');
+  unsigned char* binary_ptr = reinterpret_cast<unsigned char*>(&binary[0]);
+  OPENCL_CALL(clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &binary_ptr,
+                               nullptr));
+  SaveKernelCache(cache_key, binary);
+}
+
 Module OpenCLModuleCreate(std::string data, std::string fmt,
                           std::unordered_map<std::string, FunctionInfo> fmap, std::string source) {
   auto n = make_object<OpenCLModuleNode>(data, fmt, fmap, source);
@@ -24,6 +24,7 @@
 #include <limits>
 #include <memory>
 
+#include "../memory_stats.h"
 #include "../texture.h"
 
 namespace tvm {
@@ -31,7 +32,7 @@ namespace runtime {
 
 class TexturePool::Pool {
  public:
-  Pool() = default;
+  explicit Pool(Device dev) : memory_counter_(MemoryStats::Get(dev, kMemoryTexture)) {}
   void* Alloc(Device dev, DeviceAPI* device, size_t width, size_t height, DLDataType type_hint) {
     Entry e;
     e.data = nullptr;
@@ -68,11 +69,13 @@ class TexturePool::Pool {
         // if added size is less or equal to
         // what is needed by alloc, then grow entry
         device->FreeDataSpace(dev, best_mem->data);
+        memory_counter_->RecordFree(NumBytes(*best_mem));
         free_list_.erase(best_mem);
         new_mem.type = type_hint;
         std::vector<int64_t> shape{int64_t(new_mem.y), int64_t(new_mem.x), 4};
         new_mem.data = device->AllocDataSpace(dev, shape.size(), shape.data(), new_mem.type,
                                               Optional<String>("global.texture"));
+        memory_counter_->RecordAlloc(NumBytes(new_mem));
         e = new_mem;
       }
     }
@@ -85,6 +88,7 @@ class TexturePool::Pool {
       e.x = width;
       e.y = height;
       e.type = type_hint;
+      memory_counter_->RecordAlloc(NumBytes(e));
     }
 
     allocated_.push_back(e);
@@ -112,9 +116,11 @@ class TexturePool::Pool {
   void Release(Device dev, DeviceAPI* device) {
     for (auto& e : allocated_) {
       device->FreeDataSpace(dev, e.data);
+      memory_counter_->RecordFree(NumBytes(e));
     }
     for (auto& e : free_list_) {
       device->FreeDataSpace(dev, e.data);
+      memory_counter_->RecordFree(NumBytes(e));
     }
     allocated_.clear();
     free_list_.clear();
@@ -127,8 +133,13 @@ class TexturePool::Pool {
     size_t y;
     DLDataType type;
   };
+  // The bytes of an image of four channels.
+  static size_t NumBytes(const Entry& e) {
+    return e.x * e.y * 4 * ((e.type.bits * e.type.lanes + 7) / 8);
+  }
   std::vector<Entry> free_list_;
   std::vector<Entry> allocated_;
+  MemoryCounter* memory_counter_;
 };
 
 TexturePool::TexturePool(DLDeviceType device_type, DeviceAPI* device)
@@ -151,7 +162,7 @@ void* TexturePool::AllocTexture(Device dev, size_t width, size_t height, DLDataT
     array_.resize(dev.device_id + 1, nullptr);
   }
   if (array_[dev.device_id] == nullptr) {
-    array_[dev.device_id] = new Pool();
+    array_[dev.device_id] = new Pool(dev);
   }
   return array_[dev.device_id]->Alloc(dev, device_, width, height, type_hint);
 }
@@ -34,6 +34,23 @@ PackedFunc PipelineExecutor::GetFunction(const std::string& name,
   if (name == "get_num_outputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumOutputs(); });
+  } else if (name == "set_input") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetInput(args[0].operator String(), args[1]);
+    });
+  } else if (name == "run") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "get_output") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetOutput(); });
+  } else if (name == "set_queue_capacity") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      pipeline_scheduler_.SetQueueCapacity(args[0]);
+    });
+  } else if (name == "get_statistics") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = pipeline_scheduler_.GetStatistics();
+    });
   } else {
     LOG(FATAL) << "Unknown packed function: " << name;
     return PackedFunc();
@@ -106,13 +123,12 @@ std::vector<Module> PipelineExecutor::CreateGraphModules(const ModuleConfig& mod
 void PipelineExecutor::Init(const std::vector<Module>& modules, const std::string& pipeline_json) {
   ICHECK(!modules.empty()) << "The graph executor module list is empty.";
   // Use JSONReader to load pipeline configuration.
-  std::istringstream is(pipeline_json);
-  dmlc::JSONReader reader(&is);
-  PipelineConfig& pipeline_config = this->LoadPipelineConfig(&reader);
-  ICHECK(!pipeline_config.Empty()) << "The pipeline config information is empty.";
+  this->LoadConfig(pipeline_json);
+  ICHECK(!pipeline_config_.Empty()) << "The pipeline config information is empty.";
   // Initialize the pipeline function class used for pipeline thread pool management
   // and schedule etc. This function returns the number of output.
-  num_outputs_ = pipeline_scheduler_.PipelineInit(modules, pipeline_config);
+  num_outputs_ =
+      pipeline_scheduler_.PipelineInit(modules, pipeline_config_, input_connection_config_);
   return;
 }
 
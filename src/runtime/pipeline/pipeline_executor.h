@@ -74,6 +74,23 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
    * \return The number of outputs.
    */
   int NumOutputs() const { return num_outputs_; }
+  /*!
+   * \brief Set a global input of the next request.
+   * \param name The global input name.
+   * \param data The input data, copied.
+   */
+  void SetInput(const std::string& name, DLTensor* data) {
+    pipeline_scheduler_.SetInput(name, data);
+  }
+  /*!
+   * \brief Submit the inputs set so far as one request, blocking while the pipeline is full.
+   */
+  void Run() { pipeline_scheduler_.Run(); }
+  /*!
+   * \brief Wait for the outputs of the oldest request that has not been fetched.
+   * \return The global outputs.
+   */
+  Array<NDArray> GetOutput() { return pipeline_scheduler_.GetOutput(); }
 
   /*!\brief Load the module files information.*/
   ModuleConfig& LoadModuleConfig(dmlc::JSONReader* reader) {
@@ -116,10 +133,37 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
   PipelineScheduler pipeline_scheduler_;
   /*!\brief The dependency information of each graph runtime module of the pipeline.*/
   PipelineConfig pipeline_config_;
+  /*!\brief The module inputs each global input of the pipeline is bound to.*/
+  InputConnectionConfig input_connection_config_;
   /*!\brief The module information used to create the graph runtimes.*/
   ModuleConfig mod_config_;
   /*!\brief How many outputs are in this pipeline executor.*/
   size_t num_outputs_ = 0;
+  /*!
+   * \brief Load the pipeline configuration, either the list of module connections or an
+   *  object holding the "module_connection" list and the "input_connection" list.
+   * \param pipeline_json The configuration in JSON format.
+   */
+  void LoadConfig(const std::string& pipeline_json) {
+    std::istringstream is(pipeline_json);
+    dmlc::JSONReader reader(&is);
+    size_t first = pipeline_json.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos || pipeline_json[first] != '{') {
+      this->LoadPipelineConfig(&reader);
+      return;
+    }
+    std::string key;
+    reader.BeginObject();
+    while (reader.NextObjectItem(&key)) {
+      if (key == "module_connection") {
+        this->LoadPipelineConfig(&reader);
+      } else if (key == "input_connection") {
+        input_connection_config_.Load(&reader);
+      } else {
+        LOG(FATAL) << "do not support key " << key;
+      }
+    }
+  }
   /*!\brief Json loader.*/
   PipelineConfig& LoadPipelineConfig(dmlc::JSONReader* reader) {
     reader->BeginArray();
@@ -18,20 +18,343 @@
  */
 #include "pipeline_scheduler.h"
 
+#include <tvm/runtime/device_api.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <sstream>
 #include <utility>
 #include <vector>
 namespace tvm {
 namespace runtime {
+namespace {
+/*! \brief The number of failed attempts a blocked queue operation yields before sleeping. */
+constexpr int kSpinCount = 256;
+/*! \brief The sleep between the attempts after that, in microseconds. */
+constexpr int kBackoffUs = 20;
+
+uint64_t MicrosecondsSince(std::chrono::steady_clock::time_point begin) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                               begin)
+      .count();
+}
+
+/*! \brief Whether a tensor can be bound as a module input without a copy. */
+bool CanBindZeroCopy(const NDArray& value, const NDArray& input) {
+  const DLTensor* a = value.operator->();
+  const DLTensor* b = input.operator->();
+  if (a->device.device_type != b->device.device_type || a->device.device_id != b->device.device_id ||
+      a->dtype.code != b->dtype.code || a->dtype.bits != b->dtype.bits ||
+      a->dtype.lanes != b->dtype.lanes || a->ndim != b->ndim || a->byte_offset != 0 ||
+      reinterpret_cast<size_t>(a->data) % kAllocAlignment != 0) {
+    return false;
+  }
+  return std::equal(a->shape, a->shape + a->ndim, b->shape);
+}
+
+/*! \brief Get a buffer of an output that no consumer still holds. */
+NDArray AcquireBuffer(PipelineOutputBuffers* buffers) {
+  for (const NDArray& buffer : buffers->pool) {
+    if (buffer.use_count() == 1) {
+      // Pair with the release of the last reference dropped by a consumer.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return buffer;
+    }
+  }
+  const NDArray& internal = buffers->internal;
+  buffers->pool.push_back(NDArray::Empty(internal.Shape(), internal.DataType(), internal->device));
+  return buffers->pool.back();
+}
+}  // namespace
+
+PipelineScheduler::~PipelineScheduler() { Stop(); }
+
+template <typename FTry>
+bool PipelineScheduler::WaitUntil(FTry ftry) {
+  for (int spin = 0; !ftry(); ++spin) {
+    if (stop_.load(std::memory_order_relaxed)) return false;
+    if (spin < kSpinCount) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(kBackoffUs));
+    }
+  }
+  return true;
+}
+
 /*!
  * \brief Initialize the pipeline.
  * \param modules The list of graph executor modules.
  * \param pipeline_conf The dependency information of each graph executor module.
+ * \param input_config The module inputs each global input is bound to.
  */
 size_t PipelineScheduler::PipelineInit(const std::vector<Module>& modules,
-                                       const PipelineConfig& pipeline_config) {
+                                       const PipelineConfig& pipeline_config,
+                                       const InputConnectionConfig& input_config) {
   graph_modules_ = modules;
-  int num_output = pipeline_config.GetGlobalOutputNum();
-  return num_output;
+  for (const Module& module : modules) {
+    stages_.emplace_back(new PipelineStage());
+    stages_.back()->module = module;
+  }
+  // One channel per pair of producer and consumer, -1 standing for the caller.
+  std::map<std::pair<int, int>, PipelineChannel*> channels;
+  auto get_channel = [&](int src, int dst) {
+    ICHECK_LT(std::max(src, dst), static_cast<int>(stages_.size()))
+        << "Invalid mod_idx value " << std::max(src, dst);
+    PipelineChannel*& channel = channels[std::make_pair(src, dst)];
+    if (channel == nullptr) {
+      channels_.emplace_back(new PipelineChannel());
+      channel = channels_.back().get();
+      if (src < 0) {
+        input_channels_.push_back(channel);
+      } else {
+        stages_[src]->outputs.push_back(channel);
+      }
+      if (dst < 0) {
+        output_channels_.push_back(channel);
+      } else {
+        stages_[dst]->inputs.push_back(channel);
+      }
+    }
+    return channel;
+  };
+  for (const auto& mod_output : pipeline_config.config) {
+    int mod_idx = mod_output.first;
+    for (const auto& output : mod_output.second.output_binding_map) {
+      for (const auto& binding : output.second.bindings) {
+        PipelineChannel* channel = get_channel(mod_idx, binding.first);
+        channel->src_index.push_back(output.first);
+        channel->dst_name.push_back(binding.second);
+      }
+      if (output.second.IsGlobalOutput()) {
+        PipelineChannel* channel = get_channel(mod_idx, -1);
+        channel->src_index.push_back(output.first);
+        channel->dst_global_index.push_back(output.second.global_output_index);
+      }
+    }
+  }
+  for (const auto& global_input : input_config.input_connection) {
+    int index = static_cast<int>(input_index_.size());
+    input_index_[global_input.first] = index;
+    for (const auto& binding : global_input.second) {
+      PipelineChannel* channel = get_channel(-1, binding.first);
+      channel->src_index.push_back(index);
+      channel->dst_name.push_back(binding.second);
+    }
+  }
+  pending_inputs_.resize(input_index_.size());
+  num_outputs_ = pipeline_config.GetGlobalOutputNum();
+  return num_outputs_;
+}
+
+void PipelineScheduler::SetQueueCapacity(int capacity) {
+  ICHECK(!started_) << "The queue capacity can only be set before the first run";
+  ICHECK_GT(capacity, 0);
+  queue_capacity_ = capacity;
+}
+
+void PipelineScheduler::SetInput(const std::string& name, DLTensor* data) {
+  auto it = input_index_.find(name);
+  ICHECK(it != input_index_.end()) << "Cannot find global input " << name;
+  // The request may stay queued after the caller reuses the buffer, so it is copied.
+  NDArray input = NDArray::Empty(ShapeTuple(data->shape, data->shape + data->ndim), data->dtype,
+                                 data->device);
+  input.CopyFrom(data);
+  pending_inputs_[it->second] = input;
+}
+
+void PipelineScheduler::Run() {
+  if (!started_) Start();
+  for (const auto& input : input_index_) {
+    ICHECK(pending_inputs_[input.second].defined())
+        << "The global input " << input.first << " is not set";
+  }
+  auto begin = std::chrono::steady_clock::now();
+  for (PipelineChannel* channel : input_channels_) {
+    std::vector<NDArray> item;
+    for (int index : channel->src_index) item.push_back(pending_inputs_[index]);
+    if (!WaitUntil([&]() { return channel->queue->TryPush(&item); })) ReportStopped();
+  }
+  run_wait_us_ += MicrosecondsSince(begin);
+  ++num_in_flight_;
+}
+
+Array<NDArray> PipelineScheduler::GetOutput() {
+  ICHECK_GT(num_in_flight_, 0) << "There is no request to get the outputs of";
+  std::vector<NDArray> outputs(num_outputs_);
+  std::vector<NDArray> item;
+  for (PipelineChannel* channel : output_channels_) {
+    if (!WaitUntil([&]() { return channel->queue->TryPop(&item); })) ReportStopped();
+    for (size_t i = 0; i < item.size(); ++i) {
+      outputs[channel->dst_global_index[i]] = item[i];
+    }
+  }
+  --num_in_flight_;
+  return Array<NDArray>(outputs.begin(), outputs.end());
+}
+
+std::string PipelineScheduler::GetStatistics() const {
+  std::ostringstream os;
+  os << "{\"run_wait_us\": " << run_wait_us_.load() << ", \"stages\": [";
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    const PipelineStage& stage = *stages_[i];
+    uint64_t runs = stage.num_runs.load();
+    double div = std::max<uint64_t>(runs, 1);
+    os << (i == 0 ? "" : ", ") << "{\"mod_idx\": " << i << ", \"runs\": " << runs
+       << ", \"mean_run_us\": " << stage.run_us.load() / div
+       << ", \"max_run_us\": " << stage.max_run_us.load()
+       << ", \"input_wait_us\": " << stage.input_wait_us.load()
+       << ", \"output_wait_us\": " << stage.output_wait_us.load()
+       << ", \"mean_occupancy\": " << stage.occupancy_sum.load() / div
+       << ", \"zero_copy_inputs\": " << stage.zero_copy_inputs.load() << "}";
+  }
+  os << "]}";
+  return os.str();
+}
+
+void PipelineScheduler::Start() {
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    ICHECK(!stages_[i]->inputs.empty())
+        << "Module " << i << " has no input, the pipeline config is missing its input_connection";
+  }
+  for (auto& stage : stages_) PrepareZeroCopy(stage.get());
+  for (auto& channel : channels_) {
+    channel->queue.reset(new support::SPSCQueue<std::vector<NDArray>>(queue_capacity_));
+  }
+  started_ = true;
+  for (auto& stage : stages_) {
+    stage->thread = std::thread(&PipelineScheduler::StageLoop, this, stage.get());
+  }
+}
+
+void PipelineScheduler::Stop() {
+  stop_ = true;
+  for (auto& stage : stages_) {
+    if (stage->thread.joinable()) stage->thread.join();
+  }
+}
+
+void PipelineScheduler::PrepareZeroCopy(PipelineStage* stage) {
+  Module& module = stage->module;
+  PackedFunc get_input = module.GetFunction("get_input");
+  PackedFunc get_num_inputs = module.GetFunction("get_num_inputs");
+  PackedFunc get_output = module.GetFunction("get_output");
+  if (get_input == nullptr || get_num_inputs == nullptr) return;
+  // The number of inputs and outputs each internal buffer stands for, inputs counting twice.
+  std::unordered_map<void*, int> users;
+  int num_inputs = get_num_inputs();
+  for (int i = 0; i < num_inputs; ++i) {
+    NDArray input = get_input(i);
+    if (input.defined()) users[input->data] += 2;
+  }
+  std::map<int, NDArray> outputs;
+  for (PipelineChannel* channel : stage->outputs) {
+    for (int index : channel->src_index) {
+      if (outputs.count(index)) continue;
+      NDArray output = get_output(index);
+      outputs[index] = output;
+      ++users[output->data];
+    }
+  }
+  // get_output returns the internal buffer of an input, so such an input is copied.
+  if (module.GetFunction("set_input_zero_copy") != nullptr) {
+    for (PipelineChannel* channel : stage->inputs) {
+      for (const std::string& name : channel->dst_name) {
+        NDArray input = get_input(name);
+        channel->dst_input.push_back(users[input->data] == 2 ? input : NDArray());
+      }
+    }
+  }
+  // An output that is a graph input or that shares its entry with another output is not
+  // written by an operator of its own, binding it would leave the buffer unwritten.
+  if (module.GetFunction("set_output_zero_copy") == nullptr) return;
+  for (const auto& output : outputs) {
+    if (users[output.second->data] == 1) {
+      stage->bound_outputs[output.first].internal = output.second;
+    }
+  }
+}
+
+void PipelineScheduler::StageLoop(PipelineStage* stage) {
+  try {
+    PackedFunc set_input = stage->module.GetFunction("set_input");
+    PackedFunc run = stage->module.GetFunction("run");
+    PackedFunc get_output = stage->module.GetFunction("get_output");
+    PackedFunc set_input_zero_copy = stage->module.GetFunction("set_input_zero_copy");
+    PackedFunc set_output_zero_copy = stage->module.GetFunction("set_output_zero_copy");
+    std::vector<NDArray> item;
+    // The inputs bound without a copy, held until the run reading them is over.
+    std::vector<NDArray> bound_inputs;
+    std::unordered_map<int, NDArray> outputs;
+    while (true) {
+      bound_inputs.clear();
+      // Every producer pushes one item per request into each of its channels, so the
+      // items popped from the input channels belong to the same request.
+      size_t occupancy = 0;
+      for (PipelineChannel* channel : stage->inputs) {
+        auto begin = std::chrono::steady_clock::now();
+        if (!WaitUntil([&]() { return channel->queue->TryPop(&item); })) return;
+        stage->input_wait_us += MicrosecondsSince(begin);
+        occupancy = std::max(occupancy, channel->queue->size() + 1);
+        for (size_t i = 0; i < item.size(); ++i) {
+          if (i < channel->dst_input.size() && channel->dst_input[i].defined() &&
+              CanBindZeroCopy(item[i], channel->dst_input[i])) {
+            set_input_zero_copy(channel->dst_name[i], item[i]);
+            bound_inputs.push_back(item[i]);
+          } else {
+            set_input(channel->dst_name[i], item[i]);
+          }
+        }
+      }
+      item.clear();
+      stage->occupancy_sum += occupancy;
+      stage->zero_copy_inputs += bound_inputs.size();
+      // The modules on the same device share its default stream, so a buffer released by
+      // a consumer is only overwritten after the consumer read it.
+      for (auto& output : stage->bound_outputs) {
+        NDArray buffer = AcquireBuffer(&output.second);
+        set_output_zero_copy(output.first, buffer);
+        outputs[output.first] = buffer;
+      }
+      auto begin = std::chrono::steady_clock::now();
+      run();
+      uint64_t run_us = MicrosecondsSince(begin);
+      stage->run_us += run_us;
+      if (run_us > stage->max_run_us.load()) stage->max_run_us = run_us;
+      // The other outputs are overwritten by the next run, each one is copied once and
+      // shared by its consumers.
+      for (PipelineChannel* channel : stage->outputs) {
+        item.clear();
+        for (int index : channel->src_index) {
+          auto it = outputs.find(index);
+          if (it == outputs.end()) {
+            NDArray output = get_output(index);
+            it = outputs.emplace(index, output.CopyTo(output->device)).first;
+          }
+          item.push_back(it->second);
+        }
+        begin = std::chrono::steady_clock::now();
+        if (!WaitUntil([&]() { return channel->queue->TryPush(&item); })) return;
+        stage->output_wait_us += MicrosecondsSince(begin);
+      }
+      outputs.clear();
+      ++stage->num_runs;
+    }
+  } catch (const std::exception& e) {
+    Fail(e.what());
+  }
+}
+
+void PipelineScheduler::Fail(const std::string& error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (error_.empty()) error_ = error;
+  stop_ = true;
+}
+
+void PipelineScheduler::ReportStopped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LOG(FATAL) << "The pipeline stopped" << (error_.empty() ? "" : ": " + error_);
 }
 }  // namespace runtime
 }  // namespace tvm
@@ -18,34 +18,186 @@
  */
 #ifndef TVM_RUNTIME_PIPELINE_PIPELINE_SCHEDULER_H_
 #define TVM_RUNTIME_PIPELINE_PIPELINE_SCHEDULER_H_
+#include <tvm/runtime/container/array.h>
 #include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <atomic>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "../../support/spsc_queue.h"
 #include "pipeline_struct.h"
 namespace tvm {
 namespace runtime {
+/*!
+ * \brief A bounded queue carrying the tensors of one request from a producer to a consumer.
+ *  The producer and the consumer are either a stage or the caller of the pipeline.
+ */
+struct PipelineChannel {
+  /*! \brief The producer side index of each tensor: a module output index, or a global
+   *  input index when the caller produces the channel.
+   */
+  std::vector<int> src_index;
+  /*! \brief The module input name of each tensor, empty when the caller consumes it. */
+  std::vector<std::string> dst_name;
+  /*! \brief The global output index of each tensor when the caller consumes the channel. */
+  std::vector<int> dst_global_index;
+  /*! \brief The consumer input of each tensor, the ones matching it are bound without a copy.
+   *  Empty when the consumer cannot bind its inputs.
+   */
+  std::vector<NDArray> dst_input;
+  /*! \brief The queue, created when the pipeline starts. */
+  std::unique_ptr<support::SPSCQueue<std::vector<NDArray>>> queue;
+};
+/*!
+ * \brief The buffers a stage output is written to in place of the internal output.
+ *
+ *  A buffer is handed to the consumers after each run and reused once they all dropped
+ *  it, so the next run never overwrites a tensor still being read downstream.
+ */
+struct PipelineOutputBuffers {
+  /*! \brief The internal output of the module, giving the shape, type and device. */
+  NDArray internal;
+  /*! \brief The buffers allocated so far, at least two once the pipeline is busy. */
+  std::vector<NDArray> pool;
+};
+/*!
+ * \brief One pipeline stage: a graph executor module run by its own thread.
+ */
+struct PipelineStage {
+  /*! \brief The graph executor module. */
+  Module module;
+  /*! \brief The channels the stage consumes, one request is popped from each per run. */
+  std::vector<PipelineChannel*> inputs;
+  /*! \brief The channels the stage produces. */
+  std::vector<PipelineChannel*> outputs;
+  /*! \brief The outputs bound to buffers of their own, indexed by output index. */
+  std::unordered_map<int, PipelineOutputBuffers> bound_outputs;
+  /*! \brief The thread running the stage. */
+  std::thread thread;
+  /*! \brief The number of runs completed. */
+  std::atomic<uint64_t> num_runs{0};
+  /*! \brief The total and the maximum time spent in the module, in microseconds. */
+  std::atomic<uint64_t> run_us{0}, max_run_us{0};
+  /*! \brief The time spent waiting for an input, in microseconds. */
+  std::atomic<uint64_t> input_wait_us{0};
+  /*! \brief The time spent blocked on a full consumer queue, in microseconds. */
+  std::atomic<uint64_t> output_wait_us{0};
+  /*! \brief The sum over the runs of the number of requests queued ahead of the stage. */
+  std::atomic<uint64_t> occupancy_sum{0};
+  /*! \brief The number of inputs bound without a copy. */
+  std::atomic<uint64_t> zero_copy_inputs{0};
+};
 /*!
  * \brief The class that executes the pipeline logic,it is used to initialize the thread pool,
     execute and schedule pipeline tasks, allocate and manage memory, etc.
+ *
+ *  Each module runs on its own thread and the stages are connected by bounded lock-free
+ *  queues, so that the stages of consecutive requests overlap. A full queue blocks its
+ *  producer, which propagates the backpressure up to Run. Run and GetOutput must be
+ *  called from a single caller thread.
+ *
+ *  The modules write their outputs straight into buffers owned by the scheduler, and a
+ *  consumer on the device of a tensor binds it with set_input_zero_copy, so a tensor
+ *  crosses a same device edge without being copied.
  */
 class PipelineScheduler {
  public:
+  ~PipelineScheduler();
   /*!
    * \brief Initialize the pipeline.
    * \param modules The list of graph executor module.
    * \param pipeline_config The dependency information of each graph executor module.
+   * \param input_config The module inputs each global input is bound to.
+   */
+  size_t PipelineInit(const std::vector<Module>& modules, const PipelineConfig& pipeline_config,
+                      const InputConnectionConfig& input_config);
+  /*!
+   * \brief Set the capacity of the queues, only before the first Run.
+   * \param capacity The maximum number of requests waiting in front of each stage.
+   */
+  void SetQueueCapacity(int capacity);
+  /*!
+   * \brief Set a global input of the next request.
+   * \param name The global input name.
+   * \param data The input data, copied.
+   */
+  void SetInput(const std::string& name, DLTensor* data);
+  /*!
+   * \brief Submit the inputs set so far as one request, blocking while the pipeline is full.
+   *
+   *  The queues only hold a bounded number of requests, so the caller interleaves Run with
+   *  GetOutput to make room for new requests.
    */
-  size_t PipelineInit(const std::vector<Module>& modules, const PipelineConfig& pipeline_config);
+  void Run();
+  /*!
+   * \brief Wait for the outputs of the oldest request that has not been fetched.
+   * \return The global outputs, ordered by their global output index.
+   */
+  Array<NDArray> GetOutput();
+  /*! \return The per stage occupancy and latency counters as a JSON string. */
+  std::string GetStatistics() const;
 
  private:
+  /*! \brief Create the queues and start the stage threads. */
+  void Start();
+  /*! \brief Stop the stage threads and wait for them. */
+  void Stop();
+  /*!
+   * \brief Find the outputs of a stage that can be written to buffers of their own and the
+   *  inputs that can be bound to the tensors of the producers.
+   */
+  void PrepareZeroCopy(PipelineStage* stage);
+  /*! \brief The loop run by the thread of a stage. */
+  void StageLoop(PipelineStage* stage);
+  /*!
+   * \brief Push or pop until it succeeds, backing off while it fails.
+   * \return false when the pipeline stopped before it succeeded.
+   */
+  template <typename FTry>
+  bool WaitUntil(FTry ftry);
+  /*! \brief Stop the pipeline and make the caller fail with the error of a stage. */
+  void Fail(const std::string& error);
+  /*! \brief Log the error that stopped the pipeline. */
+  void ReportStopped() const;
   /*!\brief The list of graph executors.*/
   std::vector<Module> graph_modules_;
+  /*! \brief The stages, indexed by module index. */
+  std::vector<std::unique_ptr<PipelineStage>> stages_;
+  /*! \brief All the channels, owned here. */
+  std::vector<std::unique_ptr<PipelineChannel>> channels_;
+  /*! \brief The channels feeding the global inputs to the stages. */
+  std::vector<PipelineChannel*> input_channels_;
+  /*! \brief The channels returning the global outputs to the caller. */
+  std::vector<PipelineChannel*> output_channels_;
+  /*! \brief The index of each global input name in pending_inputs_. */
+  std::unordered_map<std::string, int> input_index_;
+  /*! \brief The global inputs of the next request. */
+  std::vector<NDArray> pending_inputs_;
+  /*! \brief The number of requests submitted by Run whose outputs were not fetched. */
+  int64_t num_in_flight_{0};
+  /*! \brief The number of global outputs. */
+  size_t num_outputs_{0};
+  /*! \brief The capacity of each queue. */
+  size_t queue_capacity_{4};
+  /*! \brief Whether the stage threads have been started. */
+  bool started_{false};
+  /*! \brief Set to stop the stage threads. */
+  std::atomic<bool> stop_{false};
+  /*! \brief The time Run spent blocked on a full pipeline, in microseconds. */
+  std::atomic<uint64_t> run_wait_us_{0};
+  /*! \brief Protects error_. */
+  mutable std::mutex mutex_;
+  /*! \brief The error that stopped the pipeline, empty when it did not fail. */
+  std::string error_;
 };
 }  // namespace runtime
 }  // namespace tvm
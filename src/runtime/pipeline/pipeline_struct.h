@@ -25,6 +25,7 @@
 #include <limits>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 /*!
  * \brief All binding information of a output interface.
@@ -166,6 +167,44 @@ struct PipelineConfig {
     return num_output;
   }
 };
+/*!
+ * \brief The module inputs each global input of the pipeline is bound to.
+ */
+struct InputConnectionConfig {
+  /*!\brief The key is the global input name, the value is the list of module index and module
+   * input name pairs that receive this global input.
+   */
+  std::unordered_map<std::string, std::vector<std::pair<int, std::string>>> input_connection;
+  /*!
+   * \brief Create the input connection map from JSONReader.
+   * \param reader Json reader.
+   */
+  void Load(dmlc::JSONReader* reader) {
+    reader->BeginArray();
+    while (reader->NextArrayItem()) {
+      std::string key;
+      reader->BeginObject();
+      std::string global_interface_name;
+      std::string module_interface_name;
+      int mod_idx = -1;
+      while (reader->NextObjectItem(&key)) {
+        if (key == "global_interface_name") {
+          reader->Read(&global_interface_name);
+        } else if (key == "mod_idx") {
+          reader->Read(&mod_idx);
+        } else if (key == "module_interface_name") {
+          reader->Read(&module_interface_name);
+        } else {
+          LOG(FATAL) << "do not support key " << key;
+        }
+      }
+      ICHECK(mod_idx >= 0) << "Invalid mod_idx value " << mod_idx;
+      ICHECK(!global_interface_name.empty()) << "global_interface_name is empty.";
+      ICHECK(!module_interface_name.empty()) << "module_interface_name is empty.";
+      input_connection[global_interface_name].emplace_back(mod_idx, module_interface_name);
+    }
+  }
+};
 /*!
  * \brief The information used to initialize the graph executor module, the information
  *  come from the export library function call.
@@ -31,11 +31,15 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <numeric>
+#include <set>
+
+#include "memory_stats.h"
 
 namespace tvm {
 namespace runtime {
@@ -105,6 +109,19 @@ TVM_REGISTER_GLOBAL("profiling.start_timer").set_body_typed(Timer::Start);
 
 namespace profiling {
 
+namespace {
+/*! \brief The per-call metrics placing the calls on a timeline, left out of the tables. */
+constexpr const char* kStartMetric = "Start (us)";
+constexpr const char* kThreadMetric = "Thread";
+
+/*! \brief A small index identifying the calling thread in the timelines. */
+int64_t CurrentThreadIndex() {
+  static std::atomic<int64_t> num_threads{0};
+  thread_local int64_t index = num_threads.fetch_add(1);
+  return index;
+}
+}  // namespace
+
 Profiler::Profiler(std::vector<Device> devs, std::vector<MetricCollector> metric_collectors)
     : devs_(devs), collectors_(metric_collectors) {
   is_running_ = false;
@@ -121,6 +138,9 @@ Profiler::Profiler(std::vector<Device> devs, std::vector<MetricCollector> metric
 
 void Profiler::Start() {
   is_running_ = true;
+  // the peaks reported per device are the ones of the profiled run
+  MemoryStats::ResetPeaks();
+  start_time_ = std::chrono::steady_clock::now();
   for (auto dev : devs_) {
     StartCall("Total", dev, {});
   }
@@ -135,7 +155,13 @@ void Profiler::StartCall(String name, Device dev,
       objs.emplace_back(collector, obj);
     }
   }
-  in_flight_.push(CallFrame{dev, name, Timer::Start(dev), extra_metrics, objs});
+  CallFrame cf{dev, name, Timer(), extra_metrics, objs};
+  cf.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_time_)
+                    .count();
+  cf.thread = CurrentThreadIndex();
+  cf.timer = Timer::Start(dev);
+  in_flight_.push(cf);
 }
 
 void Profiler::StopCall(std::unordered_map<std::string, ObjectRef> extra_metrics) {
@@ -157,8 +183,10 @@ void Profiler::StopCall(std::unordered_map<std::string, ObjectRef> extra_metrics
 
 void Profiler::Stop() {
   is_running_ = false;
-  for (size_t i = 0; i < devs_.size(); i++) {
-    StopCall();
+  // the frames of the devices are stopped in the reverse order of Start
+  for (size_t i = devs_.size(); i > 0; i--) {
+    int64_t peak = MemoryStats::Get(devs_[i - 1], kMemoryTotal)->peak_bytes();
+    StopCall({{"Peak Memory (bytes)", ObjectRef(make_object<CountNode>(peak))}});
   }
 }
 
@@ -263,6 +291,8 @@ String ReportNode::AsCSV() const {
           s << (*it).second.as<DurationNode>()->microseconds;
         } else if ((*it).second.as<PercentNode>()) {
           s << (*it).second.as<PercentNode>()->percent;
+        } else if ((*it).second.as<RatioNode>()) {
+          s << (*it).second.as<RatioNode>()->ratio;
         } else if ((*it).second.as<StringObj>()) {
           s << "\"" << Downcast<String>((*it).second) << "\"";
         }
@@ -288,6 +318,8 @@ void print_metric(std::ostream& os, ObjectRef o) {
     os << "{\"microseconds\":" << std::to_string(n->microseconds) << "}";
   } else if (const PercentNode* n = o.as<PercentNode>()) {
     os << "{\"percent\":" << std::to_string(n->percent) << "}";
+  } else if (const RatioNode* n = o.as<RatioNode>()) {
+    os << "{\"ratio\":" << std::to_string(n->ratio) << "}";
   } else {
     LOG(FATAL) << "Unprintable type " << o->GetTypeKey();
   }
@@ -343,13 +375,95 @@ String ReportNode::AsJSON() const {
   return s.str();
 }
 
+namespace {
+std::string EscapeJSON(const std::string& str) {
+  std::string out;
+  for (char c : str) {
+    if (c == '"' || c == '\\') out.push_back('\\');
+    out.push_back(c);
+  }
+  return out;
+}
+
+// Print a metric as a JSON value of the args of a trace event.
+void PrintTraceArg(std::ostream& os, const ObjectRef& o) {
+  if (o.as<StringObj>()) {
+    os << "\"" << EscapeJSON(Downcast<String>(o)) << "\"";
+  } else if (const CountNode* n = o.as<CountNode>()) {
+    os << n->value;
+  } else if (const DurationNode* n = o.as<DurationNode>()) {
+    os << n->microseconds;
+  } else if (const PercentNode* n = o.as<PercentNode>()) {
+    os << n->percent;
+  } else if (const RatioNode* n = o.as<RatioNode>()) {
+    os << n->ratio;
+  } else {
+    os << "\"" << o->GetTypeKey() << "\"";
+  }
+}
+}  // namespace
+
+String ReportNode::AsChromeTrace() const {
+  std::ostringstream s;
+  s << std::fixed << std::setprecision(3);
+  s << "{\"traceEvents\":[";
+  // each device is a process, numbered in order of appearance
+  std::unordered_map<std::string, int> pids;
+  // the end of the last call of each device, where a call without a start is placed
+  std::unordered_map<std::string, double> device_end;
+  for (const auto& call : calls) {
+    auto it = call.find("Device");
+    std::string device = it == call.end() ? "" : std::string(Downcast<String>((*it).second));
+    if (pids.find(device) == pids.end()) {
+      int pid = static_cast<int>(pids.size());
+      pids[device] = pid;
+      s << (pid ? "," : "") << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+        << ",\"args\":{\"name\":\"" << EscapeJSON(device) << "\"}}";
+    }
+    it = call.find("Duration (us)");
+    double duration = it == call.end() ? 0 : (*it).second.as<DurationNode>()->microseconds;
+    it = call.find(kStartMetric);
+    double start =
+        it == call.end() ? device_end[device] : (*it).second.as<DurationNode>()->microseconds;
+    device_end[device] = std::max(device_end[device], start + duration);
+    it = call.find(kThreadMetric);
+    int64_t thread = it == call.end() ? 0 : (*it).second.as<CountNode>()->value;
+    it = call.find("Name");
+    std::string name = it == call.end() ? "" : std::string(Downcast<String>((*it).second));
+    s << ",{\"name\":\"" << EscapeJSON(name) << "\",\"cat\":\"op\",\"ph\":\"X\",\"ts\":"
+      << start << ",\"dur\":" << duration << ",\"pid\":" << pids[device] << ",\"tid\":" << thread
+      << ",\"args\":{";
+    bool first = true;
+    for (const auto& kv : call) {
+      if (kv.first == "Name" || kv.first == "Device" || kv.first == "Duration (us)" ||
+          kv.first == kStartMetric || kv.first == kThreadMetric) {
+        continue;
+      }
+      s << (first ? "" : ",") << "\"" << EscapeJSON(kv.first) << "\":";
+      PrintTraceArg(s, kv.second);
+      first = false;
+    }
+    s << "}}";
+  }
+  s << "],\"displayTimeUnit\":\"ns\"}";
+  return s.str();
+}
+
 String ReportNode::AsTable(bool sort, bool aggregate, bool compute_col_sums) const {
+  // the timeline metrics are only meaningful per call
+  std::vector<Map<String, ObjectRef>> table_calls;
+  for (Map<String, ObjectRef> frame : calls) {
+    frame.erase(kStartMetric);
+    frame.erase(kThreadMetric);
+    table_calls.push_back(frame);
+  }
+
   // aggregate calls by op hash (or op name if hash is not set) + argument shapes
   std::vector<Map<String, ObjectRef>> aggregated_calls;
   if (aggregate) {
     std::unordered_map<std::string, std::vector<size_t>> aggregates;
-    for (size_t i = 0; i < calls.size(); i++) {
-      auto& frame = calls[i];
+    for (size_t i = 0; i < table_calls.size(); i++) {
+      auto& frame = table_calls[i];
       auto it = frame.find("Hash");
       std::string name = Downcast<String>(frame["Name"]);
       if (it != frame.end()) {
@@ -370,9 +484,13 @@ String ReportNode::AsTable(bool sort, bool aggregate, bool compute_col_sums) con
     }
     for (const auto& p : aggregates) {
       std::unordered_map<String, ObjectRef> aggregated;
+      std::unordered_map<String, int64_t> ratio_counts;
       for (auto i : p.second) {
-        for (auto& metric : calls[i]) {
+        for (auto& metric : table_calls[i]) {
           auto it = aggregated.find(metric.first);
+          if (metric.second.as<RatioNode>()) {
+            ratio_counts[metric.first]++;
+          }
           if (it == aggregated.end()) {
             aggregated[metric.first] = metric.second;
           } else {
@@ -387,20 +505,27 @@ String ReportNode::AsTable(bool sort, bool aggregate, bool compute_col_sums) con
               aggregated[metric.first] =
                   ObjectRef(make_object<PercentNode>(it->second.as<PercentNode>()->percent +
                                                      metric.second.as<PercentNode>()->percent));
+            } else if (metric.second.as<RatioNode>()) {
+              aggregated[metric.first] = ObjectRef(make_object<RatioNode>(
+                  it->second.as<RatioNode>()->ratio + metric.second.as<RatioNode>()->ratio));
             } else if (metric.second.as<StringObj>()) {
               // Don't do anything. Assume the two strings are the same.
             } else {
               LOG(FATAL) << "Can only aggregate metrics with types DurationNode, CountNode, "
-                            "PercentNode, and StringObj, but got "
+                            "PercentNode, RatioNode, and StringObj, but got "
                          << metric.second->GetTypeKey();
             }
           }
         }
       }
+      for (const auto& count : ratio_counts) {
+        aggregated[count.first] = ObjectRef(make_object<RatioNode>(
+            aggregated[count.first].as<RatioNode>()->ratio / count.second));
+      }
       aggregated_calls.push_back(aggregated);
     }
   } else {
-    for (auto call : calls) {
+    for (auto call : table_calls) {
       aggregated_calls.push_back(call);
     }
   }
@@ -499,6 +624,11 @@ String ReportNode::AsTable(bool sort, bool aggregate, bool compute_col_sums) con
           std::stringstream s;
           s << std::fixed << std::setprecision(2) << (*it).second.as<PercentNode>()->percent;
           val = s.str();
+        } else if ((*it).second.as<RatioNode>()) {
+          std::stringstream s;
+          s.imbue(std::locale(""));  // for 1000s seperators
+          s << std::fixed << std::setprecision(2) << (*it).second.as<RatioNode>()->ratio;
+          val = s.str();
         } else if ((*it).second.as<StringObj>()) {
           val = Downcast<String>((*it).second);
         }
@@ -555,6 +685,8 @@ Report Profiler::Report(bool aggregate, bool sort) {
     row["Count"] = ObjectRef(make_object<CountNode>(1));
     row["Name"] = cf.name;
     row["Device"] = String(DeviceString(cf.dev));
+    row[kStartMetric] = ObjectRef(make_object<DurationNode>(cf.start_ns / 1e3));
+    row[kThreadMetric] = ObjectRef(make_object<CountNode>(cf.thread));
     for (auto p : cf.extra_metrics) {
       row[p.first] = p.second;
     }
@@ -567,6 +699,8 @@ Report Profiler::Report(bool aggregate, bool sort) {
   for (size_t i = 0; i < devs_.size(); i++) {
     auto row = rows[rows.size() - 1];
     rows.pop_back();
+    row.erase(kStartMetric);
+    row.erase(kThreadMetric);
     device_metrics[Downcast<String>(row["Device"])] = row;
     overall_time_us =
         std::max(overall_time_us, row["Duration (us)"].as<DurationNode>()->microseconds);
@@ -615,13 +749,17 @@ Map<String, ObjectRef> parse_metrics(dmlc::JSONReader* reader) {
       int64_t count;
       reader->Read(&count);
       o = ObjectRef(make_object<CountNode>(count));
+    } else if (metric_value_name == "ratio") {
+      double ratio;
+      reader->Read(&ratio);
+      o = ObjectRef(make_object<RatioNode>(ratio));
     } else if (metric_value_name == "string") {
       std::string s;
       reader->Read(&s);
       o = String(s);
     } else {
       LOG(FATAL) << "Cannot parse metric of type " << metric_value_name
-                 << " valid types are microseconds, percent, count.";
+                 << " valid types are microseconds, percent, count, ratio.";
     }
     metrics.Set(metric_name, o);
     // Necessary to make sure that the parser hits the end of the object.
@@ -664,16 +802,37 @@ Report Report::FromJSON(String json) {
 TVM_REGISTER_OBJECT_TYPE(DurationNode);
 TVM_REGISTER_OBJECT_TYPE(PercentNode);
 TVM_REGISTER_OBJECT_TYPE(CountNode);
+TVM_REGISTER_OBJECT_TYPE(RatioNode);
 TVM_REGISTER_OBJECT_TYPE(ReportNode);
 TVM_REGISTER_OBJECT_TYPE(DeviceWrapperNode);
 TVM_REGISTER_OBJECT_TYPE(MetricCollectorNode);
 
 TVM_REGISTER_GLOBAL("runtime.profiling.AsTable").set_body_method<Report>(&ReportNode::AsTable);
 TVM_REGISTER_GLOBAL("runtime.profiling.AsCSV").set_body_typed([](Report n) { return n->AsCSV(); });
+TVM_REGISTER_GLOBAL("runtime.profiling.AsChromeTrace").set_body_typed([](Report n) {
+  return n->AsChromeTrace();
+});
 TVM_REGISTER_GLOBAL("runtime.profiling.AsJSON").set_body_typed([](Report n) {
   return n->AsJSON();
 });
 TVM_REGISTER_GLOBAL("runtime.profiling.FromJSON").set_body_typed(Report::FromJSON);
+TVM_REGISTER_GLOBAL("runtime.profiling.Report")
+    .set_body_typed([](Array<Map<String, ObjectRef>> calls,
+                       Map<String, Map<String, ObjectRef>> device_metrics) {
+      return Report(calls, device_metrics);
+    });
+TVM_REGISTER_GLOBAL("runtime.profiling.Count").set_body_typed([](int64_t count) {
+  return ObjectRef(make_object<CountNode>(count));
+});
+TVM_REGISTER_GLOBAL("runtime.profiling.Duration").set_body_typed([](double duration) {
+  return ObjectRef(make_object<DurationNode>(duration));
+});
+TVM_REGISTER_GLOBAL("runtime.profiling.Percent").set_body_typed([](double percent) {
+  return ObjectRef(make_object<PercentNode>(percent));
+});
+TVM_REGISTER_GLOBAL("runtime.profiling.Ratio").set_body_typed([](double ratio) {
+  return ObjectRef(make_object<RatioNode>(ratio));
+});
 TVM_REGISTER_GLOBAL("runtime.profiling.DeviceWrapper").set_body_typed([](Device dev) {
   return DeviceWrapper(dev);
 });
@@ -138,6 +138,15 @@ class ROCMDeviceAPI final : public DeviceAPI {
     ROCM_CALL(hipFree(ptr));
   }
 
+  void* AllocPinnedHostSpace(Device dev, size_t nbytes) final {
+    ROCM_CALL(hipSetDevice(dev.device_id));
+    void* ret;
+    ROCM_CALL(hipHostMalloc(&ret, nbytes, hipHostMallocDefault));
+    return ret;
+  }
+
+  void FreePinnedHostSpace(Device dev, void* ptr) final { ROCM_CALL(hipHostFree(ptr)); }
+
   void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
                       Device dev_from, Device dev_to, DLDataType type_hint,
                       TVMStreamHandle stream) final {
@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rpc_compression.cc
+ * \brief Codecs compressing the tensor data copied through an RPC session.
+ */
+#include "rpc_compression.h"
+
+#include <tvm/runtime/logging.h>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+namespace tvm {
+namespace runtime {
+
+namespace {
+// The zero run codec writes a sequence of records, each made of the number of zero bytes,
+// the number of literal bytes and the literal bytes, the counts being LEB128 varints.
+
+// Shorter runs are left in the literals, their record would not save anything.
+constexpr size_t kMinZeroRun = 16;
+
+inline uint64_t LoadWord(const uint8_t* ptr) {
+  uint64_t word;
+  std::memcpy(&word, ptr, sizeof(word));
+  return word;
+}
+
+size_t CountZeros(const uint8_t* data, size_t begin, size_t end) {
+  size_t i = begin;
+  while (i + 8 <= end && LoadWord(data + i) == 0) i += 8;
+  while (i < end && data[i] == 0) ++i;
+  return i - begin;
+}
+
+// The start of the first run of kMinZeroRun zeros in [begin, end), end when there is none.
+// Such a run covers a whole zero word at a multiple of 8, so only those words are tested.
+size_t FindZeroRun(const uint8_t* data, size_t begin, size_t end) {
+  for (size_t i = (begin + 7) & ~static_cast<size_t>(7); i + 8 <= end; i += 8) {
+    if (LoadWord(data + i) != 0) continue;
+    size_t start = i;
+    while (start > begin && data[start - 1] == 0) --start;
+    if (i + 8 - start + CountZeros(data, i + 8, end) >= kMinZeroRun) return start;
+  }
+  return end;
+}
+
+void PutVarint(std::string* out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+uint64_t GetVarint(const uint8_t** ptr, const uint8_t* end) {
+  uint64_t value = 0;
+  for (int shift = 0;; shift += 7) {
+    ICHECK(*ptr != end && shift < 64) << "RPCDecompress: truncated or corrupted data";
+    uint8_t byte = *(*ptr)++;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) return value;
+  }
+}
+
+std::string ZeroRunCompress(const uint8_t* data, size_t nbytes) {
+  std::string out;
+  size_t i = 0;
+  while (i < nbytes) {
+    size_t literal_begin = i + CountZeros(data, i, nbytes);
+    size_t literal_end =
+        literal_begin == nbytes ? nbytes : FindZeroRun(data, literal_begin, nbytes);
+    PutVarint(&out, literal_begin - i);
+    PutVarint(&out, literal_end - literal_begin);
+    out.append(reinterpret_cast<const char*>(data) + literal_begin, literal_end - literal_begin);
+    i = literal_end;
+  }
+  return out;
+}
+
+void ZeroRunDecompress(const uint8_t* data, size_t size, uint8_t* out, size_t nbytes) {
+  const uint8_t* end = data + size;
+  size_t pos = 0;
+  while (pos < nbytes) {
+    uint64_t num_zeros = GetVarint(&data, end);
+    uint64_t num_literals = GetVarint(&data, end);
+    ICHECK(num_zeros <= nbytes - pos && num_literals <= nbytes - pos - num_zeros &&
+           num_literals <= static_cast<uint64_t>(end - data))
+        << "RPCDecompress: truncated or corrupted data";
+    std::memset(out + pos, 0, num_zeros);
+    pos += num_zeros;
+    std::memcpy(out + pos, data, num_literals);
+    pos += num_literals;
+    data += num_literals;
+  }
+  ICHECK(data == end) << "RPCDecompress: " << (end - data) << " trailing bytes";
+}
+}  // namespace
+
+std::string RPCCompressionCodecs() { return kRPCZeroRunCodec; }
+
+bool RPCHasCompressionCodec(const std::string& codecs, const std::string& codec) {
+  std::istringstream is(codecs);
+  std::string name;
+  while (std::getline(is, name, ',')) {
+    if (name == codec) return true;
+  }
+  return false;
+}
+
+std::string RPCCompress(const std::string& codec, const void* data, size_t nbytes) {
+  ICHECK_EQ(codec, kRPCZeroRunCodec) << "RPCCompress: unknown codec " << codec;
+  return ZeroRunCompress(static_cast<const uint8_t*>(data), nbytes);
+}
+
+void RPCDecompress(const std::string& codec, const void* data, size_t size, void* out,
+                   size_t nbytes) {
+  ICHECK_EQ(codec, kRPCZeroRunCodec) << "RPCDecompress: unknown codec " << codec;
+  ZeroRunDecompress(static_cast<const uint8_t*>(data), size, static_cast<uint8_t*>(out), nbytes);
+}
+
+}  // namespace runtime
+}  // namespace tvm
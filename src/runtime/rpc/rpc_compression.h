@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rpc_compression.h
+ * \brief Codecs compressing the tensor data copied through an RPC session.
+ */
+#ifndef TVM_RUNTIME_RPC_RPC_COMPRESSION_H_
+#define TVM_RUNTIME_RPC_RPC_COMPRESSION_H_
+
+#include <cstddef>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief The codec replacing the runs of zero bytes by their length.
+ *
+ *  It needs no third party library and targets the weights of pruned and quantized
+ *  models, in which long runs of zeros are common. Other data is sent as is, with a few
+ *  bytes of overhead.
+ */
+constexpr const char* kRPCZeroRunCodec = "zero_rle";
+
+/*! \return The codecs supported by RPCCompress and RPCDecompress, comma separated. */
+std::string RPCCompressionCodecs();
+
+/*!
+ * \brief Check whether a codec is supported.
+ * \param codecs The supported codecs, comma separated.
+ * \param codec The codec name.
+ * \return Whether codec is one of codecs.
+ */
+bool RPCHasCompressionCodec(const std::string& codecs, const std::string& codec);
+
+/*!
+ * \brief Compress a block of data.
+ * \param codec The codec name.
+ * \param data The data.
+ * \param nbytes The size of the data in bytes.
+ * \return The compressed data.
+ */
+std::string RPCCompress(const std::string& codec, const void* data, size_t nbytes);
+
+/*!
+ * \brief Decompress a block of data, failing when it was not compressed by RPCCompress.
+ * \param codec The codec name.
+ * \param data The compressed data.
+ * \param size The size of the compressed data in bytes.
+ * \param out The location of the decompressed data.
+ * \param nbytes The size of the decompressed data in bytes.
+ */
+void RPCDecompress(const std::string& codec, const void* data, size_t size, void* out,
+                   size_t nbytes);
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_RPC_RPC_COMPRESSION_H_
@@ -41,6 +41,7 @@
 #include "../../support/arena.h"
 #include "../../support/ring_buffer.h"
 #include "../object_internal.h"
+#include "rpc_compression.h"
 #include "rpc_local_session.h"
 
 namespace tvm {
@@ -646,25 +647,95 @@ RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncod
   return code;
 }
 
+void RPCEndpoint::FlushWriter() {
+  while (writer_.bytes_available() != 0) {
+    size_t n = writer_.ReadWithCallback(
+        [this](const void* data, size_t size) { return channel_->Send(data, size); },
+        writer_.bytes_available());
+    if (n == 0) break;
+  }
+}
+
+void RPCEndpoint::ReserveRequest(uint64_t reply_nbytes) {
+  while (!pending_.empty() &&
+         (pending_.size() >= static_cast<size_t>(max_pending_requests_) ||
+          pending_reply_nbytes_ + reply_nbytes > kRPCMaxPendingReplyBytes)) {
+    HandleNextReply();
+  }
+}
+
+uint64_t RPCEndpoint::FinishRequest(PendingRequest request) {
+  if (request.encode_return == nullptr) request.encode_return = [](TVMArgs) {};
+  request.seq = next_seq_++;
+  pending_reply_nbytes_ += request.reply_nbytes;
+  pending_.push_back(std::move(request));
+  // Push the request out now, its reply is read by whoever waits next.
+  FlushWriter();
+  return pending_.back().seq;
+}
+
+void RPCEndpoint::HandleNextReply() {
+  PendingRequest request = std::move(pending_.front());
+  pending_.pop_front();
+  pending_reply_nbytes_ -= request.reply_nbytes;
+  try {
+    RPCCode code = HandleUntilReturnEvent(true, request.encode_return);
+    ICHECK(code == request.reply_code) << "code=" << RPCCodeToString(code);
+    if (code == RPCCode::kCopyAck) {
+      handler_->ReadArray(reinterpret_cast<char*>(request.copy_to), request.reply_nbytes);
+      handler_->FinishCopyAck();
+    }
+  } catch (const std::exception& e) {
+    // Keep the error for the one waiting for the request, the replies after it still
+    // arrive in order.
+    if (!request.detached) {
+      failed_[request.seq] = std::current_exception();
+    } else if (detached_error_ == nullptr) {
+      detached_error_ = std::current_exception();
+    }
+  }
+  finished_returns_.push_back(std::move(request.encode_return));
+}
+
+void RPCEndpoint::WaitLocked(uint64_t seq) {
+  while (!pending_.empty() && pending_.front().seq <= seq) {
+    HandleNextReply();
+  }
+  std::exception_ptr error = nullptr;
+  auto it = failed_.find(seq);
+  if (it != failed_.end()) {
+    error = it->second;
+    failed_.erase(it);
+  } else {
+    std::swap(error, detached_error_);
+  }
+  if (error != nullptr) std::rethrow_exception(error);
+}
+
+void RPCEndpoint::WaitForRequest(uint64_t seq) {
+  LockGuard lock(this);
+  WaitLocked(seq);
+}
+
+void RPCEndpoint::SetMaxPendingRequests(int num) {
+  LockGuard lock(this);
+  ICHECK_GT(num, 0);
+  max_pending_requests_ = num;
+}
+
 void RPCEndpoint::Init() {
   // callback to flush the writer.
-  auto flush_writer = [this]() {
-    while (writer_.bytes_available() != 0) {
-      size_t n = writer_.ReadWithCallback(
-          [this](const void* data, size_t size) { return channel_->Send(data, size); },
-          writer_.bytes_available());
-      if (n == 0) break;
-    }
-  };
+  auto flush_writer = [this]() { this->FlushWriter(); };
 
   // Event handler
   handler_ = std::make_shared<EventHandler>(&reader_, &writer_, name_, &remote_key_, flush_writer);
 
   // Quick function to for syscall remote.
-  syscall_remote_ = PackedFunc([this](TVMArgs all_args, TVMRetValue* rv) {
-    std::lock_guard<std::mutex> lock(mutex_);
+  auto syscall_remote = [this](TVMArgs all_args, TVMRetValue* rv, bool wait) {
+    LockGuard lock(this);
     RPCCode code = static_cast<RPCCode>(all_args[0].operator int());
     TVMArgs args(all_args.values + 1, all_args.type_codes + 1, all_args.num_args - 1);
+    ReserveRequest(0);
 
     uint64_t packet_nbytes = sizeof(code) + handler_->PackedSeqGetNumBytes(
                                                 args.values, args.type_codes, args.num_args, true);
@@ -674,12 +745,22 @@ void RPCEndpoint::Init() {
     handler_->Write(code);
     handler_->SendPackedSeq(args.values, args.type_codes, args.num_args, true);
 
-    code = HandleUntilReturnEvent(true, [rv](TVMArgs args) {
-      ICHECK_EQ(args.size(), 1);
-      *rv = args[0];
-    });
-    ICHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
-  });
+    PendingRequest request;
+    if (wait) {
+      request.encode_return = [rv](TVMArgs args) {
+        ICHECK_EQ(args.size(), 1);
+        *rv = args[0];
+      };
+      WaitLocked(FinishRequest(std::move(request)));
+    } else {
+      request.detached = true;
+      FinishRequest(std::move(request));
+    }
+  };
+  syscall_remote_ = PackedFunc(
+      [syscall_remote](TVMArgs args, TVMRetValue* rv) { syscall_remote(args, rv, true); });
+  syscall_remote_no_wait_ = PackedFunc(
+      [syscall_remote](TVMArgs args, TVMRetValue* rv) { syscall_remote(args, rv, false); });
 }
 
 /*!
@@ -715,12 +796,7 @@ void RPCEndpoint::Shutdown() {
 
     // flush all writing buffer to output channel.
     try {
-      while (writer_.bytes_available() != 0) {
-        size_t n = writer_.ReadWithCallback(
-            [this](const void* data, size_t size) { return channel_->Send(data, size); },
-            writer_.bytes_available());
-        if (n == 0) break;
-      }
+      FlushWriter();
     } catch (const Error& e) {
     }
     channel_.reset(nullptr);
@@ -758,7 +834,8 @@ int RPCEndpoint::ServerAsyncIOEventHandler(const std::string& in_bytes, int even
 }
 
 void RPCEndpoint::InitRemoteSession(TVMArgs args) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  LockGuard lock(this);
+  ReserveRequest(0);
   RPCCode code = RPCCode::kInitServer;
   std::string protocol_ver = kRPCProtocolVer;
   uint64_t length = protocol_ver.length();
@@ -774,17 +851,14 @@ void RPCEndpoint::InitRemoteSession(TVMArgs args) {
   handler_->WriteArray(protocol_ver.data(), length);
   handler_->SendPackedSeq(args.values, args.type_codes, args.num_args, true);
 
-  code = HandleUntilReturnEvent(true, [](TVMArgs args) {});
-  ICHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
+  WaitLocked(FinishRequest(PendingRequest()));
 }
 
-// Get remote function with name
-void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
-                           const int* arg_type_codes, int num_args,
-                           RPCSession::FEncodeReturn encode_return) {
-  std::lock_guard<std::mutex> lock(mutex_);
-
+uint64_t RPCEndpoint::SendCallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                                   const int* arg_type_codes, int num_args,
+                                   RPCSession::FEncodeReturn encode_return) {
   handler_->ValidateArguments(arg_values, arg_type_codes, num_args);
+  ReserveRequest(0);
   RPCCode code = RPCCode::kCallFunc;
   uint64_t handle = reinterpret_cast<uint64_t>(h);
 
@@ -797,18 +871,35 @@ void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_v
   handler_->Write(handle);
   handler_->SendPackedSeq(arg_values, arg_type_codes, num_args, true);
 
-  code = HandleUntilReturnEvent(true, encode_return);
-  ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
+  PendingRequest request;
+  request.encode_return = std::move(encode_return);
+  return FinishRequest(std::move(request));
 }
 
-void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
-  std::lock_guard<std::mutex> lock(mutex_);
+// Get remote function with name
+void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                           const int* arg_type_codes, int num_args,
+                           RPCSession::FEncodeReturn encode_return) {
+  LockGuard lock(this);
+  WaitLocked(SendCallFunc(h, arg_values, arg_type_codes, num_args, std::move(encode_return)));
+}
+
+uint64_t RPCEndpoint::SubmitCallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                                     const int* arg_type_codes, int num_args,
+                                     RPCSession::FEncodeReturn encode_return) {
+  LockGuard lock(this);
+  return SendCallFunc(h, arg_values, arg_type_codes, num_args, std::move(encode_return));
+}
+
+uint64_t RPCEndpoint::SendCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                                       bool detached) {
   RPCCode code = RPCCode::kCopyToRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
   ICHECK_LE(to->byte_offset + nbytes, tensor_total_size_bytes)
       << "CopyToRemote: overflow in tensor size: (byte_offset=" << to->byte_offset
       << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  ReserveRequest(0);
 
   uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(to, code, nbytes);
   uint64_t packet_nbytes = overhead + nbytes;
@@ -818,17 +909,31 @@ void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes)
   RPCReference::SendDLTensor(handler_, to);
   handler_->Write(nbytes);
   handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+
+  PendingRequest request;
+  request.detached = detached;
+  return FinishRequest(std::move(request));
+}
+
+void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+  LockGuard lock(this);
+  WaitLocked(SendCopyToRemote(from_bytes, to, nbytes, false));
+}
+
+void RPCEndpoint::SubmitCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+  LockGuard lock(this);
+  SendCopyToRemote(from_bytes, to, nbytes, true);
 }
 
 void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  LockGuard lock(this);
   RPCCode code = RPCCode::kCopyFromRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
   ICHECK_LE(from->byte_offset + nbytes, tensor_total_size_bytes)
       << "CopyFromRemote: overflow in tensor size: (byte_offset=" << from->byte_offset
       << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  ReserveRequest(nbytes);
 
   uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(from, code, nbytes);
   uint64_t packet_nbytes = overhead;
@@ -837,10 +942,12 @@ void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, from);
   handler_->Write(nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
 
-  handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
-  handler_->FinishCopyAck();
+  PendingRequest request;
+  request.reply_code = RPCCode::kCopyAck;
+  request.copy_to = to_bytes;
+  request.reply_nbytes = nbytes;
+  WaitLocked(FinishRequest(std::move(request)));
 }
 
 // SysCallEventHandler functions
@@ -1009,60 +1116,92 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     endpoint_->CallFunc(func, arg_values, arg_type_codes, num_args, fencode_return);
   }
 
+  std::function<void()> SubmitCallFunc(PackedFuncHandle func, const TVMValue* arg_values,
+                                       const int* arg_type_codes, int num_args,
+                                       FEncodeReturn fencode_return) final {
+    GetMaxPendingRequests();
+    uint64_t seq = endpoint_->SubmitCallFunc(func, arg_values, arg_type_codes, num_args,
+                                             std::move(fencode_return));
+    std::shared_ptr<RPCEndpoint> endpoint = endpoint_;
+    return [endpoint, seq]() { endpoint->WaitForRequest(seq); };
+  }
+
   void CopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes) final {
-    RPCCode code = RPCCode::kCopyToRemote;
-    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_to, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyToRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* from_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, block_size);
+    const uint64_t block_size = GetCopyBlockSize(remote_to, RPCCode::kCopyToRemote, nbytes);
+    // A server that queues requests acknowledges the blocks while the next ones are
+    // compressed and sent.
+    bool pipelined = GetMaxPendingRequests() > 1;
+    std::vector<std::function<void()>> compressed_blocks;
+    for (uint64_t offset = 0; offset < nbytes; offset += block_size) {
+      uint64_t block_nbytes = std::min(block_size, nbytes - offset);
+      remote_to->byte_offset = offset;
+      char* from_bytes = static_cast<char*>(local_from_bytes) + offset;
+      if (!codec_.empty()) {
+        std::string data = RPCCompress(codec_, from_bytes, block_nbytes);
+        // blocks that barely compress are cheaper to decode as they are
+        if (data.size() < block_nbytes - block_nbytes / 8) {
+          compressed_blocks.push_back(CopyCompressedToRemote(remote_to, data, block_nbytes));
+          continue;
+        }
+      }
+      if (pipelined) {
+        endpoint_->SubmitCopyToRemote(from_bytes, remote_to, block_nbytes);
+      } else {
+        endpoint_->CopyToRemote(from_bytes, remote_to, block_nbytes);
+      }
     }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, remainder_bytes);
+    for (const auto& wait : compressed_blocks) {
+      wait();
     }
   }
 
   void CopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes) final {
-    RPCCode code = RPCCode::kCopyFromRemote;
-    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_from, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyFromRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* to_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, block_size);
+    const uint64_t block_size = GetCopyBlockSize(remote_from, RPCCode::kCopyFromRemote, nbytes);
+    for (uint64_t offset = 0; offset < nbytes; offset += block_size) {
+      uint64_t block_nbytes = std::min(block_size, nbytes - offset);
+      remote_from->byte_offset = offset;
+      char* to_bytes = static_cast<char*>(local_to_bytes) + offset;
+      if (!codec_.empty()) {
+        CopyCompressedFromRemote(remote_from, to_bytes, block_nbytes);
+      } else {
+        endpoint_->CopyFromRemote(remote_from, to_bytes, block_nbytes);
+      }
     }
+  }
 
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, remainder_bytes);
+  void SetTransferOptions(uint64_t chunk_nbytes, const std::string& codec) final {
+    chunk_nbytes_ = chunk_nbytes;
+    codec_.clear();
+    if (codec.empty()) return;
+    if (copy_to_compressed_ == nullptr) {
+      std::string codecs;
+      PackedFuncHandle rpc_func = GetFunction("tvm.rpc.server.GetCompressionCodecs");
+      if (rpc_func != nullptr) {
+        CallFunc(rpc_func, nullptr, nullptr, 0, [&codecs](TVMArgs args) {
+          // Use args[1] as return value, args[0] is tcode
+          codecs = args[1].operator std::string();
+        });
+        FreeHandle(rpc_func, kTVMPackedFuncHandle);
+      }
+      if (!DMLC_IO_NO_ENDIAN_SWAP || !RPCHasCompressionCodec(codecs, codec)) {
+        LOG(WARNING) << "The RPC server does not support the " << codec
+                     << " codec, the copies are not compressed";
+        return;
+      }
+      // The handles are kept for the lifetime of the session.
+      copy_to_compressed_ = GetFunction("tvm.rpc.server.CopyToRemoteCompressed");
+      copy_from_compressed_ = GetFunction("tvm.rpc.server.CopyFromRemoteCompressed");
     }
+    ICHECK(RPCHasCompressionCodec(RPCCompressionCodecs(), codec)) << "Unknown codec " << codec;
+    codec_ = codec;
   }
 
   void FreeHandle(void* handle, int type_code) final {
-    endpoint_->SysCallRemote(RPCCode::kFreeHandle, handle, type_code);
+    if (GetMaxPendingRequests() > 1) {
+      endpoint_->SysCallRemoteNoWait(RPCCode::kFreeHandle, handle, type_code);
+    } else {
+      endpoint_->SysCallRemote(RPCCode::kFreeHandle, handle, type_code);
+    }
   }
 
   void SetDevice(Device dev) final { endpoint_->SysCallRemote(RPCCode::kDevSetDevice, dev); }
@@ -1148,8 +1287,76 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     return (uint64_t)rpc_chunk_max_size_bytes_;
   }
 
+  uint64_t GetCopyBlockSize(DLTensor* tensor, RPCCode code, uint64_t nbytes) {
+    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(tensor, code, nbytes);
+    uint64_t rpc_max_size = GetRPCMaxTransferSize();
+    ICHECK_GT(rpc_max_size, overhead) << "Invalid block size!";
+    uint64_t block_size = rpc_max_size - overhead;
+    if (chunk_nbytes_ != 0 && chunk_nbytes_ < block_size) {
+      // whole elements, so that the remote can copy each block on its own
+      uint64_t elem_bytes = (tensor->dtype.bits * tensor->dtype.lanes + 7) / 8;
+      block_size = std::max(chunk_nbytes_ / elem_bytes, static_cast<uint64_t>(1)) * elem_bytes;
+    }
+    return block_size;
+  }
+
+  std::function<void()> CopyCompressedToRemote(DLTensor* remote_to, const std::string& data,
+                                               uint64_t nbytes) {
+    TVMByteArray bytes{data.data(), data.size()};
+    TVMValue values[4];
+    int type_codes[4] = {kTVMDLTensorHandle, kTVMStr, kTVMBytes, kDLInt};
+    values[0].v_handle = remote_to;
+    values[1].v_str = codec_.c_str();
+    values[2].v_handle = &bytes;
+    values[3].v_int64 = static_cast<int64_t>(nbytes);
+    // the arguments are sent before SubmitCallFunc returns
+    return SubmitCallFunc(copy_to_compressed_, values, type_codes, 4, [](TVMArgs) {});
+  }
+
+  void CopyCompressedFromRemote(DLTensor* remote_from, char* to_bytes, uint64_t nbytes) {
+    TVMValue values[3];
+    int type_codes[3] = {kTVMDLTensorHandle, kTVMStr, kDLInt};
+    values[0].v_handle = remote_from;
+    values[1].v_str = codec_.c_str();
+    values[2].v_int64 = static_cast<int64_t>(nbytes);
+    const std::string& codec = codec_;
+    CallFunc(copy_from_compressed_, values, type_codes, 3,
+             [&codec, to_bytes, nbytes](TVMArgs args) {
+               // Use args[1] as return value, args[0] is tcode
+               ICHECK_EQ(args.type_codes[1], kTVMBytes);
+               auto* data = static_cast<TVMByteArray*>(args.values[1].v_handle);
+               RPCDecompress(codec, data->data, data->size, to_bytes, nbytes);
+             });
+  }
+
+  int GetMaxPendingRequests() {
+    if (max_pending_requests_ > 0) return max_pending_requests_;
+    // Servers that do not report it get one request at a time.
+    max_pending_requests_ = 1;
+    PackedFuncHandle rpc_func = GetFunction("tvm.rpc.server.GetMaxPendingRequests");
+    if (rpc_func != nullptr) {
+      int remote_max = 1;
+      CallFunc(rpc_func, nullptr, nullptr, 0, [&remote_max](TVMArgs args) {
+        // Use args[1] as return value, args[0] is tcode
+        remote_max = args[1];
+      });
+      FreeHandle(rpc_func, kTVMPackedFuncHandle);
+      max_pending_requests_ = std::max(1, std::min(remote_max, kRPCMaxPendingRequests));
+      endpoint_->SetMaxPendingRequests(max_pending_requests_);
+    }
+    return max_pending_requests_;
+  }
+
   std::shared_ptr<RPCEndpoint> endpoint_;
   int64_t rpc_chunk_max_size_bytes_ = -1;
+  int max_pending_requests_ = -1;
+  // The block size set by SetTransferOptions, zero for the largest one.
+  uint64_t chunk_nbytes_ = 0;
+  // The codec of the copies, empty when they are not compressed.
+  std::string codec_;
+  // The server functions copying compressed blocks.
+  PackedFuncHandle copy_to_compressed_ = nullptr;
+  PackedFuncHandle copy_from_compressed_ = nullptr;
 };
 
 std::shared_ptr<RPCSession> CreateClientSession(std::shared_ptr<RPCEndpoint> endpoint) {
@@ -26,10 +26,14 @@
 
 #include <tvm/runtime/packed_func.h>
 
+#include <deque>
+#include <exception>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "../../support/ring_buffer.h"
 #include "../minrpc/rpc_reference.h"
@@ -47,6 +51,12 @@ const int kRPCTrackerMagic = 0x2f271;
 const int kRPCSuccess = kRPCMagic + 0;
 // cannot found matched key in server
 const int kRPCMismatch = kRPCMagic + 2;
+// The number of requests a server reports it can queue through
+// tvm.rpc.server.GetMaxPendingRequests.
+const int kRPCMaxPendingRequests = 64;
+// The bytes of replies a client lets pile up on the server before it reads them,
+// kept below the socket buffers so that neither side blocks on a full send.
+const uint64_t kRPCMaxPendingReplyBytes = 32 << 10;
 
 /*! \brief Enumeration code for the RPC tracker */
 enum class TrackerCode : int {
@@ -64,6 +74,13 @@ enum class TrackerCode : int {
 /*!
  * \brief Communication endpoints to connect local and remote RPC sessions.
  *        An endpoint can either be a client or a server.
+ *
+ *  A server handles the requests in their order and replies to each of them, so a client
+ *  can send several requests before reading the replies, which it matches in order. The
+ *  Submit functions send a request and return its sequence number without waiting for
+ *  the reply, and WaitForRequest waits for it. At most max_pending_requests requests are
+ *  in flight, one unless SetMaxPendingRequests raised it after the server reported that
+ *  it queues requests.
  */
 class RPCEndpoint {
  public:
@@ -148,6 +165,44 @@ class RPCEndpoint {
    */
   void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes);
 
+  /*!
+   * \brief Send a call into remote function without waiting for its return.
+   * \param handle The function handle
+   * \param arg_values The argument values.
+   * \param arg_type_codes the type codes of the argument.
+   * \param num_args Number of arguments.
+   * \param encode_return The function to receive return value encodings, kept until the
+   *  request completes.
+   * \return The sequence number of the request.
+   */
+  uint64_t SubmitCallFunc(RPCSession::PackedFuncHandle handle, const TVMValue* arg_values,
+                          const int* arg_type_codes, int num_args,
+                          RPCSession::FEncodeReturn encode_return);
+  /*!
+   * \brief Send bytes into remote array content without waiting for the acknowledgement.
+   *
+   *  The bytes are sent before it returns, an error of the copy is raised by the next
+   *  request that waits.
+   *
+   * \param from_bytes The source host data.
+   * \param to The target array.
+   * \param nbytes The size of the memory in bytes.
+   */
+  void SubmitCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes);
+  /*!
+   * \brief Wait for a request sent by a Submit function.
+   * \param seq The sequence number of the request.
+   * \note Raises the error of the request, or of a request nobody waits for.
+   */
+  void WaitForRequest(uint64_t seq);
+  /*!
+   * \brief Set the maximum number of requests in flight.
+   * \param num The number of requests, one to wait for each reply before the next request.
+   */
+  void SetMaxPendingRequests(int num);
+  /*! \return The maximum number of requests in flight. */
+  int max_pending_requests() const { return max_pending_requests_; }
+
   /*!
    * \brief Call a remote defined system function with arguments.
    * \param fcode The function code.
@@ -156,6 +211,14 @@ class RPCEndpoint {
    */
   template <typename... Args>
   inline TVMRetValue SysCallRemote(RPCCode fcode, Args&&... args);
+  /*!
+   * \brief Call a remote defined system function that returns nothing without waiting.
+   * \param fcode The function code.
+   * \param args The arguments
+   * \note An error of the call is raised by the next request that waits.
+   */
+  template <typename... Args>
+  inline void SysCallRemoteNoWait(RPCCode fcode, Args&&... args);
   /*!
    * \brief Create a RPC session with given channel.
    * \param channel The communication channel.
@@ -171,9 +234,56 @@ class RPCEndpoint {
 
  private:
   class EventHandler;
+  // A request whose reply was not read yet.
+  struct PendingRequest {
+    // The sequence number.
+    uint64_t seq;
+    // The function to receive the return value encodings.
+    RPCSession::FEncodeReturn encode_return;
+    // The code of the reply, kCopyAck for a CopyFromRemote.
+    RPCCode reply_code{RPCCode::kReturn};
+    // The destination of the bytes of a CopyFromRemote.
+    void* copy_to{nullptr};
+    // The number of bytes the reply carries, that have to be read.
+    uint64_t reply_nbytes{0};
+    // Whether nobody waits for the request.
+    bool detached{false};
+  };
+  // Holds mutex_, and destroys the return functions of the requests read meanwhile once it
+  // is released: the last reference to a remote function frees its handle through this
+  // endpoint, which locks mutex_ again.
+  class LockGuard {
+   public:
+    explicit LockGuard(RPCEndpoint* endpoint) : endpoint_(endpoint), lock_(endpoint->mutex_) {}
+    ~LockGuard() {
+      std::vector<RPCSession::FEncodeReturn> finished;
+      finished.swap(endpoint_->finished_returns_);
+      lock_.unlock();
+    }
+
+   private:
+    RPCEndpoint* endpoint_;
+    std::unique_lock<std::mutex> lock_;
+  };
   // Handle events until receives a return
   // Also flushes channels so that the function advances.
   RPCCode HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn);
+  // Read replies until a request with the given reply size can be sent.
+  void ReserveRequest(uint64_t reply_nbytes);
+  // Push the request written to the writer and record it as pending.
+  uint64_t FinishRequest(PendingRequest request);
+  // Read the reply of the oldest pending request.
+  void HandleNextReply();
+  // Wait for a request with mutex_ held.
+  void WaitLocked(uint64_t seq);
+  // Send a call with mutex_ held.
+  uint64_t SendCallFunc(RPCSession::PackedFuncHandle handle, const TVMValue* arg_values,
+                        const int* arg_type_codes, int num_args,
+                        RPCSession::FEncodeReturn encode_return);
+  // Send a copy to the remote with mutex_ held.
+  uint64_t SendCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes, bool detached);
+  // Flush the writer to the channel.
+  void FlushWriter();
   // Initalization
   void Init();
   // Shutdown
@@ -188,6 +298,22 @@ class RPCEndpoint {
   std::shared_ptr<EventHandler> handler_;
   // syscall remote with specified function code.
   PackedFunc syscall_remote_;
+  // syscall remote that does not wait for the return.
+  PackedFunc syscall_remote_no_wait_;
+  // The requests whose reply was not read, oldest first.
+  std::deque<PendingRequest> pending_;
+  // The return functions of the requests read, destroyed by LockGuard after unlocking.
+  std::vector<RPCSession::FEncodeReturn> finished_returns_;
+  // The errors of the requests completed but not waited for yet.
+  std::unordered_map<uint64_t, std::exception_ptr> failed_;
+  // The first error of a request nobody waits for.
+  std::exception_ptr detached_error_;
+  // The sequence number of the next request.
+  uint64_t next_seq_{0};
+  // The number of reply bytes still to read.
+  uint64_t pending_reply_nbytes_{0};
+  // The maximum number of requests in flight.
+  int max_pending_requests_{1};
   // The name of the session.
   std::string name_;
   // The remote key
@@ -209,6 +335,11 @@ inline TVMRetValue RPCEndpoint::SysCallRemote(RPCCode code, Args&&... args) {
   return syscall_remote_(static_cast<int>(code), std::forward<Args>(args)...);
 }
 
+template <typename... Args>
+inline void RPCEndpoint::SysCallRemoteNoWait(RPCCode code, Args&&... args) {
+  syscall_remote_no_wait_(static_cast<int>(code), std::forward<Args>(args)...);
+}
+
 /*!
  * \brief Calculates overhead size of a CopyToRemote packet.
  * \param to DLTensor to copy.
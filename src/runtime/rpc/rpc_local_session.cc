@@ -24,6 +24,7 @@
 #include "rpc_local_session.h"
 
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
 #include <memory>
@@ -87,39 +88,48 @@ void LocalSession::CallFunc(RPCSession::PackedFuncHandle func, const TVMValue* a
   this->EncodeReturn(std::move(rv), encode_return);
 }
 
-void LocalSession::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
-  ICHECK_EQ(nbytes, GetDataSize(*to));
-  DLTensor from;
-  from.data = from_bytes;
-  from.device = {kDLCPU, 0};
-  from.ndim = to->ndim;
-  from.shape = to->shape;
-  from.dtype = to->dtype;
-  from.strides = nullptr;
-  from.byte_offset = 0;
-  Device dev_to = to->device;
-  this->GetDeviceAPI(dev_to)->CopyDataFromTo(&from, to, nullptr);
+void LocalCopyTensorRange(DLTensor* tensor, void* host_bytes, uint64_t nbytes, bool to_tensor) {
+  uint64_t tensor_nbytes = GetDataSize(*tensor);
+  DLTensor range = *tensor;
+  int64_t num_elems = 0;
+  if (nbytes != tensor_nbytes) {
+    // a block of a chunked copy, seen as a flat array starting at the byte offset
+    size_t elem_bytes = (tensor->dtype.bits * tensor->dtype.lanes + 7) / 8;
+    ICHECK(IsContiguous(*tensor) && nbytes % elem_bytes == 0 &&
+           tensor->byte_offset + nbytes <= tensor_nbytes)
+        << "Cannot copy " << nbytes << " bytes at offset " << tensor->byte_offset
+        << " of a tensor of " << tensor_nbytes << " bytes";
+    num_elems = static_cast<int64_t>(nbytes / elem_bytes);
+    range.ndim = 1;
+    range.shape = &num_elems;
+    range.strides = nullptr;
+  }
+  DLTensor host;
+  host.data = host_bytes;
+  host.device = {kDLCPU, 0};
+  host.ndim = range.ndim;
+  host.shape = range.shape;
+  host.dtype = range.dtype;
+  host.strides = nullptr;
+  host.byte_offset = 0;
+  Device dev = tensor->device;
+  DeviceAPI* api = DeviceAPI::Get(dev);
+  if (to_tensor) {
+    api->CopyDataFromTo(&host, &range, nullptr);
+  } else {
+    api->CopyDataFromTo(&range, &host, nullptr);
+  }
   // Copy can happen asynchrously
   // synchronize to make sure that copy is completed
-  this->GetDeviceAPI(dev_to)->StreamSync(dev_to, nullptr);
+  api->StreamSync(dev, nullptr);
+}
+
+void LocalSession::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+  LocalCopyTensorRange(to, from_bytes, nbytes, true);
 }
 
 void LocalSession::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
-  ICHECK_EQ(nbytes, GetDataSize(*from));
-  DLTensor to;
-  to.data = to_bytes;
-  to.device = {kDLCPU, 0};
-  to.ndim = from->ndim;
-  to.shape = from->shape;
-  to.dtype = from->dtype;
-  to.strides = nullptr;
-  to.byte_offset = 0;
-
-  Device dev_from = from->device;
-  this->GetDeviceAPI(dev_from)->CopyDataFromTo(from, &to, nullptr);
-  // Copy can happen asynchrously
-  // synchronize to make sure that copy is completed
-  this->GetDeviceAPI(dev_from)->StreamSync(dev_from, nullptr);
+  LocalCopyTensorRange(from, to_bytes, nbytes, false);
 }
 
 void LocalSession::FreeHandle(void* handle, int type_code) {
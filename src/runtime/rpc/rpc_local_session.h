@@ -67,6 +67,19 @@ class LocalSession : public RPCSession {
   void EncodeReturn(TVMRetValue rv, const FEncodeReturn& encode_return);
 };
 
+/*!
+ * \brief Copy between host memory and a local tensor, synchronously.
+ *
+ *  A copy of less than the whole tensor copies the nbytes bytes starting at its byte
+ *  offset, as done by the blocks of a chunked RPC copy.
+ *
+ * \param tensor The tensor.
+ * \param host_bytes The host memory.
+ * \param nbytes The number of bytes to copy.
+ * \param to_tensor Whether to copy from the host memory to the tensor.
+ */
+void LocalCopyTensorRange(DLTensor* tensor, void* host_bytes, uint64_t nbytes, bool to_tensor);
+
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_RPC_RPC_LOCAL_SESSION_H_
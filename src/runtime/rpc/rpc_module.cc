@@ -26,8 +26,11 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <cmath>
 #include <cstring>
 #include <memory>
+#include <string>
+#include <vector>
 #if defined(_M_X64) || defined(__x86_64__)
 #include <immintrin.h>
 #endif
@@ -79,14 +82,63 @@ NDArray NDArrayFromRemoteOpaqueHandle(std::shared_ptr<RPCSession> sess, void* ha
 /*!
  * \brief A wrapped remote function as a PackedFunc.
  */
-class RPCWrappedFunc : public Object {
+class RPCWrappedFunc : public Object, public std::enable_shared_from_this<RPCWrappedFunc> {
  public:
   RPCWrappedFunc(void* handle, std::shared_ptr<RPCSession> sess) : handle_(handle), sess_(sess) {}
 
   void operator()(TVMArgs args, TVMRetValue* rv) const {
-    std::vector<TVMValue> values(args.values, args.values + args.size());
-    std::vector<int> type_codes(args.type_codes, args.type_codes + args.size());
+    std::vector<TVMValue> values;
+    std::vector<int> type_codes;
     std::vector<std::unique_ptr<DLTensor>> temp_dltensors;
+    EncodeArgs(args, &values, &type_codes, &temp_dltensors);
+    auto set_return = [this, rv](TVMArgs args) { this->WrapRemoteReturnToValue(args, rv); };
+    sess_->CallFunc(handle_, values.data(), type_codes.data(), args.size(), set_return);
+  }
+
+  /*!
+   * \brief Send the call without waiting for it.
+   * \param args The arguments.
+   * \return The function that waits for the call and returns its return value.
+   */
+  PackedFunc CallAsync(TVMArgs args) const {
+    std::vector<TVMValue> values;
+    std::vector<int> type_codes;
+    std::vector<std::unique_ptr<DLTensor>> temp_dltensors;
+    EncodeArgs(args, &values, &type_codes, &temp_dltensors);
+    std::shared_ptr<const RPCWrappedFunc> self = shared_from_this();
+    auto result = std::make_shared<TVMRetValue>();
+    std::function<void()> wait =
+        sess_->SubmitCallFunc(handle_, values.data(), type_codes.data(), args.size(),
+                              [self, result](TVMArgs args) {
+                                self->WrapRemoteReturnToValue(args, result.get());
+                              });
+    return PackedFunc([wait, result](TVMArgs args, TVMRetValue* rv) {
+      wait();
+      *rv = *result;
+    });
+  }
+
+  ~RPCWrappedFunc() {
+    try {
+      sess_->FreeHandle(handle_, kTVMPackedFuncHandle);
+    } catch (const Error& e) {
+      // fault tolerance to remote close
+    }
+  }
+
+ private:
+  // remote function handle
+  void* handle_{nullptr};
+  // pointer to the session.
+  std::shared_ptr<RPCSession> sess_;
+
+  // translate the arguments to their remote variant.
+  void EncodeArgs(TVMArgs args, std::vector<TVMValue>* values_out, std::vector<int>* type_codes_out,
+                  std::vector<std::unique_ptr<DLTensor>>* temp_dltensors) const {
+    std::vector<TVMValue>& values = *values_out;
+    std::vector<int>& type_codes = *type_codes_out;
+    values.assign(args.values, args.values + args.size());
+    type_codes.assign(args.type_codes, args.type_codes + args.size());
 
     // scan and check whether we need rewrite these arguments
     // to their remote variant.
@@ -109,7 +161,7 @@ class RPCWrappedFunc : public Object {
           dptr->device = RemoveSessMask(dptr->device);
           dptr->data = static_cast<RemoteSpace*>(dptr->data)->data;
           values[i].v_handle = dptr.get();
-          temp_dltensors.emplace_back(std::move(dptr));
+          temp_dltensors->emplace_back(std::move(dptr));
           break;
         }
         case kDLDevice: {
@@ -123,24 +175,8 @@ class RPCWrappedFunc : public Object {
         }
       }
     }
-    auto set_return = [this, rv](TVMArgs args) { this->WrapRemoteReturnToValue(args, rv); };
-    sess_->CallFunc(handle_, values.data(), type_codes.data(), args.size(), set_return);
   }
 
-  ~RPCWrappedFunc() {
-    try {
-      sess_->FreeHandle(handle_, kTVMPackedFuncHandle);
-    } catch (const Error& e) {
-      // fault tolerance to remote close
-    }
-  }
-
- private:
-  // remote function handle
-  void* handle_{nullptr};
-  // pointer to the session.
-  std::shared_ptr<RPCSession> sess_;
-
   // unwrap a remote value to the underlying handle.
   void* UnwrapRemoteValueToHandle(const TVMArgValue& arg) const;
   // wrap a remote return via Set
@@ -189,22 +225,26 @@ class RPCModuleNode final : public ModuleNode {
   }
 
   PackedFunc GetTimeEvaluator(const std::string& name, Device dev, int number, int repeat,
-                              int min_repeat_ms, const std::string& f_preproc_name) {
+                              int min_repeat_ms, const std::string& f_preproc_name,
+                              double target_rel_ci = 0, double cutoff_seconds = 0) {
     InitRemoteFunc(&remote_get_time_evaluator_, "runtime.RPCTimeEvaluator");
     // Remove session mask because we pass dev by parts.
     ICHECK_EQ(GetRPCSessionIndex(dev), sess_->table_index())
         << "ValueError: Need to pass the matched remote device to RPCModule.GetTimeEvaluator";
     dev = RemoveRPCSessionMask(dev);
 
+    Optional<Module> mod;
     if (module_handle_ != nullptr) {
-      return remote_get_time_evaluator_(GetRef<Module>(this), name,
-                                        static_cast<int>(dev.device_type), dev.device_id, number,
-                                        repeat, min_repeat_ms, f_preproc_name);
-    } else {
-      return remote_get_time_evaluator_(Optional<Module>(nullptr), name,
-                                        static_cast<int>(dev.device_type), dev.device_id, number,
-                                        repeat, min_repeat_ms, f_preproc_name);
+      mod = GetRef<Module>(this);
     }
+    // only pass the adaptive options when set, so the servers without them still work
+    if (target_rel_ci > 0 || cutoff_seconds > 0) {
+      return remote_get_time_evaluator_(mod, name, static_cast<int>(dev.device_type),
+                                        dev.device_id, number, repeat, min_repeat_ms,
+                                        f_preproc_name, target_rel_ci, cutoff_seconds);
+    }
+    return remote_get_time_evaluator_(mod, name, static_cast<int>(dev.device_type), dev.device_id,
+                                      number, repeat, min_repeat_ms, f_preproc_name);
   }
 
   Module LoadModule(std::string name) {
@@ -217,6 +257,36 @@ class RPCModuleNode final : public ModuleNode {
     remote_import_module_(GetRef<Module>(this), other);
   }
 
+  /*!
+   * \brief Get a function whose calls return without waiting for the remote.
+   * \param name The function name.
+   * \return The function returning, for each call, a function that waits for the call.
+   */
+  PackedFunc GetAsyncFunction(const std::string& name) {
+    RPCSession::PackedFuncHandle handle = nullptr;
+    if (module_handle_ == nullptr) {
+      handle = sess_->GetFunction(name);
+    } else {
+      RPCSession::PackedFuncHandle getter = sess_->GetFunction("tvm.rpc.server.ModuleGetFunction");
+      ICHECK(getter != nullptr) << "Cannot found remote function tvm.rpc.server.ModuleGetFunction";
+      TVMValue values[3];
+      int type_codes[3];
+      TVMArgsSetter setter(values, type_codes);
+      setter(1, name);
+      setter(2, false);
+      values[0].v_handle = module_handle_;
+      type_codes[0] = kTVMModuleHandle;
+      sess_->CallFunc(getter, values, type_codes, 3, [&handle](TVMArgs args) {
+        int tcode = args[0];
+        if (tcode == kTVMPackedFuncHandle) handle = args[1];
+      });
+      sess_->FreeHandle(getter, kTVMPackedFuncHandle);
+    }
+    if (handle == nullptr) return PackedFunc();
+    auto wf = std::make_shared<RPCWrappedFunc>(handle, sess_);
+    return PackedFunc([wf](TVMArgs args, TVMRetValue* rv) { *rv = wf->CallAsync(args); });
+  }
+
   const std::shared_ptr<RPCSession>& sess() { return sess_; }
 
   void* module_handle() const { return module_handle_; }
@@ -240,9 +310,8 @@ class RPCModuleNode final : public ModuleNode {
   void* module_handle_{nullptr};
   // The local channel
   std::shared_ptr<RPCSession> sess_;
-  // remote function to get time evaluator
-  TypedPackedFunc<PackedFunc(Optional<Module>, std::string, int, int, int, int, int, std::string)>
-      remote_get_time_evaluator_;
+  // remote function to get time evaluator, taking the adaptive options or not
+  PackedFunc remote_get_time_evaluator_;
   // remote function getter for modules.
   TypedPackedFunc<PackedFunc(Module, std::string, bool)> remote_mod_get_function_;
   // remote function getter for load module
@@ -357,8 +426,47 @@ inline void CPUCacheFlush(int begin_index, const TVMArgs& args) {
   }
 }
 
+/*!
+ * \brief Read the data of a tensor back to the cache, one load per 64 bytes.
+ * \param tensor The tensor.
+ */
+inline void CPUCacheTouch(const DLTensor* tensor) {
+  const volatile char* data = static_cast<const char*>(tensor->data);
+  size_t nbytes = GetDataSize(*tensor);
+  char sink = 0;
+  for (size_t i = 0; i < nbytes; i += 64) {
+    sink ^= data[i];
+  }
+  static_cast<void>(sink);
+}
+
+// The 0.975 quantile of the Student's t distribution with a number of degrees of freedom.
+inline double StudentT975(int dof) {
+  static const double kQuantiles[] = {12.706, 4.303, 3.182, 2.776, 2.571,
+                                      2.447,  2.365, 2.306, 2.262, 2.228};
+  if (dof <= 10) return kQuantiles[dof - 1];
+  // the first terms of the Cornish-Fisher expansion around the normal quantile
+  const double z = 1.96;
+  return z + (z * z * z + z) / (4 * dof);
+}
+
+// Whether the costs measured so far are enough for the adaptive options.
+inline bool AdaptiveRepeatDone(const std::vector<double>& costs, double target_rel_ci,
+                               double cutoff_seconds) {
+  size_t n = costs.size();
+  if (n < 2) return false;
+  double mean = 0, var = 0;
+  for (double cost : costs) mean += cost;
+  mean /= n;
+  for (double cost : costs) var += (cost - mean) * (cost - mean);
+  double half_width = StudentT975(static_cast<int>(n) - 1) * std::sqrt(var / (n - 1) / n);
+  if (target_rel_ci > 0 && half_width <= target_rel_ci * mean) return true;
+  // statistically worse than the best known candidate
+  return cutoff_seconds > 0 && mean - half_width > cutoff_seconds;
+}
+
 PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat, int min_repeat_ms,
-                             PackedFunc f_preproc) {
+                             PackedFunc f_preproc, double target_rel_ci, double cutoff_seconds) {
   ICHECK(pf != nullptr);
 
   if (static_cast<int>(dev.device_type) == static_cast<int>(kDLMicroDev)) {
@@ -367,10 +475,11 @@ PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat,
     return (*get_micro_time_evaluator)(pf, dev, number, repeat);
   }
 
-  auto ftimer = [pf, dev, number, repeat, min_repeat_ms, f_preproc](TVMArgs args,
-                                                                    TVMRetValue* rv) mutable {
+  auto ftimer = [pf, dev, number, repeat, min_repeat_ms, f_preproc, target_rel_ci,
+                 cutoff_seconds](TVMArgs args, TVMRetValue* rv) mutable {
     TVMRetValue temp;
     std::ostringstream os;
+    std::vector<double> costs;
     // skip first time call, to activate lazy compilation components.
     pf.CallPacked(args, &temp);
 
@@ -400,6 +509,8 @@ PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat,
 
       double speed = duration_ms / 1e3 / number;
       os.write(reinterpret_cast<char*>(&speed), sizeof(speed));
+      costs.push_back(speed);
+      if (AdaptiveRepeatDone(costs, target_rel_ci, cutoff_seconds)) break;
     }
 
     std::string blob = os.str();
@@ -412,48 +523,67 @@ PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat,
   return PackedFunc(ftimer);
 }
 
-TVM_REGISTER_GLOBAL("runtime.RPCTimeEvaluator")
-    .set_body_typed([](Optional<Module> opt_mod, std::string name, int device_type, int device_id,
-                       int number, int repeat, int min_repeat_ms, std::string f_preproc_name) {
-      Device dev;
-      dev.device_type = static_cast<DLDeviceType>(device_type);
-      dev.device_id = device_id;
-      if (opt_mod.defined()) {
-        Module m = opt_mod.value();
-        std::string tkey = m->type_key();
-        if (tkey == "rpc") {
-          return static_cast<RPCModuleNode*>(m.operator->())
-              ->GetTimeEvaluator(name, dev, number, repeat, min_repeat_ms, f_preproc_name);
-        } else {
-          PackedFunc f_preproc;
-          if (!f_preproc_name.empty()) {
-            auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
-            ICHECK(pf_preproc != nullptr)
-                << "Cannot find " << f_preproc_name << " in the global function";
-            f_preproc = *pf_preproc;
-          }
-          PackedFunc pf = m.GetFunction(name, false);
-          CHECK(pf != nullptr) << "Cannot find " << name << " in the global registry";
-          return WrapTimeEvaluator(pf, dev, number, repeat, min_repeat_ms, f_preproc);
-        }
-      } else {
-        auto* pf = runtime::Registry::Get(name);
-        ICHECK(pf != nullptr) << "Cannot find " << name << " in the global function";
-        PackedFunc f_preproc;
-        if (!f_preproc_name.empty()) {
-          auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
-          ICHECK(pf_preproc != nullptr)
-              << "Cannot find " << f_preproc_name << " in the global function";
-          f_preproc = *pf_preproc;
-        }
-        return WrapTimeEvaluator(*pf, dev, number, repeat, min_repeat_ms, f_preproc);
-      }
-    });
+TVM_REGISTER_GLOBAL("runtime.RPCTimeEvaluator").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ICHECK(args.size() == 8 || args.size() == 10)
+      << "runtime.RPCTimeEvaluator expects 8 arguments, or 10 with the adaptive options";
+  Optional<Module> opt_mod = args[0];
+  std::string name = args[1];
+  Device dev;
+  dev.device_type = static_cast<DLDeviceType>(args[2].operator int());
+  dev.device_id = args[3];
+  int number = args[4];
+  int repeat = args[5];
+  int min_repeat_ms = args[6];
+  std::string f_preproc_name = args[7];
+  double target_rel_ci = args.size() > 8 ? args[8].operator double() : 0;
+  double cutoff_seconds = args.size() > 8 ? args[9].operator double() : 0;
+  if (opt_mod.defined()) {
+    Module m = opt_mod.value();
+    std::string tkey = m->type_key();
+    if (tkey == "rpc") {
+      *rv = static_cast<RPCModuleNode*>(m.operator->())
+                ->GetTimeEvaluator(name, dev, number, repeat, min_repeat_ms, f_preproc_name,
+                                   target_rel_ci, cutoff_seconds);
+      return;
+    }
+  }
+  PackedFunc f_preproc;
+  if (!f_preproc_name.empty()) {
+    auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
+    ICHECK(pf_preproc != nullptr) << "Cannot find " << f_preproc_name << " in the global function";
+    f_preproc = *pf_preproc;
+  }
+  PackedFunc pf;
+  if (opt_mod.defined()) {
+    pf = opt_mod.value().GetFunction(name, false);
+    CHECK(pf != nullptr) << "Cannot find " << name << " in the global registry";
+  } else {
+    auto* fglobal = runtime::Registry::Get(name);
+    ICHECK(fglobal != nullptr) << "Cannot find " << name << " in the global function";
+    pf = *fglobal;
+  }
+  *rv = WrapTimeEvaluator(pf, dev, number, repeat, min_repeat_ms, f_preproc, target_rel_ci,
+                          cutoff_seconds);
+});
 
 TVM_REGISTER_GLOBAL("cache_flush_cpu_non_first_arg").set_body([](TVMArgs args, TVMRetValue* rv) {
   CPUCacheFlush(1, args);
 });
 
+// Flush all the arguments, for a cold cache measurement.
+TVM_REGISTER_GLOBAL("cache_flush_cpu_args").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CPUCacheFlush(0, args);
+});
+
+// Emulate the cache inside a model: the first argument is the activation the previous operator
+// just wrote, so it is read back to the cache, while the weights and the outputs are flushed.
+TVM_REGISTER_GLOBAL("cache_warm_cpu_graph_context").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CPUCacheFlush(1, args);
+  if (args.size() > 0) {
+    CPUCacheTouch(args[0].operator DLTensor*());
+  }
+});
+
 // server function registration.
 TVM_REGISTER_GLOBAL("tvm.rpc.server.ImportModule").set_body_typed([](Module parent, Module child) {
   parent->Import(child);
@@ -477,6 +607,18 @@ TVM_REGISTER_GLOBAL("rpc.ImportRemoteModule").set_body_typed([](Module parent, M
   static_cast<RPCModuleNode*>(parent.operator->())->ImportModule(child);
 });
 
+TVM_REGISTER_GLOBAL("rpc.GetAsyncFunction").set_body_typed([](Module mod, std::string name) {
+  std::string tkey = mod->type_key();
+  ICHECK_EQ(tkey, "rpc");
+  return static_cast<RPCModuleNode*>(mod.operator->())->GetAsyncFunction(name);
+});
+
+TVM_REGISTER_GLOBAL("rpc.SessSetTransferOptions")
+    .set_body_typed([](Module sess, int64_t chunk_nbytes, std::string codec) {
+      ICHECK_GE(chunk_nbytes, 0) << "The chunk size cannot be negative";
+      RPCModuleGetSession(sess)->SetTransferOptions(chunk_nbytes, codec);
+    });
+
 TVM_REGISTER_GLOBAL("rpc.SessTableIndex").set_body([](TVMArgs args, TVMRetValue* rv) {
   Module m = args[0];
   std::string tkey = m->type_key();
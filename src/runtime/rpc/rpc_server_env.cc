@@ -21,9 +21,25 @@
  * \file rpc_server_env.cc
  * \brief Server environment of the RPC.
  */
+#include <dmlc/endian.h>
+#include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
 
+#if defined(__linux__) || defined(__ANDROID__)
+#include <errno.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+#include <string>
+#include <vector>
+
 #include "../file_utils.h"
+#include "rpc_compression.h"
+#include "rpc_endpoint.h"
+#include "rpc_local_session.h"
 
 namespace tvm {
 namespace runtime {
@@ -52,6 +68,80 @@ TVM_REGISTER_GLOBAL("tvm.rpc.server.download").set_body([](TVMArgs args, TVMRetV
   *rv = arr;
 });
 
+// The endpoint handles the requests in order whatever their number, which lets the
+// clients send requests before the replies to the previous ones arrive.
+TVM_REGISTER_GLOBAL("tvm.rpc.server.GetMaxPendingRequests").set_body_typed([]() {
+  return kRPCMaxPendingRequests;
+});
+
+// The codecs of the compressed copies, none when the data would need a byte swap.
+TVM_REGISTER_GLOBAL("tvm.rpc.server.GetCompressionCodecs").set_body_typed([]() {
+  return DMLC_IO_NO_ENDIAN_SWAP ? RPCCompressionCodecs() : std::string();
+});
+
+TVM_REGISTER_GLOBAL("tvm.rpc.server.CopyToRemoteCompressed")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      DLTensor* to = args[0];
+      std::string codec = args[1];
+      TVMByteArray* data = args[2].ptr<TVMByteArray>();
+      uint64_t nbytes = args[3];
+      ICHECK_LE(to->byte_offset + nbytes, GetDataSize(*to))
+          << "CopyToRemoteCompressed: overflow in tensor size";
+      if (to->device.device_type == kDLCPU) {
+        RPCDecompress(codec, data->data, data->size, static_cast<char*>(to->data) + to->byte_offset,
+                      nbytes);
+      } else {
+        std::vector<char> temp(nbytes);
+        RPCDecompress(codec, data->data, data->size, temp.data(), nbytes);
+        LocalCopyTensorRange(to, temp.data(), nbytes, true);
+      }
+    });
+
+TVM_REGISTER_GLOBAL("tvm.rpc.server.CopyFromRemoteCompressed")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      DLTensor* from = args[0];
+      std::string codec = args[1];
+      uint64_t nbytes = args[2];
+      ICHECK_LE(from->byte_offset + nbytes, GetDataSize(*from))
+          << "CopyFromRemoteCompressed: overflow in tensor size";
+      std::string data;
+      if (from->device.device_type == kDLCPU) {
+        data = RPCCompress(codec, static_cast<char*>(from->data) + from->byte_offset, nbytes);
+      } else {
+        std::vector<char> temp(nbytes);
+        LocalCopyTensorRange(from, temp.data(), nbytes, false);
+        data = RPCCompress(codec, temp.data(), nbytes);
+      }
+      TVMByteArray arr;
+      arr.data = data.c_str();
+      arr.size = data.length();
+      *rv = arr;
+    });
+
+#if defined(__linux__) || defined(__ANDROID__)
+// Load a shared library from an anonymous file in memory, so the modules of the tuning
+// trials are not written to the storage of the device.
+TVM_REGISTER_GLOBAL("tvm.rpc.server.load_module_from_memory")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      std::string name = args[0];
+      std::string data = args[1];
+      int fd = static_cast<int>(syscall(SYS_memfd_create, name.c_str(), 0));
+      ICHECK_GE(fd, 0) << "load_module_from_memory: memfd_create failed: " << strerror(errno);
+      for (size_t offset = 0; offset < data.size();) {
+        ssize_t nbytes = write(fd, data.data() + offset, data.size() - offset);
+        if (nbytes < 0 && errno == EINTR) continue;
+        if (nbytes <= 0) close(fd);
+        ICHECK_GT(nbytes, 0) << "load_module_from_memory: write failed: " << strerror(errno);
+        offset += nbytes;
+      }
+      // the library stays mapped once loaded, the file can be closed
+      Module mod = Module::LoadFromFile("/proc/self/fd/" + std::to_string(fd), "so");
+      close(fd);
+      LOG(INFO) << "Load " << name << " from memory... nbytes=" << data.size();
+      *rv = mod;
+    });
+#endif
+
 TVM_REGISTER_GLOBAL("tvm.rpc.server.remove").set_body([](TVMArgs args, TVMRetValue* rv) {
   std::string file_name = RPCGetPath(args[0]);
   RemoveFile(file_name);
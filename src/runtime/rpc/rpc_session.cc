@@ -34,6 +34,15 @@ namespace runtime {
 
 bool RPCSession::IsAsync() const { return false; }
 
+std::function<void()> RPCSession::SubmitCallFunc(PackedFuncHandle func, const TVMValue* arg_values,
+                                                 const int* arg_type_codes, int num_args,
+                                                 FEncodeReturn fencode_return) {
+  this->CallFunc(func, arg_values, arg_type_codes, num_args, fencode_return);
+  return []() {};
+}
+
+void RPCSession::SetTransferOptions(uint64_t chunk_nbytes, const std::string& codec) {}
+
 void RPCSession::SendException(FAsyncCallback callback, const char* msg) {
   TVMValue value;
   value.v_str = msg;
@@ -125,6 +125,23 @@ class RPCSession {
                         const int* arg_type_codes, int num_args,
                         const FEncodeReturn& fencode_return) = 0;
 
+  /*!
+   * \brief Send a call into a remote Packed function without waiting for its return.
+   *
+   *  The arguments follow the calling convention of CallFunc and are only used before it
+   *  returns. A session that does not pipeline its requests completes the call right away.
+   *
+   * \param func The function handle.
+   * \param arg_values The argument values.
+   * \param arg_type_codes the type codes of the argument.
+   * \param num_args Number of arguments.
+   * \param fencode_return The function to set the return value, kept until the call completes.
+   * \return The function that waits for the call, raising its error.
+   */
+  virtual std::function<void()> SubmitCallFunc(PackedFuncHandle func, const TVMValue* arg_values,
+                                               const int* arg_type_codes, int num_args,
+                                               FEncodeReturn fencode_return);
+
   /*!
    * \brief Copy bytes into remote array content.
    * \param local_from_bytes The source host data.
@@ -140,6 +157,19 @@ class RPCSession {
    */
   virtual void CopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes) = 0;
 
+  /*!
+   * \brief Set how the tensor copies are sent.
+   *
+   *  Only the sessions sending the copies through a channel use it, the others ignore it.
+   *
+   * \param chunk_nbytes The maximum size of the block of a copy sent in one request, zero
+   *  for the largest block the remote accepts. Smaller blocks let the other requests of the
+   *  session through during a large copy.
+   * \param codec The codec compressing the blocks, empty for none. The copies are sent
+   *  uncompressed when the remote does not support it.
+   */
+  virtual void SetTransferOptions(uint64_t chunk_nbytes, const std::string& codec);
+
   /*!
    * \brief Free a remote function.
    * \param handle The remote handle, can be NDArray/PackedFunc/Module
@@ -300,10 +330,16 @@ struct RemoteSpace {
  *        i.e., When the run time of one `repeat` falls below this time,
  *        the `number` parameter will be automatically increased.
  * \param f_preproc The function to be executed before we excetute time evaluator.
+ * \param target_rel_ci When positive, `repeat` is the maximum number of repeats, and the
+ *        measurement stops once the half width of the 95% confidence interval of the mean
+ *        cost falls below this fraction of the mean.
+ * \param cutoff_seconds When positive, the cost of the best known candidate. The measurement
+ *        stops once the confidence interval of the mean cost lies above it.
  * \return f_timer A timer function.
  */
 PackedFunc WrapTimeEvaluator(PackedFunc f, Device dev, int number, int repeat, int min_repeat_ms,
-                             PackedFunc f_preproc = nullptr);
+                             PackedFunc f_preproc = nullptr, double target_rel_ci = 0,
+                             double cutoff_seconds = 0);
 
 /*!
  * \brief Create a Global RPC module that refers to the session.
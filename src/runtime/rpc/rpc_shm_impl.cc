@@ -0,0 +1,271 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rpc_shm_impl.cc
+ * \brief Shared memory based RPC channel, between the processes of one host.
+ */
+// Linux only for now, as it relies on memfd and futex.
+#if defined(__linux__) || defined(__ANDROID__)
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <tvm/runtime/registry.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rpc_endpoint.h"
+#include "rpc_local_session.h"
+
+namespace tvm {
+namespace runtime {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "the shared memory channel needs address free atomics");
+
+/*! \brief The number of bytes of each direction of a shared memory channel. */
+constexpr uint64_t kShmRingBytes = 8 << 20;
+
+/*!
+ * \brief One direction of a shared memory channel, a byte ring with one sender and one
+ *  receiver.
+ *
+ *  The head and the tail count the bytes received and sent since the start. A side
+ *  blocked on an empty or a full ring sleeps on a futex, which the other side only wakes
+ *  when it announced it is waiting, so the transfers between two busy sides make no system
+ *  call.
+ */
+struct ShmRing {
+  /*! \brief The number of bytes received, written by the receiver. */
+  alignas(64) std::atomic<uint64_t> head;
+  /*! \brief The futex word bumped when bytes are received, and whether the sender waits. */
+  std::atomic<uint32_t> space_signal;
+  std::atomic<uint32_t> sender_waiting;
+  /*! \brief The number of bytes sent, written by the sender. */
+  alignas(64) std::atomic<uint64_t> tail;
+  /*! \brief The futex word bumped when bytes are sent, and whether the receiver waits. */
+  std::atomic<uint32_t> data_signal;
+  std::atomic<uint32_t> receiver_waiting;
+  /*! \brief Set when a side closed the channel. */
+  alignas(64) std::atomic<uint32_t> closed;
+};
+
+/*! \brief The start of the shared memory, followed by the data of the two rings. */
+struct ShmHeader {
+  /*! \brief The rings from the client to the server and back. */
+  ShmRing rings[2];
+};
+
+class ShmChannel final : public RPCChannel {
+ public:
+  /*!
+   * \brief Map the shared memory of a channel.
+   * \param fd The shared memory file, closed by the constructor.
+   * \param child_pid The server process started by the client side, -1 on the server side.
+   */
+  ShmChannel(int fd, pid_t child_pid) : child_pid_(child_pid), parent_pid_(getppid()) {
+    bool is_server = child_pid < 0;
+    map_nbytes_ = DataOffset() + 2 * kShmRingBytes;
+    void* base = mmap(nullptr, map_nbytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ICHECK(base != MAP_FAILED) << "ShmChannel: mmap failed: " << strerror(errno);
+    header_ = static_cast<ShmHeader*>(base);
+    char* data = static_cast<char*>(base) + DataOffset();
+    int send_index = is_server ? 1 : 0;
+    send_ring_ = &header_->rings[send_index];
+    recv_ring_ = &header_->rings[1 - send_index];
+    send_data_ = data + send_index * kShmRingBytes;
+    recv_data_ = data + (1 - send_index) * kShmRingBytes;
+  }
+
+  ~ShmChannel() {
+    for (ShmRing* ring : {send_ring_, recv_ring_}) {
+      ring->closed.store(1);
+      Wake(&ring->data_signal);
+      Wake(&ring->space_signal);
+    }
+    munmap(header_, map_nbytes_);
+    if (child_pid_ > 0) {
+      kill(child_pid_, SIGKILL);
+      waitpid(child_pid_, nullptr, 0);
+    }
+  }
+
+  /*!
+   * \brief Create the shared memory of a channel.
+   * \return The shared memory file, inherited by the child processes.
+   */
+  static int CreateSharedMemory() {
+    int fd = static_cast<int>(syscall(SYS_memfd_create, "tvm_rpc_shm", 0));
+    ICHECK_GE(fd, 0) << "ShmChannel: memfd_create failed: " << strerror(errno);
+    ICHECK_EQ(ftruncate(fd, DataOffset() + 2 * kShmRingBytes), 0)
+        << "ShmChannel: ftruncate failed: " << strerror(errno);
+    return fd;
+  }
+
+  size_t Send(const void* data, size_t size) final {
+    ShmRing* ring = send_ring_;
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint64_t head = 0;
+    WaitUntil(&ring->space_signal, &ring->sender_waiting, [&]() {
+      head = ring->head.load(std::memory_order_acquire);
+      return tail - head < kShmRingBytes;
+    });
+    if (Closed()) {
+      LOG(FATAL) << "ShmChannel: the channel is closed";
+    }
+    size_t nbytes = std::min<uint64_t>(size, kShmRingBytes - (tail - head));
+    size_t offset = tail % kShmRingBytes;
+    size_t first = std::min<uint64_t>(nbytes, kShmRingBytes - offset);
+    std::memcpy(send_data_ + offset, data, first);
+    std::memcpy(send_data_, static_cast<const char*>(data) + first, nbytes - first);
+    ring->tail.store(tail + nbytes);
+    Notify(&ring->data_signal, &ring->receiver_waiting);
+    return nbytes;
+  }
+
+  size_t Recv(void* data, size_t size) final {
+    ShmRing* ring = recv_ring_;
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t tail = head;
+    WaitUntil(&ring->data_signal, &ring->receiver_waiting, [&]() {
+      tail = ring->tail.load(std::memory_order_acquire);
+      return tail != head;
+    });
+    // an empty closed ring reads as the end of the stream
+    size_t nbytes = std::min<uint64_t>(size, tail - head);
+    size_t offset = head % kShmRingBytes;
+    size_t first = std::min<uint64_t>(nbytes, kShmRingBytes - offset);
+    std::memcpy(data, recv_data_ + offset, first);
+    std::memcpy(static_cast<char*>(data) + first, recv_data_, nbytes - first);
+    ring->head.store(head + nbytes);
+    Notify(&ring->space_signal, &ring->sender_waiting);
+    return nbytes;
+  }
+
+ private:
+  bool Closed() const { return send_ring_->closed.load() != 0 || recv_ring_->closed.load() != 0; }
+
+  bool PeerAlive() {
+    if (child_pid_ > 0) {
+      if (waitpid(child_pid_, nullptr, WNOHANG) == 0) return true;
+      child_pid_ = -1;
+      return false;
+    }
+    return getppid() == parent_pid_;
+  }
+
+  static uint64_t DataOffset() { return (sizeof(ShmHeader) + 4095) & ~static_cast<uint64_t>(4095); }
+
+  static void Wake(std::atomic<uint32_t>* signal) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(signal), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+  }
+
+  static void Notify(std::atomic<uint32_t>* signal, std::atomic<uint32_t>* waiting) {
+    signal->fetch_add(1);
+    if (waiting->load() != 0) Wake(signal);
+  }
+
+  // Wait until fready returns true or the channel is closed, spinning a little before sleeping.
+  template <typename FReady>
+  void WaitUntil(std::atomic<uint32_t>* signal, std::atomic<uint32_t>* waiting, FReady fready) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (fready()) return;
+      std::this_thread::yield();
+    }
+    while (true) {
+      uint32_t value = signal->load();
+      waiting->store(1);
+      if (fready() || Closed()) break;
+      // the timeout lets a crash of the other process be noticed
+      struct timespec timeout = {0, 20 * 1000 * 1000};
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(signal), FUTEX_WAIT, value, &timeout,
+              nullptr, 0);
+      if (!PeerAlive()) {
+        send_ring_->closed.store(1);
+        break;
+      }
+    }
+    waiting->store(0);
+  }
+
+  static constexpr int kSpinCount = 1000;
+  pid_t child_pid_;
+  pid_t parent_pid_;
+  ShmHeader* header_;
+  size_t map_nbytes_;
+  ShmRing* send_ring_;
+  ShmRing* recv_ring_;
+  char* send_data_;
+  char* recv_data_;
+};
+
+Module CreateShmClient(std::vector<std::string> cmd) {
+  int fd = ShmChannel::CreateSharedMemory();
+  std::string sfd = std::to_string(fd);
+  std::vector<char*> argv;
+  for (auto& str : cmd) {
+    argv.push_back(dmlc::BeginPtr(str));
+  }
+  argv.push_back(dmlc::BeginPtr(sfd));
+  argv.push_back(nullptr);
+  pid_t pid = fork();
+  if (pid == 0) {
+    // child process
+    execvp(argv[0], &argv[0]);
+    _exit(127);
+  }
+  ICHECK_GT(pid, 0) << "CreateShmClient: fork failed";
+  auto endpt = RPCEndpoint::Create(std::unique_ptr<ShmChannel>(new ShmChannel(fd, pid)), "shm",
+                                   "shm");
+  endpt->InitRemoteSession(TVMArgs(nullptr, nullptr, 0));
+  return CreateRPCSessionModule(CreateClientSession(endpt));
+}
+
+void ShmServerLoop(int fd) {
+  RPCEndpoint::Create(std::unique_ptr<ShmChannel>(new ShmChannel(fd, -1)), "ShmServerLoop", "")
+      ->ServerLoop();
+}
+
+TVM_REGISTER_GLOBAL("rpc.CreateShmClient").set_body([](TVMArgs args, TVMRetValue* rv) {
+  std::vector<std::string> cmd;
+  for (int i = 0; i < args.size(); ++i) {
+    cmd.push_back(args[i].operator std::string());
+  }
+  *rv = CreateShmClient(cmd);
+});
+
+TVM_REGISTER_GLOBAL("rpc.ShmServerLoop").set_body_typed(ShmServerLoop);
+
+}  // namespace runtime
+}  // namespace tvm
+#endif
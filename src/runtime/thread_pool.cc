@@ -33,6 +33,7 @@
 #endif
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstring>
 #include <memory>
@@ -58,11 +59,134 @@ uint32_t GetSpinCount() {
   return atoi(val);
 }
 
+uint32_t GetStealChunksPerWorker() {
+  const char* val = getenv("TVM_THREAD_POOL_STEAL_CHUNKS");
+  if (!val) {
+    return 0;
+  }
+  return atoi(val);
+}
+
+// The number of tasks per worker of the launches split by the worker weights, when work
+// stealing does not set it.
+constexpr int kWeightedChunksPerWorker = 8;
+
+/*!
+ * \brief Parse the relative throughput of the workers, as returned by the calibration.
+ * \param str The comma separated throughputs.
+ * \return The throughputs, empty when str is.
+ */
+std::vector<double> ParseWorkerWeights(const std::string& str) {
+  std::vector<double> weights;
+  std::istringstream is(str);
+  std::string item;
+  while (std::getline(is, item, ',')) {
+    weights.push_back(std::stod(item));
+    ICHECK_GT(weights.back(), 0) << "The worker weights must be positive: " << str;
+  }
+  return weights;
+}
+
+// The time each worker spends on the workload of the calibration.
+constexpr int kCalibrationMillis = 20;
+
+// Count the blocks of a fixed arithmetic workload run by a worker within the calibration time.
+int CalibrationTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  auto* counts = static_cast<std::vector<double>*>(cdata);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kCalibrationMillis);
+  volatile float sink = 0;
+  float acc[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  int64_t num_blocks = 0;
+  while (std::chrono::steady_clock::now() < deadline) {
+    for (int i = 0; i < 1024; ++i) {
+      for (float& v : acc) v = v * 0.999f + 0.5f;
+    }
+    ++num_blocks;
+  }
+  for (float v : acc) sink = sink + v;
+  (*counts)[task_id] = static_cast<double>(num_blocks);
+  // all the workers measure at the same time, as they do when running a kernel
+  return TVMBackendParallelBarrier(task_id, penv);
+}
+
 }  // namespace
 
 // stride in the page, fit to cache line.
 constexpr int kSyncStride = 64 / sizeof(std::atomic<int>);
 
+/*!
+ * \brief Contiguous range of task ids owned by one worker in work-stealing mode.
+ *
+ *  The owner takes tasks from the front of the range while idle workers steal
+ *  from the back. Both ends are packed into a single word so that either side
+ *  only needs one CAS and no lock is taken.
+ */
+class StealableTaskRange {
+ public:
+  void Reset(int32_t begin, int32_t end) { range_.store(Pack(begin, end)); }
+  /*!
+   * \brief Take the first task of the range, used by the owner.
+   * \param task_id The task id taken.
+   * \return Whether a task is taken.
+   */
+  bool PopFront(int32_t* task_id) {
+    uint64_t cur = range_.load(std::memory_order_acquire);
+    while (Begin(cur) < End(cur)) {
+      if (range_.compare_exchange_weak(cur, Pack(Begin(cur) + 1, End(cur)),
+                                       std::memory_order_acq_rel, std::memory_order_acquire)) {
+        *task_id = Begin(cur);
+        return true;
+      }
+    }
+    return false;
+  }
+  /*!
+   * \brief Take the last task of the range, used by thieves.
+   * \param task_id The task id taken.
+   * \return Whether a task is taken.
+   */
+  bool StealBack(int32_t* task_id) {
+    uint64_t cur = range_.load(std::memory_order_acquire);
+    while (Begin(cur) < End(cur)) {
+      if (range_.compare_exchange_weak(cur, Pack(Begin(cur), End(cur) - 1),
+                                       std::memory_order_acq_rel, std::memory_order_acquire)) {
+        *task_id = End(cur) - 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  static uint64_t Pack(int32_t begin, int32_t end) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(begin)) << 32) |
+           static_cast<uint32_t>(end);
+  }
+  static int32_t Begin(uint64_t range) { return static_cast<int32_t>(range >> 32); }
+  static int32_t End(uint64_t range) { return static_cast<int32_t>(range & 0xFFFFFFFFU); }
+
+  std::atomic<uint64_t> range_{0};
+  // pad to a cache line to avoid false sharing between neighbouring ranges
+  char pad_[kL1CacheBytes - sizeof(std::atomic<uint64_t>)];
+};
+
+class ThreadPool;
+
+/*!
+ * \brief Thread local context of the parallel task the thread is running.
+ *  Used to route a nested parallel launch to the pool that runs the task.
+ */
+struct ParallelTaskContext {
+  // The pool running the current task, nullptr when the thread is not inside a task.
+  ThreadPool* pool{nullptr};
+  // The number of threads a nested launch of the current task may use.
+  int32_t thread_budget{1};
+  // Get thread local version of the store.
+  static ParallelTaskContext* ThreadLocal() {
+    return dmlc::ThreadLocalStore<ParallelTaskContext>::Get();
+  }
+};
+
 /*!
  * \brief Thread local main environment.
  */
@@ -74,14 +198,18 @@ class ParallelLauncher {
     this->cdata = cdata;
     this->flambda = flambda;
     this->env.num_task = num_task;
+    this->env.thread_budget = 1;
+    this->work_stealing = false;
     has_error_.store(false);
     // reshape
     if (static_cast<size_t>(num_task) > par_errors_.size()) {
       par_errors_.resize(num_task + 1);
-      if (need_sync) {
-        delete[] sync_counter_;
-        sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
-      }
+    }
+    // work-stealing launches do not allocate the counter page, so track its size separately
+    if (need_sync && num_task > sync_counter_size_) {
+      delete[] sync_counter_;
+      sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
+      sync_counter_size_ = num_task;
     }
     if (need_sync) {
       for (int i = 0; i < num_task; ++i) {
@@ -93,9 +221,77 @@ class ParallelLauncher {
     }
   }
   ~ParallelLauncher() { delete[] sync_counter_; }
+  /*!
+   * \brief Split the tasks into contiguous per-worker ranges for work stealing.
+   *  Must be called after Init, which sizes the tasks without a sync handle.
+   * \param num_slots The number of workers taking part in the launch.
+   * \param weights The relative throughput of each worker, empty for an even split.
+   */
+  void InitTaskRanges(int num_slots, const std::vector<double>& weights) {
+    if (static_cast<size_t>(num_slots) > task_ranges_size_) {
+      task_ranges_.reset(new StealableTaskRange[num_slots]);
+      task_ranges_size_ = num_slots;
+    }
+    num_slots_ = num_slots;
+    int num_task = this->env.num_task;
+    if (weights.empty()) {
+      for (int i = 0; i < num_slots; ++i) {
+        task_ranges_[i].Reset(num_task * i / num_slots, num_task * (i + 1) / num_slots);
+      }
+    } else {
+      // the ranges are proportional to the throughput of their workers
+      double total = 0;
+      for (int i = 0; i < num_slots; ++i) total += weights[i];
+      double prefix = 0;
+      int32_t begin = 0;
+      for (int i = 0; i < num_slots; ++i) {
+        prefix += weights[i];
+        int32_t end = i + 1 == num_slots ? num_task
+                                         : static_cast<int32_t>(num_task * prefix / total + 0.5);
+        task_ranges_[i].Reset(begin, end);
+        begin = end;
+      }
+    }
+    num_active_slots_.store(num_slots);
+    this->work_stealing = true;
+  }
+  /*!
+   * \brief Run the tasks of one slot, then steal from the other slots until all are drained.
+   * \param slot The slot of the calling worker.
+   */
+  void RunTaskRanges(int slot) {
+    int32_t task_id;
+    while (task_ranges_[slot].PopFront(&task_id)) {
+      RunTask(task_id);
+    }
+    // start from the next slot so that the thieves spread over the victims
+    for (int i = 1; i < num_slots_; ++i) {
+      StealableTaskRange& victim = task_ranges_[(slot + i) % num_slots_];
+      while (victim.StealBack(&task_id)) {
+        RunTask(task_id);
+      }
+    }
+    num_active_slots_.fetch_sub(1);
+  }
+  // Run a single task and signal its completion.
+  void RunTask(int task_id) {
+    ParallelTaskContext* ctx = ParallelTaskContext::ThreadLocal();
+    ParallelTaskContext outer = *ctx;
+    ctx->pool = pool;
+    ctx->thread_budget = env.thread_budget;
+    int ret = (*flambda)(task_id, &env, cdata);
+    *ctx = outer;
+    if (ret == 0) {
+      SignalJobFinish();
+    } else {
+      SignalJobError(task_id);
+    }
+  }
   // Wait n jobs to finish
   int WaitForJobs() {
-    while (num_pending_.load() != 0) {
+    // In work-stealing mode also wait for every worker to leave the task ranges,
+    // so that the next launch can safely reset them.
+    while (num_pending_.load() != 0 || (work_stealing && num_active_slots_.load() != 0)) {
       tvm::runtime::threading::Yield();
     }
     if (!has_error_.load()) return 0;
@@ -123,19 +319,33 @@ class ParallelLauncher {
   FTVMParallelLambda flambda;
   // The closure data
   void* cdata;
+  // The pool running the tasks
+  ThreadPool* pool{nullptr};
   // Local env
   TVMParallelGroupEnv env;
+  // Whether the tasks are distributed through stealable task ranges.
+  bool work_stealing{false};
   // Whether this thread is worker of the pool.
   // used to prevent recursive launch.
   bool is_worker{false};
 
  private:
+  // The per-worker task ranges used in work-stealing mode.
+  std::unique_ptr<StealableTaskRange[]> task_ranges_;
+  // The allocated size of task_ranges_
+  size_t task_ranges_size_{0};
+  // The number of task ranges used by the current launch.
+  int num_slots_{0};
+  // The number of workers that have not finished draining the task ranges.
+  std::atomic<int32_t> num_active_slots_{0};
   // The pending jobs.
   std::atomic<int32_t> num_pending_;
   // Whether error has been countered.
   std::atomic<bool> has_error_;
   // The counter page.
   std::atomic<int32_t>* sync_counter_{nullptr};
+  // The number of tasks the counter page can host.
+  int sync_counter_size_{0};
   // The error message
   std::vector<std::string> par_errors_;
 };
@@ -143,7 +353,7 @@ class ParallelLauncher {
 /*! \brief Lock-free single-producer-single-consumer queue for each thread */
 class SpscTaskQueue {
  public:
-  /*! \brief The task entry */
+  /*! \brief The task entry, a null launcher makes the worker join the parallel region. */
   struct Task {
     ParallelLauncher* launcher;
     int32_t task_id;
@@ -254,6 +464,56 @@ class SpscTaskQueue {
   std::condition_variable cv_;
 };
 
+/*!
+ * \brief The workers shared by the thread pools of the process.
+ *
+ *  Each thread launching parallel jobs has its own pool. A server running several models on
+ *  their own threads would otherwise run that many full sized launches at once. While more than
+ *  one pool is alive, the launches on the default number of tasks take their workers from a
+ *  process-wide budget of MaxConcurrency, and run on fewer workers when it is exhausted. Setting
+ *  TVM_SHARE_THREAD_BUDGET to 0 disables the budget. The workers of each pool are still limited
+ *  by runtime.config_threadpool on its thread.
+ */
+class SharedWorkerBudget {
+ public:
+  static SharedWorkerBudget* Global() {
+    static SharedWorkerBudget* inst = new SharedWorkerBudget();
+    return inst;
+  }
+
+  void AddPool() { num_pools_.fetch_add(1, std::memory_order_relaxed); }
+  void RemovePool() { num_pools_.fetch_sub(1, std::memory_order_relaxed); }
+
+  /*! \return Whether the launches should take their workers from the budget. */
+  bool Active() const { return enabled_ && num_pools_.load(std::memory_order_relaxed) > 1; }
+
+  /*!
+   * \brief Take workers from the budget, to be given back by Release.
+   * \param max_workers The number of workers wanted.
+   * \return The number of workers granted, at least the calling thread.
+   */
+  int Acquire(int max_workers) {
+    int available = available_.load(std::memory_order_relaxed);
+    int granted;
+    do {
+      granted = std::max(1, std::min(max_workers, available));
+    } while (!available_.compare_exchange_weak(available, available - granted));
+    return granted;
+  }
+
+  void Release(int num_workers) { available_.fetch_add(num_workers); }
+
+ private:
+  SharedWorkerBudget() : available_(threading::MaxConcurrency()) {
+    const char* val = getenv("TVM_SHARE_THREAD_BUDGET");
+    enabled_ = val == nullptr || atoi(val) != 0;
+  }
+
+  bool enabled_;
+  std::atomic<int> num_pools_{0};
+  std::atomic<int> available_;
+};
+
 // The thread pool
 class ThreadPool {
  public:
@@ -263,9 +523,15 @@ class ThreadPool {
       exclude_worker0_ = false;
     }
     Init();
+    SharedWorkerBudget::Global()->AddPool();
   }
 
   ~ThreadPool() {
+    SharedWorkerBudget::Global()->RemovePool();
+    if (region_active_) {
+      region_depth_ = 1;
+      EndRegion();
+    }
     for (std::unique_ptr<SpscTaskQueue>& q : queues_) {
       q->SignalForKill();
     }
@@ -273,6 +539,7 @@ class ThreadPool {
   }
 
   void Reset() {
+    ICHECK_EQ(region_depth_, 0) << "Cannot reset the thread pool inside a parallel region";
     for (std::unique_ptr<SpscTaskQueue>& q : queues_) {
       q->SignalForKill();
     }
@@ -286,8 +553,23 @@ class ThreadPool {
     ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
     ICHECK(!launcher->is_worker)
         << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    // the workers this launch may use, fewer than the pool's when they come from the budget
+    int num_launch_workers = num_workers_used_;
+    int num_budget_workers = 0;
+    // a negative num_task asks for one task per worker, which the barriers need
+    bool one_task_per_worker = num_task < 0;
+    if (one_task_per_worker) num_task = 0;
     if (num_task == 0) {
-      num_task = num_workers_used_;
+      if (!one_task_per_worker &&
+          (steal_chunks_per_worker_ > 1 || !worker_weights_.empty()) && num_workers_used_ > 1) {
+        return LaunchWorkStealing(launcher, flambda, cdata);
+      }
+      SharedWorkerBudget* budget = SharedWorkerBudget::Global();
+      if (!region_active_ && num_workers_used_ > 1 && budget->Active()) {
+        num_budget_workers = budget->Acquire(num_workers_used_);
+        num_launch_workers = num_budget_workers;
+      }
+      num_task = num_launch_workers;
     }
     if (need_sync != 0) {
       ICHECK_LE(num_task, num_workers_used_)
@@ -295,29 +577,176 @@ class ThreadPool {
           << " workers=" << num_workers_used_ << " request=" << num_task;
     }
     launcher->Init(flambda, cdata, num_task, need_sync != 0);
-    SpscTaskQueue::Task tsk;
-    tsk.launcher = launcher;
-    // if worker0 is taken by the main, queues_[0] is abandoned
-    for (int i = exclude_worker0_; i < num_task; ++i) {
-      tsk.task_id = i;
-      queues_[i]->Push(tsk);
+    launcher->pool = this;
+    // the workers left idle by this launch are shared among the tasks for nested launches
+    launcher->env.thread_budget = std::max(1, num_launch_workers / num_task);
+    if (region_active_) {
+      // the workers of the region stay busy, so nested launches run on their caller
+      launcher->env.thread_budget = 1;
+      PublishToRegion(launcher);
+    } else {
+      SetWorkersBusy(0, std::min(num_task, num_workers_), true);
+      SpscTaskQueue::Task tsk;
+      tsk.launcher = launcher;
+      // if worker0 is taken by the main, queues_[0] is abandoned
+      for (int i = exclude_worker0_; i < num_task; ++i) {
+        tsk.task_id = i;
+        queues_[i]->Push(tsk);
+      }
     }
     // use the main thread to run task 0
     if (exclude_worker0_) {
-      TVMParallelGroupEnv* penv = &(tsk.launcher->env);
-      if ((*tsk.launcher->flambda)(0, penv, cdata) == 0) {
-        tsk.launcher->SignalJobFinish();
-      } else {
-        tsk.launcher->SignalJobError(tsk.task_id);
-      }
+      launcher->RunTask(0);
     }
     int res = launcher->WaitForJobs();
+    if (region_active_) {
+      WaitForRegionWorkers();
+    } else {
+      SetWorkersBusy(0, std::min(num_task, num_workers_), false);
+    }
+    if (num_budget_workers != 0) {
+      SharedWorkerBudget::Global()->Release(num_budget_workers);
+    }
+    return res;
+  }
+
+  /*!
+   * \brief Start a parallel region, in which the workers keep running between the launches
+   *  of the calling thread instead of waiting on their queues.
+   *
+   *  A launch inside the region publishes its tasks to the running workers and waits for all
+   *  of them to be done with it, so consecutive kernels pay a barrier instead of the wake up
+   *  of each worker. The workers spin until the end of the region, which suits a run of
+   *  many short kernels. Regions can be nested, only the outermost one has an effect.
+   */
+  void BeginRegion() {
+    if (region_depth_++ != 0 || num_workers_used_ <= 1) return;
+    region_launcher_ = nullptr;
+    region_begin_generation_ = region_generation_.load(std::memory_order_relaxed);
+    region_acks_.store(0, std::memory_order_relaxed);
+    num_region_workers_ = num_workers_used_ - exclude_worker0_;
+    SetWorkersBusy(0, num_workers_used_, true);
+    SpscTaskQueue::Task tsk;
+    tsk.launcher = nullptr;
+    for (int i = exclude_worker0_; i < num_workers_used_; ++i) {
+      tsk.task_id = i;
+      queues_[i]->Push(tsk);
+    }
+    region_active_ = true;
+  }
+
+  /*! \brief End the parallel region started by the matching BeginRegion. */
+  void EndRegion() {
+    ICHECK_GT(region_depth_, 0) << "EndRegion without a matching BeginRegion";
+    if (--region_depth_ != 0 || !region_active_) return;
+    // a null launcher sends the workers back to their queues
+    PublishToRegion(nullptr);
+    WaitForRegionWorkers();
+    region_active_ = false;
+    SetWorkersBusy(0, num_workers_used_, false);
+  }
+
+  /*!
+   * \brief Launch a parallel job from inside a task of this pool.
+   *
+   *  The job runs on the calling thread plus the workers of this pool that are
+   *  idle, using at most thread_budget threads in total. The lambda sees the
+   *  actual number of tasks in penv->num_task, which may be lower than requested
+   *  when not enough workers are idle.
+   */
+  int LaunchNested(FTVMParallelLambda flambda, void* cdata, int num_task, int thread_budget) {
+    int max_task = num_task <= 0 ? thread_budget : std::min(num_task, thread_budget);
+    std::vector<int> workers;
+    if (max_task > 1) {
+      ClaimIdleWorkers(max_task - 1, &workers);
+    }
+    ParallelLauncher launcher;
+    num_task = static_cast<int>(workers.size()) + 1;
+    launcher.Init(flambda, cdata, num_task, true);
+    launcher.pool = this;
+    launcher.env.thread_budget = std::max(1, thread_budget / num_task);
+    SpscTaskQueue::Task tsk;
+    tsk.launcher = &launcher;
+    for (int i = 1; i < num_task; ++i) {
+      tsk.task_id = i;
+      queues_[workers[i - 1]]->Push(tsk);
+    }
+    launcher.RunTask(0);
+    int res = launcher.WaitForJobs();
+    for (int worker_id : workers) {
+      worker_busy_[worker_id].store(false, std::memory_order_release);
+    }
     return res;
   }
 
+  /*!
+   * \brief Launch a parallel job from the calling thread.
+   *  Launches issued inside a running task are nested into the pool running it,
+   *  other launches go to the thread local pool.
+   */
+  static int ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+    ParallelTaskContext* ctx = ParallelTaskContext::ThreadLocal();
+    if (ctx->pool != nullptr) {
+      return ctx->pool->LaunchNested(flambda, cdata, num_task, ctx->thread_budget);
+    }
+    return ThreadLocal()->Launch(flambda, cdata, num_task, 1);
+  }
+
   static ThreadPool* ThreadLocal() { return dmlc::ThreadLocalStore<ThreadPool>::Get(); }
 
+  /*!
+   * \brief Configure the work-stealing mode.
+   * \param chunks_per_worker The number of tasks each worker's share of a launch
+   *        is split into, values no larger than 1 disable work stealing.
+   */
+  void SetStealChunksPerWorker(int chunks_per_worker) {
+    ICHECK_GE(chunks_per_worker, 0);
+    steal_chunks_per_worker_ = chunks_per_worker;
+  }
+
+  /*!
+   * \brief Split the launches over the workers in proportion to their throughput.
+   *
+   *  The tasks are spread as in work-stealing mode, the range of each worker being sized by
+   *  its weight, so that the little cores of a big.LITTLE system get less work than the big
+   *  ones and the stealing only evens out the remaining imbalance.
+   * \param weights The comma separated relative throughput of the workers in use, as
+   *  returned by Calibrate, an empty string gets back to the even split.
+   */
+  void SetWorkerWeights(const std::string& weights) {
+    std::vector<double> parsed = ParseWorkerWeights(weights);
+    ICHECK(parsed.empty() || static_cast<int>(parsed.size()) == num_workers_used_)
+        << "Expect the weights of the " << num_workers_used_ << " workers in use, got "
+        << weights;
+    worker_weights_ = parsed;
+  }
+
+  /*!
+   * \brief Measure the throughput of each worker in use, all running at the same time, and
+   *  split the next launches accordingly, see SetWorkerWeights.
+   * \return The relative throughputs, to be cached and given back to SetWorkerWeights or to
+   *  the TVM_THREAD_POOL_WEIGHTS environment variable instead of calibrating again.
+   */
+  std::string Calibrate() {
+    ICHECK_EQ(region_depth_, 0) << "Cannot calibrate the thread pool inside a parallel region";
+    std::vector<double> counts(num_workers_used_, 0);
+    if (num_workers_used_ > 1) {
+      ICHECK_EQ(Launch(CalibrationTask, &counts, num_workers_used_, 1), 0) << TVMGetLastError();
+    }
+    double max_count = *std::max_element(counts.begin(), counts.end());
+    std::ostringstream os;
+    os.precision(3);
+    for (size_t i = 0; i < counts.size(); ++i) {
+      os << (i == 0 ? "" : ",") << std::max(counts[i], 1.0) / std::max(max_count, 1.0);
+    }
+    SetWorkerWeights(os.str());
+    return os.str();
+  }
+
   void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads) {
+    ICHECK_EQ(region_depth_, 0) << "Cannot configure the thread pool inside a parallel region";
+    // the weights were measured on the previous cores
+    worker_weights_.clear();
     // this will also reset the affinity of the ThreadGroup
     // may use less than the MaxConcurrency number of workers
     num_workers_used_ = threads_->Configure(mode, nthreads, exclude_worker0_);
@@ -326,18 +755,136 @@ class ThreadPool {
     num_workers_used_ = std::min(num_workers_, num_workers_used_);
   }
 
+  void UpdateWorkerConfigurationNumaNode(int node, int nthreads) {
+    ICHECK_EQ(region_depth_, 0) << "Cannot configure the thread pool inside a parallel region";
+    worker_weights_.clear();
+    num_workers_used_ = threads_->ConfigureNumaNode(node, nthreads, exclude_worker0_);
+  }
+
  private:
+  /*!
+   * \brief Launch the tasks in work-stealing mode.
+   *
+   *  The loop is split into steal_chunks_per_worker_ tasks per worker, each
+   *  worker drains its own range of tasks and then steals from its peers, so a
+   *  slow worker does not stall the whole launch. Tasks may run one after the
+   *  other on the same worker, hence no sync handle is provided.
+   */
+  int LaunchWorkStealing(ParallelLauncher* launcher, FTVMParallelLambda flambda, void* cdata) {
+    int chunks_per_worker =
+        steal_chunks_per_worker_ > 1 ? steal_chunks_per_worker_ : kWeightedChunksPerWorker;
+    launcher->Init(flambda, cdata, num_workers_used_ * chunks_per_worker, false);
+    launcher->InitTaskRanges(num_workers_used_, worker_weights_);
+    launcher->pool = this;
+    if (region_active_) {
+      PublishToRegion(launcher);
+    } else {
+      SetWorkersBusy(0, num_workers_used_, true);
+      SpscTaskQueue::Task tsk;
+      tsk.launcher = launcher;
+      // in work-stealing mode task_id is the slot of the task ranges to start with
+      for (int i = exclude_worker0_; i < num_workers_used_; ++i) {
+        tsk.task_id = i;
+        queues_[i]->Push(tsk);
+      }
+    }
+    if (exclude_worker0_) {
+      launcher->RunTaskRanges(0);
+    }
+    int res = launcher->WaitForJobs();
+    if (region_active_) {
+      WaitForRegionWorkers();
+    } else {
+      SetWorkersBusy(0, num_workers_used_, false);
+    }
+    return res;
+  }
+
+  // Hand a launch to the workers of the region, nullptr ends the region.
+  void PublishToRegion(ParallelLauncher* launcher) {
+    region_acks_.store(0, std::memory_order_relaxed);
+    region_launcher_ = launcher;
+    region_generation_.fetch_add(1, std::memory_order_release);
+  }
+
+  // Wait for every worker of the region to be done with the last published launch.
+  void WaitForRegionWorkers() {
+    while (region_acks_.load(std::memory_order_acquire) != num_region_workers_) {
+      tvm::runtime::threading::Yield();
+    }
+  }
+
+  // The loop of a worker inside a parallel region, each launch is acknowledged by every
+  // worker, whether it had a task in it or not.
+  void RunRegion(int worker_id) {
+    uint64_t seen = region_begin_generation_;
+    while (true) {
+      uint64_t generation;
+      while ((generation = region_generation_.load(std::memory_order_acquire)) == seen) {
+        tvm::runtime::threading::Yield();
+      }
+      seen = generation;
+      ParallelLauncher* launcher = region_launcher_;
+      if (launcher != nullptr) {
+        if (launcher->work_stealing) {
+          launcher->RunTaskRanges(worker_id);
+        } else if (worker_id < launcher->env.num_task) {
+          launcher->RunTask(worker_id);
+        }
+      }
+      region_acks_.fetch_add(1, std::memory_order_acq_rel);
+      if (launcher == nullptr) return;
+    }
+  }
+
+  // Mark the workers in [begin, end) as taken by a top level launch.
+  void SetWorkersBusy(int begin, int end, bool busy) {
+    for (int i = begin; i < end; ++i) {
+      worker_busy_[i].store(busy, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief Claim idle workers for a nested launch.
+   * \param max_workers The maximum number of workers to claim.
+   * \param workers The ids of the claimed workers.
+   */
+  void ClaimIdleWorkers(int max_workers, std::vector<int>* workers) {
+    // worker 0 is the main thread when it is excluded from the pool
+    for (int i = exclude_worker0_;
+         i < num_workers_used_ && static_cast<int>(workers->size()) < max_workers; ++i) {
+      bool expected = false;
+      if (!worker_busy_[i].load(std::memory_order_relaxed) &&
+          worker_busy_[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        workers->push_back(i);
+      }
+    }
+  }
+
   // Shared initialization code
   void Init() {
     for (int i = 0; i < num_workers_; ++i) {
       // The SpscTaskQueue only hosts ONE item at a time
       queues_.emplace_back(std::unique_ptr<SpscTaskQueue>(new SpscTaskQueue()));
     }
+    worker_busy_.reset(new std::atomic<bool>[num_workers_]);
+    SetWorkersBusy(0, num_workers_, false);
     threads_ = std::unique_ptr<tvm::runtime::threading::ThreadGroup>(
         new tvm::runtime::threading::ThreadGroup(
             num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
             exclude_worker0_ /* include_main_thread */));
     num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    worker_weights_.clear();
+    if (const char* weights = getenv("TVM_THREAD_POOL_WEIGHTS")) {
+      if (static_cast<int>(ParseWorkerWeights(weights).size()) == num_workers_used_) {
+        SetWorkerWeights(weights);
+      } else {
+        LOG(WARNING) << "Ignore TVM_THREAD_POOL_WEIGHTS, which does not match the "
+                     << num_workers_used_ << " workers in use";
+      }
+    } else if (const char* calibrate = getenv("TVM_THREAD_POOL_CALIBRATE")) {
+      if (atoi(calibrate) != 0) Calibrate();
+    }
   }
 
   // Internal worker function.
@@ -350,13 +897,12 @@ class ThreadPool {
     // TODO(tulloch): should we make this configurable via standard APIs?
     static size_t spin_count = GetSpinCount();
     while (queue->Pop(&task, spin_count)) {
-      ICHECK(task.launcher != nullptr);
-      TVMParallelGroupEnv* penv = &(task.launcher->env);
-      void* cdata = task.launcher->cdata;
-      if ((*task.launcher->flambda)(task.task_id, penv, cdata) == 0) {
-        task.launcher->SignalJobFinish();
+      if (task.launcher == nullptr) {
+        RunRegion(worker_id);
+      } else if (task.launcher->work_stealing) {
+        task.launcher->RunTaskRanges(task.task_id);
       } else {
-        task.launcher->SignalJobError(task.task_id);
+        task.launcher->RunTask(task.task_id);
       }
     }
   }
@@ -365,8 +911,28 @@ class ThreadPool {
   int num_workers_used_;
   // if or not to exclude worker 0 and use main to run task 0
   bool exclude_worker0_{true};
+  // number of tasks per worker in work-stealing mode, work stealing is off when <= 1
+  int steal_chunks_per_worker_{static_cast<int>(GetStealChunksPerWorker())};
+  // the relative throughput of each worker in use, empty for an even split of the launches
+  std::vector<double> worker_weights_;
+  // whether each worker is taken by a launch, the idle ones can be claimed by nested launches
+  std::unique_ptr<std::atomic<bool>[]> worker_busy_;
   std::vector<std::unique_ptr<SpscTaskQueue> > queues_;
   std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
+  // the nesting depth of the parallel regions of the owner thread
+  int region_depth_{0};
+  // whether the workers are running the parallel region
+  bool region_active_{false};
+  // the number of workers taking part in the region
+  int num_region_workers_{0};
+  // the launch published to the region, written before region_generation_ is bumped
+  ParallelLauncher* region_launcher_{nullptr};
+  // the value of region_generation_ when the region started
+  uint64_t region_begin_generation_{0};
+  // bumped on each launch published to the region
+  alignas(kL1CacheBytes) std::atomic<uint64_t> region_generation_{0};
+  // the number of workers done with the last published launch
+  alignas(kL1CacheBytes) std::atomic<int> region_acks_{0};
 };
 
 TVM_REGISTER_GLOBAL("runtime.config_threadpool").set_body([](TVMArgs args, TVMRetValue* rv) {
@@ -374,10 +940,45 @@ TVM_REGISTER_GLOBAL("runtime.config_threadpool").set_body([](TVMArgs args, TVMRe
       static_cast<threading::ThreadGroup::AffinityMode>(static_cast<int>(args[0]));
   int nthreads = args[1];
   ThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads);
+  if (args.num_args > 2) {
+    ThreadPool::ThreadLocal()->SetStealChunksPerWorker(args[2]);
+  }
+});
+
+// Bind the thread pool of the calling thread to a NUMA node, see ConfigureNumaNode. Running
+// one executor per node, each created and run on a thread configured with its node, keeps
+// its tensors, its copy of the parameters and the workspaces of its operators on the node.
+TVM_REGISTER_GLOBAL("runtime.config_threadpool_numa").set_body_typed([](int node, int nthreads) {
+  ThreadPool::ThreadLocal()->UpdateWorkerConfigurationNumaNode(node, nthreads);
+});
+
+TVM_REGISTER_GLOBAL("runtime.calibrate_threadpool").set_body_typed([]() {
+  return ThreadPool::ThreadLocal()->Calibrate();
+});
+
+TVM_REGISTER_GLOBAL("runtime.set_threadpool_weights").set_body_typed([](std::string weights) {
+  ThreadPool::ThreadLocal()->SetWorkerWeights(weights);
 });
 
+TVM_REGISTER_GLOBAL("runtime.numa_num_nodes").set_body_typed(threading::NumNumaNodes);
+
 namespace threading {
 void ResetThreadPool() { tvm::runtime::ThreadPool::ThreadLocal()->Reset(); }
+
+// The launches inside a parallel task are nested in the pool running it, which is busy.
+void BeginParallelRegion() {
+#if !TVM_THREADPOOL_USE_OPENMP
+  if (tvm::runtime::ParallelTaskContext::ThreadLocal()->pool != nullptr) return;
+  tvm::runtime::ThreadPool::ThreadLocal()->BeginRegion();
+#endif
+}
+
+void EndParallelRegion() {
+#if !TVM_THREADPOOL_USE_OPENMP
+  if (tvm::runtime::ParallelTaskContext::ThreadLocal()->pool != nullptr) return;
+  tvm::runtime::ThreadPool::ThreadLocal()->EndRegion();
+#endif
+}
 }  // namespace threading
 
 }  // namespace runtime
@@ -390,19 +991,21 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
     TVMParallelGroupEnv env;
     env.num_task = 1;
     env.sync_handle = &sync_counter;
+    env.thread_budget = 1;
     (*flambda)(0, &env, cdata);
     return 0;
   } else {
 #if !TVM_THREADPOOL_USE_OPENMP
-    int res = tvm::runtime::ThreadPool::ThreadLocal()->Launch(flambda, cdata, num_task, 1);
+    int res = tvm::runtime::ThreadPool::ParallelLaunch(flambda, cdata, num_task);
     return res;
 #else
-    if (num_task == 0) num_task = num_workers;
+    if (num_task <= 0) num_task = num_workers;
     omp_set_num_threads(num_task);
 #pragma omp parallel num_threads(num_task)
     {
       TVMParallelGroupEnv env;
       env.num_task = num_task;
+      env.thread_budget = 1;
       (*flambda)(omp_get_thread_num(), &env, cdata);
     }
     return 0;
@@ -416,6 +1019,9 @@ int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) {
 #else
   using tvm::runtime::kSyncStride;
   int num_task = penv->num_task;
+  ICHECK(penv->sync_handle != nullptr)
+      << "TVMBackendParallelBarrier needs one task per thread, "
+      << "launch the lambda with a negative num_task or a fixed number of tasks";
   std::atomic<int>* sync_counter = reinterpret_cast<std::atomic<int>*>(penv->sync_handle);
   int old_counter = sync_counter[task_id * kSyncStride].fetch_add(1, std::memory_order_release);
   for (int i = 0; i < num_task; ++i) {
@@ -25,7 +25,10 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <string>
 #include <thread>
+#include <vector>
 #if defined(__linux__) || defined(__ANDROID__)
 #include <fstream>
 #include <sstream>
@@ -42,6 +45,71 @@ namespace tvm {
 namespace runtime {
 namespace threading {
 
+namespace {
+#if defined(__linux__) || defined(__ANDROID__)
+// Parse a CPU list of the sysfs, such as "0-7,16-23".
+std::vector<unsigned int> ParseCpuList(const std::string& list) {
+  std::vector<unsigned int> cpus;
+  std::istringstream is(list);
+  std::string range;
+  while (std::getline(is, range, ',')) {
+    size_t dash = range.find('-');
+    unsigned int first = std::stoul(range.substr(0, dash));
+    unsigned int last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+    for (unsigned int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// The CPUs granted by the cgroup CPU quota of the process, rounded up, 0 without a quota. The
+// cgroup of a container is the root of its cgroup namespace, so the root files are read.
+int CgroupCpuQuota() {
+  int64_t quota = -1;
+  int64_t period = 0;
+  std::ifstream v2("/sys/fs/cgroup/cpu.max");
+  if (!v2.fail()) {
+    // cgroup v2, "max 100000" without a quota
+    std::string value;
+    if (v2 >> value >> period && value != "max") quota = std::stoll(value);
+  } else {
+    // cgroup v1, a quota of -1 without a quota
+    std::ifstream quota_file("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+    std::ifstream period_file("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+    if (!(quota_file >> quota && period_file >> period)) quota = -1;
+  }
+  if (quota <= 0 || period <= 0) return 0;
+  return static_cast<int>((quota + period - 1) / period);
+}
+#endif
+
+// The CPUs of each NUMA node, a single node holding all the CPUs when the topology is unknown.
+const std::vector<std::vector<unsigned int>>& NumaNodeCpus() {
+  static const std::vector<std::vector<unsigned int>> nodes = []() {
+    std::vector<std::vector<unsigned int>> nodes;
+#if defined(__linux__) || defined(__ANDROID__)
+    for (int node = 0;; ++node) {
+      std::ifstream ifs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      std::string list;
+      if (ifs.fail() || !std::getline(ifs, list)) break;
+      // the nodes without CPU only hold memory
+      std::vector<unsigned int> cpus = ParseCpuList(list);
+      if (!cpus.empty()) nodes.push_back(cpus);
+    }
+#endif
+    if (nodes.empty()) {
+      nodes.emplace_back();
+      for (unsigned int i = 0; i < std::max(1U, std::thread::hardware_concurrency()); ++i) {
+        nodes[0].push_back(i);
+      }
+    }
+    return nodes;
+  }();
+  return nodes;
+}
+}  // namespace
+
 class ThreadGroup::Impl {
  public:
   Impl(int num_workers, std::function<void(int)> worker_callback, bool exclude_worker0)
@@ -93,7 +161,46 @@ class ThreadGroup::Impl {
     return num_workers_used;
   }
 
+  int ConfigureNumaNode(int node, int nthreads, bool exclude_worker0) {
+    const auto& nodes = NumaNodeCpus();
+    ICHECK(node >= 0 && node < static_cast<int>(nodes.size()))
+        << "Invalid NUMA node " << node << ", the system has " << nodes.size() << " nodes";
+    const std::vector<unsigned int>& cpus = nodes[node];
+    int num_workers_used = nthreads;
+    if (num_workers_used == 0) {
+      // MaxConcurrency leaves out the hyper-threads, so does the default of each node
+      unsigned int num_cpus = std::max(1U, std::thread::hardware_concurrency());
+      num_workers_used = std::max<int>(1, cpus.size() * MaxConcurrency() / num_cpus);
+    }
+    num_workers_used = std::min(num_workers_, num_workers_used);
+
+    const char* val = getenv("TVM_BIND_THREADS");
+    if (val == nullptr || atoi(val) == 1) {
+      SetNodeAffinity(cpus, exclude_worker0);
+    }
+    return num_workers_used;
+  }
+
  private:
+  // Bind the workers to the CPUs of a NUMA node, in the order of the node's CPU list which
+  // goes over the physical cores before their hyper-threads, and the main thread to all of it.
+  void SetNodeAffinity(const std::vector<unsigned int>& cpus, bool exclude_worker0) {
+#if defined(__linux__)
+    for (unsigned i = 0; i < threads_.size(); ++i) {
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpus[(i + exclude_worker0) % cpus.size()], &cpuset);
+      pthread_setaffinity_np(threads_[i].native_handle(), sizeof(cpu_set_t), &cpuset);
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (unsigned int cpu : cpus) {
+      CPU_SET(cpu, &cpuset);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#endif
+  }
+
   // bind worker threads to disjoint cores
   // if worker 0 is offloaded to main, i.e. exclude_worker0 is true,
   // the main thread is bound to core 0.
@@ -235,8 +342,45 @@ int ThreadGroup::Configure(AffinityMode mode, int nthreads, bool exclude_worker0
   return impl_->Configure(mode, nthreads, exclude_worker0);
 }
 
+int ThreadGroup::ConfigureNumaNode(int node, int nthreads, bool exclude_worker0) {
+  return impl_->ConfigureNumaNode(node, nthreads, exclude_worker0);
+}
+
 void Yield() { std::this_thread::yield(); }
 
+// The number of physical cores the process may run on, which takes system calls and reads of
+// the cgroup files to find, so it is computed once by MaxConcurrency.
+static int HardwareConcurrency() {
+  int max_concurrency = std::thread::hardware_concurrency();
+#if defined(__linux__) && !defined(__ANDROID__)
+  // the cpuset of a container or of taskset only leaves some of the CPUs to the process
+  cpu_set_t cpuset;
+  if (sched_getaffinity(0, sizeof(cpuset), &cpuset) == 0 && CPU_COUNT(&cpuset) > 0) {
+    max_concurrency = std::min(max_concurrency, CPU_COUNT(&cpuset));
+  }
+#endif
+#if defined(_M_X64) || defined(__x86_64__)
+  max_concurrency /= 2;  // ignore hyper-threading
+#elif defined(__hexagon__)
+  // With unsigned PDs, getting the number of available hardware threads
+  // is not supported in earlier versions of QuRT. In such cases assume 4.
+  // If running on simulator, set max_concurrency to 1.
+  if (max_concurrency == 0) {
+    if (dlsym(RTLD_DEFAULT, "running_in_sim_dev_17bc90206f6cf5a7")) {
+      max_concurrency = 1;
+    } else {
+      max_concurrency = 4;
+    }
+  }
+#endif
+#if defined(__linux__) || defined(__ANDROID__)
+  // more workers than the quota get throttled, ignoring the hyper-threads already halved them
+  int quota = CgroupCpuQuota();
+  if (quota > 0) max_concurrency = std::min(max_concurrency, quota);
+#endif
+  return max_concurrency;
+}
+
 int MaxConcurrency() {
   int max_concurrency = 1;
   const char* val = getenv("TVM_NUM_THREADS");
@@ -246,25 +390,15 @@ int MaxConcurrency() {
   if (val != nullptr) {
     max_concurrency = atoi(val);
   } else {
-    max_concurrency = std::thread::hardware_concurrency();
-#if defined(_M_X64) || defined(__x86_64__)
-    max_concurrency /= 2;  // ignore hyper-threading
-#elif defined(__hexagon__)
-    // With unsigned PDs, getting the number of available hardware threads
-    // is not supported in earlier versions of QuRT. In such cases assume 4.
-    // If running on simulator, set max_concurrency to 1.
-    if (max_concurrency == 0) {
-      if (dlsym(RTLD_DEFAULT, "running_in_sim_dev_17bc90206f6cf5a7")) {
-        max_concurrency = 1;
-      } else {
-        max_concurrency = 4;
-      }
-    }
-#endif
+    // every parallel launch asks for it, so the hardware is only queried once
+    static const int hardware_concurrency = HardwareConcurrency();
+    max_concurrency = hardware_concurrency;
   }
   return std::max(max_concurrency, 1);
 }
 
+int NumNumaNodes() { return static_cast<int>(NumaNodeCpus().size()); }
+
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
@@ -0,0 +1,269 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/vm/cuda_graph/vm_cuda_graph.cc
+ * \brief The Relay virtual machine with CUDA graph support.
+ */
+#include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/vm/vm.h>
+
+#include <list>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief Virtual machine replaying the invocations of a function as CUDA graphs.
+ *
+ *  The first invocation for a given set of input shapes is captured through
+ *  stream capture into a CUDA graph, and later invocations with the same shapes
+ *  copy the inputs into the captured input buffers and launch the graph, which
+ *  removes the kernel launch and interpretation overhead. The instantiated
+ *  graphs are kept in a LRU cache keyed by the function name and input shapes,
+ *  so dynamic-shape models get one graph per shape bucket they are fed with.
+ *
+ *  Replay assumes the instructions executed by the function only depend on the
+ *  input shapes, not on the input values: host code is not re-run on replay.
+ *  The returned outputs are owned by the cached graph and are overwritten by
+ *  the next replay of the same graph.
+ */
+class VirtualMachineCudaGraph : public VirtualMachine {
+ public:
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final;
+
+  ~VirtualMachineCudaGraph() {
+    while (!graphs_.empty()) {
+      EvictLeastRecentlyUsed();
+    }
+  }
+
+ private:
+  /*! \brief A function invocation captured as a CUDA graph. */
+  struct CapturedGraph {
+    /*! \brief The cache key of the graph. */
+    std::string key;
+    /*! \brief The instantiated graph. */
+    cudaGraphExec_t graph_exec{nullptr};
+    /*! \brief The stream the graph is captured on and launched on. */
+    TVMStreamHandle stream{nullptr};
+    /*! \brief The input buffers read by the graph. */
+    std::vector<NDArray> inputs;
+    /*! \brief The outputs written by the graph. */
+    ObjectRef outputs;
+    /*! \brief The objects allocated during capture, kept alive so that replay can reuse them. */
+    std::vector<ObjectRef> allocations;
+  };
+
+  ObjectRef InvokeCudaGraph(const std::string& func_name);
+  CapturedGraph Capture(const VMFunction& func, const std::string& key,
+                        const std::vector<NDArray>& args);
+  void Launch(const CapturedGraph& graph);
+  void EvictLeastRecentlyUsed();
+  Device GetCudaDevice() const;
+
+  void OpStartHook(Instruction instr) final;
+  void OpStopHook() final;
+
+  /*! \brief The captured graphs, the most recently used first. */
+  std::list<CapturedGraph> graphs_;
+  /*! \brief The index of the captured graphs by key. */
+  std::unordered_map<std::string, std::list<CapturedGraph>::iterator> graph_index_;
+  /*! \brief The maximum number of graphs kept instantiated. */
+  size_t max_num_graphs_{8};
+  /*! \brief The objects allocated by the invocation being captured, nullptr when not capturing. */
+  std::vector<ObjectRef>* capture_allocations_{nullptr};
+  /*! \brief The destination register of the instruction in between the op hooks. */
+  RegName hooked_dst_{0};
+};
+
+PackedFunc VirtualMachineCudaGraph::GetFunction(const std::string& name,
+                                                const ObjectPtr<Object>& sptr_to_self) {
+  if (name == "invoke_cuda_graph") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = this->InvokeCudaGraph(args[0]);
+    });
+  } else if (name == "set_cuda_graph_cache_size") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int64_t max_num_graphs = args[0];
+      ICHECK_GE(max_num_graphs, 1);
+      max_num_graphs_ = static_cast<size_t>(max_num_graphs);
+      while (graphs_.size() > max_num_graphs_) {
+        EvictLeastRecentlyUsed();
+      }
+    });
+  } else if (name == "get_cuda_graph_cache_size") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = static_cast<int64_t>(graphs_.size());
+    });
+  } else {
+    return VirtualMachine::GetFunction(name, sptr_to_self);
+  }
+}
+
+Device VirtualMachineCudaGraph::GetCudaDevice() const {
+  for (const Device& dev : devices_) {
+    if (dev.device_type == kDLCUDA) return dev;
+  }
+  LOG(FATAL) << "CUDA graph requires the virtual machine to be initialized with a CUDA device";
+  return Device();
+}
+
+ObjectRef VirtualMachineCudaGraph::InvokeCudaGraph(const std::string& func_name) {
+  ICHECK(exec_) << "The executable is not created yet.";
+  auto git = exec_->global_map.find(func_name);
+  ICHECK(git != exec_->global_map.end())
+      << "Cannot find function " << func_name << " in the executable";
+  const VMFunction& func = exec_->functions[git->second];
+
+  std::vector<NDArray> args;
+  std::ostringstream key;
+  key << func_name;
+  if (!func.params.empty()) {
+    auto it = inputs_.find(func_name);
+    ICHECK(it != inputs_.end()) << "Input has not been set for function " << func_name;
+    for (const ObjectRef& obj : it->second) {
+      ICHECK(obj->IsInstance<NDArray::ContainerType>())
+          << "CUDA graph invocation only supports tensor inputs";
+      NDArray arr = Downcast<NDArray>(obj);
+      args.push_back(arr);
+      key << ';' << DLDataType2String(arr->dtype);
+      for (int64_t dim : arr.Shape()) {
+        key << ',' << dim;
+      }
+    }
+  }
+
+  auto it = graph_index_.find(key.str());
+  if (it == graph_index_.end()) {
+    if (graphs_.size() >= max_num_graphs_) {
+      EvictLeastRecentlyUsed();
+    }
+    graphs_.push_front(Capture(func, key.str(), args));
+    graph_index_[key.str()] = graphs_.begin();
+  } else {
+    graphs_.splice(graphs_.begin(), graphs_, it->second);
+    const CapturedGraph& graph = graphs_.front();
+    for (size_t i = 0; i < args.size(); ++i) {
+      NDArray::CopyFromTo(args[i].operator->(), const_cast<DLTensor*>(graph.inputs[i].operator->()),
+                          graph.stream);
+    }
+  }
+  Launch(graphs_.front());
+  return_register_ = graphs_.front().outputs;
+  return return_register_;
+}
+
+VirtualMachineCudaGraph::CapturedGraph VirtualMachineCudaGraph::Capture(
+    const VMFunction& func, const std::string& key, const std::vector<NDArray>& args) {
+  Device dev = GetCudaDevice();
+  CapturedGraph graph;
+  graph.key = key;
+  std::vector<ObjectRef> func_args;
+  for (const NDArray& arg : args) {
+    NDArray input = NDArray::Empty(arg.Shape(), arg->dtype, arg->device);
+    input.CopyFrom(arg);
+    graph.inputs.push_back(input);
+    func_args.push_back(input);
+  }
+  // Run once without capture so that the kernels are loaded on the device,
+  // module loading is not allowed while a stream is captured.
+  Invoke(func, func_args);
+
+  DeviceAPI* api = DeviceAPI::Get(dev);
+  graph.stream = api->CreateStream(dev);
+  cudaStream_t stream = static_cast<cudaStream_t>(graph.stream);
+  api->SetStream(dev, graph.stream);
+  capture_allocations_ = &graph.allocations;
+  // The relaxed mode allows the allocators to call cudaMalloc during capture.
+  CUDA_CALL(cudaStreamBeginCapture(stream, cudaStreamCaptureModeRelaxed));
+  cudaGraph_t cuda_graph;
+  try {
+    graph.outputs = Invoke(func, func_args);
+  } catch (...) {
+    cudaStreamEndCapture(stream, &cuda_graph);
+    capture_allocations_ = nullptr;
+    api->SetStream(dev, nullptr);
+    api->FreeStream(dev, graph.stream);
+    throw;
+  }
+  CUDA_CALL(cudaStreamEndCapture(stream, &cuda_graph));
+  capture_allocations_ = nullptr;
+  api->SetStream(dev, nullptr);
+  CUDA_CALL(cudaGraphInstantiate(&graph.graph_exec, cuda_graph, nullptr, nullptr, 0));
+  CUDA_CALL(cudaGraphDestroy(cuda_graph));
+  return graph;
+}
+
+void VirtualMachineCudaGraph::Launch(const CapturedGraph& graph) {
+  cudaStream_t stream = static_cast<cudaStream_t>(graph.stream);
+  CUDA_CALL(cudaGraphLaunch(graph.graph_exec, stream));
+  CUDA_CALL(cudaStreamSynchronize(stream));
+}
+
+void VirtualMachineCudaGraph::EvictLeastRecentlyUsed() {
+  CapturedGraph& graph = graphs_.back();
+  CUDA_CALL(cudaGraphExecDestroy(graph.graph_exec));
+  Device dev = GetCudaDevice();
+  DeviceAPI::Get(dev)->FreeStream(dev, graph.stream);
+  graph_index_.erase(graph.key);
+  graphs_.pop_back();
+}
+
+void VirtualMachineCudaGraph::OpStartHook(Instruction instr) {
+  if (capture_allocations_ != nullptr) {
+    hooked_dst_ = instr.dst;
+  }
+}
+
+void VirtualMachineCudaGraph::OpStopHook() {
+  // The hooked instructions all allocate or produce a new object in their destination
+  // register, and the captured kernels keep referring to its address.
+  if (capture_allocations_ != nullptr) {
+    capture_allocations_->push_back(ReadRegister(hooked_dst_));
+  }
+}
+
+runtime::Module CreateVirtualMachineCudaGraph(const Executable* exec) {
+  auto vm = make_object<VirtualMachineCudaGraph>();
+  vm->LoadExecutable(exec);
+  return runtime::Module(vm);
+}
+
+TVM_REGISTER_GLOBAL("runtime._VirtualMachineCudaGraph")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      runtime::Module mod = args[0];
+      const auto* exec = dynamic_cast<Executable*>(mod.operator->());
+      ICHECK(exec) << "The virtual machine executable has not been defined yet.";
+      *rv = CreateVirtualMachineCudaGraph(exec);
+    });
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
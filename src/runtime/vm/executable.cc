@@ -29,6 +29,7 @@
 #include <tvm/runtime/vm/vm.h>
 
 #include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <memory>
@@ -321,7 +322,7 @@ void Executable::SaveGlobalSection(dmlc::Stream* strm) {
   strm->Write(glbs);
 }
 
-void Executable::SaveConstantSection(dmlc::Stream* strm) {
+void Executable::SaveConstantSection(dmlc::SeekStream* strm) {
   std::vector<DLTensor*> arrays;
   for (const auto& obj : this->constants) {
     const auto cell = Downcast<runtime::NDArray>(obj);
@@ -329,7 +330,7 @@ void Executable::SaveConstantSection(dmlc::Stream* strm) {
   }
   strm->Write(static_cast<uint64_t>(this->constants.size()));
   for (const auto& it : arrays) {
-    runtime::SaveDLTensor(strm, it);
+    runtime::SaveAlignedDLTensor(strm, strm->Tell(), it);
   }
 
   // Save the const to device index mapping.
@@ -594,6 +595,29 @@ void Executable::SetLib(const runtime::Module& lib) {
 }
 
 runtime::Module Executable::Load(const std::string& code, const runtime::Module lib) {
+  dmlc::MemoryStringStream strm(const_cast<std::string*>(&code));
+  return LoadFromStream(&strm, lib, nullptr, ObjectRef());
+}
+
+runtime::Module Executable::LoadFromFile(const std::string& file_name,
+                                         const runtime::Module lib) {
+  MappedFile file = MappedFile::Open(file_name);
+  const char* begin = file->data();
+  size_t size = file->size();
+  uint64_t header = 0;
+  STREAM_CHECK(size >= sizeof(header), "header");
+  std::memcpy(&header, begin, sizeof(header));
+  if (header != kTVMVMBytecodeMagic) {
+    // Files written by SaveToBinary prefix the bytecode with its length.
+    begin += sizeof(uint64_t);
+    size -= sizeof(uint64_t);
+  }
+  dmlc::MemoryFixedSizeStream strm(const_cast<char*>(begin), size);
+  return LoadFromStream(&strm, lib, begin, file);
+}
+
+runtime::Module Executable::LoadFromStream(dmlc::SeekStream* strm, const runtime::Module lib,
+                                           const char* base, const ObjectRef& owner) {
   auto exec = make_object<Executable>();
 
   // Support null-initialization of lib, to enable initialization during
@@ -602,26 +626,23 @@ runtime::Module Executable::Load(const std::string& code, const runtime::Module
     exec->SetLib(lib);
   }
 
-  exec->code_ = code;
-  dmlc::MemoryStringStream strm(&exec->code_);
-
   // Load header.
-  LoadHeader(&strm);
+  LoadHeader(strm);
 
   // Virtual devices section
-  exec->LoadVirtualDevicesSection(&strm);
+  exec->LoadVirtualDevicesSection(strm);
 
   // Global section.
-  exec->LoadGlobalSection(&strm);
+  exec->LoadGlobalSection(strm);
 
   // Constant section.
-  exec->LoadConstantSection(&strm);
+  exec->LoadConstantSection(strm, base, owner);
 
   // Primitive names that will be invoked by `InvokePacked` instructions.
-  exec->LoadPrimitiveOpNames(&strm);
+  exec->LoadPrimitiveOpNames(strm);
 
   // Code section.
-  exec->LoadCodeSection(&strm);
+  exec->LoadCodeSection(strm);
 
   return runtime::Module(exec);
 }
@@ -640,7 +661,8 @@ void Executable::LoadGlobalSection(dmlc::Stream* strm) {
   }
 }
 
-void Executable::LoadConstantSection(dmlc::Stream* strm) {
+void Executable::LoadConstantSection(dmlc::Stream* strm, const char* base,
+                                     const ObjectRef& owner) {
   uint64_t sz;
   // Load the number of constants.
   STREAM_CHECK(strm->Read(&sz, sizeof(sz)), "constant");
@@ -648,9 +670,7 @@ void Executable::LoadConstantSection(dmlc::Stream* strm) {
   size_t size = static_cast<size_t>(sz);
   // Load each of the constants.
   for (size_t i = 0; i < size; i++) {
-    runtime::NDArray constant;
-    STREAM_CHECK(constant.Load(strm), "constant");
-    this->constants.emplace_back(std::move(constant));
+    this->constants.emplace_back(runtime::LoadAlignedDLTensor(strm, base, owner));
   }
 
   // Load the const to device index mapping.
@@ -927,23 +947,18 @@ Module ExecutableLoadBinary(void* strm) {
 }
 
 void Executable::SaveToFile(const std::string& path, const std::string& format) {
-  std::string data;
-  dmlc::MemoryStringStream writer(&data);
-  dmlc::SeekStream* strm = &writer;
-  SaveToBinary(strm);
-  SaveBinaryToFile(path, data);
+  // Write the bytecode without the length prefix of SaveToBinary so that the constant
+  // payloads stay aligned to the start of the file and LoadFromFile can map them.
+  auto code_bytes = this->Save();
+  SaveBinaryToFile(path, std::string(code_bytes.data, code_bytes.size));
+  ICHECK(this->imports()[0].defined()) << "the library must be imported before serialization";
 }
 
 TVM_REGISTER_GLOBAL("runtime.module.loadbinary_VMExecutable").set_body_typed(ExecutableLoadBinary);
 
 // Load module from module.
 Module ExecutableLoadFile(const std::string& file_name, const std::string& format) {
-  std::string data;
-  LoadBinaryFromFile(file_name, &data);
-  dmlc::MemoryStringStream reader(&data);
-  dmlc::Stream* strm = &reader;
-  auto exec = ExecutableLoadBinary(reinterpret_cast<void*>(strm));
-  return exec;
+  return Executable::LoadFromFile(file_name, Module());
 }
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_VMExecutable").set_body_typed(ExecutableLoadFile);
@@ -998,6 +1013,11 @@ TVM_REGISTER_GLOBAL("runtime.Load_Executable")
       return Executable::Load(code, lib);
     });
 
+TVM_REGISTER_GLOBAL("runtime.Load_ExecutableFromFile")
+    .set_body_typed([](std::string file_name, runtime::Module lib) {
+      return Executable::LoadFromFile(file_name, lib);
+    });
+
 }  // namespace vm
 }  // namespace runtime
 }  // namespace tvm
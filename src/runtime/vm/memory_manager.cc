@@ -23,11 +23,13 @@
  */
 #include <tvm/runtime/vm/memory_manager.h>
 
+#include <cstdlib>
 #include <memory>
 #include <utility>
 
 #include "naive_allocator.h"
 #include "pooled_allocator.h"
+#include "slab_allocator.h"
 
 namespace tvm {
 namespace runtime {
@@ -42,6 +44,14 @@ static void BufferDeleter(Object* obj) {
   delete ptr;
 }
 
+#if TVM_USE_OBJECT_POOL
+// The containers of the arrays of the storages, made for most VM instructions, are pooled.
+constexpr size_t kContainerSizeClass = (sizeof(NDArray::Container) - 1) / kObjectPoolAlignment;
+static_assert(sizeof(NDArray::Container) <= kObjectPoolMaxBytes &&
+                  alignof(NDArray::Container) <= kObjectPoolAlignment,
+              "NDArray::Container does not fit the object pool");
+#endif
+
 void StorageObj::Deleter(Object* obj) {
   auto* ptr = static_cast<NDArray::Container*>(obj);
   // When invoking AllocNDArray we don't own the underlying allocation
@@ -55,7 +65,12 @@ void StorageObj::Deleter(Object* obj) {
   // reference count from allocation.
   StorageObj* storage = reinterpret_cast<StorageObj*>(ptr->manager_ctx);
   storage->DecRef();
+#if TVM_USE_OBJECT_POOL
+  ptr->NDArray::Container::~Container();
+  detail::ObjectPoolFree(ptr, kContainerSizeClass);
+#else
   delete ptr;
+#endif
 }
 
 inline void VerifyDataType(DLDataType dtype) {
@@ -76,12 +91,23 @@ inline size_t GetDataAlignment(const DLTensor& arr) {
   return align;
 }
 
+Storage::Storage(Buffer buffer) {
+  auto n = DefaultObjAllocator().make_object<StorageObj>();
+  n->buffer = std::move(buffer);
+  data_ = std::move(n);
+}
+
 NDArray StorageObj::AllocNDArray(size_t offset, std::vector<int64_t> shape, DLDataType dtype) {
   VerifyDataType(dtype);
 
   // crtical zone: allocate header, cannot throw
+#if TVM_USE_OBJECT_POOL
+  NDArray::Container* container = new (detail::ObjectPoolAlloc(kContainerSizeClass))
+      NDArray::Container(this->buffer.data, shape, dtype, this->buffer.device);
+#else
   NDArray::Container* container =
       new NDArray::Container(this->buffer.data, shape, dtype, this->buffer.device);
+#endif
   container->dl_tensor.byte_offset = offset;
 
   container->SetDeleter(StorageObj::Deleter);
@@ -130,6 +156,15 @@ Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
         alloc.reset(new PooledAllocator(dev));
         break;
       }
+      case kSlab: {
+        // The cached bytes kept above steady state can be bounded through the environment.
+        const char* val = getenv("TVM_VM_SLAB_ALLOCATOR_MAX_CACHED_BYTES");
+        size_t max_cached_bytes = val ? std::strtoull(val, nullptr, 10) : 0;
+        VLOG(1) << "New slab allocator for " << DeviceName(dev.device_type) << "(" << dev.device_id
+                << "), max cached bytes " << max_cached_bytes;
+        alloc.reset(new SlabAllocator(dev, max_cached_bytes));
+        break;
+      }
       default:
         LOG(FATAL) << "Unknown allocator type: " << type;
     }
@@ -28,13 +28,19 @@
 
 #include <atomic>
 
+#include "../memory_stats.h"
+
 namespace tvm {
 namespace runtime {
 namespace vm {
 
 class NaiveAllocator final : public Allocator {
  public:
-  explicit NaiveAllocator(Device dev) : Allocator(kNaive), used_memory_(0), device_(dev) {}
+  explicit NaiveAllocator(Device dev)
+      : Allocator(kNaive),
+        used_memory_(0),
+        device_(dev),
+        memory_counter_(MemoryStats::Get(dev, kMemoryVMNaive)) {}
 
   Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
     Buffer buf;
@@ -42,6 +48,7 @@ class NaiveAllocator final : public Allocator {
     buf.size = nbytes;
     buf.data = DeviceAPI::Get(device_)->AllocDataSpace(device_, nbytes, alignment, type_hint);
     used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    memory_counter_->RecordAlloc(nbytes);
     DLOG(INFO) << "allocate " << nbytes << " B, used memory " << used_memory_ << " B";
     return buf;
   }
@@ -49,6 +56,7 @@ class NaiveAllocator final : public Allocator {
   void Free(const Buffer& buffer) override {
     DeviceAPI::Get(device_)->FreeDataSpace(buffer.device, buffer.data);
     used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    memory_counter_->RecordFree(buffer.size);
     DLOG(INFO) << "free " << buffer.size << " B, used memory " << used_memory_ << " B";
   }
 
@@ -57,6 +65,7 @@ class NaiveAllocator final : public Allocator {
  private:
   std::atomic<size_t> used_memory_;
   Device device_;
+  MemoryCounter* memory_counter_;
 };
 
 }  // namespace vm
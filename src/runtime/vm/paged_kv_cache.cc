@@ -0,0 +1,245 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/vm/paged_kv_cache.cc
+ * \brief The key value cache of autoregressive decoders, split in fixed size blocks.
+ */
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/vm/memory_manager.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief A pool of cache blocks shared by the sequences of a running batch.
+ *
+ *  The pool is one tensor of shape [num_blocks, block_size, entry_shape...], allocated by the
+ *  pooled allocator of the device. Each sequence owns a list of blocks, its block table, so
+ *  the entry of position p of a sequence is at row p % block_size of its block
+ *  p / block_size. The blocks of a finished sequence go back to the pool at once, and
+ *  sequences of different lengths share the pool without padding.
+ *
+ *  A forked sequence shares the blocks of its parent, counted by reference. A shared block
+ *  is copied when a sequence reserves one of its positions past the shared prefix, so the
+ *  common prefix of the sequences is stored once.
+ */
+class PagedKVCache : public ModuleNode {
+ public:
+  PagedKVCache(int64_t num_blocks, int64_t block_size, ShapeTuple entry_shape, DLDataType dtype,
+               Device dev)
+      : block_size_(block_size), ref_counts_(num_blocks, 0) {
+    ICHECK_GT(num_blocks, 0) << "PagedKVCache: the number of blocks must be positive";
+    ICHECK_GT(block_size, 0) << "PagedKVCache: the block size must be positive";
+    std::vector<int64_t> shape = {num_blocks, block_size};
+    shape.insert(shape.end(), entry_shape.begin(), entry_shape.end());
+    pool_ = MemoryManager::GetOrCreateAllocator(dev, kPooled)->Empty(shape, dtype, dev);
+    // hand out the low blocks first
+    for (int64_t i = num_blocks - 1; i >= 0; --i) {
+      free_blocks_.push_back(static_cast<int32_t>(i));
+    }
+  }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "reserve") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = Reserve(args[0], args[1]);
+      });
+    } else if (name == "free") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { Free(args[0]); });
+    } else if (name == "fork") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { Fork(args[0], args[1]); });
+    } else if (name == "block_table") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = BlockTable(args[0]);
+      });
+    } else if (name == "get_pool") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = pool_; });
+    } else if (name == "set_pool") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { SetPool(args[0]); });
+    } else if (name == "get_num_free_blocks") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = static_cast<int64_t>(free_blocks_.size());
+      });
+    } else if (name == "get_block_size") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = block_size_; });
+    }
+    return PackedFunc();
+  }
+
+  const char* type_key() const final { return "PagedKVCache"; }
+
+  /*!
+   * \brief Make sure a sequence has the blocks holding its first length positions.
+   *
+   *  The positions past the previous length are the ones the caller writes next, the
+   *  shared blocks holding some of them are replaced by private copies.
+   *
+   * \param seq_id The sequence, added when it has no block yet.
+   * \param length The number of positions.
+   * \return Whether the blocks are reserved. Nothing is reserved when the pool is too short.
+   */
+  bool Reserve(int64_t seq_id, int64_t length) {
+    ICHECK_GE(length, 0) << "PagedKVCache: negative length " << length;
+    Sequence& seq = seqs_[seq_id];
+    if (length <= seq.length) return true;
+    size_t num_needed = static_cast<size_t>((length + block_size_ - 1) / block_size_);
+    size_t first_written = static_cast<size_t>(seq.length / block_size_);
+    std::vector<size_t> to_copy;
+    for (size_t i = first_written; i < std::min(num_needed, seq.blocks.size()); ++i) {
+      if (ref_counts_[seq.blocks[i]] > 1) to_copy.push_back(i);
+    }
+    size_t num_new = num_needed > seq.blocks.size() ? num_needed - seq.blocks.size() : 0;
+    if (num_new + to_copy.size() > free_blocks_.size()) {
+      if (seq.blocks.empty()) seqs_.erase(seq_id);
+      return false;
+    }
+    for (size_t i : to_copy) {
+      int32_t block = PopFreeBlock();
+      CopyBlock(seq.blocks[i], block);
+      --ref_counts_[seq.blocks[i]];
+      seq.blocks[i] = block;
+    }
+    for (size_t i = 0; i < num_new; ++i) {
+      seq.blocks.push_back(PopFreeBlock());
+    }
+    seq.length = length;
+    return true;
+  }
+
+  /*!
+   * \brief Start a sequence sharing the blocks of another one.
+   * \param parent_id The sequence whose positions are the prefix of the new one.
+   * \param child_id The new sequence.
+   */
+  void Fork(int64_t parent_id, int64_t child_id) {
+    auto it = seqs_.find(parent_id);
+    ICHECK(it != seqs_.end()) << "PagedKVCache: sequence " << parent_id << " has no block";
+    ICHECK(!seqs_.count(child_id)) << "PagedKVCache: sequence " << child_id << " exists";
+    Sequence child = it->second;
+    for (int32_t block : child.blocks) {
+      ++ref_counts_[block];
+    }
+    seqs_[child_id] = std::move(child);
+  }
+
+  /*! \brief Return the blocks of a sequence to the pool, as far as no other one shares them. */
+  void Free(int64_t seq_id) {
+    auto it = seqs_.find(seq_id);
+    if (it == seqs_.end()) return;
+    for (auto rit = it->second.blocks.rbegin(); rit != it->second.blocks.rend(); ++rit) {
+      if (--ref_counts_[*rit] == 0) free_blocks_.push_back(*rit);
+    }
+    seqs_.erase(it);
+  }
+
+  /*!
+   * \brief Gather the block tables of a batch.
+   * \param seq_ids The sequences of the batch.
+   * \return The int32 CPU tensor of shape [batch, max_blocks], padded with -1.
+   */
+  NDArray BlockTable(ShapeTuple seq_ids) {
+    size_t max_blocks = 1;
+    for (int64_t seq_id : seq_ids) {
+      auto it = seqs_.find(seq_id);
+      ICHECK(it != seqs_.end()) << "PagedKVCache: sequence " << seq_id << " has no block";
+      max_blocks = std::max(max_blocks, it->second.blocks.size());
+    }
+    int64_t num_seqs = static_cast<int64_t>(seq_ids.size());
+    NDArray table = NDArray::Empty({num_seqs, static_cast<int64_t>(max_blocks)},
+                                   DataType::Int(32), Device{kDLCPU, 0});
+    int32_t* data = static_cast<int32_t*>(table->data);
+    for (int64_t i = 0; i < num_seqs; ++i) {
+      const std::vector<int32_t>& blocks = seqs_[seq_ids[i]].blocks;
+      int32_t* row = data + i * max_blocks;
+      std::copy(blocks.begin(), blocks.end(), row);
+      std::fill(row + blocks.size(), row + max_blocks, -1);
+    }
+    return table;
+  }
+
+  /*! \brief Replace the pool by the one returned by a decoding step. */
+  void SetPool(NDArray pool) {
+    ICHECK(pool.Shape() == pool_.Shape() && pool.DataType() == pool_.DataType())
+        << "PagedKVCache: the new pool must have the shape and the type of the old one";
+    pool_ = pool;
+  }
+
+ private:
+  /*! \brief The blocks of a sequence. */
+  struct Sequence {
+    /*! \brief The blocks, in position order. */
+    std::vector<int32_t> blocks;
+    /*! \brief The number of reserved positions. */
+    int64_t length = 0;
+  };
+
+  int32_t PopFreeBlock() {
+    int32_t block = free_blocks_.back();
+    free_blocks_.pop_back();
+    ref_counts_[block] = 1;
+    return block;
+  }
+
+  void CopyBlock(int32_t from, int32_t to) {
+    const DLTensor& pool = *pool_.operator->();
+    DLTensor src = pool;
+    src.ndim = pool.ndim - 1;
+    src.shape = pool.shape + 1;
+    src.strides = nullptr;
+    size_t block_bytes = GetDataSize(src);
+    src.byte_offset = pool.byte_offset + from * block_bytes;
+    DLTensor dst = src;
+    dst.byte_offset = pool.byte_offset + to * block_bytes;
+    NDArray::CopyFromTo(&src, &dst);
+  }
+
+  /*! \brief The number of positions in a block. */
+  int64_t block_size_;
+  /*! \brief The blocks of all sequences. */
+  NDArray pool_;
+  /*! \brief The number of sequences owning each block. */
+  std::vector<int32_t> ref_counts_;
+  /*! \brief The blocks not owned by any sequence. */
+  std::vector<int32_t> free_blocks_;
+  /*! \brief The sequences holding blocks. */
+  std::unordered_map<int64_t, Sequence> seqs_;
+};
+
+TVM_REGISTER_GLOBAL("runtime._PagedKVCache")
+    .set_body_typed([](int64_t num_blocks, int64_t block_size, ShapeTuple entry_shape,
+                       DLDataType dtype, int device_type, int device_id) {
+      Device dev{static_cast<DLDeviceType>(device_type), device_id};
+      return Module(make_object<PagedKVCache>(num_blocks, block_size, entry_shape, dtype, dev));
+    });
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
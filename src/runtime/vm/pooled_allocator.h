@@ -27,10 +27,17 @@
 #include <tvm/runtime/vm/memory_manager.h>
 
 #include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "../memory_stats.h"
+
 namespace tvm {
 namespace runtime {
 namespace vm {
@@ -38,21 +45,57 @@ namespace vm {
 class PooledAllocator final : public Allocator {
  public:
   static constexpr size_t kDefaultPageSize = 4096;
+  /*! \brief Default bytes a thread may keep cached before returning them to the shared pool. */
+  static constexpr size_t kDefaultThreadCacheBytes = 16 << 20;
 
   explicit PooledAllocator(Device dev, size_t page_size = kDefaultPageSize)
-      : Allocator(kPooled), page_size_(page_size), used_memory_(0), device_(dev) {}
+      : PooledAllocator(dev, page_size, DefaultThreadCacheBytes()) {}
 
-  ~PooledAllocator() { ReleaseAll(); }
+  PooledAllocator(Device dev, size_t page_size, size_t thread_cache_bytes)
+      : Allocator(kPooled),
+        page_size_(page_size),
+        thread_cache_bytes_(thread_cache_bytes),
+        id_(NextId()),
+        used_memory_(0),
+        device_(dev),
+        memory_counter_(MemoryStats::Get(dev, kMemoryVMPooled)) {}
+
+  ~PooledAllocator() {
+    ReleaseAll();
+    // the threads drop the caches of this allocator when they next add a cache
+    std::lock_guard<std::mutex> lock(mu_);
+    for (const auto& cache : thread_caches_) {
+      cache->retired.store(true, std::memory_order_release);
+    }
+  }
 
   Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
-    std::lock_guard<std::recursive_mutex> lock(mu_);
     size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
-    auto&& it = memory_pool_.find(size);
-    if (it != memory_pool_.end() && !it->second.empty()) {
-      auto&& pool = it->second;
-      auto ret = pool.back();
-      pool.pop_back();
-      return ret;
+    if (ThreadCache* cache = GetThreadCache()) {
+      std::lock_guard<std::mutex> lock(cache->mu);
+      auto it = cache->pool.find(size);
+      if (it != cache->pool.end() && !it->second.empty()) {
+        Buffer ret = it->second.back();
+        it->second.pop_back();
+        cache->bytes -= size;
+        ++cache->hits;
+        return ret;
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      auto it = memory_pool_.find(size);
+      if (it == memory_pool_.end() || it->second.empty()) {
+        ReclaimOrphanCaches();
+        it = memory_pool_.find(size);
+      }
+      if (it != memory_pool_.end() && !it->second.empty()) {
+        Buffer ret = it->second.back();
+        it->second.pop_back();
+        ++pool_hits_;
+        return ret;
+      }
+      ++misses_;
     }
     Buffer buf;
     buf.device = device_;
@@ -67,28 +110,142 @@ class PooledAllocator final : public Allocator {
     }
 
     used_memory_.fetch_add(size, std::memory_order_relaxed);
+    memory_counter_->RecordAlloc(size);
     VLOG(1) << "allocate " << size << " B, used memory " << used_memory_ << " B";
     return buf;
   }
 
   void Free(const Buffer& buffer) override {
-    std::lock_guard<std::recursive_mutex> lock(mu_);
-    if (memory_pool_.find(buffer.size) == memory_pool_.end()) {
-      memory_pool_.emplace(buffer.size, std::vector<Buffer>{});
+    if (ThreadCache* cache = GetThreadCache()) {
+      std::unordered_map<size_t, std::vector<Buffer>> flushed;
+      {
+        std::lock_guard<std::mutex> lock(cache->mu);
+        cache->pool[buffer.size].push_back(buffer);
+        cache->bytes += buffer.size;
+        if (cache->bytes <= thread_cache_bytes_) return;
+        // Return the whole cache to the shared pool. The cache lock is released first so
+        // that the lock order is always mu_ before a cache lock.
+        flushed.swap(cache->pool);
+        cache->bytes = 0;
+      }
+      std::lock_guard<std::mutex> lock(mu_);
+      MergeIntoPool(&flushed);
+      VLOG(1) << "return thread cached buffers to the shared pool";
+      return;
     }
-    memory_pool_.at(buffer.size).push_back(buffer);
+    std::lock_guard<std::mutex> lock(mu_);
+    memory_pool_[buffer.size].push_back(buffer);
     VLOG(1) << "reclaim buffer " << buffer.size;
   }
 
   size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
 
+  std::unordered_map<std::string, int64_t> Stats() const override {
+    std::lock_guard<std::mutex> lock(mu_);
+    int64_t thread_cache_hits = retired_cache_hits_;
+    for (const auto& cache : thread_caches_) {
+      std::lock_guard<std::mutex> cache_lock(cache->mu);
+      thread_cache_hits += cache->hits;
+    }
+    return {{"Thread Cache Hits", thread_cache_hits},
+            {"Pool Hits", pool_hits_},
+            {"Misses", misses_}};
+  }
+
+  /*! \return The number of allocators the calling thread holds a cache for. */
+  static size_t NumThreadCaches() { return ThreadCaches().size(); }
+
  private:
+  /*! \brief Buffers freed by one thread, only contended while the allocator flushes caches. */
+  struct ThreadCache {
+    mutable std::mutex mu;
+    std::unordered_map<size_t, std::vector<Buffer>> pool;
+    size_t bytes{0};
+    int64_t hits{0};
+    /*! \brief Whether the allocator is destroyed, the cache then only waits to be dropped. */
+    std::atomic<bool> retired{false};
+  };
+
+  static size_t DefaultThreadCacheBytes() {
+    const char* val = getenv("TVM_VM_POOLED_ALLOCATOR_THREAD_CACHE_BYTES");
+    return val ? std::strtoull(val, nullptr, 10) : kDefaultThreadCacheBytes;
+  }
+
+  static uint64_t NextId() {
+    static std::atomic<uint64_t> next_id{0};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /*!
+   * \brief The caches of the calling thread by allocator id. Keyed by id rather than address so
+   *  a new allocator never picks up a stale entry.
+   */
+  static std::unordered_map<uint64_t, std::shared_ptr<ThreadCache>>& ThreadCaches() {
+    static thread_local std::unordered_map<uint64_t, std::shared_ptr<ThreadCache>> caches;
+    return caches;
+  }
+
+  /*!
+   * \brief Get the cache of the calling thread, creating it on first use.
+   * \return The cache, or nullptr when thread caching is disabled.
+   */
+  ThreadCache* GetThreadCache() {
+    if (thread_cache_bytes_ == 0) return nullptr;
+    auto& caches = ThreadCaches();
+    auto it = caches.find(id_);
+    if (it != caches.end()) return it->second.get();
+    // the caches of the destroyed allocators are dropped before adding one
+    for (it = caches.begin(); it != caches.end();) {
+      if (it->second->retired.load(std::memory_order_acquire)) {
+        it = caches.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    auto cache = std::make_shared<ThreadCache>();
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      thread_caches_.push_back(cache);
+    }
+    caches.emplace(id_, cache);
+    return cache.get();
+  }
+
+  /*! \brief Move buffers into the shared pool, requires mu_. */
+  void MergeIntoPool(std::unordered_map<size_t, std::vector<Buffer>>* buffers) {
+    for (auto& kv : *buffers) {
+      auto& pool = memory_pool_[kv.first];
+      pool.insert(pool.end(), kv.second.begin(), kv.second.end());
+    }
+    buffers->clear();
+  }
+
+  /*! \brief Return the caches of exited threads to the shared pool, requires mu_. */
+  void ReclaimOrphanCaches() {
+    for (size_t i = 0; i < thread_caches_.size();) {
+      if (thread_caches_[i].use_count() == 1) {
+        MergeIntoPool(&thread_caches_[i]->pool);
+        retired_cache_hits_ += thread_caches_[i]->hits;
+        thread_caches_[i] = std::move(thread_caches_.back());
+        thread_caches_.pop_back();
+      } else {
+        ++i;
+      }
+    }
+  }
+
   void ReleaseAll() {
-    std::lock_guard<std::recursive_mutex> lock(mu_);
+    std::lock_guard<std::mutex> lock(mu_);
+    for (const auto& cache : thread_caches_) {
+      std::lock_guard<std::mutex> cache_lock(cache->mu);
+      MergeIntoPool(&cache->pool);
+      cache->bytes = 0;
+    }
     for (auto const& it : memory_pool_) {
       auto const& pool = it.second;
       for (auto const& buf : pool) {
         DeviceAPI::Get(buf.device)->FreeDataSpace(buf.device, buf.data);
+        memory_counter_->RecordFree(buf.size);
       }
     }
     memory_pool_.clear();
@@ -98,10 +255,17 @@ class PooledAllocator final : public Allocator {
 
  private:
   size_t page_size_;
+  size_t thread_cache_bytes_;
+  uint64_t id_;
   std::atomic<size_t> used_memory_;
   std::unordered_map<size_t, std::vector<Buffer> > memory_pool_;
-  std::recursive_mutex mu_;
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;
+  int64_t retired_cache_hits_{0};
+  int64_t pool_hits_{0};
+  int64_t misses_{0};
+  mutable std::mutex mu_;
   Device device_;
+  MemoryCounter* memory_counter_;
 };
 
 }  // namespace vm
@@ -69,12 +69,17 @@ PackedFunc VirtualMachineDebug::GetFunction(const std::string& name,
             invoke(arg_name);
           }
 
+          std::vector<std::unordered_map<std::string, int64_t>> alloc_stats;
+          for (Allocator* allocator : allocators_) {
+            alloc_stats.push_back(allocator ? allocator->Stats()
+                                            : std::unordered_map<std::string, int64_t>());
+          }
           prof_.operator*().Start();
           invoke(arg_name);
           prof_.operator*().Stop();
           auto report = prof_.operator*().Report();
           prof_ = dmlc::optional<profiling::Profiler>();  // releases hardware counters
-          return report;
+          return AddAllocatorStats(report, alloc_stats);
         });
   } else if (name == "profile_rpc") {
     // We cannot return a Report over RPC because TMV RPC mechanism only
@@ -90,6 +95,26 @@ PackedFunc VirtualMachineDebug::GetFunction(const std::string& name,
   }
 }
 
+profiling::Report VirtualMachineDebug::AddAllocatorStats(
+    profiling::Report report,
+    const std::vector<std::unordered_map<std::string, int64_t>>& before) const {
+  Map<String, Map<String, ObjectRef>> device_metrics = report->device_metrics;
+  for (size_t i = 0; i < allocators_.size() && i < before.size(); ++i) {
+    if (allocators_[i] == nullptr) continue;
+    String device_name = profiling::DeviceString(devices_[i]);
+    auto it = device_metrics.find(device_name);
+    if (it == device_metrics.end()) continue;
+    Map<String, ObjectRef> metrics = (*it).second;
+    for (const auto& kv : allocators_[i]->Stats()) {
+      auto prev = before[i].find(kv.first);
+      int64_t delta = kv.second - (prev == before[i].end() ? 0 : prev->second);
+      metrics.Set("Allocator " + kv.first, ObjectRef(make_object<profiling::CountNode>(delta)));
+    }
+    device_metrics.Set(device_name, metrics);
+  }
+  return profiling::Report(report->calls, device_metrics);
+}
+
 void VirtualMachineDebug::LoadExecutable(const Executable* exec) {
   VirtualMachine::LoadExecutable(exec);
   ICHECK(exec_);
@@ -53,6 +53,15 @@ class VirtualMachineDebug : public VirtualMachine {
                     const std::vector<ObjectRef>& args) final;
   void OpStartHook(Instruction instr) final;
   void OpStopHook() final;
+  /*!
+   * \brief Add the allocator counters accumulated since `before` to the device metrics.
+   * \param report The profiling report.
+   * \param before The counters of each allocator in `allocators_` before profiling.
+   * \return The report with an "Allocator ..." metric per counter for each device.
+   */
+  profiling::Report AddAllocatorStats(
+      profiling::Report report,
+      const std::vector<std::unordered_map<std::string, int64_t>>& before) const;
 
   std::unordered_map<Index, std::string> packed_index_map_;
   dmlc::optional<profiling::Profiler> prof_;
@@ -0,0 +1,267 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime/slab_allocator.h
+ * \brief A size class based allocator that reuses, splits and coalesces blocks.
+ */
+#ifndef TVM_RUNTIME_VM_SLAB_ALLOCATOR_H_
+#define TVM_RUNTIME_VM_SLAB_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/vm/memory_manager.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../memory_stats.h"
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief Allocator that caches freed blocks in an ordered free list.
+ *
+ * Requests are rounded up to geometric size classes (four per power of two) so that
+ * dynamically shaped buffers share a bounded set of block sizes. A request is served
+ * by the smallest cached block that fits. On devices whose buffers are plain
+ * addresses, larger blocks are split and the remainder stays cached, and adjacent
+ * free pieces of the same device allocation are coalesced when freed. On other
+ * devices a cached block is only reused when it wastes less than half of itself.
+ *
+ * When the cached bytes exceed max_cached_bytes (0 means no limit), fully free
+ * device allocations are released, largest first.
+ */
+class SlabAllocator final : public Allocator {
+ public:
+  static constexpr size_t kDefaultPageSize = 4096;
+  static constexpr size_t kClassesPerDoubling = 4;
+
+  explicit SlabAllocator(Device dev, size_t max_cached_bytes = 0,
+                         size_t page_size = kDefaultPageSize)
+      : Allocator(kSlab),
+        page_size_(page_size),
+        max_cached_bytes_(max_cached_bytes),
+        used_memory_(0),
+        device_(dev),
+        memory_counter_(MemoryStats::Get(dev, kMemoryVMSlab)),
+        splittable_(IsAddressable(dev)) {}
+
+  ~SlabAllocator() {
+    std::lock_guard<std::mutex> lock(mu_);
+    ReleaseFreeChunks(0);
+  }
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    size_t size = RoundUp(nbytes);
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      if (Block* block = FindFreeBlock(size, alignment)) {
+        return MakeBuffer(block);
+      }
+    }
+    void* data = nullptr;
+    try {
+      data = DeviceAPI::Get(device_)->AllocDataSpace(device_, size, alignment, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "SlabAllocator got InternalError during allocation: " << err.message();
+      LOG(WARNING) << "Trying to release all unused memory and reallocate...";
+      {
+        std::lock_guard<std::mutex> lock(mu_);
+        ReleaseFreeChunks(0);
+      }
+      data = DeviceAPI::Get(device_)->AllocDataSpace(device_, size, alignment, type_hint);
+    }
+    used_memory_.fetch_add(size, std::memory_order_relaxed);
+    memory_counter_->RecordAlloc(size);
+    VLOG(1) << "allocate " << size << " B, used memory " << used_memory_ << " B";
+
+    std::lock_guard<std::mutex> lock(mu_);
+    Block* block = new Block();
+    block->data = data;
+    block->size = size;
+    return MakeBuffer(block);
+  }
+
+  void Free(const Buffer& buffer) override {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = live_blocks_.find(buffer.data);
+    ICHECK(it != live_blocks_.end()) << "Freeing a buffer not allocated by this allocator";
+    Block* block = it->second;
+    live_blocks_.erase(it);
+    // Merge with the free neighbours of the same device allocation.
+    if (block->next != nullptr && block->next->is_free) {
+      Block* next = block->next;
+      EraseFree(next);
+      block->size += next->size;
+      Unlink(next);
+    }
+    if (block->prev != nullptr && block->prev->is_free) {
+      Block* prev = block->prev;
+      EraseFree(prev);
+      prev->size += block->size;
+      Unlink(block);
+      block = prev;
+    }
+    InsertFree(block);
+    VLOG(1) << "reclaim buffer " << buffer.size << ", cached " << cached_bytes_ << " B";
+    if (max_cached_bytes_ != 0 && cached_bytes_ > max_cached_bytes_) {
+      ReleaseFreeChunks(max_cached_bytes_);
+    }
+  }
+
+  size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
+
+  /*! \return The bytes held in freed blocks that are ready for reuse. */
+  size_t CachedMemory() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return cached_bytes_;
+  }
+
+  /*!
+   * \brief Round a request up to its size class.
+   * \param nbytes The requested size.
+   * \return The size of the block serving the request.
+   */
+  size_t RoundUp(size_t nbytes) const {
+    size_t size = std::max(nbytes, page_size_);
+    size_t base = 1;
+    while ((base << 1) <= size) base <<= 1;
+    size_t step = std::max<size_t>(base / kClassesPerDoubling, 1);
+    size = (size + step - 1) / step * step;
+    return (size + page_size_ - 1) / page_size_ * page_size_;
+  }
+
+ private:
+  /*! \brief A piece of a device allocation, linked with its neighbours in address order. */
+  struct Block {
+    void* data{nullptr};
+    size_t size{0};
+    bool is_free{false};
+    Block* prev{nullptr};
+    Block* next{nullptr};
+    std::multimap<size_t, Block*>::iterator free_it;
+  };
+
+  static bool IsAddressable(Device dev) {
+    switch (static_cast<int>(dev.device_type)) {
+      case kDLCPU:
+      case kDLCUDA:
+      case kDLCUDAHost:
+      case kDLCUDAManaged:
+      case kDLROCM:
+      case kDLROCMHost:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  Buffer MakeBuffer(Block* block) {
+    live_blocks_.emplace(block->data, block);
+    Buffer buf;
+    buf.device = device_;
+    buf.data = block->data;
+    buf.size = block->size;
+    return buf;
+  }
+
+  /*! \brief Take the best fitting cached block for size, splitting off any remainder. */
+  Block* FindFreeBlock(size_t size, size_t alignment) {
+    for (auto it = free_blocks_.lower_bound(size); it != free_blocks_.end(); ++it) {
+      Block* block = it->second;
+      if (!splittable_ && block->size > 2 * size) return nullptr;
+      if (reinterpret_cast<uintptr_t>(block->data) % alignment != 0) continue;
+      EraseFree(block);
+      if (splittable_ && block->size - size >= page_size_) {
+        Block* rest = new Block();
+        rest->data = static_cast<char*>(block->data) + size;
+        rest->size = block->size - size;
+        rest->prev = block;
+        rest->next = block->next;
+        if (block->next != nullptr) block->next->prev = rest;
+        block->next = rest;
+        block->size = size;
+        InsertFree(rest);
+      }
+      return block;
+    }
+    return nullptr;
+  }
+
+  void InsertFree(Block* block) {
+    block->is_free = true;
+    block->free_it = free_blocks_.emplace(block->size, block);
+    cached_bytes_ += block->size;
+  }
+
+  void EraseFree(Block* block) {
+    free_blocks_.erase(block->free_it);
+    block->is_free = false;
+    cached_bytes_ -= block->size;
+  }
+
+  /*! \brief Unlink a block that has been merged into a neighbour and delete it. */
+  void Unlink(Block* block) {
+    if (block->prev != nullptr) block->prev->next = block->next;
+    if (block->next != nullptr) block->next->prev = block->prev;
+    delete block;
+  }
+
+  /*! \brief Release fully free device allocations until at most limit bytes are cached. */
+  void ReleaseFreeChunks(size_t limit) {
+    auto it = free_blocks_.end();
+    while (cached_bytes_ > limit && it != free_blocks_.begin()) {
+      --it;
+      Block* block = it->second;
+      if (block->prev != nullptr || block->next != nullptr) continue;
+      DeviceAPI::Get(device_)->FreeDataSpace(device_, block->data);
+      used_memory_.fetch_sub(block->size, std::memory_order_relaxed);
+      memory_counter_->RecordFree(block->size);
+      cached_bytes_ -= block->size;
+      it = free_blocks_.erase(it);
+      delete block;
+    }
+    VLOG(1) << "release free buffers, used memory " << used_memory_ << " B";
+  }
+
+  size_t page_size_;
+  size_t max_cached_bytes_;
+  std::atomic<size_t> used_memory_;
+  size_t cached_bytes_{0};
+  Device device_;
+  MemoryCounter* memory_counter_;
+  bool splittable_;
+  std::multimap<size_t, Block*> free_blocks_;
+  std::unordered_map<void*, Block*> live_blocks_;
+  mutable std::mutex mu_;
+};
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_VM_SLAB_ALLOCATOR_H_
@@ -31,11 +31,25 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../file_utils.h"
+#include "../library_module.h"
+
+/*! \brief Whether the dispatch loop may use labels as values (a GNU extension). */
+#ifndef TVM_VM_COMPUTED_GOTO
+#if defined(__GNUC__) || defined(__clang__)
+#define TVM_VM_COMPUTED_GOTO 1
+#else
+#define TVM_VM_COMPUTED_GOTO 0
+#endif
+#endif
 
 using namespace tvm::runtime;
 
@@ -128,7 +142,7 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
       auto git = exec_->global_map.find(func_name);
       ICHECK(git != exec_->global_map.end())
           << "Cannot find function " << func_name << " in the executable";
-      auto func = exec_->functions[git->second];
+      const auto& func = exec_->functions[git->second];
       if (func.params.empty()) {
         *rv = Invoke(func, {});
       } else {
@@ -219,6 +233,9 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
   } else if (name == "set_input") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { SetInput(args[0], args, 1); });
+  } else if (name == "set_storage_arena") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { SetStorageArena(args[0]); });
   } else {
     LOG(FATAL) << "Unknown packed function: " << name;
     return PackedFunc([sptr_to_self, name](TVMArgs args, TVMRetValue* rv) {});
@@ -271,6 +288,32 @@ inline Allocator* VirtualMachine::GetAllocator(Index device_index) const {
 
 void VirtualMachine::PushFrame(Index arg_count, Index ret_pc, const VMFunction& vm_func) {
   auto frame = VMFrame(ret_pc, func_index_, arg_count, code_, vm_func.register_file_size);
+  if (!storage_plans_.empty()) {
+    // Callers may pass a copy of the function rather than the entry in the table.
+    const VMFunction* begin = exec_->functions.data();
+    const VMFunction* end = begin + exec_->functions.size();
+    std::less<const VMFunction*> less;
+    size_t func_index = !less(&vm_func, begin) && less(&vm_func, end)
+                            ? static_cast<size_t>(&vm_func - begin)
+                            : static_cast<size_t>(exec_->global_map.at(vm_func.name));
+    ICHECK_LT(func_index, storage_plans_.size());
+    StaticStoragePlan& plan = storage_plans_[func_index];
+    frame.storage_plan = &plan;
+    frame.storage_arenas.resize(plan.arena_bytes.size());
+    for (size_t i = 0; i < plan.arena_bytes.size(); ++i) {
+      if (plan.arena_bytes[i] == 0) continue;
+      // Reuse the previous arena unless storage carved out of it is still alive, for
+      // example outputs of the last invocation or an enclosing recursive frame.
+      ObjectRef& arena = plan.arena_cache[i];
+      if (!arena.defined() || !arena.unique()) {
+        Allocator* allocator = GetAllocator(i);
+        ICHECK(allocator) << "Did you forget to init the VirtualMachine with devices?";
+        arena = Storage(allocator->Alloc(plan.arena_bytes[i], plan.arena_alignment[i],
+                                         DataType::UInt(8)));
+      }
+      frame.storage_arenas[i] = arena;
+    }
+  }
   frames_.push_back(frame);
 }
 
@@ -306,6 +349,8 @@ ObjectRef VirtualMachine::Invoke(const VMFunction& func, const std::vector<Objec
                << (i == exec_->host_device_index ? " (using as host device)" : "");
   }
 
+  // Drop the previous result first so that it does not pin the storage arenas.
+  return_register_ = ObjectRef();
   InvokeGlobal(func, args);
   RunLoop();
   return return_register_;
@@ -320,6 +365,75 @@ ObjectRef VirtualMachine::Invoke(const std::string& name, const std::vector<Obje
   return Invoke(exec_->functions[func_index], args);
 }
 
+/*! \brief The number of memoized calls of a shape function, beyond which they are dropped. */
+constexpr size_t kMaxShapeFuncCacheEntries = 256;
+/*! \brief Shape functions of larger inputs, which read data and not shapes, are not memoized. */
+constexpr size_t kMaxShapeFuncKeyBytes = 4096;
+
+/*! \brief Append the data of a compact host tensor to \p out, false for the other tensors. */
+static bool AppendTensorData(const DLTensor* tensor, std::string* out) {
+  if (tensor->device.device_type != kDLCPU || !IsContiguous(*tensor)) return false;
+  out->append(static_cast<const char*>(tensor->data) + tensor->byte_offset,
+              GetDataSize(*tensor));
+  return true;
+}
+
+/*!
+ * \brief Compute the key of the inputs of a shape function call, from their types, shapes and
+ *  data. Return false when they can not be memoized.
+ */
+static bool ShapeFuncKey(const TVMValue* values, const int* codes, size_t num_inputs,
+                         std::string* key) {
+  for (size_t i = 0; i < num_inputs; ++i) {
+    if (codes[i] != kTVMNDArrayHandle && codes[i] != kTVMDLTensorHandle) return false;
+    const auto* tensor = static_cast<const DLTensor*>(values[i].v_handle);
+    int32_t header[2] = {tensor->ndim, static_cast<int32_t>(tensor->dtype.code |
+                                                            (tensor->dtype.bits << 8) |
+                                                            (tensor->dtype.lanes << 16))};
+    key->append(reinterpret_cast<const char*>(header), sizeof(header));
+    key->append(reinterpret_cast<const char*>(tensor->shape), tensor->ndim * sizeof(int64_t));
+    if (key->size() + GetDataSize(*tensor) > kMaxShapeFuncKeyBytes) return false;
+    if (!AppendTensorData(tensor, key)) return false;
+  }
+  return true;
+}
+
+/*! \brief Copy the memoized outputs of a shape function, false when they do not fit. */
+static bool CopyShapeFuncOutputs(const std::string& data, const TVMValue* outputs,
+                                 size_t num_outputs) {
+  size_t offset = 0;
+  for (size_t i = 0; i < num_outputs; ++i) {
+    const auto* tensor = static_cast<const DLTensor*>(outputs[i].v_handle);
+    size_t nbytes = GetDataSize(*tensor);
+    if (tensor->device.device_type != kDLCPU || !IsContiguous(*tensor) ||
+        offset + nbytes > data.size()) {
+      return false;
+    }
+    std::memcpy(static_cast<char*>(tensor->data) + tensor->byte_offset, data.data() + offset,
+                nbytes);
+    offset += nbytes;
+  }
+  return offset == data.size();
+}
+
+/*!
+ * \brief Mark the buffers kept by the VM to reuse their storage as in use for a scope, so that a
+ *  packed function reentering the VM meanwhile uses buffers of its own.
+ */
+class ReusedBuffersScope {
+ public:
+  /*! \param in_use The flag of the buffers, nullptr when they were already in use. */
+  explicit ReusedBuffersScope(bool* in_use) : in_use_(in_use) {
+    if (in_use_ != nullptr) *in_use_ = true;
+  }
+  ~ReusedBuffersScope() {
+    if (in_use_ != nullptr) *in_use_ = false;
+  }
+
+ private:
+  bool* in_use_;
+};
+
 void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func, Index arg_count,
                                   Index output_size, const std::vector<ObjectRef>& args) {
   size_t arity = 0;
@@ -331,8 +445,15 @@ void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func, In
     }
   }
 
-  std::vector<TVMValue> values(arity);
-  std::vector<int> codes(arity);
+  bool reuse = !packed_values_in_use_;
+  ReusedBuffersScope reused_scope(reuse ? &packed_values_in_use_ : nullptr);
+  std::vector<TVMValue> local_values;
+  std::vector<int> local_codes;
+  std::string local_shape_func_key;
+  std::vector<TVMValue>& values = reuse ? packed_values_ : local_values;
+  std::vector<int>& codes = reuse ? packed_codes_ : local_codes;
+  values.resize(arity);
+  codes.resize(arity);
   runtime::TVMArgsSetter setter(values.data(), codes.data());
   int idx = 0;
   bool is_empty_output = false;
@@ -359,10 +480,51 @@ void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func, In
     }
   }
 
-  if (!is_empty_output) {
+  if (is_empty_output) return;
+
+  // Serving repeats the same input shapes, so the outputs of a shape function are copied from
+  // the previous call on the same inputs when there is one.
+  std::string& shape_func_key = reuse ? shape_func_key_ : local_shape_func_key;
+  shape_func_key.clear();
+  bool memoize = static_cast<size_t>(packed_index) < is_shape_func_.size() &&
+                 is_shape_func_[packed_index] &&
+                 ShapeFuncKey(values.data(), codes.data(), arity - output_size, &shape_func_key);
+  std::unordered_map<std::string, std::string>* memo = nullptr;
+  if (memoize) {
+    memo = &shape_func_cache_[packed_index];
+    auto it = memo->find(shape_func_key);
+    if (it != memo->end() &&
+        CopyShapeFuncOutputs(it->second, values.data() + arity - output_size, output_size)) {
+      return;
+    }
+  }
+
+  TVMBackendPackedCFunc faddr = static_cast<size_t>(packed_index) < packed_cfuncs_.size()
+                                    ? packed_cfuncs_[packed_index]
+                                    : nullptr;
+  if (faddr != nullptr) {
+    // the kernels of library modules are called directly, without the PackedFunc wrappers
+    TVMValue ret_value;
+    int ret_type_code = kTVMNullptr;
+    int ret = (*faddr)(values.data(), codes.data(), static_cast<int>(arity), &ret_value,
+                       &ret_type_code, nullptr);
+    ICHECK_EQ(ret, 0) << TVMGetLastError();
+  } else {
     TVMRetValue rv;
     func.CallPacked(TVMArgs(values.data(), codes.data(), arity), &rv);
   }
+
+  if (memo != nullptr) {
+    std::string outputs;
+    for (size_t i = arity - output_size; i < arity; ++i) {
+      const auto* tensor = static_cast<const DLTensor*>(values[i].v_handle);
+      if (!AppendTensorData(tensor, &outputs)) return;
+    }
+    if (memo->size() >= kMaxShapeFuncCacheEntries) {
+      memo->clear();
+    }
+    (*memo)[shape_func_key] = std::move(outputs);
+  }
 }
 
 void VirtualMachine::LoadExecutable(const Executable* exec) {
@@ -385,8 +547,104 @@ void VirtualMachine::LoadExecutable(const Executable* exec) {
     ICHECK(pf != nullptr) << "Cannot find function in module: " << packed_name;
     packed_funcs_[packed_index] = pf;
   }
+  packed_cfuncs_.clear();
   for (size_t i = 0; i < packed_funcs_.size(); ++i) {
     ICHECK(packed_funcs_[i] != nullptr) << "Packed function " << i << " is not initialized";
+    packed_cfuncs_.push_back(GetBackendPackedCFunc(packed_funcs_[i]));
+  }
+  is_shape_func_.assign(packed_funcs_.size(), false);
+  for (const auto& it : exec_->op_attrs) {
+    if (static_cast<size_t>(it.first) < is_shape_func_.size() &&
+        it.second.count(kShapeFuncAttr)) {
+      is_shape_func_[it.first] = true;
+    }
+  }
+  shape_func_cache_.clear();
+  storage_plans_.clear();
+  consti_pool_.clear();
+}
+
+void VirtualMachine::SetStorageArena(bool enable) {
+  use_storage_arena_ = enable;
+  PlanStaticStorage();
+}
+
+/*! \brief Whether buffers on the device are addresses that may be offset on the host. */
+static bool IsAddressableDevice(Device dev) {
+  switch (static_cast<int>(dev.device_type)) {
+    case kDLCPU:
+    case kDLCUDA:
+    case kDLCUDAHost:
+    case kDLCUDAManaged:
+    case kDLROCM:
+    case kDLROCMHost:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void VirtualMachine::PlanStaticStorage() {
+  storage_plans_.clear();
+  if (!use_storage_arena_ || exec_ == nullptr || devices_.empty()) return;
+  storage_plans_.resize(exec_->functions.size());
+  for (size_t func_index = 0; func_index < exec_->functions.size(); ++func_index) {
+    const VMFunction& func = exec_->functions[func_index];
+    StaticStoragePlan& plan = storage_plans_[func_index];
+    // An allocation size is static when its register is only ever written by a load of
+    // an integer scalar constant.
+    std::unordered_map<RegName, int> num_writes;
+    std::unordered_map<RegName, Index> consts;
+    for (const Instruction& instr : func.instructions) {
+      switch (instr.op) {
+        case Opcode::Ret:
+        case Opcode::Fatal:
+        case Opcode::Goto:
+        case Opcode::If:
+        case Opcode::InvokePacked:
+          break;
+        case Opcode::LoadConsti:
+          consts[instr.dst] = instr.load_consti.val;
+          num_writes[instr.dst]++;
+          break;
+        case Opcode::LoadConst: {
+          const auto* array = exec_->constants[instr.const_index].as<NDArray::Container>();
+          if (array != nullptr && array->dl_tensor.device.device_type == kDLCPU &&
+              array->dl_tensor.dtype.code == kDLInt && array->dl_tensor.dtype.bits == 64 &&
+              array->dl_tensor.dtype.lanes == 1 &&
+              GetDataSize(array->dl_tensor) == sizeof(int64_t)) {
+            const char* data = static_cast<const char*>(array->dl_tensor.data);
+            consts[instr.dst] =
+                *reinterpret_cast<const int64_t*>(data + array->dl_tensor.byte_offset);
+          }
+          num_writes[instr.dst]++;
+          break;
+        }
+        default:
+          num_writes[instr.dst]++;
+          break;
+      }
+    }
+    plan.slots.assign(func.instructions.size(), std::make_pair(Index(-1), size_t(0)));
+    plan.arena_bytes.assign(devices_.size(), 0);
+    plan.arena_alignment.assign(devices_.size(), 1);
+    plan.arena_cache.assign(devices_.size(), ObjectRef());
+    for (size_t pc = 0; pc < func.instructions.size(); ++pc) {
+      const Instruction& instr = func.instructions[pc];
+      if (instr.op != Opcode::AllocStorage) continue;
+      RegName size_reg = instr.alloc_storage.allocation_size;
+      auto it = consts.find(size_reg);
+      if (it == consts.end() || num_writes[size_reg] != 1) continue;
+      Index device_index = instr.alloc_storage.device_index;
+      if (!IsAddressableDevice(GetDevice(device_index))) continue;
+      size_t alignment = std::max<size_t>(instr.alloc_storage.alignment, 1);
+      size_t& arena_bytes = plan.arena_bytes[device_index];
+      size_t offset = (arena_bytes + alignment - 1) / alignment * alignment;
+      plan.slots[pc] = std::make_pair(device_index, offset);
+      arena_bytes = offset + static_cast<size_t>(it->second);
+      plan.arena_alignment[device_index] =
+          std::max(plan.arena_alignment[device_index], alignment);
+    }
   }
 }
 
@@ -416,42 +674,80 @@ void VirtualMachine::Init(const std::vector<Device>& physical_devices,
     devices_.push_back(*itr);
     allocators_.push_back(MemoryManager::GetOrCreateAllocator(*itr, alloc_types[i]));
   }
+  consti_pool_.clear();
+  PlanStaticStorage();
+  UploadConstants();
+}
+
+void VirtualMachine::UploadConstants() {
+  const_pool_.assign(exec_->constants.size(), ObjectRef());
+  std::vector<NDArray> src, dst;
+  for (size_t i = 0; i < exec_->constants.size(); ++i) {
+    // late bound constants are undefined until they are loaded
+    const auto* array = exec_->constants[i].as<NDArray::Container>();
+    if (array == nullptr || i >= exec_->const_device_indexes.size()) continue;
+    NDArray constant = GetRef<NDArray>(array);
+    Device dev = GetDevice(exec_->const_device_indexes[i]);
+    if (constant->device.device_type == dev.device_type) {
+      const_pool_[i] = constant;
+      continue;
+    }
+    src.push_back(constant);
+    dst.push_back(NDArray::Empty(constant.Shape(), constant.DataType(), dev));
+    const_pool_[i] = dst.back();
+  }
+  UploadParams(src, dst);
 }
 
 inline void VirtualMachine::WriteRegister(Index r, const ObjectRef& val) {
   frames_.back().register_file[r] = val;
 }
 
-ObjectRef VirtualMachine::ReadRegister(Index r) const { return frames_.back().register_file[r]; }
+inline void VirtualMachine::WriteRegister(Index r, ObjectRef&& val) {
+  frames_.back().register_file[r] = std::move(val);
+}
+
+const ObjectRef& VirtualMachine::ReadRegister(Index r) const {
+  return frames_.back().register_file[r];
+}
 
 int64_t VirtualMachine::LoadScalarInt(Index r) const {
   int64_t result = 0;
   const auto& obj = ReadRegister(r);
-  NDArray array = Downcast<NDArray>(CopyTo(obj, GetDevice(exec_->host_device_index)));
+  // Scalars almost always live on the host already, read them in place.
+  NDArray copy;
+  const auto* container = obj.as<NDArray::Container>();
+  if (container == nullptr ||
+      container->dl_tensor.device.device_type != GetDevice(exec_->host_device_index).device_type) {
+    copy = Downcast<NDArray>(CopyTo(obj, GetDevice(exec_->host_device_index)));
+    container = static_cast<const NDArray::Container*>(copy.get());
+  }
+  const DLTensor& array = container->dl_tensor;
+  const void* data = static_cast<const char*>(array.data) + array.byte_offset;
 
-  switch (array->dtype.bits) {
+  switch (array.dtype.bits) {
     case 1: {
-      result = reinterpret_cast<bool*>(array->data)[0];
+      result = reinterpret_cast<const bool*>(data)[0];
       break;
     }
     case 8: {
-      result = reinterpret_cast<int8_t*>(array->data)[0];
+      result = reinterpret_cast<const int8_t*>(data)[0];
       break;
     }
     case 16: {
-      result = reinterpret_cast<int16_t*>(array->data)[0];
+      result = reinterpret_cast<const int16_t*>(data)[0];
       break;
     }
     case 32: {
-      result = reinterpret_cast<int32_t*>(array->data)[0];
+      result = reinterpret_cast<const int32_t*>(data)[0];
       break;
     }
     case 64: {
-      result = reinterpret_cast<int64_t*>(array->data)[0];
+      result = reinterpret_cast<const int64_t*>(data)[0];
       break;
     }
     default:
-      LOG(FATAL) << "Unknown scalar int type: " << DLDataType2String(array->dtype);
+      LOG(FATAL) << "Unknown scalar int type: " << DLDataType2String(array.dtype);
   }
   return result;
 }
@@ -461,142 +757,178 @@ void VirtualMachine::RunLoop() {
   ICHECK(this->code_);
   pc_ = 0;
   Index frame_start = frames_.size();
+  const Instruction* instr = nullptr;
+#if TVM_VM_COMPUTED_GOTO
+  // Jump straight to the next handler instead of through the switch, which gives the branch
+  // predictor one indirect jump per handler. Indexed by Opcode, keep in sync with bytecode.h.
+  // A computed goto does not run destructors, so handlers dispatch only after their scope
+  // has closed.
+  static const void* const kDispatchTable[] = {
+      &&op_Move,         &&op_Ret,           &&op_Invoke,         &&op_InvokeClosure,
+      &&op_InvokePacked, &&op_AllocTensor,   &&op_AllocTensorReg, &&op_AllocADT,
+      &&op_AllocClosure, &&op_GetField,      &&op_If,             &&op_LoadConst,
+      &&op_Goto,         &&op_GetTag,        &&op_LoadConsti,     &&op_Fatal,
+      &&op_AllocStorage, &&op_ShapeOf,       &&op_ReshapeTensor,  &&op_DeviceCopy};
+  constexpr size_t kNumOpcodes = sizeof(kDispatchTable) / sizeof(kDispatchTable[0]);
+#define VM_DISPATCH()                                                    \
+  do {                                                                   \
+    instr = &code_[pc_];                                                 \
+    VLOG(2) << "Executing(" << pc_ << "): " << *instr;                   \
+    if (static_cast<size_t>(instr->op) >= kNumOpcodes) goto unknown_op; \
+    goto* kDispatchTable[static_cast<size_t>(instr->op)];                \
+  } while (0)
+#define VM_CASE(name) \
+  case Opcode::name:  \
+  op_##name
+#else
+#define VM_DISPATCH() goto main_loop
+#define VM_CASE(name) case Opcode::name
+#endif
   while (true) {
   main_loop:
-    auto const& instr = code_[this->pc_];
-    VLOG(2) << "Executing(" << pc_ << "): " << instr;
-
-    switch (instr.op) {
-      case Opcode::Move: {
-        ObjectRef from_obj;
-        from_obj = ReadRegister(instr.from);
-        WriteRegister(instr.dst, from_obj);
+    instr = &code_[this->pc_];
+    VLOG(2) << "Executing(" << pc_ << "): " << *instr;
+
+    switch (instr->op) {
+      VM_CASE(Move): {
+        WriteRegister(instr->dst, ReadRegister(instr->from));
         pc_++;
-        goto main_loop;
       }
-      case Opcode::Fatal: {
+      VM_DISPATCH();
+      VM_CASE(Fatal): {
         throw std::runtime_error("VM encountered fatal error");
       }
-      case Opcode::LoadConst: {
-        bool is_not_cached = const_pool_.size() <= static_cast<size_t>(instr.const_index) ||
-                             !const_pool_[instr.const_index].defined();
+      VM_CASE(LoadConst): {
+        bool is_not_cached = const_pool_.size() <= static_cast<size_t>(instr->const_index) ||
+                             !const_pool_[instr->const_index].defined();
         if (is_not_cached) {
-          OpStartHook(instr);
+          OpStartHook(*instr);
         }
-        auto constant_obj = exec_->constants[instr.const_index];
+        auto constant_obj = exec_->constants[instr->const_index];
         // We cache the allocated object in the constant pool. To measure, the
         // first iteration will set the pool up. The other iterations will
         // directly reuse the allocated objects.
-        if (const_pool_.size() <= static_cast<size_t>(instr.const_index)) {
-          const_pool_.resize(instr.const_index + 1);
+        if (const_pool_.size() <= static_cast<size_t>(instr->const_index)) {
+          const_pool_.resize(instr->const_index + 1);
         }
 
-        if (!const_pool_[instr.const_index].defined()) {
-          Device dev = GetDevice(exec_->const_device_indexes[instr.const_index]);
-          const_pool_[instr.const_index] = CopyTo(constant_obj, dev);
+        if (!const_pool_[instr->const_index].defined()) {
+          Device dev = GetDevice(exec_->const_device_indexes[instr->const_index]);
+          const_pool_[instr->const_index] = CopyTo(constant_obj, dev);
         }
-        WriteRegister(instr.dst, const_pool_[instr.const_index]);
+        WriteRegister(instr->dst, const_pool_[instr->const_index]);
         if (is_not_cached) {
           OpStopHook();
         }
         pc_++;
-        goto main_loop;
       }
-      case Opcode::LoadConsti: {
-        auto tensor = NDArray::Empty({1}, {kDLInt, 64, 1}, GetDevice(exec_->host_device_index));
-        reinterpret_cast<int64_t*>(tensor->data)[0] = instr.load_consti.val;
-        WriteRegister(instr.dst, tensor);
+      VM_DISPATCH();
+      VM_CASE(LoadConsti): {
+        // The scalar is only ever read, so one tensor per value is shared like LoadConst does.
+        NDArray& tensor = consti_pool_[instr->load_consti.val];
+        if (!tensor.defined()) {
+          tensor = NDArray::Empty({1}, {kDLInt, 64, 1}, GetDevice(exec_->host_device_index));
+          reinterpret_cast<int64_t*>(tensor->data)[0] = instr->load_consti.val;
+        }
+        WriteRegister(instr->dst, tensor);
         pc_++;
-        goto main_loop;
       }
-      case Opcode::Invoke: {
+      VM_DISPATCH();
+      VM_CASE(Invoke): {
         std::vector<ObjectRef> args;
-        for (Index i = 0; i < instr.num_args; ++i) {
-          args.push_back(ReadRegister(instr.invoke_args_registers[i]));
+        args.reserve(instr->num_args);
+        for (Index i = 0; i < instr->num_args; ++i) {
+          args.push_back(ReadRegister(instr->invoke_args_registers[i]));
         }
-        InvokeGlobal(exec_->functions[instr.func_index], args);
-        frames_.back().caller_return_register = instr.dst;
-        goto main_loop;
+        InvokeGlobal(exec_->functions[instr->func_index], args);
+        frames_.back().caller_return_register = instr->dst;
       }
-      case Opcode::InvokePacked: {
-        VLOG(2) << "InvokedPacked " << instr.packed_index << " arity=" << instr.arity;
-        ICHECK_LE(instr.packed_index, packed_funcs_.size());
-        const auto& func = packed_funcs_[instr.packed_index];
-        const auto& arity = instr.arity;
-        std::vector<ObjectRef> args;
+      VM_DISPATCH();
+      VM_CASE(InvokePacked): {
+        VLOG(2) << "InvokedPacked " << instr->packed_index << " arity=" << instr->arity;
+        ICHECK_LE(instr->packed_index, packed_funcs_.size());
+        const auto& func = packed_funcs_[instr->packed_index];
+        const auto& arity = instr->arity;
+        // The argument list is reused by the calls, so that it keeps its capacity, unless a
+        // packed function reentering the VM is still using it.
+        bool reuse = !packed_args_in_use_;
+        ReusedBuffersScope reused_scope(reuse ? &packed_args_in_use_ : nullptr);
+        std::vector<ObjectRef> local_args;
+        std::vector<ObjectRef>& args = reuse ? packed_args_ : local_args;
+        args.clear();
         for (Index i = 0; i < arity; ++i) {
-          VLOG(2) << "arg" << i << " $" << instr.packed_args[i];
-          auto arg = ReadRegister(instr.packed_args[i]);
-          args.push_back(arg);
+          VLOG(2) << "arg" << i << " $" << instr->packed_args[i];
+          args.push_back(ReadRegister(instr->packed_args[i]));
         }
 
         // We no longer need to write the registers back, we write directly
         // through the registers mutably.
-        InvokePacked(instr.packed_index, func, arity, instr.output_size, args);
+        InvokePacked(instr->packed_index, func, arity, instr->output_size, args);
+        // Do not keep the arguments alive until the next call.
+        args.clear();
         pc_++;
-        goto main_loop;
       }
-      case Opcode::InvokeClosure: {
-        auto object = ReadRegister(instr.closure);
-        const auto* closure = object.as<VMClosureObj>();
+      VM_DISPATCH();
+      VM_CASE(InvokeClosure): {
+        const auto* closure = ReadRegister(instr->closure).as<VMClosureObj>();
         ICHECK(closure);
         std::vector<ObjectRef> args;
-        for (auto free_var : closure->free_vars) {
+        args.reserve(closure->free_vars.size() + instr->num_closure_args);
+        for (const auto& free_var : closure->free_vars) {
           args.push_back(free_var);
         }
-        for (Index i = 0; i < instr.num_closure_args; ++i) {
-          args.push_back(ReadRegister(instr.closure_args[i]));
+        for (Index i = 0; i < instr->num_closure_args; ++i) {
+          args.push_back(ReadRegister(instr->closure_args[i]));
         }
         InvokeGlobal(exec_->functions[closure->func_index], args);
-        frames_.back().caller_return_register = instr.dst;
-        goto main_loop;
+        frames_.back().caller_return_register = instr->dst;
       }
-      case Opcode::GetField: {
-        auto object = ReadRegister(instr.object);
-        const auto& tuple = Downcast<ADT>(object);
-        auto field = tuple[instr.field_index];
-        WriteRegister(instr.dst, field);
+      VM_DISPATCH();
+      VM_CASE(GetField): {
+        const auto* tuple = ReadRegister(instr->object).as<ADTObj>();
+        ICHECK(tuple) << "GetField expects an ADT";
+        WriteRegister(instr->dst, (*tuple)[instr->field_index]);
         pc_++;
-        goto main_loop;
       }
-      case Opcode::GetTag: {
-        auto object = ReadRegister(instr.get_tag.object);
-        const auto& adt = Downcast<ADT>(object);
-        auto tag = adt.tag();
+      VM_DISPATCH();
+      VM_CASE(GetTag): {
+        const auto* adt = ReadRegister(instr->get_tag.object).as<ADTObj>();
+        ICHECK(adt) << "GetTag expects an ADT";
+        auto tag = adt->tag;
         auto tag_tensor = NDArray::Empty({1}, {kDLInt, 32, 1}, GetDevice(exec_->host_device_index));
         reinterpret_cast<int32_t*>(tag_tensor->data)[0] = tag;
-        WriteRegister(instr.dst, tag_tensor);
+        WriteRegister(instr->dst, tag_tensor);
         pc_++;
-        goto main_loop;
       }
-      case Opcode::Goto: {
-        pc_ += instr.pc_offset;
-        goto main_loop;
+      VM_DISPATCH();
+      VM_CASE(Goto): {
+        pc_ += instr->pc_offset;
       }
-      case Opcode::If: {
-        int32_t test_val = LoadScalarInt(instr.if_op.test);
-        int32_t target_val = LoadScalarInt(instr.if_op.target);
+      VM_DISPATCH();
+      VM_CASE(If): {
+        int32_t test_val = LoadScalarInt(instr->if_op.test);
+        int32_t target_val = LoadScalarInt(instr->if_op.target);
 
         if (test_val == target_val) {
-          ICHECK_NE(instr.if_op.true_offset, 0);
-          pc_ += instr.if_op.true_offset;
+          ICHECK_NE(instr->if_op.true_offset, 0);
+          pc_ += instr->if_op.true_offset;
         } else {
-          ICHECK_NE(instr.if_op.false_offset, 0);
-          pc_ += instr.if_op.false_offset;
+          ICHECK_NE(instr->if_op.false_offset, 0);
+          pc_ += instr->if_op.false_offset;
         }
 
-        goto main_loop;
       }
-      case Opcode::AllocTensor: {
-        OpStartHook(instr);
-        auto shape = std::vector<int64_t>(instr.alloc_tensor.ndim);
+      VM_DISPATCH();
+      VM_CASE(AllocTensor): {
+        OpStartHook(*instr);
+        auto shape = std::vector<int64_t>(instr->alloc_tensor.ndim);
 
-        for (uint32_t i = 0; i < instr.alloc_tensor.ndim; ++i) {
-          shape[i] = instr.alloc_tensor.shape[i];
+        for (uint32_t i = 0; i < instr->alloc_tensor.ndim; ++i) {
+          shape[i] = instr->alloc_tensor.shape[i];
         }
 
-        auto storage_obj = ReadRegister(instr.alloc_tensor.storage);
-        auto offset = LoadScalarInt(instr.alloc_tensor.offset);
+        auto storage_obj = ReadRegister(instr->alloc_tensor.storage);
+        auto offset = LoadScalarInt(instr->alloc_tensor.offset);
         auto storage = Downcast<Storage>(storage_obj);
 #if TVM_LOG_DEBUG
         std::ostringstream os;
@@ -607,72 +939,83 @@ void VirtualMachine::RunLoop() {
           os << i << ",";
         }
         os << "]";
-        os << ", dtype=" << DLDataType2String(instr.alloc_tensor.dtype);
+        os << ", dtype=" << DLDataType2String(instr->alloc_tensor.dtype);
         VLOG(2) << os.str();
 #endif
-        auto obj = storage->AllocNDArray(offset, shape, instr.alloc_tensor.dtype);
+        auto obj = storage->AllocNDArray(offset, shape, instr->alloc_tensor.dtype);
 
-        WriteRegister(instr.dst, obj);
+        WriteRegister(instr->dst, obj);
         OpStopHook();
         pc_++;
-        goto main_loop;
       }
-      case Opcode::AllocTensorReg: {
-        OpStartHook(instr);
+      VM_DISPATCH();
+      VM_CASE(AllocTensorReg): {
+        OpStartHook(*instr);
         Device cpu_dev = GetDevice(exec_->host_device_index);
-        auto shape_obj = ReadRegister(instr.alloc_tensor_reg.shape_register);
+        auto shape_obj = ReadRegister(instr->alloc_tensor_reg.shape_register);
         NDArray shape_tensor = Downcast<NDArray>(CopyTo(shape_obj, cpu_dev));
         auto shape = ToShape(shape_tensor);
-        auto storage_obj = ReadRegister(instr.alloc_tensor_reg.storage);
+        auto storage_obj = ReadRegister(instr->alloc_tensor_reg.storage);
         auto storage = Downcast<Storage>(storage_obj);
-        auto offset = LoadScalarInt(instr.alloc_tensor.offset);
-        auto obj = storage->AllocNDArray(offset, shape, instr.alloc_tensor_reg.dtype);
+        auto offset = LoadScalarInt(instr->alloc_tensor.offset);
+        auto obj = storage->AllocNDArray(offset, shape, instr->alloc_tensor_reg.dtype);
 
-        WriteRegister(instr.dst, obj);
+        WriteRegister(instr->dst, obj);
         OpStopHook();
         pc_++;
-        goto main_loop;
       }
-      case Opcode::AllocADT: {
+      VM_DISPATCH();
+      VM_CASE(AllocADT): {
         std::vector<ObjectRef> fields;
-        for (Index i = 0; i < instr.num_fields; ++i) {
-          fields.push_back(ReadRegister(instr.datatype_fields[i]));
+        for (Index i = 0; i < instr->num_fields; ++i) {
+          fields.push_back(ReadRegister(instr->datatype_fields[i]));
         }
-        ObjectRef obj = ADT(instr.constructor_tag, fields);
-        WriteRegister(instr.dst, obj);
+        ObjectRef obj = ADT(instr->constructor_tag, fields);
+        WriteRegister(instr->dst, obj);
         pc_++;
-        goto main_loop;
       }
-      case Opcode::AllocClosure: {
+      VM_DISPATCH();
+      VM_CASE(AllocClosure): {
         std::vector<ObjectRef> free_vars;
-        for (Index i = 0; i < instr.num_freevar; i++) {
-          free_vars.push_back(ReadRegister(instr.free_vars[i]));
+        for (Index i = 0; i < instr->num_freevar; i++) {
+          free_vars.push_back(ReadRegister(instr->free_vars[i]));
         }
-        WriteRegister(instr.dst, VMClosure(instr.func_index, free_vars));
+        WriteRegister(instr->dst, VMClosure(instr->func_index, free_vars));
         pc_++;
-        goto main_loop;
       }
-      case Opcode::AllocStorage: {
-        OpStartHook(instr);
-        auto size = LoadScalarInt(instr.alloc_storage.allocation_size);
-        auto alignment = instr.alloc_storage.alignment;
+      VM_DISPATCH();
+      VM_CASE(AllocStorage): {
+        OpStartHook(*instr);
+        auto size = LoadScalarInt(instr->alloc_storage.allocation_size);
+        auto alignment = instr->alloc_storage.alignment;
 
-        auto storage_obj = SimpleObjAllocator().make_object<StorageObj>();
-        Allocator* allocator = GetAllocator(instr.alloc_storage.device_index);
-        ICHECK(allocator) << "Did you forget to init the VirtualMachine with devices?";
-        VLOG(2) << "AllocStorage: allocation_size=" << size << ", alignment=" << alignment
-                << ", dtype_hint=" << DLDataType2String(instr.alloc_storage.dtype_hint)
-                << ", device_index=" << instr.alloc_storage.device_index;
+        auto storage_obj = DefaultObjAllocator().make_object<StorageObj>();
+        const VMFrame& frame = frames_.back();
+        if (frame.storage_plan != nullptr && frame.storage_plan->slots[pc_].first >= 0) {
+          // Static storage is a sub-range of the frame's arena.
+          const auto& slot = frame.storage_plan->slots[pc_];
+          const auto& arena = Downcast<Storage>(frame.storage_arenas[slot.first]);
+          storage_obj->buffer.data = static_cast<char*>(arena->buffer.data) + slot.second;
+          storage_obj->buffer.size = size;
+          storage_obj->buffer.device = arena->buffer.device;
+          storage_obj->parent = arena;
+        } else {
+          Allocator* allocator = GetAllocator(instr->alloc_storage.device_index);
+          ICHECK(allocator) << "Did you forget to init the VirtualMachine with devices?";
+          VLOG(2) << "AllocStorage: allocation_size=" << size << ", alignment=" << alignment
+                  << ", dtype_hint=" << DLDataType2String(instr->alloc_storage.dtype_hint)
+                  << ", device_index=" << instr->alloc_storage.device_index;
 
-        storage_obj->buffer = allocator->Alloc(size, alignment, instr.alloc_storage.dtype_hint);
-        Storage storage(storage_obj);
-        WriteRegister(instr.dst, storage);
+          storage_obj->buffer =
+              allocator->Alloc(size, alignment, instr->alloc_storage.dtype_hint);
+        }
+        WriteRegister(instr->dst, Storage(storage_obj));
         OpStopHook();
         pc_++;
-        goto main_loop;
       }
-      case Opcode::ShapeOf: {
-        auto input = ReadRegister(instr.shape_of.tensor);
+      VM_DISPATCH();
+      VM_CASE(ShapeOf): {
+        auto input = ReadRegister(instr->shape_of.tensor);
         NDArray input_array = Downcast<NDArray>(input);
         int ndim = input_array->ndim;
         auto out_tensor =
@@ -680,32 +1023,31 @@ void VirtualMachine::RunLoop() {
         for (int i = 0; i < ndim; ++i) {
           reinterpret_cast<int64_t*>(out_tensor->data)[i] = input_array->shape[i];
         }
-        WriteRegister(instr.dst, out_tensor);
+        WriteRegister(instr->dst, out_tensor);
         pc_++;
-        goto main_loop;
       }
-      case Opcode::Ret: {
+      VM_DISPATCH();
+      VM_CASE(Ret): {
         // If we have hit the point from which we started
         // running, we should return to the caller breaking
         // the dispatch loop.
-        return_register_ = ReadRegister(instr.result);
+        return_register_ = ReadRegister(instr->result);
         auto caller_return_register = frames_.back().caller_return_register;
 
         if (PopFrame() == frame_start) {
           return;
-          // Otherwise we are just returning from a local call.
-        } else {
-          WriteRegister(caller_return_register, return_register_);
-          goto main_loop;
         }
+        // Otherwise we are just returning from a local call.
+        WriteRegister(caller_return_register, return_register_);
       }
-      case Opcode::ReshapeTensor: {
-        OpStartHook(instr);
+      VM_DISPATCH();
+      VM_CASE(ReshapeTensor): {
+        OpStartHook(*instr);
         Device cpu_dev = GetDevice(exec_->host_device_index);
-        auto tensor_obj = ReadRegister(instr.reshape_tensor.tensor);
+        auto tensor_obj = ReadRegister(instr->reshape_tensor.tensor);
         NDArray tensor_arr = Downcast<NDArray>(tensor_obj);
         // Read the shape from shape tensor
-        auto shape_obj = ReadRegister(instr.reshape_tensor.newshape);
+        auto shape_obj = ReadRegister(instr->reshape_tensor.newshape);
         NDArray shape_tensor = Downcast<NDArray>(CopyTo(shape_obj, cpu_dev));
         const DLTensor* dl_tensor = shape_tensor.operator->();
         ICHECK_EQ(dl_tensor->dtype.code, 0u);
@@ -726,31 +1068,35 @@ void VirtualMachine::RunLoop() {
         VLOG(2) << os.str();
 #endif
         auto out_tensor = tensor_arr.CreateView(shape, tensor_arr->dtype);
-        WriteRegister(instr.dst, out_tensor);
+        WriteRegister(instr->dst, out_tensor);
         OpStopHook();
         pc_++;
-        goto main_loop;
       }
-      case Opcode::DeviceCopy: {
-        OpStartHook(instr);
-        auto tensor_src = ReadRegister(instr.device_copy.src);
+      VM_DISPATCH();
+      VM_CASE(DeviceCopy): {
+        OpStartHook(*instr);
+        auto tensor_src = ReadRegister(instr->device_copy.src);
         NDArray src_data = Downcast<NDArray>(tensor_src);
         Device actual_src_dev = src_data->device;
-        Device inst_src_dev = GetDevice(instr.device_copy.src_device_index);
+        Device inst_src_dev = GetDevice(instr->device_copy.src_device_index);
         ICHECK_EQ(actual_src_dev.device_type, inst_src_dev.device_type);
         ICHECK_EQ(actual_src_dev.device_id, inst_src_dev.device_id);
-        Device dst_dev = GetDevice(instr.device_copy.dst_device_index);
+        Device dst_dev = GetDevice(instr->device_copy.dst_device_index);
 
         NDArray dst_data = src_data.CopyTo(dst_dev);
-        WriteRegister(instr.dst, dst_data);
+        WriteRegister(instr->dst, dst_data);
         OpStopHook();
         pc_++;
-        goto main_loop;
       }
+      VM_DISPATCH();
       default:
-        LOG(FATAL) << "Unknown instruction opcode: " << int(instr.op);
+        goto unknown_op;
     }
   }
+unknown_op:
+  LOG(FATAL) << "Unknown instruction opcode: " << int(instr->op);
+#undef VM_DISPATCH
+#undef VM_CASE
 }
 
 runtime::Module CreateVirtualMachine(const Executable* exec) {
@@ -20,7 +20,9 @@
 #include "vulkan_device.h"
 
 #include <algorithm>
+#include <iomanip>
 #include <mutex>
+#include <sstream>
 #include <unordered_map>
 #include <utility>
 
@@ -70,6 +72,8 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES};
   VkPhysicalDeviceShaderFloat16Int8Features float16_int8 = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+  VkPhysicalDeviceCooperativeMatrixFeaturesNV cooperative_matrix = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_NV};
 
   // Set up linked list for feature query
   {
@@ -86,6 +90,10 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       *pp_next = &float16_int8;
       pp_next = &float16_int8.pNext;
     }
+    if (device.HasExtension("VK_NV_cooperative_matrix")) {
+      *pp_next = &cooperative_matrix;
+      pp_next = &cooperative_matrix.pNext;
+    }
   }
 
   if (instance.HasExtension("VK_KHR_get_physical_device_properties2")) {
@@ -132,6 +140,13 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       device.HasExtension("VK_KHR_dedicated_allocation") &&
       !support::BoolEnvironmentVar("TVM_VULKAN_DISABLE_DEDICATED_ALLOCATION");
 
+  // The fragments of the tensor core intrinsics are 16x16 matrices
+  // of float16, multiplied to float16 or float32.  Every driver
+  // exposing the extension supports these shapes.
+  supports_cooperative_matrix = cooperative_matrix.cooperativeMatrix &&
+                                (properties.properties.apiVersion >= VK_API_VERSION_1_1) &&
+                                supports_float16 && supports_16bit_buffer;
+
   // The check of VK_SHADER_STAGE_COMPUTE_BIT isn't technically
   // needed, since it will be set so long at least one queue has
   // VK_QUEUE_COMPUTE_BIT.  Including it to avoid potential future
@@ -323,6 +338,16 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, VkPhysicalDevice phy_
     get_buffer_memory_requirements_2_functions =
         std::make_unique<VulkanGetBufferMemoryRequirements2Functions>(device_);
   }
+
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(physical_device_, &props);
+  std::ostringstream cache_id;
+  cache_id << std::hex << props.vendorID << "-" << props.deviceID << "-" << props.driverVersion
+           << "-";
+  for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+    cache_id << std::setw(2) << std::setfill('0') << static_cast<int>(props.pipelineCacheUUID[i]);
+  }
+  pipeline_cache_id = cache_id.str();
 }
 
 VulkanDevice::~VulkanDevice() {
@@ -367,6 +392,7 @@ void VulkanDevice::do_swap(VulkanDevice&& other) {
   std::swap(physical_device_, other.physical_device_);
   std::swap(enabled_extensions, other.enabled_extensions);
   std::swap(device_, other.device_);
+  std::swap(pipeline_cache_id, other.pipeline_cache_id);
 }
 
 bool VulkanDevice::SupportsCompute() const { return queue_family_index != uint32_t(-1); }
@@ -421,6 +447,7 @@ std::vector<const char*> VulkanDevice::SelectEnabledExtensions() const {
       "VK_KHR_get_memory_requirements2",
       "VK_KHR_dedicated_allocation",
       "VK_KHR_spirv_1_4",
+      "VK_NV_cooperative_matrix",
   };
 
   uint32_t device_extension_prop_count;
@@ -447,6 +474,8 @@ void VulkanDevice::CreateVkDevice(const VulkanInstance& instance) {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES};
   VkPhysicalDeviceShaderFloat16Int8Features float16_int8 = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+  VkPhysicalDeviceCooperativeMatrixFeaturesNV cooperative_matrix = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_NV};
 
   void** pp_next = &enabled_features.pNext;
   bool needs_float16_int8 = false;
@@ -483,6 +512,11 @@ void VulkanDevice::CreateVkDevice(const VulkanInstance& instance) {
     *pp_next = &float16_int8;
     pp_next = &float16_int8.pNext;
   }
+  if (device_properties.supports_cooperative_matrix) {
+    cooperative_matrix.cooperativeMatrix = true;
+    *pp_next = &cooperative_matrix;
+    pp_next = &cooperative_matrix.pNext;
+  }
 
   float priority = 1.0f;
 
@@ -546,6 +580,7 @@ void VulkanDevice::AllocateThreadLocalUniformBuffer(size_t min_size) {
 
   if (result.size < min_size) {
     result = VulkanUniformBuffer(*this, min_size, usage, mem_type_index);
+    VulkanDeviceAPI::Global()->NotifyBufferRelease();
   }
 }
 
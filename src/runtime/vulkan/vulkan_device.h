@@ -81,6 +81,7 @@ struct VulkanDeviceProperties {
   bool supports_storage_buffer_storage_class{false};
   bool supports_push_descriptor{false};
   bool supports_dedicated_allocation{false};
+  bool supports_cooperative_matrix{false};
   uint32_t supported_subgroup_operations{0};
   uint32_t max_num_threads{1};
   uint32_t thread_warp_size{1};
@@ -219,6 +220,14 @@ class VulkanDevice {
 
   bool UseImmediate() const { return descriptor_template_khr_functions != nullptr; }
 
+  /*! \brief Identifies the device and driver in the kernel cache keys
+   *
+   * Made of the vendor, device and driver versions and the pipeline
+   * cache UUID, so that pipeline cache data is only reused by the
+   * driver that produced it.
+   */
+  std::string pipeline_cache_id;
+
  private:
   /*! \brief Helper function for move assignment/construction
    *
@@ -203,6 +203,9 @@ void VulkanDeviceAPI::GetTargetProperty(Device dev, const std::string& property,
   if (property == "supports_dedicated_allocation") {
     *rv = prop.supports_dedicated_allocation;
   }
+  if (property == "supports_cooperative_matrix") {
+    *rv = prop.supports_cooperative_matrix;
+  }
   if (property == "supported_subgroup_operations") {
     *rv = int64_t(prop.supported_subgroup_operations);
   }
@@ -275,6 +278,7 @@ void VulkanDeviceAPI::FreeDataSpace(Device dev, void* ptr) {
 
   auto* pbuf = static_cast<VulkanBuffer*>(ptr);
   delete pbuf;
+  NotifyBufferRelease();
 }
 
 void* VulkanDeviceAPI::AllocWorkspace(Device dev, size_t size, DLDataType type_hint) {
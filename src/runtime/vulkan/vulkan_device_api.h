@@ -23,6 +23,7 @@
 #include <tvm/runtime/device_api.h>
 #include <vulkan/vulkan_core.h>
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -108,6 +109,17 @@ class VulkanDeviceAPI final : public DeviceAPI {
    */
   void GetTargetProperty(Device dev, const std::string& property, TVMRetValue* rv) final;
 
+  /*! \brief Return the number of buffers released so far
+   *
+   * A released VkBuffer handle may be returned again by a later
+   * allocation, so the caches keyed by buffer handles are cleared
+   * when this count changes.
+   */
+  uint64_t BufferReleaseCount() const { return buffer_release_count_.load(); }
+
+  /*! \brief Record the release of a buffer that may be bound to a descriptor set */
+  void NotifyBufferRelease() { ++buffer_release_count_; }
+
  private:
   std::vector<uint32_t> GetComputeQueueFamilies(VkPhysicalDevice phy_dev);
 
@@ -124,6 +136,9 @@ class VulkanDeviceAPI final : public DeviceAPI {
    */
   std::vector<VulkanDevice> devices_;
 
+  /*! \brief The number of buffers released, see BufferReleaseCount */
+  std::atomic<uint64_t> buffer_release_count_{0};
+
   /*! \brief One pool of device memory for each CPU thread.
    *
    * These allocate memory based on the devices stored in devices_.
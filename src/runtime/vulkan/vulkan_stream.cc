@@ -70,54 +70,14 @@ void VulkanStream::Launch(const std::function<void(VulkanStreamState*)>& kernel)
   }
 }
 
-void VulkanStream::LaunchDeferred(const std::function<void()>& deferred_initializer,
-                                  const std::function<void(VulkanStreamState*)>& deferred_kernel,
-                                  const VulkanStreamToken& deferred_token) {
-  ICHECK(!device_->UseImmediate());
-
-  // If the new kernel uses the same descriptor set as one of the
-  // kernels already in the command buffer, we need to synchronize
-  // first.
-  if (std::any_of(deferred_tokens_[deferred_token.descriptor_set_].begin(),
-                  deferred_tokens_[deferred_token.descriptor_set_].end(),
-                  [&](const VulkanStreamToken& token) {
-                    DCHECK(token.descriptor_set_ == deferred_token.descriptor_set_);
-                    return token.descriptor_set_ == deferred_token.descriptor_set_ &&
-                           token.buffers_ != deferred_token.buffers_;
-                  })) {
-    Synchronize();
-  }
-
-  // If the new kernel uses the same buffers in the same descriptor
-  // set as an already-queued kernel, we don't need to initialize it
-  // again.  Since every VulkanWrappedFunc owns a single descriptor
-  // set, unless the same function is called with the same buffer
-  // arguments, deferred_initializer() will always be called.
-  if (!std::any_of(deferred_tokens_[deferred_token.descriptor_set_].begin(),
-                   deferred_tokens_[deferred_token.descriptor_set_].end(),
-                   [&](const VulkanStreamToken& token) {
-                     DCHECK(token.descriptor_set_ == deferred_token.descriptor_set_);
-                     return token.descriptor_set_ == deferred_token.descriptor_set_ &&
-                            token.buffers_ == deferred_token.buffers_;
-                   })) {
-    deferred_initializer();
-  }
-
-  // Save the kernel itself to be called later.
-  deferred_kernels_.push_back(deferred_kernel);
-  deferred_tokens_[deferred_token.descriptor_set_].push_back(deferred_token);
-}
-
 void VulkanStream::Synchronize() {
   if (!device_->UseImmediate()) {
     for (const auto& deferred_kernel : deferred_kernels_) {
       deferred_kernel(state_.get());
     }
     deferred_kernels_.clear();
-    deferred_tokens_.clear();
   } else {
     DCHECK_EQ(deferred_kernels_.size(), 0);
-    DCHECK_EQ(deferred_tokens_.size(), 0);
   }
 
   VULKAN_CALL(vkEndCommandBuffer(state_->cmd_buffer_));
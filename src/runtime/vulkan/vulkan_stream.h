@@ -22,7 +22,6 @@
 
 #include <functional>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 #include "vulkan_common.h"
@@ -39,12 +38,6 @@ class VulkanStreamState {
   VkFence fence_;
 };
 
-// Used to identify state that should only be used once-per-stream.
-struct VulkanStreamToken {
-  VkDescriptorSet descriptor_set_{VK_NULL_HANDLE};
-  std::vector<VkBuffer> buffers_;
-};
-
 /*!
  *  \brief Wrapper around a vulkan command buffer
  *
@@ -74,40 +67,20 @@ class VulkanStream {
    * to the list of deferred updates to be pushed onto the command
    * buffer.
    *
-   * Assumes that there are no descriptor sets or buffers accessed by this kernel.
-   *
+   * A deferred kernel binding a descriptor set must own it until the
+   * stream is synchronized, since the set is not updated again before
+   * then.  The descriptor sets of the VulkanWrappedFunc are cached
+   * per buffer binding, so that all the kernels between two
+   * synchronizations are recorded in one command buffer.
    */
   void Launch(const std::function<void(VulkanStreamState*)>& kernel);
 
-  /*! \brief Push the kernel onto the stream's command buffer.
-   *
-   * Can only be called if device.UseImmediate() is false.  The
-   * kernel is delayed, and isn't pushed to the command buffer until
-   * all kernels are collected.
-   *
-   * \param deferred_initializer Updates the descriptor set.  Only
-   * called if the deferred_token has differences from
-   *
-   * \param deferred_kernel Submits updates to the command buffer.
-   *
-   * \param deferred_token Indicates which descriptor set and buffers
-   * are accessed by this kernel.  No two kernels in the command
-   * buffer can use the same descriptor set.
-   *
-   */
-  void LaunchDeferred(const std::function<void()>& deferred_initializer,
-                      const std::function<void(VulkanStreamState*)>& deferred_kernel,
-                      const VulkanStreamToken& deferred_token);
-
   // Synchronize the current stream `state_` with respect to the host.
   void Synchronize();
 
  private:
   const VulkanDevice* device_;
   std::unique_ptr<VulkanStreamState> state_;
-  // An index of deferred tokens, allowing us to efficiently detect duplicated
-  // deferred_initializer blocks.
-  std::unordered_map<VkDescriptorSet, std::vector<VulkanStreamToken>> deferred_tokens_;
   std::vector<std::function<void(VulkanStreamState*)>> deferred_kernels_;
   VkCommandPool cmd_pool_;
 };
@@ -104,38 +104,14 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
 
   // Otherwise, the more expensive deferred path.
   std::vector<ArgUnion64> pack_args_storage(pack_args, pack_args + num_pack_args_);
-  const auto& deferred_initializer = [&device, pipeline, descriptor_buffers]() {
-    std::vector<VkWriteDescriptorSet> write_descriptor_sets;
-    write_descriptor_sets.resize(descriptor_buffers.size());
-    for (size_t i = 0; i < write_descriptor_sets.size(); i++) {
-      write_descriptor_sets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      write_descriptor_sets[i].pNext = 0;
-      write_descriptor_sets[i].dstSet = pipeline->descriptor_set;
-      write_descriptor_sets[i].dstBinding = i;
-      write_descriptor_sets[i].dstArrayElement = 0;
-      write_descriptor_sets[i].descriptorCount = 1;
-      write_descriptor_sets[i].pImageInfo = 0;
-      write_descriptor_sets[i].pBufferInfo = &(descriptor_buffers[i]);
-      write_descriptor_sets[i].pTexelBufferView = 0;
-
-      if (pipeline->use_ubo && i == write_descriptor_sets.size() - 1) {
-        // The last binding is for UBO
-        write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-      } else {
-        write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-      }
-    }
-    vkUpdateDescriptorSets(device, write_descriptor_sets.size(), write_descriptor_sets.data(), 0,
-                           0);
-  };
-  const auto& deferred_kernel = [this, pipeline, wl, pack_args_storage, nbytes_scalars,
-                                 device_id](VulkanStreamState* state) {
+  VkDescriptorSet descriptor_set = pipeline->GetDescriptorSet(device, descriptor_buffers);
+  const auto& deferred_kernel = [this, pipeline, descriptor_set, wl, pack_args_storage,
+                                 nbytes_scalars, device_id](VulkanStreamState* state) {
     auto& device = VulkanDeviceAPI::Global()->device(device_id);
 
     vkCmdBindPipeline(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
     vkCmdBindDescriptorSets(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            pipeline->pipeline_layout, 0, 1, &(pipeline->descriptor_set), 0,
-                            nullptr);
+                            pipeline->pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
 
     if (pipeline->use_ubo) {
       auto& ubo = device.ThreadLocalUniformBuffer(nbytes_scalars);
@@ -157,13 +133,91 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
                          VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
                          1, &barrier_info, 0, nullptr, 0, nullptr);
   };
-  VulkanStreamToken deferred_token;
-  deferred_token.descriptor_set_ = pipeline->descriptor_set;
-  deferred_token.buffers_.resize(descriptor_buffers.size());
+  device.ThreadLocalStream().Launch(deferred_kernel);
+}
+
+VkDescriptorSet VulkanPipeline::GetDescriptorSet(
+    const VulkanDevice& device, const std::vector<VkDescriptorBufferInfo>& descriptor_buffers) {
+  // The number of descriptor sets allocated from each descriptor pool.
+  constexpr uint32_t kDescriptorSetsPerPool = 64;
+  std::vector<VkBuffer> buffers(descriptor_buffers.size());
   for (size_t i = 0; i < descriptor_buffers.size(); ++i) {
-    deferred_token.buffers_[i] = descriptor_buffers[i].buffer;
+    buffers[i] = descriptor_buffers[i].buffer;
+  }
+
+  std::lock_guard<std::mutex> lock(descriptor_mutex);
+  // The stream was synchronized when the buffer was released, so
+  // none of the cached sets is used by a queued kernel.
+  uint64_t release_count = VulkanDeviceAPI::Global()->BufferReleaseCount();
+  if (release_count != buffer_release_count) {
+    ReleaseDescriptorSets(device);
+    buffer_release_count = release_count;
+  }
+  auto it = descriptor_sets.find(buffers);
+  if (it != descriptor_sets.end()) {
+    return it->second;
+  }
+
+  if (descriptor_pools.empty() || num_sets_in_last_pool == kDescriptorSetsPerPool) {
+    std::vector<VkDescriptorPoolSize> pool_sizes = descriptor_pool_sizes;
+    for (auto& pool_size : pool_sizes) {
+      pool_size.descriptorCount *= kDescriptorSetsPerPool;
+    }
+    VkDescriptorPoolCreateInfo descrip_pool_cinfo;
+    descrip_pool_cinfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descrip_pool_cinfo.pNext = nullptr;
+    descrip_pool_cinfo.flags = 0;
+    descrip_pool_cinfo.maxSets = kDescriptorSetsPerPool;
+    descrip_pool_cinfo.poolSizeCount = pool_sizes.size();
+    descrip_pool_cinfo.pPoolSizes = pool_sizes.data();
+    VkDescriptorPool pool;
+    VULKAN_CALL(vkCreateDescriptorPool(device, &descrip_pool_cinfo, nullptr, &pool));
+    descriptor_pools.push_back(pool);
+    num_sets_in_last_pool = 0;
   }
-  device.ThreadLocalStream().LaunchDeferred(deferred_initializer, deferred_kernel, deferred_token);
+
+  VkDescriptorSet descriptor_set;
+  VkDescriptorSetAllocateInfo alloc_info;
+  alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  alloc_info.pNext = nullptr;
+  alloc_info.descriptorPool = descriptor_pools.back();
+  alloc_info.descriptorSetCount = 1;
+  alloc_info.pSetLayouts = &descriptor_set_layout;
+  VULKAN_CALL(vkAllocateDescriptorSets(device, &alloc_info, &descriptor_set));
+  ++num_sets_in_last_pool;
+
+  std::vector<VkWriteDescriptorSet> write_descriptor_sets;
+  write_descriptor_sets.resize(descriptor_buffers.size());
+  for (size_t i = 0; i < write_descriptor_sets.size(); i++) {
+    write_descriptor_sets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write_descriptor_sets[i].pNext = 0;
+    write_descriptor_sets[i].dstSet = descriptor_set;
+    write_descriptor_sets[i].dstBinding = i;
+    write_descriptor_sets[i].dstArrayElement = 0;
+    write_descriptor_sets[i].descriptorCount = 1;
+    write_descriptor_sets[i].pImageInfo = 0;
+    write_descriptor_sets[i].pBufferInfo = &(descriptor_buffers[i]);
+    write_descriptor_sets[i].pTexelBufferView = 0;
+
+    if (use_ubo && i == write_descriptor_sets.size() - 1) {
+      // The last binding is for UBO
+      write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    } else {
+      write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    }
+  }
+  vkUpdateDescriptorSets(device, write_descriptor_sets.size(), write_descriptor_sets.data(), 0, 0);
+  descriptor_sets[buffers] = descriptor_set;
+  return descriptor_set;
+}
+
+void VulkanPipeline::ReleaseDescriptorSets(const VulkanDevice& device) {
+  for (VkDescriptorPool pool : descriptor_pools) {
+    vkDestroyDescriptorPool(device, pool, nullptr);
+  }
+  descriptor_pools.clear();
+  descriptor_sets.clear();
+  num_sets_in_last_pool = 0;
 }
 
 VulkanModuleNode::~VulkanModuleNode() {
@@ -180,7 +234,7 @@ VulkanModuleNode::~VulkanModuleNode() {
       }
       vkDestroyPipeline(device, pe->pipeline, nullptr);
       vkDestroyPipelineLayout(device, pe->pipeline_layout, nullptr);
-      vkDestroyDescriptorPool(device, pe->descriptor_pool, nullptr);
+      pe->ReleaseDescriptorSets(device);
       vkDestroyDescriptorSetLayout(device, pe->descriptor_set_layout, nullptr);
       vkDestroyShaderModule(device, pe->shader, nullptr);
     }
@@ -302,23 +356,8 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
   }
 
   if (!device.UseImmediate()) {
-    VkDescriptorPoolCreateInfo descrip_pool_cinfo;
-    descrip_pool_cinfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descrip_pool_cinfo.pNext = nullptr;
-    descrip_pool_cinfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descrip_pool_cinfo.maxSets = 1;
-    descrip_pool_cinfo.poolSizeCount = descriptor_set_pool_sizes.size();
-    descrip_pool_cinfo.pPoolSizes = descriptor_set_pool_sizes.data();
-    VULKAN_CALL(
-        vkCreateDescriptorPool(device, &descrip_pool_cinfo, nullptr, &(pe->descriptor_pool)));
-
-    VkDescriptorSetAllocateInfo alloc_info;
-    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    alloc_info.pNext = nullptr;
-    alloc_info.descriptorPool = pe->descriptor_pool;
-    alloc_info.descriptorSetCount = 1;
-    alloc_info.pSetLayouts = &(pe->descriptor_set_layout);
-    VULKAN_CALL(vkAllocateDescriptorSets(device, &alloc_info, &(pe->descriptor_set)));
+    pe->descriptor_pool_sizes = descriptor_set_pool_sizes;
+    pe->buffer_release_count = VulkanDeviceAPI::Global()->BufferReleaseCount();
   }
 
   VkPushConstantRange crange;
@@ -364,8 +403,43 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
   pipeline_cinfo.layout = pe->pipeline_layout;
   pipeline_cinfo.basePipelineHandle = VK_NULL_HANDLE;
   pipeline_cinfo.basePipelineIndex = 0;
-  VULKAN_CALL(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipeline_cinfo, nullptr,
+
+  // The pipeline cache of this shader, so that the driver compilation
+  // is skipped when an earlier process saved it to the kernel cache.
+  std::string cache_key;
+  std::string cache_data;
+  bool cache_hit = false;
+  if (!GetKernelCacheDir().empty()) {
+    const std::vector<uint32_t>& data = smap_.at(func_name).data;
+    cache_key = KernelCacheKey(
+        {"vulkan_pipeline", device.pipeline_cache_id, func_name,
+         std::string(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(uint32_t))});
+    cache_hit = LoadKernelCache(cache_key, &cache_data);
+  }
+  VkPipelineCacheCreateInfo cache_cinfo;
+  cache_cinfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  cache_cinfo.pNext = nullptr;
+  cache_cinfo.flags = 0;
+  cache_cinfo.initialDataSize = cache_data.size();
+  cache_cinfo.pInitialData = cache_data.data();
+  VkPipelineCache pipeline_cache;
+  if (vkCreatePipelineCache(device, &cache_cinfo, nullptr, &pipeline_cache) != VK_SUCCESS) {
+    cache_hit = false;
+    cache_cinfo.initialDataSize = 0;
+    cache_cinfo.pInitialData = nullptr;
+    VULKAN_CALL(vkCreatePipelineCache(device, &cache_cinfo, nullptr, &pipeline_cache));
+  }
+  VULKAN_CALL(vkCreateComputePipelines(device, pipeline_cache, 1, &pipeline_cinfo, nullptr,
                                        &(pe->pipeline)));
+  if (!cache_key.empty() && !cache_hit) {
+    size_t cache_size = 0;
+    VULKAN_CALL(vkGetPipelineCacheData(device, pipeline_cache, &cache_size, nullptr));
+    cache_data.resize(cache_size);
+    VULKAN_CALL(vkGetPipelineCacheData(device, pipeline_cache, &cache_size, &cache_data[0]));
+    cache_data.resize(cache_size);
+    SaveKernelCache(cache_key, cache_data);
+  }
+  vkDestroyPipelineCache(device, pipeline_cache, nullptr);
 
   if (device.UseImmediate()) {
     VkDescriptorUpdateTemplateCreateInfoKHR descrip_template_cinfo;
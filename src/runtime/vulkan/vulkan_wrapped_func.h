@@ -21,6 +21,7 @@
 #define TVM_RUNTIME_VULKAN_VULKAN_WRAPPED_FUNC_H_
 
 #include <array>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -43,12 +44,39 @@ struct VulkanPipeline {
   VulkanDevice* device{nullptr};
   VkShaderModule shader{VK_NULL_HANDLE};
   VkDescriptorSetLayout descriptor_set_layout{VK_NULL_HANDLE};
-  VkDescriptorPool descriptor_pool{VK_NULL_HANDLE};
-  VkDescriptorSet descriptor_set{VK_NULL_HANDLE};
   VkPipelineLayout pipeline_layout{VK_NULL_HANDLE};
   VkPipeline pipeline{VK_NULL_HANDLE};
   VkDescriptorUpdateTemplateKHR descriptor_update_template{VK_NULL_HANDLE};
   bool use_ubo{false};
+
+  /*! \brief Return the descriptor set binding the buffers, used when
+   *  push descriptors are not supported.
+   *
+   *  The sets are cached by the buffers they bind and only written
+   *  on the first use of a binding, so repeated launches neither
+   *  update descriptors nor synchronize the stream.  The cache is
+   *  emptied once a buffer is released, as its handle may be reused.
+   *
+   * \param device The device of the pipeline.
+   * \param descriptor_buffers The buffers, in binding order.
+   */
+  VkDescriptorSet GetDescriptorSet(const VulkanDevice& device,
+                                   const std::vector<VkDescriptorBufferInfo>& descriptor_buffers);
+
+  /*! \brief Destroy the descriptor sets returned by GetDescriptorSet. */
+  void ReleaseDescriptorSets(const VulkanDevice& device);
+
+  // The descriptor counts of one descriptor set.
+  std::vector<VkDescriptorPoolSize> descriptor_pool_sizes;
+  // The pools of the cached descriptor sets, the last one being filled.
+  std::vector<VkDescriptorPool> descriptor_pools;
+  uint32_t num_sets_in_last_pool{0};
+  // The cached descriptor sets, keyed by the buffers they bind.
+  std::map<std::vector<VkBuffer>, VkDescriptorSet> descriptor_sets;
+  // The VulkanDeviceAPI::BufferReleaseCount the cache was filled at.
+  uint64_t buffer_release_count{0};
+  // Guards the descriptor set cache.
+  std::mutex descriptor_mutex;
 };
 
 class VulkanModuleNode;
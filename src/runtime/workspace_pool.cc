@@ -23,114 +23,144 @@
  */
 #include "workspace_pool.h"
 
+#include <algorithm>
+#include <array>
+#include <limits>
 #include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "memory_stats.h"
 
 namespace tvm {
 namespace runtime {
 
 // page size.
 constexpr size_t kWorkspacePageSize = 4 << 10;
+// The number of size classes, four per power of two of the number of pages.
+constexpr int kNumSizeClasses = 256;
+// A request may be served by a cached block up to this number of classes larger.
+constexpr int kMaxClassSkip = 2;
+// An idle pool trims when it holds more than this many times its peak usage, releasing
+// the blocks not reused during this many idle periods.
+constexpr size_t kTrimRatio = 2;
+constexpr uint64_t kTrimEpochs = 8;
 
 class WorkspacePool::Pool {
  public:
-  // constructor
-  Pool() {
-    // safe guard header on each list.
-    Entry e;
-    e.data = nullptr;
-    e.size = 0;
-    free_list_.push_back(e);
-    allocated_.push_back(e);
-  }
+  explicit Pool(Device dev) : memory_counter_(MemoryStats::Get(dev, kMemoryWorkspace)) {}
   // allocate from pool
   void* Alloc(Device dev, DeviceAPI* device, size_t nbytes) {
-    // Allocate align to page.
-    nbytes = (nbytes + (kWorkspacePageSize - 1)) / kWorkspacePageSize * kWorkspacePageSize;
-    if (nbytes == 0) nbytes = kWorkspacePageSize;
+    int cls = SizeClass(nbytes);
     Entry e;
-    DLDataType type;
-    type.code = kDLUInt;
-    type.bits = 8;
-    type.lanes = 1;
-    if (free_list_.size() == 2) {
-      e = free_list_.back();
-      free_list_.pop_back();
-      if (e.size < nbytes) {
-        // resize the page
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
-      }
-    } else if (free_list_.size() == 1) {
-      e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-      e.size = nbytes;
-    } else {
-      if (free_list_.back().size >= nbytes) {
-        // find smallest fit
-        auto it = free_list_.end() - 2;
-        for (; it->size >= nbytes; --it) {
-        }
-        e = *(it + 1);
-        free_list_.erase(it + 1);
-      } else {
-        // resize the page
-        e = free_list_.back();
-        free_list_.pop_back();
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
+    e.data = nullptr;
+    for (int c = cls; c < std::min(cls + kMaxClassSkip + 1, kNumSizeClasses); ++c) {
+      if (!free_list_[c].empty()) {
+        e = free_list_[c].back();
+        free_list_[c].pop_back();
+        ++stats_.num_hits;
+        break;
       }
     }
-    allocated_.push_back(e);
+    if (e.data == nullptr) {
+      // grow, the blocks no longer reused are released when the pool is idle
+      DLDataType type;
+      type.code = kDLUInt;
+      type.bits = 8;
+      type.lanes = 1;
+      e.size = ClassSize(cls);
+      e.cls = cls;
+      e.data = device->AllocDataSpace(dev, e.size, kTempAllocaAlignment, type);
+      ++stats_.num_device_allocs;
+      stats_.reserved_bytes += e.size;
+      memory_counter_->RecordAlloc(e.size);
+    }
+    e.epoch = epoch_;
+    allocated_[e.data] = e;
+    ++stats_.num_allocs;
+    stats_.in_use_bytes += e.size;
+    stats_.peak_in_use_bytes = std::max(stats_.peak_in_use_bytes, stats_.in_use_bytes);
+    peak_since_idle_ = std::max(peak_since_idle_, stats_.in_use_bytes);
     return e.data;
   }
   // free resource back to pool
-  void Free(void* data) {
-    Entry e;
-    if (allocated_.back().data == data) {
-      // quick path, last allocated.
-      e = allocated_.back();
-      allocated_.pop_back();
-    } else {
-      int index = static_cast<int>(allocated_.size()) - 2;
-      for (; index > 0 && allocated_[index].data != data; --index) {
+  void Free(Device dev, DeviceAPI* device, void* data) {
+    auto it = allocated_.find(data);
+    ICHECK(it != allocated_.end()) << "trying to free things that has not been allocated";
+    Entry e = it->second;
+    allocated_.erase(it);
+    free_list_[e.cls].push_back(e);
+    stats_.in_use_bytes -= e.size;
+    if (allocated_.empty()) {
+      // idle, release the blocks unused for a while when caching too much
+      if (stats_.reserved_bytes > kTrimRatio * peak_since_idle_ && epoch_ >= kTrimEpochs) {
+        Release(dev, device, epoch_ - kTrimEpochs + 1);
       }
-      ICHECK_GT(index, 0) << "trying to free things that has not been allocated";
-      e = allocated_[index];
-      allocated_.erase(allocated_.begin() + index);
+      peak_since_idle_ = 0;
+      ++epoch_;
     }
-    if (free_list_.back().size < e.size) {
-      free_list_.push_back(e);
-    } else if (free_list_.size() == 2) {
-      free_list_.push_back(free_list_.back());
-      free_list_[1] = e;
-    } else {
-      size_t i = free_list_.size() - 1;
-      free_list_.resize(free_list_.size() + 1);
-      for (; e.size < free_list_[i].size; --i) {
-        free_list_[i + 1] = free_list_[i];
+  }
+  // Release the cached blocks last used before epoch.
+  void Release(Device dev, DeviceAPI* device, uint64_t epoch) {
+    for (std::vector<Entry>& free_list : free_list_) {
+      size_t kept = 0;
+      for (const Entry& e : free_list) {
+        if (e.epoch < epoch) {
+          device->FreeDataSpace(dev, e.data);
+          ++stats_.num_device_frees;
+          stats_.reserved_bytes -= e.size;
+          memory_counter_->RecordFree(e.size);
+        } else {
+          free_list[kept++] = e;
+        }
       }
-      free_list_[i + 1] = e;
+      free_list.resize(kept);
     }
   }
-  // Release all resources
+  // Release all cached blocks.
   void Release(Device dev, DeviceAPI* device) {
-    for (size_t i = 1; i < free_list_.size(); ++i) {
-      device->FreeDataSpace(dev, free_list_[i].data);
-    }
-    free_list_.clear();
+    Release(dev, device, std::numeric_limits<uint64_t>::max());
   }
 
+  const WorkspacePoolStats& stats() const { return stats_; }
+
  private:
   /*! \brief a single entry in the pool */
   struct Entry {
     void* data;
     size_t size;
+    /*! \brief The size class of the block. */
+    int cls;
+    /*! \brief The idle epoch the block was last allocated in. */
+    uint64_t epoch;
   };
-  /*! \brief List of free items, sorted from small to big size */
-  std::vector<Entry> free_list_;
-  /*! \brief List of allocated items */
-  std::vector<Entry> allocated_;
+  // The smallest size class holding nbytes: 1 to 4 pages, then 4 classes per power of two.
+  static int SizeClass(size_t nbytes) {
+    size_t pages = std::max<size_t>((nbytes + (kWorkspacePageSize - 1)) / kWorkspacePageSize, 1);
+    if (pages <= 4) return static_cast<int>(pages) - 1;
+    size_t p = pages - 1;
+    int msb = 0;
+    while ((p >> msb) > 1) ++msb;
+    return 4 * (msb - 1) + static_cast<int>(p >> (msb - 2)) - 4;
+  }
+  // The size of the blocks of a size class.
+  static size_t ClassSize(int cls) {
+    if (cls < 4) return (cls + 1) * kWorkspacePageSize;
+    size_t step = static_cast<size_t>(1) << (cls / 4 - 1);
+    return (cls % 4 + 5) * step * kWorkspacePageSize;
+  }
+  /*! \brief The free blocks of each size class, the last freed at the back. */
+  std::array<std::vector<Entry>, kNumSizeClasses> free_list_;
+  /*! \brief The allocated blocks, by address. */
+  std::unordered_map<void*, Entry> allocated_;
+  /*! \brief The number of times the pool became idle. */
+  uint64_t epoch_{0};
+  /*! \brief The peak bytes in use since the pool was last idle. */
+  size_t peak_since_idle_{0};
+  /*! \brief The statistics. */
+  WorkspacePoolStats stats_;
+  /*! \brief The process wide counter of the workspace memory of the device. */
+  MemoryCounter* memory_counter_;
 };
 
 WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device)
@@ -153,14 +183,32 @@ void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
     array_.resize(dev.device_id + 1, nullptr);
   }
   if (array_[dev.device_id] == nullptr) {
-    array_[dev.device_id] = new Pool();
+    array_[dev.device_id] = new Pool(dev);
   }
   return array_[dev.device_id]->Alloc(dev, device_, size);
 }
 
 void WorkspacePool::FreeWorkspace(Device dev, void* ptr) {
   ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr);
-  array_[dev.device_id]->Free(ptr);
+  array_[dev.device_id]->Free(dev, device_, ptr);
+}
+
+void WorkspacePool::Trim() {
+  for (size_t i = 0; i < array_.size(); ++i) {
+    if (array_[i] != nullptr) {
+      Device dev;
+      dev.device_type = device_type_;
+      dev.device_id = static_cast<int>(i);
+      array_[i]->Release(dev, device_);
+    }
+  }
+}
+
+WorkspacePoolStats WorkspacePool::GetStats(Device dev) const {
+  if (static_cast<size_t>(dev.device_id) >= array_.size() || array_[dev.device_id] == nullptr) {
+    return WorkspacePoolStats();
+  }
+  return array_[dev.device_id]->stats();
 }
 
 }  // namespace runtime
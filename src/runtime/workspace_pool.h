@@ -31,6 +31,22 @@
 
 namespace tvm {
 namespace runtime {
+/*! \brief The statistics of the workspace pool of one device. */
+struct WorkspacePoolStats {
+  /*! \brief The number of workspaces allocated. */
+  uint64_t num_allocs{0};
+  /*! \brief The number of allocations served by a cached block. */
+  uint64_t num_hits{0};
+  /*! \brief The number of blocks allocated from and released to the device. */
+  uint64_t num_device_allocs{0};
+  uint64_t num_device_frees{0};
+  /*! \brief The bytes of the workspaces in use, and the maximum since the start. */
+  size_t in_use_bytes{0};
+  size_t peak_in_use_bytes{0};
+  /*! \brief The bytes allocated from the device, in use or cached. */
+  size_t reserved_bytes{0};
+};
+
 /*!
  * \brief A workspace pool to manage
  *
@@ -41,6 +57,11 @@ namespace runtime {
  *  - Only a few allocation will happen, and space will be released after use.
  *  - The release order is usually in reverse order of allocate
  *  - Repeative pattern of same allocations over different runs.
+ *
+ *  The free blocks are kept in lists indexed by size class, four classes per power of two,
+ *  so that allocating and freeing takes constant time. A miss allocates a new block
+ *  instead of freeing a cached one, as freeing can synchronize the device. The cached
+ *  blocks that stopped being reused are released once the pool is idle, or by Trim.
  */
 class TVM_DLL WorkspacePool {
  public:
@@ -65,6 +86,16 @@ class TVM_DLL WorkspacePool {
    * \param ptr The pointer to be freed.
    */
   void FreeWorkspace(Device dev, void* ptr);
+  /*!
+   * \brief Release the cached blocks of all devices to the device API.
+   */
+  void Trim();
+  /*!
+   * \brief Get the statistics of the pool of a device.
+   * \param dev The device.
+   * \return The statistics, all zero when the device has no workspace allocated.
+   */
+  WorkspacePoolStats GetStats(Device dev) const;
 
  private:
   class Pool;
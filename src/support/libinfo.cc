@@ -87,6 +87,10 @@
 #define TVM_INFO_USE_GRAPH_EXECUTOR "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_AOT_EXECUTOR
+#define TVM_INFO_USE_AOT_EXECUTOR "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_PROFILER
 #define TVM_INFO_USE_PROFILER "NOT-FOUND"
 #endif
@@ -127,6 +131,10 @@
 #define TVM_INFO_USE_FALLBACK_STL_MAP "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_OBJECT_POOL
+#define TVM_INFO_USE_OBJECT_POOL "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_BYODT_POSIT
 #define TVM_INFO_USE_BYODT_POSIT "NOT-FOUND"
 #endif
@@ -244,6 +252,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"CUDA_VERSION", TVM_INFO_CUDA_VERSION},
       {"USE_STACKVM_RUNTIME", TVM_INFO_USE_STACKVM_RUNTIME},
       {"USE_GRAPH_EXECUTOR", TVM_INFO_USE_GRAPH_EXECUTOR},
+      {"USE_AOT_EXECUTOR", TVM_INFO_USE_AOT_EXECUTOR},
       {"USE_PROFILER", TVM_INFO_USE_PROFILER},
       {"USE_OPENMP", TVM_INFO_USE_OPENMP},
       {"USE_RELAY_DEBUG", TVM_INFO_USE_RELAY_DEBUG},
@@ -254,6 +263,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"HIDE_PRIVATE_SYMBOLS", TVM_INFO_HIDE_PRIVATE_SYMBOLS},
       {"USE_TF_TVMDSOOP", TVM_INFO_USE_TF_TVMDSOOP},
       {"USE_FALLBACK_STL_MAP", TVM_INFO_USE_FALLBACK_STL_MAP},
+      {"USE_OBJECT_POOL", TVM_INFO_USE_OBJECT_POOL},
       {"USE_BYODT_POSIT", TVM_INFO_USE_BYODT_POSIT},
       {"USE_BLAS", TVM_INFO_USE_BLAS},
       {"USE_MKL", TVM_INFO_USE_MKL},
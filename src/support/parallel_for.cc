@@ -24,14 +24,157 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/support/parallel_for.h>
 
-#include <future>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <utility>
 #include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 namespace tvm {
 namespace support {
 
+namespace {
+/*!
+ * \brief The threads shared by the parallel loops of the compiler.
+ *
+ *  A loop is a job made of participants, the calling thread being one of them. The idle
+ *  workers and the caller claim the participants of the jobs in the queue one by one, so a
+ *  loop never waits for a participant that no thread started, and the loops called inside
+ *  a participant run on its thread. The pool grows to the largest number of participants
+ *  requested and its threads are kept for the next loops.
+ */
+class ParallelForPool {
+ public:
+  static ParallelForPool* Global() {
+    // NOTE: leaked on purpose, the workers outlive the static destructors
+    static std::mutex mutex;
+    static ParallelForPool* pool = nullptr;
+    std::lock_guard<std::mutex> lock(mutex);
+#ifndef _WIN32
+    // the workers do not survive a fork, nor may the locks they held be used in the child
+    if (pool != nullptr && pool->pid_ != getpid()) pool = nullptr;
+#endif
+    if (pool == nullptr) pool = new ParallelForPool();
+    return pool;
+  }
+
+  /*!
+   * \brief Run the participants of a job and wait for them to finish.
+   * \param num_participants The number of participants.
+   * \param fjob The job, called with the index of each participant.
+   * \note The first exception thrown by a participant is rethrown, after all of them ended.
+   */
+  void Run(int num_participants, const std::function<void(int)>& fjob) {
+    if (num_participants <= 0) return;
+    if (in_participant_ || num_participants == 1) {
+      // nested in a participant, which has the other threads busy
+      for (int i = 0; i < num_participants; ++i) fjob(i);
+      return;
+    }
+    auto job = std::make_shared<Job>(fjob, num_participants);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      while (static_cast<int>(workers_.size()) < num_participants - 1) {
+        workers_.emplace_back([this]() { RunWorker(); });
+        workers_.back().detach();
+      }
+      queue_.push_back(job);
+    }
+    cv_.notify_all();
+    // the caller is participant 0, then helps with the participants left
+    RunParticipant(job.get(), 0);
+    for (int index; (index = job->next_participant.fetch_add(1)) < num_participants;) {
+      RunParticipant(job.get(), index);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = std::find(queue_.begin(), queue_.end(), job);
+      if (it != queue_.end()) queue_.erase(it);
+    }
+    {
+      std::unique_lock<std::mutex> lock(job->mutex);
+      job->cv.wait(lock, [&job]() { return job->num_pending == 0; });
+    }
+    if (job->error) std::rethrow_exception(job->error);
+  }
+
+ private:
+  struct Job {
+    Job(const std::function<void(int)>& fjob, int num_participants)
+        : fjob(fjob), num_participants(num_participants), num_pending(num_participants) {}
+    const std::function<void(int)>& fjob;
+    const int num_participants;
+    // the next participant to claim, participant 0 being the caller
+    std::atomic<int> next_participant{1};
+    // the participants not finished, guarded by mutex
+    int num_pending;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::exception_ptr error;
+  };
+
+  ParallelForPool() {
+#ifndef _WIN32
+    pid_ = getpid();
+#endif
+  }
+
+  // Run one participant of a job and signal its end.
+  void RunParticipant(Job* job, int index) {
+    std::exception_ptr error;
+    in_participant_ = true;
+    try {
+      job->fjob(index);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    in_participant_ = false;
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (error && !job->error) job->error = error;
+    if (--job->num_pending == 0) job->cv.notify_all();
+  }
+
+  void RunWorker() {
+    while (true) {
+      std::shared_ptr<Job> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return !queue_.empty(); });
+        job = queue_.front();
+      }
+      int index = job->next_participant.fetch_add(1);
+      if (index < job->num_participants) {
+        RunParticipant(job.get(), index);
+      } else {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!queue_.empty() && queue_.front() == job) queue_.pop_front();
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // the jobs with participants left to claim
+  std::deque<std::shared_ptr<Job>> queue_;
+  std::vector<std::thread> workers_;
+#ifndef _WIN32
+  pid_t pid_;
+#endif
+  // whether the current thread runs a participant
+  static thread_local bool in_participant_;
+};
+
+thread_local bool ParallelForPool::in_participant_ = false;
+}  // namespace
+
 std::vector<std::vector<int>> rr_partitioner(int begin, int end, int step, int num_threads) {
   int total_task_count = (end - begin) / step;
   ICHECK_GE(total_task_count, 0) << "Infinite loop condition with begin: " << begin
@@ -49,45 +192,23 @@ std::vector<std::vector<int>> rr_partitioner(int begin, int end, int step, int n
 
 void parallel_for(int begin, int end, const std::function<void(int)>& f, int step,
                   const PartitionerFuncType partitioner) {
-  static bool GLOBAL_PARALLEL_FOR_FLAG{false};
-  static std::mutex M_GLOBAL_PARALLEL_FOR_FLAG;
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(!GLOBAL_PARALLEL_FOR_FLAG) << "There's another parallel_for running. Maybe you're "
-                                      << "currently inside another parallel_for loop.";
-    GLOBAL_PARALLEL_FOR_FLAG = true;
-  }
-
   int default_num_threads = std::thread::hardware_concurrency();
   const auto& run_partitions = partitioner(begin, end, step, default_num_threads);
-
-  std::vector<std::thread> threads;
-  threads.reserve(run_partitions.size());
-  std::vector<std::future<void>> res_vec;
-  res_vec.reserve(run_partitions.size());
-  for (const auto& run_partition : run_partitions) {
-    std::packaged_task<void(const std::vector<int>&, const std::function<void(int)>&)> task(
-        [](const std::vector<int>& run_partition, const std::function<void(int)>& f) {
-          for (const auto& i : run_partition) {
-            f(i);
-          }
-        });
-    res_vec.emplace_back(task.get_future());
-    threads.emplace_back(std::move(task), run_partition, f);
-  }
-
-  for (auto&& thread : threads) {
-    thread.join();
-  }
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(GLOBAL_PARALLEL_FOR_FLAG);
-    GLOBAL_PARALLEL_FOR_FLAG = false;
-  }
+  int num_partitions = static_cast<int>(run_partitions.size());
+  // A participant runs its partition, then steals the indices left in the others, which
+  // balances the iterations of irregular cost.
+  std::unique_ptr<std::atomic<size_t>[]> cursors(new std::atomic<size_t>[num_partitions]);
+  for (int i = 0; i < num_partitions; ++i) cursors[i].store(0);
   try {
-    for (auto&& i : res_vec) {
-      i.get();
-    }
+    ParallelForPool::Global()->Run(num_partitions, [&](int participant) {
+      for (int k = 0; k < num_partitions; ++k) {
+        int victim = (participant + k) % num_partitions;
+        const std::vector<int>& partition = run_partitions[victim];
+        for (size_t i; (i = cursors[victim].fetch_add(1)) < partition.size();) {
+          f(partition[i]);
+        }
+      }
+    });
   } catch (const std::exception& e) {
     LOG(FATAL) << "Parallel_for error with " << e.what();
   }
@@ -101,40 +222,15 @@ void parallel_for_dynamic(int begin, int end, int num_threads,
   }
   CHECK_LE(begin, end) << "ValueError: The interval [begin, end) requires `begin <= end`";
   CHECK_GT(num_threads, 0) << "ValueError: `num_threads` should be positive";
-  // Step 2. Launch threads
-  // Step 2.1. Launch worker 1 to worker `num_threads - 1`
+  // Step 2. Run `num_threads` participants fetching the next task until there is none left,
+  // the calling thread being worker 0.
   std::atomic<int> counter{begin};
-  std::vector<std::future<void>> futures;
-  std::vector<std::thread> threads;
-  futures.reserve(num_threads - 1);
-  threads.reserve(num_threads - 1);
-  auto worker = [end, &counter, &f](int thread_id) -> void {
-    for (int task_id; (task_id = counter++) < end;) {
-      f(thread_id, task_id);
-    }
-  };
-  for (int thread_id = 1; thread_id < num_threads; ++thread_id) {
-    std::packaged_task<void(int)> task(worker);
-    futures.emplace_back(task.get_future());
-    threads.emplace_back(std::move(task), thread_id);
-  }
-  // Step 2.2. Launch worker 0 inplace
-  try {
-    worker(0);
-  } catch (const std::exception& e) {
-    for (auto&& thread : threads) {
-      thread.join();
-    }
-    LOG(FATAL) << "RuntimeError: parallel_for_dynamic error with " << e.what();
-  }
-  // Step 3. Join threads and check exceptions
-  for (auto&& thread : threads) {
-    thread.join();
-  }
   try {
-    for (auto&& future : futures) {
-      future.get();
-    }
+    ParallelForPool::Global()->Run(num_threads, [end, &counter, &f](int thread_id) {
+      for (int task_id; (task_id = counter++) < end;) {
+        f(thread_id, task_id);
+      }
+    });
   } catch (const std::exception& e) {
     LOG(FATAL) << "RuntimeError: parallel_for_dynamic error with " << e.what();
   }
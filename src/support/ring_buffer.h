@@ -24,6 +24,8 @@
 #ifndef TVM_SUPPORT_RING_BUFFER_H_
 #define TVM_SUPPORT_RING_BUFFER_H_
 
+#include <tvm/runtime/logging.h>
+
 #include <algorithm>
 #include <cstring>
 #include <vector>
@@ -59,9 +61,16 @@ class RingBuffer {
       size_t new_size = static_cast<size_t>(n * 1.2);
       ring_.resize(new_size);
       if (head_ptr_ + bytes_available_ > old_size) {
-        // copy the ring overflow part into the tail.
         size_t ncopy = head_ptr_ + bytes_available_ - old_size;
-        memcpy(&ring_[0] + old_size, &ring_[0], ncopy);
+        if (ncopy <= new_size - old_size) {
+          // copy the ring overflow part into the tail.
+          memcpy(&ring_[0] + old_size, &ring_[0], ncopy);
+        } else {
+          // move the head part to the end, the overflow part does not fit after it.
+          size_t nhead = old_size - head_ptr_;
+          memmove(&ring_[0] + new_size - nhead, &ring_[0] + head_ptr_, nhead);
+          head_ptr_ = new_size - nhead;
+        }
       }
     } else if (ring_.size() > n * 8 && ring_.size() > kInitCapacity) {
       // shrink too large temporary buffer to
@@ -115,12 +124,13 @@ class RingBuffer {
     ICHECK_NE(size, 0U);
     size_t ncopy = std::min(size, ring_.size() - head_ptr_);
     size_t nsend = fsend(&ring_[0] + head_ptr_, ncopy);
-    bytes_available_ -= nsend;
     if (ncopy == nsend && ncopy < size) {
       size_t nsend2 = fsend(&ring_[0], size - ncopy);
-      bytes_available_ -= nsend2;
       nsend += nsend2;
     }
+    // a partial send leaves the rest at the new head
+    head_ptr_ = (head_ptr_ + nsend) % ring_.size();
+    bytes_available_ -= nsend;
     return nsend;
   }
   /*!
@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file spsc_queue.h
+ * \brief Bounded lock-free queue between one producer and one consumer thread.
+ */
+#ifndef TVM_SUPPORT_SPSC_QUEUE_H_
+#define TVM_SUPPORT_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace support {
+/*!
+ * \brief Bounded ring of objects shared by exactly one producer and one consumer thread.
+ *
+ *  Unlike RingBuffer, which grows on demand and is used from a single thread, the ring
+ *  has a fixed capacity and TryPush fails when it is full, which lets the producer apply
+ *  backpressure. Neither side takes a lock: each one owns an index and publishes it
+ *  with release semantics.
+ *
+ * \tparam T The element type, default constructible and movable.
+ */
+template <typename T>
+class SPSCQueue {
+ public:
+  /*!
+   * \brief constructor
+   * \param capacity The maximum number of elements in the queue.
+   */
+  explicit SPSCQueue(size_t capacity) : ring_(capacity + 1) {}
+  /*! \return The maximum number of elements in the queue. */
+  size_t capacity() const { return ring_.size() - 1; }
+  /*!
+   * \return The number of elements in the queue. Exact when called by the producer or
+   *  the consumer while the other side is idle, a snapshot otherwise.
+   */
+  size_t size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : tail + ring_.size() - head;
+  }
+  /*!
+   * \brief Append an element, only called by the producer.
+   * \param value The element, moved from only when it was appended.
+   * \return Whether the element was appended, false when the queue is full.
+   */
+  bool TryPush(T* value) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t next = Next(tail);
+    if (next == head_.load(std::memory_order_acquire)) return false;
+    ring_[tail] = std::move(*value);
+    tail_.store(next, std::memory_order_release);
+    return true;
+  }
+  /*!
+   * \brief Remove the oldest element, only called by the consumer.
+   * \param value The location the element is moved to.
+   * \return Whether an element was removed, false when the queue is empty.
+   */
+  bool TryPop(T* value) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return false;
+    *value = std::move(ring_[head]);
+    // drop what the moved-from slot still holds before handing it back
+    ring_[head] = T();
+    head_.store(Next(head), std::memory_order_release);
+    return true;
+  }
+
+ private:
+  size_t Next(size_t index) const { return index + 1 == ring_.size() ? 0 : index + 1; }
+
+  // The next slot to pop, written by the consumer only.
+  alignas(64) std::atomic<size_t> head_{0};
+  // The next slot to push, written by the producer only.
+  alignas(64) std::atomic<size_t> tail_{0};
+  // One more slot than the capacity, so that full and empty can be told apart.
+  std::vector<T> ring_;
+};
+}  // namespace support
+}  // namespace tvm
+#endif  // TVM_SUPPORT_SPSC_QUEUE_H_
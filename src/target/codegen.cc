@@ -87,8 +87,19 @@ class ModuleSerializer {
       if (!DSOExportable(group[0])) {
         ICHECK_EQ(group.size(), 1U) << "Non DSO module is never merged";
         std::string mod_type_key = group[0]->type_key();
-        stream->Write(mod_type_key);
-        group[0]->SaveToBinary(stream);
+        if (LazyLoadable(group[0])) {
+          // the size lets the runtime defer the deserialization until the module is used
+          std::string lazy_key = "_lazy";
+          std::string bin;
+          dmlc::MemoryStringStream ms(&bin);
+          group[0]->SaveToBinary(&ms);
+          stream->Write(lazy_key);
+          stream->Write(mod_type_key);
+          stream->Write(bin);
+        } else {
+          stream->Write(mod_type_key);
+          group[0]->SaveToBinary(stream);
+        }
       } else {
         // DSOExportable: do not need binary
         if (has_import_tree) {
@@ -223,6 +234,13 @@ class ModuleSerializer {
     return !std::strcmp(mod->type_key(), "llvm") || !std::strcmp(mod->type_key(), "c");
   }
 
+  // Whether a module is a device binary, which the runtime can load when it is first used.
+  bool LazyLoadable(const runtime::ModuleNode* mod) {
+    static const std::unordered_set<std::string> device_keys = {
+        "cuda", "rocm", "opencl", "vulkan", "metal", "sdaccel", "aocl"};
+    return mod->imports().empty() && device_keys.count(mod->type_key());
+  }
+
   runtime::Module mod_;
   // construct module to index
   std::unordered_map<runtime::ModuleNode*, size_t> mod2index_;
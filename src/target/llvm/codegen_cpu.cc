@@ -66,8 +66,10 @@ void CodeGenCPU::Init(const std::string& module_name, llvm::TargetMachine* tm,
   // typedef union { ... } TVMValue;
   t_tvm_value_ = llvm::StructType::create({t_float64_});
   // Defined in include/tvm/runtime/c_backend_api.h:
-  // typedef struct { void* sync_handle; int32_t num_task; } TVMParallelGroupEnv;
-  t_tvm_parallel_group_env_ = llvm::StructType::create({t_int32_->getPointerTo(), t_int32_});
+  // typedef struct { void* sync_handle; int32_t num_task; int32_t thread_budget; }
+  //     TVMParallelGroupEnv;
+  t_tvm_parallel_group_env_ =
+      llvm::StructType::create({t_int32_->getPointerTo(), t_int32_, t_int32_});
   // Defined in include/tvm/runtime/c_backend_api.h:
   // typedef int (*TVMBackendPackedCFunc)(TVMValue* args, int* type_codes, int num_args,
   //                                      TVMValue* out_ret_value, int* out_ret_tcode,
@@ -279,6 +281,18 @@ std::unique_ptr<llvm::Module> CodeGenCPU::Finish() {
   if (dbg_info_ != nullptr) {
     dbg_info_->di_builder_->finalize();
   }
+  if (inline_direct_calls_) {
+    // The operators of an AOT main function are inlined in it, their parameters are then
+    // passed in registers and the type checks of their arguments folded away. They stay
+    // exported, for the modules looking them up by name.
+    for (const std::string& name : direct_callees_) {
+      llvm::Function* func = module_->getFunction(name);
+      if (func != nullptr && !func->isDeclaration()) {
+        func->removeFnAttr(llvm::Attribute::NoInline);
+        func->addFnAttr(llvm::Attribute::AlwaysInline);
+      }
+    }
+  }
   return CodeGenLLVM::Finish();
 }
 
@@ -841,6 +855,65 @@ llvm::Value* CodeGenCPU::CreateCallPacked(const CallNode* op) {
   return pc.ret_value;
 }
 
+llvm::Value* CodeGenCPU::CreateCallCPacked(const CallNode* op) {
+  // tvm_call_cpacked_lowered(fname, stack_value, stack_tcode, begin, end, resource_handle)
+  ICHECK_EQ(op->args.size(), 6U);
+  std::string func_name = op->args[0].as<StringImmNode>()->value;
+  int64_t begin = op->args[3].as<IntImmNode>()->value;
+  // the last slot of the range is the one of the resource handle
+  int64_t nargs = op->args[4].as<IntImmNode>()->value - begin - 1;
+  ICHECK_GE(nargs, 0);
+  const std::string& resource_handle = op->args[5].as<StringImmNode>()->value;
+  CHECK_EQ(resource_handle, "no_device_context")
+      << "The LLVM backend does not support the device contexts of the C device API";
+  // The callee is usually defined in this module, after the functions calling it, see
+  // AddFunctionInternal. Being called directly, it can be inlined in the caller.
+  direct_callees_.insert(func_name);
+  llvm::FunctionType* ftype = llvm::FunctionType::get(
+      t_int_, {t_void_p_, t_void_p_, t_int_, t_void_p_, t_void_p_, t_void_p_}, false);
+  llvm::Function* func = module_->getFunction(func_name);
+  if (func == nullptr) {
+    func = llvm::Function::Create(ftype, llvm::Function::ExternalLinkage, func_name, module_.get());
+  }
+  llvm::Value* func_ptr = builder_->CreatePointerCast(func, ftype->getPointerTo());
+#if TVM_LLVM_VERSION >= 90
+  auto callee = llvm::FunctionCallee(ftype, func_ptr);
+#else
+  auto callee = func_ptr;
+#endif
+  llvm::Value* stack_value = MakeValue(op->args[1]);
+  llvm::Value* stack_tcode = MakeValue(op->args[2]);
+  llvm::Value* arg_value = builder_->CreateInBoundsGEP(
+      t_tvm_value_, builder_->CreatePointerCast(stack_value, t_tvm_value_->getPointerTo()),
+      ConstInt32(begin));
+  TypedPointer arg_tcode = CreateBufferPtr(DataType::Int(32), stack_tcode, ConstInt32(begin));
+  llvm::Value* ret_value =
+      WithFunctionEntry([&]() { return builder_->CreateAlloca(t_tvm_value_); });
+  llvm::Value* ret_tcode = WithFunctionEntry([&]() { return builder_->CreateAlloca(t_int_); });
+  llvm::Value* call = builder_->CreateCall(
+      callee, {builder_->CreatePointerCast(arg_value, t_void_p_),
+               builder_->CreatePointerCast(arg_tcode.addr, t_void_p_), ConstInt32(nargs),
+               builder_->CreatePointerCast(ret_value, t_void_p_),
+               builder_->CreatePointerCast(ret_tcode, t_void_p_),
+               llvm::Constant::getNullValue(t_void_p_)});
+  CheckCallSuccess(call);
+  return ConstInt32(0);
+}
+
+llvm::Value* CodeGenCPU::CreateLookupParam(const CallNode* op) {
+  ICHECK_EQ(op->args.size(), 1U);
+  const StringImmNode* name = op->args[0].as<StringImmNode>();
+  ICHECK(name != nullptr);
+  std::string symbol = std::string(::tvm::runtime::symbol::tvm_param_prefix) + name->value;
+  // declared here when LinkParameters has not run yet, which then defines it
+  llvm::GlobalVariable* param = module_->getGlobalVariable(symbol, true);
+  if (param == nullptr) {
+    param = new llvm::GlobalVariable(*module_, t_int8_, true, llvm::GlobalValue::ExternalLinkage,
+                                     nullptr, symbol);
+  }
+  return builder_->CreatePointerCast(param, t_void_p_);
+}
+
 llvm::Value* CodeGenCPU::CreateCallTracePacked(const CallNode* op) {
   ICHECK_EQ(op->args.size(), 6U);
   PackedCall pc = MakeCallPackedLowered(op->args, op->dtype, op->args[3].as<IntImmNode>()->value,
@@ -959,6 +1032,10 @@ llvm::Value* CodeGenCPU::CreateIntrinsic(const CallNode* op) {
     return CreateCallPacked(op);
   } else if (op->op.same_as(builtin::tvm_call_trace_packed_lowered())) {
     return CreateCallTracePacked(op);
+  } else if (op->op.same_as(builtin::tvm_call_cpacked_lowered())) {
+    return CreateCallCPacked(op);
+  } else if (op->op.same_as(builtin::lookup_param())) {
+    return CreateLookupParam(op);
   } else if (op->op.same_as(builtin::tvm_static_handle())) {
     return CreateStaticHandle();
   } else if (op->op.same_as(builtin::tvm_throw_last_error())) {
@@ -1055,7 +1132,14 @@ void CodeGenCPU::VisitStmt_(const AttrStmtNode* op) {
       parallel_env_.stride_pattern = true;
       this->VisitStmt(op->body);
     } else if (op->attr_key == "pragma_parallel_launch_point") {
-      CreateParallelLaunch(op->body, 0);
+      // the barriers need all the tasks running at once, one per thread
+      bool has_barrier = false;
+      tir::PostOrderVisit(op->body, [&has_barrier](const ObjectRef& node) {
+        if (const auto* attr = node.as<AttrStmtNode>()) {
+          has_barrier |= attr->attr_key == "pragma_parallel_barrier_when_finish";
+        }
+      });
+      CreateParallelLaunch(op->body, has_barrier ? -1 : 0);
     } else if (op->attr_key == "pragma_parallel_barrier_when_finish") {
       ICHECK(parallel_env_.penv != nullptr) << "Cannot run barrier without parallel environment";
       ICHECK(!parallel_env_.in_parallel_loop)
@@ -30,6 +30,7 @@
 #include <tvm/tir/op.h>
 
 #include <algorithm>
+#include <limits>
 
 #include "../../arith/pattern_match.h"
 #include "../build_common.h"
@@ -93,6 +94,10 @@ void CodeGenLLVM::InitTarget(llvm::TargetMachine* tm) {
       native_vector_bits_ = 256;
     } else if (arch == llvm::Triple::arm || arch == llvm::Triple::aarch64) {
       native_vector_bits_ = 128;
+    } else if (arch == llvm::Triple::wasm32 || arch == llvm::Triple::wasm64) {
+      // without SIMD128 the vectors are scalarized
+      bool simd128 = tm->getTargetFeatureString().find("+simd128") != llvm::StringRef::npos;
+      native_vector_bits_ = simd128 ? 128 : 32;
     } else {
       native_vector_bits_ = 128;
       std::string arch_name = std::string(tm->getTargetTriple().getArchName());
@@ -134,11 +139,21 @@ void CodeGenLLVM::AddFunctionInternal(const PrimFunc& f, bool ret_void) {
   auto global_symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol);
   ICHECK(global_symbol.defined())
       << "CodeGenLLVM: Expect PrimFunc to have the global_symbol attribute";
-  ICHECK(module_->getFunction(static_cast<std::string>(global_symbol.value())) == nullptr)
+  // a function called before it is defined, see CodeGenCPU::CreateCallCPacked, was declared
+  llvm::Function* declared = module_->getFunction(static_cast<std::string>(global_symbol.value()));
+  ICHECK(declared == nullptr || declared->isDeclaration())
       << "Function " << global_symbol << " already exist in module";
 
   function_ = llvm::Function::Create(ftype, llvm::Function::ExternalLinkage,
                                      global_symbol.value().operator std::string(), module_.get());
+  branch_prefix_ = global_symbol.value();
+  num_branches_ = 0;
+  if (declared != nullptr) {
+    declared->replaceAllUsesWith(
+        llvm::ConstantExpr::getPointerCast(function_, declared->getType()));
+    function_->takeName(declared);
+    declared->eraseFromParent();
+  }
   function_->setCallingConv(llvm::CallingConv::C);
   function_->setDLLStorageClass(llvm::GlobalValue::DLLStorageClassTypes::DLLExportStorageClass);
 
@@ -232,23 +247,56 @@ void CodeGenLLVM::LinkParameters(const Map<String, LinkedParam> params) {
   builder_->CreateStore(llvm::ConstantInt::get(t_int_, kTVMNullptr), ret_tcode);
   builder_->CreateRet(ConstInt32(kTvmErrorNoError));
 
-  // Add data to the global section.
+  // Pack the data of all parameters in one raw blob, each at an aligned offset. A single data
+  // array is emitted as plain bytes, instead of one constant per element, so that the time and
+  // memory taken to compile it stay flat with the size of the weights.
+  std::string blob;
+  std::vector<std::pair<std::string, size_t>> offsets;
+  size_t blob_align = tvm::runtime::kAllocAlignment;
+  bool big_endian = module_->getDataLayout().isBigEndian();
   for (auto kv : params) {
-    auto array = NDArrayToLLVMArray(ctx_, kv.second->param);
-    std::string symbol_name = std::string(::tvm::runtime::symbol::tvm_param_prefix) + kv.first;
-    llvm::GlobalVariable* param_symbol = new llvm::GlobalVariable(
-        *module_, array->getType(), true, llvm::GlobalValue::InternalLinkage, array, symbol_name);
     auto dtype = tvm::runtime::DataType(kv.second->param->dtype);
     size_t align = std::max(tvm::runtime::GetVectorBytes(dtype), tvm::runtime::kAllocAlignment);
+    blob.resize((blob.size() + align - 1) / align * align, '\0');
+    blob_align = std::max(blob_align, align);
+    offsets.emplace_back(kv.first, blob.size());
+    AppendNDArrayBytes(kv.second->param, big_endian, &blob);
+  }
+  llvm::Constant* blob_data = llvm::ConstantDataArray::getString(*ctx_, blob, false);
+  llvm::GlobalVariable* param_blob =
+      new llvm::GlobalVariable(*module_, blob_data->getType(), true,
+                               llvm::GlobalValue::InternalLinkage, blob_data, "__tvm_param_blob");
 #if TVM_LLVM_VERSION >= 100
-    param_symbol->setAlignment(llvm::Align(align));
+  param_blob->setAlignment(llvm::Align(blob_align));
 #else
-    param_symbol->setAlignment(align);
+  param_blob->setAlignment(blob_align);
 #endif
 
+  for (const auto& it : offsets) {
+    const String& name = it.first;
+    std::string symbol_name = std::string(::tvm::runtime::symbol::tvm_param_prefix) + name;
+    llvm::Constant* indices[] = {llvm::ConstantInt::get(t_int64_, 0),
+                                 llvm::ConstantInt::get(t_int64_, it.second)};
+    llvm::Constant* address =
+        llvm::ConstantExpr::getInBoundsGetElementPtr(blob_data->getType(), param_blob, indices);
+    // the parameters keep their symbols, as aliases into the blob
+    llvm::GlobalAlias* param_symbol =
+        llvm::GlobalAlias::create(t_int8_, GetGlobalAddressSpace(),
+                                  llvm::GlobalValue::InternalLinkage, symbol_name, address,
+                                  module_.get());
+    llvm::GlobalVariable* declared = module_->getGlobalVariable(symbol_name, true);
+    if (declared != nullptr) {
+      // the AOT main function was generated first, see CodeGenCPU::CreateLookupParam
+      declared->replaceAllUsesWith(
+          llvm::ConstantExpr::getPointerCast(param_symbol, declared->getType()));
+      param_symbol->takeName(declared);
+      declared->eraseFromParent();
+    }
+    const LinkedParam& param = params[name];
+
     llvm::BasicBlock* case_block = llvm::BasicBlock::Create(*ctx_, "case_" + symbol_name, function);
     switch_inst->addCase(
-        llvm::cast<llvm::ConstantInt>(llvm::ConstantInt::get(t_int64_, kv.second->id)), case_block);
+        llvm::cast<llvm::ConstantInt>(llvm::ConstantInt::get(t_int64_, param->id)), case_block);
     builder_->SetInsertPoint(case_block);
     builder_->CreateStore(builder_->CreatePointerCast(param_symbol, t_void_p_), ret_value);
     builder_->CreateStore(llvm::ConstantInt::get(t_int_, kTVMOpaqueHandle), ret_tcode);
@@ -701,6 +749,49 @@ llvm::Value* CodeGenLLVM::CreateVecConcat(std::vector<llvm::Value*> vecs) {
   return CreateVecSlice(vecs[0], 0, total_lanes);
 }
 
+llvm::MDNode* CodeGenLLVM::ProfileBranch(llvm::Value* cond, llvm::MDNode* default_weights) {
+  std::string name = branch_prefix_ + "." + std::to_string(num_branches_++);
+  if (instrument_branches_) {
+    llvm::GlobalVariable* counters[2];
+    for (int i = 0; i < 2; ++i) {
+      std::string counter_name = kBranchCounterPrefix + name + (i == 0 ? ".true" : ".false");
+      counters[i] = new llvm::GlobalVariable(*module_, t_int64_, false,
+                                             llvm::GlobalValue::ExternalLinkage,
+                                             llvm::ConstantInt::get(t_int64_, 0), counter_name);
+#if TVM_LLVM_VERSION >= 100
+      counters[i]->setAlignment(llvm::Align(8));
+#else
+      counters[i]->setAlignment(8);
+#endif
+    }
+    // the parallel loops may run a branch on several threads at once
+    llvm::Value* counter = builder_->CreateSelect(cond, counters[0], counters[1]);
+    llvm::Value* one = llvm::ConstantInt::get(t_int64_, 1);
+#if TVM_LLVM_VERSION >= 130
+    builder_->CreateAtomicRMW(llvm::AtomicRMWInst::Add, counter, one, llvm::MaybeAlign(),
+                              llvm::AtomicOrdering::Monotonic);
+#else
+    builder_->CreateAtomicRMW(llvm::AtomicRMWInst::Add, counter, one,
+                              llvm::AtomicOrdering::Monotonic);
+#endif
+    return default_weights;
+  }
+  if (branch_profile_ != nullptr) {
+    auto it = branch_profile_->find(name);
+    if (it != branch_profile_->end()) {
+      uint64_t true_count = it->second.first;
+      uint64_t false_count = it->second.second;
+      while (std::max(true_count, false_count) > std::numeric_limits<uint32_t>::max()) {
+        true_count >>= 1;
+        false_count >>= 1;
+      }
+      return md_builder_->createBranchWeights(static_cast<uint32_t>(true_count),
+                                              static_cast<uint32_t>(false_count));
+    }
+  }
+  return default_weights;
+}
+
 void CodeGenLLVM::CreateSerialFor(llvm::Value* begin, llvm::Value* end, llvm::Value* stride,
                                   const Var& loop_var, const Stmt& body) {
   using llvm::BasicBlock;
@@ -714,8 +805,8 @@ void CodeGenLLVM::CreateSerialFor(llvm::Value* begin, llvm::Value* end, llvm::Va
   loop_value->addIncoming(begin, pre_block);
   ICHECK(!var_map_.count(loop_var.get()));
   var_map_[loop_var.get()] = loop_value;
-  builder_->CreateCondBr(CreateLT(loop_var.dtype(), loop_value, end), for_body, for_end,
-                         md_very_likely_branch_);
+  llvm::Value* cond = CreateLT(loop_var.dtype(), loop_value, end);
+  builder_->CreateCondBr(cond, for_body, for_end, ProfileBranch(cond, md_very_likely_branch_));
   builder_->SetInsertPoint(for_body);
   this->VisitStmt(body);
   var_map_.erase(loop_var.get());
@@ -959,7 +1050,8 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
     BasicBlock* then_block = BasicBlock::Create(*ctx_, "if_then", function_);
     BasicBlock* else_block = BasicBlock::Create(*ctx_, "if_else", function_);
     BasicBlock* end_block = BasicBlock::Create(*ctx_, "if_end", function_);
-    builder_->CreateCondBr(MakeValue(op->args[0]), then_block, else_block);
+    llvm::Value* cond = MakeValue(op->args[0]);
+    builder_->CreateCondBr(cond, then_block, else_block, ProfileBranch(cond, nullptr));
     builder_->SetInsertPoint(then_block);
     llvm::Value* then_value = MakeValue(op->args[1]);
     BasicBlock* then_value_block = builder_->GetInsertBlock();
@@ -1223,6 +1315,24 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const LoadNode* op) {
         buffer_ptr.type = DTypeToLLVMType(t);
         buffer_ptr.addr =
             builder_->CreatePointerCast(buffer_ptr.addr, buffer_ptr.type->getPointerTo(addrspace));
+        if (!is_one(op->predicate)) {
+          // the disabled lanes are not accessed and read as zero
+          ICHECK(!is_volatile) << "A predicated load cannot be volatile";
+          llvm::Value* mask = MakeValue(op->predicate);
+          llvm::Value* zero = llvm::Constant::getNullValue(buffer_ptr.type);
+#if TVM_LLVM_VERSION >= 130
+          llvm::Instruction* load = builder_->CreateMaskedLoad(
+              buffer_ptr.type, buffer_ptr.addr, llvm::Align(alignment), mask, zero);
+#elif TVM_LLVM_VERSION >= 110
+          llvm::Instruction* load =
+              builder_->CreateMaskedLoad(buffer_ptr.addr, llvm::Align(alignment), mask, zero);
+#else
+          llvm::Instruction* load =
+              builder_->CreateMaskedLoad(buffer_ptr.addr, alignment, mask, zero);
+#endif
+          AddAliasInfo(load, op->buffer_var.get(), op->index);
+          return load;
+        }
 #if TVM_LLVM_VERSION >= 110
         llvm::LoadInst* load = builder_->CreateAlignedLoad(buffer_ptr.type, buffer_ptr.addr,
                                                            llvm::Align(alignment), is_volatile);
@@ -1237,6 +1347,8 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const LoadNode* op) {
       }
     }
   }
+  ICHECK(is_one(op->predicate)) << "Only the contiguous vector loads can be predicated, got "
+                                 << op->predicate;
   // scalarized load.
   int basic_align = t.bits() / 8;
   llvm::Value* ret = llvm::UndefValue::get(DTypeToLLVMType(t));
@@ -1319,7 +1431,6 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const BroadcastNode* op) {
 }
 
 void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
-  ICHECK(is_one(op->predicate)) << op->predicate;
   DataType t = op->value.dtype();
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
   llvm::Value* buffer = MakeValue(op->buffer_var);
@@ -1329,6 +1440,7 @@ void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
   if (t.lanes() == 1) {
     int alignment, native_bits;
     GetAlignment(t, op->buffer_var.get(), op->index, &alignment, &native_bits);
+    ICHECK(is_one(op->predicate)) << op->predicate;
     TypedPointer buffer_ptr = CreateBufferPtr(t, buffer, index);
 #if TVM_LLVM_VERSION >= 110
     llvm::StoreInst* store =
@@ -1353,6 +1465,20 @@ void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
         buffer_ptr.type = DTypeToLLVMType(t);
         buffer_ptr.addr =
             builder_->CreatePointerCast(buffer_ptr.addr, buffer_ptr.type->getPointerTo(addrspace));
+        if (!is_one(op->predicate)) {
+          // the disabled lanes are left untouched
+          ICHECK(!is_volatile) << "A predicated store cannot be volatile";
+          llvm::Value* mask = MakeValue(op->predicate);
+#if TVM_LLVM_VERSION >= 110
+          llvm::Instruction* store =
+              builder_->CreateMaskedStore(value, buffer_ptr.addr, llvm::Align(alignment), mask);
+#else
+          llvm::Instruction* store =
+              builder_->CreateMaskedStore(value, buffer_ptr.addr, alignment, mask);
+#endif
+          AddAliasInfo(store, op->buffer_var.get(), op->index);
+          return;
+        }
 #if TVM_LLVM_VERSION >= 110
         llvm::StoreInst* store = builder_->CreateAlignedStore(value, buffer_ptr.addr,
                                                               llvm::Align(alignment), is_volatile);
@@ -1365,6 +1491,8 @@ void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
       }
     }
   }
+  ICHECK(is_one(op->predicate)) << "Only the contiguous vector stores can be predicated, got "
+                                 << op->predicate;
   ICHECK_GE(t.bits(), 8);
   // scalarized store.
   int basic_align = t.bits() / 8;
@@ -1403,7 +1531,8 @@ void CodeGenLLVM::VisitStmt_(const WhileNode* op) {
   BasicBlock* while_merge = BasicBlock::Create(*ctx_, "while_merge", function_);
   builder_->CreateBr(while_cond);
   builder_->SetInsertPoint(while_cond);
-  builder_->CreateCondBr(MakeValue(op->condition), while_body, while_merge);
+  llvm::Value* cond = MakeValue(op->condition);
+  builder_->CreateCondBr(cond, while_body, while_merge, ProfileBranch(cond, nullptr));
   builder_->SetInsertPoint(while_body);
   this->VisitStmt(op->body);
   builder_->CreateBr(while_cond);
@@ -1417,7 +1546,7 @@ void CodeGenLLVM::VisitStmt_(const IfThenElseNode* op) {
   BasicBlock* end_block = BasicBlock::Create(*ctx_, "if_end", function_);
   if (op->else_case.defined()) {
     BasicBlock* else_block = BasicBlock::Create(*ctx_, "if_else", function_);
-    builder_->CreateCondBr(cond, then_block, else_block);
+    builder_->CreateCondBr(cond, then_block, else_block, ProfileBranch(cond, nullptr));
     builder_->SetInsertPoint(then_block);
     this->VisitStmt(op->then_case);
     builder_->CreateBr(end_block);
@@ -1425,7 +1554,8 @@ void CodeGenLLVM::VisitStmt_(const IfThenElseNode* op) {
     this->VisitStmt(op->else_case);
     builder_->CreateBr(end_block);
   } else {
-    builder_->CreateCondBr(cond, then_block, end_block, md_very_likely_branch_);
+    builder_->CreateCondBr(cond, then_block, end_block,
+                           ProfileBranch(cond, md_very_likely_branch_));
     builder_->SetInsertPoint(then_block);
     this->VisitStmt(op->then_case);
     builder_->CreateBr(end_block);
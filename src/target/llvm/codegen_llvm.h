@@ -84,6 +84,28 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
    * \param fmf FastMathFlags to use for code generation.
    */
   void SetFastMathFlag(llvm::FastMathFlags fmf);
+  /*!
+   * \brief Force the inlining of the functions of this module called directly.
+   * \param inline_direct_calls Whether to inline them.
+   */
+  void SetInlineDirectCalls(bool inline_direct_calls) { inline_direct_calls_ = inline_direct_calls; }
+
+  /*!
+   * \brief The number of times the conditional branches went to their true and false targets,
+   *  by branch name, the global symbol of the function and the index of the branch in it.
+   */
+  using BranchProfile = std::unordered_map<std::string, std::pair<uint64_t, uint64_t>>;
+  /*! \brief The prefix of the global counters of an instrumented branch. */
+  static constexpr const char* kBranchCounterPrefix = "__tvm_branch_count.";
+  /*!
+   * \brief Count the targets taken by the conditional branches, or weight them by a profile.
+   * \param instrument Whether to count them in the global counters of each branch.
+   * \param profile The counts of the branches, the static weights being used when null.
+   */
+  void SetBranchProfile(bool instrument, std::shared_ptr<const BranchProfile> profile) {
+    instrument_branches_ = instrument;
+    branch_profile_ = std::move(profile);
+  }
 
   /*!
    * \brief Compile and add function f to the current module.
@@ -324,6 +346,13 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   llvm::Value* CreateVecConcat(std::vector<llvm::Value*> vecs);
   llvm::Value* CreateVecPad(llvm::Value* vec, int target_lanes);
   // Create serial for
+  /*!
+   * \brief Count or weight the next conditional branch.
+   * \param cond The branch condition, at the insertion point of the branch.
+   * \param default_weights The static weights of the branch, may be null.
+   * \return The weights of the branch.
+   */
+  llvm::MDNode* ProfileBranch(llvm::Value* cond, llvm::MDNode* default_weights);
   void CreateSerialFor(llvm::Value* begin, llvm::Value* end, llvm::Value* stride,
                        const Var& loop_var, const Stmt& body);
   // add alias information.
@@ -374,6 +403,14 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   std::unordered_map<std::string, llvm::Constant*> str_map_;
   // Whether current function is restricted
   bool is_restricted_{true};
+  // Whether the functions called directly are inlined in their callers
+  bool inline_direct_calls_{false};
+  // Whether the conditional branches are counted, and the counts weighting them
+  bool instrument_branches_{false};
+  std::shared_ptr<const BranchProfile> branch_profile_;
+  // The global symbol of the current function and its number of profiled branches
+  std::string branch_prefix_;
+  int num_branches_{0};
   // The analyzer information
   std::unique_ptr<arith::Analyzer> analyzer_;
   // set of var that are not restricted(can alias)
@@ -190,7 +190,8 @@ static bool GetWarpShuffleIntrinsic(const CallNode* op, llvm::Intrinsic::ID* id)
   llvm::Intrinsic::ID ids[] = {
       llvm::Intrinsic::nvvm_shfl_idx_i32,  llvm::Intrinsic::nvvm_shfl_idx_f32,
       llvm::Intrinsic::nvvm_shfl_up_i32,   llvm::Intrinsic::nvvm_shfl_up_f32,
-      llvm::Intrinsic::nvvm_shfl_down_i32, llvm::Intrinsic::nvvm_shfl_down_f32};
+      llvm::Intrinsic::nvvm_shfl_down_i32, llvm::Intrinsic::nvvm_shfl_down_f32,
+      llvm::Intrinsic::nvvm_shfl_bfly_i32, llvm::Intrinsic::nvvm_shfl_bfly_f32};
 
   int offset = 0;
   if (op->op.same_as(builtin::tvm_warp_shuffle())) {
@@ -199,6 +200,8 @@ static bool GetWarpShuffleIntrinsic(const CallNode* op, llvm::Intrinsic::ID* id)
     offset = 2;
   } else if (op->op.same_as(builtin::tvm_warp_shuffle_down())) {
     offset = 4;
+  } else if (op->op.same_as(builtin::tvm_warp_shuffle_xor())) {
+    offset = 6;
   } else {
     return false;
   }
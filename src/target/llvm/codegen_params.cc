@@ -24,6 +24,8 @@
 
 #include "codegen_params.h"
 
+#include <dmlc/endian.h>
+
 #include <algorithm>
 #include <memory>
 #include <vector>
@@ -170,6 +172,27 @@ llvm::ConstantArray* NDArrayToLLVMArray(llvm::LLVMContext* ctx, ::tvm::runtime::
       llvm::ArrayType::get(element_type, num_elements), llvm::ArrayRef<llvm::Constant*>(elements)));
 }
 
+void AppendNDArrayBytes(::tvm::runtime::NDArray arr, bool big_endian, std::string* blob) {
+  auto arr_type = arr.DataType();
+  CHECK(arr.IsContiguous()) << "CodegenParams: only support contiguous arrays";
+  CHECK_EQ(arr->device.device_type, kDLCPU) << "CodegenParams: only support CPU arrays";
+  CHECK_EQ(arr_type.lanes(), 1) << "CodegenParams: only support generating 1-lane parameters; saw "
+                                << arr_type.lanes();
+  CHECK(arr_type.bits() == 8 || arr_type.bits() == 16 || arr_type.bits() == 32 ||
+        arr_type.bits() == 64)
+      << "CodegenParams: only support generating 8-, 16-, 32-, or 64-bit params; saw "
+      << arr_type.bits() << "-bit array";
+
+  size_t nbytes = ::tvm::runtime::GetDataSize(*arr.operator->());
+  size_t begin = blob->size();
+  const char* data = static_cast<const char*>(arr->data) + arr->byte_offset;
+  blob->append(data, nbytes);
+  if (big_endian == static_cast<bool>(DMLC_IO_NO_ENDIAN_SWAP)) {
+    int elem_bytes = arr_type.bits() / 8;
+    dmlc::ByteSwap(&(*blob)[begin], elem_bytes, nbytes / elem_bytes);
+  }
+}
+
 }  // namespace codegen
 }  // namespace tvm
 
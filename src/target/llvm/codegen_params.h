@@ -26,6 +26,8 @@
 
 #include <tvm/runtime/ndarray.h>
 
+#include <string>
+
 #include "llvm_common.h"
 
 namespace tvm {
@@ -42,6 +44,18 @@ namespace codegen {
  */
 llvm::ConstantArray* NDArrayToLLVMArray(llvm::LLVMContext* ctx, ::tvm::runtime::NDArray arr);
 
+/*!
+ * \brief Append the raw bytes of an NDArray to a blob, in the byte order of the target.
+ *
+ * Unlike NDArrayToLLVMArray, no constant is created per element, so that the blob can be
+ * emitted as a single data array whose cost does not grow with the number of elements.
+ *
+ * \param arr NDArray to append.
+ * \param big_endian Whether the target is big endian.
+ * \param blob The blob the bytes are appended to.
+ */
+void AppendNDArrayBytes(::tvm::runtime::NDArray arr, bool big_endian, std::string* blob);
+
 }  // namespace codegen
 }  // namespace tvm
 
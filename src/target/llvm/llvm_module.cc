@@ -24,12 +24,18 @@
 #ifdef TVM_LLVM_VERSION
 
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
+#include <tvm/relay/executor.h>
 #include <tvm/relay/runtime.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/target/codegen.h>
 
+#include <algorithm>
 #include <mutex>
+#include <sstream>
+#include <thread>
 
 #include "../../runtime/file_utils.h"
 #include "../../runtime/library_module.h"
@@ -46,6 +52,9 @@ using runtime::PackedFunc;
 using runtime::TVMArgs;
 using runtime::TVMRetValue;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.llvm.instrument_branches", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.llvm.branch_profile", String);
+
 class LLVMModuleNode final : public runtime::ModuleNode {
  public:
   ~LLVMModuleNode() {
@@ -87,6 +96,10 @@ class LLVMModuleNode final : public runtime::ModuleNode {
       }
       std::string target_triple = target_triple_ss.str();
       return PackedFunc([target_triple](TVMArgs args, TVMRetValue* rv) { *rv = target_triple; });
+    } else if (name == "get_branch_profile") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = this->GetBranchProfile();
+      });
     }
     if (ee_ == nullptr) LazyInitJIT();
 
@@ -228,6 +241,10 @@ class LLVMModuleNode final : public runtime::ModuleNode {
         mod->GetAttr<relay::Runtime>(tvm::attr::kRuntime).value_or(relay::Runtime::Create("cpp"));
     bool system_lib = runtime->GetAttr<Bool>("system-lib").value_or(Bool(false));
     bool target_c_runtime = runtime->name == "crt";
+    Optional<relay::Executor> executor = mod->GetAttr<relay::Executor>(tvm::attr::kExecutor);
+    bool inline_operators =
+        executor.defined() &&
+        executor.value()->GetAttr<Bool>("inline-operators").value_or(Bool(false));
 
     for (auto kv : mod->functions) {
       if (could_have_linked_params &&
@@ -307,16 +324,50 @@ class LLVMModuleNode final : public runtime::ModuleNode {
 #endif
 
     cg->SetFastMathFlag(fmf);
-
-    cg->AddFunctionsOrdered(funcs.begin(), funcs.end());
-    if (entry_func.length() != 0) {
-      cg->AddMainFunction(entry_func);
+    cg->SetInlineDirectCalls(inline_operators);
+
+    // The pass context is local to this thread, so it is read before the parts are generated.
+    tvm::transform::PassContext pass_ctx = tvm::transform::PassContext::Current();
+    bool instrument_branches =
+        pass_ctx->GetConfig<Bool>("tir.llvm.instrument_branches", Bool(false)).value();
+    String branch_profile_text =
+        pass_ctx->GetConfig<String>("tir.llvm.branch_profile", String("")).value();
+    std::shared_ptr<const CodeGenLLVM::BranchProfile> branch_profile;
+    if (!branch_profile_text.empty()) {
+      branch_profile = ParseBranchProfile(branch_profile_text);
     }
+    cg->SetBranchProfile(instrument_branches, branch_profile);
+
+    // The first part holds the module level definitions, the other parts are generated and
+    // optimized on their own threads, then linked into it.
+    std::vector<std::vector<PrimFunc>> parts =
+        SplitFunctions(funcs, entry_func, system_lib || target_c_runtime);
+    std::vector<std::string> part_bitcodes(parts.size());
+    support::parallel_for_dynamic(0, parts.size(), parts.size(), [&](int, int part_id) {
+      if (part_id != 0) {
+        part_bitcodes[part_id] =
+            GeneratePart(parts[part_id], target, fmf, instrument_branches, branch_profile);
+        return;
+      }
+      cg->AddFunctionsOrdered(parts[0].begin(), parts[0].end());
+      if (entry_func.length() != 0) {
+        cg->AddMainFunction(entry_func);
+      }
 
-    if (found_linked_params) {
-      cg->LinkParameters(linked_params);
+      if (found_linked_params) {
+        cg->LinkParameters(linked_params);
+      }
+      module_ = cg->Finish();
+    });
+    for (size_t i = 1; i < parts.size(); ++i) {
+      llvm::MemoryBufferRef buffer(part_bitcodes[i], "TVMModPart");
+      llvm::Expected<std::unique_ptr<llvm::Module>> part = llvm::parseBitcodeFile(buffer, *ctx_);
+      if (!part) {
+        LOG(FATAL) << "Failed to load a generated part: " << llvm::toString(part.takeError());
+      }
+      ICHECK(!llvm::Linker::linkModules(*module_, std::move(part.get())))
+          << "Failed to link modules";
     }
-    module_ = cg->Finish();
     module_->addModuleFlag(llvm::Module::Warning, "tvm_target",
                            llvm::MDString::get(*ctx_, LLVMTargetToString(target)));
     module_->addModuleFlag(llvm::Module::Override, "Debug Info Version",
@@ -375,6 +426,135 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   }
 
  private:
+  /*!
+   * \brief Split the functions into the parts generated in parallel.
+   *
+   *  The number of parts is set by the "tir.lower_num_threads" option of the pass context.
+   *  The parts are only connected through their external symbols, so the modules registering
+   *  their functions, i.e. the system libraries and the C runtime modules, are not split, nor
+   *  are the modules of the AOT executor.
+   */
+  static std::vector<std::vector<PrimFunc>> SplitFunctions(const std::vector<PrimFunc>& funcs,
+                                                           const std::string& entry_func,
+                                                           bool registers_functions) {
+    int num_threads = tvm::transform::PassContext::Current()
+                          ->GetConfig<Integer>("tir.lower_num_threads", Integer(1))
+                          .value();
+    if (num_threads == 0) {
+      num_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    // The AOT main function calls the operators directly, which are kept in its module so that
+    // they can be inlined in it.
+    bool has_runner = std::any_of(funcs.begin(), funcs.end(), [](const PrimFunc& f) {
+      return f->HasNonzeroAttr("runner_function");
+    });
+    size_t num_parts = registers_functions || has_runner
+                           ? 1
+                           : std::min<size_t>(num_threads, funcs.size());
+    if (num_parts <= 1) {
+      return {funcs};
+    }
+    // a deterministic split gives the same module on every build
+    std::vector<std::pair<std::string, PrimFunc>> sorted;
+    for (const PrimFunc& f : funcs) {
+      sorted.emplace_back(f->GetAttr<String>(tvm::attr::kGlobalSymbol).value(), f);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<std::vector<PrimFunc>> parts(num_parts);
+    size_t next_part = 0;
+    for (const auto& kv : sorted) {
+      // the main function refers to the entry function
+      if (kv.first == entry_func) {
+        parts[0].push_back(kv.second);
+      } else {
+        parts[next_part].push_back(kv.second);
+        next_part = (next_part + 1) % num_parts;
+      }
+    }
+    return parts;
+  }
+
+  /*!
+   * \brief Parse a branch profile, made of one "name taken not_taken" line per branch.
+   * \param text The profile.
+   * \return The counts of the branches by name.
+   */
+  static std::shared_ptr<const CodeGenLLVM::BranchProfile> ParseBranchProfile(
+      const std::string& text) {
+    auto profile = std::make_shared<CodeGenLLVM::BranchProfile>();
+    std::istringstream is(text);
+    std::string line;
+    while (std::getline(is, line)) {
+      std::istringstream line_is(line);
+      std::string name;
+      uint64_t taken, not_taken;
+      if (!(line_is >> name)) continue;
+      ICHECK(line_is >> taken >> not_taken)
+          << "Invalid line in the branch profile, expected \"name taken not_taken\": " << line;
+      (*profile)[name] = {taken, not_taken};
+    }
+    return profile;
+  }
+
+  /*!
+   * \brief Read the counters of the branches of a module built with the
+   *  "tir.llvm.instrument_branches" option.
+   * \return The profile, in the format of the "tir.llvm.branch_profile" option.
+   */
+  std::string GetBranchProfile() {
+    if (ee_ == nullptr) LazyInitJIT();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string prefix = CodeGenLLVM::kBranchCounterPrefix;
+    const std::string suffix = ".true";
+    std::vector<std::string> names;
+    for (const llvm::GlobalVariable& global : mptr_->globals()) {
+      std::string global_name = global.getName().str();
+      if (global_name.size() > prefix.size() + suffix.size() &&
+          global_name.compare(0, prefix.size(), prefix) == 0 &&
+          global_name.compare(global_name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        names.push_back(global_name.substr(
+            prefix.size(), global_name.size() - prefix.size() - suffix.size()));
+      }
+    }
+    std::sort(names.begin(), names.end());
+    std::ostringstream os;
+    for (const std::string& name : names) {
+      auto* taken = reinterpret_cast<const uint64_t*>(GetGlobalAddr(prefix + name + suffix));
+      auto* not_taken = reinterpret_cast<const uint64_t*>(GetGlobalAddr(prefix + name + ".false"));
+      ICHECK(taken != nullptr && not_taken != nullptr)
+          << "Cannot find the counters of the branch " << name;
+      os << name << " " << *taken << " " << *not_taken << "\n";
+    }
+    return os.str();
+  }
+
+  /*!
+   * \brief Generate and optimize the functions of a part in a context of its own.
+   * \return The bitcode of the part, which is loaded in the context of the module.
+   */
+  static std::string GeneratePart(
+      const std::vector<PrimFunc>& funcs, const Target& target, const llvm::FastMathFlags& fmf,
+      bool instrument_branches, std::shared_ptr<const CodeGenLLVM::BranchProfile> branch_profile) {
+    llvm::LLVMContext ctx;
+    std::unique_ptr<llvm::TargetMachine> tm = GetLLVMTargetMachine(target);
+    std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(tm.get());
+    cg->Init("TVMMod", tm.get(), &ctx, false, false, false);
+    cg->SetFastMathFlag(fmf);
+    cg->SetBranchProfile(instrument_branches, std::move(branch_profile));
+    cg->AddFunctionsOrdered(funcs.begin(), funcs.end());
+    std::unique_ptr<llvm::Module> module = cg->Finish();
+    std::string bitcode;
+    llvm::raw_string_ostream os(bitcode);
+#if TVM_LLVM_VERSION <= 60
+    llvm::WriteBitcodeToFile(module.get(), os);
+#else
+    llvm::WriteBitcodeToFile(*module, os);
+#endif
+    os.flush();
+    return bitcode;
+  }
+
   void LazyInitJIT() {
     std::lock_guard<std::mutex> lock(mutex_);
     if (ee_) {
@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "literal/cuda_half_t.h"
+#include "ptx.h"
 
 namespace tvm {
 namespace codegen {
@@ -713,6 +714,45 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
       this->PrintExpr(op->args[i * 2 + 1], os);
       os << "]" << ((i < 3) ? ", " : ")");
     }
+  } else if (op->op.same_as(builtin::ptx_mma())) {
+    ICHECK_EQ(op->args.size(), 13U);
+    auto str_arg = [op](int i) {
+      const StringImmNode* str = op->args[i].as<StringImmNode>();
+      ICHECK(str != nullptr) << "ptx_mma: argument " << i << " must be a string";
+      return std::string(str->value);
+    };
+    auto ref = [this, op](int i) {
+      return "(" + this->PrintExpr(op->args[i]) + " + " + this->PrintExpr(op->args[i + 1]) + ")";
+    };
+    os << PrintMMAAssembly(str_arg(0), str_arg(1), str_arg(2), str_arg(3), str_arg(4), str_arg(5),
+                           ref(6), ref(8), ref(10), !is_zero(op->args[12]));
+  } else if (op->op.same_as(builtin::ptx_ldmatrix())) {
+    ICHECK_EQ(op->args.size(), 6U);
+    const IntImmNode* num = op->args[1].as<IntImmNode>();
+    const StringImmNode* type = op->args[2].as<StringImmNode>();
+    ICHECK(num != nullptr && type != nullptr)
+        << "ptx_ldmatrix needs a constant number of matrices and a type";
+    std::string dst =
+        "(" + this->PrintExpr(op->args[3]) + " + " + this->PrintExpr(op->args[4]) + ")";
+    os << PrintLoadMatrixAssembly(!is_zero(op->args[0]), num->value, type->value, dst,
+                                  this->PrintExpr(op->args[5]));
+  } else if (op->op.same_as(builtin::ptx_cp_async())) {
+    ICHECK_EQ(op->args.size(), 3U);
+    const IntImmNode* bytes = op->args[2].as<IntImmNode>();
+    ICHECK(bytes != nullptr) << "ptx_cp_async needs a constant number of bytes";
+    os << "__asm__ __volatile__(\"cp.async.ca.shared.global [%0], [%1], " << bytes->value
+       << ";\" :: \"r\"(static_cast<unsigned>(__cvta_generic_to_shared(";
+    this->PrintExpr(op->args[0], os);
+    os << "))), \"l\"(";
+    this->PrintExpr(op->args[1], os);
+    os << "))";
+  } else if (op->op.same_as(builtin::ptx_commit_group())) {
+    os << "__asm__ __volatile__(\"cp.async.commit_group;\")";
+  } else if (op->op.same_as(builtin::ptx_wait_group())) {
+    ICHECK_EQ(op->args.size(), 1U);
+    const IntImmNode* num_pending = op->args[0].as<IntImmNode>();
+    ICHECK(num_pending != nullptr) << "ptx_wait_group needs a constant number of groups";
+    os << "__asm__ __volatile__(\"cp.async.wait_group " << num_pending->value << ";\")";
   } else if (op->op.same_as(builtin::tvm_bmma_sync())) {
     need_mma_h_ = true;
     ICHECK_EQ(op->args.size(), 8U);
@@ -22,13 +22,17 @@
  * \brief Generates a C interface header for a given modules inputs and outputs
  */
 
+#include <tvm/ir/expr.h>
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "../../relay/backend/name_transforms.h"
 
@@ -36,17 +40,21 @@ namespace tvm {
 namespace codegen {
 
 using runtime::PackedFunc;
+using runtime::TVMArgs;
+using runtime::TVMRetValue;
 using namespace tvm::relay::backend;
 
 class InterfaceCNode : public runtime::ModuleNode {
  public:
   InterfaceCNode(std::string module_name, Array<String> inputs, Array<String> outputs,
-                 Array<String> devices, int workspace_size)
+                 Array<String> devices, int workspace_size,
+                 Map<String, Integer> workspace_pool_sizes)
       : module_name_(module_name),
         inputs_(inputs),
         outputs_(outputs),
         devices_(devices),
-        workspace_size_(workspace_size) {}
+        workspace_size_(workspace_size),
+        workspace_pool_sizes_(workspace_pool_sizes) {}
   const char* type_key() const { return "h"; }
 
   std::string GetSource(const std::string& format) final {
@@ -65,6 +73,9 @@ class InterfaceCNode : public runtime::ModuleNode {
 
     EmitRunFunction(code);
     EmitWorkspaceSize(code);
+    if (!workspace_pool_sizes_.empty()) {
+      EmitWorkspacePools(code);
+    }
     EmitLowerHeaderGuard(code);
 
     return code.str();
@@ -154,20 +165,60 @@ class InterfaceCNode : public runtime::ModuleNode {
                 << "#define " << workspace_size_name << " " << workspace_size_ << "\n";
   }
 
+  void EmitWorkspacePools(std::stringstream& code_stream) {
+    // Sorted, so that the header does not depend on the order of the map.
+    std::vector<std::string> pool_names;
+    for (const auto& kv : workspace_pool_sizes_) {
+      pool_names.push_back(kv.first);
+    }
+    std::sort(pool_names.begin(), pool_names.end());
+    for (const std::string& pool_name : pool_names) {
+      std::string pool_size_name = ToCConstantStyle(
+          PrefixGeneratedName({module_name_, SanitizeName(pool_name), "WORKSPACE_POOL_SIZE"}));
+      std::string pool_var_name = ToCVariableStyle(PrefixGeneratedName({SanitizeName(pool_name)}));
+      code_stream << "\n/*!\n"
+                  << " * \\brief Size of the workspace pool \"" << pool_name
+                  << "\" for TVM module \"" << module_name_ << "\"\n"
+                  << " */\n"
+                  << "#define " << pool_size_name << " " << workspace_pool_sizes_[pool_name]->value
+                  << "\n\n"
+                  << "/*!\n"
+                  << " * \\brief Workspace pool \"" << pool_name
+                  << "\", shared by the TVM modules that never run concurrently.\n"
+                  << " * Its size is the largest of their workspace pool sizes.\n"
+                  << " */\n"
+                  << "extern uint8_t " << pool_var_name << "[];\n";
+    }
+  }
+
   std::string module_name_;
   Array<String> inputs_;
   Array<String> outputs_;
   Array<String> devices_;
   int workspace_size_;
+  Map<String, Integer> workspace_pool_sizes_;
 };
 
 runtime::Module InterfaceCCreate(std::string module_name, Array<String> inputs,
-                                 Array<String> outputs, Array<String> devices, int workspace_size) {
-  auto n = make_object<InterfaceCNode>(module_name, inputs, outputs, devices, workspace_size);
+                                 Array<String> outputs, Array<String> devices, int workspace_size,
+                                 Map<String, Integer> workspace_pool_sizes) {
+  auto n = make_object<InterfaceCNode>(module_name, inputs, outputs, devices, workspace_size,
+                                       workspace_pool_sizes);
   return runtime::Module(n);
 }
 
-TVM_REGISTER_GLOBAL("runtime.InterfaceCCreate").set_body_typed(InterfaceCCreate);
+runtime::Module InterfaceCCreate(std::string module_name, Array<String> inputs,
+                                 Array<String> outputs, Array<String> devices, int workspace_size) {
+  return InterfaceCCreate(module_name, inputs, outputs, devices, workspace_size, {});
+}
+
+TVM_REGISTER_GLOBAL("runtime.InterfaceCCreate").set_body([](TVMArgs args, TVMRetValue* rv) {
+  Map<String, Integer> workspace_pool_sizes;
+  if (args.size() > 5 && args[5].type_code() != kTVMNullptr) {
+    workspace_pool_sizes = args[5];
+  }
+  *rv = InterfaceCCreate(args[0], args[1], args[2], args[3], args[4], workspace_pool_sizes);
+});
 
 }  // namespace codegen
 }  // namespace tvm
@@ -21,6 +21,8 @@
  * \file intrin_rule_metal.cc
  * \brief Metal intrinsic rules.
  */
+#include <tvm/arith/analyzer.h>
+#include <tvm/tir/builtin.h>
 #include <tvm/tir/op_attr_types.h>
 #include <tvm/topi/elemwise.h>
 
@@ -109,6 +111,43 @@ static PrimExpr DispatchFastErf(const PrimExpr& e) {
 }
 TVM_REGISTER_OP("tir.erf").set_attr<FLowerIntrinsic>("metal.FLowerIntrinsic", DispatchFastErf);
 
+// The SIMD-group functions of Metal shuffle within the whole SIMD-group, whose width the
+// thread_warp_size of the target divides, and take no mask.
+template <const char* name>
+static PrimExpr DispatchMetalShuffle(const PrimExpr& e) {
+  const CallNode* call = e.as<CallNode>();
+  ICHECK(call != nullptr);
+  ICHECK_EQ(call->args.size(), 5);  // mask, value, warp_id, width, warp_size
+  arith::Analyzer analyzer;
+  ICHECK(analyzer.CanProve(call->args[3] == call->args[4]))
+      << "Metal SIMD-group shuffle does not support width != warp_size";
+  Array<PrimExpr> metal_args{{StringImm(name), call->args[1], call->args[2]}};
+  return Call(call->dtype, builtin::call_pure_extern(), metal_args);
+}
+
+static constexpr const char kMetalShuffle[] = "simd_shuffle";
+static constexpr const char kMetalShuffleUp[] = "simd_shuffle_up";
+static constexpr const char kMetalShuffleDown[] = "simd_shuffle_down";
+static constexpr const char kMetalShuffleXor[] = "simd_shuffle_xor";
+
+TVM_REGISTER_OP("tir.tvm_warp_shuffle")
+    .set_attr<FLowerIntrinsic>("metal.FLowerIntrinsic", DispatchMetalShuffle<kMetalShuffle>);
+
+TVM_REGISTER_OP("tir.tvm_warp_shuffle_up")
+    .set_attr<FLowerIntrinsic>("metal.FLowerIntrinsic", DispatchMetalShuffle<kMetalShuffleUp>);
+
+TVM_REGISTER_OP("tir.tvm_warp_shuffle_down")
+    .set_attr<FLowerIntrinsic>("metal.FLowerIntrinsic", DispatchMetalShuffle<kMetalShuffleDown>);
+
+TVM_REGISTER_OP("tir.tvm_warp_shuffle_xor")
+    .set_attr<FLowerIntrinsic>("metal.FLowerIntrinsic", DispatchMetalShuffle<kMetalShuffleXor>);
+
+// dummy because the SIMD-group functions take no mask
+TVM_REGISTER_OP("tir.tvm_warp_activemask")
+    .set_attr<FLowerIntrinsic>("metal.FLowerIntrinsic", [](const PrimExpr& e) -> PrimExpr {
+      return make_const(DataType::UInt(32), 0);
+    });
+
 }  // namespace intrin
 }  // namespace codegen
 }  // namespace tvm
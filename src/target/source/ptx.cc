@@ -0,0 +1,138 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file ptx.cc
+ * \brief Inline PTX assembly of the tensor core instructions.
+ */
+#include "ptx.h"
+
+#include <tvm/runtime/logging.h>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace codegen {
+
+namespace {
+
+/*! \brief The number of bits of a PTX type of the tensor core operands. */
+int PTXTypeBits(const std::string& dtype) {
+  if (dtype == "f16" || dtype == "bf16") return 16;
+  if (dtype == "tf32" || dtype == "f32" || dtype == "s32") return 32;
+  if (dtype == "s8" || dtype == "u8") return 8;
+  LOG(FATAL) << "mma.sync: unsupported type " << dtype;
+  return 0;
+}
+
+/*! \brief Whether an mma.sync configuration exists, on sm_80 and later for most of them. */
+bool IsSupportedMMA(int m, int n, int k, const std::string& a_dtype, const std::string& c_dtype) {
+  if (m != 16 || n != 8) return false;
+  if (a_dtype == "f16") return (k == 8 || k == 16) && (c_dtype == "f16" || c_dtype == "f32");
+  if (a_dtype == "bf16") return (k == 8 || k == 16) && c_dtype == "f32";
+  if (a_dtype == "tf32") return (k == 4 || k == 8) && c_dtype == "f32";
+  if (a_dtype == "s8" || a_dtype == "u8") return (k == 16 || k == 32) && c_dtype == "s32";
+  return false;
+}
+
+// Print the operands of one fragment, the registers a thread holds packed in 32 bits.
+void PrintOperands(const std::string& constraint, const std::string& reg_type,
+                   const std::string& ref, int num_regs, std::ostream& os) {
+  for (int i = 0; i < num_regs; ++i) {
+    if (i != 0) os << ", ";
+    os << "\"" << constraint << "\"(((" << reg_type << " *)(" << ref << "))[" << i << "])";
+  }
+}
+
+// Print the placeholders %first ... %(first + num - 1) of a fragment.
+void PrintPlaceholders(int first, int num, std::ostream& os) {
+  os << "{";
+  for (int i = 0; i < num; ++i) {
+    os << (i == 0 ? "" : ", ") << "%" << first + i;
+  }
+  os << "}";
+}
+
+}  // namespace
+
+std::string PrintMMAAssembly(const std::string& shape, const std::string& a_layout,
+                             const std::string& b_layout, const std::string& a_dtype,
+                             const std::string& b_dtype, const std::string& c_dtype,
+                             const std::string& a_ref, const std::string& b_ref,
+                             const std::string& c_ref, bool saturate) {
+  int m = 0, n = 0, k = 0;
+  ICHECK_EQ(sscanf(shape.c_str(), "m%dn%dk%d", &m, &n, &k), 3)
+      << "mma.sync: invalid shape " << shape;
+  ICHECK_EQ(a_dtype, b_dtype) << "mma.sync: the multiplicands must have the same type";
+  ICHECK(IsSupportedMMA(m, n, k, a_dtype, c_dtype))
+      << "mma.sync: unsupported configuration " << shape << " " << a_dtype << " -> " << c_dtype;
+  ICHECK(a_layout == "row" && b_layout == "col")
+      << "mma.sync: the " << shape << " shapes only support the row.col layout";
+  bool is_int = c_dtype == "s32";
+  ICHECK(!saturate || is_int) << "mma.sync: only the integer results can be saturated";
+  // The fragments are spread over the 32 threads of the warp, in 32 bit registers.
+  int a_regs = m * k * PTXTypeBits(a_dtype) / (32 * 32);
+  int b_regs = n * k * PTXTypeBits(b_dtype) / (32 * 32);
+  int c_regs = m * n * PTXTypeBits(c_dtype) / (32 * 32);
+
+  std::ostringstream os;
+  os << "__asm__ __volatile__(\"mma.sync.aligned." << shape << "." << a_layout << "." << b_layout
+     << (saturate ? ".satfinite" : "") << "." << c_dtype << "." << a_dtype << "." << b_dtype
+     << "." << c_dtype << " ";
+  PrintPlaceholders(0, c_regs, os);
+  os << ", ";
+  PrintPlaceholders(c_regs, a_regs, os);
+  os << ", ";
+  PrintPlaceholders(c_regs + a_regs, b_regs, os);
+  os << ", ";
+  // the accumulator is both the input and the output
+  PrintPlaceholders(0, c_regs, os);
+  os << ";\\n\" : ";
+  if (c_dtype == "f32") {
+    PrintOperands("+f", "float", c_ref, c_regs, os);
+  } else {
+    PrintOperands("+r", "unsigned", c_ref, c_regs, os);
+  }
+  os << " : ";
+  PrintOperands("r", "unsigned", a_ref, a_regs, os);
+  os << ", ";
+  PrintOperands("r", "unsigned", b_ref, b_regs, os);
+  os << ")";
+  return os.str();
+}
+
+std::string PrintLoadMatrixAssembly(bool trans, int num, const std::string& type,
+                                    const std::string& dst_ref, const std::string& src_ref) {
+  ICHECK(num == 1 || num == 2 || num == 4) << "ldmatrix: loads 1, 2 or 4 matrices, got " << num;
+  ICHECK_EQ(type, ".b16") << "ldmatrix: unsupported type " << type;
+  std::ostringstream os;
+  os << "__asm__ __volatile__(\"ldmatrix.sync.aligned.m8n8.x" << num << (trans ? ".trans" : "")
+     << ".shared" << type << " ";
+  PrintPlaceholders(0, num, os);
+  os << ", [%" << num << "];\\n\" : ";
+  PrintOperands("=r", "unsigned", dst_ref, num, os);
+  os << " : \"r\"(static_cast<unsigned>(__cvta_generic_to_shared(" << src_ref << "))))";
+  return os.str();
+}
+
+}  // namespace codegen
+}  // namespace tvm
@@ -0,0 +1,67 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file ptx.h
+ * \brief Inline PTX assembly of the tensor core instructions.
+ */
+#ifndef TVM_TARGET_SOURCE_PTX_H_
+#define TVM_TARGET_SOURCE_PTX_H_
+
+#include <string>
+
+namespace tvm {
+namespace codegen {
+
+/*!
+ * \brief Print the inline assembly of mma.sync, accumulating in place.
+ * \param shape The shape of the instruction, e.g. m16n8k16.
+ * \param a_layout The layout of the multiplicand A, row.
+ * \param b_layout The layout of the multiplicand B, col.
+ * \param a_dtype The PTX type of A, e.g. f16.
+ * \param b_dtype The PTX type of B.
+ * \param c_dtype The PTX type of the accumulator, e.g. f32.
+ * \param a_ref The pointer to the registers of A, printed.
+ * \param b_ref The pointer to the registers of B, printed.
+ * \param c_ref The pointer to the registers of the accumulator, printed.
+ * \param saturate Whether to saturate the integer results.
+ * \return The asm statement.
+ */
+std::string PrintMMAAssembly(const std::string& shape, const std::string& a_layout,
+                             const std::string& b_layout, const std::string& a_dtype,
+                             const std::string& b_dtype, const std::string& c_dtype,
+                             const std::string& a_ref, const std::string& b_ref,
+                             const std::string& c_ref, bool saturate);
+
+/*!
+ * \brief Print the inline assembly of ldmatrix, loading 8x8 matrices from the shared memory.
+ * \param trans Whether to transpose the matrices.
+ * \param num The number of matrices, 1, 2 or 4.
+ * \param type The PTX type of the elements, .b16.
+ * \param dst_ref The pointer to the registers loaded to, printed.
+ * \param src_ref The pointer to the shared memory the rows of this thread start at, printed.
+ * \return The asm statement.
+ */
+std::string PrintLoadMatrixAssembly(bool trans, int num, const std::string& type,
+                                    const std::string& dst_ref, const std::string& src_ref);
+
+}  // namespace codegen
+}  // namespace tvm
+
+#endif  // TVM_TARGET_SOURCE_PTX_H_
@@ -31,6 +31,7 @@
 #include <unordered_map>
 #include <utility>
 
+#include "../../relay/backend/name_transforms.h"
 #include "../../runtime/file_utils.h"
 #include "../../support/str_escape.h"
 #include "../func_registry_generator.h"
@@ -245,8 +246,8 @@ class CSourceCrtMetadataModuleNode : public runtime::ModuleNode {
                                     const std::string& mod_name) {
     code_ << "#include <" << mod_name << ".h>\n";
     code_ << "TVM_DLL int32_t " << run_func << "(";
-    unsigned int total_args =
-        (metadata_->inputs.size() + metadata_->devices.size() + metadata_->num_outputs);
+    unsigned int total_args = (metadata_->inputs.size() + metadata_->devices.size() +
+                               metadata_->num_outputs + metadata_->pools.size());
     for (unsigned int i = 0; i < total_args; ++i) {
       code_ << "void* arg" << i;
       if (i + 1 != total_args) {
@@ -290,6 +291,11 @@ class CSourceCrtMetadataModuleNode : public runtime::ModuleNode {
         }
       }
     }
+    // The workspace pools planned by the USMP are declared in the C interface header
+    for (const String& pool : metadata_->pools) {
+      code_ << "," << relay::backend::ToCVariableStyle(relay::backend::PrefixGeneratedName(
+                          {relay::backend::SanitizeName(pool)}));
+    }
 
     code_ << ");\n";
     code_ << "}\n";
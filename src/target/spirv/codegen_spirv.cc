@@ -27,6 +27,7 @@
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
 
+#include <sstream>
 #include <string>
 
 #include "../../runtime/pack_args.h"
@@ -126,6 +127,9 @@ void CodeGenSPIRV::InitFuncState() {
   std::fill(workgroup_size_, workgroup_size_ + 3, 1);
   var_map_.clear();
   storage_info_.clear();
+  fragment_shapes_.clear();
+  fragment_layouts_.clear();
+  fragment_info_.clear();
   analyzer_.reset(new arith::Analyzer());
   builder_.reset(new spirv::IRBuilder(spirv_support_));
   builder_->InitHeader();
@@ -350,6 +354,67 @@ spirv::Value CodeGenSPIRV::VisitExpr_(const CallNode* op) {
     return builder_->UIntImm(builder_->GetSType(op->dtype), val);
   } else if (op->op.same_as(builtin::tvm_storage_sync())) {
     return this->CreateStorageSync(op);
+  } else if (op->op.same_as(builtin::tvm_warp_shuffle()) ||
+             op->op.same_as(builtin::tvm_warp_shuffle_up()) ||
+             op->op.same_as(builtin::tvm_warp_shuffle_down()) ||
+             op->op.same_as(builtin::tvm_warp_shuffle_xor())) {
+    // mask, value, warp_id, width, warp_size
+    ICHECK_EQ(op->args.size(), 5U);
+    ICHECK(analyzer_->CanProve(op->args[3] == op->args[4]))
+        << "SPIR-V subgroup shuffle does not support width != warp_size";
+    spv::Op shuffle = spv::OpGroupNonUniformShuffle;
+    if (op->op.same_as(builtin::tvm_warp_shuffle_up())) {
+      shuffle = spv::OpGroupNonUniformShuffleUp;
+    } else if (op->op.same_as(builtin::tvm_warp_shuffle_down())) {
+      shuffle = spv::OpGroupNonUniformShuffleDown;
+    } else if (op->op.same_as(builtin::tvm_warp_shuffle_xor())) {
+      shuffle = spv::OpGroupNonUniformShuffleXor;
+    }
+    spirv::Value lane = MakeValue(cast(DataType::UInt(32), op->args[2]));
+    return builder_->SubgroupShuffle(shuffle, MakeValue(op->args[1]), lane);
+  } else if (op->op.same_as(builtin::tvm_warp_activemask())) {
+    // the subgroup operations take no mask
+    return builder_->UIntImm(builder_->GetSType(DataType::UInt(32)), 0);
+  } else if (op->op.same_as(builtin::tvm_fill_fragment())) {
+    ICHECK_EQ(op->args.size(), 6U);
+    const FragmentInfo& info = GetFragmentInfo(op->args[0]);
+    spirv::Value value = MakeValue(cast(info.dtype, op->args[5]));
+    spirv::Value matrix =
+        builder_->MakeValue(spv::OpCompositeConstruct, info.matrix_type, value);
+    builder_->MakeInst(spv::OpStore, GetFragment(info, op->args[4]), matrix);
+    return spirv::Value();
+  } else if (op->op.same_as(builtin::tvm_load_matrix_sync())) {
+    ICHECK_EQ(op->args.size(), 8U);
+    const FragmentInfo& info = GetFragmentInfo(op->args[0]);
+    spirv::Value matrix = builder_->CooperativeMatrixLoad(
+        info.matrix_type, GetAccessPtr(op->args[5], info.dtype), MakeValue(op->args[6]),
+        IsColumnMajor(info, op->args[7]));
+    builder_->MakeInst(spv::OpStore, GetFragment(info, op->args[4]), matrix);
+    return spirv::Value();
+  } else if (op->op.same_as(builtin::tvm_store_matrix_sync())) {
+    ICHECK_EQ(op->args.size(), 8U);
+    const FragmentInfo& info = GetFragmentInfo(op->args[0]);
+    spirv::Value matrix =
+        builder_->MakeValue(spv::OpLoad, info.matrix_type, GetFragment(info, op->args[4]));
+    builder_->CooperativeMatrixStore(GetAccessPtr(op->args[5], info.dtype), matrix,
+                                     MakeValue(op->args[6]), IsColumnMajor(info, op->args[7]));
+    return spirv::Value();
+  } else if (op->op.same_as(builtin::tvm_mma_sync())) {
+    // D = A * B + C, each given by a buffer and the index of a fragment
+    ICHECK_EQ(op->args.size(), 8U);
+    std::vector<spirv::Value> matrices;
+    for (int i = 1; i < 4; ++i) {
+      const FragmentInfo& info = GetFragmentInfo(op->args[i * 2]);
+      matrices.push_back(builder_->MakeValue(spv::OpLoad, info.matrix_type,
+                                             GetFragment(info, op->args[i * 2 + 1])));
+    }
+    const FragmentInfo& dst = GetFragmentInfo(op->args[0]);
+    ICHECK_EQ(dst.matrix_type.id, matrices[2].stype.id)
+        << "tvm_mma_sync needs the same type of accumulator for C and D";
+    spirv::Value result = builder_->MakeValue(spv::OpCooperativeMatrixMulAddNV, dst.matrix_type,
+                                              matrices[0], matrices[1], matrices[2]);
+    builder_->MakeInst(spv::OpStore, GetFragment(dst, op->args[1]), result);
+    return spirv::Value();
   } else if (op->op.same_as(builtin::if_then_else())) {
     ICHECK_EQ(op->args.size(), 3U);
     spirv::Value cond = MakeValue(op->args[0]);
@@ -641,8 +706,15 @@ void CodeGenSPIRV::VisitStmt_(const AllocateNode* op) {
   int32_t constant_size = op->constant_allocation_size();
   ICHECK_GT(constant_size, 0) << "Can only handle constant size stack allocation in GPU";
 
+  std::string scope = GetPtrStorageScope(op->buffer_var);
+  if (scope.find("wmma.") == 0) {
+    AllocateFragment(op, scope);
+    this->VisitStmt(op->body);
+    return;
+  }
+
   spirv::Value buf;
-  auto storage_scope = runtime::StorageScope::Create(GetPtrStorageScope(op->buffer_var));
+  auto storage_scope = runtime::StorageScope::Create(scope);
   spirv::SType etype = builder_->GetSType(op->dtype);
   if (storage_scope.rank == runtime::StorageRank::kLocal) {
     buf =
@@ -683,10 +755,115 @@ void CodeGenSPIRV::VisitStmt_(const AttrStmtNode* op) {
     const VarNode* v = op->node.as<VarNode>();
     ICHECK(v);
     storage_info_[v].is_volatile = true;
+  } else if (op->attr_key == tir::attr::fragment_shape) {
+    const VarNode* v = op->node.as<VarNode>();
+    const StringImmNode* shape = op->value.as<StringImmNode>();
+    ICHECK(v && shape);
+    fragment_shapes_[v] = shape->value;
+  } else if (op->attr_key == tir::attr::fragment_layout) {
+    const VarNode* v = op->node.as<VarNode>();
+    const StringImmNode* layout = op->value.as<StringImmNode>();
+    ICHECK(v && layout);
+    fragment_layouts_[v] = layout->value;
   }
   this->VisitStmt(op->body);
 }
 
+void CodeGenSPIRV::AllocateFragment(const AllocateNode* op, const std::string& scope) {
+  const VarNode* buffer_var = op->buffer_var.get();
+  auto it = fragment_shapes_.find(buffer_var);
+  ICHECK(it != fragment_shapes_.end())
+      << "Cannot find the fragment shape of " << buffer_var->name_hint
+      << ", which InferFragment attaches to the buffers in a wmma scope";
+  int m = 0, n = 0, k = 0;
+  char sep0 = 0, sep1 = 0;
+  std::istringstream is(it->second);
+  ICHECK(is >> m >> sep0 >> n >> sep1 >> k && sep0 == ',' && sep1 == ',')
+      << "Invalid fragment shape " << it->second;
+
+  FragmentInfo info;
+  info.dtype = op->dtype;
+  int rows, cols;
+  if (scope == "wmma.matrix_a" || scope == "wmma.matrix_b") {
+    ICHECK(op->dtype == DataType::Float(16))
+        << "The cooperative matrices of matrix_a and matrix_b only support half for now";
+    rows = scope == "wmma.matrix_a" ? m : k;
+    cols = scope == "wmma.matrix_a" ? k : n;
+    auto layout = fragment_layouts_.find(buffer_var);
+    if (layout != fragment_layouts_.end()) {
+      info.layout = layout->second;
+    }
+  } else {
+    ICHECK_EQ(scope, "wmma.accumulator");
+    ICHECK(op->dtype == DataType::Float(16) || op->dtype == DataType::Float(32))
+        << "The cooperative matrices of the accumulator only support half and float for now";
+    rows = m;
+    cols = n;
+  }
+  int32_t constant_size = op->constant_allocation_size();
+  ICHECK_EQ(constant_size % (rows * cols), 0)
+      << "The size of " << buffer_var->name_hint << " is not a multiple of the fragment size";
+  info.matrix_type = builder_->GetCooperativeMatrixType(op->dtype, static_cast<uint32_t>(rows),
+                                                        static_cast<uint32_t>(cols));
+  info.matrices = builder_->AllocateCooperativeMatrices(
+      info.matrix_type, static_cast<uint32_t>(constant_size / (rows * cols)));
+  builder_->SetName(info.matrices, buffer_var->name_hint);
+  ICHECK(!fragment_info_.count(buffer_var));
+  fragment_info_[buffer_var] = info;
+}
+
+const CodeGenSPIRV::FragmentInfo& CodeGenSPIRV::GetFragmentInfo(const PrimExpr& buffer_var) {
+  const VarNode* v = buffer_var.as<VarNode>();
+  ICHECK(v) << "Expected the buffer of a fragment, but got " << buffer_var;
+  auto it = fragment_info_.find(v);
+  ICHECK(it != fragment_info_.end()) << v->name_hint << " is not a buffer in a wmma scope";
+  return it->second;
+}
+
+spirv::Value CodeGenSPIRV::GetFragment(const FragmentInfo& info, const PrimExpr& index) {
+  return builder_->CooperativeMatrixAccess(info.matrix_type, info.matrices, MakeValue(index));
+}
+
+bool CodeGenSPIRV::IsColumnMajor(const FragmentInfo& info, const PrimExpr& layout) {
+  // The layout of matrix_a and matrix_b is the one of their fragment, as for CUDA.
+  if (!info.layout.empty()) {
+    return info.layout == "col_major";
+  }
+  const StringImmNode* str = layout.as<StringImmNode>();
+  ICHECK(str) << "Expected the layout row_major or col_major, but got " << layout;
+  ICHECK(str->value == "row_major" || str->value == "col_major")
+      << "Expected the layout row_major or col_major, but got " << str->value;
+  return str->value == "col_major";
+}
+
+spirv::Value CodeGenSPIRV::GetAccessPtr(const PrimExpr& access_ptr, DataType dtype) {
+  // LowerDeviceStorageAccessInfo rewrites tvm_access_ptr to address_of a load.
+  Var buffer_var;
+  PrimExpr index;
+  const CallNode* call = access_ptr.as<CallNode>();
+  if (call && call->op.same_as(builtin::address_of())) {
+    const LoadNode* load = call->args[0].as<LoadNode>();
+    ICHECK(load && load->dtype.is_scalar());
+    buffer_var = load->buffer_var;
+    index = load->index;
+  } else if (call && call->op.same_as(builtin::tvm_access_ptr())) {
+    buffer_var = Downcast<Var>(call->args[1]);
+    index = call->args[2];
+  } else {
+    LOG(FATAL) << "Expected the pointer of a cooperative matrix load or store, but got "
+               << access_ptr;
+  }
+  auto it = storage_info_.find(buffer_var.get());
+  ICHECK(it != storage_info_.end());
+  StorageInfo& info = it->second;
+  info.CheckContentType(dtype);
+
+  spirv::SType content_type = builder_->GetSType(info.element_type);
+  spirv::Value buffer = MakeValue(buffer_var);
+  spirv::SType ptr_type = builder_->GetPointerType(content_type, buffer.stype.storage_class);
+  return builder_->StructArrayAccess(ptr_type, buffer, MakeValue(index));
+}
+
 void CodeGenSPIRV::VisitStmt_(const AssertStmtNode* op) {
   With<arith::ConstraintContext> cctx(analyzer_.get(), op->condition);
   this->VisitStmt(op->body);
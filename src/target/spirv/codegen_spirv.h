@@ -171,6 +171,17 @@ class CodeGenSPIRV : public ExprFunctor<spirv::Value(const PrimExpr&)>,
       element_type_known = true;
     }
   };
+  /*! \brief The cooperative matrices backing a buffer in a wmma scope */
+  struct FragmentInfo {
+    /*! \brief The type of the elements. */
+    DataType dtype;
+    /*! \brief The type of each matrix. */
+    spirv::SType matrix_type;
+    /*! \brief The pointer to the array of matrices. */
+    spirv::Value matrices;
+    /*! \brief The layout of the matrix_a and matrix_b fragments, empty otherwise. */
+    std::string layout;
+  };
   // Reset the state so it works for a new function.
   void InitFuncState();
   // Get the thread index
@@ -178,6 +189,16 @@ class CodeGenSPIRV : public ExprFunctor<spirv::Value(const PrimExpr&)>,
 
   spirv::Value CreateStorageSync(const CallNode* op);
   void Scalarize(const PrimExpr& e, std::function<void(int i, spirv::Value v)> f);
+  // Allocate the cooperative matrices of a buffer in a wmma scope.
+  void AllocateFragment(const AllocateNode* op, const std::string& scope);
+  // Get the cooperative matrices of a buffer in a wmma scope.
+  const FragmentInfo& GetFragmentInfo(const PrimExpr& buffer_var);
+  // Get the pointer to a matrix of a buffer in a wmma scope.
+  spirv::Value GetFragment(const FragmentInfo& info, const PrimExpr& index);
+  // Whether a matrix is loaded or stored by columns, given the layout argument.
+  bool IsColumnMajor(const FragmentInfo& info, const PrimExpr& layout);
+  // Get the pointer to the element of a buffer given by a tvm_access_ptr call.
+  spirv::Value GetAccessPtr(const PrimExpr& access_ptr, DataType dtype);
 
   // SPIRV-related capabilities of the target
   SPIRVSupport spirv_support_;
@@ -203,6 +224,13 @@ class CodeGenSPIRV : public ExprFunctor<spirv::Value(const PrimExpr&)>,
   // the storage scope of allocation
   std::unordered_map<const VarNode*, StorageInfo> storage_info_;
 
+  // The fragment shape "m, n, k" and layout of the buffers in a wmma scope.
+  std::unordered_map<const VarNode*, std::string> fragment_shapes_;
+  std::unordered_map<const VarNode*, std::string> fragment_layouts_;
+
+  // The cooperative matrices of the buffers in a wmma scope.
+  std::unordered_map<const VarNode*, FragmentInfo> fragment_info_;
+
   // The definition of local variable.
   std::unordered_map<const VarNode*, spirv::Value> var_map_;
 
@@ -25,6 +25,8 @@
 
 #include <spirv.hpp>
 
+#include <algorithm>
+
 namespace tvm {
 namespace codegen {
 namespace spirv {
@@ -38,8 +40,8 @@ void IRBuilder::InitHeader() {
   header_.push_back(spv::MagicNumber);
 
   // Target SPIR-V version 1.0.  Additional functionality will be
-  // enabled through extensions.
-  header_.push_back(0x10000);
+  // enabled through extensions, or by raising the version in Finalize.
+  header_.push_back(spirv_version_);
 
   // generator: set to 0, unknown
   header_.push_back(0U);
@@ -78,6 +80,8 @@ std::vector<uint32_t> IRBuilder::Finalize() {
   // Index for upper bound of id numbers.
   const int kBoundLoc = 3;
   header_[kBoundLoc] = id_counter_;
+  const int kVersionLoc = 1;
+  header_[kVersionLoc] = spirv_version_;
   data.insert(data.end(), header_.begin(), header_.end());
   for (const auto& capability : capabilities_used_) {
     ib_.Begin(spv::OpCapability).Add(capability).Commit(&data);
@@ -197,6 +201,67 @@ Value IRBuilder::StructArrayAccess(const SType& res_type, Value buffer, Value in
   return MakeValue(spv::OpInBoundsAccessChain, res_type, buffer, const_i32_zero_, index);
 }
 
+SType IRBuilder::GetCooperativeMatrixType(const tvm::DataType& dtype, uint32_t rows,
+                                          uint32_t cols) {
+  ICHECK(spirv_support_.supports_cooperative_matrix)
+      << "Vulkan target does not support cooperative matrices.  "
+      << "Please either query the target from the device, or add "
+      << "-supports_cooperative_matrix=1 to the target.";
+  ICHECK(dtype.is_scalar()) << "The elements of a cooperative matrix must be scalars";
+  SType elem_type = GetSType(dtype);
+  auto key = std::make_tuple(elem_type.id, rows, cols);
+  auto it = cooperative_matrix_type_tbl_.find(key);
+  if (it != cooperative_matrix_type_tbl_.end()) {
+    return it->second;
+  }
+  capabilities_used_.insert(spv::CapabilityCooperativeMatrixNV);
+  extensions_used_.insert("SPV_NV_cooperative_matrix");
+  SType t;
+  t.id = id_counter_++;
+  t.type = DataType::Handle();
+  t.element_type_id = elem_type.id;
+  Value scope = UIntImm(t_uint32_, spv::ScopeSubgroup);
+  ib_.Begin(spv::OpTypeCooperativeMatrixNV)
+      .AddSeq(t, elem_type, scope, UIntImm(t_uint32_, rows), UIntImm(t_uint32_, cols))
+      .Commit(&global_);
+  cooperative_matrix_type_tbl_[key] = t;
+  return t;
+}
+
+Value IRBuilder::AllocateCooperativeMatrices(const SType& matrix_type, uint32_t num_elems) {
+  ICHECK_NE(num_elems, 0U);
+  // The matrices are opaque, so the array has no stride and no struct around it.
+  SType arr_type;
+  arr_type.id = id_counter_++;
+  arr_type.type = DataType::Handle();
+  arr_type.element_type_id = matrix_type.id;
+  Value length = UIntImm(t_uint32_, num_elems);
+  ib_.Begin(spv::OpTypeArray).AddSeq(arr_type, matrix_type, length).Commit(&global_);
+  SType ptr_type = GetPointerType(arr_type, spv::StorageClassFunction);
+  Value val = NewValue(ptr_type, kNormal);
+  ib_.Begin(spv::OpVariable)
+      .AddSeq(ptr_type, val, spv::StorageClassFunction)
+      .Commit(&func_header_);
+  return val;
+}
+
+Value IRBuilder::CooperativeMatrixAccess(const SType& matrix_type, Value matrices, Value index) {
+  SType ptr_type = GetPointerType(matrix_type, spv::StorageClassFunction);
+  return MakeValue(spv::OpAccessChain, ptr_type, matrices, index);
+}
+
+Value IRBuilder::CooperativeMatrixLoad(const SType& matrix_type, Value ptr, Value stride,
+                                       bool column_major) {
+  Value layout = UIntImm(t_bool_, column_major);
+  return MakeValue(spv::OpCooperativeMatrixLoadNV, matrix_type, ptr, stride, layout);
+}
+
+void IRBuilder::CooperativeMatrixStore(Value ptr, Value matrix, Value stride,
+                                       bool column_major) {
+  Value layout = UIntImm(t_bool_, column_major);
+  MakeInst(spv::OpCooperativeMatrixStoreNV, ptr, matrix, stride, layout);
+}
+
 Value IRBuilder::IntImm(const SType& dtype, int64_t value) {
   return GetConst_(dtype, reinterpret_cast<uint64_t*>(&value));
 }
@@ -603,6 +668,29 @@ Value IRBuilder::CallGLSL450(const SType& ret_type, uint32_t inst_id,
   return val;
 }
 
+Value IRBuilder::SubgroupShuffle(spv::Op op, const Value& value, const Value& lane) {
+  ICHECK_GE(spirv_support_.vulkan_api_version, VK_API_VERSION_1_1)
+      << "Vulkan target does not support subgroup operations, which need Vulkan 1.1.";
+  ICHECK(lane.stype.type.is_uint() && lane.stype.type.is_scalar())
+      << "The lane of a subgroup shuffle must be an unsigned integer";
+  capabilities_used_.insert(spv::CapabilityGroupNonUniform);
+  if (op == spv::OpGroupNonUniformShuffle || op == spv::OpGroupNonUniformShuffleXor) {
+    ICHECK(spirv_support_.supported_subgroup_operations & VK_SUBGROUP_FEATURE_SHUFFLE_BIT)
+        << "Vulkan target does not support the subgroup shuffle operations.";
+    capabilities_used_.insert(spv::CapabilityGroupNonUniformShuffle);
+  } else {
+    ICHECK(op == spv::OpGroupNonUniformShuffleUp || op == spv::OpGroupNonUniformShuffleDown);
+    ICHECK(spirv_support_.supported_subgroup_operations &
+           VK_SUBGROUP_FEATURE_SHUFFLE_RELATIVE_BIT)
+        << "Vulkan target does not support the relative subgroup shuffle operations.";
+    capabilities_used_.insert(spv::CapabilityGroupNonUniformShuffleRelative);
+  }
+  // SPIR-V 1.3
+  spirv_version_ = std::max<uint32_t>(spirv_version_, 0x10300);
+  Value scope = IntImm(t_int32_, spv::ScopeSubgroup);
+  return MakeValue(op, value.stype, scope, value, lane);
+}
+
 Value IRBuilder::Concat(const std::vector<Value>& vec) {
   bool is_const = vec[0].flag == kConstant;
   DataType etype = vec[0].stype.type;
@@ -420,6 +420,18 @@ class IRBuilder {
    * \return The result value.
    */
   Value CallGLSL450(const SType& ret_type, uint32_t inst_id, const std::vector<Value>& args);
+  /*!
+   * \brief Shuffle a value between the invocations of the subgroup.
+   *
+   *  The group operations need SPIR-V 1.3, which the module header then declares.
+   *
+   * \param op The OpGroupNonUniformShuffle instruction, or its Xor, Up or Down variant.
+   * \param value The value of the calling invocation.
+   * \param lane The unsigned source invocation id, or the one combined with the id of the
+   *  calling invocation.
+   * \return The value of the source invocation.
+   */
+  Value SubgroupShuffle(spv::Op op, const Value& value, const Value& lane);
   /*!
    * \brief Build vector by concatenating components
    *
@@ -458,6 +470,48 @@ class IRBuilder {
    * \param index The array index.
    */
   Value StructArrayAccess(const SType& ptr_type, Value buffer, Value index);
+  /*!
+   * \brief Get the type of a cooperative matrix, held by a whole subgroup.
+   * \param dtype The scalar type of the elements.
+   * \param rows The number of rows.
+   * \param cols The number of columns.
+   * \return The corresponding spirv type.
+   */
+  SType GetCooperativeMatrixType(const tvm::DataType& dtype, uint32_t rows, uint32_t cols);
+  /*!
+   * \brief Allocate an array of cooperative matrices in the function storage.
+   * \param matrix_type The type from GetCooperativeMatrixType.
+   * \param num_elems The number of matrices.
+   * \return The pointer to the array.
+   */
+  Value AllocateCooperativeMatrices(const SType& matrix_type, uint32_t num_elems);
+  /*!
+   * \brief Get the pointer to a matrix of an array of cooperative matrices.
+   * \param matrix_type The type of the matrices.
+   * \param matrices The pointer from AllocateCooperativeMatrices.
+   * \param index The index of the matrix.
+   */
+  Value CooperativeMatrixAccess(const SType& matrix_type, Value matrices, Value index);
+  /*!
+   * \brief Load a cooperative matrix from memory.
+   * \param matrix_type The type of the matrix.
+   * \param ptr The pointer to the first element.
+   * \param stride The number of elements between the starts of two rows, or of two columns
+   *  when column_major.
+   * \param column_major Whether the matrix is stored by columns.
+   * \return The loaded matrix.
+   */
+  Value CooperativeMatrixLoad(const SType& matrix_type, Value ptr, Value stride,
+                              bool column_major);
+  /*!
+   * \brief Store a cooperative matrix to memory.
+   * \param ptr The pointer to the first element.
+   * \param matrix The matrix.
+   * \param stride The number of elements between the starts of two rows, or of two columns
+   *  when column_major.
+   * \param column_major Whether the matrix is stored by columns.
+   */
+  void CooperativeMatrixStore(Value ptr, Value matrix, Value stride, bool column_major);
   /*!
    * \brief Create a cast that cast value to dst_type
    * \param dst_type The target type.
@@ -690,6 +744,8 @@ class IRBuilder {
   std::map<std::tuple<uint32_t, uint32_t, bool>, SType> struct_array_type_tbl_;
   /*! \brief map from value to its pointer type */
   std::map<std::pair<uint32_t, spv::StorageClass>, SType> pointer_type_tbl_;
+  /*! \brief map from element type and shape to the cooperative matrix type */
+  std::map<std::tuple<uint32_t, uint32_t, uint32_t>, SType> cooperative_matrix_type_tbl_;
   /*! \brief map from constant int to its value */
   std::map<std::pair<uint32_t, uint64_t>, Value> const_tbl_;
   /*! \brief map from name of a ExtInstImport to its value */
@@ -701,6 +757,8 @@ class IRBuilder {
    * section of SPIR-V documentation.
    */
   std::vector<uint32_t> header_;
+  /*! \brief The SPIR-V version declared in the header. */
+  uint32_t spirv_version_{0x10000};
   /*! \brief SPIR-V capabilities used by this module. */
   std::set<spv::Capability> capabilities_used_;
   /*! \brief SPIR-V extensions used by this module. */
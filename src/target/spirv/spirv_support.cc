@@ -84,6 +84,9 @@ SPIRVSupport::SPIRVSupport(tvm::Target target) {
   if (target->GetAttr<Bool>("supports_int64")) {
     supports_int64 = target->GetAttr<Bool>("supports_int64").value();
   }
+  if (target->GetAttr<Bool>("supports_cooperative_matrix")) {
+    supports_cooperative_matrix = target->GetAttr<Bool>("supports_cooperative_matrix").value();
+  }
 }
 
 }  // namespace codegen
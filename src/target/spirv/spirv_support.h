@@ -262,6 +262,22 @@ struct SPIRVSupport {
    * attempting to create a 64-bit int.
    */
   bool supports_int64{false};
+
+  /*!
+   * \brief Whether the driver supports cooperative matrices
+   *
+   * Vulkan extension: VK_NV_cooperative_matrix
+   * Vulkan struct: VkPhysicalDeviceCooperativeMatrixFeaturesNV
+   * Device Property: cooperativeMatrix
+   * SPV Extension name: SPV_NV_cooperative_matrix
+   * SPV Capability: CooperativeMatrixNV
+   *
+   * If support is present, the tensor core intrinsics
+   * (tvm_load_matrix_sync, tvm_mma_sync, ...) are lowered to
+   * cooperative matrix operations of a subgroup.  If support is not
+   * present, codegen will throw exception on attempting to use them.
+   */
+  bool supports_cooperative_matrix{false};
 };
 
 }  // namespace codegen
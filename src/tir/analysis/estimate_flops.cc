@@ -0,0 +1,163 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/analysis/estimate_flops.cc
+ * \brief Estimate the floating point operations and the memory traffic of PrimFuncs.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace tvm {
+namespace tir {
+
+/*!
+ * \brief Count the floating point operations and the bytes accessed in each buffer.
+ *
+ *  Every expression is weighted by the trip count of the loops and the GPU threads around
+ *  it. Both branches of a condition are counted, and a loop or a thread of unknown extent
+ *  is counted once.
+ */
+class FlopEstimator : public StmtExprVisitor {
+ public:
+  /*! \brief The floating point operations of the visited statements. */
+  double flops = 0;
+  /*! \brief The bytes read and written through each buffer variable. */
+  std::unordered_map<const VarNode*, double> accessed_bytes;
+
+ private:
+  void VisitStmt_(const ForNode* op) final { VisitScaled(op->extent, op->body); }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent || op->attr_key == attr::virtual_thread) {
+      VisitScaled(op->value, op->body);
+    } else {
+      StmtExprVisitor::VisitStmt_(op);
+    }
+  }
+
+  void VisitStmt_(const StoreNode* op) final {
+    Access(op->buffer_var.get(), op->value.dtype());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    Access(op->buffer->data.get(), op->value.dtype());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LoadNode* op) final {
+    Access(op->buffer_var.get(), op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    Access(op->buffer->data.get(), op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+#define TVM_FLOP_ESTIMATOR_BINARY(OpNode)    \
+  void VisitExpr_(const OpNode* op) final {  \
+    Count(op->dtype, 1);                     \
+    StmtExprVisitor::VisitExpr_(op);         \
+  }
+
+  TVM_FLOP_ESTIMATOR_BINARY(AddNode)
+  TVM_FLOP_ESTIMATOR_BINARY(SubNode)
+  TVM_FLOP_ESTIMATOR_BINARY(MulNode)
+  TVM_FLOP_ESTIMATOR_BINARY(DivNode)
+  TVM_FLOP_ESTIMATOR_BINARY(ModNode)
+  TVM_FLOP_ESTIMATOR_BINARY(FloorDivNode)
+  TVM_FLOP_ESTIMATOR_BINARY(FloorModNode)
+  TVM_FLOP_ESTIMATOR_BINARY(MinNode)
+  TVM_FLOP_ESTIMATOR_BINARY(MaxNode)
+#undef TVM_FLOP_ESTIMATOR_BINARY
+
+  void VisitExpr_(const CallNode* op) final {
+    // the calls selecting or reinterpreting values do no arithmetic, the math intrinsics
+    // count as one operation and a fused multiply add as two
+    if (op->op.as<OpNode>()) {
+      if (!op->op.same_as(builtin::if_then_else()) && !op->op.same_as(builtin::reinterpret()) &&
+          !op->op.same_as(builtin::likely())) {
+        Count(op->dtype, op->op.same_as(builtin::fma()) ? 2 : 1);
+      }
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitScaled(const PrimExpr& extent, const Stmt& body) {
+    double scale = scale_;
+    if (const IntImmNode* imm = extent.as<IntImmNode>()) {
+      scale_ *= static_cast<double>(imm->value);
+    }
+    VisitStmt(body);
+    scale_ = scale;
+  }
+
+  void Count(DataType dtype, int ops) {
+    if (dtype.is_float()) flops += scale_ * ops * dtype.lanes();
+  }
+
+  void Access(const VarNode* buffer_var, DataType dtype) {
+    accessed_bytes[buffer_var] += scale_ * dtype.bytes() * dtype.lanes();
+  }
+
+  /*! \brief The trip count of the visited statement. */
+  double scale_ = 1;
+};
+
+double EstimateTIRFlops(const PrimFunc& func) {
+  FlopEstimator estimator;
+  estimator(func->body);
+  return estimator.flops;
+}
+
+double EstimateTIRBytes(const PrimFunc& func) {
+  FlopEstimator estimator;
+  estimator(func->body);
+  double bytes = 0;
+  for (const Var& param : func->params) {
+    auto it = func->buffer_map.find(param);
+    if (it == func->buffer_map.end()) continue;
+    const Buffer& buffer = (*it).second;
+    auto accessed = estimator.accessed_bytes.find(buffer->data.get());
+    if (accessed == estimator.accessed_bytes.end()) continue;
+    // a buffer of unknown size is bounded by its accesses only
+    double size = buffer->dtype.bytes() * buffer->dtype.lanes();
+    for (const PrimExpr& dim : buffer->shape) {
+      const IntImmNode* imm = dim.as<IntImmNode>();
+      size = imm ? size * imm->value : std::numeric_limits<double>::infinity();
+    }
+    bytes += std::min(size, accessed->second);
+  }
+  return bytes;
+}
+
+TVM_REGISTER_GLOBAL("tir.analysis.estimate_tir_flops").set_body_typed(EstimateTIRFlops);
+TVM_REGISTER_GLOBAL("tir.analysis.estimate_tir_bytes").set_body_typed(EstimateTIRBytes);
+
+}  // namespace tir
+}  // namespace tvm
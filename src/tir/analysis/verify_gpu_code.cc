@@ -30,6 +30,10 @@
 #include <tvm/tir/stmt.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <map>
+#include <utility>
+
 #include "../transforms/ir_utils.h"
 
 namespace tvm {
@@ -40,7 +44,8 @@ class GPUCodeVerifier : public StmtExprVisitor {
   std::vector<String> Verify(Stmt stmt, int64_t max_local_memory_per_block,
                              int64_t max_shared_memory_per_block, int64_t max_threads_per_block,
                              int64_t max_thread_x, int64_t max_thread_y, int64_t max_thread_z,
-                             int64_t max_vthread, int64_t max_vector_bytes, int64_t max_kernels) {
+                             int64_t max_vthread, int64_t max_vector_bytes, int64_t max_kernels,
+                             int64_t max_shared_memory_bank_conflicts) {
     max_local_memory_per_block_ = static_cast<size_t>(max_local_memory_per_block);
     max_shared_memory_per_block_ = static_cast<size_t>(max_shared_memory_per_block);
     max_threads_per_block_ = static_cast<size_t>(max_threads_per_block);
@@ -50,6 +55,7 @@ class GPUCodeVerifier : public StmtExprVisitor {
     max_vthread_ = static_cast<size_t>(max_vthread);
     max_vector_bytes_ = static_cast<size_t>(max_vector_bytes);
     max_kernels_ = static_cast<size_t>(max_kernels);
+    max_shared_memory_bank_conflicts_ = static_cast<size_t>(max_shared_memory_bank_conflicts);
     Reset_();
 
     // TODO(jcf94): Add support of detecting CUDA Misaligned Address error
@@ -135,6 +141,14 @@ class GPUCodeVerifier : public StmtExprVisitor {
           err("threadIdx.y", length, thread_y_extent_);
           err("threadIdx.z", length, thread_z_extent_);
         }
+        // the loops of consecutive thread nests bind the same thread with different variables
+        if (name == "threadIdx.x") {
+          thread_vars_[0] = {var, extent->value};
+        } else if (name == "threadIdx.y") {
+          thread_vars_[1] = {var, extent->value};
+        } else if (name == "threadIdx.z") {
+          thread_vars_[2] = {var, extent->value};
+        }
       }
 
       nest_level_++;
@@ -154,6 +168,15 @@ class GPUCodeVerifier : public StmtExprVisitor {
         err("threads per block", thread_per_block_, max_threads_per_block_);
         err("local memory per block", local_memory_per_block_, max_local_memory_per_block_);
         err("shared memory per block", shared_memory_per_block_, max_shared_memory_per_block_);
+        for (const auto& kv : bank_conflicts_) {
+          if (kv.second > max_shared_memory_bank_conflicts_) {
+            std::stringstream s;
+            s << "Shared memory buffer " << kv.first << " is accessed with a " << kv.second
+              << "-way bank conflict, greater than the allowed maximum ("
+              << max_shared_memory_bank_conflicts_ << ")";
+            errors_.push_back(s.str());
+          }
+        }
 
         if (kernels_launched_ > max_kernels_) {
           std::stringstream s;
@@ -194,6 +217,7 @@ class GPUCodeVerifier : public StmtExprVisitor {
         errors_.push_back(s.str());
       }
     }
+    CheckBankConflicts_(op->buffer_var, op->index, op->dtype);
     ExprVisitor::VisitExpr_(op);
   }
 
@@ -208,10 +232,38 @@ class GPUCodeVerifier : public StmtExprVisitor {
         errors_.push_back(s.str());
       }
     }
+    CheckBankConflicts_(op->buffer_var, op->index, op->value->dtype);
     StmtVisitor::VisitStmt_(op);
   }
 
  private:
+  /*! \brief Record the bank conflicts of the first warp accessing a shared memory buffer. */
+  void CheckBankConflicts_(const Var& buffer_var, const PrimExpr& index, DataType dtype) {
+    if (max_shared_memory_bank_conflicts_ == static_cast<size_t>(INT64_MAX) || nest_level_ == 0) {
+      return;
+    }
+    String scope = GetPtrStorageScope(buffer_var);
+    if (scope != "shared" && scope != "shared.dyn") return;
+    PrimExpr base = index;
+    if (const auto* ramp = index.as<RampNode>()) {
+      if (!is_one(ramp->stride)) return;
+      base = ramp->base;
+    } else if (dtype.lanes() > 1) {
+      return;
+    }
+    std::vector<std::pair<Var, int64_t>> threads;
+    for (const auto& thread : thread_vars_) {
+      if (thread.second > 0) threads.push_back(thread);
+    }
+    std::vector<int64_t> offsets = EvalForWarpLanes(base, threads);
+    for (int64_t& offset : offsets) {
+      offset *= dtype.bytes();
+    }
+    size_t ways = SharedMemoryBankConflictWays(offsets, dtype.bytes() * dtype.lanes());
+    size_t& max_ways = bank_conflicts_[buffer_var->name_hint];
+    max_ways = std::max(max_ways, ways);
+  }
+
   int nest_level_{0};
 
   std::unordered_set<std::string> visited_threads_;
@@ -229,6 +281,12 @@ class GPUCodeVerifier : public StmtExprVisitor {
   size_t max_thread_x_, max_thread_y_, max_thread_z_, max_vthread_;
   size_t max_vector_bytes_;
   size_t max_kernels_;
+  size_t max_shared_memory_bank_conflicts_;
+
+  /*! \brief The threadIdx.x, threadIdx.y and threadIdx.z variables of the current kernel. */
+  std::pair<Var, int64_t> thread_vars_[3];
+  /*! \brief The largest bank conflict of each shared memory buffer of the current kernel. */
+  std::map<std::string, size_t> bank_conflicts_;
 
   std::vector<String> errors_;
 
@@ -238,6 +296,10 @@ class GPUCodeVerifier : public StmtExprVisitor {
 
     visited_threads_.clear();
     thread_per_block_ = 1;
+    for (auto& thread : thread_vars_) {
+      thread = {Var(), 0};
+    }
+    bank_conflicts_.clear();
   }
 };
 
@@ -253,6 +315,7 @@ std::vector<String> VerifyGPUCode_(const PrimFunc& func, Map<String, PrimExpr> c
   int64_t max_vthread = INT64_MAX;
   int64_t max_vector_bytes = INT64_MAX;
   int64_t max_kernels = INT64_MAX;
+  int64_t max_shared_memory_bank_conflicts = INT64_MAX;
 
   for (auto iter : constraints) {
     const IntImmNode* val = iter.second.as<IntImmNode>();
@@ -274,6 +337,8 @@ std::vector<String> VerifyGPUCode_(const PrimFunc& func, Map<String, PrimExpr> c
       max_vector_bytes = val->value;
     } else if (iter.first == "max_kernels") {
       max_kernels = val->value;
+    } else if (iter.first == "max_shared_memory_bank_conflicts") {
+      max_shared_memory_bank_conflicts = val->value;
     } else {
       LOG(FATAL) << "Invalid check item: " << iter.first;
     }
@@ -281,7 +346,8 @@ std::vector<String> VerifyGPUCode_(const PrimFunc& func, Map<String, PrimExpr> c
 
   return verifier.Verify(func->body, max_local_memory_per_block, max_shared_memory_per_block,
                          max_threads_per_block, max_thread_x, max_thread_y, max_thread_z,
-                         max_vthread, max_vector_bytes, max_kernels);
+                         max_vthread, max_vector_bytes, max_kernels,
+                         max_shared_memory_bank_conflicts);
 }
 
 bool VerifyGPUCode(const PrimFunc& func, Map<String, PrimExpr> constraints) {
@@ -0,0 +1,169 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file index_map.cc
+ */
+
+#include "tvm/tir/index_map.h"
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/int_set.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace tvm {
+namespace tir {
+
+IndexMap::IndexMap(Array<Var> initial_indices, Array<PrimExpr> final_indices) {
+  auto n = make_object<IndexMapNode>();
+  n->initial_indices = std::move(initial_indices);
+  n->final_indices = std::move(final_indices);
+  data_ = std::move(n);
+}
+
+Array<PrimExpr> IndexMapNode::MapIndices(const Array<PrimExpr>& indices) const {
+  CHECK_EQ(indices.size(), initial_indices.size())
+      << "ValueError: The index map expects " << initial_indices.size()
+      << " indices, but gets " << indices.size();
+
+  arith::Analyzer analyzer;
+  Map<Var, PrimExpr> vmap;
+  for (size_t i = 0; i < initial_indices.size(); ++i) {
+    vmap.Set(initial_indices[i], indices[i]);
+  }
+
+  Array<PrimExpr> output;
+  for (const PrimExpr& final_index : final_indices) {
+    output.push_back(analyzer.Simplify(Substitute(final_index, vmap)));
+  }
+  return output;
+}
+
+Array<Range> IndexMapNode::MapRanges(const Array<Range>& ranges) const {
+  CHECK_EQ(ranges.size(), initial_indices.size())
+      << "ValueError: The index map expects " << initial_indices.size()
+      << " ranges, but gets " << ranges.size();
+
+  arith::Analyzer analyzer;
+  std::unordered_map<const VarNode*, arith::IntSet> dom_map;
+  Map<Var, PrimExpr> vmap;
+  for (size_t i = 0; i < initial_indices.size(); ++i) {
+    const Range& range = ranges[i];
+    // A single point is substituted for an exact result, the other ranges are relaxed.
+    if (is_one(range->extent)) {
+      vmap.Set(initial_indices[i], range->min);
+    } else {
+      dom_map[initial_indices[i].get()] = arith::IntSet::FromRange(range);
+    }
+  }
+
+  Array<Range> output;
+  for (const PrimExpr& final_index : final_indices) {
+    arith::IntSet int_set = arith::EvalSet(Substitute(final_index, vmap), dom_map);
+    PrimExpr min = analyzer.Simplify(int_set.min());
+    PrimExpr extent = analyzer.Simplify(int_set.max() - int_set.min() + 1);
+    output.push_back(Range::FromMinExtent(min, extent));
+  }
+  return output;
+}
+
+Array<PrimExpr> IndexMapNode::MapShape(const Array<PrimExpr>& shape) const {
+  CHECK_EQ(shape.size(), initial_indices.size())
+      << "ValueError: The index map expects a shape of " << initial_indices.size()
+      << " dimensions, but gets " << shape.size();
+
+  Array<Range> ranges;
+  for (const PrimExpr& dim : shape) {
+    ranges.push_back(Range::FromMinExtent(make_zero(dim.dtype()), dim));
+  }
+  Array<PrimExpr> output;
+  for (const Range& range : MapRanges(ranges)) {
+    CHECK(is_zero(range->min)) << "ValueError: The index map does not map the shape to a range "
+                                  "starting at zero, but to one starting at "
+                               << range->min;
+    output.push_back(range->extent);
+  }
+  return output;
+}
+
+String IndexMapNode::ToPythonString() const {
+  // Rename the repeated index names, so that the lambda is valid python.
+  std::unordered_set<std::string> used_names;
+  Map<Var, PrimExpr> var_remap;
+  for (const Var& initial_index : initial_indices) {
+    if (used_names.count(initial_index->name_hint)) {
+      std::string new_name = initial_index->name_hint + std::to_string(used_names.size());
+      used_names.insert(new_name);
+      var_remap.Set(initial_index, Var(new_name));
+    } else {
+      used_names.insert(initial_index->name_hint);
+    }
+  }
+  std::ostringstream oss;
+  oss << "lambda ";
+  for (size_t i = 0; i < initial_indices.size(); ++i) {
+    if (i != 0) {
+      oss << ", ";
+    }
+    auto it = var_remap.find(initial_indices[i]);
+    if (it != var_remap.end()) {
+      oss << (*it).second;
+    } else {
+      oss << initial_indices[i];
+    }
+  }
+  oss << ": (";
+  for (size_t i = 0; i < final_indices.size(); ++i) {
+    oss << Substitute(final_indices[i], var_remap) << ",";
+    if (i + 1 != final_indices.size()) {
+      oss << " ";
+    }
+  }
+  oss << ")";
+  return String(oss.str());
+}
+
+TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
+    .set_dispatch<IndexMapNode>([](const ObjectRef& node, ReprPrinter* p) {
+      const auto* n = node.as<IndexMapNode>();
+      ICHECK(n);
+      p->stream << "index_map(" << n->ToPythonString() << ")";
+    });
+
+TVM_REGISTER_NODE_TYPE(IndexMapNode);
+
+TVM_REGISTER_GLOBAL("tir.IndexMap")
+    .set_body_typed([](Array<Var> initial_indices, Array<PrimExpr> final_indices) {
+      return IndexMap(initial_indices, final_indices);
+    });
+
+TVM_REGISTER_GLOBAL("tir.IndexMapMapIndices")
+    .set_body_method<IndexMap>(&IndexMapNode::MapIndices);
+
+TVM_REGISTER_GLOBAL("tir.IndexMapMapShape").set_body_method<IndexMap>(&IndexMapNode::MapShape);
+
+}  // namespace tir
+}  // namespace tvm
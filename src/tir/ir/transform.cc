@@ -23,12 +23,24 @@
  */
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
 namespace tvm {
 namespace tir {
 namespace transform {
 
+// The number of threads running the function passes and the LLVM code generation, 1 runs them
+// on the caller thread and 0 uses one thread per core. The pass functions must be thread safe
+// to use more than one.
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.lower_num_threads", Integer);
+
 /*!
  * \brief Function level pass that applies transformations to all
  *        TIR functions within the module.
@@ -91,17 +103,59 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   std::vector<ObjectRef> deleted_list;
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
   auto* func_dict = mod_ptr->functions.CopyOnWrite();
-  // directly loop over the underlying dict
-  for (auto& kv : *func_dict) {
-    // only picks up tir::PrimFunc
-    if (kv.second->IsInstance<PrimFuncNode>()) {
-      // move out the function so that it is the only copy.
-      PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
-      func = pass_func(std::move(func), mod, pass_ctx);
-      kv.second = std::move(func);
-
-      if (!kv.second.defined()) {
-        deleted_list.push_back(kv.first);
+  int num_threads = pass_ctx->GetConfig<Integer>("tir.lower_num_threads", Integer(1)).value();
+  if (num_threads == 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  // the keys and the values of the functions to run in parallel
+  std::vector<std::pair<ObjectRef, ObjectRef*>> funcs;
+  if (num_threads > 1) {
+    for (auto& kv : *func_dict) {
+      if (kv.second->IsInstance<PrimFuncNode>()) funcs.emplace_back(kv.first, &kv.second);
+    }
+  }
+  if (funcs.size() > 1) {
+    // The functions are not moved out, so that a pass reading the other functions of the module
+    // sees all of them, and the module is only written once all the functions are done.
+    std::vector<PrimFunc> results(funcs.size());
+    // the workers inherit the context without running its instruments again
+    auto worker_ctx_node = make_object<PassContextNode>(*pass_ctx.operator->());
+    worker_ctx_node->instruments.clear();
+    PassContext worker_ctx(worker_ctx_node);
+    Target target = Target::Current(true);
+    auto run = [&](int task_id) {
+      PrimFunc func = Downcast<PrimFunc>(*funcs[task_id].second);
+      results[task_id] = pass_func(std::move(func), mod, worker_ctx);
+    };
+    support::parallel_for_dynamic(0, funcs.size(), std::min<int>(num_threads, funcs.size()),
+                                  [&](int, int task_id) {
+                                    With<PassContext> ctx_scope(worker_ctx);
+                                    if (target.defined()) {
+                                      With<Target> target_scope(target);
+                                      run(task_id);
+                                    } else {
+                                      run(task_id);
+                                    }
+                                  });
+    for (size_t i = 0; i < funcs.size(); ++i) {
+      if (!results[i].defined()) {
+        deleted_list.push_back(funcs[i].first);
+      }
+      *funcs[i].second = std::move(results[i]);
+    }
+  } else {
+    // directly loop over the underlying dict
+    for (auto& kv : *func_dict) {
+      // only picks up tir::PrimFunc
+      if (kv.second->IsInstance<PrimFuncNode>()) {
+        // move out the function so that it is the only copy.
+        PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
+        func = pass_func(std::move(func), mod, pass_ctx);
+        kv.second = std::move(func);
+
+        if (!kv.second.defined()) {
+          deleted_list.push_back(kv.first);
+        }
       }
     }
   }
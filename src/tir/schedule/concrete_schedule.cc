@@ -182,10 +182,34 @@ void ConcreteScheduleNode::Copy(ScheduleState* new_state, TSymbolTable* new_symb
   new_state->get()->DebugVerify();
 }
 
+void ConcreteScheduleNode::ShareState(ConcreteScheduleNode* copy) const {
+  copy->state_ = this->state_;
+  copy->symbol_table_ = this->symbol_table_;
+  copy->state_shared_.store(true, std::memory_order_relaxed);
+  this->state_shared_.store(true, std::memory_order_relaxed);
+}
+
+void ConcreteScheduleNode::DetachState() const {
+  if (!state_shared_.exchange(false, std::memory_order_relaxed)) {
+    return;
+  }
+  ConcreteScheduleNode* self = const_cast<ConcreteScheduleNode*>(this);
+  if (state_.unique()) {
+    // The other copies detached already, their reads of the state happen before the writes.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return;
+  }
+  ScheduleState new_state{nullptr};
+  TSymbolTable new_symbol_table;
+  ConcreteScheduleNode::Copy(&new_state, &new_symbol_table);
+  self->state_ = std::move(new_state);
+  self->symbol_table_ = std::move(new_symbol_table);
+}
+
 Schedule ConcreteScheduleNode::Copy() const {
   ObjectPtr<ConcreteScheduleNode> n = make_object<ConcreteScheduleNode>();
   n->error_render_level_ = this->error_render_level_;
-  ConcreteScheduleNode::Copy(&n->state_, &n->symbol_table_);
+  ShareState(n.get());
   n->analyzer_ = std::make_unique<arith::Analyzer>();  // new analyzer needed because it is stateful
   return Schedule(std::move(n));
 }
@@ -236,7 +260,7 @@ Array<ExprRV> ConcreteScheduleNode::SamplePerfectTile(const LoopRV& loop_rv, int
                                                       int max_innermost_factor,
                                                       Optional<Array<Integer>> decision) {
   TVM_TIR_SCHEDULE_BEGIN();
-  return CreateRV(tir::SamplePerfectTile(&this->rand_state_, this->GetSRef(loop_rv), n,
+  return CreateRV(tir::SamplePerfectTile(&this->rand_state_, this->LookupSRef(loop_rv), n,
                                          max_innermost_factor, &decision));
   TVM_TIR_SCHEDULE_END("sample-perfect-tile", this->error_render_level_);
   throw;
@@ -289,13 +313,13 @@ BlockRV ConcreteScheduleNode::GetBlock(const String& name, const String& func_na
 }
 
 Array<LoopRV> ConcreteScheduleNode::GetLoops(const BlockRV& block_rv) {
-  return CreateRV<LoopRV>(tir::GetLoops(this->GetSRef(block_rv)));
+  return CreateRV<LoopRV>(tir::GetLoops(this->LookupSRef(block_rv)));
 }
 
 Array<BlockRV> ConcreteScheduleNode::GetChildBlocks(const BlockRV& block_rv) {
   Array<BlockRV> result;
   TVM_TIR_SCHEDULE_BEGIN();
-  result = CreateRV<BlockRV>(tir::GetChildBlocks(state_, this->GetSRef(block_rv)));
+  result = CreateRV<BlockRV>(tir::GetChildBlocks(state_, this->LookupSRef(block_rv)));
   TVM_TIR_SCHEDULE_END("get-child-blocks", this->error_render_level_);
   this->state_->DebugVerify();
   return result;
@@ -304,7 +328,7 @@ Array<BlockRV> ConcreteScheduleNode::GetChildBlocks(const BlockRV& block_rv) {
 Array<BlockRV> ConcreteScheduleNode::GetChildBlocks(const LoopRV& loop_rv) {
   Array<BlockRV> result;
   TVM_TIR_SCHEDULE_BEGIN();
-  result = CreateRV<BlockRV>(tir::GetChildBlocks(state_, this->GetSRef(loop_rv)));
+  result = CreateRV<BlockRV>(tir::GetChildBlocks(state_, this->LookupSRef(loop_rv)));
   TVM_TIR_SCHEDULE_END("get-child-blocks", this->error_render_level_);
   this->state_->DebugVerify();
   return result;
@@ -312,14 +336,14 @@ Array<BlockRV> ConcreteScheduleNode::GetChildBlocks(const LoopRV& loop_rv) {
 
 Array<BlockRV> ConcreteScheduleNode::GetProducers(const BlockRV& block_rv) {
   TVM_TIR_SCHEDULE_BEGIN();
-  return CreateRV<BlockRV>(tir::GetProducers(state_, this->GetSRef(block_rv)));
+  return CreateRV<BlockRV>(tir::GetProducers(state_, this->LookupSRef(block_rv)));
   TVM_TIR_SCHEDULE_END("get-producers", this->error_render_level_);
   throw;
 }
 
 Array<BlockRV> ConcreteScheduleNode::GetConsumers(const BlockRV& block_rv) {
   TVM_TIR_SCHEDULE_BEGIN();
-  return CreateRV<BlockRV>(tir::GetConsumers(state_, this->GetSRef(block_rv)));
+  return CreateRV<BlockRV>(tir::GetConsumers(state_, this->LookupSRef(block_rv)));
   TVM_TIR_SCHEDULE_END("get-consumers", this->error_render_level_);
   throw;
 }
@@ -327,6 +351,7 @@ Array<BlockRV> ConcreteScheduleNode::GetConsumers(const BlockRV& block_rv) {
 /******** Schedule: Transform loops ********/
 
 LoopRV ConcreteScheduleNode::Fuse(const Array<LoopRV>& loop_rvs) {
+  this->DetachState();
   CHECK(!loop_rvs.empty()) << "ValueError: 'fuse' requires at least 1 loop(s)";
   Array<StmtSRef> loop_srefs = this->GetSRefs(loop_rvs);
   StmtSRef result{nullptr};
@@ -339,6 +364,7 @@ LoopRV ConcreteScheduleNode::Fuse(const Array<LoopRV>& loop_rvs) {
 
 Array<LoopRV> ConcreteScheduleNode::Split(const LoopRV& loop_rv,
                                           const Array<Optional<ExprRV>>& factor_rvs) {
+  this->DetachState();
   class NotSingleInferFactorError : public ScheduleError {
    public:
     explicit NotSingleInferFactorError(IRModule mod) : mod_(mod) {}
@@ -413,6 +439,7 @@ Array<LoopRV> ConcreteScheduleNode::Split(const LoopRV& loop_rv,
 }
 
 void ConcreteScheduleNode::Reorder(const Array<LoopRV>& ordered_loop_rvs) {
+  this->DetachState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Reorder(state_, GetSRefs(ordered_loop_rvs));
   TVM_TIR_SCHEDULE_END("reorder", this->error_render_level_);
@@ -422,6 +449,7 @@ void ConcreteScheduleNode::Reorder(const Array<LoopRV>& ordered_loop_rvs) {
 /******** Schedule: Manipulate ForKind ********/
 
 void ConcreteScheduleNode::Parallel(const LoopRV& loop_rv) {
+  this->DetachState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Parallel(state_, this->GetSRef(loop_rv));
   this->state_->DebugVerify();
@@ -429,6 +457,7 @@ void ConcreteScheduleNode::Parallel(const LoopRV& loop_rv) {
 }
 
 void ConcreteScheduleNode::Vectorize(const LoopRV& loop_rv) {
+  this->DetachState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Vectorize(state_, this->GetSRef(loop_rv));
   this->state_->DebugVerify();
@@ -436,6 +465,7 @@ void ConcreteScheduleNode::Vectorize(const LoopRV& loop_rv) {
 }
 
 void ConcreteScheduleNode::Bind(const LoopRV& loop_rv, const String& thread_axis) {
+  this->DetachState();
   if (thread_axis == "vthread") {
     LOG(WARNING) << "`vthread` is legacy behavior and is going to be deprecated. Please use "
                     "`vthread.x`, `vthread.y` and `vthread.z` instead";
@@ -449,6 +479,7 @@ void ConcreteScheduleNode::Bind(const LoopRV& loop_rv, const String& thread_axis
 }
 
 void ConcreteScheduleNode::Unroll(const LoopRV& loop_rv) {
+  this->DetachState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::Unroll(state_, this->GetSRef(loop_rv));
   this->state_->DebugVerify();
@@ -459,6 +490,7 @@ void ConcreteScheduleNode::Unroll(const LoopRV& loop_rv) {
 
 BlockRV ConcreteScheduleNode::CacheRead(const BlockRV& block_rv, int read_buffer_index,
                                         const String& storage_scope) {
+  this->DetachState();
   StmtSRef result{nullptr};
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::CacheRead(state_, this->GetSRef(block_rv), read_buffer_index, storage_scope);
@@ -469,6 +501,7 @@ BlockRV ConcreteScheduleNode::CacheRead(const BlockRV& block_rv, int read_buffer
 
 BlockRV ConcreteScheduleNode::CacheWrite(const BlockRV& block_rv, int write_buffer_index,
                                          const String& storage_scope) {
+  this->DetachState();
   StmtSRef result{nullptr};
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::CacheWrite(state_, this->GetSRef(block_rv), write_buffer_index, storage_scope);
@@ -481,6 +514,7 @@ BlockRV ConcreteScheduleNode::CacheWrite(const BlockRV& block_rv, int write_buff
 
 void ConcreteScheduleNode::ComputeAt(const BlockRV& block_rv, const LoopRV& loop_rv,
                                      bool preserve_unit_loops) {
+  this->DetachState();
   static StmtSRef inline_mark = StmtSRef::InlineMark();
   static StmtSRef root_mark = StmtSRef::RootMark();
   StmtSRef loop_sref = this->GetSRef(loop_rv);
@@ -500,6 +534,7 @@ void ConcreteScheduleNode::ComputeAt(const BlockRV& block_rv, const LoopRV& loop
 
 void ConcreteScheduleNode::ReverseComputeAt(const BlockRV& block_rv, const LoopRV& loop_rv,
                                             bool preserve_unit_loops) {
+  this->DetachState();
   static StmtSRef inline_mark = StmtSRef::InlineMark();
   static StmtSRef root_mark = StmtSRef::RootMark();
   StmtSRef loop_sref = this->GetSRef(loop_rv);
@@ -518,6 +553,7 @@ void ConcreteScheduleNode::ReverseComputeAt(const BlockRV& block_rv, const LoopR
 }
 
 void ConcreteScheduleNode::ComputeInline(const BlockRV& block_rv) {
+  this->DetachState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::ComputeInline(state_, this->GetSRef(block_rv));
   TVM_TIR_SCHEDULE_END("compute-inline", this->error_render_level_);
@@ -525,6 +561,7 @@ void ConcreteScheduleNode::ComputeInline(const BlockRV& block_rv) {
 }
 
 void ConcreteScheduleNode::ReverseComputeInline(const BlockRV& block_rv) {
+  this->DetachState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::ReverseComputeInline(state_, this->GetSRef(block_rv));
   TVM_TIR_SCHEDULE_END("reverse-compute-inline", this->error_render_level_);
@@ -535,6 +572,7 @@ void ConcreteScheduleNode::ReverseComputeInline(const BlockRV& block_rv) {
 
 void ConcreteScheduleNode::StorageAlign(const BlockRV& block_rv, int buffer_index, int axis,
                                         int factor, int offset) {
+  this->DetachState();
   TVM_TIR_SCHEDULE_BEGIN();
   tir::StorageAlign(state_, this->GetSRef(block_rv), buffer_index, axis, factor, offset);
   TVM_TIR_SCHEDULE_END("storage-align", this->error_render_level_);
@@ -544,6 +582,7 @@ void ConcreteScheduleNode::StorageAlign(const BlockRV& block_rv, int buffer_inde
 /******** Schedule: Reduction ********/
 
 BlockRV ConcreteScheduleNode::DecomposeReduction(const BlockRV& block_rv, const LoopRV& loop_rv) {
+  this->DetachState();
   StmtSRef result{nullptr};
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::DecomposeReduction(state_, this->GetSRef(block_rv), this->GetSRef(loop_rv));
@@ -553,6 +592,7 @@ BlockRV ConcreteScheduleNode::DecomposeReduction(const BlockRV& block_rv, const
 }
 
 BlockRV ConcreteScheduleNode::RFactor(const LoopRV& loop_rv, int factor_axis) {
+  this->DetachState();
   StmtSRef result{nullptr};
   TVM_TIR_SCHEDULE_BEGIN();
   result = tir::RFactor(state_, this->GetSRef(loop_rv), factor_axis);
@@ -562,7 +602,45 @@ BlockRV ConcreteScheduleNode::RFactor(const LoopRV& loop_rv, int factor_axis) {
 }
 
 /******** Schedule: Blockize & Tensorize ********/
+
+BlockRV ConcreteScheduleNode::Blockize(const LoopRV& loop_rv) {
+  this->DetachState();
+  StmtSRef result{nullptr};
+  TVM_TIR_SCHEDULE_BEGIN();
+  result = tir::Blockize(state_, this->GetSRef(loop_rv));
+  TVM_TIR_SCHEDULE_END("blockize", this->error_render_level_);
+  this->state_->DebugVerify();
+  return CreateRV<BlockRV>(result);
+}
+
+void ConcreteScheduleNode::Tensorize(const LoopRV& loop_rv, const String& intrin) {
+  this->DetachState();
+  TVM_TIR_SCHEDULE_BEGIN();
+  tir::Tensorize(state_, this->GetSRef(loop_rv), tir::TensorIntrin::Get(intrin));
+  TVM_TIR_SCHEDULE_END("tensorize", this->error_render_level_);
+  this->state_->DebugVerify();
+}
+
+void ConcreteScheduleNode::Tensorize(const BlockRV& block_rv, const String& intrin) {
+  this->DetachState();
+  TVM_TIR_SCHEDULE_BEGIN();
+  tir::Tensorize(state_, this->GetSRef(block_rv), tir::TensorIntrin::Get(intrin));
+  TVM_TIR_SCHEDULE_END("tensorize", this->error_render_level_);
+  this->state_->DebugVerify();
+}
+
 /******** Schedule: Annotation ********/
+/******** Schedule: Layout transformation ********/
+
+void ConcreteScheduleNode::TransformLayout(const BlockRV& block_rv, int buffer_index,
+                                           bool is_write_index, const IndexMap& index_map) {
+  this->DetachState();
+  TVM_TIR_SCHEDULE_BEGIN();
+  tir::TransformLayout(state_, this->GetSRef(block_rv), buffer_index, is_write_index, index_map);
+  TVM_TIR_SCHEDULE_END("transform_layout", this->error_render_level_);
+  this->state_->DebugVerify();
+}
+
 /******** Schedule: Misc ********/
 
 }  // namespace tir
@@ -19,6 +19,7 @@
 #ifndef TVM_TIR_SCHEDULE_CONCRETE_SCHEDULE_H_
 #define TVM_TIR_SCHEDULE_CONCRETE_SCHEDULE_H_
 
+#include <atomic>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -46,6 +47,14 @@ class ConcreteScheduleNode : public ScheduleNode {
   std::unique_ptr<arith::Analyzer> analyzer_;
   /*! \brief The value of random state for sampling. */
   support::LinearCongruentialEngine::TRandState rand_state_;
+  /*!
+   * \brief Whether `state_` may be shared with the copies of the schedule, see DetachState.
+   *
+   *  A copy shares the state and the srefs of the symbol table with the schedule it was copied
+   *  from, and only deep copies them when either side is about to modify the state or to give
+   *  away one of its srefs, so the copies which are never modified cost next to nothing.
+   */
+  mutable std::atomic<bool> state_shared_{false};
 
  public:
   void VisitAttrs(tvm::AttrVisitor* v) {
@@ -54,12 +63,16 @@ class ConcreteScheduleNode : public ScheduleNode {
     // `symbol_table_` is not visited
     // `analyzer_` is not visited
     // `rand_state_` is not visited
+    // `state_shared_` is not visited
   }
 
   virtual ~ConcreteScheduleNode() = default;
 
  public:
-  ScheduleState state() const final { return state_; }
+  ScheduleState state() const final {
+    DetachState();
+    return state_;
+  }
   Optional<Trace> trace() const override { return NullOpt; }
   Schedule Copy() const override;
   void Seed(support::LinearCongruentialEngine::TRandState seed = -1) final;
@@ -119,7 +132,13 @@ class ConcreteScheduleNode : public ScheduleNode {
   void StorageAlign(const BlockRV& block_rv, int buffer_index, int axis, int factor,
                     int offset) override;
   /******** Schedule: Blockize & Tensorize ********/
+  BlockRV Blockize(const LoopRV& loop_rv) override;
+  void Tensorize(const BlockRV& block_rv, const String& intrin) override;
+  void Tensorize(const LoopRV& loop_rv, const String& intrin) override;
   /******** Schedule: Annotation ********/
+  /******** Schedule: Layout transformation ********/
+  void TransformLayout(const BlockRV& block_rv, int buffer_index, bool is_write_index,
+                       const IndexMap& index_map) override;
   /******** Schedule: Misc ********/
   void EnterPostproc() override {}
 
@@ -131,6 +150,28 @@ class ConcreteScheduleNode : public ScheduleNode {
    * \param new_symbol_table The symbol table copied
    */
   void Copy(ScheduleState* new_state, TSymbolTable* new_symbol_table) const;
+  /*!
+   * \brief Share the schedule state and the symbol table with a copy of the schedule.
+   * \param copy The copy.
+   */
+  void ShareState(ConcreteScheduleNode* copy) const;
+  /*!
+   * \brief Deep copy the schedule state and the symbol table if they are shared with a copy of
+   *  the schedule, to be called before modifying the state or giving away one of its srefs.
+   * \note It is const as the schedule is logically unchanged. The schedule itself is not thread
+   *  safe, but the schedule being copied may be copied by several threads at once.
+   */
+  void DetachState() const;
+  /*!
+   * \brief Find the sref of a block random variable, without detaching the state, for the
+   *  primitives only reading the state.
+   */
+  inline StmtSRef LookupSRef(const BlockRV& block_rv) const;
+  /*!
+   * \brief Find the sref of a loop random variable, without detaching the state, for the
+   *  primitives only reading the state.
+   */
+  inline StmtSRef LookupSRef(const LoopRV& loop_rv) const;
   /*!
    * \brief Add srefs as random variables into the symbol table
    * \tparam T The type of the random variables
@@ -168,13 +209,13 @@ class ConcreteScheduleNode : public ScheduleNode {
 /******** Lookup random variables ********/
 
 inline Block ConcreteScheduleNode::Get(const BlockRV& block_rv) const {
-  StmtSRef sref = this->GetSRef(block_rv);
+  StmtSRef sref = this->LookupSRef(block_rv);
   const BlockNode* block = TVM_SREF_TO_BLOCK(block, sref);
   return GetRef<Block>(block);
 }
 
 inline For ConcreteScheduleNode::Get(const LoopRV& loop_rv) const {
-  StmtSRef sref = this->GetSRef(loop_rv);
+  StmtSRef sref = this->LookupSRef(loop_rv);
   const ForNode* loop = TVM_SREF_TO_FOR(loop, sref);
   return GetRef<For>(loop);
 }
@@ -193,6 +234,16 @@ inline PrimExpr ConcreteScheduleNode::Get(const ExprRV& expr_rv) const {
 }
 
 inline StmtSRef ConcreteScheduleNode::GetSRef(const BlockRV& block_rv) const {
+  DetachState();
+  return LookupSRef(block_rv);
+}
+
+inline StmtSRef ConcreteScheduleNode::GetSRef(const LoopRV& loop_rv) const {
+  DetachState();
+  return LookupSRef(loop_rv);
+}
+
+inline StmtSRef ConcreteScheduleNode::LookupSRef(const BlockRV& block_rv) const {
   auto it = this->symbol_table_.find(block_rv);
   if (it == this->symbol_table_.end()) {
     LOG(FATAL) << "IndexError: Cannot find corresponding BlockRV: " << block_rv;
@@ -209,7 +260,7 @@ inline StmtSRef ConcreteScheduleNode::GetSRef(const BlockRV& block_rv) const {
   return GetRef<StmtSRef>(sref);
 }
 
-inline StmtSRef ConcreteScheduleNode::GetSRef(const LoopRV& loop_rv) const {
+inline StmtSRef ConcreteScheduleNode::LookupSRef(const LoopRV& loop_rv) const {
   static StmtSRef inline_mark = StmtSRef::InlineMark();
   static StmtSRef root_mark = StmtSRef::RootMark();
   auto it = this->symbol_table_.find(loop_rv);
@@ -0,0 +1,324 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "./ir_comparator.h"
+
+namespace tvm {
+namespace tir {
+
+/******** Statements ********/
+
+bool TensorizeComparator::VisitStmt(const Stmt& n, const Stmt& other) {
+  if (n.same_as(other)) return true;
+  if (n->type_index() != other->type_index()) {
+    std::ostringstream os;
+    os << "The statement types mismatch: " << n->GetTypeKey() << " vs " << other->GetTypeKey();
+    EmitError(os.str());
+    return false;
+  }
+  bool equal = StmtComparator::VisitStmt(n, other);
+  if (!equal) {
+    std::ostringstream os;
+    os << "The statements mismatch:\n" << n << "vs\n" << other;
+    EmitError(os.str());
+  }
+  return equal;
+}
+
+bool TensorizeComparator::VisitStmtDefault_(const Object* op, const Stmt& other) {
+  EmitError("The statement type " + op->GetTypeKey() + " is not supported");
+  return false;
+}
+
+bool TensorizeComparator::VisitStmt_(const ForNode* op, const Stmt& other) {
+  const auto* rhs = other.as<ForNode>();
+  return DefEqual(op->loop_var, rhs->loop_var) && VisitExpr(op->min, rhs->min) &&
+         VisitExpr(op->extent, rhs->extent) && op->kind == rhs->kind &&
+         VisitStmt(op->body, rhs->body);
+}
+
+bool TensorizeComparator::VisitStmt_(const SeqStmtNode* op, const Stmt& other) {
+  const auto* rhs = other.as<SeqStmtNode>();
+  return CompareArray(op->seq, rhs->seq, &TensorizeComparator::VisitStmt);
+}
+
+bool TensorizeComparator::VisitStmt_(const BufferStoreNode* op, const Stmt& other) {
+  const auto* rhs = other.as<BufferStoreNode>();
+  return CompareBufferAccess(op, rhs) && VisitExpr(op->value, rhs->value);
+}
+
+bool TensorizeComparator::VisitStmt_(const IfThenElseNode* op, const Stmt& other) {
+  const auto* rhs = other.as<IfThenElseNode>();
+  if (!VisitExpr(op->condition, rhs->condition) || !VisitStmt(op->then_case, rhs->then_case)) {
+    return false;
+  }
+  if (op->else_case.defined() != rhs->else_case.defined()) return false;
+  return !op->else_case.defined() || VisitStmt(op->else_case, rhs->else_case);
+}
+
+bool TensorizeComparator::VisitStmt_(const EvaluateNode* op, const Stmt& other) {
+  const auto* rhs = other.as<EvaluateNode>();
+  return VisitExpr(op->value, rhs->value);
+}
+
+bool TensorizeComparator::VisitStmt_(const BlockRealizeNode* op, const Stmt& other) {
+  const auto* rhs = other.as<BlockRealizeNode>();
+  // The bindings of the scope block refer to the loops outside of the comparison.
+  if (!is_scope_block_ &&
+      !CompareArray(op->iter_values, rhs->iter_values, &TensorizeComparator::VisitExpr)) {
+    return false;
+  }
+  return VisitExpr(op->predicate, rhs->predicate) && VisitStmt(op->block, rhs->block);
+}
+
+bool TensorizeComparator::VisitStmt_(const BlockNode* op, const Stmt& other) {
+  const auto* rhs = other.as<BlockNode>();
+  if (!is_scope_block_) {
+    if (!CompareArray(op->iter_vars, rhs->iter_vars, &TensorizeComparator::CompareIterVar) ||
+        !CompareArray(op->alloc_buffers, rhs->alloc_buffers, &TensorizeComparator::CompareBuffer)) {
+      return false;
+    }
+    // The allocated buffers are accessed from their origin.
+    for (const Buffer& buffer : op->alloc_buffers) {
+      buffer_indices_[buffer] = std::vector<PrimExpr>(buffer->shape.size(), Integer(0));
+    }
+    if (!op->match_buffers.empty() || !rhs->match_buffers.empty()) {
+      EmitError("The blocks inside of the scope block cannot have match_buffers");
+      return false;
+    }
+  }
+  // The regions of the scope block fix the base indices of the buffer accesses inside of it.
+  if (!CompareArray(op->writes, rhs->writes, &TensorizeComparator::CompareBufferRegion) ||
+      !CompareArray(op->reads, rhs->reads, &TensorizeComparator::CompareBufferRegion)) {
+    return false;
+  }
+  is_scope_block_ = false;
+  if (op->init.defined() != rhs->init.defined()) {
+    EmitError("The blocks mismatch in whether they have an init statement");
+    return false;
+  }
+  if (op->init.defined() && !VisitStmt(op->init.value(), rhs->init.value())) return false;
+  return VisitStmt(op->body, rhs->body);
+}
+
+/******** Expressions ********/
+
+bool TensorizeComparator::VisitExpr(const PrimExpr& n, const PrimExpr& other) {
+  // Only the type codes are compared, so the indices may differ in their bit widths.
+  bool equal = n.same_as(other) ||
+               (n->type_index() == other->type_index() &&
+                n.dtype().code() == other.dtype().code() && ExprComparator::VisitExpr(n, other));
+  if (!equal) {
+    std::ostringstream os;
+    os << "The expressions mismatch: " << n << " vs " << other;
+    EmitError(os.str());
+  }
+  return equal;
+}
+
+bool TensorizeComparator::VisitExprDefault_(const Object* op, const PrimExpr& other) {
+  EmitError("The expression type " + op->GetTypeKey() + " is not supported");
+  return false;
+}
+
+#define TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(OpName)                            \
+  bool TensorizeComparator::VisitExpr_(const OpName* op, const PrimExpr& other) { \
+    const auto* rhs = other.as<OpName>();                                         \
+    return VisitExpr(op->a, rhs->a) && VisitExpr(op->b, rhs->b);                  \
+  }
+
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(AddNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(SubNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(MulNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(DivNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(ModNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(FloorDivNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(FloorModNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(MinNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(MaxNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(EQNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(NENode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(LTNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(LENode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(GTNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(GENode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(AndNode);
+TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP(OrNode);
+
+#undef TVM_DECLARE_TENSORIZE_COMPARATOR_BINOP
+
+bool TensorizeComparator::VisitExpr_(const NotNode* op, const PrimExpr& other) {
+  const auto* rhs = other.as<NotNode>();
+  return VisitExpr(op->a, rhs->a);
+}
+
+bool TensorizeComparator::VisitExpr_(const SelectNode* op, const PrimExpr& other) {
+  const auto* rhs = other.as<SelectNode>();
+  return VisitExpr(op->condition, rhs->condition) && VisitExpr(op->true_value, rhs->true_value) &&
+         VisitExpr(op->false_value, rhs->false_value);
+}
+
+bool TensorizeComparator::VisitExpr_(const CastNode* op, const PrimExpr& other) {
+  const auto* rhs = other.as<CastNode>();
+  return op->dtype == rhs->dtype && VisitExpr(op->value, rhs->value);
+}
+
+bool TensorizeComparator::VisitExpr_(const CallNode* op, const PrimExpr& other) {
+  const auto* rhs = other.as<CallNode>();
+  return op->op.same_as(rhs->op) && op->dtype == rhs->dtype &&
+         CompareArray(op->args, rhs->args, &TensorizeComparator::VisitExpr);
+}
+
+bool TensorizeComparator::VisitExpr_(const VarNode* op, const PrimExpr& other) {
+  auto it = equal_map_.find(GetRef<Var>(op));
+  return it != equal_map_.end() && it->second.same_as(other);
+}
+
+bool TensorizeComparator::VisitExpr_(const IntImmNode* op, const PrimExpr& other) {
+  return op->value == other.as<IntImmNode>()->value;
+}
+
+bool TensorizeComparator::VisitExpr_(const FloatImmNode* op, const PrimExpr& other) {
+  return op->dtype == other.dtype() && op->value == other.as<FloatImmNode>()->value;
+}
+
+bool TensorizeComparator::VisitExpr_(const BufferLoadNode* op, const PrimExpr& other) {
+  return CompareBufferAccess(op, other.as<BufferLoadNode>());
+}
+
+/******** Definitions and buffers ********/
+
+bool TensorizeComparator::DefEqual(const Var& lhs, const Var& rhs) {
+  if (lhs.same_as(rhs)) return true;
+  auto it = equal_map_.find(lhs);
+  if (it != equal_map_.end()) return it->second.same_as(rhs);
+  if (lhs.dtype() != rhs.dtype() && !(lhs.dtype().is_int() && rhs.dtype().is_int())) {
+    return false;
+  }
+  equal_map_[lhs] = rhs;
+  // The indices are compared after the matched variables are substituted.
+  if (lhs.dtype().is_int()) {
+    analyzer_.Bind(lhs, cast(lhs.dtype(), rhs));
+  }
+  return true;
+}
+
+bool TensorizeComparator::CompareBuffer(const Buffer& lhs, const Buffer& rhs) {
+  if (lhs.same_as(rhs)) return true;
+  auto it = rhs_buffer_map_.find(rhs);
+  if (it != rhs_buffer_map_.end()) return it->second.same_as(lhs);
+  // The shapes are left out, it is the accessed regions which have to match.
+  if (lhs->dtype != rhs->dtype || lhs.scope() != rhs.scope() || !DefEqual(lhs->data, rhs->data)) {
+    return false;
+  }
+  rhs_buffer_map_[rhs] = lhs;
+  return true;
+}
+
+bool TensorizeComparator::CompareBufferRegion(const BufferRegion& lhs, const BufferRegion& rhs) {
+  if (!CompareBuffer(lhs->buffer, rhs->buffer)) return false;
+  // The leading dimensions of the left hand side are the ones missing in the description.
+  int offset = static_cast<int>(lhs->region.size()) - static_cast<int>(rhs->region.size());
+  if (offset < 0) return false;
+  for (int i = 0; i < offset; ++i) {
+    if (!is_one(lhs->region[i]->extent)) return false;
+  }
+  for (size_t i = 0; i < rhs->region.size(); ++i) {
+    if (!analyzer_.CanProveEqual(lhs->region[i + offset]->extent, rhs->region[i]->extent)) {
+      return false;
+    }
+  }
+  auto it = buffer_indices_.find(lhs->buffer);
+  if (it == buffer_indices_.end()) {
+    if (!is_scope_block_) {
+      EmitError("The buffer " + lhs->buffer->name + " is not in the regions of the scope block");
+      return false;
+    }
+    std::vector<PrimExpr> indices_base;
+    indices_base.reserve(lhs->region.size());
+    for (int i = 0; i < offset; ++i) {
+      indices_base.push_back(lhs->region[i]->min);
+    }
+    for (size_t i = 0; i < rhs->region.size(); ++i) {
+      indices_base.push_back(
+          analyzer_.Simplify(lhs->region[i + offset]->min - rhs->region[i]->min));
+    }
+    buffer_indices_.emplace(lhs->buffer, std::move(indices_base));
+    return true;
+  }
+  const std::vector<PrimExpr>& indices_base = it->second;
+  for (int i = 0; i < offset; ++i) {
+    if (!analyzer_.CanProveEqual(lhs->region[i]->min, indices_base[i])) return false;
+  }
+  for (size_t i = 0; i < rhs->region.size(); ++i) {
+    if (!analyzer_.CanProveEqual(lhs->region[i + offset]->min - indices_base[i + offset],
+                                 rhs->region[i]->min)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TensorizeComparator::CompareIterVar(const IterVar& lhs, const IterVar& rhs) {
+  return lhs->iter_type == rhs->iter_type && VisitExpr(lhs->dom->min, rhs->dom->min) &&
+         VisitExpr(lhs->dom->extent, rhs->dom->extent) && DefEqual(lhs->var, rhs->var);
+}
+
+template <typename T>
+bool TensorizeComparator::CompareBufferAccess(const T* lhs, const T* rhs) {
+  if (!CompareBuffer(lhs->buffer, rhs->buffer)) return false;
+  auto it = buffer_indices_.find(lhs->buffer);
+  if (it == buffer_indices_.end()) {
+    EmitError("The buffer " + lhs->buffer->name + " is not in the regions of the scope block");
+    return false;
+  }
+  const std::vector<PrimExpr>& indices_base = it->second;
+  if (lhs->indices.size() != indices_base.size() || lhs->indices.size() < rhs->indices.size()) {
+    return false;
+  }
+  size_t offset = lhs->indices.size() - rhs->indices.size();
+  for (size_t i = 0; i < offset; ++i) {
+    if (!analyzer_.CanProveEqual(lhs->indices[i], indices_base[i])) return false;
+  }
+  for (size_t i = 0; i < rhs->indices.size(); ++i) {
+    if (!analyzer_.CanProveEqual(lhs->indices[i + offset] - indices_base[i + offset],
+                                 rhs->indices[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T, typename F>
+bool TensorizeComparator::CompareArray(const Array<T>& lhs, const Array<T>& rhs, F cmp) {
+  if (lhs.same_as(rhs)) return true;
+  if (lhs.size() != rhs.size()) return false;
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (!(this->*cmp)(lhs[i], rhs[i])) return false;
+  }
+  return true;
+}
+
+void TensorizeComparator::EmitError(const std::string& error_message) {
+  if (error_message_.empty()) {
+    error_message_ = error_message;
+  }
+}
+
+}  // namespace tir
+}  // namespace tvm
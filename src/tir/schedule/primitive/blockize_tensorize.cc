@@ -0,0 +1,481 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/node/serialization.h>
+
+#include "../ir_comparator.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace tir {
+
+/******** Error Classes ********/
+
+class SubspaceNotDivisibleError : public ScheduleError {
+ public:
+  explicit SubspaceNotDivisibleError(IRModule mod, For scope_loop, Block inner_block)
+      : mod_(std::move(mod)),
+        scope_loop_(std::move(scope_loop)),
+        inner_block_(std::move(inner_block)) {}
+
+  String FastErrorString() const final {
+    return "ScheduleError: The bindings of the inner block can not be blockized.";
+  }
+
+  String DetailRenderTemplate() const final {
+    return "ScheduleError: The bindings of the inner block {0} can not be blockized by the loops "
+           "starting at {1}.";
+  }
+
+  IRModule mod() const final { return mod_; }
+
+  Array<ObjectRef> LocationsOfInterest() const final { return {inner_block_, scope_loop_}; }
+
+ private:
+  IRModule mod_;
+  For scope_loop_;
+  Block inner_block_;
+};
+
+class TensorIntrinMismatchError : public ScheduleError {
+ public:
+  explicit TensorIntrinMismatchError(IRModule mod, Block block, String message)
+      : mod_(std::move(mod)), block_(std::move(block)), message_(std::move(message)) {}
+
+  String FastErrorString() const final {
+    return "ScheduleError: The block does not match the description of the tensor intrinsic.";
+  }
+
+  String DetailRenderTemplate() const final {
+    std::ostringstream os;
+    os << "ScheduleError: The block {0} does not match the description of the tensor intrinsic: "
+       << message_;
+    return os.str();
+  }
+
+  IRModule mod() const final { return mod_; }
+
+  Array<ObjectRef> LocationsOfInterest() const final { return {block_}; }
+
+ private:
+  IRModule mod_;
+  Block block_;
+  String message_;
+};
+
+/******** Blockize ********/
+
+/*!
+ * \brief Divide the block bindings when each of them uses either only the inner loops or only
+ *        the outer loops, in which case they are not required to be quasi-affine.
+ * \param iter_vars The block vars.
+ * \param bindings The block bindings.
+ * \param outer_iters The loops outside of the loop to blockize.
+ * \param inner_iters The loops inside of the loop to blockize, it included.
+ * \param predicate The predicate of the block realize.
+ * \return The division in the format of arith::SubspaceDivide, empty if it fails.
+ */
+Array<Array<arith::IterMark>> TrivialSubspaceDivision(const Array<IterVar>& iter_vars,
+                                                      const Array<PrimExpr>& bindings,
+                                                      const Array<Var>& outer_iters,
+                                                      const Array<Var>& inner_iters,
+                                                      const PrimExpr& predicate) {
+  if (!is_one(predicate)) return {};
+  std::unordered_set<const VarNode*> outer_loop_vars;
+  std::unordered_set<const VarNode*> inner_loop_vars;
+  for (const Var& var : outer_iters) {
+    outer_loop_vars.insert(var.get());
+  }
+  for (const Var& var : inner_iters) {
+    inner_loop_vars.insert(var.get());
+  }
+  const arith::IterMark unit_iter_mark(arith::IterSumExpr({}, 0), 1);
+  Array<Array<arith::IterMark>> res;
+  for (size_t i = 0; i < bindings.size(); ++i) {
+    bool outer = UsesVar(bindings[i], [&outer_loop_vars](const VarNode* var) {
+      return outer_loop_vars.count(var) != 0;
+    });
+    bool inner = UsesVar(bindings[i], [&inner_loop_vars](const VarNode* var) {
+      return inner_loop_vars.count(var) != 0;
+    });
+    if (outer && inner) return {};
+    const PrimExpr& extent = iter_vars[i]->dom->extent;
+    arith::IterMark iter_mark =
+        bindings[i]->IsInstance<VarNode>()
+            ? arith::IterMark(arith::IterSplitExpr(arith::IterMark(bindings[i], extent)), extent)
+            : arith::IterMark(arith::IterSumExpr({}, bindings[i]), extent);
+    if (inner) {
+      res.push_back({unit_iter_mark, iter_mark});
+    } else {
+      // The bindings using no loop at all are kept in the outer block as well.
+      res.push_back({iter_mark, unit_iter_mark});
+    }
+  }
+  res.push_back({arith::IterMark(arith::IterSumExpr({}, 0), Bool(true)),
+                 arith::IterMark(arith::IterSumExpr({}, 0), Bool(true))});
+  return res;
+}
+
+/*!
+ * \brief Generate the init statement of the outer block, which initializes the whole region the
+ *        inner blocks reduce to.
+ * \param block_init The init statement of the original block, over the inner block vars.
+ * \param inner_realize The block realize of the inner block.
+ * \param inner_loops The loops between the outer block and the inner block, innermost first.
+ * \return The init block of the outer block, nested in the loops it needs.
+ */
+Stmt GenerateOuterInit(const Stmt& block_init, const BlockRealize& inner_realize,
+                       const std::vector<const ForNode*>& inner_loops) {
+  const Block& inner_block = inner_realize->block;
+  Map<Var, PrimExpr> subst_map;
+  // Step 1. The init block keeps the data parallel block vars the init statement uses
+  Array<IterVar> iter_vars;
+  Array<PrimExpr> iter_values;
+  for (size_t i = 0; i < inner_block->iter_vars.size(); ++i) {
+    const IterVar& old_iter_var = inner_block->iter_vars[i];
+    if (old_iter_var->iter_type == IterVarType::kDataPar &&
+        UsesVar(block_init,
+                [v = old_iter_var->var.get()](const VarNode* var) { return var == v; })) {
+      ObjectPtr<IterVarNode> new_iter_var = make_object<IterVarNode>(*old_iter_var.get());
+      new_iter_var->var = old_iter_var->var.copy_with_suffix("_init");
+      subst_map.Set(old_iter_var->var, new_iter_var->var);
+      iter_vars.push_back(IterVar(new_iter_var));
+      iter_values.push_back(inner_realize->iter_values[i]);
+    }
+  }
+  Stmt stmt = BlockRealize(
+      /*iter_values=*/iter_values,
+      /*predicate=*/inner_realize->predicate,
+      /*block=*/
+      Block(/*iter_vars=*/iter_vars,
+            /*reads=*/{},
+            /*writes=*/inner_block->writes,
+            /*name_hint=*/inner_block->name_hint + "_init",
+            /*body=*/block_init,
+            /*init=*/NullOpt));
+  // Step 2. Copy the loops the bindings of the init block use
+  for (const ForNode* loop : inner_loops) {
+    bool is_init_loop = false;
+    for (const PrimExpr& iter_value : iter_values) {
+      if (UsesVar(iter_value,
+                  [v = loop->loop_var.get()](const VarNode* var) { return var == v; })) {
+        is_init_loop = true;
+        break;
+      }
+    }
+    if (is_init_loop) {
+      ObjectPtr<ForNode> new_loop = make_object<ForNode>(*loop);
+      new_loop->loop_var = loop->loop_var.copy_with_suffix("_init");
+      new_loop->body = std::move(stmt);
+      subst_map.Set(loop->loop_var, new_loop->loop_var);
+      stmt = For(new_loop);
+    }
+  }
+  return Substitute(stmt, subst_map);
+}
+
+/*!
+ * \brief Relax the regions accessed by the inner block over the inner block vars.
+ * \param regions The regions accessed by the inner block.
+ * \param dom_map The domains of the inner block vars.
+ * \return The regions accessed by the outer block.
+ */
+Array<BufferRegion> EvalSetRegions(const Array<BufferRegion>& regions,
+                                   const Map<Var, arith::IntSet>& dom_map) {
+  Array<BufferRegion> results;
+  results.reserve(regions.size());
+  for (const BufferRegion& buffer_region : regions) {
+    const Buffer& buffer = buffer_region->buffer;
+    Array<arith::IntSet> relaxed = arith::EvalSet(buffer_region->region, dom_map);
+    ICHECK_EQ(relaxed.size(), buffer->shape.size());
+    Array<Range> new_region;
+    new_region.reserve(relaxed.size());
+    for (size_t i = 0; i < relaxed.size(); ++i) {
+      new_region.push_back(relaxed[i].CoverRange(Range::FromMinExtent(0, buffer->shape[i])));
+    }
+    results.push_back(BufferRegion(buffer, new_region));
+  }
+  return results;
+}
+
+/*! \brief Replace a block realize in the loop nest it is under. */
+class BlockRealizeReplacer : public StmtMutator {
+ public:
+  static Stmt Replace(const Stmt& stmt, const BlockRealizeNode* src, BlockRealize tgt) {
+    BlockRealizeReplacer replacer(src, std::move(tgt));
+    return replacer(stmt);
+  }
+
+ private:
+  explicit BlockRealizeReplacer(const BlockRealizeNode* src, BlockRealize tgt)
+      : src_(src), tgt_(std::move(tgt)) {}
+
+  Stmt VisitStmt_(const BlockRealizeNode* realize) final {
+    return realize == src_ ? Stmt(tgt_) : GetRef<Stmt>(realize);
+  }
+
+  const BlockRealizeNode* src_;
+  BlockRealize tgt_;
+};
+
+/*!
+ * \brief Recompute the cached flags of the scope a new block is in, the flag of the scope root
+ *        being left as it was.
+ */
+void UpdateScopeCachedFlags(ScheduleState self, const StmtSRef& block_sref) {
+  StmtSRef scope_root = GetScopeRoot(self, block_sref, /*require_stage_pipeline=*/false,
+                                     /*require_subtree_compact_dataflow=*/false);
+  bool scope_block_affine_binding = self->IsAffineBlockBinding(scope_root);
+  self->UpdateScopeBlockInfo(GetBlockRealize(self, scope_root));
+  self->block_info[scope_root].affine_binding = scope_block_affine_binding;
+}
+
+StmtSRef Blockize(ScheduleState self, const StmtSRef& loop_sref) {
+  const ForNode* loop = TVM_SREF_TO_FOR(loop, loop_sref);
+  arith::Analyzer analyzer;
+  // Step 1. Check the loop has a single child block
+  BlockRealize block_realize = CheckGetSingleChildBlockRealizeOnSRefTree(self, loop_sref);
+  Block block = block_realize->block;
+  StmtSRef block_sref = self->stmt2ref.at(block.get());
+  // Step 2. Collect the loops inside of the loop to blockize, innermost first, and the domains
+  // of all the loops of the scope
+  std::vector<const ForNode*> inner_loops;
+  Array<Var> inner_iters;
+  for (const StmtSRefNode* sref = block_sref->parent;; sref = sref->parent) {
+    const ForNode* inner_loop = TVM_SREF_TO_FOR(inner_loop, GetRef<StmtSRef>(sref));
+    inner_loops.push_back(inner_loop);
+    inner_iters.push_back(inner_loop->loop_var);
+    if (sref == loop_sref.get()) break;
+  }
+  Map<Var, Range> iters = LoopDomainOfSRefTreePath(GetRef<StmtSRef>(block_sref->parent));
+  Array<Var> outer_iters;
+  for (const auto& kv : iters) {
+    if (std::find_if(inner_iters.begin(), inner_iters.end(), [&kv](const Var& var) {
+          return var.same_as(kv.first);
+        }) == inner_iters.end()) {
+      outer_iters.push_back(kv.first);
+    }
+  }
+  // Step 3. Divide the block bindings into the subspaces of the outer and the inner loops
+  Array<Array<arith::IterMark>> division =
+      arith::SubspaceDivide(block_realize->iter_values, iters, inner_iters,
+                            block_realize->predicate, /*require_bijective=*/false, &analyzer);
+  if (division.empty()) {
+    division = TrivialSubspaceDivision(block->iter_vars, block_realize->iter_values, outer_iters,
+                                       inner_iters, block_realize->predicate);
+  }
+  if (division.empty()) {
+    throw SubspaceNotDivisibleError(self->mod, GetRef<For>(loop), block);
+  }
+  PrimExpr outer_pred = division.back()[0]->extent;
+  PrimExpr inner_pred = division.back()[1]->extent;
+  // Step 4. Generate the block vars of the outer and the inner blocks. A block var not divided
+  // is moved to the outer block as is
+  Array<IterVar> outer_block_vars, inner_block_vars;
+  Array<PrimExpr> outer_bindings, inner_bindings;
+  Map<Var, PrimExpr> block_var_subst;
+  Map<Var, arith::IntSet> inner_dom_map;
+  for (size_t i = 0; i < block->iter_vars.size(); ++i) {
+    const IterVar& iter_var = block->iter_vars[i];
+    const arith::IterMark& outer_mark = division[i][0];
+    const arith::IterMark& inner_mark = division[i][1];
+    PrimExpr outer_binding =
+        arith::NormalizeIterMapToExpr(Downcast<arith::IterMapExpr>(outer_mark->source));
+    PrimExpr inner_binding =
+        arith::NormalizeIterMapToExpr(Downcast<arith::IterMapExpr>(inner_mark->source));
+    if (is_one(inner_mark->extent)) {
+      outer_block_vars.push_back(iter_var);
+      outer_bindings.push_back(outer_binding);
+      continue;
+    }
+    IterVar outer_var(Range::FromMinExtent(make_zero(outer_mark->extent.dtype()),
+                                           outer_mark->extent),
+                      iter_var->var.copy_with_suffix("_o"), iter_var->iter_type);
+    IterVar inner_var(Range::FromMinExtent(make_zero(inner_mark->extent.dtype()),
+                                           inner_mark->extent),
+                      iter_var->var.copy_with_suffix("_i"), iter_var->iter_type);
+    outer_block_vars.push_back(outer_var);
+    outer_bindings.push_back(outer_binding);
+    inner_block_vars.push_back(inner_var);
+    inner_bindings.push_back(inner_binding);
+    block_var_subst.Set(iter_var->var, outer_var->var * inner_mark->extent + inner_var->var);
+    inner_dom_map.Set(inner_var->var, arith::IntSet::FromRange(inner_var->dom));
+  }
+  // Step 5. Generate the inner block, whose init statement is moved to the outer block
+  ObjectPtr<BlockNode> inner_block_node = make_object<BlockNode>(*block.get());
+  inner_block_node->iter_vars = inner_block_vars;
+  inner_block_node->init = NullOpt;
+  Block inner_block = Downcast<Block>(Substitute(Block(inner_block_node), block_var_subst));
+  BlockRealize inner_realize(inner_bindings, inner_pred, inner_block);
+  // Step 6. Generate the outer block
+  Optional<Stmt> outer_init = NullOpt;
+  if (block->init.defined()) {
+    outer_init =
+        GenerateOuterInit(Substitute(block->init.value(), block_var_subst), inner_realize,
+                          inner_loops);
+  }
+  Block outer_block(/*iter_vars=*/outer_block_vars,
+                    /*reads=*/EvalSetRegions(inner_block->reads, inner_dom_map),
+                    /*writes=*/EvalSetRegions(inner_block->writes, inner_dom_map),
+                    /*name_hint=*/block->name_hint + "_o",
+                    /*body=*/
+                    BlockRealizeReplacer::Replace(GetRef<Stmt>(loop), block_realize.get(),
+                                                  inner_realize),
+                    /*init=*/outer_init);
+  BlockRealize outer_realize(outer_bindings, outer_pred, outer_block);
+  // Step 7. Do the replacement and update the cached flags
+  self->Replace(loop_sref, outer_realize, {{block, inner_block}});
+  StmtSRef outer_block_sref = self->stmt2ref.at(outer_block.get());
+  UpdateScopeCachedFlags(self, outer_block_sref);
+  return outer_block_sref;
+}
+
+/******** Tensorize ********/
+
+void Tensorize(ScheduleState self, const StmtSRef& sref, const TensorIntrin& intrin) {
+  // Step 1. Blockize the subtree of the loop if a loop is given
+  StmtSRef block_sref = sref;
+  if (sref->stmt->IsInstance<ForNode>()) {
+    block_sref = Blockize(self, sref);
+  }
+  const BlockNode* block = TVM_SREF_TO_BLOCK(block, block_sref);
+  BlockRealize block_realize = GetBlockRealize(self, block_sref);
+  // Step 2. Compare the block with the description of the tensor intrinsic, which matches the
+  // buffers of the description to those of the block
+  const PrimFunc& desc = intrin->desc;
+  TensorizeComparator comparator;
+  if (!comparator.VisitStmt(block_realize, desc->body)) {
+    throw TensorIntrinMismatchError(self->mod, GetRef<Block>(block), comparator.error_message());
+  }
+  // Step 3. Match the buffers of the implementation to those of the block. The implementation is
+  // copied, so that each tensorized block defines its own buffers and vars
+  PrimFunc impl = Downcast<PrimFunc>(LoadJSON(SaveJSON(intrin->impl)));
+  std::unordered_map<Buffer, Buffer, ObjectPtrHash, ObjectPtrEqual> impl2block;
+  for (size_t i = 0; i < impl->params.size(); ++i) {
+    const Buffer& desc_buffer = desc->buffer_map.at(desc->params[i]);
+    const Buffer& impl_buffer = impl->buffer_map.at(impl->params[i]);
+    auto it = comparator.rhs_buffer_map_.find(desc_buffer);
+    if (it == comparator.rhs_buffer_map_.end()) {
+      throw TensorIntrinMismatchError(
+          self->mod, GetRef<Block>(block),
+          "The buffer " + desc_buffer->name + " of the description is not accessed");
+    }
+    impl2block[impl_buffer] = it->second;
+  }
+  // Step 4. Bind the buffers of the implementation to the regions of the block they access
+  const BlockNode* impl_block = Downcast<BlockRealize>(impl->body)->block.get();
+  Array<MatchBufferRegion> match_buffers;
+  std::unordered_set<const BufferNode*> matched;
+  arith::Analyzer analyzer;
+  for (const Array<BufferRegion>& regions : {impl_block->reads, impl_block->writes}) {
+    for (const BufferRegion& region : regions) {
+      if (!matched.insert(region->buffer.get()).second) continue;
+      auto it = impl2block.find(region->buffer);
+      CHECK(it != impl2block.end())
+          << "ValueError: The root block of the implementation of the tensor intrinsic accesses "
+          << region->buffer->name << ", which is not a parameter";
+      const Buffer& target = it->second;
+      const std::vector<PrimExpr>& indices_base = comparator.buffer_indices_.at(target);
+      int offset = static_cast<int>(indices_base.size()) - static_cast<int>(region->region.size());
+      CHECK_GE(offset, 0) << "ValueError: The implementation of the tensor intrinsic accesses "
+                          << region->buffer->name << " with more dimensions than the description";
+      Array<Range> new_region;
+      for (int i = 0; i < offset; ++i) {
+        new_region.push_back(Range::FromMinExtent(indices_base[i], 1));
+      }
+      for (size_t i = 0; i < region->region.size(); ++i) {
+        const Range& range = region->region[i];
+        new_region.push_back(Range::FromMinExtent(
+            analyzer.Simplify(indices_base[i + offset] + range->min), range->extent));
+      }
+      match_buffers.push_back(MatchBufferRegion(region->buffer, BufferRegion(target, new_region)));
+    }
+  }
+  // Step 5. Replace the body of the block by the implementation
+  ObjectPtr<BlockNode> new_block_node = make_object<BlockNode>(*block);
+  new_block_node->body = impl_block->body;
+  new_block_node->alloc_buffers = impl_block->alloc_buffers;
+  new_block_node->match_buffers = match_buffers;
+  Block new_block(new_block_node);
+  self->Replace(block_sref, new_block, {{GetRef<Block>(block), new_block}});
+  // Step 6. Update the cached flags
+  UpdateScopeCachedFlags(self, self->stmt2ref.at(new_block.get()));
+}
+
+/******** InstructionKind Registration ********/
+
+struct BlockizeTraits : public UnpackedInstTraits<BlockizeTraits> {
+  static constexpr const char* kName = "Blockize";
+  static constexpr bool kIsPure = false;
+
+ private:
+  static constexpr size_t kNumInputs = 1;
+  static constexpr size_t kNumAttrs = 0;
+  static constexpr size_t kNumDecisions = 0;
+
+  static BlockRV UnpackedApplyToSchedule(Schedule sch, LoopRV loop_rv) {
+    return sch->Blockize(loop_rv);
+  }
+
+  static String UnpackedAsPython(Array<String> outputs, String loop_rv) {
+    PythonAPICall py("blockize");
+    py.Input("loop", loop_rv);
+    py.SingleOutput(outputs);
+    return py.Str();
+  }
+
+  template <typename>
+  friend struct ::tvm::tir::UnpackedInstTraits;
+};
+
+struct TensorizeTraits : public UnpackedInstTraits<TensorizeTraits> {
+  static constexpr const char* kName = "Tensorize";
+  static constexpr bool kIsPure = false;
+
+ private:
+  static constexpr size_t kNumInputs = 1;
+  static constexpr size_t kNumAttrs = 1;
+  static constexpr size_t kNumDecisions = 0;
+
+  static void UnpackedApplyToSchedule(Schedule sch, ObjectRef block_or_loop_rv, String intrin) {
+    if (const auto* block = block_or_loop_rv.as<BlockRVNode>()) {
+      sch->Tensorize(GetRef<BlockRV>(block), intrin);
+    } else if (const auto* loop = block_or_loop_rv.as<LoopRVNode>()) {
+      sch->Tensorize(GetRef<LoopRV>(loop), intrin);
+    } else {
+      LOG(FATAL) << "TypeError: Expected Block or Loop, but gets: "
+                 << block_or_loop_rv->GetTypeKey();
+    }
+  }
+
+  static String UnpackedAsPython(Array<String> outputs, String block_or_loop_rv, String intrin) {
+    PythonAPICall py("tensorize");
+    py.Input("block_or_loop", block_or_loop_rv);
+    py.Input("tensor_intrin", "\"" + std::string(intrin) + "\"");
+    return py.Str();
+  }
+
+  template <typename>
+  friend struct ::tvm::tir::UnpackedInstTraits;
+};
+
+TVM_REGISTER_INST_KIND_TRAITS(BlockizeTraits);
+TVM_REGISTER_INST_KIND_TRAITS(TensorizeTraits);
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,254 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "./trace_replay_cache.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "./utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The trie grows to at most so many nodes per snapshot before it is cleared. */
+constexpr int64_t kMaxNumNodesPerSnapshot = 64;
+
+/*!
+ * \brief An instruction of a trace, with its random variable inputs replaced by the position of
+ *  the instruction output they are, which can be compared across traces.
+ */
+struct TraceReplayCache::InstKey {
+  /*! \brief The kind name, the inputs, the attributes and the decision. */
+  ObjectRef key;
+  /*! \brief The structural hash of the key. */
+  size_t hash;
+};
+
+/*! \brief The schedule after a prefix of a trace, never modified once recorded. */
+struct TraceReplayCache::Snapshot {
+  /*! \brief The schedule. */
+  Schedule sch;
+  /*! \brief The outputs of each instruction of the prefix on the schedule. */
+  std::vector<Array<ObjectRef>> outputs;
+};
+
+/*! \brief A prefix of a trace, extending its parent by one instruction. */
+struct TraceReplayCache::Node {
+  /*! \brief The last instruction of the prefix, undefined for the empty prefix. */
+  InstKey inst;
+  /*! \brief The number of replays of the prefix. */
+  int num_visits = 0;
+  /*! \brief The schedule after the prefix, if recorded. */
+  std::shared_ptr<const Snapshot> snapshot;
+  /*! \brief The longer prefixes. */
+  std::vector<std::unique_ptr<Node>> children;
+
+  Node* FindChild(const InstKey& inst) const {
+    for (const std::unique_ptr<Node>& child : children) {
+      if (child->inst.hash == inst.hash && StructuralEqual()(child->inst.key, inst.key)) {
+        return child.get();
+      }
+    }
+    return nullptr;
+  }
+};
+
+/*!
+ * \brief Check whether an instruction is a sampling one, whose outcome is random unless its
+ *  decision is given.
+ */
+bool IsSamplingInstruction(const Instruction& inst) {
+  const std::string& name = inst->kind->name;
+  return name.compare(0, 6, "Sample") == 0;
+}
+
+TraceReplayCache::TraceReplayCache(IRModule mod, int debug_mask,
+                                   ScheduleErrorRenderLevel error_render_level,
+                                   int max_num_snapshots)
+    : mod_(std::move(mod)),
+      debug_mask_(debug_mask),
+      error_render_level_(error_render_level),
+      max_num_snapshots_(max_num_snapshots),
+      root_(std::make_unique<Node>()) {
+  CHECK_GT(max_num_snapshots, 0) << "ValueError: The cache needs room for one snapshot";
+}
+
+TraceReplayCache::~TraceReplayCache() = default;
+
+std::vector<TraceReplayCache::InstKey> TraceReplayCache::ComputeInstKeys(const Trace& trace,
+                                                                        int n_insts) {
+  std::vector<InstKey> keys;
+  std::unordered_map<const Object*, String> rv_names;
+  for (int i = 0; i < n_insts; ++i) {
+    const Instruction& inst = trace->insts[i];
+    Optional<ObjectRef> decision = trace->GetDecision(inst);
+    if (IsSamplingInstruction(inst) && !decision.defined()) {
+      break;
+    }
+    Array<ObjectRef> inputs;
+    bool comparable = true;
+    for (const ObjectRef& input : inst->inputs) {
+      if (!input.defined() || input->IsInstance<StringObj>() || input->IsInstance<IntImmNode>() ||
+          input->IsInstance<FloatImmNode>()) {
+        inputs.push_back(input);
+      } else if (input->IsInstance<BlockRVNode>() || input->IsInstance<LoopRVNode>() ||
+                 input->IsInstance<VarNode>()) {
+        auto it = rv_names.find(input.get());
+        if (it == rv_names.end()) {
+          comparable = false;
+          break;
+        }
+        inputs.push_back(it->second);
+      } else {
+        // An expression of random variables.
+        comparable = false;
+        break;
+      }
+    }
+    if (!comparable) {
+      break;
+    }
+    for (int j = 0, n = inst->outputs.size(); j < n; ++j) {
+      rv_names.emplace(inst->outputs[j].get(),
+                       String(std::to_string(i) + ":" + std::to_string(j)));
+    }
+    ObjectRef key = Array<ObjectRef>{inst->kind->name, inputs, inst->attrs, decision};
+    size_t hash = StructuralHash()(key);
+    keys.push_back(InstKey{std::move(key), hash});
+  }
+  return keys;
+}
+
+Schedule TraceReplayCache::Replay(const Trace& trace,
+                                  support::LinearCongruentialEngine::TRandState seed,
+                                  bool remove_postproc) {
+  const Array<Instruction>& insts = trace->insts;
+  int n_insts = insts.size();
+  if (remove_postproc) {
+    for (int i = 0; i < n_insts; ++i) {
+      if (IsPostproc(insts[i]->kind)) {
+        n_insts = i;
+        break;
+      }
+    }
+  }
+  std::vector<InstKey> keys = ComputeInstKeys(trace, n_insts);
+  int n_keys = keys.size();
+  // Find the longest prefix with a snapshot, and the prefixes to take a snapshot of.
+  std::shared_ptr<const Snapshot> start = nullptr;
+  std::vector<int> snapshot_lens;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (num_nodes_ > kMaxNumNodesPerSnapshot * max_num_snapshots_) {
+      root_ = std::make_unique<Node>();
+      num_nodes_ = 0;
+      num_snapshots_ = 0;
+    }
+    Node* node = root_.get();
+    ++node->num_visits;
+    for (int i = 0; i <= n_keys; ++i) {
+      if (i > 0 && i < n_insts && IsSamplingInstruction(insts[i])) {
+        if (node->snapshot != nullptr) {
+          start = node->snapshot;
+          snapshot_lens.clear();
+        } else if (node->num_visits >= 2) {
+          snapshot_lens.push_back(i);
+        }
+      }
+      if (i == n_keys) {
+        break;
+      }
+      Node* child = node->FindChild(keys[i]);
+      if (child == nullptr) {
+        node->children.push_back(std::make_unique<Node>());
+        child = node->children.back().get();
+        child->inst = keys[i];
+        ++num_nodes_;
+      }
+      node = child;
+      ++node->num_visits;
+    }
+    if (start != nullptr) {
+      ++num_hits_;
+    }
+  }
+  Schedule sch{nullptr};
+  std::vector<Array<ObjectRef>> outputs;
+  std::unordered_map<const Object*, const Object*> rv_map;
+  if (start != nullptr) {
+    sch = start->sch->Copy();
+    sch->Seed(seed);
+    outputs = start->outputs;
+    for (int i = 0, n = outputs.size(); i < n; ++i) {
+      TranslateAddOutputRVs(insts[i]->outputs, outputs[i], &rv_map);
+    }
+  } else {
+    sch = Schedule::Traced(mod_, seed, debug_mask_, error_render_level_);
+  }
+  auto next_snapshot = snapshot_lens.begin();
+  for (int i = outputs.size(); i < n_insts; ++i) {
+    const Instruction& inst = insts[i];
+    if (next_snapshot != snapshot_lens.end() && *next_snapshot == i) {
+      AddSnapshot(keys, i, std::make_shared<const Snapshot>(Snapshot{sch->Copy(), outputs}));
+      ++next_snapshot;
+    }
+    Array<ObjectRef> inputs = TranslateInputRVs(inst->inputs, rv_map);
+    outputs.push_back(
+        inst->kind->f_apply_to_schedule(sch, inputs, inst->attrs, trace->GetDecision(inst)));
+    TranslateAddOutputRVs(inst->outputs, outputs.back(), &rv_map);
+  }
+  return sch;
+}
+
+void TraceReplayCache::AddSnapshot(const std::vector<InstKey>& keys, int prefix_len,
+                                   std::shared_ptr<const Snapshot> snapshot) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Node* node = root_.get();
+  for (int i = 0; i < prefix_len && node != nullptr; ++i) {
+    node = node->FindChild(keys[i]);
+  }
+  // The prefix is gone if the cache was cleared in the meantime.
+  if (node == nullptr || node->snapshot != nullptr) {
+    return;
+  }
+  if (num_snapshots_ >= max_num_snapshots_) {
+    root_ = std::make_unique<Node>();
+    num_nodes_ = 0;
+    num_snapshots_ = 0;
+    return;
+  }
+  node->snapshot = std::move(snapshot);
+  ++num_snapshots_;
+}
+
+void TraceReplayCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  root_ = std::make_unique<Node>();
+  num_nodes_ = 0;
+  num_snapshots_ = 0;
+}
+
+int64_t TraceReplayCache::num_hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_hits_;
+}
+
+}  // namespace tir
+}  // namespace tvm
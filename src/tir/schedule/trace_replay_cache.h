@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef TVM_TIR_SCHEDULE_TRACE_REPLAY_CACHE_H_
+#define TVM_TIR_SCHEDULE_TRACE_REPLAY_CACHE_H_
+
+#include <tvm/support/random_engine.h>
+#include <tvm/tir/schedule/schedule.h>
+#include <tvm/tir/schedule/trace.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+/*!
+ * \brief A cache replaying traces on schedules of one module, which resumes the replay from a
+ *  snapshot of the schedule after the longest prefix of the trace already replayed.
+ *
+ *  The instructions of the prefixes are compared structurally together with their decisions,
+ *  the random variables being identified by the instruction producing them, so that the traces
+ *  derived from one another by changing decisions share their common prefix. A snapshot is
+ *  taken before a sampling instruction once its prefix was replayed twice, and a replay starts
+ *  from a copy of it. The prefix stops at the first sampling instruction without a decision,
+ *  whose outcome differs from one replay to the next.
+ *
+ *  The cache is thread safe.
+ */
+class TraceReplayCache {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param mod The module the traces are replayed on.
+   * \param debug_mask The debug mask of the schedules.
+   * \param error_render_level The error render level of the schedules.
+   * \param max_num_snapshots The number of snapshots after which the cache is cleared.
+   */
+  explicit TraceReplayCache(IRModule mod, int debug_mask = 0,
+                            ScheduleErrorRenderLevel error_render_level =
+                                ScheduleErrorRenderLevel::kNone,
+                            int max_num_snapshots = 256);
+  ~TraceReplayCache();
+
+  /*!
+   * \brief Replay a trace on a traced schedule of the module, as Trace::ApplyToSchedule does on
+   *  a fresh one.
+   * \param trace The trace to be replayed.
+   * \param seed The random seed of the schedule returned.
+   * \param remove_postproc Whether to stop at the postprocessing instructions.
+   * \return The schedule. The errors of the instructions are thrown.
+   */
+  Schedule Replay(const Trace& trace, support::LinearCongruentialEngine::TRandState seed,
+                  bool remove_postproc);
+
+  /*! \brief Drop the snapshots. */
+  void Clear();
+
+  /*! \return The number of replays which started from a snapshot. */
+  int64_t num_hits() const;
+
+ private:
+  struct InstKey;
+  struct Node;
+  struct Snapshot;
+
+  /*!
+   * \brief Compute the keys of the prefix of the instructions of a trace that can be cached.
+   * \param trace The trace.
+   * \param n_insts The number of instructions to be replayed.
+   * \return The keys, stopping before the first instruction whose outcome may differ between
+   *  two replays or whose inputs cannot be compared across traces.
+   */
+  static std::vector<InstKey> ComputeInstKeys(const Trace& trace, int n_insts);
+
+  /*!
+   * \brief Record the snapshot of the schedule after a prefix of a trace.
+   * \param keys The keys of the instructions of the trace.
+   * \param prefix_len The length of the prefix.
+   * \param snapshot The snapshot.
+   */
+  void AddSnapshot(const std::vector<InstKey>& keys, int prefix_len,
+                   std::shared_ptr<const Snapshot> snapshot);
+
+  /*! \brief The module the traces are replayed on. */
+  IRModule mod_;
+  /*! \brief The debug mask of the schedules. */
+  int debug_mask_;
+  /*! \brief The error render level of the schedules. */
+  ScheduleErrorRenderLevel error_render_level_;
+  /*! \brief The number of snapshots after which the cache is cleared. */
+  int max_num_snapshots_;
+  /*! \brief The number of snapshots in the cache. */
+  int num_snapshots_ = 0;
+  /*! \brief The number of nodes in the trie. */
+  int64_t num_nodes_ = 0;
+  /*! \brief The number of replays which started from a snapshot. */
+  int64_t num_hits_ = 0;
+  /*! \brief The trie of the prefixes, its root is the empty prefix. */
+  std::unique_ptr<Node> root_;
+  /*! \brief Protects the fields above. */
+  mutable std::mutex mutex_;
+};
+
+}  // namespace tir
+}  // namespace tvm
+
+#endif  // TVM_TIR_SCHEDULE_TRACE_REPLAY_CACHE_H_
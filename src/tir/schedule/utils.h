@@ -210,6 +210,33 @@ inline Map<Var, arith::IntSet> AsIntSet(const Map<Var, Range>& var_dom) {
   return {result.begin(), result.end()};
 }
 
+/******** Trace ********/
+
+/*!
+ * \brief Check whether an instruction kind marks the start of the postprocessing.
+ * \param inst_kind The instruction kind.
+ * \return Whether it is the kind EnterPostproc.
+ */
+bool IsPostproc(const InstructionKind& inst_kind);
+
+/*!
+ * \brief Translate the inputs of an instruction to the random variables of a schedule.
+ * \param inputs The inputs of the instruction in a trace.
+ * \param rv_map The mapping from the random variables of the trace to the ones of the schedule.
+ * \return The inputs to apply the instruction to the schedule with.
+ */
+Array<ObjectRef> TranslateInputRVs(const Array<ObjectRef>& inputs,
+                                   const std::unordered_map<const Object*, const Object*>& rv_map);
+
+/*!
+ * \brief Record the random variables an instruction produced on a schedule.
+ * \param old_outputs The outputs of the instruction in a trace.
+ * \param new_outputs The outputs of the instruction applied to the schedule.
+ * \param rv_map The mapping from the random variables of the trace to the ones of the schedule.
+ */
+void TranslateAddOutputRVs(const Array<ObjectRef>& old_outputs, const Array<ObjectRef>& new_outputs,
+                           std::unordered_map<const Object*, const Object*>* rv_map);
+
 /**************** Loop extents ****************/
 
 /*!
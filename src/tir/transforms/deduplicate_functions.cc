@@ -0,0 +1,157 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file deduplicate_functions.cc
+ * \brief Keep one copy of the PrimFuncs that only differ by their names.
+ */
+#include <tvm/ir/transform.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief Redirect the calls of the removed functions to their kept copies. */
+class CallRedirector : public StmtExprMutator {
+ public:
+  using GlobalVarMap = std::unordered_map<GlobalVar, GlobalVar, ObjectPtrHash, ObjectPtrEqual>;
+
+  CallRedirector(const std::unordered_map<std::string, String>& symbols, const GlobalVarMap& gvars)
+      : symbols_(symbols), gvars_(gvars) {}
+
+  PrimExpr VisitExpr_(const CallNode* op) final {
+    Call call = Downcast<Call>(StmtExprMutator::VisitExpr_(op));
+    if (const auto* gvar = call->op.as<GlobalVarNode>()) {
+      auto it = gvars_.find(GetRef<GlobalVar>(gvar));
+      if (it != gvars_.end()) {
+        return Call(call->dtype, it->second, call->args, call->span);
+      }
+    } else if (call->op.same_as(builtin::call_extern()) ||
+               call->op.same_as(builtin::tvm_call_cpacked()) ||
+               call->op.same_as(builtin::tvm_call_packed())) {
+      const auto* name = call->args.empty() ? nullptr : call->args[0].as<StringImmNode>();
+      if (name != nullptr) {
+        auto it = symbols_.find(name->value);
+        if (it != symbols_.end()) {
+          Array<PrimExpr> args = call->args;
+          args.Set(0, StringImm(it->second));
+          return Call(call->dtype, call->op, args, call->span);
+        }
+      }
+    }
+    return std::move(call);
+  }
+
+ private:
+  const std::unordered_map<std::string, String>& symbols_;
+  const GlobalVarMap& gvars_;
+};
+
+namespace transform {
+
+Pass DeduplicateFunctions() {
+  auto pass_func = [=](IRModule mod, PassContext ctx) {
+    // The candidates, sorted by name so the first copy kept does not depend on the hashing.
+    std::vector<std::pair<GlobalVar, PrimFunc>> funcs;
+    for (const auto& kv : mod->functions) {
+      const auto* func = kv.second.as<PrimFuncNode>();
+      if (func == nullptr) continue;
+      PrimFunc prim_func = GetRef<PrimFunc>(func);
+      if (!prim_func->GetAttr<String>(tvm::attr::kGlobalSymbol) ||
+          prim_func->GetAttr<Integer>(tir::attr::kIsEntryFunc, 0) != 0 ||
+          prim_func->GetAttr<Bool>("runner_function", Bool(false)).value() ||
+          prim_func->GetAttr<String>("Compiler")) {
+        continue;
+      }
+      funcs.emplace_back(kv.first, prim_func);
+    }
+    std::sort(funcs.begin(), funcs.end(), [](const auto& a, const auto& b) {
+      return a.first->name_hint < b.first->name_hint;
+    });
+
+    // The functions kept, without their names, by structural hash.
+    struct Copy {
+      GlobalVar gvar;
+      String symbol;
+      PrimFunc unnamed;
+    };
+    std::unordered_map<size_t, std::vector<Copy>> kept;
+    std::unordered_map<std::string, String> symbols;
+    CallRedirector::GlobalVarMap gvars;
+    for (const auto& kv : funcs) {
+      String symbol = kv.second->GetAttr<String>(tvm::attr::kGlobalSymbol).value();
+      PrimFunc unnamed = kv.second;
+      Map<String, ObjectRef> attrs = unnamed->attrs->dict;
+      attrs.erase(tvm::attr::kGlobalSymbol);
+      unnamed.CopyOnWrite()->attrs = DictAttrs(attrs);
+      std::vector<Copy>& bucket = kept[StructuralHash()(unnamed)];
+      auto it = std::find_if(bucket.begin(), bucket.end(), [&](const Copy& copy) {
+        return StructuralEqual()(copy.unnamed, unnamed);
+      });
+      if (it == bucket.end()) {
+        bucket.push_back(Copy{kv.first, symbol, unnamed});
+      } else {
+        symbols[symbol] = it->symbol;
+        gvars[kv.first] = it->gvar;
+      }
+    }
+    if (gvars.empty()) return mod;
+
+    IRModuleNode* mod_node = mod.CopyOnWrite();
+    for (const auto& kv : gvars) {
+      mod_node->Remove(kv.first);
+    }
+    CallRedirector redirector(symbols, gvars);
+    std::vector<std::pair<GlobalVar, PrimFunc>> updates;
+    for (const auto& kv : mod_node->functions) {
+      if (const auto* func = kv.second.as<PrimFuncNode>()) {
+        PrimFunc prim_func = GetRef<PrimFunc>(func);
+        Stmt body = redirector(prim_func->body);
+        if (!body.same_as(prim_func->body)) {
+          prim_func.CopyOnWrite()->body = body;
+          updates.emplace_back(kv.first, prim_func);
+        }
+      }
+    }
+    for (const auto& kv : updates) {
+      mod_node->Update(kv.first, kv.second);
+    }
+    return mod;
+  };
+  return tvm::transform::CreateModulePass(pass_func, 0, "tir.DeduplicateFunctions", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.DeduplicateFunctions").set_body_typed(DeduplicateFunctions);
+
+}  // namespace transform
+}  // namespace tir
+}  // namespace tvm
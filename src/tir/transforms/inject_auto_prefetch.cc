@@ -0,0 +1,299 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_auto_prefetch.cc
+ * \brief Insert software prefetches for the strided and indirect accesses of CPU loops.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+struct InjectAutoPrefetchConfigNode : public tvm::AttrsNode<InjectAutoPrefetchConfigNode> {
+  int distance_bytes;
+  int max_distance;
+  int min_stride_bytes;
+  int min_extent;
+
+  TVM_DECLARE_ATTRS(InjectAutoPrefetchConfigNode, "tir.transform.InjectAutoPrefetchConfig") {
+    TVM_ATTR_FIELD(distance_bytes)
+        .describe("How far ahead the prefetches go, in bytes of the prefetched streams of a "
+                  "loop. 0 disables the pass.")
+        .set_default(0);
+    TVM_ATTR_FIELD(max_distance)
+        .describe("The maximum number of iterations the prefetches go ahead.")
+        .set_default(32);
+    TVM_ATTR_FIELD(min_stride_bytes)
+        .describe("The minimum stride of the prefetched accesses, the hardware prefetchers "
+                  "follow the denser ones.")
+        .set_default(64);
+    TVM_ATTR_FIELD(min_extent)
+        .describe("The minimum extent of the loops getting prefetches, when it is constant.")
+        .set_default(16);
+  }
+};
+
+class InjectAutoPrefetchConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(InjectAutoPrefetchConfig, Attrs,
+                                            InjectAutoPrefetchConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(InjectAutoPrefetchConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.InjectAutoPrefetch", InjectAutoPrefetchConfig);
+
+/*! \brief The indirect accesses are assumed to touch a new cache line on each iteration. */
+constexpr int kIndirectStrideBytes = 64;
+
+/*! \brief An access of a loop body worth prefetching. */
+struct PrefetchCandidate {
+  /*! \brief The load, its index being the scalar address of the access. */
+  Load load;
+  /*! \brief The bytes between the accesses of two consecutive iterations. */
+  int64_t stride_bytes;
+  /*! \brief Whether the index reads memory, so that it may only be evaluated in the loop. */
+  bool indirect;
+};
+
+/*!
+ * \brief Collects the accesses of a loop body whose address moves with the loop variable.
+ *
+ *  The direct accesses of the body itself, at a constant stride of at least the minimum, and the
+ *  indirect accesses whose index reads memory depending on the loop variable, such as the rows
+ *  of a gather, which are visited at the start of the inner loops. The accesses under a
+ *  condition are left out, as their index may not be valid on every iteration.
+ */
+class PrefetchCandidateCollector : public StmtExprVisitor {
+ public:
+  PrefetchCandidateCollector(Var loop_var, int64_t min_stride_bytes)
+      : loop_var_(std::move(loop_var)), min_stride_bytes_(min_stride_bytes) {}
+
+  std::vector<PrefetchCandidate> Collect(const Stmt& body) {
+    VisitStmt(body);
+    return std::move(candidates_);
+  }
+
+ private:
+  void VisitStmt_(const ForNode* op) final {
+    const auto* extent = op->extent.as<IntImmNode>();
+    bool known = extent != nullptr && extent->value > 0 && op->kind == ForKind::kSerial;
+    inner_loops_.push_back(op);
+    unknown_inner_loops_ += !known;
+    StmtExprVisitor::VisitStmt_(op);
+    unknown_inner_loops_ -= !known;
+    inner_loops_.pop_back();
+  }
+
+  void VisitStmt_(const IfThenElseNode* op) final {
+    VisitExpr(op->condition);
+    ++conditional_depth_;
+    VisitStmt(op->then_case);
+    if (op->else_case.defined()) VisitStmt(op->else_case);
+    --conditional_depth_;
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    // the bodies of the device scopes do not run as part of the iteration
+    if (op->attr_key == attr::thread_extent || op->attr_key == attr::virtual_thread) return;
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const SelectNode* op) final {
+    VisitExpr(op->condition);
+    ++conditional_depth_;
+    VisitExpr(op->true_value);
+    VisitExpr(op->false_value);
+    --conditional_depth_;
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (op->op.same_as(builtin::if_then_else())) {
+      VisitExpr(op->args[0]);
+      ++conditional_depth_;
+      VisitExpr(op->args[1]);
+      VisitExpr(op->args[2]);
+      --conditional_depth_;
+    } else if (!op->op.same_as(builtin::address_of()) && !op->op.same_as(builtin::prefetch())) {
+      StmtExprVisitor::VisitExpr_(op);
+    }
+  }
+
+  void VisitExpr_(const LoadNode* op) final {
+    StmtExprVisitor::VisitExpr_(op);
+    if (conditional_depth_ != 0 || !is_one(op->predicate)) return;
+    String scope = GetPtrStorageScope(op->buffer_var);
+    if (scope != "" && scope != "global") return;
+    PrimExpr index = op->index;
+    if (const auto* ramp = index.as<RampNode>()) index = ramp->base;
+    if (!UsesVar(index, [this](const VarNode* var) { return var == loop_var_.get(); })) return;
+    int64_t elem_bytes = op->dtype.bytes();
+    PrimExpr address = index;
+    if (ReadsMemoryAt(index)) {
+      // the whole index is evaluated again ahead, so the inner loops must run at least once
+      if (unknown_inner_loops_ != 0) return;
+      Map<Var, PrimExpr> inner_mins;
+      for (const ForNode* loop : inner_loops_) {
+        inner_mins.Set(loop->loop_var, loop->min);
+      }
+      address = Substitute(index, inner_mins);
+      AddCandidate(op, address, kIndirectStrideBytes, true);
+      return;
+    }
+    if (!inner_loops_.empty()) return;
+    Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, {loop_var_});
+    if (coeffs.empty()) return;
+    const auto* stride = coeffs[0].as<IntImmNode>();
+    if (stride == nullptr) return;
+    int64_t stride_bytes = std::abs(stride->value) * elem_bytes;
+    if (stride_bytes < min_stride_bytes_) return;
+    AddCandidate(op, address, stride_bytes, false);
+  }
+
+  // Whether the index reads memory at an address moving with the loop variable.
+  bool ReadsMemoryAt(const PrimExpr& index) const {
+    bool reads = false;
+    auto uses_loop_var = [this](const VarNode* var) { return var == loop_var_.get(); };
+    PostOrderVisit(index, [&](const ObjectRef& node) {
+      if (const auto* load = node.as<LoadNode>()) {
+        reads = reads || UsesVar(load->index, uses_loop_var);
+      } else if (const auto* load = node.as<BufferLoadNode>()) {
+        for (const PrimExpr& load_index : load->indices) {
+          reads = reads || UsesVar(load_index, uses_loop_var);
+        }
+      }
+    });
+    return reads;
+  }
+
+  void AddCandidate(const LoadNode* op, const PrimExpr& address, int64_t stride_bytes,
+                    bool indirect) {
+    for (const PrefetchCandidate& candidate : candidates_) {
+      if (candidate.load->buffer_var.same_as(op->buffer_var) &&
+          StructuralEqual()(candidate.load->index, address)) {
+        return;
+      }
+    }
+    Load load(op->dtype.element_of(), op->buffer_var, address, const_true());
+    candidates_.push_back({load, stride_bytes, indirect});
+  }
+
+  Var loop_var_;
+  int64_t min_stride_bytes_;
+  std::vector<const ForNode*> inner_loops_;
+  int unknown_inner_loops_{0};
+  int conditional_depth_{0};
+  std::vector<PrefetchCandidate> candidates_;
+};
+
+class AutoPrefetchInjector : public StmtMutator {
+ public:
+  explicit AutoPrefetchInjector(const InjectAutoPrefetchConfig& config) : config_(config) {}
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent || op->attr_key == attr::virtual_thread) {
+      return GetRef<Stmt>(op);
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    if (op->kind != ForKind::kSerial) return stmt;
+    const auto* extent = op->extent.as<IntImmNode>();
+    if (extent != nullptr && extent->value < config_->min_extent) return stmt;
+    std::vector<PrefetchCandidate> candidates =
+        PrefetchCandidateCollector(op->loop_var, config_->min_stride_bytes).Collect(op->body);
+    if (candidates.empty()) return stmt;
+
+    int64_t iteration_bytes = 0;
+    for (const PrefetchCandidate& candidate : candidates) {
+      iteration_bytes += candidate.stride_bytes;
+    }
+    int64_t distance = (config_->distance_bytes + iteration_bytes - 1) / iteration_bytes;
+    distance = std::max<int64_t>(1, std::min<int64_t>(distance, config_->max_distance));
+    PrimExpr ahead = op->loop_var + make_const(op->loop_var.dtype(), distance);
+
+    Array<Stmt> seq;
+    for (const PrefetchCandidate& candidate : candidates) {
+      Map<Var, PrimExpr> vmap;
+      vmap.Set(op->loop_var, ahead);
+      Load load = Downcast<Load>(Substitute(candidate.load, vmap));
+      PrimExpr address = Call(DataType::Handle(), builtin::address_of(), {load});
+      // a read prefetch with high temporal locality into the data cache
+      Stmt prefetch = Evaluate(Call(DataType::Int(32), builtin::prefetch(), {address, 0, 3, 1}));
+      if (candidate.indirect) {
+        // the index reads memory, which is only valid for the iterations of the loop
+        prefetch = IfThenElse(ahead < op->min + op->extent, prefetch);
+      }
+      seq.push_back(prefetch);
+    }
+    seq.push_back(op->body);
+    For loop = GetRef<For>(op);
+    loop.CopyOnWrite()->body = SeqStmt(seq);
+    return std::move(loop);
+  }
+
+ private:
+  InjectAutoPrefetchConfig config_;
+};
+
+namespace transform {
+
+Pass InjectAutoPrefetch() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto config = ctx->GetConfig<InjectAutoPrefetchConfig>("tir.InjectAutoPrefetch");
+    if (!config.defined()) {
+      config = AttrsWithDefaultValues<InjectAutoPrefetchConfig>();
+    }
+    if (config.value()->distance_bytes <= 0) return f;
+    // the prefetch intrinsic is only lowered for the CPU
+    Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (target.defined() && target.value()->kind->device_type != kDLCPU) return f;
+    auto* n = f.CopyOnWrite();
+    n->body = AutoPrefetchInjector(config.value())(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectAutoPrefetch", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectAutoPrefetch").set_body_typed(InjectAutoPrefetch);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,166 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_dma_async_copy.cc
+ * \brief Rewrite the contiguous copies out of the shared memory in an async_scope into
+ *  dma_copy.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <string>
+#include <vector>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+class DMAAsyncCopyInjector : public StmtMutator {
+ public:
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key != attr::async_scope) {
+      return StmtMutator::VisitStmt_(op);
+    }
+    bool in_async = in_async_;
+    in_async_ = true;
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    in_async_ = in_async;
+    return stmt;
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    if (in_async_) {
+      Stmt copy = MatchCopy(GetRef<Stmt>(op));
+      if (copy.defined()) return copy;
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const StoreNode* op) final {
+    if (in_async_) {
+      Stmt copy = MatchCopy(GetRef<Stmt>(op));
+      if (copy.defined()) return copy;
+    }
+    return GetRef<Stmt>(op);
+  }
+
+ private:
+  /*!
+   * \brief Rewrite a loop nest copying a buffer into one dma_copy per contiguous run.
+   * \return The copies, undefined when the nest is not a copy or has no contiguous run.
+   */
+  Stmt MatchCopy(const Stmt& stmt) {
+    std::vector<const ForNode*> loops;
+    Stmt body = stmt;
+    while (const ForNode* loop = body.as<ForNode>()) {
+      if (!is_zero(loop->min) || loop->kind == ForKind::kParallel ||
+          loop->kind == ForKind::kThreadBinding) {
+        return Stmt();
+      }
+      loops.push_back(loop);
+      body = loop->body;
+    }
+    const StoreNode* store = body.as<StoreNode>();
+    if (store == nullptr || !is_one(store->predicate)) return Stmt();
+    const LoadNode* load = store->value.as<LoadNode>();
+    if (load == nullptr || !is_one(load->predicate)) return Stmt();
+    if (std::string(GetPtrStorageScope(store->buffer_var)).find("shared") == 0) return Stmt();
+    PrimExpr dst_offset = ContiguousOffset(store->index);
+    PrimExpr src_offset = ContiguousOffset(load->index);
+    if (!dst_offset.defined() || !src_offset.defined()) return Stmt();
+
+    // merge the inner loops as long as both sides stay contiguous
+    DataType dtype = load->dtype;
+    PrimExpr run = make_const(dst_offset.dtype(), dtype.lanes());
+    size_t num_outer = loops.size();
+    while (num_outer > 0) {
+      const ForNode* loop = loops[num_outer - 1];
+      Array<PrimExpr> dst_coef = arith::DetectLinearEquation(dst_offset, {loop->loop_var});
+      Array<PrimExpr> src_coef = arith::DetectLinearEquation(src_offset, {loop->loop_var});
+      if (dst_coef.size() != 2 || src_coef.size() != 2 ||
+          !analyzer_.CanProveEqual(dst_coef[0], run) ||
+          !analyzer_.CanProveEqual(src_coef[0], run)) {
+        break;
+      }
+      run = run * cast(run.dtype(), loop->extent);
+      --num_outer;
+    }
+    // a copy one element at a time is left to the processor
+    if (num_outer == loops.size() && dtype.lanes() == 1) return Stmt();
+
+    Map<Var, PrimExpr> vmap;
+    for (size_t i = num_outer; i < loops.size(); ++i) {
+      vmap.Set(loops[i]->loop_var, make_zero(loops[i]->loop_var.dtype()));
+    }
+    dst_offset = analyzer_.Simplify(Substitute(dst_offset, vmap));
+    src_offset = analyzer_.Simplify(Substitute(src_offset, vmap));
+    run = analyzer_.Simplify(run);
+    auto access_ptr = [&](const Var& buffer_var, const PrimExpr& offset, int rw_mask) {
+      return Call(DataType::Handle(), builtin::tvm_access_ptr(),
+                  {TypeAnnotation(dtype.element_of()), buffer_var, offset, run, rw_mask});
+    };
+    PrimExpr nbytes = cast(DataType::Int(64), run) * dtype.bytes();
+    Stmt copy = Evaluate(Call(DataType::Void(), builtin::dma_copy(),
+                              {Integer(kDMAQueue), access_ptr(store->buffer_var, dst_offset, 2),
+                               access_ptr(load->buffer_var, src_offset, 1), nbytes}));
+    for (size_t i = num_outer; i > 0; --i) {
+      const ForNode* loop = loops[i - 1];
+      copy = For(loop->loop_var, loop->min, loop->extent, ForKind::kSerial, copy);
+    }
+    return copy;
+  }
+
+  // The first element of a contiguous access, undefined when the access is strided.
+  static PrimExpr ContiguousOffset(const PrimExpr& index) {
+    if (index.dtype().lanes() == 1) return index;
+    const RampNode* ramp = index.as<RampNode>();
+    if (ramp != nullptr && is_one(ramp->stride)) return ramp->base;
+    return PrimExpr();
+  }
+
+  // The queue the copies of InjectSoftwarePipeline are committed and waited on.
+  static constexpr int kDMAQueue = 0;
+  bool in_async_{false};
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+Pass InjectDMAAsyncCopy() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* n = f.CopyOnWrite();
+    n->body = DMAAsyncCopyInjector()(n->body);
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectDMAAsyncCopy", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectDMAAsyncCopy").set_body_typed(InjectDMAAsyncCopy);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,110 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_ptx_async_copy.cc
+ * \brief Rewrite the copies from the global to the shared memory in an async_scope into
+ *  ptx_cp_async.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+class PTXAsyncCopyInjector : public StmtMutator {
+ public:
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key != attr::async_scope) {
+      return StmtMutator::VisitStmt_(op);
+    }
+    bool in_async = in_async_;
+    in_async_ = true;
+    Stmt body = this->VisitStmt(op->body);
+    in_async_ = in_async;
+    return body;
+  }
+
+  Stmt VisitStmt_(const StoreNode* op) final {
+    if (!in_async_) return GetRef<Stmt>(op);
+    const LoadNode* load = op->value.as<LoadNode>();
+    if (load == nullptr || !is_one(op->predicate) || !is_one(load->predicate)) {
+      return GetRef<Stmt>(op);
+    }
+    if (!op->buffer_var->type_annotation.as<PointerTypeNode>() ||
+        !load->buffer_var->type_annotation.as<PointerTypeNode>()) {
+      return GetRef<Stmt>(op);
+    }
+    std::string dst_scope = GetPtrStorageScope(op->buffer_var);
+    std::string src_scope = GetPtrStorageScope(load->buffer_var);
+    if (dst_scope.find("shared") != 0 || (src_scope != "global" && !src_scope.empty())) {
+      return GetRef<Stmt>(op);
+    }
+    // cp.async copies 4, 8 or 16 contiguous bytes
+    DataType dtype = load->dtype;
+    int bytes = dtype.bytes() * dtype.lanes();
+    if (bytes != 4 && bytes != 8 && bytes != 16) return GetRef<Stmt>(op);
+    PrimExpr dst_offset = ContiguousOffset(op->index);
+    PrimExpr src_offset = ContiguousOffset(load->index);
+    if (!dst_offset.defined() || !src_offset.defined()) return GetRef<Stmt>(op);
+
+    auto access_ptr = [&](const Var& buffer_var, const PrimExpr& offset, int rw_mask) {
+      return Call(DataType::Handle(), builtin::tvm_access_ptr(),
+                  {TypeAnnotation(dtype.element_of()), buffer_var, offset,
+                   make_const(offset.dtype(), dtype.lanes()), rw_mask});
+    };
+    return Evaluate(Call(DataType::Void(), builtin::ptx_cp_async(),
+                         {access_ptr(op->buffer_var, dst_offset, 2),
+                          access_ptr(load->buffer_var, src_offset, 1), bytes}));
+  }
+
+ private:
+  // The first element of a contiguous access, undefined when the access is strided.
+  static PrimExpr ContiguousOffset(const PrimExpr& index) {
+    if (index.dtype().lanes() == 1) return index;
+    const RampNode* ramp = index.as<RampNode>();
+    if (ramp != nullptr && is_one(ramp->stride)) return ramp->base;
+    return PrimExpr();
+  }
+
+  bool in_async_{false};
+};
+
+namespace transform {
+
+Pass InjectPTXAsyncCopy() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* n = f.CopyOnWrite();
+    n->body = PTXAsyncCopyInjector()(n->body);
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectPTXAsyncCopy", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectPTXAsyncCopy").set_body_typed(InjectPTXAsyncCopy);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
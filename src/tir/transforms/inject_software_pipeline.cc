@@ -0,0 +1,520 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_software_pipeline.cc
+ * \brief Software pipeline the loops annotated with their stages.
+ *
+ *  The loop body is a sequence of statements, each one given a stage and an order by the
+ *  loop annotations. Iteration j of the pipelined loop runs, in the given order, every
+ *  statement for the original iteration j - stage, so the statements of the later stages
+ *  consume what the earlier stages produced a few iterations ago. The first and the last
+ *  max_stage iterations are emitted as an unrolled prologue and epilogue, with each
+ *  statement guarded by the range of its iteration.
+ *
+ *  The buffers allocated in the loop body and read by a later stage than the one writing
+ *  them are given one version per iteration in flight, selected by the iteration modulo the
+ *  number of versions.
+ *
+ *  The statements of an asynchronous stage are wrapped in async_scope, so that their copies
+ *  to the shared memory become ptx_cp_async, and their other copies dma_copy, and committed to
+ *  one group per iteration. The statements reading what they produce first wait for their
+ *  group.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+namespace software_pipeline {
+
+/*! \brief The buffers a statement of the pipeline body reads and writes. */
+struct BufferAccess {
+  std::unordered_set<const BufferNode*> reads;
+  std::unordered_set<const BufferNode*> writes;
+};
+
+class BufferAccessCollector : public StmtExprVisitor {
+ public:
+  static BufferAccess Collect(const Stmt& stmt) {
+    BufferAccessCollector collector;
+    collector(stmt);
+    return std::move(collector.access_);
+  }
+
+ private:
+  void VisitExpr_(const BufferLoadNode* op) final {
+    access_.reads.insert(op->buffer.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    access_.writes.insert(op->buffer.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  BufferAccess access_;
+};
+
+/*! \brief Rewrite the accesses to the versioned buffers to the version of an iteration. */
+class PipelineBufferRewriter : public StmtExprMutator {
+ public:
+  /*!
+   * \param versioned The versioned buffer of each buffer given more than one version.
+   * \param iteration The iteration relative to the start of the loop.
+   */
+  PipelineBufferRewriter(const std::unordered_map<const BufferNode*, Buffer>& versioned,
+                         PrimExpr iteration)
+      : versioned_(versioned), iteration_(std::move(iteration)) {
+    for (const auto& kv : versioned_) {
+      data_vars_.insert(kv.second->data.get());
+    }
+  }
+
+ private:
+  PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    BufferLoad load = Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op));
+    auto it = versioned_.find(load->buffer.get());
+    if (it == versioned_.end()) return std::move(load);
+    return BufferLoad(it->second, Versioned(it->second, load->indices), load->span);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode* op) final {
+    BufferStore store = Downcast<BufferStore>(StmtExprMutator::VisitStmt_(op));
+    auto it = versioned_.find(store->buffer.get());
+    if (it == versioned_.end()) return std::move(store);
+    return BufferStore(it->second, store->value, Versioned(it->second, store->indices),
+                       store->span);
+  }
+
+  Stmt VisitStmt_(const BlockNode* op) final {
+    Block block = Downcast<Block>(StmtExprMutator::VisitStmt_(op));
+    BlockNode* n = block.CopyOnWrite();
+    n->reads = VersionedRegions(n->reads);
+    n->writes = VersionedRegions(n->writes);
+    Array<MatchBufferRegion> match_buffers;
+    for (const MatchBufferRegion& match_buffer : n->match_buffers) {
+      Array<BufferRegion> source = VersionedRegions({match_buffer->source});
+      match_buffers.push_back(MatchBufferRegion(match_buffer->buffer, source[0]));
+    }
+    n->match_buffers = std::move(match_buffers);
+    return std::move(block);
+  }
+
+  PrimExpr VisitExpr_(const VarNode* op) final {
+    ICHECK(!data_vars_.count(op)) << "InjectSoftwarePipeline: the buffer " << op->name_hint
+                                  << " read by a later stage is accessed through its pointer, "
+                                     "which cannot be versioned";
+    return GetRef<PrimExpr>(op);
+  }
+
+  Array<PrimExpr> Versioned(const Buffer& buffer, const Array<PrimExpr>& indices) const {
+    Array<PrimExpr> result{floormod(iteration_, buffer->shape[0])};
+    for (const PrimExpr& index : indices) {
+      result.push_back(index);
+    }
+    return result;
+  }
+
+  Array<BufferRegion> VersionedRegions(const Array<BufferRegion>& regions) const {
+    Array<BufferRegion> result;
+    for (const BufferRegion& region : regions) {
+      auto it = versioned_.find(region->buffer.get());
+      if (it == versioned_.end()) {
+        result.push_back(region);
+        continue;
+      }
+      Array<Range> ranges{Range::FromMinExtent(floormod(iteration_, it->second->shape[0]), 1)};
+      for (const Range& range : region->region) {
+        ranges.push_back(range);
+      }
+      result.push_back(BufferRegion(it->second, ranges));
+    }
+    return result;
+  }
+
+  const std::unordered_map<const BufferNode*, Buffer>& versioned_;
+  std::unordered_set<const VarNode*> data_vars_;
+  PrimExpr iteration_;
+};
+
+/*! \brief Build the pipeline of one annotated loop. */
+class PipelineRewriter {
+ public:
+  PipelineRewriter(const ForNode* loop, const Map<Var, Buffer>& buffer_data_to_buffer)
+      : loop_(loop), buffer_data_to_buffer_(buffer_data_to_buffer) {}
+
+  Stmt Rewrite() {
+    ICHECK(loop_->kind == ForKind::kSerial)
+        << "InjectSoftwarePipeline: only a serial loop can be pipelined, got " << loop_->kind;
+    ExtractBody();
+    ReadAnnotations();
+    PlanVersions();
+    PlanAsync();
+
+    PrimExpr min = loop_->min;
+    PrimExpr extent = loop_->extent;
+    PrimExpr num_stages = make_const(extent.dtype(), max_stage_);
+    PrimExpr steady_end = analyzer_.Simplify(max(extent, num_stages));
+    Array<Stmt> seq;
+    // The prologue and the epilogue run max_stage iterations each, only some of their
+    // statements are in the range of the loop.
+    EmitLoop(min, num_stages, ForKind::kUnrolled, &seq);
+    EmitLoop(analyzer_.Simplify(min + num_stages), analyzer_.Simplify(steady_end - num_stages),
+             loop_->kind, &seq);
+    EmitLoop(analyzer_.Simplify(min + steady_end),
+             analyzer_.Simplify(extent + num_stages - steady_end), ForKind::kUnrolled, &seq);
+    Stmt pipeline = SeqStmt::Flatten(seq);
+    if (body_block_ == nullptr || alloc_buffers_.empty()) return pipeline;
+
+    Block block(/*iter_vars=*/{}, /*reads=*/{}, /*writes=*/{}, body_block_->name_hint, pipeline,
+                /*init=*/NullOpt, alloc_buffers_, /*match_buffers=*/{}, body_block_->annotations);
+    Array<Array<BufferRegion>> access = GetBlockReadWriteRegion(block, buffer_data_to_buffer_);
+    BlockNode* n = block.CopyOnWrite();
+    n->reads = access[0];
+    n->writes = access[1];
+    return BlockRealize({}, Bool(true), block);
+  }
+
+ private:
+  void ExtractBody() {
+    Stmt body = loop_->body;
+    if (const BlockRealizeNode* realize = body.as<BlockRealizeNode>()) {
+      const BlockNode* block = realize->block.get();
+      ICHECK(block->iter_vars.empty() && is_one(realize->predicate) && !block->init.defined() &&
+             block->match_buffers.empty())
+          << "InjectSoftwarePipeline: the body of a pipelined loop must be an opaque block";
+      body_block_ = block;
+      alloc_buffers_ = block->alloc_buffers;
+      body = block->body;
+    }
+    if (const SeqStmtNode* seq = body.as<SeqStmtNode>()) {
+      for (const Stmt& stmt : seq->seq) {
+        stmts_.push_back(stmt);
+      }
+    } else {
+      stmts_.push_back(body);
+    }
+  }
+
+  void ReadAnnotations() {
+    auto get = [this](const char* key) {
+      auto it = loop_->annotations.find(key);
+      ICHECK(it != loop_->annotations.end())
+          << "InjectSoftwarePipeline: the pipelined loop needs the annotation " << key;
+      Array<Integer> values = Downcast<Array<Integer>>((*it).second);
+      ICHECK_EQ(values.size(), stmts_.size())
+          << "InjectSoftwarePipeline: " << key << " needs one value per statement";
+      return values;
+    };
+    Array<Integer> stage = get(attr::software_pipeline_stage);
+    Array<Integer> order = get(attr::software_pipeline_order);
+    std::vector<bool> seen(stmts_.size(), false);
+    order_.resize(stmts_.size());
+    for (size_t i = 0; i < stmts_.size(); ++i) {
+      stages_.push_back(stage[i]->value);
+      ICHECK_GE(stages_.back(), 0) << "InjectSoftwarePipeline: negative stage";
+      max_stage_ = std::max(max_stage_, stages_.back());
+      int64_t pos = order[i]->value;
+      ICHECK(pos >= 0 && pos < static_cast<int64_t>(stmts_.size()) && !seen[pos])
+          << "InjectSoftwarePipeline: " << attr::software_pipeline_order
+          << " must be a permutation of the statements, got " << order;
+      seen[pos] = true;
+      order_[pos] = i;
+      accesses_.push_back(BufferAccessCollector::Collect(stmts_[i]));
+    }
+    auto it = loop_->annotations.find(attr::software_pipeline_async_stages);
+    if (it != loop_->annotations.end()) {
+      for (const Integer& stage : Downcast<Array<Integer>>((*it).second)) {
+        async_stages_.insert(stage->value);
+      }
+    }
+  }
+
+  void PlanVersions() {
+    std::unordered_set<const BufferNode*> local;
+    for (const Buffer& buffer : alloc_buffers_) {
+      local.insert(buffer.get());
+    }
+    // the first stage writing and the last stage reading each buffer
+    std::unordered_map<const BufferNode*, std::pair<int, int>> stage_range;
+    std::unordered_map<const BufferNode*, std::set<int>> stages_of;
+    for (size_t i = 0; i < stmts_.size(); ++i) {
+      for (const BufferNode* buffer : accesses_[i].writes) {
+        auto& range = stage_range.emplace(buffer, std::make_pair(stages_[i], -1)).first->second;
+        range.first = std::min(range.first, stages_[i]);
+        stages_of[buffer].insert(stages_[i]);
+      }
+    }
+    for (size_t i = 0; i < stmts_.size(); ++i) {
+      for (const BufferNode* buffer : accesses_[i].reads) {
+        auto it = stage_range.find(buffer);
+        if (it == stage_range.end()) continue;
+        it->second.second = std::max(it->second.second, stages_[i]);
+        stages_of[buffer].insert(stages_[i]);
+      }
+    }
+    for (const auto& kv : stage_range) {
+      const BufferNode* buffer = kv.first;
+      int write_stage = kv.second.first, read_stage = kv.second.second;
+      if (!local.count(buffer)) {
+        // the buffers of the outer scope are shared by all the iterations in flight
+        ICHECK_LE(stages_of[buffer].size(), 1U)
+            << "InjectSoftwarePipeline: the buffer " << buffer->name
+            << " is accessed by several stages, it must be allocated in the pipelined loop";
+        continue;
+      }
+      ICHECK(read_stage < 0 || read_stage >= write_stage)
+          << "InjectSoftwarePipeline: the buffer " << buffer->name
+          << " is read by an earlier stage than the one writing it";
+      if (read_stage > write_stage) {
+        num_versions_[buffer] = read_stage - write_stage + 1;
+      }
+    }
+    Array<Buffer> alloc_buffers;
+    for (const Buffer& buffer : alloc_buffers_) {
+      auto it = num_versions_.find(buffer.get());
+      if (it == num_versions_.end()) {
+        alloc_buffers.push_back(buffer);
+        continue;
+      }
+      ObjectPtr<BufferNode> n = make_object<BufferNode>(*buffer.get());
+      Array<PrimExpr> shape{Integer(it->second)};
+      for (const PrimExpr& dim : buffer->shape) shape.push_back(dim);
+      if (!buffer->strides.empty()) {
+        Array<PrimExpr> strides{buffer->strides[0] * buffer->shape[0]};
+        for (const PrimExpr& stride : buffer->strides) strides.push_back(stride);
+        n->strides = std::move(strides);
+      }
+      n->shape = std::move(shape);
+      Buffer new_buffer(n);
+      versioned_.emplace(buffer.get(), new_buffer);
+      alloc_buffers.push_back(new_buffer);
+    }
+    alloc_buffers_ = std::move(alloc_buffers);
+  }
+
+  void PlanAsync() {
+    if (async_stages_.empty()) return;
+    ICHECK_EQ(async_stages_.size(), 1U)
+        << "InjectSoftwarePipeline: the copies of only one stage can be asynchronous";
+    async_stage_ = *async_stages_.begin();
+    for (size_t pos = 0; pos < order_.size(); ++pos) {
+      size_t i = order_[pos];
+      if (stages_[i] != async_stage_) continue;
+      commit_pos_ = static_cast<int>(pos);
+      for (const BufferNode* buffer : accesses_[i].writes) {
+        async_buffers_.insert(buffer);
+        String scope = GetRef<Buffer>(buffer).scope();
+        if (std::string(scope).find("shared") == 0) {
+          sync_scopes_.insert(scope);
+        } else {
+          use_dma_ = true;
+        }
+      }
+    }
+    ICHECK(!use_dma_ || sync_scopes_.empty())
+        << "InjectSoftwarePipeline: the asynchronous copies go either to the shared memory or "
+           "through DMA";
+    ICHECK_GE(commit_pos_, 0) << "InjectSoftwarePipeline: no statement in the asynchronous stage "
+                              << async_stage_;
+    num_pending_.assign(stmts_.size(), -1);
+    for (size_t pos = 0; pos < order_.size(); ++pos) {
+      size_t i = order_[pos];
+      bool reads_async = false;
+      for (const BufferNode* buffer : accesses_[i].reads) {
+        reads_async |= async_buffers_.count(buffer) != 0;
+      }
+      if (!reads_async) continue;
+      ICHECK_GE(stages_[i], async_stage_)
+          << "InjectSoftwarePipeline: a statement reads the asynchronous copies of a later "
+             "stage";
+      // the groups committed after the one of the consumed iteration may stay in flight
+      num_pending_[i] =
+          stages_[i] - async_stage_ - 1 + (commit_pos_ < static_cast<int>(pos) ? 1 : 0);
+      ICHECK_GE(num_pending_[i], 0)
+          << "InjectSoftwarePipeline: a statement reads the asynchronous copies of its "
+             "iteration before they are committed";
+    }
+  }
+
+  /*!
+   * \brief Emit a loop running the pipeline over a range of its iterations.
+   * \param start The first iteration of the pipelined loop.
+   * \param extent The number of iterations.
+   * \param kind The kind of the loop.
+   * \param seq The statements the loop is appended to.
+   */
+  void EmitLoop(PrimExpr start, PrimExpr extent, ForKind kind, Array<Stmt>* seq) {
+    if (analyzer_.CanProve(extent <= 0)) return;
+    Var loop_var = loop_->loop_var.copy_with_suffix("");
+    analyzer_.Bind(loop_var, Range::FromMinExtent(start, extent));
+    Array<Stmt> body;
+    int num_pending = std::numeric_limits<int>::max();
+    for (size_t pos = 0; pos < order_.size(); ++pos) {
+      size_t i = order_[pos];
+      if (async_stage_ >= 0 && num_pending_[i] >= 0 && num_pending_[i] < num_pending) {
+        num_pending = num_pending_[i];
+        if (use_dma_) {
+          body.push_back(Evaluate(Call(DataType::Void(), builtin::dma_wait_group(),
+                                       {Integer(kDMAQueue), Integer(num_pending)})));
+        } else {
+          body.push_back(Evaluate(
+              Call(DataType::Void(), builtin::ptx_wait_group(), {Integer(num_pending)})));
+        }
+        for (const String& scope : sync_scopes_) {
+          body.push_back(Evaluate(
+              Call(DataType::Int(32), builtin::tvm_storage_sync(), {StringImm(scope)})));
+        }
+      }
+      PrimExpr iteration = loop_var - make_const(loop_var.dtype(), stages_[i]);
+      PrimExpr in_range = analyzer_.Simplify(loop_->min <= iteration &&
+                                             iteration < loop_->min + loop_->extent);
+      if (!is_zero(in_range)) {
+        PipelineBufferRewriter rewriter(versioned_, iteration - loop_->min);
+        Stmt stmt = Substitute(rewriter(stmts_[i]), {{loop_->loop_var, iteration}});
+        if (stages_[i] == async_stage_) {
+          stmt = AttrStmt(make_zero(DataType::Int(32)), attr::async_scope, 1, stmt);
+        }
+        if (!is_one(in_range)) {
+          stmt = IfThenElse(in_range, stmt);
+        }
+        body.push_back(stmt);
+      }
+      if (async_stage_ >= 0 && static_cast<int>(pos) == commit_pos_) {
+        // committed in every iteration, so that the number of groups in flight is the same
+        if (use_dma_) {
+          body.push_back(Evaluate(
+              Call(DataType::Void(), builtin::dma_commit_group(), {Integer(kDMAQueue)})));
+        } else {
+          body.push_back(Evaluate(Call(DataType::Void(), builtin::ptx_commit_group(), {})));
+        }
+      }
+    }
+    if (body.empty()) return;
+    Map<String, ObjectRef> annotations;
+    for (const auto& kv : loop_->annotations) {
+      if (kv.first != attr::software_pipeline_stage && kv.first != attr::software_pipeline_order &&
+          kv.first != attr::software_pipeline_async_stages) {
+        annotations.Set(kv.first, kv.second);
+      }
+    }
+    seq->push_back(For(loop_var, start, extent, kind, SeqStmt::Flatten(body), NullOpt,
+                       kind == loop_->kind ? annotations : Map<String, ObjectRef>()));
+  }
+
+  const ForNode* loop_;
+  const Map<Var, Buffer>& buffer_data_to_buffer_;
+  arith::Analyzer analyzer_;
+  /*! \brief The block of the loop body, nullptr when there is none. */
+  const BlockNode* body_block_{nullptr};
+  /*! \brief The buffers allocated in the loop body, versioned. */
+  Array<Buffer> alloc_buffers_;
+  /*! \brief The statements of the loop body, their stage and buffer accesses. */
+  std::vector<Stmt> stmts_;
+  std::vector<int> stages_;
+  std::vector<BufferAccess> accesses_;
+  /*! \brief The statement emitted at each position. */
+  std::vector<size_t> order_;
+  int max_stage_{0};
+  /*! \brief The number of versions of the buffers given more than one. */
+  std::unordered_map<const BufferNode*, int> num_versions_;
+  std::unordered_map<const BufferNode*, Buffer> versioned_;
+  /*! \brief The stages annotated as asynchronous. */
+  std::set<int> async_stages_;
+  /*! \brief The asynchronous stage, -1 when there is none. */
+  int async_stage_{-1};
+  /*! \brief The position the group of the asynchronous copies is committed after. */
+  int commit_pos_{-1};
+  /*! \brief The buffers written asynchronously and the shared scopes among them. */
+  std::unordered_set<const BufferNode*> async_buffers_;
+  std::set<String> sync_scopes_;
+  /*! \brief Whether the asynchronous copies go through DMA, on the queue kDMAQueue. */
+  bool use_dma_{false};
+  static constexpr int kDMAQueue = 0;
+  /*! \brief The groups left in flight before each statement, -1 when it does not wait. */
+  std::vector<int> num_pending_;
+};
+
+class PipelineInjector : public StmtExprMutator {
+ public:
+  static Stmt Inject(const PrimFunc& func) {
+    PipelineInjector injector;
+    for (const auto& kv : func->buffer_map) {
+      injector.buffer_data_to_buffer_.Set(kv.second->data, kv.second);
+    }
+    return injector(func->body);
+  }
+
+ private:
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtExprMutator::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    if (op == nullptr || !op->annotations.count(attr::software_pipeline_stage)) return stmt;
+    return PipelineRewriter(op, buffer_data_to_buffer_).Rewrite();
+  }
+
+  Stmt VisitStmt_(const BlockNode* op) final {
+    for (const Buffer& buffer : op->alloc_buffers) {
+      buffer_data_to_buffer_.Set(buffer->data, buffer);
+    }
+    Stmt stmt = StmtExprMutator::VisitStmt_(op);
+    for (const Buffer& buffer : op->alloc_buffers) {
+      buffer_data_to_buffer_.erase(buffer->data);
+    }
+    return stmt;
+  }
+
+  Map<Var, Buffer> buffer_data_to_buffer_;
+};
+
+}  // namespace software_pipeline
+
+namespace transform {
+
+Pass InjectSoftwarePipeline() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* fptr = f.CopyOnWrite();
+    fptr->body = software_pipeline::PipelineInjector::Inject(f);
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSoftwarePipeline", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSoftwarePipeline").set_body_typed(InjectSoftwarePipeline);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
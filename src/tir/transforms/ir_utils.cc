@@ -27,6 +27,7 @@
 #include <tvm/arith/int_solver.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -252,6 +253,53 @@ Bool IsFromLegacyTESchedule(PrimFunc f) {
   return from_legacy_te_schedule.value();
 }
 
+std::vector<int64_t> EvalForWarpLanes(const PrimExpr& index,
+                                      const std::vector<std::pair<Var, int64_t>>& threads) {
+  int64_t num_lanes = 1;
+  for (const auto& thread : threads) {
+    num_lanes *= thread.second;
+  }
+  num_lanes = std::min<int64_t>(num_lanes, 32);
+  arith::Analyzer analyzer;
+  std::vector<int64_t> values;
+  for (int64_t lane = 0; lane < num_lanes; ++lane) {
+    std::unordered_map<const VarNode*, int64_t> lane_index;
+    int64_t rest = lane;
+    for (const auto& thread : threads) {
+      lane_index[thread.first.get()] = rest % thread.second;
+      rest /= thread.second;
+    }
+    PrimExpr value = Substitute(index, [&](const Var& var) -> Optional<PrimExpr> {
+      auto it = lane_index.find(var.get());
+      return make_const(var.dtype(), it != lane_index.end() ? it->second : 0);
+    });
+    const auto* imm = analyzer.Simplify(value).as<IntImmNode>();
+    if (imm == nullptr) return {};
+    values.push_back(imm->value);
+  }
+  return values;
+}
+
+int SharedMemoryBankConflictWays(const std::vector<int64_t>& lane_offsets, int access_bytes) {
+  int64_t lanes_per_transaction = kSharedMemoryBanks * 4 / std::max(access_bytes, 4);
+  int ways = 1;
+  for (size_t begin = 0; begin < lane_offsets.size(); begin += lanes_per_transaction) {
+    size_t end = std::min<size_t>(lane_offsets.size(), begin + lanes_per_transaction);
+    std::vector<std::unordered_set<int64_t>> bank_words(kSharedMemoryBanks);
+    for (size_t i = begin; i < end; ++i) {
+      // the lanes reading the same word share the transaction, only distinct words conflict
+      for (int64_t word = lane_offsets[i] / 4; word <= (lane_offsets[i] + access_bytes - 1) / 4;
+           ++word) {
+        int64_t bank = (word % kSharedMemoryBanks + kSharedMemoryBanks) % kSharedMemoryBanks;
+        std::unordered_set<int64_t>& words = bank_words[bank];
+        words.insert(word);
+        ways = std::max(ways, static_cast<int>(words.size()));
+      }
+    }
+  }
+  return ways;
+}
+
 Map<Var, Range> ConditionalBoundsContext::GetVarBoundsFromCondition() {
   // extract equations and related vars from condition expression.
   // currently only extract simple integral equations which could be solvable.
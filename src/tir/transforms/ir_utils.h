@@ -35,6 +35,7 @@
 #include <limits>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -227,6 +228,36 @@ Region ConvertRegion(const MatchBufferRegion& match_buffer, const Region& region
  */
 Bool IsFromLegacyTESchedule(PrimFunc f);
 
+/*! \brief The number of banks of the shared memory of a GPU, each one 4 bytes wide. */
+constexpr int kSharedMemoryBanks = 32;
+
+/*!
+ * \brief Evaluate an index for each lane of the first warp of a thread block.
+ *
+ *  The threads are numbered with threadIdx.x varying fastest, and the variables other than
+ *  the thread indices are set to zero.
+ *
+ * \param index The index to evaluate.
+ * \param threads The threadIdx.x, threadIdx.y and threadIdx.z variables found so far, with
+ *  their extents.
+ * \return The value of the index in each lane, empty when it is not a constant.
+ */
+std::vector<int64_t> EvalForWarpLanes(const PrimExpr& index,
+                                      const std::vector<std::pair<Var, int64_t>>& threads);
+
+/*!
+ * \brief Estimate the bank conflicts of a shared memory access by one warp.
+ *
+ *  An access of 8 or 16 bytes per lane is served in two or four transactions of one half or
+ *  one quarter warp, the conflicts are the ones within a transaction.
+ *
+ * \param lane_offsets The byte offset accessed by each lane, in lane order.
+ * \param access_bytes The number of bytes accessed by each lane.
+ * \return The largest number of distinct 4 byte words mapped to one bank within a
+ *  transaction, 1 when the access is free of conflicts.
+ */
+int SharedMemoryBankConflictWays(const std::vector<int64_t>& lane_offsets, int access_bytes);
+
 /*!
  *\brief Context helper to update domain map within conditional scope.
  *
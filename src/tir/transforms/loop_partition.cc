@@ -42,12 +42,18 @@ namespace tir {
 struct LoopPartitionConfigNode : public tvm::AttrsNode<LoopPartitionConfigNode> {
   bool partition_const_loop;
   bool no_unroll_loop_with_extent_one;
+  bool partition_vectorized_tail;
 
   TVM_DECLARE_ATTRS(LoopPartitionConfigNode, "tir.transform.LoopPartitionConfig") {
     TVM_ATTR_FIELD(partition_const_loop).describe("Split constant loop").set_default(false);
     TVM_ATTR_FIELD(no_unroll_loop_with_extent_one)
         .describe("Don't unroll loops with extent 1")
         .set_default(false);
+    TVM_ATTR_FIELD(partition_vectorized_tail)
+        .describe(
+            "Split the constant loops around and of vectorized loops into a vectorized main body "
+            "and a tail, vectorized or scalar by a cost estimate")
+        .set_default(false);
   }
 };
 
@@ -85,19 +91,33 @@ using Partition = std::unordered_map<PartitionKey, IntSet, PartitionKeyHash, Par
 
 using ExpressionSet = std::unordered_set<PrimExpr, ObjectPtrHash, ObjectPtrEqual>;
 
+bool ContainsVectorizedLoop(const Stmt& stmt) {
+  bool found = false;
+  PostOrderVisit(stmt, [&found](const ObjectRef& node) {
+    if (const ForNode* op = node.as<ForNode>()) {
+      found = found || op->kind == ForKind::kVectorized;
+    }
+  });
+  return found;
+}
+
 // Select potential candidate IRs that can be partitioned.
 // Rule:
-//   - the range should not be const
+//   - the range should not be const, unless it is or contains a vectorized loop and the
+//     tails of vectorized loops are partitioned
 //   - there exist a condition expression in the scope that use the var
 class CandidateSelector final : public StmtExprVisitor {
  public:
   using VarIsUsed = bool;
-  explicit CandidateSelector(bool partition_const_loop)
-      : partition_const_loop_(partition_const_loop) {}
+  explicit CandidateSelector(bool partition_const_loop, bool partition_vectorized_tail = false)
+      : partition_const_loop_(partition_const_loop),
+        partition_vectorized_tail_(partition_vectorized_tail) {}
 
   void VisitStmt_(const ForNode* op) final {
     // partition const loop when sets partition_const_loop_
-    if (!is_const_int(op->min) || !is_const_int(op->extent) || partition_const_loop_) {
+    if (!is_const_int(op->min) || !is_const_int(op->extent) || partition_const_loop_ ||
+        (partition_vectorized_tail_ &&
+         (op->kind == ForKind::kVectorized || ContainsVectorizedLoop(op->body)))) {
       // always treat var with hint to be partitioned
       const VarNode* var = op->loop_var.get();
       if (partition_hint_vars.count(var)) {
@@ -189,6 +209,7 @@ class CandidateSelector final : public StmtExprVisitor {
   bool in_likely_{false};
   bool no_split_{false};
   bool partition_const_loop_{false};
+  bool partition_vectorized_tail_{false};
   std::unordered_map<const VarNode*, VarIsUsed> record_;
 };
 
@@ -373,9 +394,11 @@ class ThreadPartitionInserter : public StmtMutator {
 // likely conditions
 class LoopPartitioner : public StmtMutator {
  public:
-  explicit LoopPartitioner(bool partition_const_loop, bool no_unroll_loop_with_extent_one)
-      : selector(CandidateSelector(partition_const_loop)),
-        no_unroll_loop_with_extent_one_(no_unroll_loop_with_extent_one) {}
+  explicit LoopPartitioner(bool partition_const_loop, bool no_unroll_loop_with_extent_one,
+                           bool partition_vectorized_tail = false)
+      : selector(CandidateSelector(partition_const_loop, partition_vectorized_tail)),
+        no_unroll_loop_with_extent_one_(no_unroll_loop_with_extent_one),
+        partition_vectorized_tail_(partition_vectorized_tail) {}
 
   Stmt VisitAndMutate(Stmt stmt) {
     selector(stmt);
@@ -437,12 +460,15 @@ class LoopPartitioner : public StmtMutator {
 
   inline Stmt MakeFor(const Object* op, PrimExpr extent, Stmt body);
 
+  bool VectorizeTail(const PrimExpr& extent, const Stmt& body);
+
   /* Candidate IRs that may be partitioned potentially */
   std::unordered_map<const VarNode*, IntSet> hint_map_;
   std::unordered_map<const VarNode*, IntSet> relax_map_;
   arith::Analyzer analyzer_;
   CandidateSelector selector;
   bool no_unroll_loop_with_extent_one_;
+  bool partition_vectorized_tail_;
 };
 
 // Returns an interval (in the first component) in which all the conditions
@@ -644,10 +670,41 @@ inline Stmt LoopPartitioner::MakeFor(const Object* node, PrimExpr extent, Stmt b
     return Substitute(body, {{Var{for_node->loop_var}, make_const(DataType::Int(32), 0)}});
   } else {
     ICHECK(for_node->kind != ForKind::kThreadBinding);
-    return For(for_node->loop_var, IntImm(for_node->min.dtype(), 0), extent, for_node->kind, body);
+    ForKind kind = for_node->kind;
+    if (kind == ForKind::kVectorized && partition_vectorized_tail_ &&
+        !VectorizeTail(extent, body)) {
+      kind = ForKind::kSerial;
+    }
+    return For(for_node->loop_var, IntImm(for_node->min.dtype(), 0), extent, kind, body);
   }
 }
 
+// Whether a piece of a partitioned vectorized loop is cheaper vectorized than scalar.
+//
+// The piece must have a constant extent to be vectorized. A vector of that many lanes is
+// legalized into one power of two vector per set bit of the extent, against one iteration
+// per lane for a scalar loop. A body with loops or conditions left after the partition is
+// scalarized by the vectorizer anyway, with the extra cost of extracting the lanes, so it
+// stays scalar.
+bool LoopPartitioner::VectorizeTail(const PrimExpr& extent, const Stmt& body) {
+  const int64_t* lanes = as_const_int(analyzer_.Simplify(extent));
+  if (lanes == nullptr || *lanes <= 1) return false;
+  bool scalarized = false;
+  PostOrderVisit(body, [&scalarized](const ObjectRef& node) {
+    if (const IfThenElseNode* op = node.as<IfThenElseNode>()) {
+      PrimExpr cond = op->condition;
+      const CallNode* call = cond.as<CallNode>();
+      if (call != nullptr && call->op.same_as(builtin::likely())) cond = call->args[0];
+      scalarized = scalarized || !is_const_int(cond);
+    }
+    scalarized = scalarized || node->IsInstance<ForNode>();
+  });
+  if (scalarized) return false;
+  int64_t num_vectors = 0;
+  for (int64_t rest = *lanes; rest != 0; rest &= rest - 1) ++num_vectors;
+  return num_vectors < *lanes;
+}
+
 class RemoveLikelyTagsAndHints : public StmtExprMutator {
  public:
   PrimExpr VisitExpr_(const CallNode* op) final {
@@ -667,8 +724,10 @@ class RemoveLikelyTagsAndHints : public StmtExprMutator {
   }
 };
 
-Stmt LoopPartition(Stmt stmt, bool partition_const_loop, bool no_unroll_loop_with_extent_one) {
-  stmt = LoopPartitioner(partition_const_loop, no_unroll_loop_with_extent_one)
+Stmt LoopPartition(Stmt stmt, bool partition_const_loop, bool no_unroll_loop_with_extent_one,
+                   bool partition_vectorized_tail) {
+  stmt = LoopPartitioner(partition_const_loop, no_unroll_loop_with_extent_one,
+                         partition_vectorized_tail)
              .VisitAndMutate(std::move(stmt));
   stmt = RemoveLikelyTagsAndHints()(std::move(stmt));
   return stmt;
@@ -684,7 +743,8 @@ Pass LoopPartition() {
       cfg = AttrsWithDefaultValues<LoopPartitionConfig>();
     }
     n->body = LoopPartition(std::move(n->body), cfg.value()->partition_const_loop,
-                            cfg.value()->no_unroll_loop_with_extent_one);
+                            cfg.value()->no_unroll_loop_with_extent_one,
+                            cfg.value()->partition_vectorized_tail);
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.LoopPartition", {});
@@ -42,7 +42,9 @@ class StorageAccessInfoLower : public StmtExprMutator {
  public:
   Stmt VisitStmt_(const AllocateNode* op) final {
     auto scope = StorageScope::Create(GetPtrStorageScope(op->buffer_var));
-    if (scope.tag.length() != 0 && scope.tag != ".dyn") {
+    // the VTCM of global scope is allocated at runtime, by LowerTVMBuiltin.
+    bool is_global_vtcm = scope.rank == StorageRank::kGlobal && scope.tag == ".vtcm";
+    if (scope.tag.length() != 0 && scope.tag != ".dyn" && !is_global_vtcm) {
       auto info = GetMemoryInfo(GetPtrStorageScope(op->buffer_var));
       ICHECK(info.defined()) << "Cannot find memory info of " << scope.to_string();
       ICHECK(storage_info_.find(op->buffer_var.get()) == storage_info_.end())
@@ -104,6 +104,12 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
         stmt = Allocate(repl->buffer_var, repl->dtype, repl->extents, repl->condition, op->body);
         new_storage_scopes_[repl->buffer_var.get()] = "shared";
       }
+      auto staging = staging_allocs_.find(op->buffer_var.get());
+      if (staging != staging_allocs_.end()) {
+        const AllocateNode* buf = staging->second.as<AllocateNode>();
+        stmt = Allocate(buf->buffer_var, buf->dtype, buf->extents, buf->condition, stmt);
+        new_storage_scopes_[buf->buffer_var.get()] = "shared";
+      }
       return stmt;
     } else {
       return stmt;
@@ -238,9 +244,23 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     // broadcast results from lane 0 to all other lanes and store
     // the final reduction result to the proper location.
     //
+    // The targets shuffling with shuffle_xor do a butterfly instead, which
+    // leaves the result in every lane, so there is nothing to broadcast.
+    //
+    // A reduction on threadIdx.x over several warps first reduces each warp,
+    // then the lane 0 of each warp stores its result to shared memory and
+    // the first warp_size of these results are reduced again in every warp.
+    //
+    int num_warps = 0;
     if (is_warp_reduction(types)) {
       // TODO(tvm-team) sub-warp reduction support.
       ICHECK_EQ(reduce_extent, warp_size_) << "not a warp reduction";
+      num_warps = 1;
+    } else if (is_multi_warp_reduction(types, vred, reduce_extent)) {
+      num_warps = reduce_extent / warp_size_;
+    }
+    if (num_warps > 0) {
+      bool shuffle_xor = use_shuffle_xor();
       //
       // This is the index to the reduction variable, one reduction
       // variable per warp. Local scope seems easier to reason without
@@ -277,60 +297,60 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       }
 
       // Emit reductions within a warp.
-      for (int offset = warp_size_ / 2; offset > 0; offset /= 2) {
-        // Load reduction values, no synchronization needed.
-        Array<PrimExpr> a, b;
+      EmitWarpReduce(combiner, types, shared_bufs, local_vars, mask_var, warp_size_ / 2, &seq);
+
+      if (num_warps > 1) {
+        PrimExpr lane = floormod(reduce_index, warp_size_);
+        PrimExpr warp_id = floordiv(reduce_index, warp_size_);
+        // This sync is necessary because there might be incomplete read of
+        // previous iteration on the same buffer.
+        seq.emplace_back(SyncThread("shared"));
+        std::vector<Var> staging_bufs(size);
+        std::vector<Stmt> stores(size);
         for (size_t i = 0; i < size; ++i) {
-          Var var = shared_bufs[i];
           PrimExpr pred = const_true(types[i].lanes());
-          PrimExpr val = Load(types[i], var, index, pred);
-          a.push_back(val);
-
-          // __shfl_*sync calls shall not appear in if_then_else expressions
-          // as this is causing extra divergency. E.g.
-          //
-          // v1 = (v2 < v3) ? v3 : __shfl_sync(mask, v1, 0);
-          //
-          // behaves differently from
-          //
-          // int t = __shfl_sync(mask, v1, 0);
-          // v1 = (v2 < v3) ? v3 : t;
-          //
-          // The former may cause dead lock as there is a divergent
-          // branch with a warp sync call inside.
-          //
-          PrimExpr other = WarpShuffle(builtin::tvm_warp_shuffle_down(), mask_var, val, offset);
-          const AllocateNode* repl = local_vars[i].as<AllocateNode>();
-          Stmt s = Store(repl->buffer_var, other, index, pred);
-          seq.push_back(s);
-
-          PrimExpr load = Load(types[i], repl->buffer_var, index, pred);
-          b.push_back(load);
+          staging_bufs[i] =
+              Var("red_buf_staging" + std::to_string(i), PointerType(PrimType(types[i])));
+          stores[i] = Store(staging_bufs[i], Load(types[i], shared_bufs[i], index, pred),
+                            BufIndex(warp_id, group_index, num_warps), pred);
         }
-
-        // Do reductions.
-        Array<PrimExpr> ret = (*combiner)(a, b);
-
-        // Store the reduction result to itself.
-        std::vector<Stmt> stores(size);
+        seq.emplace_back(IfThenElse(lane == 0, SeqStmt::Flatten(stores)));
+        seq.emplace_back(SyncThread("shared"));
         for (size_t i = 0; i < size; ++i) {
-          Var var = shared_bufs[i];
           PrimExpr pred = const_true(types[i].lanes());
-          stores[i] = Store(var, ret[i], index, pred);
+          PrimExpr val = if_then_else(
+              lane < num_warps,
+              Load(types[i], staging_bufs[i], BufIndex(lane, group_index, num_warps), pred),
+              inits[i]);
+          seq.emplace_back(Store(shared_bufs[i], val, index, pred));
+          ICHECK(!staging_allocs_.count(buffers[i]));
+          staging_allocs_[buffers[i]] = Allocate(staging_bufs[i], types[i],
+                                                 {PrimExpr(group_extent * num_warps)}, pred,
+                                                 Evaluate(0));
         }
-        seq.push_back(SeqStmt::Flatten(stores));
+        // Only the lanes below num_warps hold values. The butterfly still
+        // goes through the whole warp to leave the result in every lane.
+        int offset = warp_size_ / 2;
+        if (!shuffle_xor) {
+          offset = 1;
+          while (offset < num_warps) offset *= 2;
+          offset /= 2;
+        }
+        EmitWarpReduce(combiner, types, shared_bufs, local_vars, mask_var, offset, &seq);
       }
 
-      // Broadcast the reduction result from lane 0 to all other lanes.
-      // This avoids to emit predicated stores, as all threads are
-      // uniformmly writting the same result.
-      //
-      for (size_t i = 0; i < size; ++i) {
-        Var var = shared_bufs[i];
-        PrimExpr pred = const_true(types[i].lanes());
-        PrimExpr val = Load(types[i], var, index, pred);
-        PrimExpr splat = WarpShuffle(builtin::tvm_warp_shuffle(), mask_var, val, 0);
-        seq.push_back(Store(var, splat, index, pred));
+      if (!shuffle_xor) {
+        // Broadcast the reduction result from lane 0 to all other lanes.
+        // This avoids to emit predicated stores, as all threads are
+        // uniformmly writting the same result.
+        //
+        for (size_t i = 0; i < size; ++i) {
+          Var var = shared_bufs[i];
+          PrimExpr pred = const_true(types[i].lanes());
+          PrimExpr val = Load(types[i], var, index, pred);
+          PrimExpr splat = WarpShuffle(builtin::tvm_warp_shuffle(), mask_var, val, 0);
+          seq.push_back(Store(var, splat, index, pred));
+        }
       }
 
       // Update existing allocations.
@@ -499,6 +519,60 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     }
     return SeqStmt::Flatten(seq);
   }
+  // Emit the reduction of the values of each warp into red_bufs, shuffling
+  // from the lanes at the offsets from start_offset down to 1. The shuffled
+  // data goes through the local variables leading local_vars.
+  void EmitWarpReduce(const CommReducerNode* combiner, const std::vector<DataType>& types,
+                      const std::vector<Var>& red_bufs, const std::vector<Stmt>& local_vars,
+                      const Var& mask_var, int start_offset, std::vector<Stmt>* seq) {
+    size_t size = red_bufs.size();
+    PrimExpr index(0);
+    const Op& shuffle =
+        use_shuffle_xor() ? builtin::tvm_warp_shuffle_xor() : builtin::tvm_warp_shuffle_down();
+    for (int offset = start_offset; offset > 0; offset /= 2) {
+      // Load reduction values, no synchronization needed.
+      Array<PrimExpr> a, b;
+      for (size_t i = 0; i < size; ++i) {
+        Var var = red_bufs[i];
+        PrimExpr pred = const_true(types[i].lanes());
+        PrimExpr val = Load(types[i], var, index, pred);
+        a.push_back(val);
+
+        // __shfl_*sync calls shall not appear in if_then_else expressions
+        // as this is causing extra divergency. E.g.
+        //
+        // v1 = (v2 < v3) ? v3 : __shfl_sync(mask, v1, 0);
+        //
+        // behaves differently from
+        //
+        // int t = __shfl_sync(mask, v1, 0);
+        // v1 = (v2 < v3) ? v3 : t;
+        //
+        // The former may cause dead lock as there is a divergent
+        // branch with a warp sync call inside.
+        //
+        PrimExpr other = WarpShuffle(shuffle, mask_var, val, offset);
+        const AllocateNode* repl = local_vars[i].as<AllocateNode>();
+        Stmt s = Store(repl->buffer_var, other, index, pred);
+        seq->push_back(s);
+
+        PrimExpr load = Load(types[i], repl->buffer_var, index, pred);
+        b.push_back(load);
+      }
+
+      // Do reductions.
+      Array<PrimExpr> ret = (*combiner)(a, b);
+
+      // Store the reduction result to itself.
+      std::vector<Stmt> stores(size);
+      for (size_t i = 0; i < size; ++i) {
+        Var var = red_bufs[i];
+        PrimExpr pred = const_true(types[i].lanes());
+        stores[i] = Store(var, ret[i], index, pred);
+      }
+      seq->push_back(SeqStmt::Flatten(stores));
+    }
+  }
   // Flatten the thread index.
   // Also return a warp number,
   PrimExpr FlattenThread(const std::vector<ThreadEntry>& tvec, int* out_total_extent) {
@@ -543,22 +617,39 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     return Call(val.dtype(), op, args);
   }
 
-  // Check if this is a reduction on threadIdx.x and its extent matches
-  // the warp size.
+  // Whether the warp reductions of the target shuffle with shuffle_xor.
+  // The subgroup shuffles of Vulkan and Metal take no mask, and their relative
+  // shuffles do not stop at a width below the subgroup size.
+  bool use_shuffle_xor() const {
+    return target_->kind->name == "vulkan" || target_->kind->name == "metal";
+  }
+
+  // Check if the target can shuffle values of these types within a warp.
   //
-  // TODO(tvm-team) reduction with a sub-warp of 8 or 16 threads.
   // Note: The ROCm backend will only have warp reductions for now.
   // Also, the warp/wavefront size differs (64 on rocm, 32 on cuda).
-  bool is_warp_reduction(const std::vector<DataType>& types) const {
-    // Only cuda target supports warp reductions.
-    if ((target_->kind->name != "cuda") && (target_->kind->name != "rocm")) return false;
+  bool supports_warp_shuffle(const std::vector<DataType>& types) const {
+    const std::string& kind = target_->kind->name;
+    if (kind == "vulkan") {
+      // The subgroup shuffles need Vulkan 1.1 and VK_SUBGROUP_FEATURE_SHUFFLE_BIT,
+      // which the target only reports when it is queried from the device.
+      const int64_t vk_api_version_1_1 = (1 << 22) | (1 << 12);
+      const int64_t vk_subgroup_feature_shuffle_bit = 0x10;
+      int64_t api_version = target_->GetAttr<Integer>("vulkan_api_version", 0).value();
+      int64_t operations = target_->GetAttr<Integer>("supported_subgroup_operations", 0).value();
+      if (api_version < vk_api_version_1_1 || (operations & vk_subgroup_feature_shuffle_bit) == 0) {
+        return false;
+      }
+    } else if (kind != "cuda" && kind != "rocm" && kind != "metal") {
+      return false;
+    }
 
-    // rocm only supports 32 bit operands for shuffling at the moment
-    if ((target_->kind->name == "rocm") &&
-        (std::any_of(types.begin(), types.end(), [](DataType ty) {
+    // rocm only supports 32 bit operands for shuffling at the moment,
+    // the subgroup shuffles of vulkan and metal 32 bit and half operands.
+    if (kind != "cuda" && std::any_of(types.begin(), types.end(), [&](DataType ty) {
           if (ty.is_vector()) return true;
-          return ty.bits() != 32;
-        }))) {
+          return ty.bits() != 32 && (kind == "rocm" || !ty.is_float16());
+        })) {
       return false;
     }
 
@@ -571,6 +662,15 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
         })) {
       return false;
     }
+    return true;
+  }
+
+  // Check if this is a reduction on threadIdx.x and its extent matches
+  // the warp size.
+  //
+  // TODO(tvm-team) reduction with a sub-warp of 8 or 16 threads.
+  bool is_warp_reduction(const std::vector<DataType>& types) const {
+    if (!supports_warp_shuffle(types)) return false;
     if (thread_extents_.empty()) {
       return false;
     }
@@ -589,6 +689,17 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     return e.extent == warp_size_ && e.scope.dim_index == 0 && e.scope.rank == 1;
   }
 
+  // Check if this is a reduction on threadIdx.x alone over several whole warps,
+  // whose per warp results fit in a single warp.
+  bool is_multi_warp_reduction(const std::vector<DataType>& types,
+                               const std::vector<ThreadEntry>& vred, int reduce_extent) const {
+    if (warp_size_ <= 1 || (warp_size_ & (warp_size_ - 1)) != 0) return false;
+    if (vred.size() != 1 || vred[0].scope.dim_index != 0) return false;
+    if (reduce_extent <= warp_size_ || reduce_extent % warp_size_ != 0) return false;
+    if (reduce_extent / warp_size_ > warp_size_) return false;
+    return supports_warp_shuffle(types);
+  }
+
   // The target.
   const TargetNode* target_ = nullptr;
 
@@ -606,6 +717,8 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   std::unordered_map<const VarNode*, Stmt> alloc_remap_;
   // Allocate from warp reductions
   std::unordered_set<const void*> warp_allocs_;
+  // The shared memory allocate staging the per warp results of multi warp reductions
+  std::unordered_map<const VarNode*, Stmt> staging_allocs_;
   // Internal analyzer
   arith::Analyzer analyzer_;
 };
@@ -108,6 +108,9 @@ class BuiltinLower : public StmtExprMutator {
   }
 
   Stmt VisitStmt_(const AllocateNode* op) {
+    if (GetPtrStorageScope(op->buffer_var) == "global.vtcm") {
+      return StmtExprMutator::VisitStmt(MakeVtcmAlloc(op));
+    }
     // Lower allocate to device allocate when needed.
     Stmt stmt = StmtExprMutator::VisitStmt_(op);
     op = stmt.as<AllocateNode>();
@@ -209,6 +212,12 @@ class BuiltinLower : public StmtExprMutator {
       return MakeArray(op);
     } else if (op->op.same_as(builtin::tvm_context_id())) {
       return make_zero(op->dtype);
+    } else if (op->op.same_as(builtin::dma_copy())) {
+      return MakeDMACall(op, "DMACopy");
+    } else if (op->op.same_as(builtin::dma_commit_group())) {
+      return MakeDMACall(op, "DMACommitGroup");
+    } else if (op->op.same_as(builtin::dma_wait_group())) {
+      return MakeDMACall(op, "DMAWaitGroup");
     } else {
       return StmtExprMutator::VisitExpr_(op);
     }
@@ -415,6 +424,49 @@ class BuiltinLower : public StmtExprMutator {
     return body;
   }
 
+  // The DMA builtins call the functions of the device API of the current device.
+  PrimExpr MakeDMACall(const CallNode* op, const std::string& name) {
+    ICHECK(device_type_.defined()) << "Unknown device type in current IR";
+    const auto* dev_type = device_type_.as<IntImmNode>();
+    ICHECK(dev_type) << "The device of the DMA copies must be known at compile time";
+    Array<PrimExpr> args = {
+        StringImm("device_api." + std::string(runtime::DeviceName(dev_type->value)) + "." + name)};
+    for (const PrimExpr& arg : op->args) {
+      args.push_back(arg);
+    }
+    Call call(DataType::Int(32), builtin::tvm_call_packed(), args);
+    return MakeCallPacked(call.get(), /* use_string_lookup */ true);
+  }
+
+  // The VTCM of Hexagon is allocated by its device API, from a separate pool.
+  Stmt MakeVtcmAlloc(const AllocateNode* op) {
+    ICHECK(device_type_.defined()) << "Unknown device type in current IR";
+    ICHECK(device_id_.defined()) << "Unknown device id in current IR";
+    Stmt throw_last_error = Evaluate(Call(DataType::Int(32), builtin::tvm_throw_last_error(), {}));
+
+    PrimExpr total_bytes = make_const(op->extents[0].dtype(), GetVectorBytes(op->dtype));
+    for (size_t i = 0; i < op->extents.size(); ++i) {
+      total_bytes = total_bytes * op->extents[i];
+    }
+    Stmt body = SeqStmt({IfThenElse(Call(DataType::Bool(1), builtin::isnullptr(), {op->buffer_var}),
+                                    throw_last_error),
+                         op->body});
+    Call call_packed =
+        Call(op->buffer_var.dtype(), builtin::tvm_call_packed(),
+             {StringImm("device_api.hexagon.AllocVtcm"), cast(DataType::Int(32), device_type_),
+              cast(DataType::Int(32), device_id_), cast(DataType::UInt(64), total_bytes),
+              IntImm(DataType::Int(32), op->dtype.code()),
+              IntImm(DataType::Int(32), op->dtype.bits())});
+    Stmt alloca = LetStmt(op->buffer_var, call_packed, body);
+
+    Call free_op = Call(DataType::Int(32), builtin::tvm_call_packed(),
+                        {StringImm("device_api.hexagon.FreeVtcm"),
+                         cast(DataType::Int(32), device_type_),
+                         cast(DataType::Int(32), device_id_), op->buffer_var});
+    Stmt free_stmt = IfThenElse(free_op != make_zero(DataType::Int(32)), throw_last_error);
+    return SeqStmt({alloca, free_stmt});
+  }
+
  private:
   bool IsArrayHandle(const PrimExpr& arg) {
     // specially set array handle.
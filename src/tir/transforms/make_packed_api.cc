@@ -107,7 +107,15 @@ inline Stmt MakeAssertEQ(PrimExpr lhs, PrimExpr rhs, std::string msg) {
   return AssertStmt(lhs == rhs, tvm::tir::StringImm(msg), Evaluate(0));
 }
 
-PrimFunc MakePackedAPI(PrimFunc&& func, int num_unpacked_args) {
+/*!
+ * \brief Lower a PrimFunc to the packed function API.
+ * \param func The function.
+ * \param num_unpacked_args The number of arguments passed directly, -1 to pack them all.
+ * \param skip_arg_checks Whether to leave out the checks of the number, the type codes and
+ *  the tensor fields of the arguments, which the caller then guarantees.
+ * \return The lowered function.
+ */
+PrimFunc MakePackedAPI(PrimFunc&& func, int num_unpacked_args, bool skip_arg_checks) {
   auto global_symbol = func->GetAttr<String>(tvm::attr::kGlobalSymbol);
   ICHECK(global_symbol) << "MakePackedAPI: Expect PrimFunc to have the global_symbol attribute";
 
@@ -194,6 +202,7 @@ PrimFunc MakePackedAPI(PrimFunc&& func, int num_unpacked_args) {
     if (i < num_packed_args) {
       // Value loads
       seq_init.emplace_back(LetStmt(v_arg, f_arg_value(v_arg.dtype(), i), nop));
+      if (skip_arg_checks) continue;
       // type code checks
       Var tcode(v_arg->name_hint + ".code", DataType::Int(32));
       seq_init.emplace_back(LetStmt(tcode,
@@ -268,7 +277,11 @@ PrimFunc MakePackedAPI(PrimFunc&& func, int num_unpacked_args) {
     }
   }
 
-  if (pack_args) {
+  if (skip_arg_checks) {
+    // the lets binding the shape and the stride variables are kept, seq_check only holds the
+    // device context then
+    func_ptr->body = MergeNest({seq_init, binder.init_nest(), seq_check}, body);
+  } else if (pack_args) {
     std::ostringstream num_args_error;
     num_args_error << name_hint << ": num_args should be " << num_packed_args;
     std::vector<Stmt> arg_assert = {
@@ -303,6 +316,7 @@ namespace transform {
 Pass MakePackedAPI(int num_unpacked_args) {
   // packed arguments anyway while `num_unpacked_args` is -1
   auto pass_func = [num_unpacked_args](IRModule m, PassContext ctx) {
+    bool skip_arg_checks = ctx->GetConfig<Bool>("tir.skip_arg_checks", Bool(false)).value();
     IRModuleNode* mptr = m.CopyOnWrite();
     std::vector<std::pair<GlobalVar, PrimFunc> > updates;
 
@@ -311,7 +325,7 @@ Pass MakePackedAPI(int num_unpacked_args) {
         PrimFunc func = GetRef<PrimFunc>(n);
         if (func->GetAttr<Integer>(tvm::attr::kCallingConv, Integer(CallingConv::kDefault)) ==
             CallingConv::kDefault) {
-          auto updated_func = MakePackedAPI(std::move(func), num_unpacked_args);
+          auto updated_func = MakePackedAPI(std::move(func), num_unpacked_args, skip_arg_checks);
           updates.push_back({kv.first, updated_func});
         }
       }
@@ -0,0 +1,370 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rewrite_shared_memory_layout.cc
+ * \brief Change the layout of the shared memory buffers the threads of a warp access with
+ *  bank conflicts.
+ *
+ *  The accesses are evaluated for the lanes of the first warp, with the other loop variables
+ *  set to zero, and a layout is only kept when it lowers the largest conflict of the buffer.
+ *  Two layouts are tried on the last two dimensions: permuting the words of each row by an
+ *  XOR with the row index, which needs no extra memory but is only used when every access is
+ *  scalar, then padding the rows, which keeps the vectorized accesses contiguous.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The layout of the last two dimensions of a buffer. */
+struct SharedMemoryLayout {
+  /*! \brief The number of elements added at the end of each row. */
+  int64_t pad{0};
+  /*! \brief The number of rows whose chunks are permuted, 1 when they are not. */
+  int64_t swizzle{1};
+  /*! \brief The number of elements of a permuted chunk. */
+  int64_t chunk{1};
+};
+
+/*! \brief An access to a shared memory buffer, evaluated for each lane of a warp. */
+struct SharedMemoryAccess {
+  /*! \brief The value of each index in each lane. */
+  std::vector<std::vector<int64_t>> lane_indices;
+  /*! \brief The number of bytes accessed by each lane. */
+  int access_bytes;
+};
+
+/*! \brief Collect the accesses to the shared memory buffers allocated by the blocks. */
+class SharedMemoryAccessCollector : public StmtExprVisitor {
+ public:
+  /*! \brief The buffers, in their order of allocation. */
+  std::vector<Buffer> buffers;
+  /*! \brief The accesses of each buffer. */
+  std::unordered_map<const BufferNode*, std::vector<SharedMemoryAccess>> accesses;
+  /*! \brief The buffers with an access that cannot be evaluated or is not through the buffer. */
+  std::unordered_set<const BufferNode*> unknown;
+
+ private:
+  void VisitStmt_(const BlockNode* op) final {
+    for (const Buffer& buffer : op->alloc_buffers) {
+      String scope = buffer.scope();
+      if (scope == "shared" || scope == "shared.dyn") {
+        buffers.push_back(buffer);
+        buffer_data_[buffer->data.get()] = buffer.get();
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    const auto* extent = op->extent.as<IntImmNode>();
+    if (op->kind == ForKind::kThreadBinding && op->thread_binding.defined()) {
+      EnterThread(op->thread_binding.value()->thread_tag, op->loop_var, extent,
+                  [&]() { StmtExprVisitor::VisitStmt_(op); });
+    } else if (op->kind == ForKind::kVectorized && extent != nullptr) {
+      std::pair<Var, int64_t> outer = vector_loop_;
+      vector_loop_ = {op->loop_var, extent->value};
+      StmtExprVisitor::VisitStmt_(op);
+      vector_loop_ = outer;
+    } else {
+      StmtExprVisitor::VisitStmt_(op);
+    }
+  }
+
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent) {
+      IterVar iv = Downcast<IterVar>(op->node);
+      EnterThread(iv->thread_tag, iv->var, op->value.as<IntImmNode>(),
+                  [&]() { StmtExprVisitor::VisitStmt_(op); });
+    } else {
+      StmtExprVisitor::VisitStmt_(op);
+    }
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    Record(op->buffer, op->indices, op->value.dtype());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    Record(op->buffer, op->indices, op->dtype);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const VarNode* op) final {
+    auto it = buffer_data_.find(op);
+    if (it != buffer_data_.end()) unknown.insert(it->second);
+  }
+
+  template <typename FVisit>
+  void EnterThread(const String& thread_tag, const Var& var, const IntImmNode* extent,
+                   FVisit fvisit) {
+    int dim = -1;
+    if (thread_tag == "threadIdx.x") {
+      dim = 0;
+    } else if (thread_tag == "threadIdx.y") {
+      dim = 1;
+    } else if (thread_tag == "threadIdx.z") {
+      dim = 2;
+    } else {
+      fvisit();
+      return;
+    }
+    std::pair<Var, int64_t> outer = threads_[dim];
+    // a thread extent that is not a constant leaves the lanes unknown
+    threads_[dim] = {var, extent != nullptr ? extent->value : -1};
+    fvisit();
+    threads_[dim] = outer;
+  }
+
+  void Record(const Buffer& buffer, const Array<PrimExpr>& indices, DataType dtype) {
+    if (!buffer_data_.count(buffer->data.get()) || unknown.count(buffer.get())) return;
+    std::vector<std::pair<Var, int64_t>> threads;
+    for (const auto& thread : threads_) {
+      if (thread.second < 0) {
+        unknown.insert(buffer.get());
+        return;
+      }
+      if (thread.second > 0) threads.push_back(thread);
+    }
+    SharedMemoryAccess access;
+    access.access_bytes = dtype.bytes() * dtype.lanes();
+    auto is_vector_loop = [this](const VarNode* var) { return var == vector_loop_.first.get(); };
+    for (const PrimExpr& index : indices) {
+      if (vector_loop_.second > 0 && UsesVar(index, is_vector_loop)) {
+        access.access_bytes = dtype.bytes() * dtype.lanes() * vector_loop_.second;
+      }
+      std::vector<int64_t> lanes = EvalForWarpLanes(index, threads);
+      if (lanes.empty()) {
+        unknown.insert(buffer.get());
+        return;
+      }
+      access.lane_indices.push_back(std::move(lanes));
+    }
+    accesses[buffer.get()].push_back(std::move(access));
+  }
+
+  /*! \brief The threadIdx.x, threadIdx.y and threadIdx.z loops around the visited node. */
+  std::pair<Var, int64_t> threads_[3];
+  /*! \brief The innermost vectorized loop around the visited node. */
+  std::pair<Var, int64_t> vector_loop_;
+  /*! \brief The buffers collected, by their data variable. */
+  std::unordered_map<const VarNode*, const BufferNode*> buffer_data_;
+};
+
+/*!
+ * \brief Find the layout of a buffer with the fewest bank conflicts.
+ * \return The layout, the default one when no layout lowers the conflicts.
+ */
+SharedMemoryLayout FindSharedMemoryLayout(const Buffer& buffer,
+                                          const std::vector<SharedMemoryAccess>& accesses) {
+  size_t ndim = buffer->shape.size();
+  std::vector<int64_t> shape;
+  for (const PrimExpr& dim : buffer->shape) {
+    const auto* imm = dim.as<IntImmNode>();
+    if (imm == nullptr) return {};
+    shape.push_back(imm->value);
+  }
+  int64_t elem_bytes = buffer->dtype.bytes() * buffer->dtype.lanes();
+  int64_t num_cols = shape[ndim - 1];
+
+  auto fways = [&](const SharedMemoryLayout& layout) {
+    int ways = 1;
+    for (const SharedMemoryAccess& access : accesses) {
+      size_t num_lanes = access.lane_indices[0].size();
+      std::vector<int64_t> offsets(num_lanes, 0);
+      for (size_t lane = 0; lane < num_lanes; ++lane) {
+        int64_t row = access.lane_indices[ndim - 2][lane];
+        int64_t col = access.lane_indices[ndim - 1][lane];
+        if (layout.swizzle > 1) {
+          col = ((col / layout.chunk) ^ (row % layout.swizzle)) * layout.chunk + col % layout.chunk;
+        }
+        int64_t offset = row * (num_cols + layout.pad) + col;
+        int64_t stride = shape[ndim - 2] * (num_cols + layout.pad);
+        for (size_t i = ndim - 2; i > 0; --i) {
+          offset += access.lane_indices[i - 1][lane] * stride;
+          stride *= shape[i - 1];
+        }
+        offsets[lane] = offset * elem_bytes;
+      }
+      ways = std::max(ways, SharedMemoryBankConflictWays(offsets, access.access_bytes));
+    }
+    return ways;
+  };
+
+  SharedMemoryLayout best;
+  int best_ways = fways(best);
+  int access_bytes = elem_bytes;
+  for (const SharedMemoryAccess& access : accesses) {
+    access_bytes = std::max(access_bytes, access.access_bytes);
+  }
+  // a chunk is the word of one bank, the chunks of a row are permuted by the row modulo the
+  // number of permuted rows, which stays a bijection for powers of two
+  int64_t chunk = std::max<int64_t>(1, 4 / elem_bytes);
+  int64_t num_chunks = num_cols / chunk;
+  if (access_bytes == elem_bytes && num_cols % chunk == 0 && num_chunks >= 2 &&
+      (num_chunks & (num_chunks - 1)) == 0) {
+    for (int64_t swizzle = 2; best_ways > 1 && swizzle <= std::min<int64_t>(num_chunks, 32);
+         swizzle *= 2) {
+      SharedMemoryLayout layout;
+      layout.swizzle = swizzle;
+      layout.chunk = chunk;
+      int ways = fways(layout);
+      if (ways < best_ways) {
+        best = layout;
+        best_ways = ways;
+      }
+    }
+  }
+  // the padded rows stay aligned to the widest access, the largest padding spans every bank
+  int64_t pad_step = std::max<int64_t>(1, access_bytes / elem_bytes);
+  for (int64_t pad = pad_step; best_ways > 1 && pad * elem_bytes <= kSharedMemoryBanks * 4;
+       pad += pad_step) {
+    SharedMemoryLayout layout;
+    layout.pad = pad;
+    int ways = fways(layout);
+    if (ways < best_ways) {
+      best = layout;
+      best_ways = ways;
+    }
+  }
+  return best;
+}
+
+/*! \brief Rewrite the buffers and their accesses to their new layout. */
+class SharedMemoryLayoutRewriter : public StmtExprMutator {
+ public:
+  static Stmt Rewrite(const PrimFunc& f) {
+    SharedMemoryAccessCollector collector;
+    collector(f->body);
+    SharedMemoryLayoutRewriter rewriter;
+    for (const Buffer& buffer : collector.buffers) {
+      auto it = collector.accesses.find(buffer.get());
+      // the strides set by storage_align are left as they are
+      if (it == collector.accesses.end() || collector.unknown.count(buffer.get()) ||
+          buffer->shape.size() < 2 || !buffer->strides.empty()) {
+        continue;
+      }
+      SharedMemoryLayout layout = FindSharedMemoryLayout(buffer, it->second);
+      if (layout.pad > 0) {
+        size_t ndim = buffer->shape.size();
+        std::vector<PrimExpr> strides(ndim);
+        strides[ndim - 1] = make_const(buffer->shape[ndim - 1].dtype(), 1);
+        strides[ndim - 2] = buffer->shape[ndim - 1] + static_cast<int>(layout.pad);
+        for (size_t i = ndim - 2; i > 0; --i) {
+          strides[i - 1] = strides[i] * buffer->shape[i];
+        }
+        ObjectPtr<BufferNode> n = make_object<BufferNode>(*buffer.get());
+        n->strides = Array<PrimExpr>(strides.begin(), strides.end());
+        rewriter.buffer_map_[buffer.get()] = Buffer(n);
+      } else if (layout.swizzle > 1) {
+        rewriter.swizzle_[buffer.get()] = layout;
+      }
+    }
+    if (rewriter.buffer_map_.empty() && rewriter.swizzle_.empty()) return f->body;
+    return rewriter(f->body);
+  }
+
+ private:
+  Stmt VisitStmt_(const BlockNode* op) final {
+    Block block = Downcast<Block>(StmtExprMutator::VisitStmt_(op));
+    auto fregion = [this](const BufferRegion& region) {
+      auto it = buffer_map_.find(region->buffer.get());
+      return it == buffer_map_.end() ? region : BufferRegion(it->second, region->region);
+    };
+    auto falloc = [this](const Buffer& buffer) {
+      auto it = buffer_map_.find(buffer.get());
+      return it == buffer_map_.end() ? buffer : it->second;
+    };
+    BlockNode* n = block.CopyOnWrite();
+    n->reads = UpdateArray(n->reads, fregion);
+    n->writes = UpdateArray(n->writes, fregion);
+    n->alloc_buffers = UpdateArray(n->alloc_buffers, falloc);
+    return std::move(block);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode* op) final {
+    BufferStore store = Downcast<BufferStore>(StmtExprMutator::VisitStmt_(op));
+    BufferStoreNode* n = store.CopyOnWrite();
+    RewriteAccess(&n->buffer, &n->indices);
+    return std::move(store);
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    BufferLoad load = Downcast<BufferLoad>(StmtExprMutator::VisitExpr_(op));
+    BufferLoadNode* n = load.CopyOnWrite();
+    RewriteAccess(&n->buffer, &n->indices);
+    return std::move(load);
+  }
+
+  void RewriteAccess(Buffer* buffer, Array<PrimExpr>* indices) {
+    auto it = buffer_map_.find(buffer->get());
+    if (it != buffer_map_.end()) {
+      *buffer = it->second;
+      return;
+    }
+    auto swizzle_it = swizzle_.find(buffer->get());
+    if (swizzle_it == swizzle_.end()) return;
+    const SharedMemoryLayout& layout = swizzle_it->second;
+    size_t ndim = indices->size();
+    PrimExpr row = (*indices)[ndim - 2];
+    PrimExpr col = (*indices)[ndim - 1];
+    PrimExpr chunk = make_const(col.dtype(), layout.chunk);
+    PrimExpr row_key = cast(col.dtype(), floormod(row, static_cast<int>(layout.swizzle)));
+    PrimExpr permuted = bitwise_xor(floordiv(col, chunk), row_key);
+    indices->Set(ndim - 1, layout.chunk == 1 ? permuted : permuted * chunk + floormod(col, chunk));
+  }
+
+  /*! \brief The padded buffers replacing the original ones. */
+  std::unordered_map<const BufferNode*, Buffer> buffer_map_;
+  /*! \brief The layout of the buffers whose chunks are permuted. */
+  std::unordered_map<const BufferNode*, SharedMemoryLayout> swizzle_;
+};
+
+namespace transform {
+
+Pass RewriteSharedMemoryLayout() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* fptr = f.CopyOnWrite();
+    fptr->body = SharedMemoryLayoutRewriter::Rewrite(f);
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.RewriteSharedMemoryLayout", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.RewriteSharedMemoryLayout")
+    .set_body_typed(RewriteSharedMemoryLayout);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
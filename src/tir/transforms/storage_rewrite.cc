@@ -480,7 +480,8 @@ class StoragePlanRewriter : public StmtExprMutator {
 
   // Checks whether the storage_scope is especially tagged for a specific memory.
   bool IsSpecialTaggedMemory(const StorageScope& scope) {
-    return scope.tag.length() != 0 && scope.tag != ".dyn" && scope.tag != ".workspace";
+    return scope.tag.length() != 0 && scope.tag != ".dyn" && scope.tag != ".workspace" &&
+           !(scope.rank == StorageRank::kGlobal && scope.tag == ".vtcm");
   }
 
   // Alllocate entry of node.
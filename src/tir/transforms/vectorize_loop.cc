@@ -38,6 +38,8 @@
 namespace tvm {
 namespace tir {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.vectorize_predicated", Bool);
+
 inline PrimExpr BroadcastTo(PrimExpr e, int lanes) {
   if (e.dtype().lanes() == lanes) return e;
   if (const BroadcastNode* op = e.as<BroadcastNode>()) {
@@ -100,7 +102,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   using ExprFunctor::VisitExpr;
   using StmtMutator::operator();
 
-  Vectorizer(Var var, int var_lanes) : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool predicated = false)
+      : var_(var), var_lanes_(var_lanes), predicated_(predicated) {
     ramp_ = Ramp(0, 1, var_lanes);
   }
 
@@ -247,6 +250,16 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr MutateIfThenElseExpr_(const CallNode* op) {
     PrimExpr cond = this->VisitExpr(op->args[0]);
     if (cond.dtype().is_vector()) {
+      if (predicated_) {
+        // evaluate each side in the lanes selecting it
+        PrimExpr t = WithMask(cond, [&]() { return this->VisitExpr(op->args[1]); });
+        PrimExpr f = WithMask(!cond, [&]() { return this->VisitExpr(op->args[2]); });
+        int lanes = cond.dtype().lanes();
+        if (t.defined() && f.defined() && t.dtype().lanes() <= lanes &&
+            lanes % t.dtype().lanes() == 0 && lanes % f.dtype().lanes() == 0) {
+          return Select(cond, BroadcastTo(t, lanes), BroadcastTo(f, lanes));
+        }
+      }
       need_scalarize_ = true;
       return GetRef<PrimExpr>(op);
     }
@@ -314,6 +327,12 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr VisitExpr_(const LoadNode* op) final {
     PrimExpr index = this->VisitExpr(op->index);
     PrimExpr pred = this->VisitExpr(op->predicate);
+    if (mask_.defined()) {
+      // only executed in the active lanes
+      pred = MaskAccess(index, pred);
+      return Load(op->dtype.with_lanes(pred.dtype().lanes()), op->buffer_var,
+                  BroadcastTo(index, pred.dtype().lanes()), pred);
+    }
     if (index.same_as(op->index) && pred.same_as(op->predicate)) {
       return GetRef<PrimExpr>(op);
     } else {
@@ -355,6 +374,15 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     PrimExpr value = this->VisitExpr(op->value);
     PrimExpr index = this->VisitExpr(op->index);
     PrimExpr pred = this->VisitExpr(op->predicate);
+    if (mask_.defined()) {
+      pred = MaskAccess(index, pred);
+      int lanes = pred.dtype().lanes();
+      if (value.dtype().lanes() != 1 && value.dtype().lanes() != lanes) {
+        mask_failed_ = true;
+        return GetRef<Stmt>(op);
+      }
+      return Store(op->buffer_var, BroadcastTo(value, lanes), BroadcastTo(index, lanes), pred);
+    }
     if (value.same_as(op->value) && index.same_as(op->index)) {
       return GetRef<Stmt>(op);
     } else {
@@ -388,6 +416,10 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     ICHECK(!op->condition.dtype().is_vector());
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
+      if (predicated_ && !need_scalarize_) {
+        Stmt predicated = PredicateIfThenElse(op, condition);
+        if (predicated.defined()) return predicated;
+      }
       return Scalarize(GetRef<Stmt>(op));
     }
     Stmt then_case = this->VisitStmt(op->then_case);
@@ -451,6 +483,72 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     return Allocate(op->buffer_var, op->dtype, extents, condition, body);
   }
 
+  /*!
+   * \brief Vectorize an if statement with a vector condition into predicated stores.
+   * \return The predicated statement, undefined when it cannot be predicated.
+   */
+  Stmt PredicateIfThenElse(const IfThenElseNode* op, const PrimExpr& condition) {
+    auto predicate_stores = [this](const Stmt& stmt, const PrimExpr& mask) -> Stmt {
+      // only the stores are predicated, any other statement would run in all the lanes
+      std::vector<Stmt> stores;
+      if (const SeqStmtNode* seq = stmt.as<SeqStmtNode>()) {
+        for (const Stmt& s : seq->seq) stores.push_back(s);
+      } else {
+        stores.push_back(stmt);
+      }
+      Array<Stmt> result;
+      for (const Stmt& store : stores) {
+        const StoreNode* store_node = store.as<StoreNode>();
+        if (store_node == nullptr) return Stmt();
+        Stmt vectorized = WithMask(mask, [&]() { return StmtMutator::VisitStmt(store); });
+        if (!vectorized.defined()) return Stmt();
+        result.push_back(vectorized);
+      }
+      return SeqStmt::Flatten(result);
+    };
+    Stmt then_case = predicate_stores(op->then_case, condition);
+    if (!then_case.defined()) return Stmt();
+    if (!op->else_case.defined()) return then_case;
+    Stmt else_case = predicate_stores(op->else_case, !condition);
+    if (!else_case.defined()) return Stmt();
+    return SeqStmt({then_case, else_case});
+  }
+
+  /*!
+   * \brief Vectorize with the lanes outside of a mask disabled.
+   * \return The result of fvisit, undefined when an access cannot be predicated.
+   */
+  template <typename FVisit>
+  auto WithMask(const PrimExpr& mask, FVisit fvisit) -> decltype(fvisit()) {
+    PrimExpr outer_mask = mask_;
+    bool outer_failed = mask_failed_;
+    mask_ = outer_mask.defined() ? (outer_mask && mask) : mask;
+    mask_failed_ = false;
+    auto result = fvisit();
+    bool failed = mask_failed_ || need_scalarize_;
+    mask_ = outer_mask;
+    mask_failed_ = outer_failed;
+    if (failed) return decltype(fvisit())();
+    return result;
+  }
+
+  /*!
+   * \brief Add the mask to the predicate of a memory access.
+   *
+   *  Only the contiguous accesses of the width of the mask can be predicated, they are
+   *  lowered to masked loads and stores. The other accesses make the predication fail.
+   */
+  PrimExpr MaskAccess(const PrimExpr& index, const PrimExpr& pred) {
+    int lanes = mask_.dtype().lanes();
+    const RampNode* ramp = index.as<RampNode>();
+    if (ramp == nullptr || !is_one(ramp->stride) || ramp->lanes != lanes ||
+        (pred.dtype().lanes() != 1 && pred.dtype().lanes() != lanes)) {
+      mask_failed_ = true;
+      return BroadcastTo(pred, index.dtype().lanes());
+    }
+    return is_one(pred) ? mask_ : (BroadcastTo(pred, lanes) && mask_);
+  }
+
   // scalarize the statment
   Stmt Scalarize(Stmt stmt) {
     Var idx(var_->name_hint + ".s", var_->dtype);
@@ -477,6 +575,12 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr ramp_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
+  // whether the conditions are vectorized into predicated memory accesses.
+  bool predicated_{false};
+  // the lanes the memory accesses are enabled in, undefined outside of a condition.
+  PrimExpr mask_;
+  // set when a memory access under mask_ cannot be predicated.
+  bool mask_failed_{false};
   // Let binding
   std::unordered_map<Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual> let_binding_;
   // vectorizable property
@@ -544,6 +648,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
 class LoopVectorizer : public StmtMutator {
  public:
+  explicit LoopVectorizer(bool predicated = false) : predicated_(predicated) {}
+
   Stmt VisitStmt_(const ForNode* op) final {
     if (op->kind == ForKind::kVectorized) {
       ICHECK(is_zero(op->min));
@@ -551,11 +657,15 @@ class LoopVectorizer : public StmtMutator {
       if (!extent_as_int || extent_as_int->value < 1) {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
-      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value))(op->body);
+      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value),
+                        predicated_)(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+ private:
+  bool predicated_;
 };
 
 Stmt VectorizeLoop(Stmt stmt) { return LoopVectorizer()(std::move(stmt)); }
@@ -582,7 +692,8 @@ Pass VectorizeLoop(bool enable_vectorize) {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
     if (enable_vectorize) {
-      n->body = LoopVectorizer()(std::move(n->body));
+      bool predicated = ctx->GetConfig<Bool>("tir.vectorize_predicated", Bool(false)).value();
+      n->body = LoopVectorizer(predicated)(std::move(n->body));
     } else {
       n->body = VectorizeSkipper()(std::move(n->body));
     }
@@ -0,0 +1,264 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file widen_memory_access.cc
+ * \brief Vectorize the innermost loops of the GPU kernels that access consecutive elements
+ *  of the function arguments, so that each thread loads and stores 8 or 16 bytes at once.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "../../arith/ir_mutator_with_analyzer.h"
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief An access of an innermost loop to consecutive elements. */
+struct ConsecutiveAccess {
+  /*! \brief The buffer variable. */
+  Var buffer_var;
+  /*! \brief The index, one more in each iteration. */
+  PrimExpr index;
+  /*! \brief The element type. */
+  DataType dtype;
+};
+
+/*!
+ * \brief Check whether the iterations of an innermost loop can run as the lanes of a vector.
+ *
+ *  The body must be made of stores to consecutive elements, whose values read consecutive
+ *  elements or values that do not change in the loop, and only read a stored buffer at the
+ *  one element the iteration stores to it.
+ */
+class ConsecutiveAccessChecker : public StmtExprVisitor {
+ public:
+  static bool Check(const ForNode* loop, std::vector<ConsecutiveAccess>* accesses) {
+    ConsecutiveAccessChecker checker(loop->loop_var);
+    checker(loop->body);
+    if (!checker.ok_) return false;
+    for (const ConsecutiveAccess& load : checker.loads_) {
+      auto it = checker.stores_.find(load.buffer_var.get());
+      if (it == checker.stores_.end()) continue;
+      if (!std::any_of(it->second.begin(), it->second.end(),
+                       [&](const PrimExpr& index) { return ExprDeepEqual()(index, load.index); })) {
+        return false;
+      }
+    }
+    *accesses = std::move(checker.accesses_);
+    return true;
+  }
+
+ private:
+  explicit ConsecutiveAccessChecker(Var loop_var) : loop_var_(std::move(loop_var)) {}
+
+  void VisitStmt(const Stmt& stmt) final {
+    if (!ok_) return;
+    if (stmt->IsInstance<StoreNode>() || stmt->IsInstance<SeqStmtNode>() ||
+        stmt->IsInstance<LetStmtNode>()) {
+      StmtExprVisitor::VisitStmt(stmt);
+    } else {
+      ok_ = false;
+    }
+  }
+
+  void VisitStmt_(const StoreNode* op) final {
+    // an element stored by every iteration is a reduction
+    if (!RecordAccess(op->buffer_var, op->index, op->value.dtype(), op->predicate) ||
+        !UsesLoopVar(op->index)) {
+      ok_ = false;
+      return;
+    }
+    // the lanes of two stores to different elements of a buffer would overwrite in another order
+    std::vector<PrimExpr>& indices = stores_[op->buffer_var.get()];
+    if (!indices.empty() && !ExprDeepEqual()(indices[0], op->index)) {
+      ok_ = false;
+      return;
+    }
+    indices.push_back(op->index);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LoadNode* op) final {
+    if (!RecordAccess(op->buffer_var, op->index, op->dtype, op->predicate)) {
+      ok_ = false;
+      return;
+    }
+    loads_.push_back({op->buffer_var, op->index, op->dtype});
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (SideEffect(GetRef<PrimExpr>(op)) > CallEffectKind::kReadState) {
+      ok_ = false;
+      return;
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  bool UsesLoopVar(const PrimExpr& expr) {
+    return UsesVar(expr, [this](const VarNode* var) { return var == loop_var_.get(); });
+  }
+
+  /*! \return Whether an access is scalar and, when it depends on the loop, consecutive. */
+  bool RecordAccess(const Var& buffer_var, const PrimExpr& index, DataType dtype,
+                    const PrimExpr& predicate) {
+    if (!dtype.is_scalar() || !is_one(predicate)) return false;
+    if (!UsesLoopVar(index)) return true;
+    Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, {loop_var_});
+    if (coeffs.empty() || !is_one(coeffs[0])) return false;
+    accesses_.push_back({buffer_var, index, dtype});
+    return true;
+  }
+
+  /*! \brief The loop variable. */
+  Var loop_var_;
+  /*! \brief Whether the loop can be vectorized so far. */
+  bool ok_{true};
+  /*! \brief The accesses depending on the loop. */
+  std::vector<ConsecutiveAccess> accesses_;
+  /*! \brief All the loads. */
+  std::vector<ConsecutiveAccess> loads_;
+  /*! \brief The indices stored to each buffer. */
+  std::unordered_map<const VarNode*, std::vector<PrimExpr>> stores_;
+};
+
+/*! \brief Split the innermost loops of the kernels into vectorized accesses. */
+class MemoryAccessWidener : public arith::IRMutatorWithAnalyzer {
+ public:
+  static Stmt Widen(const PrimFunc& f) {
+    arith::Analyzer analyzer;
+    MemoryAccessWidener widener(&analyzer);
+    for (const auto& kv : f->buffer_map) {
+      widener.alignment_[kv.second->data.get()] = kv.second->data_alignment;
+    }
+    return widener(f->body);
+  }
+
+ private:
+  using IRMutatorWithAnalyzer::VisitStmt_;
+
+  explicit MemoryAccessWidener(arith::Analyzer* analyzer) : IRMutatorWithAnalyzer(analyzer) {}
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent) {
+      ++thread_depth_;
+      Stmt stmt = IRMutatorWithAnalyzer::VisitStmt_(op);
+      --thread_depth_;
+      return stmt;
+    }
+    return IRMutatorWithAnalyzer::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = IRMutatorWithAnalyzer::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    const auto* extent = op->extent.as<IntImmNode>();
+    if (thread_depth_ == 0 || extent == nullptr ||
+        (op->kind != ForKind::kSerial && op->kind != ForKind::kUnrolled)) {
+      return stmt;
+    }
+    std::vector<ConsecutiveAccess> accesses;
+    if (!ConsecutiveAccessChecker::Check(op, &accesses) || accesses.empty()) return stmt;
+    int lanes = FindLanes(op, extent->value, accesses);
+    if (lanes == 0) return stmt;
+
+    DataType dtype = op->loop_var.dtype();
+    Var inner = op->loop_var.copy_with_suffix(".vec");
+    PrimExpr index = op->min + inner;
+    int64_t num_vectors = extent->value / lanes;
+    Var outer = op->loop_var.copy_with_suffix(".outer");
+    if (num_vectors > 1) {
+      index = index + outer * make_const(dtype, lanes);
+    }
+    Stmt body = Substitute(op->body, {{op->loop_var, index}});
+    body = For(inner, make_zero(dtype), make_const(dtype, lanes), ForKind::kVectorized, body);
+    if (num_vectors > 1) {
+      body = For(outer, make_zero(dtype), make_const(dtype, num_vectors), op->kind, body,
+                 NullOpt, op->annotations);
+    }
+    return body;
+  }
+
+  /*!
+   * \brief Find the widest vector of at most 16 bytes whose accesses are all aligned.
+   * \return The number of lanes, 0 when the loop is better left as it is.
+   */
+  int FindLanes(const ForNode* loop, int64_t extent,
+                const std::vector<ConsecutiveAccess>& accesses) {
+    int max_bytes = 0;
+    for (const ConsecutiveAccess& access : accesses) {
+      // the local and shared allocations are only aligned to their element type
+      if (!alignment_.count(access.buffer_var.get())) return 0;
+      max_bytes = std::max(max_bytes, access.dtype.bytes());
+    }
+    for (int vector_bytes : {16, 8}) {
+      int lanes = vector_bytes / max_bytes;
+      if (lanes < 2 || extent % lanes != 0) continue;
+      bool aligned = true;
+      for (const ConsecutiveAccess& access : accesses) {
+        if (alignment_.at(access.buffer_var.get()) < access.dtype.bytes() * lanes) {
+          aligned = false;
+          break;
+        }
+        PrimExpr first = Substitute(access.index, {{loop->loop_var, loop->min}});
+        arith::ModularSet mod = analyzer_->modular_set(first);
+        if (mod->coeff % lanes != 0 || (mod->base % lanes + lanes) % lanes != 0) {
+          aligned = false;
+          break;
+        }
+      }
+      if (aligned) return lanes;
+    }
+    return 0;
+  }
+
+  /*! \brief The number of thread_extent attributes around the visited node. */
+  int thread_depth_{0};
+  /*! \brief The alignment in bytes of the data of each buffer argument. */
+  std::unordered_map<const VarNode*, int> alignment_;
+};
+
+namespace transform {
+
+Pass WidenMemoryAccess() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* fptr = f.CopyOnWrite();
+    fptr->body = MemoryAccessWidener::Widen(f);
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.WidenMemoryAccess", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.WidenMemoryAccess").set_body_typed(WidenMemoryAccess);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,215 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/usmp/algo/branch_and_bound.cc
+ * \brief This source contains the branch and bound algorithm for planning memory for USMP.
+ *
+ * branch_and_bound : this algorithm searches the placements of the BufferInfo objects for the
+ * smallest total size of the pools, starting from the plan of the hill climb algorithm. Each
+ * BufferInfo is placed at the lowest offset of a pool candidate where it does not overlap the
+ * conflicting BufferInfo objects placed before it. Any placement can be lowered to one built
+ * this way in the order of the offsets, so only the orders where (offset, index) increases are
+ * searched, which keeps the search exact. A branch is pruned when the size of the pools plus
+ * the least growth needed by a remaining BufferInfo is not below the best plan found.
+ *
+ * The search is exponential in the number of BufferInfo objects, thus it is only run for
+ * small numbers of them and it stops when its time budget is exhausted.
+ */
+
+#include <tvm/tir/usmp/algorithms.h>
+#include <tvm/tir/usmp/utils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include "placement.h"
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+namespace algo {
+
+/*! \brief The maximum number of BufferInfo objects the search is run for. */
+constexpr size_t kMaxBranchAndBoundBuffers = 24;
+
+/*!
+ * \brief This class implements the branch and bound algorithm. Please refer to main
+ * documentation of the file for more details.
+ */
+class BranchAndBoundPlanner {
+ public:
+  BranchAndBoundPlanner(const PlacementProblem& problem, int64_t lower_bound,
+                        int64_t time_budget_ms)
+      : problem_(problem),
+        lower_bound_(lower_bound),
+        deadline_(std::chrono::steady_clock::now() + std::chrono::milliseconds(time_budget_ms)),
+        current_(problem.buffers.size()),
+        placed_(problem.buffers.size(), false),
+        pool_sizes_(problem.pools.size(), 0) {}
+
+  /*!
+   * \brief Search for a placement smaller than a known one.
+   * \param best The known placement, replaced by the best placement found.
+   * \return Whether the search completed before the deadline.
+   */
+  bool Plan(Placement* best) {
+    best_ = best;
+    best_size_ = problem_.TotalSize(*best);
+    Search(0, 0, 0, -1);
+    return !timed_out_;
+  }
+
+ private:
+  void Search(size_t num_placed, int64_t total_size, int64_t last_offset, int64_t last_buffer) {
+    if (Stopped()) return;
+    size_t num_buffers = problem_.buffers.size();
+    if (num_placed == num_buffers) {
+      if (total_size < best_size_) {
+        *best_ = current_;
+        best_size_ = total_size;
+      }
+      return;
+    }
+    // Every remaining buffer ends above last_offset in one of its pools.
+    int64_t min_growth = 0;
+    for (size_t i = 0; i < num_buffers; ++i) {
+      if (placed_[i]) continue;
+      int64_t growth = std::numeric_limits<int64_t>::max();
+      for (int pool : problem_.pool_candidates[i]) {
+        int64_t end = last_offset + problem_.sizes[i];
+        if (problem_.size_hints[pool] != kUnrestrictedPoolSizeHint &&
+            end > problem_.size_hints[pool]) {
+          continue;
+        }
+        growth = std::min(growth, std::max<int64_t>(0, end - pool_sizes_[pool]));
+      }
+      min_growth = std::max(min_growth, growth);
+    }
+    if (min_growth == std::numeric_limits<int64_t>::max() ||
+        total_size + min_growth >= best_size_) {
+      return;
+    }
+    // The next placements, the ones growing the pools the least first.
+    std::vector<std::tuple<int64_t, int64_t, size_t, int>> children;
+    for (size_t i = 0; i < num_buffers; ++i) {
+      if (placed_[i]) continue;
+      for (int pool : problem_.pool_candidates[i]) {
+        int64_t offset = problem_.LowestFit(i, pool, current_);
+        if (offset < 0 || offset < last_offset ||
+            (offset == last_offset && static_cast<int64_t>(i) < last_buffer)) {
+          continue;
+        }
+        int64_t growth = std::max<int64_t>(0, offset + problem_.sizes[i] - pool_sizes_[pool]);
+        if (total_size + growth < best_size_) {
+          children.emplace_back(growth, offset, i, pool);
+        }
+      }
+    }
+    std::sort(children.begin(), children.end());
+    for (const auto& child : children) {
+      int64_t growth, offset;
+      size_t buffer;
+      int pool;
+      std::tie(growth, offset, buffer, pool) = child;
+      if (total_size + growth >= best_size_ || Stopped()) break;
+      int64_t pool_size = pool_sizes_[pool];
+      placed_[buffer] = true;
+      current_.pools[buffer] = pool;
+      current_.offsets[buffer] = offset;
+      pool_sizes_[pool] = pool_size + growth;
+      Search(num_placed + 1, total_size + growth, offset, static_cast<int64_t>(buffer));
+      pool_sizes_[pool] = pool_size;
+      current_.pools[buffer] = -1;
+      placed_[buffer] = false;
+    }
+  }
+
+  /*! \brief Whether the search reached the lower bound or its deadline. */
+  bool Stopped() {
+    if (best_size_ <= lower_bound_ || timed_out_) return true;
+    if (++num_nodes_ % 1024 == 0 && std::chrono::steady_clock::now() > deadline_) {
+      timed_out_ = true;
+    }
+    return timed_out_;
+  }
+
+  /*! \brief The buffers to plan. */
+  const PlacementProblem& problem_;
+  /*! \brief The total pool size at which the search stops. */
+  int64_t lower_bound_;
+  /*! \brief The time at which the search stops. */
+  std::chrono::steady_clock::time_point deadline_;
+  /*! \brief The placement being built, and the buffers it placed. */
+  Placement current_;
+  std::vector<bool> placed_;
+  /*! \brief The size of each pool in the placement being built. */
+  std::vector<int64_t> pool_sizes_;
+  /*! \brief The best placement found and its total pool size. */
+  Placement* best_{nullptr};
+  int64_t best_size_{0};
+  /*! \brief The number of nodes searched, and whether the deadline passed. */
+  int64_t num_nodes_{0};
+  bool timed_out_{false};
+};
+
+Map<BufferInfo, PoolAllocation> BranchAndBound(const Array<BufferInfo>& buffer_info_arr,
+                                               const Integer& memory_pressure,
+                                               int64_t time_budget_ms) {
+  Map<BufferInfo, PoolAllocation> pool_allocations = HillClimb(buffer_info_arr, memory_pressure);
+  if (buffer_info_arr.size() > kMaxBranchAndBoundBuffers) {
+    VLOG(1) << "USMP branch_and_bound: " << buffer_info_arr.size()
+            << " buffers are too many to search, using the hill_climb plan";
+    return pool_allocations;
+  }
+  PlacementProblem problem(buffer_info_arr);
+  int64_t lower_bound = CalculatePoolSizeLowerBound(buffer_info_arr, memory_pressure);
+  Placement best(problem.buffers.size());
+  for (size_t i = 0; i < problem.buffers.size(); ++i) {
+    PoolAllocation pool_allocation = pool_allocations[problem.buffers[i]];
+    best.pools[i] = static_cast<int>(
+        std::find(problem.pools.begin(), problem.pools.end(), pool_allocation->pool_info) -
+        problem.pools.begin());
+    best.offsets[i] = pool_allocation->byte_offset->value;
+  }
+  bool completed = BranchAndBoundPlanner(problem, lower_bound, time_budget_ms).Plan(&best);
+  VLOG(1) << "USMP branch_and_bound: total pool size " << problem.TotalSize(best)
+          << " bytes, lower bound " << lower_bound << " bytes"
+          << (completed ? "" : ", stopped by the time budget");
+  return problem.ToPoolAllocations(best);
+}
+
+TVM_REGISTER_GLOBAL("tir.usmp.algo.branch_and_bound")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      Array<BufferInfo> buffer_info_arr = args[0];
+      Integer memory_pressure = args[1];
+      if (args.size() > 2) {
+        *rv = BranchAndBound(buffer_info_arr, memory_pressure, args[2].operator int64_t());
+      } else {
+        *rv = BranchAndBound(buffer_info_arr, memory_pressure);
+      }
+    });
+
+}  // namespace algo
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
@@ -39,6 +39,7 @@
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/usmp/algorithms.h>
 #include <tvm/tir/usmp/utils.h>
 
 namespace tvm {
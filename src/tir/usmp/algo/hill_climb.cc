@@ -0,0 +1,172 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/usmp/algo/hill_climb.cc
+ * \brief This source contains the hill climb algorithm for planning memory for USMP.
+ *
+ * hill_climb : this algorithm places the BufferInfo objects one after the other, each at the
+ * lowest offset of its first pool candidate where it does not overlap a conflicting BufferInfo
+ * placed before it while adhering to the size_hint constraint. It starts from the orders of the
+ * greedy algorithms and randomly changes the order, moving a BufferInfo ending at the top of a
+ * pool earlier or swapping two of them. The orders that do not grow the total size of the pools
+ * are kept, until the lower bound is reached or the number of steps is exhausted.
+ */
+
+#include <tvm/support/random_engine.h>
+#include <tvm/tir/usmp/algorithms.h>
+#include <tvm/tir/usmp/utils.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "placement.h"
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+namespace algo {
+
+/*! \brief The maximum number of orders tried by the hill climb. */
+constexpr int64_t kMaxHillClimbSteps = 4096;
+/*! \brief The work of all the steps of the hill climb, in units of conflicts visited. */
+constexpr int64_t kHillClimbBudget = int64_t(1) << 26;
+/*! \brief The seed of the random moves, fixed so that the plans are reproducible. */
+constexpr int64_t kHillClimbSeed = 1;
+
+/*!
+ * \brief This class implements the hill climb algorithm. Please refer to main documentation
+ * of the file for more details.
+ */
+class HillClimbPlanner {
+ public:
+  explicit HillClimbPlanner(const PlacementProblem& problem) : problem_(problem), rng_(&state_) {
+    rng_.Seed(kHillClimbSeed);
+  }
+
+  /*!
+   * \brief Search for the order with the smallest total pool size.
+   * \param lower_bound The total pool size at which the search stops.
+   * \return The best placement found.
+   */
+  Placement Plan(int64_t lower_bound) {
+    size_t num_buffers = problem_.buffers.size();
+    Placement best(num_buffers);
+    size_t failed_buffer = 0;
+    std::vector<size_t> order = problem_.GreedyBySizeOrder();
+    int64_t best_size = problem_.PlaceInOrder(order, &best, &failed_buffer);
+    {
+      std::vector<size_t> conflicts_order = problem_.GreedyByConflictsOrder();
+      Placement placement(num_buffers);
+      int64_t size = problem_.PlaceInOrder(conflicts_order, &placement);
+      if (size >= 0 && (best_size < 0 || size < best_size)) {
+        best_size = size;
+        best = std::move(placement);
+        order = std::move(conflicts_order);
+      }
+    }
+    if (best_size < 0) {
+      problem_.ReportNoSpace(failed_buffer);
+    }
+    if (num_buffers < 2) return best;
+    int64_t work = static_cast<int64_t>(num_buffers);
+    for (const auto& buffer_conflicts : problem_.conflicts) {
+      work += static_cast<int64_t>(buffer_conflicts.size());
+    }
+    int64_t num_steps = std::min(kMaxHillClimbSteps, std::max<int64_t>(1, kHillClimbBudget / work));
+
+    Placement current = best;
+    int64_t current_size = best_size;
+    for (int64_t step = 0; step < num_steps && best_size > lower_bound; ++step) {
+      std::vector<size_t> next_order = order;
+      Move(current, &next_order);
+      Placement placement(num_buffers);
+      int64_t size = problem_.PlaceInOrder(next_order, &placement);
+      if (size < 0 || size > current_size) continue;
+      order = std::move(next_order);
+      current = std::move(placement);
+      current_size = size;
+      if (current_size < best_size) {
+        best = current;
+        best_size = current_size;
+      }
+    }
+    return best;
+  }
+
+ private:
+  /*! \brief Randomly change an order placing the buffers as in the current placement. */
+  void Move(const Placement& current, std::vector<size_t>* order) {
+    size_t num_buffers = order->size();
+    if (rng_() % 2 == 0) {
+      // Move a buffer ending at the top of its pool to an earlier position, so that it is
+      // placed before the buffers pushing it up.
+      std::vector<int64_t> pool_sizes(problem_.pools.size(), 0);
+      for (size_t i = 0; i < num_buffers; ++i) {
+        int64_t& pool_size = pool_sizes[current.pools[i]];
+        pool_size = std::max(pool_size, current.offsets[i] + problem_.sizes[i]);
+      }
+      std::vector<size_t> top_positions;
+      for (size_t pos = 1; pos < num_buffers; ++pos) {
+        size_t i = (*order)[pos];
+        if (current.offsets[i] > 0 &&
+            current.offsets[i] + problem_.sizes[i] == pool_sizes[current.pools[i]]) {
+          top_positions.push_back(pos);
+        }
+      }
+      if (!top_positions.empty()) {
+        size_t pos = top_positions[rng_() % top_positions.size()];
+        size_t new_pos = rng_() % pos;
+        std::rotate(order->begin() + new_pos, order->begin() + pos, order->begin() + pos + 1);
+        return;
+      }
+    }
+    size_t a = rng_() % num_buffers;
+    size_t b = rng_() % num_buffers;
+    std::swap((*order)[a], (*order)[b]);
+  }
+
+  /*! \brief The buffers to plan. */
+  const PlacementProblem& problem_;
+  /*! \brief The state of the random engine. */
+  support::LinearCongruentialEngine::TRandState state_;
+  /*! \brief The random engine of the moves. */
+  support::LinearCongruentialEngine rng_;
+};
+
+Map<BufferInfo, PoolAllocation> HillClimb(const Array<BufferInfo>& buffer_info_arr,
+                                          const Integer& memory_pressure) {
+  PlacementProblem problem(buffer_info_arr);
+  int64_t lower_bound = CalculatePoolSizeLowerBound(buffer_info_arr, memory_pressure);
+  Placement best = HillClimbPlanner(problem).Plan(lower_bound);
+  VLOG(1) << "USMP hill_climb: total pool size " << problem.TotalSize(best)
+          << " bytes, lower bound " << lower_bound << " bytes";
+  return problem.ToPoolAllocations(best);
+}
+
+TVM_REGISTER_GLOBAL("tir.usmp.algo.hill_climb")
+    .set_body_typed([](Array<BufferInfo> buffer_info_arr, Integer memory_pressure) {
+      return HillClimb(buffer_info_arr, memory_pressure);
+    });
+
+}  // namespace algo
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,182 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/usmp/algo/placement.cc
+ * \brief The first fit placement of buffers in pools shared by the search based USMP
+ * algorithms.
+ */
+
+#include "placement.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+namespace algo {
+
+PlacementProblem::PlacementProblem(const Array<BufferInfo>& buffer_info_arr) {
+  std::unordered_map<BufferInfo, size_t, ObjectPtrHash, ObjectPtrEqual> buffer_indices;
+  std::unordered_map<PoolInfo, int, ObjectPtrHash, ObjectPtrEqual> pool_indices;
+  for (const auto& buffer_info : buffer_info_arr) {
+    buffer_indices[buffer_info] = buffers.size();
+    buffers.push_back(buffer_info);
+    sizes.push_back(buffer_info->size_bytes->value);
+    alignments.push_back(std::max<int64_t>(buffer_info->alignment->value, 1));
+    std::vector<int> candidates;
+    for (const auto& pool_info : buffer_info->pool_candidates) {
+      auto it = pool_indices.find(pool_info);
+      if (it == pool_indices.end()) {
+        it = pool_indices.emplace(pool_info, static_cast<int>(pools.size())).first;
+        pools.push_back(pool_info);
+        size_hints.push_back(pool_info->size_hint_bytes->value);
+      }
+      candidates.push_back(it->second);
+    }
+    pool_candidates.push_back(std::move(candidates));
+  }
+  conflicts.resize(buffers.size());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    for (const auto& conflict_obj : buffers[i]->conflicts) {
+      auto it = buffer_indices.find(Downcast<BufferInfo>(conflict_obj));
+      if (it != buffer_indices.end() && it->second != i) {
+        conflicts[i].push_back(it->second);
+        conflicts[it->second].push_back(i);
+      }
+    }
+  }
+  for (auto& buffer_conflicts : conflicts) {
+    std::sort(buffer_conflicts.begin(), buffer_conflicts.end());
+    buffer_conflicts.erase(std::unique(buffer_conflicts.begin(), buffer_conflicts.end()),
+                           buffer_conflicts.end());
+  }
+}
+
+int64_t PlacementProblem::LowestFit(size_t buffer, int pool, const Placement& placement) const {
+  std::vector<std::pair<int64_t, int64_t>> placed;
+  for (size_t conflict : conflicts[buffer]) {
+    if (placement.pools[conflict] == pool) {
+      placed.emplace_back(placement.offsets[conflict],
+                          placement.offsets[conflict] + sizes[conflict]);
+    }
+  }
+  std::sort(placed.begin(), placed.end());
+  int64_t offset = 0;
+  for (const auto& interval : placed) {
+    if (interval.second <= offset) continue;
+    if (interval.first >= offset + sizes[buffer]) break;
+    offset = (interval.second + alignments[buffer] - 1) / alignments[buffer] * alignments[buffer];
+  }
+  if (size_hints[pool] != kUnrestrictedPoolSizeHint && offset + sizes[buffer] > size_hints[pool]) {
+    return -1;
+  }
+  return offset;
+}
+
+int64_t PlacementProblem::PlaceInOrder(const std::vector<size_t>& order, Placement* placement,
+                                       size_t* failed_buffer) const {
+  for (size_t buffer : order) {
+    for (int pool : pool_candidates[buffer]) {
+      int64_t offset = LowestFit(buffer, pool, *placement);
+      if (offset >= 0) {
+        placement->pools[buffer] = pool;
+        placement->offsets[buffer] = offset;
+        break;
+      }
+    }
+    if (placement->pools[buffer] < 0) {
+      if (failed_buffer != nullptr) *failed_buffer = buffer;
+      return -1;
+    }
+  }
+  return TotalSize(*placement);
+}
+
+int64_t PlacementProblem::TotalSize(const Placement& placement) const {
+  std::vector<int64_t> pool_sizes(pools.size(), 0);
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    if (placement.pools[i] >= 0) {
+      int64_t& pool_size = pool_sizes[placement.pools[i]];
+      pool_size = std::max(pool_size, placement.offsets[i] + sizes[i]);
+    }
+  }
+  int64_t total_size = 0;
+  for (int64_t pool_size : pool_sizes) {
+    total_size += pool_size;
+  }
+  return total_size;
+}
+
+std::vector<size_t> PlacementProblem::GreedyBySizeOrder() const {
+  std::vector<size_t> order(buffers.size());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+  // The same ordering as greedy_by_size, so that the search starts from its plan.
+  std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    if (sizes[a] == sizes[b]) {
+      if (buffers[a]->conflicts.size() == buffers[b]->conflicts.size()) {
+        return std::string(buffers[a]->name_hint) > std::string(buffers[b]->name_hint);
+      }
+      return buffers[a]->conflicts.size() > buffers[b]->conflicts.size();
+    }
+    return sizes[a] > sizes[b];
+  });
+  return order;
+}
+
+std::vector<size_t> PlacementProblem::GreedyByConflictsOrder() const {
+  std::vector<size_t> order(buffers.size());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+  // The same ordering as greedy_by_conflicts, so that the search starts from its plan.
+  std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    if (buffers[a]->conflicts.size() == buffers[b]->conflicts.size()) {
+      if (sizes[a] == sizes[b]) {
+        return std::string(buffers[a]->name_hint) > std::string(buffers[b]->name_hint);
+      }
+      return sizes[a] > sizes[b];
+    }
+    return buffers[a]->conflicts.size() > buffers[b]->conflicts.size();
+  });
+  return order;
+}
+
+Map<BufferInfo, PoolAllocation> PlacementProblem::ToPoolAllocations(
+    const Placement& placement) const {
+  Map<BufferInfo, PoolAllocation> pool_allocations;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    ICHECK_GE(placement.pools[i], 0);
+    pool_allocations.Set(buffers[i], PoolAllocation(pools[placement.pools[i]],
+                                                    Integer(placement.offsets[i])));
+  }
+  return pool_allocations;
+}
+
+void PlacementProblem::ReportNoSpace(size_t buffer) const {
+  CHECK(false) << "TVM USMP Error: the space available in the provided pools exceeded when "
+                  "trying to allocate the buffer : "
+               << buffers[buffer] << "\n. Please increase the size_hints for memory pools.";
+}
+
+}  // namespace algo
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/usmp/algo/placement.h
+ * \brief The first fit placement of buffers in pools shared by the search based USMP
+ * algorithms.
+ */
+
+#ifndef TVM_TIR_USMP_ALGO_PLACEMENT_H_
+#define TVM_TIR_USMP_ALGO_PLACEMENT_H_
+
+#include <tvm/tir/usmp/utils.h>
+
+#include <vector>
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+namespace algo {
+
+/*!
+ * \brief The pool index and the offset of each buffer of a PlacementProblem, the pool
+ * index being -1 for the buffers not placed yet.
+ */
+struct Placement {
+  std::vector<int> pools;
+  std::vector<int64_t> offsets;
+
+  explicit Placement(size_t num_buffers) : pools(num_buffers, -1), offsets(num_buffers, 0) {}
+};
+
+/*!
+ * \brief The BufferInfo objects to plan with their liveness conflicts and their pool
+ * candidates as indices. The conflicts are made symmetric, as the placement of a buffer
+ * is checked against the conflicting buffers placed before it in whatever order.
+ */
+struct PlacementProblem {
+  /*! \brief The BufferInfo objects */
+  std::vector<BufferInfo> buffers;
+  /*! \brief The size and the alignment of each buffer */
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> alignments;
+  /*! \brief The indices of the buffers conflicting with each buffer */
+  std::vector<std::vector<size_t>> conflicts;
+  /*! \brief The ordered pool candidates of each buffer, as indices in pools */
+  std::vector<std::vector<int>> pool_candidates;
+  /*! \brief The pools and their size hint, -1 if not bounded */
+  std::vector<PoolInfo> pools;
+  std::vector<int64_t> size_hints;
+
+  explicit PlacementProblem(const Array<BufferInfo>& buffer_info_arr);
+
+  /*!
+   * \brief Find the lowest offset of a pool where a buffer does not overlap the conflicting
+   * buffers already placed there.
+   * \return The offset, or -1 if the buffer does not fit in the size hint of the pool.
+   */
+  int64_t LowestFit(size_t buffer, int pool, const Placement& placement) const;
+
+  /*!
+   * \brief Place the buffers in order, each at the lowest fit of its first pool candidate
+   * where it fits.
+   * \param order The indices of the buffers
+   * \param placement The placement to fill, with no buffer placed
+   * \param failed_buffer The buffer that did not fit in any pool, if not nullptr
+   * \return The total size of the pools, or -1 if a buffer did not fit in any pool.
+   */
+  int64_t PlaceInOrder(const std::vector<size_t>& order, Placement* placement,
+                       size_t* failed_buffer = nullptr) const;
+
+  /*! \return The sum over the pools of the end of the last buffer placed in each of them. */
+  int64_t TotalSize(const Placement& placement) const;
+
+  /*! \return The placement orders of the greedy by size and greedy by conflicts algorithms. */
+  std::vector<size_t> GreedyBySizeOrder() const;
+  std::vector<size_t> GreedyByConflictsOrder() const;
+
+  /*! \brief Convert a placement of all the buffers to pool allocations. */
+  Map<BufferInfo, PoolAllocation> ToPoolAllocations(const Placement& placement) const;
+
+  /*! \brief Fail with the USMP error of a buffer that does not fit in any pool. */
+  void ReportNoSpace(size_t buffer) const;
+};
+
+}  // namespace algo
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
+
+#endif  // TVM_TIR_USMP_ALGO_PLACEMENT_H_
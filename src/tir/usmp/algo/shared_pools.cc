@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/usmp/algo/shared_pools.cc
+ * \brief The planning of pools shared by several modules that never run concurrently.
+ */
+
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/usmp/algorithms.h>
+#include <tvm/tir/usmp/utils.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+namespace algo {
+
+Array<Map<BufferInfo, PoolAllocation>> PlanSharedPools(
+    const Array<Array<BufferInfo>>& module_buffer_info_arrs, const Array<Integer>& memory_pressures,
+    const String& algorithm) {
+  ICHECK_EQ(module_buffer_info_arrs.size(), memory_pressures.size())
+      << "PlanSharedPools expects one memory pressure per module";
+  const runtime::PackedFunc* falgo =
+      runtime::Registry::Get("tir.usmp.algo." + std::string(algorithm));
+  CHECK(falgo != nullptr) << "TVM USMP Error: unknown memory planning algorithm " << algorithm;
+
+  std::unordered_map<BufferInfo, size_t, ObjectPtrHash, ObjectPtrEqual> buffer_modules;
+  for (size_t i = 0; i < module_buffer_info_arrs.size(); ++i) {
+    for (const auto& buffer_info : module_buffer_info_arrs[i]) {
+      CHECK(buffer_modules.emplace(buffer_info, i).second)
+          << "TVM USMP Error: the buffer " << buffer_info->name_hint
+          << " belongs to several modules";
+    }
+  }
+  Array<Map<BufferInfo, PoolAllocation>> ret;
+  for (size_t i = 0; i < module_buffer_info_arrs.size(); ++i) {
+    for (const auto& buffer_info : module_buffer_info_arrs[i]) {
+      for (const auto& conflict_obj : buffer_info->conflicts) {
+        auto conflict = Downcast<BufferInfo>(conflict_obj);
+        auto it = buffer_modules.find(conflict);
+        CHECK(it == buffer_modules.end() || it->second == i)
+            << "TVM USMP Error: the buffer " << buffer_info->name_hint
+            << " conflicts with the buffer " << conflict->name_hint
+            << " of another module, the modules sharing pools must not run concurrently";
+      }
+    }
+    Map<BufferInfo, PoolAllocation> pool_allocations =
+        (*falgo)(module_buffer_info_arrs[i], memory_pressures[i]);
+    ret.push_back(pool_allocations);
+  }
+  for (const auto& kv : CalculateSharedPoolSizes(ret)) {
+    VLOG(1) << "USMP shared pool " << kv.first->pool_name << ": " << kv.second
+            << " bytes for " << module_buffer_info_arrs.size() << " modules";
+  }
+  return ret;
+}
+
+TVM_REGISTER_GLOBAL("tir.usmp.PlanSharedPools").set_body_typed(PlanSharedPools);
+
+}  // namespace algo
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
@@ -31,8 +31,10 @@
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/usmp/analysis.h>
 #include <tvm/tir/usmp/utils.h>
 
+#include <set>
 #include <stack>
 
 namespace tvm {
@@ -343,7 +345,12 @@ void BufferInfoExtractor::VisitExpr_(const VarNode* op) {
 Array<Var> static GetMatchedBuffers(const PrimFunc& func) {
   Array<Var> buffer_vars;
   for (const auto& param : func->params) {
-    buffer_vars.push_back(func->buffer_map[param]->data);
+    // The operators taking raw pointers, such as the external ones, have no matched buffer
+    if (func->buffer_map.count(param)) {
+      buffer_vars.push_back(func->buffer_map[param]->data);
+    } else {
+      buffer_vars.push_back(param);
+    }
   }
   return buffer_vars;
 }
@@ -0,0 +1,195 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/usmp/transform/convert_pool_allocations_to_offsets.cc
+ * \brief Replace the planned allocate nodes by offsets in the pools passed to the PrimFuncs.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/usmp/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+
+namespace {
+
+/*! \brief The name of the PrimFunc a call_extern or tvm_call_cpacked calls, empty otherwise. */
+std::string CalleeName(const CallNode* op) {
+  if (!op->op.same_as(builtin::call_extern()) && !op->op.same_as(builtin::tvm_call_cpacked())) {
+    return "";
+  }
+  const auto* name = op->args[0].as<StringImmNode>();
+  return name == nullptr ? "" : name->value;
+}
+
+/*! \brief The names of the PrimFuncs a PrimFunc calls, and whether it allocates in a pool. */
+class CallCollector : public StmtExprVisitor {
+ public:
+  explicit CallCollector(const Map<Stmt, PoolAllocation>& pool_allocations)
+      : pool_allocations_(pool_allocations) {}
+
+  std::unordered_set<std::string> callees;
+  bool allocates_in_pool = false;
+
+ private:
+  void VisitStmt_(const AllocateNode* op) final {
+    allocates_in_pool |= pool_allocations_.count(GetRef<Stmt>(op)) != 0;
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    std::string name = CalleeName(op);
+    if (!name.empty()) callees.insert(name);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  const Map<Stmt, PoolAllocation>& pool_allocations_;
+};
+
+class PoolAllocationToOffsetConverter : public StmtExprMutator {
+ public:
+  PoolAllocationToOffsetConverter(const Map<Stmt, PoolAllocation>& pool_allocations,
+                                  const std::unordered_set<std::string>& pooled_funcs,
+                                  const std::unordered_map<const Object*, Var>& pool_vars)
+      : pool_allocations_(pool_allocations), pooled_funcs_(pooled_funcs), pool_vars_(pool_vars) {}
+
+  Array<Var> pool_args;
+
+ private:
+  Stmt VisitStmt_(const AllocateNode* op) final {
+    auto it = pool_allocations_.find(GetRef<Stmt>(op));
+    if (it == pool_allocations_.end()) {
+      return StmtExprMutator::VisitStmt_(op);
+    }
+    const PoolAllocation& pool_allocation = (*it).second;
+    Var pool_var = pool_vars_.at(pool_allocation->pool_info.get());
+    PrimExpr address = Call(DataType::Handle(), builtin::address_of(),
+                            {Load(DataType::UInt(8), pool_var, pool_allocation->byte_offset,
+                                  const_true())});
+    return LetStmt(op->buffer_var, address, VisitStmt(op->body), op->span);
+  }
+
+  PrimExpr VisitExpr_(const CallNode* op) final {
+    Call call = Downcast<Call>(StmtExprMutator::VisitExpr_(op));
+    if (pooled_funcs_.count(CalleeName(op)) == 0) {
+      return std::move(call);
+    }
+    Array<PrimExpr> args = call->args;
+    for (const Var& pool_arg : pool_args) {
+      args.push_back(pool_arg);
+    }
+    return Call(call->dtype, call->op, args, call->span);
+  }
+
+  const Map<Stmt, PoolAllocation>& pool_allocations_;
+  const std::unordered_set<std::string>& pooled_funcs_;
+  const std::unordered_map<const Object*, Var>& pool_vars_;
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass ConvertPoolAllocationsToOffsets(const Map<Stmt, PoolAllocation>& pool_allocations) {
+  auto pass_func = [=](IRModule mod, tvm::transform::PassContext ctx) {
+    // The pools, sorted by name to make the signatures deterministic.
+    std::vector<PoolInfo> pools;
+    for (const auto& kv : pool_allocations) {
+      if (std::find(pools.begin(), pools.end(), kv.second->pool_info) == pools.end()) {
+        pools.push_back(kv.second->pool_info);
+      }
+    }
+    std::sort(pools.begin(), pools.end(), [](const PoolInfo& lhs, const PoolInfo& rhs) {
+      return lhs->pool_name < rhs->pool_name;
+    });
+
+    // The PrimFuncs taking the pools, the ones allocating in them and their callers.
+    std::unordered_map<std::string, GlobalVar> symbols;
+    std::unordered_map<std::string, std::unordered_set<std::string>> callees;
+    std::unordered_set<std::string> pooled_funcs;
+    for (const auto& kv : mod->functions) {
+      const auto* func = kv.second.as<PrimFuncNode>();
+      if (func == nullptr) continue;
+      std::string name =
+          func->GetAttr<String>(tvm::attr::kGlobalSymbol).value_or(kv.first->name_hint);
+      symbols[name] = kv.first;
+      CallCollector collector(pool_allocations);
+      collector(func->body);
+      callees[name] = std::move(collector.callees);
+      if (collector.allocates_in_pool) pooled_funcs.insert(name);
+    }
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (const auto& kv : callees) {
+        if (pooled_funcs.count(kv.first)) continue;
+        for (const std::string& callee : kv.second) {
+          if (pooled_funcs.count(callee)) {
+            pooled_funcs.insert(kv.first);
+            changed = true;
+            break;
+          }
+        }
+      }
+    }
+
+    IRModule updated_mod = mod->ShallowCopy();
+    for (const std::string& name : pooled_funcs) {
+      GlobalVar gv = symbols.at(name);
+      PrimFunc func = Downcast<PrimFunc>(mod->Lookup(gv));
+      std::unordered_map<const Object*, Var> pool_vars;
+      Array<Var> pool_args;
+      for (const PoolInfo& pool : pools) {
+        Var pool_var(pool->pool_name, PointerType(PrimType(DataType::UInt(8))));
+        pool_vars[pool.get()] = pool_var;
+        pool_args.push_back(pool_var);
+      }
+      PoolAllocationToOffsetConverter converter(pool_allocations, pooled_funcs, pool_vars);
+      converter.pool_args = pool_args;
+      PrimFuncNode* n = func.CopyOnWrite();
+      n->body = converter(std::move(n->body));
+      for (const Var& pool_arg : pool_args) {
+        n->params.push_back(pool_arg);
+      }
+      func = WithAttr(std::move(func), kPoolArgsAttr, Array<PoolInfo>(pools));
+      updated_mod->Update(gv, func);
+    }
+    return updated_mod;
+  };
+  return tvm::transform::CreateModulePass(pass_func, 0, "tir.usmp.ConvertPoolAllocationsToOffsets",
+                                          {});
+}
+
+TVM_REGISTER_GLOBAL("tir.usmp.transform.ConvertPoolAllocationsToOffsets")
+    .set_body_typed(ConvertPoolAllocationsToOffsets);
+
+}  // namespace transform
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
@@ -22,15 +22,22 @@
  * \brief Utilities for Unified Static Memory Planner
  */
 
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/stmt.h>
 #include <tvm/tir/usmp/utils.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace tvm {
 namespace tir {
 namespace usmp {
 
+TVM_REGISTER_PASS_CONFIG_OPTION(kUSMPEnableOption, Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION(kUSMPAlgorithmOption, String);
+
 BufferInfo::BufferInfo(String name_hint, Integer size_bytes, Array<PoolInfo> pool_candidates,
                        Integer alignment) {
   auto bufinfo_node = make_object<BufferInfoNode>();
@@ -158,11 +165,101 @@ Integer CalculateExtentsSize(const AllocateNode* op) {
   return Integer(num_elements * element_size_bytes);
 }
 
+Map<Stmt, PoolAllocation> AssignStmtPoolAllocations(
+    const Map<BufferInfo, Stmt>& buffer_info_stmts,
+    const Map<BufferInfo, PoolAllocation>& pool_allocations) {
+  Map<Stmt, PoolAllocation> ret;
+  for (const auto& kv : pool_allocations) {
+    ICHECK(buffer_info_stmts.count(kv.first))
+        << "TVM USMP Error: the buffer " << kv.first->name_hint << " has no allocate node";
+    ret.Set(buffer_info_stmts[kv.first], kv.second);
+  }
+  return ret;
+}
+
+Map<PoolInfo, Integer> CalculatePoolSizes(const Map<BufferInfo, PoolAllocation>& pool_allocations) {
+  std::unordered_map<PoolInfo, int64_t, ObjectPtrHash, ObjectPtrEqual> pool_sizes;
+  for (const auto& kv : pool_allocations) {
+    int64_t end = kv.second->byte_offset->value + kv.first->size_bytes->value;
+    int64_t& pool_size = pool_sizes[kv.second->pool_info];
+    pool_size = std::max(pool_size, end);
+  }
+  Map<PoolInfo, Integer> ret;
+  for (const auto& kv : pool_sizes) {
+    ret.Set(kv.first, Integer(kv.second));
+  }
+  return ret;
+}
+
+Map<PoolInfo, Integer> CalculateSharedPoolSizes(
+    const Array<Map<BufferInfo, PoolAllocation>>& module_pool_allocations) {
+  Map<PoolInfo, Integer> ret;
+  for (const auto& pool_allocations : module_pool_allocations) {
+    for (const auto& kv : CalculatePoolSizes(pool_allocations)) {
+      auto it = ret.find(kv.first);
+      if (it == ret.end() || (*it).second->value < kv.second->value) {
+        ret.Set(kv.first, kv.second);
+      }
+    }
+  }
+  return ret;
+}
+
+int64_t CalculateTotalPoolSize(const Map<BufferInfo, PoolAllocation>& pool_allocations) {
+  int64_t total_size = 0;
+  for (const auto& kv : CalculatePoolSizes(pool_allocations)) {
+    total_size += kv.second->value;
+  }
+  return total_size;
+}
+
+int64_t CalculatePoolSizeLowerBound(const Array<BufferInfo>& buffer_info_arr,
+                                    const Integer& memory_pressure) {
+  int64_t lower_bound = memory_pressure.defined() ? memory_pressure->value : 0;
+  for (const auto& buffer_info : buffer_info_arr) {
+    int64_t size_bytes = buffer_info->size_bytes->value;
+    lower_bound = std::max(lower_bound, size_bytes);
+    for (const auto& conflict_obj : buffer_info->conflicts) {
+      auto conflict = Downcast<BufferInfo>(conflict_obj);
+      if (!conflict.same_as(buffer_info)) {
+        lower_bound = std::max(lower_bound, size_bytes + conflict->size_bytes->value);
+      }
+    }
+  }
+  return lower_bound;
+}
+
 TVM_REGISTER_GLOBAL("tir.usmp.CreateArrayBufferInfo")
     .set_body_typed([](Map<BufferInfo, Stmt> buffer_info_map) {
       return (CreateArrayBufferInfo(buffer_info_map));
     });
 
+TVM_REGISTER_GLOBAL("tir.usmp.AssignStmtPoolAllocations")
+    .set_body_typed([](Map<BufferInfo, Stmt> buffer_info_stmts,
+                       Map<BufferInfo, PoolAllocation> pool_allocations) {
+      return AssignStmtPoolAllocations(buffer_info_stmts, pool_allocations);
+    });
+
+TVM_REGISTER_GLOBAL("tir.usmp.CalculatePoolSizes")
+    .set_body_typed([](Map<BufferInfo, PoolAllocation> pool_allocations) {
+      return CalculatePoolSizes(pool_allocations);
+    });
+
+TVM_REGISTER_GLOBAL("tir.usmp.CalculateSharedPoolSizes")
+    .set_body_typed([](Array<Map<BufferInfo, PoolAllocation>> module_pool_allocations) {
+      return CalculateSharedPoolSizes(module_pool_allocations);
+    });
+
+TVM_REGISTER_GLOBAL("tir.usmp.CalculateTotalPoolSize")
+    .set_body_typed([](Map<BufferInfo, PoolAllocation> pool_allocations) {
+      return CalculateTotalPoolSize(pool_allocations);
+    });
+
+TVM_REGISTER_GLOBAL("tir.usmp.CalculatePoolSizeLowerBound")
+    .set_body_typed([](Array<BufferInfo> buffer_info_arr, Integer memory_pressure) {
+      return CalculatePoolSizeLowerBound(buffer_info_arr, memory_pressure);
+    });
+
 }  // namespace usmp
 }  // namespace tir
 }  // namespace tvm
@@ -53,3 +53,59 @@ TEST(Simplify, Mod) {
   auto es = ana.canonical_simplify(mod - x);
   ICHECK(tvm::tir::is_zero(es));
 }
+
+TEST(Simplify, MemoInvalidation) {
+  using namespace tvm;
+  arith::Analyzer ana;
+  ana.EnableMemo();
+  auto x = te::var("x");
+  auto y = te::var("y");
+  PrimExpr cond = floordiv(x, 4) < 2;
+  ICHECK(!ana.CanProve(cond));
+  {
+    With<arith::ConstraintContext> ctx(&ana, x < 8);
+    ICHECK(ana.CanProve(cond));
+  }
+  // the result proved under the constraint is dropped with it
+  ICHECK(!ana.CanProve(cond));
+  // binding a variable no result depends on keeps them
+  ana.Bind(y, Range::FromMinExtent(0, 4));
+  ICHECK(!ana.CanProve(cond));
+  ana.Bind(x, Range::FromMinExtent(0, 8));
+  ICHECK(ana.CanProve(cond));
+}
+
+TEST(Simplify, MemoBindValue) {
+  using namespace tvm;
+  arith::Analyzer ana;
+  ana.EnableMemo();
+  auto x = te::var("x");
+  auto y = te::var("y");
+  ana.Bind(x, y + 1);
+  ICHECK(!ana.CanProve(x > 0));
+  // x depends on y through its value
+  ana.Bind(y, Range::FromMinExtent(0, 4));
+  ICHECK(ana.CanProve(x > 0));
+}
+
+TEST(Simplify, SharedMemo) {
+  using namespace tvm;
+  auto memo = std::make_shared<arith::SimplifyMemo>();
+  auto x = te::var("x");
+  auto n = te::var("n");
+  PrimExpr e = (x * 4 + 2) - (x * 4 + 1);
+  PrimExpr bound_e = floordiv(n, 8);
+  {
+    arith::Analyzer ana;
+    ana.EnableMemo(memo);
+    ana.Bind(n, Range::FromMinExtent(0, 8));
+    ICHECK(tir::is_one(ana.Simplify(e)));
+    ICHECK(tir::is_zero(ana.Simplify(bound_e)));
+  }
+  // only the result not depending on the binding of n is shared
+  ICHECK_EQ(memo->size(), 1U);
+  arith::Analyzer ana;
+  ana.EnableMemo(memo);
+  ICHECK(tir::is_one(ana.Simplify(e)));
+  ICHECK(!tir::is_zero(ana.Simplify(bound_e)));
+}
@@ -0,0 +1,62 @@
+
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <gtest/gtest.h>
+#include <tvm/meta_schedule/runner.h>
+#include <tvm/runtime/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+using namespace tvm;
+using namespace tvm::meta_schedule;
+
+TEST(RPCPoolRunner, DestroyWithRequeuedInput) {
+  auto num_attempts = std::make_shared<std::atomic<int>>(0);
+  // every session fails after a while, the input being requeued until the runner is destroyed
+  runtime::PackedFunc f_create_session(
+      [num_attempts](runtime::TVMArgs args, runtime::TVMRetValue* rv) {
+        num_attempts->fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        LOG(FATAL) << "Intended session failure";
+      });
+  Array<RunnerFuture> futures;
+  {
+    Runner runner = Runner::RPCPool(f_create_session, /*num_devices=*/1,
+                                    /*max_retries=*/1 << 20, /*timeout_sec=*/100,
+                                    /*session_lifetime_sec=*/200, /*number=*/1, /*repeat=*/1,
+                                    /*min_repeat_ms=*/0, /*enable_cpu_cache_flush=*/false,
+                                    /*alloc_repeat=*/1);
+    futures = runner->Run({RunnerInput("artifact.so", "cpu", {})});
+    while (num_attempts->load() < 2) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  // the runner is destroyed while its worker is failing the input again
+  RunnerResult result = futures[0]->Result();
+  ASSERT_TRUE(result->error_msg.defined());
+  EXPECT_NE(std::string(result->error_msg.value()).find("destroyed"), std::string::npos);
+}
+
+}  // namespace
@@ -22,6 +22,9 @@
 #include <tvm/runtime/memory.h>
 #include <tvm/runtime/object.h>
 
+#include <thread>
+#include <vector>
+
 namespace tvm {
 namespace test {
 
@@ -95,3 +98,27 @@ TEST(ObjectHierachy, Basic) {
   ICHECK(refB.as<ObjAA>() == nullptr);
   ICHECK(refB.as<ObjB>() != nullptr);
 }
+
+TEST(ObjectPool, ReuseAcrossThreads) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+
+  ObjectPoolStats before = GetObjectPoolStats();
+  std::vector<ObjectRef> objs;
+  for (int i = 0; i < 1000; ++i) {
+    objs.push_back(ObjectRef(PooledObjAllocator().make_object<ObjAA>()));
+  }
+  ICHECK_EQ(objs.back()->type_index(), ObjAA::RuntimeTypeIndex());
+  ICHECK(objs.back().as<ObjA>() != nullptr);
+  // the objects may be freed by another thread than the one that allocated them
+  std::thread([&objs]() { objs.clear(); }).join();
+  for (int i = 0; i < 1000; ++i) {
+    objs.push_back(ObjectRef(PooledObjAllocator().make_object<ObjB>()));
+  }
+  objs.clear();
+
+  ObjectPoolStats after = GetObjectPoolStats();
+  ICHECK_GE(after.num_allocs - before.num_allocs, 2000U);
+  ICHECK_GE(after.num_frees - before.num_frees, 2000U);
+  ICHECK_GT(after.reserved_bytes, 0U);
+}
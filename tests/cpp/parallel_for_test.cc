@@ -22,6 +22,7 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/support/parallel_for.h>
 
+#include <atomic>
 #include <thread>
 #include <vector>
 
@@ -92,20 +93,43 @@ TEST(ParallelFor, NestedWithNormalForLoop) {
 }
 
 TEST(ParallelFor, NestedWithParallelFor) {
-  // Currently do not support using nested parallel_for
   using tvm::support::parallel_for;
+  using tvm::support::parallel_for_dynamic;
 
-  bool exception = false;
-  try {
-    parallel_for(0, 100, [](int i) {
-      parallel_for(0, 100, [](int j) {
-        // Blank loop
-      });
+  // the nested loops run on the thread of their outer iteration
+  std::vector<std::atomic<int>> sums(100);
+  parallel_for(0, 100, [&sums](int i) {
+    sums[i] = 0;
+    parallel_for(0, 100, [&sums, i](int j) { sums[i] += j; });
+    parallel_for_dynamic(0, 100, 4, [&sums, i](int thread_id, int j) {
+      ICHECK_EQ(thread_id, 0);
+      sums[i] += j;
     });
-  } catch (const std::exception& e) {
-    exception = true;
+  });
+  for (int i = 0; i < 100; i++) {
+    ICHECK_EQ(sums[i].load(), 2 * 4950);
+  }
+}
+
+TEST(ParallelFor, ConcurrentCallers) {
+  using tvm::support::parallel_for;
+
+  std::vector<std::thread> callers;
+  std::vector<std::atomic<int>> sums(4);
+  for (int t = 0; t < 4; t++) {
+    callers.emplace_back([&sums, t]() {
+      sums[t] = 0;
+      for (int k = 0; k < 10; k++) {
+        parallel_for(0, 1000, [&sums, t](int i) { sums[t] += i; });
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (int t = 0; t < 4; t++) {
+    ICHECK_EQ(sums[t].load(), 10 * 499500);
   }
-  ICHECK(exception);
 }
 
 TEST(ParallelFor, Exception) {
@@ -130,6 +154,17 @@ TEST(ParallelForDynamic, Basic) {
   }
 }
 
+TEST(ParallelForDynamic, MoreThreadsThanCores) {
+  using tvm::support::parallel_for_dynamic;
+  int num_threads = 2 * std::thread::hardware_concurrency() + 1;
+  std::atomic<int> sum{0};
+  parallel_for_dynamic(0, 1000, num_threads, [&](int thread_id, int i) {
+    ICHECK_LT(thread_id, num_threads);
+    sum += i;
+  });
+  ICHECK_EQ(sum.load(), 499500);
+}
+
 TEST(ParallelForDynamic, ExceptionOnMain) {
   using tvm::support::parallel_for_dynamic;
   int num_threads = 1;
@@ -162,3 +162,18 @@ TEST(Relay, OutOfStackLet) {
   };
   ASSERT_EXIT((foo(), exit(0)), ::testing::ExitedWithCode(0), ".*");
 }
+
+TEST(Relay, OutOfStack_infer_type) {
+  auto foo = [] {
+    auto relu_op = relay::Op::Get("nn.relu");
+    auto x = relay::Var("x", relay::TensorType({3, 2}, DataType::Float(32)));
+    Expr y = relay::Call(relu_op, {x});
+    for (int i = 0; i < 1e5; ++i) {
+      y = relay::Call(relu_op, {relay::TupleGetItem(relay::Tuple({y, x}), 0)});
+    }
+    IRModule mod = IRModule::FromExpr(relay::Function({x}, y, relay::Type(), {}));
+    mod = relay::transform::InferType()(mod);
+    ICHECK(mod->Lookup("main").as<FunctionNode>()->body->checked_type_.defined());
+  };
+  ASSERT_EXIT((foo(), exit(0)), ::testing::ExitedWithCode(0), ".*");
+}
@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/registry.h>
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../src/runtime/contrib/json/json_runtime.h"
+
+namespace tvm {
+namespace runtime {
+namespace json {
+namespace {
+
+// A json runtime adding float32 vectors, the intermediates being planned by the base.
+class AddJSONRuntime : public JSONRuntimeBase {
+ public:
+  AddJSONRuntime(const std::string& symbol_name, const std::string& graph_json,
+                 const Array<String> const_names)
+      : JSONRuntimeBase(symbol_name, graph_json, const_names) {}
+
+  void Init(const Array<NDArray>& consts) override {
+    SetupConstants(consts);
+    AllocateIntermediates(Device{kDLCPU, 0});
+  }
+
+  void Run() override {
+    RunKernelNodes([this](uint32_t nid) {
+      const auto& node = nodes_[nid];
+      ICHECK_EQ(node.GetOpName(), "add") << "Unsupported op: " << node.GetOpName();
+      const float* lhs = static_cast<const float*>(data_entry_[EntryID(node.GetInputs()[0])]->data);
+      const float* rhs = static_cast<const float*>(data_entry_[EntryID(node.GetInputs()[1])]->data);
+      float* out = static_cast<float*>(data_entry_[EntryID(nid, 0)]->data);
+      for (int64_t i = 0; i < node.GetOpShape()[0][0]; ++i) {
+        out[i] = lhs[i] + rhs[i];
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      threads_.insert(std::this_thread::get_id());
+    });
+  }
+
+  size_t NumLevels() const { return node_levels_.size(); }
+  size_t NumStorage() const { return intermediate_storage_.size(); }
+  size_t NumThreads() const { return threads_.size(); }
+
+ private:
+  std::mutex mutex_;
+  std::set<std::thread::id> threads_;
+};
+
+std::string InputNode(const std::string& name, int64_t size) {
+  std::ostringstream os;
+  os << "{\"op\": \"input\", \"name\": \"" << name << "\", \"attrs\": {\"shape\": [[[" << size
+     << "]]], \"dtype\": [[\"float32\"]]}}";
+  return os.str();
+}
+
+std::string AddNode(int lhs, int rhs, int64_t size) {
+  std::ostringstream os;
+  os << "{\"op\": \"kernel\", \"name\": \"add\", \"inputs\": [[" << lhs << ", 0, 0], [" << rhs
+     << ", 0, 0]], \"attrs\": {\"num_inputs\": \"2\", \"num_outputs\": \"1\", \"shape\": [[["
+     << size << "]]], \"dtype\": [[\"float32\"]]}}";
+  return os.str();
+}
+
+// out = ((a + b) + (a + a)) * 2 + a, where a + b and a + a are independent.
+std::string AddGraph(int64_t size) {
+  std::vector<std::string> nodes = {InputNode("a", size), InputNode("b", size),
+                                    AddNode(0, 1, size),  AddNode(0, 0, size),
+                                    AddNode(2, 3, size),  AddNode(4, 4, size),
+                                    AddNode(5, 0, size)};
+  std::ostringstream os;
+  os << "{\"nodes\": [";
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    os << (i == 0 ? "" : ", ") << nodes[i];
+  }
+  os << "], \"arg_nodes\": [0, 1], \"heads\": [[6, 0, 0]], "
+     << "\"node_row_ptr\": [0, 1, 2, 3, 4, 5, 6, 7]}";
+  return os.str();
+}
+
+TEST(JSONRuntime, ReuseIntermediatesAndRunIndependentNodes) {
+  const int64_t size = 1024;
+  auto node = make_object<AddJSONRuntime>("add_graph", AddGraph(size), Array<String>());
+  AddJSONRuntime* runtime = node.get();
+  Module mod(node);
+  mod.GetFunction("__init_add_graph")(Array<NDArray>());
+
+  // The two first adds form one level; the four intermediates fit in three storages, as the
+  // third add reuses the storage of the first level once it is consumed.
+  EXPECT_EQ(runtime->NumLevels(), 4);
+  EXPECT_EQ(runtime->NumStorage(), 3);
+
+  Device cpu{kDLCPU, 0};
+  NDArray a = NDArray::Empty({size}, DLDataType{kDLFloat, 32, 1}, cpu);
+  NDArray b = NDArray::Empty({size}, DLDataType{kDLFloat, 32, 1}, cpu);
+  NDArray out = NDArray::Empty({size}, DLDataType{kDLFloat, 32, 1}, cpu);
+  for (int64_t i = 0; i < size; ++i) {
+    static_cast<float*>(a->data)[i] = static_cast<float>(i);
+    static_cast<float*>(b->data)[i] = 1.0f;
+  }
+  PackedFunc run = mod.GetFunction("add_graph");
+  for (int repeat = 0; repeat < 4; ++repeat) {
+    run(a, b, out);
+    for (int64_t i = 0; i < size; ++i) {
+      ASSERT_EQ(static_cast<float*>(out->data)[i], 7.0f * i + 2.0f);
+    }
+  }
+  EXPECT_GE(runtime->NumThreads(), 1);
+}
+
+}  // namespace
+}  // namespace json
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,66 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "../../../src/runtime/file_utils.h"
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+TEST(KernelCache, KeyDependsOnEveryPart) {
+  std::string key = KernelCacheKey({"opencl_program", "device", "source"});
+  EXPECT_EQ(key.size(), 16);
+  EXPECT_EQ(key, KernelCacheKey({"opencl_program", "device", "source"}));
+  EXPECT_NE(key, KernelCacheKey({"opencl_program", "device", "source2"}));
+  // The parts are separated, moving bytes between them changes the key.
+  EXPECT_NE(KernelCacheKey({"ab", "c"}), KernelCacheKey({"a", "bc"}));
+}
+
+TEST(KernelCache, SaveAndLoad) {
+  std::string old_dir = GetKernelCacheDir();
+  std::string data;
+  SetKernelCacheDir("");
+  SaveKernelCache("disabled", "binary");
+  EXPECT_FALSE(LoadKernelCache("disabled", &data));
+
+  std::string dir = testing::TempDir() + "tvm_kernel_cache_test";
+  SetKernelCacheDir(dir);
+  std::string key = KernelCacheKey({"kernel_cache_test"});
+  std::remove((dir + "/" + key + ".bin").c_str());
+  EXPECT_FALSE(LoadKernelCache(key, &data));
+  std::string binary("\0\1binary", 8);
+  SaveKernelCache(key, binary);
+  ASSERT_TRUE(LoadKernelCache(key, &data));
+  EXPECT_EQ(data, binary);
+  // A new entry replaces the previous one.
+  SaveKernelCache(key, "other");
+  ASSERT_TRUE(LoadKernelCache(key, &data));
+  EXPECT_EQ(data, "other");
+  std::remove((dir + "/" + key + ".bin").c_str());
+  SetKernelCacheDir(old_dir);
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,44 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../../../src/runtime/library_module.h"
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/packed_func.h>
+
+namespace {
+int AddOne(TVMValue* args, int* type_codes, int num_args, TVMValue* out_ret_value,
+           int* out_ret_tcode, void* resource_handle) {
+  out_ret_value->v_int64 = args[0].v_int64 + 1;
+  *out_ret_tcode = kTVMArgInt;
+  return 0;
+}
+}  // namespace
+
+TEST(LibraryModule, GetBackendPackedCFunc) {
+  using namespace tvm::runtime;
+  PackedFunc wrapped = WrapPackedFunc(AddOne, ObjectPtr<Object>());
+  EXPECT_EQ(GetBackendPackedCFunc(wrapped), &AddOne);
+  int64_t result = wrapped(41);
+  EXPECT_EQ(result, 42);
+
+  PackedFunc plain([](TVMArgs args, TVMRetValue* rv) { *rv = args[0]; });
+  EXPECT_EQ(GetBackendPackedCFunc(plain), nullptr);
+}
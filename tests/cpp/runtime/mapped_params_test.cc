@@ -0,0 +1,151 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/memory_io.h>
+#include <tvm/runtime/device_api.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../../../src/runtime/file_utils.h"
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+const DLDataType kFloat32 = {kDLFloat, 32, 1};
+
+NDArray Iota(int64_t n) {
+  NDArray arr = NDArray::Empty({n}, kFloat32, {kDLCPU, 0});
+  for (int64_t i = 0; i < n; ++i) {
+    static_cast<float*>(arr->data)[i] = static_cast<float>(i);
+  }
+  return arr;
+}
+
+Map<String, NDArray> TestParams() {
+  Map<String, NDArray> params;
+  params.Set("small", Iota(3));
+  params.Set("weight", Iota(4096));
+  return params;
+}
+
+void ExpectIota(const NDArray& arr, int64_t n) {
+  ASSERT_EQ(arr->ndim, 1);
+  ASSERT_EQ(arr->shape[0], n);
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_EQ(static_cast<const float*>(arr->data)[i], static_cast<float>(i));
+  }
+}
+
+std::string TempFile(const std::string& name) {
+  return testing::TempDir() + "tvm_" + name + ".params";
+}
+
+TEST(MappedParams, AlignedLayoutIsMapped) {
+  std::string path = TempFile("aligned_params");
+  SaveBinaryToFile(path, SaveParams(TestParams(), /*aligned=*/true));
+  Map<String, NDArray> params = LoadParamsFromFile(path);
+  ExpectIota(params["small"], 3);
+  ExpectIota(params["weight"], 4096);
+  if (MappedFile::Open(path)->is_mapped()) {
+    // Page sized payloads are page aligned, smaller ones meet the allocator alignment.
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(params["small"]->data) % kAllocAlignment, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(params["weight"]->data) % 4096, 0);
+  }
+  std::remove(path.c_str());
+  // Views keep their mapping alive after the file is gone.
+  ExpectIota(params["weight"], 4096);
+}
+
+TEST(MappedParams, ViewsAreCopyOnWrite) {
+  std::string path = TempFile("cow_params");
+  SaveBinaryToFile(path, SaveParams(TestParams(), /*aligned=*/true));
+  NDArray weight = LoadParamsFromFile(path)["weight"];
+  static_cast<float*>(weight->data)[0] = 42.0f;
+  ExpectIota(LoadParamsFromFile(path)["weight"], 4096);
+  std::remove(path.c_str());
+}
+
+TEST(MappedParams, StreamAndLegacyLayouts) {
+  // The aligned layout still loads from an in-memory blob.
+  Map<String, NDArray> params = LoadParams(SaveParams(TestParams(), /*aligned=*/true));
+  ExpectIota(params["small"], 3);
+  ExpectIota(params["weight"], 4096);
+
+  // The legacy layout loads from a file through the copying path.
+  std::string path = TempFile("legacy_params");
+  SaveBinaryToFile(path, SaveParams(TestParams()));
+  params = LoadParamsFromFile(path);
+  ExpectIota(params["small"], 3);
+  ExpectIota(params["weight"], 4096);
+  std::remove(path.c_str());
+}
+
+TEST(MappedParams, IndexedLayoutRandomAccess) {
+  std::string path = TempFile("indexed_params");
+  SaveBinaryToFile(path, SaveIndexedParams(TestParams()));
+  ParamsFile file = ParamsFile::Open(path);
+  Array<String> names = file->GetNames();
+  ASSERT_EQ(names.size(), 2);
+  EXPECT_EQ(names[0], "small");
+  EXPECT_EQ(names[1], "weight");
+  // One tensor is read without the others.
+  NDArray weight = file->Get("weight");
+  ExpectIota(weight, 4096);
+  if (MappedFile::Open(path)->is_mapped()) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(weight->data) % 4096, 0);
+  }
+  Map<String, NDArray> params = file->Load({"small"}, {kDLCPU, 0});
+  ASSERT_EQ(params.size(), 1);
+  ExpectIota(params["small"], 3);
+  std::remove(path.c_str());
+}
+
+TEST(MappedParams, IndexedLayoutStreams) {
+  std::string bytes = SaveIndexedParams(TestParams());
+  // The whole list still loads sequentially from a blob.
+  Map<String, NDArray> params = LoadParams(bytes);
+  ExpectIota(params["small"], 3);
+  ExpectIota(params["weight"], 4096);
+  // The names are read from the table alone, in every layout.
+  for (const std::string& blob : {bytes, SaveParams(TestParams())}) {
+    dmlc::MemoryFixedSizeStream strm(const_cast<char*>(blob.data()), blob.size());
+    EXPECT_EQ(LoadParamNames(&strm), std::vector<std::string>({"small", "weight"}));
+  }
+}
+
+TEST(MappedParams, UploadParamsSpreadsCopies) {
+  std::vector<NDArray> src, dst;
+  for (int64_t n : {3, 4096, 17, 1 << 18, 1, 256}) {
+    src.push_back(Iota(n));
+    dst.push_back(NDArray::Empty({n}, kFloat32, {kDLCPU, 0}));
+  }
+  UploadParams(src, dst);
+  for (size_t i = 0; i < src.size(); ++i) {
+    ExpectIota(dst[i], src[i]->shape[0]);
+  }
+  EXPECT_ANY_THROW(UploadParams({Iota(3)}, {NDArray::Empty({4}, kFloat32, {kDLCPU, 0})}));
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,110 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "../../../../src/runtime/vm/pooled_allocator.h"
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+namespace {
+
+const DLDataType kFloat32 = {kDLFloat, 32, 1};
+
+TEST(PooledAllocator, ThreadCacheHit) {
+  PooledAllocator alloc({kDLCPU, 0}, PooledAllocator::kDefaultPageSize, 1 << 20);
+  Buffer a = alloc.Alloc(1000, 64, kFloat32);
+  alloc.Free(a);
+  Buffer b = alloc.Alloc(1000, 64, kFloat32);
+  EXPECT_EQ(a.data, b.data);
+  alloc.Free(b);
+  auto stats = alloc.Stats();
+  EXPECT_EQ(stats["Thread Cache Hits"], 1);
+  EXPECT_EQ(stats["Pool Hits"], 0);
+  EXPECT_EQ(stats["Misses"], 1);
+}
+
+TEST(PooledAllocator, FlushToSharedPool) {
+  // The second free exceeds the thread cache limit and returns both buffers to the pool.
+  PooledAllocator alloc({kDLCPU, 0}, PooledAllocator::kDefaultPageSize, 4096);
+  Buffer a = alloc.Alloc(4096, 64, kFloat32);
+  Buffer b = alloc.Alloc(4096, 64, kFloat32);
+  alloc.Free(a);
+  alloc.Free(b);
+  std::thread worker([&]() {
+    Buffer c = alloc.Alloc(4096, 64, kFloat32);
+    EXPECT_TRUE(c.data == a.data || c.data == b.data);
+    alloc.Free(c);
+  });
+  worker.join();
+  auto stats = alloc.Stats();
+  EXPECT_EQ(stats["Pool Hits"], 1);
+  EXPECT_EQ(stats["Misses"], 2);
+  EXPECT_EQ(alloc.UsedMemory(), 8192);
+}
+
+TEST(PooledAllocator, ReclaimExitedThreadCache) {
+  PooledAllocator alloc({kDLCPU, 0}, PooledAllocator::kDefaultPageSize, 1 << 20);
+  void* data = nullptr;
+  std::thread worker([&]() {
+    Buffer a = alloc.Alloc(4096, 64, kFloat32);
+    data = a.data;
+    alloc.Free(a);
+  });
+  worker.join();
+  // The exited thread's cache is handed back to the shared pool on a miss.
+  Buffer b = alloc.Alloc(4096, 64, kFloat32);
+  EXPECT_EQ(b.data, data);
+  alloc.Free(b);
+  EXPECT_EQ(alloc.UsedMemory(), 4096);
+}
+
+TEST(PooledAllocator, DropDestroyedAllocatorCaches) {
+  std::vector<size_t> num_caches;
+  for (int i = 0; i < 16; ++i) {
+    PooledAllocator alloc({kDLCPU, 0}, PooledAllocator::kDefaultPageSize, 1 << 20);
+    Buffer a = alloc.Alloc(4096, 64, kFloat32);
+    alloc.Free(a);
+    num_caches.push_back(PooledAllocator::NumThreadCaches());
+  }
+  // the cache of each destroyed allocator is dropped when the next one is added
+  EXPECT_GE(num_caches[0], 1);
+  for (size_t n : num_caches) {
+    EXPECT_EQ(n, num_caches[0]);
+  }
+}
+
+TEST(PooledAllocator, ThreadCacheDisabled) {
+  PooledAllocator alloc({kDLCPU, 0}, PooledAllocator::kDefaultPageSize, 0);
+  Buffer a = alloc.Alloc(1000, 64, kFloat32);
+  alloc.Free(a);
+  Buffer b = alloc.Alloc(1000, 64, kFloat32);
+  EXPECT_EQ(a.data, b.data);
+  alloc.Free(b);
+  EXPECT_EQ(alloc.Stats()["Pool Hits"], 1);
+}
+
+}  // namespace
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../../../src/runtime/vm/slab_allocator.h"
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+namespace {
+
+const DLDataType kFloat32 = {kDLFloat, 32, 1};
+
+TEST(SlabAllocator, SizeClasses) {
+  SlabAllocator alloc({kDLCPU, 0});
+  EXPECT_EQ(alloc.RoundUp(1), 4096);
+  EXPECT_EQ(alloc.RoundUp(4096), 4096);
+  EXPECT_EQ(alloc.RoundUp(4097), 8192);
+  // Four classes per doubling above 16KB.
+  EXPECT_EQ(alloc.RoundUp(16385), 20480);
+  EXPECT_EQ(alloc.RoundUp(1 << 20), 1 << 20);
+  EXPECT_EQ(alloc.RoundUp((1 << 20) + 1), (1 << 20) + (1 << 18));
+}
+
+TEST(SlabAllocator, SplitAndCoalesce) {
+  SlabAllocator alloc({kDLCPU, 0});
+  Buffer big = alloc.Alloc(1 << 20, 64, kFloat32);
+  EXPECT_EQ(alloc.UsedMemory(), 1 << 20);
+  alloc.Free(big);
+  EXPECT_EQ(alloc.CachedMemory(), 1 << 20);
+
+  // Both halves are carved out of the cached block without a new device allocation.
+  Buffer a = alloc.Alloc(1 << 19, 64, kFloat32);
+  Buffer b = alloc.Alloc(1 << 19, 64, kFloat32);
+  EXPECT_EQ(alloc.UsedMemory(), 1 << 20);
+  EXPECT_EQ(alloc.CachedMemory(), 0);
+  EXPECT_EQ(static_cast<char*>(a.data) + a.size, static_cast<char*>(b.data));
+
+  // Freeing both halves merges them back so the whole block is reusable.
+  alloc.Free(a);
+  alloc.Free(b);
+  Buffer c = alloc.Alloc(1 << 20, 64, kFloat32);
+  EXPECT_EQ(c.data, big.data);
+  EXPECT_EQ(alloc.UsedMemory(), 1 << 20);
+  alloc.Free(c);
+}
+
+TEST(SlabAllocator, ReuseAcrossClasses) {
+  SlabAllocator alloc({kDLCPU, 0});
+  Buffer a = alloc.Alloc(100000, 64, kFloat32);
+  alloc.Free(a);
+  Buffer b = alloc.Alloc(90000, 64, kFloat32);
+  EXPECT_EQ(b.data, a.data);
+  EXPECT_EQ(alloc.UsedMemory(), alloc.RoundUp(100000));
+  alloc.Free(b);
+}
+
+TEST(SlabAllocator, TrimToHighWater) {
+  SlabAllocator alloc({kDLCPU, 0}, 1 << 20);
+  Buffer a = alloc.Alloc(1 << 20, 64, kFloat32);
+  Buffer b = alloc.Alloc(1 << 20, 64, kFloat32);
+  alloc.Free(a);
+  EXPECT_EQ(alloc.CachedMemory(), 1 << 20);
+  alloc.Free(b);
+  // The second free exceeds the limit and returns one block to the device.
+  EXPECT_EQ(alloc.CachedMemory(), 1 << 20);
+  EXPECT_EQ(alloc.UsedMemory(), 1 << 20);
+}
+
+}  // namespace
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../../../src/runtime/workspace_pool.h"
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/device_api.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+// A device API allocating host memory and counting the allocations.
+class CountingDeviceAPI : public DeviceAPI {
+ public:
+  void SetDevice(Device dev) final {}
+  void GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv) final {}
+  void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
+    ++num_allocs;
+    return std::malloc(nbytes);
+  }
+  void FreeDataSpace(Device dev, void* ptr) final {
+    ++num_frees;
+    std::free(ptr);
+  }
+  void StreamSync(Device dev, TVMStreamHandle stream) final {}
+
+  int num_allocs = 0;
+  int num_frees = 0;
+};
+
+Device CPU() { return Device{kDLCPU, 0}; }
+
+TEST(WorkspacePool, ReusesFreedBlocks) {
+  CountingDeviceAPI api;
+  WorkspacePool pool(kDLCPU, &api);
+  for (int i = 0; i < 10; ++i) {
+    void* a = pool.AllocWorkspace(CPU(), 1000);
+    void* b = pool.AllocWorkspace(CPU(), 100000);
+    pool.FreeWorkspace(CPU(), a);
+    pool.FreeWorkspace(CPU(), b);
+  }
+  EXPECT_EQ(api.num_allocs, 2);
+  EXPECT_EQ(api.num_frees, 0);
+  WorkspacePoolStats stats = pool.GetStats(CPU());
+  EXPECT_EQ(stats.num_allocs, 20);
+  EXPECT_EQ(stats.num_hits, 18);
+  EXPECT_EQ(stats.in_use_bytes, 0);
+  EXPECT_GE(stats.peak_in_use_bytes, 101000);
+  EXPECT_EQ(stats.reserved_bytes, stats.peak_in_use_bytes);
+}
+
+TEST(WorkspacePool, GrowsInsteadOfFreeingOnMiss) {
+  CountingDeviceAPI api;
+  WorkspacePool pool(kDLCPU, &api);
+  void* small = pool.AllocWorkspace(CPU(), 4096);
+  pool.FreeWorkspace(CPU(), small);
+  void* large = pool.AllocWorkspace(CPU(), 1 << 20);
+  EXPECT_EQ(api.num_allocs, 2);
+  EXPECT_EQ(api.num_frees, 0);
+  // the small block is still cached
+  void* again = pool.AllocWorkspace(CPU(), 4096);
+  EXPECT_EQ(again, small);
+  pool.FreeWorkspace(CPU(), again);
+  pool.FreeWorkspace(CPU(), large);
+  EXPECT_EQ(api.num_allocs, 2);
+  pool.Trim();
+  EXPECT_EQ(api.num_frees, 2);
+  EXPECT_EQ(pool.GetStats(CPU()).reserved_bytes, 0);
+}
+
+TEST(WorkspacePool, SizeClassesBoundTheWaste) {
+  CountingDeviceAPI api;
+  WorkspacePool pool(kDLCPU, &api);
+  for (size_t nbytes = 1; nbytes < (64 << 20); nbytes = nbytes * 3 / 2 + 1) {
+    void* data = pool.AllocWorkspace(CPU(), nbytes);
+    size_t in_use = pool.GetStats(CPU()).in_use_bytes;
+    EXPECT_GE(in_use, nbytes);
+    EXPECT_LE(in_use, std::max<size_t>(4096, nbytes + nbytes / 4 + 4096));
+    pool.FreeWorkspace(CPU(), data);
+  }
+}
+
+TEST(WorkspacePool, TrimsBlocksNoLongerUsed) {
+  CountingDeviceAPI api;
+  WorkspacePool pool(kDLCPU, &api);
+  void* large = pool.AllocWorkspace(CPU(), 1 << 20);
+  pool.FreeWorkspace(CPU(), large);
+  for (int i = 0; i < 20; ++i) {
+    pool.FreeWorkspace(CPU(), pool.AllocWorkspace(CPU(), 4096));
+  }
+  EXPECT_EQ(api.num_frees, 1);
+  EXPECT_EQ(pool.GetStats(CPU()).reserved_bytes, 4096);
+}
+
+TEST(WorkspacePool, OutOfOrderFree) {
+  CountingDeviceAPI api;
+  WorkspacePool pool(kDLCPU, &api);
+  std::vector<void*> data;
+  for (int i = 0; i < 8; ++i) {
+    data.push_back(pool.AllocWorkspace(CPU(), 4096 * (i + 1)));
+  }
+  for (int i : {3, 0, 7, 5, 1, 2, 6, 4}) {
+    pool.FreeWorkspace(CPU(), data[i]);
+  }
+  EXPECT_EQ(pool.GetStats(CPU()).in_use_bytes, 0);
+  EXPECT_ANY_THROW(pool.FreeWorkspace(CPU(), data[0]));
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/ir/module.h>
+#include <tvm/node/structural_hash.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/function.h>
+#include <tvm/relay/op.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt.h>
+
+using namespace tvm;
+
+namespace {
+
+size_t Hash(const ObjectRef& object, bool map_free_vars) {
+  static const runtime::PackedFunc* fhash = runtime::Registry::Get("node.StructuralHash");
+  return static_cast<size_t>((*fhash)(object, map_free_vars).operator int64_t());
+}
+
+size_t CachedHash(SHashCache* cache, const ObjectRef& object, bool map_free_vars) {
+  With<SHashCacheContext> scope(cache);
+  return Hash(object, map_free_vars);
+}
+
+tir::PrimFunc MakePrimFunc() {
+  tir::Var n("n"), i("i"), j("j"), t("t");
+  PrimExpr value = (i * 4 + j) * (i * 4 + j) + (i + 1) * (j + 2);
+  tir::Stmt body = tir::Evaluate(tir::Let(t, value, t * t + n));
+  body = tir::For(j, 0, 4, tir::ForKind::kSerial, body);
+  body = tir::For(i, 0, n, tir::ForKind::kSerial, body);
+  return tir::PrimFunc({n}, body);
+}
+
+}  // namespace
+
+TEST(SHashCache, SameAsUncached) {
+  tir::PrimFunc func = MakePrimFunc();
+  tir::Var free("free");
+  PrimExpr free_expr = free * 3 + free * 5 + (free + 7) * 2;
+  Array<ObjectRef> contexts = {func, Array<ObjectRef>{func, func}, Array<ObjectRef>{free, func},
+                               Array<ObjectRef>{free_expr, func, free_expr},
+                               Array<ObjectRef>{func, MakePrimFunc(), free_expr}};
+  for (bool map_free_vars : {false, true}) {
+    SHashCache cache;
+    // hash twice, the second time reuses the subtrees cached by the first one.
+    for (int k = 0; k < 2; ++k) {
+      for (const ObjectRef& object : contexts) {
+        ASSERT_EQ(CachedHash(&cache, object, map_free_vars), Hash(object, map_free_vars));
+      }
+    }
+    ASSERT_GT(cache.size(), 0U);
+  }
+}
+
+TEST(SHashCache, GraphNodes) {
+  relay::Var x("x", relay::Type());
+  Op add_op = Op::Get("add");
+  relay::Expr shared = relay::Call(add_op, {x, x});
+  relay::Expr expr = shared;
+  for (int i = 0; i < 8; ++i) {
+    expr = relay::Call(add_op, {expr, shared});
+  }
+  relay::Function func({x}, expr, relay::Type(), {});
+  relay::Function tree({x}, relay::Call(add_op, {relay::Call(add_op, {x, x}), shared}),
+                       relay::Type(), {});
+  Array<ObjectRef> contexts = {func, Array<ObjectRef>{func, func}, Array<ObjectRef>{shared, func},
+                               Array<ObjectRef>{tree, func}, Array<ObjectRef>{x, expr, func}};
+  for (bool map_free_vars : {false, true}) {
+    SHashCache cache;
+    for (int k = 0; k < 2; ++k) {
+      for (const ObjectRef& object : contexts) {
+        ASSERT_EQ(CachedHash(&cache, object, map_free_vars), Hash(object, map_free_vars));
+      }
+    }
+  }
+}
+
+TEST(SHashCache, Module) {
+  SHashCache cache;
+  IRModule mod(Map<GlobalVar, BaseFunc>{{GlobalVar("prim"), MakePrimFunc()}});
+  size_t before = CachedHash(&cache, mod, false);
+  ASSERT_EQ(before, Hash(mod, false));
+  // the module is updated in place, its hash must not be cached.
+  mod->Add(GlobalVar("other"), MakePrimFunc());
+  ASSERT_EQ(CachedHash(&cache, mod, false), Hash(mod, false));
+  ASSERT_NE(CachedHash(&cache, mod, false), before);
+}
@@ -20,7 +20,11 @@
 #include <dmlc/logging.h>
 #include <gtest/gtest.h>
 
+#include <thread>
+
 #include "../../src/support/hexdump.h"
+#include "../../src/support/ring_buffer.h"
+#include "../../src/support/spsc_queue.h"
 #include "../../src/support/utils.h"
 
 namespace tvm {
@@ -62,5 +66,65 @@ TEST(StartsWithTests, Basic) {
   EXPECT_FALSE(::tvm::support::StartsWith("abc", "abcd"));
 }
 
+TEST(SPSCQueueTests, Bounded) {
+  ::tvm::support::SPSCQueue<int> queue(2);
+  int value = 1;
+  EXPECT_TRUE(queue.TryPush(&value));
+  value = 2;
+  EXPECT_TRUE(queue.TryPush(&value));
+  value = 3;
+  EXPECT_FALSE(queue.TryPush(&value));
+  EXPECT_EQ(queue.size(), 2U);
+  EXPECT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, 1);
+  value = 3;
+  EXPECT_TRUE(queue.TryPush(&value));
+  EXPECT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, 2);
+  EXPECT_TRUE(queue.TryPop(&value));
+  EXPECT_EQ(value, 3);
+  EXPECT_FALSE(queue.TryPop(&value));
+  EXPECT_EQ(queue.size(), 0U);
+}
+
+TEST(SPSCQueueTests, Threaded) {
+  constexpr int kCount = 100000;
+  ::tvm::support::SPSCQueue<int> queue(16);
+  std::thread producer([&queue]() {
+    for (int i = 0; i < kCount; ++i) {
+      int value = i;
+      while (!queue.TryPush(&value)) std::this_thread::yield();
+    }
+  });
+  for (int i = 0; i < kCount; ++i) {
+    int value;
+    while (!queue.TryPop(&value)) std::this_thread::yield();
+    ASSERT_EQ(value, i);
+  }
+  producer.join();
+}
+
+TEST(RingBufferTests, PartialSend) {
+  ::tvm::support::RingBuffer buffer;
+  std::string sent;
+  // a channel taking at most 7 bytes per send
+  auto fsend = [&sent](const void* data, size_t size) {
+    size_t n = std::min<size_t>(size, 7);
+    sent.append(static_cast<const char*>(data), n);
+    return n;
+  };
+  std::string expected;
+  for (int i = 0; i < 2000; ++i) {
+    std::string chunk(i % 37 + 1, static_cast<char>('a' + i % 26));
+    buffer.Write(chunk.data(), chunk.size());
+    expected += chunk;
+    if (i % 3 == 0) buffer.ReadWithCallback(fsend, buffer.bytes_available());
+  }
+  while (buffer.bytes_available() != 0) {
+    buffer.ReadWithCallback(fsend, buffer.bytes_available());
+  }
+  EXPECT_EQ(sent, expected);
+}
+
 }  // namespace test
 }  // namespace tvm
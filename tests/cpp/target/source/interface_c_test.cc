@@ -19,17 +19,23 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <tvm/ir/expr.h>
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/module.h>
 
 using ::testing::HasSubstr;
+using ::testing::Not;
 
 namespace tvm {
 namespace codegen {
 
 runtime::Module InterfaceCCreate(std::string module_name, Array<String> inputs,
                                  Array<String> outputs, Array<String> devices, int workspace_size);
+runtime::Module InterfaceCCreate(std::string module_name, Array<String> inputs,
+                                 Array<String> outputs, Array<String> devices, int workspace_size,
+                                 Map<String, Integer> workspace_pool_sizes);
 
 namespace {
 
@@ -286,6 +292,40 @@ TEST(InterfaceAPI, ContainsWorkspaceSize) {
               HasSubstr("#define TVMGEN_ULTIMATE_CAT_SPOTTER_WORKSPACE_SIZE 765432"));
 }
 
+TEST(InterfaceAPI, ContainsWorkspacePools) {
+  std::stringstream workspace_pool;
+
+  workspace_pool << "/*!\n"
+                 << " * \\brief Size of the workspace pool \"sram\" for TVM module "
+                 << "\"ultimate_cat_spotter\"\n"
+                 << " */\n"
+                 << "#define TVMGEN_ULTIMATE_CAT_SPOTTER_SRAM_WORKSPACE_POOL_SIZE 2048\n\n"
+                 << "/*!\n"
+                 << " * \\brief Workspace pool \"sram\", shared by the TVM modules that never "
+                 << "run concurrently.\n"
+                 << " * Its size is the largest of their workspace pool sizes.\n"
+                 << " */\n"
+                 << "extern uint8_t tvmgen_sram[];\n";
+
+  runtime::Module test_module =
+      InterfaceCCreate("ultimate_cat_spotter", {"input"}, {"output"}, {}, 0,
+                       {{"sram", Integer(2048)}, {"dram", Integer(65536)}});
+  std::string header_source = test_module->GetSource();
+
+  ASSERT_THAT(header_source, HasSubstr(workspace_pool.str()));
+  ASSERT_THAT(header_source,
+              HasSubstr("#define TVMGEN_ULTIMATE_CAT_SPOTTER_DRAM_WORKSPACE_POOL_SIZE 65536"));
+  ASSERT_LT(header_source.find("tvmgen_dram"), header_source.find("tvmgen_sram"));
+}
+
+TEST(InterfaceAPI, NoWorkspacePoolsByDefault) {
+  runtime::Module test_module =
+      InterfaceCCreate("ultimate_cat_spotter", {"input"}, {"output"}, {}, 765432);
+  std::string header_source = test_module->GetSource();
+
+  ASSERT_THAT(header_source, Not(HasSubstr("WORKSPACE_POOL_SIZE")));
+}
+
 }  // namespace
 }  // namespace codegen
 }  // namespace tvm
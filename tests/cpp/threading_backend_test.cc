@@ -19,10 +19,15 @@
 
 #include <gtest/gtest.h>
 #include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 constexpr size_t N = 128;
 
@@ -63,3 +68,198 @@ TEST(ThreadingBackend, TVMBackendParallelLaunchMultipleThreads) {
     }
   }
 }
+
+struct ConcurrentTasks {
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+};
+
+static FTVMParallelLambda count_concurrent_tasks = [](int task_id, TVMParallelGroupEnv* penv,
+                                                      void* cdata) -> int {
+  auto* tasks = reinterpret_cast<ConcurrentTasks*>(cdata);
+  int running = tasks->running.fetch_add(1) + 1;
+  int max_running = tasks->max_running.load();
+  while (running > max_running && !tasks->max_running.compare_exchange_weak(max_running, running)) {
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  tasks->running.fetch_sub(1);
+  return 0;
+};
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchSharedBudget) {
+  // the pools of the threads share the workers instead of each using all of them
+  const int num_threads = 4;
+  ConcurrentTasks tasks;
+  std::atomic<int> num_pools(0);
+  std::vector<std::thread> ts;
+  for (int i = 0; i < num_threads; ++i) {
+    ts.emplace_back([&]() {
+      // create the pool of the thread, and wait for the other ones
+      std::atomic<size_t> acc(0);
+      EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 1), 0);
+      num_pools.fetch_add(1);
+      while (num_pools.load() != num_threads) {
+        std::this_thread::yield();
+      }
+      for (int j = 0; j < 8; ++j) {
+        EXPECT_EQ(TVMBackendParallelLaunch(count_concurrent_tasks, &tasks, 0), 0);
+      }
+    });
+  }
+  for (auto& t : ts) {
+    t.join();
+  }
+  // each launch runs at least on its calling thread, even when the budget is exhausted
+  int max_concurrency = tvm::runtime::threading::MaxConcurrency();
+  EXPECT_GE(max_concurrency, 1);
+  EXPECT_LE(tasks.max_running.load(), max_concurrency + num_threads - 1);
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchWorkStealing) {
+  const auto* config_threadpool = tvm::runtime::Registry::Get("runtime.config_threadpool");
+  ASSERT_NE(config_threadpool, nullptr);
+  // split the work of each worker into 4 stealable chunks
+  (*config_threadpool)(1, 0, 4);
+  for (int i = 0; i < 16; ++i) {
+    std::atomic<size_t> acc(0);
+    TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  (*config_threadpool)(1, 0, 0);
+  std::atomic<size_t> acc(0);
+  TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+  EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+}
+
+struct NestedLaunchData {
+  std::atomic<size_t> acc[2];
+};
+
+static FTVMParallelLambda nested_launch_task = [](int task_id, TVMParallelGroupEnv* penv,
+                                                  void* cdata) -> int {
+  auto* data = reinterpret_cast<NestedLaunchData*>(cdata);
+  EXPECT_GE(penv->thread_budget, 1);
+  return TVMBackendParallelLaunch(atomic_add_task_id, &data->acc[task_id], 0);
+};
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchNested) {
+  for (int i = 0; i < 16; ++i) {
+    NestedLaunchData data;
+    data.acc[0] = 0;
+    data.acc[1] = 0;
+    EXPECT_EQ(TVMBackendParallelLaunch(nested_launch_task, &data, 2), 0);
+    EXPECT_EQ(data.acc[0].load(std::memory_order_relaxed), N * (N - 1) / 2);
+    EXPECT_EQ(data.acc[1].load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchInRegion) {
+  const auto* config_threadpool = tvm::runtime::Registry::Get("runtime.config_threadpool");
+  ASSERT_NE(config_threadpool, nullptr);
+  {
+    tvm::runtime::threading::ParallelRegionScope region;
+    for (int i = 0; i < 64; ++i) {
+      std::atomic<size_t> acc(0);
+      EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+      EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+      // the workers of the region have no queue left for the nested launches
+      NestedLaunchData data;
+      data.acc[0] = 0;
+      data.acc[1] = 0;
+      EXPECT_EQ(TVMBackendParallelLaunch(nested_launch_task, &data, 2), 0);
+      EXPECT_EQ(data.acc[0].load(std::memory_order_relaxed), N * (N - 1) / 2);
+      EXPECT_EQ(data.acc[1].load(std::memory_order_relaxed), N * (N - 1) / 2);
+    }
+    // the regions inside a region have no effect
+    tvm::runtime::threading::ParallelRegionScope inner;
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  (*config_threadpool)(1, 0, 4);
+  {
+    tvm::runtime::threading::ParallelRegionScope region;
+    for (int i = 0; i < 16; ++i) {
+      std::atomic<size_t> acc(0);
+      EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+      EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+    }
+  }
+  (*config_threadpool)(1, 0, 0);
+  // the workers are back on their queues
+  std::atomic<size_t> acc(0);
+  EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+  EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchNumaNode) {
+  const auto* config_threadpool = tvm::runtime::Registry::Get("runtime.config_threadpool");
+  const auto* config_threadpool_numa =
+      tvm::runtime::Registry::Get("runtime.config_threadpool_numa");
+  ASSERT_NE(config_threadpool_numa, nullptr);
+  int num_nodes = tvm::runtime::threading::NumNumaNodes();
+  ASSERT_GE(num_nodes, 1);
+  for (int node = 0; node < num_nodes; ++node) {
+    (*config_threadpool_numa)(node, 0);
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  EXPECT_ANY_THROW((*config_threadpool_numa)(num_nodes, 0));
+  (*config_threadpool)(1, 0);
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchWeighted) {
+  const auto* calibrate = tvm::runtime::Registry::Get("runtime.calibrate_threadpool");
+  const auto* set_weights = tvm::runtime::Registry::Get("runtime.set_threadpool_weights");
+  ASSERT_NE(calibrate, nullptr);
+  ASSERT_NE(set_weights, nullptr);
+  std::string weights = (*calibrate)();
+  EXPECT_FALSE(weights.empty());
+  for (int i = 0; i < 16; ++i) {
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  // the cached weights are given back as is
+  (*set_weights)(weights);
+  std::atomic<size_t> acc(0);
+  EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+  EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  EXPECT_ANY_THROW((*set_weights)(weights + ",1"));
+  (*set_weights)("");
+}
+
+struct BarrierData {
+  std::atomic<size_t> acc{0};
+  std::atomic<int> num_before{0};
+  std::atomic<int> num_mismatch{0};
+};
+
+static FTVMParallelLambda barrier_task = [](int task_id, TVMParallelGroupEnv* penv,
+                                            void* cdata) -> int {
+  auto* data = reinterpret_cast<BarrierData*>(cdata);
+  data->num_before.fetch_add(1);
+  TVMBackendParallelBarrier(task_id, penv);
+  // every task has reached the barrier once it is passed
+  if (data->num_before.load() != penv->num_task) {
+    data->num_mismatch.fetch_add(1);
+  }
+  return atomic_add_task_id(task_id, penv, &data->acc);
+};
+
+TEST(ThreadingBackend, TVMBackendParallelBarrierWeighted) {
+  const auto* calibrate = tvm::runtime::Registry::Get("runtime.calibrate_threadpool");
+  const auto* set_weights = tvm::runtime::Registry::Get("runtime.set_threadpool_weights");
+  ASSERT_NE(calibrate, nullptr);
+  ASSERT_NE(set_weights, nullptr);
+  std::string weights = (*calibrate)();
+  // the kernels with barriers ask for one task per worker, the weights do not split them
+  for (int i = 0; i < 16; ++i) {
+    BarrierData data;
+    EXPECT_EQ(TVMBackendParallelLaunch(barrier_task, &data, -1), 0);
+    EXPECT_EQ(data.num_mismatch.load(), 0);
+    EXPECT_EQ(data.acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  (*set_weights)("");
+}
@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../../src/tir/schedule/trace_replay_cache.h"
+
+#include <gtest/gtest.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/te/operation.h>
+#include <tvm/tir/schedule/schedule.h>
+
+namespace {
+
+void MatmulModule(tvm::IRModule* mod) {
+  using namespace tvm;
+  te::Tensor a = te::placeholder({128, 128}, DataType::Float(32), "A");
+  te::Tensor b = te::placeholder({128, 128}, DataType::Float(32), "B");
+  tir::IterVar k = te::reduce_axis(Range(0, 128), "k");
+  te::Tensor c = te::compute(
+      {128, 128}, [&](tir::Var i, tir::Var j) { return sum(a(i, k) * b(k, j), {k}); }, "C");
+  const auto* create_prim_func = runtime::Registry::Get("te.CreatePrimFunc");
+  ASSERT_NE(create_prim_func, nullptr);
+  tir::PrimFunc func = (*create_prim_func)(Array<te::Tensor>{a, b, c});
+  *mod = IRModule({{GlobalVar("main"), func}});
+}
+
+// Tile the two spatial loops of the matmul, the decisions being sampled.
+tvm::tir::Trace TileMatmul(const tvm::IRModule& mod, int64_t seed) {
+  using namespace tvm;
+  tir::Schedule sch = tir::Schedule::Traced(mod, seed, /*debug_mask=*/0,
+                                            tir::ScheduleErrorRenderLevel::kDetail);
+  tir::BlockRV block = sch->GetBlock("C");
+  Array<tir::LoopRV> loops = sch->GetLoops(block);
+  for (int i = 0; i < 2; ++i) {
+    Array<tir::ExprRV> factors = sch->SamplePerfectTile(loops[i], 2, 16);
+    sch->Split(loops[i], {factors[0], factors[1]});
+  }
+  return sch->trace().value();
+}
+
+}  // namespace
+
+TEST(TraceReplayCache, SameAsApplyToSchedule) {
+  using namespace tvm;
+  IRModule mod;
+  ASSERT_NO_FATAL_FAILURE(MatmulModule(&mod));
+  tir::TraceReplayCache cache(mod);
+  for (int64_t seed = 1; seed <= 8; ++seed) {
+    tir::Trace trace = TileMatmul(mod, seed);
+    tir::Schedule expected = tir::Schedule::Traced(mod, seed, /*debug_mask=*/0,
+                                                   tir::ScheduleErrorRenderLevel::kDetail);
+    trace->ApplyToSchedule(expected, /*remove_postproc=*/true);
+    tir::Schedule sch = cache.Replay(trace, seed, /*remove_postproc=*/true);
+    EXPECT_TRUE(StructuralEqual()(sch->mod(), expected->mod()));
+    EXPECT_EQ(sch->trace().value()->insts.size(), trace->insts.size());
+  }
+  // The traces share the prefix before the first sampling instruction.
+  EXPECT_GT(cache.num_hits(), 0);
+}
+
+TEST(TraceReplayCache, ResumeAfterDecision) {
+  using namespace tvm;
+  IRModule mod;
+  ASSERT_NO_FATAL_FAILURE(MatmulModule(&mod));
+  tir::TraceReplayCache cache(mod);
+  tir::Trace trace = TileMatmul(mod, /*seed=*/1);
+  // Only change the decision of the second tiling, so that the first one is a shared prefix.
+  tir::Instruction second_tile = trace->insts[4];
+  ASSERT_EQ(second_tile->kind->name, "SamplePerfectTile");
+  for (int64_t factor : {1, 2, 4, 8, 16}) {
+    tir::Trace mutated = trace->WithDecision(
+        second_tile, Array<Integer>{Integer(128 / factor), Integer(factor)},
+        /*remove_postproc=*/true);
+    tir::Schedule expected = tir::Schedule::Traced(mod, /*seed=*/1, /*debug_mask=*/0,
+                                                   tir::ScheduleErrorRenderLevel::kDetail);
+    mutated->ApplyToSchedule(expected, /*remove_postproc=*/true);
+    tir::Schedule sch = cache.Replay(mutated, /*seed=*/1, /*remove_postproc=*/true);
+    EXPECT_TRUE(StructuralEqual()(sch->mod(), expected->mod()));
+  }
+  // The snapshot before the second tiling is taken on the second replay, and used afterwards.
+  EXPECT_GE(cache.num_hits(), 3);
+  cache.Clear();
+  tir::Schedule sch = cache.Replay(trace, /*seed=*/1, /*remove_postproc=*/true);
+  EXPECT_TRUE(sch->trace().defined());
+}
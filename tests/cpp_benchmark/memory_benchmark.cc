@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file memory_benchmark.cc
+ * \brief Benchmarks of the workspace pool, the VM pooled allocator and the NDArray copies.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/ndarray.h>
+
+#include "../../src/runtime/vm/pooled_allocator.h"
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+constexpr int kDTypeCodeFloat = 2;
+
+// The argument of the memory benchmarks is the size in bytes.
+void WorkspaceAllocFree(benchmark::State& state) {
+  uint64_t nbytes = state.range(0);
+  for (auto _ : state) {
+    void* ptr = TVMBackendAllocWorkspace(kDLCPU, 0, nbytes, kDTypeCodeFloat, 32);
+    benchmark::DoNotOptimize(ptr);
+    TVMBackendFreeWorkspace(kDLCPU, 0, ptr);
+  }
+}
+BENCHMARK(WorkspaceAllocFree)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+// The nested allocations of an operator with several intermediate buffers.
+void WorkspaceAllocFreeNested(benchmark::State& state) {
+  uint64_t nbytes = state.range(0);
+  void* ptrs[4];
+  for (auto _ : state) {
+    for (int i = 0; i < 4; ++i) {
+      ptrs[i] = TVMBackendAllocWorkspace(kDLCPU, 0, nbytes, kDTypeCodeFloat, 32);
+    }
+    for (int i = 3; i >= 0; --i) {
+      TVMBackendFreeWorkspace(kDLCPU, 0, ptrs[i]);
+    }
+  }
+}
+BENCHMARK(WorkspaceAllocFreeNested)->Arg(1 << 12);
+
+void PooledAllocatorAllocFree(benchmark::State& state) {
+  vm::PooledAllocator alloc({kDLCPU, 0});
+  size_t nbytes = state.range(0);
+  for (auto _ : state) {
+    vm::Buffer buffer = alloc.Alloc(nbytes, 64, DataType::Float(32));
+    benchmark::DoNotOptimize(buffer.data);
+    alloc.Free(buffer);
+  }
+}
+BENCHMARK(PooledAllocatorAllocFree)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+void NDArrayEmpty(benchmark::State& state) {
+  int64_t num = state.range(0) / 4;
+  for (auto _ : state) {
+    NDArray arr = NDArray::Empty({num}, DataType::Float(32), {kDLCPU, 0});
+    benchmark::DoNotOptimize(arr);
+  }
+}
+BENCHMARK(NDArrayEmpty)->Arg(1 << 12);
+
+void NDArrayCopyFrom(benchmark::State& state) {
+  int64_t num = state.range(0) / 4;
+  NDArray src = NDArray::Empty({num}, DataType::Float(32), {kDLCPU, 0});
+  NDArray dst = NDArray::Empty({num}, DataType::Float(32), {kDLCPU, 0});
+  for (auto _ : state) {
+    dst.CopyFrom(src);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(NDArrayCopyFrom)->RangeMultiplier(32)->Range(1 << 10, 1 << 25);
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
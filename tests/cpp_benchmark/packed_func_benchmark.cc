@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file packed_func_benchmark.cc
+ * \brief Benchmarks of the PackedFunc calling convention.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+TVM_REGISTER_GLOBAL("cppbench.nop").set_body([](TVMArgs args, TVMRetValue* rv) {});
+
+void PackedFuncNoArgs(benchmark::State& state) {
+  PackedFunc f([](TVMArgs args, TVMRetValue* rv) {});
+  for (auto _ : state) {
+    f();
+  }
+}
+BENCHMARK(PackedFuncNoArgs);
+
+void PackedFuncIntArgs(benchmark::State& state) {
+  PackedFunc f([](TVMArgs args, TVMRetValue* rv) {
+    *rv = args[0].operator int() + args[1].operator int() + args[2].operator int();
+  });
+  int64_t sum = 0;
+  for (auto _ : state) {
+    sum += f(1, 2, 3).operator int();
+  }
+  benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(PackedFuncIntArgs);
+
+void PackedFuncNDArrayArg(benchmark::State& state) {
+  PackedFunc f([](TVMArgs args, TVMRetValue* rv) { *rv = args[0].operator NDArray(); });
+  NDArray arr = NDArray::Empty({1}, DataType::Float(32), {kDLCPU, 0});
+  for (auto _ : state) {
+    NDArray ret = f(arr);
+    benchmark::DoNotOptimize(ret);
+  }
+}
+BENCHMARK(PackedFuncNDArrayArg);
+
+void TypedPackedFuncCall(benchmark::State& state) {
+  TypedPackedFunc<int(int, int)> f([](int a, int b) { return a + b; });
+  int64_t sum = 0;
+  for (auto _ : state) {
+    sum += f(1, 2);
+  }
+  benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(TypedPackedFuncCall);
+
+// The calls made by the generated code and the language bindings.
+void TVMFuncCallGlobal(benchmark::State& state) {
+  TVMFunctionHandle handle;
+  TVMFuncGetGlobal("cppbench.nop", &handle);
+  TVMValue args[1];
+  int type_codes[1];
+  TVMValue ret;
+  int ret_type_code;
+  for (auto _ : state) {
+    TVMFuncCall(handle, args, type_codes, 0, &ret, &ret_type_code);
+  }
+}
+BENCHMARK(TVMFuncCallGlobal);
+
+void RegistryGet(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Registry::Get("cppbench.nop"));
+  }
+}
+BENCHMARK(RegistryGet);
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
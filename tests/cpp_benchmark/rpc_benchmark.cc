@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rpc_benchmark.cc
+ * \brief Benchmarks of the round trips of an RPC session with a server in the same process.
+ */
+#include <benchmark/benchmark.h>
+#include <sys/socket.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../../src/runtime/rpc/rpc_endpoint.h"
+#include "../../src/runtime/rpc/rpc_session.h"
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+// One end of a unix socket pair, so that the benchmarks do not depend on the network.
+class SocketPairChannel final : public RPCChannel {
+ public:
+  explicit SocketPairChannel(int fd) : fd_(fd) {}
+  ~SocketPairChannel() { close(fd_); }
+  size_t Send(const void* data, size_t size) final {
+    ssize_t n = write(fd_, data, size);
+    ICHECK_GE(n, 0) << "SocketPairChannel: write failed";
+    return static_cast<size_t>(n);
+  }
+  size_t Recv(void* data, size_t size) final {
+    ssize_t n = read(fd_, data, size);
+    ICHECK_GE(n, 0) << "SocketPairChannel: read failed";
+    return static_cast<size_t>(n);
+  }
+
+ private:
+  int fd_;
+};
+
+// The session is shared by the benchmarks and never closed, its server thread blocking in
+// its loop until the process exits.
+Module LoopbackSession() {
+  static Module session = []() {
+    int fds[2];
+    ICHECK_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    std::thread([fd = fds[1]]() {
+      RPCEndpoint::Create(std::unique_ptr<RPCChannel>(new SocketPairChannel(fd)), "server", "")
+          ->ServerLoop();
+    }).detach();
+    auto endpt = RPCEndpoint::Create(std::unique_ptr<RPCChannel>(new SocketPairChannel(fds[0])),
+                                     "client", "loopback");
+    endpt->InitRemoteSession(TVMArgs(nullptr, nullptr, 0));
+    return CreateRPCSessionModule(CreateClientSession(endpt));
+  }();
+  return session;
+}
+
+TVM_REGISTER_GLOBAL("cppbench.rpc_nop").set_body([](TVMArgs args, TVMRetValue* rv) {});
+
+void RPCRoundTrip(benchmark::State& state) {
+  PackedFunc nop = LoopbackSession().GetFunction("cppbench.rpc_nop");
+  for (auto _ : state) {
+    nop();
+  }
+}
+BENCHMARK(RPCRoundTrip)->UseRealTime();
+
+// The argument is the size in bytes of the argument sent with each call.
+void RPCRoundTripBytes(benchmark::State& state) {
+  PackedFunc nop = LoopbackSession().GetFunction("cppbench.rpc_nop");
+  std::string data(state.range(0), 'x');
+  TVMByteArray arr{data.data(), data.size()};
+  for (auto _ : state) {
+    nop(arr);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(RPCRoundTripBytes)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->UseRealTime();
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,55 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file threading_benchmark.cc
+ * \brief Benchmarks of the fork and join of the runtime thread pool.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/c_backend_api.h>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+int NopTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) { return 0; }
+
+int BarrierTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  return TVMBackendParallelBarrier(task_id, penv);
+}
+
+// The argument is the number of tasks, 0 for one per worker.
+void ParallelLaunch(benchmark::State& state) {
+  int num_task = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    TVMBackendParallelLaunch(NopTask, nullptr, num_task);
+  }
+}
+BENCHMARK(ParallelLaunch)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+
+void ParallelBarrier(benchmark::State& state) {
+  for (auto _ : state) {
+    TVMBackendParallelLaunch(BarrierTask, nullptr, 0);
+  }
+}
+BENCHMARK(ParallelBarrier)->UseRealTime();
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
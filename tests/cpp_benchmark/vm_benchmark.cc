@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file vm_benchmark.cc
+ * \brief Benchmarks of the invocation and the instruction dispatch of the Relay VM.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/vm/executable.h>
+#include <tvm/runtime/vm/vm.h>
+
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+namespace {
+
+/*!
+ * \brief Make a VM running a function of the given number of moves between two registers,
+ *  which needs neither kernels nor allocations.
+ */
+Module MakeMovesVM(int num_moves, ObjectPtr<Executable>* exec) {
+  std::vector<Instruction> instructions = {Instruction::LoadConsti(1, 0)};
+  for (int i = 0; i < num_moves; ++i) {
+    instructions.push_back(Instruction::Move(i % 2, 1 - i % 2));
+  }
+  instructions.push_back(Instruction::Ret(num_moves % 2));
+  *exec = make_object<Executable>();
+  (*exec)->virtual_devices = {{kDLCPU, 0}};
+  (*exec)->host_device_index = 0;
+  (*exec)->functions.push_back(VMFunction("main", {}, instructions, 2, {}));
+  (*exec)->global_map["main"] = 0;
+  auto vm = make_object<VirtualMachine>();
+  vm->LoadExecutable(exec->get());
+  vm->GetFunction("init", vm)(static_cast<int>(kDLCPU), 0, static_cast<int>(kPooled));
+  return Module(vm);
+}
+
+void VMInvoke(benchmark::State& state) {
+  ObjectPtr<Executable> exec;
+  Module vm = MakeMovesVM(0, &exec);
+  PackedFunc invoke = vm.GetFunction("invoke");
+  for (auto _ : state) {
+    invoke("main");
+  }
+}
+BENCHMARK(VMInvoke);
+
+// The items are the dispatched instructions.
+void VMRunLoopDispatch(benchmark::State& state) {
+  constexpr int kNumMoves = 1024;
+  ObjectPtr<Executable> exec;
+  Module vm = MakeMovesVM(kNumMoves, &exec);
+  PackedFunc invoke = vm.GetFunction("invoke");
+  for (auto _ : state) {
+    invoke("main");
+  }
+  state.SetItemsProcessed(state.iterations() * (kNumMoves + 2));
+}
+BENCHMARK(VMRunLoopDispatch);
+
+}  // namespace
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
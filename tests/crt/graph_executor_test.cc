@@ -21,6 +21,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "../../src/runtime/crt/include/tvm/runtime/crt/internal/graph_executor/load_json.h"
 
 namespace {
@@ -112,4 +114,53 @@ TEST(TVMGraphExecutor_Load, Parse) {
   EXPECT_EQ(executor.nodes_count, 3);
 }
 
+int FakeOpCall(TVMPackedFunc* pf) { return 0; }
+
+// Check the profiler keeps the last TVM_CRT_PROFILER_RING_SIZE operator runs, oldest first.
+TEST(TVMGraphExecutor_Profile, Ring) {
+  TVMGraphExecutor executor;
+  memset(&executor, 0, sizeof(executor));
+  TVMPackedFunc op_execs[3];
+  memset(op_execs, 0, sizeof(op_execs));
+  // node 0 is not an operator and is not recorded
+  for (int i = 1; i < 3; ++i) {
+    op_execs[i].fexec = reinterpret_cast<TVMFunctionHandle>(1);
+    op_execs[i].Call = &FakeOpCall;
+  }
+  executor.op_execs = op_execs;
+  executor.op_execs_count = 3;
+
+  constexpr int kNumRuns = TVM_CRT_PROFILER_RING_SIZE;
+  TVMGraphExecutor_Run(&executor);
+  ASSERT_EQ(TVMGraphExecutor_SetProfiling(&executor, 1), 0);
+  for (int i = 0; i < kNumRuns; ++i) {
+    TVMGraphExecutor_Run(&executor);
+  }
+  ASSERT_EQ(TVMGraphExecutor_SetProfiling(&executor, 0), 0);
+  TVMGraphExecutor_Run(&executor);
+
+  std::vector<int64_t> data(2 * (TVM_CRT_PROFILER_RING_SIZE + 1));
+  int64_t shape[2] = {TVM_CRT_PROFILER_RING_SIZE + 1, 2};
+  DLTensor out = {data.data(), {kDLCPU, 0}, 2, {kDLInt, 64, 1}, shape, nullptr, 0};
+  ASSERT_EQ(TVMGraphExecutor_GetProfile(&executor, &out), TVM_CRT_PROFILER_RING_SIZE);
+  for (int i = 0; i < TVM_CRT_PROFILER_RING_SIZE; ++i) {
+    EXPECT_EQ(data[2 * i], 1 + i % 2);
+    EXPECT_EQ(data[2 * i + 1], 10);
+  }
+
+  // a smaller output gets the last records
+  shape[0] = 3;
+  ASSERT_EQ(TVMGraphExecutor_GetProfile(&executor, &out), 3);
+  EXPECT_EQ(data[0], 2);
+  EXPECT_EQ(data[2], 1);
+  EXPECT_EQ(data[4], 2);
+
+  // enabling the profiler again clears the records
+  ASSERT_EQ(TVMGraphExecutor_SetProfiling(&executor, 1), 0);
+  EXPECT_EQ(TVMGraphExecutor_GetProfile(&executor, &out), 0);
+
+  shape[1] = 3;
+  EXPECT_LT(TVMGraphExecutor_GetProfile(&executor, &out), 0);
+}
+
 }  // namespace
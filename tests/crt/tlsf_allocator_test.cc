@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/crt/internal/memory/tlsf_allocator.h>
+#include <tvm/runtime/crt/tlsf_allocator.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "crt_config.h"
+
+static constexpr const size_t kMemoryPoolSizeBytes = 64 * 1024;
+
+class TLSFAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memset(memory_pool, 0, sizeof(memory_pool));
+    ASSERT_EQ(TLSFMemoryManagerCreate(&interface, memory_pool, kMemoryPoolSizeBytes),
+              kTvmErrorNoError);
+    mgr = reinterpret_cast<TLSFMemoryManager*>(interface);
+    dev_ = {kDLCPU, 0};
+  }
+
+  /*! \brief The size of the single free block of the pool when nothing is allocated. */
+  size_t FreePoolSize() {
+    return reinterpret_cast<uint8_t*>(mgr->last_block) -
+           reinterpret_cast<uint8_t*>(mgr->first_block) - TLSF_BLOCK_OVERHEAD;
+  }
+
+  /*! \brief Check that the pool has a single free block, all the freed blocks were merged. */
+  void ExpectSingleFreeBlock() {
+    EXPECT_EQ(interface->vleak_size, 0);
+    int fl, sl;
+    TLSFMappingInsert(FreePoolSize(), &fl, &sl);
+    EXPECT_EQ(mgr->fl_bitmap, 1U << fl);
+    EXPECT_EQ(mgr->sl_bitmap[fl], 1U << sl);
+    EXPECT_EQ(mgr->blocks[fl][sl], mgr->first_block);
+    EXPECT_EQ(mgr->first_block->next_free, nullptr);
+  }
+
+  alignas(TLSF_ALIGNMENT_BYTES) uint8_t memory_pool[kMemoryPoolSizeBytes];
+  MemoryManagerInterface* interface;
+  TLSFMemoryManager* mgr;
+  DLDevice dev_;
+};
+
+TEST_F(TLSFAllocatorTest, Mapping) {
+  int fl, sl;
+  TLSFMappingInsert(TLSF_ALIGNMENT_BYTES, &fl, &sl);
+  EXPECT_EQ(fl, 0);
+  EXPECT_EQ(sl, 1);
+  TLSFMappingInsert(TLSF_SMALL_BLOCK_SIZE, &fl, &sl);
+  EXPECT_EQ(fl, 1);
+  EXPECT_EQ(sl, 0);
+  TLSFMappingInsert(TLSF_SMALL_BLOCK_SIZE * 2 - TLSF_ALIGNMENT_BYTES, &fl, &sl);
+  EXPECT_EQ(fl, 1);
+  EXPECT_EQ(sl, TLSF_SL_COUNT - 1);
+  TLSFMappingInsert(TLSF_SMALL_BLOCK_SIZE * 3, &fl, &sl);
+  EXPECT_EQ(fl, 2);
+  EXPECT_EQ(sl, TLSF_SL_COUNT / 2);
+}
+
+TEST_F(TLSFAllocatorTest, AllocFree) {
+  ExpectSingleFreeBlock();
+  void* a;
+  void* b;
+  EXPECT_EQ(interface->Allocate(interface, 1, dev_, &a), kTvmErrorNoError);
+  EXPECT_EQ(interface->Allocate(interface, 100, dev_, &b), kTvmErrorNoError);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % TLSF_ALIGNMENT_BYTES, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % TLSF_ALIGNMENT_BYTES, 0);
+  EXPECT_EQ(static_cast<uint8_t*>(b),
+            static_cast<uint8_t*>(a) + TLSF_MIN_BLOCK_SIZE + TLSF_BLOCK_OVERHEAD);
+  EXPECT_EQ(interface->vleak_size, 2);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, b, dev_), kTvmErrorNoError);
+  ExpectSingleFreeBlock();
+}
+
+TEST_F(TLSFAllocatorTest, BadFree) {
+  void* a;
+  EXPECT_EQ(interface->Allocate(interface, 64, dev_, &a), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, static_cast<uint8_t*>(a) + 1, dev_),
+            kTvmErrorPlatformMemoryManagerBadFree);
+  EXPECT_EQ(interface->Free(interface, memory_pool, dev_), kTvmErrorPlatformMemoryManagerBadFree);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorPlatformMemoryManagerBadFree);
+  ExpectSingleFreeBlock();
+}
+
+TEST_F(TLSFAllocatorTest, NoMemory) {
+  void* a;
+  EXPECT_EQ(interface->Allocate(interface, kMemoryPoolSizeBytes, dev_, &a),
+            kTvmErrorPlatformNoMemory);
+  EXPECT_EQ(a, nullptr);
+  EXPECT_EQ(interface->Allocate(interface, TLSF_MAX_BLOCK_SIZE, dev_, &a),
+            kTvmErrorPlatformNoMemory);
+  // The largest power of two fitting the pool, the good fit search rounds larger sizes up.
+  size_t size = size_t(1) << (31 - __builtin_clz(static_cast<uint32_t>(FreePoolSize())));
+  EXPECT_EQ(interface->Allocate(interface, size, dev_, &a), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+  ExpectSingleFreeBlock();
+}
+
+TEST_F(TLSFAllocatorTest, FreeMergesNeighbours) {
+  void* ptrs[3];
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(interface->Allocate(interface, 1024, dev_, &ptrs[i]), kTvmErrorNoError);
+  }
+  // Free the middle block last, merging it with both of its neighbours.
+  EXPECT_EQ(interface->Free(interface, ptrs[0], dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, ptrs[2], dev_), kTvmErrorNoError);
+  void* a;
+  EXPECT_EQ(interface->Allocate(interface, 1024, dev_, &a), kTvmErrorNoError);
+  EXPECT_EQ(a, ptrs[0]);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorNoError);
+  EXPECT_EQ(interface->Free(interface, ptrs[1], dev_), kTvmErrorNoError);
+  ExpectSingleFreeBlock();
+}
+
+TEST_F(TLSFAllocatorTest, RandomChurn) {
+  std::mt19937 rng(42);
+  std::vector<std::pair<uint8_t*, size_t>> live;
+  for (int step = 0; step < 20000; step++) {
+    if (live.empty() || rng() % 3 != 0) {
+      size_t size = 1 + rng() % (rng() % 8 == 0 ? 4096 : 256);
+      void* ptr;
+      if (interface->Allocate(interface, size, dev_, &ptr) != kTvmErrorNoError) {
+        continue;
+      }
+      uint8_t* data = static_cast<uint8_t*>(ptr);
+      ASSERT_GE(data, memory_pool);
+      ASSERT_LE(data + size, memory_pool + kMemoryPoolSizeBytes);
+      for (const auto& other : live) {
+        ASSERT_TRUE(data + size <= other.first || other.first + other.second <= data);
+      }
+      memset(data, step & 0xff, size);
+      live.emplace_back(data, size);
+    } else {
+      size_t index = rng() % live.size();
+      std::swap(live[index], live.back());
+      ASSERT_EQ(interface->Free(interface, live.back().first, dev_), kTvmErrorNoError);
+      live.pop_back();
+    }
+    ASSERT_EQ(static_cast<size_t>(interface->vleak_size), live.size());
+  }
+  for (const auto& block : live) {
+    ASSERT_EQ(interface->Free(interface, block.first, dev_), kTvmErrorNoError);
+  }
+  ExpectSingleFreeBlock();
+}
@@ -65,7 +65,20 @@ def test_dtype():
     assert dtype.type_code == tvm.DataTypeCode.HANDLE
 
 
+def test_slice():
+    x = np.arange(24, dtype="float32").reshape(4, 6)
+    arr = tvm.nd.array(x)
+    # a slice of the outer axis is compact, an inner one strided
+    np.testing.assert_equal(arr.slice(0, 1, 3).numpy(), x[1:3])
+    np.testing.assert_equal(arr.slice(1, 2, 5).numpy(), x[:, 2:5])
+    view = arr.slice(1, 1, 3)
+    view.copyfrom(np.zeros((4, 2), dtype="float32"))
+    x[:, 1:3] = 0
+    np.testing.assert_equal(arr.numpy(), x)
+
+
 if __name__ == "__main__":
     test_nd_create()
     test_fp16_conversion()
     test_dtype()
+    test_slice()
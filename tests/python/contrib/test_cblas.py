@@ -234,6 +234,11 @@ def test_batch_matmul():
     verify_batch_matmul(1, 1, 1, 16, 3, mkl, False, False)
     verify_batch_matmul(1, 1, 1, 16, 3, mkl, True, True)
     verify_batch_matmul(1, 1, 1, 16, 3, mkl, iterative=True)
+    # many small gemms, as in the attention heads, are run in parallel
+    verify_batch_matmul(64, 64, 32, 64, 32, cblas)
+    verify_batch_matmul(64, 1, 32, 64, 32, cblas, True, True)
+    verify_batch_matmul(1, 64, 32, 64, 32, cblas, dtype="float64")
+    verify_batch_matmul(64, 64, 32, 64, 32, mkl)
 
 
 if __name__ == "__main__":
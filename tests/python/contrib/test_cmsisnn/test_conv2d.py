@@ -26,6 +26,7 @@ from tvm.relay.op.contrib import cmsisnn
 
 from tests.python.relay.aot.aot_test_utils import (
     AOTTestModel,
+    AOTTestRunner,
     AOT_CORSTONE300_RUNNER,
     AOT_DEFAULT_RUNNER,
     generate_ref_data,
@@ -347,6 +348,68 @@ def test_depthwise_int8(
     )
 
 
+@skip_if_no_reference_system
+@tvm.testing.requires_cmsisnn
+@pytest.mark.parametrize("mcpu", ["cortex-m55", "cortex-m4", ""])
+def test_conv2d_int8_usmp(mcpu):
+    """The scratch of the CMSIS-NN operators is planned in the workspace pool"""
+    ifm_shape = (1, 28, 28, 12)
+    kernel_shape = (3, 3, 12, 3)
+    dtype = "int8"
+    input_zero_point = 10
+    input_scale = 0.0128
+    kernel_scale = [0.11, 0.22, 0.33]
+    in_min, in_max = get_range_for_dtype_str(dtype)
+    output_scale, output_zero_point = get_conv2d_qnn_params(
+        kernel_shape, input_scale, input_zero_point, kernel_scale, 0, dtype, dtype, dtype
+    )
+    model, params = make_model(
+        ifm_shape,
+        kernel_shape,
+        input_zero_point,
+        input_scale,
+        0,
+        kernel_scale,
+        output_zero_point,
+        output_scale,
+        "SAME",
+        (1, 1),
+        (1, 1),
+        1,
+        dtype,
+        dtype,
+        3,
+        "HWIO",
+        True,
+        "RELU",
+    )
+    orig_mod = make_module(model)
+    cmsisnn_mod = cmsisnn.partition_for_cmsisnn(orig_mod, params)
+
+    test_runner = AOTTestRunner(
+        makefile=AOT_CORSTONE300_RUNNER.makefile,
+        prologue=AOT_CORSTONE300_RUNNER.prologue,
+        includes=AOT_CORSTONE300_RUNNER.includes,
+        parameters=AOT_CORSTONE300_RUNNER.parameters,
+        pass_config={"tir.usmp.enable": True, "relay.ext.cmsisnn.options": {"mcpu": mcpu}},
+    )
+    rng = np.random.default_rng(12345)
+    inputs = {"input": rng.integers(in_min, high=in_max, size=ifm_shape, dtype=dtype)}
+    output_list = generate_ref_data(orig_mod["main"], inputs, params)
+    compile_and_run(
+        AOTTestModel(
+            module=cmsisnn_mod,
+            inputs=inputs,
+            outputs=output_list,
+            params=params,
+            output_tolerance=1,
+        ),
+        test_runner,
+        "c",
+        True,
+    )
+
+
 def parameterize_for_invalid_model(test):
     in_dtype = ["uint8", "int8"]
     kernel_dtype = ["uint8", "int8"]
@@ -126,6 +126,23 @@ def get_conv2d_nchw(d_shape, w_shape):
     )
 
 
+def get_conv2d_nchw_bias(d_shape, w_shape):
+    conv2d = get_conv2d_nchw(d_shape, w_shape)["main"].body
+    bias = relay.var("bias", shape=(w_shape[0],), dtype="float16")
+    return tvm.IRModule.from_expr(relay.nn.bias_add(conv2d, bias))
+
+
+def get_conv2d_nchw_bias_relu(d_shape, w_shape):
+    conv2d_bias = get_conv2d_nchw_bias(d_shape, w_shape)["main"].body
+    return tvm.IRModule.from_expr(relay.nn.relu(conv2d_bias))
+
+
+def get_conv2d_nchw_residual_add_relu(d_shape, w_shape):
+    conv2d = get_conv2d_nchw(d_shape, w_shape)["main"].body
+    data = conv2d.args[0]
+    return tvm.IRModule.from_expr(relay.nn.relu(conv2d + data))
+
+
 def profile_and_build(mod, params, sm, tmp_dir="./tmp", lib_path="compile.so"):
     mod = partition_for_cutlass(mod)
     mod, num_cutlass_partition = tune_cutlass_kernels(
@@ -326,8 +343,9 @@ def verify_conv2d(
 
     np_data = np.random.uniform(-1, 1, d_shape).astype("float16")
     np_weight = np.random.uniform(-1, 1, w_shape).astype("float16")
+    np_bias = np.random.uniform(-1, 1, (w_shape[0],)).astype("float16")
 
-    params = {"weight": np_weight}
+    params = {"weight": np_weight, "bias": np_bias}
 
     typ = relay.transform.InferType()(mod_nchw)["main"].body.checked_type
     use_vm = any(isinstance(s, tvm.tir.Any) for s in typ.shape)
@@ -385,5 +403,23 @@ def test_conv2d():
     )
 
 
+def test_conv2d_fusion():
+    d_shape = (16, 16, 32, 32)
+    w_shape = (32, 16, 3, 3)
+    mod_nchw = get_conv2d_nchw_bias(d_shape, w_shape)
+    verify_conv2d(mod_nchw, mod_nchw, d_shape, w_shape, sm=80, atol=1e-5, rtol=1e-5)
+
+    mod_nchw = get_conv2d_nchw_bias_relu(d_shape, w_shape)
+    verify_conv2d(mod_nchw, mod_nchw, d_shape, w_shape, sm=80, atol=1e-5, rtol=1e-5)
+
+    w_shape = (16, 16, 3, 3)
+    mod_nchw = get_conv2d_nchw_residual_add_relu(d_shape, w_shape)
+    verify_conv2d(mod_nchw, mod_nchw, d_shape, w_shape, sm=80, atol=1e-5, rtol=1e-5)
+
+    dyn_batch_shape = (relay.Any(),) + d_shape[1:]
+    mod_dyn = get_conv2d_nchw_residual_add_relu(dyn_batch_shape, w_shape)
+    verify_conv2d(mod_dyn, mod_nchw, d_shape, w_shape, sm=80, atol=1e-5, rtol=1e-5)
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -899,6 +899,46 @@ def test_assign_addresses():
         assert np.prod(constant_tensor_read_mask) == 1
 
 
+
+def test_double_buffer_constants():
+    tir_mod = WeightStreamOnly
+    tir_mod["main"] = tir_mod["main"].with_attr("target", tvm.target.Target("ethos-u"))
+    tir_mod = tvm.tir.transform.MakeUnpackedAPI()(tir_mod)
+    param_dict = dict()
+    for idx in range(2, 10):
+        size = 144 if idx % 2 == 0 else 20
+        param_dict[idx] = np.random.randint(0, 255, [size], "uint8")
+    buffer_info = tir_to_cs_translator.extract_buffer_info(tir_mod, param_dict)
+    _npu_ops = list()
+    for extern_call in tir_to_cs_translator.extract_call_extern_list(tir_mod):
+        _npu_ops.append(tir_to_cs_translator.translate_ethosu_tir_call_extern(extern_call))
+    _npu_ops, _, scratch_size = tir_to_cs_translator.assign_addresses(
+        buffer_info, _npu_ops, double_buffer_constants=True
+    )
+    # Two slots for each of the weights and the biases
+    assert scratch_size == 2 * 144 + 2 * 32
+
+    conv2d_ops = [op for op in _npu_ops if isinstance(op, vapi.NpuConv2DOperation)]
+    weight_addresses = [op.weights[0].address for op in conv2d_ops]
+    bias_addresses = [op.biases[0].address for op in conv2d_ops]
+    assert weight_addresses[0] != weight_addresses[1]
+    assert weight_addresses[0::2] == [weight_addresses[0]] * 2
+    assert weight_addresses[1::2] == [weight_addresses[1]] * 2
+    assert bias_addresses[0] != bias_addresses[1]
+
+    # The copies for each convolution are issued before the previous convolution
+    _npu_ops = tir_to_cs_translator.prefetch_constants(_npu_ops)
+    op_kinds = ["dma" if isinstance(op, vapi.NpuDmaOperation) else "conv" for op in _npu_ops]
+    assert op_kinds == ["dma"] * 4 + (["conv"] + ["dma"] * 2) * 2 + ["conv"] * 2
+    latest_copies = list()
+    for npu_op in _npu_ops:
+        if isinstance(npu_op, vapi.NpuDmaOperation):
+            latest_copies = (latest_copies + [npu_op.dest.address])[-4:]
+        else:
+            assert npu_op.weights[0].address in latest_copies
+            assert npu_op.biases[0].address in latest_copies
+
+
 # fmt: off
 """A ethosu_pooling tir testcase for the translator"""
 @tvm.script.ir_module
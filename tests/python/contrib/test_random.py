@@ -96,6 +96,39 @@ def test_normal():
     verify()
 
 
+def test_seed():
+    if not tvm.get_global_func("tvm.contrib.random.seed", True):
+        print("skip because extern function is not available")
+        return
+    m = 1024
+    n = 1024
+    A = random.uniform(0, 1, size=(m, n))
+    B = random.normal(0, 1, size=(m, n))
+    f = tvm.build(te.create_schedule([A.op, B.op]), [A, B], "llvm")
+    config_threadpool = tvm.get_global_func("runtime.config_threadpool")
+    dev = tvm.cpu(0)
+
+    def run(seed, num_threads):
+        config_threadpool(0, num_threads)
+        random.seed(seed)
+        a = tvm.nd.array(np.zeros((m, n), dtype=A.dtype), dev)
+        b = tvm.nd.array(np.zeros((m, n), dtype=B.dtype), dev)
+        f(a, b)
+        return a.numpy(), b.numpy()
+
+    try:
+        a0, b0 = run(7, 1)
+        a1, b1 = run(7, 4)
+        a2, _ = run(8, 4)
+    finally:
+        config_threadpool(0, 0)
+    # the samples only depend on the seed, whatever the number of threads
+    np.testing.assert_array_equal(a0, a1)
+    np.testing.assert_array_equal(b0, b1)
+    assert not np.array_equal(a0, a2)
+    assert not np.array_equal(a0, b0)
+
+
 @tvm.testing.uses_gpu
 def test_random_fill():
     def test_local(dev, dtype):
@@ -159,4 +192,5 @@ if __name__ == "__main__":
     test_randint()
     test_uniform()
     test_normal()
+    test_seed()
     test_random_fill()
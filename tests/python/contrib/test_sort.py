@@ -91,6 +91,52 @@ def test_sort_np():
     tvm.testing.assert_allclose(c.numpy(), np_out, rtol=1e-5)
 
 
+def test_sort_large_rows():
+    # a long row is sorted by several threads, and the top-k of a long row is selected
+    # rather than sorted: both must return the order of a stable sort
+    dev = tvm.cpu(0)
+    for dshape, axis in [((1, 200000), 1), ((2, 3000, 3), 1)]:
+        np_data = np.random.randint(0, 100, size=dshape).astype("float32")
+        data = te.placeholder(dshape, name="data")
+        out = te.extern(
+            data.shape,
+            [data],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.sort.argsort", ins[0], outs[0], axis, True
+            ),
+            dtype="int32",
+            name="argsort",
+        )
+        f = tvm.build(te.create_schedule(out.op), [data, out], "llvm")
+        a = tvm.nd.array(np_data, dev)
+        c = tvm.nd.array(np.zeros(dshape, dtype="int32"), dev)
+        f(a, c)
+        np_indices = np.argsort(np_data, axis=axis, kind="stable")
+        tvm.testing.assert_allclose(c.numpy(), np_indices)
+
+        k = 5
+        out_shape = list(dshape)
+        out_shape[axis] = k
+        values, indices = te.extern(
+            [out_shape, out_shape],
+            [data],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.sort.topk", ins[0], outs[0], outs[1], k, axis, "both", False
+            ),
+            dtype=["float32", "int32"],
+            name="topk",
+        )
+        f = tvm.build(te.create_schedule(values.op), [data, values, indices], "llvm")
+        v = tvm.nd.array(np.zeros(out_shape, dtype="float32"), dev)
+        i = tvm.nd.array(np.zeros(out_shape, dtype="int32"), dev)
+        f(a, v, i)
+        np_indices = np.take(
+            np.argsort(-np_data, axis=axis, kind="stable"), np.arange(k), axis=axis
+        )
+        tvm.testing.assert_allclose(i.numpy(), np_indices)
+        tvm.testing.assert_allclose(v.numpy(), np.take_along_axis(np_data, np_indices, axis))
+
+
 def test_sort_by_key_gpu():
     size = 6
     keys = te.placeholder((size,), name="keys", dtype="int32")
@@ -126,4 +172,5 @@ def test_sort_by_key_gpu():
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
+    test_sort_large_rows()
     test_sort_by_key_gpu()
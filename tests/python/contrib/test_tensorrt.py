@@ -355,6 +355,39 @@ def test_tensorrt_serialize_vm(run_module):
         assert_result_dict_holds(result_dict)
 
 
+def test_tensorrt_engine_cache(run_module, monkeypatch):
+    dtype = "float32"
+    x_shape = (1, 4, 8, 8)
+    k_shape = (8, 4, 3, 3)
+    x = relay.var("x", shape=x_shape, dtype=dtype)
+    kernel = relay.var("kernel", shape=k_shape, dtype=dtype)
+    out = relay.nn.relu(relay.nn.conv2d(x, kernel, channels=8, kernel_size=(3, 3)))
+    mod = tvm.IRModule.from_expr(relay.Function([x, kernel], out))
+    params = {"kernel": np.random.uniform(-1, 1, k_shape).astype(dtype)}
+    x_data = np.random.uniform(-1, 1, x_shape).astype(dtype)
+    mod, config = tensorrt.partition_for_tensorrt(mod, params)
+    with tvm.transform.PassContext(opt_level=3, config={"relay.ext.tensorrt.options": config}):
+        lib = relay.build(mod, params=params, target="cuda")
+    if not run_module:
+        return
+
+    tmpdir = utils.tempdir()
+    cache_dir = utils.tempdir()
+    monkeypatch.setenv("TVM_TENSORRT_CACHE_DIR", cache_dir.temp_dir)
+    lib.export_library(tmpdir.relpath("compiled.so"))
+    results = []
+    for _ in range(2):
+        # The second module is loaded afresh and finds the engine cached by the first one.
+        loaded_lib = tvm.runtime.load_module(tmpdir.relpath("compiled.so"))
+        gmod = graph_executor.GraphModule(loaded_lib["default"](tvm.cuda(0)))
+        assert tensorrt.build_tensorrt_engines(loaded_lib, 1) == 1
+        assert any(name.endswith(".plan") for name in cache_dir.listdir())
+        gmod.set_input("x", x_data)
+        gmod.run()
+        results.append(gmod.get_output(0).numpy())
+    tvm.testing.assert_allclose(results[0], results[1], rtol=1e-5, atol=1e-5)
+
+
 def test_conv1d(run_module):
     def get_graph(
         x_shape=((1, 3, 224)),
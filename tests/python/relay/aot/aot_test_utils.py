@@ -44,6 +44,7 @@ from tvm.micro.testing import mlf_extract_workspace_size_bytes
 _LOG = logging.getLogger(__name__)
 
 AOT_SUCCESS_TOKEN = "AOT_TEST_SUCCESS"
+AOT_BENCHMARK_TOKEN = "AOT_TEST_CYCLES"
 AOT_FAILURE_TOKEN = "AOT_TEST_FAILURE"
 
 
@@ -124,6 +125,11 @@ class AOTTestRunner(NamedTuple):
         Additional parameters to pass to the make command
     pass_config: Dict[str, Any]
         Additional pass configuration when building the model
+    benchmark_iterations: int
+        When positive, each model is run this many times and the smallest and largest cycle
+        counts are printed after AOT_BENCHMARK_TOKEN. The cycles are read by the
+        AOT_BENCHMARK_CYCLES() macro, clock() unless the runner defines it, for example from
+        the DWT cycle counter of Cortex-M targets
     """
 
     makefile: str = "default"
@@ -132,10 +138,18 @@ class AOTTestRunner(NamedTuple):
     includes: List[str] = []
     parameters: Dict[str, str] = {}
     pass_config: Dict[str, Any] = {}
+    benchmark_iterations: int = 0
 
 
 AOT_DEFAULT_RUNNER = AOTTestRunner()
 
+# AOT Test Runner planning the storage of the executor in static pools, with no allocation
+# at run time, and measuring the spread of the latency of the models
+AOT_USMP_BENCHMARK_RUNNER = AOTTestRunner(
+    pass_config={"tir.usmp.enable": True},
+    benchmark_iterations=10,
+)
+
 # AOT Test Runner using the Arm® Corstone™-300 Reference Systems
 # see: https://developer.arm.com/ip-products/subsystem/corstone/corstone-300
 AOT_CORSTONE300_RUNNER = AOTTestRunner(
@@ -317,6 +331,32 @@ int main(){\n
     main_file.write(custom_prologue)
 
 
+def emit_main_workspace_pools(main_file, compiled_models):
+    """Define the workspace pools planned by the USMP, declared by the C interface headers"""
+    pool_sizes = {}
+    for compiled_model in compiled_models:
+        main_func_metadata = compiled_model.executor_factory.function_metadata["__tvm_main__"]
+        for pool_name, size in main_func_metadata.workspace_pool_sizes.items():
+            pool_sizes[str(pool_name)] = max(pool_sizes.get(str(pool_name), 0), int(size))
+    for pool_name, size in sorted(pool_sizes.items()):
+        pool_var = mangle_module_name(re.sub(r"\W", "_", pool_name))
+        main_file.write(
+            f"uint8_t {pool_var}[{size}] "
+            "__attribute__((aligned(TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES)));\n"
+        )
+
+
+def emit_main_benchmark_prologue(main_file):
+    main_file.write(
+        """
+#ifndef AOT_BENCHMARK_CYCLES
+#include <time.h>
+#define AOT_BENCHMARK_CYCLES() ((uint64_t)clock())
+#endif
+"""
+    )
+
+
 def emit_main_data(main_file, input_map, output_list, mod_name):
     for key in input_map:
         sanitized_tensor_name = re.sub(r"\W", "_", key)
@@ -378,6 +418,25 @@ def emit_main_data_setup(main_file, input_map, output_list, mod_name):
     main_file.write("};\n")
 
 
+def emit_main_c_interface_benchmark(main_file, devices, mod_name, iterations):
+    main_file.write(
+        "{\n"
+        "uint64_t min_cycles = UINT64_MAX, max_cycles = 0;\n"
+        f"for (int i = 0; i < {iterations}; ++i) {{\n"
+        "uint64_t start = AOT_BENCHMARK_CYCLES();\n"
+    )
+    emit_main_c_interface_call(main_file, devices, mod_name)
+    main_file.write(
+        "uint64_t cycles = AOT_BENCHMARK_CYCLES() - start;\n"
+        "if (cycles < min_cycles) min_cycles = cycles;\n"
+        "if (cycles > max_cycles) max_cycles = cycles;\n"
+        "}\n"
+        f'printf("{AOT_BENCHMARK_TOKEN} {mod_name} %llu %llu\\n", '
+        "(unsigned long long)min_cycles, (unsigned long long)max_cycles);\n"
+        "}\n"
+    )
+
+
 def emit_main_c_interface_call(main_file, devices, mod_name):
     if devices:
         main_file.write(
@@ -507,6 +566,7 @@ def create_main(
     data_linkage,
     interface_api,
     workspace_bytes,
+    benchmark_iterations=0,
 ):
     file_path = pathlib.Path(f"{output_path}/" + test_name).resolve()
     # create header file
@@ -521,6 +581,10 @@ def create_main(
         for compiled_model in compiled_models:
             model = compiled_model.model
             emit_main_data(main_file, model.inputs, model.outputs, model.name)
+        if interface_api == "c":
+            emit_main_workspace_pools(main_file, compiled_models)
+        if benchmark_iterations > 0:
+            emit_main_benchmark_prologue(main_file)
 
         emit_main_prologue(
             main_file,
@@ -538,7 +602,12 @@ def create_main(
                 devices = compiled_model.executor_factory.get_devices()
                 emit_main_device_structs(main_file, devices, model.name)
                 emit_main_data_structs(main_file, model.inputs, model.outputs, model.name)
-                emit_main_c_interface_call(main_file, devices, model.name)
+                if benchmark_iterations > 0:
+                    emit_main_c_interface_benchmark(
+                        main_file, devices, model.name, benchmark_iterations
+                    )
+                else:
+                    emit_main_c_interface_call(main_file, devices, model.name)
         else:
             emit_main_fake_packed_values(main_file)
             for compiled_model in compiled_models:
@@ -733,6 +802,7 @@ def run_and_check(
         data_linkage,
         interface_api,
         workspace_bytes,
+        runner.benchmark_iterations,
     )
 
     # Verify that compiles fine
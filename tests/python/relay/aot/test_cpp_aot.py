@@ -0,0 +1,134 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Tests of the AOT executor of the C++ runtime."""
+import sys
+
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import aot_executor, graph_executor, utils
+from tvm.relay.backend import Executor, Runtime
+
+
+def _conv_model():
+    data = relay.var("data", shape=(1, 3, 16, 16), dtype="float32")
+    weight = relay.var("weight", shape=(8, 3, 3, 3), dtype="float32")
+    bias = relay.var("bias", shape=(8,), dtype="float32")
+    out = relay.nn.conv2d(data, weight, padding=(1, 1))
+    out = relay.nn.relu(relay.nn.bias_add(out, bias))
+    mod = tvm.IRModule.from_expr(relay.Function([data, weight, bias], out))
+    params = {
+        "weight": np.random.uniform(-1, 1, size=(8, 3, 3, 3)).astype("float32"),
+        "bias": np.random.uniform(-1, 1, size=(8,)).astype("float32"),
+    }
+    return mod, params
+
+
+def _reference(mod, params, inputs):
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target="llvm", params=params)
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+    gmod.run(**inputs)
+    return [gmod.get_output(i).numpy() for i in range(gmod.get_num_outputs())]
+
+
+@tvm.testing.requires_llvm
+def test_conv2d():
+    mod, params = _conv_model()
+    data = np.random.uniform(size=(1, 3, 16, 16)).astype("float32")
+    with tvm.transform.PassContext(opt_level=3):
+        factory = relay.build(mod, target="llvm", params=params, executor=Executor("aot"))
+    assert factory.get_executor_config()
+
+    temp = utils.tempdir()
+    path = temp.relpath("aot.so")
+    factory.export_library(path)
+    lib = tvm.runtime.load_module(path)
+    amod = aot_executor.AotModule(lib["default"](tvm.cpu()))
+    assert amod.get_num_inputs() == 1
+    assert amod.get_num_outputs() == 1
+    assert amod.get_input_index("data") == 0
+    assert amod.get_input_index("weight") == -1
+    amod.run(data=data)
+    expected = _reference(mod, params, {"data": data})
+    tvm.testing.assert_allclose(amod.get_output(0).numpy(), expected[0], rtol=1e-5, atol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_tuple_output_zero_copy():
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    y = relay.var("y", shape=(4, 8), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x, y], relay.Tuple([x + y, x * y])))
+    with tvm.transform.PassContext(opt_level=3):
+        factory = relay.build(mod, target="llvm", executor=Executor("aot"))
+    amod = aot_executor.AotModule(factory["default"](tvm.cpu()))
+    assert amod.get_num_outputs() == 2
+
+    for _ in range(2):
+        x_in = np.random.uniform(size=(4, 8)).astype("float32")
+        y_in = np.random.uniform(size=(4, 8)).astype("float32")
+        x_nd, y_nd = tvm.nd.array(x_in), tvm.nd.array(y_in)
+        sum_nd, prod_nd = tvm.nd.empty((4, 8)), tvm.nd.empty((4, 8))
+        amod.set_input_zero_copy("x", x_nd)
+        amod.set_input_zero_copy(1, y_nd)
+        amod.set_output_zero_copy(0, sum_nd)
+        amod.set_output_zero_copy(1, prod_nd)
+        amod.run()
+        tvm.testing.assert_allclose(sum_nd.numpy(), x_in + y_in, rtol=1e-6)
+        tvm.testing.assert_allclose(prod_nd.numpy(), x_in * y_in, rtol=1e-6)
+
+    # set_input copies into the tensors of the executor again
+    amod.set_input("x", x_in)
+    amod.set_input("y", y_in)
+    amod.run()
+    tvm.testing.assert_allclose(amod.get_output(0).numpy(), x_in + y_in, rtol=1e-6)
+
+
+@tvm.testing.requires_llvm
+def test_inline_operators():
+    mod, params = _conv_model()
+    data = np.random.uniform(size=(1, 3, 16, 16)).astype("float32")
+    executor = Executor("aot", {"inline-operators": True})
+    with tvm.transform.PassContext(opt_level=3):
+        factory = relay.build(mod, target="llvm", params=params, executor=executor)
+
+    # the main function makes no call to the operators left
+    llvm_ir = factory.lib.get_source("ll")
+    main_body = llvm_ir.split("@tvmgen_default_run_model(", 1)[1].split("\n}\n", 1)[0]
+    assert "call i32 @tvmgen_default_fused" not in main_body
+
+    amod = aot_executor.AotModule(factory["default"](tvm.cpu()))
+    amod.run(data=data)
+    expected = _reference(mod, params, {"data": data})
+    tvm.testing.assert_allclose(amod.get_output(0).numpy(), expected[0], rtol=1e-5, atol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_unpacked_api_has_no_config():
+    x = relay.var("x", shape=(4,), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], x + relay.const(1.0)))
+    executor = Executor("aot", {"unpacked-api": True, "interface-api": "c"})
+    with tvm.transform.PassContext(opt_level=3, config={"tir.disable_vectorize": True}):
+        factory = relay.build(mod, target="c", executor=executor, runtime=Runtime("crt"))
+    assert factory.get_executor_config() is None
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main([__file__] + sys.argv[1:]))
@@ -31,6 +31,7 @@ from tvm.relay.backend import Executor, Runtime
 from aot_test_utils import (
     AOTTestModel,
     AOT_DEFAULT_RUNNER,
+    AOT_USMP_BENCHMARK_RUNNER,
     generate_ref_data,
     convert_to_relay,
     compile_and_run,
@@ -733,6 +734,43 @@ def test_aot_codegen_backend_alloc_workspace_calls():
     assert source.count("TVMBackendAllocWorkspace") == 3
 
 
+def test_usmp_workspace_pools():
+    """Test that the USMP places the storage of the executor in a pool given by the caller"""
+    interface_api = "c"
+    use_unpacked_api = True
+
+    mod, params = testing.synthetic.get_workload()
+    data_shape = [int(x) for x in mod["main"].checked_type.arg_types[0].shape]
+    inputs = {"data": np.random.uniform(size=data_shape).astype("float32")}
+    output_list = generate_ref_data(mod, inputs, params)
+    model = AOTTestModel(module=mod, inputs=inputs, outputs=output_list, params=params)
+
+    compiled_test_mods = compile_models(
+        model,
+        interface_api,
+        use_unpacked_api,
+        pass_config=AOT_USMP_BENCHMARK_RUNNER.pass_config,
+    )
+    main_func_metadata = compiled_test_mods[0].executor_factory.function_metadata["__tvm_main__"]
+    assert sum(main_func_metadata.workspace_sizes.values()) == 0
+    assert main_func_metadata.workspace_pool_sizes["workspace"] > 0
+    main_source = compiled_test_mods[0].executor_factory.lib.get_source()
+    assert "tvmgen_workspace" in main_source
+
+    compile_and_run(model, AOT_USMP_BENCHMARK_RUNNER, interface_api, use_unpacked_api)
+
+
+def test_usmp_requires_c_interface():
+    mod, params = testing.synthetic.get_workload()
+    with pytest.raises(tvm.TVMError, match="The USMP needs the AOT executor"):
+        compile_models(
+            AOTTestModel(module=mod, inputs={}, outputs=[], params=params),
+            "packed",
+            False,
+            pass_config={"tir.usmp.enable": True},
+        )
+
+
 @pytest.mark.parametrize("constants_byte_alignment", [8, 16, 32])
 def test_constants_alignment(constants_byte_alignment):
     """Test that constants_byte_alignment correctly sets constants byte alignment"""
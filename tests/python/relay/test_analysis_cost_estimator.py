@@ -0,0 +1,123 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the latency estimates of the cost estimator"""
+import os
+import sys
+
+import pytest
+import tvm
+import tvm.testing
+from tvm import relay, te
+from tvm.contrib import utils
+from tvm.meta_schedule.arg_info import ArgInfo
+from tvm.meta_schedule.database import JSONDatabase, TuningRecord
+from tvm.relay.analysis import CostEstimator
+from tvm.relay.testing import run_infer_type
+
+
+def _matmul(n):
+    A = te.placeholder((n, n), name="A")
+    B = te.placeholder((n, n), name="B")
+    k = te.reduce_axis((0, n), name="k")
+    C = te.compute((n, n), lambda i, j: te.sum(A[i, k] * B[k, j], axis=k), name="C")
+    return te.create_prim_func([A, B, C])
+
+
+def test_roofline():
+    func = _matmul(64)
+    estimator = CostEstimator(peak_flops=1e9, peak_bandwidth=1e8)
+    flops = tvm.tir.analysis.estimate_tir_flops(func)
+    nbytes = tvm.tir.analysis.estimate_tir_bytes(func)
+    expected = max(flops / 1e9, nbytes / 1e8)
+    assert estimator.roofline(func, "llvm") == pytest.approx(expected)
+    assert estimator.estimate(func, "llvm") == pytest.approx(expected)
+    # the larger the kernel, the longer it takes
+    assert estimator.estimate(_matmul(128), "llvm") > expected
+    # the default peaks of the target are used without explicit ones
+    assert CostEstimator().estimate(func, "llvm") > 0
+
+
+def test_learned_model_and_cache():
+    calls = []
+
+    def _model(func, target):
+        calls.append(func)
+        return 1.0 if len(func.params) == 3 else -1.0
+
+    estimator = CostEstimator(learned_model=_model)
+    assert estimator.estimate(_matmul(64), "llvm") == 1.0
+    # a structurally equal PrimFunc is estimated once
+    assert estimator.estimate(_matmul(64), "llvm") == 1.0
+    assert len(calls) == 1
+    assert estimator.estimate(_matmul(64), "cuda") == 1.0
+    assert len(calls) == 2
+
+    # the roofline is the fallback when the model cannot estimate
+    x = te.placeholder((16,), name="x")
+    y = te.compute((16,), lambda i: x[i] * 2.0, name="y")
+    func = te.create_prim_func([x, y])
+    assert estimator.estimate(func, "llvm") == pytest.approx(estimator.roofline(func, "llvm"))
+
+
+def test_tuning_record():
+    func = _matmul(64)
+    target = tvm.target.Target("llvm")
+    tmpdir = utils.tempdir()
+    database = JSONDatabase(
+        os.path.join(tmpdir.path, "workloads.json"),
+        os.path.join(tmpdir.path, "tuning_records.json"),
+    )
+    mod = tvm.IRModule({"main": func})
+    workload = database.commit_workload(mod)
+    database.commit_tuning_record(
+        TuningRecord(
+            tvm.tir.Schedule(mod).trace,
+            [2.0, 4.0],
+            workload,
+            target,
+            ArgInfo.from_prim_func(func),
+        )
+    )
+    estimator = CostEstimator(peak_flops=1e9, peak_bandwidth=1e9, database=database)
+    assert estimator.estimate(func, target) == pytest.approx(3.0)
+    # the records of another target do not apply
+    assert estimator.estimate(func, "cuda") < 1.0
+    # nor to another workload
+    assert estimator.estimate(_matmul(32), target) < 1.0
+
+
+@tvm.testing.requires_llvm
+def test_relay_call():
+    def _dense(m):
+        data = relay.var("data", shape=(m, 64))
+        weight = relay.var("weight", shape=(32, 64))
+        return run_infer_type(relay.nn.dense(data, weight))
+
+    estimator = CostEstimator(peak_flops=1e9, peak_bandwidth=1e9)
+    small = estimator.estimate(_dense(1), "llvm")
+    large = estimator.estimate(_dense(256), "llvm")
+    assert 0 < small < large
+
+    # the estimator of the scope is the one of the passes
+    assert not CostEstimator.current().same_as(estimator)
+    with estimator:
+        assert CostEstimator.current().same_as(estimator)
+    assert not CostEstimator.current().same_as(estimator)
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main([__file__] + sys.argv[1:]))
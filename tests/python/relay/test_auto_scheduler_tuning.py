@@ -91,6 +91,42 @@ def tune_network(network, target):
         tvm.testing.assert_allclose(actual_output2, expected_output, rtol=1e-4, atol=1e-4)
 
 
+@tvm.testing.requires_llvm
+def test_measure_in_situ():
+    mod, params = get_network("mlp")
+    target = tvm.target.Target("llvm")
+    tasks, task_weights = auto_scheduler.extract_tasks(mod["main"], params, target)
+
+    with tempfile.NamedTemporaryFile() as fp:
+        tuner = auto_scheduler.TaskScheduler(tasks, task_weights, callbacks=[])
+        tune_option = auto_scheduler.TuningOptions(
+            num_measure_trials=2 * len(tasks),
+            num_measures_per_round=2,
+            measure_callbacks=[auto_scheduler.RecordToFile(fp.name)],
+        )
+        tuner.tune(tune_option, search_policy="sketch.random")
+
+        with auto_scheduler.ApplyHistoryBest(fp.name):
+            with tvm.transform.PassContext(
+                opt_level=3, config={"relay.backend.use_auto_scheduler": True}
+            ):
+                lib = relay.build(mod, target=target, params=params)
+
+        data = tvm.nd.array(np.random.uniform(size=(1, 32)).astype("float32"))
+        interference = auto_scheduler.measure_in_situ(
+            lib, tvm.cpu(), tasks, fp.name, inputs={"data": data}, threshold=float("inf")
+        )
+
+    assert interference
+    for item in interference:
+        assert item.func_names and item.in_situ_cost > 0
+        assert item.ratio == item.in_situ_cost / item.isolated_cost
+        assert not item.sensitive
+    weights = auto_scheduler.in_situ_task_weights(task_weights, interference)
+    for item in interference:
+        assert weights[item.task_idx] == task_weights[item.task_idx] * item.ratio
+
+
 @tvm.testing.requires_cuda
 def test_tuning_cuda():
     tune_network("mlp", "cuda")
@@ -98,4 +134,5 @@ def test_tuning_cuda():
 
 
 if __name__ == "__main__":
+    test_measure_in_situ()
     test_tuning_cuda()
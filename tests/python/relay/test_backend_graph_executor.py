@@ -184,6 +184,100 @@ def test_plan_memory():
     )
 
 
+def test_plan_memory_offsets():
+    x = relay.var("x", shape=(10,))
+    y = relay.var("y", shape=(1,))
+    z = relay.add(x, relay.exp(y))
+    for _ in range(5):
+        z = relay.exp(z)
+    func = relay.Function([x, y], z)
+    mod = tvm.IRModule.from_expr(func)
+    mod = relay.transform.InferType()(mod)
+    mod = relay.transform.FuseOps(0)(mod)
+    mod = relay.transform.InferType()(mod)
+    with tvm.transform.PassContext(config={"relay.GraphPlanMemory.use_offsets": True}):
+        memory_plan = relay.backend._backend.GraphPlanMemory(mod["main"])
+
+    offsets = {}
+    for v in memory_plan.expr_to_storage_info.values():
+        for sid, offset in zip(v.storage_ids, v.storage_offsets):
+            offsets.setdefault(int(sid), set()).add(int(offset))
+    # the two params keep their own storage, all the other tensors share one arena in which
+    # two aligned slots are enough
+    assert len(offsets) == 3, f"found storage_ids: {offsets}"
+    assert sorted(offsets.values(), key=len)[-1] == {0, 64}
+
+
+def test_plan_memory_offsets_run():
+    x = relay.var("x", shape=(4, 32))
+    a = relay.exp(x)
+    b, c = relay.split(relay.tanh(a), 2, axis=1)
+    d = relay.concatenate([relay.sigmoid(b), relay.abs(c)], axis=1)
+    func = relay.Function([x], relay.add(relay.nn.relu(d), x))
+    x_data = np.random.rand(4, 32).astype("float32")
+
+    def run(use_offsets):
+        with tvm.transform.PassContext(
+            opt_level=0, config={"relay.GraphPlanMemory.use_offsets": use_offsets}
+        ):
+            lib = relay.build(tvm.IRModule.from_expr(func), "llvm")
+        gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        gmod.set_input(x=x_data)
+        gmod.run()
+        return json.loads(lib.get_graph_json()), gmod.get_output(0).numpy()
+
+    graph_json, with_offsets = run(True)
+    assert "storage_offset" in graph_json["attrs"]
+    _, without_offsets = run(False)
+    tvm.testing.assert_allclose(with_offsets, without_offsets)
+
+
+def test_plan_memory_in_place():
+    x = relay.var("x", shape=(4, 32))
+    y = relay.var("y", shape=(4, 32))
+    a = relay.exp(x)
+    b = relay.tanh(a)
+    c = relay.sigmoid(b)
+    func = relay.Function([x, y], relay.add(c, y))
+    x_data = np.random.rand(4, 32).astype("float32")
+    y_data = np.random.rand(4, 32).astype("float32")
+
+    def run(in_place):
+        with tvm.transform.PassContext(
+            opt_level=0, config={"relay.GraphPlanMemory.in_place": in_place}
+        ):
+            lib = relay.build(tvm.IRModule.from_expr(func), "llvm")
+        gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        gmod.set_input(x=x_data, y=y_data)
+        gmod.run()
+        return json.loads(lib.get_graph_json()), gmod.get_output(0).numpy()
+
+    graph_json, in_place = run(True)
+    # The parameters are never overwritten, every other operator overwrites its dying input.
+    assert tuple(graph_json["attrs"]["storage_id"][1]) == (0, 1, 2, 2, 2, 2)
+    _, not_in_place = run(False)
+    tvm.testing.assert_allclose(in_place, not_in_place)
+    tvm.testing.assert_allclose(in_place, 1 / (1 + np.exp(-np.tanh(np.exp(x_data)))) + y_data)
+
+
+def test_in_place_params():
+    in_place_params = tvm.get_global_func("relay.backend.InPlaceParams")
+    x = relay.var("x", shape=(4, 8))
+    bias = relay.var("bias", shape=(8,))
+    i = relay.var("i", shape=(4, 8), dtype="int32")
+    body = relay.nn.relu(relay.add(x, bias)) + relay.cast(i, "float32")
+    func = relay.Function([x, bias, i], body).with_attr("Primitive", 1)
+    func = relay.transform.InferType()(tvm.IRModule.from_expr(func))["main"]
+    # Only x has the shape and the dtype of the result.
+    assert [int(index) for index in in_place_params(func)] == [0]
+
+    # A transpose reads the elements of other indices.
+    y = relay.var("y", shape=(8, 8))
+    func = relay.Function([y], relay.transpose(relay.exp(y))).with_attr("Primitive", 1)
+    func = relay.transform.InferType()(tvm.IRModule.from_expr(func))["main"]
+    assert len(in_place_params(func)) == 0
+
+
 def test_reshape_nop():
     # test that reshape can be turned into nop
     x = relay.var("x", shape=(10, 4))
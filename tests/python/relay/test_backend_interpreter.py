@@ -271,6 +271,45 @@ def test_keyword_args():
     testing.assert_allclose(actual.numpy(), expected)
 
 
+def test_eval_direct():
+    eval_direct = tvm.get_global_func("relay.backend.EvalDirect")
+    dev = tvm.cpu(0)
+    a_np = np.random.uniform(-10, 10, size=(4, 5)).astype("float32")
+    b_np = np.random.uniform(-10, 10, size=(4, 5)).astype("float32")
+    a, b = relay.const(a_np), relay.const(b_np)
+    for op, np_op in [
+        (relay.add, np.add),
+        (relay.subtract, np.subtract),
+        (relay.multiply, np.multiply),
+        (relay.maximum, np.maximum),
+        (relay.minimum, np.minimum),
+    ]:
+        testing.assert_allclose(eval_direct(op(a, b), dev).numpy(), np_op(a_np, b_np))
+        testing.assert_allclose(eval_direct(op(a, relay.const(2.0)), dev).numpy(), np_op(a_np, 2.0))
+
+    # The integers wrap around as in the compiled kernels.
+    big = relay.const(np.array([2**31 - 1], "int32"))
+    result = eval_direct(relay.add(big, relay.const(np.array([1], "int32"))), dev)
+    assert result.numpy()[0] == -(2**31)
+
+    # Broadcasts, mixed types and large constants are left to the compiled kernels.
+    assert eval_direct(relay.add(a, relay.const(np.ones((5,), "float32"))), dev) is None
+    assert eval_direct(relay.add(relay.const(1), relay.const(1.0)), dev) is None
+    large = relay.const(np.ones((100, 100), "float32"))
+    assert eval_direct(relay.add(large, large), dev) is None
+    assert eval_direct(relay.divide(a, b), dev) is None
+
+
+def test_compiled_primitives_reused():
+    x = relay.var("x", shape=(3,), dtype="float32")
+    func = relay.Function([x], relay.exp(x))
+    x_np = np.random.uniform(size=(3,)).astype("float32")
+    # The second executor reuses the primitive built by the first one.
+    for _ in range(2):
+        result = relay.create_executor(kind="debug").evaluate(func)(x_np)
+        testing.assert_allclose(result.numpy(), np.exp(x_np), rtol=1e-5)
+
+
 # TODO(mbs): Support? Would help reduce wasted work when we need to prepare
 # multiple functions w.r.t. the same module.
 @pytest.mark.skip(reason="closures are currently not directly Python callable")
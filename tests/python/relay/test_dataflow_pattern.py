@@ -1401,6 +1401,39 @@ def test_partition_overused():
     assert pattern.partition(out) == out
 
 
+def test_partition_alt_root_ops():
+    act = is_op("nn.relu") | is_op("sigmoid")
+    pattern = act(is_op("add")(wildcard(), wildcard())) | is_op("tanh")(wildcard())
+
+    x = relay.var("x")
+    y = relay.var("y")
+    out = relay.op.tanh(relay.op.sigmoid(relay.op.nn.relu(x + y) + y))
+    partitioned = pattern.partition(out)
+    assert isinstance(partitioned.op, relay.Function)
+    sigmoid = partitioned.args[0]
+    assert isinstance(sigmoid.op, relay.Function)
+    assert any(
+        isinstance(arg, relay.Call) and isinstance(arg.op, relay.Function) for arg in sigmoid.args
+    )
+
+
+def test_partition_shared_wildcard():
+    w = wildcard()
+    pattern = is_op("nn.relu")(is_op("add")(w, w))
+
+    x = relay.var("x")
+    y = relay.var("y")
+    # only the additions of an expression with itself match, wherever they are in the graph
+    chain = x
+    for _ in range(8):
+        shared = relay.op.nn.relu(chain + y)
+        chain = relay.op.nn.relu(shared + shared)
+    partitioned = pattern.partition(chain)
+    assert isinstance(partitioned.op, relay.Function)
+    assert isinstance(partitioned.args[0].op, tvm.ir.Op)
+    assert pattern.partition(relay.op.nn.relu(x + y)) == relay.op.nn.relu(x + y)
+
+
 def test_partition_fuzzy_tuple():
     x = relay.var("x")
     y = relay.var("y")
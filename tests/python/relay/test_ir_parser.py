@@ -161,6 +161,25 @@ def test_comments():
     )
 
 
+def test_token_spans():
+    # Names starting like `inff` and runs of whitespace must not shift the columns.
+    text = "fn (%info: int32) {\n    negative(%info)   }"
+    func = tvm.parser.parse_expr(text)
+    assert func.body.span.line == 2
+    assert func.body.span.column == text.split("\n")[1].index("negative") + 1
+
+
+def test_metadata_roundtrip():
+    # The metadata section, where the constants are, is read at once.
+    x = relay.var("x", shape=(64, 64))
+    weights = [relay.const(np.random.rand(64, 64).astype("float32")) for _ in range(4)]
+    body = x
+    for weight in weights:
+        body = relay.add(body, weight)
+    mod = tvm.IRModule.from_expr(relay.Function([x], body))
+    roundtrip(mod)
+
+
 def test_int_literal():
     assert isinstance(parse_text("1"), relay.Constant)
     assert isinstance(parse_text("1").data, tvm.nd.NDArray)
@@ -58,6 +58,22 @@ def test_large_graph():
     show(astext(f))
 
 
+def test_save_text(tmp_path):
+    # nested scopes share their docs, and the text is written as it is rendered
+    x = relay.var("x", shape=(3, 2))
+    body = x
+    for i in range(50):
+        y = relay.var("y%d" % i, shape=(3, 2))
+        body = relay.Let(y, relay.add(body, relay.const(np.ones((3, 2), "float32"))), y)
+        body = relay.If(relay.const(True), body, x)
+    mod = tvm.IRModule.from_expr(relay.Function([x], body))
+    path = str(tmp_path / "mod.txt")
+    tvm.ir.save_text(mod, path)
+    with open(path) as f:
+        text = f.read()
+    assert text == astext(mod)
+
+
 def test_func():
     x = relay.var("x", shape=(3, 2))
     y = relay.var("y")
@@ -713,6 +713,92 @@ def test_partial_constant():
     check_result(mod, ref_mod, {"in_2": data2, "in_4": data4}, (10, 10), tol=1e-5)
 
 
+def test_fused_post_ops():
+    """Test the convolutions and the denses with fused post-ops, run from several threads."""
+    if not tvm.get_global_func("runtime.DNNLJSONRuntimeCreate", True):
+        print("skip because DNNL codegen is not available")
+        return
+    if sys.platform == "win32":
+        print("Skip test on Windows for now")
+        return
+
+    import threading
+
+    from tvm.contrib import graph_executor
+    from tvm.relay.op.contrib.dnnl import partition_for_dnnl
+
+    dtype = "float32"
+    ishape = (1, 8, 14, 14)
+    data = relay.var("data", shape=ishape, dtype=dtype)
+    w1 = relay.var("w1", shape=(8, 8, 3, 3), dtype=dtype)
+    b1 = relay.var("b1", shape=(8, 1, 1), dtype=dtype)
+    w2 = relay.var("w2", shape=(8, 8, 3, 3), dtype=dtype)
+    b2 = relay.var("b2", shape=(8, 1, 1), dtype=dtype)
+    w3 = relay.var("w3", shape=(16, 8 * 14 * 14), dtype=dtype)
+    b3 = relay.var("b3", shape=(16,), dtype=dtype)
+
+    conv1 = relay.nn.conv2d(data, w1, kernel_size=(3, 3), channels=8, padding=(1, 1))
+    out = relay.nn.relu(relay.add(relay.add(conv1, b1), data))
+    # The second convolution shares the primitive of the first one.
+    conv2 = relay.nn.conv2d(out, w2, kernel_size=(3, 3), channels=8, padding=(1, 1))
+    out = relay.nn.relu(relay.add(conv2, b2))
+    out = relay.add(relay.nn.dense(relay.reshape(out, (1, -1)), w3), b3)
+    func = relay.Function([data, w1, b1, w2, b2, w3, b3], out)
+    ref_mod = tvm.IRModule.from_expr(func)
+    ref_mod = transform.InferType()(ref_mod)
+
+    params = {}
+    for var in [w1, b1, w2, b2, w3, b3]:
+        shape = [int(dim) for dim in var.type_annotation.shape]
+        params[var.name_hint] = np.random.uniform(-1, 1, shape).astype(dtype)
+    mod = partition_for_dnnl(tvm.IRModule.from_expr(func), params)
+    composites = set()
+
+    def collect_composite(expr):
+        if isinstance(expr, relay.Function) and expr.attrs and "Composite" in expr.attrs.keys():
+            composites.add(str(expr.attrs["Composite"]))
+
+    for _, subgraph in mod.functions.items():
+        tvm.relay.analysis.post_order_visit(subgraph, collect_composite)
+    assert composites == {"dnnl.conv2d_bias_sum_relu", "dnnl.conv2d_bias_relu", "dnnl.dense_bias"}
+
+    i_data = np.random.uniform(0, 1, ishape).astype(dtype)
+    ref_mod["main"] = bind_params_by_name(ref_mod["main"], params)
+    check_result(mod, ref_mod, {"data": i_data}, (1, 16), tol=1e-5)
+
+    # The executors of one library share the DNNL modules, which run concurrently.
+    te_compiler.get().clear()
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target="llvm")
+        ref_lib = relay.build(ref_mod, target="llvm")
+    ref_rt = graph_executor.GraphModule(ref_lib["default"](tvm.cpu()))
+    datas = [np.random.uniform(0, 1, ishape).astype(dtype) for _ in range(4)]
+    ref_results = []
+    for i_data in datas:
+        ref_rt.set_input("data", i_data)
+        ref_rt.run()
+        ref_results.append(ref_rt.get_output(0).numpy())
+
+    results = [[] for _ in range(4)]
+
+    def run(index):
+        rt = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+        for _ in range(8):
+            rt.set_input("data", datas[index])
+            rt.run()
+            results[index].append(rt.get_output(0).numpy())
+
+    threads = [threading.Thread(target=run, args=(index,)) for index in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    for index in range(4):
+        assert len(results[index]) == 8
+        for result in results[index]:
+            tvm.testing.assert_allclose(result, ref_results[index], rtol=1e-5, atol=1e-5)
+
+
 if __name__ == "__main__":
     test_conv2d()
     test_add()
@@ -724,3 +810,4 @@ if __name__ == "__main__":
     test_composite()
     test_constant()
     test_partial_constant()
+    test_fused_post_ops()
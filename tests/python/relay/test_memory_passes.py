@@ -116,7 +116,111 @@ def test_no_fuse():
     check_memory_plan(func, check_no_fuse)
 
 
+def _compile_vm(func, plan_static_storage, in_place=False):
+    mod = tvm.IRModule.from_expr(func)
+    # Without fusion each operator gets a storage of its own.
+    with tvm.transform.PassContext(
+        opt_level=0,
+        config={
+            "relay.vm.plan_static_storage": plan_static_storage,
+            "relay.vm.plan_static_storage.in_place": in_place,
+        },
+    ):
+        return relay.vm.compile(mod, "llvm")
+
+
+def _num_alloc_storage(exe):
+    return sum(1 for line in exe.bytecode.splitlines() if "alloc_storage" in line)
+
+
+def _run_vm(exe, *args):
+    vm = tvm.runtime.vm.VirtualMachine(exe, tvm.cpu())
+    return vm.invoke("main", *args)
+
+
+def test_plan_static_storage():
+    x = relay.var("x", shape=(16, 16))
+    y = x
+    for _ in range(6):
+        y = relay.exp(relay.negative(y))
+    func = relay.Function([x], y)
+
+    data = np.random.rand(16, 16).astype("float32")
+    expected = data
+    for _ in range(6):
+        expected = np.exp(-expected)
+
+    exe = _compile_vm(func, False)
+    planned_exe = _compile_vm(func, True)
+    # The chain of 12 operators only needs two storages alive at once.
+    assert _num_alloc_storage(planned_exe) < _num_alloc_storage(exe)
+    assert _num_alloc_storage(planned_exe) == 2
+    np.testing.assert_allclose(_run_vm(planned_exe, data).numpy(), expected, rtol=1e-5)
+
+
+def test_plan_static_storage_escaping_tensors():
+    x = relay.var("x", shape=(8,))
+    a = relay.exp(x)
+    b = relay.negative(a)
+    c = relay.exp(b)
+    # a is returned, its storage must not back the storage of c.
+    func = relay.Function([x], relay.Tuple([a, c]))
+
+    data = np.random.rand(8).astype("float32")
+    result = _run_vm(_compile_vm(func, True), data)
+    np.testing.assert_allclose(result[0].numpy(), np.exp(data), rtol=1e-5)
+    np.testing.assert_allclose(result[1].numpy(), np.exp(-np.exp(data)), rtol=1e-5)
+
+
+def test_plan_static_storage_dynamic():
+    x = relay.var("x", shape=(relay.Any(), 4))
+    y = relay.exp(relay.negative(x))
+    z = relay.sum(y, axis=0)
+    w = relay.exp(relay.negative(z))
+    func = relay.Function([x], w)
+
+    data = np.random.rand(5, 4).astype("float32")
+    result = _run_vm(_compile_vm(func, True), data)
+    np.testing.assert_allclose(result.numpy(), np.exp(-np.sum(np.exp(-data), axis=0)), rtol=1e-5)
+
+
+def test_plan_static_storage_in_place():
+    x = relay.var("x", shape=(16, 16))
+    y = x
+    for _ in range(6):
+        y = relay.exp(relay.negative(y))
+    func = relay.Function([x], y)
+
+    data = np.random.rand(16, 16).astype("float32")
+    expected = data
+    for _ in range(6):
+        expected = np.exp(-expected)
+
+    # Each elementwise operator overwrites the result of the previous one, only the parameter
+    # is left alone.
+    exe = _compile_vm(func, True, in_place=True)
+    assert _num_alloc_storage(exe) == 1
+    np.testing.assert_allclose(_run_vm(exe, data).numpy(), expected, rtol=1e-5)
+
+
+def test_plan_static_storage_in_place_live_argument():
+    x = relay.var("x", shape=(8,))
+    a = relay.exp(x)
+    b = relay.negative(a)
+    # a is still used after b, b must not overwrite it.
+    func = relay.Function([x], relay.add(b, a))
+
+    data = np.random.rand(8).astype("float32")
+    result = _run_vm(_compile_vm(func, True, in_place=True), data)
+    np.testing.assert_allclose(result.numpy(), np.zeros(8), atol=1e-6)
+
+
 if __name__ == "__main__":
     test_tyck_alloc_tensor()
     test_add()
     test_add_sub()
+    test_plan_static_storage()
+    test_plan_static_storage_escaping_tensors()
+    test_plan_static_storage_dynamic()
+    test_plan_static_storage_in_place()
+    test_plan_static_storage_in_place_live_argument()
@@ -622,6 +622,74 @@ def test_nll_loss(dev, target):
     _verify((10, 5), dtype="float64")
 
 
+@tvm.testing.parametrize_targets
+def test_fused_attention(dev, target):
+    def _verify(batch, q_len, kv_len, dim, v_dim, scale):
+        q = relay.var("q", relay.TensorType((batch, q_len, dim), "float32"))
+        k = relay.var("k", relay.TensorType((batch, kv_len, dim), "float32"))
+        v = relay.var("v", relay.TensorType((batch, kv_len, v_dim), "float32"))
+        out = relay.nn.fused_attention(q, k, v, scale)
+        checked = run_infer_type(out)
+        assert checked.checked_type == relay.ty.TensorType((batch, q_len, v_dim), "float32")
+        func = relay.Function([q, k, v], out)
+
+        q_np = np.random.uniform(-1, 1, size=(batch, q_len, dim)).astype("float32")
+        k_np = np.random.uniform(-1, 1, size=(batch, kv_len, dim)).astype("float32")
+        v_np = np.random.uniform(-1, 1, size=(batch, kv_len, v_dim)).astype("float32")
+        scores = scale * np.matmul(q_np, k_np.transpose(0, 2, 1))
+        probs = np.exp(scores - scores.max(axis=-1, keepdims=True))
+        probs /= probs.sum(axis=-1, keepdims=True)
+        out_np = np.matmul(probs, v_np)
+
+        out_relay = relay.create_executor("graph", device=dev, target=target).evaluate(func)(
+            q_np, k_np, v_np
+        )
+        tvm.testing.assert_allclose(out_relay.numpy(), out_np, rtol=1e-5, atol=1e-5)
+
+    _verify(2, 16, 16, 8, 8, 1.0)
+    # key lengths that are not a multiple of the key blocks
+    _verify(4, 33, 100, 64, 32, 0.125)
+    _verify(1, 1, 257, 16, 16, 0.25)
+
+
+
+@tvm.testing.parametrize_targets
+def test_weight_only_dense(dev, target):
+    def _verify(batch, in_dim, units, bits, group_size):
+        w_np = np.random.uniform(-1, 1, size=(units, in_dim)).astype("float32")
+        packed_np, scales_np = relay.transform.weight_only_quantize.quantize_weight(
+            w_np, bits, group_size
+        )
+        x = relay.var("x", relay.TensorType((batch, in_dim), "float32"))
+        w = relay.var("w", relay.TensorType(packed_np.shape, packed_np.dtype))
+        scales = relay.var("scales", relay.TensorType(scales_np.shape, "float32"))
+        out = relay.nn.weight_only_dense(x, w, scales, bits, group_size)
+        checked = run_infer_type(out)
+        assert checked.checked_type == relay.ty.TensorType((batch, units), "float32")
+        func = relay.Function([x, w, scales], out)
+
+        if bits == 8:
+            q_np = packed_np.astype("float32")
+        else:
+            q_np = np.zeros((units, in_dim), dtype="float32")
+            q_np[:, 0::2] = (packed_np & 15).astype("float32") - 8
+            q_np[:, 1::2] = (packed_np >> 4).astype("float32") - 8
+        dequantized = q_np * np.repeat(scales_np, group_size, axis=1)
+        # the quantization error is within half a step of each group
+        assert np.abs(dequantized - w_np).max() <= scales_np.max() / 2 + 1e-6
+        x_np = np.random.uniform(-1, 1, size=(batch, in_dim)).astype("float32")
+        out_np = x_np.dot(dequantized.T)
+
+        out_relay = relay.create_executor("graph", device=dev, target=target).evaluate(func)(
+            x_np, packed_np, scales_np
+        )
+        tvm.testing.assert_allclose(out_relay.numpy(), out_np, rtol=1e-5, atol=1e-5)
+
+    _verify(1, 256, 64, 4, 128)
+    _verify(3, 96, 40, 4, 32)
+    _verify(2, 64, 16, 8, 64)
+
+
 if __name__ == "__main__":
     import sys
     import pytest
@@ -252,8 +252,44 @@ def test_per_channel_weight_scale():
         qnn_dense_driver(config)
 
 
+def test_qnn_dense_constant_weight_terms():
+    config = make_int_configuration()
+    data = relay.var("quantized_data", shape=config["input_shape"], dtype=config["dtype"])
+    kernel = relay.const(config["quantized_kernel"])
+    out = relay.qnn.op.dense(
+        data,
+        kernel,
+        relay.const(config["input_zero_point"], "int32"),
+        relay.const(config["kernel_zero_point"], "int32"),
+        relay.const(config["input_scale"], "float32"),
+        relay.const(config["kernel_scale"], "float32"),
+        config["units"],
+    )
+    mod = tvm.IRModule.from_expr(relay.Function([data], out))
+    mod = relay.transform.InferType()(mod)
+    mod = relay.qnn.transform.CanonicalizeOps()(mod)
+
+    # Only the data is reduced at run time, the weight terms are folded into a constant.
+    reduced = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and expr.op == relay.op.get("sum"):
+            reduced.append(expr.args[0])
+
+    relay.analysis.post_order_visit(mod["main"], visit)
+    assert len(reduced) == 1
+
+    with tvm.transform.PassContext(opt_level=2):
+        lib = relay.build(mod, "llvm")
+    runtime = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    runtime.set_input("quantized_data", config["quantized_data"])
+    runtime.run()
+    np.testing.assert_equal(runtime.get_output(0).numpy(), config["output"])
+
+
 if __name__ == "__main__":
     test_qnn_dense_without_bias()
     test_qnn_dense_with_bias()
     test_qnn_dense_with_requantized_output()
     test_per_channel_weight_scale()
+    test_qnn_dense_constant_weight_terms()
@@ -1337,6 +1337,34 @@ def test_alter_op_dense():
             assert tvm.ir.structural_equal(a, b)
 
 
+def test_alter_op_dense_vnni():
+    def before():
+        x = relay.var("x", shape=(32, 128), dtype="uint8")
+        weight = relay.var("weight", shape=(48, 128), dtype="int8")
+        y = relay.nn.dense(x, weight, out_dtype="int32")
+        y = relay.Function(analysis.free_vars(y), y)
+        return y
+
+    def expected():
+        x = relay.var("x", shape=(32, 128), dtype="uint8")
+        weight = relay.var("weight", shape=(48, 128), dtype="int8")
+        target_layout = "NC16n4c"
+        weight_transform = relay.layout_transform(weight, "NC", target_layout)
+        y = relay.nn.contrib_dense_pack(
+            x, weight_transform, target_layout, units=None, out_dtype="int32"
+        )
+        y = relay.Function(analysis.free_vars(y), y)
+        return y
+
+    with tvm.target.Target("llvm -mcpu=cascadelake"):
+        with TempOpAttr(
+            "nn.dense", "FTVMAlterOpLayout", topi.x86.dense_alter_op._alter_dense_layout
+        ):
+            a = run_opt_pass(before(), transform.AlterOpLayout())
+            b = run_opt_pass(expected(), transform.InferType())
+            assert tvm.ir.structural_equal(a, b)
+
+
 def test_not_inplace_modify():
     def func():
         x = relay.var("x", shape=(1, 64, 56, 56))
@@ -1452,5 +1480,60 @@ def test_conv2d_strided_slice_packed_to_unpacked():
         assert tvm.ir.structural_equal(a, b)
 
 
+def test_alter_layout_plan_layouts():
+    """Test planning the layouts of the convolutions over the whole graph"""
+
+    def before():
+        x = relay.var("x", shape=(1, 32, 28, 28))
+        weight1 = relay.var("weight1", shape=(64, 32, 3, 3))
+        weight2 = relay.var("weight2", shape=(64, 64, 3, 3))
+        y = relay.nn.conv2d(x, weight1, channels=64, kernel_size=(3, 3), padding=(1, 1))
+        y = relay.nn.relu(y)
+        y = relay.nn.conv2d(y, weight2, channels=64, kernel_size=(3, 3), padding=(1, 1))
+        y = relay.Function(analysis.free_vars(y), y)
+        return y
+
+    def layout_candidates(attrs, tinfos, out_type):
+        if int(tinfos[0].shape[1]) == 32:
+            # A tuned convolution with a fixed blocking.
+            return [("NCHW8c", "NCHW8c", 0.0)]
+        return [("NCHW4c", "NCHW4c", 0.0), ("NCHW8c", "NCHW8c", 1.0)]
+
+    planned_layouts = []
+
+    def alter_conv2d(attrs, inputs, tinfos, out_type):
+        data, weight = inputs
+        planned = transform.planned_layout_candidate()
+        new_attrs = dict(attrs)
+        new_attrs["data_layout"] = str(planned[0]) if planned is not None else "NCHW4c"
+        planned_layouts.append(new_attrs["data_layout"])
+        return relay.nn.conv2d(data, weight, **new_attrs)
+
+    def plan(transform_cost):
+        del planned_layouts[:]
+        config = {
+            "relay.AlterOpLayout.plan_layouts": True,
+            "relay.AlterOpLayout.layout_transform_cost": transform_cost,
+        }
+        mod = tvm.IRModule.from_expr(before())
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            mod = transform.AlterOpLayout()(transform.InferType()(mod))
+        transforms = []
+        analysis.post_order_visit(
+            mod["main"],
+            lambda e: transforms.append(e)
+            if isinstance(e, relay.Call) and e.op.name == "layout_transform"
+            else None,
+        )
+        return list(planned_layouts), len(transforms)
+
+    with TempOpAttr("nn.conv2d", "FTVMLayoutCandidates", layout_candidates):
+        with TempOpAttr("nn.conv2d", "FTVMAlterOpLayout", alter_conv2d):
+            # Matching the tuned blocking saves a transform worth more than the compute.
+            assert plan(8.0) == (["NCHW8c", "NCHW8c"], 2)
+            # Free transforms leave each convolution its cheapest layout.
+            assert plan(0.0) == (["NCHW8c", "NCHW4c"], 3)
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -0,0 +1,67 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm import relay
+from tvm.relay.analysis import post_order_visit
+from tvm.relay.testing import check_grad
+
+
+def _chain(num_layers):
+    x = relay.var("x", shape=(8, 8), dtype="float64")
+    w = relay.var("w", shape=(8, 8), dtype="float64")
+    y = x
+    for _ in range(num_layers):
+        y = relay.tanh(relay.multiply(y, w))
+    return relay.Function([x, w], relay.sum(y))
+
+
+def _num_checkpoints(func):
+    num = [0]
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and expr.op == relay.op.get("annotation.checkpoint"):
+            num[0] += 1
+
+    post_order_visit(func, visit)
+    return num[0]
+
+
+def _run(func, budget_bytes):
+    mod = tvm.IRModule.from_expr(func)
+    return relay.transform.AutoCheckpoint(budget_bytes)(mod)["main"]
+
+
+def test_fits_in_budget():
+    # 8 layers of two 512 bytes activations
+    func = _run(_chain(8), 1 << 20)
+    assert _num_checkpoints(func) == 0
+
+
+def test_checkpoint_gradient():
+    func = _run(_chain(8), 4096)
+    assert _num_checkpoints(func) > 0
+    check_grad(func, eps=1e-3, scale=0.1)
+
+
+def test_smaller_budget_more_checkpoints():
+    assert _num_checkpoints(_run(_chain(16), 2048)) >= _num_checkpoints(_run(_chain(16), 8192))
+
+
+if __name__ == "__main__":
+    test_fits_in_budget()
+    test_checkpoint_gradient()
+    test_smaller_budget_more_checkpoints()
@@ -129,6 +129,25 @@ def test_calibrate_memory_bound():
         relay.quantize.quantize(mod, params, dataset)
 
 
+@pytest.mark.parametrize("num_workers", [1, 3])
+def test_calibrate_streaming_kl(num_workers):
+    from tvm.relay.quantize import _calibrate, _quantize
+    from tvm.relay.quantize.kl_divergence import _find_scale_by_kl
+
+    mod, params = testing.synthetic.get_workload()
+    dataset = get_calibration_dataset(mod, "data")
+    with relay.quantize.qconfig(calibrate_mode="kl_divergence"):
+        mod = relay.quantize.prerequisite_optimize(mod, params)
+        with relay.quantize.quantize_context():
+            mod = relay.quantize.annotate()(relay.quantize.partition()(mod))
+        samples = next(_calibrate.collect_stats(mod, dataset))
+        expected = [_find_scale_by_kl(sample) for sample in samples]
+        # the streaming statistics read an iterator only once
+        stats = _calibrate.stream_stats(mod, iter(dataset), num_workers)
+        scales = [scale.value for scale in _quantize.CalibrationStatsFindScales(stats, 255)]
+    np.testing.assert_allclose(scales, expected, rtol=1e-5)
+
+
 def test_calibrate_percentile():
     mod, params = testing.synthetic.get_workload()
     dataset = get_calibration_dataset(mod, "data")
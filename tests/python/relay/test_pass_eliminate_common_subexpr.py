@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """Test eliminate common subexpr pass"""
+import numpy as np
 import tvm
 from tvm import te
 
@@ -116,6 +117,84 @@ def test_tuple_get_time():
     assert tvm.ir.structural_equal(z, expected())
 
 
+def test_duplicate_constants():
+    x = relay.var("x", shape=(1, 16))
+    w_np = np.random.uniform(size=(16, 16)).astype("float32")
+    y1 = relay.nn.dense(x, relay.const(w_np))
+    y2 = relay.nn.dense(x, relay.const(w_np.copy()))
+    y3 = relay.nn.dense(x, relay.const(w_np + 1))
+    f = relay.Function([x], relay.Tuple([y1, y2, y3]))
+    z = run_opt_pass(f, transform.EliminateCommonSubexpr())
+    assert z.body.fields[0].same_as(z.body.fields[1])
+    assert not z.body.fields[0].same_as(z.body.fields[2])
+
+
+def test_let_bound():
+    def before():
+        x = relay.var("x", shape=(1, 16))
+        a = relay.var("a")
+        b = relay.var("b")
+        body = relay.Let(b, relay.nn.relu(x), relay.add(a, b))
+        return relay.Function([x], relay.Let(a, relay.nn.relu(x), body))
+
+    def expected():
+        x = relay.var("x", shape=(1, 16))
+        a = relay.var("a")
+        f = relay.Function([x], relay.Let(a, relay.nn.relu(x), relay.add(a, a)))
+        return run_opt_pass(f, transform.InferType())
+
+    z = run_opt_pass(before(), transform.EliminateCommonSubexpr())
+    assert tvm.ir.structural_equal(z, expected())
+
+
+def test_let_bound_branches():
+    # the binding of a branch is not in scope in the other one
+    x = relay.var("x", shape=(1, 16))
+    c = relay.var("c", shape=(), dtype="bool")
+    a = relay.var("a")
+    b = relay.var("b")
+    true_branch = relay.Let(a, relay.nn.relu(x), relay.add(a, a))
+    false_branch = relay.Let(b, relay.nn.relu(x), relay.multiply(b, b))
+    f = relay.Function([x, c], relay.If(c, true_branch, false_branch))
+    z = run_opt_pass(f, transform.EliminateCommonSubexpr())
+    assert tvm.ir.structural_equal(z, run_opt_pass(f, transform.InferType()))
+    assert relay.analysis.well_formed(z)
+
+
+def test_primitive_functions():
+    def fused():
+        p = relay.var("p", shape=(1, 16))
+        f = relay.Function([p], relay.nn.relu(relay.add(p, relay.const(1.0))))
+        return f.with_attr("Primitive", 1)
+
+    x = relay.var("x", shape=(1, 16))
+    y = relay.add(relay.Call(fused(), [x]), relay.Call(fused(), [x]))
+    z = run_opt_pass(relay.Function([x], y), transform.EliminateCommonSubexpr())
+    assert z.body.args[0].same_as(z.body.args[1])
+
+
+def test_duplicate_global_functions():
+    def branch():
+        p = relay.var("p", shape=(1, 16))
+        return relay.Function([p], relay.nn.relu(p))
+
+    mod = tvm.IRModule()
+    f0 = relay.GlobalVar("f0")
+    f1 = relay.GlobalVar("f1")
+    mod[f0] = branch()
+    mod[f1] = branch()
+    x = relay.var("x", shape=(1, 16))
+    mod["main"] = relay.Function([x], relay.add(f0(x), f1(x)))
+    mod = transform.EliminateCommonSubexpr()(mod)
+    body = mod["main"].body
+    assert body.args[0].op.same_as(body.args[1].op)
+
+
 if __name__ == "__main__":
     test_simple()
     test_callback()
+    test_duplicate_constants()
+    test_let_bound()
+    test_let_bound_branches()
+    test_primitive_functions()
+    test_duplicate_global_functions()
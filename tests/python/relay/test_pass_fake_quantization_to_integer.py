@@ -399,6 +399,79 @@ def test_fake_quantize_concat():
     compare_fq_to_int(out, inputs_np)
 
 
+def test_fake_quantize_concat_same_scale():
+    zero = relay.const(0)
+    inputs = []
+    for i in range(3):
+        inputs.append(
+            relay.qnn.op.dequantize(
+                relay.var("x%d" % i, shape=[1, 4], dtype="int8"), relay.const(0.5), zero
+            )
+        )
+    concat = relay.op.concatenate(inputs, axis=1)
+    out = relay.qnn.op.quantize(concat, relay.const(1.5), zero)
+
+    mod = tvm.relay.transform.InferType()(tvm.IRModule.from_expr(out))
+    mod_int = tvm.relay.transform.FakeQuantizationToInteger()(mod)
+    # a single requantize of the concatenated inputs
+    assert "qnn.concatenate" not in mod_int.astext()
+    assert mod_int.astext().count("qnn.requantize") == 1
+
+    inputs_np = []
+    for i in range(3):
+        inputs_np.append(np.random.randint(-128, 127, size=[1, 4], dtype="int8"))
+
+    compare_fq_to_int(out, inputs_np, True)
+
+
+def test_fake_quantize_softmax():
+    x = relay.var("x", shape=[1, 16], dtype="int8")
+    w = relay.var("w", shape=[8, 16], dtype="int8")
+    zero = relay.const(0)
+    op = relay.op.nn.dense(
+        relay.qnn.op.dequantize(x, relay.const(0.1), zero),
+        relay.qnn.op.dequantize(w, relay.const(0.05), zero),
+    )
+    op = relay.op.nn.softmax(op)
+    op = relay.qnn.op.quantize(op, relay.const(1.0 / 256), relay.const(-128))
+
+    mod = tvm.relay.transform.InferType()(tvm.IRModule.from_expr(op))
+    mod_int = tvm.relay.transform.FakeQuantizationToInteger()(mod)
+    # the dense runs on integers, only the softmax is left in float
+    assert "qnn.dense" in mod_int.astext()
+
+    x_np = np.random.randint(-128, 127, size=[1, 16], dtype="int8")
+    w_np = np.random.randint(-128, 127, size=[8, 16], dtype="int8")
+
+    compare_fq_to_int(op, [x_np, w_np], True)
+
+
+def test_fake_quantize_layer_norm():
+    x = relay.var("x", shape=[2, 32], dtype="int8")
+    x = relay.qnn.op.dequantize(x, relay.const(0.25), relay.const(3))
+    gamma = relay.const(np.random.uniform(0.5, 1.5, size=[32]).astype("float32"))
+    beta = relay.const(np.random.uniform(-0.5, 0.5, size=[32]).astype("float32"))
+    op = relay.op.nn.layer_norm(x, gamma, beta)
+    op = relay.qnn.op.quantize(op, relay.const(0.05), relay.const(0))
+
+    x_np = np.random.randint(-128, 127, size=[2, 32], dtype="int8")
+
+    compare_fq_to_int(op, [x_np])
+
+
+@pytest.mark.parametrize("method", ["nearest_neighbor", "linear"])
+def test_fake_quantize_resize2d(method):
+    x = relay.var("x", shape=[1, 3, 8, 8], dtype="int8")
+    zero = relay.const(0)
+    x = relay.qnn.op.dequantize(x, relay.const(2.0), zero)
+    op = relay.op.image.resize2d(x, [16, 16], method=method)
+    op = relay.qnn.op.quantize(op, relay.const(2.0), zero)
+
+    x_np = np.random.randint(-128, 127, size=[1, 3, 8, 8], dtype="int8")
+
+    compare_fq_to_int(op, [x_np])
+
+
 def test_fake_quantize_clip():
     x = relay.var("x", shape=[1, 3, 224, 224], dtype="uint8")
 
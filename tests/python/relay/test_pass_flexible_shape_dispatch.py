@@ -0,0 +1,65 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the dispatch of dynamic shapes to specialized buckets"""
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.relay.transform import FlexibleShapeDispatch
+
+
+def get_model():
+    x = relay.var("x", shape=(relay.Any(), 4), dtype="float32")
+    w = relay.var("w", shape=(8, 4), dtype="float32")
+    y = relay.nn.relu(relay.nn.dense(x, w))
+    return tvm.IRModule.from_expr(relay.Function([x, w], y))
+
+
+def run_vm(mod, *args):
+    with tvm.transform.PassContext(opt_level=3):
+        exe = relay.vm.compile(mod, target="llvm")
+    vm = tvm.runtime.vm.VirtualMachine(exe, tvm.cpu())
+    return vm.invoke("main", *args).numpy()
+
+
+def test_dispatch_buckets():
+    mod = FlexibleShapeDispatch(buckets=[1, 4])(get_model())
+    names = sorted(gv.name_hint for gv in mod.get_global_vars())
+    assert names == ["main", "main_bucket_1", "main_bucket_4", "main_generic"]
+    # The buckets are compiled for static shapes.
+    assert list(mod["main_bucket_4"].params[0].checked_type.shape) == [4, 4]
+
+    w = np.random.uniform(-1, 1, (8, 4)).astype("float32")
+    for batch in [1, 3, 4]:
+        x = np.random.uniform(-1, 1, (batch, 4)).astype("float32")
+        tvm.testing.assert_allclose(run_vm(mod, x, w), np.maximum(x @ w.T, 0), rtol=1e-5)
+
+
+def test_dispatch_auto_pad():
+    mod = FlexibleShapeDispatch(buckets=[2, 8], auto_pad=True)(get_model())
+    w = np.random.uniform(-1, 1, (8, 4)).astype("float32")
+    for batch in [1, 5, 8, 9]:
+        x = np.random.uniform(-1, 1, (batch, 4)).astype("float32")
+        out = run_vm(mod, x, w)
+        assert out.shape == (batch, 8)
+        tvm.testing.assert_allclose(out, np.maximum(x @ w.T, 0), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
@@ -366,6 +366,49 @@ def test_fold_dropout():
     tvm.ir.assert_structural_equal(run_infer_type(before_mod["main"]), after_mod["main"])
 
 
+def test_fold_parallel():
+    x = relay.var("x", shape=(8, 8), dtype="float32")
+
+    def before():
+        out = x
+        for i in range(4):
+            c = relay.const(np.full((8, 8), i, dtype="float32"))
+            folded = relay.transpose(relay.multiply(relay.add(c, c), c))
+            out = relay.add(out, relay.split(folded, 2)[1 - i % 2])
+        return relay.Function([x], out)
+
+    def folded(num_threads):
+        with tvm.transform.PassContext(config={"relay.FoldConstant.num_threads": num_threads}):
+            return run_opt_pass(before(), transform.FoldConstant())
+
+    zz = folded(4)
+    ops = []
+    relay.analysis.post_order_visit(
+        zz, lambda n: ops.append(n.op.name) if isinstance(n, relay.Call) else None
+    )
+    assert ops == ["add"] * 4
+    tvm.ir.assert_structural_equal(zz, folded(1))
+
+
+def test_fold_max_constant_bytes():
+    c = relay.const(np.ones((4,), dtype="float32"))
+
+    def before():
+        big = relay.broadcast_to(c, (256, 256))
+        small = relay.add(c, c)
+        return relay.Function([], relay.Tuple([big, small]))
+
+    def expected():
+        big = relay.broadcast_to(c, (256, 256))
+        small = relay.const(np.full((4,), 2, dtype="float32"))
+        return relay.Function([], relay.Tuple([big, small]))
+
+    with tvm.transform.PassContext(config={"relay.FoldConstant.max_constant_bytes": 1024}):
+        zz = run_opt_pass(before(), transform.FoldConstant())
+    zexpected = run_opt_pass(expected(), transform.InferType())
+    tvm.ir.assert_structural_equal(zz, zexpected)
+
+
 if __name__ == "__main__":
     import sys
     import pytest
@@ -0,0 +1,131 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Unit tests for fusing the ops at the boundaries of the external functions."""
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import transform
+
+
+COMPILER = "test_fuse_boundary"
+
+
+@tvm.ir.register_op_attr("nn.relu", "target." + COMPILER)
+def _relu_supported(expr):
+    return True
+
+
+@tvm.ir.register_op_attr("add", "target." + COMPILER)
+def _add_supported(expr):
+    return True
+
+
+def set_func_attr(func, compile_name, symbol_name):
+    func = func.with_attr("Primitive", tvm.tir.IntImm("int32", 1))
+    func = func.with_attr("Inline", tvm.tir.IntImm("int32", 1))
+    func = func.with_attr("Compiler", compile_name)
+    func = func.with_attr("global_symbol", symbol_name)
+    return func
+
+
+def make_external(params, body, name):
+    mod = tvm.IRModule()
+    gv = relay.GlobalVar(name)
+    mod[gv] = set_func_attr(relay.Function(params, body), COMPILER, name)
+    return mod, gv
+
+
+def test_fuse_producer_and_consumer():
+    shape = (4, 8)
+    const = relay.const(np.ones(shape, "float32"))
+
+    def before():
+        a = relay.var("a", shape=shape)
+        b = relay.var("b", shape=shape)
+        mod, gv = make_external([a, b], relay.multiply(a, b), "ext_0")
+        x = relay.var("x", shape=shape)
+        y = relay.var("y", shape=shape)
+        out = relay.add(gv(relay.nn.relu(x), y), const)
+        mod["main"] = relay.Function([x, y], out)
+        return transform.InferType()(mod)
+
+    def expected():
+        a = relay.var("a_in0", shape=shape)
+        b = relay.var("b", shape=shape)
+        body = relay.add(relay.multiply(relay.nn.relu(a), b), const)
+        mod, gv = make_external([a, b], body, "ext_0")
+        x = relay.var("x", shape=shape)
+        y = relay.var("y", shape=shape)
+        mod["main"] = relay.Function([x, y], gv(x, y))
+        return transform.InferType()(mod)
+
+    mod = transform.FuseBoundaryOps()(before())
+    tvm.ir.assert_structural_equal(mod, expected(), map_free_vars=True)
+
+
+def test_keep_shared_and_unsupported_ops():
+    shape = (4, 8)
+
+    def before():
+        a = relay.var("a", shape=shape)
+        mod, gv = make_external([a], relay.multiply(a, a), "ext_0")
+        x = relay.var("x", shape=shape)
+        # The relu also feeds the subtract, and the codegen does not support the subtract.
+        relu = relay.nn.relu(x)
+        out = relay.subtract(gv(relu), relu)
+        mod["main"] = relay.Function([x], out)
+        return transform.InferType()(mod)
+
+    mod = before()
+    tvm.ir.assert_structural_equal(transform.FuseBoundaryOps()(mod), mod)
+
+
+def test_fuse_chain_between_functions():
+    shape = (4, 8)
+
+    def before():
+        a = relay.var("a", shape=shape)
+        mod, gv0 = make_external([a], relay.multiply(a, a), "ext_0")
+        b = relay.var("b", shape=shape)
+        mod1, gv1 = make_external([b], relay.multiply(b, b), "ext_1")
+        mod.update(mod1)
+        x = relay.var("x", shape=shape)
+        out = gv1(relay.nn.relu(relay.nn.relu(gv0(x))))
+        mod["main"] = relay.Function([x], out)
+        return transform.InferType()(mod)
+
+    mod = transform.FuseBoundaryOps()(before())
+    # Both relus moved into the external functions, which now feed each other directly.
+    num_relus = [0]
+
+    def count_relus(expr):
+        if isinstance(expr, relay.Call) and expr.op == relay.op.get("nn.relu"):
+            num_relus[0] += 1
+
+    relay.analysis.post_order_visit(mod["main"], count_relus)
+    assert num_relus[0] == 0
+    for name in ["ext_0", "ext_1"]:
+        relay.analysis.post_order_visit(mod[name], count_relus)
+    assert num_relus[0] == 2
+    tvm.ir.assert_structural_equal(mod["main"].checked_type, before()["main"].checked_type)
+
+
+if __name__ == "__main__":
+    test_fuse_producer_and_consumer()
+    test_keep_shared_and_unsupported_ops()
+    test_fuse_chain_between_functions()
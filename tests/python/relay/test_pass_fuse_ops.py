@@ -823,5 +823,87 @@ def test_fuse_softmax():
         tvm.testing.assert_allclose(result, ref, rtol=1e-4, atol=1e-4)
 
 
+def test_fuse_horizontal():
+    """Test packing the independent ops after a split into one multi-output kernel."""
+
+    def before():
+        x = relay.var("x", shape=(4, 16))
+        heads = relay.split(x, 4, axis=0)
+        outs = [relay.exp(relay.nn.relu(heads[i])) for i in range(4)]
+        # The reduction reads the same split, but is not packed with the injective heads.
+        outs.append(relay.sum(heads[0], axis=1, keepdims=True))
+        return relay.Function([x], relay.Tuple(outs))
+
+    def count_primitive_calls(func):
+        calls = []
+
+        def visit(expr):
+            if isinstance(expr, relay.Call) and isinstance(expr.op, relay.Function):
+                calls.append(expr)
+
+        relay.analysis.post_order_visit(func.body, visit)
+        return len(calls)
+
+    vertical = run_opt_pass(before(), transform.FuseOps())
+    with tvm.transform.PassContext(config={"relay.FuseOps.horizontal": True}):
+        horizontal = run_opt_pass(before(), transform.FuseOps())
+    # The four heads run in one kernel instead of four.
+    assert count_primitive_calls(horizontal) == count_primitive_calls(vertical) - 3
+
+    x_data = np.random.uniform(-1, 1, (4, 16)).astype("float32")
+    for target, dev in tvm.testing.enabled_targets():
+        with tvm.transform.PassContext(opt_level=3, config={"relay.FuseOps.horizontal": True}):
+            mod = tvm.IRModule.from_expr(before())
+            results = relay.create_executor("graph", mod=mod, device=dev, target=target).evaluate()(
+                x_data
+            )
+        heads = np.split(x_data, 4, axis=0)
+        for i in range(4):
+            tvm.testing.assert_allclose(
+                results[i].numpy(), np.exp(np.maximum(heads[i], 0)), rtol=1e-5
+            )
+        tvm.testing.assert_allclose(
+            results[4].numpy(), np.sum(heads[0], axis=1, keepdims=True), rtol=1e-5
+        )
+
+
+def test_fuse_layout_transform_into_anchor():
+    """Test fusing a layout transform into the convolution reading it."""
+
+    def before():
+        x = relay.var("x", shape=(1, 8, 8, 16))
+        w = relay.var("w", shape=(16, 16, 3, 3))
+        y = relay.layout_transform(relay.nn.relu(x), "NHWC", "NCHW")
+        y = relay.nn.conv2d(y, w, channels=16, kernel_size=(3, 3), padding=(1, 1))
+        return relay.Function([x, w], relay.nn.relu(y))
+
+    def count_primitive_calls(func):
+        calls = []
+
+        def visit(expr):
+            if isinstance(expr, relay.Call) and isinstance(expr.op, relay.Function):
+                calls.append(expr)
+
+        relay.analysis.post_order_visit(func.body, visit)
+        return len(calls)
+
+    config = {"relay.FuseOps.fuse_layout_transform": True}
+    assert count_primitive_calls(run_opt_pass(before(), transform.FuseOps())) == 2
+    with tvm.transform.PassContext(config=config):
+        assert count_primitive_calls(run_opt_pass(before(), transform.FuseOps())) == 1
+
+    x_data = np.random.uniform(-1, 1, (1, 8, 8, 16)).astype("float32")
+    w_data = np.random.uniform(-1, 1, (16, 16, 3, 3)).astype("float32")
+    mod = tvm.IRModule.from_expr(before())
+    ref = relay.create_executor("graph", mod=mod, device=tvm.cpu(), target="llvm").evaluate()(
+        x_data, w_data
+    )
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        result = relay.create_executor(
+            "graph", mod=mod, device=tvm.cpu(), target="llvm"
+        ).evaluate()(x_data, w_data)
+    tvm.testing.assert_allclose(result.numpy(), ref.numpy(), rtol=1e-4, atol=1e-4)
+
+
 if __name__ == "__main__":
     pytest.main([__pfile__])
@@ -20,7 +20,9 @@ import pytest
 import tvm
 import tvm.relay
 from tvm.relay import op
-from tvm.ir.instrument import PassTimingInstrument, pass_instrument
+import json
+
+from tvm.ir.instrument import PassStatsInstrument, PassTimingInstrument, pass_instrument
 
 
 def get_test_model():
@@ -59,6 +61,30 @@ def test_pass_timing_instrument():
     assert profiles == ""
 
 
+def test_pass_stats_instrument():
+    pass_stats = PassStatsInstrument()
+    seq = tvm.transform.Sequential(
+        [tvm.relay.transform.InferType(), tvm.relay.transform.ToANormalForm()], name="Seq"
+    )
+    with tvm.transform.PassContext(instruments=[pass_stats]):
+        seq(get_test_model())
+
+    stats = pass_stats.as_json()
+    (top,) = stats["passes"]
+    assert top["name"] == "Seq"
+    names = [child["name"] for child in top["children"]]
+    assert "InferType" in names and "ToANormalForm" in names
+    anf = [child for child in top["children"] if child["name"] == "ToANormalForm"][0]
+    # the let bindings add nodes to the module
+    assert anf["nodes_after"] > anf["nodes_before"]
+    assert stats["summary"]["Seq"]["count"] == 1
+    assert stats["summary"]["Seq"]["self_duration_us"] <= top["duration_us"]
+
+    trace = json.loads(pass_stats.as_chrome_trace())
+    events = [event["name"] for event in trace["traceEvents"]]
+    assert events[0] == "Seq" and "ToANormalForm" in events
+
+
 instrument_definition_type = tvm.testing.parameter("decorator", "subclass")
 
 
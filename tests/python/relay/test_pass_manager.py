@@ -613,5 +613,33 @@ def test_print_debug_callback():
     assert pass_counter.get_counts() == 0
 
 
+def test_function_pass_skip_unchanged():
+    visited = []
+
+    @_transform.function_pass(opt_level=0, name="CountVisits")
+    def count_visits(func, mod, ctx):
+        visited.append(func)
+        return func
+
+    def make_func(value):
+        x = relay.var("x", shape=(2,), dtype="float32")
+        return relay.Function([x], relay.add(x, relay.const(value, "float32")))
+
+    mod = tvm.IRModule({"f": make_func(1.0), "g": make_func(2.0)})
+    config = {"relay.FunctionPass.skip_unchanged": ["CountVisits"]}
+    with tvm.transform.PassContext(config=config):
+        mod = count_visits(mod)
+        assert len(visited) == 2
+        mod = count_visits(mod)
+        assert len(visited) == 2
+        mod["g"] = make_func(3.0)
+        mod = count_visits(mod)
+        assert len(visited) == 3
+
+    # the other passes and contexts are not affected.
+    count_visits(mod)
+    assert len(visited) == 5
+
+
 if __name__ == "__main__":
     pytest.main()
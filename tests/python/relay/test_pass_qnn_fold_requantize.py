@@ -0,0 +1,105 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+from tvm import relay
+
+
+def run_opt_pass(expr):
+    mod = tvm.IRModule.from_expr(expr)
+    mod = relay.transform.InferType()(mod)
+    mod = relay.qnn.transform.FoldRequantize()(mod)
+    return mod
+
+
+def count_ops(mod, op_name):
+    op = relay.op.get(op_name)
+    calls = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and expr.op == op:
+            calls.append(expr)
+
+    relay.analysis.post_order_visit(mod["main"], visit)
+    return len(calls)
+
+
+def run(mod, x_np):
+    return (
+        relay.create_executor("vm", mod=mod, device=tvm.cpu(), target="llvm")
+        .evaluate()(x_np)
+        .numpy()
+    )
+
+
+def check_close(expr, folded, x_np):
+    ref = run(relay.transform.InferType()(tvm.IRModule.from_expr(expr)), x_np)
+    res = run(folded, x_np)
+    assert np.all(np.abs(ref.astype("int32") - res.astype("int32")) <= 1)
+
+
+def test_fold_requantize_chain():
+    x = relay.var("x", shape=[64], dtype="int32")
+    y = relay.qnn.op.requantize(
+        x, relay.const(0.01), relay.const(0), relay.const(0.1), relay.const(0), out_dtype="int32"
+    )
+    y = relay.qnn.op.requantize(
+        y, relay.const(0.1), relay.const(0), relay.const(0.5), relay.const(3), out_dtype="int8"
+    )
+    folded = run_opt_pass(y)
+    assert count_ops(folded, "qnn.requantize") == 1
+    check_close(y, folded, np.random.randint(-10000, 10000, size=[64], dtype="int32"))
+
+
+def test_keep_requantize_clipping():
+    # the int8 intermediate clips a range the outer requantize keeps
+    x = relay.var("x", shape=[64], dtype="int32")
+    y = relay.qnn.op.requantize(
+        x, relay.const(0.01), relay.const(0), relay.const(0.1), relay.const(0), out_dtype="int8"
+    )
+    y = relay.qnn.op.requantize(
+        y, relay.const(0.1), relay.const(0), relay.const(0.5), relay.const(0), out_dtype="int32"
+    )
+    assert count_ops(run_opt_pass(y), "qnn.requantize") == 2
+
+
+def test_fold_dequantize_quantize():
+    x = relay.var("x", shape=[64], dtype="int8")
+    y = relay.qnn.op.dequantize(x, relay.const(0.2), relay.const(1))
+    y = relay.qnn.op.quantize(y, relay.const(0.4), relay.const(-2), out_dtype="int8")
+    folded = run_opt_pass(y)
+    assert count_ops(folded, "qnn.requantize") == 1
+    assert count_ops(folded, "qnn.quantize") == 0
+    check_close(y, folded, np.random.randint(-128, 127, size=[64], dtype="int8"))
+
+
+def test_fold_identity_requantize():
+    x = relay.var("x", shape=[64], dtype="int8")
+    y = relay.qnn.op.requantize(
+        x, relay.const(0.2), relay.const(1), relay.const(0.2), relay.const(1), out_dtype="int8"
+    )
+    y = relay.qnn.op.dequantize(y, relay.const(0.2), relay.const(1))
+    folded = run_opt_pass(y)
+    assert count_ops(folded, "qnn.requantize") == 0
+
+
+if __name__ == "__main__":
+    test_fold_requantize_chain()
+    test_keep_requantize_clipping()
+    test_fold_dequantize_quantize()
+    test_fold_identity_requantize()
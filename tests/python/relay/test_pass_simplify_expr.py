@@ -512,5 +512,34 @@ def test_concretize_multiple():
     assert tvm.ir.structural_equal(actual, expected)
 
 
+def test_simplify_attention():
+    q = relay.var("q", shape=(8, 128, 64), dtype="float32")
+    k = relay.var("k", shape=(8, 256, 64), dtype="float32")
+    v = relay.var("v", shape=(8, 256, 32), dtype="float32")
+
+    def before():
+        scores = relay.nn.batch_matmul(q, k) * relay.const(0.125)
+        probs = relay.nn.softmax(scores, axis=-1)
+        return relay.nn.batch_matmul(probs, v, transpose_b=False)
+
+    def before_transposed_value():
+        scores = relay.nn.batch_matmul(q, k) / relay.const(8.0)
+        probs = relay.nn.softmax(scores)
+        return relay.nn.batch_matmul(probs, relay.transpose(v, [0, 2, 1]))
+
+    def expected():
+        return relay.nn.fused_attention(q, k, v, scale=0.125)
+
+    with tvm.transform.PassContext(config={"relay.SimplifyExpr.fuse_attention": True}):
+        actual = run_opt_pass(before(), relay.transform.SimplifyExpr())
+        actual_transposed = run_opt_pass(before_transposed_value(), relay.transform.SimplifyExpr())
+    assert tvm.ir.structural_equal(actual, run_infer_type(expected()))
+    assert tvm.ir.structural_equal(actual_transposed, run_infer_type(expected()))
+
+    # off by default
+    actual = run_opt_pass(before(), relay.transform.SimplifyExpr())
+    assert tvm.ir.structural_equal(actual, run_infer_type(before()))
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.relay.transform import WeightOnlyQuantize
+
+
+def _quantize(mod, bits, group_size):
+    seq = tvm.transform.Sequential(
+        [relay.transform.InferType(), WeightOnlyQuantize(bits, group_size)]
+    )
+    return relay.transform.InferType()(seq(mod))
+
+
+@tvm.testing.parametrize_targets("llvm")
+def test_weight_only_quantize(dev, target):
+    x = relay.var("x", shape=(2, 256), dtype="float32")
+    w1_np = np.random.uniform(-1, 1, size=(128, 256)).astype("float32")
+    w2_np = np.random.uniform(-1, 1, size=(32, 128)).astype("float32")
+    y = relay.nn.relu(relay.nn.dense(x, relay.const(w1_np)))
+    y = relay.nn.dense(y, relay.const(w2_np))
+    mod = tvm.IRModule.from_expr(relay.Function([x], y))
+
+    for bits in [4, 8]:
+        quantized = _quantize(mod, bits, 64)
+        ops = []
+        relay.analysis.post_order_visit(
+            quantized["main"],
+            lambda expr: ops.append(expr.op.name) if isinstance(expr, relay.Call) else None,
+        )
+        assert ops.count("nn.weight_only_dense") == 2 and "nn.dense" not in ops
+
+        x_np = np.random.uniform(-1, 1, size=(2, 256)).astype("float32")
+        ref = np.maximum(x_np.dot(w1_np.T), 0).dot(w2_np.T)
+        out = relay.create_executor("graph", mod=quantized, device=dev, target=target).evaluate()(
+            x_np
+        )
+        # a loose bound, the rounding errors pile up across the inputs
+        tol = 0.5 if bits == 4 else 0.05
+        tvm.testing.assert_allclose(out.numpy(), ref, rtol=tol, atol=tol * np.abs(ref).max())
+
+
+def test_weight_only_quantize_skips():
+    x = relay.var("x", shape=(2, 100), dtype="float32")
+    w = relay.var("w", shape=(8, 100), dtype="float32")
+    # a weight that is not constant, and an input dimension that is not made of groups
+    y = relay.nn.dense(x, w) + relay.nn.dense(x, relay.const(np.ones((8, 100), "float32")))
+    mod = tvm.IRModule.from_expr(relay.Function([x, w], y))
+    quantized = _quantize(mod, 4, 64)
+    assert tvm.ir.structural_equal(quantized, relay.transform.InferType()(mod))
+
+
+if __name__ == "__main__":
+    import sys
+    import pytest
+
+    sys.exit(pytest.main([__file__] + sys.argv[1:]))
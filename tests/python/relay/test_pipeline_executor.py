@@ -126,6 +126,18 @@ def get_manual_conf(mods, target):
     return mod_config
 
 
+def check_pipeline_outputs(outputs, data):
+    # The reference results of the modules of get_mannual_mod.
+    net1_output1 = data + 1
+    net1_output2 = data - 2
+    net1_output3 = data * 3
+    net2_output = net1_output1 + 2 + data + 3
+    net3_output = net1_output2 * 3 + net2_output
+    assert len(outputs) == 2
+    tvm.testing.assert_allclose(outputs[0].numpy(), net1_output3)
+    tvm.testing.assert_allclose(outputs[1].numpy(), net3_output)
+
+
 def test_pipe_config_check():
     # This function is used to trigger runtime error by applying wrong logic connection.
 
@@ -249,6 +261,23 @@ def test_pipeline():
             pipeline_module_test = pipeline_executor.PipelineModule.load_library(config_file_name)
             assert pipeline_module_test.num_outputs == 2
 
+            # Run the requests through the pipeline, the stages of consecutive requests overlap.
+            for module in [pipeline_module, pipeline_module_test]:
+                module.set_queue_capacity(2)
+                for i, data in enumerate(datas):
+                    module.set_input("data_0", data)
+                    module.set_input("data_1", data)
+                    module.run()
+                    # Keep two requests in flight.
+                    if i >= 2:
+                        check_pipeline_outputs(module.get_output(), datas[i - 2])
+                for data in datas[-2:]:
+                    check_pipeline_outputs(module.get_output(), data)
+                statistics = module.get_statistics()
+                assert [stage["runs"] for stage in statistics["stages"]] == [len(datas)] * 3
+                # mod3 gets the output of mod2 on the same device without a copy.
+                assert statistics["stages"][2]["zero_copy_inputs"] >= len(datas)
+
 
 if __name__ == "__main__":
     pytest.main([__file__])
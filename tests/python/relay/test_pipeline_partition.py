@@ -0,0 +1,148 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import graph_executor, pipeline_executor, pipeline_partition
+
+CPU_STAGES = [("llvm", tvm.cpu(0)), ("llvm", tvm.cpu(0))]
+
+
+def cost_by_op(costs):
+    return lambda call, stage_index: costs[call.op.name]
+
+
+def stage_ops(mod):
+    ops = []
+    relay.analysis.post_order_visit(
+        mod["main"],
+        lambda expr: ops.append(expr.op.name) if isinstance(expr, relay.Call) else None,
+    )
+    return ops
+
+
+def get_chain():
+    # add, add, add, add, relu on a (1, 16) tensor.
+    x = relay.var("x", shape=(1, 16))
+    y = x
+    for i in range(4):
+        y = relay.add(y, relay.const(np.full((1, 16), i, "float32")))
+    y = relay.nn.relu(y)
+    return tvm.IRModule.from_expr(relay.Function([x], y))
+
+
+def test_balanced_cut():
+    mod = get_chain()
+    result = pipeline_partition.partition(
+        mod, CPU_STAGES, op_cost=cost_by_op({"add": 1.0, "nn.relu": 4.0}), bandwidth=1e30
+    )
+    assert len(result.mods) == 2
+    assert stage_ops(result.mods[0]) == ["add"] * 4
+    assert stage_ops(result.mods[1]) == ["nn.relu"]
+    tvm.testing.assert_allclose(result.stage_times, [4.0, 4.0])
+    assert result.transfer_bytes == [0, 64]
+
+
+def test_fewer_transfers():
+    # Cutting before or after the sum is equally balanced, after it moves less data.
+    x = relay.var("x", shape=(1, 1024))
+    a = relay.add(x, relay.const(1.0))
+    b = relay.sum(a, axis=1, keepdims=True)
+    c = relay.multiply(b, relay.const(2.0))
+    mod = tvm.IRModule.from_expr(relay.Function([x], c))
+    result = pipeline_partition.partition(
+        mod,
+        CPU_STAGES,
+        op_cost=cost_by_op({"add": 1.0, "sum": 0.0, "multiply": 1.0}),
+        bandwidth=1e30,
+    )
+    assert stage_ops(result.mods[0]) == ["add", "sum"]
+    assert stage_ops(result.mods[1]) == ["multiply"]
+    assert result.transfer_bytes == [0, 4]
+
+
+def test_too_many_stages():
+    mod = get_chain()
+    with pytest.raises(ValueError):
+        pipeline_partition.partition(mod, CPU_STAGES * 3)
+
+
+def test_estimate_op_cost():
+    data = relay.var("data", shape=(1, 8, 16, 16))
+    weight = relay.var("weight", shape=(4, 8, 3, 3))
+    conv = relay.nn.conv2d(data, weight, padding=(1, 1))
+    mod = relay.transform.InferType()(tvm.IRModule.from_expr(relay.Function([data, weight], conv)))
+    call = mod["main"].body
+    # 1 * 4 * 16 * 16 outputs, 8 * 3 * 3 multiply-accumulates each
+    assert pipeline_partition.estimate_op_cost(call, throughput=1.0) == 1024 * 72
+
+
+@tvm.testing.requires_llvm
+def test_profiled_op_cost():
+    mod = relay.transform.InferType()(get_chain())
+    calls = []
+    relay.analysis.post_order_visit(
+        mod["main"], lambda expr: calls.append(expr) if isinstance(expr, relay.Call) else None
+    )
+    op_cost = pipeline_partition.ProfiledOpCost(CPU_STAGES, number=2, repeat=1)
+    costs = [op_cost(call, 0) for call in calls]
+    assert all(cost > 0 for cost in costs)
+    # The adds only differ by their constant, they are timed once.
+    assert len(op_cost.cache) == 2
+    assert costs[0] == costs[3]
+
+
+@tvm.testing.requires_llvm
+def test_partitioned_pipeline():
+    if not pipeline_executor.pipeline_executor_enabled():
+        return
+    x = relay.var("x", shape=(1, 16, 8, 8))
+    w1 = relay.var("w1", shape=(16, 16, 3, 3))
+    w2 = relay.var("w2", shape=(16, 16, 3, 3))
+    y = relay.nn.relu(relay.nn.conv2d(x, w1, padding=(1, 1)))
+    y = relay.nn.relu(relay.nn.conv2d(y, w2, padding=(1, 1)))
+    z = relay.add(y, x)
+    mod = tvm.IRModule.from_expr(relay.Function([x, w1, w2], relay.Tuple([z, y])))
+    params = {
+        "w1": np.random.uniform(-1, 1, (16, 16, 3, 3)).astype("float32"),
+        "w2": np.random.uniform(-1, 1, (16, 16, 3, 3)).astype("float32"),
+    }
+    data = np.random.uniform(-1, 1, (1, 16, 8, 8)).astype("float32")
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target="llvm", params=params)
+    ref = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    ref.run(x=data)
+    expected = [ref.get_output(i).numpy() for i in range(2)]
+
+    result = pipeline_partition.partition(mod, CPU_STAGES, params=params)
+    assert len(result.mods) == 2
+    with tvm.transform.PassContext(opt_level=3):
+        factory = pipeline_executor.build(result.config)
+    pipeline_module = pipeline_executor.PipelineModule(factory)
+    assert pipeline_module.num_outputs == 2
+    pipeline_module.set_input("x", data)
+    pipeline_module.run()
+    outputs = pipeline_module.get_output()
+    for output, ref_output in zip(outputs, expected):
+        tvm.testing.assert_allclose(output.numpy(), ref_output, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
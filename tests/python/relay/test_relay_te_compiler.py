@@ -21,6 +21,7 @@ import tvm.testing
 from tvm import relay
 from tvm import autotvm
 from tvm import topi
+from tvm.contrib import graph_executor, utils
 from tvm.relay.backend import te_compiler
 from tvm.relay.testing import run_infer_type
 from tvm.relay.testing.temp_op_attr import TempOpAttr
@@ -162,6 +163,85 @@ def test_select_implementation():
                 assert impl.name == "conv2d_1"
 
 
+def _compute_dense_fast(data, weight):
+    k = te.reduce_axis((0, data.shape[1]), name="k")
+    return te.compute(
+        (data.shape[0], weight.shape[0]),
+        lambda i, j: te.sum(data[i, k] * weight[j, k], axis=k),
+    )
+
+
+def _compute_dense_slow(data, weight):
+    # the same result, with a reduction 64 times longer
+    k = te.reduce_axis((0, data.shape[1]), name="k")
+    r = te.reduce_axis((0, 64), name="r")
+    return te.compute(
+        (data.shape[0], weight.shape[0]),
+        lambda i, j: te.sum(
+            tvm.tir.Select(r == 0, data[i, k] * weight[j, k], tvm.tir.const(0, data.dtype)),
+            axis=[k, r],
+        ),
+    )
+
+
+@tvm.target.override_native_generic_func("test_dense_latency_strategy")
+def _latency_strategy(attrs, inputs, out_type, target):
+    strategy = relay.op.OpStrategy()
+    impls = [("slow", _compute_dense_slow, 20), ("fast", _compute_dense_fast, 10)]
+    for name, fcompute, plevel in impls:
+        strategy.add_implementation(
+            lambda attrs, inputs, out_type, fcompute=fcompute: [fcompute(*inputs)],
+            lambda attrs, outs, target: te.create_schedule([x.op for x in outs]),
+            name=name,
+            plevel=plevel,
+        )
+    return strategy
+
+
+@tvm.testing.requires_llvm
+def test_select_implementation_by_latency():
+    target = tvm.target.Target("llvm")
+    dshape, wshape = (16, 64), (32, 64)
+
+    def _select_impl():
+        data = relay.var("data", shape=dshape)
+        weight = relay.var("weight", shape=wshape)
+        out = run_infer_type(relay.nn.dense(data, weight))
+        return te_compiler.select_implementation(
+            relay.op.get("nn.dense"),
+            out.attrs,
+            [te.placeholder(dshape), te.placeholder(wshape)],
+            out.checked_type,
+            target,
+        )
+
+    log_path = utils.tempdir().relpath("latency.log")
+    config = {
+        "relay.backend.measure_implementations": True,
+        "relay.backend.implementation_latency_log": log_path,
+    }
+    with TempOpAttr("nn.dense", "FTVMStrategy", _latency_strategy):
+        impl, _ = _select_impl()
+        assert impl.name == "slow"
+        with tvm.transform.PassContext(config=config):
+            impl, _ = _select_impl()
+            assert impl.name == "fast"
+        with open(log_path) as log:
+            lines = log.readlines()
+        assert len(lines) == 1
+
+        # the measured latencies are reused, within the process and from the log
+        te_compiler._measured_latencies.clear()
+        te_compiler._loaded_latency_logs.clear()
+        with tvm.transform.PassContext(config=config):
+            impl, _ = _select_impl()
+            assert impl.name == "fast"
+            impl, _ = _select_impl()
+            assert impl.name == "fast"
+        with open(log_path) as log:
+            assert log.readlines() == lines
+
+
 def test_te_compiler():
     tec = relay.backend.te_compiler.get()
 
@@ -261,6 +341,58 @@ def test_compile_nhwc_pack():
     relay.build(mod, target="llvm")
 
 
+def test_compile_disk_cache():
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    y = relay.var("y", shape=(4, 8), dtype="float32")
+    func = relay.Function([x, y], relay.nn.relu(x + y) * relay.const(2.0))
+    mod = tvm.IRModule.from_expr(func)
+    x_np = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+    y_np = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+    cache_dir = utils.tempdir()
+    config = {"relay.backend.te_compiler_cache_dir": cache_dir.temp_dir}
+    results = []
+    for _ in range(2):
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            lib = relay.build(mod, target="llvm")
+        rt = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+        rt.set_input("x", x_np, y=y_np)
+        rt.run()
+        results.append(rt.get_output(0).numpy())
+        # the second build reuses the entries of the first one
+        assert len(cache_dir.listdir()) == 1
+    tvm.testing.assert_allclose(results[1], np.maximum(x_np + y_np, 0) * 2)
+    tvm.testing.assert_allclose(results[0], results[1])
+
+
+def test_compile_disk_cache_dispatch_context():
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.nn.relu(x)))
+    cache_dir = utils.tempdir()
+    config = {"relay.backend.te_compiler_cache_dir": cache_dir.temp_dir}
+
+    def build():
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            relay.build(mod, target="llvm")
+
+    build()
+    assert len(cache_dir.listdir()) == 1
+    # the configs picked by the tuning records are part of the entries
+    with autotvm.apply_history_best([]) as context:
+        cfg = autotvm.task.space.FallbackConfigEntity()
+        context.update(tvm.target.Target("llvm"), ("workload",), cfg)
+        build()
+    assert len(cache_dir.listdir()) == 2
+
+    class OpaqueContext(autotvm.task.DispatchContext):
+        def _query_inside(self, target, workload):
+            return None
+
+    # the contexts that cannot be digested do not use the cache
+    with OpaqueContext():
+        build()
+    assert len(cache_dir.listdir()) == 2
+
+
 if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
@@ -270,3 +402,5 @@ if __name__ == "__main__":
     test_compile_tuple_dup()
     test_compile_full()
     test_compile_nhwc_pack()
+    test_compile_disk_cache()
+    test_compile_disk_cache_dispatch_context()
@@ -86,5 +86,46 @@ def test_bsr_sparse_dense():
     np.testing.assert_allclose(sparse_output, dense_output, atol=1e-5, rtol=1e-5)
 
 
+def test_bsr_sparse_dense_select_block_size():
+    data = relay.var("data", shape=(1, 128), dtype="float32")
+    w0 = relay.var("weight0", shape=(768, 128), dtype="float32")
+    w1 = relay.var("weight1", shape=(64, 768), dtype="float32")
+    y = relay.nn.dense(relay.nn.dense(data, w0), w1)
+    func = relay.Function(relay.analysis.free_vars(y), y)
+
+    params = {
+        "weight0": tvm.nd.array(random_bsr_matrix(768, 128, 16, 1, 0.1).todense()),
+        "weight1": tvm.nd.array(random_bsr_matrix(64, 768, 4, 1, 0.1).todense()),
+    }
+    candidates = [(16, 1), (8, 1), (4, 1), (1, 1)]
+    _, new_params = relay.data_dep_optimization.bsr_dense.convert(func, params, candidates, 0.85)
+    assert new_params["weight0.data"].shape[1:] == (16, 1)
+    assert new_params["weight1.data"].shape[1:] == (4, 1)
+
+
+def test_bsr_sparse_dense_build_config():
+    data = relay.var("data", shape=(1, 128), dtype="float32")
+    w = relay.var("weight", shape=(768, 128), dtype="float32")
+    y = relay.nn.relu(relay.nn.dense(data, w))
+    func = relay.Function(relay.analysis.free_vars(y), y)
+    params = {"weight": tvm.nd.array(random_bsr_matrix(768, 128, 8, 1, 0.1).todense())}
+
+    x_np = np.random.randn(1, 128).astype("float32")
+    dense_output = run_func(func, params, x_np)
+    config = {"relay.DenseToSparse.sparsity_threshold": 0.8}
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        lib = relay.build(func, "llvm", params=params)
+    assert "sparse_dense" in lib.get_graph_json()
+
+    from tvm.contrib import graph_executor
+
+    m = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    m.set_input("data", x_np)
+    m.run()
+    np.testing.assert_allclose(m.get_output(0).numpy(), dense_output, atol=1e-5, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_bsr_sparse_dense()
+    test_bsr_sparse_dense_select_block_size()
+    test_bsr_sparse_dense_build_config()
@@ -459,5 +459,71 @@ def test_batch_matmul_simple():
     assert tvm.ir.structural_equal(expected_mod, output_mod)
 
 
+def get_call_dtypes(mod, op_name):
+    dtypes = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and expr.op == relay.op.get(op_name):
+            dtypes.append(expr.checked_type.dtype)
+
+    relay.analysis.post_order_visit(mod["main"], visit)
+    return dtypes
+
+
+def test_minimize_casts():
+    """A FOLLOW op between two convolutions also reading a small FP32 tensor.
+
+    Following its inputs, the add runs in FP32 and the large convolution outputs are cast
+    twice. Minimizing the casts runs it in FP16 and casts the small softmax output instead.
+    """
+    data_shape = (1, 8, 16, 16)
+    weight_shape = (8, 8, 3, 3)
+    data = relay.var("data", shape=data_shape, dtype="float32")
+    bias = relay.var("bias", shape=(1, 8, 1, 1), dtype="float32")
+    weight = relay.var("weight", shape=weight_shape, dtype="float32")
+    conv = relay.nn.conv2d(data, weight, padding=(1, 1), out_dtype="float32")
+    add = relay.add(conv, relay.nn.softmax(bias, axis=1))
+    result = relay.nn.conv2d(add, weight, padding=(1, 1), out_dtype="float32")
+    mod = InferType()(tvm.IRModule.from_expr(result))
+
+    assert get_call_dtypes(InferType()(ToMixedPrecision()(mod)), "add") == ["float32"]
+    with tvm.transform.PassContext(config={"relay.ToMixedPrecision.minimize_casts": True}):
+        fp16_mod = InferType()(ToMixedPrecision()(mod))
+    assert get_call_dtypes(fp16_mod, "add") == ["float16"]
+
+    mod_params = {
+        "data": np.random.uniform(-1, 1, size=data_shape).astype("float32"),
+        "bias": np.random.uniform(-1, 1, size=(1, 8, 1, 1)).astype("float32"),
+        "weight": np.random.uniform(-1, 1, size=weight_shape).astype("float32"),
+    }
+    np.testing.assert_allclose(
+        run_module(mod, mod_params)[0], run_module(fp16_mod, mod_params)[0], rtol=0.01, atol=0.05
+    )
+
+
+def test_sensitivity_profile():
+    """The layers scoring above max_sensitivity stay in FP32."""
+    data_shape = (1, 3, 32, 32)
+    weight_shape = (3, 3, 3, 3)
+    data = relay.var("data", shape=data_shape, dtype="float32")
+    weight = relay.var("weight", shape=weight_shape, dtype="float32")
+    conv = relay.nn.conv2d(data, weight, padding=(1, 1), out_dtype="float32")
+    result = relay.nn.conv2d(conv, weight, padding=(1, 1), out_dtype="float32")
+    mod = InferType()(tvm.IRModule.from_expr(result))
+
+    config = {
+        "relay.ToMixedPrecision.sensitivity": {"nn.conv2d:1": 0.5, "nn.conv2d:0": 0.01},
+        "relay.ToMixedPrecision.max_sensitivity": 0.1,
+    }
+    with tvm.transform.PassContext(config=config):
+        fp16_mod = InferType()(ToMixedPrecision()(mod))
+    assert get_call_dtypes(fp16_mod, "nn.conv2d") == ["float16", "float32"]
+
+    config = {"relay.ToMixedPrecision.sensitivity": {"nn.conv2d": 1.0}}
+    with tvm.transform.PassContext(config=config):
+        fp32_mod = InferType()(ToMixedPrecision()(mod))
+    assert get_call_dtypes(fp32_mod, "nn.conv2d") == ["float32", "float32"]
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
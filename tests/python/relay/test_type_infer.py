@@ -545,6 +545,28 @@ def test_repeat_register():
         assert "Operator custom_log3 is registered before" in str(cm.execption)
 
 
+def test_incremental_infer_type():
+    x = relay.var("x", shape=(3,), dtype="float32")
+    y = relay.var("y", shape=(3,), dtype="float32")
+    g = relay.GlobalVar("g")
+    mod = tvm.IRModule()
+    mod[g] = relay.Function([x], x + x)
+    mod["main"] = relay.Function([y], g(y))
+    mod = relay.transform.InferType()(mod)
+    # the return type of g, inferred by the first InferType, is now annotated
+    mod = relay.transform.InferType()(mod)
+    main = mod["main"]
+    # the functions left untouched are not inferred again
+    mod = relay.transform.InferType()(mod)
+    assert mod["main"].same_as(main)
+    assert mod["main"].checked_type == main.checked_type
+    # a new signature of g invalidates main
+    z = relay.var("z", shape=(3,), dtype="int32")
+    mod[g] = relay.Function([z], z)
+    with pytest.raises(tvm.error.TVMError):
+        relay.transform.InferType()(mod)
+
+
 if __name__ == "__main__":
     import sys
 
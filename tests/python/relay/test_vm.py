@@ -1112,6 +1112,110 @@ def test_multi_targets():
     tvm.testing.assert_allclose(actual_result.numpy(), expected_result)
 
 
+def test_storage_arena():
+    x = relay.var("x", shape=(8, 16), dtype="float32")
+    y = relay.nn.relu(relay.add(x, relay.const(1.0)))
+    z = relay.multiply(y, y)
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.Tuple([y, z])))
+    with tvm.transform.PassContext(opt_level=0):
+        exe = relay.vm.compile(mod, target="llvm")
+    vm = runtime.vm.VirtualMachine(exe, tvm.cpu())
+    vm.set_storage_arena(True)
+
+    x_np = np.random.uniform(-1, 1, size=(8, 16)).astype("float32")
+    y_np = np.maximum(x_np + 1, 0)
+    first = vm.run(x_np)
+    # The outputs of the first call stay alive, so the second call needs a fresh arena.
+    second = vm.run(x_np * 2)
+    tvm.testing.assert_allclose(first[0].numpy(), y_np)
+    tvm.testing.assert_allclose(first[1].numpy(), y_np * y_np)
+    y2_np = np.maximum(x_np * 2 + 1, 0)
+    tvm.testing.assert_allclose(second[1].numpy(), y2_np * y2_np)
+    del first, second
+    for _ in range(2):
+        tvm.testing.assert_allclose(vm.run(x_np)[1].numpy(), y_np * y_np)
+
+
+def test_shape_func_memoized():
+    x = relay.var("x", shape=(relay.Any(), 4), dtype="float32")
+    y = relay.var("y", shape=(relay.Any(),), dtype="int64")
+    z = relay.concatenate([relay.add(x, relay.const(1.0)), x], axis=0)
+    w = relay.reshape(z, newshape=(-1,))
+    mod = tvm.IRModule.from_expr(relay.Function([x, y], relay.Tuple([w, relay.add(y, y)])))
+    exe = relay.vm.compile(mod, target="llvm")
+    vm = runtime.vm.VirtualMachine(exe, tvm.cpu())
+
+    # The shape functions see the same inputs again, and then new ones.
+    for n in [3, 3, 5, 3, 1]:
+        x_np = np.random.uniform(size=(n, 4)).astype("float32")
+        y_np = np.arange(n + 2).astype("int64")
+        w_out, y_out = vm.run(x_np, y_np)
+        tvm.testing.assert_allclose(w_out.numpy(), np.concatenate([x_np + 1, x_np]).reshape(-1))
+        tvm.testing.assert_allclose(y_out.numpy(), y_np * 2)
+
+
+def test_paged_kv_cache():
+    cache = runtime.vm.PagedKVCache(4, 2, [3])
+    assert tuple(cache.pool.shape) == (4, 2, 3)
+    assert cache.reserve(0, 3)
+    assert cache.num_free_blocks == 2
+    # a reservation the cache cannot hold takes nothing
+    assert not cache.reserve(1, 5)
+    assert cache.num_free_blocks == 2
+    assert cache.reserve(1, 4)
+    np.testing.assert_equal(cache.block_table([0, 1]).numpy(), [[0, 1], [2, 3]])
+    cache.free(0)
+    assert cache.reserve(2, 1)
+    np.testing.assert_equal(cache.block_table([2, 1]).numpy(), [[0, -1], [2, 3]])
+    cache.free(1)
+    cache.free(2)
+    assert cache.num_free_blocks == 4
+
+
+def test_paged_kv_cache_fork():
+    cache = runtime.vm.PagedKVCache(4, 2, [1])
+    assert cache.reserve(0, 3)
+    pool_np = np.arange(8, dtype="float32").reshape(4, 2, 1)
+    cache.pool.copyfrom(pool_np)
+    cache.fork(0, 1)
+    # the forks share the full block and the block they both write further
+    np.testing.assert_equal(cache.block_table([0, 1]).numpy(), [[0, 1], [0, 1]])
+    assert cache.num_free_blocks == 2
+    assert cache.reserve(1, 4)
+    np.testing.assert_equal(cache.block_table([0, 1]).numpy(), [[0, 1], [0, 2]])
+    np.testing.assert_equal(cache.pool.numpy()[2], pool_np[1])
+    # the parent owns its block alone now
+    assert cache.reserve(0, 4)
+    np.testing.assert_equal(cache.block_table([0]).numpy(), [[0, 1]])
+    cache.free(0)
+    assert cache.num_free_blocks == 2
+    cache.free(1)
+    assert cache.num_free_blocks == 4
+
+
+def test_continuous_batching():
+    tokens = relay.var("tokens", shape=(relay.Any(),), dtype="int32")
+    positions = relay.var("positions", shape=(relay.Any(),), dtype="int32")
+    block_table = relay.var("block_table", shape=(relay.Any(), relay.Any()), dtype="int32")
+    pool = relay.var("pool", shape=(3, 2, 4), dtype="float32")
+    # a toy decoder predicting the next integer
+    body = relay.Tuple([relay.add(tokens, relay.const(1)), relay.add(pool, relay.const(1.0))])
+    mod = tvm.IRModule()
+    mod["decode"] = relay.Function([tokens, positions, block_table, pool], body)
+    exe = relay.vm.compile(mod, target="llvm")
+    vm = runtime.vm.VirtualMachine(exe, tvm.cpu())
+
+    # the three blocks cannot hold the four positions of both first sequences
+    cache = runtime.vm.PagedKVCache(3, 2, [4])
+    batcher = runtime.vm.ContinuousBatcher(vm, cache, max_batch_size=2)
+    first = batcher.add_request([1, 2, 3], max_new_tokens=2)
+    second = batcher.add_request([10], max_new_tokens=4)
+    third = batcher.add_request([7], max_new_tokens=5, stop_token=8)
+    outputs = batcher.run()
+    assert outputs == {first: [4, 5], second: [11, 12, 13, 14], third: [8]}
+    assert cache.num_free_blocks == 3
+
+
 if __name__ == "__main__":
     import sys
 
@@ -145,6 +145,26 @@ def test_save_load():
     tvm.testing.assert_allclose(res.numpy(), x_data + x_data)
 
 
+def test_load_exec_from_file():
+    x = relay.var("x", shape=(64, 64), dtype="float32")
+    c_data = np.random.rand(64, 64).astype("float32")
+    f = relay.Function([x], x + relay.const(c_data))
+    x_data = np.random.rand(64, 64).astype("float32")
+
+    exe = create_exec(f)
+    code, lib = exe.save()
+    tmp = utils.tempdir()
+    path_code = tmp.relpath("code.ro")
+    with open(path_code, "wb") as fo:
+        fo.write(code)
+
+    # The constants are used in place from the mapped file.
+    des_exec = _vm.Executable.load_exec_from_file(path_code, lib)
+    des_vm = _vm.VirtualMachine(des_exec, tvm.cpu())
+    res = des_vm.run(x_data)
+    tvm.testing.assert_allclose(res.numpy(), x_data + c_data)
+
+
 def test_const():
     c = relay.const(1.0, "float32")
     x = relay.var("x", shape=(10, 10), dtype="float32")
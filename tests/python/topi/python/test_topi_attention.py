@@ -0,0 +1,75 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test code for FIFO buffer"""
+"""Test code for the attention operators"""
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import te, topi
+
+
+def verify_paged_attention(seq_lens, num_heads, dim, v_dim, block_size, scale):
+    batch = len(seq_lens)
+    max_blocks = max((l + block_size - 1) // block_size for l in seq_lens)
+    num_blocks = batch * max_blocks + 1
+    # the blocks of the sequences are scattered over the cache
+    perm = np.random.permutation(num_blocks).astype("int32")
+    table_np = np.full((batch, max_blocks), -1, dtype="int32")
+    k_cache_np = np.random.uniform(-1, 1, size=(num_blocks, block_size, num_heads, dim))
+    v_cache_np = np.random.uniform(-1, 1, size=(num_blocks, block_size, num_heads, v_dim))
+    k_cache_np = k_cache_np.astype("float32")
+    v_cache_np = v_cache_np.astype("float32")
+    q_np = np.random.uniform(-1, 1, size=(batch, num_heads, dim)).astype("float32")
+    out_np = np.zeros((batch, num_heads, v_dim), dtype="float32")
+    next_block = 0
+    for b, seq_len in enumerate(seq_lens):
+        num_seq_blocks = (seq_len + block_size - 1) // block_size
+        table_np[b, :num_seq_blocks] = perm[next_block : next_block + num_seq_blocks]
+        next_block += num_seq_blocks
+        blocks = table_np[b, :num_seq_blocks]
+        keys = k_cache_np[blocks].reshape(-1, num_heads, dim)[:seq_len]
+        values = v_cache_np[blocks].reshape(-1, num_heads, v_dim)[:seq_len]
+        for h in range(num_heads):
+            scores = scale * keys[:, h, :].dot(q_np[b, h])
+            probs = np.exp(scores - scores.max())
+            out_np[b, h] = (probs / probs.sum()).dot(values[:, h, :])
+
+    q = te.placeholder(q_np.shape, name="q")
+    k_cache = te.placeholder(k_cache_np.shape, name="k_cache")
+    v_cache = te.placeholder(v_cache_np.shape, name="v_cache")
+    table = te.placeholder(table_np.shape, name="table", dtype="int32")
+    lens = te.placeholder((batch,), name="lens", dtype="int32")
+    out = topi.nn.paged_attention(q, k_cache, v_cache, table, lens, scale)
+    s = te.create_schedule(out.op)
+    f = tvm.build(s, [q, k_cache, v_cache, table, lens, out], "llvm")
+    dev = tvm.cpu()
+    out_nd = tvm.nd.empty(out_np.shape, device=dev)
+    args = [q_np, k_cache_np, v_cache_np, table_np, np.array(seq_lens, dtype="int32")]
+    f(*[tvm.nd.array(x, dev) for x in args], out_nd)
+    tvm.testing.assert_allclose(out_nd.numpy(), out_np, rtol=1e-5, atol=1e-5)
+
+
+def test_paged_attention():
+    verify_paged_attention([1], 1, 8, 8, 4, 1.0)
+    # lengths that are not a multiple of the block size
+    verify_paged_attention([5, 16, 9], 4, 16, 8, 4, 0.25)
+    verify_paged_attention([33, 2], 2, 32, 32, 16, 0.125)
+
+
+if __name__ == "__main__":
+    test_paged_attention()
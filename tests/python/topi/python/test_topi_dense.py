@@ -181,5 +181,35 @@ def test_dense_cuda_int8(
         )
 
 
+@pytest.mark.parametrize("target,in_dtype,out_dtype", [("llvm", "float32", "float32")])
+@pytest.mark.parametrize("in_dim,out_dim", [(1024, 1024)])
+def test_dense_micro_kernel(
+    target,
+    dev,
+    batch_size,
+    in_dim,
+    out_dim,
+    use_bias,
+    dense_ref_data,
+    in_dtype,
+    out_dtype,
+):
+    implementations = [
+        (topi.x86.dense_pack_micro_kernel, topi.x86.schedule_dense_pack_micro_kernel),
+    ]
+    test_dense(
+        target,
+        dev,
+        batch_size,
+        in_dim,
+        out_dim,
+        use_bias,
+        dense_ref_data,
+        in_dtype,
+        out_dtype,
+        implementations=implementations,
+    )
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main(sys.argv))
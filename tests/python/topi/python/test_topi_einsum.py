@@ -55,6 +55,10 @@ def verify_einsum(subscripts, shapes):
         c2 = with_tvm(lambda A, B: topi.einsum(subscripts, A, B), *ops)
     elif len(ops) == 3:
         c2 = with_tvm(lambda A, B, C: topi.einsum(subscripts, A, B, C), *ops)
+    elif len(ops) == 4:
+        c2 = with_tvm(lambda A, B, C, D: topi.einsum(subscripts, A, B, C, D), *ops)
+    elif len(ops) == 5:
+        c2 = with_tvm(lambda A, B, C, D, E: topi.einsum(subscripts, A, B, C, D, E), *ops)
 
     tvm.testing.assert_allclose(c1, c2, rtol=1e-5, atol=1e-5)
 
@@ -74,5 +78,21 @@ def test_einsum():
     verify_einsum("ij,jk,km->im", [(2, 3), (3, 4), (4, 5)])
 
 
+def test_einsum_contraction_path():
+    # contracted pairwise, along an exhaustively searched order
+    verify_einsum("ij,jk,kl", [(2, 3), (3, 4), (4, 5)])
+    verify_einsum("bij,bjk,bkl->bli", [(2, 3, 4), (2, 4, 5), (2, 5, 3)])
+    verify_einsum("ab,cd,bc->", [(2, 3), (4, 5), (3, 4)])
+    verify_einsum("ijk,kl,m->jm", [(2, 3, 4), (4, 5), (6,)])
+    verify_einsum("...ij,...jk,...kl->...il", [(2, 3, 4), (2, 4, 5), (2, 5, 6)])
+    verify_einsum("ab,bc,cd,de->ae", [(2, 3), (3, 4), (4, 5), (5, 2)])
+    # contracted pairwise, along a greedy order
+    verify_einsum("ab,bc,cd,de,ef->fa", [(2, 3), (3, 4), (4, 5), (5, 2), (2, 3)])
+    # broadcast and repeated labels fall back to a single loop nest
+    verify_einsum("ij,jk,jk->ik", [(2, 3), (1, 4), (3, 4)])
+    verify_einsum("ii,ij,jk->k", [(3, 3), (3, 4), (4, 2)])
+
+
 if __name__ == "__main__":
     test_einsum()
+    test_einsum_contraction_path()
@@ -716,5 +716,51 @@ def test_all_class_non_max_suppression(target, dev):
     )
 
 
+@tvm.testing.parametrize_targets("cuda", "vulkan")
+@pytest.mark.parametrize("use_bitmask", [True, False])
+def test_non_max_suppression_many_boxes(target, dev, use_bitmask, monkeypatch):
+    # more boxes than the bits of a bitmask word, compared with the CPU implementation
+    if not use_bitmask:
+        monkeypatch.setattr(tvm.topi.cuda.nms, "_NMS_BITMASK_MAX_BYTES", 0)
+    batch, num_anchors = 2, 150
+    np.random.seed(1)
+    corners = np.random.uniform(0, 80, size=(batch, num_anchors, 2))
+    sizes = np.random.uniform(10, 40, size=(batch, num_anchors, 2))
+    np_data = np.concatenate(
+        [
+            np.random.randint(0, 3, size=(batch, num_anchors, 1)),
+            np.random.uniform(0.1, 1, size=(batch, num_anchors, 1)),
+            corners,
+            corners + sizes,
+        ],
+        axis=2,
+    ).astype("float32")
+    np_valid_count = np.array([num_anchors, 120]).astype("int32")
+    np_indices = np.tile(np.arange(num_anchors, dtype="int32"), (batch, 1))
+
+    data = te.placeholder(np_data.shape, name="data")
+    valid_count = te.placeholder((batch,), dtype="int32", name="valid_count")
+    indices = te.placeholder((batch, num_anchors), dtype="int32", name="indices")
+    outs = []
+    for tgt, implement in [("llvm", _nms_implement["generic"]), (target, _nms_implement["gpu"])]:
+        fcompute, fschedule = implement
+        with tvm.target.Target(tgt):
+            out = fcompute(
+                data, valid_count, indices, 40, 0.5, False, 100, 2, 1, 0, return_indices=False
+            )
+            s = fschedule(out)
+        device = tvm.cpu() if tgt == "llvm" else dev
+        tvm_out = tvm.nd.array(np.zeros(np_data.shape, dtype="float32"), device)
+        f = tvm.build(s, [data, valid_count, indices, out], tgt)
+        f(
+            tvm.nd.array(np_data, device),
+            tvm.nd.array(np_valid_count, device),
+            tvm.nd.array(np_indices, device),
+            tvm_out,
+        )
+        outs.append(tvm_out.numpy())
+    tvm.testing.assert_allclose(outs[1], outs[0], rtol=1e-4)
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main(sys.argv))
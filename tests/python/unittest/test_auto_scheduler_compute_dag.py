@@ -43,6 +43,24 @@ def test_infer_bound():
     s = dag.infer_bound_from_state(s)
 
 
+def test_infer_bound_cached():
+    dag, s = get_tiled_matmul()
+    first = dag.infer_bound_from_state(s)
+    # The second inference of the same steps reuses the bounds of the first one
+    second = dag.infer_bound_from_state(s)
+    assert str(first) == str(second)
+
+    # The states built by other steps get their own bounds
+    A, B, C = matmul_auto_scheduler_test(512, 512, 512)
+    dag = auto_scheduler.ComputeDAG([A, B, C])
+    for factor in [4, 8, 4]:
+        s = dag.get_init_state()
+        s.split(C, s[C].iters[0], [factor])
+        s = dag.infer_bound_from_state(s)
+        assert s[C].iters[0].range.extent == 512 // factor
+        assert s[C].iters[1].range.extent == factor
+
+
 def test_estimate_flop():
     N = 512
     A, B, C = matmul_auto_scheduler_test(N, N, N)
@@ -152,6 +170,7 @@ def test_invalid_compute_dag():
 if __name__ == "__main__":
     test_apply_steps()
     test_infer_bound()
+    test_infer_bound_cached()
     test_estimate_flop()
     test_stage_order()
     test_invalid_compute_dag()
@@ -17,6 +17,7 @@
 
 """Test cost models"""
 
+import json
 import tempfile
 
 import numpy as np
@@ -79,6 +80,67 @@ def test_xgb_model():
     model.load(tmpfile)
 
 
+def test_gbtree_model():
+    task, inputs, results = get_sample_records(50)
+    states = [x.state for x in inputs]
+
+    # f0 < 0.5 ? 1.0 : 2.0, plus a constant tree and a base score of 0.5
+    model_json = json.dumps(
+        {
+            "learner": {
+                "learner_model_param": {"base_score": "5E-1"},
+                "gradient_booster": {
+                    "name": "gbtree",
+                    "model": {
+                        "trees": [
+                            {
+                                "left_children": [1, -1, -1],
+                                "right_children": [2, -1, -1],
+                                "split_indices": [0, 0, 0],
+                                "split_conditions": [0.5, 1.0, 2.0],
+                                "default_left": [0, 0, 0],
+                            },
+                            {
+                                "left_children": [-1],
+                                "right_children": [-1],
+                                "split_indices": [0],
+                                "split_conditions": [0.25],
+                                "default_left": [0],
+                            },
+                        ]
+                    },
+                },
+            }
+        }
+    )
+    model = auto_scheduler.GBTreeModel(model_json)
+    assert model.num_trees == 2
+    features = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    expected = [np.sum(np.where(f[:, 0] < 0.5, 1.75, 2.75)) for f in features]
+    np.testing.assert_allclose(model.predict(task, states), expected, rtol=1e-5)
+
+    # no model, random predictions
+    model.load_json("")
+    assert model.num_trees == 0
+    assert len(model.predict(task, states)) == len(states)
+
+
+def test_gbtree_model_from_xgb():
+    task, inputs, results = get_sample_records(50)
+    states = [x.state for x in inputs]
+
+    trainer = auto_scheduler.XGBModel(num_warmup_sample=-1)
+    model = auto_scheduler.GBTreeModel(trainer=trainer)
+    assert model.num_trees == 0
+    model.update(inputs, results)
+    assert model.num_trees > 0
+    np.testing.assert_allclose(
+        model.predict(task, states), trainer.predict(task, states), rtol=1e-4, atol=1e-5
+    )
+
+
 if __name__ == "__main__":
     test_random_model()
     test_xgb_model()
+    test_gbtree_model()
+    test_gbtree_model_from_xgb()
@@ -20,6 +20,8 @@
 import math
 import tempfile
 
+import numpy as np
+
 import tvm
 from tvm import te, auto_scheduler
 
@@ -200,7 +202,43 @@ def test_gpu_feature():
         assert fequal(fea_dicts[0]["is_gpu"], 1.0)
 
 
+def test_feature_cache():
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(128, 128, 128), target="llvm"
+    )
+    policy = auto_scheduler.SketchPolicy(task, verbose=0)
+    states = policy.sample_initial_population()[:20]
+
+    auto_scheduler.feature.clear_feature_cache()
+    features = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    stats = auto_scheduler.feature.get_feature_cache_stats()
+    assert stats["hits"] + stats["misses"] == len(states)
+    assert 0 < stats["num_entries"] <= len(states)
+    first_hits = stats["hits"]
+
+    # the same states are read back from the cache
+    cached = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    stats = auto_scheduler.feature.get_feature_cache_stats()
+    assert stats["hits"] == first_hits + len(states)
+    for x, y in zip(features, cached):
+        np.testing.assert_equal(x, y)
+
+    # a small capacity evicts the least recently used states
+    old_capacity = stats["capacity_nbytes"]
+    try:
+        auto_scheduler.feature.set_feature_cache_capacity(stats["nbytes"] // 2)
+        stats = auto_scheduler.feature.get_feature_cache_stats()
+        assert stats["evictions"] > 0 and stats["nbytes"] <= stats["capacity_nbytes"]
+        auto_scheduler.feature.set_feature_cache_capacity(0)
+        auto_scheduler.feature.get_per_store_features_from_states(states, task)
+        assert auto_scheduler.feature.get_feature_cache_stats()["num_entries"] == 0
+    finally:
+        auto_scheduler.feature.set_feature_cache_capacity(old_capacity)
+        auto_scheduler.feature.clear_feature_cache()
+
+
 if __name__ == "__main__":
     test_cpu_matmul()
     test_cpu_fusion()
     test_gpu_feature()
+    test_feature_cache()
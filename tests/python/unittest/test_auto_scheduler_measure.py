@@ -203,6 +203,67 @@ def test_recover_measure_input():
         assert str(correct_inp.state) == str(inp.state)
 
 
+def test_binary_record_log():
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(64, 64, 64), target="llvm"
+    )
+    other_task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(32, 32, 32), target="llvm"
+    )
+
+    inputs, results = [], []
+    for i in range(6):
+        cur_task = task if i % 2 == 0 else other_task
+        state = cur_task.compute_dag.init_state
+        inputs.append(auto_scheduler.measure.MeasureInput(cur_task, state))
+        results.append(auto_scheduler.measure.MeasureResult([0.1 * (i + 1)], 0, "", 0.2, i))
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        json_file = tmpdir + "/log.json"
+        binary_file = tmpdir + "/log.bin"
+        json_file_back = tmpdir + "/log_back.json"
+        auto_scheduler.save_records(json_file, inputs, results)
+        assert auto_scheduler.measure_record.convert_records_to_binary(json_file, binary_file) == 6
+
+        # The binary log reads the same records as the json log
+        json_inputs, json_results = auto_scheduler.RecordReader(json_file).read_lines()
+        bin_inputs, bin_results = auto_scheduler.RecordReader(binary_file).read_lines()
+        assert len(bin_inputs) == 6
+        for json_inp, bin_inp in zip(json_inputs, bin_inputs):
+            assert json_inp.task.workload_key == bin_inp.task.workload_key
+            assert str(json_inp.state) == str(bin_inp.state)
+        for json_res, bin_res in zip(json_results, bin_results):
+            assert str(json_res) == str(bin_res)
+
+        # Skipping, reading forward and the workload index
+        reader = auto_scheduler.RecordReader(binary_file)
+        _, skipped = reader.read_lines(max_lines=2, skip_lines=1)
+        assert [int(r.timestamp) for r in skipped] == [1, 2]
+        assert [int(r.timestamp) for _, r in reader] == [3, 4, 5]
+        _, workload_results = reader.read_workload(task.workload_key)
+        assert [int(r.timestamp) for r in workload_results] == [0, 2, 4]
+        _, workload_results = auto_scheduler.RecordReader(json_file).read_workload(
+            other_task.workload_key
+        )
+        assert [int(r.timestamp) for r in workload_results] == [1, 3, 5]
+
+        num_records = auto_scheduler.measure_record.convert_records_to_json(
+            binary_file, json_file_back
+        )
+        assert num_records == 6
+        with open(json_file) as f_json, open(json_file_back) as f_back:
+            assert f_json.read() == f_back.read()
+
+        # The error messages are not stored by either format, only the error numbers are
+        error_result = auto_scheduler.measure.MeasureResult([0.1], 2, "compile error", 0.2, 6)
+        auto_scheduler.save_records(json_file, inputs[:1], [error_result])
+        auto_scheduler.measure_record.convert_records_to_binary(json_file, binary_file)
+        for log_file in [json_file, binary_file]:
+            _, log_results = auto_scheduler.RecordReader(log_file).read_lines()
+            assert int(log_results[-1].error_no) == 2
+            assert log_results[-1].error_msg == ""
+
+
 def test_workload_dis_factor():
     calc = auto_scheduler.utils.calc_workload_dis_factor
     decode = auto_scheduler.utils.decode_workload_key
@@ -257,6 +318,42 @@ def test_measure_local_builder_runner():
         assert mress[0].error_no == 0
 
 
+def test_measure_program_cache():
+    if not tvm.testing.device_enabled("llvm"):
+        return
+
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(64, 64, 64), target="llvm"
+    )
+    s0 = task.compute_dag.init_state
+    C = s0.stage_ops[2]
+    i, j, k = s0[C].iters
+    # The same program reached through other steps
+    s1 = s0.copy()
+    s1.reorder(C, [j, i, k])
+    s1.reorder(C, [i, j, k])
+    inputs = [auto_scheduler.MeasureInput(task, s) for s in [s0, s1]]
+    policy = auto_scheduler.EmptyPolicy(task)
+
+    with tempfile.NamedTemporaryFile() as fp:
+        measurer = auto_scheduler.measure.ProgramMeasurer(
+            auto_scheduler.LocalBuilder(), auto_scheduler.LocalRunner(), [], 0, cache_file=fp.name
+        )
+        results = measurer.measure(task, policy, inputs)
+        assert all(res.error_no == 0 for res in results)
+        assert [c.value for c in results[0].costs] == [c.value for c in results[1].costs]
+        with open(fp.name) as f:
+            assert len(f.readlines()) == 1
+
+        # A new session does not measure the cached program again
+        measurer = auto_scheduler.measure.ProgramMeasurer(
+            auto_scheduler.LocalBuilder(), auto_scheduler.LocalRunner(), [], 0, cache_file=fp.name
+        )
+        res = measurer.measure(task, policy, inputs[1:])[0]
+        assert res.error_no == 0 and res.all_cost == 0
+        assert [c.value for c in res.costs] == [c.value for c in results[0].costs]
+
+
 def test_dag_measure_local_builder_runner():
     if not tvm.testing.device_enabled("llvm"):
         return
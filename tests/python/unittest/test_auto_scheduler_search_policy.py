@@ -209,6 +209,40 @@ def test_sketch_search_policy_custom_sketch():
     )
 
 
+@tvm.testing.requires_llvm
+def test_sketch_search_policy_warm_start():
+    def make_task(n):
+        return auto_scheduler.SearchTask(
+            func=matmul_auto_scheduler_test, args=(n, n, n), target="llvm"
+        )
+
+    with tempfile.NamedTemporaryFile() as fp, tempfile.NamedTemporaryFile() as fp_new:
+        tuning_options = auto_scheduler.TuningOptions(
+            num_measure_trials=4,
+            num_measures_per_round=2,
+            measure_callbacks=[auto_scheduler.RecordToFile(fp.name)],
+        )
+        make_task(64).tune(tuning_options=tuning_options)
+        best_inp, _ = auto_scheduler.load_best_record(fp.name, make_task(64).workload_key)
+
+        # The best state of 64x64x64 is measured first for 128x128x128
+        task = make_task(128)
+        search_policy = auto_scheduler.SketchPolicy(
+            task,
+            program_cost_model=auto_scheduler.RandomModel(),
+            init_search_callbacks=[auto_scheduler.WarmStartFromSimilarWorkloads(fp.name, 1)],
+        )
+        tuning_options = auto_scheduler.TuningOptions(
+            num_measure_trials=2,
+            num_measures_per_round=2,
+            measure_callbacks=[auto_scheduler.RecordToFile(fp_new.name)],
+        )
+        task.tune(tuning_options=tuning_options, search_policy=search_policy)
+        inputs, _ = auto_scheduler.RecordReader(fp_new.name).read_lines()
+        steps = [type(s) for s in inputs[0].state.transform_steps]
+        assert steps == [type(s) for s in best_inp.state.transform_steps]
+
+
 if __name__ == "__main__":
     test_workload_registry_empty_policy()
     test_sketch_search_policy_basic()
@@ -218,3 +252,4 @@ if __name__ == "__main__":
     test_sketch_search_policy_cuda_xgbmodel_rpc_runner()
     test_sketch_search_policy_zero_rank()
     test_sketch_search_policy_custom_sketch()
+    test_sketch_search_policy_warm_start()
@@ -0,0 +1,63 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test tuning a computation with a symbolic dimension on representative sizes"""
+import tempfile
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import auto_scheduler
+from tvm.testing.auto_scheduler import matmul_auto_scheduler_test
+
+
+@tvm.testing.requires_llvm
+def test_symbolic_kernel():
+    sizes = [4, 16]
+    args = (None, 32, 32)
+    tasks = auto_scheduler.create_symbolic_tasks(matmul_auto_scheduler_test, args, 0, sizes, "llvm")
+    assert [task.compute_dag.tensors[0].shape[0] for task in tasks] == sizes
+
+    with tempfile.NamedTemporaryFile() as fp:
+        log_file = fp.name
+        measure_ctx = auto_scheduler.LocalRPCMeasureContext()
+        tune_option = auto_scheduler.TuningOptions(
+            num_measure_trials=2 * len(tasks),
+            runner=measure_ctx.runner,
+            num_measures_per_round=1,
+            measure_callbacks=[auto_scheduler.RecordToFile(log_file)],
+        )
+        auto_scheduler.TaskScheduler(tasks, strategy="round-robin").tune(tune_option)
+        del measure_ctx
+
+        mod = auto_scheduler.build_symbolic_kernel(
+            matmul_auto_scheduler_test, args, 0, sizes, log_file, "llvm", name="matmul"
+        )
+        func = tvm.build(mod, target="llvm")
+
+    dev = tvm.cpu()
+    b = np.random.uniform(size=(32, 32)).astype("float32")
+    # Inside, at and beyond the representative sizes.
+    for n in [1, 4, 9, 16, 40]:
+        a = np.random.uniform(size=(n, 32)).astype("float32")
+        c = tvm.nd.empty((n, 32), device=dev)
+        func(tvm.nd.array(a, dev), tvm.nd.array(b, dev), c)
+        tvm.testing.assert_allclose(c.numpy(), a @ b, rtol=1e-4)
+
+
+if __name__ == "__main__":
+    test_symbolic_kernel()
@@ -164,6 +164,47 @@ def test_graph_executor():
         assert (out.numpy() == np.array([6, 10])).all()
 
 
+@tvm.testing.requires_micro
+def test_graph_executor_profiler():
+    """Test the per-operator profiler of the graph executor with microTVM."""
+    temp_dir = tvm.contrib.utils.tempdir()
+    relay_mod = tvm.parser.fromtext(
+        """
+      #[version = "0.0.5"]
+      def @main(%a : Tensor[(1, 2), uint8], %b : Tensor[(1, 2), uint8]) {
+          %0 = %a + %b;
+          %1 = %0 * %b;
+          %1
+      }"""
+    )
+
+    runtime = Runtime("crt", {"system-lib": True})
+    with tvm.transform.PassContext(opt_level=0, config={"tir.disable_vectorize": True}):
+        factory = tvm.relay.build(relay_mod, target=TARGET, runtime=runtime)
+
+    with _make_session(temp_dir, factory) as sess:
+        graph_json = factory.get_graph_json()
+        graph_mod = tvm.micro.create_local_graph_executor(
+            graph_json, sess.get_system_lib(), sess.device
+        )
+        graph_mod.set_input(
+            a=tvm.nd.array(np.array([[2, 3]], dtype="uint8"), device=sess.device),
+            b=tvm.nd.array(np.array([[4, 7]], dtype="uint8"), device=sess.device),
+        )
+        # the host CRT counts nanoseconds
+        report = tvm.micro.profile_graph_executor(graph_mod, graph_json, sess.device, 1e9, number=3)
+
+        op_names = [
+            node["name"] for node in json.loads(graph_json)["nodes"] if node["op"] == "tvm_op"
+        ]
+        assert len(report.calls) == 3 * len(op_names)
+        assert sorted({str(call["Name"]) for call in report.calls}) == sorted(op_names)
+        calls = json.loads(report.json())["calls"]
+        assert all(call["Cycles"]["count"] >= 0 for call in calls)
+        assert "Total" in report.table()
+        assert (graph_mod.get_output(0).numpy() == np.array([[24, 70]])).all()
+
+
 @tvm.testing.requires_micro
 def test_std_math_functions():
     """Verify that standard math functions can be used."""
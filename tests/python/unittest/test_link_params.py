@@ -235,6 +235,21 @@ def test_llvm_link_params():
             np.testing.assert_allclose(unlinked_output.numpy(), linked_output.numpy())
 
 
+@tvm.testing.requires_llvm
+def test_llvm_link_params_blob():
+    ir_mod, param_init = _make_mod_and_params("float32")
+    runtime = Runtime("crt", {"system-lib": True})
+    executor = Executor("graph", {"link-params": True})
+    with tvm.transform.PassContext(opt_level=3):
+        lib = tvm.relay.build(ir_mod, "llvm", runtime=runtime, executor=executor, params=param_init)
+
+    # The parameters are aliases into one raw blob, not arrays of per-element constants.
+    src = lib.lib.get_source("ll")
+    assert src.count("@__tvm_param_blob = internal constant [") == 1
+    for p in lib.params:
+        assert re.search(f"@__tvm_param__{p} = internal alias i8", src), src
+
+
 def _get_c_datatype(dtype):
     """Translate LINKABLE_DTYPES element to c datatype."""
     if "int" in dtype:
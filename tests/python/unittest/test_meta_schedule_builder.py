@@ -30,6 +30,7 @@ from tvm.meta_schedule.builder import (
     BuilderResult,
     LocalBuilder,
     PyBuilder,
+    ThreadedBuilder,
 )
 from tvm.runtime import Module
 from tvm.script import tir as T
@@ -133,6 +134,37 @@ def test_meta_schedule_multiple_build():
     _check_build_results(builder_results)
 
 
+def test_meta_schedule_threaded_build():
+    """Test meta schedule threaded builder for multiple builds"""
+    builder = ThreadedBuilder(num_threads=2)
+    builder_inputs = [
+        BuilderInput(MatmulModule, Target("llvm")),
+        BuilderInput(MatmulReluModule, Target("llvm")),
+        BuilderInput(BatchMatmulModule, Target("llvm")),
+    ]
+    builder_results = builder.build(builder_inputs)
+    assert len(builder_results) == len(builder_inputs)
+    _check_build_results(builder_results)
+
+
+def test_meta_schedule_threaded_build_error():
+    """Test the error handing of the threaded builder"""
+
+    def test_build(mod: Module, target: Target) -> None:  # pylint: disable=unused-argument
+        raise ValueError("Builder intended Test Error (build func).")
+
+    builder = ThreadedBuilder(num_threads=2, f_build=test_build)
+    builder_inputs = [
+        BuilderInput(MatmulModule, Target("llvm")),
+        BuilderInput(MatmulReluModule, Target("llvm")),
+    ]
+    builder_results = builder.build(builder_inputs)
+    assert len(builder_results) == len(builder_inputs)
+    for result in builder_results:
+        assert result.artifact_path is None
+        assert result.error_msg.startswith("ThreadedBuilder: An exception occurred")
+
+
 def test_meta_schedule_error_handle_test_builder():
     """Test the error handing during building"""
 
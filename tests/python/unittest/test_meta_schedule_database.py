@@ -277,5 +277,51 @@ def test_meta_schedule_database_reload():
             _equal_record(ret[1], records[2])
 
 
+def test_meta_schedule_database_reload_multiple_workloads():
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = _create_tmp_database(tmpdir)
+        records = {}
+        for mod, sch_fn in [(Matmul, _schedule_matmul), (MatmulRelu, lambda sch: None)]:
+            token = database.commit_workload(mod)
+            trace = _create_schedule(mod, sch_fn).trace
+            records[mod] = [
+                TuningRecord(
+                    trace,
+                    run_secs,
+                    token,
+                    tvm.target.Target("llvm"),
+                    ArgInfo.from_prim_func(func=mod["main"]),  # pylint: disable=unsubscriptable-object
+                )
+                for run_secs in [[3.0], [1.0], [2.0]]
+            ]
+            for record in records[mod]:
+                database.commit_tuning_record(record)
+        new_database = JSONDatabase(
+            path_workload=database.path_workload,
+            path_tuning_record=database.path_tuning_record,
+        )
+        assert len(new_database) == 6
+        # only the workload being queried is decoded, the other one stays untouched
+        token = new_database.commit_workload(MatmulRelu)
+        ret = new_database.get_top_k(token, 2)
+        assert len(ret) == 2
+        _equal_record(ret[0], records[MatmulRelu][1])
+        _equal_record(ret[1], records[MatmulRelu][2])
+        # a record committed after the reload is ranked with the ones read from the file
+        token = new_database.commit_workload(Matmul)
+        new_database.commit_tuning_record(
+            TuningRecord(
+                records[Matmul][0].trace,
+                [0.5],
+                token,
+                tvm.target.Target("llvm"),
+                ArgInfo.from_prim_func(func=Matmul["main"]),  # pylint: disable=unsubscriptable-object
+            )
+        )
+        assert len(new_database) == 7
+        ret = new_database.get_top_k(token, 10)
+        assert [float(r.run_secs[0]) for r in ret] == [0.5, 1.0, 2.0, 3.0]
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main([__file__] + sys.argv[1:]))
@@ -0,0 +1,108 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+""" Test Meta Schedule FeatureExtractor """
+# pylint: disable=missing-function-docstring
+import sys
+from typing import List
+
+import numpy as np
+import pytest
+
+import tvm
+from tvm.meta_schedule import TuneContext
+from tvm.meta_schedule.feature_extractor import PerStoreFeature, PyFeatureExtractor
+from tvm.meta_schedule.search_strategy import MeasureCandidate
+from tvm.script import tir as T
+from tvm.tir.schedule import Schedule
+
+# pylint: disable=invalid-name,no-member,line-too-long,too-many-nested-blocks,no-self-argument
+# fmt: off
+
+@tvm.script.ir_module
+class Matmul:
+    @T.prim_func
+    def main(a: T.handle, b: T.handle, c: T.handle) -> None:
+        T.func_attr({"global_symbol": "main"})
+        A = T.match_buffer(a, (64, 64), "float32")
+        B = T.match_buffer(b, (64, 64), "float32")
+        C = T.match_buffer(c, (64, 64), "float32")
+        for i, j, k in T.grid(64, 64, 64):
+            with T.block("matmul"):
+                vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                with T.init():
+                    C[vi, vj] = 0.0
+                C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
+
+# fmt: on
+# pylint: enable=invalid-name,no-member,line-too-long,too-many-nested-blocks,no-self-argument
+
+
+def _make_candidates(factors):
+    candidates = []
+    for factor in factors:
+        sch = Schedule(Matmul)
+        i, _, _ = sch.get_loops(sch.get_block("matmul"))
+        _, i_1 = sch.split(i, factors=[None, factor])
+        if factor == 8:
+            sch.parallel(i_1)
+        else:
+            sch.unroll(i_1)
+        candidates.append(MeasureCandidate(sch, []))
+    return candidates
+
+
+def test_meta_schedule_per_store_feature():
+    extractor = PerStoreFeature(buffers_per_store=5)
+    context = TuneContext(num_threads=2)
+    candidates = _make_candidates([8, 4, 8])
+    features, row_offsets = extractor.extract_from(context, candidates)
+    assert features.dtype == np.float32
+    assert row_offsets.dtype == np.int64
+    assert row_offsets.shape == (len(candidates) + 1,)
+    assert row_offsets[0] == 0 and row_offsets[-1] == features.shape[0]
+    assert features.shape[1] == extractor.feature_vector_length
+    # the init and the update of C are described together, as the stores of one buffer
+    assert list(np.diff(row_offsets)) == [1, 1, 1]
+    # the candidates scheduled the same way have the same features
+    np.testing.assert_equal(features[0], features[2])
+    assert not np.array_equal(features[0], features[1])
+
+
+def test_meta_schedule_per_store_feature_empty():
+    features, row_offsets = PerStoreFeature().extract_from(TuneContext(num_threads=1), [])
+    assert features.shape[0] == 0
+    assert list(row_offsets) == [0]
+
+
+def test_meta_schedule_py_feature_extractor():
+    class FancyFeatureExtractor(PyFeatureExtractor):
+        def extract_from(
+            self,
+            tune_context: TuneContext,
+            candidates: List[MeasureCandidate],
+        ):
+            n = len(candidates)
+            return np.ones((n, 3), dtype="float32"), np.arange(n + 1, dtype="int64")
+
+    extractor = FancyFeatureExtractor()
+    features, row_offsets = extractor.extract_from(TuneContext(), _make_candidates([8, 4]))
+    np.testing.assert_equal(features, np.ones((2, 3), dtype="float32"))
+    np.testing.assert_equal(row_offsets, [0, 1, 2])
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main([__file__] + sys.argv[1:]))
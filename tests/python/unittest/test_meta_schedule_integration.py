@@ -14,7 +14,9 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import os.path as osp
 import sys
+import tempfile
 from typing import List
 
 import pytest
@@ -22,13 +24,17 @@ import pytest
 import tvm
 from tvm import meta_schedule as ms
 from tvm.ir.module import IRModule
+from tvm.meta_schedule.arg_info import ArgInfo
+from tvm.meta_schedule.database import JSONDatabase, TuningRecord
 from tvm.meta_schedule.integration import (
+    ApplyHistoryBest,
     ExtractedTask,
     MetaScheduleContext,
     TaskExtraction,
 )
 from tvm.meta_schedule.testing import get_network
 from tvm.script import tir as T
+from tvm.tir import Schedule
 
 # pylint: disable=invalid-name,no-member,line-too-long,too-many-nested-blocks,missing-docstring,unbalanced-tuple-unpacking
 
@@ -105,6 +111,39 @@ def test_meta_schedule_integration_query_inside_with_scope():
     _check_mock_task(env.tasks, mod)
 
 
+def test_meta_schedule_integration_apply_history_best():
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = JSONDatabase(
+            osp.join(tmpdir, "workloads.json"), osp.join(tmpdir, "tuning_records.json")
+        )
+        sch = Schedule(MockModule)
+        (i,) = sch.get_loops(sch.get_block("matmul"))
+        sch.split(i, factors=[None, 4])
+        database.commit_tuning_record(
+            TuningRecord(
+                sch.trace,
+                [1.0],
+                database.commit_workload(MockModule),
+                tvm.target.Target("llvm"),
+                ArgInfo.from_prim_func(func=MockModule["main"]),
+            )
+        )
+        env = ApplyHistoryBest(database)
+        # the second query of the workload is answered by the index
+        for _ in range(2):
+            with env:
+                func = MetaScheduleContext.query_inside_with_scope(
+                    task_name="mock-task",
+                    mod=MockModule,
+                    dispatched=[MockModule],
+                )
+            tvm.ir.assert_structural_equal(func, sch.mod["main"])
+        # a workload without record is not scheduled
+        other = Schedule(MockModule)
+        other.parallel(other.get_loops(other.get_block("matmul"))[0])
+        assert env.query(task_name="mock-task", mod=other.mod, dispatched=[other.mod]) is None
+
+
 def test_meta_schedule_integration_extract_from_resnet():
     mod, params, _, _ = get_network(
         name="resnet-18",
@@ -33,6 +33,7 @@ from tvm.meta_schedule.runner import (
     LocalRunner,
     PyRunner,
     RPCConfig,
+    RPCPoolRunner,
     RPCRunner,
     RunnerFuture,
     RunnerInput,
@@ -568,6 +569,81 @@ def test_meta_schedule_local_runner_exception():
     _clean_build(builder_result.artifact_path)
 
 
+def test_meta_schedule_rpc_pool_multiple_runs():
+    """Test meta schedule rpc pool runner for multiple runs, with a failed session"""
+    mods = [
+        MatmulModule,
+        MatmulReluModule,
+        BatchMatmulModule,
+    ]
+    builder = LocalBuilder()
+    builder_results = builder.build([BuilderInput(mod, Target("llvm")) for mod in mods])
+    for builder_result in builder_results:
+        assert builder_result.artifact_path is not None
+        assert builder_result.error_msg is None
+
+    args_infos = [
+        [TensorInfo("float32", (MATMUL_N, MATMUL_N)) for _ in range(3)],
+        [TensorInfo("float32", (MATMUL_N, MATMUL_N)) for _ in range(3)],
+        [TensorInfo("float32", [16, MATMUL_M, MATMUL_M]) for _ in range(3)],
+    ]
+    runner_inputs = [
+        RunnerInput(builder_results[i].artifact_path, "llvm", args_infos[i])
+        for i in range(len(mods))
+    ]
+
+    with LocalRPC() as rpc:
+        rpc_config = RPCConfig(
+            tracker_host=rpc.tracker_host,
+            tracker_port=rpc.tracker_port,
+            tracker_key=rpc.tracker_key,
+            session_priority=1,
+            session_timeout_sec=100,
+        )
+        evaluator_config = EvaluatorConfig(
+            number=1,
+            repeat=1,
+            min_repeat_ms=0,
+            enable_cpu_cache_flush=False,
+        )
+        num_sessions = 0
+
+        def flaky_session_creator(session_timeout_sec: int) -> Module:
+            nonlocal num_sessions
+            num_sessions += 1
+            if num_sessions == 1:
+                raise ValueError("Intended session failure")
+            tracker = rpc_config.connect_tracker()
+            session = tracker.request(
+                key=rpc_config.tracker_key, session_timeout=session_timeout_sec
+            )
+            return session._sess  # pylint: disable=protected-access
+
+        runner = RPCPoolRunner(
+            rpc_config,
+            evaluator_config,
+            num_devices=1,
+            max_retries=1,
+            f_create_session=flaky_session_creator,
+        )
+        runner_futures = runner.run(runner_inputs)
+        runner_results = [runner_future.result() for runner_future in runner_futures]
+        del runner
+
+    # The session is kept across the inputs once it is created.
+    assert num_sessions == 2
+    for runner_result in runner_results:
+        assert runner_result.error_msg is None
+        for result in runner_result.run_secs:
+            if isinstance(result, FloatImm):
+                result = result.value
+            assert isinstance(result, float)
+            assert result >= 0.0
+
+    for builder_result in builder_results:
+        _clean_build(builder_result.artifact_path)
+
+
 def test_meta_schedule_runner_matmul_test():
     """Test meta schedule runner with add module"""
 
@@ -20,13 +20,15 @@ from typing import List
 
 import sys
 
+import numpy as np
 import pytest
 
 import tvm
 from tvm.meta_schedule import TuneContext
+from tvm.meta_schedule.cost_model import PyCostModel
 from tvm.meta_schedule.runner import RunnerResult
 from tvm.meta_schedule.space_generator import ScheduleFn
-from tvm.meta_schedule.search_strategy import ReplayTrace
+from tvm.meta_schedule.search_strategy import EvolutionarySearch, MeasureCandidate, ReplayTrace
 
 from tvm.script import tir as T
 from tvm.tir.schedule import Schedule, Trace
@@ -97,5 +99,77 @@ def test_meta_schedule_replay_trace():
     assert num_trials_each_round == [7, 7, 6]
 
 
+def _schedule_matmul_sampled(sch: Schedule):
+    block = sch.get_block("matmul")
+    i, j, k = sch.get_loops(block=block)
+    i_0, i_1, i_2, i_3 = sch.split(loop=i, factors=sch.sample_perfect_tile(i, n=4))
+    j_0, j_1, j_2, j_3 = sch.split(loop=j, factors=sch.sample_perfect_tile(j, n=4))
+    k_0, k_1 = sch.split(loop=k, factors=sch.sample_perfect_tile(k, n=2))
+    sch.reorder(i_0, j_0, i_1, j_1, k_0, i_2, j_2, k_1, i_3, j_3)
+
+
+def _innermost_tile_of_j(sch: Schedule) -> int:
+    trace = sch.trace
+    tiles = [trace.decisions[inst] for inst in trace.insts if inst.kind.name == "SamplePerfectTile"]
+    return int(tiles[1][-1])
+
+
+def test_meta_schedule_evolutionary_search():
+    num_trials_per_iter = 7
+    num_trials_total = 20
+
+    class TestCostModel(PyCostModel):
+        def __init__(self):
+            super().__init__()
+            self.num_updates = 0
+
+        def update(
+            self,
+            tune_context: TuneContext,
+            candidates: List[MeasureCandidate],
+            results: List[RunnerResult],
+        ) -> None:
+            assert len(candidates) == len(results)
+            self.num_updates += 1
+
+        def predict(
+            self, tune_context: TuneContext, candidates: List[MeasureCandidate]
+        ) -> np.ndarray:
+            # Favor the schedules whose innermost loop of `j` is long.
+            return np.array([_innermost_tile_of_j(c.sch) for c in candidates], dtype="float64")
+
+    (example_sch,) = ScheduleFn(sch_fn=_schedule_matmul_sampled).generate_design_space(Matmul)
+    cost_model = TestCostModel()
+    strategy = EvolutionarySearch(
+        num_trials_per_iter=num_trials_per_iter,
+        num_trials_total=num_trials_total,
+        population_size=16,
+        genetic_num_iters=2,
+        cost_model=cost_model,
+    )
+    tune_context = TuneContext(mod=Matmul, rand_state=42)
+    strategy.initialize_with_tune_context(tune_context)
+
+    num_trials_each_round: List[int] = []
+    hashes = set()
+    strategy.pre_tuning([example_sch])
+    while True:
+        candidates = strategy.generate_measure_candidates()
+        if candidates is None:
+            break
+        num_trials_each_round.append(len(candidates))
+        runner_results: List[RunnerResult] = []
+        for candidate in candidates:
+            assert _is_trace_equal(candidate.sch, example_sch)
+            hashes.add(tvm.ir.structural_hash(candidate.sch.mod))
+            runner_results.append(RunnerResult(run_secs=[0.5, 0.4, 0.3], error_msg=None))
+        strategy.notify_runner_results(runner_results)
+    strategy.post_tuning()
+    assert num_trials_each_round == [7, 7, 6]
+    # No schedule is measured twice.
+    assert len(hashes) == num_trials_total
+    assert cost_model.num_updates == 3
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main([__file__] + sys.argv[1:]))
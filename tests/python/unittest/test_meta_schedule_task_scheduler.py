@@ -33,7 +33,7 @@ from tvm.meta_schedule.search_strategy import ReplayTrace
 from tvm.meta_schedule.builder import PyBuilder, BuilderInput, BuilderResult
 from tvm.meta_schedule.runner import PyRunner, RunnerInput, RunnerFuture, RunnerResult
 from tvm.meta_schedule.database import PyDatabase, TuningRecord, Workload
-from tvm.meta_schedule.task_scheduler import RoundRobin, PyTaskScheduler
+from tvm.meta_schedule.task_scheduler import GradientBased, RoundRobin, PyTaskScheduler
 
 
 # pylint: disable=invalid-name,no-member,line-too-long,too-many-nested-blocks,missing-docstring
@@ -124,6 +124,19 @@ class DummyRunnerFuture(RunnerFuture):
         return RunnerResult([random.uniform(5, 30) for _ in range(random.randint(1, 10))], None)
 
 
+class ConstantRunnerFuture(RunnerFuture):
+    def done(self) -> bool:
+        return True
+
+    def result(self) -> RunnerResult:
+        return RunnerResult([1.0], None)
+
+
+class ConstantRunner(PyRunner):
+    def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
+        return [ConstantRunnerFuture() for _ in runner_inputs]
+
+
 class DummyBuilder(PyBuilder):
     def build(self, build_inputs: List[BuilderInput]) -> List[BuilderResult]:
         return [BuilderResult("test_path", None) for _ in build_inputs]
@@ -295,5 +308,80 @@ def test_meta_schedule_task_scheduler_override_next_task_id_only():
         assert len(database.get_top_k(database.commit_workload(task.mod), 1e9)) == num_trials_total
 
 
+def _create_tasks(num_trials_per_iter: int, num_trials_total: int) -> List[TuneContext]:
+    return [
+        TuneContext(
+            MatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=ScheduleFn(sch_fn=_schedule_matmul),
+            search_strategy=ReplayTrace(num_trials_per_iter, num_trials_total),
+            task_name="Matmul",
+            rand_state=42,
+        ),
+        TuneContext(
+            MatmulReluModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=ScheduleFn(sch_fn=_schedule_matmul),
+            search_strategy=ReplayTrace(num_trials_per_iter, num_trials_total),
+            task_name="MatmulRelu",
+            rand_state=0xDEADBEEF,
+        ),
+        TuneContext(
+            BatchMatmulModule,
+            target=tvm.target.Target("llvm"),
+            space_generator=ScheduleFn(sch_fn=_schedule_batch_matmul),
+            search_strategy=ReplayTrace(num_trials_per_iter, num_trials_total),
+            task_name="BatchMatmul",
+            rand_state=0x114514,
+        ),
+    ]
+
+
+def test_meta_schedule_task_scheduler_gradient_based():
+    num_trials_per_iter = 6
+    num_trials_total = 101
+    tasks = _create_tasks(num_trials_per_iter, num_trials_total)
+    database = DummyDatabase()
+    scheduler = GradientBased(
+        tasks,
+        DummyBuilder(),
+        ConstantRunner(),
+        database,
+        task_weights=[1, 10, 1],
+        seed=42,
+    )
+    scheduler.tune()
+    assert len(database) == num_trials_total * len(tasks)
+    for task in tasks:
+        assert len(database.get_top_k(database.commit_workload(task.mod), 1e9)) == num_trials_total
+    # After a warmup round each, the heavy task gets the rounds until its forward gradient
+    # drops to the one of the other tasks.
+    heavy = database.commit_workload(tasks[1].mod)
+    for record in database.records[3 * num_trials_per_iter : 10 * num_trials_per_iter]:
+        assert record.workload == heavy
+
+
+def test_meta_schedule_task_scheduler_gradient_based_early_stopping():
+    num_trials_per_iter = 6
+    num_trials_total = 101
+    early_stopping_rounds = 2
+    tasks = _create_tasks(num_trials_per_iter, num_trials_total)
+    database = DummyDatabase()
+    scheduler = GradientBased(
+        tasks,
+        DummyBuilder(),
+        ConstantRunner(),
+        database,
+        early_stopping_rounds=early_stopping_rounds,
+        seed=42,
+    )
+    scheduler.tune()
+    # The latency never improves after the first round.
+    num_rounds = 1 + early_stopping_rounds
+    assert len(database) == num_rounds * num_trials_per_iter * len(tasks)
+    for task in tasks:
+        assert task.is_stopped
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main([__file__] + sys.argv[1:]))
@@ -154,6 +154,23 @@ def test_pass_config():
         cfg = tvm.transform.PassContext(config={"tir.UnrollLoop": 1})
 
 
+def test_binary_saveload():
+    import pickle
+    import numpy as np
+
+    data = np.arange(1 << 16, dtype="float32")
+    x = tvm.relay.var("x", shape=data.shape)
+    func = tvm.relay.Function([x], x + tvm.relay.const(data))
+    node = tvm.runtime.convert({"func": func, "names": ["a", "b"]})
+    binary = tvm.ir.save_binary(node)
+    # the tensor payload is raw, not base64 encoded
+    assert len(binary) < len(tvm.ir.save_json(node)) * 0.8
+    tvm.ir.assert_structural_equal(tvm.ir.load_json(binary), node, map_free_vars=True)
+    tvm.ir.assert_structural_equal(pickle.loads(pickle.dumps(func)), func, map_free_vars=True)
+    with pytest.raises(tvm.error.TVMError):
+        tvm.ir.load_json(binary[: len(binary) // 2])
+
+
 def test_dict():
     x = tvm.tir.const(1)  # a class that has Python-defined methods
     # instances should see the full class dict
@@ -166,6 +183,7 @@ if __name__ == "__main__":
     test_make_node()
     test_make_smap()
     test_const_saveload_json()
+    test_binary_saveload()
     test_make_sum()
     test_pass_config()
     test_dict()
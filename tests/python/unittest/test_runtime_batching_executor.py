@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import threading
+
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import batching_executor, graph_executor
+from tvm.runtime.vm import VirtualMachine
+
+
+def _graph_variant(batch_size):
+    x = relay.var("x", shape=(batch_size, 8), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], x * relay.const(2.0)))
+    lib = relay.build(mod, target="llvm")
+    return graph_executor.GraphModule(lib["default"](tvm.cpu()))
+
+
+def _run_concurrently(executor, datas):
+    results = [None] * len(datas)
+
+    def worker(i):
+        results[i] = executor.run(datas[i])[0].numpy()
+
+    threads = [threading.Thread(target=worker, args=(i,)) for i in range(len(datas))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    return results
+
+
+@pytest.mark.skipif(
+    not batching_executor.batching_executor_enabled(), reason="batching executor not enabled"
+)
+@tvm.testing.requires_llvm
+def test_graph_variants():
+    executor = batching_executor.create([_graph_variant(1), _graph_variant(4)], max_latency_ms=50.0)
+    datas = [np.random.rand(1, 8).astype("float32") for _ in range(4)]
+    results = _run_concurrently(executor, datas)
+    for data, result in zip(datas, results):
+        tvm.testing.assert_allclose(result, data * 2)
+    assert 1 <= executor.num_batches <= len(datas)
+
+    # A request larger than max_batch_size is rejected.
+    with pytest.raises(tvm.TVMError):
+        executor.run(np.zeros((5, 8), "float32"))
+
+
+@pytest.mark.skipif(
+    not batching_executor.batching_executor_enabled(), reason="batching executor not enabled"
+)
+@tvm.testing.requires_llvm
+def test_vm_variant():
+    x = relay.var("x", shape=(relay.Any(), 8), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], x + relay.const(1.0)))
+    exe = relay.vm.compile(mod, target="llvm")
+    vm = VirtualMachine(exe, tvm.cpu())
+    executor = batching_executor.create([(vm, 0)], max_batch_size=8, max_latency_ms=50.0)
+    datas = [np.random.rand(n, 8).astype("float32") for n in [1, 2, 3]]
+    results = _run_concurrently(executor, datas)
+    for data, result in zip(datas, results):
+        tvm.testing.assert_allclose(result, data + 1)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
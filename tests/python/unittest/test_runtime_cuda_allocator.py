@@ -0,0 +1,69 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def _set_allocator(name):
+    tvm.get_global_func("runtime.cuda.SetAllocator")(name)
+
+
+@tvm.testing.requires_cuda
+def test_async_allocator():
+    get_allocator = tvm.get_global_func("runtime.cuda.GetAllocator")
+    previous = get_allocator()
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2.0, name="B")
+    s = te.create_schedule(B.op)
+    bx, tx = s[B].split(B.op.axis[0], factor=64)
+    s[B].bind(bx, te.thread_axis("blockIdx.x"))
+    s[B].bind(tx, te.thread_axis("threadIdx.x"))
+    dev = tvm.cuda(0)
+    if dev.api_version < 11020:
+        pytest.skip("the async allocator needs CUDA 11.2")
+    f = tvm.build(s, [A, B], "cuda")
+    a_np = np.random.uniform(size=n).astype(A.dtype)
+    # an array allocated by cudaMalloc is freed by cudaFree after the switch
+    default_array = tvm.nd.array(a_np, dev)
+    try:
+        _set_allocator("async")
+        assert get_allocator() == "async"
+        for _ in range(3):
+            a = tvm.nd.array(a_np, dev)
+            b = tvm.nd.empty((n,), B.dtype, dev)
+            f(a, b)
+            tvm.testing.assert_allclose(b.numpy(), a_np * 2.0)
+        del default_array
+    finally:
+        _set_allocator(previous)
+    tvm.testing.assert_allclose(a.numpy(), a_np)
+
+
+@tvm.testing.requires_cuda
+def test_unknown_allocator():
+    with pytest.raises(tvm.TVMError):
+        _set_allocator("bogus")
+
+
+if __name__ == "__main__":
+    test_async_allocator()
+    test_unknown_allocator()
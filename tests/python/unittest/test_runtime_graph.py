@@ -19,6 +19,7 @@ import tvm.testing
 from tvm import te, runtime
 import numpy as np
 import json
+import threading
 from tvm import rpc
 from tvm import relay
 from tvm.contrib import utils, graph_executor
@@ -138,6 +139,365 @@ def test_load_unexpected_params():
     rt_mod.load_params(runtime.save_param_dict(new_params))
 
 
+@tvm.testing.requires_llvm
+def test_concurrent_ops():
+    # Two independent branches joined at the end, run with the ops dispatched concurrently.
+    x = relay.var("x", shape=(4, 64))
+    branches = [relay.exp(x), relay.sqrt(x), relay.sigmoid(x), relay.negative(x)]
+    branches = [relay.nn.relu(b) + relay.const(1.0) for b in branches]
+    z = relay.Tuple(branches)
+    out = relay.concatenate(z, axis=0)
+    mod = tvm.IRModule.from_expr(relay.Function([x], out))
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target="llvm")
+
+    data = np.random.uniform(size=(4, 64)).astype("float32")
+    ref = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    ref.run(x=data)
+    expected = ref.get_output(0).numpy()
+
+    # more concurrent ops than the host has cores are clamped to the thread pool size
+    for max_concurrent_ops in [2, 4, 1024]:
+        gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        gmod.set_max_concurrent_ops(max_concurrent_ops)
+        for _ in range(10):
+            gmod.run(x=data)
+            tvm.testing.assert_allclose(gmod.get_output(0).numpy(), expected)
+
+
+@tvm.testing.requires_llvm
+def test_persistent_parallel_region():
+    x = relay.var("x", shape=(64, 256))
+    out = x
+    for _ in range(8):
+        out = relay.nn.relu(relay.exp(out * relay.const(0.5)) - relay.const(1.0))
+        out = relay.nn.softmax(out)
+    mod = tvm.IRModule.from_expr(relay.Function([x], out))
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target="llvm")
+
+    data = np.random.uniform(size=(64, 256)).astype("float32")
+    ref = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    ref.run(x=data)
+    expected = ref.get_output(0).numpy()
+
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    gmod.set_persistent_parallel_region(True)
+    for _ in range(10):
+        gmod.run(x=data)
+        tvm.testing.assert_allclose(gmod.get_output(0).numpy(), expected)
+    gmod.set_persistent_parallel_region(False)
+    gmod.run(x=data)
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), expected)
+
+
+@tvm.testing.requires_llvm
+def test_executor_per_numa_node():
+    x = relay.var("x", shape=(16, 64))
+    w = relay.var("w", shape=(32, 64))
+    mod = tvm.IRModule.from_expr(relay.Function([x, w], relay.nn.dense(x, w)))
+    weight = np.random.uniform(size=(32, 64)).astype("float32")
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target="llvm", params={"w": weight})
+    data = np.random.uniform(size=(16, 64)).astype("float32")
+    expected = np.dot(data, weight.T)
+
+    config_threadpool_numa = tvm.get_global_func("runtime.config_threadpool_numa")
+    num_nodes = tvm.get_global_func("runtime.numa_num_nodes")()
+    assert num_nodes >= 1
+    outputs = [None] * num_nodes
+
+    def serve(node):
+        # the executor created on the bound thread holds its own copy of the parameters
+        config_threadpool_numa(node, 0)
+        gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        gmod.run(x=data)
+        outputs[node] = gmod.get_output(0).numpy()
+
+    threads = [threading.Thread(target=serve, args=(node,)) for node in range(num_nodes)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    for output in outputs:
+        tvm.testing.assert_allclose(output, expected, rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_sampling_profiler():
+    x = relay.var("x", shape=(4, 64))
+    y = relay.exp(x)
+    out = relay.nn.relu(relay.sqrt(x)) + y
+    mod = tvm.IRModule.from_expr(relay.Function([x], out))
+    with tvm.transform.PassContext(opt_level=0):
+        lib = relay.build(mod, target="llvm")
+    data = np.random.uniform(size=(4, 64)).astype("float32")
+
+    for max_concurrent_ops in [1, 2]:
+        gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        gmod.set_max_concurrent_ops(max_concurrent_ops)
+        assert gmod.get_sampling_profile()["ops"] == []
+        gmod.set_sampling_profiler(3)
+        for _ in range(10):
+            gmod.run(x=data)
+        profile = gmod.get_sampling_profile()
+        assert profile["sample_period"] == 3
+        assert profile["sampled_runs"] == 4
+        graph = json.loads(lib.get_graph_json())
+        op_names = [node["name"] for node in graph["nodes"] if node["op"] == "tvm_op"]
+        assert sorted(op["name"] for op in profile["ops"]) == sorted(op_names)
+        for op in profile["ops"]:
+            assert op["count"] == 4
+            assert sum(op["histogram"]) == 4
+            assert op["min_us"] <= op["p50_us"] <= op["max_us"]
+            assert op["min_us"] <= op["mean_us"] <= op["max_us"]
+
+        gmod.set_sampling_profiler(0)
+        gmod.run(x=data)
+        assert gmod.get_sampling_profile()["sampled_runs"] == 0
+
+
+@tvm.testing.requires_cuda
+def test_multi_stream():
+    x = relay.var("x", shape=(4, 64))
+    branches = [relay.exp(x), relay.sqrt(x), relay.sigmoid(x), relay.negative(x)]
+    branches = [relay.nn.relu(b) + relay.const(1.0) for b in branches]
+    out = relay.concatenate(relay.Tuple(branches), axis=0)
+    mod = tvm.IRModule.from_expr(relay.Function([x], out))
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target="cuda")
+
+    dev = tvm.cuda(0)
+    data = np.random.uniform(size=(4, 64)).astype("float32")
+    ref = graph_executor.GraphModule(lib["default"](dev))
+    ref.run(x=data)
+    expected = ref.get_output(0).numpy()
+
+    gmod = graph_executor.GraphModule(lib["default"](dev))
+    gmod.set_num_streams(4)
+    out = tvm.nd.empty(expected.shape, device=dev)
+    gmod["set_output_zero_copy"](0, out)
+    for _ in range(10):
+        gmod.run(x=data)
+        tvm.testing.assert_allclose(out.numpy(), expected)
+
+
+def _build_branches(target):
+    x = relay.var("x", shape=(4, 64))
+    out = relay.nn.relu(relay.exp(x)) + relay.sigmoid(x)
+    mod = tvm.IRModule.from_expr(relay.Function([x], out))
+    with tvm.transform.PassContext(opt_level=3):
+        return relay.build(mod, target=target)
+
+
+@tvm.testing.requires_llvm
+def test_run_async():
+    lib = _build_branches("llvm")
+    data = np.random.uniform(size=(4, 64)).astype("float32")
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    done = []
+    # on CPU the graph runs synchronously and the callback fires before returning
+    gmod.run_async(lambda: done.append(True), x=data)
+    assert done == [True]
+    expected = np.maximum(np.exp(data), 0) + 1 / (1 + np.exp(-data))
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), expected, rtol=1e-5)
+    assert gmod.get_stream() is None
+
+
+@tvm.testing.requires_cuda
+def test_run_async_streams():
+    lib = _build_branches("cuda")
+    dev = tvm.cuda(0)
+    datas = [np.random.uniform(size=(4, 64)).astype("float32") for _ in range(4)]
+    streams = [dev.create_raw_stream() for _ in datas]
+    gmods = [graph_executor.GraphModule(lib["default"](dev)) for _ in datas]
+    outs = [tvm.nd.empty((4, 64), device=tvm.cpu(0)) for _ in datas]
+    done = []
+    for gmod, stream, data, out in zip(gmods, streams, datas, outs):
+        gmod.set_stream(stream)
+        gmod.run_async(lambda: done.append(True), x=data)
+        gmod.get_output(0, out)
+    dev.sync()
+    for stream in streams:
+        dev.free_raw_stream(stream)
+    assert len(done) == len(datas)
+    for data, out in zip(datas, outs):
+        expected = np.maximum(np.exp(data), 0) + 1 / (1 + np.exp(-data))
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_pinned_staging_cpu():
+    lib = _build_branches("llvm")
+    data = np.random.uniform(size=(4, 64)).astype("float32")
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    gmod.set_pinned_staging()
+    # CPU entries are never staged
+    assert gmod.get_input_staging("x") is None
+    assert gmod.get_output_staging(0) is None
+    gmod.run(x=data)
+    expected = np.maximum(np.exp(data), 0) + 1 / (1 + np.exp(-data))
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), expected, rtol=1e-5)
+
+
+@tvm.testing.requires_cuda
+def test_pinned_staging():
+    lib = _build_branches("cuda")
+    dev = tvm.cuda(0)
+    gmod = graph_executor.GraphModule(lib["default"](dev))
+    gmod.set_pinned_staging()
+    stage_in = gmod.get_input_staging("x")
+    stage_out = gmod.get_output_staging(0)
+    assert stage_in.device == tvm.cpu(0) and stage_in.shape == (4, 64)
+    for _ in range(3):
+        data = np.random.uniform(size=(4, 64)).astype("float32")
+        expected = np.maximum(np.exp(data), 0) + 1 / (1 + np.exp(-data))
+        # through the staging buffers in place
+        stage_in.copyfrom(data)
+        gmod.module["set_input"]("x", stage_in)
+        gmod.run()
+        gmod.get_output(0, stage_out)
+        dev.sync()
+        tvm.testing.assert_allclose(stage_out.numpy(), expected, rtol=1e-5)
+        # and from pageable memory
+        out = tvm.nd.empty((4, 64), device=tvm.cpu(0))
+        gmod.module["set_input"]("x", tvm.nd.array(data))
+        gmod.run()
+        gmod.get_output(0, out)
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-5)
+    gmod.set_pinned_staging(False)
+
+
+def test_zero_copy_after_rebuild():
+    # The zero copy inputs and outputs must patch the arguments of the current operators,
+    # after share_params rebuilt them.
+    x = relay.var("x", shape=(1, 10))
+    y = relay.var("y", shape=(1, 10))
+    func = relay.Function([x, y], relay.add(relay.add(x, y), y))
+    x_in = np.ones((1, 10)).astype("float32")
+    graph, lib, params = relay.build(func, target="llvm", params={"x": x_in})
+
+    mod_shared = graph_executor.create(graph, lib, tvm.cpu(0))
+    mod_shared.load_params(runtime.save_param_dict(params))
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    mod.share_params(mod_shared, runtime.save_param_dict(params))
+
+    for _ in range(2):
+        a = np.random.uniform(size=(1, 10)).astype("float32")
+        out = tvm.nd.empty((1, 10))
+        mod.module["set_input_zero_copy"]("y", tvm.nd.array(a))
+        mod.module["set_output_zero_copy"](0, out)
+        mod.run()
+        tvm.testing.assert_allclose(out.numpy(), x_in + 2 * a, rtol=1e-6)
+
+
+@tvm.testing.requires_llvm
+def test_streaming():
+    lib = _build_branches("llvm")
+    frames = [np.random.uniform(size=(4, 64)).astype("float32") for _ in range(5)]
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    # one set runs a frame, one receives the next and one holds the outputs popped last
+    gmod.start_streaming(3, ["x"])
+    gmod.push_frame(frames[0])
+    outputs = []
+    for frame in frames[1:]:
+        # the next frame is copied in while the previous one runs
+        gmod.push_frame(frame)
+        outputs.append(gmod.pop_frame()[0].numpy())
+    outputs.append(gmod.pop_frame()[0].numpy())
+    gmod.stop_streaming()
+    for frame, out in zip(frames, outputs):
+        expected = np.maximum(np.exp(frame), 0) + 1 / (1 + np.exp(-frame))
+        tvm.testing.assert_allclose(out, expected, rtol=1e-5)
+    # the executor runs on its own tensors again
+    gmod.run(x=frames[0])
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), outputs[0], rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_bind_state():
+    x = relay.var("x", shape=(4,))
+    state = relay.var("state", shape=(4,))
+    next_state = relay.nn.relu(state + x)
+    func = relay.Function([x, state], relay.Tuple([next_state * relay.const(2.0), next_state]))
+    lib = relay.build(tvm.IRModule.from_expr(func), target="llvm")
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    init = np.random.uniform(size=(4,)).astype("float32")
+    gmod.set_input("state", init)
+    gmod.bind_state("state", 1)
+    expected = init
+    for _ in range(3):
+        data = np.random.uniform(-1, 1, size=(4,)).astype("float32")
+        gmod.run(x=data)
+        expected = np.maximum(expected + data, 0)
+        tvm.testing.assert_allclose(gmod.get_output(0).numpy(), 2 * expected, rtol=1e-6)
+        tvm.testing.assert_allclose(gmod.get_output(1).numpy(), expected, rtol=1e-6)
+        tvm.testing.assert_allclose(gmod.get_input("state").numpy(), expected, rtol=1e-6)
+
+
+@tvm.testing.requires_llvm
+def test_run_in_context():
+    x = relay.var("x", shape=(4, 16))
+    w = relay.var("w", shape=(8, 16))
+    func = relay.Function([x, w], relay.nn.relu(relay.nn.dense(x, w)))
+    weight = np.random.uniform(-1, 1, size=(8, 16)).astype("float32")
+    lib = relay.build(tvm.IRModule.from_expr(func), target="llvm", params={"w": weight})
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    inputs = [np.random.uniform(-1, 1, size=(4, 16)).astype("float32") for _ in range(8)]
+    results = [None] * len(inputs)
+
+    def worker(i):
+        for _ in range(10):
+            results[i] = gmod.run_in_context(x=inputs[i])[0].numpy()
+
+    threads = [threading.Thread(target=worker, args=(i,)) for i in range(len(inputs))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    for data, out in zip(inputs, results):
+        tvm.testing.assert_allclose(out, np.maximum(data @ weight.T, 0), rtol=1e-5)
+
+
+def test_zero_copy_strided_views():
+    # Views of a batch are used in place when they are compact and aligned, and copied
+    # otherwise.
+    x = relay.var("x", shape=(2, 8))
+    func = relay.Function([x], relay.nn.relu(x) + relay.const(1.0))
+    graph, lib, _ = relay.build(func, target="llvm")
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+
+    # rows 0 and 4 start on an aligned address, row 1 does not, and columns are strided
+    rows = np.random.uniform(-1, 1, size=(8, 8)).astype("float32")
+    cols = np.random.uniform(-1, 1, size=(2, 16)).astype("float32")
+    rows_in, rows_out = tvm.nd.array(rows), tvm.nd.empty((8, 8))
+    cols_in, cols_out = tvm.nd.array(cols), tvm.nd.empty((2, 16))
+    cases = [(0, 0, rows_in, rows_out), (0, 4, rows_in, rows_out), (0, 1, rows_in, rows_out)]
+    cases += [(1, 8, cols_in, cols_out)]
+    for axis, begin, arr_in, arr_out in cases:
+        extent = 2 if axis == 0 else 8
+        x_in = arr_in.slice(axis, begin, begin + extent)
+        out = arr_out.slice(axis, begin, begin + extent)
+        mod.module["set_input_zero_copy"](0, x_in)
+        mod.module["set_output_zero_copy"](0, out)
+        mod.run()
+        expected = np.maximum(x_in.numpy(), 0) + 1
+        # the output lands in the viewed memory
+        written = np.take(arr_out.numpy(), range(begin, begin + extent), axis=axis)
+        tvm.testing.assert_allclose(written, expected, rtol=1e-6)
+
+
 if __name__ == "__main__":
     test_graph_simple()
     test_load_unexpected_params()
+    test_concurrent_ops()
+    test_multi_stream()
+    test_run_async()
+    test_run_async_streams()
+    test_pinned_staging_cpu()
+    test_pinned_staging()
+    test_zero_copy_after_rebuild()
+    test_streaming()
+    test_bind_state()
+    test_run_in_context()
+    test_zero_copy_strided_views()
@@ -416,6 +416,13 @@ def test_duplex_data_transferring():
             out = mod.get_output(0, tvm.nd.empty(shape))
             np.testing.assert_equal(out.numpy(), tensor_a + tensor_b - tensor_c + tensor_d)
 
+            # The device and host operators overlap when run concurrently.
+            mod.set_max_concurrent_ops(2)
+            for _ in range(3):
+                mod.run()
+                out = mod.get_output(0, tvm.nd.empty(shape))
+                np.testing.assert_equal(out.numpy(), tensor_a + tensor_b - tensor_c + tensor_d)
+
         def check_load_module():
             temp = utils.tempdir()
             path_lib = temp.relpath("deploy.so")
@@ -17,6 +17,8 @@
 import time
 import ctypes
 
+import numpy as np
+
 import tvm
 from tvm import te
 from tvm.contrib.utils import tempdir
@@ -57,6 +59,56 @@ def test_min_repeat_ms():
     assert ct > 10 + 2
 
 
+def test_adaptive_repeat():
+    tmp = tempdir()
+    filename = tmp.relpath("log")
+
+    @tvm.register_func
+    def my_debug_adaptive(filename):
+        """one call lasts for 10 ms and writes one character to a file"""
+        time.sleep(0.01)
+        with open(filename, "a") as fout:
+            fout.write("c")
+
+    X = te.compute((), lambda: tvm.tir.call_packed("my_debug_adaptive", filename))
+    s = te.create_schedule(X.op)
+    func = tvm.build(s, [X])
+
+    # clearly slower than a 1 ms incumbent, so it stops after two repeats
+    x = tvm.nd.empty((), dtype="int32")
+    ftimer = func.time_evaluator(func.entry_name, tvm.cpu(), number=1, repeat=20, cutoff=1e-3)
+    res = ftimer(x)
+    assert len(res.results) == 2
+    assert res.mean - res.ci > 1e-3
+
+    with open(filename, "r") as fin:
+        ct = len(fin.readline())
+
+    assert ct == 3
+
+
+def test_cache_preproc():
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    func = tvm.build(s, [A, B])
+
+    a = tvm.nd.array(np.random.uniform(size=n).astype("float32"))
+    b = tvm.nd.empty((n,), "float32")
+    for f_preproc in [
+        "cache_flush_cpu_args",
+        "cache_flush_cpu_non_first_arg",
+        "cache_warm_cpu_graph_context",
+    ]:
+        ftimer = func.time_evaluator(
+            func.entry_name, tvm.cpu(), number=1, repeat=3, f_preproc=f_preproc
+        )
+        res = ftimer(a, b)
+        assert len(res.results) == 3 and res.min > 0
+        np.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+
+
 def test_benchmark_result():
     r = BenchmarkResult([1, 2, 2, 5])
     assert r.mean == 2.5
@@ -64,8 +116,12 @@ def test_benchmark_result():
     assert r.min == 1
     assert r.max == 5
     assert r.std == 1.5
+    assert abs(r.ci - 3.182 * 1.7320508 / 2) < 1e-3
+    assert BenchmarkResult([1]).ci == float("inf")
 
 
 if __name__ == "__main__":
     test_min_repeat_ms()
+    test_adaptive_repeat()
+    test_cache_preproc()
     test_benchmark_result()
@@ -86,6 +86,41 @@ def test_cpu():
     tvm.testing.assert_allclose(out, verify(data), atol=1e-5)
 
 
+@tvm.testing.requires_llvm
+def test_cpu_shared_params():
+    mod, params = relay.testing.synthetic.get_workload()
+    with relay.build_config(opt_level=3):
+        complied_graph_lib = relay.build_module.build(mod, "llvm", params=params)
+    data = np.random.uniform(-1, 1, size=input_shape(mod)).astype("float32")
+    dev = tvm.cpu()
+    name = next(iter(complied_graph_lib.get_params()))
+    # Each executor gets its own copy of the params by default.
+    gmod0 = graph_executor.GraphModule(complied_graph_lib["default"](dev))
+    gmod1 = graph_executor.GraphModule(complied_graph_lib["default"](dev))
+    assert gmod0.get_input(name).handle.contents.data != gmod1.get_input(name).handle.contents.data
+
+    # Once enabled, executors created by one factory link to the same params.
+    complied_graph_lib["set_share_params"](True)
+    gmod0 = graph_executor.GraphModule(complied_graph_lib["default"](dev))
+    gmod1 = graph_executor.GraphModule(complied_graph_lib["default"](dev))
+    assert gmod0.get_input(name).handle.contents.data == gmod1.get_input(name).handle.contents.data
+    for gmod in [gmod0, gmod1]:
+        gmod.set_input("data", data)
+        gmod.run()
+        tvm.testing.assert_allclose(gmod.get_output(0).numpy(), verify(data), atol=1e-5)
+
+    # Overwriting a param only changes the executor it is set on.
+    param = gmod0.get_input(name).numpy()
+    gmod0.set_input(name, np.zeros_like(param))
+    tvm.testing.assert_allclose(gmod1.get_input(name).numpy(), param)
+    gmod1.run()
+    tvm.testing.assert_allclose(gmod1.get_output(0).numpy(), verify(data), atol=1e-5)
+
+    complied_graph_lib["set_share_params"](False)
+    gmod2 = graph_executor.GraphModule(complied_graph_lib["default"](dev))
+    assert gmod2.get_input(name).handle.contents.data != gmod1.get_input(name).handle.contents.data
+
+
 @tvm.testing.requires_llvm
 def test_cpu_get_graph_json():
     mod, params = relay.testing.synthetic.get_workload()
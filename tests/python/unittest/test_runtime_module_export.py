@@ -14,6 +14,10 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import os
+
+import numpy as np
+
 from tvm import relay
 from tvm.relay import testing
 import tvm
@@ -225,5 +229,60 @@ def test_mod_export():
     verify_multi_c_mod_export()
 
 
+def test_export_object_cache():
+    from shutil import which
+
+    if which("g++") is None:
+        print("Skip test because g++ is not available.")
+        return
+
+    A = te.placeholder((1024,), name="A")
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    mod0 = tvm.build(s, [A, B], "c", name="myadd0")
+    mod1 = tvm.build(s, [A, B], "c", name="myadd1")
+    mod0.import_module(mod1)
+
+    temp = utils.tempdir()
+    cache_dir = temp.relpath("objects")
+    for index in range(2):
+        path_lib = temp.relpath("deploy_lib%d.so" % index)
+        mod0.export_library(path_lib, num_workers=2, object_cache_dir=cache_dir)
+        # the second export reuses the objects of the first one.
+        assert len(os.listdir(cache_dir)) == 2
+        loaded_lib = tvm.runtime.load_module(path_lib)
+        for name in ["myadd0", "myadd1"]:
+            a = tvm.nd.array(np.random.uniform(size=1024).astype(A.dtype))
+            b = tvm.nd.array(np.zeros(1024, dtype=B.dtype))
+            loaded_lib[name](a, b)
+            tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+
+
+@tvm.testing.requires_cuda
+def test_lazy_device_module():
+    A = te.placeholder((1024,), name="A")
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    bx, tx = s[B].split(B.op.axis[0], factor=64)
+    s[B].bind(bx, te.thread_axis("blockIdx.x"))
+    s[B].bind(tx, te.thread_axis("threadIdx.x"))
+    mod = tvm.build(s, [A, B], "cuda", name="myadd")
+
+    temp = utils.tempdir()
+    dev = tvm.cuda(0)
+    for index in range(2):
+        path_lib = temp.relpath("deploy_lib%d.so" % index)
+        # the second export saves the module loaded by the first one before it is used.
+        mod.export_library(path_lib)
+        mod = tvm.runtime.load_module(path_lib)
+        assert mod.imported_modules[0].type_key == "cuda"
+
+    a = tvm.nd.array(np.random.uniform(size=1024).astype(A.dtype), dev)
+    b = tvm.nd.array(np.zeros(1024, dtype=B.dtype), dev)
+    mod["myadd"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+
+
 if __name__ == "__main__":
     test_mod_export()
+    test_export_object_cache()
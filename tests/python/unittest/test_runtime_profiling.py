@@ -27,7 +27,8 @@ from tvm import relay
 from tvm.relay.testing import mlp
 from tvm.contrib.debugger import debug_executor
 from tvm import rpc
-from tvm.contrib import utils
+from tvm.contrib import roofline, utils
+from tvm.runtime import profiling
 from tvm.runtime.profiling import Report
 
 
@@ -132,6 +133,53 @@ def test_papi(target, dev):
     assert any([float(x) > 0 for x in csv[metric]])
 
 
+@tvm.testing.requires_cuda
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.profiling.CUPTIMetricCollector", allow_missing=True) is None,
+    reason="CUPTI profiling not enabled",
+)
+def test_cupti():
+    dev = tvm.cuda()
+    mod, params = mlp.get_workload(1)
+    exe = relay.vm.compile(mod, "cuda", params=params)
+    vm = profiler_vm.VirtualMachineProfiler(exe, dev)
+
+    data = tvm.nd.array(np.random.rand(1, 1, 28, 28).astype("float32"), device=dev)
+    metrics = ["dram__bytes.sum", "lts__t_sector_hit_rate.pct"]
+    report = vm.profile(
+        [data],
+        func_name="main",
+        collectors=[tvm.runtime.profiling.CUPTIMetricCollector(metrics)],
+    )
+    csv = read_csv(report)
+    for metric in metrics:
+        assert metric in csv.keys()
+    assert any([float(x) > 0 for x in csv["dram__bytes.sum"] if x])
+
+
+@tvm.testing.requires_rocm
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.profiling.ROCProfilerMetricCollector", allow_missing=True)
+    is None,
+    reason="rocprofiler profiling not enabled",
+)
+def test_rocprofiler():
+    dev = tvm.rocm()
+    mod, params = mlp.get_workload(1)
+    exe = relay.vm.compile(mod, "rocm", params=params)
+    vm = profiler_vm.VirtualMachineProfiler(exe, dev)
+
+    data = tvm.nd.array(np.random.rand(1, 1, 28, 28).astype("float32"), device=dev)
+    report = vm.profile(
+        [data],
+        func_name="main",
+        collectors=[tvm.runtime.profiling.ROCProfilerMetricCollector(["FETCH_SIZE", "L2CacheHit"])],
+    )
+    csv = read_csv(report)
+    assert "FETCH_SIZE" in csv.keys()
+    assert "L2CacheHit" in csv.keys()
+
+
 @tvm.testing.requires_llvm
 def test_json():
     mod, params = mlp.get_workload(1)
@@ -153,6 +201,69 @@ def test_json():
         assert isinstance(call["Duration (us)"]["microseconds"], float)
 
 
+@tvm.testing.requires_llvm
+def test_chrome_trace():
+    mod, params = mlp.get_workload(1)
+
+    exe = relay.vm.compile(mod, "llvm", params=params)
+    vm = profiler_vm.VirtualMachineProfiler(exe, tvm.cpu())
+
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    report = vm.profile(data, func_name="main")
+    trace = json.loads(report.chrome_trace())
+    events = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+    assert len(events) == len(report.calls)
+    assert any(e["name"] == "VM::AllocStorage" for e in events)
+    starts = [e["ts"] for e in events]
+    assert starts == sorted(starts)
+    assert all(e["dur"] >= 0 and e["pid"] == 0 for e in events)
+    processes = [e for e in trace["traceEvents"] if e["ph"] == "M"]
+    assert [p["args"]["name"] for p in processes] == ["cpu0"]
+
+    # the timeline is left out of the tables
+    assert "Start (us)" not in report.table()
+    # and kept by the serialization
+    trace2 = json.loads(Report.from_json(report.json()).chrome_trace())
+    key = lambda e: (e["name"], e["ts"], e["dur"], e["tid"])
+    assert [key(e) for e in trace2["traceEvents"] if e["ph"] == "X"] == [key(e) for e in events]
+
+
+@tvm.testing.requires_llvm
+def test_peak_memory():
+    mod, params = mlp.get_workload(1)
+
+    exe = relay.vm.compile(mod, "llvm", params=params)
+    vm = profiler_vm.VirtualMachineProfiler(exe, tvm.cpu())
+
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    report = vm.profile(data, func_name="main")
+    parsed = json.loads(report.json())
+    assert parsed["device_metrics"]["cpu0"]["Peak Memory (bytes)"]["count"] > 0
+    assert "Peak Memory (bytes)" in str(report)
+
+
+def test_memory_statistics():
+    get_statistics = tvm.get_global_func("runtime.GetMemoryStatistics")
+
+    def ndarray_counter():
+        return json.loads(get_statistics())["cpu0"]["ndarray"]
+
+    tvm.nd.empty((1,), "float32")
+    before = ndarray_counter()
+    arr = tvm.nd.empty((1024, 1024), "float32")
+    during = ndarray_counter()
+    assert during["current_bytes"] - before["current_bytes"] == 4 << 20
+    assert during["num_allocs"] == before["num_allocs"] + 1
+    assert during["histogram"][str(4 << 20)] >= 1
+    assert during["peak_bytes"] >= during["current_bytes"]
+    del arr
+    after = ndarray_counter()
+    assert after["current_bytes"] == before["current_bytes"]
+    assert after["num_frees"] == before["num_frees"] + 1
+    total = json.loads(get_statistics())["cpu0"]["total"]
+    assert total["peak_bytes"] >= during["current_bytes"]
+
+
 @tvm.testing.requires_llvm
 def test_rpc_vm():
     server = rpc.Server(key="profiling")
@@ -210,6 +321,51 @@ def test_report_serialization():
     )
 
 
+def test_report_from_metrics():
+    calls = [
+        {
+            "Name": "fused_dense",
+            "Duration (us)": profiling.Duration(10.0),
+            "Count": profiling.Count(1),
+            "Percent": profiling.Percent(50.0),
+            "GFLOP/s": profiling.Ratio(float(gflops)),
+        }
+        for gflops in [1, 3]
+    ]
+    device_metrics = {"cpu0": {"Duration (us)": profiling.Duration(20.0)}}
+    report = Report(calls, device_metrics)
+    parsed = json.loads(report.json())
+    assert parsed["calls"][1]["GFLOP/s"]["ratio"] == 3.0
+    # aggregated calls report the mean ratio
+    assert "2.00" in report.table()
+    report2 = Report.from_json(report.json())
+    assert report.table(aggregate=False, col_sums=False) == report2.table(
+        aggregate=False, col_sums=False
+    )
+
+
+def test_roofline_analysis():
+    mod, params = mlp.get_workload(1)
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    report = roofline.roofline_analysis(
+        mod, params, "llvm", tvm.cpu(), {"data": data}, peak_flops=1e11, peak_bandwidth=1e10
+    )
+    calls = json.loads(report.json())["calls"]
+    dense_calls = [call for call in calls if "dense" in call["Name"]["string"]]
+    assert len(dense_calls) > 0
+    for call in dense_calls:
+        assert call["Estimated FLOPs"]["count"] > 0
+        assert call["Estimated Bytes"]["count"] > 0
+        assert call["Bound"]["string"] in ["compute", "memory"]
+        assert 0 <= call["Roofline Efficiency (%)"]["ratio"] <= 100
+    assert "Roofline Headroom (us)" in report.table()
+
+    ranking = roofline.roofline_ranking(report)
+    assert len(ranking) > 0
+    headrooms = [op["Roofline Headroom (us)"] for op in ranking]
+    assert headrooms == sorted(headrooms, reverse=True)
+
+
 if __name__ == "__main__":
     import sys
     import pytest
@@ -17,6 +17,7 @@
 import tvm
 from tvm import te
 import tvm.testing
+import hashlib
 import multiprocessing
 import os
 import stat
@@ -109,6 +110,67 @@ def test_rpc_simple():
     check_remote()
 
 
+@tvm.testing.requires_rpc
+def test_rpc_async_call():
+    server = rpc.Server(key="x1")
+    client = rpc.connect("127.0.0.1", server.port, key="x1")
+
+    def check_remote():
+        addone = client.get_async_function("rpc.test.addone")
+        waits = [addone(i) for i in range(10)]
+        assert [wait() for wait in waits] == list(range(1, 11))
+
+        # The error is raised by the call it belongs to.
+        wait_except = client.get_async_function("rpc.test.except")("abc")
+        wait_addone = addone(1)
+        with pytest.raises(tvm._ffi.base.TVMError):
+            wait_except()
+        assert wait_addone() == 2
+        assert client.get_function("rpc.test.addone")(10) == 11
+
+        # The copies to the remote do not wait for their acknowledgement.
+        x = np.random.uniform(size=(1024,)).astype("float32")
+        arrays = [tvm.nd.array(x + i, client.cpu(0)) for i in range(4)]
+        for i, arr in enumerate(arrays):
+            np.testing.assert_equal(arr.numpy(), x + i)
+
+    check_remote()
+
+
+@tvm.testing.requires_rpc
+def test_rpc_chunked_compressed_copy():
+    server = rpc.Server(key="x1")
+    client = rpc.connect("127.0.0.1", server.port, key="x1")
+
+    def check_remote(chunk_size, compression):
+        client.set_transfer_options(chunk_size=chunk_size, compression=compression)
+        dev = client.cpu(0)
+        # runs of zeros as in a pruned weight, and an odd size for the last chunk
+        x = np.random.uniform(size=(64, 1001)).astype("float32")
+        x[::2] = 0
+        arr = tvm.nd.array(x, dev)
+        np.testing.assert_equal(arr.numpy(), x)
+        y = np.random.randint(-128, 127, size=(4099,)).astype("int8")
+        np.testing.assert_equal(tvm.nd.array(y, dev).numpy(), y)
+
+    check_remote(4096, None)
+    check_remote(4096, "zero_rle")
+    check_remote(0, "zero_rle")
+    check_remote(0, None)
+
+
+@tvm.testing.requires_rpc
+def test_rpc_shm_session():
+    if tvm.get_global_func("rpc.CreateShmClient", allow_missing=True) is None:
+        return
+    sess = rpc.ShmSession()
+    addone = sess.get_function("rpc.test.addone")
+    assert [addone(i) for i in range(100)] == list(range(1, 101))
+    # larger than the ring of each direction
+    x = np.random.uniform(size=(3 << 20,)).astype("float32")
+    np.testing.assert_equal(tvm.nd.array(x, sess.cpu(0)).numpy(), x)
+
+
 @tvm.testing.requires_rpc
 def test_rpc_runtime_string():
     server = rpc.Server(key="x1")
@@ -215,6 +277,56 @@ def test_rpc_file_exchange():
     check_remote()
 
 
+def test_rpc_upload_cache():
+    server = rpc.Server()
+    blob = bytearray(np.random.randint(0, 10, size=(1000)))
+    digest = hashlib.sha256(blob).hexdigest()
+
+    def check_remote():
+        remote = rpc.connect("127.0.0.1", server.port)
+        load_cached_upload = remote.get_function("tvm.rpc.server.load_cached_upload")
+        assert not load_cached_upload("cached.bin", digest)
+        remote.upload(blob, "dat.bin")
+        # the next sessions find the file
+        remote = rpc.connect("127.0.0.1", server.port)
+        load_cached_upload = remote.get_function("tvm.rpc.server.load_cached_upload")
+        assert load_cached_upload("cached.bin", digest)
+        assert remote.download("cached.bin") == blob
+        remote.upload(blob, "dat.bin")
+        assert remote.download("dat.bin") == blob
+
+    check_remote()
+    server.terminate()
+
+
+@tvm.testing.requires_rpc
+@tvm.testing.requires_llvm
+@pytest.mark.skipif(not sys.platform.startswith("linux"), reason="needs memfd_create")
+def test_rpc_upload_and_load():
+    A = te.placeholder((102,), name="A")
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    server = rpc.Server()
+
+    def check_remote():
+        remote = rpc.connect("127.0.0.1", server.port)
+        temp = utils.tempdir()
+        path_dso = temp.relpath("dev_lib.so")
+        tvm.build(s, [A, B], "llvm", name="myadd").export_library(path_dso)
+        # loaded from memory, nothing is written to the remote temp folder
+        f1 = remote.upload_and_load(path_dso)
+        with pytest.raises(tvm.error.TVMError):
+            remote.download("dev_lib.so")
+        dev = remote.cpu(0)
+        a = tvm.nd.array(np.random.uniform(size=102).astype(A.dtype), dev)
+        b = tvm.nd.array(np.zeros(102, dtype=A.dtype), dev)
+        f1(a, b)
+        np.testing.assert_equal(b.numpy(), a.numpy() + 1)
+
+    check_remote()
+    server.terminate()
+
+
 @tvm.testing.requires_rpc
 @tvm.testing.requires_llvm
 def test_rpc_remote_module():
@@ -493,6 +605,37 @@ def test_rpc_tracker_register():
     tracker.terminate()
 
 
+@tvm.testing.requires_rpc
+def test_rpc_tracker_session_pool():
+    tracker = Tracker(port=9000, port_end=10000)
+    device_key = "test_device"
+    server = rpc.Server(
+        port=9000,
+        port_end=10000,
+        key=device_key,
+        tracker_addr=("127.0.0.1", tracker.port),
+    )
+    time.sleep(1)
+    client = rpc.connect_tracker("127.0.0.1", tracker.port)
+    pool = client.session_pool(device_key)
+
+    def check_pool():
+        with pool.session() as remote:
+            remote.upload(bytearray(10), "dat.bin")
+        # the session is kept, with its files
+        with pool.session() as remote:
+            assert remote.download("dat.bin") == bytearray(10)
+        assert client.summary()["queue_info"][device_key]["free"] == 0
+
+    check_pool()
+    pool.close()
+    time.sleep(1)
+    assert client.summary()["queue_info"][device_key]["free"] == 1
+
+    server.terminate()
+    tracker.terminate()
+
+
 def _target(host, port, device_key, timeout):
     client = rpc.connect_tracker(host, port)
     remote = client.request(device_key, session_timeout=timeout)
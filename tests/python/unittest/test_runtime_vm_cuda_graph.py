@@ -0,0 +1,61 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib.cuda_graph import cuda_graph_vm
+
+
+@tvm.testing.requires_cuda
+def test_vm_cuda_graph_dynamic_batch():
+    if not cuda_graph_vm.enabled():
+        print("skip because cuda graph vm is not enabled...")
+        return
+
+    x = relay.var("x", shape=(relay.Any(), 16), dtype="float32")
+    w = relay.var("w", shape=(32, 16), dtype="float32")
+    y = relay.nn.relu(relay.nn.dense(x, w))
+    mod = tvm.IRModule.from_expr(relay.Function([x, w], y))
+    w_np = np.random.uniform(size=(32, 16)).astype("float32")
+
+    dev = tvm.cuda(0)
+    with tvm.transform.PassContext(opt_level=3):
+        exe = relay.vm.compile(mod, target="cuda")
+    ref_vm = tvm.runtime.vm.VirtualMachine(exe, dev)
+    vm = cuda_graph_vm.VirtualMachineCudaGraph(exe, dev)
+    vm.set_cuda_graph_cache_size(2)
+
+    for batch in [1, 4, 1, 8, 4]:
+        x_np = np.random.uniform(size=(batch, 16)).astype("float32")
+        ref = ref_vm.run(x_np, w_np).numpy()
+        # Replay twice so that the second call hits the cached graph.
+        vm.run(x_np, w_np)
+        out = vm.run(x_np, w_np).numpy()
+        tvm.testing.assert_allclose(out, ref, rtol=1e-5)
+        assert vm.get_cuda_graph_cache_size() <= 2
+
+    vm.set_cuda_graph_cache_size(1)
+    assert vm.get_cuda_graph_cache_size() == 1
+
+
+if __name__ == "__main__":
+    import sys
+    import pytest
+
+    sys.exit(pytest.main([__file__] + sys.argv[1:]))
@@ -104,6 +104,52 @@ def test_alloc_vtcm():
     assert "HexagonBackendFreeVTCM" in calls
 
 
+def test_cache_read_global_vtcm():
+    buf_len = 2048
+    A = tvm.te.placeholder((buf_len,), name="A", dtype="int8")
+    C = tvm.te.compute((buf_len,), lambda *i: A(*i) + 1, name="C")
+    s = tvm.te.create_schedule(C.op)
+    s.cache_read(A, "global.vtcm", [C])
+
+    mod = tvm.lower(s, [A, C], name="cache_vtcm")
+    mod = tvm.tir.transform.Apply(lambda f: f.with_attr("target", tvm.target.Target("llvm")))(mod)
+    mod = tvm.tir.transform.MakePackedAPI()(mod)
+    mod = tvm.tir.transform.LowerDeviceStorageAccessInfo()(mod)
+    mod = tvm.tir.transform.LowerTVMBuiltin()(mod)
+
+    # the VTCM buffer is allocated at runtime by the device API, not as a workspace.
+    text = str(mod["cache_vtcm"])
+    assert "device_api.hexagon.AllocVtcm" in text
+    assert "device_api.hexagon.FreeVtcm" in text
+    assert "TVMBackendAllocWorkspace" not in text
+
+
+@tvm.testing.requires_llvm
+def test_tensorize_vrmpy():
+    from tvm.topi.hexagon.tensor_intrin import dot_vrmpy
+
+    m, n, k = 4, 64, 32
+    X = tvm.te.placeholder((m, k), name="X", dtype="uint8")
+    W = tvm.te.placeholder((n, k), name="W", dtype="int8")
+    r = tvm.te.reduce_axis((0, k), name="r")
+    C = tvm.te.compute(
+        (m, n),
+        lambda i, j: tvm.te.sum(X[i, r].astype("int32") * W[j, r].astype("int32"), axis=r),
+        name="C",
+    )
+    s = tvm.te.create_schedule(C.op)
+    i, j = C.op.axis
+    jo, ji = s[C].split(j, factor=32)
+    ro, ri = s[C].split(C.op.reduce_axis[0], factor=4)
+    s[C].reorder(i, jo, ro, ji, ri)
+    s[C].tensorize(ji, dot_vrmpy("uint8", "int8"))
+
+    text = str(tvm.lower(s, [X, W, C]))
+    for name in ["llvm.hexagon.V6.vrmpybusv.128B", "llvm.hexagon.V6.vrmpybusv.acc.128B"]:
+        llvm_id = tvm.target.codegen.llvm_lookup_intrinsic_id(name)
+        assert "call_llvm_pure_intrin(%d" % llvm_id in text.replace(" ", "")
+
+
 @tvm.testing.requires_hexagon
 def test_llvm_options():
     target = tvm.target.hexagon("v66", llvm_options="-hexagon-noopt")
@@ -906,5 +906,97 @@ def test_llvm_scalar_concat():
         m = tvm.build(mod, [x, y, z], target="llvm")
 
 
+@tvm.testing.requires_llvm
+def test_llvm_parallel_codegen():
+    n = 64
+    funcs = {}
+    for i in range(6):
+        A = te.placeholder((n,), name="A")
+        B = te.compute((n,), lambda j, i=i: A[j] * (i + 1) + 1.0, name="B")
+        func = te.create_prim_func([A, B]).with_attr("global_symbol", "scale%d" % i)
+        funcs["scale%d" % i] = func
+    mod = tvm.IRModule(funcs)
+    with tvm.transform.PassContext(config={"tir.lower_num_threads": 4}):
+        m = tvm.build(mod, target="llvm")
+    a_np = np.random.uniform(size=n).astype("float32")
+    for i in range(6):
+        a = tvm.nd.array(a_np)
+        b = tvm.nd.empty((n,), "float32")
+        m["scale%d" % i](a, b)
+        tvm.testing.assert_allclose(b.numpy(), a_np * (i + 1) + 1.0, rtol=1e-5)
+    # the linked module can still be exported
+    temp = utils.tempdir()
+    m.save(temp.relpath("parallel.o"))
+
+
+@tvm.testing.requires_llvm
+def test_llvm_branch_profile():
+    from tvm.contrib import pgo
+
+    n = te.var("n")
+    m = te.var("m")
+    A = te.placeholder((n,), name="A")
+
+    def _body(A, B):
+        ib = tvm.tir.ir_builder.create()
+        a = ib.buffer_ptr(A)
+        b = ib.buffer_ptr(B)
+        with ib.for_range(0, n, name="i") as i:
+            with ib.if_scope(i < m):
+                b[i] = a[i] + 1.0
+            with ib.else_scope():
+                b[i] = a[i] * 2.0
+        return ib.get()
+
+    B = te.extern((n,), [A], lambda ins, outs: _body(ins[0], outs[0]), name="B", dtype="float32")
+    s = te.create_schedule(B.op)
+    a_np = np.random.uniform(size=10).astype("float32")
+    expected = np.where(np.arange(10) < 3, a_np + 1.0, a_np * 2.0)
+
+    def _run(module):
+        b = tvm.nd.empty((10,), "float32")
+        module(tvm.nd.array(a_np), b, 3)
+        tvm.testing.assert_allclose(b.numpy(), expected, rtol=1e-5)
+
+    with tvm.transform.PassContext(config={"tir.llvm.instrument_branches": True}):
+        instrumented = tvm.build(s, [A, B, m], "llvm", name="branchy")
+    _run(instrumented)
+    profile = pgo.collect_branch_profile(instrumented)
+    counts = [tuple(int(x) for x in line.split()[1:]) for line in profile.splitlines()]
+    # the loop ran 10 times, the then case 3 times
+    assert (10, 1) in counts
+    assert (3, 7) in counts
+    assert pgo.merge_branch_profiles(profile, profile).count(" 20 2\n") == 1
+
+    with tvm.transform.PassContext(config={"tir.llvm.branch_profile": profile}):
+        optimized = tvm.build(s, [A, B, m], "llvm", name="branchy")
+    assert "__tvm_branch_count" not in optimized.get_source()
+    _run(optimized)
+    _run(pgo.profile_guided_build(s, "llvm", _run, args=[A, B, m], name="branchy"))
+
+
+@tvm.testing.requires_llvm
+def test_llvm_wasm_simd128():
+    n = 64
+    A = te.placeholder((n,), name="A")
+    B = te.compute(A.shape, lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    xo, xi = s[B].split(B.op.axis[0], factor=4)
+    s[B].vectorize(xi)
+    runtime = Runtime("cpp", {"system-lib": True})
+
+    def get_ll(simd):
+        target = tvm.target.wasm(simd=simd)
+        try:
+            f = tvm.build(s, [A, B], target, runtime=runtime)
+        except tvm.TVMError:
+            pytest.skip("the WebAssembly backend of LLVM is not enabled")
+        return f.get_source("ll")
+
+    assert "+simd128" in str(tvm.target.wasm().attrs["mattr"])
+    assert "+atomics" in str(tvm.target.wasm(threads=True).attrs["mattr"])
+    assert "<4 x float>" in get_ll(simd=True)
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main([__file__] + sys.argv[1:]))
@@ -14,6 +14,7 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import numpy as np
 import tvm
 from tvm import te
 import tvm.testing
@@ -139,8 +140,33 @@ def test_opencl_erf():
     check_erf(dev, 1, "float64")
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_opencl
+def test_opencl_event_timer():
+    n = 1024
+    A = te.placeholder((n,), name="A", dtype="float32")
+    B = te.compute((n,), lambda i: A[i] * 2.0, name="B")
+    C = te.compute((n,), lambda i: B[i] + 1.0, name="C")
+    s = te.create_schedule(C.op)
+    for stage in [B, C]:
+        xo, xi = s[stage].split(stage.op.axis[0], factor=64)
+        s[stage].bind(xo, te.thread_axis("blockIdx.x"))
+        s[stage].bind(xi, te.thread_axis("threadIdx.x"))
+    fun = tvm.build(s, [A, C], target)
+
+    dev = tvm.device(target, 0)
+    a_np = np.random.uniform(size=n).astype("float32")
+    a = tvm.nd.array(a_np, dev)
+    c = tvm.nd.empty((n,), "float32", dev)
+    # The timer measures the two kernels from their profiling events.
+    result = fun.time_evaluator(fun.entry_name, dev, number=3)(a, c)
+    assert result.mean > 0
+    tvm.testing.assert_allclose(c.numpy(), a_np * 2.0 + 1.0, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_opencl_ternary_expression()
     test_opencl_inf_nan()
     test_opencl_max()
     test_opencl_erf()
+    test_opencl_event_timer()
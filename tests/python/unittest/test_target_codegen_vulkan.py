@@ -555,6 +555,96 @@ def test_shared_mem_alloc(target, dev):
         tvm.build(s, [Out], target)
 
 
+def _cooperative_matrix_gemm():
+    n = 16
+    A = te.placeholder((n, n), dtype="float16", name="A")
+    B = te.placeholder((n, n), dtype="float16", name="B")
+
+    def do_compute(ins, outs):
+        ib = tvm.tir.ir_builder.create()
+        ib.scope_attr(te.thread_axis("blockIdx.x"), "thread_extent", 1)
+        ib.scope_attr(te.thread_axis("threadIdx.x"), "thread_extent", 32)
+        frag_a = ib.allocate("float16", (n * n,), name="frag_a", scope="wmma.matrix_a")
+        frag_b = ib.allocate("float16", (n * n,), name="frag_b", scope="wmma.matrix_b")
+        frag_c = ib.allocate("float32", (n * n,), name="frag_c", scope="wmma.accumulator")
+        frag_a, frag_b, frag_c = frag_a.asobject(), frag_b.asobject(), frag_c.asobject()
+
+        def emit(name, *args):
+            ib.emit(tvm.tir.call_intrin("handle", name, *args))
+
+        emit("tir.tvm_fill_fragment", frag_c, n, n, n, 0, 0.0)
+        emit("tir.tvm_load_matrix_sync", frag_a, n, n, n, 0, ins[0].access_ptr("r"), n, "row_major")
+        emit("tir.tvm_load_matrix_sync", frag_b, n, n, n, 0, ins[1].access_ptr("r"), n, "row_major")
+        emit("tir.tvm_mma_sync", frag_c, 0, frag_a, 0, frag_b, 0, frag_c, 0)
+        emit(
+            "tir.tvm_store_matrix_sync", frag_c, n, n, n, 0, outs[0].access_ptr("w"), n, "row_major"
+        )
+        return ib.get()
+
+    C = te.extern((n, n), [A, B], do_compute, dtype="float32", name="C")
+    return te.create_schedule(C.op), [A, B, C]
+
+
+# Explicitly specify a target, as this test is looking at the
+# generated shader code, and is not running on an actual device.
+@tvm.testing.parametrize_targets(
+    " ".join(
+        [
+            "vulkan",
+            "-supports_cooperative_matrix=1",
+            "-supports_storage_buffer_storage_class=1",
+            "-supports_float16=1",
+            "-supports_16bit_buffer=1",
+        ]
+    )
+)
+def test_cooperative_matrix(target):
+    s, args = _cooperative_matrix_gemm()
+    f = tvm.build(s, args, target)
+    assembly = f.imported_modules[0].get_source()
+    assert "OpCapability CooperativeMatrixNV" in assembly
+    # matrix_a and matrix_b share the 16x16 half type
+    assert len(re.findall("OpTypeCooperativeMatrixNV", assembly)) == 2
+    assert len(re.findall("OpCooperativeMatrixLoadNV", assembly)) == 2
+    assert len(re.findall("OpCooperativeMatrixMulAddNV", assembly)) == 1
+    assert len(re.findall("OpCooperativeMatrixStoreNV", assembly)) == 1
+
+
+@tvm.testing.parametrize_targets("vulkan -supports_float16=1 -supports_16bit_buffer=1")
+def test_cooperative_matrix_unsupported(target):
+    s, args = _cooperative_matrix_gemm()
+    with pytest.raises(tvm.TVMError):
+        tvm.build(s, args, target)
+
+
+@tvm.testing.parametrize_targets("vulkan")
+def test_vulkan_alternating_buffers(target, dev):
+    """Launch one kernel many times between synchronizations, alternating
+    between buffers, which reuses the descriptor set of each binding when
+    push descriptors are not supported."""
+    n = 256
+    A = te.placeholder((n,), name="A", dtype="float32")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    xo, xi = s[B].split(B.op.axis[0], factor=64)
+    s[B].bind(xo, te.thread_axis("blockIdx.x"))
+    s[B].bind(xi, te.thread_axis("threadIdx.x"))
+    fun = tvm.build(s, [A, B], target)
+
+    bufs = [tvm.nd.array(np.zeros(n, dtype="float32"), dev) for _ in range(3)]
+    num_steps = 10
+    for step in range(num_steps):
+        src = bufs[step % 3]
+        dst = bufs[(step + 1) % 3]
+        fun(src, dst)
+    dev.sync()
+    expected = [np.zeros(n, dtype="float32") for _ in range(3)]
+    for step in range(num_steps):
+        expected[(step + 1) % 3] = expected[step % 3] + 1.0
+    for buf, ref in zip(bufs, expected):
+        tvm.testing.assert_allclose(buf.numpy(), ref)
+
+
 if __name__ == "__main__":
     import sys
 
@@ -0,0 +1,58 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm import te
+
+
+def test_estimate_elementwise():
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2.0 + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    func = tvm.lower(s, [A, B])["main"]
+    assert tvm.tir.analysis.estimate_tir_flops(func) == 2 * n
+    assert tvm.tir.analysis.estimate_tir_bytes(func) == 2 * n * 4
+
+
+def test_estimate_matmul():
+    n, m, l = 32, 16, 64
+    A = te.placeholder((n, l), name="A")
+    B = te.placeholder((l, m), name="B")
+    k = te.reduce_axis((0, l), name="k")
+    C = te.compute((n, m), lambda i, j: te.sum(A[i, k] * B[k, j], axis=k), name="C")
+    s = te.create_schedule(C.op)
+    s[C].vectorize(C.op.axis[1])
+    func = tvm.lower(s, [A, B, C])["main"]
+    assert tvm.tir.analysis.estimate_tir_flops(func) == 2 * n * m * l
+    # every buffer moves its size once, the reduction re-reads the output from the cache
+    assert tvm.tir.analysis.estimate_tir_bytes(func) == (n * l + l * m + n * m) * 4
+
+
+def test_estimate_integer_ops():
+    n = 128
+    A = te.placeholder((n,), name="A", dtype="int32")
+    B = te.compute((n,), lambda i: A[i] + 1, name="B")
+    s = te.create_schedule(B.op)
+    func = tvm.lower(s, [A, B])["main"]
+    assert tvm.tir.analysis.estimate_tir_flops(func) == 0
+    assert tvm.tir.analysis.estimate_tir_bytes(func) == 2 * n * 4
+
+
+if __name__ == "__main__":
+    test_estimate_elementwise()
+    test_estimate_matmul()
+    test_estimate_integer_ops()
@@ -430,6 +430,30 @@ def test_redundant_kernels():
         assert valid[0]
 
 
+def test_shared_memory_bank_conflicts():
+    def make_func(stride):
+        ib = tvm.tir.ir_builder.create()
+        out = ib.pointer("float32", name="out")
+        tx = te.thread_axis("threadIdx.x")
+        ib.scope_attr(tx, "thread_extent", 32)
+        shared = ib.allocate("float32", 32 * stride, name="shared", scope="shared")
+        shared[tx * stride] = out[tx]
+        out[tx] = shared[tx * stride]
+        return tvm.tir.PrimFunc([out.asobject()], ib.get())
+
+    def verify(stride, max_conflicts):
+        return tvm.tir.analysis.verify_gpu_code(
+            make_func(stride), {"max_shared_memory_bank_conflicts": max_conflicts}
+        )
+
+    assert verify(1, 1)
+    assert verify(33, 1)
+    assert not verify(2, 1)
+    assert verify(2, 2)
+    assert not verify(32, 16)
+    assert verify(32, 32)
+
+
 if __name__ == "__main__":
     test_local_memory()
     test_shared_memory()
@@ -440,3 +464,4 @@ if __name__ == "__main__":
     test_vectorize_half()
     test_vthread()
     test_redundant_kernels()
+    test_shared_memory_bank_conflicts()
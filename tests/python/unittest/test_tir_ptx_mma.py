@@ -0,0 +1,114 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import te
+from tvm.contrib.nvcc import parse_compute_version
+
+
+def _have_sm80():
+    major, _ = parse_compute_version(tvm.cuda(0).compute_version)
+    return major >= 8
+
+
+def _mma_m16n8k16(A, B, C):
+    """One warp computing C[16, 8] = A[16, 16] * B[8, 16]^T, A loaded by ldmatrix."""
+    ib = tvm.tir.ir_builder.create()
+    tx = te.thread_axis("threadIdx.x")
+    ib.scope_attr(tx, "thread_extent", 32)
+    A = ib.buffer_ptr(A)
+    B = ib.buffer_ptr(B)
+    C = ib.buffer_ptr(C)
+    A_shared = ib.allocate("float16", [256], name="A_shared", scope="shared")
+    a = ib.allocate("float16", [8], name="a", scope="local")
+    b = ib.allocate("float16", [4], name="b", scope="local")
+    c = ib.allocate("float32", [4], name="c", scope="local")
+    group, thread_in_group = tx // 4, tx % 4
+
+    for i in range(8):
+        A_shared[tx * 8 + i] = A[tx * 8 + i]
+    # the threads provide the row addresses of the four 8x8 matrices of the fragment of A
+    row, col = tx % 16, tx // 16 * 8
+    shared_row = tvm.tir.call_intrin(
+        "handle",
+        "tir.tvm_access_ptr",
+        tvm.tir.call_intrin("float16", "tir.type_annotation"),
+        A_shared.asobject(),
+        row * 16 + col,
+        8,
+        1,
+    )
+    ib.emit(tvm.tir.ptx_ldmatrix(False, 4, ".b16", a.asobject(), 0, shared_row))
+    for i in range(4):
+        k = thread_in_group * 2 + i % 2 + i // 2 * 8
+        b[i] = B[group * 16 + k]
+    for i in range(4):
+        c[i] = 0.0
+    ib.emit(
+        tvm.tir.ptx_mma(
+            "m16n8k16",
+            "row",
+            "col",
+            "f16",
+            "f16",
+            "f32",
+            a.asobject(),
+            0,
+            b.asobject(),
+            0,
+            c.asobject(),
+            0,
+        )
+    )
+    for i in range(4):
+        C[(group + i // 2 * 8) * 8 + thread_in_group * 2 + i % 2] = c[i]
+    return ib.get()
+
+
+@tvm.testing.requires_cuda
+def test_mma_m16n8k16_f16_f32():
+    if not _have_sm80():
+        print("skip because gpu does not support sm_80")
+        return
+    A = te.placeholder((16, 16), name="A", dtype="float16")
+    B = te.placeholder((8, 16), name="B", dtype="float16")
+    C = te.extern(
+        (16, 8),
+        [A, B],
+        lambda ins, outs: _mma_m16n8k16(ins[0], ins[1], outs[0]),
+        name="mma",
+        dtype="float32",
+    )
+    s = te.create_schedule(C.op)
+    f = tvm.build(s, [A, B, C], "cuda")
+    assert "mma.sync.aligned.m16n8k16.row.col.f32.f16.f16.f32" in f.imported_modules[0].get_source()
+
+    dev = tvm.cuda(0)
+    a_np = np.random.uniform(-1, 1, size=(16, 16)).astype("float16")
+    b_np = np.random.uniform(-1, 1, size=(8, 16)).astype("float16")
+    a = tvm.nd.array(a_np, dev)
+    b = tvm.nd.array(b_np, dev)
+    c = tvm.nd.array(np.zeros((16, 8), dtype="float32"), dev)
+    f(a, b, c)
+    expected = np.dot(a_np.astype("float32"), b_np.astype("float32").T)
+    tvm.testing.assert_allclose(c.numpy(), expected, rtol=1e-3, atol=1e-3)
+
+
+if __name__ == "__main__":
+    test_mma_m16n8k16_f16_f32()
@@ -0,0 +1,126 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import pytest
+import tvm
+from tvm import tir
+from tvm.script import tir as T
+from tvm.tir.schedule.testing import verify_trace_roundtrip
+
+# fmt: off
+# pylint: disable=no-member,invalid-name,unused-variable,line-too-long,redefined-outer-name
+
+@T.prim_func
+def single_elementwise(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, (128, 128))
+    B = T.match_buffer(b, (128, 128))
+    for i_0, j_0, i_1, j_1 in T.grid(8, 8, 16, 16):
+        with T.block("B"):
+            vi = T.axis.spatial(128, i_0 * 16 + i_1)
+            vj = T.axis.spatial(128, j_0 * 16 + j_1)
+            B[vi, vj] = A[vi, vj] * T.float32(2)
+
+
+@T.prim_func
+def single_elementwise_blockized(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, (128, 128))
+    B = T.match_buffer(b, (128, 128))
+    for i_0, j_0 in T.grid(8, 8):
+        with T.block("B_o"):
+            vio, vjo = T.axis.remap("SS", [i_0, j_0])
+            T.reads(A[vio * 16 : vio * 16 + 16, vjo * 16 : vjo * 16 + 16])
+            T.writes(B[vio * 16 : vio * 16 + 16, vjo * 16 : vjo * 16 + 16])
+            for i_1, j_1 in T.grid(16, 16):
+                with T.block("B"):
+                    vi, vj = T.axis.remap("SS", [i_1, j_1])
+                    T.reads(A[vio * 16 + vi, vjo * 16 + vj])
+                    T.writes(B[vio * 16 + vi, vjo * 16 + vj])
+                    B[vio * 16 + vi, vjo * 16 + vj] = A[vio * 16 + vi, vjo * 16 + vj] * T.float32(2)
+
+
+@T.prim_func
+def two_elementwise(a: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (128, 128))
+    B = T.alloc_buffer((128, 128))
+    C = T.match_buffer(c, (128, 128))
+    for i, j in T.grid(128, 128):
+        with T.block("B"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            B[vi, vj] = A[vi, vj] * T.float32(2)
+        with T.block("C"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            C[vi, vj] = B[vi, vj] + T.float32(1)
+
+
+@T.prim_func
+def matmul(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (128, 128))
+    B = T.match_buffer(b, (128, 128))
+    C = T.match_buffer(c, (128, 128))
+    for i, j, k in T.grid(128, 128, 128):
+        with T.block("update"):
+            vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+            with T.init():
+                C[vi, vj] = T.float32(0)
+            C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vj, vk]
+
+
+# pylint: enable=no-member,invalid-name,unused-variable,line-too-long,redefined-outer-name
+# fmt: on
+
+
+def test_blockize():
+    sch = tir.Schedule(single_elementwise, debug_mask="all")
+    _, _, i_1, _ = sch.get_loops(sch.get_block("B"))
+    block = sch.blockize(i_1)
+    assert sch.get(block).name_hint == "B_o"
+    tvm.ir.assert_structural_equal(single_elementwise_blockized, sch.mod["main"])
+    verify_trace_roundtrip(sch=sch, mod=single_elementwise)
+
+
+def test_blockize_reduction_init():
+    sch = tir.Schedule(matmul, debug_mask="all")
+    i, j, k = sch.get_loops(sch.get_block("update"))
+    _, i_1 = sch.split(i, factors=[None, 16])
+    _, j_1 = sch.split(j, factors=[None, 16])
+    _, k_1 = sch.split(k, factors=[None, 16])
+    i_0, i_1, j_0, j_1, k_0, k_1 = sch.get_loops(sch.get_block("update"))
+    sch.reorder(i_0, j_0, k_0, i_1, j_1, k_1)
+    block = sch.blockize(i_1)
+    outer = sch.get(block)
+    # The init statement moves to the outer block, which reduces over the outer reduction loop
+    assert outer.init is not None
+    assert sch.get(sch.get_block("update")).init is None
+    assert [iter_var.iter_type for iter_var in outer.iter_vars] == [
+        tir.IterVar.DataPar,
+        tir.IterVar.DataPar,
+        tir.IterVar.CommReduce,
+    ]
+    verify_trace_roundtrip(sch=sch, mod=matmul)
+
+
+def test_blockize_fail_on_multiple_blocks():
+    sch = tir.Schedule(two_elementwise, debug_mask="all")
+    i, _ = sch.get_loops(sch.get_block("B"))
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.blockize(i)
+
+
+if __name__ == "__main__":
+    test_blockize()
+    test_blockize_reduction_init()
+    test_blockize_fail_on_multiple_blocks()
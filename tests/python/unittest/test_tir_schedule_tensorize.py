@@ -0,0 +1,170 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import pytest
+import tvm
+from tvm import tir
+from tvm.script import tir as T
+from tvm.tir.schedule.testing import verify_trace_roundtrip
+
+# fmt: off
+# pylint: disable=no-member,invalid-name,unused-variable,line-too-long,redefined-outer-name
+
+@T.prim_func
+def mma_desc(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (16, 16), align=128, offset_factor=1)
+    B = T.match_buffer(b, (16, 16), align=128, offset_factor=1)
+    C = T.match_buffer(c, (16, 16), align=128, offset_factor=1)
+
+    with T.block("root"):
+        T.reads(C[0 : 16, 0 : 16], A[0 : 16, 0 : 16], B[0 : 16, 0 : 16])
+        T.writes(C[0 : 16, 0 : 16])
+        for i, j, k in T.grid(16, 16, 16):
+            with T.block("update"):
+                vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vj, vk]
+
+
+@T.prim_func
+def mma_intrin(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (16, 16), align=128, offset_factor=1)
+    B = T.match_buffer(b, (16, 16), align=128, offset_factor=1)
+    C = T.match_buffer(c, (16, 16), align=128, offset_factor=1)
+
+    with T.block("root"):
+        T.reads(C[0 : 16, 0 : 16], A[0 : 16, 0 : 16], B[0 : 16, 0 : 16])
+        T.writes(C[0 : 16, 0 : 16])
+        T.evaluate(
+            T.tvm_mma_sync(
+                C.data,
+                C.elem_offset // 256,
+                A.data,
+                A.elem_offset // 256,
+                B.data,
+                B.elem_offset // 256,
+                C.data,
+                C.elem_offset // 256,
+                dtype="handle",
+            )
+        )
+
+
+@T.prim_func
+def dot_product_desc(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (4,), offset_factor=1)
+    B = T.match_buffer(b, (4,), offset_factor=1)
+    C = T.match_buffer(c, (1,), offset_factor=1)
+
+    with T.block("root"):
+        T.reads(C[0 : 1], A[0 : 4], B[0 : 4])
+        T.writes(C[0 : 1])
+        for i in T.serial(0, 4):
+            with T.block("update"):
+                vi = T.axis.reduce(4, i)
+                C[0] = C[0] + A[vi] * B[vi]
+
+
+@T.prim_func
+def matmul(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (128, 128))
+    B = T.match_buffer(b, (128, 128))
+    C = T.match_buffer(c, (128, 128))
+    for i, j, k in T.grid(128, 128, 128):
+        with T.block("update"):
+            vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+            with T.init():
+                C[vi, vj] = T.float32(0)
+            C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vj, vk]
+
+
+# pylint: enable=no-member,invalid-name,unused-variable,line-too-long,redefined-outer-name
+# fmt: on
+
+tir.TensorIntrin.register("test_mma_intrin", mma_desc, mma_intrin)
+tir.TensorIntrin.register("test_dot_product_intrin", dot_product_desc, mma_intrin)
+
+
+def _split_matmul(sch):
+    update = sch.get_block("update")
+    i, j, k = sch.get_loops(update)
+    i_0, i_1 = sch.split(i, factors=[None, 16])
+    j_0, j_1 = sch.split(j, factors=[None, 16])
+    k_0, k_1 = sch.split(k, factors=[None, 16])
+    sch.reorder(i_0, j_0, k_0, i_1, j_1, k_1)
+    sch.decompose_reduction(update, k_0)
+    return update, i_1
+
+
+def test_tensor_intrin_registry():
+    intrin = tir.TensorIntrin.get("test_mma_intrin")
+    tvm.ir.assert_structural_equal(intrin.desc, mma_desc)
+    tvm.ir.assert_structural_equal(intrin.impl, mma_intrin)
+    with pytest.raises(tvm.TVMError):
+        tir.TensorIntrin.get("test_unregistered_intrin")
+    with pytest.raises(tvm.TVMError):
+        tir.TensorIntrin.register("test_mma_intrin", mma_desc, mma_intrin)
+
+
+def test_tensorize_matmul():
+    sch = tir.Schedule(matmul, debug_mask="all")
+    update, i_1 = _split_matmul(sch)
+    sch.tensorize(i_1, "test_mma_intrin")
+    block = sch.get(sch.get_block("update_o"))
+    assert isinstance(block.body, tir.Evaluate)
+    assert block.body.value.op.same_as(tvm.ir.Op.get("tir.tvm_mma_sync"))
+    # The buffers of the implementation are bound to the 16x16 tiles of the block
+    assert [match.source.buffer.name for match in block.match_buffers] == ["C", "A", "B"]
+    for match in block.match_buffers:
+        assert [r.extent.value for r in match.source.region] == [16, 16]
+    verify_trace_roundtrip(sch=sch, mod=matmul)
+
+
+def test_tensorize_blockized():
+    sch = tir.Schedule(matmul, debug_mask="all")
+    update, i_1 = _split_matmul(sch)
+    block = sch.blockize(i_1)
+    sch.tensorize(block, "test_mma_intrin")
+    assert isinstance(sch.get(block).body, tir.Evaluate)
+    verify_trace_roundtrip(sch=sch, mod=matmul)
+
+
+def test_tensorize_mismatch():
+    sch = tir.Schedule(matmul, debug_mask="all")
+    update, i_1 = _split_matmul(sch)
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.tensorize(i_1, "test_dot_product_intrin")
+
+
+def test_tensorize_with_init():
+    sch = tir.Schedule(matmul, debug_mask="all")
+    update = sch.get_block("update")
+    i, j, k = sch.get_loops(update)
+    i_0, i_1 = sch.split(i, factors=[None, 16])
+    j_0, j_1 = sch.split(j, factors=[None, 16])
+    k_0, k_1 = sch.split(k, factors=[None, 16])
+    sch.reorder(i_0, j_0, k_0, i_1, j_1, k_1)
+    # The description has no init statement, so the reduction has to be decomposed first
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.tensorize(i_1, "test_mma_intrin")
+
+
+if __name__ == "__main__":
+    test_tensor_intrin_registry()
+    test_tensorize_matmul()
+    test_tensorize_blockized()
+    test_tensorize_mismatch()
+    test_tensorize_with_init()
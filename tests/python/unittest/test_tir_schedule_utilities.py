@@ -149,6 +149,26 @@ def test_tir_schedule_copy_2():
     verify_trace_roundtrip(sch_copy, mod=matmul)
 
 
+def test_tir_schedule_copy_3():
+    # Tests:
+    # - The copies of a schedule are independent, whichever side is modified first
+    sch = tir.Schedule(mod=matmul, debug_mask="all")
+    i, j, _ = sch.get_loops(sch.get_block("update"))
+    sch_1 = sch.copy()
+    sch_2 = sch.copy()
+    i_0, _ = sch_1.split(i, factors=[None, 64])
+    assert tvm.ir.structural_equal(sch.mod["main"], matmul)
+    assert tvm.ir.structural_equal(sch_2.mod["main"], matmul)
+    j_0, _ = sch.split(j, factors=[None, 32])
+    assert tvm.ir.structural_equal(sch_2.mod["main"], matmul)
+    assert sch_1.get(i_0).extent == 2
+    assert sch.get(j_0).extent == 4
+    assert sch_2.get(i).extent == 128
+    assert sch_2.get(j).extent == 128
+    verify_trace_roundtrip(sch_1, mod=matmul)
+    verify_trace_roundtrip(sch, mod=matmul)
+
+
 def test_tir_schedule_remove_rv():
     # Tests:
     # - Schedule.remove_rv
@@ -199,6 +199,19 @@ def test_buffer_load_store():
     assert not consistent_equal(sy, sz)
 
 
+def test_shared_subtree():
+    x = te.var("x")
+    y = te.var("y")
+    body = x * 2 + y * 3
+    arr = tvm.runtime.convert
+    # the skipped shared subtree still maps x and y to themselves
+    assert not consistent_equal(arr([body, x]), arr([body, y]), True)
+    assert not consistent_equal(arr([x, body]), arr([y, body]), True)
+    assert consistent_equal(arr([body, x]), arr([body, x]), True)
+    func = tvm.tir.PrimFunc([x, y], tvm.tir.Evaluate(body))
+    assert consistent_equal(arr([func, func.body]), arr([func, func.body]))
+
+
 if __name__ == "__main__":
     test_exprs()
     test_prim_func()
@@ -208,3 +221,4 @@ if __name__ == "__main__":
     test_stmt()
     test_buffer_storage_scope()
     test_buffer_load_store()
+    test_shared_subtree()
@@ -0,0 +1,85 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm.script import tir as T
+
+
+# fmt: off
+@T.prim_func
+def copy_a(a: T.handle, b: T.handle) -> None:
+    T.func_attr({"global_symbol": "copy_a", "tir.noalias": True})
+    A = T.match_buffer(a, [16], dtype="float32")
+    B = T.match_buffer(b, [16], dtype="float32")
+    for i in T.serial(0, 16):
+        T.store(B.data, i, T.load("float32", A.data, i), True)
+
+
+@T.prim_func
+def copy_b(x: T.handle, y: T.handle) -> None:
+    T.func_attr({"global_symbol": "copy_b", "tir.noalias": True})
+    X = T.match_buffer(x, [16], dtype="float32")
+    Y = T.match_buffer(y, [16], dtype="float32")
+    for j in T.serial(0, 16):
+        T.store(Y.data, j, T.load("float32", X.data, j), True)
+
+
+@T.prim_func
+def double(a: T.handle, b: T.handle) -> None:
+    T.func_attr({"global_symbol": "double", "tir.noalias": True})
+    A = T.match_buffer(a, [16], dtype="float32")
+    B = T.match_buffer(b, [16], dtype="float32")
+    for i in T.serial(0, 16):
+        T.store(B.data, i, T.load("float32", A.data, i) * T.float32(2), True)
+
+
+@T.prim_func
+def run(a: T.handle, b: T.handle) -> None:
+    T.func_attr({"global_symbol": "run", "runner_function": True})
+    A = T.match_buffer(a, [16], dtype="float32")
+    B = T.match_buffer(b, [16], dtype="float32")
+    T.evaluate(T.call_extern("copy_a", A.data, B.data, dtype="int32"))
+    T.evaluate(T.call_extern("copy_b", B.data, A.data, dtype="int32"))
+    T.evaluate(T.call_extern("double", A.data, B.data, dtype="int32"))
+# fmt: on
+
+
+def _callees(func):
+    names = []
+
+    def _visit(expr):
+        if isinstance(expr, tvm.tir.Call) and expr.op.same_as(tvm.ir.Op.get("tir.call_extern")):
+            names.append(expr.args[0].value)
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, _visit)
+    return names
+
+
+def test_deduplicate_functions():
+    mod = tvm.IRModule({"copy_a": copy_a, "copy_b": copy_b, "double": double, "run": run})
+    mod = tvm.tir.transform.DeduplicateFunctions()(mod)
+    assert sorted(gv.name_hint for gv in mod.get_global_vars()) == ["copy_a", "double", "run"]
+    assert _callees(mod["run"]) == ["copy_a", "copy_a", "double"]
+
+
+def test_deduplicate_functions_unchanged():
+    mod = tvm.IRModule({"copy_a": copy_a, "double": double, "run": run})
+    tvm.ir.assert_structural_equal(tvm.tir.transform.DeduplicateFunctions()(mod), mod)
+
+
+if __name__ == "__main__":
+    test_deduplicate_functions()
+    test_deduplicate_functions_unchanged()
@@ -0,0 +1,119 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def _prefetches(stmt):
+    calls = []
+
+    def visit(op):
+        if isinstance(op, tvm.tir.Call) and op.op.same_as(tvm.ir.Op.get("tir.prefetch")):
+            calls.append(op)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, visit)
+    return calls
+
+
+def _inject(stmt, args, **config):
+    mod = tvm.IRModule({"main": tvm.tir.PrimFunc(args, stmt)})
+    with tvm.transform.PassContext(config={"tir.InjectAutoPrefetch": config}):
+        return tvm.tir.transform.InjectAutoPrefetch()(mod)["main"].body
+
+
+def test_strided_access():
+    n = 256
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        with ib.for_range(0, n, name="j") as j:
+            # the column of A is read at a stride of n floats, the row of B densely
+            B[i * n + j] = A[j * n + i]
+    stmt = ib.get()
+    args = [A.asobject(), B.asobject()]
+
+    # disabled by default
+    assert not _prefetches(_inject(stmt, args))
+
+    body = _inject(stmt, args, distance_bytes=4096)
+    calls = _prefetches(body)
+    assert len(calls) == 1
+    load = calls[0].args[0].args[0]
+    assert load.buffer_var.same_as(args[0])
+    # 4096 bytes ahead over a stride of 1024 bytes is 4 iterations of j
+    inner = body.body
+    analyzer = tvm.arith.Analyzer()
+    expected = analyzer.simplify((inner.loop_var + 4) * n + body.loop_var)
+    tvm.ir.assert_structural_equal(analyzer.simplify(load.index), expected, True)
+
+
+def test_gather_access():
+    n, m, k = 64, 1000, 32
+    ib = tvm.tir.ir_builder.create()
+    T = ib.pointer("float32", name="T")
+    I = ib.pointer("int32", name="I")
+    O = ib.pointer("float32", name="O")
+    with ib.for_range(0, n, name="i") as i:
+        with ib.for_range(0, k, name="j") as j:
+            O[i * k + j] = T[I[i] * k + j]
+    stmt = ib.get()
+    body = _inject(stmt, [T.asobject(), I.asobject(), O.asobject()], distance_bytes=256)
+    # the row of the next indices is prefetched from the outer loop, guarded by its extent
+    assert isinstance(body.body[0], tvm.tir.IfThenElse)
+    calls = _prefetches(body)
+    assert len(calls) == 1
+    assert calls[0].args[0].args[0].buffer_var.same_as(T.asobject())
+
+
+def test_conditional_access_left_out():
+    n = 256
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    I = ib.pointer("int32", name="I")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, n, name="i") as i:
+        with ib.if_scope(i < 10):
+            B[i] = A[I[i] * 64]
+    stmt = ib.get()
+    body = _inject(stmt, [A.asobject(), I.asobject(), B.asobject()], distance_bytes=4096)
+    assert not _prefetches(body)
+
+
+@tvm.testing.requires_llvm
+def test_build_with_prefetch():
+    n = 512
+    A = te.placeholder((n, n), name="A")
+    B = te.compute((n, n), lambda i, j: A[j, i], name="B")
+    s = te.create_schedule(B.op)
+    with tvm.transform.PassContext(config={"tir.InjectAutoPrefetch": {"distance_bytes": 8192}}):
+        f = tvm.build(s, [A, B], "llvm")
+    dev = tvm.cpu()
+    a_np = np.random.uniform(size=(n, n)).astype("float32")
+    a = tvm.nd.array(a_np, dev)
+    b = tvm.nd.empty((n, n), "float32", dev)
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a_np.T)
+
+
+if __name__ == "__main__":
+    test_strided_access()
+    test_gather_access()
+    test_conditional_access_left_out()
+    test_build_with_prefetch()
@@ -0,0 +1,189 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+@T.prim_func
+def copy_then_add(a: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (16, 16), "float32")
+    C = T.match_buffer(c, (16, 16), "float32")
+    for tx in T.serial(0, 16):
+        for i in T.serial(0, 16):
+            with T.block():
+                T.reads(A[tx, i])
+                T.writes(C[tx, i])
+                B = T.alloc_buffer((16, 1), "float32", scope="global")
+                with T.block():
+                    T.reads(A[tx, i])
+                    T.writes(B[tx, 0])
+                    B[tx, 0] = A[tx, i]
+                with T.block():
+                    T.reads(B[tx, 0])
+                    T.writes(C[tx, i])
+                    C[tx, i] = B[tx, 0] + T.float32(1)
+
+
+@T.prim_func
+def shared_copy_then_add(a: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (16, 16), "float32")
+    C = T.match_buffer(c, (16, 16), "float32")
+    for tx in T.serial(0, 16):
+        for i in T.serial(0, 16):
+            with T.block():
+                T.reads(A[tx, i])
+                T.writes(C[tx, i])
+                B = T.alloc_buffer((16, 1), "float32", scope="shared")
+                with T.block():
+                    T.reads(A[tx, i])
+                    T.writes(B[tx, 0])
+                    B[tx, 0] = A[tx, i]
+                with T.block():
+                    T.reads(B[tx, 0])
+                    T.writes(C[tx, i])
+                    C[tx, i] = B[tx, 0] + T.float32(1)
+
+
+def _pipelined(func, annotations):
+    def annotate(loop):
+        if loop.loop_var.name != "i":
+            return None
+        return tvm.tir.For(
+            loop.loop_var, loop.min, loop.extent, loop.kind, loop.body, None, annotations
+        )
+
+    return func.with_body(tvm.tir.stmt_functor.ir_transform(func.body, None, annotate, ["tir.For"]))
+
+
+def _collect(stmt):
+    loops, allocs, calls, attrs = [], [], [], []
+
+    def visit(node):
+        if isinstance(node, tvm.tir.For):
+            loops.append(node)
+        elif isinstance(node, tvm.tir.Block):
+            allocs.extend(node.alloc_buffers)
+        elif isinstance(node, tvm.tir.Call) and isinstance(node.op, tvm.ir.Op):
+            calls.append(node)
+        elif isinstance(node, tvm.tir.AttrStmt):
+            attrs.append(node.attr_key)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, visit)
+    return loops, allocs, calls, attrs
+
+
+def test_pipeline_versions_buffers():
+    func = _pipelined(
+        copy_then_add, {"software_pipeline_stage": [0, 1], "software_pipeline_order": [0, 1]}
+    )
+    mod = tvm.tir.transform.InjectSoftwarePipeline()(tvm.IRModule.from_expr(func))
+    loops, allocs, _, _ = _collect(mod["main"].body)
+
+    pipelined = [loop for loop in loops if loop.loop_var.name == "i"]
+    assert [int(loop.extent) for loop in pipelined] == [1, 15, 1]
+    assert pipelined[0].kind == tvm.tir.ForKind.UNROLLED
+    assert pipelined[1].kind == tvm.tir.ForKind.SERIAL
+    assert "software_pipeline_stage" not in pipelined[1].annotations
+    assert [list(buf.shape) for buf in allocs] == [[2, 16, 1]]
+
+
+def test_pipeline_invalid_order():
+    func = _pipelined(
+        copy_then_add, {"software_pipeline_stage": [0, 1], "software_pipeline_order": [0, 0]}
+    )
+    try:
+        tvm.tir.transform.InjectSoftwarePipeline()(tvm.IRModule.from_expr(func))
+        assert False
+    except tvm.error.TVMError as e:
+        assert "must be a permutation" in str(e)
+
+
+@tvm.testing.requires_llvm
+def test_pipeline_build():
+    for order in [[0, 1], [1, 0]]:
+        func = _pipelined(
+            copy_then_add, {"software_pipeline_stage": [0, 1], "software_pipeline_order": order}
+        )
+        f = tvm.build(func, target="llvm")
+        a = tvm.nd.array(np.random.uniform(size=(16, 16)).astype("float32"))
+        c = tvm.nd.array(np.zeros((16, 16), dtype="float32"))
+        f(a, c)
+        tvm.testing.assert_allclose(c.numpy(), a.numpy() + 1)
+
+
+def test_pipeline_async_stage():
+    func = _pipelined(
+        shared_copy_then_add,
+        {
+            "software_pipeline_stage": [0, 1],
+            "software_pipeline_order": [0, 1],
+            "software_pipeline_async_stages": [0],
+        },
+    )
+    mod = tvm.tir.transform.InjectSoftwarePipeline()(tvm.IRModule.from_expr(func))
+    _, _, calls, attrs = _collect(mod["main"].body)
+    names = [call.op.name for call in calls]
+    # one group committed in each of the three loops
+    assert names.count("tir.ptx_commit_group") == 3
+    waits = [call for call in calls if call.op.name == "tir.ptx_wait_group"]
+    assert all(int(call.args[0]) == 1 for call in waits)
+    assert "async_scope" in attrs
+
+    mod = tvm.lower(func)
+    _, _, calls, attrs = _collect(mod["main"].body)
+    assert "tir.ptx_cp_async" in [call.op.name for call in calls]
+    assert "async_scope" not in attrs
+
+
+@tvm.testing.requires_llvm
+def test_pipeline_async_dma_stage():
+    func = _pipelined(
+        copy_then_add,
+        {
+            "software_pipeline_stage": [0, 1],
+            "software_pipeline_order": [0, 1],
+            "software_pipeline_async_stages": [0],
+        },
+    )
+    mod = tvm.tir.transform.InjectSoftwarePipeline()(tvm.IRModule.from_expr(func))
+    _, _, calls, _ = _collect(mod["main"].body)
+    names = [call.op.name for call in calls]
+    assert names.count("tir.dma_commit_group") == 3
+    assert "tir.ptx_commit_group" not in names
+
+    mod = tvm.lower(func)
+    _, _, calls, _ = _collect(mod["main"].body)
+    names = [call.op.name for call in calls]
+    assert "tir.dma_copy" in names
+    assert "tir.dma_wait_group" in names
+
+    f = tvm.build(func, target="llvm")
+    a = tvm.nd.array(np.random.uniform(size=(16, 16)).astype("float32"))
+    c = tvm.nd.array(np.zeros((16, 16), dtype="float32"))
+    f(a, c)
+    tvm.testing.assert_allclose(c.numpy(), a.numpy() + 1)
+
+
+if __name__ == "__main__":
+    test_pipeline_versions_buffers()
+    test_pipeline_invalid_order()
+    test_pipeline_build()
+    test_pipeline_async_stage()
+    test_pipeline_async_dma_stage()
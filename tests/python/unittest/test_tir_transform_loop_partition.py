@@ -565,6 +565,59 @@ def test_explicit_partition_hint():
     assert tvm.ir.structural_equal(mod["main"], partitioned_concat)
 
 
+def _partition_vectorized_tail(n, factor=16):
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2.0, name="B")
+    s = te.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=factor)
+    s[B].vectorize(xi)
+    mod = tvm.driver.build_module.schedule_to_module(s, [A, B], "main", None)
+    with tvm.transform.PassContext(
+        config={"tir.LoopPartition": {"partition_vectorized_tail": True}}
+    ):
+        mod = tvm.tir.transform.StorageFlatten(64)(mod)
+        mod = tvm.tir.transform.LoopPartition()(mod)
+        mod = tvm.tir.transform.Simplify()(mod)
+    loops = collect_visit(mod["main"].body, lambda x: x if isinstance(x, tvm.tir.For) else None)
+    vectorized = [x for x in loops if x is not None and x.kind == tvm.tir.ForKind.VECTORIZED]
+    return mod["main"], vectorized
+
+
+def test_partition_vectorized_tail_const():
+    func, vectorized = _partition_vectorized_tail(1000)
+    # a full width main body and a tail of 8 lanes, without bound checks
+    assert sorted(x.extent.value for x in vectorized) == [8, 16]
+    assert not any(collect_visit(func.body, lambda x: isinstance(x, tvm.tir.IfThenElse)))
+
+
+def test_partition_vectorized_tail_symbolic():
+    n = te.size_var("n")
+    func, vectorized = _partition_vectorized_tail(n)
+    # the remainder is not constant, so the tail is not vectorized
+    assert all(isinstance(x.extent, tvm.tir.IntImm) for x in vectorized)
+    assert any(
+        not any(collect_visit(x, lambda y: isinstance(y, tvm.tir.IfThenElse))) for x in vectorized
+    )
+
+
+@tvm.testing.requires_llvm
+def test_partition_vectorized_tail_build():
+    for n in [1000, 1001, 1024]:
+        A = te.placeholder((n,), name="A")
+        B = te.compute((n,), lambda i: A[i] * 2.0, name="B")
+        s = te.create_schedule(B.op)
+        _, xi = s[B].split(B.op.axis[0], factor=16)
+        s[B].vectorize(xi)
+        with tvm.transform.PassContext(
+            config={"tir.LoopPartition": {"partition_vectorized_tail": True}}
+        ):
+            f = tvm.build(s, [A, B], "llvm")
+        a = tvm.nd.array(numpy.random.uniform(size=n).astype(A.dtype))
+        b = tvm.nd.empty((n,), B.dtype)
+        f(a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() * 2.0)
+
+
 if __name__ == "__main__":
     test_basic()
     test_const_loop()
@@ -587,3 +640,6 @@ if __name__ == "__main__":
     test_multilevel_splitting_with_indivisble_factors()
     test_simple_rfactor()
     test_explicit_partition_hint()
+    test_partition_vectorized_tail_const()
+    test_partition_vectorized_tail_symbolic()
+    test_partition_vectorized_tail_build()
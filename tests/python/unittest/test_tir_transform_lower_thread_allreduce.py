@@ -0,0 +1,105 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def _lower_allreduce(n, target, groups=1):
+    A = te.placeholder((groups, n), name="A")
+    k = te.reduce_axis((0, n), name="k")
+    B = te.compute((groups,), lambda i: te.sum(A[i, k], axis=k), name="B")
+    s = te.create_schedule(B.op)
+    s[B].bind(B.op.reduce_axis[0], te.thread_axis("threadIdx.x"))
+    s[B].bind(B.op.axis[0], te.thread_axis("threadIdx.y"))
+    mod = tvm.lower(s, [A, B], name="main")
+    target = tvm.target.Target(target)
+    mod = tvm.tir.transform.Apply(lambda f: f.with_attr("target", target))(mod)
+    return tvm.tir.transform.LowerThreadAllreduce()(mod)["main"]
+
+
+def _collect(func):
+    calls = []
+    scopes = {}
+
+    def fvisit(node):
+        if isinstance(node, tvm.tir.Call) and isinstance(node.op, tvm.ir.Op):
+            calls.append(node.op.name)
+        if isinstance(node, tvm.tir.Allocate):
+            scopes[node.buffer_var.name] = node.buffer_var.type_annotation.storage_scope
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return calls, scopes
+
+
+def test_cuda_single_warp():
+    calls, scopes = _lower_allreduce(32, "cuda")
+    assert calls.count("tir.tvm_warp_shuffle_down") == 5
+    assert calls.count("tir.tvm_warp_shuffle") == 1
+    assert scopes["red_buf0"] == "local"
+    assert "red_buf_staging0" not in scopes
+
+
+def test_cuda_multi_warp():
+    calls, scopes = _lower_allreduce(256, "cuda", groups=2)
+    # 5 steps within each warp, 3 steps over the 8 warp results, then the broadcast
+    assert calls.count("tir.tvm_warp_shuffle_down") == 8
+    assert calls.count("tir.tvm_warp_shuffle") == 1
+    assert scopes["red_buf0"] == "local"
+    assert scopes["red_buf_staging0"] == "shared"
+
+
+def test_cuda_shared_memory_fallback():
+    # the 48 warp results do not fit in a warp
+    calls, scopes = _lower_allreduce(32 * 48, "cuda")
+    assert "tir.tvm_warp_shuffle_down" not in calls
+    assert scopes["red_buf0"] == "shared"
+
+
+def test_metal_butterfly():
+    calls, scopes = _lower_allreduce(128, "metal")
+    # warps of 16 threads, 4 steps within each warp and 4 more over the warp results
+    assert calls.count("tir.tvm_warp_shuffle_xor") == 8
+    assert "tir.tvm_warp_shuffle" not in calls
+    assert "tir.tvm_warp_shuffle_down" not in calls
+    assert scopes["red_buf_staging0"] == "shared"
+
+
+def test_vulkan_subgroup_shuffle():
+    target = {
+        "kind": "vulkan",
+        "thread_warp_size": 32,
+        "vulkan_api_version": (1 << 22) | (1 << 12),
+        "supported_subgroup_operations": 0x1F,
+    }
+    calls, scopes = _lower_allreduce(32, target)
+    assert calls.count("tir.tvm_warp_shuffle_xor") == 5
+    assert scopes["red_buf0"] == "local"
+
+    # without the subgroup shuffles the reduction goes through shared memory
+    target["supported_subgroup_operations"] = 0x1
+    calls, scopes = _lower_allreduce(32, target)
+    assert "tir.tvm_warp_shuffle_xor" not in calls
+    assert scopes["red_buf0"] == "shared"
+
+
+if __name__ == "__main__":
+    test_cuda_single_warp()
+    test_cuda_multi_warp()
+    test_cuda_shared_memory_fallback()
+    test_metal_butterfly()
+    test_vulkan_subgroup_shuffle()
@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import numpy as np
+
 import tvm
 from tvm import te
 from tvm.driver.build_module import schedule_to_module
@@ -144,5 +146,44 @@ def test_device_api_context_implicit_resource_handle():
     assert call_extern.args[2] == device_context_in_resource_handle
 
 
+def _count_asserts(func):
+    num_asserts = [0]
+
+    def visit(node):
+        if isinstance(node, tvm.tir.AssertStmt):
+            num_asserts[0] += 1
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, visit)
+    return num_asserts[0]
+
+
+def test_skip_arg_checks():
+    n = te.size_var("n")
+    A = te.placeholder((n,), name="A")
+    B = te.compute(A.shape, lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+
+    mod = schedule_to_module(s, [A, B])
+    mod = tvm.tir.transform.StorageFlatten(64)(mod)
+    mod = tvm.tir.transform.Apply(
+        lambda f: f.with_attr({"target": tvm.target.Target("llvm"), "global_symbol": "main"})
+    )(mod)
+
+    assert _count_asserts(tvm.tir.transform.MakePackedAPI()(mod)["main"]) > 0
+    with tvm.transform.PassContext(config={"tir.skip_arg_checks": True}):
+        func = tvm.tir.transform.MakePackedAPI()(mod)["main"]
+    assert _count_asserts(func) == 0
+    # n is still bound from the shape of A.
+    assert _find_assignment(func.body, "n").var.name == "n"
+
+    with tvm.transform.PassContext(config={"tir.skip_arg_checks": True}):
+        f = tvm.build(s, [A, B], "llvm")
+    a = tvm.nd.array(np.full((7,), 2, "float32"))
+    b = tvm.nd.empty((7,), "float32")
+    f(a, b)
+    np.testing.assert_equal(b.numpy(), np.full((7,), 3, "float32"))
+
+
 if __name__ == "__main__":
     test_makeapi()
+    test_skip_arg_checks()
@@ -63,6 +63,25 @@ def test_cow_pass():
     assert func_hash == mod["main"].__hash__()
 
 
+def test_parallel_prim_func_pass():
+    funcs = {}
+    for i in range(8):
+        x = te.var("x")
+        n = te.var("n")
+        body = tvm.tir.Evaluate(tvm.tir.floordiv(x * 4 + i, 4) + (n - n))
+        funcs["func%d" % i] = tvm.tir.PrimFunc([x, n], body)
+    passes = tvm.transform.Sequential(
+        [tvm.tir.transform.Simplify(), tvm.tir.transform.RemoveNoOp()]
+    )
+    expected = passes(tvm.IRModule(funcs))
+    with tvm.transform.PassContext(config={"tir.lower_num_threads": 4}):
+        mod = passes(tvm.IRModule(funcs))
+    assert len(mod.functions) == len(funcs)
+    for name in funcs:
+        tvm.ir.assert_structural_equal(mod[name], expected[name])
+
+
 if __name__ == "__main__":
     test_cow_pass()
     test_prim_func_pass()
+    test_parallel_prim_func_pass()
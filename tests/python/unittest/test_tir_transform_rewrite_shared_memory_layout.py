@@ -0,0 +1,114 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm.script import tir as T
+
+
+@T.prim_func
+def transpose(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, (32, 32), "float32")
+    B = T.match_buffer(b, (32, 32), "float32")
+    with T.block():
+        T.reads(A[0:32, 0:32])
+        T.writes(B[0:32, 0:32])
+        S = T.alloc_buffer((32, 32), "float32", scope="shared")
+        for ty in T.thread_binding(0, 32, thread="threadIdx.y"):
+            for tx in T.thread_binding(0, 32, thread="threadIdx.x"):
+                with T.block():
+                    T.reads(A[ty, tx])
+                    T.writes(S[ty, tx])
+                    S[ty, tx] = A[ty, tx]
+        for ty in T.thread_binding(0, 32, thread="threadIdx.y"):
+            for tx in T.thread_binding(0, 32, thread="threadIdx.x"):
+                with T.block():
+                    T.reads(S[tx, ty])
+                    T.writes(B[ty, tx])
+                    B[ty, tx] = S[tx, ty]
+
+
+@T.prim_func
+def vector_rows(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, (32, 4), "float32")
+    B = T.match_buffer(b, (32, 4), "float32")
+    with T.block():
+        T.reads(A[0:32, 0:4])
+        T.writes(B[0:32, 0:4])
+        S = T.alloc_buffer((32, 32), "float32", scope="shared")
+        for tx in T.thread_binding(0, 32, thread="threadIdx.x"):
+            for v in T.vectorized(0, 4):
+                with T.block():
+                    T.reads(A[tx, v])
+                    T.writes(S[tx, v])
+                    S[tx, v] = A[tx, v]
+        for tx in T.thread_binding(0, 32, thread="threadIdx.x"):
+            for v in T.vectorized(0, 4):
+                with T.block():
+                    T.reads(S[tx, v])
+                    T.writes(B[tx, v])
+                    B[tx, v] = S[tx, v]
+
+
+def _shared_accesses(func):
+    mod = tvm.tir.transform.RewriteSharedMemoryLayout()(tvm.IRModule.from_expr(func))
+    allocs, indices = [], []
+
+    def visit(node):
+        if isinstance(node, tvm.tir.Block):
+            allocs.extend(node.alloc_buffers)
+        elif isinstance(node, (tvm.tir.BufferLoad, tvm.tir.BufferStore)):
+            if node.buffer.scope() == "shared":
+                indices.append(node.indices)
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, visit)
+    return allocs, indices
+
+
+def _bank_conflicts(func):
+    mod = tvm.IRModule.from_expr(func)
+    mod = tvm.tir.transform.FlattenBuffer()(mod)
+    return tvm.tir.analysis.verify_gpu_code(mod["main"], {"max_shared_memory_bank_conflicts": 1})
+
+
+def test_swizzle_scalar_accesses():
+    allocs, indices = _shared_accesses(transpose)
+    assert [list(buf.strides) for buf in allocs] == [[]]
+    for index in indices:
+        assert isinstance(index[1], tvm.tir.Call) and index[1].op.name == "tir.bitwise_xor"
+
+    mod = tvm.tir.transform.RewriteSharedMemoryLayout()(tvm.IRModule.from_expr(transpose))
+    assert not _bank_conflicts(transpose)
+    assert _bank_conflicts(mod["main"])
+
+
+def test_pad_vector_accesses():
+    allocs, indices = _shared_accesses(vector_rows)
+    # the rows stay aligned to the 16 byte accesses
+    assert [[int(stride) for stride in buf.strides] for buf in allocs] == [[36, 1]]
+    assert all(isinstance(index[1], tvm.tir.Var) for index in indices)
+
+
+def test_rewrite_idempotent():
+    rewrite = tvm.tir.transform.RewriteSharedMemoryLayout()
+    for func in [transpose, vector_rows]:
+        once = rewrite(tvm.IRModule.from_expr(func))
+        tvm.ir.assert_structural_equal(rewrite(once), once)
+
+
+if __name__ == "__main__":
+    test_swizzle_scalar_accesses()
+    test_pad_vector_accesses()
+    test_rewrite_idempotent()
@@ -14,7 +14,10 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import numpy as np
+
 import tvm
+import tvm.testing
 from tvm import te
 
 
@@ -205,6 +208,87 @@ def test_vectorize_while_fail():
         assert expected in error_msg
 
 
+def _vectorize_predicated(stmt, params):
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc(params, stmt))
+    with tvm.transform.PassContext(config={"tir.vectorize_predicated": True}):
+        return tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+
+def test_vectorize_predicated_if():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 8, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            A[i] = B[i] + 1
+        with ib.else_scope():
+            A[i] = 0.0
+    stmt = _vectorize_predicated(ib.get(), [A, B, n])
+
+    assert isinstance(stmt, tvm.tir.SeqStmt)
+    then_case, else_case = stmt
+    assert isinstance(then_case, tvm.tir.Store)
+    assert then_case.value.dtype == "float32x8"
+    assert then_case.predicate.dtype == "boolx8"
+    assert then_case.value.a.predicate.dtype == "boolx8"
+    assert isinstance(else_case, tvm.tir.Store)
+    assert else_case.predicate.dtype == "boolx8"
+
+
+def test_vectorize_predicated_fallback():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            # a strided store cannot be predicated
+            A[i * 2] = 1.0
+    stmt = _vectorize_predicated(ib.get(), [A, n])
+    assert isinstance(stmt, tvm.tir.For)
+
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        A[i] = tvm.tir.call_intrin("float32", "tir.if_then_else", i < n, A[i * 2], 0)
+    stmt = _vectorize_predicated(ib.get(), [A, n])
+    assert isinstance(stmt, tvm.tir.For)
+
+
+def test_vectorize_predicated_if_then_else():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        A[i] = tvm.tir.call_intrin("float32", "tir.if_then_else", i < n, B[i], 0)
+    stmt = _vectorize_predicated(ib.get(), [A, B, n])
+
+    assert isinstance(stmt, tvm.tir.Store)
+    assert isinstance(stmt.value, tvm.tir.Select)
+    assert stmt.value.true_value.predicate.dtype == "boolx4"
+    assert isinstance(stmt.predicate, tvm.tir.Broadcast)
+
+
+@tvm.testing.requires_llvm
+def test_vectorize_predicated_build():
+    n = 20
+    A = te.placeholder((n,), name="A")
+    # the padding reads A out of bounds in the lanes it masks
+    B = te.compute(
+        (n + 2,), lambda i: tvm.tir.if_then_else(tvm.tir.all(i >= 1, i <= n), A[i - 1], 0.0)
+    )
+    s = te.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=8)
+    s[B].vectorize(xi)
+    with tvm.transform.PassContext(config={"tir.vectorize_predicated": True}):
+        f = tvm.build(s, [A, B], "llvm")
+    a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype))
+    b = tvm.nd.array(np.zeros(n + 2, dtype=B.dtype))
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), np.pad(a.numpy(), 1))
+
+
 if __name__ == "__main__":
     test_vectorize_vector()
     test_vectorize_with_if()
@@ -214,3 +298,7 @@ if __name__ == "__main__":
     test_vectorize_with_ge_cond()
     test_vectorize_let()
     test_vectorize_while_fail()
+    test_vectorize_predicated_if()
+    test_vectorize_predicated_fallback()
+    test_vectorize_predicated_if_then_else()
+    test_vectorize_predicated_build()
@@ -0,0 +1,113 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def _copy_kernel(dtype, extent, offset=0, thread=True):
+    n = 1024
+    A = tvm.tir.decl_buffer((n + offset,), dtype, name="A")
+    B = tvm.tir.decl_buffer((n,), dtype, name="B")
+    ib = tvm.tir.ir_builder.create()
+    a = ib.buffer_ptr(A)
+    b = ib.buffer_ptr(B)
+    tx = te.thread_axis("threadIdx.x")
+    if thread:
+        ib.scope_attr(tx, "thread_extent", n // extent)
+    with ib.for_range(0, extent, name="i") as i:
+        b[tx * extent + i] = a[tx * extent + i + offset] + tvm.tir.const(1, dtype)
+    return tvm.tir.PrimFunc([A, B], ib.get())
+
+
+def _loops(func):
+    mod = tvm.tir.transform.WidenMemoryAccess()(tvm.IRModule.from_expr(func))
+    loops = []
+    tvm.tir.stmt_functor.post_order_visit(
+        mod["main"].body,
+        lambda n: loops.append((n.kind, int(n.extent))) if isinstance(n, tvm.tir.For) else None,
+    )
+    return loops
+
+
+def test_widen_half():
+    assert _loops(_copy_kernel("float16", 8)) == [(tvm.tir.ForKind.VECTORIZED, 8)]
+
+
+def test_widen_float():
+    # the 16 byte vectors of float32 leave an outer loop of two vectors
+    assert _loops(_copy_kernel("float32", 8)) == [
+        (tvm.tir.ForKind.VECTORIZED, 4),
+        (tvm.tir.ForKind.SERIAL, 2),
+    ]
+
+
+def test_widen_narrower_when_misaligned():
+    # the accesses are only 8 byte aligned
+    assert _loops(_copy_kernel("float16", 8, offset=4)) == [
+        (tvm.tir.ForKind.VECTORIZED, 4),
+        (tvm.tir.ForKind.SERIAL, 2),
+    ]
+    assert _loops(_copy_kernel("float16", 8, offset=1)) == [(tvm.tir.ForKind.SERIAL, 8)]
+
+
+def test_skip_host_loop():
+    assert _loops(_copy_kernel("float16", 8, thread=False)) == [(tvm.tir.ForKind.SERIAL, 8)]
+
+
+def test_skip_reduction():
+    A = tvm.tir.decl_buffer((1024,), "float32", name="A")
+    B = tvm.tir.decl_buffer((128,), "float32", name="B")
+    ib = tvm.tir.ir_builder.create()
+    a = ib.buffer_ptr(A)
+    b = ib.buffer_ptr(B)
+    tx = te.thread_axis("threadIdx.x")
+    ib.scope_attr(tx, "thread_extent", 128)
+    with ib.for_range(0, 8, name="i") as i:
+        b[tx] = b[tx] + a[tx * 8 + i]
+    func = tvm.tir.PrimFunc([A, B], ib.get())
+    assert _loops(func) == [(tvm.tir.ForKind.SERIAL, 8)]
+
+
+@tvm.testing.requires_cuda
+def test_widen_build():
+    n = 1024
+    A = te.placeholder((n,), name="A", dtype="float16")
+    B = te.compute((n,), lambda i: A[i] + tvm.tir.const(1, "float16"), name="B")
+    s = te.create_schedule(B.op)
+    xo, xi = s[B].split(B.op.axis[0], factor=8)
+    s[B].bind(xo, te.thread_axis("threadIdx.x"))
+    with tvm.transform.PassContext(config={"tir.widen_memory_access": True}):
+        f = tvm.build(s, [A, B], "cuda")
+    assert "uint4" in f.imported_modules[0].get_source()
+
+    dev = tvm.cuda(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype("float16"), dev)
+    b = tvm.nd.array(np.zeros(n, dtype="float16"), dev)
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+
+
+if __name__ == "__main__":
+    test_widen_half()
+    test_widen_float()
+    test_widen_narrower_when_misaligned()
+    test_skip_host_loop()
+    test_skip_reduction()
+    test_widen_build()
@@ -160,7 +160,12 @@ def test_name_based_ordering(algorithm):
 
 @pytest.mark.parametrize(
     ["algorithm", "workspace_size"],
-    [("greedy_by_size", 140), ("greedy_by_conflicts", 140)],
+    [
+        ("greedy_by_size", 140),
+        ("greedy_by_conflicts", 140),
+        ("hill_climb", 140),
+        ("branch_and_bound", 140),
+    ],
 )
 def test_linear(algorithm, workspace_size):
     """
@@ -222,7 +227,14 @@ def test_linear(algorithm, workspace_size):
 
 @pytest.mark.parametrize(
     ["algorithm", "workspace_size"],
-    [("greedy_by_size", 190), ("greedy_by_conflicts", 320)],
+    # The search based algorithms treat the conflicts as symmetric, thus bi_b conflicts
+    # with bi_d for them and the plan can not be smaller than bi_b, bi_c, bi_d and bi_e.
+    [
+        ("greedy_by_size", 190),
+        ("greedy_by_conflicts", 320),
+        ("hill_climb", 210),
+        ("branch_and_bound", 210),
+    ],
 )
 def test_fanout(algorithm, workspace_size):
     """
@@ -291,6 +303,131 @@ def test_fanout(algorithm, workspace_size):
     _check_max_workspace_size(buffer_pool_allocations, global_workspace_pool, workspace_size)
 
 
+def _check_no_overlap(buffer_pool_allocations):
+    for buffer_info, pool_allocation in buffer_pool_allocations.items():
+        for conflict in buffer_info.conflicts:
+            conflict_allocation = buffer_pool_allocations[conflict]
+            if conflict_allocation.pool_info != pool_allocation.pool_info:
+                continue
+            start = pool_allocation.byte_offset
+            conflict_start = conflict_allocation.byte_offset
+            assert (
+                start + buffer_info.size_bytes <= conflict_start
+                or conflict_start + conflict.size_bytes <= start
+            )
+
+
+@pytest.mark.parametrize("algorithm", ["hill_climb", "branch_and_bound"])
+def test_search_based_algorithms(algorithm):
+    """The search based algorithms are never worse than greedy and respect the bounds"""
+    target = Target("c")
+    global_workspace_pool = usmp_utils.PoolInfo(
+        pool_name="global_workspace",
+        target_access={target: usmp_utils.PoolInfo.READ_WRITE_ACCESS},
+    )
+    sizes = [30, 70, 10, 60, 40, 20, 50, 80]
+    buffer_info_arr = [
+        usmp_utils.BufferInfo(
+            name_hint=f"bi_{i}", size_bytes=size, pool_candidates=[global_workspace_pool]
+        )
+        for i, size in enumerate(sizes)
+    ]
+    # Each buffer is live with the three following ones.
+    for i, buffer_info in enumerate(buffer_info_arr):
+        conflicts = [buffer_info_arr[j] for j in range(len(sizes)) if j != i and abs(i - j) <= 3]
+        buffer_info.set_conflicts(conflicts)
+
+    lower_bound = tvm.tir.usmp._ffi_api.CalculatePoolSizeLowerBound(buffer_info_arr, 0)
+    assert lower_bound == 130
+    # The memory pressure, when larger, is the lower bound.
+    assert tvm.tir.usmp._ffi_api.CalculatePoolSizeLowerBound(buffer_info_arr, 1000) == 1000
+
+    fgreedy = tvm.get_global_func("tir.usmp.algo.greedy_by_size")
+    greedy_size = tvm.tir.usmp._ffi_api.CalculateTotalPoolSize(fgreedy(buffer_info_arr, 0))
+    fusmp_algo = tvm.get_global_func(f"tir.usmp.algo.{algorithm}")
+    buffer_pool_allocations = fusmp_algo(buffer_info_arr, 0)
+    _check_no_overlap(buffer_pool_allocations)
+    total_size = tvm.tir.usmp._ffi_api.CalculateTotalPoolSize(buffer_pool_allocations)
+    assert lower_bound <= total_size <= greedy_size
+    # bi_4 to bi_7 are live together, no plan is smaller.
+    assert total_size == 190
+
+    # The result does not change from one run to the other.
+    assert (
+        tvm.tir.usmp._ffi_api.CalculateTotalPoolSize(fusmp_algo(buffer_info_arr, 0)) == total_size
+    )
+
+
+def test_branch_and_bound_time_budget():
+    """Without time to search, branch_and_bound returns the hill_climb plan"""
+    target = Target("c")
+    global_workspace_pool = usmp_utils.PoolInfo(
+        pool_name="global_workspace",
+        target_access={target: usmp_utils.PoolInfo.READ_WRITE_ACCESS},
+    )
+    buffer_info_arr = [
+        usmp_utils.BufferInfo(
+            name_hint=f"bi_{i}",
+            size_bytes=10 * (i % 5 + 1),
+            pool_candidates=[global_workspace_pool],
+        )
+        for i in range(12)
+    ]
+    for i, buffer_info in enumerate(buffer_info_arr):
+        buffer_info.set_conflicts([buffer_info_arr[(i + 1) % 12], buffer_info_arr[(i + 5) % 12]])
+
+    fhill_climb = tvm.get_global_func("tir.usmp.algo.hill_climb")
+    fbranch_and_bound = tvm.get_global_func("tir.usmp.algo.branch_and_bound")
+    hill_climb_size = tvm.tir.usmp._ffi_api.CalculateTotalPoolSize(fhill_climb(buffer_info_arr, 0))
+    buffer_pool_allocations = fbranch_and_bound(buffer_info_arr, 0, 0)
+    _check_no_overlap(buffer_pool_allocations)
+    assert tvm.tir.usmp._ffi_api.CalculateTotalPoolSize(buffer_pool_allocations) <= hill_climb_size
+
+
+def _create_chain(prefix, sizes, pool_info):
+    """helper to create BufferInfo objects live two by two in sequence"""
+    buffer_info_arr = [
+        usmp_utils.BufferInfo(
+            name_hint=f"{prefix}_{i}", size_bytes=size, pool_candidates=[pool_info]
+        )
+        for i, size in enumerate(sizes)
+    ]
+    for i, buffer_info in enumerate(buffer_info_arr):
+        buffer_info.set_conflicts(
+            [buffer_info_arr[j] for j in (i - 1, i + 1) if 0 <= j < len(sizes)]
+        )
+    return buffer_info_arr
+
+
+def test_shared_pools():
+    """Modules that never run concurrently only need the largest of their plans"""
+    target = Target("c")
+    sram_pool = usmp_utils.PoolInfo(
+        pool_name="sram",
+        target_access={target: usmp_utils.PoolInfo.READ_WRITE_ACCESS},
+        size_hint_bytes=160,
+    )
+    model_a = _create_chain("a", [10, 20, 100, 40, 50, 50], sram_pool)
+    model_b = _create_chain("b", [30, 90, 60], sram_pool)
+
+    module_pool_allocations = tvm.tir.usmp._ffi_api.PlanSharedPools(
+        [model_a, model_b], [0, 0], "greedy_by_size"
+    )
+    assert len(module_pool_allocations) == 2
+    _check_max_workspace_size(module_pool_allocations[0], sram_pool, 140)
+    _check_max_workspace_size(module_pool_allocations[1], sram_pool, 150)
+    # The plans both start at the beginning of the pool, they alias each other.
+    assert min(alloc.byte_offset for alloc in module_pool_allocations[1].values()) == 0
+
+    shared_sizes = tvm.tir.usmp._ffi_api.CalculateSharedPoolSizes(module_pool_allocations)
+    assert shared_sizes[sram_pool] == 150
+
+    # A liveness conflict across the modules means they run concurrently.
+    model_b[0].set_conflicts([model_b[1], model_a[0]])
+    with pytest.raises(tvm.TVMError, match="of another module"):
+        tvm.tir.usmp._ffi_api.PlanSharedPools([model_a, model_b], [0, 0], "greedy_by_size")
+
+
 # fmt: off
 @tvm.script.ir_module
 class MobilenetStructure:
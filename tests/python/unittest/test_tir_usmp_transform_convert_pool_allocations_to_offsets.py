@@ -0,0 +1,151 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import sys
+
+import pytest
+
+import tvm
+from tvm.script import tir as T
+from tvm.tir import stmt_functor
+from tvm.tir.usmp import utils as usmp_utils
+from tvm.target import Target
+
+
+def _assign_poolinfos_to_allocates_in_primfunc(primfunc, pool_infos):
+    """helper to assing poolinfos to allocate nodes in a tir.PrimFunc"""
+
+    def set_poolinfos(stmt):
+        if isinstance(stmt, tvm.tir.Allocate):
+            return tvm.tir.Allocate(
+                buffer_var=stmt.buffer_var,
+                dtype=stmt.dtype,
+                extents=stmt.extents,
+                condition=stmt.condition,
+                body=stmt.body,
+                annotations={tvm.tir.usmp.utils.CANDIDATE_MEMORY_POOL_ATTR: pool_infos},
+            )
+
+    return primfunc.with_body(stmt_functor.ir_transform(primfunc.body, None, set_poolinfos))
+
+
+def _assign_poolinfos_to_allocates_in_irmodule(mod, pool_infos, target):
+    """helper to assign poolinfos and the target to the PrimFuncs of an IRModule"""
+    ret = tvm.IRModule()
+    for global_var, basefunc in mod.functions.items():
+        if isinstance(basefunc, tvm.tir.PrimFunc):
+            func = _assign_poolinfos_to_allocates_in_primfunc(basefunc, pool_infos)
+            ret[global_var] = func.with_attr("target", target)
+    return ret
+
+
+def _count_allocates(primfunc):
+    allocates = []
+    stmt_functor.post_order_visit(
+        primfunc.body,
+        lambda stmt: allocates.append(stmt) if isinstance(stmt, tvm.tir.Allocate) else None,
+    )
+    return len(allocates)
+
+
+def _extern_calls(primfunc):
+    calls = {}
+
+    def visit(expr):
+        if isinstance(expr, tvm.tir.Call) and expr.op.name == "tir.call_extern":
+            calls[expr.args[0].value] = expr
+
+    stmt_functor.post_order_visit(primfunc.body, visit)
+    return calls
+
+
+# fmt: off
+@tvm.script.ir_module
+class LinearStructure:
+    @T.prim_func
+    def tvmgen_default_fused_add(placeholder: T.handle, T_add: T.handle) -> None:
+        T.func_attr({"global_symbol": "tvmgen_default_fused_add", "tir.noalias": True})
+        placeholder_1 = T.match_buffer(placeholder, [256], dtype="float32")
+        T_add_1 = T.match_buffer(T_add, [256], dtype="float32")
+        tmp = T.allocate([256], "float32", "global")
+        for i in T.serial(0, 256):
+            T.store(tmp, i, T.load("float32", placeholder_1.data, i) + T.float32(1), True)
+        for i in T.serial(0, 256):
+            T.store(T_add_1.data, i, T.load("float32", tmp, i) * T.float32(2), True)
+
+    @T.prim_func
+    def tvmgen_default_fused_copy(placeholder: T.handle, T_copy: T.handle) -> None:
+        T.func_attr({"global_symbol": "tvmgen_default_fused_copy", "tir.noalias": True})
+        placeholder_1 = T.match_buffer(placeholder, [256], dtype="float32")
+        T_copy_1 = T.match_buffer(T_copy, [256], dtype="float32")
+        for i in T.serial(0, 256):
+            T.store(T_copy_1.data, i, T.load("float32", placeholder_1.data, i), True)
+
+    @T.prim_func
+    def run_model(input: T.handle, output: T.handle) -> None:
+        T.func_attr({"global_symbol": "tvmgen_default_run_model", "runner_function": True})
+        T.attr("default", "device_id", 0)
+        T.attr("default", "device_type", 1)
+        sid_1 = T.allocate([1024], "int8", "global")
+        T.evaluate(T.call_extern("tvmgen_default_fused_add", input, sid_1, dtype="int32"))
+        T.evaluate(T.call_extern("tvmgen_default_fused_copy", sid_1, output, dtype="int32"))
+    __tvm_meta__ = None
+# fmt: on
+
+
+@pytest.mark.parametrize("algorithm", ["greedy_by_size", "greedy_by_conflicts"])
+def test_linear(algorithm):
+    target = Target("c")
+    workspace_pool = usmp_utils.PoolInfo(
+        pool_name="workspace", target_access={target: usmp_utils.PoolInfo.READ_WRITE_ACCESS}
+    )
+    tir_mod = _assign_poolinfos_to_allocates_in_irmodule(LinearStructure, [workspace_pool], target)
+    buffer_info_analysis = tvm.tir.usmp.analysis.extract_buffer_info(tir_mod["run_model"], tir_mod)
+    buffer_info_arr = tvm.tir.usmp._ffi_api.CreateArrayBufferInfo(
+        buffer_info_analysis.buffer_info_stmts
+    )
+    fusmp_algo = tvm.get_global_func(f"tir.usmp.algo.{algorithm}")
+    buffer_pool_allocations = fusmp_algo(buffer_info_arr, buffer_info_analysis.memory_pressure)
+    pool_sizes = tvm.tir.usmp._ffi_api.CalculatePoolSizes(buffer_pool_allocations)
+    # sid_1 and tmp are live together
+    assert pool_sizes[workspace_pool] == 2048
+    stmt_pool_allocations = tvm.tir.usmp._ffi_api.AssignStmtPoolAllocations(
+        buffer_info_analysis.buffer_info_stmts, buffer_pool_allocations
+    )
+    tir_mod = tvm.tir.usmp.transform.convert_pool_allocations_to_offsets(stmt_pool_allocations)(
+        tir_mod
+    )
+
+    run_model = tir_mod["run_model"]
+    fused_add = tir_mod["tvmgen_default_fused_add"]
+    fused_copy = tir_mod["tvmgen_default_fused_copy"]
+    assert _count_allocates(run_model) == 0
+    assert _count_allocates(fused_add) == 0
+    # The pool is a trailing parameter of the PrimFuncs allocating in it and of their callers
+    assert len(run_model.params) == 3 and run_model.params[2].name == "workspace"
+    assert len(fused_add.params) == 3 and fused_add.params[2].name == "workspace"
+    assert len(fused_copy.params) == 2
+    assert [pool.pool_name for pool in run_model.attrs["tir.usmp.pool_args"]] == ["workspace"]
+    assert "tir.usmp.pool_args" not in (fused_copy.attrs or {})
+
+    calls = _extern_calls(run_model)
+    assert len(calls["tvmgen_default_fused_add"].args) == 4
+    assert calls["tvmgen_default_fused_add"].args[3].same_as(run_model.params[2])
+    assert len(calls["tvmgen_default_fused_copy"].args) == 3
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main([__file__] + sys.argv[1:]))
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Compare two runs of the cppbench microbenchmarks and fail on the regressions.
+
+Both runs are the JSON output of cppbench with repetitions, whose medians are compared.
+"""
+import argparse
+import json
+import sys
+
+_NANOS_PER_UNIT = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_medians(path):
+    """Load the median real time in nanoseconds of each benchmark of a run."""
+    with open(path) as f:
+        run = json.load(f)
+    medians = {}
+    for bench in run["benchmarks"]:
+        if bench.get("run_type") == "aggregate" and bench.get("aggregate_name") != "median":
+            continue
+        name = bench.get("run_name", bench["name"])
+        medians[name] = bench["real_time"] * _NANOS_PER_UNIT[bench.get("time_unit", "ns")]
+    return medians
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline", help="the JSON output of the baseline run")
+    parser.add_argument("current", help="the JSON output of the current run")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.25,
+        help="the relative slowdown reported as a regression",
+    )
+    args = parser.parse_args()
+
+    baseline = load_medians(args.baseline)
+    current = load_medians(args.current)
+    regressions = []
+    print("%-48s %14s %14s %8s" % ("Benchmark", "Baseline (ns)", "Current (ns)", "Change"))
+    for name in sorted(current):
+        if name not in baseline:
+            print("%-48s %14s %14.1f %8s" % (name, "-", current[name], "new"))
+            continue
+        change = current[name] / baseline[name] - 1
+        print("%-48s %14.1f %14.1f %+7.1f%%" % (name, baseline[name], current[name], change * 100))
+        if change > args.threshold:
+            regressions.append(name)
+    if regressions:
+        print("Regressions beyond %.0f%%: %s" % (args.threshold * 100, ", ".join(regressions)))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,36 @@
+#!/bin/bash
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+
+set -e
+set -u
+
+export LD_LIBRARY_PATH="lib:${LD_LIBRARY_PATH:-}"
+# A fixed number of workers keeps the thread pool benchmarks comparable between machines.
+export TVM_NUM_THREADS=2
+
+make cppbench -j2
+
+# The medians of several repetitions are stable enough to compare with a baseline run,
+# given as the JSON output of a previous run in TVM_CPPBENCH_BASELINE.
+build/cppbench --benchmark_repetitions=5 --benchmark_report_aggregates_only=true \
+    --benchmark_out=build/cppbench.json --benchmark_out_format=json
+
+if [ -n "${TVM_CPPBENCH_BASELINE:-}" ]; then
+    python3 tests/scripts/compare_cpp_benchmarks.py "${TVM_CPPBENCH_BASELINE}" build/cppbench.json
+fi
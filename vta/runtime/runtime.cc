@@ -35,7 +35,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -509,40 +512,18 @@ class UopQueue : public BaseQueue<VTAUop> {
     cache_idx_ = 0;
     BaseQueue<VTAUop>::Reset();
   }
-  void AutoReadBarrier() { ReadBarrier(); }
-  /*! \brief Writer barrier to make sure that data written by CPU is visible to VTA. */
-  void ReadBarrier() {
-    CHECK(fpga_buff_ != nullptr);
-    CHECK(fpga_buff_phy_);
-    // Iterate over caches; allocate buffer in FPGA-readable memory
-    uint32_t buff_size = 0;
-    for (uint32_t i = 0; i < cache_.size(); ++i) {
-      buff_size += cache_[i]->size() * kElemBytes;
-    }
-    CHECK(buff_size <= kMaxBytes);
-
-    // merge all the cache entries and do CopyFromHost once
-    uint32_t total_size = 0;
-    for (uint32_t i = 0; i < cache_.size(); ++i) {
-      uint32_t ksize = cache_[i]->size() * kElemBytes;
-      total_size += ksize;
-    }
-
-    char* lbuf = (char*)memalign(ALLOC_ALIGNMENT, total_size);
-    uint32_t offset = 0;
+  /*!
+   * \brief Merge the cached kernels in host memory, in the layout the micro-op loads
+   *  address relative to dram_phy_addr().
+   * \param out The merged micro-ops, as bytes.
+   */
+  void CopyKernels(std::vector<char>* out) const {
+    out->clear();
     for (uint32_t i = 0; i < cache_.size(); ++i) {
-      uint32_t ksize = cache_[i]->size() * kElemBytes;
-      memcpy(lbuf + offset, cache_[i]->data(), ksize);
-      offset += ksize;
-    }
-    VTAMemCopyFromHost(static_cast<char*>(fpga_buff_), lbuf, total_size);
-    free(lbuf);
-
-    // Flush if we're using a shared memory system
-    // and if interface is non-coherent
-    if (!coherent_ && always_cache_) {
-      VTAFlushCache(fpga_buff_, fpga_buff_phy_, offset);
+      const char* kdata = reinterpret_cast<const char*>(cache_[i]->data());
+      out->insert(out->end(), kdata, kdata + cache_[i]->size() * kElemBytes);
     }
+    CHECK(out->size() <= static_cast<size_t>(kMaxBytes));
   }
 
  private:
@@ -896,21 +877,6 @@ class InsnQueue : public BaseQueue<VTAGenericInsn> {
     }
     return false;
   }
-  void AutoReadBarrier() { ReadBarrier(); }
-  /*! \brief Writer barrier to make sure that data written by CPU is visible to VTA. */
-  void ReadBarrier() {
-    CHECK(fpga_buff_ != nullptr);
-    CHECK(fpga_buff_phy_);
-    uint32_t buff_size = dram_buffer_.size() * elem_bytes_;
-    CHECK(buff_size <= kMaxBytes);
-    // Copy contents of DRAM buffer to FPGA buff
-    VTAMemCopyFromHost(fpga_buff_, dram_buffer_.data(), buff_size);
-    // Flush if we're using a shared memory system
-    // and if interface is non-coherent
-    if (!coherent_ && always_cache_) {
-      VTAFlushCache(fpga_buff_, fpga_buff_phy_, buff_size);
-    }
-  }
 
  protected:
   /*! \return Add new instruction to the buffer. */
@@ -994,6 +960,222 @@ class InsnQueue : public BaseQueue<VTAGenericInsn> {
   static constexpr int kMaxElems = kMaxBytes / kElemBytes;
 };
 
+/*!
+ * \brief An instruction stream and its micro-ops, copied to FPGA readable memory.
+ */
+struct InsnStream {
+  ~InsnStream() {
+    if (insn_buff != nullptr) VTAMemFree(insn_buff);
+    if (uop_buff != nullptr) VTAMemFree(uop_buff);
+  }
+  // The instructions and micro-ops built by the host, which identify the stream
+  std::vector<char> host_insn;
+  std::vector<char> host_uop;
+  // The hash of the host streams
+  uint64_t hash{0};
+  // The FPGA readable copies, the micro-op loads being moved to uop_buff
+  void* insn_buff{nullptr};
+  void* uop_buff{nullptr};
+  vta_phy_addr_t insn_phy{0};
+  uint32_t insn_count{0};
+};
+
+/*!
+ * \brief Cache of the instruction streams already copied to FPGA readable memory.
+ *
+ *  The invocations of a kernel on the same buffers build the same streams, the buffers and
+ *  the argument offsets being encoded in the instructions. Those streams are copied and
+ *  flushed once, and later only compared with their host copy.
+ */
+class InsnStreamCache {
+ public:
+  /*!
+   * \brief Get the stream with the given instructions and micro-ops, copying it on a miss.
+   * \param insn The instructions.
+   * \param insn_count The number of instructions.
+   * \param uop The micro-ops loaded by the instructions.
+   * \param uop_phy_base The physical address the micro-op loads are relative to.
+   * \return The stream, kept alive by the callers running it when it is evicted.
+   */
+  std::shared_ptr<InsnStream> Get(const VTAGenericInsn* insn, uint32_t insn_count,
+                                  const std::vector<char>& uop, vta_phy_addr_t uop_phy_base) {
+    const char* insn_bytes = reinterpret_cast<const char*>(insn);
+    size_t insn_size = insn_count * sizeof(VTAGenericInsn);
+    uint64_t hash = Hash(uop.data(), uop.size(), Hash(insn_bytes, insn_size, kHashSeed));
+    for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+      const InsnStream& stream = **it;
+      if (stream.hash == hash && stream.host_insn.size() == insn_size &&
+          stream.host_uop == uop && memcmp(stream.host_insn.data(), insn_bytes, insn_size) == 0) {
+        streams_.splice(streams_.begin(), streams_, it);
+        return streams_.front();
+      }
+    }
+    std::shared_ptr<InsnStream> stream = Create(insn_bytes, insn_count, uop, uop_phy_base);
+    stream->hash = hash;
+    streams_.push_front(stream);
+    total_bytes_ += insn_size + uop.size();
+    while (streams_.size() > 1 &&
+           (streams_.size() > kMaxStreams || total_bytes_ > kMaxTotalBytes)) {
+      total_bytes_ -= streams_.back()->host_insn.size() + streams_.back()->host_uop.size();
+      streams_.pop_back();
+    }
+    return stream;
+  }
+
+ private:
+  static std::shared_ptr<InsnStream> Create(const char* insn, uint32_t insn_count,
+                                            const std::vector<char>& uop,
+                                            vta_phy_addr_t uop_phy_base) {
+    auto stream = std::make_shared<InsnStream>();
+    size_t insn_size = insn_count * sizeof(VTAGenericInsn);
+    stream->host_insn.assign(insn, insn + insn_size);
+    stream->host_uop = uop;
+    stream->insn_count = insn_count;
+    stream->insn_buff = VTAMemAlloc(insn_size, kBufferCoherent || kAlwaysCache);
+    CHECK(stream->insn_buff != nullptr);
+    stream->insn_phy = VTAMemGetPhyAddr(stream->insn_buff);
+    vta_phy_addr_t uop_phy = uop_phy_base;
+    if (!uop.empty()) {
+      stream->uop_buff = VTAMemAlloc(uop.size(), kBufferCoherent || kAlwaysCache);
+      CHECK(stream->uop_buff != nullptr);
+      uop_phy = VTAMemGetPhyAddr(stream->uop_buff);
+      Upload(stream->uop_buff, uop_phy, uop.data(), uop.size());
+    }
+    // Move the micro-op loads from the micro-op queue buffer to the one of the stream
+    char* lbuf = static_cast<char*>(memalign(ALLOC_ALIGNMENT, insn_size));
+    CHECK(lbuf != nullptr);
+    memcpy(lbuf, insn, insn_size);
+    VTAGenericInsn* insn_copy = reinterpret_cast<VTAGenericInsn*>(lbuf);
+    for (uint32_t i = 0; i < insn_count; ++i) {
+      VTAMemInsn* mem = reinterpret_cast<VTAMemInsn*>(&insn_copy[i]);
+      if (mem->opcode == VTA_OPCODE_LOAD && mem->memory_type == VTA_MEM_ID_UOP) {
+        uint64_t dram_base = mem->dram_base;
+        mem->dram_base = dram_base - uop_phy_base / kUopBytes + uop_phy / kUopBytes;
+      }
+    }
+    Upload(stream->insn_buff, stream->insn_phy, lbuf, insn_size);
+    free(lbuf);
+    return stream;
+  }
+
+  static void Upload(void* dst, vta_phy_addr_t dst_phy, const void* src, size_t size) {
+    VTAMemCopyFromHost(dst, src, size);
+    // Flush if we're using a shared memory system
+    // and if interface is non-coherent
+    if (!kBufferCoherent && kAlwaysCache) {
+      VTAFlushCache(dst, dst_phy, size);
+    }
+  }
+
+  // FNV-1a over 64 bit words
+  static uint64_t Hash(const char* data, size_t size, uint64_t hash) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, data + i, sizeof(word));
+      hash = (hash ^ word) * kHashPrime;
+    }
+    for (; i < size; ++i) {
+      hash = (hash ^ static_cast<uint8_t>(data[i])) * kHashPrime;
+    }
+    return hash;
+  }
+
+  static constexpr uint64_t kHashSeed = 14695981039346656037ULL;
+  static constexpr uint64_t kHashPrime = 1099511628211ULL;
+  static constexpr int kUopBytes = sizeof(VTAUop);
+  // Bounds of the cache, the least recently used streams are evicted first
+  static constexpr size_t kMaxStreams = 64;
+  static constexpr size_t kMaxTotalBytes = 16 << 20;
+  // The streams, the most recently used first
+  std::list<std::shared_ptr<InsnStream>> streams_;
+  // The total size of the cached streams
+  size_t total_bytes_{0};
+};
+
+/*!
+ * \brief Runs the instruction streams on the device in a worker thread.
+ *
+ *  The host builds the streams of the next layer while the accelerator runs the current
+ *  one. The streams run in submission order, the accelerator running one at a time, and
+ *  at most kMaxInFlight are submitted and not finished.
+ */
+class AsyncSubmitter {
+ public:
+  explicit AsyncSubmitter(VTADeviceHandle device)
+      : device_(device), worker_([this]() { this->Run(); }) {}
+
+  ~AsyncSubmitter() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+  /*!
+   * \brief Submit a stream, waiting while kMaxInFlight streams are not finished.
+   * \param stream The stream.
+   * \param wait_cycles The limit of poll cycles.
+   */
+  void Submit(std::shared_ptr<InsnStream> stream, uint32_t wait_cycles) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return jobs_.size() + (running_ ? 1 : 0) < kMaxInFlight; });
+    CheckTimeout();
+    jobs_.push_back(Job{std::move(stream), wait_cycles});
+    cv_.notify_all();
+  }
+  /*! \brief Wait until the submitted streams finished, and check that none timed out. */
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return jobs_.empty() && !running_; });
+    CheckTimeout();
+  }
+
+ private:
+  struct Job {
+    std::shared_ptr<InsnStream> stream;
+    uint32_t wait_cycles;
+  };
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+      if (jobs_.empty()) return;
+      Job job = std::move(jobs_.front());
+      jobs_.pop_front();
+      running_ = true;
+      lock.unlock();
+      int timeout =
+          VTADeviceRun(device_, job.stream->insn_phy, job.stream->insn_count, job.wait_cycles);
+      job.stream.reset();
+      lock.lock();
+      running_ = false;
+      if (timeout != 0) ++num_timeouts_;
+      cv_.notify_all();
+    }
+  }
+
+  // Called with the lock held
+  void CheckTimeout() {
+    int num_timeouts = num_timeouts_;
+    num_timeouts_ = 0;
+    CHECK_EQ(num_timeouts, 0) << "VTA: " << num_timeouts << " instruction streams timed out";
+  }
+
+  static constexpr size_t kMaxInFlight = 2;
+  VTADeviceHandle device_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Job> jobs_;
+  bool running_{false};
+  bool stop_{false};
+  int num_timeouts_{0};
+  // Started last, once the other members are initialized
+  std::thread worker_;
+};
+
 /*!
  * \brief The command queue object that handles the request.
  */
@@ -1005,9 +1187,17 @@ class CommandQueue {
     insn_queue_.InitSpace();
     device_ = VTADeviceAlloc();
     CHECK(device_ != nullptr);
+    const char* async_submit = getenv("VTA_ASYNC_SUBMIT");
+    if (async_submit != nullptr && atoi(async_submit) != 0) {
+      this->SetAsyncSubmit(true);
+    }
   }
 
-  ~CommandQueue() { VTADeviceFree(device_); }
+  ~CommandQueue() {
+    // Finish the streams in flight before freeing the device
+    submitter_.reset();
+    VTADeviceFree(device_);
+  }
 
   uint32_t GetElemBytes(uint32_t memory_id) {
     uint32_t elem_bytes = 0;
@@ -1086,6 +1276,7 @@ class CommandQueue {
   void DepPop(int from_qid, int to_qid) { insn_queue_.DepPop(from_qid, to_qid); }
 
   void ReadBarrier(void* buffer, uint32_t elem_bits, uint32_t start, uint32_t extent) {
+    this->Wait();
     if (!(debug_flag_ & VTA_DEBUG_SKIP_READ_BARRIER)) {
       uint32_t elem_bytes = (elem_bits + 8 - 1) / 8;
       DataBuffer::FromHandle(buffer)->FlushCache(elem_bytes * start, elem_bytes * extent);
@@ -1093,6 +1284,7 @@ class CommandQueue {
   }
 
   void WriteBarrier(void* buffer, uint32_t elem_bits, uint32_t start, uint32_t extent) {
+    this->Wait();
     if (!(debug_flag_ & VTA_DEBUG_SKIP_WRITE_BARRIER)) {
       uint32_t elem_bytes = (elem_bits + 8 - 1) / 8;
       DataBuffer::FromHandle(buffer)->InvalidateCache(elem_bytes * start, elem_bytes * extent);
@@ -1117,9 +1309,6 @@ class CommandQueue {
     CHECK(!insn_queue_.PendingPop());
     // Check if there are no instruction to execute at all
     if (insn_queue_.count() == 0) return;
-    // Synchronization for the queues
-    uop_queue_.AutoReadBarrier();
-    insn_queue_.AutoReadBarrier();
     // Dump instructions if debug enabled
     if (debug_flag_ & VTA_DEBUG_DUMP_INSN) {
       insn_queue_.DumpInsn();
@@ -1130,9 +1319,15 @@ class CommandQueue {
 
     // Make sure that we don't exceed contiguous physical memory limits
     CHECK(insn_queue_.count() * sizeof(VTAGenericInsn) <= VTA_MAX_XFER);
-    int timeout =
-        VTADeviceRun(device_, insn_queue_.dram_phy_addr(), insn_queue_.count(), wait_cycles);
-    CHECK_EQ(timeout, 0);
+    uop_queue_.CopyKernels(&uop_image_);
+    std::shared_ptr<InsnStream> stream = stream_cache_.Get(
+        insn_queue_.data(), insn_queue_.count(), uop_image_, uop_queue_.dram_phy_addr());
+    if (submitter_ != nullptr) {
+      submitter_->Submit(std::move(stream), wait_cycles);
+    } else {
+      int timeout = VTADeviceRun(device_, stream->insn_phy, stream->insn_count, wait_cycles);
+      CHECK_EQ(timeout, 0);
+    }
     // Reset buffers
     uop_queue_.Reset();
     insn_queue_.Reset();
@@ -1147,6 +1342,21 @@ class CommandQueue {
   // Set debug flag
   void SetDebugFlag(int debug_flag) { debug_flag_ = debug_flag; }
 
+  // Enable or disable the asynchronous submission of the instruction streams
+  void SetAsyncSubmit(bool enable) {
+    if (enable && submitter_ == nullptr) {
+      submitter_.reset(new AsyncSubmitter(device_));
+    } else if (!enable && submitter_ != nullptr) {
+      submitter_->Wait();
+      submitter_.reset();
+    }
+  }
+
+  // Wait until the submitted instruction streams finished
+  void Wait() {
+    if (submitter_ != nullptr) submitter_->Wait();
+  }
+
   void PushGEMMOp(void** uop_handle, int (*finit)(void*), void* signature, int nbytes) {
     UopKernelMap** uptr = reinterpret_cast<UopKernelMap**>(uop_handle);
     if (uptr[0] == nullptr) {
@@ -1186,16 +1396,28 @@ class CommandQueue {
   }
 
   static std::shared_ptr<CommandQueue>& ThreadLocal() {
-    static std::shared_ptr<CommandQueue> inst = std::make_shared<CommandQueue>();
+    std::shared_ptr<CommandQueue>& inst = Instance();
     if (inst == nullptr) {
       inst = std::make_shared<CommandQueue>();
     }
     return inst;
   }
 
-  static void Shutdown() { ThreadLocal().reset(); }
+  static void Shutdown() { Instance().reset(); }
+
+  // Wait for the streams in flight before the host accesses the data buffers
+  static void WaitAll() {
+    std::shared_ptr<CommandQueue>& inst = Instance();
+    if (inst != nullptr) inst->Wait();
+  }
 
  private:
+  // The queue, not created by the functions only waiting for it
+  static std::shared_ptr<CommandQueue>& Instance() {
+    static std::shared_ptr<CommandQueue> inst;
+    return inst;
+  }
+
   // Push GEMM uop to the command buffer
   void PushGEMMOp(UopKernel* kernel) {
     uop_queue_.Push(kernel, [this]() { this->AutoSync(); });
@@ -1295,18 +1517,28 @@ class CommandQueue {
   InsnQueue<VTA_MAX_XFER, kBufferCoherent, kAlwaysCache> insn_queue_;
   // Device handle
   VTADeviceHandle device_{nullptr};
+  // The streams already copied to FPGA readable memory
+  InsnStreamCache stream_cache_;
+  // The merged micro-ops of the current stream
+  std::vector<char> uop_image_;
+  // The worker running the streams, when they are submitted asynchronously
+  std::unique_ptr<AsyncSubmitter> submitter_;
 };
 
 }  // namespace vta
 
 void* VTABufferAlloc(size_t size) { return vta::DataBuffer::Alloc(size); }
 
-void VTABufferFree(void* buffer) { vta::DataBuffer::Free(vta::DataBuffer::FromHandle(buffer)); }
+void VTABufferFree(void* buffer) {
+  vta::CommandQueue::WaitAll();
+  vta::DataBuffer::Free(vta::DataBuffer::FromHandle(buffer));
+}
 
 void VTABufferCopy(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
                    int kind_mask) {
   vta::DataBuffer* from_buffer = nullptr;
   vta::DataBuffer* to_buffer = nullptr;
+  vta::CommandQueue::WaitAll();
 
   if (kind_mask & 2) {
     from_buffer = vta::DataBuffer::FromHandle(from);
@@ -1338,7 +1570,12 @@ void VTASetDebugMode(VTACommandHandle cmd, int debug_flag) {
   static_cast<vta::CommandQueue*>(cmd)->SetDebugFlag(debug_flag);
 }
 
+void VTASetAsyncSubmit(VTACommandHandle cmd, int enable) {
+  static_cast<vta::CommandQueue*>(cmd)->SetAsyncSubmit(enable != 0);
+}
+
 void* VTABufferCPUPtr(VTACommandHandle cmd, void* buffer) {
+  static_cast<vta::CommandQueue*>(cmd)->Wait();
   auto data_buf = vta::DataBuffer::FromHandle(buffer);
   if (data_buf) {
     return data_buf->virt_addr();
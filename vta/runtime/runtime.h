@@ -118,6 +118,16 @@ TVM_DLL void VTAReadBarrier(VTACommandHandle cmd, void* buffer, uint32_t elem_bi
  */
 TVM_DLL void VTASetDebugMode(VTACommandHandle cmd, int debug_flag);
 
+/*!
+ * \brief Set whether the instruction streams are submitted asynchronously.
+ *  VTASynchronize then returns once the instructions are submitted, while the
+ *  accelerator runs them, and the host accesses to the data buffers wait for it.
+ *  Also enabled by setting the VTA_ASYNC_SUBMIT environment variable to 1.
+ * \param cmd The VTA command handle.
+ * \param enable Whether to submit asynchronously.
+ */
+TVM_DLL void VTASetAsyncSubmit(VTACommandHandle cmd, int enable);
+
 /*!
  * \brief Perform a 2D data load from DRAM.
  *  Sizes are measured in units of vector elements.
@@ -249,6 +259,7 @@ TVM_DLL int VTADepPop(VTACommandHandle cmd, int from_qid, int to_qid);
  *  Commit all the instructions to VTA and wait until
  *  the accelerator finishes its job.
  *  Perform all of the out-of-order DRAM stores.
+ *  With VTASetAsyncSubmit, only wait until the accelerator can accept the instructions.
  * \param cmd The VTA command handle.
  * \param wait_cycles The limit of poll cycles.
  *
@@ -29,8 +29,9 @@ function __wasmLibInstantiateWasm(imports, successCallback) {
     __wasmLib.successCallback = successCallback;
 }
 
-function __wasmLibStart(wasmInstance) {
-    __wasmLib.successCallback(wasmInstance);
+function __wasmLibStart(wasmInstance, wasmModule) {
+    // the threaded runtime instantiates the module again in each of its workers
+    __wasmLib.successCallback(wasmInstance, wasmModule);
 }
 
 __wasmLib.start = __wasmLibStart;
@@ -44,6 +44,7 @@
 #include "src/runtime/profiling.cc"
 #include "src/runtime/registry.cc"
 #include "src/runtime/rpc/rpc_channel.cc"
+#include "src/runtime/rpc/rpc_compression.cc"
 #include "src/runtime/rpc/rpc_endpoint.cc"
 #include "src/runtime/rpc/rpc_event_impl.cc"
 #include "src/runtime/rpc/rpc_local_session.cc"
@@ -52,16 +53,26 @@
 #include "src/runtime/system_library.cc"
 #include "src/runtime/workspace_pool.cc"
 
+// The threaded runtime, built with -pthread, runs the parallel loops on Web Workers sharing the
+// memory of the instance in a SharedArrayBuffer.
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include "src/runtime/thread_pool.cc"
+#include "src/runtime/threading_backend.cc"
+#endif
+
 // --- Implementations of backend and wasm runtime API. ---
 
+#ifndef __EMSCRIPTEN_PTHREADS__
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
   TVMParallelGroupEnv env;
   env.num_task = 1;
+  env.thread_budget = 1;
   flambda(0, &env, cdata);
   return 0;
 }
 
 int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) { return 0; }
+#endif
 
 // --- Environment PackedFuncs for testing ---
 namespace tvm {
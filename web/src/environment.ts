@@ -41,8 +41,8 @@ function detectLibraryProvider(
     // create provider so that we capture imports in the provider.
     return {
       imports: item.wasmLibraryProvider.imports,
-      start: (inst: WebAssembly.Instance): void => {
-        item.wasmLibraryProvider.start(inst);
+      start: (inst: WebAssembly.Instance, module?: WebAssembly.Module): void => {
+        item.wasmLibraryProvider.start(inst, module);
       },
     };
   } else if (importObject["imports"] && importObject["start"] !== undefined) {
@@ -102,9 +102,9 @@ export class Environment implements LibraryProvider {
   }
 
   /** Mark the start of the instance. */
-  start(inst: WebAssembly.Instance): void {
+  start(inst: WebAssembly.Instance, module?: WebAssembly.Module): void {
     if (this.libProvider !== undefined) {
-      this.libProvider.start(inst);
+      this.libProvider.start(inst, module);
     }
   }
 
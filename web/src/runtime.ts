@@ -721,7 +721,7 @@ export class Instance implements Disposable {
       wasmInstance = new WebAssembly.Instance(wasmModule, env.imports);
     }
 
-    env.start(wasmInstance);
+    env.start(wasmInstance, wasmModule);
     this.env = env;
     this.lib = new FFILibrary(wasmInstance, env.imports);
     this.memory = this.lib.memory;
@@ -42,29 +42,94 @@ interface FunctionInfo {
   launch_param_tags: Array<string>;
 }
 
+/**
+ * The number of commands recorded before they are submitted without a sync.
+ */
+const kMaxPendingCommands = 1024;
+
+/**
+ * The size of the buffers allocated for a request, the next power of two
+ * up to 1MB and the next multiple of 1MB after, so freed buffers can be reused.
+ *
+ * @param nbytes The number of bytes requested.
+ */
+function bufferSizeClass(nbytes: number): number {
+  const kMinSize = 256;
+  const kMaxPow2Size = 1 << 20;
+  if (nbytes <= kMinSize) return kMinSize;
+  if (nbytes > kMaxPow2Size) {
+    return Math.ceil(nbytes / kMaxPow2Size) * kMaxPow2Size;
+  }
+  return 1 << Math.ceil(Math.log2(nbytes));
+}
+
 /**
  * WebGPU context
  * Manages all the webgpu resources here.
+ *
+ * The kernel launches and copies are recorded in one command encoder,
+ * submitted when the results are read back or waited for, so a run
+ * of a model makes a single submit. Freed storage buffers and the staging
+ * buffers of the readbacks are kept in pools by size class.
  */
 export class WebGPUContext {
   device: GPUDevice;
   memory: Memory;
 
-  //private readBuffer:;
   private bufferTable: Array<GPUBuffer | undefined> = [undefined];
+  private bufferTableSize: Array<number> = [0];
   private bufferTableFreeId: Array<number> = [];
   private pendingRead: Promise<void> = Promise.resolve();
   private numPendingReads = 0;
+  // the commands recorded and not submitted yet
+  private pendingEncoder?: GPUCommandEncoder = undefined;
+  private numPendingCommands = 0;
+  // the upload buffers to destroy once their copies are submitted
+  private pendingDestroy: Array<GPUBuffer> = [];
+  // the free storage and readback buffers of each size class
+  private bufferPool: Map<number, Array<GPUBuffer>> = new Map();
+  private readBufferPool: Map<number, Array<GPUBuffer>> = new Map();
 
   constructor(memory: Memory, device: GPUDevice) {
     this.memory = memory;
     this.device = device;
   }
 
+  /**
+   * Submit the commands recorded so far.
+   */
+  flush(): void {
+    if (this.pendingEncoder === undefined) return;
+    this.device.defaultQueue.submit([this.pendingEncoder.finish()]);
+    this.pendingEncoder = undefined;
+    this.numPendingCommands = 0;
+    for (const buffer of this.pendingDestroy) {
+      buffer.destroy();
+    }
+    this.pendingDestroy = [];
+  }
+
+  /**
+   * Release the free buffers kept in the pools.
+   */
+  clearBufferPool(): void {
+    // the recorded commands may use the pooled buffers
+    this.flush();
+    for (const pool of [this.bufferPool, this.readBufferPool]) {
+      for (const buffers of pool.values()) {
+        for (const buffer of buffers) {
+          buffer.destroy();
+        }
+      }
+      pool.clear();
+    }
+  }
+
   /**
    * Wait for all pending GPU tasks to complete
    */
   async sync(): Promise<void> {
+    this.flush();
     const fence = this.device.defaultQueue.createFence();
     this.device.defaultQueue.signal(fence, 1);
     if (this.numPendingReads != 0) {
@@ -130,8 +195,7 @@ export class WebGPUContext {
     }
 
     const submitShader = (...args: Array<GPUPointer | number>): void => {
-      const commandEncoder = this.device.createCommandEncoder();
-      const compute = commandEncoder.beginComputePass();
+      const compute = this.getEncoder().beginComputePass();
       compute.setPipeline(pipeline);
       const bindGroupEntries: Array<GPUBindGroupEntry> = [];
       assert(args.length == layoutEntries.length + dispatchToDim.length);
@@ -155,8 +219,7 @@ export class WebGPUContext {
       }
       compute.dispatch(wl[0], wl[1], wl[2]);
       compute.endPass();
-      const command = commandEncoder.finish();
-      this.device.defaultQueue.submit([command]);
+      this.commandRecorded();
     };
 
     return submitShader;
@@ -210,13 +273,52 @@ export class WebGPUContext {
 
   }
 
+  private getEncoder(): GPUCommandEncoder {
+    if (this.pendingEncoder === undefined) {
+      this.pendingEncoder = this.device.createCommandEncoder();
+    }
+    return this.pendingEncoder;
+  }
+
+  private commandRecorded(): void {
+    this.numPendingCommands += 1;
+    if (this.numPendingCommands >= kMaxPendingCommands) {
+      this.flush();
+    }
+  }
+
+  private takeFromPool(
+    pool: Map<number, Array<GPUBuffer>>,
+    size: number
+  ): GPUBuffer | undefined {
+    const buffers = pool.get(size);
+    return buffers === undefined ? undefined : buffers.pop();
+  }
+
+  private returnToPool(
+    pool: Map<number, Array<GPUBuffer>>,
+    size: number,
+    buffer: GPUBuffer
+  ): void {
+    const buffers = pool.get(size);
+    if (buffers === undefined) {
+      pool.set(size, [buffer]);
+    } else {
+      buffers.push(buffer);
+    }
+  }
+
   // DeviceAPI
   private deviceAllocDataSpace(nbytes: number): GPUPointer {
-    const buffer = this.device.createBuffer({
-      size: nbytes,
-      usage: GPUBufferUsage.STORAGE | GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST,
-    });
-    return this.attachToBufferTable(buffer);
+    const size = bufferSizeClass(nbytes);
+    let buffer = this.takeFromPool(this.bufferPool, size);
+    if (buffer === undefined) {
+      buffer = this.device.createBuffer({
+        size: size,
+        usage: GPUBufferUsage.STORAGE | GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST,
+      });
+    }
+    return this.attachToBufferTable(buffer, size);
   }
 
   private deviceFreeDataSpace(ptr: GPUPointer): void {
@@ -225,7 +327,8 @@ export class WebGPUContext {
     this.bufferTable[idx] = undefined;
     assert(buffer !== undefined);
     this.bufferTableFreeId.push(idx);
-    buffer.destroy();
+    // the recorded commands run before the ones of a next owner of the buffer
+    this.returnToPool(this.bufferPool, this.bufferTableSize[idx], buffer);
   }
 
   private deviceCopyToGPU(
@@ -247,17 +350,15 @@ export class WebGPUContext {
     viewU8.set(this.memory.loadRawBytes(from, nbytes));
     gpuTemp.unmap();
 
-    const copyEncoder = this.device.createCommandEncoder();
-    copyEncoder.copyBufferToBuffer(
+    this.getEncoder().copyBufferToBuffer(
       gpuTemp,
       0,
       this.gpuBufferFromPtr(to),
       toOffset,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.defaultQueue.submit([copyCommands]);
-    gpuTemp.destroy();
+    this.pendingDestroy.push(gpuTemp);
+    this.commandRecorded();
   }
 
   private deviceCopyFromGPU(
@@ -266,29 +367,35 @@ export class WebGPUContext {
     to: Pointer,
     nbytes: number
   ): void {
-    // Perhaps it would be more useful to resuse a staging buffer?
-    const gpuTemp = this.device.createBuffer({
-      size: nbytes,
-      usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
-    });
+    // the staging buffers are reused once their data is read
+    const size = bufferSizeClass(nbytes);
+    let gpuTemp = this.takeFromPool(this.readBufferPool, size);
+    if (gpuTemp === undefined) {
+      gpuTemp = this.device.createBuffer({
+        size: size,
+        usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
+      });
+    }
+    const staging = gpuTemp;
 
-    const copyEncoder = this.device.createCommandEncoder();
-    copyEncoder.copyBufferToBuffer(
+    this.getEncoder().copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
-      gpuTemp,
+      staging,
       0,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.defaultQueue.submit([copyCommands]);
+    // the readback needs the commands recorded before it
+    this.flush();
 
     this.numPendingReads += 1;
 
-    const readEvent = gpuTemp.mapAsync(GPUMapMode.READ).then((data: unknown) => {
-      this.memory.storeRawBytes(to, new Uint8Array(data as ArrayBuffer));
+    const readEvent = staging.mapAsync(GPUMapMode.READ).then(() => {
+      const data = staging.getMappedRange();
+      this.memory.storeRawBytes(to, new Uint8Array(data, 0, nbytes));
       this.numPendingReads -= 1;
-      gpuTemp.destroy();
+      staging.unmap();
+      this.returnToPool(this.readBufferPool, size, staging);
     });
 
     if (this.numPendingReads == 1) {
@@ -309,16 +416,14 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    const copyEncoder = this.device.createCommandEncoder();
-    copyEncoder.copyBufferToBuffer(
+    this.getEncoder().copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
       this.gpuBufferFromPtr(to),
       toOffset,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.defaultQueue.submit([copyCommands]);
+    this.commandRecorded();
   }
 
   private gpuBufferFromPtr(ptr: GPUPointer): GPUBuffer {
@@ -327,14 +432,16 @@ export class WebGPUContext {
     return buffer;
   }
 
-  private attachToBufferTable(buffer: GPUBuffer): GPUPointer {
+  private attachToBufferTable(buffer: GPUBuffer, size: number): GPUPointer {
     if (this.bufferTableFreeId.length != 0) {
       const idx = this.bufferTableFreeId.pop() as number;
       this.bufferTable[idx] = buffer;
+      this.bufferTableSize[idx] = size;
       return idx;
     } else {
       const idx = this.bufferTable.length;
       this.bufferTable.push(buffer);
+      this.bufferTableSize.push(size);
       return idx;
     }
   }